@@ -9,6 +9,7 @@
 #include "envoy/common/exception.h"
 #include "envoy/common/platform.h"
 #include "envoy/common/pure.h"
+#include "envoy/http/stream_reset_handler.h"
 
 #include "source/common/common/assert.h"
 #include "source/common/common/byte_order.h"
@@ -109,6 +110,18 @@ public:
    * @param amount the amount to credit.
    */
   virtual void credit(uint64_t amount) PURE;
+
+  /**
+   * Resets the downstream stream charged to this account, if it is still around, to release the
+   * memory it is using.
+   */
+  virtual void resetDownstream() PURE;
+
+  /**
+   * Called when the downstream stream charged to this account is done, so that it is no longer
+   * reset. The account may still be charged and credited afterwards, by the slices it outlives.
+   */
+  virtual void clearDownstream() PURE;
 };
 
 using BufferMemoryAccountSharedPtr = std::shared_ptr<BufferMemoryAccount>;
@@ -241,6 +254,16 @@ public:
    */
   virtual void move(Instance& rhs, uint64_t length) PURE;
 
+  /**
+   * Move a portion of a buffer into this buffer without copying the moved data, so that the
+   * memory previously returned by getRawSlices() for it stays valid while this buffer holds it.
+   * Unlike move() this never coalesces slices. If the moved portion ends in the middle of a slice,
+   * the remainder of that slice is copied into a new slice that stays in rhs instead.
+   * @param rhs supplies the buffer to move.
+   * @param length supplies the amount of data to move.
+   */
+  virtual void movePinned(Instance& rhs, uint64_t length) PURE;
+
   /**
    * Reserve space in the buffer for reading into. The amount of space reserved is determined
    * based on buffer settings and performance considerations.
@@ -497,6 +520,21 @@ public:
   virtual InstancePtr createBuffer(std::function<void()> below_low_watermark,
                                    std::function<void()> above_high_watermark,
                                    std::function<void()> above_overflow_watermark) PURE;
+
+  /**
+   * Creates an account for a downstream stream, which the factory tracks by the memory charged to
+   * it so that the streams using the most memory can be reset under memory pressure.
+   * @param reset_handler supplies the handler to reset the stream with.
+   * @return a newly created BufferMemoryAccountSharedPtr.
+   */
+  virtual BufferMemoryAccountSharedPtr createAccount(Http::StreamResetHandler& reset_handler) PURE;
+
+  /**
+   * Resets the streams of the accounts charged the most, the more of them the higher the pressure.
+   * @param pressure supplies the memory pressure, between 0 and 1.
+   * @return the number of streams reset.
+   */
+  virtual uint64_t resetAccountsGivenPressure(float pressure) PURE;
 };
 
 using WatermarkFactoryPtr = std::unique_ptr<WatermarkFactory>;
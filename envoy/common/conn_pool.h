@@ -1,9 +1,12 @@
 #pragma once
 
 #include "envoy/common/pure.h"
+#include "envoy/common/time.h"
 #include "envoy/event/deferred_deletable.h"
 #include "envoy/upstream/upstream.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace ConnectionPool {
 
@@ -22,6 +25,19 @@ enum class CancelPolicy {
   CloseExcess,
 };
 
+/**
+ * Controls how a stream waits in the pending queue of a pool when no connection can serve it right
+ * away.
+ */
+struct PendingStreamOptions {
+  // The pending streams of higher priority are served first. Once the queue is full, a new stream
+  // displaces the most recently queued stream of the lowest priority if it is lower than its own.
+  uint32_t queue_priority_{0};
+  // The time past which the stream can no longer be of use, after which it is failed rather than
+  // served by the pool.
+  absl::optional<MonotonicTime> deadline_;
+};
+
 /**
  * Handle that allows a pending connection or stream to be canceled before it is completed.
  */
@@ -86,6 +102,22 @@ public:
    * @return true if a connection was preconnected, false otherwise.
    */
   virtual bool maybePreconnect(float preconnect_ratio) PURE;
+
+  /**
+   * Called once the connections created by warmUp() are established or have failed.
+   */
+  using WarmUpCb = std::function<void()>;
+
+  /**
+   * Creates upstream connections until the pool has the given number of connections, within the
+   * connection circuit breaker, irrespective of the load. Used to pre-establish the connections of
+   * a new host before it receives traffic.
+   *
+   * @param connections the number of connections the pool should have.
+   * @param cb called once none of the connections of the pool are connecting anymore. It may be
+   *        called before this call returns, and is not called if the pool is destroyed first.
+   */
+  virtual void warmUp(uint32_t connections, WarmUpCb cb) PURE;
 };
 
 enum class PoolFailureReason {
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <functional>
+#include <memory>
+
+#include "envoy/common/platform.h"
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+namespace Io {
+
+/**
+ * Callback invoked when iterating over entries in the completion queue.
+ * @param user_data is the opaque pointer passed in when the request was prepared.
+ * @param result is the result of the operation, i.e. the value the corresponding syscall would
+ *        have returned, or a negated errno value on failure.
+ */
+using CompletionCb = std::function<void(void* user_data, int32_t result)>;
+
+enum class IoUringResult { Ok, Busy, Failed };
+
+/**
+ * Abstract for io_uring I/O Uring. An instance is owned by a single thread and is not thread
+ * safe. Requests are only queued in the submission queue by the prepare*() methods and are
+ * handed to the kernel in one batch by submit(), so callers can amortize the cost of entering
+ * the kernel over all the I/O issued within a single event loop iteration.
+ */
+class IoUring {
+public:
+  virtual ~IoUring() = default;
+
+  /**
+   * Registers an eventfd file descriptor for the ring and returns it. The file descriptor becomes
+   * readable each time a new completion is posted to the completion queue and can be watched by
+   * the event loop.
+   */
+  virtual os_fd_t registerEventfd() PURE;
+
+  /**
+   * Resets the eventfd file descriptor for the ring.
+   */
+  virtual void unregisterEventfd() PURE;
+
+  /**
+   * Returns true if an eventfd file descriptor is registered with the ring.
+   */
+  virtual bool isEventfdRegistered() const PURE;
+
+  /**
+   * Iterates over entries in the completion queue, calls the given callback for every entry and
+   * marks them consumed.
+   */
+  virtual void forEveryCompletion(const CompletionCb& completion_cb) PURE;
+
+  /**
+   * Prepares an accept system call and puts it into the submission queue.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareAccept(os_fd_t fd, struct sockaddr* remote_addr,
+                                      socklen_t* remote_addr_len, void* user_data) PURE;
+
+  /**
+   * Prepares a connect system call and puts it into the submission queue.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareConnect(os_fd_t fd, const struct sockaddr* address,
+                                       socklen_t address_len, void* user_data) PURE;
+
+  /**
+   * Prepares a readv system call and puts it into the submission queue.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareReadv(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
+                                     off_t offset, void* user_data) PURE;
+
+  /**
+   * Prepares a writev system call and puts it into the submission queue.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
+                                      off_t offset, void* user_data) PURE;
+
+  /**
+   * Prepares a close system call and puts it into the submission queue.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareClose(os_fd_t fd, void* user_data) PURE;
+
+  /**
+   * Submits the entries in the submission queue to the kernel using one io_uring_enter(2)
+   * system call.
+   * Returns IoUringResult::Ok in case of success and may return
+   * IoUringResult::Busy if we over commit the number of requests. In the latter case the
+   * application should drain the completion queue by handling some completions with the
+   * forEveryCompletion() method and try again.
+   */
+  virtual IoUringResult submit() PURE;
+};
+
+using IoUringPtr = std::unique_ptr<IoUring>;
+
+} // namespace Io
+} // namespace Envoy
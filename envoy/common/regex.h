@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "envoy/common/matchers.h"
 
@@ -24,5 +26,26 @@ public:
 
 using CompiledMatcherPtr = std::unique_ptr<const CompiledMatcher>;
 
+/**
+ * A set of compiled regex expressions, matched against a value in a single pass rather than one by
+ * one.
+ */
+class CompiledMatcherSet {
+public:
+  virtual ~CompiledMatcherSet() = default;
+
+  /**
+   * Matches the value against all the regexes of the set, as CompiledMatcher::match() does.
+   * @param value supplies the value to match.
+   * @param matches receives the indices of the regexes which match the whole value, in the order
+   *        they were given to the set, in ascending order.
+   * @return false if the regex engine couldn't evaluate the set for the value, in which case
+   *         nothing is added to matches and the regexes have to be matched one by one.
+   */
+  virtual bool match(absl::string_view value, std::vector<uint32_t>& matches) const PURE;
+};
+
+using CompiledMatcherSetPtr = std::unique_ptr<const CompiledMatcherSet>;
+
 } // namespace Regex
 } // namespace Envoy
@@ -37,7 +37,15 @@ namespace Event {
  */
 #define ALL_DISPATCHER_STATS(HISTOGRAM)                                                            \
   HISTOGRAM(loop_duration_us, Microseconds)                                                        \
-  HISTOGRAM(poll_delay_us, Microseconds)
+  HISTOGRAM(poll_delay_us, Microseconds)                                                           \
+  HISTOGRAM(file_event_duration_us, Microseconds)                                                  \
+  HISTOGRAM(timer_duration_us, Microseconds)                                                       \
+  HISTOGRAM(schedulable_callback_duration_us, Microseconds)                                        \
+  HISTOGRAM(post_callback_duration_us, Microseconds)                                               \
+  HISTOGRAM(deferred_delete_duration_us, Microseconds)                                             \
+  HISTOGRAM(deferred_delete_queue_size, Unspecified)                                              \
+  HISTOGRAM(events_per_loop, Unspecified)                                                          \
+  HISTOGRAM(post_batch_size, Unspecified)
 
 /**
  * Struct definition for all dispatcher stats. @see stats_macros.h
@@ -69,6 +77,13 @@ public:
    */
   virtual void post(PostCb callback) PURE;
 
+  /**
+   * Posts several functors to the dispatcher at once. This is safe cross thread. The functors run
+   * in order, in the context of the dispatcher event loop, and the loop is woken at most once for
+   * the whole batch.
+   */
+  virtual void postBatch(std::vector<PostCb>&& callbacks) PURE;
+
   /**
    * Validates that an operation is thread-safe with respect to this dispatcher; i.e. that the
    * current thread of execution is on the same thread upon which the dispatcher loop is running.
@@ -184,6 +199,13 @@ public:
   virtual void initializeStats(Stats::Scope& scope,
                                const absl::optional<std::string>& prefix = absl::nullopt) PURE;
 
+  /**
+   * @return a moving average of the duration of the iterations of the event loop, excluding the
+   *         time spent polling. This is zero until stats are initialized for this dispatcher.
+   *         This can be called from any thread.
+   */
+  virtual std::chrono::microseconds averageLoopDuration() const PURE;
+
   /**
    * Clears any items in the deferred deletion queue.
    */
@@ -46,6 +46,18 @@ public:
    */
   virtual void sendMessageRaw(Buffer::InstancePtr&& request, bool end_stream) PURE;
 
+  /**
+   * Send request message compressed with the grpc-encoding set in the initial metadata of the
+   * stream, flagged as compressed. Only supported by the Envoy gRPC client: the Google gRPC client
+   * compresses the messages itself, with the algorithm set in the grpc-internal-encoding-request
+   * initial metadata.
+   * @param request compressed serialized message.
+   * @param end_stream close the stream locally. No further methods may be invoked on the stream
+   *                   object, but callbacks may still be received until the stream is closed
+   *                   remotely.
+   */
+  virtual void sendCompressedMessageRaw(Buffer::InstancePtr&& request, bool end_stream) PURE;
+
   /**
    * Close the stream locally and send an empty DATA frame to the remote. No further methods may be
    * invoked on the stream object, but callbacks may still be received until the stream is closed
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
@@ -11,6 +12,7 @@
 #include "envoy/config/core/v3/protocol.pb.h"
 
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Http {
@@ -86,6 +88,17 @@ public:
     MonotonicTime expiration_;
   };
 
+  /**
+   * What was learned of the HTTP/3 connection attempts to an origin.
+   */
+  struct OriginStats {
+    // The smoothed time the attempts which succeeded took to connect, zero if none did.
+    std::chrono::microseconds http3_connect_time_{};
+    // The number of recent attempts which succeeded and failed. Both decay as attempts are made.
+    uint32_t http3_successes_{};
+    uint32_t http3_failures_{};
+  };
+
   virtual ~AlternateProtocolsCache() = default;
 
   /**
@@ -107,6 +120,22 @@ public:
    */
   virtual OptRef<const std::vector<AlternateProtocol>> findAlternatives(const Origin& origin) PURE;
 
+  /**
+   * Records the outcome of an HTTP/3 connection attempt to the specified origin.
+   * @param origin The origin the attempt connected to.
+   * @param succeeded Whether the attempt succeeded.
+   * @param connect_time The time the attempt took to connect, ignored if it failed.
+   */
+  virtual void recordHttp3Attempt(const Origin& origin, bool succeeded,
+                                  std::chrono::microseconds connect_time) PURE;
+
+  /**
+   * Returns what was learned of the HTTP/3 connection attempts to the specified origin.
+   * @param origin The origin to find the stats of.
+   * @return The stats of the origin, or nullopt if no attempt to it was recorded.
+   */
+  virtual absl::optional<OriginStats> findStats(const Origin& origin) PURE;
+
   /**
    * Returns the number of entries in the map.
    * @return the number if entries in the map.
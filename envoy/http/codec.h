@@ -11,6 +11,7 @@
 #include "envoy/http/header_map.h"
 #include "envoy/http/metadata_interface.h"
 #include "envoy/http/protocol.h"
+#include "envoy/http/stream_reset_handler.h"
 #include "envoy/network/address.h"
 #include "envoy/stream_info/stream_info.h"
 
@@ -263,32 +264,6 @@ public:
   virtual void dumpState(std::ostream& os, int indent_level = 0) const PURE;
 };
 
-/**
- * Stream reset reasons.
- */
-enum class StreamResetReason {
-  // If a local codec level reset was sent on the stream.
-  LocalReset,
-  // If a local codec level refused stream reset was sent on the stream (allowing for retry).
-  LocalRefusedStreamReset,
-  // If a remote codec level reset was received on the stream.
-  RemoteReset,
-  // If a remote codec level refused stream reset was received on the stream (allowing for retry).
-  RemoteRefusedStreamReset,
-  // If the stream was locally reset by a connection pool due to an initial connection failure.
-  ConnectionFailure,
-  // If the stream was locally reset due to connection termination.
-  ConnectionTermination,
-  // The stream was reset because of a resource overflow.
-  Overflow,
-  // Either there was an early TCP error for a CONNECT request or the peer reset with CONNECT_ERROR
-  ConnectError,
-  // Received payload did not conform to HTTP protocol.
-  ProtocolError,
-  // If the stream was locally reset by the Overload Manager.
-  OverloadManager
-};
-
 /**
  * Callbacks that fire against a stream.
  */
@@ -319,9 +294,9 @@ public:
 /**
  * An HTTP stream (request, response, and push).
  */
-class Stream {
+class Stream : public StreamResetHandler {
 public:
-  virtual ~Stream() = default;
+  ~Stream() override = default;
 
   /**
    * Add stream callbacks.
@@ -335,12 +310,6 @@ public:
    */
   virtual void removeCallbacks(StreamCallbacks& callbacks) PURE;
 
-  /**
-   * Reset the stream. No events will fire beyond this point.
-   * @param reason supplies the reset reason.
-   */
-  virtual void resetStream(StreamResetReason reason) PURE;
-
   /**
    * Enable/disable further data from this stream.
    * Cessation of data may not be immediate. For example, for HTTP/2 this may stop further flow
@@ -45,6 +45,12 @@ public:
   virtual void onPoolReady(RequestEncoder& encoder, Upstream::HostDescriptionConstSharedPtr host,
                            const StreamInfo::StreamInfo& info,
                            absl::optional<Http::Protocol> protocol) PURE;
+
+  /**
+   * Called once by newStream() to find how the stream waits if it has to be queued.
+   * @return the options of the stream in the pending queue of the pool.
+   */
+  virtual Envoy::ConnectionPool::PendingStreamOptions pendingStreamOptions() const { return {}; }
 };
 
 /**
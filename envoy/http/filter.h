@@ -15,6 +15,7 @@
 #include "envoy/matcher/matcher.h"
 #include "envoy/router/router.h"
 #include "envoy/ssl/connection.h"
+#include "envoy/stats/histogram.h"
 #include "envoy/tracing/http_tracer.h"
 #include "envoy/upstream/upstream.h"
 
@@ -301,6 +302,17 @@ public:
    * Called when filter activity indicates that the stream idle timeout should be reset.
    */
   virtual void resetIdleTimer() PURE;
+
+  /**
+   * Declares that the filter needs no further callbacks in the direction of these callbacks for
+   * the rest of the stream. The decoder filter is no longer called for the body, trailers and
+   * metadata of the request, and the encoder filter is no longer called for any part of the
+   * response, nor for the completion of the stream in that direction. Filters which only look at
+   * the request headers, or only act on some streams, may call it to take themselves out of the
+   * iteration of the stream. It may be called before the encoder filter is first called, or from
+   * a headers callback which returns Continue. The filter must not resume the iteration later.
+   */
+  virtual void skipRemainingCallbacks() PURE;
 };
 
 /**
@@ -1043,6 +1055,13 @@ public:
    * @param handler supplies the handler to add.
    */
   virtual void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) PURE;
+
+  /**
+   * Charge the CPU time of the filters added next to a histogram, recorded in microseconds once
+   * the stream is done. Only called for the streams sampled for the cost of their filters.
+   * @param cpu_time_us supplies the histogram of the filters added next.
+   */
+  virtual void recordFilterCost(Stats::Histogram& cpu_time_us) PURE;
 };
 
 /**
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+
 #include "envoy/network/listen_socket.h"
 
 namespace Envoy {
@@ -35,6 +37,19 @@ public:
 
   virtual void onAcceptWorker(Network::ConnectionSocketPtr&& socket,
                               bool hand_off_restored_destination_connections, bool rebalanced) PURE;
+
+  /**
+   * @return the socket the handler accepts connections from, if the handler owns one. This is
+   *         used by balancers that steer connections to the socket of a handler in the kernel.
+   */
+  virtual Network::SocketOptRef listenSocket() PURE;
+
+  /**
+   * @return a moving average of the event loop iteration duration of the handler's dispatcher.
+   *         This is used by balancers that weight handlers by how busy their worker is, and may be
+   *         called from any thread.
+   */
+  virtual std::chrono::microseconds averageLoopDuration() PURE;
 };
 
 /**
@@ -66,6 +81,12 @@ public:
    */
   virtual BalancedConnectionHandler&
   pickTargetHandler(BalancedConnectionHandler& current_handler) PURE;
+
+  /**
+   * Called after the number of connections within a handler has been decremented.
+   * @param handler supplies the handler of the connection that was closed.
+   */
+  virtual void onConnectionClosed(BalancedConnectionHandler& handler) PURE;
 };
 
 using ConnectionBalancerSharedPtr = std::shared_ptr<ConnectionBalancer>;
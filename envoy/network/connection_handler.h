@@ -1,11 +1,14 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "envoy/network/connection.h"
 #include "envoy/network/connection_balancer.h"
 #include "envoy/network/filter.h"
+#include "envoy/network/io_handle.h"
 #include "envoy/network/listen_socket.h"
 #include "envoy/network/listener.h"
 #include "envoy/ssl/context.h"
@@ -101,6 +104,24 @@ public:
    */
   virtual const std::string& statPrefix() const PURE;
 
+  /**
+   * Closes the TCP connections which have been idle for at least min_idle_time and can be handed
+   * off to another process, see Network::IdleConnectionState. The data still buffered for a
+   * connection is written before its socket is closed by the handler.
+   * @param min_idle_time supplies how long the connections must have been idle for.
+   * @return the duplicates of the sockets of the closed connections.
+   */
+  virtual std::vector<IoHandlePtr>
+  releaseIdleConnections(std::chrono::milliseconds min_idle_time) PURE;
+
+  /**
+   * Adopts a connection handed off by another process, as if it had been accepted by the TCP
+   * listener of its local address.
+   * @param socket supplies the socket of the connection.
+   * @return bool whether a listener took the connection.
+   */
+  virtual bool adoptConnection(ConnectionSocketPtr&& socket) PURE;
+
   /**
    * Used by ConnectionHandler to manage listeners.
    */
@@ -5,6 +5,7 @@
 #include "envoy/buffer/buffer.h"
 #include "envoy/network/listen_socket.h"
 #include "envoy/network/transport_socket.h"
+#include "envoy/stats/histogram.h"
 #include "envoy/stream_info/stream_info.h"
 #include "envoy/upstream/host_description.h"
 
@@ -245,6 +246,14 @@ public:
    * @return true if read filters were initialized successfully, otherwise false.
    */
   virtual bool initializeReadFilters() PURE;
+
+  /**
+   * Charge the CPU time of the filters added next to a histogram, recorded in microseconds once
+   * the connection is closed. Only called for the connections sampled for the cost of their
+   * filters.
+   * @param cpu_time_us supplies the histogram of the filters added next.
+   */
+  virtual void recordFilterCost(Stats::Histogram& cpu_time_us) PURE;
 };
 
 /**
@@ -284,6 +293,18 @@ public:
    */
   virtual void continueFilterChain(bool success) PURE;
 
+  /**
+   * Peek at the data received on the socket, like a recv() with MSG_PEEK. The data peeked is
+   * shared by the listener filters of the socket until the end of the event loop iteration, so
+   * that the filters inspecting the same data in turn peek once at the socket. Filters consuming
+   * data from the socket, such as the proxy protocol filter, read from its IoHandle instead and
+   * must run before the filters peeking at it.
+   * @param buffer supplies the buffer to copy the data peeked into.
+   * @param length supplies the maximum number of bytes to peek.
+   * @return the result of the peek, with the number of bytes copied into the buffer.
+   */
+  virtual Api::IoCallUint64Result peek(void* buffer, uint64_t length) PURE;
+
   /**
    * @param name the namespace used in the metadata in reverse DNS format, for example:
    * envoy.test.my_filter.
@@ -284,6 +284,12 @@ public:
    */
   virtual void onDatagramsDropped(uint32_t dropped) PURE;
 
+  /**
+   * Called after each receive syscall of the underlying socket which read datagrams.
+   * @param datagrams supplies the number of datagrams the syscall read.
+   */
+  virtual void onDatagramsRead(uint64_t datagrams) PURE;
+
   /**
    * Called when the underlying socket is ready for read, before onData() is
    * called. Called only once per event loop, even if followed by multiple
@@ -11,6 +11,10 @@
 #include "envoy/stats/stats_macros.h"
 
 namespace Envoy {
+namespace Event {
+class Dispatcher;
+}
+
 namespace Network {
 
 /**
@@ -107,9 +111,11 @@ public:
   /**
    * Creates an UdpPacketWriter object for the given Udp Socket
    * @param socket UDP socket used to send packets.
+   * @param dispatcher supplies the dispatcher of the thread writing the packets.
    * @return the UdpPacketWriter created.
    */
   virtual UdpPacketWriterPtr createUdpPacketWriter(Network::IoHandle& io_handle,
+                                                   Event::Dispatcher& dispatcher,
                                                    Stats::Scope& scope) PURE;
 };
 
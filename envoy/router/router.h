@@ -458,6 +458,12 @@ public:
    * @return true if the trace span should be sampled.
    */
   virtual bool traceSampled() const PURE;
+
+  /**
+   * @return true if the request should be streamed to the shadow cluster as it is received,
+   *         instead of being buffered.
+   */
+  virtual bool streamBody() const PURE;
 };
 
 using ShadowPolicyPtr = std::unique_ptr<ShadowPolicy>;
@@ -507,7 +513,7 @@ public:
 };
 
 class RateLimitPolicy;
-class Config;
+class CommonConfig;
 
 /**
  * All route specific config returned by the method at
@@ -543,9 +549,11 @@ public:
   virtual const RateLimitPolicy& rateLimitPolicy() const PURE;
 
   /**
-   * @return const Config& the RouteConfiguration that owns this virtual host.
+   * @return const CommonConfig& the settings of the RouteConfiguration that owns this virtual host.
+   *         They are shared by the successive versions of the RouteConfiguration that reuse the
+   *         virtual host, so they do not match routes.
    */
-  virtual const Config& routeConfig() const PURE;
+  virtual const CommonConfig& routeConfig() const PURE;
 
   /**
    * @return const RouteSpecificFilterConfig* the per-filter config pre-processed object for
@@ -583,6 +591,19 @@ public:
   virtual uint32_t retryShadowBufferLimit() const PURE;
 };
 
+/**
+ * Settings of hedging on the latency of the upstream requests of a cluster.
+ */
+struct LatencyHedgeSettings {
+  // The percentile, between 0 and 100, of the recent latencies of the tries of the cluster after
+  // which a hedged request is sent.
+  double percentile_;
+  // The maximum percentage of the requests of the cluster which are hedged on latency.
+  double budget_percent_;
+  // The number of latencies measured for the cluster before requests are hedged on latency.
+  uint32_t min_samples_;
+};
+
 /**
  * Route level hedging policy.
  */
@@ -607,6 +628,12 @@ public:
    * will be canceled immediately.
    */
   virtual bool hedgeOnPerTryTimeout() const PURE;
+
+  /**
+   * @return the settings of hedging on the latency of the upstream requests of the cluster, or
+   * nullptr if requests are not hedged on latency.
+   */
+  virtual const LatencyHedgeSettings* latencyHedge() const PURE;
 };
 
 class MetadataMatchCriterion {
@@ -778,6 +805,12 @@ public:
    */
   virtual Upstream::ResourcePriority priority() const PURE;
 
+  /**
+   * @return the priority of the requests of the route in the pending request queues of the
+   *         connection pools, higher priorities being served first.
+   */
+  virtual uint32_t queuePriority() const PURE;
+
   /**
    * @return const RateLimitPolicy& the rate limit policy for the route.
    */
@@ -1118,12 +1151,48 @@ enum class RouteEvalStatus {
 using RouteCallback = std::function<RouteMatchStatus(RouteConstSharedPtr, RouteEvalStatus)>;
 
 /**
- * The router configuration.
+ * The settings of a router configuration that do not depend on its virtual hosts.
  */
-class Config {
+class CommonConfig {
 public:
-  virtual ~Config() = default;
+  virtual ~CommonConfig() = default;
+
+  /**
+   * Return a list of headers that will be cleaned from any requests that are not from an internal
+   * (RFC1918) source.
+   */
+  virtual const std::list<Http::LowerCaseString>& internalOnlyHeaders() const PURE;
 
+  /**
+   * @return const std::string the RouteConfiguration name.
+   */
+  virtual const std::string& name() const PURE;
+
+  /**
+   * @return whether router configuration uses VHDS.
+   */
+  virtual bool usesVhds() const PURE;
+
+  /**
+   * @return bool whether most specific header mutations should take precedence. The default
+   * evaluation order is route level, then virtual host level and finally global connection
+   * manager level.
+   */
+  virtual bool mostSpecificHeaderMutationsWins() const PURE;
+
+  /**
+   * @return uint32_t The maximum bytes of the response direct response body size. The default value
+   * is 4096.
+   * TODO(dio): To allow overrides at different levels (e.g. per-route, virtual host, etc).
+   */
+  virtual uint32_t maxDirectResponseBodySizeBytes() const PURE;
+};
+
+/**
+ * The router configuration.
+ */
+class Config : public CommonConfig {
+public:
   /**
    * Based on the incoming HTTP request headers, determine the target route (containing either a
    * route entry or a direct response entry) for the request.
@@ -1154,36 +1223,6 @@ public:
   virtual RouteConstSharedPtr route(const RouteCallback& cb, const Http::RequestHeaderMap& headers,
                                     const StreamInfo::StreamInfo& stream_info,
                                     uint64_t random_value) const PURE;
-
-  /**
-   * Return a list of headers that will be cleaned from any requests that are not from an internal
-   * (RFC1918) source.
-   */
-  virtual const std::list<Http::LowerCaseString>& internalOnlyHeaders() const PURE;
-
-  /**
-   * @return const std::string the RouteConfiguration name.
-   */
-  virtual const std::string& name() const PURE;
-
-  /**
-   * @return whether router configuration uses VHDS.
-   */
-  virtual bool usesVhds() const PURE;
-
-  /**
-   * @return bool whether most specific header mutations should take precedence. The default
-   * evaluation order is route level, then virtual host level and finally global connection
-   * manager level.
-   */
-  virtual bool mostSpecificHeaderMutationsWins() const PURE;
-
-  /**
-   * @return uint32_t The maximum bytes of the response direct response body size. The default value
-   * is 4096.
-   * TODO(dio): To allow overrides at different levels (e.g. per-route, virtual host, etc).
-   */
-  virtual uint32_t maxDirectResponseBodySizeBytes() const PURE;
 };
 
 using ConfigConstSharedPtr = std::shared_ptr<const Config>;
@@ -1240,6 +1279,11 @@ public:
    * @return return the connection for the downstream stream.
    */
   virtual const Network::Connection& connection() const PURE;
+  /**
+   * @return the time past which the response can no longer reach the downstream within the global
+   *         timeout of the request, if that timeout is known to be running by then.
+   */
+  virtual absl::optional<MonotonicTime> downstreamDeadline() const PURE;
 };
 
 /**
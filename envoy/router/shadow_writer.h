@@ -4,16 +4,42 @@
 #include <memory>
 #include <string>
 
+#include "envoy/buffer/buffer.h"
 #include "envoy/http/async_client.h"
+#include "envoy/http/header_map.h"
 #include "envoy/http/message.h"
 
 namespace Envoy {
 namespace Router {
 
 /**
- * Interface used to shadow complete requests to an alternate upstream cluster in a "fire and
- * forget" fashion. Right now this interface takes a fully buffered request and cannot be used for
- * streaming. This is sufficient for current use cases.
+ * A request shadowed as it is received. Destroying it before the end of the request has been sent
+ * resets the shadowed request.
+ */
+class ShadowStream {
+public:
+  virtual ~ShadowStream() = default;
+
+  /**
+   * Sends a copy of a part of the body of the request. The shadowed request is dropped instead if
+   * it has fallen behind, or if its response is already complete.
+   * @param data supplies the part of the body.
+   * @param end_stream supplies whether this is the end of the request.
+   */
+  virtual void sendData(const Buffer::Instance& data, bool end_stream) PURE;
+
+  /**
+   * Sends a copy of the trailers of the request, which end it.
+   * @param trailers supplies the trailers.
+   */
+  virtual void sendTrailers(const Http::RequestTrailerMap& trailers) PURE;
+};
+
+using ShadowStreamPtr = std::unique_ptr<ShadowStream>;
+
+/**
+ * Interface used to shadow requests to an alternate upstream cluster in a "fire and forget"
+ * fashion, either fully buffered or streamed as they are received.
  */
 class ShadowWriter {
 public:
@@ -27,6 +53,19 @@ public:
    */
   virtual void shadow(const std::string& cluster, Http::RequestMessagePtr&& request,
                       const Http::AsyncClient::RequestOptions& options) PURE;
+
+  /**
+   * Start shadowing a request whose body and trailers are sent as they are received.
+   * @param cluster supplies the cluster name to shadow to.
+   * @param headers supplies the headers of the request.
+   * @param end_stream supplies whether the request ends with its headers.
+   * @param options supplies the options of the shadowed stream.
+   * @return the shadowed request to send the rest of the request to, or nullptr if it could not
+   *         be started or it ended with its headers.
+   */
+  virtual ShadowStreamPtr streamingShadow(const std::string& cluster,
+                                          Http::RequestHeaderMapPtr&& headers, bool end_stream,
+                                          const Http::AsyncClient::StreamOptions& options) PURE;
 };
 
 using ShadowWriterPtr = std::unique_ptr<ShadowWriter>;
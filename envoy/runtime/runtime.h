@@ -17,6 +17,7 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -27,6 +28,26 @@ class ClusterManager;
 
 namespace Runtime {
 
+/**
+ * A runtime key registered once, such as when the configuration referring to it is loaded, so
+ * that the snapshots can look it up by the index of the handle rather than by hashing the key on
+ * every lookup. Handles are created by Runtime::KeyRegistry::registerKey().
+ */
+class KeyHandle {
+public:
+  // The index of the handles which could not be registered, which are looked up by key.
+  static constexpr uint32_t Unregistered = std::numeric_limits<uint32_t>::max();
+
+  KeyHandle(absl::string_view key, uint32_t index) : key_(key), index_(index) {}
+
+  const std::string& key() const { return key_; }
+  uint32_t index() const { return index_; }
+
+private:
+  const std::string key_;
+  const uint32_t index_;
+};
+
 /**
  * A snapshot of runtime data.
  */
@@ -201,6 +222,36 @@ public:
    */
   virtual bool getBoolean(absl::string_view key, bool default_value) const PURE;
 
+  /**
+   * Variants of the lookups above for registered keys, which the implementations may look up in
+   * constant time. They default to the lookups by key.
+   */
+  virtual bool featureEnabled(const KeyHandle& key, uint64_t default_value) const {
+    return featureEnabled(key.key(), default_value);
+  }
+  virtual bool featureEnabled(const KeyHandle& key, uint64_t default_value,
+                              uint64_t random_value) const {
+    return featureEnabled(key.key(), default_value, random_value);
+  }
+  virtual bool featureEnabled(const KeyHandle& key,
+                              const envoy::type::v3::FractionalPercent& default_value) const {
+    return featureEnabled(key.key(), default_value);
+  }
+  virtual bool featureEnabled(const KeyHandle& key,
+                              const envoy::type::v3::FractionalPercent& default_value,
+                              uint64_t random_value) const {
+    return featureEnabled(key.key(), default_value, random_value);
+  }
+  virtual uint64_t getInteger(const KeyHandle& key, uint64_t default_value) const {
+    return getInteger(key.key(), default_value);
+  }
+  virtual double getDouble(const KeyHandle& key, double default_value) const {
+    return getDouble(key.key(), default_value);
+  }
+  virtual bool getBoolean(const KeyHandle& key, bool default_value) const {
+    return getBoolean(key.key(), default_value);
+  }
+
   /**
    * Fetch the OverrideLayers that provide values in this snapshot. Layers are ordered from bottom
    * to top; for instance, the second layer's entries override the first layer's entries, and so on.
@@ -26,6 +26,9 @@ public:
   struct ServerStatsFromParent {
     uint64_t parent_memory_allocated_ = 0;
     uint64_t parent_connections_ = 0;
+    // The number of replies the stats were received in, and of stats merged.
+    uint64_t parent_stats_replies_ = 0;
+    uint64_t parent_stats_merged_ = 0;
   };
 
   virtual ~HotRestart() = default;
@@ -44,6 +47,13 @@ public:
    */
   virtual int duplicateParentListenSocket(const std::string& address) PURE;
 
+  /**
+   * Retrieve an idle connection the parent process hands off, to be adopted by this process. The
+   * socket of the connection will be duplicated across process boundaries.
+   * @return int the fd or -1 if the parent has no idle connection to hand off.
+   */
+  virtual int duplicateParentIdleConnection() PURE;
+
   /**
    * Initialize the parent logic of our restarter. Meant to be called after initialization of a
    * new child has begun. The hot restart implementation needs to be created early to deal with
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <vector>
 
 #include "envoy/admin/v3/config_dump.pb.h"
@@ -13,6 +14,7 @@
 #include "envoy/server/drain_manager.h"
 #include "envoy/server/filter_config.h"
 #include "envoy/server/guarddog.h"
+#include "envoy/server/worker.h"
 
 #include "source/common/protobuf/protobuf.h"
 
@@ -244,6 +246,22 @@ public:
    * @return TRUE if the worker has started or FALSE if not.
    */
   virtual bool isWorkerStarted() PURE;
+
+  /**
+   * Close the connections of all the workers which have been idle for at least min_idle_time and
+   * can be handed off to another process. This is used for hot restart.
+   * @param min_idle_time supplies how long the connections must have been idle for.
+   * @param completion supplies the completion to be called on the main thread, once per worker,
+   * with the duplicates of the sockets of the connections closed by the worker.
+   */
+  virtual void releaseIdleConnections(std::chrono::milliseconds min_idle_time,
+                                      Worker::ReleaseIdleConnectionsCompletion completion) PURE;
+
+  /**
+   * Adopt a connection handed off by another process, on one of the workers.
+   * @param socket supplies the socket of the connection.
+   */
+  virtual void adoptConnection(Network::ConnectionSocketPtr&& socket) PURE;
 };
 
 // overload operator| to allow ListenerManager::listeners(ListenerState) to be called using a
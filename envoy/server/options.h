@@ -183,6 +183,11 @@ public:
    */
   virtual bool enableFineGrainLogging() const PURE;
 
+  /**
+   * @return const bool whether to write the application logs from a background thread.
+   */
+  virtual bool enableAsyncLogging() const PURE;
+
   /**
    * @return const std::string& the log file path.
    */
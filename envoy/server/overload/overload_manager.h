@@ -34,10 +34,29 @@ public:
 
   // Overload action to reduce some subset of configured timeouts.
   const std::string ReduceTimeouts = "envoy.overload_actions.reduce_timeouts";
+
+  // Overload action to reset the streams using the most buffer memory.
+  const std::string ResetStreams = "envoy.overload_actions.reset_high_memory_stream";
 };
 
 using OverloadActionNames = ConstSingleton<OverloadActionNameValues>;
 
+/**
+ * Well-known load shed point names. Load shed points are overload actions configured like the
+ * others, which guard optional work: the work is skipped with a probability of the action state,
+ * i.e. always once the action is saturated. They are read from the thread-local overload state.
+ */
+class LoadShedPointNameValues {
+public:
+  // Load shed point to stop tracing new HTTP requests.
+  const std::string HttpTracing = "envoy.load_shed_points.http_tracing";
+
+  // Load shed point to stop shadowing new requests in the router.
+  const std::string RouterShadowing = "envoy.load_shed_points.router_shadowing";
+};
+
+using LoadShedPointNames = ConstSingleton<LoadShedPointNameValues>;
+
 /**
  * The OverloadManager protects the Envoy instance from being overwhelmed by client
  * requests. It monitors a set of resources and notifies registered listeners if
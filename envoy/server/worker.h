@@ -1,8 +1,12 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
+#include <vector>
 
 #include "envoy/event/dispatcher.h"
+#include "envoy/network/io_handle.h"
+#include "envoy/network/listen_socket.h"
 #include "envoy/server/guarddog.h"
 #include "envoy/server/overload/overload_manager.h"
 
@@ -90,6 +94,30 @@ public:
    */
   virtual void stopListener(Network::ListenerConfig& listener,
                             std::function<void()> completion) PURE;
+
+  /**
+   * Completion called with the duplicates of the sockets of the connections released by a worker.
+   */
+  using ReleaseIdleConnectionsCompletion =
+      std::function<void(std::vector<Network::IoHandlePtr>&& released)>;
+
+  /**
+   * Close the connections of the worker which have been idle for at least min_idle_time and can
+   * be handed off to another process. This is used for hot restart.
+   * @param min_idle_time supplies how long the connections must have been idle for.
+   * @param completion supplies the completion to be called with the duplicates of the sockets of
+   * the closed connections. This completion is called on the worker thread. No locking is
+   * performed by the worker.
+   */
+  virtual void releaseIdleConnections(std::chrono::milliseconds min_idle_time,
+                                      ReleaseIdleConnectionsCompletion completion) PURE;
+
+  /**
+   * Adopt a connection handed off by another process. The connection is closed if none of the
+   * listeners of the worker takes it.
+   * @param socket supplies the socket of the connection.
+   */
+  virtual void adoptConnection(Network::ConnectionSocketPtr&& socket) PURE;
 };
 
 using WorkerPtr = std::unique_ptr<Worker>;
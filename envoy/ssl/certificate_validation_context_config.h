@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -74,6 +75,16 @@ public:
   virtual const absl::optional<envoy::config::core::v3::TypedExtensionConfig>&
   customValidatorConfig() const PURE;
 
+  /**
+   * @return the maximum number of verified certificate chains cached, or 0 if they aren't cached.
+   */
+  virtual uint32_t verifiedCertChainCacheMaxEntries() const PURE;
+
+  /**
+   * @return how long a verified certificate chain is cached for.
+   */
+  virtual std::chrono::milliseconds verifiedCertChainCacheTtl() const PURE;
+
   /**
    * @return a reference to the api object.
    */
@@ -9,6 +9,7 @@
 #include "envoy/common/pure.h"
 #include "envoy/ssl/certificate_validation_context_config.h"
 #include "envoy/ssl/handshaker.h"
+#include "envoy/ssl/session_cache.h"
 #include "envoy/ssl/tls_certificate_config.h"
 
 #include "absl/types/optional.h"
@@ -89,6 +90,12 @@ public:
    * @return a callback for configuring an SSL_CTX before use.
    */
   virtual SslCtxCb sslctxCb() const PURE;
+
+  /**
+   * @return true if the TLS records of the connections are to be offloaded to the kernel once
+   *         their handshake completes.
+   */
+  virtual bool kernelTlsEnabled() const PURE;
 };
 
 class ClientContextConfig : public virtual ContextConfig {
@@ -162,6 +169,12 @@ public:
    * @return True if stateless TLS session resumption is disabled, false otherwise.
    */
   virtual bool disableStatelessSessionResumption() const PURE;
+
+  /**
+   * @return the cache of the sessions resumed by session ID, or nullptr to use the session cache of
+   * the context alone.
+   */
+  virtual SessionCacheSharedPtr sessionCache() const PURE;
 };
 
 using ServerContextConfigPtr = std::unique_ptr<ServerContextConfig>;
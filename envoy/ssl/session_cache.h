@@ -0,0 +1,102 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "envoy/common/pure.h"
+#include "envoy/config/typed_config.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/protobuf/message_validator.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Server {
+namespace Configuration {
+// Prevent a dependency loop with the forward declaration.
+class TransportSocketFactoryContext;
+} // namespace Configuration
+} // namespace Server
+
+namespace Ssl {
+
+/**
+ * A lookup in progress in a SessionCache. Destroying it cancels the lookup.
+ */
+class SessionCacheLookupHandle {
+public:
+  virtual ~SessionCacheLookupHandle() = default;
+};
+
+using SessionCacheLookupHandlePtr = std::unique_ptr<SessionCacheLookupHandle>;
+
+/**
+ * A cache of the TLS sessions of server contexts, keyed by session ID, so that the sessions
+ * established with a context can be resumed with the other contexts sharing the cache, e.g. on
+ * other listeners, after a listener update, or on other Envoy instances for a remote cache.
+ * Sessions are stored serialized, as by SSL_SESSION_to_bytes(). The sessions of a context can only
+ * be resumed with the contexts having the same session ID context. Thread safe.
+ */
+class SessionCache {
+public:
+  virtual ~SessionCache() = default;
+
+  /**
+   * Called with the serialized session of a lookup, or nullopt on a miss.
+   */
+  using LookupCallback = std::function<void(absl::optional<std::string>&& session)>;
+
+  /**
+   * Stores a session, replacing the session with the same ID if any.
+   * @param session_id supplies the ID of the session.
+   * @param session supplies the serialized session.
+   * @param timeout supplies how long the session can be resumed.
+   */
+  virtual void insert(absl::string_view session_id, std::string&& session,
+                      std::chrono::seconds timeout) PURE;
+
+  /**
+   * Looks up a session.
+   * @param session_id supplies the ID of the session.
+   * @param dispatcher supplies the dispatcher of the worker of the lookup.
+   * @param cb supplies the callback called with the result of the lookup, either before lookup()
+   *        returns or later on the dispatcher.
+   * @return the handle of the lookup, or nullptr if the callback has been called already.
+   */
+  virtual SessionCacheLookupHandlePtr lookup(absl::string_view session_id,
+                                             Event::Dispatcher& dispatcher,
+                                             LookupCallback cb) PURE;
+
+  /**
+   * Removes a session, e.g. as it couldn't be resumed.
+   * @param session_id supplies the ID of the session.
+   */
+  virtual void remove(absl::string_view session_id) PURE;
+};
+
+using SessionCacheSharedPtr = std::shared_ptr<SessionCache>;
+
+/**
+ * A factory of the session caches configured in the session_cache field of a downstream TLS
+ * context.
+ */
+class SessionCacheFactory : public Config::TypedFactory {
+public:
+  /**
+   * @param config supplies the config of the cache.
+   * @param factory_context supplies the factory context of the TLS context.
+   * @return the session cache. Contexts configured with the same cache may share it.
+   * @throw EnvoyException if the config is invalid.
+   */
+  virtual SessionCacheSharedPtr
+  createSessionCache(const Protobuf::Message& config,
+                     Server::Configuration::TransportSocketFactoryContext& factory_context) PURE;
+
+  std::string category() const override { return "envoy.tls.session_cache"; }
+};
+
+} // namespace Ssl
+} // namespace Envoy
@@ -37,6 +37,18 @@ public:
   virtual CounterSharedPtr makeCounter(StatName name, StatName tag_extracted_name,
                                        const StatNameTagVector& stat_name_tags) PURE;
 
+  /**
+   * Like makeCounter, but the counter is sharded so that threads incrementing it concurrently do
+   * not contend on one cache line. Reading the value of a sharded counter is slower as the
+   * shards must be summed. If a counter of the same name already exists it is returned as is.
+   * @param name the full name of the stat.
+   * @param tag_extracted_name the name of the stat with tag-values stripped out.
+   * @param tags the tag values.
+   * @return CounterSharedPtr a counter.
+   */
+  virtual CounterSharedPtr makeShardedCounter(StatName name, StatName tag_extracted_name,
+                                              const StatNameTagVector& stat_name_tags) PURE;
+
   /**
    * @param name the full name of the stat.
    * @param tag_extracted_name the name of the stat with tag-values stripped out.
@@ -5,6 +5,7 @@
 #include "envoy/stats/histogram.h"
 #include "envoy/stats/stats.h"
 
+#include "source/common/stats/lazy_metric_impl.h"
 #include "source/common/stats/symbol_table_impl.h"
 #include "source/common/stats/utility.h"
 
@@ -124,6 +125,7 @@ static inline std::string statPrefixJoin(absl::string_view prefix, absl::string_
   , NAME##_(Envoy::Stats::Utility::textReadoutFromStatNames(scope, {prefix, stat_names.NAME##_}))
 
 #define MAKE_STATS_STRUCT_STATNAME_HELPER_(name)
+#define MAKE_STATS_STRUCT_FROM_LAZY_HELPER_(NAME, ...) , NAME##_(lazy_stats.NAME##_)
 #define GENERATE_STATNAME_STRUCT(name)
 
 /**
@@ -159,9 +161,47 @@ static inline std::string statPrefixJoin(absl::string_view prefix, absl::string_
                         MAKE_STATS_STRUCT_HISTOGRAM_HELPER_,                                       \
                         MAKE_STATS_STRUCT_TEXT_READOUT_HELPER_,                                    \
                         MAKE_STATS_STRUCT_STATNAME_HELPER_) {}                                     \
+    template <class LazyStatsStruct, class = typename LazyStatsStruct::IsLazyStatsStruct>          \
+    explicit StatsStruct(LazyStatsStruct& lazy_stats)                                              \
+        : stat_names_(lazy_stats.stat_names_)                                                      \
+              ALL_STATS(MAKE_STATS_STRUCT_FROM_LAZY_HELPER_, MAKE_STATS_STRUCT_FROM_LAZY_HELPER_,  \
+                        MAKE_STATS_STRUCT_FROM_LAZY_HELPER_, MAKE_STATS_STRUCT_FROM_LAZY_HELPER_,  \
+                        MAKE_STATS_STRUCT_STATNAME_HELPER_) {}                                     \
     const StatNamesStruct& stat_names_;                                                            \
     ALL_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT,           \
               GENERATE_TEXT_READOUT_STRUCT, GENERATE_STATNAME_STRUCT)                              \
   }
 
+// Macros for declaring a struct of placeholders for the stats in a MAKE_STATS_STRUCT, which are
+// only created in the scope when they are first written. See Stats::LazyMetricImpl. Text readouts
+// are created up front. The stats struct is then constructed from the placeholders with
+//   StatsStruct stats(lazy_stats);
+// and must not outlive them.
+#define GENERATE_LAZY_COUNTER_STRUCT(NAME) Envoy::Stats::LazyCounterImpl NAME##_;
+#define GENERATE_LAZY_GAUGE_STRUCT(NAME, MODE) Envoy::Stats::LazyGaugeImpl NAME##_;
+#define GENERATE_LAZY_HISTOGRAM_STRUCT(NAME, UNIT) Envoy::Stats::LazyHistogramImpl NAME##_;
+
+#define MAKE_LAZY_STATS_STRUCT_COUNTER_HELPER_(NAME) , NAME##_(scope, prefix, stat_names.NAME##_)
+#define MAKE_LAZY_STATS_STRUCT_GAUGE_HELPER_(NAME, MODE)                                           \
+  , NAME##_(scope, prefix, stat_names.NAME##_, Envoy::Stats::Gauge::ImportMode::MODE)
+#define MAKE_LAZY_STATS_STRUCT_HISTOGRAM_HELPER_(NAME, UNIT)                                       \
+  , NAME##_(scope, prefix, stat_names.NAME##_, Envoy::Stats::Histogram::Unit::UNIT)
+
+#define MAKE_LAZY_STATS_STRUCT(LazyStatsStruct, StatNamesStruct, ALL_STATS)                        \
+  struct LazyStatsStruct {                                                                         \
+    using IsLazyStatsStruct = void;                                                                \
+    LazyStatsStruct(const StatNamesStruct& stat_names, Envoy::Stats::Scope& scope,                 \
+                    Envoy::Stats::StatName prefix = Envoy::Stats::StatName())                      \
+        : stat_names_(stat_names)                                                                  \
+              ALL_STATS(MAKE_LAZY_STATS_STRUCT_COUNTER_HELPER_,                                    \
+                        MAKE_LAZY_STATS_STRUCT_GAUGE_HELPER_,                                      \
+                        MAKE_LAZY_STATS_STRUCT_HISTOGRAM_HELPER_,                                  \
+                        MAKE_STATS_STRUCT_TEXT_READOUT_HELPER_,                                    \
+                        MAKE_STATS_STRUCT_STATNAME_HELPER_) {}                                     \
+    const StatNamesStruct& stat_names_;                                                            \
+    ALL_STATS(GENERATE_LAZY_COUNTER_STRUCT, GENERATE_LAZY_GAUGE_STRUCT,                            \
+              GENERATE_LAZY_HISTOGRAM_STRUCT, GENERATE_TEXT_READOUT_STRUCT,                        \
+              GENERATE_STATNAME_STRUCT)                                                            \
+  }
+
 } // namespace Envoy
@@ -9,6 +9,7 @@
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_matcher.h"
 #include "envoy/stats/tag_producer.h"
+#include "envoy/thread/thread.h"
 
 namespace Envoy {
 namespace Event {
@@ -79,12 +80,29 @@ public:
    */
   virtual void setStatsMatcher(StatsMatcherPtr&& stats_matcher) PURE;
 
+  /**
+   * Attach a StatsMatcher to this StoreRoot selecting the counters which are created sharded,
+   * see Allocator::makeShardedCounter. Counters the matcher rejects are created as usual. This
+   * must be called before the counters to be sharded are created.
+   * @param sharded_counter_matcher a StatsMatcher, or nullptr to not shard any counters.
+   */
+  virtual void setShardedCounterMatcher(StatsMatcherPtr&& sharded_counter_matcher) PURE;
+
   /**
    * Attach a HistogramSettings to this StoreRoot to generate histogram configurations
    * according to some ruleset.
    */
   virtual void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) PURE;
 
+  /**
+   * Merge the thread local histograms in mergeHistograms() on a pool of threads, rather than on
+   * the main thread. This must be called before initializeThreading().
+   * @param thread_factory used to create the threads.
+   * @param num_threads the number of threads, or 0 to merge on the main thread.
+   */
+  virtual void setHistogramMergeThreads(Thread::ThreadFactory& thread_factory,
+                                        uint32_t num_threads) PURE;
+
   /**
    * Initialize the store for threading. This will be called once after all worker threads have
    * been initialized. At this point the store can initialize itself for multi-threaded operation.
@@ -183,6 +183,19 @@ public:
    */
   virtual DynamicSpans getDynamicSpans(StatName stat_name) const PURE;
 
+  using SymbolFn = std::function<void(uint32_t, absl::string_view)>;
+
+  /**
+   * Calls the provided function with every symbol currently in the table and
+   * the token it decodes to. This lets the encoded form of StatNames be
+   * exported along with the tokens needed to decode it. The table is locked
+   * for the duration of the iteration, so the function must not call back into
+   * the symbol table.
+   *
+   * @param fn the function to call for every symbol.
+   */
+  virtual void iterateSymbols(const SymbolFn& fn) const PURE;
+
 private:
   friend struct HeapStatData;
   friend class StatNameDynamicStorage;
@@ -56,6 +56,7 @@ using ThreadPtr = std::unique_ptr<Thread>;
 // Options specified during thread creation.
 struct Options {
   std::string name_; // A name supplied for the thread. On Linux this is limited to 15 chars.
+  absl::optional<uint32_t> cpu_; // A CPU to pin the thread to. This is only supported on Linux.
 };
 
 using OptionsOptConstRef = const absl::optional<Options>&;
@@ -113,6 +113,17 @@ public:
    */
   virtual void finishSpan() PURE;
 
+  /**
+   * Like finishSpan(), for a span which actually finished earlier, e.g. while its trace was
+   * awaiting a tail sampling decision. The implementations which can't backdate the end of a span
+   * finish it at the current time.
+   * @param end_time the time the span finished.
+   * @param monotonic_end_time the monotonic time the span finished.
+   */
+  virtual void finishSpanAt(SystemTime /* end_time */, MonotonicTime /* monotonic_end_time */) {
+    finishSpan();
+  }
+
   /**
    * Mutate the provided headers with the context necessary to propagate this
    * (implementation-specific) trace.
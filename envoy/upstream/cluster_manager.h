@@ -15,9 +15,11 @@
 #include "envoy/config/core/v3/protocol.pb.h"
 #include "envoy/config/grpc_mux.h"
 #include "envoy/config/subscription_factory.h"
+#include "envoy/event/dispatcher.h"
 #include "envoy/grpc/async_client_manager.h"
 #include "envoy/http/conn_pool.h"
 #include "envoy/local_info/local_info.h"
+#include "envoy/protobuf/message_validator.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/secret/secret_manager.h"
 #include "envoy/server/admin.h"
@@ -120,6 +122,51 @@ struct ClusterConnectivityState {
   int64_t connecting_and_connected_stream_capacity_{};
 };
 
+/**
+ * The outcome of an on demand discovery of a cluster.
+ */
+enum class ClusterDiscoveryStatus {
+  // The discovery service does not know the cluster, or told so in the past.
+  Missing,
+  // The cluster was not received in time.
+  Timeout,
+  // The cluster is available to the worker the discovery was requested from.
+  Available,
+};
+
+/**
+ * Called on the worker the discovery of a cluster was requested from, once it is done.
+ */
+using ClusterDiscoveryCallback = std::function<void(ClusterDiscoveryStatus)>;
+using ClusterDiscoveryCallbackSharedPtr = std::shared_ptr<ClusterDiscoveryCallback>;
+using ClusterDiscoveryCallbackWeakPtr = std::weak_ptr<ClusterDiscoveryCallback>;
+
+/**
+ * A handle to an on demand CDS subscription, used by the workers to discover the clusters they
+ * need as they are referenced by requests.
+ */
+class OdCdsApiHandle {
+public:
+  virtual ~OdCdsApiHandle() = default;
+
+  /**
+   * Request the discovery of a cluster, unless the worker already has it, in which case the
+   * callback is invoked at once. Otherwise the callback is invoked on this worker once the cluster
+   * is added, once the discovery service tells that it does not know the cluster, or once the
+   * timeout expires. The discoveries of a cluster requested while one is in progress share it.
+   * The callback is only held weakly, so that the requester can cancel the discovery by
+   * releasing it.
+   * @param name supplies the name of the cluster.
+   * @param callback supplies the callback invoked once the discovery is done.
+   * @param timeout supplies the time to wait for the cluster.
+   */
+  virtual void requestOnDemandClusterDiscovery(absl::string_view name,
+                                               ClusterDiscoveryCallbackWeakPtr callback,
+                                               std::chrono::milliseconds timeout) PURE;
+};
+
+using OdCdsApiHandleSharedPtr = std::shared_ptr<OdCdsApiHandle>;
+
 /**
  * Manages connection pools and load balancing for upstream clusters. The cluster manager is
  * persistent and shared among multiple ongoing requests/connections.
@@ -310,6 +357,38 @@ public:
   virtual const ClusterRequestResponseSizeStatNames&
   clusterRequestResponseSizeStatNames() const PURE;
   virtual const ClusterTimeoutBudgetStatNames& clusterTimeoutBudgetStatNames() const PURE;
+
+  /**
+   * @return whether clusters should create each of their ClusterStats only when it is first
+   *         written, per StatsConfig.lazy_cluster_stats.
+   */
+  virtual bool lazyClusterStats() const PURE;
+
+  /**
+   * Runs work on one of the threads configured with cluster_manager.cluster_init_threads, which
+   * take CPU heavy parts of creating clusters, such as building their TLS contexts, off the main
+   * thread, and then posts done to the main thread. Both are dropped if the cluster manager is
+   * destroyed before work runs.
+   * @param work supplies the callback to run on a cluster init thread.
+   * @param done supplies the callback to run on the main thread once work has run.
+   * @return false if there are no such threads, in which case neither callback is run.
+   */
+  virtual bool runOnClusterInitThread(std::function<void()> work, Event::PostCb done) PURE;
+
+  /**
+   * Allocate an on demand CDS subscription, the clusters of which are only requested as they are
+   * referenced. The subscriptions allocated with the same configuration are shared, and are only
+   * started with the first discovery. Must be called on the main thread.
+   * @param odcds_config supplies the configuration of the discovery service.
+   * @param negative_cache_ttl supplies how long a cluster the discovery service does not know is
+   *        considered missing without asking it again, zero disabling the negative cache.
+   * @param validation_visitor supplies the validation visitor of the discovered clusters.
+   * @return OdCdsApiHandleSharedPtr the handle to request the discoveries with, from any thread.
+   */
+  virtual OdCdsApiHandleSharedPtr
+  allocateOdCdsApi(const envoy::config::core::v3::ConfigSource& odcds_config,
+                   std::chrono::milliseconds negative_cache_ttl,
+                   ProtobufMessage::ValidationVisitor& validation_visitor) PURE;
 };
 
 using ClusterManagerPtr = std::unique_ptr<ClusterManager>;
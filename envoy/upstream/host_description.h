@@ -1,5 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -12,21 +17,120 @@
 #include "envoy/stats/primitive_stats_macros.h"
 #include "envoy/stats/stats_macros.h"
 #include "envoy/upstream/health_check_host_monitor.h"
+#include "envoy/upstream/locality.h"
 #include "envoy/upstream/outlier_detection.h"
 
+#include "source/common/common/non_copyable.h"
+
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Upstream {
 
 using MetadataConstSharedPtr = std::shared_ptr<const envoy::config::core::v3::Metadata>;
 
+/**
+ * The load of the hosts of a cluster in a locality, as reported by LoadStatsReporter. The hosts
+ * count their requests into it along with their own stats, so that a load report reads one of these
+ * per locality rather than the stats of every host. The counts are spread over stripes picked by
+ * thread, so that the workers counting the requests of a locality rarely share a cache line.
+ */
+class LocalityLoadStats : NonCopyable {
+public:
+  // The load of the locality since it was last latched, with the requests in progress.
+  struct Load {
+    uint64_t rq_success_{};
+    uint64_t rq_error_{};
+    uint64_t rq_active_{};
+    uint64_t rq_issued_{};
+  };
+
+  void incRqSuccess() { stripe().rq_success_.inc(); }
+  void incRqError() { stripe().rq_error_.inc(); }
+  void incRqTotal() { stripe().rq_total_.inc(); }
+  void incRqActive() { stripe().rq_active_++; }
+  // A request may end on another thread than the one it started on, so the requests in progress
+  // of a stripe may go below zero, but not their sum.
+  void decRqActive() { stripe().rq_active_--; }
+
+  Load latch() {
+    Load load;
+    int64_t rq_active = 0;
+    for (Stripe& stripe : stripes_) {
+      load.rq_success_ += stripe.rq_success_.latch();
+      load.rq_error_ += stripe.rq_error_.latch();
+      load.rq_issued_ += stripe.rq_total_.latch();
+      rq_active += stripe.rq_active_;
+    }
+    // The stripes are read one by one while requests start and end on the workers.
+    load.rq_active_ = std::max<int64_t>(rq_active, 0);
+    return load;
+  }
+
+private:
+  static constexpr uint32_t Stripes = 8;
+
+  struct alignas(64) Stripe {
+    Stats::PrimitiveCounter rq_success_;
+    Stats::PrimitiveCounter rq_error_;
+    Stats::PrimitiveCounter rq_total_;
+    std::atomic<int64_t> rq_active_{};
+  };
+
+  Stripe& stripe() {
+    // Each thread counts into the stripe it is given on first use, round robin.
+    static std::atomic<uint32_t> next_stripe{};
+    static thread_local const uint32_t thread_stripe = next_stripe++ % Stripes;
+    return stripes_[thread_stripe];
+  }
+
+  std::array<Stripe, Stripes> stripes_;
+};
+
+/**
+ * The load of the hosts of a cluster per locality. @see LocalityLoadStats
+ */
+class LocalityLoadStatsMap : NonCopyable {
+public:
+  /**
+   * @return the load of a locality, created on first use. It lives as long as the map.
+   */
+  LocalityLoadStats& get(const envoy::config::core::v3::Locality& locality) {
+    absl::MutexLock lock(&mutex_);
+    auto& locality_load_stats = map_[locality];
+    if (locality_load_stats == nullptr) {
+      locality_load_stats = std::make_unique<LocalityLoadStats>();
+    }
+    return *locality_load_stats;
+  }
+
+  /**
+   * Invoke a callback for the load of each locality.
+   */
+  void iterate(const std::function<void(LocalityLoadStats&)>& callback) {
+    absl::MutexLock lock(&mutex_);
+    for (auto& locality_load_stats : map_) {
+      callback(*locality_load_stats.second);
+    }
+  }
+
+private:
+  absl::Mutex mutex_;
+  absl::flat_hash_map<envoy::config::core::v3::Locality, std::unique_ptr<LocalityLoadStats>,
+                      LocalityHash, LocalityEqualTo>
+      map_ ABSL_GUARDED_BY(mutex_);
+};
+
 /**
  * All per host stats. @see stats_macros.h
  *
  * {rq_success, rq_error} have specific semantics driven by the needs of EDS load reporting. See
  * envoy.api.v2.endpoint.UpstreamLocalityStats for the definitions of success/error. These are
- * latched by LoadStatsReporter, independent of the normal stats sink flushing.
+ * reported by LoadStatsReporter from the LocalityLoadStats of the host, independent of the normal
+ * stats sink flushing, so they are to be counted with the methods of HostStats rather than on the
+ * stats directly.
  */
 #define ALL_HOST_STATS(COUNTER, GAUGE)                                                             \
   COUNTER(cx_connect_fail)                                                                         \
@@ -53,10 +157,67 @@ struct HostStats {
   std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>> gauges() const {
     return {ALL_HOST_STATS(IGNORE_PRIMITIVE_COUNTER, PRIMITIVE_GAUGE_NAME_AND_REFERENCE)};
   }
+
+  // Count a request of the host, in its stats and in the load of its locality.
+  void incRqSuccess() {
+    rq_success_.inc();
+    if (locality_load_stats_ != nullptr) {
+      locality_load_stats_->incRqSuccess();
+    }
+  }
+  void incRqError() {
+    rq_error_.inc();
+    if (locality_load_stats_ != nullptr) {
+      locality_load_stats_->incRqError();
+    }
+  }
+  void incRqTotal() {
+    rq_total_.inc();
+    if (locality_load_stats_ != nullptr) {
+      locality_load_stats_->incRqTotal();
+    }
+  }
+  void incRqActive() {
+    rq_active_.inc();
+    if (locality_load_stats_ != nullptr) {
+      locality_load_stats_->incRqActive();
+    }
+  }
+  void decRqActive() {
+    rq_active_.dec();
+    if (locality_load_stats_ != nullptr) {
+      locality_load_stats_->decRqActive();
+    }
+  }
+
+  // The load of the locality of the host, owned by the cluster of the host. Not set for the hosts
+  // that don't come from a cluster, such as the mocks.
+  LocalityLoadStats* locality_load_stats_{};
 };
 
 class ClusterInfo;
 
+/**
+ * Tracks the response times of a host for use by latency aware load balancers.
+ */
+class ResponseTimeTracker {
+public:
+  virtual ~ResponseTimeTracker() = default;
+
+  /**
+   * Record the response time of a completed request.
+   * @param response_time supplies the time from the end of the downstream request to the end of
+   *        the upstream response.
+   */
+  virtual void putResponseTime(std::chrono::microseconds response_time) PURE;
+
+  /**
+   * @return the current estimate of the host's response time in microseconds, or 0 if no response
+   *         time has been recorded yet.
+   */
+  virtual double responseTime() const PURE;
+};
+
 /**
  * A description of an upstream host.
  */
@@ -99,6 +260,12 @@ public:
    */
   virtual HealthCheckHostMonitor& healthChecker() const PURE;
 
+  /**
+   * @return the host's response time tracker, or nullptr if the cluster's load balancer does not
+   *         use response times.
+   */
+  virtual ResponseTimeTracker* responseTimeTracker() const PURE;
+
   /**
    * @return The hostname used as the host header for health checking.
    */
@@ -22,7 +22,8 @@ enum class LoadBalancerType {
   RingHash,
   OriginalDst,
   Maglev,
-  ClusterProvided
+  ClusterProvided,
+  PeakEwma
 };
 
 /**
@@ -107,6 +108,17 @@ public:
    * elements in a list value defined in endpoint metadata.
    */
   virtual bool listAsAny() const PURE;
+
+  /*
+   * @return bool whether subset load balancers are only built when a subset is first selected.
+   */
+  virtual bool lazyBuild() const PURE;
+
+  /*
+   * @return uint32_t the maximum number of subset load balancers kept built when building lazily,
+   * or 0 if unlimited.
+   */
+  virtual uint32_t maxBuiltSubsets() const PURE;
 };
 
 } // namespace Upstream
@@ -110,6 +110,13 @@ public:
    * and LocalOrigin type returns success rate for local origin errors.
    */
   virtual double successRate(SuccessRateMonitorType type) const PURE;
+
+  /**
+   * @return the 99th percentile response time of the host in the last calculated interval, in
+   *         milliseconds. -1 means that the host did not have enough request volume to calculate it
+   *         or latency based outlier ejection is not configured.
+   */
+  virtual double latency() const PURE;
 };
 
 using DetectorHostMonitorPtr = std::unique_ptr<DetectorHostMonitor>;
@@ -150,6 +157,22 @@ public:
    */
   virtual double
       successRateEjectionThreshold(DetectorHostMonitor::SuccessRateMonitorType) const PURE;
+
+  /**
+   * Returns the median of the 99th percentile response times of the hosts in the Detector for the
+   * last aggregation interval, in milliseconds.
+   * @return the median, or -1 if there were not enough hosts with enough request volume to proceed
+   *         with latency based outlier ejection.
+   */
+  virtual double latencyMedian() const PURE;
+
+  /**
+   * Returns the latency threshold used in the last interval, in milliseconds. The hosts whose 99th
+   * percentile response time is above it are ejected.
+   * @return the threshold, or -1 if there were not enough hosts with enough request volume to
+   *         proceed with latency based outlier ejection.
+   */
+  virtual double latencyEjectionThreshold() const PURE;
 };
 
 using DetectorSharedPtr = std::shared_ptr<Detector>;
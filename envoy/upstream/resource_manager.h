@@ -31,6 +31,16 @@ private:
 
 using ResourceAutoIncDecPtr = std::unique_ptr<ResourceAutoIncDec>;
 
+/**
+ * A retry budget which each worker enforces on its own requests.
+ */
+struct WorkerRetryBudgetSettings {
+  // The percentage of the requests of a worker which may be retried.
+  double budget_percent_;
+  // The number of retries a worker may send every second whatever its traffic.
+  uint32_t min_retry_concurrency_;
+};
+
 /**
  * Global resource manager that loosely synchronizes maximum connections, pending requests, etc.
  * NOTE: Currently this is used on a per cluster basis. In the future we may consider also chaining
@@ -62,6 +72,12 @@ public:
    */
   virtual ResourceLimit& retries() PURE;
 
+  /**
+   * @return the retry budget enforced by each worker, or nullptr if the retries are limited by
+   *         retries().
+   */
+  virtual const WorkerRetryBudgetSettings* workerRetryBudget() const PURE;
+
   /**
    * @return ResourceLimit& active connection pools.
    */
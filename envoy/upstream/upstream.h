@@ -188,6 +188,18 @@ public:
    * @param new_used supplies the new value of host being in use to be stored.
    */
   virtual void used(bool new_used) PURE;
+
+  /**
+   * @return the last time the host passed an active health check after failing active health
+   * checks, if ever. This is where the slow start window of a host begins if it's later than its
+   * creation time.
+   */
+  virtual absl::optional<MonotonicTime> lastHcPassTime() const PURE;
+
+  /**
+   * Set the last time the host passed an active health check after failing active health checks.
+   */
+  virtual void setLastHcPassTime(MonotonicTime last_hc_pass_time) PURE;
 };
 
 using HostConstSharedPtr = std::shared_ptr<const Host>;
@@ -541,25 +553,35 @@ public:
   COUNTER(upstream_cx_http1_total)                                                                 \
   COUNTER(upstream_cx_http2_total)                                                                 \
   COUNTER(upstream_cx_http3_total)                                                                 \
+  COUNTER(upstream_cx_idle_overflow)                                                               \
   COUNTER(upstream_cx_idle_timeout)                                                                \
   COUNTER(upstream_cx_max_requests)                                                                \
   COUNTER(upstream_cx_none_healthy)                                                                \
   COUNTER(upstream_cx_overflow)                                                                    \
   COUNTER(upstream_cx_pool_overflow)                                                               \
+  COUNTER(upstream_cx_preconnect_unused)                                                           \
   COUNTER(upstream_cx_protocol_error)                                                              \
   COUNTER(upstream_cx_rx_bytes_total)                                                              \
   COUNTER(upstream_cx_total)                                                                       \
   COUNTER(upstream_cx_tx_bytes_total)                                                              \
+  COUNTER(upstream_cx_warm_up)                                                                     \
   COUNTER(upstream_flow_control_backed_up_total)                                                   \
   COUNTER(upstream_flow_control_drained_total)                                                     \
   COUNTER(upstream_flow_control_paused_reading_total)                                              \
   COUNTER(upstream_flow_control_resumed_reading_total)                                             \
+  COUNTER(upstream_host_warm_up)                                                                   \
+  COUNTER(upstream_host_warm_up_timeout)                                                           \
   COUNTER(upstream_internal_redirect_failed_total)                                                 \
   COUNTER(upstream_internal_redirect_succeeded_total)                                              \
   COUNTER(upstream_rq_cancelled)                                                                   \
   COUNTER(upstream_rq_completed)                                                                   \
+  COUNTER(upstream_rq_latency_hedge)                                                               \
+  COUNTER(upstream_rq_latency_hedge_budget_exceeded)                                               \
+  COUNTER(upstream_rq_latency_hedge_won)                                                           \
   COUNTER(upstream_rq_maintenance_mode)                                                            \
   COUNTER(upstream_rq_max_duration_reached)                                                        \
+  COUNTER(upstream_rq_pending_deadline_exceeded)                                                   \
+  COUNTER(upstream_rq_pending_displaced)                                                           \
   COUNTER(upstream_rq_pending_failure_eject)                                                       \
   COUNTER(upstream_rq_pending_overflow)                                                            \
   COUNTER(upstream_rq_pending_total)                                                               \
@@ -567,10 +589,12 @@ public:
   COUNTER(upstream_rq_retry)                                                                       \
   COUNTER(upstream_rq_retry_backoff_exponential)                                                   \
   COUNTER(upstream_rq_retry_backoff_ratelimited)                                                   \
+  COUNTER(upstream_rq_retry_budget_exhausted)                                                      \
   COUNTER(upstream_rq_retry_limit_exceeded)                                                        \
   COUNTER(upstream_rq_retry_overflow)                                                              \
   COUNTER(upstream_rq_retry_success)                                                               \
   COUNTER(upstream_rq_rx_reset)                                                                    \
+  COUNTER(upstream_rq_shadow_dropped)                                                              \
   COUNTER(upstream_rq_timeout)                                                                     \
   COUNTER(upstream_rq_total)                                                                       \
   COUNTER(upstream_rq_tx_reset)                                                                    \
@@ -642,6 +666,7 @@ public:
  */
 MAKE_STAT_NAMES_STRUCT(ClusterStatNames, ALL_CLUSTER_STATS);
 MAKE_STATS_STRUCT(ClusterStats, ClusterStatNames, ALL_CLUSTER_STATS);
+MAKE_LAZY_STATS_STRUCT(LazyClusterStats, ClusterStatNames, ALL_CLUSTER_STATS);
 
 MAKE_STAT_NAMES_STRUCT(ClusterLoadReportStatNames, ALL_CLUSTER_LOAD_REPORT_STATS);
 MAKE_STATS_STRUCT(ClusterLoadReportStats, ClusterLoadReportStatNames,
@@ -740,6 +765,23 @@ public:
    */
   virtual float peekaheadRatio() const PURE;
 
+  /**
+   * @return the window over which connection pools average stream arrival rate to adapt
+   *         preconnecting to it, or absl::nullopt if adaptive preconnecting is disabled.
+   */
+  virtual const absl::optional<std::chrono::milliseconds> adaptivePreconnectWindow() const PURE;
+
+  /**
+   * @return the number of connections each worker establishes to a new host before it receives
+   *         traffic, 0 if hosts are not warmed up.
+   */
+  virtual uint32_t warmUpConnections() const PURE;
+
+  /**
+   * @return how long a new host may be kept out of the load balancing while it is warmed up.
+   */
+  virtual std::chrono::milliseconds warmUpTimeout() const PURE;
+
   /**
    * @return soft limit on size of the cluster's connections read and write buffers.
    */
@@ -814,6 +856,12 @@ public:
   virtual const absl::optional<envoy::config::cluster::v3::Cluster::LeastRequestLbConfig>&
   lbLeastRequestConfig() const PURE;
 
+  /**
+   * @return configuration for peak EWMA load balancing, only used if LB type is peak EWMA.
+   */
+  virtual const absl::optional<envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig>&
+  lbPeakEwmaConfig() const PURE;
+
   /**
    * @return configuration for ring hash load balancing, only used if type is set to ring_hash_lb.
    */
@@ -903,6 +951,12 @@ public:
    */
   virtual ClusterLoadReportStats& loadReportStats() const PURE;
 
+  /**
+   * @return LocalityLoadStatsMap& the load of the hosts of this cluster per locality, as counted by
+   *         the hosts for load reporting.
+   */
+  virtual LocalityLoadStatsMap& localityLoadStats() const PURE;
+
   /**
    * @return absl::optional<std::reference_wrapper<ClusterRequestResponseSizeStats>> stats to track
    * headers/body sizes of request/response for this cluster.
@@ -956,6 +1010,12 @@ public:
    */
   virtual bool connectionPoolPerDownstreamConnection() const PURE;
 
+  /**
+   * @return whether HTTP/2 connection pools for each host are owned by a single worker, which the
+   *         other workers forward their streams to.
+   */
+  virtual bool shareHttp2ConnectionPoolsAcrossWorkers() const PURE;
+
   /**
    * @return true if this cluster is configured to ignore hosts for the purpose of load balancing
    * computations until they have been health checked for the first time.
@@ -1,5 +1,7 @@
 #include "source/common/access_log/access_log_impl.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <string>
 
@@ -12,6 +14,7 @@
 #include "envoy/upstream/upstream.h"
 
 #include "source/common/common/assert.h"
+#include "source/common/common/empty_string.h"
 #include "source/common/common/utility.h"
 #include "source/common/config/metadata.h"
 #include "source/common/config/utility.h"
@@ -52,8 +55,10 @@ bool ComparisonFilter::compareAgainstValue(uint64_t lhs) const {
 }
 
 FilterPtr FilterFactory::fromProto(const envoy::config::accesslog::v3::AccessLogFilter& config,
-                                   Runtime::Loader& runtime, Random::RandomGenerator& random,
-                                   ProtobufMessage::ValidationVisitor& validation_visitor) {
+                                   Server::Configuration::CommonFactoryContext& context) {
+  Runtime::Loader& runtime = context.runtime();
+  Random::RandomGenerator& random = context.api().randomGenerator();
+  ProtobufMessage::ValidationVisitor& validation_visitor = context.messageValidationVisitor();
   switch (config.filter_specifier_case()) {
   case envoy::config::accesslog::v3::AccessLogFilter::FilterSpecifierCase::kStatusCodeFilter:
     return FilterPtr{new StatusCodeFilter(config.status_code_filter(), runtime)};
@@ -66,9 +71,9 @@ FilterPtr FilterFactory::fromProto(const envoy::config::accesslog::v3::AccessLog
   case envoy::config::accesslog::v3::AccessLogFilter::FilterSpecifierCase::kRuntimeFilter:
     return FilterPtr{new RuntimeFilter(config.runtime_filter(), runtime, random)};
   case envoy::config::accesslog::v3::AccessLogFilter::FilterSpecifierCase::kAndFilter:
-    return FilterPtr{new AndFilter(config.and_filter(), runtime, random, validation_visitor)};
+    return FilterPtr{new AndFilter(config.and_filter(), context)};
   case envoy::config::accesslog::v3::AccessLogFilter::FilterSpecifierCase::kOrFilter:
-    return FilterPtr{new OrFilter(config.or_filter(), runtime, random, validation_visitor)};
+    return FilterPtr{new OrFilter(config.or_filter(), context)};
   case envoy::config::accesslog::v3::AccessLogFilter::FilterSpecifierCase::kHeaderFilter:
     return FilterPtr{new HeaderFilter(config.header_filter())};
   case envoy::config::accesslog::v3::AccessLogFilter::FilterSpecifierCase::kResponseFlagFilter:
@@ -79,6 +84,9 @@ FilterPtr FilterFactory::fromProto(const envoy::config::accesslog::v3::AccessLog
     return FilterPtr{new GrpcStatusFilter(config.grpc_status_filter())};
   case envoy::config::accesslog::v3::AccessLogFilter::FilterSpecifierCase::kMetadataFilter:
     return FilterPtr{new MetadataFilter(config.metadata_filter())};
+  case envoy::config::accesslog::v3::AccessLogFilter::FilterSpecifierCase::kAdaptiveSamplingFilter:
+    MessageUtil::validate(config, validation_visitor);
+    return FilterPtr{new AdaptiveSamplingFilter(config.adaptive_sampling_filter(), context)};
   case envoy::config::accesslog::v3::AccessLogFilter::FilterSpecifierCase::kExtensionFilter:
     MessageUtil::validate(config, validation_visitor);
     {
@@ -152,22 +160,19 @@ bool RuntimeFilter::evaluate(const StreamInfo::StreamInfo& stream_info,
 
 OperatorFilter::OperatorFilter(
     const Protobuf::RepeatedPtrField<envoy::config::accesslog::v3::AccessLogFilter>& configs,
-    Runtime::Loader& runtime, Random::RandomGenerator& random,
-    ProtobufMessage::ValidationVisitor& validation_visitor) {
+    Server::Configuration::CommonFactoryContext& context) {
   for (const auto& config : configs) {
-    filters_.emplace_back(FilterFactory::fromProto(config, runtime, random, validation_visitor));
+    filters_.emplace_back(FilterFactory::fromProto(config, context));
   }
 }
 
-OrFilter::OrFilter(const envoy::config::accesslog::v3::OrFilter& config, Runtime::Loader& runtime,
-                   Random::RandomGenerator& random,
-                   ProtobufMessage::ValidationVisitor& validation_visitor)
-    : OperatorFilter(config.filters(), runtime, random, validation_visitor) {}
+OrFilter::OrFilter(const envoy::config::accesslog::v3::OrFilter& config,
+                   Server::Configuration::CommonFactoryContext& context)
+    : OperatorFilter(config.filters(), context) {}
 
 AndFilter::AndFilter(const envoy::config::accesslog::v3::AndFilter& config,
-                     Runtime::Loader& runtime, Random::RandomGenerator& random,
-                     ProtobufMessage::ValidationVisitor& validation_visitor)
-    : OperatorFilter(config.filters(), runtime, random, validation_visitor) {}
+                     Server::Configuration::CommonFactoryContext& context)
+    : OperatorFilter(config.filters(), context) {}
 
 bool OrFilter::evaluate(const StreamInfo::StreamInfo& info,
                         const Http::RequestHeaderMap& request_headers,
@@ -302,14 +307,165 @@ bool MetadataFilter::evaluate(const StreamInfo::StreamInfo& info, const Http::Re
   return default_match_;
 }
 
+AdaptiveSamplingFilter::AdaptiveSamplingFilter(
+    const envoy::config::accesslog::v3::AdaptiveSamplingFilter& config,
+    Server::Configuration::CommonFactoryContext& context)
+    : logs_per_second_(config.logs_per_second()),
+      error_status_code_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, error_status_code, 500)),
+      slow_request_percentile_(
+          config.has_slow_request_percentile()
+              ? absl::optional<double>(config.slow_request_percentile().value())
+              : absl::nullopt),
+      reconciliation_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, reconciliation_interval, 1000)),
+      tls_(ThreadLocal::TypedSlot<ThreadLocalSamplers>::makeUnique(context.threadLocal())),
+      still_alive_guard_(std::make_shared<bool>(true)) {
+  tls_->set([logs_per_second = logs_per_second_, &time_source = context.timeSource()](
+                Event::Dispatcher&) {
+    return std::make_shared<ThreadLocalSamplers>(logs_per_second, time_source);
+  });
+  reconciliation_timer_ = context.dispatcher().createTimer([this]() { reconcile(); });
+  reconciliation_timer_->enableTimer(reconciliation_interval_);
+}
+
+AdaptiveSamplingFilter::~AdaptiveSamplingFilter() = default;
+
+bool AdaptiveSamplingFilter::evaluate(const StreamInfo::StreamInfo& info,
+                                      const Http::RequestHeaderMap&,
+                                      const Http::ResponseHeaderMap&,
+                                      const Http::ResponseTrailerMap&) const {
+  const uint64_t response_code = info.responseCode().value_or(0);
+  if (response_code == 0 || response_code >= error_status_code_) {
+    return true;
+  }
+
+  ThreadLocalSamplers& samplers = tls_->get().ref();
+  const std::string& route_name =
+      info.routeEntry() != nullptr ? info.routeEntry()->routeName() : EMPTY_STRING;
+  // The error status code is below 600, so is the response code.
+  const size_t response_class = response_code / 100;
+  SamplerPtr& sampler = samplers.routes_[route_name][response_class];
+  if (sampler == nullptr) {
+    sampler = std::make_unique<Sampler>();
+    samplers.updateSampler(route_name, response_class, *sampler);
+  }
+
+  ++sampler->requests_;
+  const absl::optional<std::chrono::nanoseconds> duration = info.requestComplete();
+  const double duration_ms =
+      duration.has_value() ? std::chrono::duration<double, std::milli>(duration.value()).count()
+                           : 0;
+  hist_insert(sampler->durations_.get(), duration_ms, 1);
+  if (duration_ms >= sampler->slow_threshold_ms_) {
+    return true;
+  }
+  return sampler->bucket_->consume(1, false) == 1;
+}
+
+void AdaptiveSamplingFilter::ThreadLocalSamplers::updateSampler(const std::string& route_name,
+                                                                size_t response_class,
+                                                                Sampler& sampler) const {
+  // Until the first reconciliation, each thread samples the pair at the whole rate.
+  double rate = logs_per_second_;
+  if (reconciled_ != nullptr) {
+    uint64_t requests = 0;
+    sampler.slow_threshold_ms_ = std::numeric_limits<double>::infinity();
+    const auto route = reconciled_->routes_.find(route_name);
+    if (route != reconciled_->routes_.end()) {
+      requests = route->second[response_class].requests_;
+      sampler.slow_threshold_ms_ = route->second[response_class].slow_threshold_ms_;
+    }
+    // Each thread counts one more request than it handled, so that the threads which didn't see
+    // the pair during the last interval still get a share of the rate.
+    rate = logs_per_second_ * (sampler.last_requests_ + 1.0) / (requests + reconciled_->threads_);
+  }
+
+  const uint64_t max_tokens = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(rate)));
+  uint64_t tokens = max_tokens;
+  if (sampler.bucket_ != nullptr) {
+    tokens = sampler.bucket_->consume(max_tokens, true);
+  }
+  sampler.bucket_ = std::make_unique<TokenBucketImpl>(max_tokens, time_source_, rate);
+  sampler.bucket_->maybeReset(tokens);
+}
+
+void AdaptiveSamplingFilter::reconcile() {
+  auto collected = std::make_shared<CollectedStats>();
+  tls_->runOnAllThreads(
+      [collected](OptRef<ThreadLocalSamplers> samplers) {
+        absl::MutexLock lock(&collected->mutex_);
+        ++collected->threads_;
+        for (auto route = samplers->routes_.begin(); route != samplers->routes_.end();) {
+          bool idle = true;
+          for (size_t i = 0; i < NumResponseClasses; ++i) {
+            SamplerPtr& sampler = route->second[i];
+            if (sampler == nullptr) {
+              continue;
+            }
+            if (sampler->requests_ == 0) {
+              // The pair is sampled again at the share of the idle threads if it comes back.
+              sampler.reset();
+              continue;
+            }
+            idle = false;
+            CollectedStats::Pair& pair = collected->routes_[route->first][i];
+            pair.requests_ += sampler->requests_;
+            histogram_t* durations = sampler->durations_.get();
+            hist_accumulate(pair.durations_.get(), &durations, 1);
+            sampler->last_requests_ = sampler->requests_;
+            sampler->requests_ = 0;
+            hist_clear(sampler->durations_.get());
+          }
+          if (idle) {
+            samplers->routes_.erase(route++);
+          } else {
+            ++route;
+          }
+        }
+      },
+      [this, still_alive = std::weak_ptr<bool>(still_alive_guard_), collected]() {
+        if (still_alive.expired()) {
+          return;
+        }
+        ReconciledStatsConstSharedPtr reconciled = reconciledStats(*collected);
+        tls_->runOnAllThreads([reconciled](OptRef<ThreadLocalSamplers> samplers) {
+          samplers->reconciled_ = reconciled;
+          for (auto& route : samplers->routes_) {
+            for (size_t i = 0; i < NumResponseClasses; ++i) {
+              if (route.second[i] != nullptr) {
+                samplers->updateSampler(route.first, i, *route.second[i]);
+              }
+            }
+          }
+        });
+        reconciliation_timer_->enableTimer(reconciliation_interval_);
+      });
+}
+
+AdaptiveSamplingFilter::ReconciledStatsConstSharedPtr
+AdaptiveSamplingFilter::reconciledStats(CollectedStats& collected) const {
+  auto reconciled = std::make_shared<ReconciledStats>();
+  absl::MutexLock lock(&collected.mutex_);
+  reconciled->threads_ = collected.threads_;
+  for (const auto& route : collected.routes_) {
+    std::array<PairStats, NumResponseClasses>& stats = reconciled->routes_[route.first];
+    for (size_t i = 0; i < NumResponseClasses; ++i) {
+      stats[i].requests_ = route.second[i].requests_;
+      if (slow_request_percentile_.has_value() && stats[i].requests_ > 0) {
+        const double quantile = slow_request_percentile_.value() / 100;
+        hist_approx_quantile(route.second[i].durations_.get(), &quantile, 1,
+                             &stats[i].slow_threshold_ms_);
+      }
+    }
+  }
+  return reconciled;
+}
+
 InstanceSharedPtr
 AccessLogFactory::fromProto(const envoy::config::accesslog::v3::AccessLog& config,
                             Server::Configuration::CommonFactoryContext& context) {
   FilterPtr filter;
   if (config.has_filter()) {
-    filter = FilterFactory::fromProto(config.filter(), context.runtime(),
-                                      context.api().randomGenerator(),
-                                      context.messageValidationVisitor());
+    filter = FilterFactory::fromProto(config.filter(), context);
   }
 
   auto& factory =
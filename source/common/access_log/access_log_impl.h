@@ -1,6 +1,10 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <cstdint>
+#include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -8,17 +12,25 @@
 #include "envoy/common/random_generator.h"
 #include "envoy/config/accesslog/v3/accesslog.pb.h"
 #include "envoy/config/typed_config.h"
+#include "envoy/event/timer.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/server/access_log_config.h"
+#include "envoy/thread_local/thread_local.h"
 #include "envoy/type/v3/percent.pb.h"
 
 #include "source/common/common/matchers.h"
+#include "source/common/common/token_bucket_impl.h"
 #include "source/common/grpc/status.h"
 #include "source/common/http/header_utility.h"
 #include "source/common/protobuf/protobuf.h"
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_set.h"
 #include "absl/hash/hash.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+#include "circllhist.h"
 
 namespace Envoy {
 namespace AccessLog {
@@ -32,8 +44,7 @@ public:
    * Read a filter definition from proto and instantiate a concrete filter class.
    */
   static FilterPtr fromProto(const envoy::config::accesslog::v3::AccessLogFilter& config,
-                             Runtime::Loader& runtime, Random::RandomGenerator& random,
-                             ProtobufMessage::ValidationVisitor& validation_visitor);
+                             Server::Configuration::CommonFactoryContext& context);
 };
 
 /**
@@ -87,8 +98,7 @@ class OperatorFilter : public Filter {
 public:
   OperatorFilter(
       const Protobuf::RepeatedPtrField<envoy::config::accesslog::v3::AccessLogFilter>& configs,
-      Runtime::Loader& runtime, Random::RandomGenerator& random,
-      ProtobufMessage::ValidationVisitor& validation_visitor);
+      Server::Configuration::CommonFactoryContext& context);
 
 protected:
   std::vector<FilterPtr> filters_;
@@ -99,9 +109,8 @@ protected:
  */
 class AndFilter : public OperatorFilter {
 public:
-  AndFilter(const envoy::config::accesslog::v3::AndFilter& config, Runtime::Loader& runtime,
-            Random::RandomGenerator& random,
-            ProtobufMessage::ValidationVisitor& validation_visitor);
+  AndFilter(const envoy::config::accesslog::v3::AndFilter& config,
+            Server::Configuration::CommonFactoryContext& context);
 
   // AccessLog::Filter
   bool evaluate(const StreamInfo::StreamInfo& info, const Http::RequestHeaderMap& request_headers,
@@ -114,8 +123,8 @@ public:
  */
 class OrFilter : public OperatorFilter {
 public:
-  OrFilter(const envoy::config::accesslog::v3::OrFilter& config, Runtime::Loader& runtime,
-           Random::RandomGenerator& random, ProtobufMessage::ValidationVisitor& validation_visitor);
+  OrFilter(const envoy::config::accesslog::v3::OrFilter& config,
+           Server::Configuration::CommonFactoryContext& context);
 
   // AccessLog::Filter
   bool evaluate(const StreamInfo::StreamInfo& info, const Http::RequestHeaderMap& request_headers,
@@ -250,6 +259,101 @@ private:
   const std::string filter_;
 };
 
+/**
+ * Filter sampling the logs of each pair of route and response class at a constant rate, whatever
+ * the request rate, while always logging the requests with an error response and the slowest
+ * requests of each pair. Each worker samples with its own token buckets, whose fill rates are
+ * periodically reconciled with the share of the requests of each pair the worker handled.
+ */
+class AdaptiveSamplingFilter : public Filter {
+public:
+  // The response classes, from the requests without a response code to the 5xx requests.
+  static constexpr size_t NumResponseClasses = 6;
+
+  AdaptiveSamplingFilter(const envoy::config::accesslog::v3::AdaptiveSamplingFilter& config,
+                         Server::Configuration::CommonFactoryContext& context);
+  ~AdaptiveSamplingFilter() override;
+
+  // AccessLog::Filter
+  bool evaluate(const StreamInfo::StreamInfo& info, const Http::RequestHeaderMap& request_headers,
+                const Http::ResponseHeaderMap& response_headers,
+                const Http::ResponseTrailerMap& response_trailers) const override;
+
+private:
+  using HistogramPtr = std::unique_ptr<histogram_t, decltype(&hist_free)>;
+
+  // The requests of a pair on all the threads during the last reconciliation interval.
+  struct PairStats {
+    uint64_t requests_{};
+    // The duration in milliseconds from which the requests of the pair are always logged.
+    double slow_threshold_ms_{std::numeric_limits<double>::infinity()};
+  };
+
+  // The result of a reconciliation, shared by all the threads.
+  struct ReconciledStats {
+    uint32_t threads_{};
+    absl::flat_hash_map<std::string, std::array<PairStats, NumResponseClasses>> routes_;
+  };
+  using ReconciledStatsConstSharedPtr = std::shared_ptr<const ReconciledStats>;
+
+  // The requests of the pairs and their durations, collected from all the threads for a
+  // reconciliation.
+  struct CollectedStats {
+    struct Pair {
+      uint64_t requests_{};
+      HistogramPtr durations_{hist_fast_alloc(), hist_free};
+    };
+
+    absl::Mutex mutex_;
+    uint32_t threads_ ABSL_GUARDED_BY(mutex_){};
+    absl::flat_hash_map<std::string, std::array<Pair, NumResponseClasses>>
+        routes_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  // The sampling state of a pair on a thread.
+  struct Sampler {
+    std::unique_ptr<TokenBucketImpl> bucket_;
+    // The requests of the pair and their durations in milliseconds since the last collection.
+    uint64_t requests_{};
+    HistogramPtr durations_{hist_fast_alloc(), hist_free};
+    // The requests of the pair during the last reconciliation interval.
+    uint64_t last_requests_{};
+    double slow_threshold_ms_{std::numeric_limits<double>::infinity()};
+  };
+  using SamplerPtr = std::unique_ptr<Sampler>;
+
+  struct ThreadLocalSamplers : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalSamplers(uint32_t logs_per_second, TimeSource& time_source)
+        : logs_per_second_(logs_per_second), time_source_(time_source) {}
+
+    // Sets the fill rate of the bucket of a pair to the share of the requests of the pair the
+    // thread handled during the last reconciliation interval, keeping the tokens left.
+    void updateSampler(const std::string& route_name, size_t response_class,
+                       Sampler& sampler) const;
+
+    const uint32_t logs_per_second_;
+    TimeSource& time_source_;
+    // The samplers of the pairs which had requests since the last collection or during the last
+    // reconciliation interval, by route name and response class.
+    absl::flat_hash_map<std::string, std::array<SamplerPtr, NumResponseClasses>> routes_;
+    ReconciledStatsConstSharedPtr reconciled_;
+  };
+
+  // Collects the requests of all the threads, then updates their samplers.
+  void reconcile();
+  // Computes the stats of all the pairs from what was collected from the threads.
+  ReconciledStatsConstSharedPtr reconciledStats(CollectedStats& collected) const;
+
+  const uint32_t logs_per_second_;
+  const uint64_t error_status_code_;
+  const absl::optional<double> slow_request_percentile_;
+  const std::chrono::milliseconds reconciliation_interval_;
+  ThreadLocal::TypedSlotPtr<ThreadLocalSamplers> tls_;
+  Event::TimerPtr reconciliation_timer_;
+  // Lets a reconciliation completing on the main thread know whether the filter still exists.
+  std::shared_ptr<bool> still_alive_guard_;
+};
+
 /**
  * Extension filter factory that reads from ExtensionFilter proto.
  */
@@ -1,5 +1,6 @@
 #include "source/common/access_log/access_log_manager_impl.h"
 
+#include <algorithm>
 #include <string>
 
 #include "envoy/common/exception.h"
@@ -34,23 +35,95 @@ AccessLogManagerImpl::createAccessLog(const Filesystem::FilePathAndType& file_in
   if (access_logs_.count(file_name)) {
     return access_logs_[file_name];
   }
+  if (flush_thread_ == nullptr) {
+    flush_thread_ = std::make_shared<AccessLogFlushThread>(api_.threadFactory());
+  }
   access_logs_[file_name] =
       std::make_shared<AccessLogFileImpl>(std::move(file), dispatcher_, lock_, file_stats_,
-                                          file_flush_interval_msec_, api_.threadFactory());
+                                          file_flush_interval_msec_, flush_thread_);
   return access_logs_[file_name];
 }
 
+AccessLogFlushThread::~AccessLogFlushThread() {
+  Thread::ThreadPtr thread;
+  {
+    Thread::LockGuard lock(lock_);
+    exit_ = true;
+    flush_event_.notifyOne();
+    thread = std::move(thread_);
+  }
+
+  if (thread != nullptr) {
+    thread->join();
+  }
+}
+
+void AccessLogFlushThread::scheduleFlush(AccessLogFileImpl& file) {
+  if (file.flush_scheduled_.exchange(true)) {
+    return;
+  }
+
+  Thread::LockGuard lock(lock_);
+  if (thread_ == nullptr) {
+    thread_ = thread_factory_.createThread([this]() -> void { threadFunc(); },
+                                           Thread::Options{"AccessLogFlush"});
+  }
+  pending_files_.push_back(&file);
+  flush_event_.notifyOne();
+}
+
+void AccessLogFlushThread::removeFile(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(lock_);
+  pending_files_.erase(std::remove(pending_files_.begin(), pending_files_.end(), &file),
+                       pending_files_.end());
+  while (flushing_file_ == &file) {
+    // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+    flushed_event_.wait(lock_);
+  }
+}
+
+void AccessLogFlushThread::threadFunc() {
+  while (true) {
+    AccessLogFileImpl* file;
+    {
+      Thread::LockGuard lock(lock_);
+      while (pending_files_.empty() && !exit_) {
+        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+        flush_event_.wait(lock_);
+      }
+
+      if (exit_) {
+        return;
+      }
+
+      file = pending_files_.front();
+      pending_files_.pop_front();
+      flushing_file_ = file;
+      // The writes from now on schedule another flush.
+      file->flush_scheduled_ = false;
+    }
+
+    file->flushFromThread();
+
+    {
+      Thread::LockGuard lock(lock_);
+      flushing_file_ = nullptr;
+      flushed_event_.notifyAll();
+    }
+  }
+}
+
 AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                                      Thread::BasicLockable& lock, AccessLogFileStats& stats,
                                      std::chrono::milliseconds flush_interval_msec,
-                                     Thread::ThreadFactory& thread_factory)
-    : file_(std::move(file)), file_lock_(lock),
+                                     AccessLogFlushThreadSharedPtr flush_thread)
+    : file_(std::move(file)), file_lock_(lock), flush_thread_(std::move(flush_thread)),
       flush_timer_(dispatcher.createTimer([this]() -> void {
         stats_.flushed_by_timer_.inc();
-        flush_event_.notifyOne();
+        scheduleFlush();
         flush_timer_->enableTimer(flush_interval_msec_);
       })),
-      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec), stats_(stats) {
+      flush_interval_msec_(flush_interval_msec), stats_(stats) {
   flush_timer_->enableTimer(flush_interval_msec_);
   auto open_result = open();
   if (!open_result.rc_) {
@@ -75,20 +148,14 @@ Api::IoCallBoolResult AccessLogFileImpl::open() {
 void AccessLogFileImpl::reopen() { reopen_file_ = true; }
 
 AccessLogFileImpl::~AccessLogFileImpl() {
-  {
-    Thread::LockGuard lock(write_lock_);
-    flush_thread_exit_ = true;
-    flush_event_.notifyOne();
-  }
-
-  if (flush_thread_ != nullptr) {
-    flush_thread_->join();
-  }
+  flush_thread_->removeFile(*this);
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (file_->isOpen()) {
-    if (flush_buffer_.length() > 0) {
-      doWrite(flush_buffer_);
+    Thread::LockGuard flush_lock(flush_lock_);
+    moveWriteBuffers();
+    if (about_to_write_buffer_.length() > 0) {
+      doWrite(about_to_write_buffer_);
     }
     const Api::IoCallBoolResult result = file_->close();
     ASSERT(result.rc_, fmt::format("unable to close file '{}': {}", file_->path(),
@@ -125,91 +192,80 @@ void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
   buffer.drain(buffer.length());
 }
 
-void AccessLogFileImpl::flushThreadFunc() {
-
-  while (true) {
-    std::unique_lock<Thread::BasicLockable> flush_lock;
-
-    {
-      Thread::LockGuard write_lock(write_lock_);
-
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_ && !reopen_file_) {
-        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
-        flush_event_.wait(write_lock_);
-      }
-
-      if (flush_thread_exit_) {
-        return;
-      }
-
-      flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
-    }
-
-    // if we failed to open file before, then simply ignore
-    if (file_->isOpen()) {
-      if (reopen_file_) {
-        reopen_file_ = false;
-        const Api::IoCallBoolResult result = file_->close();
-        ASSERT(result.rc_, fmt::format("unable to close file '{}': {}", file_->path(),
-                                       result.err_->getErrorDetails()));
-        const Api::IoCallBoolResult open_result = open();
-        if (!open_result.rc_) {
-          stats_.reopen_failed_.inc();
-          return;
-        }
-      }
-      doWrite(about_to_write_buffer_);
-    }
+void AccessLogFileImpl::moveWriteBuffers() {
+  for (WriteBuffer& write_buffer : write_buffers_) {
+    Thread::LockGuard lock(write_buffer.lock_);
+    about_to_write_buffer_.move(write_buffer.buffer_);
   }
 }
 
-void AccessLogFileImpl::flush() {
-  std::unique_lock<Thread::BasicLockable> flush_buffer_lock;
+void AccessLogFileImpl::flushFromThread() {
+  Thread::LockGuard flush_lock(flush_lock_);
+  moveWriteBuffers();
 
-  {
-    Thread::LockGuard write_lock(write_lock_);
-
-    // flush_lock_ must be held while checking this or else it is
-    // possible that flushThreadFunc() has already moved data from
-    // flush_buffer_ to about_to_write_buffer_, has unlocked write_lock_,
-    // but has not yet completed doWrite(). This would allow flush() to
-    // return before the pending data has actually been written to disk.
-    flush_buffer_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
+  // if we failed to open file before, then simply ignore
+  if (!file_->isOpen()) {
+    stats_.write_total_buffered_.sub(about_to_write_buffer_.length());
+    about_to_write_buffer_.drain(about_to_write_buffer_.length());
+    return;
+  }
 
-    if (flush_buffer_.length() == 0) {
+  if (reopen_file_) {
+    reopen_file_ = false;
+    const Api::IoCallBoolResult result = file_->close();
+    ASSERT(result.rc_, fmt::format("unable to close file '{}': {}", file_->path(),
+                                   result.err_->getErrorDetails()));
+    const Api::IoCallBoolResult open_result = open();
+    if (!open_result.rc_) {
+      stats_.reopen_failed_.inc();
+      stats_.write_total_buffered_.sub(about_to_write_buffer_.length());
+      about_to_write_buffer_.drain(about_to_write_buffer_.length());
       return;
     }
+  }
+  if (about_to_write_buffer_.length() > 0) {
+    doWrite(about_to_write_buffer_);
+  }
+}
 
-    about_to_write_buffer_.move(flush_buffer_);
-    ASSERT(flush_buffer_.length() == 0);
+void AccessLogFileImpl::flush() {
+  // flush_lock_ must be held while moving the write buffers or else it is possible that the flush
+  // thread has already moved data from them to about_to_write_buffer_, but has not yet completed
+  // doWrite(). This would allow flush() to return before the pending data has actually been
+  // written to disk.
+  Thread::LockGuard flush_lock(flush_lock_);
+  moveWriteBuffers();
+  if (about_to_write_buffer_.length() == 0) {
+    return;
   }
 
   doWrite(about_to_write_buffer_);
 }
 
 void AccessLogFileImpl::write(absl::string_view data) {
-  Thread::LockGuard lock(write_lock_);
+  WriteBuffer& write_buffer = write_buffers_[threadWriteBuffer()];
+  bool flush_now;
+  {
+    Thread::LockGuard lock(write_buffer.lock_);
+    if (write_buffer.buffer_.length() + data.size() > MAX_BUFFER_SIZE) {
+      // The flush thread can't keep up, most likely because the disk is slow.
+      stats_.write_dropped_.inc();
+      return;
+    }
 
-  if (flush_thread_ == nullptr) {
-    createFlushStructures();
+    stats_.write_buffered_.inc();
+    stats_.write_total_buffered_.add(data.length());
+    write_buffer.buffer_.add(data.data(), data.size());
+    flush_now = write_buffer.buffer_.length() > MIN_FLUSH_SIZE;
   }
 
-  stats_.write_buffered_.inc();
-  stats_.write_total_buffered_.add(data.length());
-  flush_buffer_.add(data.data(), data.size());
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
-    flush_event_.notifyOne();
+  // The first write to the file is flushed right away.
+  if (flush_now || (!written_.load(std::memory_order_relaxed) && !written_.exchange(true))) {
+    scheduleFlush();
   }
 }
 
-void AccessLogFileImpl::createFlushStructures() {
-  flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); },
-                                               Thread::Options{"AccessLogFlush"});
-}
+void AccessLogFileImpl::scheduleFlush() { flush_thread_->scheduleFlush(*this); }
 
 } // namespace AccessLog
 } // namespace Envoy
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <string>
 
 #include "envoy/access_log/access_log.h"
@@ -13,6 +17,7 @@
 #include "source/common/common/logger.h"
 #include "source/common/common/thread.h"
 
+#include "absl/base/optimization.h"
 #include "absl/container/node_hash_map.h"
 
 namespace Envoy {
@@ -22,6 +27,7 @@ namespace Envoy {
   COUNTER(reopen_failed)                                                                           \
   COUNTER(write_buffered)                                                                          \
   COUNTER(write_completed)                                                                         \
+  COUNTER(write_dropped)                                                                           \
   COUNTER(write_failed)                                                                            \
   GAUGE(write_total_buffered, Accumulate)
 
@@ -31,6 +37,47 @@ struct AccessLogFileStats {
 
 namespace AccessLog {
 
+class AccessLogFileImpl;
+
+/**
+ * The thread flushing all the access log files of an AccessLogManagerImpl to disk, one file at a
+ * time, so that the number of threads doesn't grow with the number of files. It is started by the
+ * first flush scheduled, and shared by the manager and its files, which may outlive it.
+ */
+class AccessLogFlushThread {
+public:
+  explicit AccessLogFlushThread(Thread::ThreadFactory& thread_factory)
+      : thread_factory_(thread_factory) {}
+  ~AccessLogFlushThread();
+
+  /**
+   * Schedules a flush of a file, after the flushes of the files scheduled before. Does nothing if
+   * a flush of the file is scheduled already.
+   */
+  void scheduleFlush(AccessLogFileImpl& file);
+
+  /**
+   * Cancels the scheduled flush of a file about to be destroyed, and waits for its flush in
+   * progress, if any.
+   */
+  void removeFile(AccessLogFileImpl& file);
+
+private:
+  void threadFunc();
+
+  Thread::ThreadFactory& thread_factory_;
+  Thread::MutexBasicLockable lock_;
+  Thread::CondVar flush_event_;
+  // Notified once the file being flushed is flushed.
+  Thread::CondVar flushed_event_;
+  std::deque<AccessLogFileImpl*> pending_files_ ABSL_GUARDED_BY(lock_);
+  AccessLogFileImpl* flushing_file_ ABSL_GUARDED_BY(lock_){};
+  bool exit_ ABSL_GUARDED_BY(lock_){};
+  Thread::ThreadPtr thread_ ABSL_GUARDED_BY(lock_);
+};
+
+using AccessLogFlushThreadSharedPtr = std::shared_ptr<AccessLogFlushThread>;
+
 class AccessLogManagerImpl : public AccessLogManager, Logger::Loggable<Logger::Id::main> {
 public:
   AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec, Api::Api& api,
@@ -52,22 +99,24 @@ private:
   Event::Dispatcher& dispatcher_;
   Thread::BasicLockable& lock_;
   AccessLogFileStats file_stats_;
+  // Created with the first file.
+  AccessLogFlushThreadSharedPtr flush_thread_;
   absl::node_hash_map<std::string, AccessLogFileSharedPtr> access_logs_;
 };
 
 /**
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
- * This implementation uses a flush thread per file, with the idea there aren't that many
- * files. If this turns out to be a good implementation we can potentially have a single flush
- * thread that flushes all files, but we will start with this.
+ * The files are written to disk by the AccessLogFlushThread shared by all the files of the
+ * manager. The threads writing to a file append to one of several buffers chosen by thread, so
+ * that the workers rarely contend for the same lock.
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
   AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                     Thread::BasicLockable& lock, AccessLogFileStats& stats,
                     std::chrono::milliseconds flush_interval_msec,
-                    Thread::ThreadFactory& thread_factory);
+                    AccessLogFlushThreadSharedPtr flush_thread);
   ~AccessLogFileImpl() override;
 
   // AccessLog::AccessLogFile
@@ -82,22 +131,45 @@ public:
   void flush() override;
 
 private:
+  friend class AccessLogFlushThread;
+
+  // A buffer the threads writing to the file append to.
+  struct ABSL_CACHELINE_ALIGNED WriteBuffer {
+    Thread::MutexBasicLockable lock_;
+    Buffer::OwnedImpl buffer_ ABSL_GUARDED_BY(lock_);
+  };
+
   void doWrite(Buffer::Instance& buffer);
-  void flushThreadFunc();
+  // Writes the buffered data to disk, reopening the file first if requested. Called by the flush
+  // thread.
+  void flushFromThread();
+  // Moves the data of all the write buffers to about_to_write_buffer_.
+  void moveWriteBuffers();
   Api::IoCallBoolResult open();
-  void createFlushStructures();
+  void scheduleFlush();
+
+  static uint32_t threadWriteBuffer() {
+    static std::atomic<uint32_t> next_buffer{0};
+    static thread_local const uint32_t buffer =
+        next_buffer.fetch_add(1, std::memory_order_relaxed) % NUM_WRITE_BUFFERS;
+    return buffer;
+  }
 
   // return default flags set which used by open
   static Filesystem::FlagSet defaultFlags();
 
-  // Minimum size before the flush thread will be told to flush.
+  // Minimum size of a write buffer before the flush thread will be told to flush.
   static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
+  // Maximum size of a write buffer, beyond which the writes are dropped until the flush thread
+  // catches up.
+  static const uint64_t MAX_BUFFER_SIZE = 1024 * 1024 * 4;
+  static constexpr uint32_t NUM_WRITE_BUFFERS = 16;
 
   Filesystem::FilePtr file_;
 
   // These locks are always acquired in the following order if multiple locks are held:
-  //    1) write_lock_
-  //    2) flush_lock_
+  //    1) flush_lock_
+  //    2) the lock of a write buffer
   //    3) file_lock_
   Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
                                           // to disk. This is used to make sure that file blocks do
@@ -108,28 +180,24 @@ private:
                                           // concurrent access to the about_to_write_buffer_, fd_,
                                           // and all other data used during flushing and file
                                           // re-opening.
-  Thread::MutexBasicLockable
-      write_lock_; // The lock is used when filling the flush buffer. It allows
-                   // multiple threads to write to the same file at relatively
-                   // high performance. It is always local to the process.
-  Thread::ThreadPtr flush_thread_;
-  Thread::CondVar flush_event_;
-  std::atomic<bool> flush_thread_exit_{};
+  // The buffers filled by the writing threads, each always by the same threads, and then flushed
+  // either when the size of one of them reaches MIN_FLUSH_SIZE or when a timer fires.
+  std::array<WriteBuffer, NUM_WRITE_BUFFERS> write_buffers_;
+  const AccessLogFlushThreadSharedPtr flush_thread_;
+  // Set once the file was written to for the first time, which flushes it right away.
+  std::atomic<bool> written_{};
+  // Set while a flush of the file is scheduled on the flush thread.
+  std::atomic<bool> flush_scheduled_{};
   std::atomic<bool> reopen_file_{};
-  Buffer::OwnedImpl
-      flush_buffer_ ABSL_GUARDED_BY(write_lock_); // This buffer is used by multiple threads. It
-                                                  // gets filled and then flushed either when max
-                                                  // size is reached or when a timer fires.
   // TODO(jmarantz): this should be ABSL_GUARDED_BY(flush_lock_) but the analysis cannot poke
   // through the std::make_unique assignment. I do not believe it's possible to annotate this
   // properly now due to limitations in the clang thread annotation analysis.
   Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only by the flush thread. Data
-                                            // is moved from flush_buffer_ under lock, and then
-                                            // the lock is released so that flush_buffer_ can
+                                            // is moved from write_buffers_ under their locks,
+                                            // and then the locks are released so that they can
                                             // continue to fill. This buffer is then used for the
                                             // final write to disk.
   Event::TimerPtr flush_timer_;
-  Thread::ThreadFactory& thread_factory_;
   const std::chrono::milliseconds flush_interval_msec_; // Time interval buffer gets flushed no
                                                         // matter if it reached the MIN_FLUSH_SIZE
                                                         // or not.
@@ -1,12 +1,18 @@
 #include "source/common/buffer/buffer_impl.h"
 
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <list>
 #include <memory>
 #include <string>
 
 #include "source/common/common/assert.h"
+#include "source/common/common/lock_guard.h"
+#include "source/common/common/thread.h"
 
 #include "absl/container/fixed_array.h"
+#include "absl/container/inlined_vector.h"
 #include "event2/buffer.h"
 
 namespace Envoy {
@@ -17,9 +23,193 @@ namespace {
 // TODO(yanavlasov): This may not be optimal for all hardware configurations or traffic patterns and
 // may need to be configurable in the future.
 constexpr uint64_t CopyThreshold = 512;
+
+class SliceStoragePool;
+
+// Set when this thread's pool is destroyed. Thread local and static objects destroyed after it
+// may still free slices, which then go straight to the allocator.
+thread_local bool thread_pool_destroyed = false;
+
+// Tracks the live pools so their stats can be summed, and keeps the stats of pools whose thread
+// has exited.
+class SliceStoragePoolRegistry {
+public:
+  static SliceStoragePoolRegistry& get() {
+    // Leaked, so it outlives the pools of threads which exit during static destruction.
+    static auto* registry = new SliceStoragePoolRegistry();
+    return *registry;
+  }
+
+  std::list<SliceStoragePool*>::iterator add(SliceStoragePool& pool) {
+    Thread::LockGuard lock(lock_);
+    return pools_.insert(pools_.end(), &pool);
+  }
+  void remove(std::list<SliceStoragePool*>::iterator entry);
+  std::vector<Slice::PoolStats> stats();
+
+  // Incremented by Slice::trimPools(). Each pool trims itself when it sees a new value.
+  std::atomic<uint64_t> trim_epoch_{0};
+
+private:
+  Thread::MutexBasicLockable lock_;
+  std::list<SliceStoragePool*> pools_ ABSL_GUARDED_BY(lock_);
+  std::array<uint64_t, Slice::pool_size_classes_> exited_hits_ ABSL_GUARDED_BY(lock_){};
+  std::array<uint64_t, Slice::pool_size_classes_> exited_misses_ ABSL_GUARDED_BY(lock_){};
+};
+
+// Slice storage freed on one thread, kept for reuse by the next slice of the same size on that
+// thread.
+class SliceStoragePool {
+public:
+  SliceStoragePool() : entry_(SliceStoragePoolRegistry::get().add(*this)) {}
+  ~SliceStoragePool() {
+    SliceStoragePoolRegistry::get().remove(entry_);
+    thread_pool_destroyed = true;
+  }
+
+  // @return this thread's pool, or nullptr if it has been destroyed.
+  static SliceStoragePool* threadLocal() {
+    if (thread_pool_destroyed) {
+      return nullptr;
+    }
+    static thread_local SliceStoragePool pool;
+    return &pool;
+  }
+
+  static bool pooled(uint64_t capacity) { return capacity <= Slice::max_pooled_size_; }
+
+  Slice::StoragePtr take(uint64_t capacity) {
+    maybeTrim();
+    const uint32_t size_class = sizeClass(capacity);
+    auto& free_list = free_lists_[size_class];
+    if (free_list.empty()) {
+      increment(misses_[size_class]);
+      return nullptr;
+    }
+    increment(hits_[size_class]);
+    Slice::StoragePtr storage = std::move(free_list.back());
+    free_list.pop_back();
+    pooled_bytes_ -= capacity;
+    return storage;
+  }
+
+  // @return false, leaving the storage alone, if the pool is full.
+  bool put(Slice::StoragePtr& storage, uint64_t capacity) {
+    maybeTrim();
+    auto& free_list = free_lists_[sizeClass(capacity)];
+    if (free_list.size() == MaxPerSizeClass ||
+        pooled_bytes_ + capacity > Slice::max_pooled_bytes_per_thread_) {
+      return false;
+    }
+    free_list.emplace_back(std::move(storage));
+    pooled_bytes_ += capacity;
+    return true;
+  }
+
+  uint64_t hits(uint32_t size_class) const {
+    return hits_[size_class].load(std::memory_order_relaxed);
+  }
+  uint64_t misses(uint32_t size_class) const {
+    return misses_[size_class].load(std::memory_order_relaxed);
+  }
+
+private:
+  // As many as a read reservation uses.
+  static constexpr uint32_t MaxPerSizeClass = Buffer::Reservation::MAX_SLICES_;
+
+  static uint32_t sizeClass(uint64_t capacity) {
+    ASSERT(capacity > 0 && capacity % Slice::page_size_ == 0 && pooled(capacity));
+    return capacity / Slice::page_size_ - 1;
+  }
+
+  // Only this pool's thread writes its stats, so they need no atomic read-modify-write.
+  static void increment(std::atomic<uint64_t>& stat) {
+    stat.store(stat.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  void maybeTrim() {
+    const uint64_t trim_epoch =
+        SliceStoragePoolRegistry::get().trim_epoch_.load(std::memory_order_relaxed);
+    if (trim_epoch != trim_epoch_) {
+      trim_epoch_ = trim_epoch;
+      for (auto& free_list : free_lists_) {
+        free_list.clear();
+      }
+      pooled_bytes_ = 0;
+    }
+  }
+
+  const std::list<SliceStoragePool*>::iterator entry_;
+  std::array<absl::InlinedVector<Slice::StoragePtr, MaxPerSizeClass>, Slice::pool_size_classes_>
+      free_lists_;
+  uint64_t pooled_bytes_{0};
+  uint64_t trim_epoch_{0};
+  std::array<std::atomic<uint64_t>, Slice::pool_size_classes_> hits_{};
+  std::array<std::atomic<uint64_t>, Slice::pool_size_classes_> misses_{};
+};
+
+void SliceStoragePoolRegistry::remove(std::list<SliceStoragePool*>::iterator entry) {
+  Thread::LockGuard lock(lock_);
+  for (uint32_t i = 0; i < Slice::pool_size_classes_; i++) {
+    exited_hits_[i] += (*entry)->hits(i);
+    exited_misses_[i] += (*entry)->misses(i);
+  }
+  pools_.erase(entry);
+}
+
+std::vector<Slice::PoolStats> SliceStoragePoolRegistry::stats() {
+  Thread::LockGuard lock(lock_);
+  std::vector<Slice::PoolStats> stats;
+  stats.reserve(Slice::pool_size_classes_);
+  for (uint32_t i = 0; i < Slice::pool_size_classes_; i++) {
+    Slice::PoolStats size_class_stats{(i + 1) * Slice::page_size_, exited_hits_[i],
+                                      exited_misses_[i]};
+    for (const SliceStoragePool* pool : pools_) {
+      size_class_stats.hits_ += pool->hits(i);
+      size_class_stats.misses_ += pool->misses(i);
+    }
+    stats.push_back(size_class_stats);
+  }
+  return stats;
+}
+
 } // namespace
 
-thread_local absl::InlinedVector<Slice::StoragePtr, Slice::free_list_max_> Slice::free_list_;
+Slice::StoragePtr Slice::newStorage(uint64_t capacity) {
+  ASSERT(sliceSize(default_slice_size_) == default_slice_size_,
+         "default_slice_size_ incompatible with sliceSize()");
+  ASSERT(sliceSize(capacity) == capacity,
+         "newStorage should only be called on values returned from sliceSize()");
+
+  if (capacity > 0 && SliceStoragePool::pooled(capacity)) {
+    SliceStoragePool* pool = SliceStoragePool::threadLocal();
+    StoragePtr storage = pool != nullptr ? pool->take(capacity) : nullptr;
+    if (storage != nullptr) {
+      return storage;
+    }
+  }
+  return StoragePtr(new uint8_t[capacity]);
+}
+
+void Slice::freeStorage(StoragePtr storage, uint64_t capacity) {
+  if (storage == nullptr) {
+    return;
+  }
+  if (capacity > 0 && SliceStoragePool::pooled(capacity)) {
+    SliceStoragePool* pool = SliceStoragePool::threadLocal();
+    if (pool != nullptr) {
+      pool->put(storage, capacity);
+    }
+  }
+}
+
+std::vector<Slice::PoolStats> Slice::poolStats() {
+  return SliceStoragePoolRegistry::get().stats();
+}
+
+void Slice::trimPools() {
+  SliceStoragePoolRegistry::get().trim_epoch_.fetch_add(1, std::memory_order_relaxed);
+}
 
 void OwnedImpl::addImpl(const void* data, uint64_t size) {
   const char* src = static_cast<const char*>(data);
@@ -310,6 +500,42 @@ void OwnedImpl::move(Instance& rhs, uint64_t length) {
   other.postProcess();
 }
 
+void OwnedImpl::movePinned(Instance& rhs, uint64_t length) {
+  ASSERT(&rhs != this);
+  // See move() above for why we do the static cast.
+  OwnedImpl& other = static_cast<OwnedImpl&>(rhs);
+  while (length != 0 && !other.slices_.empty()) {
+    Slice& front = other.slices_.front();
+    const uint64_t slice_size = front.dataSize();
+    if (slice_size == 0) {
+      other.slices_.pop_front();
+      continue;
+    }
+    if (length < slice_size) {
+      // The caller may still reference the head of this slice, so it has to keep its storage. Copy
+      // the tail which stays in `other` into a new slice instead.
+      const uint64_t tail_size = slice_size - length;
+      Slice tail(tail_size, other.account_);
+      tail.append(front.data() + length, tail_size);
+      front.truncate(length);
+      front.maybeChargeAccount(account_);
+      slices_.emplace_back(std::move(front));
+      other.slices_.pop_front();
+      other.slices_.emplace_front(std::move(tail));
+      length_ += length;
+      other.length_ -= length;
+      break;
+    }
+    front.maybeChargeAccount(account_);
+    slices_.emplace_back(std::move(front));
+    other.slices_.pop_front();
+    length_ += slice_size;
+    other.length_ -= slice_size;
+    length -= slice_size;
+  }
+  other.postProcess();
+}
+
 Reservation OwnedImpl::reserveForRead() {
   return reserveWithMaxLength(default_read_reservation_size_);
 }
@@ -355,7 +581,7 @@ Reservation OwnedImpl::reserveWithMaxLength(uint64_t max_length) {
 
     // We will tag the reservation slices on commit. This avoids unnecessary
     // work in the case that the entire reservation isn't used.
-    Slice slice(size, nullptr, slices_owner->free_list_);
+    Slice slice(size, nullptr);
     const auto raw_slice = slice.reserve(size);
     reservation_slices.push_back(raw_slice);
     slices_owner->owned_slices_.emplace_back(std::move(slice));
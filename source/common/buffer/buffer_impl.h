@@ -5,6 +5,7 @@
 #include <deque>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/buffer/buffer.h"
 
@@ -36,15 +37,6 @@ public:
   using Reservation = RawSlice;
   using StoragePtr = std::unique_ptr<uint8_t[]>;
 
-  static constexpr uint32_t free_list_max_ = Buffer::Reservation::MAX_SLICES_;
-  using FreeListType = absl::InlinedVector<StoragePtr, free_list_max_>;
-  class FreeListReference {
-  private:
-    FreeListReference(FreeListType& free_list) : free_list_(free_list) {}
-    FreeListType& free_list_;
-    friend class Slice;
-  };
-
   /**
    * Create an empty Slice with 0 capacity.
    */
@@ -56,11 +48,9 @@ public:
    * @param min_capacity number of bytes of space the slice should have. Actual capacity is rounded
    * up to the next multiple of 4kb.
    * @param account the account to charge.
-   * @param freelist to search for the backing storage, if any.
    */
-  Slice(uint64_t min_capacity, BufferMemoryAccountSharedPtr account,
-        absl::optional<FreeListReference> free_list = absl::nullopt)
-      : capacity_(sliceSize(min_capacity)), storage_(newStorage(capacity_, free_list)),
+  Slice(uint64_t min_capacity, BufferMemoryAccountSharedPtr account)
+      : capacity_(sliceSize(min_capacity)), storage_(newStorage(capacity_)),
         base_(storage_.get()), data_(0), reservable_(0) {
     if (account) {
       account->charge(capacity_);
@@ -121,11 +111,6 @@ public:
     freeStorage(std::move(storage_), capacity_);
   }
 
-  void freeStorage(FreeListReference free_list) {
-    callAndClearDrainTrackersAndCharges();
-    freeStorage(std::move(storage_), capacity_, free_list);
-  }
-
   /**
    * @return true if the data in the slice is mutable
    */
@@ -166,6 +151,16 @@ public:
     }
   }
 
+  /**
+   * Remove all but the first `size` bytes of usable content. The removed bytes are not handed back
+   * to the reservable section, so the slice must not be appended to afterwards.
+   * @param size number of bytes to keep. If greater than data_size(), the result is undefined.
+   */
+  void truncate(uint64_t size) {
+    ASSERT(size <= dataSize());
+    reservable_ = data_ + size;
+  }
+
   /**
    * @return the number of bytes available to be reserve()d.
    * @note Read-only implementations of Slice should return zero from this method.
@@ -337,7 +332,32 @@ public:
 
   static constexpr uint32_t default_slice_size_ = 16384;
 
-  static FreeListReference freeList() { return FreeListReference(free_list_); }
+  static constexpr uint64_t page_size_ = 4096;
+  // Storage of up to this size is kept in a per-thread pool when it is freed, with a size class
+  // for each multiple of the page size, and reused by the next slice of the same size on the
+  // thread.
+  static constexpr uint64_t max_pooled_size_ = 16 * page_size_;
+  static constexpr uint32_t pool_size_classes_ = max_pooled_size_ / page_size_;
+  // The most storage each thread's pool holds. Storage freed beyond this goes to the allocator.
+  static constexpr uint64_t max_pooled_bytes_per_thread_ = 1024 * 1024;
+
+  struct PoolStats {
+    uint64_t size_;
+    uint64_t hits_;
+    uint64_t misses_;
+  };
+
+  /**
+   * @return for each size class of the storage pools, the number of slices which did and didn't
+   *         get their storage from a pool, summed over all threads.
+   */
+  static std::vector<PoolStats> poolStats();
+
+  /**
+   * Frees the storage held by every thread's pool. Each thread does this the next time it
+   * allocates or frees slice storage, so this can be called from any thread.
+   */
+  static void trimPools();
 
 protected:
   /**
@@ -346,53 +366,12 @@ protected:
    * @return a recommended slice size, in bytes.
    */
   static uint64_t sliceSize(uint64_t data_size) {
-    static constexpr uint64_t PageSize = 4096;
-    const uint64_t num_pages = (data_size + PageSize - 1) / PageSize;
-    return num_pages * PageSize;
-  }
-
-  static StoragePtr newStorage(uint64_t capacity, absl::optional<FreeListReference> free_list_opt) {
-    ASSERT(sliceSize(default_slice_size_) == default_slice_size_,
-           "default_slice_size_ incompatible with sliceSize()");
-    ASSERT(sliceSize(capacity) == capacity,
-           "newStorage should only be called on values returned from sliceSize()");
-    ASSERT(!free_list_opt.has_value() || &free_list_opt->free_list_ == &free_list_);
-
-    StoragePtr storage;
-    if (capacity == default_slice_size_ && free_list_opt.has_value()) {
-      FreeListType& free_list = free_list_opt->free_list_;
-      if (!free_list.empty()) {
-        storage = std::move(free_list.back());
-        ASSERT(storage != nullptr);
-        ASSERT(free_list.back() == nullptr);
-        free_list.pop_back();
-        return storage;
-      }
-    }
-
-    storage.reset(new uint8_t[capacity]);
-    return storage;
+    const uint64_t num_pages = (data_size + page_size_ - 1) / page_size_;
+    return num_pages * page_size_;
   }
 
-  static void freeStorage(StoragePtr storage, uint64_t capacity,
-                          absl::optional<FreeListReference> free_list_opt = absl::nullopt) {
-    if (storage == nullptr) {
-      return;
-    }
-
-    if (capacity == default_slice_size_ && free_list_opt.has_value()) {
-      FreeListType& free_list = free_list_opt->free_list_;
-      if (free_list.size() < free_list_max_) {
-        free_list.emplace_back(std::move(storage));
-        ASSERT(storage == nullptr);
-        return;
-      }
-    }
-
-    storage.reset();
-  }
-
-  static thread_local FreeListType free_list_;
+  static StoragePtr newStorage(uint64_t capacity);
+  static void freeStorage(StoragePtr storage, uint64_t capacity);
 
   /** Length of the byte array that base_ points to. This is also the offset in bytes from the start
    * of the slice to the end of the Reservable section. */
@@ -688,6 +667,7 @@ public:
   void* linearize(uint32_t size) override;
   void move(Instance& rhs) override;
   void move(Instance& rhs, uint64_t length) override;
+  void movePinned(Instance& rhs, uint64_t length) override;
   Reservation reserveForRead() override;
   ReservationSingleSlice reserveSingleSlice(uint64_t length, bool separate_slice = false) override;
   ssize_t search(const void* data, uint64_t size, size_t start, size_t length) const override;
@@ -779,18 +759,14 @@ private:
   };
 
   struct OwnedImplReservationSlicesOwnerMultiple : public OwnedImplReservationSlicesOwner {
-    // Optimization: get the thread_local freeList() once per Reservation, outside the loop.
-    OwnedImplReservationSlicesOwnerMultiple() : free_list_(Slice::freeList()) {}
-
     ~OwnedImplReservationSlicesOwnerMultiple() override {
+      // Free the unused slices last to first, so the next reservation gets them in the same order.
       while (!owned_slices_.empty()) {
-        owned_slices_.back().freeStorage(free_list_);
         owned_slices_.pop_back();
       }
     }
     absl::Span<Slice> ownedSlices() override { return absl::MakeSpan(owned_slices_); }
 
-    Slice::FreeListReference free_list_;
     absl::InlinedVector<Slice, Buffer::Reservation::MAX_SLICES_> owned_slices_;
   };
 
@@ -872,6 +848,10 @@ public:
     buffer_memory_allocated_ -= amount;
   }
 
+  // The account is not tracked for any stream.
+  void resetDownstream() override {}
+  void clearDownstream() override {}
+
 private:
   uint64_t buffer_memory_allocated_ = 0;
 };
@@ -0,0 +1,179 @@
+#include "source/common/buffer/disk_spill_impl.h"
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/logger.h"
+#include "source/common/common/utility.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+constexpr uint64_t DefaultMemoryThreshold = 1024 * 1024;
+constexpr uint64_t DefaultSegmentSize = 1024 * 1024;
+constexpr uint64_t DefaultMaxDiskBytes = 1024 * 1024 * 1024;
+
+/**
+ * A spilled chunk, which keeps its segment mapped while it is buffered.
+ */
+class SpillFragment : public BufferFragment {
+public:
+  SpillFragment(DiskSpillSegmentSharedPtr segment, const uint8_t* data, size_t size)
+      : segment_(std::move(segment)), data_(data), size_(size) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return data_; }
+  size_t size() const override { return size_; }
+  void done() override { delete this; }
+
+private:
+  const DiskSpillSegmentSharedPtr segment_;
+  const uint8_t* const data_;
+  const size_t size_;
+};
+
+} // namespace
+
+DiskSpillSegment::~DiskSpillSegment() {
+#ifndef WIN32
+  ::munmap(base_, size_);
+#endif
+  spill_->stats().disk_bytes_.sub(size_);
+  spill_->release(1);
+}
+
+DiskSpillSharedPtr DiskSpill::create(const envoy::config::core::v3::BufferSpillConfig& config,
+                                     Stats::Scope& scope, const std::string& prefix) {
+  return DiskSpillSharedPtr{new DiskSpill(config, scope, prefix)};
+}
+
+DiskSpill::DiskSpill(const envoy::config::core::v3::BufferSpillConfig& config,
+                     Stats::Scope& scope, const std::string& prefix)
+    : path_template_(absl::StrCat(config.directory().empty() ? "/tmp" : config.directory(),
+                                  "/envoy_spill_XXXXXX")),
+      memory_threshold_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, memory_threshold_bytes, DefaultMemoryThreshold)),
+      segment_size_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, segment_size_bytes, DefaultSegmentSize)),
+      max_disk_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_disk_bytes, DefaultMaxDiskBytes)),
+      scope_(scope.createScope(prefix)),
+      stats_({ALL_BUFFER_SPILL_STATS(POOL_COUNTER(*scope_), POOL_GAUGE(*scope_))}) {}
+
+bool DiskSpill::reserve(uint64_t count) {
+  const uint64_t bytes = count * segment_size_;
+  uint64_t reserved = reserved_bytes_.load();
+  do {
+    if (reserved + bytes > max_disk_bytes_) {
+      return false;
+    }
+  } while (!reserved_bytes_.compare_exchange_weak(reserved, reserved + bytes));
+  return true;
+}
+
+void DiskSpill::release(uint64_t count) {
+  ASSERT(reserved_bytes_.load() >= count * segment_size_);
+  reserved_bytes_ -= count * segment_size_;
+}
+
+DiskSpillSegmentSharedPtr DiskSpill::createSegment() {
+#ifdef WIN32
+  return nullptr;
+#else
+  std::string path = path_template_;
+  const int fd = ::mkstemp(path.data());
+  if (fd < 0) {
+    ENVOY_LOG_MISC(warn, "unable to create buffer spill file in {}: {}", path_template_,
+                   errorDetails(errno));
+    return nullptr;
+  }
+  // The file is only reachable through the mapping, so that its space is freed with the last
+  // fragment whatever the way Envoy exits.
+  ::unlink(path.c_str());
+#ifdef __linux__
+  // Allocating the blocks up front fails here when the disk is full, rather than with a SIGBUS on
+  // the first write to the mapping.
+  const bool allocated = ::posix_fallocate(fd, 0, segment_size_) == 0;
+#else
+  const bool allocated = ::ftruncate(fd, segment_size_) == 0;
+#endif
+  void* mapping =
+      allocated ? ::mmap(nullptr, segment_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                : MAP_FAILED;
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    ENVOY_LOG_MISC(warn, "unable to map buffer spill file in {}", path_template_);
+    return nullptr;
+  }
+  stats_.disk_bytes_.add(segment_size_);
+  return std::make_shared<DiskSpillSegment>(shared_from_this(), static_cast<uint8_t*>(mapping),
+                                            segment_size_);
+#endif
+}
+
+bool DiskSpiller::spill(Instance& data) {
+  const uint64_t length = data.length();
+  if (length == 0) {
+    return true;
+  }
+
+  // Reserve and create all the segments the chunk needs first, so that it is either spilled whole
+  // or left in memory.
+  const uint64_t free_space = segment_ != nullptr ? segment_->size() - segment_offset_ : 0;
+  const uint64_t segment_size = spill_->segmentSize();
+  const uint64_t count =
+      length > free_space ? (length - free_space + segment_size - 1) / segment_size : 0;
+  if (!spill_->reserve(count)) {
+    spill_->stats().spill_disk_full_.inc();
+    return false;
+  }
+  std::vector<DiskSpillSegmentSharedPtr> segments;
+  segments.reserve(count);
+  while (segments.size() < count) {
+    DiskSpillSegmentSharedPtr segment = spill_->createSegment();
+    if (segment == nullptr) {
+      // The created segments release their own reservation as they are destroyed.
+      spill_->release(count - segments.size());
+      spill_->stats().spill_failed_.inc();
+      return false;
+    }
+    segments.push_back(std::move(segment));
+  }
+
+  OwnedImpl spilled;
+  auto next_segment = segments.begin();
+  uint64_t offset = 0;
+  while (offset < length) {
+    if (segment_ == nullptr || segment_offset_ == segment_->size()) {
+      ASSERT(next_segment != segments.end());
+      segment_ = std::move(*next_segment++);
+      segment_offset_ = 0;
+    }
+    const uint64_t size = std::min(length - offset, segment_->size() - segment_offset_);
+    uint8_t* dest = segment_->base() + segment_offset_;
+    data.copyOut(offset, size, dest);
+    spilled.addBufferFragment(*new SpillFragment(segment_, dest, size));
+    offset += size;
+    segment_offset_ += size;
+  }
+
+  data.drain(length);
+  data.move(spilled);
+  spill_->stats().spilled_bytes_.add(length);
+  return true;
+}
+
+} // namespace Buffer
+} // namespace Envoy
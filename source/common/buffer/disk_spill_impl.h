@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/config/core/v3/base.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * All buffer spill stats. @see stats_macros.h
+ */
+#define ALL_BUFFER_SPILL_STATS(COUNTER, GAUGE)                                                     \
+  COUNTER(spill_disk_full)                                                                         \
+  COUNTER(spill_failed)                                                                            \
+  COUNTER(spilled_bytes)                                                                           \
+  GAUGE(disk_bytes, Accumulate)
+
+/**
+ * Struct definition for all buffer spill stats. @see stats_macros.h
+ */
+struct BufferSpillStats {
+  ALL_BUFFER_SPILL_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+class DiskSpill;
+using DiskSpillSharedPtr = std::shared_ptr<DiskSpill>;
+
+/**
+ * A memory mapped segment of an unlinked temporary file, unmapped and freed once the last fragment
+ * referencing its data is released.
+ */
+class DiskSpillSegment : NonCopyable {
+public:
+  DiskSpillSegment(DiskSpillSharedPtr spill, uint8_t* base, uint64_t size)
+      : spill_(std::move(spill)), base_(base), size_(size) {}
+  ~DiskSpillSegment();
+
+  uint8_t* base() const { return base_; }
+  uint64_t size() const { return size_; }
+
+private:
+  const DiskSpillSharedPtr spill_;
+  uint8_t* const base_;
+  const uint64_t size_;
+};
+
+using DiskSpillSegmentSharedPtr = std::shared_ptr<DiskSpillSegment>;
+
+/**
+ * The segments of the bodies spilled by a configuration, which may be shared by all the workers.
+ * The disk space is reserved whole segments at a time, so that the segments never take more than
+ * the configured maximum.
+ */
+class DiskSpill : public std::enable_shared_from_this<DiskSpill>, NonCopyable {
+public:
+  static DiskSpillSharedPtr create(const envoy::config::core::v3::BufferSpillConfig& config,
+                                   Stats::Scope& scope, const std::string& prefix);
+
+  /**
+   * @return the number of bytes of a body to buffer in memory before spilling the rest of it.
+   */
+  uint64_t memoryThreshold() const { return memory_threshold_; }
+  uint64_t segmentSize() const { return segment_size_; }
+  BufferSpillStats& stats() { return stats_; }
+
+  /**
+   * Reserve the disk space of segments.
+   * @param count supplies the number of segments.
+   * @return whether all of them fit under the maximum, nothing being reserved if not.
+   */
+  bool reserve(uint64_t count);
+
+  /**
+   * Release the disk space reserved for segments.
+   * @param count supplies the number of segments.
+   */
+  void release(uint64_t count);
+
+  /**
+   * Create a segment whose disk space was reserved, and which releases it once destroyed.
+   * @return the segment, or nullptr if the temporary file could not be created or mapped, the
+   *         reservation being left to the caller to release.
+   */
+  DiskSpillSegmentSharedPtr createSegment();
+
+private:
+  DiskSpill(const envoy::config::core::v3::BufferSpillConfig& config, Stats::Scope& scope,
+            const std::string& prefix);
+
+  const std::string path_template_;
+  const uint64_t memory_threshold_;
+  const uint64_t segment_size_;
+  const uint64_t max_disk_bytes_;
+  Stats::ScopePtr scope_;
+  BufferSpillStats stats_;
+  std::atomic<uint64_t> reserved_bytes_{};
+};
+
+/**
+ * Spills the chunks of a single body into segments, packing them one after another. It is not
+ * thread safe and lives with the stream which buffers the body.
+ */
+class DiskSpiller {
+public:
+  explicit DiskSpiller(DiskSpillSharedPtr spill) : spill_(std::move(spill)) {}
+
+  /**
+   * Replace the content of a buffer by its copy in segments, which is moved without copies with
+   * the rest of the body as any other data.
+   * @param data supplies the buffer to spill.
+   * @return whether the data was spilled, the buffer being left untouched if not.
+   */
+  bool spill(Instance& data);
+
+private:
+  const DiskSpillSharedPtr spill_;
+  // The segment the next chunk is copied into, and the offset of its free space.
+  DiskSpillSegmentSharedPtr segment_;
+  uint64_t segment_offset_{};
+};
+
+using DiskSpillerPtr = std::unique_ptr<DiskSpiller>;
+
+} // namespace Buffer
+} // namespace Envoy
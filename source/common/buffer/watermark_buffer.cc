@@ -1,5 +1,9 @@
 #include "source/common/buffer/watermark_buffer.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "source/common/common/assert.h"
 #include "source/common/runtime/runtime_features.h"
 
@@ -136,5 +140,110 @@ void WatermarkBuffer::checkHighAndOverflowWatermarks() {
   }
 }
 
+void TrackedBufferMemoryAccountImpl::charge(uint64_t amount) {
+  BufferMemoryAccountImpl::charge(amount);
+  updateSizeClass();
+}
+
+void TrackedBufferMemoryAccountImpl::credit(uint64_t amount) {
+  BufferMemoryAccountImpl::credit(amount);
+  updateSizeClass();
+}
+
+void TrackedBufferMemoryAccountImpl::resetDownstream() {
+  if (!reset_handler_.has_value()) {
+    return;
+  }
+  // The stream is done once reset, even if its account is still charged by slices for a while.
+  Http::StreamResetHandler& reset_handler = reset_handler_.ref();
+  clearDownstream();
+  reset_handler.resetStream(Http::StreamResetReason::OverloadManager);
+}
+
+void TrackedBufferMemoryAccountImpl::clearDownstream() {
+  if (!reset_handler_.has_value()) {
+    return;
+  }
+  reset_handler_.reset();
+  if (size_class_.has_value()) {
+    factory_.updateAccountSizeClass(*this, size_class_, absl::nullopt);
+    size_class_.reset();
+  }
+}
+
+absl::optional<uint32_t> TrackedBufferMemoryAccountImpl::balanceToSizeClass() const {
+  uint64_t shifted_balance = balance() >> MinTrackedBalanceShift;
+  if (shifted_balance == 0) {
+    return absl::nullopt;
+  }
+  uint32_t size_class = 0;
+  while (shifted_balance > 1 && size_class < NumSizeClasses - 1) {
+    shifted_balance >>= 1;
+    size_class++;
+  }
+  return size_class;
+}
+
+void TrackedBufferMemoryAccountImpl::updateSizeClass() {
+  if (!reset_handler_.has_value()) {
+    return;
+  }
+  const absl::optional<uint32_t> size_class = balanceToSizeClass();
+  if (size_class != size_class_) {
+    factory_.updateAccountSizeClass(*this, size_class_, size_class);
+    size_class_ = size_class;
+  }
+}
+
+BufferMemoryAccountSharedPtr
+WatermarkBufferFactory::createAccount(Http::StreamResetHandler& reset_handler) {
+  return std::make_shared<TrackedBufferMemoryAccountImpl>(*this, reset_handler);
+}
+
+void WatermarkBufferFactory::updateAccountSizeClass(TrackedBufferMemoryAccountImpl& account,
+                                                    absl::optional<uint32_t> from,
+                                                    absl::optional<uint32_t> to) {
+  if (from.has_value()) {
+    size_classes_[from.value()].erase(&account);
+  }
+  if (to.has_value()) {
+    size_classes_[to.value()].insert(&account);
+  }
+}
+
+uint64_t WatermarkBufferFactory::resetAccountsGivenPressure(float pressure) {
+  ASSERT(pressure >= 0.0 && pressure <= 1.0);
+  if (pressure <= 0.0) {
+    return 0;
+  }
+
+  // The higher the pressure, the more size classes are reset, from the largest one down.
+  constexpr uint32_t num_size_classes = TrackedBufferMemoryAccountImpl::NumSizeClasses;
+  const uint32_t size_classes_to_reset =
+      std::min<uint32_t>(std::floor(pressure * num_size_classes) + 1, num_size_classes);
+
+  // Resetting a stream removes its account from the classes, and possibly the accounts of other
+  // streams on the same connection, so the accounts are collected first.
+  std::vector<std::shared_ptr<TrackedBufferMemoryAccountImpl>> accounts;
+  for (uint32_t i = 0; i < size_classes_to_reset && accounts.size() < MaxStreamsToResetPerCall;
+       i++) {
+    for (TrackedBufferMemoryAccountImpl* account : size_classes_[num_size_classes - 1 - i]) {
+      if (accounts.size() == MaxStreamsToResetPerCall) {
+        break;
+      }
+      accounts.push_back(account->shared_from_this());
+    }
+  }
+
+  if (!accounts.empty()) {
+    ENVOY_LOG_MISC(warn, "resetting {} streams in the {} largest buffer memory size classes",
+                   accounts.size(), size_classes_to_reset);
+  }
+  for (const auto& account : accounts) {
+    account->resetDownstream();
+  }
+  return accounts.size();
+}
+
 } // namespace Buffer
 } // namespace Envoy
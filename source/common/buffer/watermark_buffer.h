@@ -1,10 +1,18 @@
 #pragma once
 
+#include <array>
 #include <functional>
+#include <memory>
 #include <string>
 
+#include "envoy/common/optref.h"
+#include "envoy/http/stream_reset_handler.h"
+
 #include "source/common/buffer/buffer_impl.h"
 
+#include "absl/container/flat_hash_set.h"
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Buffer {
 
@@ -72,6 +80,46 @@ private:
 
 using WatermarkBufferPtr = std::unique_ptr<WatermarkBuffer>;
 
+class WatermarkBufferFactory;
+
+/**
+ * A BufferMemoryAccountImpl charged by a downstream stream, which the WatermarkBufferFactory that
+ * created it tracks in the size class of its balance for as long as the stream is around.
+ */
+class TrackedBufferMemoryAccountImpl
+    : public BufferMemoryAccountImpl,
+      public std::enable_shared_from_this<TrackedBufferMemoryAccountImpl> {
+public:
+  TrackedBufferMemoryAccountImpl(WatermarkBufferFactory& factory,
+                                 Http::StreamResetHandler& reset_handler)
+      : factory_(factory), reset_handler_(reset_handler) {}
+  ~TrackedBufferMemoryAccountImpl() override { ASSERT(!size_class_.has_value()); }
+
+  // Buffer::BufferMemoryAccount
+  void charge(uint64_t amount) override;
+  void credit(uint64_t amount) override;
+  void resetDownstream() override;
+  void clearDownstream() override;
+
+  /**
+   * @return the size class of the balance: the i-th class holds the balances of at least
+   *   2^(MinTrackedBalanceShift + i) bytes, and the last one all the larger balances too. Balances
+   *   under 2^MinTrackedBalanceShift bytes have no class and are not tracked.
+   */
+  absl::optional<uint32_t> balanceToSizeClass() const;
+
+  static constexpr uint32_t NumSizeClasses = 8;
+  static constexpr uint32_t MinTrackedBalanceShift = 20;
+
+private:
+  void updateSizeClass();
+
+  WatermarkBufferFactory& factory_;
+  // Cleared once the stream is done.
+  OptRef<Http::StreamResetHandler> reset_handler_;
+  absl::optional<uint32_t> size_class_;
+};
+
 class WatermarkBufferFactory : public WatermarkFactory {
 public:
   // Buffer::WatermarkFactory
@@ -81,6 +129,33 @@ public:
     return std::make_unique<WatermarkBuffer>(below_low_watermark, above_high_watermark,
                                              above_overflow_watermark);
   }
+  BufferMemoryAccountSharedPtr createAccount(Http::StreamResetHandler& reset_handler) override;
+  uint64_t resetAccountsGivenPressure(float pressure) override;
+
+  /**
+   * Moves an account from a size class to another.
+   * @param account supplies the account to move.
+   * @param from supplies the size class the account was in, if any.
+   * @param to supplies the size class the account is now in, if any.
+   */
+  void updateAccountSizeClass(TrackedBufferMemoryAccountImpl& account,
+                              absl::optional<uint32_t> from, absl::optional<uint32_t> to);
+
+  /**
+   * @return the number of accounts tracked in a size class.
+   */
+  size_t accountsInSizeClass(uint32_t size_class) const {
+    return size_classes_[size_class].size();
+  }
+
+  // Bounds the work of a single reset pass, the next pressure update resets more streams if
+  // still needed.
+  static constexpr uint32_t MaxStreamsToResetPerCall = 50;
+
+private:
+  std::array<absl::flat_hash_set<TrackedBufferMemoryAccountImpl*>,
+             TrackedBufferMemoryAccountImpl::NumSizeClasses>
+      size_classes_;
 };
 
 } // namespace Buffer
@@ -0,0 +1,53 @@
+#include "source/common/buffer/zero_copy_output_stream_impl.h"
+
+#include <algorithm>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Buffer {
+
+ZeroCopyOutputStreamImpl::ZeroCopyOutputStreamImpl(Buffer::Instance& buffer, uint64_t size_hint)
+    : buffer_(buffer), size_hint_remaining_(size_hint) {}
+
+ZeroCopyOutputStreamImpl::~ZeroCopyOutputStreamImpl() { commitReservation(0); }
+
+void ZeroCopyOutputStreamImpl::commitReservation(uint64_t unused) {
+  if (reservation_.has_value()) {
+    ASSERT(unused <= reservation_->length());
+    reservation_->commit(reservation_->length() - unused);
+    reservation_.reset();
+  }
+}
+
+bool ZeroCopyOutputStreamImpl::Next(void** data, int* size) {
+  commitReservation(0);
+
+  // Reserve at most a default sized slice at a time, so large messages are spread over slices
+  // which can be pooled rather than needing one large allocation.
+  uint64_t length = Slice::default_slice_size_;
+  if (size_hint_remaining_ > 0) {
+    length = std::min(length, size_hint_remaining_);
+    size_hint_remaining_ -= length;
+  }
+
+  reservation_.emplace(buffer_.reserveSingleSlice(length));
+  const RawSlice slice = reservation_->slice();
+  *data = slice.mem_;
+  *size = static_cast<int>(slice.len_);
+  byte_count_ += slice.len_;
+  return true;
+}
+
+void ZeroCopyOutputStreamImpl::BackUp(int count) {
+  ASSERT(count >= 0);
+  ASSERT(reservation_.has_value());
+  ASSERT(static_cast<uint64_t>(count) <= reservation_->length());
+
+  commitReservation(count);
+  byte_count_ -= count;
+}
+
+} // namespace Buffer
+} // namespace Envoy
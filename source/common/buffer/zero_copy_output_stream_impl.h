@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/buffer/buffer.h"
+
+#include "source/common/protobuf/protobuf.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+
+namespace Buffer {
+
+// Writes directly into slices reserved at the end of a buffer, so serializing a message does not
+// need an intermediate contiguous copy of it. The data written is committed to the buffer by the
+// next Next() or BackUp() call, or when the stream is destroyed.
+class ZeroCopyOutputStreamImpl : public virtual Protobuf::io::ZeroCopyOutputStream {
+public:
+  // Create output stream appending to buffer. If the number of bytes which will be written is
+  // known it can be passed as size_hint, which keeps the reservations from overshooting it.
+  explicit ZeroCopyOutputStreamImpl(Buffer::Instance& buffer, uint64_t size_hint = 0);
+
+  ~ZeroCopyOutputStreamImpl() override;
+
+  // Protobuf::io::ZeroCopyOutputStream
+  // See
+  // https://developers.google.com/protocol-buffers/docs/reference/cpp/google.protobuf.io.zero_copy_stream#ZeroCopyOutputStream
+  // for each method details.
+  bool Next(void** data, int* size) override;
+  void BackUp(int count) override;
+  ProtobufTypes::Int64 ByteCount() const override { return byte_count_; }
+
+private:
+  void commitReservation(uint64_t unused);
+
+  Buffer::Instance& buffer_;
+  uint64_t size_hint_remaining_;
+  absl::optional<ReservationSingleSlice> reservation_;
+  uint64_t byte_count_{0};
+};
+
+} // namespace Buffer
+} // namespace Envoy
@@ -0,0 +1,233 @@
+#include "source/common/common/async_log_writer.h"
+
+#include <algorithm>
+#include <cassert> // use direct system-assert to avoid cyclic dependency.
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Logger {
+
+namespace {
+
+uint64_t nextWriterId() {
+  static std::atomic<uint64_t> next_writer_id{1};
+  return next_writer_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Whether this thread is the background thread of a writer, for it not to wait for itself.
+bool& onDrainThread() {
+  static thread_local bool on_drain_thread = false;
+  return on_drain_thread;
+}
+
+} // namespace
+
+AsyncLogWriter::AsyncLogWriter(WriteCb write_cb, uint32_t ring_capacity)
+    : write_cb_(std::move(write_cb)), ring_capacity_(ring_capacity), id_(nextWriterId()) {}
+
+AsyncLogWriter::~AsyncLogWriter() { stop(); }
+
+void AsyncLogWriter::start(Thread::ThreadFactory& thread_factory) {
+  assert(drain_thread_ == nullptr);
+  {
+    absl::MutexLock lock(&wake_up_mutex_);
+    running_ = true;
+  }
+  drain_thread_ = thread_factory.createThread([this]() -> void { drainThread(); },
+                                              Thread::Options{"LogWriter"});
+}
+
+void AsyncLogWriter::stop() {
+  if (drain_thread_ == nullptr) {
+    return;
+  }
+  {
+    absl::MutexLock lock(&wake_up_mutex_);
+    woken_up_ = true;
+    shutdown_ = true;
+  }
+  // The background thread writes the messages that are still buffered before it exits.
+  drain_thread_->join();
+  drain_thread_.reset();
+
+  absl::MutexLock lock(&wake_up_mutex_);
+  woken_up_ = false;
+  running_ = false;
+  shutdown_ = false;
+}
+
+void AsyncLogWriter::log(const spdlog::details::log_msg& msg) {
+  MessageRing& ring = ringOfThisThread();
+  if (!ring.push(msg)) {
+    ring.dropped_.fetch_add(1, std::memory_order_relaxed);
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+  wakeUp();
+}
+
+void AsyncLogWriter::flush() {
+  if (onDrainThread()) {
+    return;
+  }
+  absl::MutexLock lock(&wake_up_mutex_);
+  if (!running_ || shutdown_) {
+    return;
+  }
+  const uint64_t flush_request = ++flush_requests_;
+  woken_up_ = true;
+  while (flushes_done_ < flush_request) {
+    flushed_.Wait(&wake_up_mutex_);
+  }
+}
+
+bool AsyncLogWriter::MessageRing::push(const spdlog::details::log_msg& msg) {
+  const uint64_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+    return false;
+  }
+  Message& message = slots_[tail % slots_.size()];
+  message.time_ = msg.time;
+  message.source_ = msg.source;
+  message.level_ = msg.level;
+  message.thread_id_ = msg.thread_id;
+  message.logger_name_.assign(msg.logger_name.data(), msg.logger_name.size());
+  message.payload_.assign(msg.payload.data(), msg.payload.size());
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+uint64_t AsyncLogWriter::MessageRing::popAll(AsyncLogWriter& writer) {
+  const uint64_t tail = tail_.load(std::memory_order_acquire);
+  uint64_t head = head_.load(std::memory_order_relaxed);
+  const uint64_t popped = tail - head;
+  for (; head != tail; head++) {
+    writer.writeMessage(slots_[head % slots_.size()]);
+    // Each slot is released once written, for the thread to keep logging into it.
+    head_.store(head + 1, std::memory_order_release);
+  }
+  return popped;
+}
+
+bool AsyncLogWriter::MessageRing::empty() const {
+  return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+}
+
+AsyncLogWriter::ThreadRing::~ThreadRing() {
+  if (ring_ != nullptr) {
+    ring_->thread_exited_.store(true, std::memory_order_release);
+  }
+}
+
+AsyncLogWriter::MessageRing& AsyncLogWriter::ringOfThisThread() {
+  // The ring is registered once per thread, so the lock is not taken for each message.
+  static thread_local ThreadRing thread_ring;
+  if (thread_ring.writer_id_ != id_) {
+    if (thread_ring.ring_ != nullptr) {
+      // The thread now logs to another writer, which the previous one sees as the thread exiting.
+      thread_ring.ring_->thread_exited_.store(true, std::memory_order_release);
+    }
+    thread_ring.ring_ = std::make_shared<MessageRing>(ring_capacity_);
+    thread_ring.writer_id_ = id_;
+    absl::MutexLock lock(&rings_mutex_);
+    rings_.push_back(thread_ring.ring_);
+    rings_version_.fetch_add(1, std::memory_order_release);
+  }
+  return *thread_ring.ring_;
+}
+
+void AsyncLogWriter::wakeUp() {
+  // Pairs with the fence of the background thread, so that either the background thread sees the
+  // pushed message before it waits, or the pushing thread sees that it is waiting.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (waiting_.load(std::memory_order_relaxed) && waiting_.exchange(false)) {
+    absl::MutexLock lock(&wake_up_mutex_);
+    woken_up_ = true;
+  }
+}
+
+void AsyncLogWriter::drainThread() {
+  onDrainThread() = true;
+  while (true) {
+    if (drainRings() > 0) {
+      continue;
+    }
+
+    waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (drainRings() > 0) {
+      waiting_.store(false, std::memory_order_relaxed);
+      continue;
+    }
+
+    absl::MutexLock lock(&wake_up_mutex_);
+    wake_up_mutex_.Await(absl::Condition(&woken_up_));
+    woken_up_ = false;
+    waiting_.store(false, std::memory_order_relaxed);
+    if (shutdown_) {
+      break;
+    }
+  }
+
+  drainRings();
+  onDrainThread() = false;
+}
+
+uint64_t AsyncLogWriter::drainRings() {
+  // The flushes requested so far are done once the messages buffered before them are written.
+  uint64_t flush_requests;
+  {
+    absl::MutexLock lock(&wake_up_mutex_);
+    flush_requests = flush_requests_;
+  }
+
+  // The rings are only copied when they change, so the lock is not taken for each drain.
+  if (rings_version_.load(std::memory_order_acquire) != drained_rings_version_) {
+    absl::MutexLock lock(&rings_mutex_);
+    drained_rings_ = rings_;
+    drained_rings_version_ = rings_version_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t drained = 0;
+  bool thread_exited = false;
+  for (const MessageRingSharedPtr& ring : drained_rings_) {
+    // Read before popping, so that the last messages of an exited thread are all written.
+    thread_exited = ring->thread_exited_.load(std::memory_order_acquire) || thread_exited;
+    drained += ring->popAll(*this);
+    const uint64_t dropped = ring->dropped_.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+      const std::string payload = absl::StrCat("dropped ", dropped, " log messages");
+      write_cb_(spdlog::details::log_msg("misc", spdlog::level::warn, payload));
+    }
+  }
+
+  if (thread_exited) {
+    absl::MutexLock lock(&rings_mutex_);
+    rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                [](const MessageRingSharedPtr& ring) {
+                                  return ring->thread_exited_.load(std::memory_order_acquire) &&
+                                         ring->empty();
+                                }),
+                 rings_.end());
+    rings_version_.fetch_add(1, std::memory_order_release);
+  }
+
+  absl::MutexLock lock(&wake_up_mutex_);
+  if (flushes_done_ != flush_requests) {
+    flushes_done_ = flush_requests;
+    flushed_.SignalAll();
+  }
+  return drained;
+}
+
+void AsyncLogWriter::writeMessage(const Message& message) {
+  spdlog::details::log_msg msg(message.source_, message.logger_name_, message.level_,
+                               message.payload_);
+  msg.time = message.time_;
+  msg.thread_id = message.thread_id_;
+  write_cb_(msg);
+}
+
+} // namespace Logger
+} // namespace Envoy
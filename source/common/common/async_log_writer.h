@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/thread/thread.h"
+
+#include "absl/synchronization/mutex.h"
+#include "spdlog/spdlog.h"
+
+namespace Envoy {
+namespace Logger {
+
+/**
+ * Writes the log messages of all of the threads from a background thread. Each thread copies its
+ * messages into a ring of its own without taking any lock, and the background thread formats and
+ * writes them, in order for each thread. The messages which do not fit in the ring of their thread
+ * are dropped and counted, so that logging never blocks the thread.
+ */
+class AsyncLogWriter {
+public:
+  // The messages buffered for each thread.
+  static constexpr uint32_t DefaultRingCapacity = 1024;
+
+  using WriteCb = std::function<void(const spdlog::details::log_msg& msg)>;
+
+  /**
+   * @param write_cb writes a message, called on the background thread.
+   * @param ring_capacity the messages buffered for each thread.
+   */
+  explicit AsyncLogWriter(WriteCb write_cb, uint32_t ring_capacity = DefaultRingCapacity);
+  ~AsyncLogWriter();
+
+  /**
+   * Start the background thread.
+   * @param thread_factory creates the background thread.
+   */
+  void start(Thread::ThreadFactory& thread_factory);
+
+  /**
+   * Stop the background thread, once it has written the buffered messages.
+   */
+  void stop();
+
+  /**
+   * Buffer a message for the background thread, or drop it if the ring of this thread is full.
+   * The logger name and payload are copied, the message being formatted by the background thread.
+   */
+  void log(const spdlog::details::log_msg& msg);
+
+  /**
+   * Wait for the background thread to write the messages buffered so far. Returns at once if the
+   * background thread is not running, or if called from it.
+   */
+  void flush();
+
+  /**
+   * @return uint64_t the messages dropped since the writer was created.
+   */
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+  struct Message {
+    spdlog::log_clock::time_point time_;
+    spdlog::source_loc source_;
+    spdlog::level::level_enum level_{spdlog::level::off};
+    size_t thread_id_{0};
+    std::string logger_name_;
+    std::string payload_;
+  };
+
+  // Single producer single consumer ring, pushed to by its thread and popped from by the
+  // background thread. The messages are kept in the slots, so that their strings keep their
+  // capacity.
+  class MessageRing {
+  public:
+    explicit MessageRing(uint32_t capacity) : slots_(capacity) {}
+
+    bool push(const spdlog::details::log_msg& msg);
+    // Writes the messages pushed so far with the writer, and returns how many there were.
+    uint64_t popAll(AsyncLogWriter& writer);
+    bool empty() const;
+
+    // The messages dropped since the background thread last wrote how many there were.
+    std::atomic<uint64_t> dropped_{0};
+    // Set once the thread exited, for the empty ring to be removed.
+    std::atomic<bool> thread_exited_{false};
+
+  private:
+    std::vector<Message> slots_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+  };
+  using MessageRingSharedPtr = std::shared_ptr<MessageRing>;
+
+  // The ring of a thread, released once the thread exits.
+  struct ThreadRing {
+    ~ThreadRing();
+
+    uint64_t writer_id_{0};
+    MessageRingSharedPtr ring_;
+  };
+
+  MessageRing& ringOfThisThread();
+  // Wakes the background thread up if it is waiting for messages.
+  void wakeUp();
+  void drainThread();
+  uint64_t drainRings();
+  void writeMessage(const Message& message);
+
+  const WriteCb write_cb_;
+  const uint32_t ring_capacity_;
+  // Identifies the writer to the threads, which keep the ring of the last writer they logged to.
+  const uint64_t id_;
+  std::atomic<uint64_t> dropped_{0};
+
+  absl::Mutex rings_mutex_;
+  std::vector<MessageRingSharedPtr> rings_ ABSL_GUARDED_BY(rings_mutex_);
+  // Incremented with each change of rings_, for the background thread to copy them again.
+  std::atomic<uint64_t> rings_version_{0};
+  std::vector<MessageRingSharedPtr> drained_rings_;
+  uint64_t drained_rings_version_{0};
+
+  // Set while the background thread waits, for the threads buffering messages to wake it up
+  // without taking the lock otherwise.
+  std::atomic<bool> waiting_{false};
+  absl::Mutex wake_up_mutex_;
+  absl::CondVar flushed_;
+  bool woken_up_ ABSL_GUARDED_BY(wake_up_mutex_){false};
+  bool running_ ABSL_GUARDED_BY(wake_up_mutex_){false};
+  bool shutdown_ ABSL_GUARDED_BY(wake_up_mutex_){false};
+  uint64_t flush_requests_ ABSL_GUARDED_BY(wake_up_mutex_){0};
+  uint64_t flushes_done_ ABSL_GUARDED_BY(wake_up_mutex_){0};
+  Thread::ThreadPtr drain_thread_;
+};
+
+} // namespace Logger
+} // namespace Envoy
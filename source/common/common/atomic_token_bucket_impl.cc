@@ -0,0 +1,93 @@
+#include "source/common/common/atomic_token_bucket_impl.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace Envoy {
+namespace {
+
+constexpr double NanosecondsPerSecond = 1e9;
+// Absorbs the rounding of the times to whole nanoseconds, which would otherwise take a token away
+// from a bucket refilled with exactly a whole number of tokens.
+constexpr double TokenEpsilon = 1e-6;
+
+} // namespace
+
+AtomicTokenBucketImpl::AtomicTokenBucketImpl(uint64_t max_tokens, TimeSource& time_source,
+                                             double fill_rate)
+    : max_tokens_(max_tokens), fill_rate_(std::abs(fill_rate)), time_source_(time_source),
+      empty_time_(now() - refillTime(max_tokens_)) {}
+
+uint64_t
+AtomicTokenBucketImpl::consume(const std::function<uint64_t(uint64_t)>& tokens_to_consume) {
+  const int64_t time_now = now();
+  const int64_t full_time = time_now - refillTime(max_tokens_);
+  int64_t empty_time = empty_time_.load(std::memory_order_relaxed);
+  uint64_t consumed;
+  int64_t new_empty_time;
+  do {
+    const uint64_t available =
+        static_cast<uint64_t>(std::floor(tokensAt(time_now, empty_time) + TokenEpsilon));
+    consumed = std::min(tokens_to_consume(available), available);
+    if (consumed == 0) {
+      return 0;
+    }
+    // The tokens refilled beyond the maximum are lost.
+    new_empty_time = std::max(empty_time, full_time) + refillTime(consumed);
+  } while (!empty_time_.compare_exchange_weak(empty_time, new_empty_time,
+                                              std::memory_order_relaxed));
+  return consumed;
+}
+
+uint64_t AtomicTokenBucketImpl::consume(uint64_t tokens, bool allow_partial) {
+  return consume([tokens, allow_partial](uint64_t available) -> uint64_t {
+    if (allow_partial) {
+      return std::min(tokens, available);
+    }
+    return available >= tokens ? tokens : 0;
+  });
+}
+
+uint64_t AtomicTokenBucketImpl::consume(uint64_t tokens, bool allow_partial,
+                                        std::chrono::milliseconds& time_to_next_token) {
+  auto tokens_consumed = consume(tokens, allow_partial);
+  time_to_next_token = nextTokenAvailable();
+  return tokens_consumed;
+}
+
+std::chrono::milliseconds AtomicTokenBucketImpl::nextTokenAvailable() {
+  const double available = tokensAt(now(), empty_time_.load(std::memory_order_relaxed));
+  // If there are tokens available, return immediately.
+  if (available + TokenEpsilon >= 1) {
+    return std::chrono::milliseconds(0);
+  }
+  return std::chrono::milliseconds(
+      static_cast<uint64_t>(std::ceil((1 - available) / fill_rate_ * 1000)));
+}
+
+void AtomicTokenBucketImpl::maybeReset(uint64_t num_tokens) {
+  ASSERT(num_tokens <= max_tokens_);
+  // Don't reset if reset once before.
+  if (reset_once_.exchange(true)) {
+    return;
+  }
+  empty_time_.store(now() - refillTime(num_tokens), std::memory_order_relaxed);
+}
+
+int64_t AtomicTokenBucketImpl::now() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time_source_.monotonicTime().time_since_epoch())
+      .count();
+}
+
+int64_t AtomicTokenBucketImpl::refillTime(double tokens) const {
+  return fill_rate_ > 0 ? std::llround(tokens / fill_rate_ * NanosecondsPerSecond) : 0;
+}
+
+double AtomicTokenBucketImpl::tokensAt(int64_t time_now, int64_t empty_time) const {
+  // Another thread may have consumed tokens at a later time.
+  return std::clamp((time_now - empty_time) / NanosecondsPerSecond * fill_rate_, 0.0, max_tokens_);
+}
+
+} // namespace Envoy
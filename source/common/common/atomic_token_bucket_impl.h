@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include "envoy/common/time.h"
+#include "envoy/common/token_bucket.h"
+
+#include "source/common/common/utility.h"
+
+namespace Envoy {
+
+/**
+ * A thread-safe token bucket refilled without a lock. Instead of the number of its tokens, the
+ * bucket keeps the time at which it would have been empty, which is updated with a single
+ * compare-and-swap when tokens are consumed, so that the threads sharing it never wait for each
+ * other.
+ */
+class AtomicTokenBucketImpl : public TokenBucket {
+public:
+  /**
+   * @param max_tokens supplies the maximum number of tokens in the bucket.
+   * @param time_source supplies the time source.
+   * @param fill_rate supplies the number of tokens that will return to the bucket on each second.
+   * The default is 1.
+   */
+  explicit AtomicTokenBucketImpl(uint64_t max_tokens, TimeSource& time_source,
+                                 double fill_rate = 1);
+
+  AtomicTokenBucketImpl(const AtomicTokenBucketImpl&) = delete;
+  AtomicTokenBucketImpl(AtomicTokenBucketImpl&&) = delete;
+
+  /**
+   * Consumes the number of tokens a callback returns, given the tokens available. The callback may
+   * be called more than once when other threads consume tokens at the same time.
+   * @param tokens_to_consume supplies the callback returning the number of tokens to consume, at
+   *                          most the number of tokens available it is given.
+   * @return the number of tokens actually consumed.
+   */
+  uint64_t consume(const std::function<uint64_t(uint64_t)>& tokens_to_consume);
+
+  // TokenBucket
+  uint64_t consume(uint64_t tokens, bool allow_partial) override;
+  uint64_t consume(uint64_t tokens, bool allow_partial,
+                   std::chrono::milliseconds& time_to_next_token) override;
+  std::chrono::milliseconds nextTokenAvailable() override;
+
+  /**
+   * Since the token bucket is shared, only the first reset call will work.
+   * Subsequent calls to reset method will be ignored.
+   */
+  void maybeReset(uint64_t num_tokens) override;
+
+private:
+  // @return the current monotonic time in nanoseconds.
+  int64_t now() const;
+  // @return the nanoseconds it takes to refill a number of tokens.
+  int64_t refillTime(double tokens) const;
+  // @return the tokens available at `time_now` in a bucket that was empty at `empty_time`.
+  double tokensAt(int64_t time_now, int64_t empty_time) const;
+
+  const double max_tokens_;
+  const double fill_rate_;
+  TimeSource& time_source_;
+  // The monotonic time in nanoseconds at which the bucket would have been empty. It is never older
+  // than the time the bucket was last full.
+  std::atomic<int64_t> empty_time_;
+  std::atomic<bool> reset_once_{false};
+};
+
+} // namespace Envoy
@@ -0,0 +1,52 @@
+#include "source/common/common/filter_cost.h"
+
+#include <time.h>
+
+#ifdef ENVOY_PERF_ANNOTATION
+#include "source/common/common/perf_annotation.h"
+#endif
+
+namespace Envoy {
+namespace {
+
+// The innermost timer of the thread, paused by the next one started.
+FilterCostTimer*& currentTimer() {
+  static thread_local FilterCostTimer* current_timer = nullptr;
+  return current_timer;
+}
+
+} // namespace
+
+std::chrono::nanoseconds FilterCostTimer::threadCpuTime() {
+#ifdef CLOCK_THREAD_CPUTIME_ID
+  struct timespec now;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) == 0) {
+    return std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec);
+  }
+#endif
+  return std::chrono::nanoseconds(0);
+}
+
+void FilterCostTimer::start() {
+  start_ = threadCpuTime();
+  parent_ = currentTimer();
+  if (parent_ != nullptr) {
+    parent_->elapsed_ += start_ - parent_->start_;
+  }
+  currentTimer() = this;
+}
+
+void FilterCostTimer::stop() {
+  const std::chrono::nanoseconds now = threadCpuTime();
+  elapsed_ += now - start_;
+  cost_->cpu_time_ += elapsed_;
+#ifdef ENVOY_PERF_ANNOTATION
+  PerfAnnotationContext::getOrCreate()->record(elapsed_, "filter_cost", cost_->cpu_time_us_.name());
+#endif
+  if (parent_ != nullptr) {
+    parent_->start_ = now;
+  }
+  currentTimer() = parent_;
+}
+
+} // namespace Envoy
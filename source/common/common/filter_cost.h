@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+#include "envoy/stats/histogram.h"
+
+#include "source/common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * The CPU time spent in the callbacks of a filter of a sampled stream or connection, recorded in
+ * microseconds into the histogram of the filter once the stream or connection is done.
+ */
+struct FilterCost {
+  explicit FilterCost(Stats::Histogram& cpu_time_us) : cpu_time_us_(cpu_time_us) {}
+
+  void record() {
+    cpu_time_us_.recordValue(
+        std::chrono::duration_cast<std::chrono::microseconds>(cpu_time_).count());
+  }
+
+  Stats::Histogram& cpu_time_us_;
+  std::chrono::nanoseconds cpu_time_{};
+};
+using FilterCostPtr = std::unique_ptr<FilterCost>;
+
+/**
+ * Adds the CPU time used by the thread while the timer exists to the cost of a filter. The timers
+ * started while another one exists, such as for the encoder filters a local reply sent by a decoder
+ * filter goes through, pause it, so that each filter is only charged for its own callbacks. A null
+ * cost measures nothing, so that the streams which are not sampled only pay for a branch.
+ *
+ * Unlike the PERF_* annotations, which are only compiled in with ENVOY_PERF_ANNOTATION, the timers
+ * are meant to be used in release builds, on a sampled fraction of the streams. When the
+ * annotations are compiled in, the time of each callback is also recorded in the
+ * PerfAnnotationContext under the "filter_cost" category.
+ */
+class FilterCostTimer : NonCopyable {
+public:
+  explicit FilterCostTimer(FilterCost* cost) : cost_(cost) {
+    if (cost_ != nullptr) {
+      start();
+    }
+  }
+  ~FilterCostTimer() {
+    if (cost_ != nullptr) {
+      stop();
+    }
+  }
+
+  /**
+   * @return the CPU time used by the calling thread so far, or zero where it can't be measured.
+   */
+  static std::chrono::nanoseconds threadCpuTime();
+
+private:
+  void start();
+  void stop();
+
+  FilterCost* const cost_;
+  // The timer paused by this one, if any.
+  FilterCostTimer* parent_{};
+  // The start of the time not accounted yet, and the time accounted while the timer was paused.
+  std::chrono::nanoseconds start_{};
+  std::chrono::nanoseconds elapsed_{};
+};
+
+} // namespace Envoy
@@ -66,6 +66,41 @@ void DelegatingLogSink::set_formatter(std::unique_ptr<spdlog::formatter> formatt
 }
 
 void DelegatingLogSink::log(const spdlog::details::log_msg& msg) {
+  AsyncLogWriter* async_log_writer = active_async_log_writer_.load(std::memory_order_acquire);
+  if (async_log_writer != nullptr) {
+    async_log_writer->log(msg);
+    return;
+  }
+  writeLog(msg);
+}
+
+void DelegatingLogSink::flush() {
+  AsyncLogWriter* async_log_writer = active_async_log_writer_.load(std::memory_order_acquire);
+  if (async_log_writer != nullptr) {
+    async_log_writer->flush();
+  }
+  absl::ReaderMutexLock lock(&sink_mutex_);
+  sink_->flush();
+}
+
+void DelegatingLogSink::startAsync(Thread::ThreadFactory& thread_factory) {
+  if (async_log_writer_ == nullptr) {
+    async_log_writer_ = std::make_unique<AsyncLogWriter>(
+        [this](const spdlog::details::log_msg& msg) { writeLog(msg); });
+  }
+  async_log_writer_->start(thread_factory);
+  active_async_log_writer_.store(async_log_writer_.get(), std::memory_order_release);
+}
+
+void DelegatingLogSink::stopAsync() {
+  if (async_log_writer_ == nullptr) {
+    return;
+  }
+  active_async_log_writer_.store(nullptr, std::memory_order_release);
+  async_log_writer_->stop();
+}
+
+void DelegatingLogSink::writeLog(const spdlog::details::log_msg& msg) {
   absl::ReleasableMutexLock lock(&format_mutex_);
   absl::string_view msg_view = absl::string_view(msg.payload.data(), msg.payload.size());
 
@@ -112,14 +147,22 @@ DelegatingLogSinkSharedPtr DelegatingLogSink::init() {
 static Context* current_context = nullptr;
 
 Context::Context(spdlog::level::level_enum log_level, const std::string& log_format,
-                 Thread::BasicLockable& lock, bool should_escape, bool enable_fine_grain_logging)
+                 Thread::BasicLockable& lock, bool should_escape, bool enable_fine_grain_logging,
+                 Thread::ThreadFactory* async_thread_factory)
     : log_level_(log_level), log_format_(log_format), lock_(lock), should_escape_(should_escape),
-      enable_fine_grain_logging_(enable_fine_grain_logging), save_context_(current_context) {
+      enable_fine_grain_logging_(enable_fine_grain_logging),
+      async_(async_thread_factory != nullptr), save_context_(current_context) {
   current_context = this;
   activate();
+  if (async_) {
+    Registry::getSink()->startAsync(*async_thread_factory);
+  }
 }
 
 Context::~Context() {
+  if (async_) {
+    Registry::getSink()->stopAsync();
+  }
   current_context = save_context_;
   if (current_context != nullptr) {
     current_context->activate();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <bitset>
 #include <chrono>
 #include <cstdint>
@@ -9,6 +10,7 @@
 
 #include "envoy/thread/thread.h"
 
+#include "source/common/common/async_log_writer.h"
 #include "source/common/common/base_logger.h"
 #include "source/common/common/fancy_logger.h"
 #include "source/common/common/fmt.h"
@@ -158,10 +160,7 @@ public:
 
   // spdlog::sinks::sink
   void log(const spdlog::details::log_msg& msg) override;
-  void flush() override {
-    absl::ReaderMutexLock lock(&sink_mutex_);
-    sink_->flush();
-  }
+  void flush() override;
   void set_pattern(const std::string& pattern) override {
     set_formatter(spdlog::details::make_unique<spdlog::pattern_formatter>(pattern));
   }
@@ -173,6 +172,26 @@ public:
    */
   bool hasLock() const { return stderr_sink_->hasLock(); }
 
+  /**
+   * Write the log messages from a background thread rather than from the threads logging them.
+   * The messages are formatted and written in order for each thread, and dropped once a thread
+   * buffered AsyncLogWriter::DefaultRingCapacity messages which are not written yet.
+   * @param thread_factory creates the background thread.
+   */
+  void startAsync(Thread::ThreadFactory& thread_factory);
+
+  /**
+   * Write the buffered log messages, and the next ones from the threads logging them again.
+   */
+  void stopAsync();
+
+  /**
+   * @return uint64_t the log messages dropped while writing them from a background thread.
+   */
+  uint64_t asyncDroppedMessages() const {
+    return async_log_writer_ != nullptr ? async_log_writer_->dropped() : 0;
+  }
+
   /**
    * Constructs a new DelegatingLogSink, sets up the default sink to stderr,
    * and returns a shared_ptr to it.
@@ -200,6 +219,9 @@ private:
 
   DelegatingLogSink() = default;
 
+  // Formats and writes the message, on the thread logging it or on the background thread.
+  void writeLog(const spdlog::details::log_msg& msg);
+
   void setDelegate(SinkDelegate* sink) {
     absl::WriterMutexLock lock(&sink_mutex_);
     sink_ = sink;
@@ -215,6 +237,9 @@ private:
   std::unique_ptr<spdlog::formatter> formatter_ ABSL_GUARDED_BY(format_mutex_);
   absl::Mutex format_mutex_;
   bool should_escape_{false};
+  // Kept once created, as threads may still be buffering messages while the writer is stopped.
+  std::unique_ptr<AsyncLogWriter> async_log_writer_;
+  std::atomic<AsyncLogWriter*> active_async_log_writer_{nullptr};
 };
 
 enum class LoggerMode { Envoy, Fancy };
@@ -236,8 +261,13 @@ enum class LoggerMode { Envoy, Fancy };
  */
 class Context {
 public:
+  /**
+   * @param async_thread_factory if not null, creates the background thread writing the log
+   *        messages while the context exists. See DelegatingLogSink::startAsync().
+   */
   Context(spdlog::level::level_enum log_level, const std::string& log_format,
-          Thread::BasicLockable& lock, bool should_escape, bool enable_fine_grain_logging = false);
+          Thread::BasicLockable& lock, bool should_escape, bool enable_fine_grain_logging = false,
+          Thread::ThreadFactory* async_thread_factory = nullptr);
   ~Context();
 
   /**
@@ -259,6 +289,7 @@ private:
   Thread::BasicLockable& lock_;
   bool should_escape_;
   bool enable_fine_grain_logging_;
+  const bool async_;
   Context* const save_context_;
 
   std::string fancy_log_format_ = "[%Y-%m-%d %T.%e][%t][%l][%n] %v";
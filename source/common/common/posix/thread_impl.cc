@@ -4,6 +4,7 @@
 #include "absl/strings/str_cat.h"
 
 #if defined(__linux__)
+#include <sched.h>
 #include <sys/syscall.h>
 #endif
 
@@ -41,12 +42,15 @@ public:
       : thread_routine_(std::move(thread_routine)) {
     if (options) {
       name_ = options->name_.substr(0, PTHREAD_MAX_THREADNAME_LEN_INCLUDING_NULL_BYTE - 1);
+      cpu_ = options->cpu_;
     }
     RELEASE_ASSERT(Logger::Registry::initialized(), "");
     const int rc = pthread_create(
         &thread_handle_, nullptr,
         [](void* arg) -> void* {
-          static_cast<ThreadImplPosix*>(arg)->thread_routine_();
+          auto* thread = static_cast<ThreadImplPosix*>(arg);
+          thread->pinToCpu();
+          thread->thread_routine_();
           return nullptr;
         },
         this);
@@ -93,6 +97,27 @@ public:
   }
 
 private:
+  // Pins the calling thread to cpu_, if set. This runs on the new thread before its routine, so
+  // that the routine only ever runs, and allocates its memory, on the CPU.
+  void pinToCpu() {
+    if (!cpu_.has_value()) {
+      return;
+    }
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    if (cpu_.value() < CPU_SETSIZE) {
+      CPU_SET(cpu_.value(), &cpus);
+    }
+    const int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (rc != 0) {
+      ENVOY_LOG_MISC(warn, "Error {} pinning thread `{}' to CPU {}", rc, name_, cpu_.value());
+    }
+#else
+    ENVOY_LOG_MISC(warn, "Pinning thread `{}' to CPU {} is not supported", name_, cpu_.value());
+#endif
+  }
+
 #if SUPPORTS_PTHREAD_NAMING
   // Attempts to get the name from the operating system, returning true and
   // updating 'name' if successful. Note that during normal operation this
@@ -113,6 +138,7 @@ private:
   std::function<void()> thread_routine_;
   pthread_t thread_handle_;
   std::string name_;
+  absl::optional<uint32_t> cpu_;
   bool joined_{false};
 };
 
@@ -14,6 +14,14 @@ public:
   uint64_t random() override;
   std::string uuid() override;
 
+  /**
+   * @return std::string a UUID4 generated with a per-thread xoshiro256** generator seeded from the
+   *         CSPRNG, without the CSPRNG refills of uuid(). The UUIDs are as unlikely to collide, but
+   *         are predictable from the ones seen before, so they are only suitable for identifiers
+   *         which are not used as secrets.
+   */
+  static std::string nonCryptographicUuid();
+
   static const size_t UUID_LENGTH;
 };
 
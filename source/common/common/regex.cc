@@ -1,5 +1,7 @@
 #include "source/common/common/regex.h"
 
+#include <algorithm>
+
 #include "envoy/common/exception.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/type/matcher/v3/regex.pb.h"
@@ -10,6 +12,7 @@
 #include "source/common/stats/symbol_table_impl.h"
 
 #include "re2/re2.h"
+#include "re2/set.h"
 
 namespace Envoy {
 namespace Regex {
@@ -93,6 +96,29 @@ private:
   const re2::RE2 regex_;
 };
 
+class CompiledGoogleReMatcherSet : public CompiledMatcherSet {
+public:
+  explicit CompiledGoogleReMatcherSet(std::unique_ptr<re2::RE2::Set> regex_set)
+      : regex_set_(std::move(regex_set)) {}
+
+  // CompiledMatcherSet
+  bool match(absl::string_view value, std::vector<uint32_t>& matches) const override {
+    std::vector<int> set_matches;
+    re2::RE2::Set::ErrorInfo error_info;
+    if (!regex_set_->Match(re2::StringPiece(value.data(), value.size()), &set_matches,
+                           &error_info)) {
+      // Either nothing matched, or the DFA ran out of memory.
+      return error_info.kind == re2::RE2::Set::kNoError;
+    }
+    std::sort(set_matches.begin(), set_matches.end());
+    matches.insert(matches.end(), set_matches.begin(), set_matches.end());
+    return true;
+  }
+
+private:
+  const std::unique_ptr<re2::RE2::Set> regex_set_;
+};
+
 } // namespace
 
 CompiledMatcherPtr Utility::parseRegex(const envoy::type::matcher::v3::RegexMatcher& matcher) {
@@ -101,6 +127,22 @@ CompiledMatcherPtr Utility::parseRegex(const envoy::type::matcher::v3::RegexMatc
   return std::make_unique<CompiledGoogleReMatcher>(matcher);
 }
 
+CompiledMatcherSetPtr Utility::parseRegexSet(const std::vector<std::string>& regexes) {
+  // The regexes are matched against the whole value, like RE2::FullMatch() does.
+  re2::RE2::Options options;
+  options.set_log_errors(false);
+  auto regex_set = std::make_unique<re2::RE2::Set>(options, re2::RE2::ANCHOR_BOTH);
+  for (const std::string& regex : regexes) {
+    if (regex_set->Add(regex, nullptr) < 0) {
+      return nullptr;
+    }
+  }
+  if (!regex_set->Compile()) {
+    return nullptr;
+  }
+  return std::make_unique<CompiledGoogleReMatcherSet>(std::move(regex_set));
+}
+
 std::regex Utility::parseStdRegex(const std::string& regex, std::regex::flag_type flags) {
   // TODO(zuercher): In the future, PGV (https://github.com/envoyproxy/protoc-gen-validate)
   // annotations may allow us to remove this in favor of direct validation of regular
@@ -2,6 +2,8 @@
 
 #include <memory>
 #include <regex>
+#include <string>
+#include <vector>
 
 #include "envoy/common/regex.h"
 #include "envoy/type/matcher/v3/regex.pb.h"
@@ -30,6 +32,15 @@ public:
    * Construct a compiled regex matcher from a match config.
    */
   static CompiledMatcherPtr parseRegex(const envoy::type::matcher::v3::RegexMatcher& matcher);
+
+  /**
+   * Construct a matcher set evaluating regexes in a single pass, for callers which match a value
+   * against many regexes, such as the regex routes of a virtual host.
+   * @param regexes supplies the regexes of the set, which are expected to be valid.
+   * @return the matcher set, or nullptr if the regex engine can't compile the regexes into a set,
+   *         in which case they have to be matched one by one.
+   */
+  static CompiledMatcherSetPtr parseRegexSet(const std::vector<std::string>& regexes);
 };
 
 } // namespace Regex
@@ -3,8 +3,10 @@
 #include "envoy/config/subscription.h"
 #include "envoy/service/discovery/v3/discovery.pb.h"
 
+#include "source/common/common/hash.h"
 #include "source/common/protobuf/utility.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "xds/core/v3/collection_entry.pb.h"
 
 namespace Envoy {
@@ -60,6 +62,15 @@ public:
                       const std::vector<std::string>& aliases, const std::string& version)
       : resource_(std::move(resource)), has_resource_(true), name_(name), aliases_(aliases),
         version_(version), ttl_(absl::nullopt) {}
+  DecodedResourceImpl(std::shared_ptr<const Protobuf::Message> resource, const std::string& name,
+                      const std::string& version)
+      : resource_(std::move(resource)), has_resource_(true), name_(name), version_(version),
+        ttl_(absl::nullopt) {}
+
+  /**
+   * @return the decoded resource message, which may be shared with other decoded resources.
+   */
+  const std::shared_ptr<const Protobuf::Message>& sharedResource() const { return resource_; }
 
   // Config::DecodedResource
   const std::string& name() const override { return name_; }
@@ -78,7 +89,7 @@ private:
         name_(name ? *name : resource_decoder.resourceName(*resource_)),
         aliases_(repeatedPtrFieldToVector(aliases)), version_(version), ttl_(ttl) {}
 
-  const ProtobufTypes::MessagePtr resource_;
+  const std::shared_ptr<const Protobuf::Message> resource_;
   const bool has_resource_;
   const std::string name_;
   const std::vector<std::string> aliases_;
@@ -87,6 +98,59 @@ private:
   const absl::optional<std::chrono::milliseconds> ttl_;
 };
 
+/**
+ * Decodes the resources of the state-of-the-world responses of one type, reusing the resources of
+ * the last accepted response which are unchanged, by a hash of their serialized bytes, rather than
+ * unpacking and validating them again. This is the same trust in a 64-bit hash that the
+ * subscribers already place in MessageUtil::hash() to skip unchanged resources. Resources wrapped
+ * in a Resource, which may carry a TTL or be heartbeats, are always decoded.
+ *
+ * The resources of the last accepted response are kept until the next one is accepted, roughly
+ * one more copy of the resources of the type than the subscribers hold.
+ */
+class DecodedResourceCache {
+public:
+  /**
+   * Decodes a resource of a response, or reuses the decoded resource with the same bytes from the
+   * last accepted response. Throws EnvoyException if the resource is rejected by the decoder.
+   */
+  DecodedResourceImplPtr decode(OpaqueResourceDecoder& resource_decoder,
+                                const ProtobufWkt::Any& resource, const std::string& version) {
+    if (resource.Is<envoy::service::discovery::v3::Resource>()) {
+      return DecodedResourceImpl::fromResource(resource_decoder, resource, version);
+    }
+    const uint64_t hash = HashUtil::xxHash64(resource.value());
+    DecodedResourceImplPtr decoded;
+    auto it = accepted_.find(hash);
+    if (it != accepted_.end()) {
+      decoded = std::make_unique<DecodedResourceImpl>(it->second->sharedResource(),
+                                                      it->second->name(), version);
+    } else {
+      decoded = DecodedResourceImpl::fromResource(resource_decoder, resource, version);
+    }
+    pending_.emplace(hash, std::make_unique<DecodedResourceImpl>(decoded->sharedResource(),
+                                                                 decoded->name(), version));
+    return decoded;
+  }
+
+  /**
+   * Makes the resources decoded since the last accepted or rejected response the ones to reuse.
+   */
+  void accept() {
+    accepted_ = std::move(pending_);
+    pending_.clear();
+  }
+
+  /**
+   * Drops the resources decoded since the last accepted or rejected response.
+   */
+  void reject() { pending_.clear(); }
+
+private:
+  absl::flat_hash_map<uint64_t, DecodedResourceImplPtr> accepted_;
+  absl::flat_hash_map<uint64_t, DecodedResourceImplPtr> pending_;
+};
+
 struct DecodedResourcesWrapper {
   DecodedResourcesWrapper() = default;
   DecodedResourcesWrapper(OpaqueResourceDecoder& resource_decoder,
@@ -48,7 +48,8 @@ GrpcMuxImpl::GrpcMuxImpl(const LocalInfo::LocalInfo& local_info,
                          const Protobuf::MethodDescriptor& service_method,
                          envoy::config::core::v3::ApiVersion transport_api_version,
                          Random::RandomGenerator& random, Stats::Scope& scope,
-                         const RateLimitSettings& rate_limit_settings, bool skip_subsequent_node)
+                         const RateLimitSettings& rate_limit_settings, bool skip_subsequent_node,
+                         XdsResourceCachePtr resource_cache)
     : grpc_stream_(this, std::move(async_client), service_method, random, dispatcher, scope,
                    rate_limit_settings),
       local_info_(local_info), skip_subsequent_node_(skip_subsequent_node),
@@ -57,7 +58,8 @@ GrpcMuxImpl::GrpcMuxImpl(const LocalInfo::LocalInfo& local_info,
       dynamic_update_callback_handle_(local_info.contextProvider().addDynamicContextUpdateCallback(
           [this](absl::string_view resource_type_url) {
             onDynamicContextUpdate(resource_type_url);
-          })) {
+          })),
+      resource_cache_(std::move(resource_cache)) {
   Config::Utility::checkLocalInfo("ads", local_info);
   AllMuxes::get().insert(this);
 }
@@ -135,6 +137,18 @@ GrpcMuxWatchPtr GrpcMuxImpl::addWatch(const std::string& type_url,
     subscriptions_.emplace_back(type_url);
   }
 
+  // Until the first response for the API is received, warm the new watch from the cached resources
+  // of the API on the next dispatcher iteration, rather than calling back into the subscription
+  // while it is being started.
+  ApiState& api_state = apiStateFor(type_url);
+  if (resource_cache_ != nullptr && !api_state.response_received_) {
+    if (api_state.warm_timer_ == nullptr) {
+      api_state.warm_timer_ =
+          dispatcher_.createTimer([this, type_url]() { warmFromCache(type_url); });
+    }
+    api_state.warm_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+
   // This will send an updated request on each subscription.
   // TODO(htuch): For RDS/EDS, this will generate a new DiscoveryRequest on each resource we added.
   // Consider in the future adding some kind of collation/batching during CDS/LDS updates so that we
@@ -219,84 +233,140 @@ void GrpcMuxImpl::onDiscoveryResponse(
   // the delta state. The proper fix for this is to converge these implementations,
   // see https://github.com/envoyproxy/envoy/issues/11477.
   same_type_resume = pause(type_url);
+  // The response supersedes any cached resources of the API.
+  api_state.response_received_ = true;
+  api_state.warm_timer_.reset();
+  api_state.cached_response_.reset();
   TRY_ASSERT_MAIN_THREAD {
-    // To avoid O(n^2) explosion (e.g. when we have 1000s of EDS watches), we
-    // build a map here from resource name to resource and then walk watches_.
-    // We have to walk all watches (and need an efficient map as a result) to
-    // ensure we deliver empty config updates when a resource is dropped. We make the map ordered
-    // for test determinism.
-    std::vector<DecodedResourceImplPtr> resources;
-    absl::btree_map<std::string, DecodedResourceRef> resource_ref_map;
-    std::vector<DecodedResourceRef> all_resource_refs;
-    OpaqueResourceDecoder& resource_decoder = api_state.watches_.front()->resource_decoder_;
-
-    const auto scoped_ttl_update = api_state.ttl_.scopedTtlUpdate();
-
-    for (const auto& resource : message->resources()) {
-      // TODO(snowp): Check the underlying type when the resource is a Resource.
-      if (!resource.Is<envoy::service::discovery::v3::Resource>() &&
-          type_url != resource.type_url()) {
-        throw EnvoyException(
-            fmt::format("{} does not match the message-wide type URL {} in DiscoveryResponse {}",
-                        resource.type_url(), type_url, message->DebugString()));
-      }
+    deliverResources(type_url, api_state, *message, false);
+    // TODO(mattklein123): In the future if we start tracking per-resource versions, we
+    // would do that tracking here.
+    api_state.request_.set_version_info(message->version_info());
+    api_state.decoded_resources_.accept();
+    if (resource_cache_ != nullptr) {
+      resource_cache_->store(*message);
+    }
+    Memory::Utils::tryShrinkHeap();
+  }
+  END_TRY
+  catch (const EnvoyException& e) {
+    api_state.decoded_resources_.reject();
+    for (auto watch : api_state.watches_) {
+      watch->callbacks_.onConfigUpdateFailed(
+          Envoy::Config::ConfigUpdateFailureReason::UpdateRejected, &e);
+    }
+    ::google::rpc::Status* error_detail = api_state.request_.mutable_error_detail();
+    error_detail->set_code(Grpc::Status::WellKnownGrpcStatus::Internal);
+    error_detail->set_message(Config::Utility::truncateGrpcStatusMessage(e.what()));
+  }
+  api_state.request_.set_response_nonce(message->nonce());
+  ASSERT(api_state.paused());
+  queueDiscoveryRequest(type_url);
+}
+
+void GrpcMuxImpl::deliverResources(const std::string& type_url, ApiState& api_state,
+                                   const envoy::service::discovery::v3::DiscoveryResponse& message,
+                                   bool warming) {
+  // To avoid O(n^2) explosion (e.g. when we have 1000s of EDS watches), we
+  // build a map here from resource name to resource and then walk watches_.
+  // We have to walk all watches (and need an efficient map as a result) to
+  // ensure we deliver empty config updates when a resource is dropped. We make the map ordered
+  // for test determinism.
+  std::vector<DecodedResourceImplPtr> resources;
+  absl::btree_map<std::string, DecodedResourceRef> resource_ref_map;
+  std::vector<DecodedResourceRef> all_resource_refs;
+  OpaqueResourceDecoder& resource_decoder = api_state.watches_.front()->resource_decoder_;
+
+  const auto scoped_ttl_update = api_state.ttl_.scopedTtlUpdate();
+
+  for (const auto& resource : message.resources()) {
+    // TODO(snowp): Check the underlying type when the resource is a Resource.
+    if (!resource.Is<envoy::service::discovery::v3::Resource>() &&
+        type_url != resource.type_url()) {
+      throw EnvoyException(
+          fmt::format("{} does not match the message-wide type URL {} in DiscoveryResponse {}",
+                      resource.type_url(), type_url, message.DebugString()));
+    }
 
-      auto decoded_resource =
-          DecodedResourceImpl::fromResource(resource_decoder, resource, message->version_info());
+    auto decoded_resource =
+        warming ? DecodedResourceImpl::fromResource(resource_decoder, resource,
+                                                    message.version_info())
+                : api_state.decoded_resources_.decode(resource_decoder, resource,
+                                                      message.version_info());
 
+    // The TTLs of cached resources are not tracked, as the resources are superseded by the first
+    // response.
+    if (!warming) {
       if (decoded_resource->ttl()) {
         api_state.ttl_.add(*decoded_resource->ttl(), decoded_resource->name());
       } else {
         api_state.ttl_.clear(decoded_resource->name());
       }
+    }
 
-      if (!isHeartbeatResource(type_url, *decoded_resource)) {
-        resources.emplace_back(std::move(decoded_resource));
-        all_resource_refs.emplace_back(*resources.back());
-        resource_ref_map.emplace(resources.back()->name(), *resources.back());
-      }
+    if (!isHeartbeatResource(type_url, *decoded_resource)) {
+      resources.emplace_back(std::move(decoded_resource));
+      all_resource_refs.emplace_back(*resources.back());
+      resource_ref_map.emplace(resources.back()->name(), *resources.back());
     }
+  }
 
-    for (auto watch : api_state.watches_) {
-      // onConfigUpdate should be called in all cases for single watch xDS (Cluster and
-      // Listener) even if the message does not have resources so that update_empty stat
-      // is properly incremented and state-of-the-world semantics are maintained.
-      if (watch->resources_.empty()) {
-        watch->callbacks_.onConfigUpdate(all_resource_refs, message->version_info());
+  for (auto watch : api_state.watches_) {
+    if (warming) {
+      if (watch->warmed_) {
         continue;
       }
-      std::vector<DecodedResourceRef> found_resources;
-      for (const auto& watched_resource_name : watch->resources_) {
-        auto it = resource_ref_map.find(watched_resource_name);
-        if (it != resource_ref_map.end()) {
-          found_resources.emplace_back(it->second);
-        }
+      watch->warmed_ = true;
+    }
+    // onConfigUpdate should be called in all cases for single watch xDS (Cluster and
+    // Listener) even if the message does not have resources so that update_empty stat
+    // is properly incremented and state-of-the-world semantics are maintained.
+    if (watch->resources_.empty()) {
+      watch->callbacks_.onConfigUpdate(all_resource_refs, message.version_info());
+      continue;
+    }
+    std::vector<DecodedResourceRef> found_resources;
+    for (const auto& watched_resource_name : watch->resources_) {
+      auto it = resource_ref_map.find(watched_resource_name);
+      if (it != resource_ref_map.end()) {
+        found_resources.emplace_back(it->second);
       }
+    }
 
-      // onConfigUpdate should be called only on watches(clusters/routes) that have
-      // updates in the message for EDS/RDS.
-      if (!found_resources.empty()) {
-        watch->callbacks_.onConfigUpdate(found_resources, message->version_info());
-      }
+    // onConfigUpdate should be called only on watches(clusters/routes) that have
+    // updates in the message for EDS/RDS.
+    if (!found_resources.empty()) {
+      watch->callbacks_.onConfigUpdate(found_resources, message.version_info());
     }
-    // TODO(mattklein123): In the future if we start tracking per-resource versions, we
-    // would do that tracking here.
-    api_state.request_.set_version_info(message->version_info());
-    Memory::Utils::tryShrinkHeap();
+  }
+}
+
+void GrpcMuxImpl::warmFromCache(const std::string& type_url) {
+  ApiState& api_state = apiStateFor(type_url);
+  if (api_state.response_received_ || api_state.watches_.empty()) {
+    return;
+  }
+  if (!api_state.cached_response_loaded_) {
+    api_state.cached_response_ = resource_cache_->load(type_url);
+    api_state.cached_response_loaded_ = true;
+  }
+  if (api_state.cached_response_ == nullptr) {
+    return;
+  }
+  ENVOY_LOG(debug, "Warming {} from cached resources at version {}", type_url,
+            api_state.cached_response_->version_info());
+  // As for responses, updates of the same type are paused while the resources are delivered.
+  ScopedResume same_type_resume = pause(type_url);
+  TRY_ASSERT_MAIN_THREAD {
+    deliverResources(type_url, api_state, *api_state.cached_response_, true);
   }
   END_TRY
   catch (const EnvoyException& e) {
-    for (auto watch : api_state.watches_) {
-      watch->callbacks_.onConfigUpdateFailed(
-          Envoy::Config::ConfigUpdateFailureReason::UpdateRejected, &e);
-    }
-    ::google::rpc::Status* error_detail = api_state.request_.mutable_error_detail();
-    error_detail->set_code(Grpc::Status::WellKnownGrpcStatus::Internal);
-    error_detail->set_message(Config::Utility::truncateGrpcStatusMessage(e.what()));
+    // The cached resources are not reported as rejected, which would end the initial fetch of
+    // the subscriptions; they wait for the management server instead.
+    ENVOY_LOG(warn, "Ignoring cached resources of {}: {}", type_url, e.what());
+    api_state.cached_response_.reset();
   }
-  api_state.request_.set_response_nonce(message->nonce());
-  ASSERT(api_state.paused());
-  queueDiscoveryRequest(type_url);
 }
 
 void GrpcMuxImpl::onWriteable() { drainRequests(); }
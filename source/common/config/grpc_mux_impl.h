@@ -18,9 +18,11 @@
 #include "source/common/common/logger.h"
 #include "source/common/common/utility.h"
 #include "source/common/config/api_version.h"
+#include "source/common/config/decoded_resource_impl.h"
 #include "source/common/config/grpc_stream.h"
 #include "source/common/config/ttl.h"
 #include "source/common/config/utility.h"
+#include "source/common/config/xds_resource_cache.h"
 
 #include "absl/container/node_hash_map.h"
 
@@ -37,7 +39,8 @@ public:
               Event::Dispatcher& dispatcher, const Protobuf::MethodDescriptor& service_method,
               envoy::config::core::v3::ApiVersion transport_api_version,
               Random::RandomGenerator& random, Stats::Scope& scope,
-              const RateLimitSettings& rate_limit_settings, bool skip_subsequent_node);
+              const RateLimitSettings& rate_limit_settings, bool skip_subsequent_node,
+              XdsResourceCachePtr resource_cache = nullptr);
 
   ~GrpcMuxImpl() override;
 
@@ -123,6 +126,8 @@ private:
     OpaqueResourceDecoder& resource_decoder_;
     const std::string type_url_;
     GrpcMuxImpl& parent_;
+    // Whether the watch was given the cached resources of its type.
+    bool warmed_{};
 
   private:
     using WatchList = std::list<GrpcMuxWatchImpl*>;
@@ -151,9 +156,18 @@ private:
     // This resource type must have a Node sent at next request.
     bool must_send_node_{};
     TtlManager ttl_;
+    // Decoded resources of the last accepted response, reused when unchanged in the next one.
+    DecodedResourceCache decoded_resources_;
     // The identifier for the server that sent the most recent response, or
     // empty if there is none.
     std::string control_plane_identifier_{};
+    // Has a response been received for this API?
+    bool response_received_{};
+    // Applies the cached resources of this API to new watches, until a response is received.
+    Event::TimerPtr warm_timer_;
+    // The cached resources of this API, loaded when the first watch is warmed.
+    std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse> cached_response_;
+    bool cached_response_loaded_{};
   };
 
   bool isHeartbeatResource(const std::string& type_url, const DecodedResource& resource) {
@@ -161,6 +175,14 @@ private:
            resource.version() == apiStateFor(type_url).request_.version_info();
   }
   void expiryCallback(absl::string_view type_url, const std::vector<std::string>& expired);
+  // Decodes the resources of a response and delivers them to the watches of its API. When warming
+  // from cached resources, only the watches which have not been warmed yet are given them and their
+  // TTLs are not tracked. Throws EnvoyException if the response or a resource is rejected.
+  void deliverResources(const std::string& type_url, ApiState& api_state,
+                        const envoy::service::discovery::v3::DiscoveryResponse& message,
+                        bool warming);
+  // Applies the cached resources of an API to its watches which have not been warmed yet.
+  void warmFromCache(const std::string& type_url);
   // Request queue management logic.
   void queueDiscoveryRequest(absl::string_view queue_item);
   // Invoked when dynamic context parameters change for a resource type.
@@ -190,6 +212,8 @@ private:
 
   Event::Dispatcher& dispatcher_;
   Common::CallbackHandlePtr dynamic_update_callback_handle_;
+  // Optional cache of the last accepted response of each API, to warm from on start up.
+  const XdsResourceCachePtr resource_cache_;
 
   // True iff Envoy is shutting down; no messages should be sent on the `grpc_stream_` when this is
   // true because it may contain dangling pointers.
@@ -10,6 +10,8 @@
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/protobuf/utility.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Config {
 
@@ -28,6 +30,8 @@ GrpcSubscriptionImpl::GrpcSubscriptionImpl(GrpcMuxSharedPtr grpc_mux,
 
 // Config::Subscription
 void GrpcSubscriptionImpl::start(const absl::flat_hash_set<std::string>& resources) {
+  startup_step_ = Init::StartupProfile::beginStep(Init::StartupProfile::Kind::Xds,
+                                                  absl::StrCat("xds ", type_url_));
   if (init_fetch_timeout_.count() > 0) {
     init_fetch_timeout_timer_ = dispatcher_.createTimer([this]() -> void {
       onConfigUpdateFailed(Envoy::Config::ConfigUpdateFailureReason::FetchTimedout, nullptr);
@@ -71,6 +75,7 @@ void GrpcSubscriptionImpl::onConfigUpdate(const std::vector<Config::DecodedResou
   // the configuration update targets.
   auto start = dispatcher_.timeSource().monotonicTime();
   callbacks_.onConfigUpdate(resources, version_info);
+  endStartupStep();
   std::chrono::milliseconds update_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
       dispatcher_.timeSource().monotonicTime() - start);
   stats_.update_success_.inc();
@@ -96,6 +101,7 @@ void GrpcSubscriptionImpl::onConfigUpdate(
   stats_.update_attempt_.inc();
   auto start = dispatcher_.timeSource().monotonicTime();
   callbacks_.onConfigUpdate(added_resources, removed_resources, system_version_info);
+  endStartupStep();
   std::chrono::milliseconds update_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
       dispatcher_.timeSource().monotonicTime() - start);
   stats_.update_success_.inc();
@@ -116,6 +122,7 @@ void GrpcSubscriptionImpl::onConfigUpdateFailed(ConfigUpdateFailureReason reason
     stats_.init_fetch_timeout_.inc();
     disableInitFetchTimeoutTimer();
     ENVOY_LOG(warn, "gRPC config: initial fetch timed out for {}", type_url_);
+    endStartupStep();
     callbacks_.onConfigUpdateFailed(reason, e);
     break;
   case Envoy::Config::ConfigUpdateFailureReason::UpdateRejected:
@@ -140,6 +147,11 @@ void GrpcSubscriptionImpl::disableInitFetchTimeoutTimer() {
   }
 }
 
+void GrpcSubscriptionImpl::endStartupStep() {
+  Init::StartupProfile::endStep(startup_step_);
+  startup_step_ = Init::StartupProfile::NoStep;
+}
+
 GrpcCollectionSubscriptionImpl::GrpcCollectionSubscriptionImpl(
     const xds::core::v3::ResourceLocator& collection_locator, GrpcMuxSharedPtr grpc_mux,
     SubscriptionCallbacks& callbacks, OpaqueResourceDecoder& resource_decoder,
@@ -8,6 +8,7 @@
 #include "envoy/event/dispatcher.h"
 
 #include "source/common/common/logger.h"
+#include "source/common/init/startup_profile.h"
 
 #include "xds/core/v3/resource_locator.pb.h"
 
@@ -46,6 +47,7 @@ public:
 
 private:
   void disableInitFetchTimeoutTimer();
+  void endStartupStep();
 
   GrpcMuxSharedPtr grpc_mux_;
   SubscriptionCallbacks& callbacks_;
@@ -60,6 +62,8 @@ private:
   Event::TimerPtr init_fetch_timeout_timer_;
   const bool is_aggregated_;
   const SubscriptionOptions options_;
+  // Startup profile step for the first update, ended when it is accepted or times out.
+  Init::StartupProfile::StepId startup_step_{Init::StartupProfile::NoStep};
 
   struct ResourceNameFormatter {
     void operator()(std::string* out, const Config::DecodedResourceRef& resource) {
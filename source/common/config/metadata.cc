@@ -106,13 +106,16 @@ bool Metadata::metadataLabelMatch(const LabelSet& label_set,
 }
 
 ConstMetadataSharedPoolSharedPtr
-Metadata::getConstMetadataSharedPool(Singleton::Manager& manager, Event::Dispatcher& dispatcher) {
+Metadata::getConstMetadataSharedPool(Singleton::Manager& manager, Event::Dispatcher& dispatcher,
+                                     Stats::Scope& scope) {
   return manager
       .getTyped<SharedPool::ObjectSharedPool<const envoy::config::core::v3::Metadata, MessageUtil>>(
-          SINGLETON_MANAGER_REGISTERED_NAME(const_metadata_shared_pool), [&dispatcher] {
+          SINGLETON_MANAGER_REGISTERED_NAME(const_metadata_shared_pool), [&dispatcher, &scope] {
             return std::make_shared<
                 SharedPool::ObjectSharedPool<const envoy::config::core::v3::Metadata, MessageUtil>>(
-                dispatcher);
+                dispatcher, SharedPool::SharedPoolStats{ALL_SHARED_POOL_STATS(
+                                POOL_COUNTER_PREFIX(scope, "shared_pool.metadata."),
+                                POOL_GAUGE_PREFIX(scope, "shared_pool.metadata."))});
           });
 }
 
@@ -8,6 +8,7 @@
 #include "envoy/event/dispatcher.h"
 #include "envoy/registry/registry.h"
 #include "envoy/singleton/manager.h"
+#include "envoy/stats/scope.h"
 #include "envoy/type/metadata/v3/metadata.pb.h"
 
 #include "source/common/protobuf/protobuf.h"
@@ -94,9 +95,11 @@ public:
    * @param manager used to create singleton
    * @param dispatcher the dispatcher object reference to the thread that created the
    * ObjectSharedPool
+   * @param scope the scope of the shared_pool.metadata stats of the pool
    */
   static ConstMetadataSharedPoolSharedPtr getConstMetadataSharedPool(Singleton::Manager& manager,
-                                                                     Event::Dispatcher& dispatcher);
+                                                                     Event::Dispatcher& dispatcher,
+                                                                     Stats::Scope& scope);
 };
 
 template <typename factoryClass> class TypedMetadataImpl : public TypedMetadata {
@@ -43,6 +43,46 @@ private:
   absl::Mutex lock_;
 };
 using AllMuxes = ThreadSafeSingleton<AllMuxesState>;
+
+// Merges a later response of the same type into a pending one. The later update of a resource,
+// whether it adds or removes it, replaces any earlier one.
+void mergeResponse(envoy::service::discovery::v3::DeltaDiscoveryResponse& pending,
+                   envoy::service::discovery::v3::DeltaDiscoveryResponse&& later) {
+  absl::flat_hash_set<std::string> updated;
+  for (const auto& resource : later.resources()) {
+    updated.insert(resource.name());
+  }
+  updated.insert(later.removed_resources().begin(), later.removed_resources().end());
+
+  Protobuf::RepeatedPtrField<envoy::service::discovery::v3::Resource> resources;
+  for (auto& resource : *pending.mutable_resources()) {
+    if (!updated.contains(resource.name())) {
+      *resources.Add() = std::move(resource);
+    }
+  }
+  for (auto& resource : *later.mutable_resources()) {
+    *resources.Add() = std::move(resource);
+  }
+  pending.mutable_resources()->Swap(&resources);
+
+  Protobuf::RepeatedPtrField<std::string> removed_resources;
+  for (auto& name : *pending.mutable_removed_resources()) {
+    if (!updated.contains(name)) {
+      *removed_resources.Add() = std::move(name);
+    }
+  }
+  for (auto& name : *later.mutable_removed_resources()) {
+    *removed_resources.Add() = std::move(name);
+  }
+  pending.mutable_removed_resources()->Swap(&removed_resources);
+
+  pending.set_system_version_info(later.system_version_info());
+  pending.set_nonce(later.nonce());
+  if (later.has_control_plane()) {
+    *pending.mutable_control_plane() = later.control_plane();
+  }
+}
+
 } // namespace
 
 NewGrpcMuxImpl::NewGrpcMuxImpl(Grpc::RawAsyncClientPtr&& async_client,
@@ -51,7 +91,8 @@ NewGrpcMuxImpl::NewGrpcMuxImpl(Grpc::RawAsyncClientPtr&& async_client,
                                envoy::config::core::v3::ApiVersion transport_api_version,
                                Random::RandomGenerator& random, Stats::Scope& scope,
                                const RateLimitSettings& rate_limit_settings,
-                               const LocalInfo::LocalInfo& local_info)
+                               const LocalInfo::LocalInfo& local_info,
+                               std::chrono::milliseconds update_coalescing_window)
     : grpc_stream_(this, std::move(async_client), service_method, random, dispatcher, scope,
                    rate_limit_settings),
       local_info_(local_info),
@@ -59,7 +100,11 @@ NewGrpcMuxImpl::NewGrpcMuxImpl(Grpc::RawAsyncClientPtr&& async_client,
           [this](absl::string_view resource_type_url) {
             onDynamicContextUpdate(resource_type_url);
           })),
-      transport_api_version_(transport_api_version), dispatcher_(dispatcher) {
+      transport_api_version_(transport_api_version), dispatcher_(dispatcher),
+      update_coalescing_window_(update_coalescing_window),
+      update_coalescing_stats_{
+          ALL_UPDATE_COALESCING_STATS(POOL_COUNTER_PREFIX(scope, "control_plane."),
+                                      POOL_HISTOGRAM_PREFIX(scope, "control_plane."))} {
   AllMuxes::get().insert(this);
 }
 
@@ -119,14 +164,54 @@ void NewGrpcMuxImpl::onDiscoveryResponse(
               sub->second->control_plane_identifier_);
   }
 
-  kickOffAck(sub->second->sub_state_.handleResponse(*message));
+  SubscriptionStuff& subscription = *sub->second;
+  if (subscription.coalescing_timer_ != nullptr && subscription.coalescing_timer_->enabled()) {
+    // Within a coalescing window, hold the response until the window ends. The responses merged
+    // into the pending one are never (N)ACKed themselves; the merged response carries the nonce of
+    // the latest of them.
+    if (subscription.pending_response_ == nullptr) {
+      subscription.pending_response_ = std::move(message);
+      subscription.pending_since_ = dispatcher_.timeSource().monotonicTime();
+    } else {
+      mergeResponse(*subscription.pending_response_, std::move(*message));
+      update_coalescing_stats_.update_coalesced_.inc();
+    }
+    return;
+  }
+  handleResponse(subscription, *message);
+}
+
+void NewGrpcMuxImpl::handleResponse(
+    SubscriptionStuff& sub, const envoy::service::discovery::v3::DeltaDiscoveryResponse& message) {
+  kickOffAck(sub.sub_state_.handleResponse(message));
   Memory::Utils::tryShrinkHeap();
+  if (sub.coalescing_timer_ != nullptr) {
+    sub.coalescing_timer_->enableTimer(update_coalescing_window_);
+  }
+}
+
+void NewGrpcMuxImpl::onCoalescingWindowEnd(SubscriptionStuff& sub) {
+  if (sub.pending_response_ == nullptr) {
+    return;
+  }
+  update_coalescing_stats_.update_coalescing_delay_ms_.recordValue(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          dispatcher_.timeSource().monotonicTime() - sub.pending_since_)
+          .count());
+  auto response = std::move(sub.pending_response_);
+  handleResponse(sub, *response);
 }
 
 void NewGrpcMuxImpl::onStreamEstablished() {
   for (auto& [type_url, subscription] : subscriptions_) {
     UNREFERENCED_PARAMETER(type_url);
     subscription->sub_state_.markStreamFresh();
+    // Responses held from the previous stream are dropped: the resources they carried are not in
+    // the initial resource versions of the new stream, so the server sends them again.
+    subscription->pending_response_.reset();
+    if (subscription->coalescing_timer_ != nullptr) {
+      subscription->coalescing_timer_->disableTimer();
+    }
   }
   pausable_ack_queue_.clear();
   trySendDiscoveryRequests();
@@ -244,9 +329,14 @@ void NewGrpcMuxImpl::removeWatch(const std::string& type_url, Watch* watch) {
 
 void NewGrpcMuxImpl::addSubscription(const std::string& type_url, const bool use_namespace_matching,
                                      const bool wildcard) {
-  subscriptions_.emplace(type_url, std::make_unique<SubscriptionStuff>(type_url, local_info_,
-                                                                       use_namespace_matching,
-                                                                       dispatcher_, wildcard));
+  auto sub = std::make_unique<SubscriptionStuff>(type_url, local_info_, use_namespace_matching,
+                                                 dispatcher_, wildcard);
+  if (update_coalescing_window_.count() > 0) {
+    SubscriptionStuff* sub_ptr = sub.get();
+    sub->coalescing_timer_ =
+        dispatcher_.createTimer([this, sub_ptr]() { onCoalescingWindowEnd(*sub_ptr); });
+  }
+  subscriptions_.emplace(type_url, std::move(sub));
   subscription_ordering_.emplace_back(type_url);
 }
 
@@ -7,7 +7,9 @@
 #include "envoy/common/token_bucket.h"
 #include "envoy/config/grpc_mux.h"
 #include "envoy/config/subscription.h"
+#include "envoy/event/timer.h"
 #include "envoy/service/discovery/v3/discovery.pb.h"
+#include "envoy/stats/stats_macros.h"
 
 #include "source/common/common/logger.h"
 #include "source/common/config/api_version.h"
@@ -21,6 +23,20 @@
 namespace Envoy {
 namespace Config {
 
+/**
+ * All delta gRPC update coalescing stats. @see stats_macros.h
+ */
+#define ALL_UPDATE_COALESCING_STATS(COUNTER, HISTOGRAM)                                            \
+  COUNTER(update_coalesced)                                                                        \
+  HISTOGRAM(update_coalescing_delay_ms, Milliseconds)
+
+/**
+ * Struct definition for all delta gRPC update coalescing stats. @see stats_macros.h
+ */
+struct UpdateCoalescingStats {
+  ALL_UPDATE_COALESCING_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
 // Manages subscriptions to one or more type of resource. The logical protocol
 // state of those subscription(s) is handled by DeltaSubscriptionState.
 // This class owns the GrpcStream used to talk to the server, maintains queuing
@@ -36,7 +52,8 @@ public:
                  envoy::config::core::v3::ApiVersion transport_api_version,
                  Random::RandomGenerator& random, Stats::Scope& scope,
                  const RateLimitSettings& rate_limit_settings,
-                 const LocalInfo::LocalInfo& local_info);
+                 const LocalInfo::LocalInfo& local_info,
+                 std::chrono::milliseconds update_coalescing_window = std::chrono::milliseconds(0));
 
   ~NewGrpcMuxImpl() override;
 
@@ -92,6 +109,11 @@ public:
     WatchMap watch_map_;
     DeltaSubscriptionState sub_state_;
     std::string control_plane_identifier_{};
+    // Only used when coalescing updates. While the timer is enabled, responses are merged into
+    // pending_response_ rather than handled.
+    Event::TimerPtr coalescing_timer_;
+    std::unique_ptr<envoy::service::discovery::v3::DeltaDiscoveryResponse> pending_response_;
+    MonotonicTime pending_since_;
 
     SubscriptionStuff(const SubscriptionStuff&) = delete;
     SubscriptionStuff& operator=(const SubscriptionStuff&) = delete;
@@ -161,6 +183,13 @@ private:
   // Invoked when dynamic context parameters change for a resource type.
   void onDynamicContextUpdate(absl::string_view resource_type_url);
 
+  // Handles a response and (N)ACKs it, opening a new coalescing window if coalescing updates.
+  void handleResponse(SubscriptionStuff& sub,
+                      const envoy::service::discovery::v3::DeltaDiscoveryResponse& message);
+
+  // Invoked at the end of a coalescing window of a type, handling any responses merged during it.
+  void onCoalescingWindowEnd(SubscriptionStuff& sub);
+
   // Resource (N)ACKs we're waiting to send, stored in the order that they should be sent in. All
   // of our different resource types' ACKs are mixed together in this queue. See class for
   // description of how it interacts with pause() and resume().
@@ -181,6 +210,8 @@ private:
   Common::CallbackHandlePtr dynamic_update_callback_handle_;
   const envoy::config::core::v3::ApiVersion transport_api_version_;
   Event::Dispatcher& dispatcher_;
+  const std::chrono::milliseconds update_coalescing_window_;
+  UpdateCoalescingStats update_coalescing_stats_;
 
   // True iff Envoy is shutting down; no messages should be sent on the `grpc_stream_` when this is
   // true because it may contain dangling pointers.
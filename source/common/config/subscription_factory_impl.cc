@@ -77,7 +77,9 @@ SubscriptionPtr SubscriptionFactoryImpl::subscriptionFromConfigSource(
                   ->create(),
               dispatcher_, deltaGrpcMethod(type_url, transport_api_version), transport_api_version,
               api_.randomGenerator(), scope, Utility::parseRateLimitSettings(api_config_source),
-              local_info_),
+              local_info_,
+              std::chrono::milliseconds(
+                  PROTOBUF_GET_MS_OR_DEFAULT(api_config_source, update_coalescing_window, 0))),
           callbacks, resource_decoder, stats, type_url, dispatcher_,
           Utility::configSourceInitialFetchTimeout(config), /*is_aggregated*/ false, options);
     }
@@ -136,7 +138,9 @@ SubscriptionPtr SubscriptionFactoryImpl::collectionSubscriptionFromUrl(
                   ->create(),
               dispatcher_, deltaGrpcMethod(type_url, envoy::config::core::v3::ApiVersion::V3),
               envoy::config::core::v3::ApiVersion::V3, api_.randomGenerator(), scope,
-              Utility::parseRateLimitSettings(api_config_source), local_info_),
+              Utility::parseRateLimitSettings(api_config_source), local_info_,
+              std::chrono::milliseconds(
+                  PROTOBUF_GET_MS_OR_DEFAULT(api_config_source, update_coalescing_window, 0))),
           callbacks, resource_decoder, stats, dispatcher_,
           Utility::configSourceInitialFetchTimeout(config), false, options);
     }
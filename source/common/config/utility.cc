@@ -228,6 +228,16 @@ Utility::createStatsMatcher(const envoy::config::bootstrap::v3::Bootstrap& boots
   return std::make_unique<Stats::StatsMatcherImpl>(bootstrap.stats_config(), symbol_table);
 }
 
+Stats::StatsMatcherPtr
+Utility::createShardedCounterMatcher(const envoy::config::bootstrap::v3::Bootstrap& bootstrap,
+                                     Stats::SymbolTable& symbol_table) {
+  if (!bootstrap.stats_config().has_sharded_counters()) {
+    return nullptr;
+  }
+  return std::make_unique<Stats::StatsMatcherImpl>(bootstrap.stats_config().sharded_counters(),
+                                                   symbol_table);
+}
+
 Stats::HistogramSettingsConstPtr
 Utility::createHistogramSettings(const envoy::config::bootstrap::v3::Bootstrap& bootstrap) {
   return std::make_unique<Stats::HistogramSettingsImpl>(bootstrap.stats_config());
@@ -434,6 +434,14 @@ public:
   createStatsMatcher(const envoy::config::bootstrap::v3::Bootstrap& bootstrap,
                      Stats::SymbolTable& symbol_table);
 
+  /**
+   * Create the StatsMatcher selecting sharded counters.
+   * @return the matcher, or nullptr if no counters are to be sharded.
+   */
+  static Stats::StatsMatcherPtr
+  createShardedCounterMatcher(const envoy::config::bootstrap::v3::Bootstrap& bootstrap,
+                              Stats::SymbolTable& symbol_table);
+
   /**
    * Create HistogramSettings instance.
    */
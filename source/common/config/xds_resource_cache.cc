@@ -0,0 +1,76 @@
+#include "source/common/config/xds_resource_cache.h"
+
+#include <cstdio>
+
+#include "envoy/common/exception.h"
+
+#include "source/common/common/assert.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_replace.h"
+
+namespace Envoy {
+namespace Config {
+
+XdsResourceCache::XdsResourceCache(Filesystem::Instance& file_system, absl::string_view directory)
+    : file_system_(file_system), directory_(directory) {}
+
+std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>
+XdsResourceCache::load(absl::string_view type_url) {
+  const std::string file_path = path(type_url);
+  if (!file_system_.fileExists(file_path)) {
+    return nullptr;
+  }
+  auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+  TRY_ASSERT_MAIN_THREAD {
+    if (!response->ParseFromString(file_system_.fileReadToEnd(file_path)) ||
+        response->type_url() != type_url) {
+      ENVOY_LOG(warn, "ignoring invalid cached xDS resources in {}", file_path);
+      return nullptr;
+    }
+  }
+  END_TRY
+  catch (const EnvoyException& e) {
+    ENVOY_LOG(warn, "unable to read cached xDS resources from {}: {}", file_path, e.what());
+    return nullptr;
+  }
+  return response;
+}
+
+void XdsResourceCache::store(const envoy::service::discovery::v3::DiscoveryResponse& response) {
+  const std::string file_path = path(response.type_url());
+  const std::string temporary_path = absl::StrCat(file_path, ".tmp");
+  // Files are opened without truncation, so start from an empty temporary file.
+  std::remove(temporary_path.c_str());
+
+  Filesystem::FilePtr file = file_system_.createFile(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, temporary_path});
+  static constexpr Filesystem::FlagSet flags{1 << Filesystem::File::Operation::Write |
+                                             1 << Filesystem::File::Operation::Create};
+  const Api::IoCallBoolResult open_result = file->open(flags);
+  if (!open_result.rc_) {
+    ENVOY_LOG(warn, "unable to open {} to cache xDS resources: {}", temporary_path,
+              open_result.err_->getErrorDetails());
+    return;
+  }
+  const std::string serialized = response.SerializeAsString();
+  const Api::IoCallSizeResult write_result = file->write(serialized);
+  const Api::IoCallBoolResult close_result = file->close();
+  if (write_result.rc_ != static_cast<ssize_t>(serialized.size()) || !close_result.rc_) {
+    ENVOY_LOG(warn, "unable to write cached xDS resources to {}", temporary_path);
+    std::remove(temporary_path.c_str());
+    return;
+  }
+  if (std::rename(temporary_path.c_str(), file_path.c_str()) != 0) {
+    ENVOY_LOG(warn, "unable to replace cached xDS resources in {}", file_path);
+    std::remove(temporary_path.c_str());
+  }
+}
+
+std::string XdsResourceCache::path(absl::string_view type_url) const {
+  // Type URLs contain a '/', as in type.googleapis.com/envoy.config.cluster.v3.Cluster.
+  return absl::StrCat(directory_, "/", absl::StrReplaceAll(type_url, {{"/", "_"}}));
+}
+
+} // namespace Config
+} // namespace Envoy
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "envoy/filesystem/filesystem.h"
+#include "envoy/service/discovery/v3/discovery.pb.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Config {
+
+/**
+ * Keeps the last accepted state-of-the-world DiscoveryResponse of each type URL in a file of a
+ * directory, so that the resources can be applied on the next start up before the management
+ * server has responded. Each file is replaced as a whole, by writing a temporary file and renaming
+ * it over the previous one, so a crash while storing leaves the previous response in place.
+ */
+class XdsResourceCache : Logger::Loggable<Logger::Id::config> {
+public:
+  XdsResourceCache(Filesystem::Instance& file_system, absl::string_view directory);
+
+  /**
+   * @param type_url the type URL of the response.
+   * @return the last response stored for the type URL, or nullptr if there is none or it cannot
+   *         be read.
+   */
+  std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>
+  load(absl::string_view type_url);
+
+  /**
+   * Replaces the response stored for the type URL of the response. Failures are logged, leaving
+   * the previous response, if any, in place.
+   */
+  void store(const envoy::service::discovery::v3::DiscoveryResponse& response);
+
+private:
+  std::string path(absl::string_view type_url) const;
+
+  Filesystem::Instance& file_system_;
+  const std::string directory_;
+};
+
+using XdsResourceCachePtr = std::unique_ptr<XdsResourceCache>;
+
+} // namespace Config
+} // namespace Envoy
@@ -1,5 +1,8 @@
 #include "source/common/conn_pool/conn_pool_base.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "source/common/common/assert.h"
 #include "source/common/network/transport_socket_options_impl.h"
 #include "source/common/runtime/runtime_features.h"
@@ -16,8 +19,40 @@ namespace {
   }
   return ret;
 }
+// Weight of each new sample in the moving average of connect latency.
+constexpr double ConnectLatencySmoothing = 0.25;
 } // namespace
 
+AdaptivePreconnectEstimator::AdaptivePreconnectEstimator(std::chrono::milliseconds window)
+    : window_seconds_(std::chrono::duration<double>(window).count()) {
+  ASSERT(window_seconds_ > 0);
+}
+
+double AdaptivePreconnectEstimator::rateAt(MonotonicTime now) const {
+  const double elapsed = std::chrono::duration<double>(now - last_stream_time_).count();
+  return rate_ * std::exp(-std::max(elapsed, 0.0) / window_seconds_);
+}
+
+void AdaptivePreconnectEstimator::onNewStream(MonotonicTime now) {
+  // Each arrival adds 1 / window to an exponentially decaying rate, which converges to the
+  // arrival rate when it is steady.
+  rate_ = rateAt(now) + 1.0 / window_seconds_;
+  last_stream_time_ = now;
+}
+
+void AdaptivePreconnectEstimator::onConnected(std::chrono::milliseconds connect_latency) {
+  const double sample = std::chrono::duration<double>(connect_latency).count();
+  if (connect_latency_seconds_ == 0) {
+    connect_latency_seconds_ = sample;
+  } else {
+    connect_latency_seconds_ += ConnectLatencySmoothing * (sample - connect_latency_seconds_);
+  }
+}
+
+uint32_t AdaptivePreconnectEstimator::expectedStreams(MonotonicTime now) const {
+  return static_cast<uint32_t>(std::lround(rateAt(now) * connect_latency_seconds_));
+}
+
 ConnPoolImplBase::ConnPoolImplBase(
     Upstream::HostConstSharedPtr host, Upstream::ResourcePriority priority,
     Event::Dispatcher& dispatcher, const Network::ConnectionSocket::OptionsSharedPtr& options,
@@ -25,7 +60,14 @@ ConnPoolImplBase::ConnPoolImplBase(
     Upstream::ClusterConnectivityState& state)
     : state_(state), host_(host), priority_(priority), dispatcher_(dispatcher),
       socket_options_(options), transport_socket_options_(transport_socket_options),
-      upstream_ready_cb_(dispatcher_.createSchedulableCallback([this]() { onUpstreamReady(); })) {}
+      upstream_ready_cb_(dispatcher_.createSchedulableCallback([this]() { onUpstreamReady(); })) {
+  const absl::optional<std::chrono::milliseconds> adaptive_preconnect_window =
+      host_->cluster().adaptivePreconnectWindow();
+  if (adaptive_preconnect_window.has_value() &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.allow_preconnect")) {
+    adaptive_preconnect_.emplace(adaptive_preconnect_window.value());
+  }
+}
 
 ConnPoolImplBase::~ConnPoolImplBase() {
   ASSERT(isIdleImpl());
@@ -71,7 +113,8 @@ bool ConnPoolImplBase::shouldConnect(size_t pending_streams, size_t active_strea
          connecting_and_connected_capacity + active_streams;
 }
 
-bool ConnPoolImplBase::shouldCreateNewConnection(float global_preconnect_ratio) const {
+bool ConnPoolImplBase::shouldCreateNewConnection(float global_preconnect_ratio,
+                                                 bool anticipate_arrivals) const {
   // If the host is not healthy, don't make it do extra work, especially as
   // upstream selection logic may result in bypassing this upstream entirely.
   // If an Envoy user wants preconnecting for degraded upstreams this could be
@@ -97,8 +140,35 @@ bool ConnPoolImplBase::shouldCreateNewConnection(float global_preconnect_ratio)
     // new streams are established or torn down and simply attempts to maintain
     // the correct ratio of streams and anticipated capacity.
     return shouldConnect(pending_streams_.size(), num_active_streams_, connecting_stream_capacity_,
-                         perUpstreamPreconnectRatio());
+                         perUpstreamPreconnectRatio()) ||
+           (anticipate_arrivals && adaptivePreconnectWanted(0));
+  }
+}
+
+bool ConnPoolImplBase::adaptivePreconnectWanted(uint32_t excluded_capacity) const {
+  if (!adaptive_preconnect_.has_value()) {
+    return false;
+  }
+  const uint64_t streams = pending_streams_.size() + num_active_streams_;
+  // Apply the same bound as the per upstream preconnect ratio, which is capped at 3.
+  const uint64_t wanted =
+      std::min<uint64_t>(pending_streams_.size() + adaptive_preconnect_->expectedStreams(
+                                                         dispatcher_.approximateMonotonicTime()),
+                         3 * (streams + 1) - num_active_streams_);
+  int64_t capacity = static_cast<int64_t>(connecting_stream_capacity_) - excluded_capacity;
+  if (capacity >= static_cast<int64_t>(wanted)) {
+    return false;
+  }
+  // Unlike the preconnect ratio, count the capacity of connected but idle clients, or
+  // connections would keep being added while earlier preconnects sit ready. Stop as soon as the
+  // target is met since there may be many ready clients.
+  for (const auto& client : ready_clients_) {
+    capacity += client->currentUnusedCapacity();
+    if (capacity >= static_cast<int64_t>(wanted)) {
+      return false;
+    }
   }
+  return true;
 }
 
 float ConnPoolImplBase::perUpstreamPreconnectRatio() const {
@@ -109,7 +179,8 @@ float ConnPoolImplBase::perUpstreamPreconnectRatio() const {
   }
 }
 
-ConnPoolImplBase::ConnectionResult ConnPoolImplBase::tryCreateNewConnections() {
+ConnPoolImplBase::ConnectionResult
+ConnPoolImplBase::tryCreateNewConnections(bool anticipate_arrivals) {
   ConnPoolImplBase::ConnectionResult result;
   // Somewhat arbitrarily cap the number of connections preconnected due to new
   // incoming connections. The preconnect ratio is capped at 3, so in steady
@@ -118,7 +189,7 @@ ConnPoolImplBase::ConnectionResult ConnPoolImplBase::tryCreateNewConnections() {
   // many connections are desired when the host becomes healthy again, but
   // overwhelming it with connections is not desirable.
   for (int i = 0; i < 3; ++i) {
-    result = tryCreateNewConnection();
+    result = tryCreateNewConnection(0, anticipate_arrivals);
     if (result != ConnectionResult::CreatedNewConnection) {
       break;
     }
@@ -127,13 +198,17 @@ ConnPoolImplBase::ConnectionResult ConnPoolImplBase::tryCreateNewConnections() {
 }
 
 ConnPoolImplBase::ConnectionResult
-ConnPoolImplBase::tryCreateNewConnection(float global_preconnect_ratio) {
+ConnPoolImplBase::tryCreateNewConnection(float global_preconnect_ratio,
+                                         bool anticipate_arrivals) {
   // There are already enough CONNECTING connections for the number of queued streams.
-  if (!shouldCreateNewConnection(global_preconnect_ratio)) {
+  if (!shouldCreateNewConnection(global_preconnect_ratio, anticipate_arrivals)) {
     ENVOY_LOG(trace, "not creating a new connection, shouldCreateNewConnection returned false.");
     return ConnectionResult::ShouldNotConnect;
   }
+  return createNewConnection();
+}
 
+ConnPoolImplBase::ConnectionResult ConnPoolImplBase::createNewConnection() {
   const bool can_create_connection =
       host_->cluster().resourceManager(priority_).connections().canCreate();
   if (!can_create_connection) {
@@ -154,6 +229,8 @@ ConnPoolImplBase::tryCreateNewConnection(float global_preconnect_ratio) {
     ASSERT(std::numeric_limits<uint64_t>::max() - connecting_stream_capacity_ >=
            client->effectiveConcurrentStreamLimit());
     ASSERT(client->real_host_description_);
+    // A connection that isn't needed for the streams already queued is created ahead of demand.
+    client->unused_preconnect_ = pending_streams_.size() <= connecting_stream_capacity_;
     // Increase the connecting capacity to reflect the streams this connection can serve.
     state_.incrConnectingAndConnectedStreamCapacity(client->effectiveConcurrentStreamLimit());
     connecting_stream_capacity_ += client->effectiveConcurrentStreamLimit();
@@ -178,6 +255,7 @@ void ConnPoolImplBase::attachStreamToClient(Envoy::ConnectionPool::ActiveClient&
   } else {
     ENVOY_CONN_LOG(debug, "creating stream", client);
 
+    client.unused_preconnect_ = false;
     client.remaining_streams_--;
     if (client.remaining_streams_ == 0) {
       ENVOY_CONN_LOG(debug, "maximum streams per connection, DRAINING", client);
@@ -193,8 +271,8 @@ void ConnPoolImplBase::attachStreamToClient(Envoy::ConnectionPool::ActiveClient&
     // Track the new active stream.
     state_.incrActiveStreams(1);
     num_active_streams_++;
-    host_->stats().rq_total_.inc();
-    host_->stats().rq_active_.inc();
+    host_->stats().incRqTotal();
+    host_->stats().incRqActive();
     host_->cluster().stats().upstream_rq_total_.inc();
     host_->cluster().stats().upstream_rq_active_.inc();
     host_->cluster().resourceManager(priority_).requests().inc();
@@ -211,7 +289,7 @@ void ConnPoolImplBase::onStreamClosed(Envoy::ConnectionPool::ActiveClient& clien
   bool had_negative_capacity = client.hadNegativeDeltaOnStreamClosed();
   state_.decrActiveStreams(1);
   num_active_streams_--;
-  host_->stats().rq_active_.dec();
+  host_->stats().decRqActive();
   host_->cluster().stats().upstream_rq_active_.dec();
   host_->cluster().resourceManager(priority_).requests().dec();
   // If the effective client capacity was limited by concurrency, increase connecting capacity.
@@ -237,16 +315,20 @@ ConnectionPool::Cancellable* ConnPoolImplBase::newStream(AttachContext& context)
 
   ASSERT(static_cast<ssize_t>(connecting_stream_capacity_) ==
          connectingCapacity(connecting_clients_)); // O(n) debug check.
+  if (adaptive_preconnect_.has_value()) {
+    adaptive_preconnect_->onNewStream(dispatcher_.approximateMonotonicTime());
+  }
   if (!ready_clients_.empty()) {
     ActiveClient& client = *ready_clients_.front();
     ENVOY_CONN_LOG(debug, "using existing connection", client);
     attachStreamToClient(client, context);
     // Even if there's a ready client, we may want to preconnect to handle the next incoming stream.
-    tryCreateNewConnections();
+    tryCreateNewConnections(true);
     return nullptr;
   }
 
-  if (host_->cluster().resourceManager(priority_).pendingRequests().canCreate()) {
+  if (host_->cluster().resourceManager(priority_).pendingRequests().canCreate() ||
+      makeRoomForPendingStream(pendingStreamOptions(context))) {
     ConnectionPool::Cancellable* pending = newPendingStream(context);
     ENVOY_LOG(debug, "trying to create new connection");
     ENVOY_LOG(trace, fmt::format("{}", *this));
@@ -254,7 +336,7 @@ ConnectionPool::Cancellable* ConnPoolImplBase::newStream(AttachContext& context)
     auto old_capacity = connecting_stream_capacity_;
     // This must come after newPendingStream() because this function uses the
     // length of pending_streams_ to determine if a new connection is needed.
-    const ConnectionResult result = tryCreateNewConnections();
+    const ConnectionResult result = tryCreateNewConnections(true);
     // If there is not enough connecting capacity, the only reason to not
     // increase capacity is if the connection limits are exceeded.
     ENVOY_BUG(pending_streams_.size() <= connecting_stream_capacity_ ||
@@ -286,21 +368,98 @@ bool ConnPoolImplBase::maybePreconnect(float global_preconnect_ratio) {
   return tryCreateNewConnection(global_preconnect_ratio) == ConnectionResult::CreatedNewConnection;
 }
 
+void ConnPoolImplBase::warmUp(uint32_t connections, Instance::WarmUpCb cb) {
+  ASSERT(!deferred_deleting_);
+  size_t existing = ready_clients_.size() + busy_clients_.size() + connecting_clients_.size();
+  // Unlike the connections created for streams, warming up never goes over the circuit breaker.
+  while (existing < connections &&
+         host_->cluster().resourceManager(priority_).connections().canCreate() &&
+         createNewConnection() == ConnectionResult::CreatedNewConnection) {
+    host_->cluster().stats().upstream_cx_warm_up_.inc();
+    ++existing;
+  }
+  warm_up_callbacks_.push_back(std::move(cb));
+  checkForWarmUpComplete();
+}
+
 void ConnPoolImplBase::scheduleOnUpstreamReady() {
   upstream_ready_cb_->scheduleCallbackCurrentIteration();
 }
 
 void ConnPoolImplBase::onUpstreamReady() {
+  if (pending_streams_.empty() || ready_clients_.empty()) {
+    return;
+  }
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
   while (!pending_streams_.empty() && !ready_clients_.empty()) {
+    // Pending streams are queued towards the front, so pull from the back.
+    PendingStream& stream = *pending_streams_.back();
+    if (stream.expired(now)) {
+      // The response could not make it downstream in time, so don't send the stream upstream.
+      ENVOY_LOG(debug, "pending stream deadline exceeded");
+      host_->cluster().stats().upstream_rq_pending_deadline_exceeded_.inc();
+      failPendingStream(stream);
+      continue;
+    }
     ActiveClientPtr& client = ready_clients_.front();
     ENVOY_CONN_LOG(debug, "attaching to next stream", *client);
-    // Pending streams are pushed onto the front, so pull from the back.
-    attachStreamToClient(*client, pending_streams_.back()->context());
+    attachStreamToClient(*client, stream.context());
     state_.decrPendingStreams(1);
     pending_streams_.pop_back();
   }
 }
 
+ConnectionPool::Cancellable*
+ConnPoolImplBase::addPendingStream(Envoy::ConnectionPool::PendingStreamPtr&& pending_stream) {
+  PendingStream& stream = *pending_stream;
+  LinkedList::moveIntoList(std::move(pending_stream), pending_streams_);
+  state_.incrPendingStreams(1);
+  // Each priority is served in order from the back of the queue, so the stream goes right behind
+  // the streams of lower priority. Without priorities, this is the front of the queue.
+  auto position = std::next(stream.entry());
+  while (position != pending_streams_.end() &&
+         (*position)->options_.queue_priority_ < stream.options_.queue_priority_) {
+    ++position;
+  }
+  pending_streams_.splice(position, pending_streams_, stream.entry());
+  return &stream;
+}
+
+bool ConnPoolImplBase::makeRoomForPendingStream(const PendingStreamOptions& options) {
+  if (pending_streams_.empty()) {
+    return false;
+  }
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  PendingStream* failed = nullptr;
+  for (const PendingStreamPtr& stream : pending_streams_) {
+    if (stream->expired(now)) {
+      failed = stream.get();
+      host_->cluster().stats().upstream_rq_pending_deadline_exceeded_.inc();
+      break;
+    }
+  }
+  if (failed == nullptr &&
+      pending_streams_.front()->options_.queue_priority_ < options.queue_priority_) {
+    failed = pending_streams_.front().get();
+    host_->cluster().stats().upstream_rq_pending_displaced_.inc();
+  }
+  if (failed == nullptr) {
+    return false;
+  }
+  ENVOY_LOG(debug, "failing pending stream to make room for a new one");
+  failPendingStream(*failed);
+  // The pending stream limit is shared by the pools of the cluster, and the failed stream may have
+  // been replaced from its callbacks.
+  return host_->cluster().resourceManager(priority_).pendingRequests().canCreate();
+}
+
+void ConnPoolImplBase::failPendingStream(PendingStream& stream) {
+  state_.decrPendingStreams(1);
+  PendingStreamPtr removed = stream.removeFromList(pending_streams_);
+  onPoolFailure(nullptr, absl::string_view(), ConnectionPool::PoolFailureReason::Overflow,
+                removed->context());
+}
+
 std::list<ActiveClientPtr>& ConnPoolImplBase::owningList(ActiveClient::State state) {
   switch (state) {
   case ActiveClient::State::CONNECTING:
@@ -361,6 +520,27 @@ void ConnPoolImplBase::closeIdleConnectionsForDrainingPool() {
   }
 }
 
+void ConnPoolImplBase::closeExcessIdleConnections(uint32_t max_idle_connections) {
+  if (!pending_streams_.empty()) {
+    return;
+  }
+
+  std::list<ActiveClient*> to_close;
+  uint32_t idle_connections = 0;
+  for (auto& client : ready_clients_) {
+    if (client->numActiveStreams() == 0 && ++idle_connections > max_idle_connections) {
+      to_close.push_back(client.get());
+    }
+  }
+
+  for (auto& entry : to_close) {
+    ENVOY_CONN_LOG(debug, "closing idle connection over the maximum of {}", *entry,
+                   max_idle_connections);
+    host_->cluster().stats().upstream_cx_idle_overflow_.inc();
+    entry->close();
+  }
+}
+
 void ConnPoolImplBase::drainConnectionsImpl() {
   closeIdleConnectionsForDrainingPool();
 
@@ -418,6 +598,9 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     ENVOY_CONN_LOG(debug, "client disconnected, failure reason: {}", client, failure_reason);
 
     Envoy::Upstream::reportUpstreamCxDestroy(host_, event);
+    if (client.unused_preconnect_) {
+      host_->cluster().stats().upstream_cx_preconnect_unused_.inc();
+    }
     const bool incomplete_stream = client.closingWithIncompleteStream();
     if (incomplete_stream) {
       Envoy::Upstream::reportUpstreamCxDestroyActiveRequest(host_, event);
@@ -464,6 +647,9 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
       tryCreateNewConnections();
     }
   } else if (event == Network::ConnectionEvent::Connected) {
+    if (adaptive_preconnect_.has_value()) {
+      adaptive_preconnect_->onConnected(client.conn_connect_ms_->elapsed());
+    }
     client.conn_connect_ms_->complete();
     client.conn_connect_ms_.reset();
     ASSERT(client.state() == ActiveClient::State::CONNECTING);
@@ -475,9 +661,23 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     onUpstreamReady();
     checkForIdleAndCloseIdleConnsIfDraining();
   }
+  checkForWarmUpComplete();
 }
 
-PendingStream::PendingStream(ConnPoolImplBase& parent) : parent_(parent) {
+void ConnPoolImplBase::checkForWarmUpComplete() {
+  if (warm_up_callbacks_.empty() || !connecting_clients_.empty()) {
+    return;
+  }
+  // A callback may warm up the pool again.
+  std::list<Instance::WarmUpCb> callbacks = std::move(warm_up_callbacks_);
+  warm_up_callbacks_.clear();
+  for (const Instance::WarmUpCb& cb : callbacks) {
+    cb();
+  }
+}
+
+PendingStream::PendingStream(ConnPoolImplBase& parent, const PendingStreamOptions& options)
+    : parent_(parent), options_(options) {
   parent_.host()->cluster().stats().upstream_rq_pending_total_.inc();
   parent_.host()->cluster().stats().upstream_rq_pending_active_.inc();
   parent_.host()->cluster().resourceManager(parent_.priority()).pendingRequests().inc();
@@ -517,9 +717,13 @@ bool ConnPoolImplBase::connectingConnectionIsExcess() const {
   // If preconnect ratio is set, it also factors in the anticipated load based on both queued
   // streams and active streams, and makes sure the connecting capacity would still be sufficient to
   // serve that even with the most recent client removed.
+  //
+  // With adaptive preconnecting, the connection is also kept if it is needed for the streams
+  // expected to arrive before another connection could be established.
+  const uint32_t front_capacity = connecting_clients_.front()->effectiveConcurrentStreamLimit();
   return (pending_streams_.size() + num_active_streams_) * perUpstreamPreconnectRatio() <=
-         (connecting_stream_capacity_ -
-          connecting_clients_.front()->effectiveConcurrentStreamLimit() + num_active_streams_);
+             (connecting_stream_capacity_ - front_capacity + num_active_streams_) &&
+         !adaptivePreconnectWanted(front_capacity);
 }
 
 void ConnPoolImplBase::onPendingStreamCancel(PendingStream& stream,
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <chrono>
+
 #include "envoy/common/conn_pool.h"
+#include "envoy/common/time.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/network/connection.h"
 #include "envoy/stats/timespan.h"
@@ -10,12 +13,39 @@
 #include "source/common/common/linked_object.h"
 
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace ConnectionPool {
 
 class ConnPoolImplBase;
 
+// Estimates how many streams will arrive at a pool while a new connection is being established,
+// from the stream arrival rate decayed over a time window and a moving average of the connect
+// latency.
+class AdaptivePreconnectEstimator {
+public:
+  explicit AdaptivePreconnectEstimator(std::chrono::milliseconds window);
+
+  // Records the arrival of a stream.
+  void onNewStream(MonotonicTime now);
+  // Records the time it took to establish a connection.
+  void onConnected(std::chrono::milliseconds connect_latency);
+
+  // @return the number of streams expected to arrive within one connect latency, rounded to the
+  // nearest integer. This is zero until a connection has been established.
+  uint32_t expectedStreams(MonotonicTime now) const;
+
+private:
+  double rateAt(MonotonicTime now) const;
+
+  const double window_seconds_;
+  // Stream arrival rate in streams per second, as of last_stream_time_.
+  double rate_{};
+  MonotonicTime last_stream_time_;
+  double connect_latency_seconds_{};
+};
+
 // A placeholder struct for whatever data a given connection pool needs to
 // successfully attach and upstream connection to a downstream connection.
 struct AttachContext {
@@ -108,6 +138,8 @@ public:
   Event::TimerPtr connect_timer_;
   bool resources_released_{false};
   bool timed_out_{false};
+  // Set for connections created ahead of demand, until they serve their first stream.
+  bool unused_preconnect_{false};
 
 private:
   State state_{State::CONNECTING};
@@ -117,7 +149,7 @@ private:
 // yet established.
 class PendingStream : public LinkedObject<PendingStream>, public ConnectionPool::Cancellable {
 public:
-  PendingStream(ConnPoolImplBase& parent);
+  PendingStream(ConnPoolImplBase& parent, const PendingStreamOptions& options = {});
   ~PendingStream() override;
 
   // ConnectionPool::Cancellable
@@ -127,7 +159,13 @@ public:
   // which will be passed back to the parent in onPoolReady or onPoolFailure.
   virtual AttachContext& context() PURE;
 
+  // Returns true if the deadline of the stream, if any, has passed.
+  bool expired(MonotonicTime now) const {
+    return options_.deadline_.has_value() && options_.deadline_.value() <= now;
+  }
+
   ConnPoolImplBase& parent_;
+  const PendingStreamOptions options_;
 };
 
 using PendingStreamPtr = std::unique_ptr<PendingStream>;
@@ -190,6 +228,11 @@ public:
   // Closes any idle connections as this pool is drained.
   void closeIdleConnectionsForDrainingPool();
 
+  // Closes the idle connections over max_idle_connections, unless streams are pending. Clients
+  // becoming ready are moved to the front of ready_clients_, where new streams are attached first,
+  // so the connections closed are the ones idle for the longest.
+  void closeExcessIdleConnections(uint32_t max_idle_connections);
+
   // Changes the state_ of an ActiveClient and moves to the appropriate list.
   void transitionActiveClientState(ActiveClient& client, ActiveClient::State new_state);
 
@@ -206,9 +249,16 @@ public:
   ConnectionPool::Cancellable* newStream(AttachContext& context);
   // Called if this pool is likely to be picked soon, to determine if it's worth preconnecting.
   bool maybePreconnect(float global_preconnect_ratio);
+  // Creates connections until the pool has the given number of them. See
+  // Envoy::ConnectionPool::Instance::warmUp().
+  void warmUp(uint32_t connections, Instance::WarmUpCb cb);
 
   virtual ConnectionPool::Cancellable* newPendingStream(AttachContext& context) PURE;
 
+  // Returns the options the stream of the context would be queued with. This is only used to make
+  // room for the stream when the queue is full, as the pending streams carry their own options.
+  virtual PendingStreamOptions pendingStreamOptions(AttachContext&) { return {}; }
+
   virtual void attachStreamToClient(Envoy::ConnectionPool::ActiveClient& client,
                                     AttachContext& context);
 
@@ -266,13 +316,23 @@ protected:
 
   // Creates up to 3 connections, based on the preconnect ratio.
   // Returns the ConnectionResult of the last attempt.
-  ConnectionResult tryCreateNewConnections();
+  // If anticipate_arrivals is true, which is only the case as new streams arrive, adaptive
+  // preconnecting is also taken into account.
+  ConnectionResult tryCreateNewConnections(bool anticipate_arrivals = false);
 
   // Creates a new connection if there is sufficient demand, it is allowed by resourceManager, or
   // to avoid starving this pool.
   // Demand is determined either by perUpstreamPreconnectRatio() or global_preconnect_ratio
-  // if this is called by maybePreconnect()
-  ConnectionResult tryCreateNewConnection(float global_preconnect_ratio = 0);
+  // if this is called by maybePreconnect(), and by adaptive preconnecting if anticipate_arrivals
+  // is true.
+  ConnectionResult tryCreateNewConnection(float global_preconnect_ratio = 0,
+                                          bool anticipate_arrivals = false);
+
+  // Creates a new connection if it is allowed by resourceManager, or to avoid starving this pool.
+  ConnectionResult createNewConnection();
+
+  // Calls the warm-up callbacks once no connections are connecting anymore.
+  void checkForWarmUpComplete();
 
   // A helper function which determines if a canceled pending connection should
   // be closed as excess or not.
@@ -280,16 +340,18 @@ protected:
 
   // A helper function which determines if a new incoming stream should trigger
   // connection preconnect.
-  bool shouldCreateNewConnection(float global_preconnect_ratio) const;
+  bool shouldCreateNewConnection(float global_preconnect_ratio, bool anticipate_arrivals) const;
 
   float perUpstreamPreconnectRatio() const;
 
+  // With adaptive preconnecting, returns true if the capacity of idle and connecting clients, less
+  // excluded_capacity, cannot serve the pending streams plus the streams expected to arrive within
+  // one connect latency.
+  bool adaptivePreconnectWanted(uint32_t excluded_capacity) const;
+
+  // Queues the stream behind the pending streams of its priority or higher.
   ConnectionPool::Cancellable*
-  addPendingStream(Envoy::ConnectionPool::PendingStreamPtr&& pending_stream) {
-    LinkedList::moveIntoList(std::move(pending_stream), pending_streams_);
-    state_.incrPendingStreams(1);
-    return pending_streams_.front().get();
-  }
+  addPendingStream(Envoy::ConnectionPool::PendingStreamPtr&& pending_stream);
 
   bool hasActiveStreams() const { return num_active_streams_ > 0; }
 
@@ -308,6 +370,7 @@ protected:
   const Network::TransportSocketOptionsConstSharedPtr transport_socket_options_;
 
   std::list<Instance::IdleCb> idle_callbacks_;
+  std::list<Instance::WarmUpCb> warm_up_callbacks_;
 
   // When calling purgePendingStreams, this list will be used to hold the streams we are about
   // to purge. We need this if one cancelled streams cancels a different pending stream
@@ -341,7 +404,15 @@ private:
   bool deferred_deleting_{false};
 
   void onUpstreamReady();
+  // Fails a pending stream past its deadline, or else the most recently queued stream of the
+  // lowest priority if that priority is lower than the one of the options. Returns true if this
+  // made room for a new pending stream.
+  bool makeRoomForPendingStream(const PendingStreamOptions& options);
+  // Removes a pending stream from the queue and fails it as an overflow.
+  void failPendingStream(PendingStream& stream);
   Event::SchedulableCallbackPtr upstream_ready_cb_;
+
+  absl::optional<AdaptivePreconnectEstimator> adaptive_preconnect_;
 };
 
 } // namespace ConnectionPool
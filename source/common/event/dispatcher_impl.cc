@@ -3,6 +3,7 @@
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -66,14 +67,13 @@ DispatcherImpl::DispatcherImpl(const std::string& name, Api::Api& api,
       thread_local_delete_cb_(
           base_scheduler_.createSchedulableCallback([this]() -> void { runThreadLocalDelete(); })),
       deferred_delete_cb_(base_scheduler_.createSchedulableCallback(
-          [this]() -> void { clearDeferredDeleteList(); })),
+          [this]() -> void { reclaimDeferredDeletes(MaxDeferredDeletesPerPass); })),
       post_cb_(base_scheduler_.createSchedulableCallback([this]() -> void { runPostCallbacks(); })),
       current_to_delete_(&to_delete_1_), scaled_timer_manager_(scaled_timer_factory(*this)) {
   ASSERT(!name_.empty());
   FatalErrorHandler::registerFatalErrorHandler(*this);
   updateApproximateMonotonicTimeInternal();
-  base_scheduler_.registerOnPrepareCallback(
-      std::bind(&DispatcherImpl::updateApproximateMonotonicTime, this));
+  base_scheduler_.registerOnPrepareCallback([this]() { onPrepare(); });
 }
 
 DispatcherImpl::~DispatcherImpl() {
@@ -105,35 +105,82 @@ void DispatcherImpl::initializeStats(Stats::Scope& scope,
 
 void DispatcherImpl::clearDeferredDeleteList() {
   ASSERT(isThreadSafe());
-  std::vector<DeferredDeletablePtr>* to_delete = current_to_delete_;
+  if (deferred_deleting_) {
+    return;
+  }
+  // Destroy what is left over from bounded passes, then everything deferred deleted so far.
+  destroyDeferredDeletes(std::numeric_limits<size_t>::max());
+  reclaimDeferredDeletes(std::numeric_limits<size_t>::max());
+}
 
-  size_t num_to_delete = to_delete->size();
-  if (deferred_deleting_ || !num_to_delete) {
+void DispatcherImpl::reclaimDeferredDeletes(size_t max_to_delete) {
+  ASSERT(isThreadSafe());
+  if (deferred_deleting_) {
     return;
   }
 
-  ENVOY_LOG(trace, "clearing deferred deletion list (size={})", num_to_delete);
+  std::vector<DeferredDeletablePtr>* to_delete = &reclaimedToDelete();
+  if (deferred_delete_offset_ == to_delete->size()) {
+    if (current_to_delete_->empty()) {
+      return;
+    }
+    // Swap the current deletion vector so that if we do deferred delete while we are deleting, we
+    // use the other vector. We will get another callback to delete that vector.
+    to_delete = current_to_delete_;
+    current_to_delete_ = &reclaimedToDelete();
+    deferred_delete_offset_ = 0;
+  }
 
-  // Swap the current deletion vector so that if we do deferred delete while we are deleting, we
-  // use the other vector. We will get another callback to delete that vector.
-  if (current_to_delete_ == &to_delete_1_) {
-    current_to_delete_ = &to_delete_2_;
-  } else {
-    current_to_delete_ = &to_delete_1_;
+  if (stats_ != nullptr) {
+    stats_->deferred_delete_queue_size_.recordValue(to_delete->size() - deferred_delete_offset_ +
+                                                    current_to_delete_->size());
+  }
+  destroyDeferredDeletes(max_to_delete);
+  // Leave the rest to the next event loop iteration, so that new events are polled for first. This
+  // also covers deletables deferred while the callback was already scheduled for the leftovers.
+  if (deferred_delete_offset_ < to_delete->size() || !current_to_delete_->empty()) {
+    deferred_delete_cb_->scheduleCallbackNextIteration();
   }
+}
+
+size_t DispatcherImpl::destroyDeferredDeletes(size_t max_to_delete) {
+  std::vector<DeferredDeletablePtr>& to_delete = reclaimedToDelete();
+  const size_t num_to_delete = std::min(to_delete.size() - deferred_delete_offset_, max_to_delete);
+  if (num_to_delete == 0) {
+    return 0;
+  }
+
+  ENVOY_LOG(trace, "clearing deferred deletion list (size={})", num_to_delete);
 
   touchWatchdog();
   deferred_deleting_ = true;
+  absl::optional<MonotonicTime> start;
+  if (stats_ != nullptr) {
+    start = api_.timeSource().monotonicTime();
+  }
 
   // Calling clear() on the vector does not specify which order destructors run in. We want to
-  // destroy in FIFO order so just do it manually. This required 2 passes over the vector which is
-  // not optimal but can be cleaned up later if needed.
-  for (size_t i = 0; i < num_to_delete; i++) {
-    (*to_delete)[i].reset();
+  // destroy in FIFO order so just do it manually.
+  const size_t end = deferred_delete_offset_ + num_to_delete;
+  for (; deferred_delete_offset_ < end; deferred_delete_offset_++) {
+    to_delete[deferred_delete_offset_].reset();
   }
 
-  to_delete->clear();
+  if (deferred_delete_offset_ == to_delete.size()) {
+    // Give back the memory a burst of deletions grew the vector to, rather than holding it for the
+    // lifetime of the dispatcher.
+    if (to_delete.capacity() > MaxDeferredDeletesPerPass) {
+      std::vector<DeferredDeletablePtr>().swap(to_delete);
+    } else {
+      to_delete.clear();
+    }
+    deferred_delete_offset_ = 0;
+  }
   deferred_deleting_ = false;
+  if (start.has_value()) {
+    recordEventDuration(stats_->deferred_delete_duration_us_, *start);
+  }
+  return num_to_delete;
 }
 
 Network::ServerConnectionPtr
@@ -185,8 +232,8 @@ FileEventPtr DispatcherImpl::createFileEvent(os_fd_t fd, FileReadyCb cb, FileTri
   return FileEventPtr{new FileEventImpl(
       *this, fd,
       [this, cb](uint32_t events) {
-        touchWatchdog();
-        cb(events);
+        auto run = [&cb, events]() { cb(events); };
+        runEvent(EventCategory::FileEvent, run);
       },
       trigger, events)};
 }
@@ -230,19 +277,12 @@ TimerPtr DispatcherImpl::createScaledTimer(ScaledTimerMinimum minimum, TimerCb c
 
 Event::SchedulableCallbackPtr DispatcherImpl::createSchedulableCallback(std::function<void()> cb) {
   ASSERT(isThreadSafe());
-  return base_scheduler_.createSchedulableCallback([this, cb]() {
-    touchWatchdog();
-    cb();
-  });
+  return base_scheduler_.createSchedulableCallback(
+      [this, cb]() { runEvent(EventCategory::SchedulableCallback, cb); });
 }
 
 TimerPtr DispatcherImpl::createTimerInternal(TimerCb cb) {
-  return scheduler_->createTimer(
-      [this, cb]() {
-        touchWatchdog();
-        cb();
-      },
-      *this);
+  return scheduler_->createTimer([this, cb]() { runEvent(EventCategory::Timer, cb); }, *this);
 }
 
 void DispatcherImpl::deferredDelete(DeferredDeletablePtr&& to_delete) {
@@ -265,14 +305,15 @@ SignalEventPtr DispatcherImpl::listenForSignal(signal_t signal_num, SignalCb cb)
 }
 
 void DispatcherImpl::post(std::function<void()> callback) {
-  bool do_post;
-  {
-    Thread::LockGuard lock(post_lock_);
-    do_post = post_callbacks_.empty();
-    post_callbacks_.push_back(callback);
+  // Only the post that finds the queue empty needs to arm post_cb_; later posts are picked up by
+  // the same runPostCallbacks() pass.
+  if (post_callbacks_.push(std::move(callback))) {
+    post_cb_->scheduleCallbackCurrentIteration();
   }
+}
 
-  if (do_post) {
+void DispatcherImpl::postBatch(std::vector<std::function<void()>>&& callbacks) {
+  if (post_callbacks_.push(std::move(callbacks))) {
     post_cb_->scheduleCallbackCurrentIteration();
   }
 }
@@ -312,11 +353,7 @@ void DispatcherImpl::shutdown() {
   // callbacks and dispatcher thread deletable objects.
   ASSERT(isThreadSafe());
   auto deferred_deletables_size = current_to_delete_->size();
-  std::list<std::function<void()>>::size_type post_callbacks_size;
-  {
-    Thread::LockGuard lock(post_lock_);
-    post_callbacks_size = post_callbacks_.size();
-  }
+  const size_t post_callbacks_size = post_callbacks_.size();
 
   std::list<DispatcherThreadDeletableConstPtr> local_deletables;
   {
@@ -337,6 +374,37 @@ void DispatcherImpl::shutdown() {
 
 void DispatcherImpl::updateApproximateMonotonicTime() { updateApproximateMonotonicTimeInternal(); }
 
+void DispatcherImpl::onPrepare() {
+  updateApproximateMonotonicTimeInternal();
+  // This runs before polling, so the callbacks counted since the previous call are those of the
+  // previous event loop iteration.
+  if (stats_ != nullptr) {
+    stats_->events_per_loop_.recordValue(events_in_loop_);
+    events_in_loop_ = 0;
+  }
+}
+
+Stats::Histogram& DispatcherImpl::eventDurationHistogram(EventCategory category) {
+  switch (category) {
+  case EventCategory::FileEvent:
+    return stats_->file_event_duration_us_;
+  case EventCategory::Timer:
+    return stats_->timer_duration_us_;
+  case EventCategory::SchedulableCallback:
+    return stats_->schedulable_callback_duration_us_;
+  case EventCategory::PostCallback:
+    return stats_->post_callback_duration_us_;
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+void DispatcherImpl::recordEventDuration(Stats::Histogram& histogram, MonotonicTime start) {
+  ++events_in_loop_;
+  histogram.recordValue(std::chrono::duration_cast<std::chrono::microseconds>(
+                            api_.timeSource().monotonicTime() - start)
+                            .count());
+}
+
 void DispatcherImpl::updateApproximateMonotonicTimeInternal() {
   approximate_monotonic_time_ = api_.timeSource().monotonicTime();
 }
@@ -360,29 +428,24 @@ void DispatcherImpl::runPostCallbacks() {
   // Clear the deferred delete list before running post callbacks to reduce non-determinism in
   // callback processing, and more easily detect if a scheduled post callback refers to one of the
   // objects that is being deferred deleted.
-  clearDeferredDeleteList();
+  reclaimDeferredDeletes(MaxDeferredDeletesPerPass);
 
-  std::list<std::function<void()>> callbacks;
-  {
-    // Take ownership of the callbacks under the post_lock_. The lock must be released before
-    // callbacks execute. Callbacks added after this transfer will re-arm post_cb_ and will execute
-    // later in the event loop.
-    Thread::LockGuard lock(post_lock_);
-    callbacks = std::move(post_callbacks_);
-    // post_callbacks_ should be empty after the move.
-    ASSERT(post_callbacks_.empty());
-  }
-  // It is important that the execution and deletion of the callback happen while post_lock_ is not
-  // held. Either the invocation or destructor of the callback can call post() on this dispatcher.
+  // Take ownership of all callbacks posted so far. Callbacks added after this point find the queue
+  // empty, re-arm post_cb_ and will execute later in the event loop. Either the invocation or
+  // destructor of a callback can call post() on this dispatcher.
+  PostCallbackQueue::Batch callbacks = post_callbacks_.popAll();
+  uint64_t batch_size = 0;
   while (!callbacks.empty()) {
-    // Touch the watchdog before executing the callback to avoid spurious watchdog miss events when
-    // executing a long list of callbacks.
-    touchWatchdog();
-    // Run the callback.
-    callbacks.front()();
+    // The watchdog is touched before executing each callback to avoid spurious watchdog miss
+    // events when executing a long list of callbacks.
+    runEvent(EventCategory::PostCallback, callbacks.front());
     // Pop the front so that the destructor of the callback that just executed runs before the next
     // callback executes.
-    callbacks.pop_front();
+    callbacks.popFront();
+    ++batch_size;
+  }
+  if (stats_ != nullptr && batch_size > 0) {
+    stats_->post_batch_size_.recordValue(batch_size);
   }
 }
 
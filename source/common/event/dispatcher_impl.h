@@ -18,6 +18,7 @@
 #include "source/common/common/thread.h"
 #include "source/common/event/libevent.h"
 #include "source/common/event/libevent_scheduler.h"
+#include "source/common/event/post_callback_queue.h"
 #include "source/common/signal/fatal_error_handler.h"
 
 #include "absl/container/inlined_vector.h"
@@ -30,6 +31,11 @@ namespace Event {
 // shouldn't have to grow larger.
 inline constexpr size_t ExpectedMaxTrackedObjectStackDepth = 10;
 
+// The maximum number of deferred deletables destroyed per pass of the event loop, so that
+// destroying a large number of objects, such as after closing many connections at once, is spread
+// over several event loop iterations instead of stalling a single one.
+inline constexpr size_t MaxDeferredDeletesPerPass = 1024;
+
 /**
  * libevent implementation of Event::Dispatcher.
  */
@@ -56,6 +62,9 @@ public:
                         std::chrono::milliseconds min_touch_interval) override;
   TimeSource& timeSource() override { return api_.timeSource(); }
   void initializeStats(Stats::Scope& scope, const absl::optional<std::string>& prefix) override;
+  std::chrono::microseconds averageLoopDuration() const override {
+    return base_scheduler_.averageLoopDuration();
+  }
   void clearDeferredDeleteList() override;
   Network::ServerConnectionPtr
   createServerConnection(Network::ConnectionSocketPtr&& socket,
@@ -87,6 +96,7 @@ public:
   void exit() override;
   SignalEventPtr listenForSignal(signal_t signal_num, SignalCb cb) override;
   void post(std::function<void()> callback) override;
+  void postBatch(std::vector<std::function<void()>>&& callbacks) override;
   void deleteInDispatcherThread(DispatcherThreadDeletableConstPtr deletable) override;
   void run(RunType type) override;
   Buffer::WatermarkFactory& getWatermarkFactory() override { return *buffer_factory_; }
@@ -128,6 +138,35 @@ private:
   };
   using WatchdogRegistrationPtr = std::unique_ptr<WatchdogRegistration>;
 
+  // The categories of event loop callbacks whose durations are recorded in stats.
+  enum class EventCategory { FileEvent, Timer, SchedulableCallback, PostCallback };
+
+  // Touches the watchdog and runs an event loop callback, recording its duration when stats are
+  // enabled. The callback may destroy the lambda that wraps it, such as a file event callback
+  // closing its connection, so nothing captured by that lambda is used after the callback runs.
+  template <class Callback> void runEvent(EventCategory category, Callback& cb) {
+    touchWatchdog();
+    if (stats_ == nullptr) {
+      cb();
+      return;
+    }
+    const MonotonicTime start = api_.timeSource().monotonicTime();
+    cb();
+    recordEventDuration(eventDurationHistogram(category), start);
+  }
+
+  Stats::Histogram& eventDurationHistogram(EventCategory category);
+  void recordEventDuration(Stats::Histogram& histogram, MonotonicTime start);
+  void onPrepare();
+  // Destroys up to max_to_delete deferred deletables. Those left over are destroyed by the next
+  // pass, in a later event loop iteration.
+  void reclaimDeferredDeletes(size_t max_to_delete);
+  // Destroys up to max_to_delete deferred deletables of the vector being reclaimed, starting at
+  // deferred_delete_offset_, and returns how many were destroyed.
+  size_t destroyDeferredDeletes(size_t max_to_delete);
+  std::vector<DeferredDeletablePtr>& reclaimedToDelete() {
+    return current_to_delete_ == &to_delete_1_ ? to_delete_2_ : to_delete_1_;
+  }
   TimerPtr createTimerInternal(TimerCb cb);
   void updateApproximateMonotonicTimeInternal();
   void runPostCallbacks();
@@ -147,6 +186,9 @@ private:
   Api::Api& api_;
   std::string stats_prefix_;
   DispatcherStatsPtr stats_;
+  // The number of callbacks run since the last event loop iteration started, only counted when
+  // stats are enabled.
+  uint64_t events_in_loop_{};
   Thread::ThreadId run_tid_;
   Buffer::WatermarkFactorySharedPtr buffer_factory_;
   LibeventScheduler base_scheduler_;
@@ -162,12 +204,14 @@ private:
   SchedulableCallbackPtr deferred_delete_cb_;
 
   SchedulableCallbackPtr post_cb_;
-  Thread::MutexBasicLockable post_lock_;
-  std::list<std::function<void()>> post_callbacks_ ABSL_GUARDED_BY(post_lock_);
+  PostCallbackQueue post_callbacks_;
 
   std::vector<DeferredDeletablePtr> to_delete_1_;
   std::vector<DeferredDeletablePtr> to_delete_2_;
+  // The vector new deferred deletables are added to. The other one is being reclaimed: its entries
+  // before deferred_delete_offset_ have been destroyed and the others are pending.
   std::vector<DeferredDeletablePtr>* current_to_delete_;
+  size_t deferred_delete_offset_{};
 
   absl::InlinedVector<const ScopeTrackedObject*, ExpectedMaxTrackedObjectStackDepth>
       tracked_object_stack_;
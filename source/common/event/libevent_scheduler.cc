@@ -101,6 +101,13 @@ void LibeventScheduler::onPrepareForStats(evwatch*, const evwatch_prepare_cb_inf
     timeval delta;
     evutil_timersub(&self->prepare_time_, &self->check_time_, &delta);
     recordTimeval(self->stats_->loop_duration_us_, delta);
+
+    // Exponentially weighted, giving 1/8 of the weight to this iteration. Only this thread writes
+    // the average, so a load and a store are enough.
+    const uint64_t duration_us = delta.tv_sec * 1000000 + delta.tv_usec;
+    const uint64_t average_us = self->average_loop_duration_us_.load(std::memory_order_relaxed);
+    self->average_loop_duration_us_.store(average_us - average_us / 8 + duration_us / 8,
+                                          std::memory_order_relaxed);
   }
 }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 
 #include "envoy/event/dispatcher.h"
@@ -99,6 +101,14 @@ public:
    */
   void initializeStats(DispatcherStats* stats);
 
+  /**
+   * @return a moving average of the loop durations recorded in stats. This can be called from any
+   *         thread.
+   */
+  std::chrono::microseconds averageLoopDuration() const {
+    return std::chrono::microseconds(average_loop_duration_us_.load(std::memory_order_relaxed));
+  }
+
 private:
   static void onPrepareForCallback(evwatch*, const evwatch_prepare_cb_info* info, void* arg);
   static void onPrepareForStats(evwatch*, const evwatch_prepare_cb_info* info, void* arg);
@@ -120,6 +130,8 @@ private:
   timeval timeout_{};        // the poll timeout for the current event loop iteration, if available
   timeval prepare_time_{};   // timestamp immediately before polling
   timeval check_time_{};     // timestamp immediately after polling
+  // moving average of loop_duration, read from other threads
+  std::atomic<uint64_t> average_loop_duration_us_{};
   OnPrepareCallback callback_; // callback to be called from onPrepareForCallback()
 };
 
@@ -0,0 +1,62 @@
+#include "source/common/event/post_callback_queue.h"
+
+namespace Envoy {
+namespace Event {
+
+bool PostCallbackQueue::push(std::function<void()> callback) {
+  Node* node = new Node{std::move(callback), nullptr};
+  return pushChain(node, node);
+}
+
+bool PostCallbackQueue::push(std::vector<std::function<void()>>&& callbacks) {
+  if (callbacks.empty()) {
+    return false;
+  }
+  // The stack is popped in reverse, so link the chain from the last callback to the first.
+  Node* first = nullptr;
+  Node* last = nullptr;
+  for (auto& callback : callbacks) {
+    first = new Node{std::move(callback), first};
+    if (last == nullptr) {
+      last = first;
+    }
+  }
+  callbacks.clear();
+  return pushChain(first, last);
+}
+
+bool PostCallbackQueue::pushChain(Node* first, Node* last) {
+  // Once the chain is published the consumer may relink it at any time, so the previous head is
+  // tracked in a local rather than read back from last->next_.
+  Node* head = head_.load(std::memory_order_relaxed);
+  do {
+    last->next_ = head;
+  } while (!head_.compare_exchange_weak(head, first, std::memory_order_release,
+                                        std::memory_order_relaxed));
+  return head == nullptr;
+}
+
+PostCallbackQueue::Batch PostCallbackQueue::popAll() {
+  Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+  // Reverse the stack into posting order.
+  Node* reversed = nullptr;
+  while (node != nullptr) {
+    Node* next = node->next_;
+    node->next_ = reversed;
+    reversed = node;
+    node = next;
+  }
+  return Batch(reversed);
+}
+
+size_t PostCallbackQueue::size() const {
+  size_t size = 0;
+  for (const Node* node = head_.load(std::memory_order_acquire); node != nullptr;
+       node = node->next_) {
+    size++;
+  }
+  return size;
+}
+
+} // namespace Event
+} // namespace Envoy
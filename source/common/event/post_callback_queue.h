@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "source/common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * Multi-producer, single-consumer queue of callbacks posted to a dispatcher. Producers add
+ * callbacks with a single compare-and-swap and never block each other or the consumer; the
+ * consumer takes everything queued so far with one atomic exchange. Pushing reports whether the
+ * queue was empty, so that producers wake the consumer at most once per drained batch.
+ *
+ * Internally this is a lock-free stack: popAll() takes the whole stack at once and reverses it,
+ * so callbacks are returned in posting order. Since nodes are only ever removed all together,
+ * the stack is not subject to the ABA problem.
+ */
+class PostCallbackQueue : NonCopyable {
+private:
+  struct Node {
+    std::function<void()> callback_;
+    Node* next_;
+  };
+
+public:
+  /**
+   * Callbacks removed from the queue, in posting order. Any callbacks that have not been popped
+   * when the batch is destroyed are destroyed without being run.
+   */
+  class Batch : NonCopyable {
+  public:
+    Batch(Batch&& other) noexcept : head_(other.head_) { other.head_ = nullptr; }
+    ~Batch() {
+      while (!empty()) {
+        popFront();
+      }
+    }
+
+    bool empty() const { return head_ == nullptr; }
+    std::function<void()>& front() { return head_->callback_; }
+    void popFront() {
+      Node* node = head_;
+      head_ = node->next_;
+      delete node;
+    }
+
+  private:
+    friend class PostCallbackQueue;
+    explicit Batch(Node* head) : head_(head) {}
+
+    Node* head_;
+  };
+
+  ~PostCallbackQueue() { popAll(); }
+
+  /**
+   * Adds a callback. Safe to call from any thread.
+   * @return true if the queue was empty, i.e. the caller should wake the consumer.
+   */
+  bool push(std::function<void()> callback);
+
+  /**
+   * Adds several callbacks with a single atomic operation. The callbacks run in vector order and
+   * no other producer's callbacks are interleaved between them. Safe to call from any thread.
+   * @return true if the queue was empty and callbacks is not, i.e. the caller should wake the
+   *         consumer.
+   */
+  bool push(std::vector<std::function<void()>>&& callbacks);
+
+  /**
+   * Removes all queued callbacks. Must only be called from the consumer thread.
+   */
+  Batch popAll();
+
+  /**
+   * @return the number of queued callbacks. Must only be called from the consumer thread; the
+   *         result is a snapshot that concurrent producers may immediately invalidate.
+   */
+  size_t size() const;
+
+private:
+  // Splices the chain [first, last] on top of the stack, where first is the most recently posted
+  // callback of the chain.
+  bool pushChain(Node* first, Node* last);
+
+  std::atomic<Node*> head_{nullptr};
+};
+
+} // namespace Event
+} // namespace Envoy
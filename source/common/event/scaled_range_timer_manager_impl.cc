@@ -34,7 +34,7 @@ class ScaledRangeTimerManagerImpl::RangeTimerImpl final : public Timer {
 public:
   RangeTimerImpl(ScaledTimerMinimum minimum, TimerCb callback, ScaledRangeTimerManagerImpl& manager)
       : minimum_(minimum), manager_(manager), callback_(std::move(callback)),
-        min_duration_timer_(manager.dispatcher_.createTimer([this] { onMinTimerComplete(); })) {}
+        min_duration_timer_(manager.createMinDurationTimer([this] { onMinTimerComplete(); })) {}
 
   ~RangeTimerImpl() override { disableTimer(); }
 
@@ -138,8 +138,12 @@ private:
 };
 
 ScaledRangeTimerManagerImpl::ScaledRangeTimerManagerImpl(
-    Dispatcher& dispatcher, const ScaledTimerTypeMapConstSharedPtr& timer_minimums)
+    Dispatcher& dispatcher, const ScaledTimerTypeMapConstSharedPtr& timer_minimums,
+    absl::optional<std::chrono::milliseconds> timer_wheel_granularity)
     : dispatcher_(dispatcher),
+      timer_wheel_(timer_wheel_granularity.has_value()
+                       ? std::make_unique<TimerWheel>(dispatcher, *timer_wheel_granularity)
+                       : nullptr),
       timer_minimums_(timer_minimums != nullptr ? timer_minimums
                                                 : std::make_shared<ScaledTimerTypeMap>()),
       scale_factor_(1.0) {}
@@ -163,6 +167,13 @@ TimerPtr ScaledRangeTimerManagerImpl::createTimer(ScaledTimerMinimum minimum, Ti
   return std::make_unique<RangeTimerImpl>(minimum, callback, *this);
 }
 
+TimerPtr ScaledRangeTimerManagerImpl::createMinDurationTimer(TimerCb callback) {
+  if (timer_wheel_ != nullptr) {
+    return timer_wheel_->createTimer(std::move(callback));
+  }
+  return dispatcher_.createTimer(std::move(callback));
+}
+
 void ScaledRangeTimerManagerImpl::setScaleFactor(UnitFloat scale_factor) {
   const MonotonicTime now = dispatcher_.approximateMonotonicTime();
   scale_factor_ = scale_factor;
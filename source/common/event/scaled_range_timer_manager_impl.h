@@ -7,6 +7,8 @@
 #include "envoy/event/scaled_range_timer_manager.h"
 #include "envoy/event/timer.h"
 
+#include "source/common/event/timer_wheel_impl.h"
+
 #include "absl/container/flat_hash_map.h"
 
 namespace Envoy {
@@ -20,12 +22,19 @@ namespace Event {
  * expectation is that the number of (max - min) values used to enable timers is small, so the
  * number of queues is tightly bounded. The queue-based implementation depends on that expectation
  * for efficient operation.
+ *
+ * Each timer waits for its min duration on a timer of its own. These are dispatcher timers, unless
+ * the manager is given a timer wheel granularity, in which case they are timers of a TimerWheel.
+ * The wheel keeps arming and disarming the timers, such as the idle timeouts of a large number of
+ * connections, off the timer heap of the event loop.
  */
 class ScaledRangeTimerManagerImpl : public ScaledRangeTimerManager {
 public:
-  // Takes a Dispatcher and a map from timer type to scaled minimum value.
-  ScaledRangeTimerManagerImpl(Dispatcher& dispatcher,
-                              const ScaledTimerTypeMapConstSharedPtr& timer_minimums = nullptr);
+  // Takes a Dispatcher, a map from timer type to scaled minimum value and optionally the
+  // granularity of the timer wheel to wait for the min durations on.
+  ScaledRangeTimerManagerImpl(
+      Dispatcher& dispatcher, const ScaledTimerTypeMapConstSharedPtr& timer_minimums = nullptr,
+      absl::optional<std::chrono::milliseconds> timer_wheel_granularity = absl::nullopt);
   ~ScaledRangeTimerManagerImpl() override;
 
   // ScaledRangeTimerManager impl
@@ -122,7 +131,11 @@ private:
 
   void onQueueTimerFired(Queue& queue);
 
+  TimerPtr createMinDurationTimer(TimerCb callback);
+
   Dispatcher& dispatcher_;
+  // Declared before any timer it creates can exist, so that it outlives them.
+  const TimerWheelPtr timer_wheel_;
   const ScaledTimerTypeMapConstSharedPtr timer_minimums_;
   UnitFloat scale_factor_;
   absl::flat_hash_set<std::unique_ptr<Queue>, Hash, Eq> queues_;
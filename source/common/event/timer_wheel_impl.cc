@@ -0,0 +1,219 @@
+#include "source/common/event/timer_wheel_impl.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/scope_tracker.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * A timer of a TimerWheel. While armed, the timer is linked into the list of the slot its expiry
+ * falls in.
+ */
+class TimerWheel::TimerImpl final : public Timer {
+public:
+  TimerImpl(TimerWheel& wheel, TimerCb callback) : wheel_(wheel), callback_(std::move(callback)) {}
+  ~TimerImpl() override { disableTimer(); }
+
+  // Timer
+  void disableTimer() override {
+    if (armed_) {
+      wheel_.disarm(*this);
+    }
+    scope_ = nullptr;
+  }
+  void enableTimer(std::chrono::milliseconds ms, const ScopeTrackedObject* scope) override {
+    disableTimer();
+    scope_ = scope;
+    wheel_.arm(*this, ms);
+  }
+  void enableHRTimer(std::chrono::microseconds us, const ScopeTrackedObject* scope) override {
+    enableTimer(std::chrono::ceil<std::chrono::milliseconds>(us), scope);
+  }
+  bool enabled() override { return armed_; }
+
+  // Runs the callback of the timer, which the wheel has already disarmed.
+  void trigger() {
+    if (scope_ == nullptr) {
+      callback_();
+    } else {
+      ScopeTrackerScopeState scope(scope_, wheel_.dispatcher_);
+      scope_ = nullptr;
+      callback_();
+    }
+  }
+
+  TimerWheel& wheel_;
+  const TimerCb callback_;
+  const ScopeTrackedObject* scope_{};
+  bool armed_{};
+  // The tick the timer expires at, and its place in the slot list while armed.
+  uint64_t expiry_tick_{};
+  Slot* slot_{};
+  TimerImpl* prev_{};
+  TimerImpl* next_{};
+};
+
+TimerWheel::TimerWheel(Dispatcher& dispatcher, std::chrono::milliseconds granularity)
+    : dispatcher_(dispatcher), granularity_(granularity),
+      start_time_(dispatcher.approximateMonotonicTime()) {
+  ASSERT(granularity_.count() > 0);
+}
+
+TimerWheel::~TimerWheel() {
+  // Timers created by the wheel must not outlive it.
+  ASSERT(size_ == 0);
+}
+
+TimerPtr TimerWheel::createTimer(TimerCb callback) {
+  return std::make_unique<TimerImpl>(*this, std::move(callback));
+}
+
+uint64_t TimerWheel::tickAt(MonotonicTime time, bool round_up) const {
+  if (time <= start_time_) {
+    return 0;
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(time - start_time_);
+  const auto granularity = std::chrono::duration_cast<std::chrono::nanoseconds>(granularity_);
+  uint64_t tick = elapsed / granularity;
+  if (round_up && elapsed % granularity != std::chrono::nanoseconds::zero()) {
+    ++tick;
+  }
+  return tick;
+}
+
+void TimerWheel::arm(TimerImpl& timer, std::chrono::milliseconds timeout) {
+  ASSERT(dispatcher_.isThreadSafe());
+  const MonotonicTime now = dispatcher_.approximateMonotonicTime();
+  if (size_ == 0) {
+    // No timer is armed, so the wheel can catch up with the current time without running ticks.
+    current_tick_ = std::max(current_tick_, tickAt(now, false));
+  }
+  timer.expiry_tick_ =
+      std::max(tickAt(now + std::max(timeout, std::chrono::milliseconds::zero()), true),
+               current_tick_ + 1);
+  insert(timer);
+  timer.armed_ = true;
+  ++size_;
+  if (size_ == 1 || timer.expiry_tick_ < scheduled_tick_) {
+    scheduleTick();
+  }
+}
+
+void TimerWheel::disarm(TimerImpl& timer) {
+  ASSERT(dispatcher_.isThreadSafe());
+  unlink(timer);
+  timer.armed_ = false;
+  --size_;
+  if (size_ == 0) {
+    tick_timer_->disableTimer();
+  }
+}
+
+void TimerWheel::insert(TimerImpl& timer) {
+  // A timer expiring less than Slots^(l + 1) ticks ahead, but not less than Slots^l, goes to level
+  // l, in the slot of its expiry tick at the granularity of that level.
+  const uint64_t max_delta = (uint64_t(1) << (SlotBits * Levels)) - 1;
+  if (timer.expiry_tick_ - current_tick_ > max_delta) {
+    timer.expiry_tick_ = current_tick_ + max_delta;
+  }
+  const uint64_t delta = timer.expiry_tick_ - current_tick_;
+  uint32_t level = 0;
+  while (level < Levels - 1 && delta >= (uint64_t(1) << (SlotBits * (level + 1)))) {
+    ++level;
+  }
+  Slot& slot = levels_[level][(timer.expiry_tick_ >> (SlotBits * level)) & (Slots - 1)];
+  timer.slot_ = &slot;
+  timer.prev_ = nullptr;
+  timer.next_ = slot.head_;
+  if (slot.head_ != nullptr) {
+    slot.head_->prev_ = &timer;
+  }
+  slot.head_ = &timer;
+}
+
+void TimerWheel::unlink(TimerImpl& timer) {
+  if (timer.prev_ != nullptr) {
+    timer.prev_->next_ = timer.next_;
+  } else {
+    timer.slot_->head_ = timer.next_;
+  }
+  if (timer.next_ != nullptr) {
+    timer.next_->prev_ = timer.prev_;
+  }
+  timer.slot_ = nullptr;
+  timer.prev_ = nullptr;
+  timer.next_ = nullptr;
+}
+
+void TimerWheel::cascade(uint32_t level) {
+  // The timers of the current slot of the level expire within the next revolution of the level
+  // below, so they all move to lower levels.
+  Slot& slot = levels_[level][(current_tick_ >> (SlotBits * level)) & (Slots - 1)];
+  TimerImpl* timer = slot.head_;
+  slot.head_ = nullptr;
+  while (timer != nullptr) {
+    TimerImpl* next = timer->next_;
+    insert(*timer);
+    timer = next;
+  }
+}
+
+uint64_t TimerWheel::nextTickToRun() const {
+  // The next tick whose first level slot has timers, or else the end of the revolution of the first
+  // level, where the next level cascades.
+  uint64_t tick = current_tick_ + 1;
+  while ((tick & (Slots - 1)) != 0 && levels_[0][tick & (Slots - 1)].head_ == nullptr) {
+    ++tick;
+  }
+  return tick;
+}
+
+void TimerWheel::onTick() {
+  ASSERT(dispatcher_.isThreadSafe());
+  const uint64_t target_tick = tickAt(dispatcher_.timeSource().monotonicTime(), false);
+  while (size_ > 0 && current_tick_ < target_tick) {
+    ++current_tick_;
+    for (uint32_t level = 1;
+         level < Levels && (current_tick_ & ((uint64_t(1) << (SlotBits * level)) - 1)) == 0;
+         ++level) {
+      cascade(level);
+    }
+
+    // Timers armed by the callbacks expire at a later tick, so they are not added to this slot.
+    Slot& slot = levels_[0][current_tick_ & (Slots - 1)];
+    while (slot.head_ != nullptr) {
+      TimerImpl& timer = *slot.head_;
+      ASSERT(timer.expiry_tick_ == current_tick_);
+      unlink(timer);
+      timer.armed_ = false;
+      --size_;
+      timer.trigger();
+    }
+  }
+
+  if (size_ == 0) {
+    current_tick_ = std::max(current_tick_, target_tick);
+  } else {
+    scheduleTick();
+  }
+}
+
+void TimerWheel::scheduleTick() {
+  if (tick_timer_ == nullptr) {
+    tick_timer_ = dispatcher_.createTimer([this]() -> void { onTick(); });
+  }
+  scheduled_tick_ = nextTickToRun();
+  const MonotonicTime tick_time =
+      start_time_ + granularity_ * static_cast<int64_t>(scheduled_tick_);
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  tick_timer_->enableTimer(
+      tick_time > now ? std::chrono::ceil<std::chrono::milliseconds>(tick_time - now)
+                      : std::chrono::milliseconds::zero());
+}
+
+} // namespace Event
+} // namespace Envoy
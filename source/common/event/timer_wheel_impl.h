@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * A hierarchical timer wheel for coarse timers, such as connection and stream idle timeouts, of
+ * which there can be millions on a dispatcher. The wheel has Levels levels of Slots slots. A slot
+ * of the first level spans one tick of the wheel's granularity and a slot of each next level spans
+ * a whole revolution of the level below it. Each timer is kept in the intrusive list of the slot
+ * its expiry falls in, so arming and disarming a timer takes constant time, rather than the
+ * logarithmic time of the event loop's timer heap. When the first level completes a revolution,
+ * the timers of the next level's current slot are redistributed to the levels below.
+ *
+ * A single dispatcher timer ticks the wheel while it has armed timers. Timers expire up to one
+ * granularity after their timeout, never before. Timeouts longer than a full revolution of the
+ * last level are capped to it. The wheel must be used from the thread of its dispatcher, and its
+ * timers must be destroyed before it.
+ */
+class TimerWheel {
+public:
+  static constexpr uint32_t SlotBits = 8;
+  static constexpr uint32_t Slots = 1 << SlotBits;
+  static constexpr uint32_t Levels = 4;
+
+  TimerWheel(Dispatcher& dispatcher, std::chrono::milliseconds granularity);
+  ~TimerWheel();
+
+  /**
+   * Creates a timer on the wheel, disabled.
+   */
+  TimerPtr createTimer(TimerCb callback);
+
+  /**
+   * @return the number of armed timers.
+   */
+  uint64_t size() const { return size_; }
+
+private:
+  class TimerImpl;
+
+  // The head of the intrusive list of the timers of a slot.
+  struct Slot {
+    TimerImpl* head_{};
+  };
+
+  uint64_t tickAt(MonotonicTime time, bool round_up) const;
+  uint64_t nextTickToRun() const;
+  void arm(TimerImpl& timer, std::chrono::milliseconds timeout);
+  void disarm(TimerImpl& timer);
+  void insert(TimerImpl& timer);
+  void unlink(TimerImpl& timer);
+  void cascade(uint32_t level);
+  void onTick();
+  void scheduleTick();
+
+  Dispatcher& dispatcher_;
+  const std::chrono::milliseconds granularity_;
+  const MonotonicTime start_time_;
+  // The tick of the wheel, counted in granularities since start_time_. The timers of the current
+  // slot of the first level expire at this tick.
+  uint64_t current_tick_{};
+  uint64_t size_{};
+  // The tick the tick timer is enabled for, if the wheel has armed timers.
+  uint64_t scheduled_tick_{};
+  std::array<std::array<Slot, Slots>, Levels> levels_;
+  // Created on the first arm, so that the wheel can be constructed on another thread than the
+  // thread running its dispatcher.
+  TimerPtr tick_timer_;
+};
+
+using TimerWheelPtr = std::unique_ptr<TimerWheel>;
+
+} // namespace Event
+} // namespace Envoy
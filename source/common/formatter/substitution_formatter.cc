@@ -1,7 +1,10 @@
 #include "source/common/formatter/substitution_formatter.h"
 
+#include <algorithm>
 #include <climits>
+#include <cmath>
 #include <cstdint>
+#include <iterator>
 #include <regex>
 #include <string>
 #include <vector>
@@ -38,6 +41,86 @@ namespace {
 
 const ProtobufWkt::Value& unspecifiedValue() { return ValueUtil::nullValue(); }
 
+bool needsJsonEscape(char c) {
+  return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+}
+
+void appendJsonEscaped(std::string& output, absl::string_view value) {
+  for (const char c : value) {
+    switch (c) {
+    case '"':
+      output.append("\\\"");
+      break;
+    case '\\':
+      output.append("\\\\");
+      break;
+    case '\b':
+      output.append("\\b");
+      break;
+    case '\f':
+      output.append("\\f");
+      break;
+    case '\n':
+      output.append("\\n");
+      break;
+    case '\r':
+      output.append("\\r");
+      break;
+    case '\t':
+      output.append("\\t");
+      break;
+    default:
+      if (needsJsonEscape(c)) {
+        fmt::format_to(std::back_inserter(output), "\\u{:04x}", static_cast<int>(c));
+      } else {
+        output.push_back(c);
+      }
+    }
+  }
+}
+
+void appendJsonString(std::string& output, absl::string_view value) {
+  output.push_back('"');
+  appendJsonEscaped(output, value);
+  output.push_back('"');
+}
+
+// Closes the JSON string opened before start, escaping the characters appended to output since.
+// These rarely need escaping, so that they are usually formatted in place.
+void closeJsonString(std::string& output, size_t start) {
+  if (std::any_of(output.begin() + start, output.end(), needsJsonEscape)) {
+    const std::string raw = output.substr(start);
+    output.resize(start);
+    appendJsonEscaped(output, raw);
+  }
+  output.push_back('"');
+}
+
+void appendJsonValue(std::string& output, const ProtobufWkt::Value& value) {
+  switch (value.kind_case()) {
+  case ProtobufWkt::Value::kNullValue:
+    output.append("null");
+    return;
+  case ProtobufWkt::Value::kBoolValue:
+    output.append(value.bool_value() ? "true" : "false");
+    return;
+  case ProtobufWkt::Value::kStringValue:
+    appendJsonString(output, value.string_value());
+    return;
+  case ProtobufWkt::Value::kNumberValue:
+    // Most of the typed values are integers, which are exact as doubles below 2^53.
+    if (std::trunc(value.number_value()) == value.number_value() &&
+        std::abs(value.number_value()) < 9007199254740992.0) {
+      absl::StrAppend(&output, static_cast<int64_t>(value.number_value()));
+      return;
+    }
+    break;
+  default:
+    break;
+  }
+  output.append(MessageUtil::getJsonStringFromMessageOrDie(value, false, true));
+}
+
 void truncate(std::string& str, absl::optional<uint32_t> max_length) {
   if (!max_length) {
     return;
@@ -128,9 +211,10 @@ std::string FormatterImpl::format(const Http::RequestHeaderMap& request_headers,
   log_line.reserve(256);
 
   for (const FormatterProviderPtr& provider : providers_) {
-    const auto bit = provider->format(request_headers, response_headers, response_trailers,
-                                      stream_info, local_reply_body);
-    log_line += bit.value_or(empty_value_string_);
+    if (!provider->formatTo(log_line, request_headers, response_headers, response_trailers,
+                            stream_info, local_reply_body)) {
+      log_line += empty_value_string_;
+    }
   }
 
   return log_line;
@@ -141,12 +225,12 @@ std::string JsonFormatterImpl::format(const Http::RequestHeaderMap& request_head
                                       const Http::ResponseTrailerMap& response_trailers,
                                       const StreamInfo::StreamInfo& stream_info,
                                       absl::string_view local_reply_body) const {
-  const ProtobufWkt::Struct output_struct = struct_formatter_.format(
-      request_headers, response_headers, response_trailers, stream_info, local_reply_body);
-
-  const std::string log_line =
-      MessageUtil::getJsonStringFromMessageOrDie(output_struct, false, true);
-  return absl::StrCat(log_line, "\n");
+  std::string log_line;
+  log_line.reserve(256);
+  struct_formatter_.formatJson(log_line, request_headers, response_headers, response_trailers,
+                               stream_info, local_reply_body);
+  log_line.push_back('\n');
+  return log_line;
 }
 
 StructFormatter::StructFormatter(const ProtobufWkt::Struct& format_mapping, bool preserve_types,
@@ -278,6 +362,115 @@ ProtobufWkt::Value StructFormatter::structFormatListCallback(
   return ValueUtil::listValue(output);
 }
 
+bool StructFormatter::providersJson(std::string& output,
+                                    const std::vector<FormatterProviderPtr>& providers,
+                                    const FormatContext& context) const {
+  ASSERT(!providers.empty());
+  if (providers.size() == 1 && preserve_types_) {
+    const ProtobufWkt::Value value = providers.front()->formatValue(
+        context.request_headers_, context.response_headers_, context.response_trailers_,
+        context.stream_info_, context.local_reply_body_);
+    if (omit_empty_values_ && value.kind_case() == ProtobufWkt::Value::kNullValue) {
+      return false;
+    }
+    appendJsonValue(output, value);
+    return true;
+  }
+
+  output.push_back('"');
+  const size_t start = output.size();
+  if (providers.size() == 1) {
+    if (!providers.front()->formatTo(output, context.request_headers_, context.response_headers_,
+                                     context.response_trailers_, context.stream_info_,
+                                     context.local_reply_body_)) {
+      if (omit_empty_values_) {
+        output.resize(start - 1);
+        return false;
+      }
+      output.append(DefaultUnspecifiedValueString);
+    }
+  } else {
+    // Multiple providers forces string output.
+    for (const auto& provider : providers) {
+      if (!provider->formatTo(output, context.request_headers_, context.response_headers_,
+                              context.response_trailers_, context.stream_info_,
+                              context.local_reply_body_)) {
+        output.append(empty_value_);
+      }
+    }
+  }
+  closeJsonString(output, start);
+  return true;
+}
+
+void StructFormatter::structFormatMapJson(std::string& output,
+                                          const StructFormatMapWrapper& format_map,
+                                          const FormatContext& context) const {
+  output.push_back('{');
+  bool empty = true;
+  for (const auto& pair : *format_map.value_) {
+    const size_t field_start = output.size();
+    if (!empty) {
+      output.push_back(',');
+    }
+    appendJsonString(output, pair.first);
+    output.push_back(':');
+    if (!structFormatValueJson(output, pair.second, context)) {
+      output.resize(field_start);
+      continue;
+    }
+    empty = false;
+  }
+  output.push_back('}');
+}
+
+void StructFormatter::structFormatListJson(std::string& output,
+                                           const StructFormatListWrapper& format_list,
+                                           const FormatContext& context) const {
+  output.push_back('[');
+  bool empty = true;
+  for (const auto& value : *format_list.value_) {
+    const size_t value_start = output.size();
+    if (!empty) {
+      output.push_back(',');
+    }
+    if (!structFormatValueJson(output, value, context)) {
+      output.resize(value_start);
+      continue;
+    }
+    empty = false;
+  }
+  output.push_back(']');
+}
+
+bool StructFormatter::structFormatValueJson(std::string& output,
+                                            const StructFormatValue& format_value,
+                                            const FormatContext& context) const {
+  return absl::visit(StructFormatMapVisitorHelper{
+                         [&](const std::vector<FormatterProviderPtr>& providers) {
+                           return providersJson(output, providers, context);
+                         },
+                         [&](const StructFormatMapWrapper& format_map) {
+                           structFormatMapJson(output, format_map, context);
+                           return true;
+                         },
+                         [&](const StructFormatListWrapper& format_list) {
+                           structFormatListJson(output, format_list, context);
+                           return true;
+                         }},
+                     format_value);
+}
+
+void StructFormatter::formatJson(std::string& output, const Http::RequestHeaderMap& request_headers,
+                                 const Http::ResponseHeaderMap& response_headers,
+                                 const Http::ResponseTrailerMap& response_trailers,
+                                 const StreamInfo::StreamInfo& stream_info,
+                                 absl::string_view local_reply_body) const {
+  const FormatContext context{request_headers, response_headers, response_trailers, stream_info,
+                              local_reply_body};
+  structFormatMapJson(output, struct_output_format_, context);
+}
+
 ProtobufWkt::Struct StructFormatter::format(const Http::RequestHeaderMap& request_headers,
                                             const Http::ResponseHeaderMap& response_headers,
                                             const Http::ResponseTrailerMap& response_trailers,
@@ -943,6 +1136,14 @@ absl::optional<std::string> PlainStringFormatter::format(const Http::RequestHead
   return str_.string_value();
 }
 
+bool PlainStringFormatter::formatTo(std::string& output, const Http::RequestHeaderMap&,
+                                    const Http::ResponseHeaderMap&,
+                                    const Http::ResponseTrailerMap&,
+                                    const StreamInfo::StreamInfo&, absl::string_view) const {
+  output.append(str_.string_value());
+  return true;
+}
+
 ProtobufWkt::Value PlainStringFormatter::formatValue(const Http::RequestHeaderMap&,
                                                      const Http::ResponseHeaderMap&,
                                                      const Http::ResponseTrailerMap&,
@@ -958,6 +1159,15 @@ LocalReplyBodyFormatter::format(const Http::RequestHeaderMap&, const Http::Respo
   return std::string(local_reply_body);
 }
 
+bool LocalReplyBodyFormatter::formatTo(std::string& output, const Http::RequestHeaderMap&,
+                                       const Http::ResponseHeaderMap&,
+                                       const Http::ResponseTrailerMap&,
+                                       const StreamInfo::StreamInfo&,
+                                       absl::string_view local_reply_body) const {
+  output.append(local_reply_body.data(), local_reply_body.size());
+  return true;
+}
+
 ProtobufWkt::Value LocalReplyBodyFormatter::formatValue(const Http::RequestHeaderMap&,
                                                         const Http::ResponseHeaderMap&,
                                                         const Http::ResponseTrailerMap&,
@@ -994,6 +1204,20 @@ absl::optional<std::string> HeaderFormatter::format(const Http::HeaderMap& heade
   return val;
 }
 
+bool HeaderFormatter::formatTo(std::string& output, const Http::HeaderMap& headers) const {
+  const Http::HeaderEntry* header = findHeader(headers);
+  if (!header) {
+    return false;
+  }
+
+  absl::string_view val = header->value().getStringView();
+  if (max_length_.has_value()) {
+    val = val.substr(0, max_length_.value());
+  }
+  output.append(val.data(), val.size());
+  return true;
+}
+
 ProtobufWkt::Value HeaderFormatter::formatValue(const Http::HeaderMap& headers) const {
   const Http::HeaderEntry* header = findHeader(headers);
   if (!header) {
@@ -1016,6 +1240,13 @@ absl::optional<std::string> ResponseHeaderFormatter::format(
   return HeaderFormatter::format(response_headers);
 }
 
+bool ResponseHeaderFormatter::formatTo(std::string& output, const Http::RequestHeaderMap&,
+                                       const Http::ResponseHeaderMap& response_headers,
+                                       const Http::ResponseTrailerMap&,
+                                       const StreamInfo::StreamInfo&, absl::string_view) const {
+  return HeaderFormatter::formatTo(output, response_headers);
+}
+
 ProtobufWkt::Value ResponseHeaderFormatter::formatValue(
     const Http::RequestHeaderMap&, const Http::ResponseHeaderMap& response_headers,
     const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&, absl::string_view) const {
@@ -1034,6 +1265,14 @@ RequestHeaderFormatter::format(const Http::RequestHeaderMap& request_headers,
   return HeaderFormatter::format(request_headers);
 }
 
+bool RequestHeaderFormatter::formatTo(std::string& output,
+                                      const Http::RequestHeaderMap& request_headers,
+                                      const Http::ResponseHeaderMap&,
+                                      const Http::ResponseTrailerMap&,
+                                      const StreamInfo::StreamInfo&, absl::string_view) const {
+  return HeaderFormatter::formatTo(output, request_headers);
+}
+
 ProtobufWkt::Value
 RequestHeaderFormatter::formatValue(const Http::RequestHeaderMap& request_headers,
                                     const Http::ResponseHeaderMap&, const Http::ResponseTrailerMap&,
@@ -1053,6 +1292,13 @@ ResponseTrailerFormatter::format(const Http::RequestHeaderMap&, const Http::Resp
   return HeaderFormatter::format(response_trailers);
 }
 
+bool ResponseTrailerFormatter::formatTo(std::string& output, const Http::RequestHeaderMap&,
+                                        const Http::ResponseHeaderMap&,
+                                        const Http::ResponseTrailerMap& response_trailers,
+                                        const StreamInfo::StreamInfo&, absl::string_view) const {
+  return HeaderFormatter::formatTo(output, response_trailers);
+}
+
 ProtobufWkt::Value
 ResponseTrailerFormatter::formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                       const Http::ResponseTrailerMap& response_trailers,
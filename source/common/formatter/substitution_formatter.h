@@ -178,6 +178,16 @@ public:
                              const StreamInfo::StreamInfo& stream_info,
                              absl::string_view local_reply_body) const;
 
+  /**
+   * Appends the JSON serialization of the formatted Struct to output, as format() would build it,
+   * without building the Struct. The fields of the objects are in the order of their keys.
+   */
+  void formatJson(std::string& output, const Http::RequestHeaderMap& request_headers,
+                  const Http::ResponseHeaderMap& response_headers,
+                  const Http::ResponseTrailerMap& response_trailers,
+                  const StreamInfo::StreamInfo& stream_info,
+                  absl::string_view local_reply_body) const;
+
 private:
   struct StructFormatMapWrapper;
   struct StructFormatListWrapper;
@@ -232,6 +242,24 @@ private:
   structFormatListCallback(const StructFormatter::StructFormatListWrapper& format_list,
                            const StructFormatMapVisitor& visitor) const;
 
+  // Methods for serializing the output to JSON directly. Each appends the JSON value of its part of
+  // the format to output, and returns false if the value is omitted, leaving output untouched.
+  struct FormatContext {
+    const Http::RequestHeaderMap& request_headers_;
+    const Http::ResponseHeaderMap& response_headers_;
+    const Http::ResponseTrailerMap& response_trailers_;
+    const StreamInfo::StreamInfo& stream_info_;
+    absl::string_view local_reply_body_;
+  };
+  bool providersJson(std::string& output, const std::vector<FormatterProviderPtr>& providers,
+                     const FormatContext& context) const;
+  void structFormatMapJson(std::string& output, const StructFormatMapWrapper& format_map,
+                           const FormatContext& context) const;
+  void structFormatListJson(std::string& output, const StructFormatListWrapper& format_list,
+                            const FormatContext& context) const;
+  bool structFormatValueJson(std::string& output, const StructFormatValue& format_value,
+                             const FormatContext& context) const;
+
   const bool omit_empty_values_;
   const bool preserve_types_;
   const std::string empty_value_;
@@ -273,6 +301,9 @@ public:
   absl::optional<std::string> format(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                      const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                      absl::string_view) const override;
+  bool formatTo(std::string& output, const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                absl::string_view) const override;
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
@@ -292,6 +323,9 @@ public:
   absl::optional<std::string> format(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                      const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                      absl::string_view local_reply_body) const override;
+  bool formatTo(std::string& output, const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                absl::string_view local_reply_body) const override;
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view local_reply_body) const override;
@@ -304,6 +338,7 @@ public:
 
 protected:
   absl::optional<std::string> format(const Http::HeaderMap& headers) const;
+  bool formatTo(std::string& output, const Http::HeaderMap& headers) const;
   ProtobufWkt::Value formatValue(const Http::HeaderMap& headers) const;
 
 private:
@@ -354,6 +389,9 @@ public:
                                      const Http::ResponseHeaderMap&,
                                      const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                      absl::string_view) const override;
+  bool formatTo(std::string& output, const Http::RequestHeaderMap& request_headers,
+                const Http::ResponseHeaderMap&, const Http::ResponseTrailerMap&,
+                const StreamInfo::StreamInfo&, absl::string_view) const override;
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
@@ -372,6 +410,9 @@ public:
                                      const Http::ResponseHeaderMap& response_headers,
                                      const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                      absl::string_view) const override;
+  bool formatTo(std::string& output, const Http::RequestHeaderMap&,
+                const Http::ResponseHeaderMap& response_headers, const Http::ResponseTrailerMap&,
+                const StreamInfo::StreamInfo&, absl::string_view) const override;
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
@@ -390,6 +431,9 @@ public:
                                      const Http::ResponseTrailerMap& response_trailers,
                                      const StreamInfo::StreamInfo&,
                                      absl::string_view) const override;
+  bool formatTo(std::string& output, const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap& response_trailers, const StreamInfo::StreamInfo&,
+                absl::string_view) const override;
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
@@ -9,6 +9,8 @@
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/utility.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Grpc {
 
@@ -16,7 +18,9 @@ AsyncClientImpl::AsyncClientImpl(Upstream::ClusterManager& cm,
                                  const envoy::config::core::v3::GrpcService& config,
                                  TimeSource& time_source)
     : cm_(cm), remote_cluster_name_(config.envoy_grpc().cluster_name()),
-      host_name_(config.envoy_grpc().authority()), time_source_(time_source),
+      host_name_(config.envoy_grpc().authority()),
+      egress_span_name_(absl::StrCat("async ", remote_cluster_name_, " egress")),
+      time_source_(time_source),
       metadata_parser_(
           Router::HeaderParser::configure(config.initial_metadata(), /*append=*/false)) {}
 
@@ -63,8 +67,23 @@ RawAsyncStream* AsyncClientImpl::startRaw(absl::string_view service_full_name,
 AsyncStreamImpl::AsyncStreamImpl(AsyncClientImpl& parent, absl::string_view service_full_name,
                                  absl::string_view method_name, RawAsyncStreamCallbacks& callbacks,
                                  const Http::AsyncClient::StreamOptions& options)
-    : parent_(parent), service_full_name_(service_full_name), method_name_(method_name),
-      callbacks_(callbacks), options_(options) {}
+    : headers_(Http::RequestHeaderMapImpl::create()), parent_(parent), callbacks_(callbacks),
+      options_(options) {
+  // The headers are built here while the service and method names are at hand, and sent with the
+  // initial metadata once the stream is started. They are the same as those of
+  // Common::prepareHeaders(), without building a message around them.
+  headers_->setReferenceMethod(Http::Headers::get().MethodValues.Post);
+  headers_->setPath(absl::StrCat("/", service_full_name, "/", method_name));
+  headers_->setHost(parent_.host_name_.empty() ? parent_.remote_cluster_name_
+                                               : parent_.host_name_);
+  // According to https://github.com/grpc/grpc/blob/master/doc/PROTOCOL-HTTP2.md TE should appear
+  // before Timeout and ContentType.
+  headers_->setReferenceTE(Http::Headers::get().TEValues.Trailers);
+  if (options_.timeout) {
+    Common::toGrpcTimeout(options_.timeout.value(), *headers_);
+  }
+  headers_->setReferenceContentType(Http::Headers::get().ContentTypeValues.Grpc);
+}
 
 void AsyncStreamImpl::initialize(bool buffer_body_for_retry) {
   const auto thread_local_cluster = parent_.cm_.getThreadLocalCluster(parent_.remote_cluster_name_);
@@ -86,15 +105,11 @@ void AsyncStreamImpl::initialize(bool buffer_body_for_retry) {
 
   // TODO(htuch): match Google gRPC base64 encoding behavior for *-bin headers, see
   // https://github.com/envoyproxy/envoy/pull/2444#discussion_r163914459.
-  headers_message_ = Common::prepareHeaders(
-      parent_.host_name_.empty() ? parent_.remote_cluster_name_ : parent_.host_name_,
-      service_full_name_, method_name_, options_.timeout);
   // Fill service-wide initial metadata.
-  parent_.metadata_parser_->evaluateHeaders(headers_message_->headers(),
-                                            options_.parent_context.stream_info);
+  parent_.metadata_parser_->evaluateHeaders(*headers_, options_.parent_context.stream_info);
 
-  callbacks_.onCreateInitialMetadata(headers_message_->headers());
-  stream_->sendHeaders(headers_message_->headers(), false);
+  callbacks_.onCreateInitialMetadata(*headers_);
+  stream_->sendHeaders(*headers_, false);
 }
 
 // TODO(htuch): match Google gRPC base64 encoding behavior for *-bin headers, see
@@ -194,6 +209,11 @@ void AsyncStreamImpl::sendMessageRaw(Buffer::InstancePtr&& buffer, bool end_stre
   stream_->sendData(*buffer, end_stream);
 }
 
+void AsyncStreamImpl::sendCompressedMessageRaw(Buffer::InstancePtr&& buffer, bool end_stream) {
+  Encoder().prependFrameHeader(GRPC_FH_COMPRESSED, *buffer);
+  stream_->sendData(*buffer, end_stream);
+}
+
 void AsyncStreamImpl::closeStream() {
   Buffer::OwnedImpl empty_buffer;
   stream_->sendData(empty_buffer, true);
@@ -223,8 +243,7 @@ AsyncRequestImpl::AsyncRequestImpl(AsyncClientImpl& parent, absl::string_view se
     : AsyncStreamImpl(parent, service_full_name, method_name, *this, options),
       request_(std::move(request)), callbacks_(callbacks) {
 
-  current_span_ = parent_span.spawnChild(Tracing::EgressConfig::get(),
-                                         "async " + parent.remote_cluster_name_ + " egress",
+  current_span_ = parent_span.spawnChild(Tracing::EgressConfig::get(), parent.egress_span_name_,
                                          parent.time_source_.systemTime());
   current_span_->setTag(Tracing::Tags::get().UpstreamCluster, parent.remote_cluster_name_);
   current_span_->setTag(Tracing::Tags::get().Component, Tracing::Tags::get().Proxy);
@@ -40,6 +40,8 @@ private:
   const std::string remote_cluster_name_;
   // The host header value in the http transport.
   const std::string host_name_;
+  // The name of the spans of the requests.
+  const std::string egress_span_name_;
   std::list<AsyncStreamImplPtr> active_streams_;
   TimeSource& time_source_;
   Router::HeaderParserPtr metadata_parser_;
@@ -70,6 +72,7 @@ public:
 
   // Grpc::AsyncStream
   void sendMessageRaw(Buffer::InstancePtr&& request, bool end_stream) override;
+  void sendCompressedMessageRaw(Buffer::InstancePtr&& request, bool end_stream) override;
   void closeStream() override;
   void resetStream() override;
   bool isAboveWriteBufferHighWatermark() const override {
@@ -87,10 +90,8 @@ private:
                        const std::string& grpc_message);
 
   Event::Dispatcher* dispatcher_{};
-  Http::RequestMessagePtr headers_message_;
+  Http::RequestHeaderMapPtr headers_;
   AsyncClientImpl& parent_;
-  std::string service_full_name_;
-  std::string method_name_;
   RawAsyncStreamCallbacks& callbacks_;
   Http::AsyncClient::StreamOptions options_;
   bool http_reset_{};
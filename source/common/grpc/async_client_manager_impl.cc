@@ -59,14 +59,19 @@ AsyncClientFactoryImpl::AsyncClientFactoryImpl(Upstream::ClusterManager& cm,
 
 AsyncClientManagerImpl::AsyncClientManagerImpl(Upstream::ClusterManager& cm,
                                                ThreadLocal::Instance& tls, TimeSource& time_source,
-                                               Api::Api& api, const StatNames& stat_names)
+                                               Api::Api& api, const StatNames& stat_names,
+                                               uint32_t google_grpc_completion_threads)
     : cm_(cm), tls_(tls), time_source_(time_source), api_(api), stat_names_(stat_names) {
 #ifdef ENVOY_GOOGLE_GRPC
+  auto shared_state =
+      std::make_shared<GoogleAsyncClientSharedState>(api, google_grpc_completion_threads);
   google_tls_slot_ = tls.allocateSlot();
-  google_tls_slot_->set(
-      [&api](Event::Dispatcher&) { return std::make_shared<GoogleAsyncClientThreadLocal>(api); });
+  google_tls_slot_->set([shared_state](Event::Dispatcher&) {
+    return std::make_shared<GoogleAsyncClientThreadLocal>(shared_state);
+  });
 #else
   UNREFERENCED_PARAMETER(api_);
+  UNREFERENCED_PARAMETER(google_grpc_completion_threads);
 #endif
 }
 
@@ -76,17 +81,16 @@ RawAsyncClientPtr AsyncClientFactoryImpl::create() {
 
 GoogleAsyncClientFactoryImpl::GoogleAsyncClientFactoryImpl(
     ThreadLocal::Instance& tls, ThreadLocal::Slot* google_tls_slot, Stats::Scope& scope,
-    const envoy::config::core::v3::GrpcService& config, Api::Api& api, const StatNames& stat_names)
+    const envoy::config::core::v3::GrpcService& config, const StatNames& stat_names)
     : tls_(tls), google_tls_slot_(google_tls_slot),
       scope_(scope.createScope(fmt::format("grpc.{}.", config.google_grpc().stat_prefix()))),
-      config_(config), api_(api), stat_names_(stat_names) {
+      config_(config), stat_names_(stat_names) {
 
 #ifndef ENVOY_GOOGLE_GRPC
   UNREFERENCED_PARAMETER(tls_);
   UNREFERENCED_PARAMETER(google_tls_slot_);
   UNREFERENCED_PARAMETER(scope_);
   UNREFERENCED_PARAMETER(config_);
-  UNREFERENCED_PARAMETER(api_);
   UNREFERENCED_PARAMETER(stat_names_);
   throw EnvoyException("Google C++ gRPC client is not linked");
 #else
@@ -117,7 +121,7 @@ RawAsyncClientPtr GoogleAsyncClientFactoryImpl::create() {
   GoogleGenericStubFactory stub_factory;
   return std::make_unique<GoogleAsyncClientImpl>(
       tls_.dispatcher(), google_tls_slot_->getTyped<GoogleAsyncClientThreadLocal>(), stub_factory,
-      scope_, config_, api_, stat_names_);
+      scope_, config_, stat_names_);
 #else
   return nullptr;
 #endif
@@ -131,7 +135,7 @@ AsyncClientManagerImpl::factoryForGrpcService(const envoy::config::core::v3::Grp
     return std::make_unique<AsyncClientFactoryImpl>(cm_, config, skip_cluster_check, time_source_);
   case envoy::config::core::v3::GrpcService::TargetSpecifierCase::kGoogleGrpc:
     return std::make_unique<GoogleAsyncClientFactoryImpl>(tls_, google_tls_slot_.get(), scope,
-                                                          config, api_, stat_names_);
+                                                          config, stat_names_);
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
@@ -7,6 +7,7 @@
 
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/buffer/zero_copy_input_stream_impl.h"
+#include "source/common/buffer/zero_copy_output_stream_impl.h"
 #include "source/common/common/assert.h"
 #include "source/common/common/base64.h"
 #include "source/common/common/empty_string.h"
@@ -126,36 +127,31 @@ Common::getGrpcStatusDetailsBin(const Http::HeaderMap& trailers) {
 
 Buffer::InstancePtr Common::serializeToGrpcFrame(const Protobuf::Message& message) {
   // http://www.grpc.io/docs/guides/wire.html
-  // Reserve enough space for the entire message and the 5 byte header.
-  // NB: we do not use prependGrpcFrameHeader because that would add another BufferFragment and this
-  // (using a single BufferFragment) is more efficient.
+  // The 5 byte header and the message are written straight into the body's slices, so large
+  // messages are neither serialized into one large allocation nor copied.
   Buffer::InstancePtr body(new Buffer::OwnedImpl());
   const uint32_t size = message.ByteSize();
-  const uint32_t alloc_size = size + 5;
-  auto reservation = body->reserveSingleSlice(alloc_size);
-  ASSERT(reservation.slice().len_ >= alloc_size);
-  uint8_t* current = reinterpret_cast<uint8_t*>(reservation.slice().mem_);
-  *current++ = 0; // flags
+  std::array<char, 5> header;
+  header[0] = 0; // flags
   const uint32_t nsize = htonl(size);
-  safeMemcpyUnsafeDst(current, &nsize);
-  current += sizeof(uint32_t);
-  Protobuf::io::ArrayOutputStream stream(current, size, -1);
-  Protobuf::io::CodedOutputStream codec_stream(&stream);
-  message.SerializeWithCachedSizes(&codec_stream);
-  reservation.commit(alloc_size);
+  safeMemcpyUnsafeDst(&header[1], &nsize);
+  {
+    Buffer::ZeroCopyOutputStreamImpl stream(*body, header.size() + size);
+    Protobuf::io::CodedOutputStream codec_stream(&stream);
+    codec_stream.WriteRaw(header.data(), header.size());
+    message.SerializeWithCachedSizes(&codec_stream);
+  }
   return body;
 }
 
 Buffer::InstancePtr Common::serializeMessage(const Protobuf::Message& message) {
   auto body = std::make_unique<Buffer::OwnedImpl>();
   const uint32_t size = message.ByteSize();
-  auto reservation = body->reserveSingleSlice(size);
-  ASSERT(reservation.slice().len_ >= size);
-  uint8_t* current = reinterpret_cast<uint8_t*>(reservation.slice().mem_);
-  Protobuf::io::ArrayOutputStream stream(current, size, -1);
-  Protobuf::io::CodedOutputStream codec_stream(&stream);
-  message.SerializeWithCachedSizes(&codec_stream);
-  reservation.commit(size);
+  {
+    Buffer::ZeroCopyOutputStreamImpl stream(*body, size);
+    Protobuf::io::CodedOutputStream codec_stream(&stream);
+    message.SerializeWithCachedSizes(&codec_stream);
+  }
   return body;
 }
 
@@ -10,6 +10,7 @@
 #include "source/common/grpc/common.h"
 #include "source/common/grpc/google_grpc_creds_impl.h"
 #include "source/common/grpc/google_grpc_utils.h"
+#include "source/common/protobuf/utility.h"
 #include "source/common/router/header_parser.h"
 #include "source/common/tracing/http_tracer_impl.h"
 
@@ -21,32 +22,18 @@ namespace {
 static constexpr int DefaultBufferLimitBytes = 1024 * 1024;
 }
 
-GoogleAsyncClientThreadLocal::GoogleAsyncClientThreadLocal(Api::Api& api)
+GoogleCompletionQueueThread::GoogleCompletionQueueThread(Api::Api& api)
     : completion_thread_(api.threadFactory().createThread([this] { completionThread(); },
                                                           Thread::Options{"GrpcGoogClient"})) {}
 
-GoogleAsyncClientThreadLocal::~GoogleAsyncClientThreadLocal() {
-  // Force streams to shutdown and invoke TryCancel() to start the drain of
-  // pending op. If we don't do this, Shutdown() below can jam on pending ops.
-  // This is also required to satisfy the contract that once Shutdown is called,
-  // streams no longer queue any additional tags.
-  for (auto it = streams_.begin(); it != streams_.end();) {
-    // resetStream() may result in immediate unregisterStream() and erase(),
-    // which would invalidate the iterator for the current element, so make sure
-    // we point to the next one first.
-    (*it++)->resetStream();
-  }
+GoogleCompletionQueueThread::~GoogleCompletionQueueThread() {
   cq_.Shutdown();
   ENVOY_LOG(debug, "Joining completionThread");
   completion_thread_->join();
   ENVOY_LOG(debug, "Joined completionThread");
-  // Ensure that we have cleaned up all orphan streams, now that CQ is gone.
-  while (!streams_.empty()) {
-    (*streams_.begin())->onCompletedOps();
-  }
 }
 
-void GoogleAsyncClientThreadLocal::completionThread() {
+void GoogleCompletionQueueThread::completionThread() {
   ENVOY_LOG(debug, "completionThread running");
   void* tag;
   bool ok;
@@ -66,30 +53,97 @@ void GoogleAsyncClientThreadLocal::completionThread() {
     // completionThread() at a high rate, consider bounding the length of such
     // sequences if this behavior becomes an issue.
     if (stream.completed_ops_.empty()) {
+      stream.completed_ops_queued_time_ = stream.dispatcher_.timeSource().monotonicTime();
       stream.dispatcher_.post([&stream] { stream.onCompletedOps(); });
     }
     stream.completed_ops_.emplace_back(op, ok);
+    // The stream, and so its silo, can't be freed before the lock is released.
+    stream.tls_.onCompletedOpsQueued();
   }
   ENVOY_LOG(debug, "completionThread exiting");
 }
 
+GoogleAsyncClientSharedState::GoogleAsyncClientSharedState(Api::Api& api,
+                                                           uint32_t completion_threads)
+    : api_(api) {
+  for (uint32_t i = 0; i < completion_threads; i++) {
+    completion_queue_threads_.push_back(std::make_shared<GoogleCompletionQueueThread>(api));
+  }
+}
+
+GoogleCompletionQueueThreadSharedPtr GoogleAsyncClientSharedState::completionQueueThread() {
+  if (completion_queue_threads_.empty()) {
+    return std::make_shared<GoogleCompletionQueueThread>(api_);
+  }
+  return completion_queue_threads_[next_completion_queue_thread_++ %
+                                   completion_queue_threads_.size()];
+}
+
+std::shared_ptr<grpc::Channel>
+GoogleAsyncClientSharedState::channel(const envoy::config::core::v3::GrpcService& config) {
+  const std::size_t key = MessageUtil::hash(config.google_grpc());
+  Thread::LockGuard lock(channels_lock_);
+  std::weak_ptr<grpc::Channel>& weak_channel = channels_[key];
+  std::shared_ptr<grpc::Channel> channel = weak_channel.lock();
+  if (channel == nullptr) {
+    // Forget the channels of the configs no longer used along the way.
+    absl::erase_if(channels_, [](const auto& entry) { return entry.second.expired(); });
+    channel = GoogleGrpcUtils::createChannel(config, api_);
+    channels_[key] = channel;
+  }
+  return channel;
+}
+
+GoogleAsyncClientThreadLocal::GoogleAsyncClientThreadLocal(
+    GoogleAsyncClientSharedStateSharedPtr shared_state)
+    : shared_state_(std::move(shared_state)),
+      completion_queue_thread_(shared_state_->completionQueueThread()) {}
+
+GoogleAsyncClientThreadLocal::~GoogleAsyncClientThreadLocal() {
+  // Force streams to shutdown and invoke TryCancel() to start the drain of
+  // pending op. This is required to satisfy the contract that once the silo is
+  // gone, streams no longer queue any additional tags.
+  for (auto it = streams_.begin(); it != streams_.end();) {
+    // resetStream() may result in immediate unregisterStream() and erase(),
+    // which would invalidate the iterator for the current element, so make sure
+    // we point to the next one first.
+    (*it++)->resetStream();
+  }
+  // The completion queue may be shared with other silos, so rather than shutting it down, wait for
+  // the cancelled ops of the orphan streams to complete and clean them up here.
+  ENVOY_LOG(debug, "Draining {} streams", streams_.size());
+  while (!streams_.empty()) {
+    {
+      Thread::LockGuard lock(completed_ops_queued_lock_);
+      while (!completed_ops_queued_) {
+        completed_ops_queued_cv_.wait(completed_ops_queued_lock_);
+      }
+      completed_ops_queued_ = false;
+    }
+    for (auto it = streams_.begin(); it != streams_.end();) {
+      (*it++)->onCompletedOps();
+    }
+  }
+  ENVOY_LOG(debug, "Drained streams");
+}
+
 GoogleAsyncClientImpl::GoogleAsyncClientImpl(Event::Dispatcher& dispatcher,
                                              GoogleAsyncClientThreadLocal& tls,
                                              GoogleStubFactory& stub_factory,
                                              Stats::ScopeSharedPtr scope,
                                              const envoy::config::core::v3::GrpcService& config,
-                                             Api::Api& api, const StatNames& stat_names)
+                                             const StatNames& stat_names)
     : dispatcher_(dispatcher), tls_(tls), stat_prefix_(config.google_grpc().stat_prefix()),
       scope_(scope),
       per_stream_buffer_limit_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
           config.google_grpc(), per_stream_buffer_limit_bytes, DefaultBufferLimitBytes)),
       metadata_parser_(
           Router::HeaderParser::configure(config.initial_metadata(), /*append=*/false)) {
-  // We rebuild the channel each time we construct the channel. It appears that the gRPC library is
-  // smart enough to do connection pooling and reuse with identical channel args, so this should
-  // have comparable overhead to what we are doing in Grpc::AsyncClientImpl, i.e. no expensive
-  // new connection implied.
-  std::shared_ptr<grpc::Channel> channel = GoogleGrpcUtils::createChannel(config, api);
+  // The clients of identical configs share their channel, on all the silos. The gRPC library also
+  // pools the connections of channels with identical channel args, so this should have comparable
+  // overhead to what we are doing in Grpc::AsyncClientImpl, i.e. no expensive new connection
+  // implied.
+  std::shared_ptr<grpc::Channel> channel = tls_.sharedState().channel(config);
   // Get state with try_to_connect = true to try connection at channel creation.
   // This is for initializing gRPC channel at channel creation. This GetState(true) is used to poke
   // the gRPC lb at channel creation, it doesn't have any effect no matter it succeeds or fails. But
@@ -105,6 +159,8 @@ GoogleAsyncClientImpl::GoogleAsyncClientImpl(Event::Dispatcher& dispatcher,
   for (uint32_t i = 0; i <= Status::WellKnownGrpcStatus::MaximumKnown; ++i) {
     stats_.streams_closed_[i] = &scope_->counterFromStatName(stat_names.streams_closed_[i]);
   }
+  stats_.completion_queue_latency_us_ = &scope_->histogramFromStatName(
+      stat_names.completion_queue_latency_us_, Stats::Histogram::Unit::Microseconds);
 }
 
 GoogleAsyncClientImpl::~GoogleAsyncClientImpl() {
@@ -262,12 +318,21 @@ void GoogleAsyncStreamImpl::onCompletedOps() {
   // both the post callback scheduled by the completionThread and the deferred deletion of the
   // GoogleAsyncClientThreadLocal happen on the dispatcher thread.
   std::deque<std::pair<GoogleAsyncTag::Operation, bool>> completed_ops;
+  MonotonicTime completed_ops_queued_time;
   {
     Thread::LockGuard lock(completed_ops_lock_);
     completed_ops = std::move(completed_ops_);
+    completed_ops_queued_time = completed_ops_queued_time_;
     // completed_ops_ should be empty after the move.
     ASSERT(completed_ops_.empty());
   }
+  // The client is only known to be alive until the stream is reset.
+  if (!draining_cq_ && !completed_ops.empty()) {
+    parent_.stats_.completion_queue_latency_us_->recordValue(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            dispatcher_.timeSource().monotonicTime() - completed_ops_queued_time)
+            .count());
+  }
 
   while (!completed_ops.empty()) {
     GoogleAsyncTag::Operation op;
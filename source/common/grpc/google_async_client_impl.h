@@ -1,10 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <queue>
+#include <vector>
 
 #include "envoy/api/api.h"
 #include "envoy/common/platform.h"
+#include "envoy/common/time.h"
 #include "envoy/config/core/v3/base.pb.h"
 #include "envoy/config/core/v3/grpc_service.pb.h"
 #include "envoy/grpc/async_client.h"
@@ -22,6 +25,7 @@
 #include "source/common/router/header_parser.h"
 #include "source/common/tracing/http_tracer_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_set.h"
 #include "grpcpp/generic/generic_stub.h"
 #include "grpcpp/grpcpp.h"
@@ -66,25 +70,15 @@ struct GoogleAsyncTag {
   const Operation op_;
 };
 
-class GoogleAsyncClientThreadLocal : public ThreadLocal::ThreadLocalObject,
-                                     Logger::Loggable<Logger::Id::grpc> {
+// A completion queue with the thread blocking on it. The completion thread delivers the events
+// of the queue to the dispatchers of their streams.
+class GoogleCompletionQueueThread : Logger::Loggable<Logger::Id::grpc> {
 public:
-  GoogleAsyncClientThreadLocal(Api::Api& api);
-  ~GoogleAsyncClientThreadLocal() override;
+  GoogleCompletionQueueThread(Api::Api& api);
+  ~GoogleCompletionQueueThread();
 
   grpc::CompletionQueue& completionQueue() { return cq_; }
 
-  void registerStream(GoogleAsyncStreamImpl* stream) {
-    ASSERT(streams_.find(stream) == streams_.end());
-    streams_.insert(stream);
-  }
-
-  void unregisterStream(GoogleAsyncStreamImpl* stream) {
-    auto it = streams_.find(stream);
-    ASSERT(it != streams_.end());
-    streams_.erase(it);
-  }
-
 private:
   void completionThread();
 
@@ -105,13 +99,79 @@ private:
   // blocking on a completion queue, cq_, on a distinct thread. When cq_ events
   // are delivered, we cross-post to the silo dispatcher to continue the
   // operation.
-  //
-  // We have an independent completion thread for each TLS silo (i.e. one per worker and
-  // also one for the main thread).
   Thread::ThreadPtr completion_thread_;
+};
+
+using GoogleCompletionQueueThreadSharedPtr = std::shared_ptr<GoogleCompletionQueueThread>;
+
+// The state shared by the Google gRPC clients of all the TLS silos: the completion queues of the
+// silos, and the channels of the clients.
+class GoogleAsyncClientSharedState {
+public:
+  // @param completion_threads the number of completion queues, each with its thread, shared round
+  //        robin by the silos. If 0, each silo gets a completion queue and thread of its own.
+  GoogleAsyncClientSharedState(Api::Api& api, uint32_t completion_threads);
+
+  // @return the completion queue thread of a new TLS silo.
+  GoogleCompletionQueueThreadSharedPtr completionQueueThread();
+
+  // @return the channel to the service of a config. The clients of identical Google gRPC configs
+  //         share a channel while any of them exists, whichever silo they are on.
+  std::shared_ptr<grpc::Channel> channel(const envoy::config::core::v3::GrpcService& config);
+
+private:
+  Api::Api& api_;
+  std::vector<GoogleCompletionQueueThreadSharedPtr> completion_queue_threads_;
+  std::atomic<uint32_t> next_completion_queue_thread_{};
+  Thread::MutexBasicLockable channels_lock_;
+  // The channels keyed by the hash of their Google gRPC config.
+  absl::flat_hash_map<std::size_t, std::weak_ptr<grpc::Channel>>
+      channels_ ABSL_GUARDED_BY(channels_lock_);
+};
+
+using GoogleAsyncClientSharedStateSharedPtr = std::shared_ptr<GoogleAsyncClientSharedState>;
+
+class GoogleAsyncClientThreadLocal : public ThreadLocal::ThreadLocalObject,
+                                     Logger::Loggable<Logger::Id::grpc> {
+public:
+  GoogleAsyncClientThreadLocal(GoogleAsyncClientSharedStateSharedPtr shared_state);
+  ~GoogleAsyncClientThreadLocal() override;
+
+  grpc::CompletionQueue& completionQueue() { return completion_queue_thread_->completionQueue(); }
+  GoogleAsyncClientSharedState& sharedState() { return *shared_state_; }
+
+  void registerStream(GoogleAsyncStreamImpl* stream) {
+    ASSERT(streams_.find(stream) == streams_.end());
+    streams_.insert(stream);
+  }
+
+  void unregisterStream(GoogleAsyncStreamImpl* stream) {
+    auto it = streams_.find(stream);
+    ASSERT(it != streams_.end());
+    streams_.erase(it);
+  }
+
+  // Called by the completion thread when it queues completed ops for one of the streams, under the
+  // lock of the stream's completed ops.
+  void onCompletedOpsQueued() {
+    Thread::LockGuard lock(completed_ops_queued_lock_);
+    completed_ops_queued_ = true;
+    completed_ops_queued_cv_.notifyAll();
+  }
+
+private:
+  GoogleAsyncClientSharedStateSharedPtr shared_state_;
+  // The completion queue of the streams of this silo. Unless the completion queue threads are
+  // shared, this is the only reference to its thread. Either way, the streams are drained on
+  // destruction, so that the thread no longer delivers events of this silo.
+  GoogleCompletionQueueThreadSharedPtr completion_queue_thread_;
   // Track all streams that are currently using this CQ, so we can notify them
   // on shutdown.
   absl::node_hash_set<GoogleAsyncStreamImpl*> streams_;
+  // Whether the completion thread queued completed ops since the streams were last drained.
+  bool completed_ops_queued_ ABSL_GUARDED_BY(completed_ops_queued_lock_){};
+  Thread::MutexBasicLockable completed_ops_queued_lock_;
+  Thread::CondVar completed_ops_queued_cv_;
 };
 
 using GoogleAsyncClientThreadLocalPtr = std::unique_ptr<GoogleAsyncClientThreadLocal>;
@@ -123,6 +183,8 @@ struct GoogleAsyncClientStats {
   Stats::Counter* streams_total_;
   // .streams_closed_<gRPC status code>
   std::array<Stats::Counter*, Status::WellKnownGrpcStatus::MaximumKnown + 1> streams_closed_;
+  // .completion_queue_latency_us
+  Stats::Histogram* completion_queue_latency_us_;
 };
 
 // Interface to allow the gRPC stub to be mocked out by tests.
@@ -173,7 +235,7 @@ class GoogleAsyncClientImpl final : public RawAsyncClient, Logger::Loggable<Logg
 public:
   GoogleAsyncClientImpl(Event::Dispatcher& dispatcher, GoogleAsyncClientThreadLocal& tls,
                         GoogleStubFactory& stub_factory, Stats::ScopeSharedPtr scope,
-                        const envoy::config::core::v3::GrpcService& config, Api::Api& api,
+                        const envoy::config::core::v3::GrpcService& config,
                         const StatNames& stat_names);
   ~GoogleAsyncClientImpl() override;
 
@@ -222,6 +284,10 @@ public:
 
   // Grpc::RawAsyncStream
   void sendMessageRaw(Buffer::InstancePtr&& request, bool end_stream) override;
+  // The messages are compressed by the library instead.
+  void sendCompressedMessageRaw(Buffer::InstancePtr&&, bool) override {
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+  }
   void closeStream() override;
   void resetStream() override;
   // While the Google-gRPC code doesn't use Envoy watermark buffers, the logical
@@ -239,7 +305,7 @@ private:
   // GoogleAsyncClient silo thread.
   void onCompletedOps();
   // Handle Operation completion on GoogleAsyncClient silo thread. This is posted by
-  // GoogleAsyncClientThreadLocal::completionThread() when a message is received on cq_.
+  // GoogleCompletionQueueThread::completionThread() when a message is received on its cq_.
   void handleOpCompletion(GoogleAsyncTag::Operation op, bool ok);
   // Convert from Google gRPC client std::multimap metadata to Envoy Http::HeaderMap.
   void metadataTranslate(const std::multimap<grpc::string_ref, grpc::string_ref>& grpc_metadata,
@@ -311,10 +377,13 @@ private:
   // handleOpCompletion().
   std::deque<std::pair<GoogleAsyncTag::Operation, bool>>
       completed_ops_ ABSL_GUARDED_BY(completed_ops_lock_);
+  // When the completion thread queued the first of completed_ops_.
+  MonotonicTime completed_ops_queued_time_ ABSL_GUARDED_BY(completed_ops_lock_);
   Thread::MutexBasicLockable completed_ops_lock_;
 
   friend class GoogleAsyncClientImpl;
   friend class GoogleAsyncClientThreadLocal;
+  friend class GoogleCompletionQueueThread;
 };
 
 class GoogleAsyncRequestImpl : public AsyncRequest,
@@ -23,6 +23,9 @@ struct StatNames {
   absl::flat_hash_map<std::string, Stats::StatName> status_names_;
   // Stat name tracking the creation of the Google grpc client.
   Stats::StatName google_grpc_client_creation_;
+  // Stat name of the latency of the Google grpc client completion queue events, from their
+  // completion thread to the dispatcher of their stream.
+  Stats::StatName completion_queue_latency_us_;
 };
 
 } // namespace Grpc
@@ -1,12 +1,144 @@
 #include "source/common/http/alternate_protocols_cache_impl.h"
 
+#include <cstdio>
+#include <functional>
+#include <thread>
+
+#include "envoy/common/exception.h"
+
 #include "source/common/common/logger.h"
+#include "source/common/common/thread.h"
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
 
 namespace Envoy {
 namespace Http {
+namespace {
+
+// The weight of a new connect time in the smoothed connect time of an origin, as for the smoothed
+// RTT of TCP.
+constexpr int64_t ConnectTimeSmoothingFactor = 8;
+// The success and failure counts of an origin are halved when they add up to this, so that they
+// reflect the recent attempts.
+constexpr uint32_t MaxRecordedAttempts = 32;
+
+// Whether a field of an entry can be serialized, as the entries are split on these characters.
+bool isSerializable(absl::string_view field) {
+  return field.find_first_of("|;, \n") == absl::string_view::npos;
+}
+
+} // namespace
 
-AlternateProtocolsCacheImpl::AlternateProtocolsCacheImpl(TimeSource& time_source)
-    : time_source_(time_source) {}
+AlternateProtocolsCacheFile::AlternateProtocolsCacheFile(Filesystem::Instance& file_system,
+                                                         const std::string& path)
+    : file_system_(file_system), path_(path) {
+  if (!file_system_.fileExists(path_)) {
+    return;
+  }
+  std::string contents;
+  TRY_NEEDS_AUDIT { contents = file_system_.fileReadToEnd(path_); }
+  catch (const EnvoyException& e) {
+    ENVOY_LOG(warn, "unable to read the alternate protocols cache from {}: {}", path_, e.what());
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  for (absl::string_view line : absl::StrSplit(contents, '\n', absl::SkipEmpty())) {
+    std::pair<absl::string_view, absl::string_view> key_and_entry =
+        absl::StrSplit(line, absl::MaxSplits(' ', 1));
+    if (!key_and_entry.second.empty()) {
+      entries_.emplace(key_and_entry.first, key_and_entry.second);
+    }
+  }
+}
+
+AlternateProtocolsCacheFile::~AlternateProtocolsCacheFile() { flush(); }
+
+absl::flat_hash_map<std::string, std::string> AlternateProtocolsCacheFile::entries() const {
+  absl::MutexLock lock(&mutex_);
+  return entries_;
+}
+
+void AlternateProtocolsCacheFile::update(const std::string& key, std::string entry) {
+  absl::MutexLock lock(&mutex_);
+  if (entry.empty()) {
+    dirty_ |= entries_.erase(key) > 0;
+    return;
+  }
+  std::string& existing_entry = entries_[key];
+  if (existing_entry != entry) {
+    existing_entry = std::move(entry);
+    dirty_ = true;
+  }
+}
+
+void AlternateProtocolsCacheFile::flush() {
+  std::string contents;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!dirty_) {
+      return;
+    }
+    dirty_ = false;
+    for (const auto& entry : entries_) {
+      absl::StrAppend(&contents, entry.first, " ", entry.second, "\n");
+    }
+  }
+
+  // The caches of several workers may flush at once, so each writes its own temporary file before
+  // replacing the file with it.
+  const std::string temporary_path =
+      absl::StrCat(path_, ".tmp.", std::hash<std::thread::id>()(std::this_thread::get_id()));
+  // Files are opened without truncation, so start from an empty temporary file.
+  std::remove(temporary_path.c_str());
+  Filesystem::FilePtr file = file_system_.createFile(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, temporary_path});
+  static constexpr Filesystem::FlagSet flags{1 << Filesystem::File::Operation::Write |
+                                             1 << Filesystem::File::Operation::Create};
+  const Api::IoCallBoolResult open_result = file->open(flags);
+  if (!open_result.rc_) {
+    ENVOY_LOG(warn, "unable to open {} to save the alternate protocols cache: {}", temporary_path,
+              open_result.err_->getErrorDetails());
+    return;
+  }
+  const Api::IoCallSizeResult write_result = file->write(contents);
+  const Api::IoCallBoolResult close_result = file->close();
+  if (write_result.rc_ != static_cast<ssize_t>(contents.size()) || !close_result.rc_) {
+    ENVOY_LOG(warn, "unable to save the alternate protocols cache to {}", temporary_path);
+    std::remove(temporary_path.c_str());
+    return;
+  }
+  if (std::rename(temporary_path.c_str(), path_.c_str()) != 0) {
+    ENVOY_LOG(warn, "unable to replace the alternate protocols cache in {}", path_);
+    std::remove(temporary_path.c_str());
+  }
+}
+
+AlternateProtocolsCacheImpl::AlternateProtocolsCacheImpl(TimeSource& time_source,
+                                                         AlternateProtocolsCacheFileSharedPtr file)
+    : time_source_(time_source), file_(std::move(file)) {
+  if (file_ == nullptr) {
+    return;
+  }
+  for (const auto& entry : file_->entries()) {
+    absl::optional<Origin> origin;
+    std::vector<AlternateProtocol> protocols;
+    absl::optional<OriginStats> stats;
+    if (!parseEntry(entry.first, entry.second, time_source_, origin, protocols, stats)) {
+      ENVOY_LOG_MISC(debug, "ignoring invalid alternate protocols cache entry for '{}'",
+                     entry.first);
+      continue;
+    }
+    if (!protocols.empty()) {
+      protocols_.emplace(origin.value(), std::move(protocols));
+    }
+    if (stats.has_value()) {
+      stats_.emplace(origin.value(), stats.value());
+    }
+  }
+}
 
 AlternateProtocolsCacheImpl::~AlternateProtocolsCacheImpl() = default;
 
@@ -19,6 +151,7 @@ void AlternateProtocolsCacheImpl::setAlternatives(const Origin& origin,
     std::vector<AlternateProtocol>& p = protocols_[origin];
     p.erase(p.begin() + max_protocols, p.end());
   }
+  save(origin);
 }
 
 OptRef<const std::vector<AlternateProtocolsCache::AlternateProtocol>>
@@ -39,13 +172,141 @@ AlternateProtocolsCacheImpl::findAlternatives(const Origin& origin) {
 
   if (protocols.empty()) {
     protocols_.erase(entry_it);
+    save(origin);
     return makeOptRefFromPtr<const std::vector<AlternateProtocol>>(nullptr);
   }
 
   return makeOptRef(const_cast<const std::vector<AlternateProtocol>&>(protocols));
 }
 
+void AlternateProtocolsCacheImpl::recordHttp3Attempt(const Origin& origin, bool succeeded,
+                                                     std::chrono::microseconds connect_time) {
+  OriginStats& stats = stats_[origin];
+  if (stats.http3_successes_ + stats.http3_failures_ >= MaxRecordedAttempts) {
+    stats.http3_successes_ /= 2;
+    stats.http3_failures_ /= 2;
+  }
+  if (!succeeded) {
+    ++stats.http3_failures_;
+  } else {
+    ++stats.http3_successes_;
+    if (stats.http3_connect_time_.count() == 0) {
+      stats.http3_connect_time_ = connect_time;
+    } else {
+      stats.http3_connect_time_ +=
+          (connect_time - stats.http3_connect_time_) / ConnectTimeSmoothingFactor;
+    }
+  }
+  save(origin);
+}
+
+absl::optional<AlternateProtocolsCache::OriginStats>
+AlternateProtocolsCacheImpl::findStats(const Origin& origin) {
+  auto entry_it = stats_.find(origin);
+  if (entry_it == stats_.end()) {
+    return absl::nullopt;
+  }
+  return entry_it->second;
+}
+
 size_t AlternateProtocolsCacheImpl::size() const { return protocols_.size(); }
 
+void AlternateProtocolsCacheImpl::save(const Origin& origin) {
+  if (file_ == nullptr) {
+    return;
+  }
+  auto protocols_it = protocols_.find(origin);
+  auto stats_it = stats_.find(origin);
+  file_->update(originKey(origin),
+                serializeEntry(protocols_it != protocols_.end() ? &protocols_it->second : nullptr,
+                               stats_it != stats_.end() ? &stats_it->second : nullptr,
+                               time_source_));
+}
+
+std::string AlternateProtocolsCacheImpl::originKey(const Origin& origin) {
+  return absl::StrCat(origin.scheme_, "|", origin.hostname_, "|", origin.port_);
+}
+
+// An entry is "<connect time us>|<successes>|<failures>|<protocols>", the protocols being separated
+// by ';', each of them "<alpn>,<hostname>,<port>,<expiration in seconds since the epoch>". The
+// stats are empty if unknown.
+std::string AlternateProtocolsCacheImpl::serializeEntry(
+    const std::vector<AlternateProtocol>* protocols, const OriginStats* stats,
+    TimeSource& time_source) {
+  std::vector<std::string> serialized_protocols;
+  if (protocols != nullptr) {
+    const MonotonicTime now = time_source.monotonicTime();
+    const SystemTime system_now = time_source.systemTime();
+    for (const AlternateProtocol& protocol : *protocols) {
+      if (protocol.expiration_ < now || !isSerializable(protocol.alpn_) ||
+          !isSerializable(protocol.hostname_)) {
+        continue;
+      }
+      const int64_t expiration = std::chrono::duration_cast<std::chrono::seconds>(
+                                     (system_now + (protocol.expiration_ - now)).time_since_epoch())
+                                     .count();
+      serialized_protocols.push_back(absl::StrCat(protocol.alpn_, ",", protocol.hostname_, ",",
+                                                  protocol.port_, ",", expiration));
+    }
+  }
+  if (serialized_protocols.empty() && stats == nullptr) {
+    return "";
+  }
+  if (stats == nullptr) {
+    return absl::StrCat("|||", absl::StrJoin(serialized_protocols, ";"));
+  }
+  return absl::StrCat(stats->http3_connect_time_.count(), "|", stats->http3_successes_, "|",
+                      stats->http3_failures_, "|", absl::StrJoin(serialized_protocols, ";"));
+}
+
+bool AlternateProtocolsCacheImpl::parseEntry(absl::string_view key, absl::string_view entry,
+                                             TimeSource& time_source,
+                                             absl::optional<Origin>& origin,
+                                             std::vector<AlternateProtocol>& protocols,
+                                             absl::optional<OriginStats>& stats) {
+  const std::vector<absl::string_view> key_fields = absl::StrSplit(key, '|');
+  uint32_t port;
+  if (key_fields.size() != 3 || !absl::SimpleAtoi(key_fields[2], &port)) {
+    return false;
+  }
+  origin.emplace(key_fields[0], key_fields[1], port);
+
+  const std::vector<absl::string_view> fields = absl::StrSplit(entry, '|');
+  if (fields.size() != 4) {
+    return false;
+  }
+  if (!fields[0].empty()) {
+    int64_t connect_time;
+    OriginStats parsed_stats;
+    if (!absl::SimpleAtoi(fields[0], &connect_time) ||
+        !absl::SimpleAtoi(fields[1], &parsed_stats.http3_successes_) ||
+        !absl::SimpleAtoi(fields[2], &parsed_stats.http3_failures_)) {
+      return false;
+    }
+    parsed_stats.http3_connect_time_ = std::chrono::microseconds(connect_time);
+    stats = parsed_stats;
+  }
+
+  const MonotonicTime now = time_source.monotonicTime();
+  const int64_t system_now = std::chrono::duration_cast<std::chrono::seconds>(
+                                 time_source.systemTime().time_since_epoch())
+                                 .count();
+  for (absl::string_view protocol : absl::StrSplit(fields[3], ';', absl::SkipEmpty())) {
+    const std::vector<absl::string_view> protocol_fields = absl::StrSplit(protocol, ',');
+    uint32_t protocol_port;
+    int64_t expiration;
+    if (protocol_fields.size() != 4 || !absl::SimpleAtoi(protocol_fields[2], &protocol_port) ||
+        !absl::SimpleAtoi(protocol_fields[3], &expiration)) {
+      return false;
+    }
+    if (expiration <= system_now) {
+      continue;
+    }
+    protocols.emplace_back(protocol_fields[0], protocol_fields[1], protocol_port,
+                           now + std::chrono::seconds(expiration - system_now));
+  }
+  return true;
+}
+
 } // namespace Http
 } // namespace Envoy
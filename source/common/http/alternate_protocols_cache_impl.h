@@ -1,39 +1,100 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
 
 #include "envoy/common/optref.h"
 #include "envoy/common/time.h"
+#include "envoy/filesystem/filesystem.h"
 #include "envoy/http/alternate_protocols_cache.h"
 
+#include "source/common/common/logger.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Http {
 
+/**
+ * The entries of the alternate protocols caches of a name, shared by the caches of all the workers
+ * and saved to a file so that they survive restarts. Each entry is the serialized state of an
+ * origin, by the key of the origin. Thread safe.
+ */
+class AlternateProtocolsCacheFile : Logger::Loggable<Logger::Id::upstream> {
+public:
+  // Loads the entries saved to the file, if any.
+  AlternateProtocolsCacheFile(Filesystem::Instance& file_system, const std::string& path);
+  ~AlternateProtocolsCacheFile();
+
+  // Returns all the entries.
+  absl::flat_hash_map<std::string, std::string> entries() const;
+
+  // Sets the entry of a key, or removes it if entry is empty.
+  void update(const std::string& key, std::string entry);
+
+  // Saves the entries to the file, if they changed since they were last saved.
+  void flush();
+
+private:
+  Filesystem::Instance& file_system_;
+  const std::string path_;
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::string> entries_ ABSL_GUARDED_BY(mutex_);
+  bool dirty_ ABSL_GUARDED_BY(mutex_){};
+};
+
+using AlternateProtocolsCacheFileSharedPtr = std::shared_ptr<AlternateProtocolsCacheFile>;
+
 // An implementation of AlternateProtocolsCache.
 // See: source/docs/http3_upstream.md
 class AlternateProtocolsCacheImpl : public AlternateProtocolsCache {
 public:
-  explicit AlternateProtocolsCacheImpl(TimeSource& time_source);
+  // If file is set, the cache is seeded from it and saves its changes to it.
+  explicit AlternateProtocolsCacheImpl(TimeSource& time_source,
+                                       AlternateProtocolsCacheFileSharedPtr file = nullptr);
   ~AlternateProtocolsCacheImpl() override;
 
   // AlternateProtocolsCache
   void setAlternatives(const Origin& origin,
                        const std::vector<AlternateProtocol>& protocols) override;
   OptRef<const std::vector<AlternateProtocol>> findAlternatives(const Origin& origin) override;
+  void recordHttp3Attempt(const Origin& origin, bool succeeded,
+                          std::chrono::microseconds connect_time) override;
+  absl::optional<OriginStats> findStats(const Origin& origin) override;
   size_t size() const override;
 
+  // Serializes the state of an origin for the cache file, with the expiration of its protocols as
+  // a system time. Returns an empty string if nothing is known of the origin.
+  static std::string serializeEntry(const std::vector<AlternateProtocol>* protocols,
+                                    const OriginStats* stats, TimeSource& time_source);
+  // Parses an entry of the cache file, setting origin, protocols and stats. The protocols which
+  // expired are skipped. Returns false if the entry is invalid.
+  static bool parseEntry(absl::string_view key, absl::string_view entry, TimeSource& time_source,
+                         absl::optional<Origin>& origin, std::vector<AlternateProtocol>& protocols,
+                         absl::optional<OriginStats>& stats);
+  static std::string originKey(const Origin& origin);
+
 private:
+  // Saves the state of an origin to the cache file, if any.
+  void save(const Origin& origin);
+
   // Time source used to check expiration of entries.
   TimeSource& time_source_;
 
   // Map from hostname to list of alternate protocols.
   // TODO(RyanTheOptimist): Add a limit to the size of this map and evict based on usage.
   std::map<Origin, std::vector<AlternateProtocol>> protocols_;
+
+  // What was learned of the HTTP/3 connection attempts to the origins.
+  std::map<Origin, OriginStats> stats_;
+
+  const AlternateProtocolsCacheFileSharedPtr file_;
 };
 
 } // namespace Http
@@ -2,6 +2,7 @@
 
 #include "source/common/http/alternate_protocols_cache_impl.h"
 #include "source/common/protobuf/protobuf.h"
+#include "source/common/protobuf/utility.h"
 
 #include "absl/container/flat_hash_map.h"
 
@@ -11,9 +12,9 @@ namespace Http {
 SINGLETON_MANAGER_REGISTRATION(alternate_protocols_cache_manager);
 
 AlternateProtocolsCacheManagerImpl::AlternateProtocolsCacheManagerImpl(
-    TimeSource& time_source, ThreadLocal::SlotAllocator& tls)
-    : time_source_(time_source), slot_(tls) {
-  slot_.set([](Event::Dispatcher& /*dispatcher*/) { return std::make_shared<State>(); });
+    TimeSource& time_source, ThreadLocal::SlotAllocator& tls, Filesystem::Instance& file_system)
+    : time_source_(time_source), file_system_(file_system), slot_(tls) {
+  slot_.set([](Event::Dispatcher& dispatcher) { return std::make_shared<State>(dispatcher); });
 }
 
 AlternateProtocolsCacheSharedPtr AlternateProtocolsCacheManagerImpl::getCache(
@@ -30,16 +31,44 @@ AlternateProtocolsCacheSharedPtr AlternateProtocolsCacheManagerImpl::getCache(
     return existing_cache->second.cache_;
   }
 
+  AlternateProtocolsCacheFileSharedPtr file = getFile(options);
   AlternateProtocolsCacheSharedPtr new_cache =
-      std::make_shared<AlternateProtocolsCacheImpl>(time_source_);
-  (*slot_).caches_.emplace(options.name(), CacheWithOptions{options, new_cache});
+      std::make_shared<AlternateProtocolsCacheImpl>(time_source_, file);
+  CacheWithOptions& cache_with_options =
+      (*slot_).caches_.emplace(options.name(), CacheWithOptions{options, new_cache}).first->second;
+  if (file != nullptr) {
+    const std::chrono::milliseconds flush_interval(
+        PROTOBUF_GET_MS_OR_DEFAULT(options, persistence_flush_interval, 10000));
+    cache_with_options.flush_timer_ = (*slot_).dispatcher_.createTimer(
+        [this, name = options.name(), file, flush_interval]() {
+          file->flush();
+          (*slot_).caches_.at(name).flush_timer_->enableTimer(flush_interval);
+        });
+    cache_with_options.flush_timer_->enableTimer(flush_interval);
+  }
   return new_cache;
 }
 
+AlternateProtocolsCacheFileSharedPtr AlternateProtocolsCacheManagerImpl::getFile(
+    const envoy::config::core::v3::AlternateProtocolsCacheOptions& options) {
+  if (options.persistence_path().empty()) {
+    return nullptr;
+  }
+  absl::MutexLock lock(&files_mutex_);
+  AlternateProtocolsCacheFileSharedPtr& file = files_[options.name()];
+  if (file == nullptr) {
+    file = std::make_shared<AlternateProtocolsCacheFile>(file_system_, options.persistence_path());
+  }
+  return file;
+}
+
 AlternateProtocolsCacheManagerSharedPtr AlternateProtocolsCacheManagerFactoryImpl::get() {
   return singleton_manager_.getTyped<AlternateProtocolsCacheManager>(
       SINGLETON_MANAGER_REGISTERED_NAME(alternate_protocols_cache_manager),
-      [this] { return std::make_shared<AlternateProtocolsCacheManagerImpl>(time_source_, tls_); });
+      [this] {
+        return std::make_shared<AlternateProtocolsCacheManagerImpl>(time_source_, tls_,
+                                                                    file_system_);
+      });
 }
 
 } // namespace Http
@@ -1,12 +1,19 @@
 #pragma once
 
 #include "envoy/config/core/v3/protocol.pb.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/filesystem/filesystem.h"
 #include "envoy/http/alternate_protocols_cache.h"
 #include "envoy/singleton/instance.h"
 #include "envoy/singleton/manager.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "source/common/http/alternate_protocols_cache_impl.h"
+
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Http {
@@ -14,7 +21,8 @@ namespace Http {
 class AlternateProtocolsCacheManagerImpl : public AlternateProtocolsCacheManager,
                                            public Singleton::Instance {
 public:
-  AlternateProtocolsCacheManagerImpl(TimeSource& time_source, ThreadLocal::SlotAllocator& tls);
+  AlternateProtocolsCacheManagerImpl(TimeSource& time_source, ThreadLocal::SlotAllocator& tls,
+                                     Filesystem::Instance& file_system);
 
   // AlternateProtocolsCacheManager
   AlternateProtocolsCacheSharedPtr
@@ -29,15 +37,30 @@ private:
 
     const envoy::config::core::v3::AlternateProtocolsCacheOptions options_;
     AlternateProtocolsCacheSharedPtr cache_;
+    // Saves the cache to its file periodically, if it's persisted.
+    Event::TimerPtr flush_timer_;
   };
 
   // Per-thread state.
   struct State : public ThreadLocal::ThreadLocalObject {
+    explicit State(Event::Dispatcher& dispatcher) : dispatcher_(dispatcher) {}
+
+    Event::Dispatcher& dispatcher_;
     // Map from config name to cache for that config.
     absl::flat_hash_map<std::string, CacheWithOptions> caches_;
   };
 
+  // Returns the file shared by the caches of a name on all the threads.
+  AlternateProtocolsCacheFileSharedPtr
+  getFile(const envoy::config::core::v3::AlternateProtocolsCacheOptions& options);
+
   TimeSource& time_source_;
+  Filesystem::Instance& file_system_;
+
+  absl::Mutex files_mutex_;
+  // Map from config name to the file of the caches of that config, if persisted.
+  absl::flat_hash_map<std::string, AlternateProtocolsCacheFileSharedPtr>
+      files_ ABSL_GUARDED_BY(files_mutex_);
 
   // Thread local state for the cache.
   ThreadLocal::TypedSlot<State> slot_;
@@ -47,8 +70,10 @@ class AlternateProtocolsCacheManagerFactoryImpl : public AlternateProtocolsCache
 public:
   AlternateProtocolsCacheManagerFactoryImpl(Singleton::Manager& singleton_manager,
                                             TimeSource& time_source,
-                                            ThreadLocal::SlotAllocator& tls)
-      : singleton_manager_(singleton_manager), time_source_(time_source), tls_(tls) {}
+                                            ThreadLocal::SlotAllocator& tls,
+                                            Filesystem::Instance& file_system)
+      : singleton_manager_(singleton_manager), time_source_(time_source), tls_(tls),
+        file_system_(file_system) {}
 
   AlternateProtocolsCacheManagerSharedPtr get() override;
 
@@ -56,6 +81,7 @@ private:
   Singleton::Manager& singleton_manager_;
   TimeSource& time_source_;
   ThreadLocal::SlotAllocator& tls_;
+  Filesystem::Instance& file_system_;
 };
 
 } // namespace Http
@@ -106,6 +106,7 @@ private:
       return additional_request_chance_;
     }
     bool hedgeOnPerTryTimeout() const override { return false; }
+    const Router::LatencyHedgeSettings* latencyHedge() const override { return nullptr; }
 
     const envoy::type::v3::FractionalPercent additional_request_chance_;
   };
@@ -189,7 +190,7 @@ private:
     Stats::StatName statName() const override { return {}; }
     const Router::RateLimitPolicy& rateLimitPolicy() const override { return rate_limit_policy_; }
     const Router::CorsPolicy* corsPolicy() const override { return nullptr; }
-    const Router::Config& routeConfig() const override { return route_configuration_; }
+    const Router::CommonConfig& routeConfig() const override { return route_configuration_; }
     const Router::RouteSpecificFilterConfig* perFilterConfig(const std::string&) const override {
       return nullptr;
     }
@@ -242,6 +243,7 @@ private:
     Upstream::ResourcePriority priority() const override {
       return Upstream::ResourcePriority::Default;
     }
+    uint32_t queuePriority() const override { return 0; }
     const Router::RateLimitPolicy& rateLimitPolicy() const override { return rate_limit_policy_; }
     const Router::RetryPolicy& retryPolicy() const override { return retry_policy_; }
     const Router::InternalRedirectPolicy& internalRedirectPolicy() const override {
@@ -435,6 +437,8 @@ private:
     NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
   }
   void resetIdleTimer() override { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+  // The router is the only filter, so there is no iteration to take it out of.
+  void skipRemainingCallbacks() override {}
 
   // ScopeTrackedObject
   void dumpState(std::ostream& os, int indent_level) const override {
@@ -101,6 +101,8 @@ ConnectionManagerImpl::ConnectionManagerImpl(ConnectionManagerConfig& config,
           overload_state_.getState(Server::OverloadActionNames::get().StopAcceptingRequests)),
       overload_disable_keepalive_ref_(
           overload_state_.getState(Server::OverloadActionNames::get().DisableHttpKeepAlive)),
+      overload_shed_tracing_ref_(
+          overload_state_.getState(Server::LoadShedPointNames::get().HttpTracing)),
       time_source_(time_source),
       enable_internal_redirects_with_body_(Runtime::runtimeFeatureEnabled(
           "envoy.reloadable_features.internal_redirects_with_body")) {}
@@ -257,12 +259,21 @@ void ConnectionManagerImpl::doDeferredStreamDestroy(ActiveStream& stream) {
   stream.filter_manager_.log();
 
   stream.filter_manager_.destroyFilters();
+  const Buffer::BufferMemoryAccountSharedPtr account = stream.filter_manager_.account();
+  if (account != nullptr) {
+    // The stream is no longer reset under memory pressure.
+    account->clearDownstream();
+  }
 
   read_callbacks_->connection().dispatcher().deferredDelete(stream.removeFromList(streams_));
 
   if (connection_idle_timer_ && streams_.empty()) {
     connection_idle_timer_->enableTimer(config_.idleTimeout().value());
   }
+  if (idle_connection_state_ != nullptr && streams_.empty() &&
+      drain_state_ == DrainState::NotDraining) {
+    idle_connection_state_->setIdleSince(time_source_.monotonicTime());
+  }
 }
 
 RequestDecoder& ConnectionManagerImpl::newStream(ResponseEncoder& response_encoder,
@@ -275,10 +286,13 @@ RequestDecoder& ConnectionManagerImpl::newStream(ResponseEncoder& response_encod
 
   // Set the account to start accounting if enabled. This is still a
   // work-in-progress, and will be removed when other features using the
-  // accounting are implemented.
+  // accounting are implemented. The dispatcher's buffer factory tracks the
+  // account, to reset the stream if it uses too much memory under pressure.
   Buffer::BufferMemoryAccountSharedPtr downstream_request_account;
   if (Runtime::runtimeFeatureEnabled("envoy.test_only.per_stream_buffer_accounting")) {
-    downstream_request_account = std::make_shared<Buffer::BufferMemoryAccountImpl>();
+    downstream_request_account =
+        read_callbacks_->connection().dispatcher().getWatermarkFactory().createAccount(
+            response_encoder.getStream());
     response_encoder.getStream().setAccount(downstream_request_account);
   }
   ActiveStreamPtr new_stream(new ActiveStream(*this, response_encoder.getStream().bufferLimit(),
@@ -325,6 +339,16 @@ void ConnectionManagerImpl::createCodec(Buffer::Instance& data) {
   case Protocol::Http10:
     stats_.named_.downstream_cx_http1_total_.inc();
     stats_.named_.downstream_cx_http1_active_.inc();
+    if (read_callbacks_->connection().ssl() == nullptr &&
+        Runtime::runtimeFeatureEnabled(
+            "envoy.reloadable_features.hot_restart_connection_handoff")) {
+      auto idle_connection_state = std::make_unique<Network::IdleConnectionState>();
+      idle_connection_state_ = idle_connection_state.get();
+      read_callbacks_->connection().streamInfo().filterState()->setData(
+          Network::IdleConnectionState::key(), std::move(idle_connection_state),
+          StreamInfo::FilterState::StateType::Mutable,
+          StreamInfo::FilterState::LifeSpan::Connection);
+    }
     break;
   }
 }
@@ -334,6 +358,9 @@ Network::FilterStatus ConnectionManagerImpl::onData(Buffer::Instance& data, bool
     // Http3 codec should have been instantiated by now.
     createCodec(data);
   }
+  if (idle_connection_state_ != nullptr) {
+    idle_connection_state_->setIdleSince(absl::nullopt);
+  }
 
   bool redispatch;
   do {
@@ -1050,8 +1077,10 @@ void ConnectionManagerImpl::ActiveStream::decodeHeaders(RequestHeaderMapPtr&& he
     }
   }
 
-  // Check if tracing is enabled at all.
-  if (connection_manager_.config_.tracingConfig()) {
+  // Check if tracing is enabled at all, and not shed under overload.
+  if (connection_manager_.config_.tracingConfig() &&
+      !connection_manager_.random_generator_.bernoulli(
+          connection_manager_.overload_shed_tracing_ref_.value())) {
     traceRequest();
   }
 
@@ -1511,6 +1540,9 @@ void ConnectionManagerImpl::ActiveStream::onResetStream(StreamResetReason reset_
   if (!encoder_details.empty() && reset_reason == StreamResetReason::LocalReset) {
     filter_manager_.streamInfo().setResponseFlag(StreamInfo::ResponseFlag::DownstreamProtocolError);
   }
+  if (reset_reason == StreamResetReason::OverloadManager) {
+    filter_manager_.streamInfo().setResponseFlag(StreamInfo::ResponseFlag::OverloadManager);
+  }
   if (!encoder_details.empty()) {
     filter_manager_.streamInfo().setResponseCodeDetails(encoder_details);
   }
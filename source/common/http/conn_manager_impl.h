@@ -44,6 +44,7 @@
 #include "source/common/http/user_agent.h"
 #include "source/common/http/utility.h"
 #include "source/common/local_reply/local_reply.h"
+#include "source/common/network/idle_connection_state.h"
 #include "source/common/network/proxy_protocol_filter_state.h"
 #include "source/common/router/scoped_rds.h"
 #include "source/common/stream_info/stream_info_impl.h"
@@ -434,6 +435,9 @@ private:
   // connection. When there are active streams it is disarmed in favor of each stream's
   // stream_idle_timer_.
   Event::TimerPtr connection_idle_timer_;
+  // Lets the plaintext HTTP/1 connections be handed off to another process while they are idle
+  // between requests, only set if the hand off is enabled.
+  Network::IdleConnectionState* idle_connection_state_{};
   // A connection duration timer. Armed during handling new connection if enabled in config.
   Event::TimerPtr connection_duration_timer_;
   Event::TimerPtr drain_timer_;
@@ -449,6 +453,7 @@ private:
   // map lookup in the hot path of processing each request.
   const Server::OverloadActionState& overload_stop_accepting_requests_ref_;
   const Server::OverloadActionState& overload_disable_keepalive_ref_;
+  const Server::OverloadActionState& overload_shed_tracing_ref_;
   TimeSource& time_source_;
   bool remote_close_{};
   bool enable_internal_redirects_with_body_{};
@@ -7,6 +7,7 @@
 #include "envoy/type/v3/percent.pb.h"
 
 #include "source/common/common/empty_string.h"
+#include "source/common/common/macros.h"
 #include "source/common/common/utility.h"
 #include "source/common/http/conn_manager_config.h"
 #include "source/common/http/header_utility.h"
@@ -17,6 +18,7 @@
 #include "source/common/http/utility.h"
 #include "source/common/network/utility.h"
 #include "source/common/runtime/runtime_features.h"
+#include "source/common/runtime/runtime_key_registry.h"
 #include "source/common/tracing/http_tracer_impl.h"
 
 #include "absl/strings/str_cat.h"
@@ -33,6 +35,18 @@ absl::string_view getScheme(absl::string_view forwarded_proto, bool is_ssl) {
   return is_ssl ? Headers::get().SchemeValues.Https : Headers::get().SchemeValues.Http;
 }
 
+// The runtime keys of the tracing decisions, looked up on every request.
+struct TracingRuntimeKeys {
+  const Runtime::KeyHandle client_enabled_{
+      Runtime::KeyRegistry::registerKey("tracing.client_enabled")};
+  const Runtime::KeyHandle random_sampling_{
+      Runtime::KeyRegistry::registerKey("tracing.random_sampling")};
+  const Runtime::KeyHandle global_enabled_{
+      Runtime::KeyRegistry::registerKey("tracing.global_enabled")};
+};
+
+const TracingRuntimeKeys& tracingRuntimeKeys() { CONSTRUCT_ON_FIRST_USE(TracingRuntimeKeys); }
+
 } // namespace
 std::string ConnectionManagerUtility::determineNextProtocol(Network::Connection& connection,
                                                             const Buffer::Instance& data) {
@@ -314,21 +328,22 @@ Tracing::Reason ConnectionManagerUtility::mutateTracingRequestHeader(
   final_reason = rid_extension->getTraceReason(request_headers);
   if (Tracing::Reason::NotTraceable == final_reason) {
     if (request_headers.ClientTraceId() &&
-        runtime.snapshot().featureEnabled("tracing.client_enabled", *client_sampling)) {
+        runtime.snapshot().featureEnabled(tracingRuntimeKeys().client_enabled_, *client_sampling)) {
       final_reason = Tracing::Reason::ClientForced;
       rid_extension->setTraceReason(request_headers, final_reason);
     } else if (request_headers.EnvoyForceTrace()) {
       final_reason = Tracing::Reason::ServiceForced;
       rid_extension->setTraceReason(request_headers, final_reason);
-    } else if (runtime.snapshot().featureEnabled("tracing.random_sampling", *random_sampling,
-                                                 result)) {
+    } else if (runtime.snapshot().featureEnabled(tracingRuntimeKeys().random_sampling_,
+                                                 *random_sampling, result)) {
       final_reason = Tracing::Reason::Sampling;
       rid_extension->setTraceReason(request_headers, final_reason);
     }
   }
 
   if (final_reason != Tracing::Reason::NotTraceable &&
-      !runtime.snapshot().featureEnabled("tracing.global_enabled", *overall_sampling, result)) {
+      !runtime.snapshot().featureEnabled(tracingRuntimeKeys().global_enabled_, *overall_sampling,
+                                         result)) {
     final_reason = Tracing::Reason::NotTraceable;
     rid_extension->setTraceReason(request_headers, final_reason);
   }
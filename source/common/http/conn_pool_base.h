@@ -29,7 +29,8 @@ public:
   // requires only the callbacks, but passes both for consistency.
   HttpPendingStream(Envoy::ConnectionPool::ConnPoolImplBase& parent, Http::ResponseDecoder& decoder,
                     Http::ConnectionPool::Callbacks& callbacks)
-      : Envoy::ConnectionPool::PendingStream(parent), context_(&decoder, &callbacks) {}
+      : Envoy::ConnectionPool::PendingStream(parent, callbacks.pendingStreamOptions()),
+        context_(&decoder, &callbacks) {}
 
   Envoy::ConnectionPool::AttachContext& context() override { return context_; }
   HttpAttachContext context_;
@@ -69,11 +70,18 @@ public:
   bool maybePreconnect(float ratio) override {
     return Envoy::ConnectionPool::ConnPoolImplBase::maybePreconnect(ratio);
   }
+  void warmUp(uint32_t connections, WarmUpCb cb) override {
+    Envoy::ConnectionPool::ConnPoolImplBase::warmUp(connections, std::move(cb));
+  }
   bool hasActiveConnections() const override;
 
   // Creates a new PendingStream and enqueues it into the queue.
   ConnectionPool::Cancellable*
   newPendingStream(Envoy::ConnectionPool::AttachContext& context) override;
+  Envoy::ConnectionPool::PendingStreamOptions
+  pendingStreamOptions(Envoy::ConnectionPool::AttachContext& context) override {
+    return typedContext<HttpAttachContext>(context).callbacks_->pendingStreamOptions();
+  }
   void onPoolFailure(const Upstream::HostDescriptionConstSharedPtr& host_description,
                      absl::string_view failure_reason, ConnectionPool::PoolFailureReason reason,
                      Envoy::ConnectionPool::AttachContext& context) override {
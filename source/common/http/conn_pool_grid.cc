@@ -12,6 +12,10 @@ namespace {
 absl::string_view describePool(const ConnectionPool::Instance& pool) {
   return pool.protocolDescription();
 }
+
+// The least delay given to HTTP/3 before attempting TCP when it usually connects, as the connect
+// times of the origin are only approximate.
+constexpr std::chrono::milliseconds MinNextAttemptDuration{10};
 } // namespace
 
 ConnectivityGrid::WrapperCallbacks::WrapperCallbacks(ConnectivityGrid& grid,
@@ -26,7 +30,8 @@ ConnectivityGrid::WrapperCallbacks::WrapperCallbacks(ConnectivityGrid& grid,
 // TODO(#15649) add trace logging.
 ConnectivityGrid::WrapperCallbacks::ConnectionAttemptCallbacks::ConnectionAttemptCallbacks(
     WrapperCallbacks& parent, PoolIterator it)
-    : parent_(parent), pool_it_(it), cancellable_(nullptr) {}
+    : parent_(parent), pool_it_(it), cancellable_(nullptr),
+      start_(parent.grid_.time_source_.monotonicTime()) {}
 
 ConnectivityGrid::WrapperCallbacks::ConnectionAttemptCallbacks::~ConnectionAttemptCallbacks() {
   if (cancellable_ != nullptr) {
@@ -34,6 +39,15 @@ ConnectivityGrid::WrapperCallbacks::ConnectionAttemptCallbacks::~ConnectionAttem
   }
 }
 
+Envoy::ConnectionPool::PendingStreamOptions
+ConnectivityGrid::WrapperCallbacks::ConnectionAttemptCallbacks::pendingStreamOptions() const {
+  // Each attempt waits in its pool as the original stream would.
+  if (parent_.inner_callbacks_ == nullptr) {
+    return {};
+  }
+  return parent_.inner_callbacks_->pendingStreamOptions();
+}
+
 ConnectivityGrid::StreamCreationResult
 ConnectivityGrid::WrapperCallbacks::ConnectionAttemptCallbacks::newStream() {
   auto* cancellable = pool().newStream(parent_.decoder_, *this);
@@ -41,9 +55,16 @@ ConnectivityGrid::WrapperCallbacks::ConnectionAttemptCallbacks::newStream() {
     return StreamCreationResult::ImmediateResult;
   }
   cancellable_ = cancellable;
+  waited_for_connection_ = true;
   return StreamCreationResult::StreamCreationPending;
 }
 
+std::chrono::microseconds
+ConnectivityGrid::WrapperCallbacks::ConnectionAttemptCallbacks::elapsed() const {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      parent_.grid_.time_source_.monotonicTime() - start_);
+}
+
 void ConnectivityGrid::WrapperCallbacks::ConnectionAttemptCallbacks::onPoolFailure(
     ConnectionPool::PoolFailureReason reason, absl::string_view transport_failure_reason,
     Upstream::HostDescriptionConstSharedPtr host) {
@@ -59,6 +80,7 @@ void ConnectivityGrid::WrapperCallbacks::onConnectionAttemptFailed(
             describePool(attempt->pool()), host->hostname());
   if (grid_.isPoolHttp3(attempt->pool())) {
     http3_attempt_failed_ = true;
+    grid_.recordHttp3Attempt(false, std::chrono::microseconds::zero());
   }
   maybeMarkHttp3Broken();
 
@@ -97,7 +119,7 @@ ConnectivityGrid::StreamCreationResult ConnectivityGrid::WrapperCallbacks::newSt
   auto attempt = std::make_unique<ConnectionAttemptCallbacks>(*this, current_);
   LinkedList::moveIntoList(std::move(attempt), connection_attempts_);
   if (!next_attempt_timer_->enabled()) {
-    next_attempt_timer_->enableTimer(grid_.next_attempt_duration_);
+    next_attempt_timer_->enableTimer(grid_.nextAttemptDuration());
   }
   // Note that in the case of immediate attempt/failure, newStream will delete this.
   return connection_attempts_.front()->newStream();
@@ -116,6 +138,10 @@ void ConnectivityGrid::WrapperCallbacks::onConnectionAttemptReady(
   } else {
     ENVOY_LOG(trace, "Marking HTTP/3 confirmed for host '{}'.", grid_.host_->hostname());
     grid_.markHttp3Confirmed();
+    // Streams created right away reuse a connection, so they tell nothing of the connect time.
+    if (attempt->waitedForConnection()) {
+      grid_.recordHttp3Attempt(true, attempt->elapsed());
+    }
   }
 
   auto delete_this_on_return = attempt->removeFromList(connection_attempts_);
@@ -320,6 +346,10 @@ bool ConnectivityGrid::maybePreconnect(float) {
   return false; // Preconnect not yet supported for the grid.
 }
 
+void ConnectivityGrid::warmUp(uint32_t, WarmUpCb cb) {
+  cb(); // Nor is warming up.
+}
+
 absl::optional<ConnectivityGrid::PoolIterator> ConnectivityGrid::nextPool(PoolIterator pool_it) {
   pool_it++;
   if (pool_it != pools_.end()) {
@@ -338,6 +368,37 @@ void ConnectivityGrid::markHttp3Broken() { http3_status_tracker_.markHttp3Broken
 
 void ConnectivityGrid::markHttp3Confirmed() { http3_status_tracker_.markHttp3Confirmed(); }
 
+void ConnectivityGrid::recordHttp3Attempt(bool succeeded, std::chrono::microseconds connect_time) {
+  if (alternate_protocols_ == nullptr ||
+      host_->address()->type() != Network::Address::Type::Ip) {
+    return;
+  }
+  alternate_protocols_->recordHttp3Attempt(origin(), succeeded, connect_time);
+}
+
+std::chrono::milliseconds ConnectivityGrid::nextAttemptDuration() {
+  if (alternate_protocols_ == nullptr ||
+      host_->address()->type() != Network::Address::Type::Ip) {
+    return next_attempt_duration_;
+  }
+  const absl::optional<AlternateProtocolsCache::OriginStats> stats =
+      alternate_protocols_->findStats(origin());
+  if (!stats.has_value()) {
+    return next_attempt_duration_;
+  }
+  if (stats->http3_failures_ > stats->http3_successes_) {
+    ENVOY_LOG(trace, "HTTP/3 mostly failed to host '{}', attempting TCP right away.",
+              host_->hostname());
+    return std::chrono::milliseconds::zero();
+  }
+  if (stats->http3_connect_time_.count() == 0) {
+    return next_attempt_duration_;
+  }
+  const std::chrono::milliseconds duration =
+      std::chrono::ceil<std::chrono::milliseconds>(2 * stats->http3_connect_time_);
+  return std::max(MinNextAttemptDuration, std::min(duration, next_attempt_duration_));
+}
+
 bool ConnectivityGrid::isIdle() const {
   // This is O(n) but the function is constant and there are no plans for n > 8.
   bool idle = true;
@@ -376,10 +437,8 @@ bool ConnectivityGrid::shouldAttemptHttp3() {
     return false;
   }
   uint32_t port = host_->address()->ip()->port();
-  // TODO(RyanTheOptimist): Figure out how scheme gets plumbed in here.
-  AlternateProtocolsCache::Origin origin("https", host_->hostname(), port);
   OptRef<const std::vector<AlternateProtocolsCache::AlternateProtocol>> protocols =
-      alternate_protocols_->findAlternatives(origin);
+      alternate_protocols_->findAlternatives(origin());
   if (!protocols.has_value()) {
     ENVOY_LOG(trace, "No alternate protocols available for host '{}', skipping HTTP/3.",
               host_->hostname());
@@ -413,5 +472,10 @@ bool ConnectivityGrid::shouldAttemptHttp3() {
   return false;
 }
 
+AlternateProtocolsCache::Origin ConnectivityGrid::origin() const {
+  // TODO(RyanTheOptimist): Figure out how scheme gets plumbed in here.
+  return {"https", host_->hostname(), host_->address()->ip()->port()};
+}
+
 } // namespace Http
 } // namespace Envoy
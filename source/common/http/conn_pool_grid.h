@@ -55,9 +55,17 @@ public:
       void onPoolReady(RequestEncoder& encoder, Upstream::HostDescriptionConstSharedPtr host,
                        const StreamInfo::StreamInfo& info,
                        absl::optional<Http::Protocol> protocol) override;
+      Envoy::ConnectionPool::PendingStreamOptions pendingStreamOptions() const override;
 
       ConnectionPool::Instance& pool() { return **pool_it_; }
 
+      // Returns how long the attempt has been in flight.
+      std::chrono::microseconds elapsed() const;
+
+      // Returns true if the pool did not create the stream under the stack of newStream(), which
+      // means it had to connect first.
+      bool waitedForConnection() const { return waited_for_connection_; }
+
       void cancel(Envoy::ConnectionPool::CancelPolicy cancel_policy);
 
     private:
@@ -68,6 +76,10 @@ public:
       // The handle to cancel this connection attempt.
       // This is owned by the pool which created it.
       Cancellable* cancellable_;
+      // When the attempt started.
+      const MonotonicTime start_;
+      // True if the pool did not create the stream under the stack of newStream().
+      bool waited_for_connection_{};
     };
     using ConnectionAttemptCallbacksPtr = std::unique_ptr<ConnectionAttemptCallbacks>;
 
@@ -150,6 +162,7 @@ public:
   void drainConnections() override;
   Upstream::HostDescriptionConstSharedPtr host() const override;
   bool maybePreconnect(float preconnect_ratio) override;
+  void warmUp(uint32_t connections, WarmUpCb cb) override;
   absl::string_view protocolDescription() const override { return "connection grid"; }
 
   // Returns the next pool in the ordered priority list.
@@ -170,6 +183,15 @@ public:
   // event that HTTP/3 is marked broken again.
   void markHttp3Confirmed();
 
+  // Records the outcome of an HTTP/3 connection attempt in the alternate protocols cache, if any,
+  // so that the next attempt delays are learned from it.
+  void recordHttp3Attempt(bool succeeded, std::chrono::microseconds connect_time);
+
+  // Returns how long the HTTP/3 attempt of a stream is given before TCP is attempted too. It is
+  // twice the time the HTTP/3 attempts to the origin took to connect, within the configured delay,
+  // and none if they mostly failed.
+  std::chrono::milliseconds nextAttemptDuration();
+
 protected:
   // Set the required idle callback on the pool.
   void setupPool(ConnectionPool::Instance& pool);
@@ -185,6 +207,10 @@ private:
   // that specifies HTTP/3 and HTTP/3 is not broken.
   bool shouldAttemptHttp3();
 
+  // Returns the origin of the host in the alternate protocols cache. The host must have an IP
+  // address.
+  AlternateProtocolsCache::Origin origin() const;
+
   // Creates the next pool in the priority list, or absl::nullopt if all pools
   // have been created.
   virtual absl::optional<PoolIterator> createNextPool();
@@ -0,0 +1,510 @@
+#include "source/common/http/cross_worker_conn_pool.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/dump_state_utils.h"
+#include "source/common/http/header_map_impl.h"
+
+namespace Envoy {
+namespace Http {
+
+namespace {
+
+// Holds a reference to a stream half until the end of the current dispatcher iteration, as its
+// caller may still be using it when it closes.
+template <class T> class DeferredRelease : public Event::DeferredDeletable {
+public:
+  explicit DeferredRelease(std::shared_ptr<T>&& object) : object_(std::move(object)) {}
+
+private:
+  std::shared_ptr<T> object_;
+};
+
+} // namespace
+
+CrossWorkerConnPool::CrossWorkerConnPool(Event::Dispatcher& dispatcher,
+                                         Event::Dispatcher& owner_dispatcher,
+                                         Upstream::HostConstSharedPtr host, OwnerPoolCb owner_pool)
+    : dispatcher_(dispatcher), owner_dispatcher_(owner_dispatcher), host_(std::move(host)),
+      owner_pool_(std::make_shared<const OwnerPoolCb>(std::move(owner_pool))) {}
+
+CrossWorkerConnPool::~CrossWorkerConnPool() {
+  for (const OriginStreamSharedPtr& stream : streams_) {
+    stream->abandon();
+  }
+}
+
+void CrossWorkerConnPool::startDrain() {
+  // There are no connections to drain on this worker, so the pool is drained once its streams are
+  // done.
+  if (isIdle()) {
+    for (const IdleCb& cb : idle_callbacks_) {
+      cb();
+    }
+  }
+}
+
+ConnectionPool::Cancellable*
+CrossWorkerConnPool::newStream(ResponseDecoder& response_decoder,
+                               ConnectionPool::Callbacks& callbacks) {
+  auto stream = std::make_shared<OriginStream>(*this, response_decoder, callbacks);
+  stream->owner_ = std::make_shared<OwnerStream>(dispatcher_, owner_dispatcher_, stream,
+                                                 callbacks.pendingStreamOptions());
+  streams_.push_front(stream);
+  stream->entry_ = streams_.begin();
+  owner_dispatcher_.post([owner = stream->owner_, owner_pool = owner_pool_]() {
+    owner->start((*owner_pool)());
+  });
+  return stream->pending() ? stream.get() : nullptr;
+}
+
+void CrossWorkerConnPool::onStreamClosed(OriginStream& stream) {
+  dispatcher_.deferredDelete(
+      std::make_unique<DeferredRelease<OriginStream>>(std::move(*stream.entry_)));
+  streams_.erase(stream.entry_);
+  if (streams_.empty()) {
+    ENVOY_LOG(debug, "invoking idle callbacks");
+    for (const IdleCb& cb : idle_callbacks_) {
+      cb();
+    }
+  }
+}
+
+CrossWorkerConnPool::OriginStream::OriginStream(CrossWorkerConnPool& parent,
+                                                ResponseDecoder& response_decoder,
+                                                ConnectionPool::Callbacks& callbacks)
+    : parent_(&parent), dispatcher_(parent.dispatcher_),
+      owner_dispatcher_(parent.owner_dispatcher_), response_decoder_(response_decoder),
+      callbacks_(&callbacks) {}
+
+template <class EventCb> void CrossWorkerConnPool::OriginStream::postToOwner(EventCb event) {
+  // Nothing is forwarded once the stream is closed.
+  if (owner_ != nullptr) {
+    owner_dispatcher_.post([owner = owner_, event = std::move(event)]() { event(*owner); });
+  }
+}
+
+Status CrossWorkerConnPool::OriginStream::encodeHeaders(const RequestHeaderMap& headers,
+                                                        bool end_stream) {
+  std::shared_ptr<const RequestHeaderMap> copy = createHeaderMap<RequestHeaderMapImpl>(headers);
+  postToOwner([copy, end_stream](OwnerStream& owner) { owner.encodeHeaders(*copy, end_stream); });
+  if (end_stream) {
+    onLocalComplete();
+  }
+  // The headers are encoded on the owning worker, which resets the stream if that fails.
+  return okStatus();
+}
+
+void CrossWorkerConnPool::OriginStream::encodeData(Buffer::Instance& data, bool end_stream) {
+  auto buffer = std::make_shared<Buffer::OwnedImpl>();
+  buffer->move(data);
+  postToOwner([buffer, end_stream](OwnerStream& owner) { owner.encodeData(*buffer, end_stream); });
+  if (end_stream) {
+    onLocalComplete();
+  }
+}
+
+void CrossWorkerConnPool::OriginStream::encodeTrailers(const RequestTrailerMap& trailers) {
+  std::shared_ptr<const RequestTrailerMap> copy = createHeaderMap<RequestTrailerMapImpl>(trailers);
+  postToOwner([copy](OwnerStream& owner) { owner.encodeTrailers(*copy); });
+  onLocalComplete();
+}
+
+void CrossWorkerConnPool::OriginStream::encodeMetadata(
+    const MetadataMapVector& metadata_map_vector) {
+  auto copy = std::make_shared<MetadataMapVector>();
+  copy->reserve(metadata_map_vector.size());
+  for (const MetadataMapPtr& metadata_map : metadata_map_vector) {
+    copy->push_back(std::make_unique<MetadataMap>(*metadata_map));
+  }
+  postToOwner([copy](OwnerStream& owner) { owner.encodeMetadata(*copy); });
+}
+
+void CrossWorkerConnPool::OriginStream::enableTcpTunneling() {
+  postToOwner([](OwnerStream& owner) { owner.enableTcpTunneling(); });
+}
+
+void CrossWorkerConnPool::OriginStream::resetStream(StreamResetReason reason) {
+  if (closed_) {
+    return;
+  }
+  postToOwner([reason](OwnerStream& owner) { owner.resetStream(reason); });
+  close();
+  runResetCallbacks(reason);
+}
+
+void CrossWorkerConnPool::OriginStream::readDisable(bool disable) {
+  postToOwner([disable](OwnerStream& owner) { owner.readDisable(disable); });
+}
+
+void CrossWorkerConnPool::OriginStream::setFlushTimeout(std::chrono::milliseconds timeout) {
+  postToOwner([timeout](OwnerStream& owner) { owner.setFlushTimeout(timeout); });
+}
+
+void CrossWorkerConnPool::OriginStream::cancel(Envoy::ConnectionPool::CancelPolicy cancel_policy) {
+  ASSERT(pending());
+  callbacks_ = nullptr;
+  postToOwner([cancel_policy](OwnerStream& owner) { owner.cancel(cancel_policy); });
+  close();
+}
+
+void CrossWorkerConnPool::OriginStream::abandon() {
+  parent_ = nullptr;
+  callbacks_ = nullptr;
+  if (!closed_) {
+    postToOwner([](OwnerStream& owner) { owner.resetStream(StreamResetReason::LocalReset); });
+    close();
+  }
+}
+
+void CrossWorkerConnPool::OriginStream::onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                                                      const std::string& transport_failure_reason,
+                                                      Upstream::HostDescriptionConstSharedPtr host) {
+  if (closed_) {
+    return;
+  }
+  ConnectionPool::Callbacks* callbacks = callbacks_;
+  callbacks_ = nullptr;
+  close();
+  callbacks->onPoolFailure(reason, transport_failure_reason, host);
+}
+
+void CrossWorkerConnPool::OriginStream::onPoolReady(
+    Upstream::HostDescriptionConstSharedPtr host, absl::optional<Http::Protocol> protocol,
+    uint32_t buffer_limit, Network::Address::InstanceConstSharedPtr connection_local_address,
+    Ssl::ConnectionInfoConstSharedPtr ssl_info) {
+  // If the stream was canceled in the meantime, the owning worker resets it.
+  if (closed_) {
+    return;
+  }
+  buffer_limit_ = buffer_limit;
+  connection_local_address_ = std::move(connection_local_address);
+  // The upstream connection's stream info belongs to the owning worker, so this stream gets its
+  // own, with the parts which are safe to share.
+  stream_info_ = std::make_unique<StreamInfo::StreamInfoImpl>(dispatcher_.timeSource(), nullptr);
+  if (protocol.has_value()) {
+    stream_info_->protocol(protocol.value());
+  }
+  stream_info_->setDownstreamSslConnection(ssl_info);
+
+  ConnectionPool::Callbacks* callbacks = callbacks_;
+  callbacks_ = nullptr;
+  callbacks->onPoolReady(*this, host, *stream_info_, protocol);
+}
+
+void CrossWorkerConnPool::OriginStream::decode100ContinueHeaders(ResponseHeaderMapPtr&& headers) {
+  if (!closed_) {
+    response_decoder_.decode100ContinueHeaders(std::move(headers));
+  }
+}
+
+void CrossWorkerConnPool::OriginStream::decodeHeaders(ResponseHeaderMapPtr&& headers,
+                                                      bool end_stream) {
+  if (closed_) {
+    return;
+  }
+  response_decoder_.decodeHeaders(std::move(headers), end_stream);
+  if (end_stream) {
+    onRemoteComplete();
+  }
+}
+
+void CrossWorkerConnPool::OriginStream::decodeData(Buffer::Instance& data, bool end_stream) {
+  if (closed_) {
+    return;
+  }
+  response_decoder_.decodeData(data, end_stream);
+  if (end_stream) {
+    onRemoteComplete();
+  }
+}
+
+void CrossWorkerConnPool::OriginStream::decodeTrailers(ResponseTrailerMapPtr&& trailers) {
+  if (closed_) {
+    return;
+  }
+  response_decoder_.decodeTrailers(std::move(trailers));
+  onRemoteComplete();
+}
+
+void CrossWorkerConnPool::OriginStream::decodeMetadata(MetadataMapPtr&& metadata_map) {
+  if (!closed_) {
+    response_decoder_.decodeMetadata(std::move(metadata_map));
+  }
+}
+
+void CrossWorkerConnPool::OriginStream::onResetStream(StreamResetReason reason,
+                                                      const std::string& transport_failure_reason) {
+  if (closed_) {
+    return;
+  }
+  close();
+  runResetCallbacks(reason, transport_failure_reason);
+}
+
+void CrossWorkerConnPool::OriginStream::onAboveWriteBufferHighWatermark() {
+  if (!closed_) {
+    runHighWatermarkCallbacks();
+  }
+}
+
+void CrossWorkerConnPool::OriginStream::onBelowWriteBufferLowWatermark() {
+  if (!closed_) {
+    runLowWatermarkCallbacks();
+  }
+}
+
+void CrossWorkerConnPool::OriginStream::onLocalComplete() {
+  local_end_stream_ = true;
+  if (remote_complete_ && !closed_) {
+    close();
+  }
+}
+
+void CrossWorkerConnPool::OriginStream::onRemoteComplete() {
+  // The decoder may have reset the stream.
+  if (closed_) {
+    return;
+  }
+  remote_complete_ = true;
+  if (local_end_stream_) {
+    close();
+  }
+}
+
+void CrossWorkerConnPool::OriginStream::close() {
+  ASSERT(!closed_);
+  closed_ = true;
+  owner_.reset();
+  if (parent_ != nullptr) {
+    parent_->onStreamClosed(*this);
+  }
+}
+
+CrossWorkerConnPool::OwnerStream::OwnerStream(Event::Dispatcher& origin_dispatcher,
+                                              Event::Dispatcher& owner_dispatcher,
+                                              OriginStreamSharedPtr origin,
+                                              const Envoy::ConnectionPool::PendingStreamOptions&
+                                                  pending_stream_options)
+    : origin_dispatcher_(origin_dispatcher), owner_dispatcher_(owner_dispatcher),
+      origin_(std::move(origin)), pending_stream_options_(pending_stream_options) {}
+
+template <class EventCb> void CrossWorkerConnPool::OwnerStream::postToOrigin(EventCb event) {
+  if (origin_ != nullptr) {
+    origin_dispatcher_.post([origin = origin_, event = std::move(event)]() { event(*origin); });
+  }
+}
+
+void CrossWorkerConnPool::OwnerStream::start(ConnectionPool::Instance* pool) {
+  self_ = shared_from_this();
+  if (pool == nullptr) {
+    onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                  "no connection pool on the owning worker", nullptr);
+    return;
+  }
+  // The pool may call back before returning, in which case the handle is nullptr.
+  handle_ = pool->newStream(*this, *this);
+}
+
+void CrossWorkerConnPool::OwnerStream::cancel(Envoy::ConnectionPool::CancelPolicy cancel_policy) {
+  if (self_ == nullptr) {
+    return;
+  }
+  if (handle_ != nullptr) {
+    handle_->cancel(cancel_policy);
+    handle_ = nullptr;
+    close();
+  } else {
+    // The stream became ready before the cancellation arrived.
+    resetStream(StreamResetReason::LocalReset);
+  }
+}
+
+void CrossWorkerConnPool::OwnerStream::encodeHeaders(const RequestHeaderMap& headers,
+                                                     bool end_stream) {
+  if (encoder_ == nullptr) {
+    return;
+  }
+  const Status status = encoder_->encodeHeaders(headers, end_stream);
+  if (!status.ok()) {
+    ENVOY_LOG(debug, "failed to encode forwarded request headers: {}", status.message());
+    postToOrigin([details = std::string(status.message())](OriginStream& origin) {
+      origin.onResetStream(StreamResetReason::LocalReset, details);
+    });
+    resetStream(StreamResetReason::LocalReset);
+    return;
+  }
+  if (end_stream) {
+    onLocalComplete();
+  }
+}
+
+void CrossWorkerConnPool::OwnerStream::encodeData(Buffer::Instance& data, bool end_stream) {
+  if (encoder_ == nullptr) {
+    return;
+  }
+  encoder_->encodeData(data, end_stream);
+  if (end_stream) {
+    onLocalComplete();
+  }
+}
+
+void CrossWorkerConnPool::OwnerStream::encodeTrailers(const RequestTrailerMap& trailers) {
+  if (encoder_ == nullptr) {
+    return;
+  }
+  encoder_->encodeTrailers(trailers);
+  onLocalComplete();
+}
+
+void CrossWorkerConnPool::OwnerStream::encodeMetadata(
+    const MetadataMapVector& metadata_map_vector) {
+  if (encoder_ != nullptr) {
+    encoder_->encodeMetadata(metadata_map_vector);
+  }
+}
+
+void CrossWorkerConnPool::OwnerStream::enableTcpTunneling() {
+  if (encoder_ != nullptr) {
+    encoder_->enableTcpTunneling();
+  }
+}
+
+void CrossWorkerConnPool::OwnerStream::resetStream(StreamResetReason reason) {
+  if (self_ == nullptr) {
+    return;
+  }
+  if (handle_ != nullptr) {
+    handle_->cancel(Envoy::ConnectionPool::CancelPolicy::Default);
+    handle_ = nullptr;
+  } else if (encoder_ != nullptr) {
+    RequestEncoder* encoder = encoder_;
+    encoder_ = nullptr;
+    encoder->getStream().removeCallbacks(*this);
+    encoder->getStream().resetStream(reason);
+  }
+  close();
+}
+
+void CrossWorkerConnPool::OwnerStream::readDisable(bool disable) {
+  if (encoder_ != nullptr) {
+    encoder_->getStream().readDisable(disable);
+  }
+}
+
+void CrossWorkerConnPool::OwnerStream::setFlushTimeout(std::chrono::milliseconds timeout) {
+  if (encoder_ != nullptr) {
+    encoder_->getStream().setFlushTimeout(timeout);
+  }
+}
+
+void CrossWorkerConnPool::OwnerStream::onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                                                     absl::string_view transport_failure_reason,
+                                                     Upstream::HostDescriptionConstSharedPtr host) {
+  handle_ = nullptr;
+  postToOrigin([reason, details = std::string(transport_failure_reason), host](
+                   OriginStream& origin) { origin.onPoolFailure(reason, details, host); });
+  close();
+}
+
+void CrossWorkerConnPool::OwnerStream::onPoolReady(RequestEncoder& encoder,
+                                                   Upstream::HostDescriptionConstSharedPtr host,
+                                                   const StreamInfo::StreamInfo& info,
+                                                   absl::optional<Http::Protocol> protocol) {
+  handle_ = nullptr;
+  encoder_ = &encoder;
+  encoder.getStream().addCallbacks(*this);
+  postToOrigin([host, protocol, buffer_limit = encoder.getStream().bufferLimit(),
+                connection_local_address = encoder.getStream().connectionLocalAddress(),
+                ssl_info = info.downstreamSslConnection()](OriginStream& origin) {
+    origin.onPoolReady(host, protocol, buffer_limit, connection_local_address, ssl_info);
+  });
+}
+
+void CrossWorkerConnPool::OwnerStream::decode100ContinueHeaders(ResponseHeaderMapPtr&& headers) {
+  auto shared = std::make_shared<ResponseHeaderMapPtr>(std::move(headers));
+  postToOrigin(
+      [shared](OriginStream& origin) { origin.decode100ContinueHeaders(std::move(*shared)); });
+}
+
+void CrossWorkerConnPool::OwnerStream::decodeHeaders(ResponseHeaderMapPtr&& headers,
+                                                     bool end_stream) {
+  auto shared = std::make_shared<ResponseHeaderMapPtr>(std::move(headers));
+  postToOrigin([shared, end_stream](OriginStream& origin) {
+    origin.decodeHeaders(std::move(*shared), end_stream);
+  });
+  if (end_stream) {
+    onRemoteComplete();
+  }
+}
+
+void CrossWorkerConnPool::OwnerStream::decodeData(Buffer::Instance& data, bool end_stream) {
+  auto buffer = std::make_shared<Buffer::OwnedImpl>();
+  buffer->move(data);
+  postToOrigin(
+      [buffer, end_stream](OriginStream& origin) { origin.decodeData(*buffer, end_stream); });
+  if (end_stream) {
+    onRemoteComplete();
+  }
+}
+
+void CrossWorkerConnPool::OwnerStream::decodeTrailers(ResponseTrailerMapPtr&& trailers) {
+  auto shared = std::make_shared<ResponseTrailerMapPtr>(std::move(trailers));
+  postToOrigin([shared](OriginStream& origin) { origin.decodeTrailers(std::move(*shared)); });
+  onRemoteComplete();
+}
+
+void CrossWorkerConnPool::OwnerStream::decodeMetadata(MetadataMapPtr&& metadata_map) {
+  auto shared = std::make_shared<MetadataMapPtr>(std::move(metadata_map));
+  postToOrigin([shared](OriginStream& origin) { origin.decodeMetadata(std::move(*shared)); });
+}
+
+void CrossWorkerConnPool::OwnerStream::dumpState(std::ostream& os, int indent_level) const {
+  const char* spaces = spacesForLevel(indent_level);
+  os << spaces << "CrossWorkerConnPool::OwnerStream " << this << DUMP_MEMBER(local_complete_)
+     << DUMP_MEMBER(remote_complete_) << "\n";
+}
+
+void CrossWorkerConnPool::OwnerStream::onResetStream(StreamResetReason reason,
+                                                     absl::string_view transport_failure_reason) {
+  // The upstream stream is gone, so there is nothing to detach from.
+  encoder_ = nullptr;
+  postToOrigin([reason, details = std::string(transport_failure_reason)](OriginStream& origin) {
+    origin.onResetStream(reason, details);
+  });
+  close();
+}
+
+void CrossWorkerConnPool::OwnerStream::onAboveWriteBufferHighWatermark() {
+  postToOrigin([](OriginStream& origin) { origin.onAboveWriteBufferHighWatermark(); });
+}
+
+void CrossWorkerConnPool::OwnerStream::onBelowWriteBufferLowWatermark() {
+  postToOrigin([](OriginStream& origin) { origin.onBelowWriteBufferLowWatermark(); });
+}
+
+void CrossWorkerConnPool::OwnerStream::onLocalComplete() {
+  local_complete_ = true;
+  if (remote_complete_) {
+    close();
+  }
+}
+
+void CrossWorkerConnPool::OwnerStream::onRemoteComplete() {
+  remote_complete_ = true;
+  if (local_complete_) {
+    close();
+  }
+}
+
+void CrossWorkerConnPool::OwnerStream::close() {
+  if (encoder_ != nullptr) {
+    encoder_->getStream().removeCallbacks(*this);
+    encoder_ = nullptr;
+  }
+  origin_.reset();
+  owner_dispatcher_.deferredDelete(
+      std::make_unique<DeferredRelease<OwnerStream>>(std::move(self_)));
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <functional>
+#include <list>
+#include <memory>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/codec.h"
+#include "envoy/http/conn_pool.h"
+#include "envoy/upstream/upstream.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/http/codec_helper.h"
+#include "source/common/stream_info/stream_info_impl.h"
+
+namespace Envoy {
+namespace Http {
+
+// An HTTP connection pool which forwards streams to a connection pool owned by another worker, so
+// that a host's HTTP/2 connections can be shared by all workers instead of each worker opening its
+// own.
+//
+// Every stream has a half on each worker. The two halves only communicate by posting to each
+// other's dispatcher, so nothing is locked on the data path, and each half is only touched by its
+// own worker. Headers, trailers and metadata are copied, and body data is moved, on every handoff.
+class CrossWorkerConnPool : public ConnectionPool::Instance,
+                            protected Logger::Loggable<Logger::Id::pool> {
+public:
+  // Called on the owning worker to get the pool which forwarded streams are created on, or nullptr
+  // if there is none, in which case the stream fails.
+  using OwnerPoolCb = std::function<ConnectionPool::Instance*()>;
+
+  CrossWorkerConnPool(Event::Dispatcher& dispatcher, Event::Dispatcher& owner_dispatcher,
+                      Upstream::HostConstSharedPtr host, OwnerPoolCb owner_pool);
+  ~CrossWorkerConnPool() override;
+
+  // ConnectionPool::Instance
+  void addIdleCallback(IdleCb cb) override { idle_callbacks_.push_back(cb); }
+  bool isIdle() const override { return streams_.empty(); }
+  void startDrain() override;
+  // Connections are drained by the owning worker.
+  void drainConnections() override {}
+  Upstream::HostDescriptionConstSharedPtr host() const override { return host_; }
+  // Preconnecting is left to the owning worker's pool.
+  bool maybePreconnect(float) override { return false; }
+  // As are the warm-up connections.
+  void warmUp(uint32_t, WarmUpCb cb) override { cb(); }
+  bool hasActiveConnections() const override { return !streams_.empty(); }
+  ConnectionPool::Cancellable* newStream(ResponseDecoder& response_decoder,
+                                         ConnectionPool::Callbacks& callbacks) override;
+  absl::string_view protocolDescription() const override { return "HTTP/2 cross worker"; }
+
+private:
+  class OwnerStream;
+  using OwnerStreamSharedPtr = std::shared_ptr<OwnerStream>;
+
+  // The half of a stream on the worker which created it. It stands in for the pool callbacks
+  // and the request encoder on the owning worker.
+  class OriginStream : public RequestEncoder,
+                       public Stream,
+                       public ConnectionPool::Cancellable,
+                       public StreamCallbackHelper,
+                       public std::enable_shared_from_this<OriginStream> {
+  public:
+    OriginStream(CrossWorkerConnPool& parent, ResponseDecoder& response_decoder,
+                 ConnectionPool::Callbacks& callbacks);
+
+    // RequestEncoder
+    Status encodeHeaders(const RequestHeaderMap& headers, bool end_stream) override;
+    void encodeTrailers(const RequestTrailerMap& trailers) override;
+    void enableTcpTunneling() override;
+
+    // StreamEncoder
+    void encodeData(Buffer::Instance& data, bool end_stream) override;
+    void encodeMetadata(const MetadataMapVector& metadata_map_vector) override;
+    Http1StreamEncoderOptionsOptRef http1StreamEncoderOptions() override { return absl::nullopt; }
+    Stream& getStream() override { return *this; }
+
+    // Stream
+    void addCallbacks(StreamCallbacks& callbacks) override { addCallbacksHelper(callbacks); }
+    void removeCallbacks(StreamCallbacks& callbacks) override { removeCallbacksHelper(callbacks); }
+    void resetStream(StreamResetReason reason) override;
+    void readDisable(bool disable) override;
+    uint32_t bufferLimit() override { return buffer_limit_; }
+    const Network::Address::InstanceConstSharedPtr& connectionLocalAddress() override {
+      return connection_local_address_;
+    }
+    void setFlushTimeout(std::chrono::milliseconds timeout) override;
+    // Buffer accounts belong to this worker and can't follow the data to the owning worker.
+    void setAccount(Buffer::BufferMemoryAccountSharedPtr) override {}
+
+    // ConnectionPool::Cancellable
+    void cancel(Envoy::ConnectionPool::CancelPolicy cancel_policy) override;
+
+    // Events from the owning worker.
+    void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                       const std::string& transport_failure_reason,
+                       Upstream::HostDescriptionConstSharedPtr host);
+    void onPoolReady(Upstream::HostDescriptionConstSharedPtr host,
+                     absl::optional<Http::Protocol> protocol, uint32_t buffer_limit,
+                     Network::Address::InstanceConstSharedPtr connection_local_address,
+                     Ssl::ConnectionInfoConstSharedPtr ssl_info);
+    void decode100ContinueHeaders(ResponseHeaderMapPtr&& headers);
+    void decodeHeaders(ResponseHeaderMapPtr&& headers, bool end_stream);
+    void decodeData(Buffer::Instance& data, bool end_stream);
+    void decodeTrailers(ResponseTrailerMapPtr&& trailers);
+    void decodeMetadata(MetadataMapPtr&& metadata_map);
+    void onResetStream(StreamResetReason reason, const std::string& transport_failure_reason);
+    void onAboveWriteBufferHighWatermark();
+    void onBelowWriteBufferLowWatermark();
+
+    // @return true if neither pool callback has been called and the stream was not canceled.
+    bool pending() const { return callbacks_ != nullptr; }
+    // Called if the pool is destroyed while the stream is open. The stream is reset on the
+    // owning worker without calling back into this worker.
+    void abandon();
+
+    // Set when the stream is created, before it is handed to the owning worker.
+    OwnerStreamSharedPtr owner_;
+    std::list<std::shared_ptr<OriginStream>>::iterator entry_;
+
+  private:
+    // Posts an event, a callable taking OwnerStream&, to the owning worker.
+    template <class EventCb> void postToOwner(EventCb event);
+    void onLocalComplete();
+    void onRemoteComplete();
+    // Detaches from the owning worker and removes the stream from the pool.
+    void close();
+
+    // Cleared if the pool is destroyed first.
+    CrossWorkerConnPool* parent_;
+    Event::Dispatcher& dispatcher_;
+    Event::Dispatcher& owner_dispatcher_;
+    ResponseDecoder& response_decoder_;
+    // Cleared once the pool callbacks have been called or the stream has been canceled.
+    ConnectionPool::Callbacks* callbacks_;
+    std::unique_ptr<StreamInfo::StreamInfoImpl> stream_info_;
+    Network::Address::InstanceConstSharedPtr connection_local_address_;
+    uint32_t buffer_limit_{};
+    bool remote_complete_{};
+    bool closed_{};
+  };
+  using OriginStreamSharedPtr = std::shared_ptr<OriginStream>;
+
+  // The half of a stream on the owning worker. It is created with, and keeps a reference to, its
+  // origin half, but is only used on the owning worker after the stream is handed off.
+  class OwnerStream : public ResponseDecoder,
+                      public ConnectionPool::Callbacks,
+                      public StreamCallbacks,
+                      public std::enable_shared_from_this<OwnerStream> {
+  public:
+    OwnerStream(Event::Dispatcher& origin_dispatcher, Event::Dispatcher& owner_dispatcher,
+                OriginStreamSharedPtr origin,
+                const Envoy::ConnectionPool::PendingStreamOptions& pending_stream_options);
+
+    void start(ConnectionPool::Instance* pool);
+
+    // Events from the origin worker.
+    void cancel(Envoy::ConnectionPool::CancelPolicy cancel_policy);
+    void encodeHeaders(const RequestHeaderMap& headers, bool end_stream);
+    void encodeData(Buffer::Instance& data, bool end_stream);
+    void encodeTrailers(const RequestTrailerMap& trailers);
+    void encodeMetadata(const MetadataMapVector& metadata_map_vector);
+    void enableTcpTunneling();
+    void resetStream(StreamResetReason reason);
+    void readDisable(bool disable);
+    void setFlushTimeout(std::chrono::milliseconds timeout);
+
+    // ConnectionPool::Callbacks
+    void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                       absl::string_view transport_failure_reason,
+                       Upstream::HostDescriptionConstSharedPtr host) override;
+    void onPoolReady(RequestEncoder& encoder, Upstream::HostDescriptionConstSharedPtr host,
+                     const StreamInfo::StreamInfo& info,
+                     absl::optional<Http::Protocol> protocol) override;
+    Envoy::ConnectionPool::PendingStreamOptions pendingStreamOptions() const override {
+      return pending_stream_options_;
+    }
+
+    // ResponseDecoder
+    void decode100ContinueHeaders(ResponseHeaderMapPtr&& headers) override;
+    void decodeHeaders(ResponseHeaderMapPtr&& headers, bool end_stream) override;
+    void decodeTrailers(ResponseTrailerMapPtr&& trailers) override;
+    void dumpState(std::ostream& os, int indent_level) const override;
+
+    // StreamDecoder
+    void decodeData(Buffer::Instance& data, bool end_stream) override;
+    void decodeMetadata(MetadataMapPtr&& metadata_map) override;
+
+    // StreamCallbacks
+    void onResetStream(StreamResetReason reason,
+                       absl::string_view transport_failure_reason) override;
+    void onAboveWriteBufferHighWatermark() override;
+    void onBelowWriteBufferLowWatermark() override;
+
+  private:
+    // Posts an event, a callable taking OriginStream&, to the origin worker.
+    template <class EventCb> void postToOrigin(EventCb event);
+    void onLocalComplete();
+    void onRemoteComplete();
+    // Detaches from the pool or upstream stream, and from the origin worker.
+    void close();
+
+    Event::Dispatcher& origin_dispatcher_;
+    Event::Dispatcher& owner_dispatcher_;
+    OriginStreamSharedPtr origin_;
+    // Taken from the origin callbacks, which can't be called from the owning worker.
+    const Envoy::ConnectionPool::PendingStreamOptions pending_stream_options_;
+    // Keeps this alive while the owning pool or upstream stream references it.
+    OwnerStreamSharedPtr self_;
+    ConnectionPool::Cancellable* handle_{};
+    RequestEncoder* encoder_{};
+    bool local_complete_{};
+    bool remote_complete_{};
+  };
+
+  void onStreamClosed(OriginStream& stream);
+
+  Event::Dispatcher& dispatcher_;
+  Event::Dispatcher& owner_dispatcher_;
+  const Upstream::HostConstSharedPtr host_;
+  // Shared with the events posted to the owning worker, which may outlive this pool.
+  const std::shared_ptr<const OwnerPoolCb> owner_pool_;
+  std::list<OriginStreamSharedPtr> streams_;
+  std::list<IdleCb> idle_callbacks_;
+};
+
+} // namespace Http
+} // namespace Envoy
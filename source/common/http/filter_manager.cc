@@ -150,6 +150,12 @@ bool ActiveStreamFilterBase::commonHandleAfterHeadersCallback(FilterHeadersStatu
     break;
   }
 
+  if (skip_remaining_callbacks_ && !canIterate()) {
+    // Skipping a stopped filter would let the rest of the stream overtake its headers.
+    ENVOY_BUG(false, "filter skipped its remaining callbacks without continuing its headers");
+    skip_remaining_callbacks_ = false;
+  }
+
   handleMetadataAfterHeadersCallback();
 
   if (stoppedAll() || status == FilterHeadersStatus::StopIteration) {
@@ -453,7 +459,10 @@ void FilterManager::addStreamDecoderFilterWorker(StreamDecoderFilterSharedPtr fi
                                                  FilterMatchStateSharedPtr match_state,
                                                  bool dual_filter) {
   ActiveStreamDecoderFilterPtr wrapper(
-      new ActiveStreamDecoderFilter(*this, filter, match_state, dual_filter));
+      new (filter_arena_) ActiveStreamDecoderFilter(*this, filter, match_state, dual_filter));
+  if (!filter_costs_.empty()) {
+    wrapper->filter_cost_ = filter_costs_.back().get();
+  }
 
   // If we're a dual handling filter, have the encoding wrapper be the only thing registering itself
   // as the handling filter.
@@ -477,7 +486,10 @@ void FilterManager::addStreamEncoderFilterWorker(StreamEncoderFilterSharedPtr fi
                                                  FilterMatchStateSharedPtr match_state,
                                                  bool dual_filter) {
   ActiveStreamEncoderFilterPtr wrapper(
-      new ActiveStreamEncoderFilter(*this, filter, match_state, dual_filter));
+      new (filter_arena_) ActiveStreamEncoderFilter(*this, filter, match_state, dual_filter));
+  if (!filter_costs_.empty()) {
+    wrapper->filter_cost_ = filter_costs_.back().get();
+  }
 
   if (match_state) {
     match_state->filter_ = filter.get();
@@ -530,6 +542,7 @@ void FilterManager::decodeHeaders(ActiveStreamDecoderFilter* filter, RequestHead
     ASSERT(!(state_.filter_call_state_ & FilterCallState::DecodeHeaders));
     state_.filter_call_state_ |= FilterCallState::DecodeHeaders;
     (*entry)->end_stream_ = (end_stream && continue_data_entry == decoder_filters_.end());
+    const FilterCostTimer cost_timer((*entry)->filter_cost_);
     FilterHeadersStatus status = (*entry)->decodeHeaders(headers, (*entry)->end_stream_);
 
     ASSERT(!(status == FilterHeadersStatus::ContinueAndDontEndStream && !(*entry)->end_stream_),
@@ -664,6 +677,7 @@ void FilterManager::decodeData(ActiveStreamDecoderFilter* filter, Buffer::Instan
 
     state_.filter_call_state_ |= FilterCallState::DecodeData;
     (*entry)->end_stream_ = end_stream && !filter_manager_callbacks_.requestTrailers();
+    const FilterCostTimer cost_timer((*entry)->filter_cost_);
     FilterDataStatus status = (*entry)->handle_->decodeData(data, (*entry)->end_stream_);
     if ((*entry)->end_stream_) {
       (*entry)->handle_->decodeComplete();
@@ -758,6 +772,7 @@ void FilterManager::decodeTrailers(ActiveStreamDecoderFilter* filter, RequestTra
     }
     ASSERT(!(state_.filter_call_state_ & FilterCallState::DecodeTrailers));
     state_.filter_call_state_ |= FilterCallState::DecodeTrailers;
+    const FilterCostTimer cost_timer((*entry)->filter_cost_);
     FilterTrailersStatus status = (*entry)->handle_->decodeTrailers(trailers);
     (*entry)->handle_->decodeComplete();
     (*entry)->end_stream_ = true;
@@ -793,6 +808,7 @@ void FilterManager::decodeMetadata(ActiveStreamDecoderFilter* filter, MetadataMa
       return;
     }
 
+    const FilterCostTimer cost_timer((*entry)->filter_cost_);
     FilterMetadataStatus status = (*entry)->handle_->decodeMetadata(metadata_map);
     ENVOY_STREAM_LOG(trace, "decode metadata called: filter={} status={}, metadata: {}", *this,
                      static_cast<const void*>((*entry).get()), static_cast<uint64_t>(status),
@@ -1009,6 +1025,7 @@ void FilterManager::encode100ContinueHeaders(ActiveStreamEncoderFilter* filter,
 
     ASSERT(!(state_.filter_call_state_ & FilterCallState::Encode100ContinueHeaders));
     state_.filter_call_state_ |= FilterCallState::Encode100ContinueHeaders;
+    const FilterCostTimer cost_timer((*entry)->filter_cost_);
     FilterHeadersStatus status = (*entry)->handle_->encode100ContinueHeaders(headers);
     state_.filter_call_state_ &= ~FilterCallState::Encode100ContinueHeaders;
     ENVOY_STREAM_LOG(trace, "encode 100 continue headers called: filter={} status={}", *this,
@@ -1057,6 +1074,7 @@ void FilterManager::encodeHeaders(ActiveStreamEncoderFilter* filter, ResponseHea
     ASSERT(!(state_.filter_call_state_ & FilterCallState::EncodeHeaders));
     state_.filter_call_state_ |= FilterCallState::EncodeHeaders;
     (*entry)->end_stream_ = (end_stream && continue_data_entry == encoder_filters_.end());
+    const FilterCostTimer cost_timer((*entry)->filter_cost_);
     FilterHeadersStatus status = (*entry)->handle_->encodeHeaders(headers, (*entry)->end_stream_);
 
     ASSERT(!(status == FilterHeadersStatus::ContinueAndDontEndStream && !(*entry)->end_stream_),
@@ -1135,6 +1153,7 @@ void FilterManager::encodeMetadata(ActiveStreamEncoderFilter* filter,
       return;
     }
 
+    const FilterCostTimer cost_timer((*entry)->filter_cost_);
     FilterMetadataStatus status = (*entry)->handle_->encodeMetadata(*metadata_map_ptr);
     ENVOY_STREAM_LOG(trace, "encode metadata called: filter={} status={}", *this,
                      static_cast<const void*>((*entry).get()), static_cast<uint64_t>(status));
@@ -1219,6 +1238,7 @@ void FilterManager::encodeData(ActiveStreamEncoderFilter* filter, Buffer::Instan
     recordLatestDataFilter(entry, state_.latest_data_encoding_filter_, encoder_filters_);
 
     (*entry)->end_stream_ = end_stream && !filter_manager_callbacks_.responseTrailers();
+    const FilterCostTimer cost_timer((*entry)->filter_cost_);
     FilterDataStatus status = (*entry)->handle_->encodeData(data, (*entry)->end_stream_);
     if ((*entry)->end_stream_) {
       (*entry)->handle_->encodeComplete();
@@ -1272,6 +1292,7 @@ void FilterManager::encodeTrailers(ActiveStreamEncoderFilter* filter,
     }
     ASSERT(!(state_.filter_call_state_ & FilterCallState::EncodeTrailers));
     state_.filter_call_state_ |= FilterCallState::EncodeTrailers;
+    const FilterCostTimer cost_timer((*entry)->filter_cost_);
     FilterTrailersStatus status = (*entry)->handle_->encodeTrailers(trailers);
     (*entry)->handle_->encodeComplete();
     (*entry)->end_stream_ = true;
@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "envoy/buffer/buffer.h"
 #include "envoy/common/optref.h"
@@ -17,6 +18,7 @@
 
 #include "source/common/buffer/watermark_buffer.h"
 #include "source/common/common/dump_state_utils.h"
+#include "source/common/common/filter_cost.h"
 #include "source/common/common/linked_object.h"
 #include "source/common/common/logger.h"
 #include "source/common/grpc/common.h"
@@ -25,6 +27,7 @@
 #include "source/common/http/matching/data_impl.h"
 #include "source/common/local_reply/local_reply.h"
 #include "source/common/matcher/matcher.h"
+#include "source/common/memory/arena.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/stream_info/stream_info_impl.h"
 
@@ -95,7 +98,8 @@ struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
       : parent_(parent), iteration_state_(IterationState::Continue),
         filter_match_state_(std::move(match_state)), iterate_from_current_filter_(false),
         headers_continued_(false), continue_headers_continued_(false), end_stream_(false),
-        dual_filter_(dual_filter), decode_headers_called_(false), encode_headers_called_(false) {}
+        dual_filter_(dual_filter), decode_headers_called_(false), encode_headers_called_(false),
+        skip_remaining_callbacks_(false) {}
 
   // Functions in the following block are called after the filter finishes processing
   // corresponding data. Those functions handle state updates and data storage (if needed)
@@ -146,6 +150,7 @@ struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
   const ScopeTrackedObject& scope() override;
   void restoreContextOnContinue(ScopeTrackedObjectStack& tracked_object_stack) override;
   void resetIdleTimer() override;
+  void skipRemainingCallbacks() override { skip_remaining_callbacks_ = true; }
 
   // Functions to set or get iteration state.
   bool canIterate() { return iteration_state_ == IterationState::Continue; }
@@ -169,7 +174,9 @@ struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
     }
     return saved_response_metadata_.get();
   }
-  bool skipFilter() const { return filter_match_state_ && filter_match_state_->skipFilter(); }
+  bool skipFilter() const {
+    return skip_remaining_callbacks_ || (filter_match_state_ && filter_match_state_->skipFilter());
+  }
   void maybeEvaluateMatchTreeWithNewData(MatchDataUpdateFunc update_func) {
     if (filter_match_state_) {
       filter_match_state_->evaluateMatchTreeWithNewData(update_func);
@@ -207,6 +214,12 @@ struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
   const bool dual_filter_ : 1;
   bool decode_headers_called_ : 1;
   bool encode_headers_called_ : 1;
+  // If true, the filter asked not to be called again in this direction of the stream.
+  bool skip_remaining_callbacks_ : 1;
+  // The cost of the filter if the stream is sampled, shared by the wrappers of a dual filter. Each
+  // filter is charged for its callbacks and the bookkeeping of the FilterManager around them, less
+  // the callbacks of the other filters they go through.
+  FilterCost* filter_cost_{};
 
   friend FilterMatchState;
 };
@@ -221,6 +234,14 @@ struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
                             FilterMatchStateSharedPtr match_state, bool dual_filter)
       : ActiveStreamFilterBase(parent, dual_filter, std::move(match_state)), handle_(filter) {}
 
+  // Wrappers are allocated from the owning FilterManager's arena. Deleting one only runs the
+  // destructor; the memory is reclaimed when the FilterManager is destroyed.
+  static void* operator new(size_t size, Memory::Arena& arena) {
+    return arena.allocate(size, alignof(ActiveStreamDecoderFilter));
+  }
+  static void operator delete(void*) {}
+  static void operator delete(void*, Memory::Arena&) {}
+
   // ActiveStreamFilterBase
   bool canContinue() override;
   Buffer::InstancePtr createBuffer() override;
@@ -314,6 +335,14 @@ struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
                             FilterMatchStateSharedPtr match_state, bool dual_filter)
       : ActiveStreamFilterBase(parent, dual_filter, std::move(match_state)), handle_(filter) {}
 
+  // Wrappers are allocated from the owning FilterManager's arena. Deleting one only runs the
+  // destructor; the memory is reclaimed when the FilterManager is destroyed.
+  static void* operator new(size_t size, Memory::Arena& arena) {
+    return arena.allocate(size, alignof(ActiveStreamEncoderFilter));
+  }
+  static void operator delete(void*) {}
+  static void operator delete(void*, Memory::Arena&) {}
+
   // ActiveStreamFilterBase
   bool canContinue() override { return true; }
   Buffer::InstancePtr createBuffer() override;
@@ -737,6 +766,9 @@ public:
     addStreamEncoderFilterWorker(filter, nullptr, true);
   }
   void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) override;
+  void recordFilterCost(Stats::Histogram& cpu_time_us) override {
+    filter_costs_.push_back(std::make_unique<FilterCost>(cpu_time_us));
+  }
 
   void log() {
     RequestHeaderMap* request_headers = nullptr;
@@ -774,15 +806,21 @@ public:
     state_.destroyed_ = true;
 
     for (auto& filter : decoder_filters_) {
+      const FilterCostTimer cost_timer(filter->filter_cost_);
       filter->handle_->onDestroy();
     }
 
     for (auto& filter : encoder_filters_) {
       // Do not call on destroy twice for dual registered filters.
       if (!filter->dual_filter_) {
+        const FilterCostTimer cost_timer(filter->filter_cost_);
         filter->handle_->onDestroy();
       }
     }
+
+    for (const FilterCostPtr& filter_cost : filter_costs_) {
+      filter_cost->record();
+    }
   }
 
   /**
@@ -934,6 +972,10 @@ public:
   void contextOnContinue(ScopeTrackedObjectStack& tracked_object_stack);
 
 private:
+  // Enough inline storage for the decoder and encoder wrappers of a typical filter chain, so that
+  // building the chain does not allocate a heap block per filter.
+  static constexpr size_t FilterArenaInlineBytes = 1024;
+
   // Indicates which filter to start the iteration with.
   enum class FilterIterationStartState { AlwaysStartFromNext, CanStartFromCurrent };
 
@@ -1000,10 +1042,16 @@ private:
   Buffer::BufferMemoryAccountSharedPtr account_;
   const bool proxy_100_continue_;
 
+  // Backing storage for the filter wrappers below. It must be declared before the filter lists so
+  // that it outlives them.
+  Memory::InlineArena<FilterArenaInlineBytes> filter_arena_;
   std::list<ActiveStreamDecoderFilterPtr> decoder_filters_;
   std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
   std::list<StreamFilterBase*> filters_;
   std::list<AccessLog::InstanceSharedPtr> access_log_handlers_;
+  // The costs of the filters of a sampled stream, the last one being the cost of the filters added
+  // next.
+  std::vector<FilterCostPtr> filter_costs_;
 
   // Stores metadata added in the decoding filter that is being processed. Will be cleared before
   // processing the next filter. The storage is created on demand. We need to store metadata
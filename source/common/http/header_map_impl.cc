@@ -476,7 +476,7 @@ HeaderMap::GetResult HeaderMapImpl::get(const LowerCaseString& key) const {
 }
 
 HeaderMap::NonConstGetResult HeaderMapImpl::getExisting(absl::string_view key) {
-  // Attempt a trie lookup first to see if the user is requesting an O(1) header. This may be
+  // Attempt a hash lookup first to see if the user is requesting an O(1) header. This may be
   // relatively common in certain header matching / routing patterns.
   // TODO(mattklein123): Add inline handle support directly to the header matcher code to support
   // this use case more directly.
@@ -505,7 +505,7 @@ HeaderMap::NonConstGetResult HeaderMapImpl::getExisting(absl::string_view key) {
   }
 
   // If the requested header is not an O(1) header and the lazy map is not in use, we do a full
-  // scan. Doing the trie lookup is wasteful in the miss case, but is present for code consistency
+  // scan. Doing the hash lookup is wasteful in the miss case, but is present for code consistency
   // with other functions that do similar things.
   for (HeaderEntryImpl& header : headers_) {
     if (header.key() == key) {
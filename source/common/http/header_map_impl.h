@@ -6,6 +6,7 @@
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "envoy/common/optref.h"
 #include "envoy/http/header_map.h"
@@ -45,7 +46,7 @@ public:
 
 /**
  * Implementation of Http::HeaderMap. This is heavily optimized for performance. Roughly, when
- * headers are added to the map by string, we do a trie lookup to see if it's one of the O(1)
+ * headers are added to the map by string, we do a hash lookup to see if it's one of the O(1)
  * headers. If it is, we store a reference to it that can be accessed later directly via direct
  * method access. Most high performance paths use O(1) direct method access. In general, we try to
  * copy as little as possible and allocate as little as possible in any of the paths.
@@ -128,7 +129,7 @@ protected:
 
   /**
    * This is the static lookup table that is used to determine whether a header is one of the O(1)
-   * headers. This uses a trie for lookup time at most equal to the size of the incoming string.
+   * headers.
    */
   struct StaticLookupResponse {
     HeaderEntryImpl** entry_;
@@ -136,21 +137,34 @@ protected:
   };
 
   /**
-   * Base class for a static lookup table that converts a string key into an O(1) header.
+   * Base class for a static lookup table that converts a string key into an O(1) header. The set
+   * of inline headers (built in and custom) is fixed once the table is finalized, so lookups use a
+   * flat open addressing table keyed on the header length and its first, middle and last bytes,
+   * followed by a single full comparison. This costs one multiply and usually a single probe per
+   * lookup, independent of the key length.
    */
-  template <class Interface>
-  struct StaticLookupTable
-      : public TrieLookupTable<std::function<StaticLookupResponse(HeaderMapImpl&)>> {
+  template <class Interface> struct StaticLookupTable {
     StaticLookupTable();
 
     void finalizeTable() {
       CustomInlineHeaderRegistry::finalize<Interface::header_map_type>();
       auto& headers = CustomInlineHeaderRegistry::headers<Interface::header_map_type>();
       size_ = headers.size();
+
+      // Keep the load factor at or below one half so that probe sequences stay short.
+      uint32_t bits = 4;
+      while ((size_t(1) << bits) < headers.size() * 2) {
+        bits++;
+      }
+      shift_ = 32 - bits;
+      mask_ = (size_t(1) << bits) - 1;
+      slots_.resize(mask_ + 1);
       for (const auto& header : headers) {
-        this->add(header.first.get().c_str(), [&header](HeaderMapImpl& h) -> StaticLookupResponse {
-          return {&h.inlineHeaders()[header.second], &header.first};
-        });
+        size_t slot = slotFor(header.first.get());
+        while (slots_[slot].key_ != nullptr) {
+          slot = (slot + 1) & mask_;
+        }
+        slots_[slot] = {&header.first, header.second};
       }
     }
 
@@ -167,15 +181,44 @@ protected:
 
     static absl::optional<StaticLookupResponse> lookup(HeaderMapImpl& header_map,
                                                        absl::string_view key) {
-      const auto& entry = ConstSingleton<StaticLookupTable>::get().find(key);
-      if (entry != nullptr) {
-        return entry(header_map);
-      } else {
+      if (key.empty()) {
         return absl::nullopt;
       }
+      const auto& table = ConstSingleton<StaticLookupTable>::get();
+      for (size_t slot = table.slotFor(key);; slot = (slot + 1) & table.mask_) {
+        const Slot& candidate = table.slots_[slot];
+        if (candidate.key_ == nullptr) {
+          return absl::nullopt;
+        }
+        if (candidate.key_->get() == key) {
+          return StaticLookupResponse{&header_map.inlineHeaders()[candidate.index_],
+                                      candidate.key_};
+        }
+      }
+    }
+
+    struct Slot {
+      const LowerCaseString* key_{};
+      size_t index_{};
+    };
+
+    // Header names of the same length almost always differ in at least one of the first, middle
+    // or last byte, which makes these a cheap and distinctive hash input. Fibonacci hashing then
+    // spreads the packed value over the table.
+    size_t slotFor(absl::string_view key) const {
+      ASSERT(!key.empty());
+      const uint32_t first = static_cast<uint8_t>(key[0]);
+      const uint32_t middle = static_cast<uint8_t>(key[key.size() / 2]);
+      const uint32_t last = static_cast<uint8_t>(key[key.size() - 1]);
+      const uint32_t packed =
+          (static_cast<uint32_t>(key.size()) << 24) ^ (first << 16) ^ (middle << 8) ^ last;
+      return (packed * 2654435769u) >> shift_;
     }
 
     size_t size_;
+    uint32_t shift_;
+    size_t mask_;
+    std::vector<Slot> slots_;
   };
 
   /**
@@ -69,6 +69,9 @@ public:
   const LowerCaseString Etag{"etag"};
   const LowerCaseString Expires{"expires"};
   const LowerCaseString GrpcAcceptEncoding{"grpc-accept-encoding"};
+  const LowerCaseString GrpcEncoding{"grpc-encoding"};
+  // Set on the requests of the Google gRPC client to have the library compress the messages.
+  const LowerCaseString GrpcInternalEncodingRequest{"grpc-internal-encoding-request"};
   const LowerCaseString IfMatch{"if-match"};
   const LowerCaseString IfNoneMatch{"if-none-match"};
   const LowerCaseString IfModifiedSince{"if-modified-since"};
@@ -101,6 +104,7 @@ public:
   struct {
     const std::string Brotli{"br"};
     const std::string Gzip{"gzip"};
+    const std::string Zstd{"zstd"};
   } ContentEncodingValues;
 
   struct {
@@ -111,6 +115,10 @@ public:
     const std::string Default{"identity"};
   } GrpcAcceptEncodingValues;
 
+  struct {
+    const std::string Gzip{"gzip"};
+  } GrpcEncodingValues;
+
   struct {
     const std::string AcceptEncoding{"Accept-Encoding"};
     const std::string Wildcard{"*"};
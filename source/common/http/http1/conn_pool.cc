@@ -63,6 +63,10 @@ void ActiveClient::StreamWrapper::onDecodeComplete() {
     pool->scheduleOnUpstreamReady();
     parent_.stream_wrapper_.reset();
 
+    const auto& protocol_options = pool->host()->cluster().commonHttpProtocolOptions();
+    if (protocol_options.has_max_idle_connections()) {
+      pool->closeExcessIdleConnections(protocol_options.max_idle_connections().value());
+    }
     pool->checkForIdleAndCloseIdleConnsIfDraining();
   }
 }
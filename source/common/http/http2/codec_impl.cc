@@ -157,6 +157,21 @@ void ConnectionImpl::StreamImpl::destroy() {
   parent_.stats_.pending_send_bytes_.sub(pending_send_data_->length());
 }
 
+// Names and values which HPACK decoded from its static table are in storage which nghttp2 never
+// frees, so they are referenced rather than copied. Everything else is only valid for the duration
+// of the nghttp2 callback.
+static HeaderString headerStringFromRcbuf(nghttp2_rcbuf* rcbuf) {
+  const nghttp2_vec buf = nghttp2_rcbuf_get_buf(rcbuf);
+  const absl::string_view view(reinterpret_cast<const char*>(buf.base), buf.len);
+  HeaderString header_string;
+  if (nghttp2_rcbuf_is_static(rcbuf)) {
+    header_string.setReference(view);
+  } else {
+    header_string.setCopy(view);
+  }
+  return header_string;
+}
+
 static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& header) {
   uint8_t flags = 0;
   if (header.key().isReference()) {
@@ -174,6 +189,7 @@ static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& he
 
 void ConnectionImpl::StreamImpl::buildHeaders(std::vector<nghttp2_nv>& final_headers,
                                               const HeaderMap& headers) {
+  final_headers.clear();
   final_headers.reserve(headers.size());
   headers.iterate([&final_headers](const HeaderEntry& header) -> HeaderMap::Iterate {
     insertHeader(final_headers, header);
@@ -213,7 +229,7 @@ Status ConnectionImpl::ClientStreamImpl::encodeHeaders(const RequestHeaderMap& h
   RETURN_IF_ERROR(HeaderUtility::checkRequiredRequestHeaders(headers));
   // This must exist outside of the scope of isUpgrade as the underlying memory is
   // needed until encodeHeadersBase has been called.
-  std::vector<nghttp2_nv> final_headers;
+  std::vector<nghttp2_nv>& final_headers = parent_.outbound_headers_;
   Http::RequestHeaderMapPtr modified_headers;
   if (Http::Utility::isUpgrade(headers)) {
     modified_headers = createHeaderMap<RequestHeaderMapImpl>(headers);
@@ -247,7 +263,7 @@ void ConnectionImpl::ServerStreamImpl::encodeHeaders(const ResponseHeaderMap& he
 
   // This must exist outside of the scope of isUpgrade as the underlying memory is
   // needed until encodeHeadersBase has been called.
-  std::vector<nghttp2_nv> final_headers;
+  std::vector<nghttp2_nv>& final_headers = parent_.outbound_headers_;
   Http::ResponseHeaderMapPtr modified_headers;
   if (Http::Utility::isUpgrade(headers)) {
     modified_headers = createHeaderMap<ResponseHeaderMapImpl>(headers);
@@ -403,7 +419,7 @@ void ConnectionImpl::StreamImpl::submitTrailers(const HeaderMap& trailers) {
     return;
   }
 
-  std::vector<nghttp2_nv> final_headers;
+  std::vector<nghttp2_nv>& final_headers = parent_.outbound_headers_;
   buildHeaders(final_headers, trailers);
   int rc = nghttp2_submit_trailer(parent_.session_, stream_id_, final_headers.data(),
                                   final_headers.size());
@@ -1321,17 +1337,12 @@ ConnectionImpl::Http2Callbacks::Http2Callbacks() {
             std::move(status));
       });
 
-  nghttp2_session_callbacks_set_on_header_callback(
+  nghttp2_session_callbacks_set_on_header_callback2(
       callbacks_,
-      [](nghttp2_session*, const nghttp2_frame* frame, const uint8_t* raw_name, size_t name_length,
-         const uint8_t* raw_value, size_t value_length, uint8_t, void* user_data) -> int {
-        // TODO PERF: Can reference count here to avoid copies.
-        HeaderString name;
-        name.setCopy(reinterpret_cast<const char*>(raw_name), name_length);
-        HeaderString value;
-        value.setCopy(reinterpret_cast<const char*>(raw_value), value_length);
-        return static_cast<ConnectionImpl*>(user_data)->onHeader(frame, std::move(name),
-                                                                 std::move(value));
+      [](nghttp2_session*, const nghttp2_frame* frame, nghttp2_rcbuf* name, nghttp2_rcbuf* value,
+         uint8_t, void* user_data) -> int {
+        return static_cast<ConnectionImpl*>(user_data)->onHeader(frame, headerStringFromRcbuf(name),
+                                                                 headerStringFromRcbuf(value));
       });
 
   nghttp2_session_callbacks_set_on_data_chunk_recv_callback(
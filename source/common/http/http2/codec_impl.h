@@ -504,6 +504,10 @@ protected:
   uint32_t per_stream_buffer_limit_;
   bool allow_metadata_;
   const bool stream_error_on_invalid_http_messaging_;
+  // Reused to build the name/value array of every HEADERS frame submitted on this connection, to
+  // save allocating one per frame. nghttp2 copies the array on submit, so it is only used until
+  // the submit call returns.
+  std::vector<nghttp2_nv> outbound_headers_;
 
   // Status for any errors encountered by the nghttp2 callbacks.
   // nghttp2 library uses single return code to indicate callback failure and
@@ -79,6 +79,9 @@ struct DelegatingFactoryCallbacks : public Envoy::Http::FilterChainFactoryCallba
   void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) override {
     delegated_callbacks_.addAccessLogHandler(std::move(handler));
   }
+  void recordFilterCost(Stats::Histogram& cpu_time_us) override {
+    delegated_callbacks_.recordFilterCost(cpu_time_us);
+  }
 
   Envoy::Http::FilterChainFactoryCallbacks& delegated_callbacks_;
   Matcher::MatchTreeSharedPtr<Envoy::Http::HttpMatchingData> match_tree_;
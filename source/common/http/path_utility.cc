@@ -1,5 +1,7 @@
 #include "source/common/http/path_utility.h"
 
+#include <array>
+
 #include "source/common/common/logger.h"
 #include "source/common/http/legacy_path_canonicalizer.h"
 #include "source/common/runtime/runtime_features.h"
@@ -30,6 +32,28 @@ absl::optional<std::string> canonicalizePath(absl::string_view original_path) {
   return LegacyPathCanonicalizer::canonicalizePath(original_path);
 }
 
+// The characters the canonicalizer copies unchanged: the unreserved characters and the reserved
+// characters it does not escape. '%' and '\\' are not part of them, as escape sequences may be
+// unescaped or rejected and backslashes are turned into slashes, and '.' is checked separately
+// since "." and ".." segments are removed.
+constexpr std::array<bool, 256> canonicalPathChars() {
+  std::array<bool, 256> chars{};
+  for (char c = 'a'; c <= 'z'; c++) {
+    chars[static_cast<uint8_t>(c)] = true;
+  }
+  for (char c = 'A'; c <= 'Z'; c++) {
+    chars[static_cast<uint8_t>(c)] = true;
+  }
+  for (char c = '0'; c <= '9'; c++) {
+    chars[static_cast<uint8_t>(c)] = true;
+  }
+  for (const char* c = "!$&'()*+,-/:;=@[]_~"; *c != '\0'; c++) {
+    chars[static_cast<uint8_t>(*c)] = true;
+  }
+  return chars;
+}
+constexpr std::array<bool, 256> CanonicalPathChars = canonicalPathChars();
+
 void unescapeInPath(std::string& path, absl::string_view escape_sequence,
                     absl::string_view substitution) {
   std::vector<absl::string_view> split = absl::StrSplit(path, escape_sequence);
@@ -47,11 +71,13 @@ bool PathUtil::canonicalPath(RequestHeaderMap& headers) {
   const auto original_path = headers.getPathValue();
   // canonicalPath is supposed to apply on path component in URL instead of :path header
   const auto query_pos = original_path.find('?');
-  auto normalized_path_opt = canonicalizePath(
-      query_pos == original_path.npos
-          ? original_path
-          : absl::string_view(original_path.data(), query_pos) // '?' is not included
-  );
+  const absl::string_view path = original_path.substr(0, query_pos); // '?' is not included
+  // Most paths are canonical already, and are left in the header without going through the
+  // canonicalizer, which copies them.
+  if (isCanonicalPath(path)) {
+    return true;
+  }
+  auto normalized_path_opt = canonicalizePath(path);
 
   if (!normalized_path_opt.has_value()) {
     return false;
@@ -68,6 +94,27 @@ bool PathUtil::canonicalPath(RequestHeaderMap& headers) {
   return true;
 }
 
+bool PathUtil::isCanonicalPath(absl::string_view path) {
+  if (path.empty() || path[0] != '/') {
+    return false;
+  }
+  for (size_t i = 1; i < path.size(); i++) {
+    const char c = path[i];
+    if (c == '.') {
+      // The dots of a "." or ".." segment would be removed, those of other segments are kept.
+      if (path[i - 1] == '/') {
+        const size_t dots = i + 1 < path.size() && path[i + 1] == '.' ? 2 : 1;
+        if (i + dots == path.size() || path[i + dots] == '/') {
+          return false;
+        }
+      }
+    } else if (!CanonicalPathChars[static_cast<uint8_t>(c)]) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void PathUtil::mergeSlashes(RequestHeaderMap& headers) {
   ASSERT(headers.Path());
   const auto original_path = headers.getPathValue();
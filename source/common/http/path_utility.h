@@ -16,6 +16,10 @@ public:
   // If it is successful, the path header will be updated with the normalized path.
   // Requires the Path header be present.
   static bool canonicalPath(RequestHeaderMap& headers);
+  // Returns true if canonicalizing the path, without its query, would leave it unchanged. This
+  // only looks at its characters and its dot segments, so the paths with escape sequences or
+  // backslashes are reported as not canonical even when the canonicalizer would keep them.
+  static bool isCanonicalPath(absl::string_view path);
   // Merges two or more adjacent slashes in path part of URI into one.
   // Requires the Path header be present.
   static void mergeSlashes(RequestHeaderMap& headers);
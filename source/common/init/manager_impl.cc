@@ -29,7 +29,7 @@ void ManagerImpl::add(const Target& target) {
     // it's important in this case that count_ was incremented above before calling the target,
     // because if the target calls the init manager back immediately, count_ will be decremented
     // here (see the definition of watcher_ above).
-    target_handle->initialize(watcher_);
+    initializeTarget(*target_handle);
     return;
   case State::Initialized:
     // If the manager has already completed initialization, consider this a programming error.
@@ -43,6 +43,7 @@ void ManagerImpl::initialize(const Watcher& watcher) {
 
   // Create a handle to notify when initialization is complete.
   watcher_handle_ = watcher.createHandle(name_);
+  startup_step_ = StartupProfile::beginStep(StartupProfile::Kind::InitManager, name_);
 
   if (count_ == 0) {
     // If we have no targets, initialization trivially completes. This can happen, and is fine.
@@ -56,7 +57,7 @@ void ManagerImpl::initialize(const Watcher& watcher) {
     // Attempt to initialize each target. If a target is unavailable, treat it as though it
     // completed immediately.
     for (const auto& target_handle : target_handles_) {
-      if (!target_handle->initialize(watcher_)) {
+      if (!initializeTarget(*target_handle)) {
         onTargetReady(target_handle->name());
       }
     }
@@ -83,6 +84,15 @@ void ManagerImpl::onTargetReady(absl::string_view target_name) {
     target_names_count_.erase(target_name);
   }
 
+  auto steps = target_startup_steps_.find(target_name);
+  if (steps != target_startup_steps_.end()) {
+    StartupProfile::endStep(steps->second.back());
+    steps->second.pop_back();
+    if (steps->second.empty()) {
+      target_startup_steps_.erase(steps);
+    }
+  }
+
   // If there are no uninitialized targets remaining when called back by a target, that means it was
   // the last. Signal `ready` to the handle we saved in `initialize`.
   if (--count_ == 0) {
@@ -90,7 +100,17 @@ void ManagerImpl::onTargetReady(absl::string_view target_name) {
   }
 }
 
+bool ManagerImpl::initializeTarget(const TargetHandle& target_handle) {
+  const StartupProfile::StepId step = StartupProfile::beginStep(
+      StartupProfile::Kind::InitTarget, target_handle.name(), startup_step_);
+  if (step != StartupProfile::NoStep) {
+    target_startup_steps_[target_handle.name()].push_back(step);
+  }
+  return target_handle.initialize(watcher_);
+}
+
 void ManagerImpl::ready() {
+  StartupProfile::endStep(startup_step_);
   state_ = State::Initialized;
   watcher_handle_->ready();
 }
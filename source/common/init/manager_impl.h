@@ -1,10 +1,12 @@
 #pragma once
 
 #include <list>
+#include <vector>
 
 #include "envoy/init/manager.h"
 
 #include "source/common/common/logger.h"
+#include "source/common/init/startup_profile.h"
 #include "source/common/init/watcher_impl.h"
 
 #include "absl/container/flat_hash_map.h"
@@ -43,6 +45,9 @@ private:
   // 1, update target_names_count_ hash map.
   void onTargetReady(absl::string_view target_name);
 
+  // Initializes a target, recording the time it takes in the startup profile.
+  bool initializeTarget(const TargetHandle& target_handle);
+
   void ready();
 
   // Human-readable name for logging.
@@ -68,6 +73,12 @@ private:
 
   // Count of target_name of unready targets.
   absl::flat_hash_map<std::string, uint32_t> target_names_count_;
+
+  // Startup profile step for the whole of initialization.
+  StartupProfile::StepId startup_step_{StartupProfile::NoStep};
+
+  // Startup profile steps of initializing targets, by target_name.
+  absl::flat_hash_map<std::string, std::vector<StartupProfile::StepId>> target_startup_steps_;
 };
 
 } // namespace Init
@@ -0,0 +1,114 @@
+#include "source/common/init/startup_profile.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Init {
+
+namespace {
+
+std::string histogramName(StartupProfile::Kind kind, absl::string_view name) {
+  switch (kind) {
+  case StartupProfile::Kind::Phase:
+    return absl::StrCat("server.startup.", name, "_time_ms");
+  case StartupProfile::Kind::Cluster:
+    return "server.startup.cluster_warm_time_ms";
+  case StartupProfile::Kind::InitManager:
+    return "server.startup.init_manager_time_ms";
+  case StartupProfile::Kind::InitTarget:
+    return "server.startup.init_target_time_ms";
+  case StartupProfile::Kind::Xds:
+    return "server.startup.xds_first_update_time_ms";
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+} // namespace
+
+StartupProfile::StartupProfile(TimeSource& time_source) : time_source_(time_source) {
+  steps_.push_back({Kind::Phase, "total", time_source_.monotonicTime(), absl::nullopt, {}});
+}
+
+StartupProfile::StepId StartupProfile::begin(Kind kind, absl::string_view name, StepId parent) {
+  if (completed_) {
+    return NoStep;
+  }
+  if (parent >= steps_.size()) {
+    // The parent was not recorded, such as an init manager initialized before the profile began.
+    parent = StartupStep;
+  }
+  const StepId step = steps_.size();
+  steps_.push_back({kind, std::string(name), time_source_.monotonicTime(), absl::nullopt, {}});
+  steps_[parent].children_.push_back(step);
+  return step;
+}
+
+void StartupProfile::end(StepId step) {
+  if (step == NoStep || completed_) {
+    return;
+  }
+  ASSERT(step < steps_.size());
+  if (!steps_[step].end_.has_value()) {
+    steps_[step].end_ = time_source_.monotonicTime();
+  }
+}
+
+void StartupProfile::complete(Stats::Scope& scope) {
+  if (completed_) {
+    return;
+  }
+  end(StartupStep);
+  completed_ = true;
+  for (const Step& step : steps_) {
+    if (!step.end_.has_value()) {
+      continue;
+    }
+    scope.histogramFromString(histogramName(step.kind_, step.name_),
+                              Stats::Histogram::Unit::Milliseconds)
+        .recordValue(
+            std::chrono::duration_cast<std::chrono::milliseconds>(step.end_.value() - step.start_)
+                .count());
+  }
+}
+
+void StartupProfile::dump(envoy::admin::v3::StartupProfile& profile) const {
+  dumpStep(StartupStep, *profile.mutable_startup());
+}
+
+void StartupProfile::dumpStep(StepId step,
+                              envoy::admin::v3::StartupProfile::Step& step_dump) const {
+  const Step& current = steps_[step];
+  step_dump.set_name(current.name_);
+  *step_dump.mutable_start() = Protobuf::util::TimeUtil::NanosecondsToDuration(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(current.start_ -
+                                                           steps_[StartupStep].start_)
+          .count());
+  if (current.end_.has_value()) {
+    *step_dump.mutable_duration() = Protobuf::util::TimeUtil::NanosecondsToDuration(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(current.end_.value() -
+                                                             current.start_)
+            .count());
+  }
+  for (const StepId child : current.children_) {
+    dumpStep(child, *step_dump.add_steps());
+  }
+}
+
+StartupProfile::StepId StartupProfile::beginStep(Kind kind, absl::string_view name,
+                                                 StepId parent) {
+  StartupProfile* profile = StartupProfileSingleton::getExisting();
+  return profile != nullptr ? profile->begin(kind, name, parent) : NoStep;
+}
+
+void StartupProfile::endStep(StepId step) {
+  StartupProfile* profile = StartupProfileSingleton::getExisting();
+  if (profile != nullptr) {
+    profile->end(step);
+  }
+}
+
+} // namespace Init
+} // namespace Envoy
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "envoy/admin/v3/init_dump.pb.h"
+#include "envoy/common/time.h"
+#include "envoy/stats/scope.h"
+
+#include "source/common/singleton/threadsafe_singleton.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Init {
+
+/**
+ * Records when each step of server startup began and ended, from the construction of the server
+ * until it is ready to serve, so that the time to ready can be broken down into the phases of the
+ * server, the init managers and their targets, the warming of each cluster and the first update of
+ * each xDS subscription. Steps nest under the step that was running when they began, which gives
+ * the tree dumped at /init_dump?mask=startup.
+ *
+ * Once startup is complete, the durations are recorded once in histograms and any further steps
+ * are ignored, so the profile stays a fixed size for the lifetime of the server. The profile is
+ * only used from the main thread.
+ */
+class StartupProfile {
+public:
+  using StepId = uint32_t;
+
+  // The whole of startup, named "total", the root of the tree of steps.
+  static constexpr StepId StartupStep = 0;
+  // Returned when a step is not recorded.
+  static constexpr StepId NoStep = std::numeric_limits<StepId>::max();
+
+  /**
+   * What a step is the startup of, which decides the histogram its duration is recorded in.
+   */
+  enum class Kind {
+    // A phase of the server, recorded in server.startup.<name>_time_ms.
+    Phase,
+    // The warming of a cluster, recorded in server.startup.cluster_warm_time_ms.
+    Cluster,
+    // An init manager, recorded in server.startup.init_manager_time_ms.
+    InitManager,
+    // An init target, recorded in server.startup.init_target_time_ms.
+    InitTarget,
+    // The first update of an xDS subscription, recorded in
+    // server.startup.xds_first_update_time_ms.
+    Xds,
+  };
+
+  explicit StartupProfile(TimeSource& time_source);
+
+  /**
+   * Begins a step.
+   * @param kind what the step is the startup of.
+   * @param name a human-readable name for the step.
+   * @param parent the step this step is part of, or the whole of startup if it was not recorded.
+   * @return the step to pass to end(), or NoStep if startup has already completed.
+   */
+  StepId begin(Kind kind, absl::string_view name, StepId parent = StartupStep);
+
+  /**
+   * Ends a step begun by begin(). Ending NoStep, or a step which already ended, does nothing.
+   */
+  void end(StepId step);
+
+  /**
+   * Ends startup and records the duration of each step which ended in histograms in the scope.
+   * Steps begun afterwards are not recorded. Completing twice does nothing.
+   */
+  void complete(Stats::Scope& scope);
+
+  /**
+   * @return whether startup has completed.
+   */
+  bool completed() const { return completed_; }
+
+  /**
+   * Dumps the tree of steps. The start of each step is relative to the start of the server, and
+   * steps which have not ended have no duration.
+   */
+  void dump(envoy::admin::v3::StartupProfile& profile) const;
+
+  /**
+   * Begins a step in the profile of the server, if there is one.
+   * @return the step to pass to endStep(), or NoStep if there is no profile.
+   */
+  static StepId beginStep(Kind kind, absl::string_view name, StepId parent = StartupStep);
+
+  /**
+   * Ends a step in the profile of the server, if there is one.
+   */
+  static void endStep(StepId step);
+
+private:
+  struct Step {
+    Kind kind_;
+    std::string name_;
+    MonotonicTime start_;
+    absl::optional<MonotonicTime> end_;
+    std::vector<StepId> children_;
+  };
+
+  void dumpStep(StepId step, envoy::admin::v3::StartupProfile::Step& dump) const;
+
+  TimeSource& time_source_;
+  std::vector<Step> steps_;
+  bool completed_{};
+};
+
+using StartupProfileSingleton = InjectableSingleton<StartupProfile>;
+using ScopedStartupProfileSingleton = ScopedInjectableLoader<StartupProfile>;
+
+} // namespace Init
+} // namespace Envoy
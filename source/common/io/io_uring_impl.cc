@@ -0,0 +1,245 @@
+#include "source/common/io/io_uring_impl.h"
+
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/utility.h"
+
+namespace Envoy {
+namespace Io {
+
+namespace {
+
+int ioUringSetup(unsigned entries, struct io_uring_params* params) {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return static_cast<int>(
+      ::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int fd, unsigned opcode, const void* arg, unsigned nr_args) {
+  return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+template <typename T> T* ringPointer(void* ring_ptr, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<char*>(ring_ptr) + offset);
+}
+
+} // namespace
+
+bool IoUringImpl::isIoUringSupported() {
+  struct io_uring_params params {};
+  const int fd = ioUringSetup(2, &params);
+  if (fd < 0) {
+    return false;
+  }
+  ::close(fd);
+  return true;
+}
+
+IoUringImpl::IoUringImpl(uint32_t io_uring_size, bool use_submission_queue_polling)
+    : use_submission_queue_polling_(use_submission_queue_polling) {
+  struct io_uring_params params {};
+  if (use_submission_queue_polling_) {
+    params.flags |= IORING_SETUP_SQPOLL;
+  }
+  ring_fd_ = ioUringSetup(io_uring_size, &params);
+  RELEASE_ASSERT(ring_fd_ >= 0,
+                 fmt::format("unable to initialize io_uring: {}", errorDetails(errno)));
+
+  sq_entries_ = params.sq_entries;
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+
+  sq_ring_ptr_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  RELEASE_ASSERT(sq_ring_ptr_ != MAP_FAILED,
+                 fmt::format("unable to map io_uring submission queue: {}", errorDetails(errno)));
+  if (single_mmap) {
+    cq_ring_ptr_ = sq_ring_ptr_;
+  } else {
+    cq_ring_ptr_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+    RELEASE_ASSERT(cq_ring_ptr_ != MAP_FAILED,
+                   fmt::format("unable to map io_uring completion queue: {}", errorDetails(errno)));
+  }
+
+  sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring_fd_, IORING_OFF_SQES);
+  RELEASE_ASSERT(sqes != MAP_FAILED,
+                 fmt::format("unable to map io_uring submission entries: {}", errorDetails(errno)));
+  sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+  sq_head_ = ringPointer<unsigned>(sq_ring_ptr_, params.sq_off.head);
+  sq_tail_ = ringPointer<unsigned>(sq_ring_ptr_, params.sq_off.tail);
+  sq_ring_mask_ = ringPointer<unsigned>(sq_ring_ptr_, params.sq_off.ring_mask);
+  sq_flags_ = ringPointer<unsigned>(sq_ring_ptr_, params.sq_off.flags);
+  sq_array_ = ringPointer<unsigned>(sq_ring_ptr_, params.sq_off.array);
+  sqe_tail_ = *sq_tail_;
+
+  cq_head_ = ringPointer<unsigned>(cq_ring_ptr_, params.cq_off.head);
+  cq_tail_ = ringPointer<unsigned>(cq_ring_ptr_, params.cq_off.tail);
+  cq_ring_mask_ = ringPointer<unsigned>(cq_ring_ptr_, params.cq_off.ring_mask);
+  cqes_ = ringPointer<struct io_uring_cqe>(cq_ring_ptr_, params.cq_off.cqes);
+}
+
+IoUringImpl::~IoUringImpl() {
+  if (isEventfdRegistered()) {
+    unregisterEventfd();
+  }
+  ::munmap(sqes_, sqes_size_);
+  if (cq_ring_ptr_ != sq_ring_ptr_) {
+    ::munmap(cq_ring_ptr_, cq_ring_size_);
+  }
+  ::munmap(sq_ring_ptr_, sq_ring_size_);
+  ::close(ring_fd_);
+}
+
+os_fd_t IoUringImpl::registerEventfd() {
+  ASSERT(!isEventfdRegistered());
+  event_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  RELEASE_ASSERT(event_fd_ >= 0, fmt::format("unable to create eventfd: {}", errorDetails(errno)));
+  const int res = ioUringRegister(ring_fd_, IORING_REGISTER_EVENTFD, &event_fd_, 1);
+  RELEASE_ASSERT(res == 0,
+                 fmt::format("unable to register eventfd with io_uring: {}", errorDetails(errno)));
+  return event_fd_;
+}
+
+void IoUringImpl::unregisterEventfd() {
+  ASSERT(isEventfdRegistered());
+  const int res = ioUringRegister(ring_fd_, IORING_UNREGISTER_EVENTFD, nullptr, 0);
+  RELEASE_ASSERT(res == 0, fmt::format("unable to unregister eventfd from io_uring: {}",
+                                       errorDetails(errno)));
+  ::close(event_fd_);
+  SET_SOCKET_INVALID(event_fd_);
+}
+
+bool IoUringImpl::isEventfdRegistered() const { return SOCKET_VALID(event_fd_); }
+
+void IoUringImpl::forEveryCompletion(const CompletionCb& completion_cb) {
+  if (isEventfdRegistered()) {
+    // Reset the eventfd counter so that the event loop is only woken up again by completions
+    // posted after this point. The eventfd is non-blocking, EAGAIN just means it was not set.
+    uint64_t value;
+    static_cast<void>(::read(event_fd_, &value, sizeof(value)));
+  }
+
+  unsigned head = *cq_head_;
+  const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  for (; head != tail; ++head) {
+    const struct io_uring_cqe& cqe = cqes_[head & *cq_ring_mask_];
+    completion_cb(reinterpret_cast<void*>(cqe.user_data), cqe.res);
+  }
+  // Hand the consumed entries back to the kernel.
+  __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+}
+
+struct io_uring_sqe* IoUringImpl::getSqe(uint8_t opcode, os_fd_t fd, void* user_data) {
+  const unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (sqe_tail_ - head >= sq_entries_) {
+    return nullptr;
+  }
+  const unsigned index = sqe_tail_ & *sq_ring_mask_;
+  struct io_uring_sqe* sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->fd = fd;
+  sqe->user_data = reinterpret_cast<uint64_t>(user_data);
+  sq_array_[index] = index;
+  ++sqe_tail_;
+  return sqe;
+}
+
+IoUringResult IoUringImpl::prepareAccept(os_fd_t fd, struct sockaddr* remote_addr,
+                                         socklen_t* remote_addr_len, void* user_data) {
+  struct io_uring_sqe* sqe = getSqe(IORING_OP_ACCEPT, fd, user_data);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+  sqe->addr = reinterpret_cast<uint64_t>(remote_addr);
+  sqe->addr2 = reinterpret_cast<uint64_t>(remote_addr_len);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareConnect(os_fd_t fd, const struct sockaddr* address,
+                                          socklen_t address_len, void* user_data) {
+  struct io_uring_sqe* sqe = getSqe(IORING_OP_CONNECT, fd, user_data);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+  sqe->addr = reinterpret_cast<uint64_t>(address);
+  sqe->off = address_len;
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareReadv(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
+                                        off_t offset, void* user_data) {
+  struct io_uring_sqe* sqe = getSqe(IORING_OP_READV, fd, user_data);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+  sqe->addr = reinterpret_cast<uint64_t>(iovecs);
+  sqe->len = nr_vecs;
+  sqe->off = offset;
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareWritev(os_fd_t fd, const struct iovec* iovecs,
+                                         unsigned nr_vecs, off_t offset, void* user_data) {
+  struct io_uring_sqe* sqe = getSqe(IORING_OP_WRITEV, fd, user_data);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+  sqe->addr = reinterpret_cast<uint64_t>(iovecs);
+  sqe->len = nr_vecs;
+  sqe->off = offset;
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareClose(os_fd_t fd, void* user_data) {
+  return getSqe(IORING_OP_CLOSE, fd, user_data) == nullptr ? IoUringResult::Failed
+                                                           : IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::submit() {
+  // Publish all the prepared entries in one go: the kernel only looks at them once the tail
+  // moves.
+  __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+  const unsigned to_submit = sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (to_submit == 0) {
+    return IoUringResult::Ok;
+  }
+
+  unsigned flags = 0;
+  if (use_submission_queue_polling_) {
+    // The kernel side polling thread picks up the entries by itself unless it went idle.
+    if ((__atomic_load_n(sq_flags_, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP) == 0) {
+      return IoUringResult::Ok;
+    }
+    flags |= IORING_ENTER_SQ_WAKEUP;
+  }
+
+  const int res = ioUringEnter(ring_fd_, to_submit, 0, flags);
+  if (res < 0) {
+    RELEASE_ASSERT(errno == EBUSY,
+                   fmt::format("unable to submit io_uring queue entries: {}", errorDetails(errno)));
+    return IoUringResult::Busy;
+  }
+  return IoUringResult::Ok;
+}
+
+} // namespace Io
+} // namespace Envoy
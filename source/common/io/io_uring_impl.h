@@ -0,0 +1,82 @@
+#pragma once
+
+#include <linux/io_uring.h>
+
+#include "envoy/common/io/io_uring.h"
+
+#include "source/common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Io {
+
+/**
+ * io_uring implementation talking to the kernel through the raw io_uring_setup(2),
+ * io_uring_enter(2) and io_uring_register(2) system calls. The submission and completion queues
+ * are shared with the kernel through mmap(2)-ed memory, so preparing requests and reaping
+ * completions doesn't enter the kernel at all; only submit() does.
+ */
+class IoUringImpl : public IoUring, NonCopyable {
+public:
+  /**
+   * @param io_uring_size the number of entries in the submission queue. The kernel rounds it up
+   *        to the next power of two.
+   * @param use_submission_queue_polling whether the kernel should spawn a thread polling the
+   *        submission queue so that submit() doesn't need to enter the kernel under load.
+   */
+  IoUringImpl(uint32_t io_uring_size, bool use_submission_queue_polling);
+  ~IoUringImpl() override;
+
+  /**
+   * @return true if the running kernel supports io_uring.
+   */
+  static bool isIoUringSupported();
+
+  // IoUring
+  os_fd_t registerEventfd() override;
+  void unregisterEventfd() override;
+  bool isEventfdRegistered() const override;
+  void forEveryCompletion(const CompletionCb& completion_cb) override;
+  IoUringResult prepareAccept(os_fd_t fd, struct sockaddr* remote_addr,
+                              socklen_t* remote_addr_len, void* user_data) override;
+  IoUringResult prepareConnect(os_fd_t fd, const struct sockaddr* address, socklen_t address_len,
+                               void* user_data) override;
+  IoUringResult prepareReadv(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
+                             off_t offset, void* user_data) override;
+  IoUringResult prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
+                              off_t offset, void* user_data) override;
+  IoUringResult prepareClose(os_fd_t fd, void* user_data) override;
+  IoUringResult submit() override;
+
+private:
+  // Returns the next free submission queue entry or nullptr if the queue is full.
+  struct io_uring_sqe* getSqe(uint8_t opcode, os_fd_t fd, void* user_data);
+
+  os_fd_t ring_fd_{INVALID_SOCKET};
+  os_fd_t event_fd_{INVALID_SOCKET};
+  const bool use_submission_queue_polling_;
+
+  // Submission queue ring shared with the kernel.
+  void* sq_ring_ptr_{nullptr};
+  size_t sq_ring_size_{0};
+  unsigned* sq_head_{nullptr};
+  unsigned* sq_tail_{nullptr};
+  unsigned* sq_ring_mask_{nullptr};
+  unsigned* sq_flags_{nullptr};
+  unsigned* sq_array_{nullptr};
+  unsigned sq_entries_{0};
+  struct io_uring_sqe* sqes_{nullptr};
+  size_t sqes_size_{0};
+  // Tail of the locally prepared, but not yet published entries.
+  unsigned sqe_tail_{0};
+
+  // Completion queue ring shared with the kernel.
+  void* cq_ring_ptr_{nullptr};
+  size_t cq_ring_size_{0};
+  unsigned* cq_head_{nullptr};
+  unsigned* cq_tail_{nullptr};
+  unsigned* cq_ring_mask_{nullptr};
+  struct io_uring_cqe* cqes_{nullptr};
+};
+
+} // namespace Io
+} // namespace Envoy
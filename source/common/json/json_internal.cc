@@ -46,16 +46,16 @@ public:
 
   // Value factory.
   template <typename T> static FieldSharedPtr createValue(T value) {
-    return FieldSharedPtr{new Field(value)}; // NOLINT(modernize-make-shared)
+    return FieldSharedPtr{new Field(std::move(value))}; // NOLINT(modernize-make-shared)
   }
 
   void append(FieldSharedPtr field_ptr) {
     checkType(Type::Array);
-    value_.array_value_.push_back(field_ptr);
+    value_.array_value_.push_back(std::move(field_ptr));
   }
-  void insert(const std::string& key, FieldSharedPtr field_ptr) {
+  void insert(std::string key, FieldSharedPtr field_ptr) {
     checkType(Type::Object);
-    value_.object_value_[key] = field_ptr;
+    value_.object_value_[std::move(key)] = std::move(field_ptr);
   }
 
   uint64_t hash() const override;
@@ -122,7 +122,9 @@ private:
   };
 
   explicit Field(Type type) : type_(type) {}
-  explicit Field(const std::string& value) : type_(Type::String) { value_.string_value_ = value; }
+  explicit Field(std::string value) : type_(Type::String) {
+    value_.string_value_ = std::move(value);
+  }
   explicit Field(int64_t value) : type_(Type::Integer) { value_.integer_value_ = value; }
   explicit Field(double value) : type_(Type::Double) { value_.double_value_ = value; }
   explicit Field(bool value) : type_(Type::Boolean) { value_.boolean_value_ = value; }
@@ -141,7 +143,7 @@ private:
     checkType(Type::String);
     return value_.string_value_;
   }
-  std::vector<FieldSharedPtr> arrayValue() const {
+  const std::vector<FieldSharedPtr>& arrayValue() const {
     checkType(Type::Array);
     return value_.array_value_;
   }
@@ -194,7 +196,9 @@ public:
     return handleValueEvent(Field::createValue(value));
   }
   bool null() override { return handleValueEvent(Field::createNull()); }
-  bool string(std::string& value) override { return handleValueEvent(Field::createValue(value)); }
+  bool string(std::string& value) override {
+    return handleValueEvent(Field::createValue(std::move(value)));
+  }
   bool binary(binary_t&) override { return false; }
   bool parse_error(std::size_t, const std::string& token,
                    const nlohmann::detail::exception& ex) override {
@@ -452,7 +456,7 @@ std::vector<ObjectSharedPtr> Field::getObjectArray(const std::string& name,
                                 line_number_start_, line_number_end_));
   }
 
-  std::vector<FieldSharedPtr> array_value = value_itr->second->arrayValue();
+  const std::vector<FieldSharedPtr>& array_value = value_itr->second->arrayValue();
   return {array_value.begin(), array_value.end()};
 }
 
@@ -487,7 +491,7 @@ std::vector<std::string> Field::getStringArray(const std::string& name, bool all
                                 line_number_start_, line_number_end_));
   }
 
-  std::vector<FieldSharedPtr> array = value_itr->second->arrayValue();
+  const std::vector<FieldSharedPtr>& array = value_itr->second->arrayValue();
   string_array.reserve(array.size());
   for (const auto& element : array) {
     if (!element->isType(Type::String)) {
@@ -545,7 +549,7 @@ bool ObjectHandler::start_object(std::size_t) {
 
   switch (state_) {
   case State::ExpectValueOrStartObjectArray:
-    stack_.top()->insert(key_, object);
+    stack_.top()->insert(std::move(key_), object);
     stack_.push(object);
     state_ = State::ExpectKeyOrEndObject;
     return true;
@@ -586,7 +590,7 @@ bool ObjectHandler::end_object() {
 bool ObjectHandler::key(std::string& val) {
   switch (state_) {
   case State::ExpectKeyOrEndObject:
-    key_ = val;
+    key_ = std::move(val);
     state_ = State::ExpectValueOrStartObjectArray;
     return true;
   default:
@@ -600,7 +604,7 @@ bool ObjectHandler::start_array(std::size_t) {
 
   switch (state_) {
   case State::ExpectValueOrStartObjectArray:
-    stack_.top()->insert(key_, array);
+    stack_.top()->insert(std::move(key_), array);
     stack_.push(array);
     state_ = State::ExpectArrayValueOrEndArray;
     return true;
@@ -644,10 +648,10 @@ bool ObjectHandler::handleValueEvent(FieldSharedPtr ptr) {
   switch (state_) {
   case State::ExpectValueOrStartObjectArray:
     state_ = State::ExpectKeyOrEndObject;
-    stack_.top()->insert(key_, ptr);
+    stack_.top()->insert(std::move(key_), std::move(ptr));
     return true;
   case State::ExpectArrayValueOrEndArray:
-    stack_.top()->append(ptr);
+    stack_.top()->append(std::move(ptr));
     return true;
   default:
     return true;
@@ -7,7 +7,8 @@ namespace Matcher {
 
 /**
  * Implementation of a `sublinear` match tree that provides O(1) lookup of exact values,
- * with one OnMatch per result.
+ * with one OnMatch per result. Small maps are scanned linearly instead, which is faster than
+ * hashing the input for a few children.
  */
 template <class DataType>
 class ExactMapMatcher : public MatchTree<DataType>, Logger::Loggable<Logger::Id::matcher> {
@@ -27,14 +28,12 @@ public:
       return {MatchState::MatchComplete, on_no_match_};
     }
 
-    const auto itr = children_.find(*input.data_);
-    if (itr != children_.end()) {
-      const auto result = itr->second;
-
-      if (result.matcher_) {
-        return result.matcher_->match(data);
+    const OnMatch<DataType>* result = find(*input.data_);
+    if (result != nullptr) {
+      if (result->matcher_) {
+        return result->matcher_->match(data);
       } else {
-        return {MatchState::MatchComplete, OnMatch<DataType>{result.action_cb_, nullptr}};
+        return {MatchState::MatchComplete, OnMatch<DataType>{result->action_cb_, nullptr}};
       }
     } else if (input.data_availability_ ==
                DataInputGetResult::DataAvailability::MoreDataMightBeAvailable) {
@@ -47,11 +46,34 @@ public:
   }
 
   void addChild(std::string value, OnMatch<DataType>&& on_match) {
-    const auto itr_and_exists = children_.emplace(value, std::move(on_match));
-    ASSERT(itr_and_exists.second);
+    ASSERT(find(value) == nullptr);
+    if (children_.empty() && small_children_.size() < MaxSmallChildren) {
+      small_children_.emplace_back(std::move(value), std::move(on_match));
+      return;
+    }
+
+    for (auto& child : small_children_) {
+      children_.emplace(std::move(child.first), std::move(child.second));
+    }
+    small_children_.clear();
+    children_.emplace(std::move(value), std::move(on_match));
   }
 
 private:
+  // The number of children up to which they are scanned linearly rather than hashed.
+  static constexpr size_t MaxSmallChildren = 8;
+
+  const OnMatch<DataType>* find(absl::string_view value) const {
+    for (const auto& child : small_children_) {
+      if (child.first == value) {
+        return &child.second;
+      }
+    }
+    const auto itr = children_.find(value);
+    return itr != children_.end() ? &itr->second : nullptr;
+  }
+
+  std::vector<std::pair<std::string, OnMatch<DataType>>> small_children_;
   absl::flat_hash_map<std::string, OnMatch<DataType>> children_;
   const DataInputPtr<DataType> data_input_;
   const absl::optional<OnMatch<DataType>> on_no_match_;
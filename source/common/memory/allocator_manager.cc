@@ -0,0 +1,41 @@
+#include "source/common/memory/allocator_manager.h"
+
+#include "source/common/memory/utils.h"
+#include "source/common/protobuf/utility.h"
+#include "source/common/stats/symbol_table_impl.h"
+
+namespace Envoy {
+namespace Memory {
+
+AllocatorManager::AllocatorManager(
+    Event::Dispatcher& dispatcher,
+    const envoy::config::bootstrap::v3::MemoryAllocatorManager& config, Envoy::Stats::Scope& stats)
+    : bytes_to_release_(config.bytes_to_release()),
+      memory_release_interval_(
+          PROTOBUF_GET_MS_OR_DEFAULT(config, memory_release_interval, 1000)) {
+  if (config.has_max_total_thread_cache_bytes()) {
+    Utils::setMaxTotalThreadCacheBytes(config.max_total_thread_cache_bytes().value());
+  }
+  if (config.has_max_per_cpu_cache_bytes()) {
+    Utils::setMaxPerCpuCacheBytes(config.max_per_cpu_cache_bytes().value());
+  }
+
+  if (bytes_to_release_ > 0) {
+    Envoy::Stats::StatNameManagedStorage stat_name("memory_allocator_manager.released_by_timer",
+                                                   stats.symbolTable());
+    released_by_timer_ = &stats.counterFromStatName(stat_name.statName());
+    timer_ = dispatcher.createTimer([this] {
+      releaseFreeMemory();
+      timer_->enableTimer(memory_release_interval_);
+    });
+    timer_->enableTimer(memory_release_interval_);
+  }
+}
+
+void AllocatorManager::releaseFreeMemory() {
+  Utils::releaseFreeMemory(bytes_to_release_);
+  released_by_timer_->inc();
+}
+
+} // namespace Memory
+} // namespace Envoy
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats.h"
+
+namespace Envoy {
+namespace Memory {
+
+/**
+ * Configures the memory allocator from the bootstrap, bounding its caches and releasing a share of
+ * its free memory to the system on each interval, so that the memory freed after a traffic spike
+ * gets back to the system incrementally rather than staying resident.
+ */
+class AllocatorManager {
+public:
+  AllocatorManager(Event::Dispatcher& dispatcher,
+                   const envoy::config::bootstrap::v3::MemoryAllocatorManager& config,
+                   Envoy::Stats::Scope& stats);
+
+private:
+  void releaseFreeMemory();
+
+  const uint64_t bytes_to_release_;
+  const std::chrono::milliseconds memory_release_interval_;
+  Envoy::Stats::Counter* released_by_timer_{};
+  Envoy::Event::TimerPtr timer_;
+};
+
+} // namespace Memory
+} // namespace Envoy
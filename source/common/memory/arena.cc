@@ -0,0 +1,37 @@
+#include "source/common/memory/arena.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Memory {
+
+void* Arena::allocate(size_t size, size_t alignment) {
+  ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+  ASSERT(alignment <= alignof(std::max_align_t));
+
+  size_t padding = -reinterpret_cast<uintptr_t>(current_) & (alignment - 1);
+  if (padding + size > remaining_) {
+    newBlock(size);
+    // Heap blocks are aligned to alignof(std::max_align_t).
+    padding = 0;
+  }
+
+  void* result = current_ + padding;
+  current_ += padding + size;
+  remaining_ -= padding + size;
+  bytes_allocated_ += size;
+  return result;
+}
+
+void Arena::newBlock(size_t min_size) {
+  const size_t block_size = std::max(next_block_size_, min_size);
+  blocks_.emplace_back(new uint8_t[block_size]);
+  current_ = blocks_.back().get();
+  remaining_ = block_size;
+  next_block_size_ = std::min(block_size * 2, MaxBlockSize);
+}
+
+} // namespace Memory
+} // namespace Envoy
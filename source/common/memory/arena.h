@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "source/common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Memory {
+
+/**
+ * A bump-pointer allocator for objects that share the lifetime of a single owner, e.g. the filter
+ * chain of one HTTP stream. Allocations are carved out of blocks that are released together when
+ * the arena is destroyed; individual allocations are never freed. The arena does not run
+ * destructors, so owners must destroy the objects they placed in it before the arena goes away.
+ */
+class Arena : NonCopyable {
+public:
+  static constexpr size_t DefaultBlockSize = 1024;
+  static constexpr size_t MaxBlockSize = 16384;
+
+  explicit Arena(size_t block_size = DefaultBlockSize)
+      : Arena(nullptr, 0, block_size == 0 ? DefaultBlockSize : block_size) {}
+  virtual ~Arena() = default;
+
+  /**
+   * @param size supplies the number of bytes to allocate.
+   * @param alignment supplies the required alignment. Must be a power of two no larger than
+   *        alignof(std::max_align_t).
+   * @return pointer to uninitialized memory owned by the arena.
+   */
+  void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  /**
+   * @return the number of heap blocks the arena had to allocate so far. Storage provided at
+   *         construction time (see InlineArena) is not counted.
+   */
+  size_t heapBlocks() const { return blocks_.size(); }
+
+  /**
+   * @return the total number of bytes handed out by allocate(), excluding alignment padding.
+   */
+  size_t bytesAllocated() const { return bytes_allocated_; }
+
+protected:
+  Arena(uint8_t* initial_block, size_t initial_size, size_t block_size)
+      : current_(initial_block), remaining_(initial_size), next_block_size_(block_size) {}
+
+private:
+  void newBlock(size_t min_size);
+
+  uint8_t* current_;
+  size_t remaining_;
+  size_t next_block_size_;
+  size_t bytes_allocated_{};
+  std::vector<std::unique_ptr<uint8_t[]>> blocks_;
+};
+
+/**
+ * An Arena whose first InlineBytes are stored inside the arena object itself, so that an owner
+ * holding it by value pays no heap allocation until that space is exhausted.
+ */
+template <size_t InlineBytes> class InlineArena : public Arena {
+public:
+  InlineArena() : Arena(storage_, InlineBytes, InlineBytes) {}
+
+private:
+  alignas(std::max_align_t) uint8_t storage_[InlineBytes];
+};
+
+} // namespace Memory
+} // namespace Envoy
@@ -1,5 +1,6 @@
 #include "source/common/memory/heap_shrinker.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/memory/utils.h"
 #include "source/common/stats/symbol_table_impl.h"
 
@@ -31,6 +32,9 @@ HeapShrinker::HeapShrinker(Event::Dispatcher& dispatcher, Server::OverloadManage
 
 void HeapShrinker::shrinkHeap() {
   if (active_) {
+    // Each thread frees its pooled slice storage the next time it uses its pool, so that storage
+    // is released by a later run.
+    Buffer::Slice::trimPools();
     Utils::releaseFreeMemory();
     shrink_counter_->inc();
   }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
 
 namespace Envoy {
 namespace Memory {
@@ -45,6 +46,12 @@ public:
    */
   static uint64_t totalPhysicalBytes();
 
+  /**
+   * @return std::string detailed stats about current memory allocation, such as the free memory
+   *                     of each size class of the allocator. Empty when they are not available.
+   */
+  static std::string detailedStats();
+
   /**
    * Log detailed stats about current memory allocation. Intended for debugging purposes.
    */
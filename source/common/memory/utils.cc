@@ -1,6 +1,7 @@
 #include "source/common/memory/utils.h"
 
 #include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
 #include "source/common/memory/stats.h"
 
 #if defined(TCMALLOC)
@@ -27,6 +28,16 @@ void Utils::releaseFreeMemory() {
 #endif
 }
 
+void Utils::releaseFreeMemory(uint64_t bytes) {
+#if defined(TCMALLOC)
+  tcmalloc::MallocExtension::ReleaseMemoryToSystem(bytes);
+#elif defined(GPERFTOOLS_TCMALLOC)
+  MallocExtension::instance()->ReleaseToSystem(bytes);
+#else
+  UNREFERENCED_PARAMETER(bytes);
+#endif
+}
+
 /*
   The purpose of this function is to release the cache introduced by tcmalloc,
   mainly in xDS config updates, admin handler, and so on. all work on the main thread,
@@ -46,5 +57,23 @@ void Utils::tryShrinkHeap() {
 #endif
 }
 
+void Utils::setMaxTotalThreadCacheBytes(uint64_t bytes) {
+#if defined(TCMALLOC)
+  tcmalloc::MallocExtension::SetMaxTotalThreadCacheBytes(bytes);
+#elif defined(GPERFTOOLS_TCMALLOC)
+  MallocExtension::instance()->SetNumericProperty("tcmalloc.max_total_thread_cache_bytes", bytes);
+#else
+  UNREFERENCED_PARAMETER(bytes);
+#endif
+}
+
+void Utils::setMaxPerCpuCacheBytes(uint32_t bytes) {
+#if defined(TCMALLOC)
+  tcmalloc::MallocExtension::SetMaxPerCpuCacheSize(bytes);
+#else
+  UNREFERENCED_PARAMETER(bytes);
+#endif
+}
+
 } // namespace Memory
 } // namespace Envoy
@@ -1,12 +1,20 @@
 #pragma once
 
+#include <cstdint>
+
 namespace Envoy {
 namespace Memory {
 
 class Utils {
 public:
   static void releaseFreeMemory();
+  // Releases up to the given number of bytes of free memory to the system.
+  static void releaseFreeMemory(uint64_t bytes);
   static void tryShrinkHeap();
+  // Bounds the total size of the per-thread caches of the allocator.
+  static void setMaxTotalThreadCacheBytes(uint64_t bytes);
+  // Bounds the size of each of the per-CPU caches of the allocator, with tcmalloc only.
+  static void setMaxPerCpuCacheBytes(uint32_t bytes);
 };
 
 } // namespace Memory
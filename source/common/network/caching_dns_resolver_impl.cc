@@ -0,0 +1,166 @@
+#include "source/common/network/caching_dns_resolver_impl.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+#include "source/common/runtime/runtime_features.h"
+
+namespace Envoy {
+namespace Network {
+
+CachingDnsResolverImpl::~CachingDnsResolverImpl() {
+  for (const auto& resolution : in_flight_) {
+    if (resolution.second->query_ != nullptr) {
+      resolution.second->query_->cancel(ActiveDnsQuery::CancelReason::QueryAbandoned);
+    }
+  }
+}
+
+ActiveDnsQuery* CachingDnsResolverImpl::resolve(const std::string& dns_name,
+                                                DnsLookupFamily dns_lookup_family,
+                                                ResolveCb callback) {
+  if (!Runtime::runtimeFeatureEnabled("envoy.reloadable_features.dns_resolution_cache")) {
+    return resolver_->resolve(dns_name, dns_lookup_family, std::move(callback));
+  }
+
+  const Key key{dns_name, dns_lookup_family};
+  if (resolveFromCache(key, callback)) {
+    return nullptr;
+  }
+
+  auto existing = in_flight_.find(key);
+  if (existing != in_flight_.end()) {
+    ENVOY_LOG(trace, "joining in flight DNS resolution for {}", dns_name);
+    existing->second->pending_.push_back(
+        std::make_unique<PendingResolution>(*existing->second, std::move(callback)));
+    return existing->second->pending_.back().get();
+  }
+
+  auto resolution = std::make_unique<InFlightResolution>(*this, key);
+  resolution->pending_.push_back(
+      std::make_unique<PendingResolution>(*resolution, std::move(callback)));
+  InFlightResolution* started = resolution.get();
+  PendingResolution* pending = resolution->pending_.back().get();
+  in_flight_.emplace(key, std::move(resolution));
+
+  starting_ = started;
+  ActiveDnsQuery* query = resolver_->resolve(
+      dns_name, dns_lookup_family,
+      [this, key](ResolutionStatus status, std::list<DnsResponse>&& response) -> void {
+        onResolution(key, status, std::move(response));
+      });
+  if (starting_ != started) {
+    // The resolver invoked the callback inline.
+    return nullptr;
+  }
+  starting_ = nullptr;
+  started->query_ = query;
+  return pending;
+}
+
+void CachingDnsResolverImpl::PendingResolution::cancel(CancelReason reason) {
+  cancelled_ = true;
+  parent_.onCancel(reason);
+}
+
+void CachingDnsResolverImpl::InFlightResolution::onCancel(ActiveDnsQuery::CancelReason reason) {
+  if (completing_) {
+    return;
+  }
+  for (const auto& pending : pending_) {
+    if (!pending->cancelled_) {
+      return;
+    }
+  }
+
+  // Nobody is waiting for the resolution anymore.
+  if (query_ != nullptr) {
+    query_->cancel(reason);
+  }
+  parent_.in_flight_.erase(key_);
+}
+
+void CachingDnsResolverImpl::onResolution(const Key& key, ResolutionStatus status,
+                                          std::list<DnsResponse>&& response) {
+  auto it = in_flight_.find(key);
+  ASSERT(it != in_flight_.end());
+  InFlightResolutionPtr resolution = std::move(it->second);
+  in_flight_.erase(it);
+  if (starting_ == resolution.get()) {
+    starting_ = nullptr;
+  }
+
+  if (status == ResolutionStatus::Success) {
+    cacheResolution(key, response);
+  }
+
+  // The callbacks may start or cancel other resolutions, including of the same name.
+  resolution->completing_ = true;
+  while (!resolution->pending_.empty()) {
+    PendingResolutionPtr pending = std::move(resolution->pending_.front());
+    resolution->pending_.pop_front();
+    if (pending->cancelled_) {
+      continue;
+    }
+    if (resolution->pending_.empty()) {
+      pending->callback_(status, std::move(response));
+    } else {
+      std::list<DnsResponse> copy = response;
+      pending->callback_(status, std::move(copy));
+    }
+  }
+}
+
+bool CachingDnsResolverImpl::resolveFromCache(const Key& key, const ResolveCb& callback) {
+  auto it = cache_.find(key);
+  if (it == cache_.end()) {
+    return false;
+  }
+
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  if (it->second.expiry_ <= now) {
+    cache_.erase(it);
+    return false;
+  }
+
+  ENVOY_LOG(trace, "using cached DNS resolution for {}", key.first);
+  const auto cached_for =
+      std::chrono::duration_cast<std::chrono::seconds>(now - it->second.resolved_at_);
+  std::list<DnsResponse> response;
+  for (const auto& cached : it->second.response_) {
+    response.emplace_back(cached.address_, cached.ttl_ - cached_for);
+  }
+  callback(ResolutionStatus::Success, std::move(response));
+  return true;
+}
+
+void CachingDnsResolverImpl::cacheResolution(const Key& key,
+                                             const std::list<DnsResponse>& response) {
+  if (response.empty()) {
+    return;
+  }
+  const auto ttl = std::min_element(response.begin(), response.end(),
+                                    [](const DnsResponse& lhs, const DnsResponse& rhs) {
+                                      return lhs.ttl_ < rhs.ttl_;
+                                    })
+                       ->ttl_;
+  if (ttl.count() <= 0) {
+    return;
+  }
+
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  if (cache_.size() >= next_sweep_size_) {
+    for (auto it = cache_.begin(); it != cache_.end();) {
+      if (it->second.expiry_ <= now) {
+        cache_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+    next_sweep_size_ = std::max(MinSweepSize, 2 * cache_.size());
+  }
+  cache_.insert_or_assign(key, CachedResolution{response, now, now + ttl});
+}
+
+} // namespace Network
+} // namespace Envoy
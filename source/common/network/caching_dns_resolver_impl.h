@@ -0,0 +1,98 @@
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/network/dns.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * DnsResolver wrapping another resolver, to share its resolutions between the callers:
+ * concurrent resolutions of the same name and lookup family are only sent once, and successful
+ * resolutions are cached for the lowest TTL of their addresses. Cached resolutions are answered
+ * inline, with the TTLs of the addresses reduced by the time they have been cached for.
+ * All calls and callbacks are assumed to happen on the thread of the dispatcher.
+ */
+class CachingDnsResolverImpl : public DnsResolver,
+                               protected Logger::Loggable<Logger::Id::upstream> {
+public:
+  CachingDnsResolverImpl(Event::Dispatcher& dispatcher, DnsResolverSharedPtr resolver)
+      : dispatcher_(dispatcher), resolver_(std::move(resolver)) {}
+  ~CachingDnsResolverImpl() override;
+
+  // Network::DnsResolver
+  ActiveDnsQuery* resolve(const std::string& dns_name, DnsLookupFamily dns_lookup_family,
+                          ResolveCb callback) override;
+
+private:
+  using Key = std::pair<std::string, DnsLookupFamily>;
+  struct InFlightResolution;
+
+  struct PendingResolution : public ActiveDnsQuery {
+    PendingResolution(InFlightResolution& parent, ResolveCb callback)
+        : parent_(parent), callback_(std::move(callback)) {}
+
+    // Network::ActiveDnsQuery
+    void cancel(CancelReason reason) override;
+
+    InFlightResolution& parent_;
+    const ResolveCb callback_;
+    bool cancelled_{false};
+  };
+
+  using PendingResolutionPtr = std::unique_ptr<PendingResolution>;
+
+  /**
+   * Resolution sent to the wrapped resolver, for all the callers waiting for the same name.
+   */
+  struct InFlightResolution {
+    InFlightResolution(CachingDnsResolverImpl& parent, const Key& key)
+        : parent_(parent), key_(key) {}
+
+    void onCancel(ActiveDnsQuery::CancelReason reason);
+
+    CachingDnsResolverImpl& parent_;
+    const Key key_;
+    ActiveDnsQuery* query_{};
+    std::list<PendingResolutionPtr> pending_;
+    // Whether the callbacks are being invoked, and the resolution is no longer in parent_.
+    bool completing_{false};
+  };
+
+  using InFlightResolutionPtr = std::unique_ptr<InFlightResolution>;
+
+  struct CachedResolution {
+    std::list<DnsResponse> response_;
+    MonotonicTime resolved_at_;
+    MonotonicTime expiry_;
+  };
+
+  void onResolution(const Key& key, ResolutionStatus status, std::list<DnsResponse>&& response);
+  bool resolveFromCache(const Key& key, const ResolveCb& callback);
+  void cacheResolution(const Key& key, const std::list<DnsResponse>& response);
+
+  Event::Dispatcher& dispatcher_;
+  const DnsResolverSharedPtr resolver_;
+  absl::flat_hash_map<Key, InFlightResolutionPtr> in_flight_;
+  absl::flat_hash_map<Key, CachedResolution> cache_;
+  // Resolution being sent to the resolver, reset if the resolver completes it inline.
+  InFlightResolution* starting_{};
+  // Size the cache has to reach before it is next swept of its expired resolutions.
+  size_t next_sweep_size_{MinSweepSize};
+
+  static constexpr size_t MinSweepSize = 1024;
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -1,5 +1,9 @@
 #include "source/common/network/connection_balancer_impl.h"
 
+#include <thread>
+
+#include "source/common/common/assert.h"
+
 namespace Envoy {
 namespace Network {
 
@@ -34,5 +38,82 @@ ExactConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler&) {
   return *min_connection_handler;
 }
 
+PowerOfTwoChoicesConnectionBalancerImpl::PowerOfTwoChoicesConnectionBalancerImpl(
+    Random::RandomGenerator& random, uint32_t max_handlers, bool weight_by_loop_duration)
+    : random_(random), max_handlers_(max_handlers),
+      weight_by_loop_duration_(weight_by_loop_duration),
+      slots_(std::make_unique<Slot[]>(max_handlers)) {
+  ASSERT(max_handlers_ > 0);
+}
+
+void PowerOfTwoChoicesConnectionBalancerImpl::registerHandler(BalancedConnectionHandler& handler) {
+  absl::MutexLock lock(&lock_);
+  for (uint32_t i = 0; i < max_handlers_; ++i) {
+    if (slots_[i].handler_.load() == nullptr) {
+      slots_[i].handler_.store(&handler);
+      return;
+    }
+  }
+  // The handler still balances its own connections, it is just never picked as a target.
+}
+
+void PowerOfTwoChoicesConnectionBalancerImpl::unregisterHandler(
+    BalancedConnectionHandler& handler) {
+  absl::MutexLock lock(&lock_);
+  for (uint32_t i = 0; i < max_handlers_; ++i) {
+    Slot& slot = slots_[i];
+    if (slot.handler_.load() == &handler) {
+      slot.handler_.store(nullptr);
+      // Picks only hold a pin for a few loads and an increment, so spinning is cheaper than making
+      // picks signal. Both the store above and the pin in pickTargetHandler() are sequentially
+      // consistent, so a pick either sees the slot cleared or is seen here.
+      while (slot.pins_.load() != 0) {
+        std::this_thread::yield();
+      }
+      return;
+    }
+  }
+}
+
+BalancedConnectionHandler&
+PowerOfTwoChoicesConnectionBalancerImpl::pickTargetHandler(
+    BalancedConnectionHandler& current_handler) {
+  const uint64_t random = random_.random();
+  Slot* const sampled[] = {&slots_[(random & 0xFFFFFFFF) % max_handlers_],
+                           &slots_[(random >> 32) % max_handlers_]};
+  BalancedConnectionHandler* target = nullptr;
+  uint64_t target_load = 0;
+  for (Slot* slot : sampled) {
+    slot->pins_.fetch_add(1);
+    BalancedConnectionHandler* handler = slot->handler_.load();
+    if (handler == nullptr) {
+      // An empty slot keeps the connection on the current handler.
+      handler = &current_handler;
+    }
+    const uint64_t handler_load = load(*handler);
+    // On ties prefer the current handler, which avoids posting the connection to another worker.
+    if (target == nullptr || handler_load < target_load ||
+        (handler_load == target_load && handler == &current_handler)) {
+      target = handler;
+      target_load = handler_load;
+    }
+  }
+  target->incNumConnections();
+  for (Slot* slot : sampled) {
+    slot->pins_.fetch_sub(1);
+  }
+
+  return *target;
+}
+
+uint64_t PowerOfTwoChoicesConnectionBalancerImpl::load(BalancedConnectionHandler& handler) const {
+  const uint64_t connections = handler.numConnections();
+  if (!weight_by_loop_duration_) {
+    return connections;
+  }
+  // Without measured durations each factor is 1, which compares the connection counts alone.
+  return (connections + 1) * (handler.averageLoopDuration().count() + 1);
+}
+
 } // namespace Network
 } // namespace Envoy
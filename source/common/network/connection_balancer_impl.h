@@ -1,5 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+
+#include "envoy/common/random_generator.h"
 #include "envoy/network/connection_balancer.h"
 
 #include "absl/synchronization/mutex.h"
@@ -21,12 +25,58 @@ public:
   void registerHandler(BalancedConnectionHandler& handler) override;
   void unregisterHandler(BalancedConnectionHandler& handler) override;
   BalancedConnectionHandler& pickTargetHandler(BalancedConnectionHandler& current_handler) override;
+  void onConnectionClosed(BalancedConnectionHandler&) override {}
 
 private:
   absl::Mutex lock_;
   std::vector<BalancedConnectionHandler*> handlers_ ABSL_GUARDED_BY(lock_);
 };
 
+/**
+ * Implementation of connection balancer that hands each connection to the less loaded of two
+ * handlers picked at random (the "power of two choices"). No lock is held while balancing: handlers
+ * are kept in fixed slots, and a pick pins the two slots it samples while it reads and increments
+ * the connection counts of their handlers, so that unregisterHandler() only has to wait for the
+ * picks in flight on the slot of the handler. Comparing two random handlers keeps connection
+ * counts close to those of exact balancing while each pick only touches the two sampled slots,
+ * which suits listeners with many worker threads and a high accept rate.
+ */
+class PowerOfTwoChoicesConnectionBalancerImpl : public ConnectionBalancer {
+public:
+  /**
+   * @param random supplies the random generator used to sample handlers.
+   * @param max_handlers supplies the maximum number of handlers registered at once, typically the
+   *        number of worker threads. Handlers registered beyond that are never picked as targets.
+   * @param weight_by_loop_duration supplies whether the connection count of each handler is
+   *        weighted by the average event loop duration of its worker.
+   */
+  PowerOfTwoChoicesConnectionBalancerImpl(Random::RandomGenerator& random, uint32_t max_handlers,
+                                          bool weight_by_loop_duration);
+
+  // ConnectionBalancer
+  void registerHandler(BalancedConnectionHandler& handler) override;
+  void unregisterHandler(BalancedConnectionHandler& handler) override;
+  BalancedConnectionHandler& pickTargetHandler(BalancedConnectionHandler& current_handler) override;
+  void onConnectionClosed(BalancedConnectionHandler&) override {}
+
+private:
+  // Aligned so that picks on different slots do not contend on a cache line.
+  struct alignas(64) Slot {
+    std::atomic<BalancedConnectionHandler*> handler_{};
+    // The number of picks that may be using handler_.
+    std::atomic<uint32_t> pins_{};
+  };
+
+  uint64_t load(BalancedConnectionHandler& handler) const;
+
+  Random::RandomGenerator& random_;
+  const uint32_t max_handlers_;
+  const bool weight_by_loop_duration_;
+  const std::unique_ptr<Slot[]> slots_;
+  // Serializes registration. Never taken while balancing.
+  absl::Mutex lock_;
+};
+
 /**
  * A NOP connection balancer implementation that always continues execution after incrementing
  * the handler's connection count.
@@ -42,6 +92,7 @@ public:
     current_handler.incNumConnections();
     return current_handler;
   }
+  void onConnectionClosed(BalancedConnectionHandler&) override {}
 };
 
 } // namespace Network
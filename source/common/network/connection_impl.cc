@@ -128,6 +128,10 @@ void ConnectionImpl::removeReadFilter(ReadFilterSharedPtr filter) {
 
 bool ConnectionImpl::initializeReadFilters() { return filter_manager_.initializeReadFilters(); }
 
+void ConnectionImpl::recordFilterCost(Stats::Histogram& cpu_time_us) {
+  filter_manager_.recordFilterCost(cpu_time_us);
+}
+
 void ConnectionImpl::close(ConnectionCloseType type) {
   if (!ioHandle().isOpen()) {
     return;
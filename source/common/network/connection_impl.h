@@ -59,6 +59,7 @@ public:
   void addReadFilter(ReadFilterSharedPtr filter) override;
   void removeReadFilter(ReadFilterSharedPtr filter) override;
   bool initializeReadFilters() override;
+  void recordFilterCost(Stats::Histogram& cpu_time_us) override;
 
   // Network::Connection
   void addBytesSentCallback(BytesSentCb cb) override;
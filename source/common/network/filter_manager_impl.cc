@@ -9,9 +9,18 @@
 namespace Envoy {
 namespace Network {
 
+FilterManagerImpl::~FilterManagerImpl() {
+  for (const FilterCostPtr& filter_cost : filter_costs_) {
+    filter_cost->record();
+  }
+}
+
 void FilterManagerImpl::addWriteFilter(WriteFilterSharedPtr filter) {
   ASSERT(connection_.state() == Connection::State::Open);
   ActiveWriteFilterPtr new_filter = std::make_unique<ActiveWriteFilter>(*this, filter);
+  if (!filter_costs_.empty()) {
+    new_filter->filter_cost_ = filter_costs_.back().get();
+  }
   filter->initializeWriteFilterCallbacks(*new_filter);
   LinkedList::moveIntoList(std::move(new_filter), downstream_filters_);
 }
@@ -24,6 +33,9 @@ void FilterManagerImpl::addFilter(FilterSharedPtr filter) {
 void FilterManagerImpl::addReadFilter(ReadFilterSharedPtr filter) {
   ASSERT(connection_.state() == Connection::State::Open);
   ActiveReadFilterPtr new_filter = std::make_unique<ActiveReadFilter>(*this, filter);
+  if (!filter_costs_.empty()) {
+    new_filter->filter_cost_ = filter_costs_.back().get();
+  }
   filter->initializeReadFilterCallbacks(*new_filter);
   LinkedList::moveIntoListBack(std::move(new_filter), upstream_filters_);
 }
@@ -37,6 +49,10 @@ void FilterManagerImpl::removeReadFilter(ReadFilterSharedPtr filter_to_remove) {
   }
 }
 
+void FilterManagerImpl::recordFilterCost(Stats::Histogram& cpu_time_us) {
+  filter_costs_.push_back(std::make_unique<FilterCost>(cpu_time_us));
+}
+
 bool FilterManagerImpl::initializeReadFilters() {
   if (upstream_filters_.empty()) {
     return false;
@@ -65,6 +81,7 @@ void FilterManagerImpl::onContinueReading(ActiveReadFilter* filter,
     if (!(*entry)->filter_) {
       continue;
     }
+    const FilterCostTimer cost_timer((*entry)->filter_cost_);
     if (!(*entry)->initialized_) {
       (*entry)->initialized_ = true;
       FilterStatus status = (*entry)->filter_->onNewConnection();
@@ -107,6 +124,7 @@ FilterStatus FilterManagerImpl::onWrite(ActiveWriteFilter* filter,
 
   for (; entry != downstream_filters_.end(); entry++) {
     StreamBuffer write_buffer = buffer_source.getWriteBuffer();
+    const FilterCostTimer cost_timer((*entry)->filter_cost_);
     FilterStatus status = (*entry)->filter_->onWrite(write_buffer.buffer, write_buffer.end_stream);
     if (status == FilterStatus::StopIteration || connection_.state() != Connection::State::Open) {
       return FilterStatus::StopIteration;
@@ -2,11 +2,13 @@
 
 #include <list>
 #include <memory>
+#include <vector>
 
 #include "envoy/network/connection.h"
 #include "envoy/network/filter.h"
 #include "envoy/network/socket.h"
 
+#include "source/common/common/filter_cost.h"
 #include "source/common/common/linked_object.h"
 
 namespace Envoy {
@@ -103,12 +105,14 @@ class FilterManagerImpl {
 public:
   FilterManagerImpl(FilterManagerConnection& connection, const Socket& socket)
       : connection_(connection), socket_(socket) {}
+  ~FilterManagerImpl();
 
   void addWriteFilter(WriteFilterSharedPtr filter);
   void addFilter(FilterSharedPtr filter);
   void addReadFilter(ReadFilterSharedPtr filter);
   void removeReadFilter(ReadFilterSharedPtr filter);
   bool initializeReadFilters();
+  void recordFilterCost(Stats::Histogram& cpu_time_us);
   void onRead();
   FilterStatus onWrite();
 
@@ -133,6 +137,8 @@ private:
 
     FilterManagerImpl& parent_;
     ReadFilterSharedPtr filter_;
+    // The cost the callbacks of the filter are charged to, if the connection is sampled.
+    FilterCost* filter_cost_{};
     bool initialized_{};
   };
 
@@ -151,6 +157,8 @@ private:
 
     FilterManagerImpl& parent_;
     WriteFilterSharedPtr filter_;
+    // The cost the callbacks of the filter are charged to, if the connection is sampled.
+    FilterCost* filter_cost_{};
   };
 
   using ActiveWriteFilterPtr = std::unique_ptr<ActiveWriteFilter>;
@@ -165,6 +173,9 @@ private:
   Upstream::HostDescriptionConstSharedPtr host_description_;
   std::list<ActiveReadFilterPtr> upstream_filters_;
   std::list<ActiveWriteFilterPtr> downstream_filters_;
+  // The costs of the filters of a sampled connection, the last one being charged for the filters
+  // added next.
+  std::vector<FilterCostPtr> filter_costs_;
 };
 
 } // namespace Network
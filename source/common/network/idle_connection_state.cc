@@ -0,0 +1,13 @@
+#include "source/common/network/idle_connection_state.h"
+
+#include "source/common/common/macros.h"
+
+namespace Envoy {
+namespace Network {
+
+const std::string& IdleConnectionState::key() {
+  CONSTRUCT_ON_FIRST_USE(std::string, "envoy.network.idle_connection_state");
+}
+
+} // namespace Network
+} // namespace Envoy
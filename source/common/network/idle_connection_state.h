@@ -0,0 +1,30 @@
+#pragma once
+
+#include "envoy/common/time.h"
+#include "envoy/stream_info/filter_state.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * Set by the network filters of the downstream connections which can be handed off to another
+ * process while they are idle, such as the HTTP/1 connection manager between requests. The
+ * connections without it are never handed off.
+ */
+class IdleConnectionState : public StreamInfo::FilterState::Object {
+public:
+  /**
+   * @param idle_since supplies since when the connection is idle, or nullopt if it is in use.
+   */
+  void setIdleSince(absl::optional<MonotonicTime> idle_since) { idle_since_ = idle_since; }
+  const absl::optional<MonotonicTime>& idleSince() const { return idle_since_; }
+  static const std::string& key();
+
+private:
+  absl::optional<MonotonicTime> idle_since_;
+};
+
+} // namespace Network
+} // namespace Envoy
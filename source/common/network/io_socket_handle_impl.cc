@@ -1,15 +1,22 @@
 #include "source/common/network/io_socket_handle_impl.h"
 
 #include "envoy/buffer/buffer.h"
+#include "envoy/event/deferred_deletable.h"
 
 #include "source/common/api/os_sys_calls_impl.h"
 #include "source/common/common/utility.h"
 #include "source/common/event/file_event_impl.h"
 #include "source/common/network/address_impl.h"
+#include "source/common/runtime/runtime_features.h"
 
 #include "absl/container/fixed_array.h"
 #include "absl/types/optional.h"
 
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+#include <linux/errqueue.h>
+#define ENVOY_MSG_ZEROCOPY
+#endif
+
 using Envoy::Api::SysCallIntResult;
 using Envoy::Api::SysCallSizeResult;
 
@@ -58,10 +65,126 @@ constexpr int messageTruncatedOption() {
 #endif
 }
 
+constexpr uint64_t MaxWriteSlices = 16;
+
 } // namespace
 
 namespace Network {
 
+#ifdef ENVOY_MSG_ZEROCOPY
+bool ZeroCopySendState::reapCompletions(os_fd_t fd) {
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  while (outstanding()) {
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+    msghdr message{};
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    if (os_sys_calls.recvmsg(fd, &message, MSG_ERRQUEUE).rc_ < 0) {
+      // Most likely EAGAIN, i.e. no notifications are queued.
+      break;
+    }
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&message, cmsg)) {
+      if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+          !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+        continue;
+      }
+      const auto* error = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cmsg));
+      if (error->ee_errno != 0 || error->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+        continue;
+      }
+      if (enabled_ && (error->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0) {
+        // The kernel had to copy the data anyway, e.g. on loopback or if the device doesn't support
+        // scatter-gather I/O. Pinning the data only adds overhead then.
+        ENVOY_LOG(debug, "fd {}: kernel copied zero-copy send, disabling MSG_ZEROCOPY", fd);
+        enabled_ = false;
+      }
+      // [ee_info, ee_data] is the range of sequence numbers which completed. TCP completes sends
+      // in order, so everything up to ee_data can be released.
+      onCompleted(error->ee_data);
+    }
+  }
+  return outstanding();
+}
+#else
+bool ZeroCopySendState::reapCompletions(os_fd_t) { return outstanding(); }
+#endif
+
+void ZeroCopySendState::onCompleted(uint32_t last_sequence) {
+  while (outstanding() && static_cast<int32_t>(last_sequence - next_sequence_) >= 0) {
+    pinned_.drain(pending_sends_.front());
+    pending_sends_.pop_front();
+    ++next_sequence_;
+  }
+}
+
+namespace {
+
+/**
+ * Keeps a closed socket open until the kernel completed all of its outstanding zero-copy sends, so
+ * that the pinned data isn't released while the kernel may still read it. Owns itself and is
+ * deferred deleted once done.
+ */
+class ZeroCopyCloseDrainer : public Event::DeferredDeletable {
+public:
+  static void start(Event::Dispatcher& dispatcher, os_fd_t fd, ZeroCopySendStatePtr&& state) {
+    // Ownership is handed to the dispatcher when done.
+    new ZeroCopyCloseDrainer(dispatcher, fd, std::move(state));
+  }
+
+  ~ZeroCopyCloseDrainer() override {
+    file_event_.reset();
+    Api::OsSysCallsSingleton::get().close(fd_);
+  }
+
+private:
+  // Bounds how long a peer which stopped reading can keep the socket and its data alive.
+  static constexpr std::chrono::seconds DrainTimeout{30};
+
+  ZeroCopyCloseDrainer(Event::Dispatcher& dispatcher, os_fd_t fd, ZeroCopySendStatePtr&& state)
+      : dispatcher_(dispatcher), fd_(fd), state_(std::move(state)) {
+    // Error queue notifications are reported as read readiness.
+    file_event_ = dispatcher_.createFileEvent(
+        fd_,
+        [this](uint32_t) {
+          if (!state_->reapCompletions(fd_)) {
+            done();
+          }
+        },
+        Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+    timer_ = dispatcher_.createTimer([this]() { onTimeout(); });
+    timer_->enableTimer(DrainTimeout);
+  }
+
+  void onTimeout() {
+    // Reset the connection instead of closing it gracefully: the kernel must not send data out of
+    // memory that is about to be reused.
+    const struct linger abort_linger = {1, 0};
+    Api::OsSysCallsSingleton::get().setsockopt(fd_, SOL_SOCKET, SO_LINGER, &abort_linger,
+                                               sizeof(abort_linger));
+    done();
+  }
+
+  void done() {
+    if (finished_) {
+      return;
+    }
+    finished_ = true;
+    file_event_->setEnabled(0);
+    timer_->disableTimer();
+    dispatcher_.deferredDelete(Event::DeferredDeletablePtr{this});
+  }
+
+  Event::Dispatcher& dispatcher_;
+  const os_fd_t fd_;
+  ZeroCopySendStatePtr state_;
+  Event::FileEventPtr file_event_;
+  Event::TimerPtr timer_;
+  bool finished_{false};
+};
+
+} // namespace
+
 IoSocketHandleImpl::~IoSocketHandleImpl() {
   if (SOCKET_VALID(fd_)) {
     IoSocketHandleImpl::close();
@@ -74,6 +197,11 @@ Api::IoCallUint64Result IoSocketHandleImpl::close() {
   }
 
   ASSERT(SOCKET_VALID(fd_));
+  if (zero_copy_ != nullptr && zero_copy_->reapCompletions(fd_) && dispatcher_ != nullptr) {
+    ZeroCopyCloseDrainer::start(*dispatcher_, fd_, std::move(zero_copy_));
+    SET_SOCKET_INVALID(fd_);
+    return Api::ioCallUint64ResultNoError();
+  }
   const int rc = Api::OsSysCallsSingleton::get().close(fd_).rc_;
   SET_SOCKET_INVALID(fd_);
   return Api::IoCallUint64Result(rc, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
@@ -161,8 +289,16 @@ Api::IoCallUint64Result IoSocketHandleImpl::writev(const Buffer::RawSlice* slice
 }
 
 Api::IoCallUint64Result IoSocketHandleImpl::write(Buffer::Instance& buffer) {
-  constexpr uint64_t MaxSlices = 16;
-  Buffer::RawSliceVector slices = buffer.getRawSlices(MaxSlices);
+  if (zero_copy_ != nullptr) {
+    if (zero_copy_->outstanding()) {
+      zero_copy_->reapCompletions(fd_);
+    }
+    if (zero_copy_->enabled_ && buffer.length() >= zero_copy_->threshold_) {
+      return writeZeroCopy(buffer);
+    }
+  }
+
+  Buffer::RawSliceVector slices = buffer.getRawSlices(MaxWriteSlices);
   Api::IoCallUint64Result result = writev(slices.begin(), slices.size());
   if (result.ok() && result.rc_ > 0) {
     buffer.drain(static_cast<uint64_t>(result.rc_));
@@ -179,6 +315,46 @@ Api::IoCallUint64Result IoSocketHandleImpl::write(Buffer::Instance& buffer) {
   return result;
 }
 
+#ifdef ENVOY_MSG_ZEROCOPY
+Api::IoCallUint64Result IoSocketHandleImpl::writeZeroCopy(Buffer::Instance& buffer) {
+  Buffer::RawSliceVector slices = buffer.getRawSlices(MaxWriteSlices);
+  absl::FixedArray<iovec> iov(slices.size());
+  uint64_t num_slices_to_write = 0;
+  for (const Buffer::RawSlice& slice : slices) {
+    if (slice.mem_ != nullptr && slice.len_ != 0) {
+      iov[num_slices_to_write].iov_base = slice.mem_;
+      iov[num_slices_to_write].iov_len = slice.len_;
+      num_slices_to_write++;
+    }
+  }
+  msghdr message{};
+  message.msg_iov = iov.begin();
+  message.msg_iovlen = num_slices_to_write;
+  const Api::SysCallSizeResult result =
+      Api::OsSysCallsSingleton::get().sendmsg(fd_, &message, MSG_ZEROCOPY);
+  if (result.rc_ < 0 && result.errno_ == ENOBUFS) {
+    // The kernel ran out of option memory to track the pinned pages, e.g. because too many sends
+    // are outstanding. Copy this chunk instead.
+    ENVOY_LOG(trace, "fd {}: MSG_ZEROCOPY send failed with ENOBUFS, copying instead", fd_);
+    Api::IoCallUint64Result copy_result = writev(slices.begin(), slices.size());
+    if (copy_result.ok() && copy_result.rc_ > 0) {
+      buffer.drain(copy_result.rc_);
+    }
+    return copy_result;
+  }
+
+  Api::IoCallUint64Result io_result = sysCallResultToIoCallResult(result);
+  if (io_result.ok() && io_result.rc_ > 0) {
+    zero_copy_->onSent(buffer, io_result.rc_);
+  }
+  return io_result;
+}
+#else
+Api::IoCallUint64Result IoSocketHandleImpl::writeZeroCopy(Buffer::Instance&) {
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+#endif
+
 Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slices,
                                                     uint64_t num_slice, int flags,
                                                     const Address::Ip* self_ip,
@@ -537,7 +713,12 @@ IoHandlePtr IoSocketHandleImpl::accept(struct sockaddr* addr, socklen_t* addrlen
     return nullptr;
   }
 
-  return std::make_unique<IoSocketHandleImpl>(result.rc_, socket_v6only_, domain_);
+  auto io_handle = std::make_unique<IoSocketHandleImpl>(result.rc_, socket_v6only_, domain_);
+  if (zero_copy_ != nullptr) {
+    // Accepted sockets inherit SO_ZEROCOPY from the listening socket.
+    io_handle->zero_copy_ = std::make_unique<ZeroCopySendState>(zero_copy_->threshold_);
+  }
+  return io_handle;
 }
 
 Api::SysCallIntResult IoSocketHandleImpl::connect(Address::InstanceConstSharedPtr address) {
@@ -546,7 +727,17 @@ Api::SysCallIntResult IoSocketHandleImpl::connect(Address::InstanceConstSharedPt
 
 Api::SysCallIntResult IoSocketHandleImpl::setOption(int level, int optname, const void* optval,
                                                     socklen_t optlen) {
-  return Api::OsSysCallsSingleton::get().setsockopt(fd_, level, optname, optval, optlen);
+  const Api::SysCallIntResult result =
+      Api::OsSysCallsSingleton::get().setsockopt(fd_, level, optname, optval, optlen);
+#ifdef ENVOY_MSG_ZEROCOPY
+  // Large writes on sockets configured with SO_ZEROCOPY are sent with MSG_ZEROCOPY.
+  if (result.rc_ == 0 && level == SOL_SOCKET && optname == SO_ZEROCOPY &&
+      optlen == sizeof(int) && *static_cast<const int*>(optval) != 0 && zero_copy_ == nullptr) {
+    zero_copy_ = std::make_unique<ZeroCopySendState>(
+        Runtime::getInteger("envoy.network.zero_copy_send_threshold_bytes", 16384));
+  }
+#endif
+  return result;
 }
 
 Api::SysCallIntResult IoSocketHandleImpl::getOption(int level, int optname, void* optval,
@@ -618,6 +809,7 @@ void IoSocketHandleImpl::initializeFileEvent(Event::Dispatcher& dispatcher, Even
   ASSERT(file_event_ == nullptr, "Attempting to initialize two `file_event_` for the same "
                                  "file descriptor. This is not allowed.");
   file_event_ = dispatcher.createFileEvent(fd_, cb, trigger, events);
+  dispatcher_ = &dispatcher;
 }
 
 void IoSocketHandleImpl::activateFileEvents(uint32_t events) {
@@ -1,17 +1,63 @@
 #pragma once
 
+#include <deque>
+
 #include "envoy/api/io_error.h"
 #include "envoy/api/os_sys_calls.h"
 #include "envoy/common/platform.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/network/io_handle.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/logger.h"
 #include "source/common/network/io_socket_error_impl.h"
 
 namespace Envoy {
 namespace Network {
 
+/**
+ * Bookkeeping for MSG_ZEROCOPY sends. The kernel references the memory of a zero-copy send until
+ * it posts a completion notification to the socket error queue, so the written data is pinned
+ * here instead of being drained from the write buffer.
+ */
+class ZeroCopySendState : Logger::Loggable<Logger::Id::io> {
+public:
+  explicit ZeroCopySendState(uint64_t threshold) : threshold_(threshold) {}
+
+  /**
+   * Pins the first bytes_sent bytes of the buffer, which have just been sent with MSG_ZEROCOPY.
+   */
+  void onSent(Buffer::Instance& buffer, uint64_t bytes_sent) {
+    pinned_.movePinned(buffer, bytes_sent);
+    pending_sends_.push_back(bytes_sent);
+  }
+
+  /**
+   * Reads all the notifications from the socket error queue and releases the data of completed
+   * sends.
+   * @return whether any send is still waiting for its completion.
+   */
+  bool reapCompletions(os_fd_t fd);
+
+  bool outstanding() const { return !pending_sends_.empty(); }
+
+  // Whether sends at least threshold_ bytes long should use MSG_ZEROCOPY.
+  bool enabled_{true};
+  const uint64_t threshold_;
+
+private:
+  void onCompleted(uint32_t last_sequence);
+
+  Buffer::OwnedImpl pinned_;
+  // Length of every send that has not completed yet, oldest first.
+  std::deque<uint64_t> pending_sends_;
+  // Sequence number the kernel assigned to the send at the front of pending_sends_. The kernel
+  // numbers successful zero-copy sends on a socket consecutively starting from zero.
+  uint32_t next_sequence_{0};
+};
+
+using ZeroCopySendStatePtr = std::unique_ptr<ZeroCopySendState>;
+
 /**
  * IoHandle derivative for sockets.
  */
@@ -100,10 +146,17 @@ protected:
              : Api::IoErrorPtr(new IoSocketError(result.errno_), IoSocketError::deleteIoError)));
   }
 
+  // Writes the front of the buffer with MSG_ZEROCOPY, and keeps the written data alive until the
+  // kernel reports the send as completed.
+  Api::IoCallUint64Result writeZeroCopy(Buffer::Instance& buffer);
+
   os_fd_t fd_;
   int socket_v6only_{false};
   const absl::optional<int> domain_;
   Event::FileEventPtr file_event_{nullptr};
+  Event::Dispatcher* dispatcher_{nullptr};
+  // Only set once SO_ZEROCOPY has been enabled on the socket.
+  ZeroCopySendStatePtr zero_copy_;
 
   // The minimum cmsg buffer size to filled in destination address, packets dropped and gso
   // size when receiving a packet. It is possible for a received packet to contain both IPv4
@@ -456,6 +456,18 @@ private:
       ASSERT(next_free_index <= trie_.size());
       trie_.resize(next_free_index);
       trie_.shrink_to_fit();
+
+      // The prefixes are only needed to build the trie_, lookups use their compact leaves.
+      leaves_.reserve(ip_prefixes_.size());
+      for (const auto& prefix : ip_prefixes_) {
+        const IpType mask =
+            prefix.length_ == 0 ? IpType(0) : ~IpType(0) << (address_size - prefix.length_);
+        const uint32_t data_begin = static_cast<uint32_t>(leaf_data_.size());
+        leaf_data_.insert(leaf_data_.end(), prefix.data_.begin(), prefix.data_.end());
+        leaves_.push_back(
+            {prefix.ip_ & mask, mask, data_begin, static_cast<uint32_t>(leaf_data_.size())});
+      }
+      std::vector<IpPrefix<IpType>>().swap(ip_prefixes_);
     }
 
     // Thin wrapper around computeBranch output to facilitate code readability.
@@ -669,7 +681,7 @@ private:
      * This value can be between 0 and 127, so IPv6 is supported.
      * - Address: the remaining 20 bits represent an index either into the trie_ or the
      * ip_prefixes_. If branch_ != 0, the index is for the trie_. If branch == zero, the index is
-     * for the ip_prefixes_.
+     * for the ip_prefixes_, and so the leaves_.
      *
      * Note: If more than 2^19-1 CIDR ranges are to be stored in trie_, uint64_t should be used
      * instead.
@@ -680,12 +692,29 @@ private:
       uint32_t address_ : 20; // If this 20-bit size changes, please change MaxLcTrieNodes too.
     };
 
+    /**
+     * The CIDR range of a leaf node, with its mask computed once, and the range of its data in
+     * leaf_data_. The data of all the leaves is kept in one vector, so that a lookup copies it
+     * from contiguous memory rather than iterating a hash set.
+     */
+    struct Leaf {
+      // The address masked to the length of the CIDR range, in host byte order.
+      IpType ip_;
+      IpType mask_;
+      uint32_t data_begin_;
+      uint32_t data_end_;
+    };
+
+    // The CIDR ranges sorted, only kept while building the trie_.
+    std::vector<IpPrefix<IpType>> ip_prefixes_;
+
     // The CIDR range and data needs to be maintained separately from the LC-Trie. A LC-Trie skips
     // chunks of data while searching for a match. This means that the node found in the LC-Trie
     // is not guaranteed to have the IP address in range. The last step prior to returning
     // associated data is to check the CIDR range pointed to by the node in the LC-Trie has
     // the IP address in range.
-    std::vector<IpPrefix<IpType>> ip_prefixes_;
+    std::vector<Leaf> leaves_;
+    std::vector<T> leaf_data_;
 
     // Main trie search structure.
     std::vector<LcNode> trie_;
@@ -735,9 +764,10 @@ LcTrie<T>::LcTrieInternal<IpType, address_size>::getData(const IpType& ip_addres
   // The path taken through the trie to match the ip_address may have contained skips,
   // so it is necessary to check whether the matched prefix really contains the
   // ip_address.
-  const auto& prefix = ip_prefixes_[address];
-  if (prefix.contains(ip_address)) {
-    return std::vector<T>(prefix.data_.begin(), prefix.data_.end());
+  const Leaf& leaf = leaves_[address];
+  if ((ip_address & leaf.mask_) == leaf.ip_) {
+    return std::vector<T>(leaf_data_.begin() + leaf.data_begin_,
+                          leaf_data_.begin() + leaf.data_end_);
   }
   return std::vector<T>();
 }
@@ -0,0 +1,70 @@
+#include "source/common/network/listener_filter_peek_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "envoy/common/platform.h"
+
+#include "source/common/network/io_socket_error_impl.h"
+
+namespace Envoy {
+namespace Network {
+
+namespace {
+
+struct PeekedData {
+  // The peek buffer holding the data, or nullptr if no socket's data is held.
+  const ListenerFilterPeekBuffer* owner_{};
+  // The bytes asked for when peeking at the socket, and those received.
+  uint64_t requested_{};
+  uint64_t length_{};
+  std::unique_ptr<uint8_t[]> data_;
+  uint64_t capacity_{};
+};
+
+PeekedData& peekedData() {
+  static thread_local PeekedData peeked_data;
+  return peeked_data;
+}
+
+} // namespace
+
+ListenerFilterPeekBuffer::~ListenerFilterPeekBuffer() { release(); }
+
+Api::IoCallUint64Result ListenerFilterPeekBuffer::peek(void* buffer, uint64_t length) {
+  PeekedData& peeked = peekedData();
+  if (peeked.owner_ != this || (peeked.length_ < length && peeked.requested_ < length)) {
+    peeked.owner_ = nullptr;
+    if (peeked.capacity_ < length) {
+      peeked.data_.reset(new uint8_t[length]);
+      peeked.capacity_ = length;
+    }
+    Api::IoCallUint64Result result = socket_.ioHandle().recv(peeked.data_.get(), length, MSG_PEEK);
+    if (!result.ok()) {
+      return result;
+    }
+    peeked.owner_ = this;
+    peeked.requested_ = length;
+    peeked.length_ = result.rc_;
+    if (release_cb_ == nullptr) {
+      release_cb_ = dispatcher_.createSchedulableCallback([this]() { release(); });
+    }
+    if (!release_cb_->enabled()) {
+      release_cb_->scheduleCallbackCurrentIteration();
+    }
+  }
+  const uint64_t bytes_peeked = std::min(length, peeked.length_);
+  memcpy(buffer, peeked.data_.get(), bytes_peeked);
+  return {bytes_peeked, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError)};
+}
+
+void ListenerFilterPeekBuffer::release() {
+  PeekedData& peeked = peekedData();
+  if (peeked.owner_ == this) {
+    peeked.owner_ = nullptr;
+  }
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/schedulable_cb.h"
+#include "envoy/network/listen_socket.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * The data peeked at by the listener filters of an accepted socket. The data is peeked into a
+ * buffer of the thread, which holds the data of the socket which peeked last until the end of the
+ * event loop iteration: the filters of the socket which peek in turn during the iteration are
+ * served from there, unless they ask for more data than asked for when peeking at the socket.
+ * Data arriving later is peeked at the next read event of a filter.
+ */
+class ListenerFilterPeekBuffer {
+public:
+  ListenerFilterPeekBuffer(ConnectionSocket& socket, Event::Dispatcher& dispatcher)
+      : socket_(socket), dispatcher_(dispatcher) {}
+  ~ListenerFilterPeekBuffer();
+
+  /**
+   * Peek at the data received on the socket, like a recv() with MSG_PEEK.
+   * @param buffer supplies the buffer to copy the data peeked into.
+   * @param length supplies the maximum number of bytes to peek.
+   * @return the result of the peek, with the number of bytes copied into the buffer.
+   */
+  Api::IoCallUint64Result peek(void* buffer, uint64_t length);
+
+private:
+  void release();
+
+  ConnectionSocket& socket_;
+  Event::Dispatcher& dispatcher_;
+  Event::SchedulableCallbackPtr release_cb_;
+};
+
+} // namespace Network
+} // namespace Envoy
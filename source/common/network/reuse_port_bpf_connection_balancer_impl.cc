@@ -0,0 +1,276 @@
+#include "source/common/network/reuse_port_bpf_connection_balancer_impl.h"
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "source/common/common/assert.h"
+
+#if defined(__linux__)
+#include <linux/bpf.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(SO_ATTACH_REUSEPORT_EBPF) && defined(__NR_bpf)
+#define ENVOY_REUSE_PORT_BPF_BALANCE 1
+#endif
+#endif
+
+namespace Envoy {
+namespace Network {
+
+namespace {
+
+#ifdef ENVOY_REUSE_PORT_BPF_BALANCE
+// The count of a slot without a handler, so that the slot is never selected.
+constexpr uint64_t UnusedSlotCount = std::numeric_limits<uint64_t>::max();
+
+int bpf(int cmd, bpf_attr& attr) { return syscall(__NR_bpf, cmd, &attr, sizeof(attr)); }
+
+int createMap(bpf_map_type type, uint32_t value_size, uint32_t max_entries, uint32_t flags) {
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_type = type;
+  attr.key_size = sizeof(uint32_t);
+  attr.value_size = value_size;
+  attr.max_entries = max_entries;
+  attr.map_flags = flags;
+  return bpf(BPF_MAP_CREATE, attr);
+}
+
+int updateElement(int map_fd, uint32_t key, const void* value) {
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_fd = map_fd;
+  attr.key = reinterpret_cast<uint64_t>(&key);
+  attr.value = reinterpret_cast<uint64_t>(value);
+  attr.flags = BPF_ANY;
+  return bpf(BPF_MAP_UPDATE_ELEM, attr);
+}
+
+int deleteElement(int map_fd, uint32_t key) {
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_fd = map_fd;
+  attr.key = reinterpret_cast<uint64_t>(&key);
+  return bpf(BPF_MAP_DELETE_ELEM, attr);
+}
+
+bpf_insn instruction(uint8_t code, uint8_t dst, uint8_t src, int16_t off, int32_t imm) {
+  bpf_insn insn;
+  memset(&insn, 0, sizeof(insn));
+  insn.code = code;
+  insn.dst_reg = dst;
+  insn.src_reg = src;
+  insn.off = off;
+  insn.imm = imm;
+  return insn;
+}
+
+void loadMapFd(std::vector<bpf_insn>& program, uint8_t dst, int map_fd) {
+  // A 64 bit immediate load takes two instructions.
+  program.push_back(instruction(BPF_LD | BPF_DW | BPF_IMM, dst, BPF_PSEUDO_MAP_FD, 0, map_fd));
+  program.push_back(instruction(0, 0, 0, 0, 0));
+}
+
+// Builds an SK_REUSEPORT program selecting the socket of the slot with the lowest count. The loop
+// over slots is unrolled as the verifier rejects loops on older kernels:
+//
+//   r6 = ctx; r7 = UINT64_MAX; r8 = 0
+//   for each slot:
+//     count = bpf_map_lookup_elem(counts, &slot)
+//     if (count != NULL && *count < r7) { r7 = *count; r8 = slot }
+//   bpf_sk_select_reuseport(ctx, sockets, &r8, 0)
+//   return SK_PASS
+//
+// If no socket can be selected the kernel falls back to hashing over the SO_REUSEPORT group.
+std::vector<bpf_insn> buildProgram(int counts_map_fd, int sockets_map_fd, uint32_t slots) {
+  std::vector<bpf_insn> program;
+  program.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1, 0, 0));
+  program.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_7, 0, 0, -1));
+  program.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_8, 0, 0, 0));
+  for (uint32_t slot = 0; slot < slots; ++slot) {
+    const int32_t key = static_cast<int32_t>(slot);
+    program.push_back(instruction(BPF_ST | BPF_MEM | BPF_W, BPF_REG_10, 0, -4, key));
+    program.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_2, BPF_REG_10, 0, 0));
+    program.push_back(instruction(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_2, 0, 0, -4));
+    loadMapFd(program, BPF_REG_1, counts_map_fd);
+    program.push_back(instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_map_lookup_elem));
+    program.push_back(instruction(BPF_JMP | BPF_JEQ | BPF_K, BPF_REG_0, 0, 4, 0));
+    program.push_back(instruction(BPF_LDX | BPF_MEM | BPF_DW, BPF_REG_3, BPF_REG_0, 0, 0));
+    program.push_back(instruction(BPF_JMP | BPF_JGE | BPF_X, BPF_REG_3, BPF_REG_7, 2, 0));
+    program.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_7, BPF_REG_3, 0, 0));
+    program.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_8, 0, 0, key));
+  }
+  program.push_back(instruction(BPF_STX | BPF_MEM | BPF_W, BPF_REG_10, BPF_REG_8, -8, 0));
+  program.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_1, BPF_REG_6, 0, 0));
+  loadMapFd(program, BPF_REG_2, sockets_map_fd);
+  program.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_3, BPF_REG_10, 0, 0));
+  program.push_back(instruction(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_3, 0, 0, -8));
+  program.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_4, 0, 0, 0));
+  program.push_back(instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_sk_select_reuseport));
+  program.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, SK_PASS));
+  program.push_back(instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0));
+  return program;
+}
+
+int loadProgram(const std::vector<bpf_insn>& program) {
+  static const char license[] = "Apache-2.0";
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.prog_type = BPF_PROG_TYPE_SK_REUSEPORT;
+  attr.insns = reinterpret_cast<uint64_t>(program.data());
+  attr.insn_cnt = program.size();
+  attr.license = reinterpret_cast<uint64_t>(license);
+  return bpf(BPF_PROG_LOAD, attr);
+}
+#endif
+
+} // namespace
+
+ReusePortBpfConnectionBalancerImpl::ReusePortBpfConnectionBalancerImpl(uint32_t max_handlers)
+    : max_handlers_(max_handlers),
+      slots_(std::make_unique<std::atomic<BalancedConnectionHandler*>[]>(max_handlers)) {
+  ASSERT(max_handlers_ > 0);
+  for (uint32_t slot = 0; slot < max_handlers_; ++slot) {
+    slots_[slot].store(nullptr);
+  }
+  initialize();
+}
+
+ReusePortBpfConnectionBalancerImpl::~ReusePortBpfConnectionBalancerImpl() {
+#ifdef ENVOY_REUSE_PORT_BPF_BALANCE
+  // The program attached to the SO_REUSEPORT group holds its own references to the maps.
+  if (counts_ != nullptr) {
+    munmap(counts_, counts_length_);
+  }
+  for (const int fd : {program_fd_, sockets_map_fd_, counts_map_fd_}) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+#endif
+}
+
+void ReusePortBpfConnectionBalancerImpl::initialize() {
+#ifdef ENVOY_REUSE_PORT_BPF_BALANCE
+  counts_map_fd_ = createMap(BPF_MAP_TYPE_ARRAY, sizeof(uint64_t), max_handlers_, BPF_F_MMAPABLE);
+  if (counts_map_fd_ < 0) {
+    ENVOY_LOG(warn, "unable to create the connection counts BPF map, using kernel hashing: {}",
+              strerror(errno));
+    return;
+  }
+  const size_t page_size = sysconf(_SC_PAGESIZE);
+  counts_length_ = (max_handlers_ * sizeof(uint64_t) + page_size - 1) / page_size * page_size;
+  void* counts =
+      mmap(nullptr, counts_length_, PROT_READ | PROT_WRITE, MAP_SHARED, counts_map_fd_, 0);
+  if (counts == MAP_FAILED) {
+    ENVOY_LOG(warn, "unable to map the connection counts BPF map, using kernel hashing: {}",
+              strerror(errno));
+    return;
+  }
+  counts_ = static_cast<std::atomic<uint64_t>*>(counts);
+  for (uint32_t slot = 0; slot < max_handlers_; ++slot) {
+    counts_[slot].store(UnusedSlotCount, std::memory_order_relaxed);
+  }
+
+  sockets_map_fd_ = createMap(BPF_MAP_TYPE_REUSEPORT_SOCKARRAY, sizeof(uint32_t), max_handlers_, 0);
+  if (sockets_map_fd_ < 0) {
+    ENVOY_LOG(warn, "unable to create the listen sockets BPF map, using kernel hashing: {}",
+              strerror(errno));
+    return;
+  }
+  program_fd_ = loadProgram(buildProgram(counts_map_fd_, sockets_map_fd_, max_handlers_));
+  if (program_fd_ < 0) {
+    ENVOY_LOG(warn, "unable to load the connection balancing BPF program, using kernel hashing: {}",
+              strerror(errno));
+  }
+#else
+  ENVOY_LOG(warn, "reuse port BPF connection balancing is not supported, using kernel hashing");
+#endif
+}
+
+void ReusePortBpfConnectionBalancerImpl::registerHandler(BalancedConnectionHandler& handler) {
+  if (!enabled()) {
+    return;
+  }
+#ifdef ENVOY_REUSE_PORT_BPF_BALANCE
+  SocketOptRef socket = handler.listenSocket();
+  if (!socket.has_value()) {
+    return;
+  }
+  absl::MutexLock lock(&lock_);
+  uint32_t slot = 0;
+  while (slot < max_handlers_ && slots_[slot].load() != nullptr) {
+    ++slot;
+  }
+  if (slot == max_handlers_) {
+    ENVOY_LOG(warn, "more than {} handlers registered for BPF connection balancing",
+              max_handlers_);
+    return;
+  }
+
+  const uint32_t fd = socket->get().ioHandle().fdDoNotUse();
+  if (updateElement(sockets_map_fd_, slot, &fd) != 0) {
+    ENVOY_LOG(warn, "unable to add a listen socket to the BPF map: {}", strerror(errno));
+    return;
+  }
+  // Attaching the program to any socket of the SO_REUSEPORT group attaches it to the group.
+  // Attaching it again on each registration keeps it attached as sockets come and go.
+  const Api::SysCallIntResult result = socket->get().setSocketOption(
+      SOL_SOCKET, SO_ATTACH_REUSEPORT_EBPF, &program_fd_, sizeof(program_fd_));
+  if (result.rc_ != 0) {
+    ENVOY_LOG(warn, "unable to attach the connection balancing BPF program: {}",
+              strerror(result.errno_));
+  }
+  slots_[slot].store(&handler);
+  counts_[slot].store(handler.numConnections(), std::memory_order_relaxed);
+#endif
+}
+
+void ReusePortBpfConnectionBalancerImpl::unregisterHandler(BalancedConnectionHandler& handler) {
+  if (!enabled()) {
+    return;
+  }
+#ifdef ENVOY_REUSE_PORT_BPF_BALANCE
+  absl::MutexLock lock(&lock_);
+  for (uint32_t slot = 0; slot < max_handlers_; ++slot) {
+    if (slots_[slot].load() == &handler) {
+      // Closing the socket would remove it from the map as well, but the socket may outlive the
+      // handler.
+      deleteElement(sockets_map_fd_, slot);
+      counts_[slot].store(UnusedSlotCount, std::memory_order_relaxed);
+      slots_[slot].store(nullptr);
+      return;
+    }
+  }
+#endif
+}
+
+BalancedConnectionHandler&
+ReusePortBpfConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler& current_handler) {
+  // The kernel already picked the handler, so the connection stays where it was accepted.
+  current_handler.incNumConnections();
+  publish(current_handler);
+  return current_handler;
+}
+
+void ReusePortBpfConnectionBalancerImpl::publish(BalancedConnectionHandler& handler) {
+  if (!enabled()) {
+    return;
+  }
+  // A handler is only registered and unregistered by its own worker, which is also the only one
+  // publishing its count, so its slot cannot change while it is published.
+  for (uint32_t slot = 0; slot < max_handlers_; ++slot) {
+    if (slots_[slot].load(std::memory_order_relaxed) == &handler) {
+      counts_[slot].store(handler.numConnections(), std::memory_order_relaxed);
+      return;
+    }
+  }
+}
+
+} // namespace Network
+} // namespace Envoy
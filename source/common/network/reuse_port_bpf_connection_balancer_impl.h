@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "envoy/network/connection_balancer.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * Implementation of connection balancer that lets the kernel steer each connection to the handler
+ * with the fewest active connections. Each registered handler is given a slot: its listen socket
+ * is inserted at the slot of a REUSEPORT_SOCKARRAY BPF map and its number of active connections is
+ * published at the same slot of a memory mapped BPF array. An SK_REUSEPORT program attached to the
+ * SO_REUSEPORT group of the listener selects the socket of the slot with the lowest count, so
+ * connections are balanced before they are accepted and pickTargetHandler() always keeps the
+ * connection on the current handler. No lock is taken while connections are accepted or closed.
+ *
+ * If the BPF maps or program cannot be created, such as on platforms other than Linux or without
+ * the privileges to load BPF programs, a warning is logged and the balancer behaves like
+ * NopConnectionBalancerImpl, leaving the kernel to hash connections over the SO_REUSEPORT group.
+ */
+class ReusePortBpfConnectionBalancerImpl : public ConnectionBalancer,
+                                           Logger::Loggable<Logger::Id::connection> {
+public:
+  /**
+   * @param max_handlers supplies the maximum number of handlers registered at once, typically the
+   *        number of worker threads.
+   */
+  explicit ReusePortBpfConnectionBalancerImpl(uint32_t max_handlers);
+  ~ReusePortBpfConnectionBalancerImpl() override;
+
+  /**
+   * @return whether the BPF program was loaded, so that connections are steered by the kernel.
+   */
+  bool enabled() const { return program_fd_ >= 0; }
+
+  // ConnectionBalancer
+  void registerHandler(BalancedConnectionHandler& handler) override;
+  void unregisterHandler(BalancedConnectionHandler& handler) override;
+  BalancedConnectionHandler& pickTargetHandler(BalancedConnectionHandler& current_handler) override;
+  void onConnectionClosed(BalancedConnectionHandler& handler) override { publish(handler); }
+
+private:
+  void initialize();
+  void publish(BalancedConnectionHandler& handler);
+
+  const uint32_t max_handlers_;
+  int counts_map_fd_{-1};
+  int sockets_map_fd_{-1};
+  int program_fd_{-1};
+  // The values of the counts map, memory mapped so that counts are published without system calls.
+  std::atomic<uint64_t>* counts_{};
+  size_t counts_length_{};
+  // The handler of each slot. Only written with the lock held, but read without it by the worker
+  // of a handler to find the slot to publish its count to.
+  std::unique_ptr<std::atomic<BalancedConnectionHandler*>[]> slots_;
+  absl::Mutex lock_;
+};
+
+} // namespace Network
+} // namespace Envoy
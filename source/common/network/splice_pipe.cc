@@ -0,0 +1,85 @@
+#include "source/common/network/splice_pipe.h"
+
+#include <fcntl.h>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/api/os_sys_calls_impl_linux.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/utility.h"
+
+namespace Envoy {
+namespace Network {
+
+namespace {
+// Upper bound for a single splice(2) call, the default capacity of a Linux pipe.
+constexpr size_t MaxSpliceLength = 64 * 1024;
+constexpr unsigned int SpliceFlags = SPLICE_F_MOVE | SPLICE_F_NONBLOCK;
+} // namespace
+
+SplicePipePtr SplicePipe::create() {
+  os_fd_t fds[2];
+  const Api::SysCallIntResult result =
+      Api::LinuxOsSysCallsSingleton::get().pipe2(fds, O_NONBLOCK | O_CLOEXEC);
+  if (result.rc_ != 0) {
+    ENVOY_LOG(debug, "unable to create splice pipe: {}", errorDetails(result.errno_));
+    return nullptr;
+  }
+  return SplicePipePtr{new SplicePipe(fds[0], fds[1])};
+}
+
+SplicePipe::~SplicePipe() {
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  os_sys_calls.close(read_fd_);
+  os_sys_calls.close(write_fd_);
+}
+
+SplicePipe::TransferResult SplicePipe::transfer(IoHandle& input, IoHandle& output) {
+  auto& os_sys_calls = Api::LinuxOsSysCallsSingleton::get();
+  TransferResult result;
+  // A pipe is bounded by a number of buffers rather than bytes, so EAGAIN when splicing into the
+  // pipe can either mean that the input is drained or that the pipe is full. Keep going as long as
+  // either side makes progress.
+  bool progress = true;
+  while (progress) {
+    progress = false;
+    if (!input_end_stream_) {
+      const Api::SysCallSizeResult read_result =
+          os_sys_calls.splice(input.fdDoNotUse(), write_fd_, MaxSpliceLength, SpliceFlags);
+      if (read_result.rc_ > 0) {
+        buffered_bytes_ += read_result.rc_;
+        result.bytes_read_ += read_result.rc_;
+        progress = true;
+      } else if (read_result.rc_ == 0) {
+        input_end_stream_ = true;
+      } else if (read_result.errno_ != SOCKET_ERROR_AGAIN) {
+        ENVOY_LOG(debug, "splice from fd {} failed: {}", input.fdDoNotUse(),
+                  errorDetails(read_result.errno_));
+        result.error_ = true;
+        return result;
+      }
+    }
+
+    if (buffered_bytes_ > 0) {
+      const Api::SysCallSizeResult write_result =
+          os_sys_calls.splice(read_fd_, output.fdDoNotUse(), buffered_bytes_, SpliceFlags);
+      if (write_result.rc_ > 0) {
+        ASSERT(static_cast<uint64_t>(write_result.rc_) <= buffered_bytes_);
+        buffered_bytes_ -= write_result.rc_;
+        result.bytes_written_ += write_result.rc_;
+        progress = true;
+      } else if (write_result.rc_ < 0 && write_result.errno_ != SOCKET_ERROR_AGAIN) {
+        ENVOY_LOG(debug, "splice to fd {} failed: {}", output.fdDoNotUse(),
+                  errorDetails(write_result.errno_));
+        result.error_ = true;
+        return result;
+      }
+    }
+  }
+
+  result.write_blocked_ = buffered_bytes_ > 0;
+  result.end_stream_ = input_end_stream_ && buffered_bytes_ == 0;
+  return result;
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,71 @@
+#pragma once
+
+#if !defined(__linux__)
+#error "Linux platform file is part of non-Linux build."
+#endif
+
+#include <memory>
+
+#include "envoy/network/io_handle.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Network {
+
+class SplicePipe;
+using SplicePipePtr = std::unique_ptr<SplicePipe>;
+
+/**
+ * Moves data from one socket to another inside the kernel with splice(2). A pipe serves as the
+ * intermediate buffer, so that the data is never copied to or from user space. The pipe is bounded,
+ * so a slow writer naturally applies back pressure to the reader: once the pipe is full no more
+ * data is read until the output becomes writable again.
+ */
+class SplicePipe : NonCopyable, Logger::Loggable<Logger::Id::connection> {
+public:
+  struct TransferResult {
+    // Bytes read from the input socket into the pipe.
+    uint64_t bytes_read_{0};
+    // Bytes written from the pipe to the output socket.
+    uint64_t bytes_written_{0};
+    // The output socket would block with data still in the pipe, i.e. the caller should wait for
+    // it to become writable before calling transfer() again.
+    bool write_blocked_{false};
+    // The input socket reached end of stream and the pipe is drained.
+    bool end_stream_{false};
+    // splice(2) failed with an error other than EAGAIN, the pipe can't be used anymore.
+    bool error_{false};
+  };
+
+  /**
+   * @return a new pipe or nullptr if the pipe could not be created, e.g. because the process ran
+   *         out of file descriptors.
+   */
+  static SplicePipePtr create();
+
+  ~SplicePipe();
+
+  /**
+   * Moves as much data as possible from the input to the output socket. Returns once the input
+   * would block and the pipe is drained, or the pipe is full and the output would block.
+   */
+  TransferResult transfer(IoHandle& input, IoHandle& output);
+
+  /**
+   * @return the number of bytes read from the input that are not yet written to the output.
+   */
+  uint64_t bufferedBytes() const { return buffered_bytes_; }
+
+private:
+  SplicePipe(os_fd_t read_fd, os_fd_t write_fd) : read_fd_(read_fd), write_fd_(write_fd) {}
+
+  const os_fd_t read_fd_;
+  const os_fd_t write_fd_;
+  uint64_t buffered_bytes_{0};
+  bool input_end_stream_{false};
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -44,7 +44,7 @@ private:
 class UdpDefaultWriterFactory : public Network::UdpPacketWriterFactory {
 public:
   Network::UdpPacketWriterPtr createUdpPacketWriter(Network::IoHandle& io_handle,
-                                                    Stats::Scope&) override {
+                                                    Event::Dispatcher&, Stats::Scope&) override {
     return std::make_unique<UdpDefaultWriter>(io_handle);
   }
 };
@@ -588,10 +588,10 @@ Api::IoCallUint64Result Utility::readFromSocket(IoHandle& handle,
                                                 const Address::Instance& local_address,
                                                 UdpPacketProcessor& udp_packet_processor,
                                                 MonotonicTime receive_time, bool use_gro,
+                                                uint64_t num_packets_per_mmsg_call,
                                                 uint32_t* packets_dropped) {
 
   if (use_gro) {
-    Buffer::InstancePtr buffer = std::make_unique<Buffer::OwnedImpl>();
     IoHandle::RecvMsgOutput output(1, packets_dropped);
 
     // TODO(yugant): Avoid allocating 24k for each read by getting memory from UdpPacketProcessor
@@ -599,34 +599,38 @@ Api::IoCallUint64Result Utility::readFromSocket(IoHandle& handle,
         NUM_DATAGRAMS_PER_RECEIVE * udp_packet_processor.maxDatagramSize();
     ENVOY_LOG_MISC(trace, "starting gro recvmsg with max={}", max_rx_datagram_size_with_gro);
 
+    // The packets coalesced in the payload reference its memory rather than copying it, which is
+    // freed once all of them have been drained.
+    std::shared_ptr<uint8_t[]> payload(new uint8_t[max_rx_datagram_size_with_gro]);
+    Buffer::RawSlice slice{payload.get(), max_rx_datagram_size_with_gro};
     Api::IoCallUint64Result result =
-        receiveMessage(max_rx_datagram_size_with_gro, buffer, output, handle, local_address);
+        handle.recvmsg(&slice, 1, local_address.ip()->port(), output);
 
     if (!result.ok() || output.msg_[0].truncated_and_dropped_) {
       return result;
     }
 
+    const uint64_t payload_size = std::min(max_rx_datagram_size_with_gro, result.rc_);
     const uint64_t gso_size = output.msg_[0].gso_size_;
     ENVOY_LOG_MISC(trace, "gro recvmsg bytes {} with gso_size as {}", result.rc_, gso_size);
 
-    // Skip gso segmentation and proceed as a single payload.
-    if (gso_size == 0u) {
-      passPayloadToProcessor(result.rc_, std::move(buffer), std::move(output.msg_[0].peer_address_),
-                             std::move(output.msg_[0].local_address_), udp_packet_processor,
-                             receive_time);
-      return result;
-    }
-
-    // Segment the buffer read by the recvmsg syscall into gso_sized sub buffers.
-    // TODO(mattklein123): The following code should be optimized to avoid buffer copies, either by
-    // switching to slices or by using a CoW buffer type.
-    while (buffer->length() > 0) {
-      const uint64_t bytes_to_copy = std::min(buffer->length(), gso_size);
-      Buffer::InstancePtr sub_buffer = std::make_unique<Buffer::OwnedImpl>();
-      sub_buffer->move(*buffer, bytes_to_copy);
-      passPayloadToProcessor(bytes_to_copy, std::move(sub_buffer), output.msg_[0].peer_address_,
+    // Without a gso_size the payload is passed as a single packet, otherwise it's segmented into
+    // gso_size sized packets.
+    const uint64_t segment_size = gso_size == 0u ? payload_size : gso_size;
+    uint64_t num_segments = 0;
+    for (uint64_t offset = 0; offset < payload_size; offset += segment_size) {
+      const uint64_t size = std::min(payload_size - offset, segment_size);
+      Buffer::InstancePtr segment = std::make_unique<Buffer::OwnedImpl>();
+      segment->addBufferFragment(*new Buffer::BufferFragmentImpl(
+          payload.get() + offset, size,
+          [payload](const void*, size_t, const Buffer::BufferFragmentImpl* fragment) {
+            delete fragment;
+          }));
+      passPayloadToProcessor(size, std::move(segment), output.msg_[0].peer_address_,
                              output.msg_[0].local_address_, udp_packet_processor, receive_time);
+      ++num_segments;
     }
+    udp_packet_processor.onDatagramsRead(num_segments);
 
     return result;
   }
@@ -646,16 +650,18 @@ Api::IoCallUint64Result Utility::readFromSocket(IoHandle& handle,
       Buffer::ReservationSingleSlice reservation_;
     };
     constexpr uint32_t num_slices_per_packet = 1u;
+    num_packets_per_mmsg_call =
+        std::max<uint64_t>(1, std::min(num_packets_per_mmsg_call, NUM_DATAGRAMS_PER_RECEIVE));
     absl::InlinedVector<BufferAndReservation, NUM_DATAGRAMS_PER_RECEIVE> buffers;
-    RawSliceArrays slices(NUM_DATAGRAMS_PER_RECEIVE,
+    RawSliceArrays slices(num_packets_per_mmsg_call,
                           absl::FixedArray<Buffer::RawSlice>(num_slices_per_packet));
-    for (uint32_t i = 0; i < NUM_DATAGRAMS_PER_RECEIVE; i++) {
+    for (uint32_t i = 0; i < num_packets_per_mmsg_call; i++) {
       buffers.push_back(max_rx_datagram_size);
       slices[i][0] = buffers[i].reservation_.slice();
     }
 
-    IoHandle::RecvMsgOutput output(NUM_DATAGRAMS_PER_RECEIVE, packets_dropped);
-    ENVOY_LOG_MISC(trace, "starting recvmmsg with packets={} max={}", NUM_DATAGRAMS_PER_RECEIVE,
+    IoHandle::RecvMsgOutput output(num_packets_per_mmsg_call, packets_dropped);
+    ENVOY_LOG_MISC(trace, "starting recvmmsg with packets={} max={}", num_packets_per_mmsg_call,
                    max_rx_datagram_size);
     Api::IoCallUint64Result result = handle.recvmmsg(slices, local_address.ip()->port(), output);
     if (!result.ok()) {
@@ -680,6 +686,7 @@ Api::IoCallUint64Result Utility::readFromSocket(IoHandle& handle,
       passPayloadToProcessor(msg_len, std::move(buffers[i].buffer_), output.msg_[i].peer_address_,
                              output.msg_[i].local_address_, udp_packet_processor, receive_time);
     }
+    udp_packet_processor.onDatagramsRead(packets_read);
     return result;
   }
 
@@ -699,6 +706,7 @@ Api::IoCallUint64Result Utility::readFromSocket(IoHandle& handle,
   passPayloadToProcessor(result.rc_, std::move(buffer), std::move(output.msg_[0].peer_address_),
                          std::move(output.msg_[0].local_address_), udp_packet_processor,
                          receive_time);
+  udp_packet_processor.onDatagramsRead(1);
   return result;
 }
 
@@ -712,19 +720,27 @@ Api::IoErrorPtr Utility::readPacketsFromSocket(IoHandle& handle,
   size_t num_packets_to_read = std::min<size_t>(
       MAX_NUM_PACKETS_PER_EVENT_LOOP, udp_packet_processor.numPacketsExpectedPerEventLoop());
   const bool use_gro = prefer_gro && handle.supportsUdpGro();
-  size_t num_reads =
-      use_gro ? (num_packets_to_read / NUM_DATAGRAMS_PER_RECEIVE)
-              : (handle.supportsMmsg() ? (num_packets_to_read / NUM_DATAGRAMS_PER_RECEIVE)
-                                       : num_packets_to_read);
+  const bool use_mmsg = !use_gro && handle.supportsMmsg();
+  if (use_gro) {
+    // Each GRO read is accounted as NUM_DATAGRAMS_PER_RECEIVE packets, its payload being sized for
+    // as many.
+    num_packets_to_read -= num_packets_to_read % NUM_DATAGRAMS_PER_RECEIVE;
+  }
   // Make sure to read at least once.
-  num_reads = std::max<size_t>(1, num_reads);
+  num_packets_to_read =
+      std::max<size_t>(use_gro ? NUM_DATAGRAMS_PER_RECEIVE : 1, num_packets_to_read);
   bool honor_read_limit =
       Runtime::runtimeFeatureEnabled("envoy.reloadable_features.udp_per_event_loop_read_limit");
   do {
     const uint32_t old_packets_dropped = packets_dropped;
     const MonotonicTime receive_time = time_source.monotonicTime();
-    Api::IoCallUint64Result result = Utility::readFromSocket(
-        handle, local_address, udp_packet_processor, receive_time, use_gro, &packets_dropped);
+    // The recvmmsg batches are sized to the packets left to read, so that no more buffers are
+    // allocated for a batch than it can be filled with.
+    const uint64_t num_packets_per_mmsg_call =
+        std::min<uint64_t>(num_packets_to_read, NUM_DATAGRAMS_PER_RECEIVE);
+    Api::IoCallUint64Result result =
+        Utility::readFromSocket(handle, local_address, udp_packet_processor, receive_time, use_gro,
+                                num_packets_per_mmsg_call, &packets_dropped);
 
     if (!result.ok()) {
       // No more to read or encountered a system error.
@@ -747,10 +763,17 @@ Api::IoErrorPtr Utility::readPacketsFromSocket(IoHandle& handle,
           delta);
       udp_packet_processor.onDatagramsDropped(delta);
     }
+    if (use_mmsg && result.rc_ < num_packets_per_mmsg_call) {
+      // The batch wasn't filled as the socket has no more packets queued, so the read which
+      // would just fail with EAGAIN is saved.
+      return Api::IoErrorPtr(IoSocketError::getIoSocketEagainInstance(),
+                             IoSocketError::deleteIoError);
+    }
     if (honor_read_limit) {
-      --num_reads;
+      num_packets_to_read -=
+          use_gro ? NUM_DATAGRAMS_PER_RECEIVE : (use_mmsg ? num_packets_per_mmsg_call : 1);
     }
-    if (num_reads == 0) {
+    if (num_packets_to_read == 0) {
       return std::move(result.err_);
     }
   } while (true);
@@ -56,6 +56,13 @@ public:
    */
   virtual void onDatagramsDropped(uint32_t dropped) PURE;
 
+  /**
+   * Called after each receive syscall which read datagrams.
+   * @param datagrams supplies the number of datagrams the syscall read, counting each of the
+   *        datagrams coalesced by GRO.
+   */
+  virtual void onDatagramsRead(uint64_t datagrams) PURE;
+
   /**
    * The expected max size of the datagram to be read. If it's smaller than
    * the size of datagrams received, they will be dropped.
@@ -361,6 +368,8 @@ public:
    * @param receive_time is the timestamp passed to udp_packet_processor for the
    * receive time of the packet.
    * @param prefer_gro supplies whether to use GRO if the OS supports it.
+   * @param num_packets_per_mmsg_call supplies the number of packets to read at most if recvmmsg is
+   * used, capped to NUM_DATAGRAMS_PER_RECEIVE.
    * @param packets_dropped is the output parameter for number of packets dropped in kernel. If the
    * caller is not interested in it, nullptr can be passed in.
    */
@@ -368,6 +377,7 @@ public:
                                                 const Address::Instance& local_address,
                                                 UdpPacketProcessor& udp_packet_processor,
                                                 MonotonicTime receive_time, bool use_gro,
+                                                uint64_t num_packets_per_mmsg_call,
                                                 uint32_t* packets_dropped);
 
   /**
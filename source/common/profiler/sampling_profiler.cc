@@ -0,0 +1,384 @@
+#include "source/common/profiler/sampling_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/debugging/stacktrace.h"
+#include "absl/debugging/symbolize.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace Envoy {
+namespace Profiler {
+namespace {
+
+// Converts a namespace such as ExtAuthz to the snake case of the filter names, ext_authz.
+std::string toSnakeCase(absl::string_view name) {
+  std::string snake_case;
+  for (const char c : name) {
+    if (absl::ascii_isupper(c)) {
+      if (!snake_case.empty()) {
+        snake_case.push_back('_');
+      }
+      snake_case.push_back(absl::ascii_tolower(c));
+    } else {
+      snake_case.push_back(c);
+    }
+  }
+  return snake_case;
+}
+
+/**
+ * Encodes the messages of the pprof profile.proto, as described in
+ * https://github.com/google/pprof/blob/master/proto/profile.proto. The locations are symbolized
+ * in the process, so the profile does not need the binary to be read.
+ */
+class ProfileEncoder {
+public:
+  ProfileEncoder() { stringId(""); }
+
+  // Adds a sample of the stack, from the innermost frame, taken count times on the thread.
+  void addSample(const std::vector<void*>& frames, int64_t thread_id, int64_t count,
+                 int64_t period_ns) {
+    std::string location_ids;
+    const absl::optional<std::string>* filter = nullptr;
+    for (size_t i = 0; i < frames.size(); i++) {
+      const Location& location = locationOf(frames[i], i == 0);
+      putVarint(location_ids, location.id_);
+      if (filter == nullptr && location.filter_.has_value()) {
+        filter = &location.filter_;
+      }
+    }
+    std::string values;
+    putVarint(values, count);
+    putVarint(values, count * period_ns);
+
+    std::string sample;
+    putBytes(sample, 1, location_ids);
+    putBytes(sample, 2, values);
+    std::string label;
+    putInt(label, 1, stringId("thread"));
+    putInt(label, 2, stringId(threadName(thread_id)));
+    putBytes(sample, 3, label);
+    if (filter != nullptr) {
+      label.clear();
+      putInt(label, 1, stringId("filter"));
+      putInt(label, 2, stringId(filter->value()));
+      putBytes(sample, 3, label);
+    }
+    putBytes(samples_, 2, sample);
+  }
+
+  std::string encode(int64_t time_ns, int64_t duration_ns, int64_t period_ns) {
+    std::string profile;
+    putBytes(profile, 1, valueType("samples", "count"));
+    putBytes(profile, 1, valueType("cpu", "nanoseconds"));
+    const std::string period_type = valueType("cpu", "nanoseconds");
+    profile.append(samples_);
+    profile.append(locations_);
+    profile.append(functions_);
+    for (const std::string& string : strings_) {
+      putBytes(profile, 6, string);
+    }
+    putInt(profile, 9, time_ns);
+    putInt(profile, 10, duration_ns);
+    putBytes(profile, 11, period_type);
+    putInt(profile, 12, period_ns);
+    return profile;
+  }
+
+private:
+  struct Location {
+    uint64_t id_;
+    absl::optional<std::string> filter_;
+  };
+
+  static void putVarint(std::string& output, uint64_t value) {
+    while (value >= 0x80) {
+      output.push_back(static_cast<char>(value | 0x80));
+      value >>= 7;
+    }
+    output.push_back(static_cast<char>(value));
+  }
+
+  static void putInt(std::string& output, uint32_t field, uint64_t value) {
+    putVarint(output, field << 3);
+    putVarint(output, value);
+  }
+
+  static void putBytes(std::string& output, uint32_t field, absl::string_view bytes) {
+    putVarint(output, (field << 3) | 2);
+    putVarint(output, bytes.size());
+    output.append(bytes.data(), bytes.size());
+  }
+
+  static std::string threadName(int64_t thread_id) {
+    std::ifstream comm(absl::StrCat("/proc/self/task/", thread_id, "/comm"));
+    std::string name;
+    if (!std::getline(comm, name) || name.empty()) {
+      // The thread has exited since.
+      return absl::StrCat("thread ", thread_id);
+    }
+    return name;
+  }
+
+  int64_t stringId(absl::string_view string) {
+    auto it = string_ids_.find(string);
+    if (it == string_ids_.end()) {
+      it = string_ids_.emplace(std::string(string), strings_.size()).first;
+      strings_.emplace_back(string);
+    }
+    return it->second;
+  }
+
+  std::string valueType(absl::string_view type, absl::string_view unit) {
+    std::string value_type;
+    putInt(value_type, 1, stringId(type));
+    putInt(value_type, 2, stringId(unit));
+    return value_type;
+  }
+
+  const Location& locationOf(void* address, bool innermost) {
+    auto it = locations_by_address_.find(address);
+    if (it != locations_by_address_.end()) {
+      return it->second;
+    }
+
+    // The outer frames are return addresses, which may be past the end of the calling function.
+    char symbol[1024];
+    const void* call = innermost ? address : static_cast<char*>(address) - 1;
+    const std::string name = absl::Symbolize(call, symbol, sizeof(symbol))
+                                 ? std::string(symbol)
+                                 : absl::StrCat("0x", absl::Hex(address));
+    auto function = function_ids_.find(name);
+    if (function == function_ids_.end()) {
+      function = function_ids_.emplace(name, function_ids_.size() + 1).first;
+      std::string message;
+      putInt(message, 1, function->second);
+      putInt(message, 2, stringId(name));
+      putInt(message, 3, stringId(name));
+      putBytes(functions_, 5, message);
+    }
+
+    Location location{locations_by_address_.size() + 1, Sampling::filterName(name)};
+    std::string line;
+    putInt(line, 1, function->second);
+    std::string message;
+    putInt(message, 1, location.id_);
+    putInt(message, 3, reinterpret_cast<uintptr_t>(address));
+    putBytes(message, 4, line);
+    putBytes(locations_, 4, message);
+    return locations_by_address_.emplace(address, std::move(location)).first->second;
+  }
+
+  std::vector<std::string> strings_;
+  absl::flat_hash_map<std::string, int64_t> string_ids_;
+  absl::flat_hash_map<std::string, uint64_t> function_ids_;
+  absl::flat_hash_map<void*, Location> locations_by_address_;
+  std::string samples_;
+  std::string locations_;
+  std::string functions_;
+};
+
+#ifdef __linux__
+int64_t monotonicNanos() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+struct Sample {
+  // Odd while the sample is written, and 0 until it is first written.
+  std::atomic<uint64_t> sequence_{0};
+  int64_t time_ns_;
+  int64_t thread_id_;
+  int depth_;
+  void* frames_[Sampling::MaxDepth];
+};
+
+// The ring of the samples, written by the signal handler on the sampled threads.
+struct Samples {
+  Sample samples_[Sampling::MaxSamples];
+  std::atomic<uint64_t> next_{0};
+};
+
+// Allocated on the first start and never freed, as a signal may be handled at any time.
+std::atomic<Samples*> samples_ring{nullptr};
+std::atomic<bool> started{false};
+std::atomic<uint32_t> frequency{Sampling::DefaultFrequencyHz};
+struct sigaction previous_action;
+
+void onProfSignal(int, siginfo_t*, void* ucontext) {
+  Samples* samples = samples_ring.load(std::memory_order_acquire);
+  if (!started.load(std::memory_order_relaxed) || samples == nullptr) {
+    return;
+  }
+  const int saved_errno = errno;
+  Sample& sample =
+      samples->samples_[samples->next_.fetch_add(1, std::memory_order_relaxed) %
+                        Sampling::MaxSamples];
+  uint64_t sequence = sample.sequence_.load(std::memory_order_relaxed);
+  // The ring may have wrapped around to a sample still written by another thread, in which case
+  // this one is dropped.
+  if ((sequence & 1) == 0 &&
+      sample.sequence_.compare_exchange_strong(sequence, sequence + 1,
+                                               std::memory_order_acquire)) {
+    sample.time_ns_ = monotonicNanos();
+    sample.thread_id_ = syscall(SYS_gettid);
+    // Skip the frame of the handler.
+    sample.depth_ =
+        absl::GetStackTraceWithContext(sample.frames_, Sampling::MaxDepth, 1, ucontext, nullptr);
+    sample.sequence_.store(sequence + 2, std::memory_order_release);
+  }
+  errno = saved_errno;
+}
+#endif
+
+} // namespace
+
+#ifdef __linux__
+bool Sampling::profilerAvailable() { return true; }
+
+bool Sampling::profilerStarted() { return started.load(); }
+
+bool Sampling::startProfiler(uint32_t frequency_hz) {
+  if (frequency_hz == 0 || frequency_hz > MaxFrequencyHz || started.load()) {
+    return false;
+  }
+  if (samples_ring.load() == nullptr) {
+    samples_ring.store(new Samples(), std::memory_order_release);
+  }
+
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  action.sa_sigaction = onProfSignal;
+  if (sigaction(SIGPROF, &action, &previous_action) != 0) {
+    return false;
+  }
+  frequency.store(frequency_hz);
+  started.store(true);
+
+  struct itimerval timer;
+  timer.it_interval.tv_sec = 0;
+  timer.it_interval.tv_usec = 1000000 / frequency_hz;
+  timer.it_value = timer.it_interval;
+  if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+    stopProfiler();
+    return false;
+  }
+  return true;
+}
+
+void Sampling::stopProfiler() {
+  if (!started.load()) {
+    return;
+  }
+  struct itimerval timer;
+  std::memset(&timer, 0, sizeof(timer));
+  setitimer(ITIMER_PROF, &timer, nullptr);
+  started.store(false);
+
+  // A signal may still be pending, which would terminate the process with the default action.
+  if ((previous_action.sa_flags & SA_SIGINFO) == 0 && previous_action.sa_handler == SIG_DFL) {
+    previous_action.sa_handler = SIG_IGN;
+  }
+  sigaction(SIGPROF, &previous_action, nullptr);
+}
+
+std::string Sampling::profile(std::chrono::seconds window) {
+  const int64_t window_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(window).count();
+  const int64_t since = monotonicNanos() - window_ns;
+
+  // Aggregates the identical stacks of each thread.
+  absl::flat_hash_map<std::pair<int64_t, std::vector<void*>>, int64_t> counts;
+  Samples* samples = samples_ring.load(std::memory_order_acquire);
+  if (samples != nullptr) {
+    for (Sample& sample : samples->samples_) {
+      const uint64_t sequence = sample.sequence_.load(std::memory_order_acquire);
+      if (sequence == 0 || (sequence & 1) != 0) {
+        continue;
+      }
+      const int64_t time_ns = sample.time_ns_;
+      const int64_t thread_id = sample.thread_id_;
+      std::vector<void*> frames(sample.frames_,
+                                sample.frames_ + std::min(sample.depth_, MaxDepth));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sample.sequence_.load(std::memory_order_relaxed) != sequence || time_ns < since) {
+        // Overwritten while it was read, or out of the window.
+        continue;
+      }
+      counts[{thread_id, std::move(frames)}]++;
+    }
+  }
+
+  const int64_t period_ns = 1000000000 / frequency.load();
+  ProfileEncoder encoder;
+  for (const auto& [key, count] : counts) {
+    encoder.addSample(key.second, key.first, count, period_ns);
+  }
+  const int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::system_clock::now().time_since_epoch())
+                             .count();
+  return encoder.encode(now_ns - window_ns, window_ns, period_ns);
+}
+#else
+bool Sampling::profilerAvailable() { return false; }
+bool Sampling::profilerStarted() { return false; }
+bool Sampling::startProfiler(uint32_t) { return false; }
+void Sampling::stopProfiler() {}
+
+std::string Sampling::profile(std::chrono::seconds window) {
+  const int64_t window_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(window).count();
+  const int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::system_clock::now().time_since_epoch())
+                             .count();
+  return ProfileEncoder().encode(now_ns - window_ns, window_ns,
+                                 1000000000 / DefaultFrequencyHz);
+}
+#endif
+
+absl::optional<std::string> Sampling::filterName(absl::string_view symbol) {
+  static constexpr std::pair<absl::string_view, absl::string_view> FilterNamespaces[] = {
+      {"Envoy::Extensions::HttpFilters::", "http."},
+      {"Envoy::Extensions::NetworkFilters::", "network."},
+      {"Envoy::Extensions::ListenerFilters::", "listener."},
+      {"Envoy::Extensions::UdpFilters::", "udp."},
+  };
+  for (const auto& [filter_namespace, prefix] : FilterNamespaces) {
+    const size_t start = symbol.find(filter_namespace);
+    if (start == absl::string_view::npos) {
+      continue;
+    }
+    absl::string_view name = symbol.substr(start + filter_namespace.size());
+    const size_t end = name.find("::");
+    if (end == absl::string_view::npos || end == 0) {
+      continue;
+    }
+    name = name.substr(0, end);
+    // The shared code of the filters, such as Envoy::Extensions::HttpFilters::Common.
+    if (name == "Common") {
+      continue;
+    }
+    return absl::StrCat(prefix, toSnakeCase(name));
+  }
+  return absl::nullopt;
+}
+
+} // namespace Profiler
+} // namespace Envoy
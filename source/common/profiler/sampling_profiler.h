@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Profiler {
+
+/**
+ * Process wide continuous CPU profiling. Unlike Cpu, which profiles to a file until stopped, the
+ * sampling profiler keeps the last samples in memory, to serve the profile of a recent window at
+ * any time. The threads using CPU are sampled on SIGPROF, and the samples are labelled with the
+ * name of their thread and, if any, of the filter they are in.
+ *
+ * Only available on Linux, and exclusive with Cpu which uses the same signal.
+ */
+class Sampling {
+public:
+  // The samples kept, the oldest being overwritten.
+  static constexpr size_t MaxSamples = 1 << 14;
+  // The frames kept of each sample, from the innermost.
+  static constexpr int MaxDepth = 48;
+  static constexpr uint32_t DefaultFrequencyHz = 100;
+  static constexpr uint32_t MaxFrequencyHz = 1000;
+
+  /**
+   * @return whether the sampling profiler is available in this build.
+   */
+  static bool profilerAvailable();
+
+  /**
+   * @return whether the sampling profiler is started.
+   */
+  static bool profilerStarted();
+
+  /**
+   * Start sampling the process.
+   * @param frequency_hz the samples taken per second of CPU used by the process, at most
+   *        MaxFrequencyHz.
+   * @return bool whether the sampling profiler was started.
+   */
+  static bool startProfiler(uint32_t frequency_hz);
+
+  /**
+   * Stop sampling the process. The samples already taken are kept.
+   */
+  static void stopProfiler();
+
+  /**
+   * @param window the duration of the most recent samples to serve, clipped to the samples kept.
+   * @return the profile of the samples in the pprof profile.proto format, uncompressed.
+   */
+  static std::string profile(std::chrono::seconds window);
+
+  /**
+   * @return the name of the filter the symbolized frame of a stack is in, such as
+   *         "http.ext_authz" for the frames of Envoy::Extensions::HttpFilters::ExtAuthz, or
+   *         nullopt if it is not in a filter.
+   */
+  static absl::optional<std::string> filterName(absl::string_view symbol);
+};
+
+} // namespace Profiler
+} // namespace Envoy
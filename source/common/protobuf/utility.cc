@@ -10,6 +10,7 @@
 #include "source/common/common/assert.h"
 #include "source/common/common/documentation_url.h"
 #include "source/common/common/fmt.h"
+#include "source/common/common/macros.h"
 #include "source/common/config/api_type_oracle.h"
 #include "source/common/config/version_converter.h"
 #include "source/common/protobuf/message_validator_impl.h"
@@ -18,7 +19,9 @@
 #include "source/common/protobuf/well_known.h"
 #include "source/common/runtime/runtime_features.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/match.h"
+#include "absl/synchronization/mutex.h"
 #include "udpa/annotations/sensitive.pb.h"
 #include "yaml-cpp/yaml.h"
 
@@ -520,6 +523,44 @@ void checkForDeprecatedNonRepeatedEnumValue(
       message, validation_visitor);
 }
 
+// Forwards the events of a validation visitor, recording whether there was any.
+class RecordingValidationVisitor : public ProtobufMessage::ValidationVisitor {
+public:
+  explicit RecordingValidationVisitor(ProtobufMessage::ValidationVisitor& validation_visitor)
+      : validation_visitor_(validation_visitor) {}
+
+  // ProtobufMessage::ValidationVisitor
+  void onUnknownField(absl::string_view description) override {
+    notified_ = true;
+    validation_visitor_.onUnknownField(description);
+  }
+  bool skipValidation() override { return validation_visitor_.skipValidation(); }
+  void onDeprecatedField(absl::string_view description, bool soft_deprecation) override {
+    notified_ = true;
+    validation_visitor_.onDeprecatedField(description, soft_deprecation);
+  }
+
+  bool notified() const { return notified_; }
+
+private:
+  ProtobufMessage::ValidationVisitor& validation_visitor_;
+  bool notified_{};
+};
+
+// The keys of the messages found valid without any deprecated or unknown field, up to a total
+// size after which they are forgotten. Large messages, such as bootstraps, are not repeated and
+// are not remembered.
+struct ValidatedMessages {
+  static constexpr size_t MaxBytes = 32 * 1024 * 1024;
+  static constexpr size_t MaxMessageBytes = 64 * 1024;
+
+  absl::Mutex mutex_;
+  absl::flat_hash_set<std::string> keys_ ABSL_GUARDED_BY(mutex_);
+  size_t bytes_ ABSL_GUARDED_BY(mutex_){};
+};
+
+ValidatedMessages& validatedMessages() { MUTABLE_CONSTRUCT_ON_FIRST_USE(ValidatedMessages); }
+
 class UnexpectedFieldProtoVisitor : public ProtobufMessage::ConstProtoVisitor {
 public:
   UnexpectedFieldProtoVisitor(ProtobufMessage::ValidationVisitor& validation_visitor,
@@ -600,12 +641,42 @@ private:
 
 } // namespace
 
-void MessageUtil::checkForUnexpectedFields(const Protobuf::Message& message,
+bool MessageUtil::checkForUnexpectedFields(const Protobuf::Message& message,
                                            ProtobufMessage::ValidationVisitor& validation_visitor,
                                            Runtime::Loader* runtime) {
-  UnexpectedFieldProtoVisitor unexpected_field_visitor(validation_visitor, runtime);
+  RecordingValidationVisitor recording_visitor(validation_visitor);
+  UnexpectedFieldProtoVisitor unexpected_field_visitor(recording_visitor, runtime);
   ProtobufMessage::traverseMessage(unexpected_field_visitor, API_RECOVER_ORIGINAL(message),
                                    nullptr);
+  return recording_visitor.notified();
+}
+
+std::string MessageUtil::validatedMessageKey(const Protobuf::Message& message) {
+  // The unknown fields holding the original message of an upgraded one are serialized too, so
+  // messages upgraded from different originals have different keys.
+  return absl::StrCat(message.GetDescriptor()->full_name(), "/", message.SerializeAsString());
+}
+
+bool MessageUtil::isValidatedMessage(const std::string& key) {
+  ValidatedMessages& validated = validatedMessages();
+  absl::MutexLock lock(&validated.mutex_);
+  return validated.keys_.contains(key);
+}
+
+void MessageUtil::addValidatedMessage(std::string key) {
+  if (key.size() > ValidatedMessages::MaxMessageBytes) {
+    return;
+  }
+  ValidatedMessages& validated = validatedMessages();
+  absl::MutexLock lock(&validated.mutex_);
+  if (validated.bytes_ + key.size() > ValidatedMessages::MaxBytes) {
+    validated.keys_.clear();
+    validated.bytes_ = 0;
+  }
+  const size_t size = key.size();
+  if (validated.keys_.insert(std::move(key)).second) {
+    validated.bytes_ += size;
+  }
 }
 
 std::string MessageUtil::getYamlStringFromMessage(const Protobuf::Message& message,
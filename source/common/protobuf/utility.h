@@ -266,10 +266,11 @@ public:
    * Checks for use of deprecated fields in message and all sub-messages.
    * @param message message to validate.
    * @param loader optional a pointer to the runtime loader for live deprecation status.
+   * @return bool whether validation_visitor was notified of any deprecated or unknown field.
    * @throw ProtoValidationException if deprecated fields are used and listed
    *    in disallowed_features in runtime_features.h
    */
-  static void
+  static bool
   checkForUnexpectedFields(const Protobuf::Message& message,
                            ProtobufMessage::ValidationVisitor& validation_visitor,
                            Runtime::Loader* loader = Runtime::LoaderSingleton::getExisting());
@@ -284,17 +285,48 @@ public:
   template <class MessageType>
   static void validate(const MessageType& message,
                        ProtobufMessage::ValidationVisitor& validation_visitor) {
+    // A message identical to one found valid without any deprecated or unknown field, such as
+    // the same filter config repeated across listeners, is not checked again.
+    std::string validated_key = validatedMessageKey(message);
+    if (isValidatedMessage(validated_key)) {
+      return;
+    }
+
     // Log warnings or throw errors if deprecated fields or unknown fields are in use.
+    bool unexpected_fields = true;
     if (!validation_visitor.skipValidation()) {
-      checkForUnexpectedFields(message, validation_visitor);
+      unexpected_fields = checkForUnexpectedFields(message, validation_visitor);
     }
 
     std::string err;
     if (!Validate(message, &err)) {
       ProtoExceptionUtil::throwProtoValidationException(err, API_RECOVER_ORIGINAL(message));
     }
+    if (!unexpected_fields) {
+      addValidatedMessage(std::move(validated_key));
+    }
   }
 
+  /**
+   * @param message supplies the message to identify.
+   * @return std::string the key identifying the type and the content of the message in the
+   *         messages found valid by validate().
+   */
+  static std::string validatedMessageKey(const Protobuf::Message& message);
+
+  /**
+   * @param key supplies the key of a message from validatedMessageKey().
+   * @return bool whether the message was found valid without any deprecated or unknown field.
+   */
+  static bool isValidatedMessage(const std::string& key);
+
+  /**
+   * Remembers a message which was found valid without any deprecated or unknown field, unless it
+   * is large, up to a total size of the keys after which the messages remembered are forgotten.
+   * @param key supplies the key of the message from validatedMessageKey().
+   */
+  static void addValidatedMessage(std::string key);
+
   template <class MessageType>
   static void loadFromYamlAndValidate(const std::string& yaml, MessageType& message,
                                       ProtobufMessage::ValidationVisitor& validation_visitor,
@@ -102,7 +102,7 @@ ActiveQuicListener::ActiveQuicListener(
   // Create udp_packet_writer
   Network::UdpPacketWriterPtr udp_packet_writer =
       listener_config.udpListenerConfig()->packetWriterFactory().createUdpPacketWriter(
-          listen_socket_.ioHandle(), listener_config.listenerScope());
+          listen_socket_.ioHandle(), dispatcher, listener_config.listenerScope());
   udp_packet_writer_ = udp_packet_writer.get();
 
   // Some packet writers (like `UdpGsoBatchWriter`) already directly implement
@@ -189,7 +189,12 @@ void ActiveQuicListener::shutdownListener() {
 
 uint32_t ActiveQuicListener::destination(const Network::UdpRecvData& data) const {
   if (kernel_worker_routing_) {
-    // The kernel has already routed the packet correctly. Make it stay on the current worker.
+    // The kernel has already routed the packet by connection ID. Make it stay on the current
+    // worker, which owns the connection if the socket index in the SO_REUSEPORT group agrees with
+    // the worker index, as it does unless the BPF filter isn't in effect.
+    if (connectionIdWorker(data) != worker_index_) {
+      udp_stats_.downstream_rx_datagram_misrouted_.inc();
+    }
     return worker_index_;
   }
 
@@ -199,9 +204,14 @@ uint32_t ActiveQuicListener::destination(const Network::UdpRecvData& data) const
   // This could possibly be improved by keeping a global table of connection IDs, so that a new
   // connection will add its connection ID to the table on the current worker, and so packets should
   // be delivered to the correct worker by the kernel unless the client changes address.
+  return connectionIdWorker(data);
+}
 
+uint32_t ActiveQuicListener::connectionIdWorker(const Network::UdpRecvData& data) const {
   // This is a re-implementation of the same algorithm written in BPF in
-  // ``ActiveQuicListenerFactory::createActiveUdpListener``
+  // ``ActiveQuicListenerFactory::createActiveUdpListener``. The connection IDs issued by the
+  // server keep the 1st word of the original connection ID, @see adjustNewConnectionIdForRoutine,
+  // so that all the packets of a connection are routed to the same worker.
   const uint64_t packet_length = data.buffer_->length();
   if (packet_length < 9) {
     return worker_index_;
@@ -70,6 +70,9 @@ public:
 private:
   friend class ActiveQuicListenerPeer;
 
+  // @return the worker which the packet is routed to by its connection ID.
+  uint32_t connectionIdWorker(const Network::UdpRecvData& data) const;
+
   uint8_t random_seed_[16];
   std::unique_ptr<quic::QuicCryptoServerConfig> crypto_config_;
   Event::Dispatcher& dispatcher_;
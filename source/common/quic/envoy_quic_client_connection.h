@@ -60,6 +60,7 @@ public:
   void onDatagramsDropped(uint32_t) override {
     // TODO(mattklein123): Emit a stat for this.
   }
+  void onDatagramsRead(uint64_t) override {}
   size_t numPacketsExpectedPerEventLoop() const override {
     if (delegate_.has_value()) {
       return delegate_.value().get().numPacketsExpectedPerEventLoop();
@@ -188,12 +188,10 @@ void EnvoyQuicServerStream::OnBodyAvailable() {
   // TODO(danzh): check Envoy per stream buffer limit.
   // Currently read out all the data.
   while (HasBytesToRead()) {
-    iovec iov;
-    int num_regions = GetReadableRegions(&iov, 1);
+    iovec regions[MaxBodyRegionsPerRead];
+    const int num_regions = GetReadableRegions(regions, MaxBodyRegionsPerRead);
     ASSERT(num_regions > 0);
-    size_t bytes_read = iov.iov_len;
-    buffer->add(iov.iov_base, bytes_read);
-    MarkConsumed(bytes_read);
+    MarkConsumed(copyBodyRegionsToBuffer(regions, num_regions, *buffer));
   }
 
   bool fin_read_and_no_trailers = IsDoneReading();
@@ -276,5 +276,23 @@ void adjustNewConnectionIdForRoutine(quic::QuicConnectionId& new_connection_id,
   safeMemcpyUnsafeDst(new_connection_id_data, first_four_bytes);
 }
 
+uint64_t copyBodyRegionsToBuffer(const iovec* regions, int num_regions, Buffer::Instance& buffer) {
+  uint64_t length = 0;
+  for (int i = 0; i < num_regions; ++i) {
+    length += regions[i].iov_len;
+  }
+  if (length == 0) {
+    return 0;
+  }
+  auto reservation = buffer.reserveSingleSlice(length);
+  uint8_t* mem = static_cast<uint8_t*>(reservation.slice().mem_);
+  for (int i = 0; i < num_regions; ++i) {
+    memcpy(mem, regions[i].iov_base, regions[i].iov_len); // NOLINT(safe-memcpy)
+    mem += regions[i].iov_len;
+  }
+  reservation.commit(length);
+  return length;
+}
+
 } // namespace Quic
 } // namespace Envoy
@@ -173,5 +173,14 @@ void configQuicInitialFlowControlWindow(const envoy::config::core::v3::QuicProto
 void adjustNewConnectionIdForRoutine(quic::QuicConnectionId& new_connection_id,
                                      const quic::QuicConnectionId& old_connection_id);
 
+// The most readable regions of a stream body copied out of the QUIC stream at once.
+constexpr int MaxBodyRegionsPerRead = 16;
+
+// Copy the readable regions of a stream body into a single slice added to buffer. The regions are
+// in the blocks of the stream sequencer, which are reused once consumed, so they can't be
+// referenced.
+// @return the number of bytes copied.
+uint64_t copyBodyRegionsToBuffer(const iovec* regions, int num_regions, Buffer::Instance& buffer);
+
 } // namespace Quic
 } // namespace Envoy
@@ -41,6 +41,10 @@ bool QuicFilterManagerConnectionImpl::initializeReadFilters() {
   return filter_manager_.initializeReadFilters();
 }
 
+void QuicFilterManagerConnectionImpl::recordFilterCost(Stats::Histogram& cpu_time_us) {
+  filter_manager_.recordFilterCost(cpu_time_us);
+}
+
 void QuicFilterManagerConnectionImpl::enableHalfClose(bool enabled) {
   RELEASE_ASSERT(!enabled, "Quic connection doesn't support half close.");
 }
@@ -108,7 +108,8 @@ UdpGsoBatchWriterStats UdpGsoBatchWriter::generateStats(Stats::Scope& scope) {
 }
 
 Network::UdpPacketWriterPtr
-UdpGsoBatchWriterFactory::createUdpPacketWriter(Network::IoHandle& io_handle, Stats::Scope& scope) {
+UdpGsoBatchWriterFactory::createUdpPacketWriter(Network::IoHandle& io_handle, Event::Dispatcher&,
+                                                Stats::Scope& scope) {
   return std::make_unique<UdpGsoBatchWriter>(io_handle, scope);
 }
 
@@ -112,6 +112,7 @@ private:
 class UdpGsoBatchWriterFactory : public Network::UdpPacketWriterFactory {
 public:
   Network::UdpPacketWriterPtr createUdpPacketWriter(Network::IoHandle& io_handle,
+                                                    Event::Dispatcher& dispatcher,
                                                     Stats::Scope& scope) override;
 
 private:
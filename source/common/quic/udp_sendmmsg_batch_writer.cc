@@ -0,0 +1,268 @@
+#include "source/common/quic/udp_sendmmsg_batch_writer.h"
+
+#include <cstring>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/logger.h"
+#include "source/common/common/utility.h"
+#include "source/common/network/io_socket_error_impl.h"
+#include "source/common/network/utility.h"
+
+namespace Envoy {
+namespace Quic {
+namespace {
+
+Api::IoCallUint64Result writeBlockedResult() {
+  return Api::IoCallUint64Result(
+      /*rc=*/0,
+      /*err=*/Api::IoErrorPtr(Network::IoSocketError::getIoSocketEagainInstance(),
+                              Network::IoSocketError::deleteIoError));
+}
+
+} // namespace
+
+UdpSendmmsgBatchWriter::UdpSendmmsgBatchWriter(Network::IoHandle& io_handle,
+                                               Event::Dispatcher& dispatcher, Stats::Scope& scope)
+    : io_handle_(io_handle), stats_({UDP_SENDMMSG_BATCH_WRITER_STATS(
+                                 POOL_COUNTER(scope), POOL_HISTOGRAM(scope))}),
+      gso_(Api::OsSysCallsSingleton::get().supportsUdpGso()),
+      flush_cb_(dispatcher.createSchedulableCallback([this]() { sendBufferedPackets(); })),
+      buffer_(new uint8_t[MaxBufferedPackets * Network::UdpMaxOutgoingPacketSize]) {}
+
+Api::IoCallUint64Result
+UdpSendmmsgBatchWriter::writePacket(const Buffer::Instance& buffer,
+                                    const Network::Address::Ip* local_ip,
+                                    const Network::Address::Instance& peer_address) {
+  if (write_blocked_) {
+    return writeBlockedResult();
+  }
+  const uint64_t length = buffer.length();
+  if (length > Network::UdpMaxOutgoingPacketSize || num_packets_ == MaxBufferedPackets) {
+    // Doesn't fit in a slot, which the connections of a QUIC listener never write. The packets
+    // buffered before it are sent first to keep the order of the packets.
+    sendBufferedPackets();
+    if (write_blocked_) {
+      return writeBlockedResult();
+    }
+    if (length > Network::UdpMaxOutgoingPacketSize) {
+      Api::IoCallUint64Result result =
+          Network::Utility::writeToSocket(io_handle_, buffer, local_ip, peer_address);
+      write_blocked_ = !result.ok() && result.wouldBlock();
+      return result;
+    }
+  }
+
+  // The packet was usually serialized in place, into the location returned by
+  // getNextWriteLocation().
+  uint8_t* packet_slot = slot(num_packets_);
+  if (buffer.getRawSlices().size() != 1 || buffer.frontSlice().mem_ != packet_slot) {
+    buffer.copyOut(0, length, packet_slot);
+  }
+  BufferedPacket& packet = packets_[num_packets_];
+  packet.length_ = length;
+  ASSERT(peer_address.sockAddrLen() <= sizeof(packet.peer_address_));
+  memcpy(&packet.peer_address_, peer_address.sockAddr(), // NOLINT(safe-memcpy)
+         peer_address.sockAddrLen());
+  packet.peer_address_length_ = peer_address.sockAddrLen();
+  packet.self_ip_version_.reset();
+  if (local_ip != nullptr) {
+    packet.self_ip_version_ = local_ip->version();
+    if (local_ip->version() == Network::Address::IpVersion::v4) {
+      packet.self_ipv4_ = local_ip->ipv4()->address();
+    } else {
+      packet.self_ipv6_ = local_ip->ipv6()->address();
+    }
+  }
+  ++num_packets_;
+
+  if (num_packets_ == MaxBufferedPackets) {
+    sendBufferedPackets();
+  } else {
+    flush_cb_->scheduleCallbackCurrentIteration();
+  }
+  // The packet is now owned by the writer, even if the socket is blocked.
+  return Api::IoCallUint64Result(
+      /*rc=*/length,
+      /*err=*/Api::IoErrorPtr(nullptr, Network::IoSocketError::deleteIoError));
+}
+
+void UdpSendmmsgBatchWriter::setWritable() {
+  write_blocked_ = false;
+  if (num_packets_ > 0) {
+    flush_cb_->scheduleCallbackCurrentIteration();
+  }
+}
+
+Network::UdpPacketWriterBuffer
+UdpSendmmsgBatchWriter::getNextWriteLocation(const Network::Address::Ip*,
+                                             const Network::Address::Instance&) {
+  if (write_blocked_ || num_packets_ == MaxBufferedPackets) {
+    return {nullptr, 0, nullptr};
+  }
+  return {slot(num_packets_), Network::UdpMaxOutgoingPacketSize, nullptr};
+}
+
+Api::IoCallUint64Result UdpSendmmsgBatchWriter::flush() {
+  if (num_packets_ > 0 && !write_blocked_) {
+    flush_cb_->scheduleCallbackCurrentIteration();
+  }
+  return Api::IoCallUint64Result(
+      /*rc=*/0,
+      /*err=*/Api::IoErrorPtr(nullptr, Network::IoSocketError::deleteIoError));
+}
+
+bool UdpSendmmsgBatchWriter::samePath(const BufferedPacket& a, const BufferedPacket& b) {
+  if (a.peer_address_length_ != b.peer_address_length_ ||
+      memcmp(&a.peer_address_, &b.peer_address_, a.peer_address_length_) != 0 ||
+      a.self_ip_version_ != b.self_ip_version_) {
+    return false;
+  }
+  if (!a.self_ip_version_.has_value()) {
+    return true;
+  }
+  return a.self_ip_version_.value() == Network::Address::IpVersion::v4
+             ? a.self_ipv4_ == b.self_ipv4_
+             : a.self_ipv6_ == b.self_ipv6_;
+}
+
+void UdpSendmmsgBatchWriter::setControlMessages(uint32_t message,
+                                                const BufferedPacket& first_packet,
+                                                uint32_t num_segments) {
+  msghdr& hdr = messages_[message].msg_hdr;
+  const bool has_self_ip = first_packet.self_ip_version_.has_value();
+  if (!has_self_ip && num_segments == 1) {
+    hdr.msg_control = nullptr;
+    hdr.msg_controllen = 0;
+    return;
+  }
+
+  control_[message].fill(0);
+  hdr.msg_control = control_[message].data();
+  hdr.msg_controllen = ControlSize;
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+  size_t control_length = 0;
+  if (has_self_ip) {
+    if (first_packet.self_ip_version_.value() == Network::Address::IpVersion::v4) {
+      cmsg->cmsg_level = IPPROTO_IP;
+      cmsg->cmsg_type = IP_PKTINFO;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
+      auto pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
+      pktinfo->ipi_ifindex = 0;
+      pktinfo->ipi_spec_dst.s_addr = first_packet.self_ipv4_;
+      control_length += CMSG_SPACE(sizeof(in_pktinfo));
+    } else {
+      cmsg->cmsg_level = IPPROTO_IPV6;
+      cmsg->cmsg_type = IPV6_PKTINFO;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
+      auto pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
+      pktinfo->ipi6_ifindex = 0;
+      *(reinterpret_cast<absl::uint128*>(pktinfo->ipi6_addr.s6_addr)) = first_packet.self_ipv6_;
+      control_length += CMSG_SPACE(sizeof(in6_pktinfo));
+    }
+    cmsg = CMSG_NXTHDR(&hdr, cmsg);
+  }
+  if (num_segments > 1) {
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    *reinterpret_cast<uint16_t*>(CMSG_DATA(cmsg)) = static_cast<uint16_t>(first_packet.length_);
+    control_length += CMSG_SPACE(sizeof(uint16_t));
+  }
+  hdr.msg_controllen = control_length;
+}
+
+void UdpSendmmsgBatchWriter::sendBufferedPackets() {
+  if (num_packets_ == 0 || write_blocked_) {
+    return;
+  }
+
+  // One message per run of packets to the same path, all of the size of the first one but the last
+  // one which may be shorter, as GSO requires.
+  uint32_t num_messages = 0;
+  for (uint32_t first = 0; first < num_packets_;) {
+    const BufferedPacket& first_packet = packets_[first];
+    uint32_t end = first + 1;
+    uint64_t message_size = first_packet.length_;
+    if (gso_) {
+      while (end < num_packets_ && end - first < MaxGsoSegments &&
+             packets_[end - 1].length_ == first_packet.length_ &&
+             packets_[end].length_ <= first_packet.length_ &&
+             message_size + packets_[end].length_ <= MaxGsoMessageSize &&
+             samePath(first_packet, packets_[end])) {
+        message_size += packets_[end].length_;
+        ++end;
+      }
+    }
+
+    for (uint32_t i = first; i < end; ++i) {
+      iovecs_[i].iov_base = slot(i);
+      iovecs_[i].iov_len = packets_[i].length_;
+    }
+    mmsghdr& message = messages_[num_messages];
+    message.msg_len = 0;
+    msghdr& hdr = message.msg_hdr;
+    hdr.msg_name = const_cast<sockaddr_storage*>(&first_packet.peer_address_);
+    hdr.msg_namelen = first_packet.peer_address_length_;
+    hdr.msg_iov = &iovecs_[first];
+    hdr.msg_iovlen = end - first;
+    hdr.msg_flags = 0;
+    setControlMessages(num_messages, first_packet, end - first);
+    message_packets_[num_messages] = end - first;
+    ++num_messages;
+    first = end;
+  }
+
+  Api::OsSysCalls& os_syscalls = Api::OsSysCallsSingleton::get();
+  uint32_t done_messages = 0;
+  uint32_t done_packets = 0;
+  uint32_t sent_packets = 0;
+  uint64_t sent_bytes = 0;
+  while (done_messages < num_messages) {
+    const Api::SysCallIntResult result =
+        os_syscalls.sendmmsg(io_handle_.fdDoNotUse(), &messages_[done_messages],
+                             num_messages - done_messages, 0);
+    if (result.return_value_ > 0) {
+      for (int i = 0; i < result.return_value_; ++i) {
+        sent_bytes += messages_[done_messages].msg_len;
+        sent_packets += message_packets_[done_messages];
+        done_packets += message_packets_[done_messages];
+        ++done_messages;
+      }
+      continue;
+    }
+    if (result.return_value_ == 0 || result.errno_ == SOCKET_ERROR_AGAIN) {
+      // The rest is sent once the socket is writable again.
+      write_blocked_ = true;
+      break;
+    }
+    // Like a single sendmsg would, the packets of the message which failed are dropped, and the
+    // next ones are still sent.
+    ENVOY_LOG_MISC(debug, "sendmmsg failed with error code {}: {}", result.errno_,
+                   errorDetails(result.errno_));
+    stats_.pkts_dropped_.add(message_packets_[done_messages]);
+    done_packets += message_packets_[done_messages];
+    ++done_messages;
+  }
+
+  if (sent_packets > 0) {
+    stats_.total_bytes_sent_.add(sent_bytes);
+    stats_.pkts_sent_per_batch_.recordValue(sent_packets);
+  }
+  if (done_packets < num_packets_) {
+    const uint32_t remaining = num_packets_ - done_packets;
+    memmove(slot(0), slot(done_packets), remaining * Network::UdpMaxOutgoingPacketSize);
+    std::move(packets_.begin() + done_packets, packets_.begin() + num_packets_, packets_.begin());
+  }
+  num_packets_ -= done_packets;
+}
+
+Network::UdpPacketWriterPtr
+UdpSendmmsgBatchWriterFactory::createUdpPacketWriter(Network::IoHandle& io_handle,
+                                                     Event::Dispatcher& dispatcher,
+                                                     Stats::Scope& scope) {
+  return std::make_unique<UdpSendmmsgBatchWriter>(io_handle, dispatcher, scope);
+}
+
+} // namespace Quic
+} // namespace Envoy
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "envoy/common/platform.h"
+
+#if !defined(__linux__) || !ENVOY_MMSG_MORE
+#define UDP_SENDMMSG_BATCH_WRITER_COMPILETIME_SUPPORT 0
+#else
+#define UDP_SENDMMSG_BATCH_WRITER_COMPILETIME_SUPPORT 1
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <array>
+#include <memory>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/schedulable_cb.h"
+#include "envoy/network/address.h"
+#include "envoy/network/udp_packet_writer_handler.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "absl/numeric/int128.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Quic {
+
+/**
+ * All stats of UdpSendmmsgBatchWriter. @see stats_macros.h
+ *
+ * @total_bytes_sent: the bytes sent by the writer on its socket.
+ * @pkts_dropped: the packets dropped as sendmmsg failed for them with an error other than EAGAIN.
+ * @pkts_sent_per_batch: the number of packets sent by each flush, from all the connections which
+ * wrote to the writer during the event loop iteration.
+ */
+#define UDP_SENDMMSG_BATCH_WRITER_STATS(COUNTER, HISTOGRAM)                                        \
+  COUNTER(total_bytes_sent)                                                                        \
+  COUNTER(pkts_dropped)                                                                            \
+  HISTOGRAM(pkts_sent_per_batch, Unspecified)
+
+/**
+ * Wrapper struct for udp sendmmsg batch writer stats. @see stats_macros.h
+ */
+struct UdpSendmmsgBatchWriterStats {
+  UDP_SENDMMSG_BATCH_WRITER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * UdpPacketWriter which buffers the packets written by all the connections of a listener during an
+ * event loop iteration, and sends them with as few sendmmsg calls as possible at the end of the
+ * iteration. Consecutive packets of the same size to the same peer from the same local address are
+ * coalesced into a single message with UDP generic segmentation offload(GSO) if the kernel supports
+ * it, so that a burst of a connection costs the kernel a single pass through the stack.
+ */
+class UdpSendmmsgBatchWriter : public Network::UdpPacketWriter {
+public:
+  // The number of packets buffered before they are sent without waiting for the end of the event
+  // loop iteration.
+  static constexpr uint32_t MaxBufferedPackets = 64;
+  // The limits of the kernel on a message sent with GSO.
+  static constexpr uint32_t MaxGsoSegments = 64;
+  static constexpr uint64_t MaxGsoMessageSize = 65507;
+
+  UdpSendmmsgBatchWriter(Network::IoHandle& io_handle, Event::Dispatcher& dispatcher,
+                         Stats::Scope& scope);
+
+  // Network::UdpPacketWriter
+  Api::IoCallUint64Result writePacket(const Buffer::Instance& buffer,
+                                      const Network::Address::Ip* local_ip,
+                                      const Network::Address::Instance& peer_address) override;
+  bool isWriteBlocked() const override { return write_blocked_; }
+  void setWritable() override;
+  uint64_t getMaxPacketSize(const Network::Address::Instance&) const override {
+    return Network::UdpMaxOutgoingPacketSize;
+  }
+  bool isBatchMode() const override { return true; }
+  Network::UdpPacketWriterBuffer
+  getNextWriteLocation(const Network::Address::Ip* local_ip,
+                       const Network::Address::Instance& peer_address) override;
+  // Defers sending the buffered packets to the end of the event loop iteration, so that the
+  // packets flushed by the other connections meanwhile are sent along.
+  Api::IoCallUint64Result flush() override;
+
+  uint32_t bufferedPackets() const { return num_packets_; }
+
+private:
+  struct BufferedPacket {
+    uint64_t length_;
+    sockaddr_storage peer_address_;
+    socklen_t peer_address_length_;
+    // The local address to send the packet from, if any.
+    absl::optional<Network::Address::IpVersion> self_ip_version_;
+    uint32_t self_ipv4_;
+    absl::uint128 self_ipv6_;
+  };
+
+  uint8_t* slot(uint32_t index) {
+    return buffer_.get() + index * Network::UdpMaxOutgoingPacketSize;
+  }
+  static bool samePath(const BufferedPacket& a, const BufferedPacket& b);
+  // Sends as many of the buffered packets as the socket takes, keeping the others buffered if it
+  // would block.
+  void sendBufferedPackets();
+  // Sets the control message selecting the local address of a message, if any, and the GSO segment
+  // size of the message if it carries more than one packet.
+  void setControlMessages(uint32_t message, const BufferedPacket& first_packet,
+                          uint32_t num_segments);
+
+  Network::IoHandle& io_handle_;
+  UdpSendmmsgBatchWriterStats stats_;
+  const bool gso_;
+  Event::SchedulableCallbackPtr flush_cb_;
+  bool write_blocked_{};
+  // MaxBufferedPackets slots of UdpMaxOutgoingPacketSize bytes.
+  std::unique_ptr<uint8_t[]> buffer_;
+  std::array<BufferedPacket, MaxBufferedPackets> packets_;
+  uint32_t num_packets_{};
+  // The messages of a sendmmsg call, and the number of packets each of them carries.
+  std::array<mmsghdr, MaxBufferedPackets> messages_;
+  std::array<uint32_t, MaxBufferedPackets> message_packets_;
+  std::array<iovec, MaxBufferedPackets> iovecs_;
+  static constexpr size_t ControlSize =
+      CMSG_SPACE(sizeof(in6_pktinfo)) + CMSG_SPACE(sizeof(uint16_t));
+  std::array<std::array<uint8_t, ControlSize>, MaxBufferedPackets> control_;
+};
+
+class UdpSendmmsgBatchWriterFactory : public Network::UdpPacketWriterFactory {
+public:
+  Network::UdpPacketWriterPtr createUdpPacketWriter(Network::IoHandle& io_handle,
+                                                    Event::Dispatcher& dispatcher,
+                                                    Stats::Scope& scope) override;
+};
+
+} // namespace Quic
+} // namespace Envoy
+
+#endif // defined(__linux__) && ENVOY_MMSG_MORE
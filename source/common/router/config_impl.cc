@@ -72,7 +72,15 @@ std::string SslRedirector::newPath(const Http::RequestHeaderMap& headers) const
 HedgePolicyImpl::HedgePolicyImpl(const envoy::config::route::v3::HedgePolicy& hedge_policy)
     : initial_requests_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(hedge_policy, initial_requests, 1)),
       additional_request_chance_(hedge_policy.additional_request_chance()),
-      hedge_on_per_try_timeout_(hedge_policy.hedge_on_per_try_timeout()) {}
+      hedge_on_per_try_timeout_(hedge_policy.hedge_on_per_try_timeout()) {
+  if (hedge_policy.has_hedge_on_latency()) {
+    const auto& latency_hedge = hedge_policy.hedge_on_latency();
+    latency_hedge_ = LatencyHedgeSettings{
+        latency_hedge.has_percentile() ? latency_hedge.percentile().value() : 95.0,
+        latency_hedge.has_budget_percent() ? latency_hedge.budget_percent().value() : 10.0,
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(latency_hedge, min_samples, 100)};
+  }
+}
 
 HedgePolicyImpl::HedgePolicyImpl() : initial_requests_(1), hedge_on_per_try_timeout_(false) {}
 
@@ -242,6 +250,7 @@ ShadowPolicyImpl::ShadowPolicyImpl(const RequestMirrorPolicy& config) {
     default_value_.set_numerator(0);
   }
   trace_sampled_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, trace_sampled, true);
+  stream_body_ = config.stream_body();
 }
 
 DecoratorImpl::DecoratorImpl(const envoy::config::route::v3::Decorator& decorator)
@@ -347,6 +356,7 @@ RouteEntryImplBase::RouteEntryImplBase(const VirtualHostImpl& vhost,
           buildInternalRedirectPolicy(route.route(), validator, route.name())),
       rate_limit_policy_(route.route().rate_limits(), validator),
       priority_(ConfigUtility::parsePriority(route.route().priority())),
+      queue_priority_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(route.route(), queue_priority, 0)),
       config_headers_(Http::HeaderUtility::buildHeaderDataVector(route.match().headers())),
       total_cluster_weight_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(route.route().weighted_clusters(), total_weight, 100UL)),
@@ -543,6 +553,18 @@ bool RouteEntryImplBase::matchRoute(const Http::RequestHeaderMap& headers,
   return matches;
 }
 
+bool RouteEntryImplBase::cacheable() const {
+  if (runtime_.has_value() || match_grpc_ || !config_query_parameters_.empty() ||
+      tls_context_match_criteria_ != nullptr || !weighted_clusters_.empty() ||
+      !cluster_header_name_.get().empty()) {
+    return false;
+  }
+  return std::all_of(config_headers_.begin(), config_headers_.end(),
+                     [](const Http::HeaderUtility::HeaderDataPtr& header) {
+                       return header->name_ == Http::Headers::get().Method;
+                     });
+}
+
 const std::string& RouteEntryImplBase::clusterName() const { return cluster_name_; }
 
 void RouteEntryImplBase::finalizeRequestHeaders(Http::RequestHeaderMap& headers,
@@ -1181,7 +1203,8 @@ RouteConstSharedPtr ConnectRouteEntryImpl::matches(const Http::RequestHeaderMap&
 
 VirtualHostImpl::VirtualHostImpl(
     const envoy::config::route::v3::VirtualHost& virtual_host,
-    const OptionalHttpFilters& optional_http_filters, const ConfigImpl& global_route_config,
+    const OptionalHttpFilters& optional_http_filters,
+    const CommonConfigSharedPtr& global_route_config,
     Server::Configuration::ServerFactoryContext& factory_context, Stats::Scope& scope,
     ProtobufMessage::ValidationVisitor& validator,
     const absl::optional<Upstream::ClusterManager::ClusterInfoMaps>& validation_clusters)
@@ -1228,6 +1251,7 @@ VirtualHostImpl::VirtualHostImpl(
   }
 
   for (const auto& route : virtual_host.routes()) {
+    route_index_.addRoute(route.match());
     switch (route.match().path_specifier_case()) {
     case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPrefix: {
       routes_.emplace_back(new PrefixRouteEntryImpl(*this, route, optional_http_filters,
@@ -1265,6 +1289,12 @@ VirtualHostImpl::VirtualHostImpl(
       }
     }
   }
+  route_index_.finalize();
+  cacheable_ = ssl_requirements_ != SslRequirements::ExternalOnly &&
+               std::all_of(routes_.begin(), routes_.end(),
+                           [](const RouteEntryImplBaseConstSharedPtr& route) {
+                             return route->cacheable();
+                           });
 
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
     virtual_clusters_.push_back(
@@ -1291,39 +1321,96 @@ VirtualHostImpl::VirtualClusterEntry::VirtualClusterEntry(
   headers_ = Http::HeaderUtility::buildHeaderDataVector(virtual_cluster.headers());
 }
 
-const Config& VirtualHostImpl::routeConfig() const { return global_route_config_; }
+const CommonConfig& VirtualHostImpl::routeConfig() const { return *global_route_config_; }
 
 const RouteSpecificFilterConfig* VirtualHostImpl::perFilterConfig(const std::string& name) const {
   return per_filter_configs_.get(name);
 }
 
-const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
-    const std::string& host, const RouteMatcher::WildcardVirtualHosts& wildcard_virtual_hosts,
-    RouteMatcher::SubstringFunction substring_function) const {
-  // We do a longest wildcard match against the host that's passed in
-  // (e.g. "foo-bar.baz.com" should match "*-bar.baz.com" before matching "*.baz.com" for suffix
-  // wildcards). This is done by scanning the length => wildcards map looking for every wildcard
-  // whose size is < length.
-  for (const auto& iter : wildcard_virtual_hosts) {
-    const uint32_t wildcard_length = iter.first;
-    const auto& wildcard_map = iter.second;
-    // >= because *.foo.com shouldn't match .foo.com.
-    if (wildcard_length >= host.size()) {
-      continue;
+bool RouteMatcher::WildcardVirtualHosts::add(absl::string_view domain,
+                                             const VirtualHostSharedPtr& virtual_host) {
+  std::string key(domain);
+  if (suffixes_) {
+    std::reverse(key.begin(), key.end());
+  }
+
+  Node* node = &root_;
+  absl::string_view remaining = key;
+  while (!remaining.empty()) {
+    auto child = std::find_if(
+        node->children_.begin(), node->children_.end(),
+        [&](const auto& candidate) { return candidate->label_[0] == remaining[0]; });
+    if (child == node->children_.end()) {
+      node->children_.push_back(std::make_unique<Node>());
+      node = node->children_.back().get();
+      node->label_ = std::string(remaining);
+      break;
     }
-    const auto& match = wildcard_map.find(substring_function(host, wildcard_length));
-    if (match != wildcard_map.end()) {
-      return match->second.get();
+
+    const std::string& label = (*child)->label_;
+    const auto mismatch =
+        std::mismatch(label.begin(), label.end(), remaining.begin(), remaining.end());
+    const size_t common = mismatch.first - label.begin();
+    if (common < label.size()) {
+      // The domain diverges from the edge, so the edge is split at the divergence.
+      auto split = std::make_unique<Node>();
+      split->label_ = label.substr(0, common);
+      (*child)->label_ = label.substr(common);
+      split->children_.push_back(std::move(*child));
+      *child = std::move(split);
+    }
+    node = child->get();
+    remaining.remove_prefix(common);
+  }
+
+  if (node->virtual_host_ != nullptr) {
+    return false;
+  }
+  node->virtual_host_ = virtual_host;
+  return true;
+}
+
+const RouteMatcher::WildcardVirtualHosts::Node*
+RouteMatcher::WildcardVirtualHosts::findChild(const Node& node, char first) {
+  for (const auto& child : node.children_) {
+    if (child->label_[0] == first) {
+      return child.get();
     }
   }
   return nullptr;
 }
 
+const VirtualHostImpl*
+RouteMatcher::WildcardVirtualHosts::findLongestMatch(absl::string_view host) const {
+  // The deeper a node, the longer its wildcard, so the last node holding a virtual host before the
+  // whole host is consumed has the longest match.
+  const VirtualHostImpl* longest_match = nullptr;
+  const Node* node = &root_;
+  size_t depth = 0;
+  while (depth < host.size()) {
+    if (node->virtual_host_ != nullptr) {
+      longest_match = node->virtual_host_.get();
+    }
+    node = findChild(*node, at(host, depth));
+    if (node == nullptr || node->label_.size() > host.size() - depth) {
+      break;
+    }
+    for (size_t i = 1; i < node->label_.size(); ++i) {
+      if (node->label_[i] != at(host, depth + i)) {
+        return longest_match;
+      }
+    }
+    depth += node->label_.size();
+  }
+  return longest_match;
+}
+
 RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& route_config,
                            const OptionalHttpFilters& optional_http_filters,
-                           const ConfigImpl& global_route_config,
+                           const CommonConfigSharedPtr& global_route_config,
                            Server::Configuration::ServerFactoryContext& factory_context,
-                           ProtobufMessage::ValidationVisitor& validator, bool validate_clusters)
+                           ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
+                           const RouteMatcher* previous)
     : vhost_scope_(factory_context.scope().scopeFromStatName(
           factory_context.routerContext().virtualClusterStatNames().vhost_)) {
   absl::optional<Upstream::ClusterManager::ClusterInfoMaps> validation_clusters;
@@ -1331,9 +1418,25 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
     validation_clusters = factory_context.clusterManager().clusters();
   }
   for (const auto& virtual_host_config : route_config.virtual_hosts()) {
-    VirtualHostSharedPtr virtual_host(
-        new VirtualHostImpl(virtual_host_config, optional_http_filters, global_route_config,
-                            factory_context, *vhost_scope_, validator, validation_clusters));
+    // The virtual hosts are never reused when their clusters are validated, so they need no hash.
+    const uint64_t hash = validate_clusters ? 0 : MessageUtil::hash(virtual_host_config);
+    VirtualHostSharedPtr virtual_host;
+    if (previous != nullptr) {
+      auto reusable = previous->virtual_hosts_by_hash_.find(hash);
+      if (reusable != previous->virtual_hosts_by_hash_.end()) {
+        virtual_host = reusable->second;
+        ++virtual_hosts_reused_;
+      }
+    }
+    if (virtual_host == nullptr) {
+      virtual_host = std::make_shared<VirtualHostImpl>(
+          virtual_host_config, optional_http_filters, global_route_config, factory_context,
+          *vhost_scope_, validator, validation_clusters);
+      ++virtual_hosts_built_;
+    }
+    if (!validate_clusters) {
+      virtual_hosts_by_hash_.emplace(hash, virtual_host);
+    }
     for (const std::string& domain_name : virtual_host_config.domains()) {
       const std::string domain = Http::LowerCaseString(domain_name).get();
       bool duplicate_found = false;
@@ -1344,13 +1447,11 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
         }
         default_virtual_host_ = virtual_host;
       } else if (!domain.empty() && '*' == domain[0]) {
-        duplicate_found = !wildcard_virtual_host_suffixes_[domain.size() - 1]
-                               .emplace(domain.substr(1), virtual_host)
-                               .second;
+        duplicate_found =
+            !wildcard_virtual_host_suffixes_.add(absl::string_view(domain).substr(1), virtual_host);
       } else if (!domain.empty() && '*' == domain[domain.size() - 1]) {
-        duplicate_found = !wildcard_virtual_host_prefixes_[domain.size() - 1]
-                               .emplace(domain.substr(0, domain.size() - 1), virtual_host)
-                               .second;
+        duplicate_found = !wildcard_virtual_host_prefixes_.add(
+            absl::string_view(domain).substr(0, domain.size() - 1), virtual_host);
       } else {
         duplicate_found = !virtual_hosts_.emplace(domain, virtual_host).second;
       }
@@ -1383,19 +1484,28 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
     return SSL_REDIRECT_ROUTE;
   }
 
-  // Check for a route that matches the request.
-  for (auto route = routes_.begin(); route != routes_.end(); ++route) {
-    if (!headers.Path() && !(*route)->supportsPathlessHeaders()) {
-      continue;
+  // Check for a route that matches the request. With a path, only the routes whose path specifier
+  // may match it are evaluated, in their configured order.
+  RouteIndex::Candidates candidates;
+  if (headers.Path()) {
+    route_index_.candidates(headers.getPathValue(), candidates);
+  } else {
+    for (uint32_t position = 0; position < routes_.size(); ++position) {
+      if (routes_[position]->supportsPathlessHeaders()) {
+        candidates.push_back(position);
+      }
     }
+  }
 
-    RouteConstSharedPtr route_entry = (*route)->matches(headers, stream_info, random_value);
+  for (const uint32_t position : candidates) {
+    RouteConstSharedPtr route_entry =
+        routes_[position]->matches(headers, stream_info, random_value);
     if (nullptr == route_entry) {
       continue;
     }
 
     if (cb) {
-      RouteEvalStatus eval_status = (std::next(route) == routes_.end())
+      RouteEvalStatus eval_status = (position + 1 == routes_.size())
                                         ? RouteEvalStatus::NoMoreRoutes
                                         : RouteEvalStatus::HasMoreRoutes;
       RouteMatchStatus match_status = cb(route_entry, eval_status);
@@ -1435,18 +1545,16 @@ const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::RequestHeaderMa
   if (iter != virtual_hosts_.end()) {
     return iter->second.get();
   }
+  // A longest wildcard match against the host (e.g. "foo-bar.baz.com" matches "*-bar.baz.com"
+  // before "*.baz.com" for suffix wildcards), suffix wildcards first.
   if (!wildcard_virtual_host_suffixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_suffixes_,
-        [](const std::string& h, int l) -> std::string { return h.substr(h.size() - l); });
+    const VirtualHostImpl* vhost = wildcard_virtual_host_suffixes_.findLongestMatch(host);
     if (vhost != nullptr) {
       return vhost;
     }
   }
   if (!wildcard_virtual_host_prefixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_prefixes_,
-        [](const std::string& h, int l) -> std::string { return h.substr(0, l); });
+    const VirtualHostImpl* vhost = wildcard_virtual_host_prefixes_.findLongestMatch(host);
     if (vhost != nullptr) {
       return vhost;
     }
@@ -1486,36 +1594,101 @@ VirtualHostImpl::virtualClusterFromEntries(const Http::HeaderMap& headers) const
   return nullptr;
 }
 
-ConfigImpl::ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
-                       const OptionalHttpFilters& optional_http_filters,
-                       Server::Configuration::ServerFactoryContext& factory_context,
-                       ProtobufMessage::ValidationVisitor& validator,
-                       bool validate_clusters_default)
-    : name_(config.name()), symbol_table_(factory_context.scope().symbolTable()),
-      uses_vhds_(config.has_vhds()),
+namespace {
+
+// @return the hash of the route configuration without its virtual hosts.
+uint64_t sharedConfigHash(const envoy::config::route::v3::RouteConfiguration& config) {
+  const Protobuf::Descriptor* descriptor = config.GetDescriptor();
+  ProtobufWkt::FieldMask shared_fields;
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const Protobuf::FieldDescriptor* field = descriptor->field(i);
+    if (field->number() != envoy::config::route::v3::RouteConfiguration::kVirtualHostsFieldNumber) {
+      shared_fields.add_paths(field->name());
+    }
+  }
+  envoy::config::route::v3::RouteConfiguration shared_config;
+  ProtobufUtil::FieldMaskUtil::MergeMessageTo(
+      config, shared_fields, ProtobufUtil::FieldMaskUtil::MergeOptions(), &shared_config);
+  return MessageUtil::hash(shared_config);
+}
+
+} // namespace
+
+CommonConfigImpl::CommonConfigImpl(const envoy::config::route::v3::RouteConfiguration& config)
+    : request_headers_parser_(HeaderParser::configure(config.request_headers_to_add(),
+                                                      config.request_headers_to_remove())),
+      response_headers_parser_(HeaderParser::configure(config.response_headers_to_add(),
+                                                       config.response_headers_to_remove())),
+      name_(config.name()), uses_vhds_(config.has_vhds()),
       most_specific_header_mutations_wins_(config.most_specific_header_mutations_wins()),
       max_direct_response_body_size_bytes_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_direct_response_body_size_bytes,
                                           DEFAULT_MAX_DIRECT_RESPONSE_BODY_SIZE_BYTES)) {
-  route_matcher_ = std::make_unique<RouteMatcher>(
-      config, optional_http_filters, *this, factory_context, validator,
-      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default));
-
   for (const std::string& header : config.internal_only_headers()) {
     internal_only_headers_.push_back(Http::LowerCaseString(header));
   }
+}
 
-  request_headers_parser_ =
-      HeaderParser::configure(config.request_headers_to_add(), config.request_headers_to_remove());
-  response_headers_parser_ = HeaderParser::configure(config.response_headers_to_add(),
-                                                     config.response_headers_to_remove());
+ConfigImpl::ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
+                       const OptionalHttpFilters& optional_http_filters,
+                       Server::Configuration::ServerFactoryContext& factory_context,
+                       ProtobufMessage::ValidationVisitor& validator,
+                       bool validate_clusters_default, const ConfigImpl* previous_config)
+    : shared_config_hash_(sharedConfigHash(config)) {
+  const bool validate_clusters =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default);
+  // The virtual hosts only depend on the rest of the route configuration through the shared
+  // config, and the clusters they reference have to be validated again if requested.
+  const RouteMatcher* previous_matcher = nullptr;
+  if (previous_config != nullptr && previous_config->shared_config_hash_ == shared_config_hash_ &&
+      !validate_clusters) {
+    shared_config_ = previous_config->shared_config_;
+    previous_matcher = previous_config->route_matcher_.get();
+  } else {
+    shared_config_ = std::make_shared<CommonConfigImpl>(config);
+  }
+  route_matcher_ = std::make_unique<RouteMatcher>(config, optional_http_filters, shared_config_,
+                                                  factory_context, validator, validate_clusters,
+                                                  previous_matcher);
+
+  const uint32_t route_cache_size = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, route_cache_size, 0);
+  if (route_cache_size > 0) {
+    route_caches_ = std::make_unique<WorkerRouteCaches>(
+        route_cache_size, factory_context.scope(),
+        fmt::format("route_config.{}.route_cache.", name()));
+  }
 }
 
 RouteConstSharedPtr ConfigImpl::route(const RouteCallback& cb,
                                       const Http::RequestHeaderMap& headers,
                                       const StreamInfo::StreamInfo& stream_info,
                                       uint64_t random_value) const {
-  return route_matcher_->route(cb, headers, stream_info, random_value);
+  // The callback may reject routes, so its lookups are not cached.
+  if (route_caches_ == nullptr || cb) {
+    return route_matcher_->route(cb, headers, stream_info, random_value);
+  }
+
+  RouteCache& route_cache = route_caches_->local();
+  RouteConstSharedPtr route;
+  if (route_cache.find(headers, route)) {
+    route_caches_->stats().hit_.inc();
+    return route;
+  }
+
+  const VirtualHostImpl* virtual_host = route_matcher_->findVirtualHost(headers);
+  if (virtual_host == nullptr) {
+    return nullptr;
+  }
+  route = virtual_host->getRouteFromEntries(nullptr, headers, stream_info, random_value);
+  if (virtual_host->cacheable()) {
+    route_caches_->stats().miss_.inc();
+    if (route_cache.insert(route)) {
+      route_caches_->stats().eviction_.inc();
+    }
+  } else {
+    route_caches_->stats().uncacheable_.inc();
+  }
+  return route;
 }
 
 RouteSpecificFilterConfigConstSharedPtr PerFilterConfigs::createRouteSpecificFilterConfig(
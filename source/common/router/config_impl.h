@@ -27,10 +27,13 @@
 #include "source/common/router/header_formatter.h"
 #include "source/common/router/header_parser.h"
 #include "source/common/router/metadatamatchcriteria_impl.h"
+#include "source/common/router/route_cache_impl.h"
+#include "source/common/router/route_index.h"
 #include "source/common/router/router_ratelimit.h"
 #include "source/common/router/tls_context_match_criteria_impl.h"
 #include "source/common/stats/symbol_table_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/types/optional.h"
 
@@ -180,7 +183,43 @@ private:
   const bool legacy_enabled_;
 };
 
-class ConfigImpl;
+/**
+ * The settings of a route configuration that do not depend on its virtual hosts. They are shared
+ * by the virtual hosts, which keep them alive when they are reused by a newer version of the route
+ * configuration.
+ */
+class CommonConfigImpl : public CommonConfig {
+public:
+  explicit CommonConfigImpl(const envoy::config::route::v3::RouteConfiguration& config);
+
+  const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; };
+  const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; };
+
+  // Router::CommonConfig
+  const std::list<Http::LowerCaseString>& internalOnlyHeaders() const override {
+    return internal_only_headers_;
+  }
+  const std::string& name() const override { return name_; }
+  bool usesVhds() const override { return uses_vhds_; }
+  bool mostSpecificHeaderMutationsWins() const override {
+    return most_specific_header_mutations_wins_;
+  }
+  uint32_t maxDirectResponseBodySizeBytes() const override {
+    return max_direct_response_body_size_bytes_;
+  }
+
+private:
+  std::list<Http::LowerCaseString> internal_only_headers_;
+  HeaderParserPtr request_headers_parser_;
+  HeaderParserPtr response_headers_parser_;
+  const std::string name_;
+  const bool uses_vhds_;
+  const bool most_specific_header_mutations_wins_;
+  const uint32_t max_direct_response_body_size_bytes_;
+};
+
+using CommonConfigSharedPtr = std::shared_ptr<const CommonConfigImpl>;
+
 /**
  * Holds all routing configuration for an entire virtual host.
  */
@@ -188,7 +227,8 @@ class VirtualHostImpl : public VirtualHost {
 public:
   VirtualHostImpl(
       const envoy::config::route::v3::VirtualHost& virtual_host,
-      const OptionalHttpFilters& optional_http_filters, const ConfigImpl& global_route_config,
+      const OptionalHttpFilters& optional_http_filters,
+      const CommonConfigSharedPtr& global_route_config,
       Server::Configuration::ServerFactoryContext& factory_context, Stats::Scope& scope,
       ProtobufMessage::ValidationVisitor& validator,
       const absl::optional<Upstream::ClusterManager::ClusterInfoMaps>& validation_clusters);
@@ -198,7 +238,10 @@ public:
                                           const StreamInfo::StreamInfo& stream_info,
                                           uint64_t random_value) const;
   const VirtualCluster* virtualClusterFromEntries(const Http::HeaderMap& headers) const;
-  const ConfigImpl& globalRouteConfig() const { return global_route_config_; }
+  // Whether the route selected for a request depends on nothing but its authority, path, method
+  // and x-forwarded-proto header.
+  bool cacheable() const { return cacheable_; }
+  const CommonConfigImpl& globalRouteConfig() const { return *global_route_config_; }
   const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; }
   const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; }
 
@@ -206,7 +249,7 @@ public:
   const CorsPolicy* corsPolicy() const override { return cors_policy_.get(); }
   Stats::StatName statName() const override { return stat_name_storage_.statName(); }
   const RateLimitPolicy& rateLimitPolicy() const override { return rate_limit_policy_; }
-  const Config& routeConfig() const override;
+  const CommonConfig& routeConfig() const override;
   const RouteSpecificFilterConfig* perFilterConfig(const std::string&) const override;
   bool includeAttemptCountInRequest() const override { return include_attempt_count_in_request_; }
   bool includeAttemptCountInResponse() const override { return include_attempt_count_in_response_; }
@@ -261,18 +304,19 @@ private:
   const Stats::StatNameManagedStorage stat_name_storage_;
   Stats::ScopePtr vcluster_scope_;
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  RouteIndex route_index_;
   std::vector<VirtualClusterEntry> virtual_clusters_;
   SslRequirements ssl_requirements_;
   const RateLimitPolicyImpl rate_limit_policy_;
   std::unique_ptr<const CorsPolicyImpl> cors_policy_;
-  const ConfigImpl& global_route_config_; // See note in RouteEntryImplBase::clusterEntry() on why
-                                          // raw ref to the top level config is currently safe.
+  const CommonConfigSharedPtr global_route_config_;
   HeaderParserPtr request_headers_parser_;
   HeaderParserPtr response_headers_parser_;
   PerFilterConfigs per_filter_configs_;
   uint32_t retry_shadow_buffer_limit_{std::numeric_limits<uint32_t>::max()};
   const bool include_attempt_count_in_request_;
   const bool include_attempt_count_in_response_;
+  bool cacheable_{};
   absl::optional<envoy::config::route::v3::RetryPolicy> retry_policy_;
   absl::optional<envoy::config::route::v3::HedgePolicy> hedge_policy_;
   const CatchAllVirtualCluster virtual_cluster_catch_all_;
@@ -352,12 +396,14 @@ public:
   const std::string& runtimeKey() const override { return runtime_key_; }
   const envoy::type::v3::FractionalPercent& defaultValue() const override { return default_value_; }
   bool traceSampled() const override { return trace_sampled_; }
+  bool streamBody() const override { return stream_body_; }
 
 private:
   std::string cluster_;
   std::string runtime_key_;
   envoy::type::v3::FractionalPercent default_value_;
   bool trace_sampled_;
+  bool stream_body_;
 };
 
 /**
@@ -375,11 +421,15 @@ public:
     return additional_request_chance_;
   }
   bool hedgeOnPerTryTimeout() const override { return hedge_on_per_try_timeout_; }
+  const LatencyHedgeSettings* latencyHedge() const override {
+    return latency_hedge_.has_value() ? &latency_hedge_.value() : nullptr;
+  }
 
 private:
   const uint32_t initial_requests_;
   const envoy::type::v3::FractionalPercent additional_request_chance_;
   const bool hedge_on_per_try_timeout_;
+  absl::optional<LatencyHedgeSettings> latency_hedge_;
 };
 
 /**
@@ -499,6 +549,11 @@ public:
 
   bool matchRoute(const Http::RequestHeaderMap& headers, const StreamInfo::StreamInfo& stream_info,
                   uint64_t random_value) const;
+  /**
+   * @return whether the route matches and selects its cluster from nothing but the authority, path,
+   *         method and x-forwarded-proto header of a request, so that its selection can be cached.
+   */
+  bool cacheable() const;
   void validateClusters(const Upstream::ClusterManager::ClusterInfoMaps& cluster_info_maps) const;
 
   // Router::RouteEntry
@@ -526,6 +581,7 @@ public:
     return tls_context_match_criteria_.get();
   }
   Upstream::ResourcePriority priority() const override { return priority_; }
+  uint32_t queuePriority() const override { return queue_priority_; }
   const RateLimitPolicy& rateLimitPolicy() const override { return rate_limit_policy_; }
   const RetryPolicy& retryPolicy() const override { return retry_policy_; }
   const InternalRedirectPolicy& internalRedirectPolicy() const override {
@@ -657,6 +713,7 @@ private:
     const Http::HashPolicy* hashPolicy() const override { return parent_->hashPolicy(); }
     const HedgePolicy& hedgePolicy() const override { return parent_->hedgePolicy(); }
     Upstream::ResourcePriority priority() const override { return parent_->priority(); }
+    uint32_t queuePriority() const override { return parent_->queuePriority(); }
     const RateLimitPolicy& rateLimitPolicy() const override { return parent_->rateLimitPolicy(); }
     const RetryPolicy& retryPolicy() const override { return parent_->retryPolicy(); }
     const InternalRedirectPolicy& internalRedirectPolicy() const override {
@@ -863,6 +920,7 @@ private:
   const RateLimitPolicyImpl rate_limit_policy_;
   std::vector<ShadowPolicyPtr> shadow_policies_;
   const Upstream::ResourcePriority priority_;
+  const uint32_t queue_priority_;
   std::vector<Http::HeaderUtility::HeaderDataPtr> config_headers_;
   std::vector<ConfigUtility::QueryParameterMatcherPtr> config_query_parameters_;
   std::vector<WeightedClusterEntrySharedPtr> weighted_clusters_;
@@ -1021,40 +1079,81 @@ public:
  */
 class RouteMatcher {
 public:
+  /**
+   * @param previous supplies the matcher of the previous version of the route configuration, whose
+   *        virtual hosts with an unchanged configuration are reused instead of being built again,
+   *        or nullptr to build all of them. They must have been built with the same global config.
+   */
   RouteMatcher(const envoy::config::route::v3::RouteConfiguration& config,
                const OptionalHttpFilters& optional_http_filters,
-               const ConfigImpl& global_http_config,
+               const CommonConfigSharedPtr& global_route_config,
                Server::Configuration::ServerFactoryContext& factory_context,
-               ProtobufMessage::ValidationVisitor& validator, bool validate_clusters);
+               ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
+               const RouteMatcher* previous);
 
   RouteConstSharedPtr route(const RouteCallback& cb, const Http::RequestHeaderMap& headers,
                             const StreamInfo::StreamInfo& stream_info, uint64_t random_value) const;
 
   const VirtualHostImpl* findVirtualHost(const Http::RequestHeaderMap& headers) const;
 
+  uint32_t virtualHostsBuilt() const { return virtual_hosts_built_; }
+  uint32_t virtualHostsReused() const { return virtual_hosts_reused_; }
+
 private:
-  using WildcardVirtualHosts =
-      std::map<int64_t, absl::node_hash_map<std::string, VirtualHostSharedPtr>, std::greater<>>;
-  using SubstringFunction = std::function<std::string(const std::string&, int)>;
-  const VirtualHostImpl* findWildcardVirtualHost(const std::string& host,
-                                                 const WildcardVirtualHosts& wildcard_virtual_hosts,
-                                                 SubstringFunction substring_function) const;
+  /**
+   * The wildcard domains of the virtual hosts in a compressed trie over their characters, which
+   * finds the virtual host of the longest wildcard matching a host in one pass over the host,
+   * without allocating. The domains of suffix wildcards such as "*.foo.com" are walked from their
+   * end, and the domains of prefix wildcards such as "foo.*" from their start.
+   */
+  class WildcardVirtualHosts {
+  public:
+    explicit WildcardVirtualHosts(bool suffixes) : suffixes_(suffixes) {}
+
+    /**
+     * @param domain supplies the domain without its wildcard.
+     * @param virtual_host supplies the virtual host of the domain.
+     * @return false if the domain already has a virtual host.
+     */
+    bool add(absl::string_view domain, const VirtualHostSharedPtr& virtual_host);
+
+    /**
+     * @return the virtual host of the longest wildcard matching the host, or nullptr if there is
+     *         none. The wildcard has to match at least one character, so "*.foo.com" does not
+     *         match ".foo.com".
+     */
+    const VirtualHostImpl* findLongestMatch(absl::string_view host) const;
+
+    bool empty() const { return root_.children_.empty(); }
+
+  private:
+    struct Node {
+      // The characters of the edge leading to the node, in walk order.
+      std::string label_;
+      VirtualHostSharedPtr virtual_host_;
+      std::vector<std::unique_ptr<Node>> children_;
+    };
+
+    static const Node* findChild(const Node& node, char first);
+    // @return the character of the domain at the position in walk order.
+    char at(absl::string_view domain, size_t position) const {
+      return suffixes_ ? domain[domain.size() - 1 - position] : domain[position];
+    }
+
+    const bool suffixes_;
+    Node root_;
+  };
 
   Stats::ScopePtr vhost_scope_;
   absl::node_hash_map<std::string, VirtualHostSharedPtr> virtual_hosts_;
-  // std::greater as a minor optimization to iterate from more to less specific
-  //
-  // A note on using an unordered_map versus a vector of (string, VirtualHostSharedPtr) pairs:
-  //
-  // Based on local benchmarks, each vector entry costs around 20ns for recall and (string)
-  // comparison with a fixed cost of about 25ns. For unordered_map, the empty map costs about 65ns
-  // and climbs to about 110ns once there are any entries.
-  //
-  // The break-even is 4 entries.
-  WildcardVirtualHosts wildcard_virtual_host_suffixes_;
-  WildcardVirtualHosts wildcard_virtual_host_prefixes_;
+  WildcardVirtualHosts wildcard_virtual_host_suffixes_{true};
+  WildcardVirtualHosts wildcard_virtual_host_prefixes_{false};
 
   VirtualHostSharedPtr default_virtual_host_;
+  // The virtual hosts keyed by the hash of their configuration, for the next version to reuse.
+  absl::flat_hash_map<uint64_t, VirtualHostSharedPtr> virtual_hosts_by_hash_;
+  uint32_t virtual_hosts_built_{};
+  uint32_t virtual_hosts_reused_{};
 };
 
 /**
@@ -1062,18 +1161,37 @@ private:
  */
 class ConfigImpl : public Config {
 public:
+  /**
+   * @param previous_config supplies the previous version of the route configuration, whose virtual
+   *        hosts are reused when neither their configuration nor the rest of the route
+   *        configuration changed, or nullptr to build every virtual host.
+   */
   ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
              const OptionalHttpFilters& optional_http_filters,
              Server::Configuration::ServerFactoryContext& factory_context,
-             ProtobufMessage::ValidationVisitor& validator, bool validate_clusters_default);
+             ProtobufMessage::ValidationVisitor& validator, bool validate_clusters_default,
+             const ConfigImpl* previous_config = nullptr);
 
-  const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; };
-  const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; };
+  const HeaderParser& requestHeaderParser() const { return shared_config_->requestHeaderParser(); };
+  const HeaderParser& responseHeaderParser() const {
+    return shared_config_->responseHeaderParser();
+  };
 
   bool virtualHostExists(const Http::RequestHeaderMap& headers) const {
     return route_matcher_->findVirtualHost(headers) != nullptr;
   }
 
+  /**
+   * @return the number of virtual hosts built for this version of the route configuration.
+   */
+  uint32_t virtualHostsBuilt() const { return route_matcher_->virtualHostsBuilt(); }
+
+  /**
+   * @return the number of virtual hosts reused from the previous version of the route
+   *         configuration.
+   */
+  uint32_t virtualHostsReused() const { return route_matcher_->virtualHostsReused(); }
+
   // Router::Config
   RouteConstSharedPtr route(const Http::RequestHeaderMap& headers,
                             const StreamInfo::StreamInfo& stream_info,
@@ -1086,31 +1204,28 @@ public:
                             uint64_t random_value) const override;
 
   const std::list<Http::LowerCaseString>& internalOnlyHeaders() const override {
-    return internal_only_headers_;
+    return shared_config_->internalOnlyHeaders();
   }
 
-  const std::string& name() const override { return name_; }
+  const std::string& name() const override { return shared_config_->name(); }
 
-  bool usesVhds() const override { return uses_vhds_; }
+  bool usesVhds() const override { return shared_config_->usesVhds(); }
 
   bool mostSpecificHeaderMutationsWins() const override {
-    return most_specific_header_mutations_wins_;
+    return shared_config_->mostSpecificHeaderMutationsWins();
   }
 
   uint32_t maxDirectResponseBodySizeBytes() const override {
-    return max_direct_response_body_size_bytes_;
+    return shared_config_->maxDirectResponseBodySizeBytes();
   }
 
 private:
+  // The hash of the route configuration without its virtual hosts.
+  const uint64_t shared_config_hash_;
+  CommonConfigSharedPtr shared_config_;
   std::unique_ptr<RouteMatcher> route_matcher_;
-  std::list<Http::LowerCaseString> internal_only_headers_;
-  HeaderParserPtr request_headers_parser_;
-  HeaderParserPtr response_headers_parser_;
-  const std::string name_;
-  Stats::SymbolTable& symbol_table_;
-  const bool uses_vhds_;
-  const bool most_specific_header_mutations_wins_;
-  const uint32_t max_direct_response_body_size_bytes_;
+  // Set if the route table caches the routes selected by each worker.
+  WorkerRouteCachesPtr route_caches_;
 };
 
 /**
@@ -66,6 +66,10 @@ Upstream::ResourcePriority DelegatingRouteEntry::priority() const {
   return base_route_->routeEntry()->priority();
 }
 
+uint32_t DelegatingRouteEntry::queuePriority() const {
+  return base_route_->routeEntry()->queuePriority();
+}
+
 const RateLimitPolicy& DelegatingRouteEntry::rateLimitPolicy() const {
   return base_route_->routeEntry()->rateLimitPolicy();
 }
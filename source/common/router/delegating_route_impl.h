@@ -61,6 +61,7 @@ public:
   const Http::HashPolicy* hashPolicy() const override;
   const HedgePolicy& hedgePolicy() const override;
   Upstream::ResourcePriority priority() const override;
+  uint32_t queuePriority() const override;
   const RateLimitPolicy& rateLimitPolicy() const override;
   const RetryPolicy& retryPolicy() const override;
   const InternalRedirectPolicy& internalRedirectPolicy() const override;
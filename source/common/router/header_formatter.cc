@@ -346,6 +346,7 @@ StreamInfoHeaderFormatter::StreamInfoHeaderFormatter(absl::string_view field_nam
   } else if (field_name == "HOSTNAME") {
     std::string hostname = Envoy::Formatter::SubstitutionFormatUtils::getHostnameOrDefault();
     field_extractor_ = [hostname](const StreamInfo::StreamInfo&) { return hostname; };
+    static_value_ = hostname;
   } else if (field_name == "RESPONSE_FLAGS") {
     field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
       return StreamInfo::ResponseFlagUtils::toShortString(stream_info);
@@ -360,6 +361,11 @@ StreamInfoHeaderFormatter::StreamInfoHeaderFormatter(absl::string_view field_nam
   } else {
     throw EnvoyException(fmt::format("field '{}' not supported as custom header", field_name));
   }
+
+  // The local address and the TLS session of the downstream connection are the same for all of its
+  // streams, unlike the remote address, which may be taken from the x-forwarded-for header.
+  connection_scoped_ = absl::StartsWith(field_name, "DOWNSTREAM_") &&
+                       !absl::StartsWith(field_name, "DOWNSTREAM_REMOTE_ADDRESS");
 }
 
 const std::string
@@ -367,5 +373,27 @@ StreamInfoHeaderFormatter::format(const Envoy::StreamInfo::StreamInfo& stream_in
   return field_extractor_(stream_info);
 }
 
+CompoundHeaderFormatter::CompoundHeaderFormatter(std::vector<HeaderFormatterPtr>&& formatters,
+                                                 bool append)
+    : formatters_(std::move(formatters)), append_(append) {
+  std::string static_value;
+  bool all_static = true;
+  bool all_connection_scoped = true;
+  for (const auto& formatter : formatters_) {
+    const std::string* formatter_static_value = formatter->staticValue();
+    if (formatter_static_value != nullptr) {
+      static_value += *formatter_static_value;
+    } else {
+      all_static = false;
+      all_connection_scoped &= formatter->connectionScoped();
+    }
+  }
+  if (all_static) {
+    static_value_ = std::move(static_value);
+  } else {
+    connection_scoped_ = all_connection_scoped;
+  }
+}
+
 } // namespace Router
 } // namespace Envoy
@@ -3,11 +3,13 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/formatter/substitution_formatter.h"
 
 #include "absl/container/node_hash_map.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Router {
@@ -26,6 +28,18 @@ public:
    *              headers or replace any existing values for the header
    */
   virtual bool append() const PURE;
+
+  /**
+   * @return the value produced for every stream if it does not depend on the stream, or nullptr.
+   *         The value lives as long as the formatter, so it can be added to headers by reference.
+   */
+  virtual const std::string* staticValue() const { return nullptr; }
+
+  /**
+   * @return whether the value does not depend on anything but the downstream connection of the
+   *         stream, so that it can be formatted once per connection.
+   */
+  virtual bool connectionScoped() const { return false; }
 };
 
 using HeaderFormatterPtr = std::unique_ptr<HeaderFormatter>;
@@ -40,6 +54,10 @@ public:
   // HeaderFormatter::format
   const std::string format(const Envoy::StreamInfo::StreamInfo& stream_info) const override;
   bool append() const override { return append_; }
+  const std::string* staticValue() const override {
+    return static_value_.has_value() ? &static_value_.value() : nullptr;
+  }
+  bool connectionScoped() const override { return connection_scoped_; }
 
   using FieldExtractor = std::function<std::string(const Envoy::StreamInfo::StreamInfo&)>;
   using FormatterPtrMap = absl::node_hash_map<std::string, Envoy::Formatter::FormatterPtr>;
@@ -47,6 +65,10 @@ public:
 private:
   FieldExtractor field_extractor_;
   const bool append_;
+  // Set for the fields which are the same for every stream, such as HOSTNAME.
+  absl::optional<std::string> static_value_;
+  // Set for the fields of the downstream connection, such as its TLS session.
+  bool connection_scoped_{};
 
   // Maps a string format pattern (including field name and any command operators between
   // parenthesis) to the list of FormatterProviderPtrs that are capable of formatting that pattern.
@@ -69,6 +91,7 @@ public:
     return static_value_;
   };
   bool append() const override { return append_; }
+  const std::string* staticValue() const override { return &static_value_; }
 
 private:
   const std::string static_value_;
@@ -80,8 +103,7 @@ private:
  */
 class CompoundHeaderFormatter : public HeaderFormatter {
 public:
-  CompoundHeaderFormatter(std::vector<HeaderFormatterPtr>&& formatters, bool append)
-      : formatters_(std::move(formatters)), append_(append) {}
+  CompoundHeaderFormatter(std::vector<HeaderFormatterPtr>&& formatters, bool append);
 
   // HeaderFormatter::format
   const std::string format(const Envoy::StreamInfo::StreamInfo& stream_info) const override {
@@ -92,10 +114,18 @@ public:
     return buf;
   };
   bool append() const override { return append_; }
+  const std::string* staticValue() const override {
+    return static_value_.has_value() ? &static_value_.value() : nullptr;
+  }
+  bool connectionScoped() const override { return connection_scoped_; }
 
 private:
   const std::vector<HeaderFormatterPtr> formatters_;
   const bool append_;
+  // Set if all the formatters are static.
+  absl::optional<std::string> static_value_;
+  // Set if all the formatters are static or connection scoped, and some are not static.
+  bool connection_scoped_{};
 };
 
 } // namespace Router
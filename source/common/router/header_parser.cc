@@ -1,5 +1,7 @@
 #include "source/common/router/header_parser.h"
 
+#include <array>
+#include <atomic>
 #include <cctype>
 #include <memory>
 #include <string>
@@ -32,6 +34,20 @@ enum class ParserState {
 
 std::string unescape(absl::string_view sv) { return absl::StrReplaceAll(sv, {{"%%", "%"}}); }
 
+// The value of a connection scoped header formatted for a downstream connection.
+struct ConnectionValue {
+  uint64_t id_{};
+  uint64_t connection_id_{};
+  std::string value_;
+};
+
+// The values of the connection scoped headers of all the parsers most recently formatted by a
+// thread are kept in a direct mapped cache indexed by their ids. Connection ids are never reused,
+// so the values of closed connections are only ever replaced.
+constexpr size_t ConnectionValueCacheSize = 256;
+
+std::atomic<uint64_t> next_connection_value_id{1};
+
 // Implements a state machine to parse custom headers. Each character of the custom header format
 // is either literal text (with % escaped as %%) or part of a %VAR% or %VAR(["args"])% expression.
 // The statement machine does minimal validation of the arguments (if any) and does not know the
@@ -222,6 +238,32 @@ HeaderFormatterPtr parseInternal(const envoy::config::core::v3::HeaderValue& hea
 
 } // namespace
 
+HeaderParser::HeadersToAddEntry::HeadersToAddEntry(HeaderFormatterPtr&& formatter,
+                                                   const std::string& original_value)
+    : formatter_(std::move(formatter)), original_value_(original_value),
+      connection_value_id_(formatter_->connectionScoped() ? next_connection_value_id++ : 0) {}
+
+const std::string& HeaderParser::formatValue(const HeadersToAddEntry& entry,
+                                             const StreamInfo::StreamInfo& stream_info,
+                                             std::string& buffer) {
+  const absl::optional<uint64_t> connection_id =
+      entry.connection_value_id_ != 0 ? stream_info.downstreamAddressProvider().connectionID()
+                                      : absl::nullopt;
+  if (!connection_id.has_value()) {
+    buffer = entry.formatter_->format(stream_info);
+    return buffer;
+  }
+
+  static thread_local std::array<ConnectionValue, ConnectionValueCacheSize> cache;
+  ConnectionValue& cached = cache[entry.connection_value_id_ % ConnectionValueCacheSize];
+  if (cached.id_ != entry.connection_value_id_ || cached.connection_id_ != connection_id.value()) {
+    cached.value_ = entry.formatter_->format(stream_info);
+    cached.id_ = entry.connection_value_id_;
+    cached.connection_id_ = connection_id.value();
+  }
+  return cached.value_;
+}
+
 HeaderParserPtr HeaderParser::configure(
     const Protobuf::RepeatedPtrField<envoy::config::core::v3::HeaderValueOption>& headers_to_add) {
   HeaderParserPtr header_parser(new HeaderParser());
@@ -230,8 +272,9 @@ HeaderParserPtr HeaderParser::configure(
     const bool append = PROTOBUF_GET_WRAPPED_OR_DEFAULT(header_value_option, append, true);
     HeaderFormatterPtr header_formatter = parseInternal(header_value_option.header(), append);
     header_parser->headers_to_add_.emplace_back(
-        Http::LowerCaseString(header_value_option.header().key()),
-        HeadersToAddEntry{std::move(header_formatter), header_value_option.header().value()});
+        std::piecewise_construct,
+        std::forward_as_tuple(header_value_option.header().key()),
+        std::forward_as_tuple(std::move(header_formatter), header_value_option.header().value()));
   }
 
   return header_parser;
@@ -245,8 +288,8 @@ HeaderParserPtr HeaderParser::configure(
   for (const auto& header_value : headers_to_add) {
     HeaderFormatterPtr header_formatter = parseInternal(header_value, append);
     header_parser->headers_to_add_.emplace_back(
-        Http::LowerCaseString(header_value.key()),
-        HeadersToAddEntry{std::move(header_formatter), header_value.value()});
+        std::piecewise_construct, std::forward_as_tuple(header_value.key()),
+        std::forward_as_tuple(std::move(header_formatter), header_value.value()));
   }
 
   return header_parser;
@@ -284,8 +327,24 @@ void HeaderParser::evaluateHeaders(Http::HeaderMap& headers,
   }
 
   for (const auto& [key, entry] : headers_to_add_) {
-    const std::string value =
-        stream_info != nullptr ? entry.formatter_->format(*stream_info) : entry.original_value_;
+    // Values which are the same for every stream are added by reference to the parser's copy, as
+    // the keys are, so that codecs which can send referenced headers without copying them do so.
+    const std::string* static_value =
+        stream_info != nullptr ? entry.formatter_->staticValue() : &entry.original_value_;
+    if (static_value != nullptr) {
+      if (!static_value->empty()) {
+        if (entry.formatter_->append()) {
+          headers.addReference(key, *static_value);
+        } else {
+          headers.setReference(key, *static_value);
+        }
+      }
+      continue;
+    }
+
+    // Values which only depend on the downstream connection are formatted once per connection.
+    std::string buffer;
+    const std::string& value = formatValue(entry, *stream_info, buffer);
     if (!value.empty()) {
       if (entry.formatter_->append()) {
         headers.addReferenceKey(key, value);
@@ -302,7 +361,8 @@ Http::HeaderTransforms HeaderParser::getHeaderTransforms(const StreamInfo::Strea
 
   for (const auto& [key, entry] : headers_to_add_) {
     if (do_formatting) {
-      const std::string value = entry.formatter_->format(stream_info);
+      std::string buffer;
+      const std::string& value = formatValue(entry, stream_info, buffer);
       if (!value.empty()) {
         if (entry.formatter_->append()) {
           transforms.headers_to_append.push_back({key, value});
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -66,10 +67,19 @@ protected:
 
 private:
   struct HeadersToAddEntry {
+    HeadersToAddEntry(HeaderFormatterPtr&& formatter, const std::string& original_value);
+
     HeaderFormatterPtr formatter_;
     const std::string original_value_;
+    // Keys the values of a connection scoped formatter cached per connection, 0 otherwise.
+    const uint64_t connection_value_id_;
   };
 
+  // @return the formatted value of the header, which lives until the next call on the thread.
+  static const std::string& formatValue(const HeadersToAddEntry& entry,
+                                        const StreamInfo::StreamInfo& stream_info,
+                                        std::string& buffer);
+
   std::vector<std::pair<Http::LowerCaseString, HeadersToAddEntry>> headers_to_add_;
   std::vector<Http::LowerCaseString> headers_to_remove_;
 };
@@ -99,7 +99,8 @@ RdsRouteConfigSubscription::RdsRouteConfigSubscription(
           resource_decoder_, {});
   local_init_manager_.add(local_init_target_);
   config_update_info_ =
-      std::make_unique<RouteConfigUpdateReceiverImpl>(factory_context, optional_http_filters_);
+      std::make_unique<RouteConfigUpdateReceiverImpl>(factory_context, optional_http_filters_,
+                                                      *scope_);
 }
 
 RdsRouteConfigSubscription::~RdsRouteConfigSubscription() {
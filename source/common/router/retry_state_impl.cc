@@ -8,14 +8,28 @@
 #include "envoy/config/route/v3/route_components.pb.h"
 
 #include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
 #include "source/common/common/utility.h"
 #include "source/common/grpc/common.h"
 #include "source/common/http/codes.h"
 #include "source/common/http/headers.h"
 #include "source/common/http/utility.h"
+#include "source/common/runtime/runtime_key_registry.h"
 
 namespace Envoy {
 namespace Router {
+namespace {
+
+// The runtime keys of the retry decisions, looked up on every request.
+struct RetryRuntimeKeys {
+  const Runtime::KeyHandle base_retry_backoff_ms_{
+      Runtime::KeyRegistry::registerKey("upstream.base_retry_backoff_ms")};
+  const Runtime::KeyHandle use_retry_{Runtime::KeyRegistry::registerKey("upstream.use_retry")};
+};
+
+const RetryRuntimeKeys& retryRuntimeKeys() { CONSTRUCT_ON_FIRST_USE(RetryRuntimeKeys); }
+
+} // namespace
 
 RetryStatePtr RetryStateImpl::create(const RetryPolicy& route_policy,
                                      Http::RequestHeaderMap& request_headers,
@@ -61,7 +75,7 @@ RetryStateImpl::RetryStateImpl(const RetryPolicy& route_policy,
       reset_max_interval_(route_policy.resetMaxInterval()) {
 
   std::chrono::milliseconds base_interval(
-      runtime_.snapshot().getInteger("upstream.base_retry_backoff_ms", 25));
+      runtime_.snapshot().getInteger(retryRuntimeKeys().base_retry_backoff_ms_, 25));
   if (route_policy.baseInterval()) {
     base_interval = *route_policy.baseInterval();
   }
@@ -132,6 +146,15 @@ RetryStateImpl::RetryStateImpl(const RetryPolicy& route_policy,
           std::make_shared<Http::HeaderUtility::HeaderData>(header_matcher));
     }
   }
+
+  const Upstream::WorkerRetryBudgetSettings* worker_retry_budget =
+      cluster_.resourceManager(priority_).workerRetryBudget();
+  if (retry_on_ != 0 && worker_retry_budget != nullptr) {
+    const MonotonicTime now = time_source_.monotonicTime();
+    worker_retry_budget_ =
+        WorkerRetryBudget::forCluster(cluster_.name(), priority_, *worker_retry_budget, now);
+    worker_retry_budget_->onRequest(now);
+  }
 }
 
 RetryStateImpl::~RetryStateImpl() { resetRetry(); }
@@ -226,7 +249,10 @@ RetryStateImpl::parseResetInterval(const Http::ResponseHeaderMap& response_heade
 
 void RetryStateImpl::resetRetry() {
   if (callback_) {
-    cluster_.resourceManager(priority_).retries().dec();
+    // The tokens of the worker retry budget are not given back.
+    if (worker_retry_budget_ == nullptr) {
+      cluster_.resourceManager(priority_).retries().dec();
+    }
     callback_ = nullptr;
   }
 }
@@ -260,7 +286,16 @@ RetryStatus RetryStateImpl::shouldRetry(bool would_retry, DoRetryCallback callba
 
   retries_remaining_--;
 
-  if (!cluster_.resourceManager(priority_).retries().canCreate()) {
+  if (worker_retry_budget_ != nullptr && !worker_retry_budget_->canRetry()) {
+    cluster_.stats().upstream_rq_retry_budget_exhausted_.inc();
+    cluster_.stats().upstream_rq_retry_overflow_.inc();
+    if (vcluster_) {
+      vcluster_->stats().upstream_rq_retry_overflow_.inc();
+    }
+    return RetryStatus::NoOverflow;
+  }
+  if (worker_retry_budget_ == nullptr &&
+      !cluster_.resourceManager(priority_).retries().canCreate()) {
     cluster_.stats().upstream_rq_retry_overflow_.inc();
     if (vcluster_) {
       vcluster_->stats().upstream_rq_retry_overflow_.inc();
@@ -268,13 +303,17 @@ RetryStatus RetryStateImpl::shouldRetry(bool would_retry, DoRetryCallback callba
     return RetryStatus::NoOverflow;
   }
 
-  if (!runtime_.snapshot().featureEnabled("upstream.use_retry", 100)) {
+  if (!runtime_.snapshot().featureEnabled(retryRuntimeKeys().use_retry_, 100)) {
     return RetryStatus::No;
   }
 
   ASSERT(!callback_);
   callback_ = callback;
-  cluster_.resourceManager(priority_).retries().inc();
+  if (worker_retry_budget_ != nullptr) {
+    worker_retry_budget_->onRetry();
+  } else {
+    cluster_.resourceManager(priority_).retries().inc();
+  }
   cluster_.stats().upstream_rq_retry_.inc();
   if (vcluster_) {
     vcluster_->stats().upstream_rq_retry_.inc();
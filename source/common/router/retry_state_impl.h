@@ -13,6 +13,7 @@
 
 #include "source/common/common/backoff_strategy.h"
 #include "source/common/http/header_utility.h"
+#include "source/common/router/worker_retry_budget.h"
 
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
@@ -123,6 +124,8 @@ private:
   std::vector<Http::HeaderMatcherSharedPtr> retriable_headers_;
   std::vector<ResetHeaderParserSharedPtr> reset_headers_{};
   std::chrono::milliseconds reset_max_interval_{};
+  // Set if the retries of the cluster are limited by a budget on each worker.
+  WorkerRetryBudgetSharedPtr worker_retry_budget_;
 };
 
 } // namespace Router
@@ -0,0 +1,102 @@
+#include "source/common/router/route_cache_impl.h"
+
+#include <atomic>
+
+#include "source/common/common/assert.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Router {
+
+bool RouteCache::find(const Http::RequestHeaderMap& headers, RouteConstSharedPtr& route) {
+  // The header values cannot contain NUL characters, so the key is unambiguous.
+  const Http::HeaderEntry* forwarded_proto = headers.ForwardedProto();
+  key_.clear();
+  absl::StrAppend(&key_, headers.getHostValue(), absl::string_view("\0", 1),
+                  headers.getPathValue(), absl::string_view("\0", 1), headers.getMethodValue(),
+                  absl::string_view("\0", 1),
+                  forwarded_proto == nullptr ? absl::string_view("\0", 1)
+                                             : forwarded_proto->value().getStringView());
+
+  auto it = index_.find(key_);
+  if (it == index_.end()) {
+    return false;
+  }
+  const Entry& entry = *it->second;
+  if (entry.has_route_) {
+    route = entry.route_.lock();
+    if (route == nullptr) {
+      return false;
+    }
+  } else {
+    route = nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return true;
+}
+
+bool RouteCache::insert(const RouteConstSharedPtr& route) {
+  auto it = index_.find(key_);
+  if (it != index_.end()) {
+    // The entry of an expired route.
+    const auto expired = it->second;
+    index_.erase(it);
+    entries_.erase(expired);
+  }
+
+  bool evicted = false;
+  if (entries_.size() >= capacity_) {
+    ASSERT(!entries_.empty());
+    index_.erase(entries_.back().key_);
+    entries_.pop_back();
+    evicted = true;
+  }
+  entries_.push_front(Entry{key_, route, route != nullptr});
+  index_.emplace(entries_.front().key_, entries_.begin());
+  return evicted;
+}
+
+namespace {
+
+std::atomic<uint64_t> next_route_cache_id{0};
+
+// The route caches of a thread, by the id of their route table.
+struct ThreadRouteCaches {
+  struct Caches {
+    std::weak_ptr<const bool> alive_;
+    std::unique_ptr<RouteCache> cache_;
+  };
+
+  absl::flat_hash_map<uint64_t, Caches> caches_;
+};
+
+} // namespace
+
+WorkerRouteCaches::WorkerRouteCaches(uint32_t capacity, Stats::Scope& scope,
+                                     const std::string& stat_prefix)
+    : id_(next_route_cache_id++), capacity_(capacity), alive_(std::make_shared<const bool>(true)),
+      stats_({ALL_ROUTE_CACHE_STATS(POOL_COUNTER_PREFIX(scope, stat_prefix))}) {
+  ASSERT(capacity_ > 0);
+}
+
+RouteCache& WorkerRouteCaches::local() const {
+  static thread_local ThreadRouteCaches thread_caches;
+  auto it = thread_caches.caches_.find(id_);
+  if (it == thread_caches.caches_.end()) {
+    // Drop the caches of the destroyed route tables, which are replaced by the new ones on updates.
+    for (auto expired = thread_caches.caches_.begin(); expired != thread_caches.caches_.end();) {
+      if (expired->second.alive_.expired()) {
+        thread_caches.caches_.erase(expired++);
+      } else {
+        ++expired;
+      }
+    }
+    ThreadRouteCaches::Caches caches{alive_, std::make_unique<RouteCache>(capacity_)};
+    it = thread_caches.caches_.emplace(id_, std::move(caches)).first;
+  }
+  return *it->second.cache_;
+}
+
+} // namespace Router
+} // namespace Envoy
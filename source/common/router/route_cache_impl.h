@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/http/header_map.h"
+#include "envoy/router/router.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * All route cache stats. @see stats_macros.h
+ */
+#define ALL_ROUTE_CACHE_STATS(COUNTER)                                                             \
+  COUNTER(eviction)                                                                                \
+  COUNTER(hit)                                                                                     \
+  COUNTER(miss)                                                                                    \
+  COUNTER(uncacheable)
+
+/**
+ * Struct definition for all route cache stats. @see stats_macros.h
+ */
+struct RouteCacheStats {
+  ALL_ROUTE_CACHE_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * A least recently used cache of the routes selected for requests, keyed by the authority, path,
+ * method and x-forwarded-proto header of the requests. The routes are held weakly, so the cache
+ * never extends the lifetime of a route table. It is not thread safe, each worker has its own.
+ */
+class RouteCache {
+public:
+  explicit RouteCache(uint32_t capacity) : capacity_(capacity) {}
+
+  /**
+   * Looks up the route of a request.
+   * @param headers supplies the request headers.
+   * @param route receives the cached route on a hit, which may be nullptr for requests without a
+   *        route.
+   * @return whether the request has a cached route. On a miss, the key of the request is kept for
+   *         the next insert().
+   */
+  bool find(const Http::RequestHeaderMap& headers, RouteConstSharedPtr& route);
+
+  /**
+   * Caches the route of the request of the last missed find().
+   * @return whether the least recently used route was evicted to make room for it.
+   */
+  bool insert(const RouteConstSharedPtr& route);
+
+  uint64_t size() const { return entries_.size(); }
+
+private:
+  struct Entry {
+    std::string key_;
+    std::weak_ptr<const Route> route_;
+    bool has_route_;
+  };
+
+  const uint32_t capacity_;
+  // The most recently used entries first.
+  std::list<Entry> entries_;
+  // Keyed by views of the keys held by the list entries, which do not move.
+  absl::flat_hash_map<absl::string_view, std::list<Entry>::iterator> index_;
+  // Reused for the key of each lookup, so that hits do not allocate.
+  std::string key_;
+};
+
+/**
+ * The route caches of the workers for a route table. Each route table has its own caches, which
+ * start empty, so they are invalidated on each update of the route table.
+ */
+class WorkerRouteCaches {
+public:
+  /**
+   * @param capacity supplies the number of routes each worker keeps.
+   * @param scope supplies the scope of the stats.
+   * @param stat_prefix supplies the prefix of the stats.
+   */
+  WorkerRouteCaches(uint32_t capacity, Stats::Scope& scope, const std::string& stat_prefix);
+
+  /**
+   * @return the route cache of the calling thread for the route table.
+   */
+  RouteCache& local() const;
+
+  RouteCacheStats& stats() const { return stats_; }
+
+private:
+  const uint64_t id_;
+  const uint32_t capacity_;
+  // Expires when the route table is destroyed, so that the threads can drop its caches.
+  const std::shared_ptr<const bool> alive_;
+  mutable RouteCacheStats stats_;
+};
+
+using WorkerRouteCachesPtr = std::unique_ptr<WorkerRouteCaches>;
+
+} // namespace Router
+} // namespace Envoy
@@ -1,5 +1,6 @@
 #include "source/common/router/route_config_update_receiver_impl.h"
 
+#include <chrono>
 #include <string>
 
 #include "envoy/config/route/v3/route.pb.h"
@@ -28,9 +29,7 @@ bool RouteConfigUpdateReceiverImpl::onRdsUpdate(
   initializeRdsVhosts(*route_config_proto_);
 
   rebuildRouteConfig(rds_virtual_hosts_, *vhds_virtual_hosts_, *route_config_proto_);
-  config_ = std::make_shared<ConfigImpl>(
-      *route_config_proto_, optional_http_filters_, factory_context_,
-      factory_context_.messageValidationContext().dynamicValidationVisitor(), false);
+  config_ = buildConfig(*route_config_proto_);
 
   onUpdateCommon(version_info);
   return true;
@@ -53,9 +52,7 @@ bool RouteConfigUpdateReceiverImpl::onVhdsUpdate(
   rebuildRouteConfig(rds_virtual_hosts_, *vhosts_after_this_update,
                      *route_config_after_this_update);
 
-  auto new_config = std::make_shared<ConfigImpl>(
-      *route_config_after_this_update, optional_http_filters_, factory_context_,
-      factory_context_.messageValidationContext().dynamicValidationVisitor(), false);
+  auto new_config = buildConfig(*route_config_after_this_update);
 
   // No exception, route_config_after_this_update is valid, can update the state.
   vhds_virtual_hosts_ = std::move(vhosts_after_this_update);
@@ -67,6 +64,20 @@ bool RouteConfigUpdateReceiverImpl::onVhdsUpdate(
   return removed || updated || !resource_ids_in_last_update_.empty();
 }
 
+std::shared_ptr<const ConfigImpl> RouteConfigUpdateReceiverImpl::buildConfig(
+    const envoy::config::route::v3::RouteConfiguration& route_config) {
+  const MonotonicTime start = time_source_.monotonicTime();
+  auto config = std::make_shared<ConfigImpl>(
+      route_config, optional_http_filters_, factory_context_,
+      factory_context_.messageValidationContext().dynamicValidationVisitor(), false, config_.get());
+  stats_.config_build_time_.recordValue(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                            time_source_.monotonicTime() - start)
+                                            .count());
+  stats_.virtual_hosts_built_.add(config->virtualHostsBuilt());
+  stats_.virtual_hosts_reused_.add(config->virtualHostsReused());
+  return config;
+}
+
 void RouteConfigUpdateReceiverImpl::onUpdateCommon(const std::string& version_info) {
   last_config_version_ = version_info;
   last_updated_ = time_source_.systemTime();
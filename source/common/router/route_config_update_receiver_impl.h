@@ -8,6 +8,8 @@
 #include "envoy/router/route_config_update_receiver.h"
 #include "envoy/server/factory_context.h"
 #include "envoy/service/discovery/v3/discovery.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 
 #include "source/common/common/logger.h"
 #include "source/common/protobuf/utility.h"
@@ -16,11 +18,28 @@
 namespace Envoy {
 namespace Router {
 
+/**
+ * All stats of the builds of the route configurations received. @see stats_macros.h
+ */
+#define ALL_ROUTE_CONFIG_BUILD_STATS(COUNTER, HISTOGRAM)                                           \
+  COUNTER(virtual_hosts_built)                                                                     \
+  COUNTER(virtual_hosts_reused)                                                                    \
+  HISTOGRAM(config_build_time, Milliseconds)
+
+/**
+ * Struct definition for all route configuration build stats. @see stats_macros.h
+ */
+struct RouteConfigBuildStats {
+  ALL_ROUTE_CONFIG_BUILD_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
 class RouteConfigUpdateReceiverImpl : public RouteConfigUpdateReceiver {
 public:
   RouteConfigUpdateReceiverImpl(Server::Configuration::ServerFactoryContext& factory_context,
-                                const OptionalHttpFilters& optional_http_filters)
+                                const OptionalHttpFilters& optional_http_filters,
+                                Stats::Scope& scope)
       : factory_context_(factory_context), time_source_(factory_context.timeSource()),
+        stats_({ALL_ROUTE_CONFIG_BUILD_STATS(POOL_COUNTER(scope), POOL_HISTOGRAM(scope))}),
         route_config_proto_(std::make_unique<envoy::config::route::v3::RouteConfiguration>()),
         last_config_hash_(0ull), last_vhds_config_hash_(0ul),
         vhds_virtual_hosts_(
@@ -36,6 +55,9 @@ public:
       const std::map<std::string, envoy::config::route::v3::VirtualHost>& rds_vhosts,
       const std::map<std::string, envoy::config::route::v3::VirtualHost>& vhds_vhosts,
       envoy::config::route::v3::RouteConfiguration& route_config);
+  // Builds the route configuration, reusing the unchanged virtual hosts of the current one.
+  std::shared_ptr<const ConfigImpl>
+  buildConfig(const envoy::config::route::v3::RouteConfiguration& route_config);
   bool onDemandFetchFailed(const envoy::service::discovery::v3::Resource& resource) const;
   void onUpdateCommon(const std::string& version_info);
 
@@ -65,6 +87,7 @@ public:
 private:
   Server::Configuration::ServerFactoryContext& factory_context_;
   TimeSource& time_source_;
+  RouteConfigBuildStats stats_;
   std::unique_ptr<envoy::config::route::v3::RouteConfiguration> route_config_proto_;
   uint64_t last_config_hash_;
   uint64_t last_vhds_config_hash_;
@@ -75,7 +98,7 @@ private:
   absl::optional<RouteConfigProvider::ConfigInfo> config_info_;
   std::set<std::string> resource_ids_in_last_update_;
   bool vhds_configuration_changed_;
-  ConfigConstSharedPtr config_;
+  std::shared_ptr<const ConfigImpl> config_;
   const OptionalHttpFilters& optional_http_filters_;
 };
 
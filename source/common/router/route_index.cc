@@ -0,0 +1,158 @@
+#include "source/common/router/route_index.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/regex.h"
+#include "source/common/http/path_utility.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+
+namespace Envoy {
+namespace Router {
+
+void RouteIndex::addRoute(const envoy::config::route::v3::RouteMatch& match) {
+  const uint32_t route = size_++;
+  const bool case_sensitive = PROTOBUF_GET_WRAPPED_OR_DEFAULT(match, case_sensitive, true);
+  switch (match.path_specifier_case()) {
+  case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPrefix:
+    if (case_sensitive) {
+      prefixes_.insert(match.prefix(), route);
+    } else {
+      lowercase_prefixes_.insert(absl::AsciiStrToLower(match.prefix()), route);
+    }
+    break;
+  case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPath:
+    if (case_sensitive) {
+      exact_paths_[match.path()].push_back(route);
+    } else {
+      lowercase_exact_paths_[absl::AsciiStrToLower(match.path())].push_back(route);
+    }
+    break;
+  case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kSafeRegex:
+    regexes_.emplace_back(match.safe_regex().regex(), route);
+    break;
+  default:
+    unindexed_routes_.push_back(route);
+    break;
+  }
+}
+
+void RouteIndex::finalize() {
+  if (regexes_.empty()) {
+    return;
+  }
+
+  std::vector<std::string> regexes;
+  for (const auto& [regex, route] : regexes_) {
+    regexes.push_back(regex);
+    regex_routes_.push_back(route);
+  }
+  regex_set_ = Regex::Utility::parseRegexSet(regexes);
+  if (regex_set_ == nullptr) {
+    // Evaluate the regex routes one by one, as without the index.
+    regex_routes_.clear();
+    for (const auto& regex : regexes_) {
+      unindexed_routes_.push_back(regex.second);
+    }
+    std::sort(unindexed_routes_.begin(), unindexed_routes_.end());
+  }
+  regexes_.clear();
+  regexes_.shrink_to_fit();
+}
+
+void RouteIndex::candidates(absl::string_view path, Candidates& candidates) const {
+  path = Http::PathUtil::removeQueryAndFragment(path);
+  candidates.assign(unindexed_routes_.begin(), unindexed_routes_.end());
+
+  prefixes_.prefixesOf(path, candidates);
+  auto exact = exact_paths_.find(path);
+  if (exact != exact_paths_.end()) {
+    candidates.insert(candidates.end(), exact->second.begin(), exact->second.end());
+  }
+
+  if (!lowercase_prefixes_.empty() || !lowercase_exact_paths_.empty()) {
+    const std::string lowercase_path = absl::AsciiStrToLower(path);
+    lowercase_prefixes_.prefixesOf(lowercase_path, candidates);
+    auto lowercase_exact = lowercase_exact_paths_.find(lowercase_path);
+    if (lowercase_exact != lowercase_exact_paths_.end()) {
+      candidates.insert(candidates.end(), lowercase_exact->second.begin(),
+                        lowercase_exact->second.end());
+    }
+  }
+
+  if (regex_set_ != nullptr) {
+    std::vector<uint32_t> matches;
+    if (regex_set_->match(path, matches)) {
+      for (const uint32_t match : matches) {
+        candidates.push_back(regex_routes_[match]);
+      }
+    } else {
+      // The DFA ran out of memory, so every regex route has to be evaluated.
+      candidates.insert(candidates.end(), regex_routes_.begin(), regex_routes_.end());
+    }
+  }
+
+  // Each route is yielded by a single index, so sorting restores the configuration order.
+  std::sort(candidates.begin(), candidates.end());
+}
+
+size_t RouteIndex::RadixTree::findChild(const Node& node, char first) {
+  size_t child = 0;
+  while (child < node.children_.size() && node.children_[child]->label_[0] != first) {
+    ++child;
+  }
+  return child;
+}
+
+void RouteIndex::RadixTree::insert(absl::string_view prefix, uint32_t route) {
+  Node* node = &root_;
+  while (!prefix.empty()) {
+    const size_t child_index = findChild(*node, prefix[0]);
+    if (child_index == node->children_.size()) {
+      node->children_.push_back(std::make_unique<Node>());
+      node = node->children_.back().get();
+      node->label_ = std::string(prefix);
+      break;
+    }
+
+    std::unique_ptr<Node>& child = node->children_[child_index];
+    const std::string& label = child->label_;
+    const auto mismatch = std::mismatch(label.begin(), label.end(), prefix.begin(), prefix.end());
+    const size_t common = mismatch.first - label.begin();
+    ASSERT(common > 0);
+    if (common < label.size()) {
+      // The prefix diverges from the edge, so the edge is split at the divergence.
+      auto split = std::make_unique<Node>();
+      split->label_ = label.substr(0, common);
+      child->label_ = label.substr(common);
+      split->children_.push_back(std::move(child));
+      child = std::move(split);
+    }
+    node = child.get();
+    prefix.remove_prefix(common);
+  }
+  node->routes_.push_back(route);
+}
+
+void RouteIndex::RadixTree::prefixesOf(absl::string_view path, Candidates& candidates) const {
+  const Node* node = &root_;
+  while (true) {
+    candidates.insert(candidates.end(), node->routes_.begin(), node->routes_.end());
+    if (path.empty()) {
+      return;
+    }
+    const size_t child = findChild(*node, path[0]);
+    if (child == node->children_.size() ||
+        !absl::StartsWith(path, node->children_[child]->label_)) {
+      return;
+    }
+    node = node->children_[child].get();
+    path.remove_prefix(node->label_.size());
+  }
+}
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/regex.h"
+#include "envoy/config/route/v3/route_components.pb.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Index of the path specifiers of the routes of a virtual host. For a request path, it yields the
+ * positions of the routes whose path specifier may match the path, in configuration order, so that
+ * only those routes have to be evaluated to find the first match. Prefix routes are kept in radix
+ * trees, exact path routes in hash maps and safe regex routes in a regex matcher set. Routes that
+ * are not indexed, such as CONNECT routes, are always yielded.
+ */
+class RouteIndex {
+public:
+  using Candidates = absl::InlinedVector<uint32_t, 8>;
+
+  /**
+   * Adds the route at the next position.
+   * @param match supplies the match of the route.
+   */
+  void addRoute(const envoy::config::route::v3::RouteMatch& match);
+
+  /**
+   * Compiles the regex set. Called once all routes have been added.
+   */
+  void finalize();
+
+  /**
+   * @param path supplies the :path header value of the request.
+   * @param candidates receives the positions of the routes whose path specifier may match the
+   *        path, in ascending order.
+   */
+  void candidates(absl::string_view path, Candidates& candidates) const;
+
+private:
+  /**
+   * A radix tree of prefixes, whose nodes hold the positions of the routes of the prefix ending at
+   * them.
+   */
+  class RadixTree {
+  public:
+    void insert(absl::string_view prefix, uint32_t route);
+    void prefixesOf(absl::string_view path, Candidates& candidates) const;
+    bool empty() const { return root_.routes_.empty() && root_.children_.empty(); }
+
+  private:
+    struct Node {
+      // The characters of the edge leading to the node.
+      std::string label_;
+      std::vector<uint32_t> routes_;
+      std::vector<std::unique_ptr<Node>> children_;
+    };
+
+    // @return the index of the child of the node whose label starts with first, or the number of
+    //         children if there is none.
+    static size_t findChild(const Node& node, char first);
+
+    Node root_;
+  };
+
+  using ExactPaths = absl::flat_hash_map<std::string, std::vector<uint32_t>>;
+
+  uint32_t size_{};
+  RadixTree prefixes_;
+  RadixTree lowercase_prefixes_;
+  ExactPaths exact_paths_;
+  ExactPaths lowercase_exact_paths_;
+  // The regexes are compiled into regex_set_ on finalize(), and regex_routes_ maps the index of
+  // each regex in the set to its route.
+  std::vector<std::pair<std::string, uint32_t>> regexes_;
+  Regex::CompiledMatcherSetPtr regex_set_;
+  std::vector<uint32_t> regex_routes_;
+  std::vector<uint32_t> unindexed_routes_;
+};
+
+} // namespace Router
+} // namespace Envoy
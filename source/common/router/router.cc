@@ -332,7 +332,7 @@ void Filter::chargeUpstreamCode(uint64_t response_status_code,
       cluster_->loadReportStats().upstream_rq_dropped_.inc();
     }
     if (upstream_host && Http::CodeUtility::is5xx(response_status_code)) {
-      upstream_host->stats().rq_error_.inc();
+      upstream_host->stats().incRqError();
     }
   }
 }
@@ -570,6 +570,11 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::RequestHeaderMap& headers,
   }
 
   hedging_params_ = FilterUtility::finalHedgingParams(*route_entry_, headers);
+  latency_hedge_ = route_entry_->hedgePolicy().latencyHedge();
+  if (latency_hedge_ != nullptr) {
+    latency_sketch_ = UpstreamLatencySketch::forCluster(cluster_);
+    latency_sketch_->recordRequest();
+  }
 
   timeout_ = FilterUtility::finalTimeout(*route_entry_, headers, !config_.suppress_envoy_headers_,
                                          grpc_request_, hedging_params_.hedge_on_per_try_timeout_,
@@ -616,10 +621,28 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::RequestHeaderMap& headers,
       config_.random_, callbacks_->dispatcher(), config_.timeSource(), route_entry_->priority());
 
   // Determine which shadow policies to use. It's possible that we don't do any shadowing due to
-  // runtime keys.
+  // runtime keys, or to it being shed under overload. Streamed shadows are started right away and
+  // never need the request buffered.
+  const bool shed_shadowing =
+      !route_entry_->shadowPolicies().empty() && config_.overload_manager_ != nullptr &&
+      config_.random_.bernoulli(config_.overload_manager_->getThreadLocalOverloadState()
+                                    .getState(Server::LoadShedPointNames::get().RouterShadowing)
+                                    .value());
   for (const auto& shadow_policy : route_entry_->shadowPolicies()) {
     const auto& policy_ref = *shadow_policy;
-    if (FilterUtility::shouldShadow(policy_ref, config_.runtime_, callbacks_->streamId())) {
+    if (shed_shadowing ||
+        !FilterUtility::shouldShadow(policy_ref, config_.runtime_, callbacks_->streamId())) {
+      continue;
+    }
+    if (policy_ref.streamBody()) {
+      ASSERT(!policy_ref.cluster().empty());
+      ShadowStreamPtr shadow_stream = config_.shadowWriter().streamingShadow(
+          policy_ref.cluster(), Http::createHeaderMap<Http::RequestHeaderMapImpl>(headers),
+          end_stream, Http::AsyncClient::StreamOptions().setTimeout(timeout_.global_timeout_));
+      if (shadow_stream != nullptr) {
+        shadow_streams_.push_back(std::move(shadow_stream));
+      }
+    } else {
       active_shadow_policies_.push_back(std::cref(policy_ref));
     }
   }
@@ -689,6 +712,11 @@ Http::FilterDataStatus Filter::decodeData(Buffer::Instance& data, bool end_strea
   // a backoff timer.
   ASSERT(upstream_requests_.size() <= 1);
 
+  // Streamed shadows get their copy before the data is moved upstream.
+  for (auto& shadow_stream : shadow_streams_) {
+    shadow_stream->sendData(data, end_stream);
+  }
+
   bool buffering = (retry_state_ && retry_state_->enabled()) || !active_shadow_policies_.empty() ||
                    (internal_redirects_with_body_enabled_ && route_entry_ &&
                     route_entry_->internalRedirectPolicy().enabled());
@@ -731,6 +759,7 @@ Http::FilterDataStatus Filter::decodeData(Buffer::Instance& data, bool end_strea
     // buffer limit we give up on retries and buffering. We must buffer using addDecodedData()
     // so that all buffered data is available by the time we do request complete processing and
     // potentially shadow.
+    maybeSpillRequestBody(data);
     callbacks_->addDecodedData(data, true);
   } else {
     upstream_requests_.front()->encodeData(data, end_stream);
@@ -743,6 +772,19 @@ Http::FilterDataStatus Filter::decodeData(Buffer::Instance& data, bool end_strea
   return Http::FilterDataStatus::StopIterationNoBuffer;
 }
 
+void Filter::maybeSpillRequestBody(Buffer::Instance& data) {
+  const Buffer::DiskSpillSharedPtr& spill = config_.request_body_spill_;
+  if (spill == nullptr ||
+      getLength(callbacks_->decodingBuffer()) + data.length() <= spill->memoryThreshold()) {
+    return;
+  }
+  if (request_body_spiller_ == nullptr) {
+    request_body_spiller_ = std::make_unique<Buffer::DiskSpiller>(spill);
+  }
+  // The chunks which can't be spilled stay in memory, under the retry and shadow buffer limit.
+  request_body_spiller_->spill(data);
+}
+
 Http::FilterTrailersStatus Filter::decodeTrailers(Http::RequestTrailerMap& trailers) {
   ENVOY_STREAM_LOG(debug, "router decoding trailers:\n{}", *callbacks_, trailers);
 
@@ -753,6 +795,9 @@ Http::FilterTrailersStatus Filter::decodeTrailers(Http::RequestTrailerMap& trail
   // a backoff timer.
   ASSERT(upstream_requests_.size() <= 1);
   downstream_trailers_ = &trailers;
+  for (auto& shadow_stream : shadow_streams_) {
+    shadow_stream->sendTrailers(trailers);
+  }
   for (auto& upstream_request : upstream_requests_) {
     upstream_request->encodeTrailers(trailers);
   }
@@ -847,6 +892,8 @@ void Filter::onDestroy() {
   // Reset any in-flight upstream requests.
   resetAll();
   cleanup();
+  // Streamed shadows which were not sent the whole request are reset, the others go on.
+  shadow_streams_.clear();
 }
 
 void Filter::onResponseTimeout() {
@@ -955,6 +1002,35 @@ void Filter::onPerTryTimeout(UpstreamRequest& upstream_request) {
                          StreamInfo::ResponseCodeDetails::get().UpstreamPerTryTimeout);
 }
 
+absl::optional<std::chrono::milliseconds> Filter::latencyHedgeDelay() {
+  if (latency_sketch_ == nullptr) {
+    return absl::nullopt;
+  }
+  return latency_sketch_->percentile(latency_hedge_->percentile_, latency_hedge_->min_samples_);
+}
+
+void Filter::onLatencyHedgeTimeout(UpstreamRequest& upstream_request) {
+  if (downstream_response_started_ || !retry_state_ || upstream_request.retried()) {
+    return;
+  }
+  if (!latency_sketch_->hedgeAllowed(latency_hedge_->budget_percent_)) {
+    cluster_->stats().upstream_rq_latency_hedge_budget_exceeded_.inc();
+    return;
+  }
+
+  // A latency hedge uses the retries of the request, like a hedge on per try timeout, but the
+  // slow request is kept until one of them responds.
+  const RetryStatus retry_status =
+      retry_state_->shouldHedgeRetryPerTryTimeout([this]() -> void { doRetry(); });
+  if (retry_status == RetryStatus::Yes) {
+    pending_retries_++;
+    upstream_request.retried(true);
+    next_retry_is_latency_hedge_ = true;
+    latency_sketch_->recordHedge();
+    cluster_->stats().upstream_rq_latency_hedge_.inc();
+  }
+}
+
 void Filter::onStreamMaxDurationReached(UpstreamRequest& upstream_request) {
   upstream_request.resetStream();
 
@@ -984,7 +1060,7 @@ void Filter::updateOutlierDetection(Upstream::Outlier::Result result,
 void Filter::chargeUpstreamAbort(Http::Code code, bool dropped, UpstreamRequest& upstream_request) {
   if (downstream_response_started_) {
     if (upstream_request.grpcRqSuccessDeferred()) {
-      upstream_request.upstreamHost()->stats().rq_error_.inc();
+      upstream_request.upstreamHost()->stats().incRqError();
       config_.stats_.rq_reset_after_downstream_response_started_.inc();
     }
   } else {
@@ -996,7 +1072,7 @@ void Filter::chargeUpstreamAbort(Http::Code code, bool dropped, UpstreamRequest&
     // timeout_response_code_ is used for code above, where this member can
     // assume values such as 204 (NoContent).
     if (upstream_host != nullptr && !Http::CodeUtility::is5xx(enumToInt(code))) {
-      upstream_host->stats().rq_error_.inc();
+      upstream_host->stats().incRqError();
     }
   }
 }
@@ -1053,7 +1129,7 @@ bool Filter::maybeRetryReset(Http::StreamResetReason reset_reason,
     pending_retries_++;
 
     if (upstream_request.upstreamHost()) {
-      upstream_request.upstreamHost()->stats().rq_error_.inc();
+      upstream_request.upstreamHost()->stats().incRqError();
     }
 
     upstream_request.removeFromList(upstream_requests_);
@@ -1158,15 +1234,15 @@ void Filter::handleNon5xxResponseHeaders(absl::optional<Grpc::Status::GrpcStatus
   if (grpc_request_) {
     if (end_stream) {
       if (grpc_status && !Http::CodeUtility::is5xx(grpc_to_http_status)) {
-        upstream_request.upstreamHost()->stats().rq_success_.inc();
+        upstream_request.upstreamHost()->stats().incRqSuccess();
       } else {
-        upstream_request.upstreamHost()->stats().rq_error_.inc();
+        upstream_request.upstreamHost()->stats().incRqError();
       }
     } else {
       upstream_request.grpcRqSuccessDeferred(true);
     }
   } else {
-    upstream_request.upstreamHost()->stats().rq_success_.inc();
+    upstream_request.upstreamHost()->stats().incRqSuccess();
   }
 }
 
@@ -1208,11 +1284,13 @@ void Filter::resetOtherUpstreams(UpstreamRequest& upstream_request) {
   // Pop each upstream request on the list and reset it if it's not the one
   // provided. At the end we'll move it back into the list.
   UpstreamRequestPtr final_upstream_request;
+  bool reset_other_upstream = false;
   while (!upstream_requests_.empty()) {
     UpstreamRequestPtr upstream_request_tmp =
         upstream_requests_.back()->removeFromList(upstream_requests_);
     if (upstream_request_tmp.get() != &upstream_request) {
       upstream_request_tmp->resetStream();
+      reset_other_upstream = true;
       // TODO: per-host stat for hedge abandoned.
       // TODO: cluster stat for hedge abandoned.
     } else {
@@ -1221,6 +1299,10 @@ void Filter::resetOtherUpstreams(UpstreamRequest& upstream_request) {
   }
 
   ASSERT(final_upstream_request);
+  if (reset_other_upstream && final_upstream_request->latencyHedge()) {
+    // The hedge responded before the slow request it was started for.
+    cluster_->stats().upstream_rq_latency_hedge_won_.inc();
+  }
   // Now put the final request back on this list.
   LinkedList::moveIntoList(std::move(final_upstream_request), upstream_requests_);
 }
@@ -1229,6 +1311,12 @@ void Filter::onUpstreamHeaders(uint64_t response_code, Http::ResponseHeaderMapPt
                                UpstreamRequest& upstream_request, bool end_stream) {
   ENVOY_STREAM_LOG(debug, "upstream headers complete: end_stream={}", *callbacks_, end_stream);
 
+  if (latency_sketch_ != nullptr && upstream_request.perTryStartTime().has_value()) {
+    latency_sketch_->recordLatency(std::chrono::duration_cast<std::chrono::microseconds>(
+        callbacks_->dispatcher().timeSource().monotonicTime() -
+        upstream_request.perTryStartTime().value()));
+  }
+
   modify_headers_(*headers);
   // When grpc-status appears in response headers, convert grpc-status to HTTP status code
   // for outlier detection. This does not currently change any stats or logging and does not
@@ -1268,7 +1356,7 @@ void Filter::onUpstreamHeaders(uint64_t response_code, Http::ResponseHeaderMapPt
           retry_state_->shouldRetryHeaders(*headers, [this]() -> void { doRetry(); });
       if (retry_status == RetryStatus::Yes) {
         pending_retries_++;
-        upstream_request.upstreamHost()->stats().rq_error_.inc();
+        upstream_request.upstreamHost()->stats().incRqError();
         Http::CodeStats& code_stats = httpContext().codeStats();
         code_stats.chargeBasicResponseStat(
             cluster_->statsScope(), config_.stats_.stat_names_.retry_,
@@ -1304,7 +1392,7 @@ void Filter::onUpstreamHeaders(uint64_t response_code, Http::ResponseHeaderMapPt
   // flight awaiting headers or scheduled retries. If so, exit to give them a
   // chance to return before returning a response downstream.
   if (could_not_retry && (numRequestsAwaitingHeaders() > 0 || pending_retries_ > 0)) {
-    upstream_request.upstreamHost()->stats().rq_error_.inc();
+    upstream_request.upstreamHost()->stats().incRqError();
 
     // Reset the stream because there are other in-flight requests that we'll
     // wait around for and we're not interested in consuming any body/trailers.
@@ -1368,7 +1456,7 @@ void Filter::onUpstreamData(Buffer::Instance& data, UpstreamRequest& upstream_re
   if (end_stream) {
     // gRPC request termination without trailers is an error.
     if (upstream_request.grpcRqSuccessDeferred()) {
-      upstream_request.upstreamHost()->stats().rq_error_.inc();
+      upstream_request.upstreamHost()->stats().incRqError();
     }
     onUpstreamComplete(upstream_request);
   }
@@ -1387,9 +1475,9 @@ void Filter::onUpstreamTrailers(Http::ResponseTrailerMapPtr&& trailers,
     absl::optional<Grpc::Status::GrpcStatus> grpc_status = Grpc::Common::getGrpcStatus(*trailers);
     if (grpc_status &&
         !Http::CodeUtility::is5xx(Grpc::Utility::grpcToHttpStatus(grpc_status.value()))) {
-      upstream_request.upstreamHost()->stats().rq_success_.inc();
+      upstream_request.upstreamHost()->stats().incRqSuccess();
     } else {
-      upstream_request.upstreamHost()->stats().rq_error_.inc();
+      upstream_request.upstreamHost()->stats().incRqError();
     }
   }
 
@@ -1409,8 +1497,18 @@ void Filter::onUpstreamComplete(UpstreamRequest& upstream_request) {
   callbacks_->streamInfo().setUpstreamTiming(final_upstream_request_->upstreamTiming());
 
   Event::Dispatcher& dispatcher = callbacks_->dispatcher();
-  std::chrono::milliseconds response_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-      dispatcher.timeSource().monotonicTime() - downstream_request_complete_time_);
+  const MonotonicTime::duration elapsed =
+      dispatcher.timeSource().monotonicTime() - downstream_request_complete_time_;
+  std::chrono::milliseconds response_time =
+      std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+
+  Upstream::ResponseTimeTracker* response_time_tracker =
+      upstream_request.upstreamHost()->responseTimeTracker();
+  if (response_time_tracker != nullptr && !callbacks_->streamInfo().healthCheck() &&
+      DateUtil::timePointValid(downstream_request_complete_time_)) {
+    response_time_tracker->putResponseTime(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed));
+  }
 
   Upstream::ClusterTimeoutBudgetStatsOptRef tb_stats = cluster()->timeoutBudgetStats();
   if (tb_stats.has_value()) {
@@ -1619,6 +1717,8 @@ void Filter::doRetry() {
   }
   UpstreamRequestPtr upstream_request =
       std::make_unique<UpstreamRequest>(*this, std::move(generic_conn_pool));
+  upstream_request->latencyHedge(next_retry_is_latency_hedge_);
+  next_retry_is_latency_hedge_ = false;
 
   if (include_attempt_count_in_request_) {
     downstream_headers_->setEnvoyAttemptCount(attempt_count_);
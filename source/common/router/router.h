@@ -15,11 +15,13 @@
 #include "envoy/router/shadow_writer.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/server/filter_config.h"
+#include "envoy/server/overload/overload_manager.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "source/common/access_log/access_log_impl.h"
+#include "source/common/buffer/disk_spill_impl.h"
 #include "source/common/buffer/watermark_buffer.h"
 #include "source/common/common/cleanup.h"
 #include "source/common/common/hash.h"
@@ -30,6 +32,7 @@
 #include "source/common/http/utility.h"
 #include "source/common/router/config_impl.h"
 #include "source/common/router/context_impl.h"
+#include "source/common/router/upstream_latency_sketch.h"
 #include "source/common/router/upstream_request.h"
 #include "source/common/stats/symbol_table_impl.h"
 #include "source/common/stream_info/stream_info_impl.h"
@@ -198,9 +201,15 @@ public:
             config.suppress_envoy_headers(), config.respect_expected_rq_timeout(),
             config.suppress_grpc_request_failure_code_stats(), config.strict_check_headers(),
             context.api().timeSource(), context.httpContext(), context.routerContext()) {
+    overload_manager_ = &context.overloadManager();
     for (const auto& upstream_log : config.upstream_log()) {
       upstream_logs_.push_back(AccessLog::AccessLogFactory::fromProto(upstream_log, context));
     }
+    if (config.has_request_body_spill()) {
+      request_body_spill_ = Buffer::DiskSpill::create(
+          config.request_body_spill(), context.scope(),
+          context.scope().symbolTable().toString(stat_prefix) + "router.spill.");
+    }
   }
   using HeaderVector = std::vector<Http::LowerCaseString>;
   using HeaderVectorPtr = std::unique_ptr<HeaderVector>;
@@ -225,6 +234,10 @@ public:
   Http::Context& http_context_;
   Stats::StatName zone_name_;
   Stats::StatName empty_stat_name_;
+  // Used to shed the shadowing of requests under overload, if set.
+  Server::OverloadManager* overload_manager_{};
+  // Spills the request bodies buffered for retries and shadowing to disk, if set.
+  Buffer::DiskSpillSharedPtr request_body_spill_;
 
 private:
   ShadowWriterPtr shadow_writer_;
@@ -256,6 +269,7 @@ public:
                                UpstreamRequest& upstream_request) PURE;
   virtual void onUpstreamHostSelected(Upstream::HostDescriptionConstSharedPtr host) PURE;
   virtual void onPerTryTimeout(UpstreamRequest& upstream_request) PURE;
+  virtual void onLatencyHedgeTimeout(UpstreamRequest& upstream_request) PURE;
   virtual void onStreamMaxDurationReached(UpstreamRequest& upstream_request) PURE;
 
   virtual Http::StreamDecoderFilterCallbacks* callbacks() PURE;
@@ -266,12 +280,16 @@ public:
   virtual Http::RequestTrailerMap* downstreamTrailers() PURE;
   virtual bool downstreamResponseStarted() const PURE;
   virtual bool downstreamEndStream() const PURE;
+  virtual MonotonicTime downstreamRequestCompleteTime() const PURE;
   virtual uint32_t attemptCount() const PURE;
   virtual const VirtualCluster* requestVcluster() const PURE;
   virtual const RouteEntry* routeEntry() const PURE;
   virtual const std::list<UpstreamRequestPtr>& upstreamRequests() const PURE;
   virtual const UpstreamRequest* finalUpstreamRequest() const PURE;
   virtual TimeSource& timeSource() PURE;
+  // The delay after which an upstream request awaiting headers is hedged, if it is hedged on
+  // latency.
+  virtual absl::optional<std::chrono::milliseconds> latencyHedgeDelay() PURE;
 };
 
 /**
@@ -287,7 +305,7 @@ public:
         downstream_100_continue_headers_encoded_(false), downstream_response_started_(false),
         downstream_end_stream_(false), is_retry_(false),
         attempting_internal_redirect_with_complete_stream_(false),
-        request_buffer_overflowed_(false) {}
+        request_buffer_overflowed_(false), next_retry_is_latency_hedge_(false) {}
 
   ~Filter() override;
 
@@ -431,6 +449,7 @@ public:
                        UpstreamRequest& upstream_request) override;
   void onUpstreamHostSelected(Upstream::HostDescriptionConstSharedPtr host) override;
   void onPerTryTimeout(UpstreamRequest& upstream_request) override;
+  void onLatencyHedgeTimeout(UpstreamRequest& upstream_request) override;
   void onStreamMaxDurationReached(UpstreamRequest& upstream_request) override;
   Http::StreamDecoderFilterCallbacks* callbacks() override { return callbacks_; }
   Upstream::ClusterInfoConstSharedPtr cluster() override { return cluster_; }
@@ -440,6 +459,9 @@ public:
   Http::RequestTrailerMap* downstreamTrailers() override { return downstream_trailers_; }
   bool downstreamResponseStarted() const override { return downstream_response_started_; }
   bool downstreamEndStream() const override { return downstream_end_stream_; }
+  MonotonicTime downstreamRequestCompleteTime() const override {
+    return downstream_request_complete_time_;
+  }
   uint32_t attemptCount() const override { return attempt_count_; }
   const VirtualCluster* requestVcluster() const override { return request_vcluster_; }
   const RouteEntry* routeEntry() const override { return route_entry_; }
@@ -448,6 +470,7 @@ public:
   }
   const UpstreamRequest* finalUpstreamRequest() const override { return final_upstream_request_; }
   TimeSource& timeSource() override { return config_.timeSource(); }
+  absl::optional<std::chrono::milliseconds> latencyHedgeDelay() override;
 
 private:
   friend class UpstreamRequest;
@@ -475,6 +498,7 @@ private:
   UpstreamRequestPtr createUpstreamRequest();
 
   void maybeDoShadowing();
+  void maybeSpillRequestBody(Buffer::Instance& data);
   bool maybeRetryReset(Http::StreamResetReason reset_reason, UpstreamRequest& upstream_request);
   uint32_t numRequestsAwaitingHeaders();
   void onGlobalTimeout();
@@ -521,6 +545,9 @@ private:
   Event::TimerPtr response_timeout_;
   FilterUtility::TimeoutData timeout_;
   FilterUtility::HedgingParams hedging_params_;
+  const LatencyHedgeSettings* latency_hedge_{};
+  // The recent latencies of the cluster on this worker, set if the request is hedged on latency.
+  UpstreamLatencySketchSharedPtr latency_sketch_;
   Http::Code timeout_response_code_ = Http::Code::GatewayTimeout;
   std::list<UpstreamRequestPtr> upstream_requests_;
   // Tracks which upstream request "wins" and will have the corresponding
@@ -532,9 +559,13 @@ private:
   Http::RequestTrailerMap* downstream_trailers_{};
   MonotonicTime downstream_request_complete_time_;
   uint32_t retry_shadow_buffer_limit_{std::numeric_limits<uint32_t>::max()};
+  // Spills the request body buffered for retries and shadowing, created with the first chunk past
+  // the threshold.
+  Buffer::DiskSpillerPtr request_body_spiller_;
   MetadataMatchCriteriaConstPtr metadata_match_;
   std::function<void(Http::ResponseHeaderMap&)> modify_headers_;
   std::vector<std::reference_wrapper<const ShadowPolicy>> active_shadow_policies_{};
+  std::vector<ShadowStreamPtr> shadow_streams_;
 
   // list of cookies to add to upstream headers
   std::vector<std::string> downstream_set_cookies_;
@@ -547,6 +578,8 @@ private:
   bool attempting_internal_redirect_with_complete_stream_ : 1;
   bool request_buffer_overflowed_ : 1;
   bool internal_redirects_with_body_enabled_ : 1;
+  // Set when the next retry is a hedge of a slow upstream request.
+  bool next_retry_is_latency_hedge_ : 1;
   uint32_t attempt_count_{1};
   uint32_t pending_retries_{0};
 
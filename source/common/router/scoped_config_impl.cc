@@ -150,6 +150,7 @@ ScopedConfigImpl::getRouteConfig(const Http::HeaderMap& headers) const {
   }
   auto iter = scoped_route_info_by_key_.find(scope_key->hash());
   if (iter != scoped_route_info_by_key_.end()) {
+    iter->second->markUsed();
     return iter->second->routeConfig();
   }
   return nullptr;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <typeinfo>
 
@@ -91,10 +92,22 @@ public:
   }
   const std::string& scopeName() const { return config_proto_.name(); }
 
+  // Called by the workers when they route a request with the scope. The flag is only written when
+  // it isn't set yet, so the workers routing with a busy scope do not contend for it.
+  void markUsed() const {
+    if (!used_.load(std::memory_order_relaxed)) {
+      used_.store(true, std::memory_order_relaxed);
+    }
+  }
+  // Returns whether the scope was used since the last call, for the main thread to unload the
+  // on demand scopes which were used the least recently.
+  bool checkAndClearUsed() const { return used_.exchange(false, std::memory_order_relaxed); }
+
 private:
   envoy::config::route::v3::ScopedRouteConfiguration config_proto_;
   ScopeKey scope_key_;
   ConfigConstSharedPtr route_config_;
+  mutable std::atomic<bool> used_{true};
 };
 using ScopedRouteInfoConstSharedPtr = std::shared_ptr<const ScopedRouteInfo>;
 // Ordered map for consistent config dumping.
@@ -116,6 +116,8 @@ ScopedRdsConfigSubscription::ScopedRdsConfigSubscription(
       stats_({ALL_SCOPED_RDS_STATS(POOL_COUNTER(*scope_), POOL_GAUGE(*scope_))}),
       scope_key_builder_(scope_key_builder), rds_config_source_(std::move(rds_config_source)),
       stat_prefix_(stat_prefix), route_config_provider_manager_(route_config_provider_manager),
+      max_loaded_on_demand_scopes_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(scoped_rds, max_loaded_on_demand_scopes, 0)),
       optional_http_filters_(optional_http_filters) {
   const auto resource_name = getResourceName();
   if (scoped_rds.srds_resources_locator().empty()) {
@@ -227,6 +229,15 @@ void ScopedRdsConfigSubscription::RdsRouteConfigProviderHelper::maybeInitRdsConf
   rds.set_route_config_name(
       parent_.scoped_route_map_[scope_name_]->configProto().route_configuration_name());
   initRdsConfigProvider(rds, *srds_init_mgr);
+  if (unloaded_) {
+    parent_.stats_.on_demand_scopes_reloaded_.inc();
+  }
+  loaded_on_demand_ = true;
+  loaded_on_demand_position_ =
+      parent_.loaded_on_demand_scopes_.insert(parent_.loaded_on_demand_scopes_.begin(), this);
+  parent_.stats_.on_demand_scopes_loaded_.inc();
+  // The scope loaded is not unloaded until its route configuration reached the workers.
+  parent_.maybeUnloadOnDemandScopes();
   ENVOY_LOG(debug, fmt::format("Scope on demand update: {}", scope_name_));
   // If RouteConfiguration hasn't been initialized, routeConfig() return a shared_ptr to
   // NullConfigImpl. The name of NullConfigImpl is an empty string.
@@ -237,6 +248,21 @@ void ScopedRdsConfigSubscription::RdsRouteConfigProviderHelper::maybeInitRdsConf
   parent_.onRdsConfigUpdate(scope_name_, route_provider_->subscription());
 }
 
+void ScopedRdsConfigSubscription::RdsRouteConfigProviderHelper::unloadRdsConfigProvider() {
+  ASSERT(loaded_on_demand_ && unloadable());
+  // The handle is owned by the RDS subscription, which the route provider may be the last to hold.
+  rds_update_callback_handle_.reset();
+  route_provider_.reset();
+  loaded_route_info_.reset();
+  parent_.loaded_on_demand_scopes_.erase(loaded_on_demand_position_);
+  loaded_on_demand_ = false;
+  unloaded_ = true;
+  parent_.stats_.active_scopes_.dec();
+  parent_.stats_.on_demand_scopes_loaded_.dec();
+  parent_.stats_.on_demand_scopes_unloaded_.inc();
+  ENVOY_LOG(debug, "srds: unloading on demand scope '{}'", scope_name_);
+}
+
 bool ScopedRdsConfigSubscription::addOrUpdateScopes(
     const std::vector<Envoy::Config::DecodedResourceRef>& resources, Init::Manager& init_manager,
     const std::string& version_info) {
@@ -401,12 +427,13 @@ void ScopedRdsConfigSubscription::onRdsConfigUpdate(const std::string& scope_nam
   auto iter = scoped_route_map_.find(scope_name);
   ASSERT(iter != scoped_route_map_.end(),
          fmt::format("trying to update route config for non-existing scope {}", scope_name));
+  // The scopes of a route configuration share the configuration built by its RDS subscription, with
+  // its compiled regexes and header parsers, rather than each building a copy of their own.
+  ConfigConstSharedPtr route_config = rds_subscription.routeConfigUpdate()->parsedConfiguration();
+  ASSERT(route_config != nullptr);
   auto new_scoped_route_info = std::make_shared<ScopedRouteInfo>(
       envoy::config::route::v3::ScopedRouteConfiguration(iter->second->configProto()),
-      std::make_shared<ConfigImpl>(
-          rds_subscription.routeConfigUpdate()->protobufConfiguration(), optional_http_filters_,
-          factory_context_, factory_context_.messageValidationContext().dynamicValidationVisitor(),
-          false));
+      std::move(route_config));
   applyConfigUpdate([new_scoped_route_info](ConfigProvider::ConfigConstSharedPtr config)
                         -> ConfigProvider::ConfigConstSharedPtr {
     auto* thread_local_scoped_config =
@@ -414,8 +441,45 @@ void ScopedRdsConfigSubscription::onRdsConfigUpdate(const std::string& scope_nam
     thread_local_scoped_config->addOrUpdateRoutingScopes({new_scoped_route_info});
     return config;
   });
+  RdsRouteConfigProviderHelper& rds_config_provider_helper = *route_provider_by_scope_[scope_name];
+  if (rds_config_provider_helper.on_demand_) {
+    rds_config_provider_helper.loaded_route_info_ = new_scoped_route_info;
+  }
   // The data plane may wait for the route configuration to come back.
-  route_provider_by_scope_[scope_name]->runOnDemandUpdateCallback();
+  rds_config_provider_helper.runOnDemandUpdateCallback();
+}
+
+void ScopedRdsConfigSubscription::maybeUnloadOnDemandScopes() {
+  if (max_loaded_on_demand_scopes_ == 0) {
+    return;
+  }
+  // The scopes are checked from the least recently loaded or used. A scope used by the workers
+  // since it was last checked, or which can't be unloaded yet, is moved to the front instead, so
+  // that each scope is checked twice at most.
+  std::vector<ScopedRouteInfoConstSharedPtr> unloaded_scopes;
+  size_t checks_left = 2 * loaded_on_demand_scopes_.size();
+  while (loaded_on_demand_scopes_.size() > max_loaded_on_demand_scopes_ && checks_left-- > 0) {
+    RdsRouteConfigProviderHelper* rds_config_provider_helper = loaded_on_demand_scopes_.back();
+    if (!rds_config_provider_helper->unloadable() ||
+        rds_config_provider_helper->loaded_route_info_->checkAndClearUsed()) {
+      loaded_on_demand_scopes_.splice(loaded_on_demand_scopes_.begin(), loaded_on_demand_scopes_,
+                                      std::prev(loaded_on_demand_scopes_.end()));
+      continue;
+    }
+    rds_config_provider_helper->unloadRdsConfigProvider();
+    // The workers get the scope back without its route configuration, for the next request to
+    // the scope to load it again on demand.
+    unloaded_scopes.push_back(scoped_route_map_[rds_config_provider_helper->scope_name_]);
+  }
+  if (!unloaded_scopes.empty()) {
+    applyConfigUpdate([unloaded_scopes](ConfigProvider::ConfigConstSharedPtr config)
+                          -> ConfigProvider::ConfigConstSharedPtr {
+      auto* thread_local_scoped_config =
+          const_cast<ScopedConfigImpl*>(static_cast<const ScopedConfigImpl*>(config.get()));
+      thread_local_scoped_config->addOrUpdateRoutingScopes(unloaded_scopes);
+      return config;
+    });
+  }
 }
 
 // TODO(stevenzzzz): see issue #7508, consider generalizing this function as it overlaps with
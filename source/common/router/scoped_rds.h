@@ -1,5 +1,6 @@
 #pragma once
 
+#include <list>
 #include <memory>
 #include <string>
 
@@ -84,10 +85,13 @@ private:
 // clang-format off
 #define ALL_SCOPED_RDS_STATS(COUNTER, GAUGE)                                                       \
   COUNTER(config_reload)                                                                           \
+  COUNTER(on_demand_scopes_reloaded)                                                               \
+  COUNTER(on_demand_scopes_unloaded)                                                               \
   COUNTER(update_empty)                                                                            \
   GAUGE(all_scopes, Accumulate)                                                                    \
   GAUGE(config_reload_time_ms, NeverImport)                                                        \
   GAUGE(on_demand_scopes, Accumulate)                                                              \
+  GAUGE(on_demand_scopes_loaded, Accumulate)                                                       \
   GAUGE(active_scopes, Accumulate)
 
 // clang-format on
@@ -151,6 +155,10 @@ private:
       if (on_demand_) {
         parent_.stats_.on_demand_scopes_.dec();
       }
+      if (loaded_on_demand_) {
+        parent_.loaded_on_demand_scopes_.erase(loaded_on_demand_position_);
+        parent_.stats_.on_demand_scopes_loaded_.dec();
+      }
     }
     ConfigConstSharedPtr routeConfig() { return route_provider_->config(); }
 
@@ -167,6 +175,16 @@ private:
         envoy::extensions::filters::network::http_connection_manager::v3::Rds& rds,
         Init::Manager& init_manager);
 
+    // Whether the route configuration of the on demand scope reached the workers, and no request
+    // waits for it, so that it can be unloaded.
+    bool unloadable() const {
+      return loaded_route_info_ != nullptr && on_demand_update_callbacks_.empty();
+    }
+
+    // Release the route provider of the loaded on demand scope, for its route configuration to be
+    // loaded again by the next on demand update.
+    void unloadRdsConfigProvider();
+
     ScopedRdsConfigSubscription& parent_;
     std::string scope_name_;
     bool on_demand_;
@@ -175,6 +193,15 @@ private:
     // destructs, the handle is deleted as well.
     Common::CallbackHandlePtr rds_update_callback_handle_;
     std::vector<std::function<void()>> on_demand_update_callbacks_;
+    // Set while the route provider of the on demand scope is initialized, with the position of the
+    // scope in the loaded on demand scopes of the subscription.
+    bool loaded_on_demand_{false};
+    std::list<RdsRouteConfigProviderHelper*>::iterator loaded_on_demand_position_;
+    // Set once the on demand scope was unloaded, to count the scopes loaded again.
+    bool unloaded_{false};
+    // The scope with its route configuration last sent to the workers, which mark it when they use
+    // it. Only set for the on demand scopes.
+    ScopedRouteInfoConstSharedPtr loaded_route_info_;
   };
 
   using RdsRouteConfigProviderHelperPtr = std::unique_ptr<RdsRouteConfigProviderHelper>;
@@ -219,6 +246,9 @@ private:
   // Propagate RDS updates to ScopeConfigImpl in workers.
   void onRdsConfigUpdate(const std::string& scope_name,
                          RdsRouteConfigSubscription& rds_subscription);
+  // Unloads the on demand scopes used the least recently while more than
+  // max_loaded_on_demand_scopes_ are loaded.
+  void maybeUnloadOnDemandScopes();
 
   // ScopedRouteInfo by scope name.
   ScopedRouteMap scoped_route_map_;
@@ -235,7 +265,12 @@ private:
   const envoy::config::core::v3::ConfigSource rds_config_source_;
   const std::string stat_prefix_;
   RouteConfigProviderManager& route_config_provider_manager_;
+  // Zero if the loaded on demand scopes are not bounded.
+  const uint32_t max_loaded_on_demand_scopes_;
 
+  // The on demand scopes whose route provider is initialized, the most recently loaded or used
+  // first. Declared before the helpers, which remove themselves from it.
+  std::list<RdsRouteConfigProviderHelper*> loaded_on_demand_scopes_;
   // RdsRouteConfigProvider by scope name.
   absl::flat_hash_map<std::string, RdsRouteConfigProviderHelperPtr> route_provider_by_scope_;
   // A map of (hash, scope-name), used to detect the key conflict between scopes.
@@ -3,7 +3,9 @@
 #include <chrono>
 #include <string>
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/assert.h"
+#include "source/common/http/header_map_impl.h"
 #include "source/common/http/headers.h"
 
 #include "absl/strings/str_join.h"
@@ -11,27 +13,110 @@
 namespace Envoy {
 namespace Router {
 
-void ShadowWriterImpl::shadow(const std::string& cluster, Http::RequestMessagePtr&& request,
-                              const Http::AsyncClient::RequestOptions& options) {
+ShadowStreamImpl::~ShadowStreamImpl() {
+  if (!end_stream_sent_) {
+    // The rest of the request will not be received, so the shadow cannot complete.
+    std::shared_ptr<StreamingShadowRequest> request = request_.lock();
+    if (request != nullptr && request->stream_ != nullptr) {
+      request->stream_->reset();
+    }
+  }
+}
+
+std::shared_ptr<StreamingShadowRequest> ShadowStreamImpl::activeRequest() {
+  std::shared_ptr<StreamingShadowRequest> request = request_.lock();
+  if (request == nullptr || request->stream_ == nullptr) {
+    return nullptr;
+  }
+  if (request->response_complete_) {
+    // The shadow cluster does not need the rest of the request.
+    request->stream_->reset();
+    return nullptr;
+  }
+  if (request->stream_->isAboveWriteBufferHighWatermark()) {
+    ENVOY_LOG(debug, "dropping shadow request to '{}' which fell behind", cluster_->name());
+    cluster_->stats().upstream_rq_shadow_dropped_.inc();
+    request->stream_->reset();
+    return nullptr;
+  }
+  return request;
+}
+
+void ShadowStreamImpl::sendData(const Buffer::Instance& data, bool end_stream) {
+  std::shared_ptr<StreamingShadowRequest> request = activeRequest();
+  if (request == nullptr) {
+    return;
+  }
+  end_stream_sent_ = end_stream;
+  Buffer::OwnedImpl copy(data);
+  request->stream_->sendData(copy, end_stream);
+}
+
+void ShadowStreamImpl::sendTrailers(const Http::RequestTrailerMap& trailers) {
+  std::shared_ptr<StreamingShadowRequest> request = activeRequest();
+  if (request == nullptr) {
+    return;
+  }
+  end_stream_sent_ = true;
+  request->trailers_ = Http::createHeaderMap<Http::RequestTrailerMapImpl>(trailers);
+  request->stream_->sendTrailers(*request->trailers_);
+}
+
+Upstream::ThreadLocalCluster* ShadowWriterImpl::shadowCluster(const std::string& cluster) {
   // It's possible that the cluster specified in the route configuration no longer exists due
   // to a CDS removal. Check that it still exists before shadowing.
   // TODO(mattklein123): Optimally we would have a stat but for now just fix the crashing issue.
-  const auto thread_local_cluster = cm_.getThreadLocalCluster(cluster);
+  Upstream::ThreadLocalCluster* thread_local_cluster = cm_.getThreadLocalCluster(cluster);
   if (thread_local_cluster == nullptr) {
     ENVOY_LOG(debug, "shadow cluster '{}' does not exist", cluster);
-    return;
   }
+  return thread_local_cluster;
+}
 
-  ASSERT(!request->headers().getHostValue().empty());
+void ShadowWriterImpl::setShadowHost(Http::RequestHeaderMap& headers) {
+  ASSERT(!headers.getHostValue().empty());
   // Switch authority to add a shadow postfix. This allows upstream logging to make more sense.
-  auto parts = StringUtil::splitToken(request->headers().getHostValue(), ":");
+  auto parts = StringUtil::splitToken(headers.getHostValue(), ":");
   ASSERT(!parts.empty() && parts.size() <= 2);
-  request->headers().setHost(parts.size() == 2
-                                 ? absl::StrJoin(parts, "-shadow:")
-                                 : absl::StrCat(request->headers().getHostValue(), "-shadow"));
+  headers.setHost(parts.size() == 2 ? absl::StrJoin(parts, "-shadow:")
+                                    : absl::StrCat(headers.getHostValue(), "-shadow"));
+}
+
+void ShadowWriterImpl::shadow(const std::string& cluster, Http::RequestMessagePtr&& request,
+                              const Http::AsyncClient::RequestOptions& options) {
+  Upstream::ThreadLocalCluster* thread_local_cluster = shadowCluster(cluster);
+  if (thread_local_cluster == nullptr) {
+    return;
+  }
+
+  setShadowHost(request->headers());
   // This is basically fire and forget. We don't handle cancelling.
   thread_local_cluster->httpAsyncClient().send(std::move(request), *this, options);
 }
 
+ShadowStreamPtr ShadowWriterImpl::streamingShadow(const std::string& cluster,
+                                                  Http::RequestHeaderMapPtr&& headers,
+                                                  bool end_stream,
+                                                  const Http::AsyncClient::StreamOptions& options) {
+  Upstream::ThreadLocalCluster* thread_local_cluster = shadowCluster(cluster);
+  if (thread_local_cluster == nullptr) {
+    return nullptr;
+  }
+
+  setShadowHost(*headers);
+  auto request = std::make_shared<StreamingShadowRequest>(std::move(headers));
+  request->self_ = request;
+  // If the stream cannot be started, onReset() has already released the request.
+  request->stream_ = thread_local_cluster->httpAsyncClient().start(*request, options);
+  if (request->stream_ == nullptr) {
+    return nullptr;
+  }
+  request->stream_->sendHeaders(*request->headers_, end_stream);
+  if (end_stream || request->stream_ == nullptr) {
+    return nullptr;
+  }
+  return std::make_unique<ShadowStreamImpl>(request, thread_local_cluster->info());
+}
+
 } // namespace Router
 } // namespace Envoy
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <memory>
 #include <string>
 
 #include "envoy/router/shadow_writer.h"
@@ -9,6 +10,63 @@
 namespace Envoy {
 namespace Router {
 
+/**
+ * A request streamed to a shadow cluster. It owns itself until its stream completes or is reset,
+ * so that it outlives the downstream request once it is complete.
+ */
+class StreamingShadowRequest : public Http::AsyncClient::StreamCallbacks {
+public:
+  explicit StreamingShadowRequest(Http::RequestHeaderMapPtr&& headers)
+      : headers_(std::move(headers)) {}
+
+  // Http::AsyncClient::StreamCallbacks
+  void onHeaders(Http::ResponseHeaderMapPtr&&, bool end_stream) override {
+    response_complete_ = end_stream;
+  }
+  void onData(Buffer::Instance&, bool end_stream) override { response_complete_ = end_stream; }
+  void onTrailers(Http::ResponseTrailerMapPtr&&) override { response_complete_ = true; }
+  void onComplete() override { onDone(); }
+  void onReset() override { onDone(); }
+
+  // The headers and trailers are referenced by the stream until it is done.
+  Http::RequestHeaderMapPtr headers_;
+  Http::RequestTrailerMapPtr trailers_;
+  // Cleared when the stream is done.
+  Http::AsyncClient::Stream* stream_{};
+  std::shared_ptr<StreamingShadowRequest> self_;
+  bool response_complete_{};
+
+private:
+  void onDone() {
+    stream_ = nullptr;
+    // This may destroy the request.
+    self_.reset();
+  }
+};
+
+/**
+ * The handle of the router on a streamed shadow request.
+ */
+class ShadowStreamImpl : Logger::Loggable<Logger::Id::router>, public ShadowStream {
+public:
+  ShadowStreamImpl(const std::shared_ptr<StreamingShadowRequest>& request,
+                   Upstream::ClusterInfoConstSharedPtr cluster)
+      : request_(request), cluster_(std::move(cluster)) {}
+  ~ShadowStreamImpl() override;
+
+  // Router::ShadowStream
+  void sendData(const Buffer::Instance& data, bool end_stream) override;
+  void sendTrailers(const Http::RequestTrailerMap& trailers) override;
+
+private:
+  // @return the shadowed request if it may still be sent to, resetting its stream otherwise.
+  std::shared_ptr<StreamingShadowRequest> activeRequest();
+
+  std::weak_ptr<StreamingShadowRequest> request_;
+  const Upstream::ClusterInfoConstSharedPtr cluster_;
+  bool end_stream_sent_{};
+};
+
 /**
  * Implementation of ShadowWriter that takes incoming requests to shadow and implements "fire and
  * forget" behavior using an async client.
@@ -22,6 +80,9 @@ public:
   // Router::ShadowWriter
   void shadow(const std::string& cluster, Http::RequestMessagePtr&& request,
               const Http::AsyncClient::RequestOptions& options) override;
+  ShadowStreamPtr streamingShadow(const std::string& cluster, Http::RequestHeaderMapPtr&& headers,
+                                  bool end_stream,
+                                  const Http::AsyncClient::StreamOptions& options) override;
 
   // Http::AsyncClient::Callbacks
   void onSuccess(const Http::AsyncClient::Request&, Http::ResponseMessagePtr&&) override {}
@@ -30,6 +91,9 @@ public:
                                     const Http::ResponseHeaderMap*) override {}
 
 private:
+  Upstream::ThreadLocalCluster* shadowCluster(const std::string& cluster);
+  static void setShadowHost(Http::RequestHeaderMap& headers);
+
   Upstream::ClusterManager& cm_;
 };
 
@@ -0,0 +1,142 @@
+#include "source/common/router/upstream_latency_sketch.h"
+
+#include <algorithm>
+#include <string>
+
+#include "source/common/common/assert.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Router {
+
+namespace {
+
+// Each power of two is split in 16 buckets.
+constexpr uint32_t SubBucketBits = 4;
+constexpr uint32_t SubBuckets = 1 << SubBucketBits;
+// The counts are halved when they reach this total, so that older latencies fade away.
+constexpr uint32_t MaxSamples = 4096;
+// The number of latencies recorded before the cached percentile is computed again.
+constexpr uint32_t PercentileRefreshSamples = 64;
+// The request counts of the budget are halved when they reach this number of requests.
+constexpr uint32_t MaxRequests = 4096;
+
+struct ThreadSketches {
+  struct Sketch {
+    // Expires when the cluster is removed or updated, so that its latencies are not carried over.
+    std::weak_ptr<const Upstream::ClusterInfo> cluster_;
+    UpstreamLatencySketchSharedPtr sketch_;
+  };
+
+  absl::flat_hash_map<std::string, Sketch> sketches_;
+};
+
+} // namespace
+
+UpstreamLatencySketchSharedPtr
+UpstreamLatencySketch::forCluster(const Upstream::ClusterInfoConstSharedPtr& cluster) {
+  static thread_local ThreadSketches thread_sketches;
+  auto it = thread_sketches.sketches_.find(cluster->name());
+  if (it != thread_sketches.sketches_.end()) {
+    if (it->second.cluster_.lock() == cluster) {
+      return it->second.sketch_;
+    }
+    thread_sketches.sketches_.erase(it);
+  }
+
+  // Drop the sketches of the removed clusters.
+  for (auto expired = thread_sketches.sketches_.begin();
+       expired != thread_sketches.sketches_.end();) {
+    if (expired->second.cluster_.expired()) {
+      thread_sketches.sketches_.erase(expired++);
+    } else {
+      ++expired;
+    }
+  }
+  ThreadSketches::Sketch sketch{cluster, std::make_shared<UpstreamLatencySketch>()};
+  return thread_sketches.sketches_.emplace(cluster->name(), std::move(sketch))
+      .first->second.sketch_;
+}
+
+uint32_t UpstreamLatencySketch::bucket(uint64_t latency_us) {
+  if (latency_us < SubBuckets) {
+    return latency_us;
+  }
+  uint32_t exponent = SubBucketBits;
+  while (exponent < 35 && (latency_us >> (exponent + 1)) != 0) {
+    exponent++;
+  }
+  const uint32_t shift = exponent - SubBucketBits;
+  const uint32_t sub_bucket = std::min<uint64_t>(latency_us >> shift, 2 * SubBuckets - 1);
+  const uint32_t bucket = (shift + 1) * SubBuckets + (sub_bucket - SubBuckets);
+  ASSERT(bucket < NumBuckets);
+  return bucket;
+}
+
+uint64_t UpstreamLatencySketch::bucketLowerBound(uint32_t bucket) {
+  if (bucket < SubBuckets) {
+    return bucket;
+  }
+  const uint32_t shift = bucket / SubBuckets - 1;
+  return static_cast<uint64_t>(SubBuckets + bucket % SubBuckets) << shift;
+}
+
+void UpstreamLatencySketch::recordLatency(std::chrono::microseconds latency) {
+  counts_[bucket(std::max<int64_t>(latency.count(), 0))]++;
+  samples_++;
+  samples_since_percentile_++;
+  if (samples_ >= MaxSamples) {
+    samples_ = 0;
+    for (uint32_t& count : counts_) {
+      count /= 2;
+      samples_ += count;
+    }
+  }
+}
+
+absl::optional<std::chrono::milliseconds> UpstreamLatencySketch::percentile(double percentile,
+                                                                            uint32_t min_samples) {
+  if (samples_ < min_samples || samples_ == 0) {
+    return absl::nullopt;
+  }
+  if (percentile == cached_percentile_ && cached_percentile_value_.has_value() &&
+      samples_since_percentile_ < PercentileRefreshSamples) {
+    return cached_percentile_value_;
+  }
+
+  const double rank = samples_ * std::min(std::max(percentile, 0.0), 100.0) / 100;
+  uint64_t below = 0;
+  uint32_t found = NumBuckets - 1;
+  for (uint32_t i = 0; i < NumBuckets; i++) {
+    below += counts_[i];
+    if (below >= rank && below > 0) {
+      found = i;
+      break;
+    }
+  }
+  // The upper bound of the bucket, so that the percentile of the latencies are below it.
+  const uint64_t upper_us = found + 1 < NumBuckets ? bucketLowerBound(found + 1)
+                                                   : bucketLowerBound(found);
+  cached_percentile_ = percentile;
+  cached_percentile_value_ = std::chrono::milliseconds((upper_us + 999) / 1000);
+  samples_since_percentile_ = 0;
+  return cached_percentile_value_;
+}
+
+void UpstreamLatencySketch::recordRequest() {
+  requests_++;
+  if (requests_ >= MaxRequests) {
+    requests_ /= 2;
+    hedges_ /= 2;
+  }
+}
+
+bool UpstreamLatencySketch::hedgeAllowed(double budget_percent) const {
+  return hedges_ + 1 <= requests_ * budget_percent / 100;
+}
+
+void UpstreamLatencySketch::recordHedge() { hedges_++; }
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "envoy/upstream/upstream.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Router {
+
+class UpstreamLatencySketch;
+using UpstreamLatencySketchSharedPtr = std::shared_ptr<UpstreamLatencySketch>;
+
+/**
+ * The recent latencies of the tries of the upstream requests of a cluster on a worker, and the
+ * share of these requests hedged on latency. The latencies are counted in log-linear buckets with
+ * a relative error of about 6%, and every count is halved once enough latencies have been
+ * recorded, so that the percentiles follow the recent latencies of the cluster. It is not thread
+ * safe, each worker has its own sketch for each cluster.
+ */
+class UpstreamLatencySketch {
+public:
+  /**
+   * @return the sketch of the cluster for the calling thread.
+   */
+  static UpstreamLatencySketchSharedPtr
+  forCluster(const Upstream::ClusterInfoConstSharedPtr& cluster);
+
+  /**
+   * Records the latency of a try.
+   */
+  void recordLatency(std::chrono::microseconds latency);
+
+  /**
+   * @param percentile supplies the percentile, between 0 and 100.
+   * @param min_samples supplies the number of latencies which have to be recorded.
+   * @return the latency below which the percentile of the recent latencies are, or nullopt if
+   *         fewer than min_samples latencies have been recorded. The value is only computed again
+   *         after some more latencies have been recorded.
+   */
+  absl::optional<std::chrono::milliseconds> percentile(double percentile, uint32_t min_samples);
+
+  /**
+   * Records a request which may be hedged on latency.
+   */
+  void recordRequest();
+
+  /**
+   * @param budget_percent supplies the maximum percentage of the recent requests hedged.
+   * @return whether one more hedge stays within the budget.
+   */
+  bool hedgeAllowed(double budget_percent) const;
+
+  /**
+   * Records a hedge of a request.
+   */
+  void recordHedge();
+
+  // The number of buckets of latencies, which covers latencies of up to about 19 hours.
+  static constexpr uint32_t NumBuckets = 16 * 33;
+
+  /**
+   * @return the bucket of a latency in microseconds.
+   */
+  static uint32_t bucket(uint64_t latency_us);
+
+  /**
+   * @return the smallest latency in microseconds of a bucket.
+   */
+  static uint64_t bucketLowerBound(uint32_t bucket);
+
+private:
+  std::array<uint32_t, NumBuckets> counts_{};
+  // The total of counts_, which is halved with them.
+  uint32_t samples_{};
+  // The number of latencies recorded since the cached percentile was computed.
+  uint32_t samples_since_percentile_{};
+  double cached_percentile_{-1};
+  absl::optional<std::chrono::milliseconds> cached_percentile_value_;
+  uint32_t requests_{};
+  uint32_t hedges_{};
+};
+
+} // namespace Router
+} // namespace Envoy
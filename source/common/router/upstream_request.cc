@@ -47,7 +47,8 @@ UpstreamRequest::UpstreamRequest(RouterFilterInterface& parent,
       stream_info_(parent_.callbacks()->dispatcher().timeSource(), nullptr),
       start_time_(parent_.callbacks()->dispatcher().timeSource().monotonicTime()),
       calling_encode_headers_(false), upstream_canary_(false), decode_complete_(false),
-      encode_complete_(false), encode_trailers_(false), retried_(false), awaiting_headers_(true),
+      encode_complete_(false), encode_trailers_(false), retried_(false), latency_hedge_(false),
+      awaiting_headers_(true),
       outlier_detection_timeout_recorded_(false),
       create_per_try_timeout_on_request_complete_(false), paused_for_connect_(false),
       record_timeout_budget_(parent_.cluster()->timeoutBudgetStats().has_value()) {
@@ -75,6 +76,9 @@ UpstreamRequest::~UpstreamRequest() {
     // Allows for testing.
     per_try_timeout_->disableTimer();
   }
+  if (latency_hedge_timer_ != nullptr) {
+    latency_hedge_timer_->disableTimer();
+  }
   if (max_stream_duration_timer_ != nullptr) {
     max_stream_duration_timer_->disableTimer();
   }
@@ -202,6 +206,22 @@ const Network::Connection& UpstreamRequest::connection() const {
   return *parent_.callbacks()->connection();
 }
 
+absl::optional<MonotonicTime> UpstreamRequest::downstreamDeadline() const {
+  const std::chrono::milliseconds global_timeout = parent_.timeout().global_timeout_;
+  if (global_timeout.count() == 0) {
+    return absl::nullopt;
+  }
+  if (parent_.downstreamEndStream()) {
+    return parent_.downstreamRequestCompleteTime() + global_timeout;
+  }
+  // The global timeout starts once the downstream request is complete, which for a headers only
+  // request is right after its first upstream request is created.
+  if (encode_complete_) {
+    return parent_.timeSource().monotonicTime() + global_timeout;
+  }
+  return absl::nullopt;
+}
+
 void UpstreamRequest::decodeMetadata(Http::MetadataMapPtr&& metadata_map) {
   parent_.onUpstreamMetadata(std::move(metadata_map));
 }
@@ -328,11 +348,26 @@ void UpstreamRequest::resetStream() {
 
 void UpstreamRequest::setupPerTryTimeout() {
   ASSERT(!per_try_timeout_);
+  Event::Dispatcher& dispatcher = parent_.callbacks()->dispatcher();
+  per_try_start_time_ = dispatcher.timeSource().monotonicTime();
   if (parent_.timeout().per_try_timeout_.count() > 0) {
-    per_try_timeout_ =
-        parent_.callbacks()->dispatcher().createTimer([this]() -> void { onPerTryTimeout(); });
+    per_try_timeout_ = dispatcher.createTimer([this]() -> void { onPerTryTimeout(); });
     per_try_timeout_->enableTimer(parent_.timeout().per_try_timeout_);
   }
+
+  const absl::optional<std::chrono::milliseconds> hedge_delay = parent_.latencyHedgeDelay();
+  if (hedge_delay.has_value()) {
+    latency_hedge_timer_ = dispatcher.createTimer([this]() -> void { onLatencyHedgeTimeout(); });
+    latency_hedge_timer_->enableTimer(hedge_delay.value());
+  }
+}
+
+void UpstreamRequest::onLatencyHedgeTimeout() {
+  // There is nothing left to hedge once a response has started.
+  if (awaiting_headers_ && !parent_.downstreamResponseStarted()) {
+    ENVOY_STREAM_LOG(debug, "upstream latency hedge timeout", *parent_.callbacks());
+    parent_.onLatencyHedgeTimeout(*this);
+  }
 }
 
 void UpstreamRequest::onPerTryTimeout() {
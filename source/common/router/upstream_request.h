@@ -47,6 +47,7 @@ public:
   void resetStream();
   void setupPerTryTimeout();
   void onPerTryTimeout();
+  void onLatencyHedgeTimeout();
   void maybeEndDecode(bool end_stream);
   void onUpstreamHostSelected(Upstream::HostDescriptionConstSharedPtr host);
 
@@ -68,6 +69,7 @@ public:
   // UpstreamToDownstream
   const RouteEntry& routeEntry() const override;
   const Network::Connection& connection() const override;
+  absl::optional<MonotonicTime> downstreamDeadline() const override;
 
   void disableDataFromDownstreamForFlowControl();
   void enableDataFromDownstreamForFlowControl();
@@ -108,6 +110,10 @@ public:
   const StreamInfo::UpstreamTiming& upstreamTiming() { return upstream_timing_; }
   void retried(bool value) { retried_ = value; }
   bool retried() { return retried_; }
+  void latencyHedge(bool value) { latency_hedge_ = value; }
+  bool latencyHedge() const { return latency_hedge_; }
+  // The time the per try timeout started, if it did.
+  const absl::optional<MonotonicTime>& perTryStartTime() const { return per_try_start_time_; }
   bool grpcRqSuccessDeferred() { return grpc_rq_success_deferred_; }
   void grpcRqSuccessDeferred(bool deferred) { grpc_rq_success_deferred_ = deferred; }
   void upstreamCanary(bool value) { upstream_canary_ = value; }
@@ -135,6 +141,8 @@ private:
   std::unique_ptr<GenericConnPool> conn_pool_;
   bool grpc_rq_success_deferred_;
   Event::TimerPtr per_try_timeout_;
+  Event::TimerPtr latency_hedge_timer_;
+  absl::optional<MonotonicTime> per_try_start_time_;
   std::unique_ptr<GenericUpstream> upstream_;
   absl::optional<Http::StreamResetReason> deferred_reset_reason_;
   Buffer::InstancePtr buffered_request_body_;
@@ -161,6 +169,8 @@ private:
   bool encode_complete_ : 1;
   bool encode_trailers_ : 1;
   bool retried_ : 1;
+  // True if this request was started as a hedge of a slow request.
+  bool latency_hedge_ : 1;
   bool awaiting_headers_ : 1;
   bool outlier_detection_timeout_recorded_ : 1;
   // Tracks whether we deferred a per try timeout because the downstream request
@@ -0,0 +1,74 @@
+#include "source/common/router/worker_retry_budget.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Router {
+
+namespace {
+
+// The buckets neither used nor referenced for this long are dropped, as their cluster is likely
+// gone.
+constexpr std::chrono::minutes IdleBucketTimeout{1};
+
+using ThreadBuckets = absl::flat_hash_map<std::pair<std::string, Upstream::ResourcePriority>,
+                                          WorkerRetryBudgetSharedPtr>;
+
+} // namespace
+
+WorkerRetryBudget::WorkerRetryBudget(const Upstream::WorkerRetryBudgetSettings& settings,
+                                     MonotonicTime now)
+    : settings_(settings), tokens_(settings.min_retry_concurrency_),
+      capacity_(settings.min_retry_concurrency_), interval_start_(now) {}
+
+WorkerRetryBudgetSharedPtr
+WorkerRetryBudget::forCluster(const std::string& cluster_name, Upstream::ResourcePriority priority,
+                              const Upstream::WorkerRetryBudgetSettings& settings,
+                              MonotonicTime now) {
+  static thread_local ThreadBuckets thread_buckets;
+  auto key = std::make_pair(cluster_name, priority);
+  auto it = thread_buckets.find(key);
+  if (it != thread_buckets.end()) {
+    // The settings of the cluster may have been updated.
+    it->second->settings_ = settings;
+    return it->second;
+  }
+
+  for (auto idle = thread_buckets.begin(); idle != thread_buckets.end();) {
+    if (idle->second.use_count() == 1 &&
+        now - idle->second->interval_start_ >= IdleBucketTimeout) {
+      thread_buckets.erase(idle++);
+    } else {
+      ++idle;
+    }
+  }
+  auto bucket = std::make_shared<WorkerRetryBudget>(settings, now);
+  thread_buckets.emplace(std::move(key), bucket);
+  return bucket;
+}
+
+void WorkerRetryBudget::onRequest(MonotonicTime now) {
+  if (now - interval_start_ >= ReconcileInterval) {
+    reconcile(now);
+  }
+  requests_in_interval_++;
+  tokens_ = std::min(tokens_ + settings_.budget_percent_ / 100, capacity_);
+}
+
+void WorkerRetryBudget::reconcile(MonotonicTime now) {
+  // Without requests for more than an interval, the rate of the last interval is unknown, so the
+  // bucket falls back to the minimum.
+  const uint64_t requests =
+      now - interval_start_ < 2 * ReconcileInterval ? requests_in_interval_ : 0;
+  capacity_ = std::max<double>(settings_.budget_percent_ / 100 * requests,
+                               settings_.min_retry_concurrency_);
+  tokens_ = std::min(std::max<double>(tokens_, settings_.min_retry_concurrency_), capacity_);
+  requests_in_interval_ = 0;
+  interval_start_ = now;
+}
+
+} // namespace Router
+} // namespace Envoy
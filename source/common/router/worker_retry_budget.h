@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/upstream/resource_manager.h"
+
+namespace Envoy {
+namespace Router {
+
+class WorkerRetryBudget;
+using WorkerRetryBudgetSharedPtr = std::shared_ptr<WorkerRetryBudget>;
+
+/**
+ * A token bucket limiting the retries of the requests of a worker to a cluster. Each request adds
+ * a fraction of a token and each retry takes a token. The bucket is reconciled with the requests
+ * of the worker every second, which bounds the tokens it may hold. It is not thread safe, each
+ * worker has its own bucket for each cluster and priority.
+ */
+class WorkerRetryBudget {
+public:
+  explicit WorkerRetryBudget(const Upstream::WorkerRetryBudgetSettings& settings,
+                             MonotonicTime now);
+
+  /**
+   * @return the bucket of the cluster and priority for the calling thread.
+   */
+  static WorkerRetryBudgetSharedPtr forCluster(const std::string& cluster_name,
+                                               Upstream::ResourcePriority priority,
+                                               const Upstream::WorkerRetryBudgetSettings& settings,
+                                               MonotonicTime now);
+
+  /**
+   * Records a request which may be retried.
+   */
+  void onRequest(MonotonicTime now);
+
+  /**
+   * @return whether a retry may be sent.
+   */
+  bool canRetry() const { return tokens_ >= 1; }
+
+  /**
+   * Records a retry, which takes a token.
+   */
+  void onRetry() { tokens_ -= 1; }
+
+  double tokens() const { return tokens_; }
+  MonotonicTime lastReconciled() const { return interval_start_; }
+
+  // How often the bucket is reconciled with the requests of the worker.
+  static constexpr std::chrono::seconds ReconcileInterval{1};
+
+private:
+  void reconcile(MonotonicTime now);
+
+  Upstream::WorkerRetryBudgetSettings settings_;
+  double tokens_;
+  double capacity_;
+  uint64_t requests_in_interval_{};
+  MonotonicTime interval_start_;
+};
+
+} // namespace Router
+} // namespace Envoy
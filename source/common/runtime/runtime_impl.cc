@@ -14,6 +14,7 @@
 
 #include "source/common/common/assert.h"
 #include "source/common/common/fmt.h"
+#include "source/common/common/macros.h"
 #include "source/common/common/utility.h"
 #include "source/common/config/api_version.h"
 #include "source/common/filesystem/directory.h"
@@ -21,6 +22,7 @@
 #include "source/common/protobuf/message_validator_impl.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/runtime/runtime_features.h"
+#include "source/common/runtime/runtime_key_registry.h"
 
 #include "absl/container/node_hash_map.h"
 #include "absl/container/node_hash_set.h"
@@ -57,6 +59,9 @@ void refreshQuicheReloadableFlags(const Snapshot::EntryMap& flag_map) {
 }
 #endif
 
+// Marks the entries of the handles which are not resolved yet.
+const Snapshot::Entry& unresolvedEntry() { CONSTRUCT_ON_FIRST_USE(Snapshot::Entry); }
+
 } // namespace
 
 bool SnapshotImpl::deprecatedFeatureEnabled(absl::string_view key, bool default_value) const {
@@ -94,15 +99,8 @@ bool SnapshotImpl::featureEnabled(absl::string_view key, uint64_t default_value,
 }
 
 bool SnapshotImpl::featureEnabled(absl::string_view key, uint64_t default_value) const {
-  // Avoid PRNG if we know we don't need it.
-  uint64_t cutoff = std::min(getInteger(key, default_value), static_cast<uint64_t>(100));
-  if (cutoff == 0) {
-    return false;
-  } else if (cutoff == 100) {
-    return true;
-  } else {
-    return generator_.random() % 100 < cutoff;
-  }
+  ASSERT(!isRuntimeFeature(key));
+  return percentEnabled(find(key), default_value);
 }
 
 bool SnapshotImpl::featureEnabled(absl::string_view key, uint64_t default_value,
@@ -112,11 +110,11 @@ bool SnapshotImpl::featureEnabled(absl::string_view key, uint64_t default_value,
 
 Snapshot::ConstStringOptRef SnapshotImpl::get(absl::string_view key) const {
   ASSERT(!isRuntimeFeature(key)); // Make sure runtime guarding is only used for getBoolean
-  auto entry = key.empty() ? values_.end() : values_.find(key);
-  if (entry == values_.end()) {
+  const Entry* entry = find(key);
+  if (entry == nullptr) {
     return absl::nullopt;
   } else {
-    return entry->second.raw_string_value_;
+    return entry->raw_string_value_;
   }
 }
 
@@ -128,22 +126,110 @@ bool SnapshotImpl::featureEnabled(absl::string_view key,
 bool SnapshotImpl::featureEnabled(absl::string_view key,
                                   const envoy::type::v3::FractionalPercent& default_value,
                                   uint64_t random_value) const {
-  const auto& entry = key.empty() ? values_.end() : values_.find(key);
+  return fractionalPercentEnabled(key, find(key), default_value, random_value);
+}
+
+uint64_t SnapshotImpl::getInteger(absl::string_view key, uint64_t default_value) const {
+  ASSERT(!isRuntimeFeature(key));
+  return integerValue(find(key), default_value);
+}
+
+double SnapshotImpl::getDouble(absl::string_view key, double default_value) const {
+  ASSERT(!isRuntimeFeature(key)); // Make sure runtime guarding is only used for getBoolean
+  return doubleValue(find(key), default_value);
+}
+
+bool SnapshotImpl::getBoolean(absl::string_view key, bool default_value) const {
+  return booleanValue(find(key), default_value);
+}
+
+bool SnapshotImpl::featureEnabled(const KeyHandle& key, uint64_t default_value) const {
+  ASSERT(!isRuntimeFeature(key.key()));
+  return percentEnabled(find(key), default_value);
+}
+
+bool SnapshotImpl::featureEnabled(const KeyHandle& key, uint64_t default_value,
+                                  uint64_t random_value) const {
+  ASSERT(!isRuntimeFeature(key.key()));
+  return random_value % 100 < std::min(integerValue(find(key), default_value), uint64_t(100));
+}
+
+bool SnapshotImpl::featureEnabled(const KeyHandle& key,
+                                  const envoy::type::v3::FractionalPercent& default_value) const {
+  return featureEnabled(key, default_value, generator_.random());
+}
+
+bool SnapshotImpl::featureEnabled(const KeyHandle& key,
+                                  const envoy::type::v3::FractionalPercent& default_value,
+                                  uint64_t random_value) const {
+  return fractionalPercentEnabled(key.key(), find(key), default_value, random_value);
+}
+
+uint64_t SnapshotImpl::getInteger(const KeyHandle& key, uint64_t default_value) const {
+  ASSERT(!isRuntimeFeature(key.key()));
+  return integerValue(find(key), default_value);
+}
+
+double SnapshotImpl::getDouble(const KeyHandle& key, double default_value) const {
+  ASSERT(!isRuntimeFeature(key.key()));
+  return doubleValue(find(key), default_value);
+}
+
+bool SnapshotImpl::getBoolean(const KeyHandle& key, bool default_value) const {
+  return booleanValue(find(key), default_value);
+}
+
+const Snapshot::Entry* SnapshotImpl::find(absl::string_view key) const {
+  if (key.empty()) {
+    return nullptr;
+  }
+  const auto it = values_.find(key);
+  return it == values_.end() ? nullptr : &it->second;
+}
+
+const Snapshot::Entry* SnapshotImpl::find(const KeyHandle& key) const {
+  if (key.index() >= KeyRegistry::MaxKeys) {
+    return find(key.key());
+  }
+  std::atomic<const Entry*>& resolved = entries_by_handle_[key.index()];
+  const Entry* entry = resolved.load(std::memory_order_relaxed);
+  if (entry == &unresolvedEntry()) {
+    entry = find(key.key());
+    resolved.store(entry, std::memory_order_relaxed);
+  }
+  return entry;
+}
+
+bool SnapshotImpl::percentEnabled(const Entry* entry, uint64_t default_value) const {
+  // Avoid PRNG if we know we don't need it.
+  uint64_t cutoff = std::min(integerValue(entry, default_value), static_cast<uint64_t>(100));
+  if (cutoff == 0) {
+    return false;
+  } else if (cutoff == 100) {
+    return true;
+  } else {
+    return generator_.random() % 100 < cutoff;
+  }
+}
+
+bool SnapshotImpl::fractionalPercentEnabled(
+    absl::string_view key, const Entry* entry,
+    const envoy::type::v3::FractionalPercent& default_value, uint64_t random_value) const {
   envoy::type::v3::FractionalPercent percent;
-  if (entry != values_.end() && entry->second.fractional_percent_value_.has_value()) {
-    percent = entry->second.fractional_percent_value_.value();
-  } else if (entry != values_.end() && entry->second.uint_value_.has_value()) {
+  if (entry != nullptr && entry->fractional_percent_value_.has_value()) {
+    percent = entry->fractional_percent_value_.value();
+  } else if (entry != nullptr && entry->uint_value_.has_value()) {
     // Check for > 100 because the runtime value is assumed to be specified as
     // an integer, and it also ensures that truncating the uint64_t runtime
     // value into a uint32_t percent numerator later is safe
-    if (entry->second.uint_value_.value() > 100) {
+    if (entry->uint_value_.value() > 100) {
       return true;
     }
 
     // The runtime value was specified as an integer rather than a fractional
     // percent proto. To preserve legacy semantics, we treat it as a percentage
     // (i.e. denominator of 100).
-    percent.set_numerator(entry->second.uint_value_.value());
+    percent.set_numerator(entry->uint_value_.value());
     percent.set_denominator(envoy::type::v3::FractionalPercent::HUNDRED);
   } else {
     percent = default_value;
@@ -164,35 +250,6 @@ bool SnapshotImpl::featureEnabled(absl::string_view key,
   return ProtobufPercentHelper::evaluateFractionalPercent(percent, random_value);
 }
 
-uint64_t SnapshotImpl::getInteger(absl::string_view key, uint64_t default_value) const {
-  ASSERT(!isRuntimeFeature(key));
-  const auto& entry = key.empty() ? values_.end() : values_.find(key);
-  if (entry == values_.end() || !entry->second.uint_value_) {
-    return default_value;
-  } else {
-    return entry->second.uint_value_.value();
-  }
-}
-
-double SnapshotImpl::getDouble(absl::string_view key, double default_value) const {
-  ASSERT(!isRuntimeFeature(key)); // Make sure runtime guarding is only used for getBoolean
-  const auto& entry = key.empty() ? values_.end() : values_.find(key);
-  if (entry == values_.end() || !entry->second.double_value_) {
-    return default_value;
-  } else {
-    return entry->second.double_value_.value();
-  }
-}
-
-bool SnapshotImpl::getBoolean(absl::string_view key, bool default_value) const {
-  const auto& entry = key.empty() ? values_.end() : values_.find(key);
-  if (entry == values_.end() || !entry->second.bool_value_.has_value()) {
-    return default_value;
-  } else {
-    return entry->second.bool_value_.value();
-  }
-}
-
 const std::vector<Snapshot::OverrideLayerConstPtr>& SnapshotImpl::getLayers() const {
   return layers_;
 }
@@ -201,7 +258,12 @@ const Snapshot::EntryMap& SnapshotImpl::values() const { return values_; }
 
 SnapshotImpl::SnapshotImpl(Random::RandomGenerator& generator, RuntimeStats& stats,
                            std::vector<OverrideLayerConstPtr>&& layers)
-    : layers_{std::move(layers)}, generator_{generator}, stats_{stats} {
+    : layers_{std::move(layers)},
+      entries_by_handle_{std::make_unique<std::atomic<const Entry*>[]>(KeyRegistry::MaxKeys)},
+      generator_{generator}, stats_{stats} {
+  for (uint32_t i = 0; i < KeyRegistry::MaxKeys; i++) {
+    entries_by_handle_[i].store(&unresolvedEntry(), std::memory_order_relaxed);
+  }
   for (const auto& layer : layers_) {
     for (const auto& kv : layer->values()) {
       values_.erase(kv.first);
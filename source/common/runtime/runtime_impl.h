@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -83,6 +84,17 @@ public:
   uint64_t getInteger(absl::string_view key, uint64_t default_value) const override;
   double getDouble(absl::string_view key, double default_value) const override;
   bool getBoolean(absl::string_view key, bool value) const override;
+  bool featureEnabled(const KeyHandle& key, uint64_t default_value) const override;
+  bool featureEnabled(const KeyHandle& key, uint64_t default_value,
+                      uint64_t random_value) const override;
+  bool featureEnabled(const KeyHandle& key,
+                      const envoy::type::v3::FractionalPercent& default_value) const override;
+  bool featureEnabled(const KeyHandle& key,
+                      const envoy::type::v3::FractionalPercent& default_value,
+                      uint64_t random_value) const override;
+  uint64_t getInteger(const KeyHandle& key, uint64_t default_value) const override;
+  double getDouble(const KeyHandle& key, double default_value) const override;
+  bool getBoolean(const KeyHandle& key, bool default_value) const override;
   const std::vector<OverrideLayerConstPtr>& getLayers() const override;
 
   const EntryMap& values() const;
@@ -112,8 +124,31 @@ private:
   static bool parseEntryDoubleValue(Entry& entry);
   static void parseEntryFractionalPercentValue(Entry& entry);
 
+  // The entry of the key, or nullptr if it is not set.
+  const Entry* find(absl::string_view key) const;
+  const Entry* find(const KeyHandle& key) const;
+
+  bool percentEnabled(const Entry* entry, uint64_t default_value) const;
+  bool fractionalPercentEnabled(absl::string_view key, const Entry* entry,
+                                const envoy::type::v3::FractionalPercent& default_value,
+                                uint64_t random_value) const;
+  static uint64_t integerValue(const Entry* entry, uint64_t default_value) {
+    return entry == nullptr || !entry->uint_value_ ? default_value : entry->uint_value_.value();
+  }
+  static double doubleValue(const Entry* entry, double default_value) {
+    return entry == nullptr || !entry->double_value_ ? default_value
+                                                     : entry->double_value_.value();
+  }
+  static bool booleanValue(const Entry* entry, bool default_value) {
+    return entry == nullptr || !entry->bool_value_.has_value() ? default_value
+                                                               : entry->bool_value_.value();
+  }
+
   const std::vector<OverrideLayerConstPtr> layers_;
   EntryMap values_;
+  // The entries of the registered keys by the index of their handles, resolved on their first
+  // lookup by any thread: each thread resolves the same entry, so the races are benign.
+  const std::unique_ptr<std::atomic<const Entry*>[]> entries_by_handle_;
   Random::RandomGenerator& generator_;
   RuntimeStats& stats_;
 };
@@ -0,0 +1,40 @@
+#include "source/common/runtime/runtime_key_registry.h"
+
+#include <string>
+
+#include "source/common/common/lock_guard.h"
+#include "source/common/common/macros.h"
+#include "source/common/common/thread.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Runtime {
+namespace {
+
+struct Registry {
+  Thread::MutexBasicLockable mutex_;
+  absl::flat_hash_map<std::string, uint32_t> indexes_ ABSL_GUARDED_BY(mutex_);
+};
+
+Registry& keyRegistry() { MUTABLE_CONSTRUCT_ON_FIRST_USE(Registry); }
+
+} // namespace
+
+KeyHandle KeyRegistry::registerKey(absl::string_view key) {
+  Registry& registry = keyRegistry();
+  Thread::LockGuard lock(registry.mutex_);
+  auto it = registry.indexes_.find(key);
+  if (it != registry.indexes_.end()) {
+    return {key, it->second};
+  }
+  if (registry.indexes_.size() >= MaxKeys) {
+    return {key, KeyHandle::Unregistered};
+  }
+  const uint32_t index = registry.indexes_.size();
+  registry.indexes_.emplace(key, index);
+  return {key, index};
+}
+
+} // namespace Runtime
+} // namespace Envoy
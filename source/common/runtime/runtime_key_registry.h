@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/runtime/runtime.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Runtime {
+
+/**
+ * Process wide registry of the runtime keys looked up by handle. Each key gets the next index on
+ * its first registration, and the same index afterwards.
+ */
+class KeyRegistry {
+public:
+  // The keys registered with an index, beyond which the handles are looked up by key.
+  static constexpr uint32_t MaxKeys = 4096;
+
+  /**
+   * @param key supplies the runtime key.
+   * @return KeyHandle the handle of the key. Registering is thread safe, but takes a lock: it is
+   *         meant to be done once, such as when the configuration of the key is loaded.
+   */
+  static KeyHandle registerKey(absl::string_view key);
+};
+
+} // namespace Runtime
+} // namespace Envoy
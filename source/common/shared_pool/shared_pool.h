@@ -7,16 +7,32 @@
 
 #include "envoy/event/dispatcher.h"
 #include "envoy/singleton/instance.h"
+#include "envoy/stats/stats_macros.h"
 
 #include "source/common/common/assert.h"
 #include "source/common/common/non_copyable.h"
 #include "source/common/common/thread_synchronizer.h"
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace SharedPool {
 
+/**
+ * All the stats of a shared pool. @see stats_macros.h
+ */
+#define ALL_SHARED_POOL_STATS(COUNTER, GAUGE)                                                      \
+  COUNTER(deduplicated)                                                                            \
+  GAUGE(objects, NeverImport)
+
+/**
+ * Struct definition for the stats of a shared pool. @see stats_macros.h
+ */
+struct SharedPoolStats {
+  ALL_SHARED_POOL_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
 /**
  * Used to share objects that have the same content.
  * control the life cycle of shared objects by reference counting
@@ -36,8 +52,15 @@ class ObjectSharedPool : public Singleton::Instance,
                          public std::enable_shared_from_this<ObjectSharedPool<T, HashFunc>>,
                          NonCopyable {
 public:
-  ObjectSharedPool(Event::Dispatcher& dispatcher)
-      : thread_id_(std::this_thread::get_id()), dispatcher_(dispatcher) {}
+  /**
+   * @param dispatcher the dispatcher of the thread creating the pool.
+   * @param stats if set, counts the objects obtained from the pool which were shared with previous
+   * callers, and the distinct objects in the pool. Their ratio to the objects in use is the
+   * deduplication achieved.
+   */
+  ObjectSharedPool(Event::Dispatcher& dispatcher,
+                   absl::optional<SharedPoolStats> stats = absl::nullopt)
+      : thread_id_(std::this_thread::get_id()), dispatcher_(dispatcher), stats_(stats) {}
 
   void deleteObject(const size_t hash_key) {
     if (std::this_thread::get_id() == thread_id_) {
@@ -46,6 +69,7 @@ public:
       if (object_pool_.find(hash_key) != object_pool_.end() &&
           object_pool_[hash_key].use_count() == 0) {
         object_pool_.erase(hash_key);
+        updateObjectsGauge();
       }
     } else {
       // Most of the time, the object's destructor occurs in the main thread, but with some
@@ -65,6 +89,9 @@ public:
     if (object_it != object_pool_.end()) {
       auto lock_object = object_it->second.lock();
       if (lock_object) {
+        if (stats_.has_value()) {
+          stats_->deduplicated_.inc();
+        }
         return lock_object;
       }
     }
@@ -84,6 +111,7 @@ public:
       ASSERT(ret.first->second.use_count() == 0);
       ret.first->second = obj_shared;
     }
+    updateObjectsGauge();
     return obj_shared;
   }
 
@@ -100,9 +128,16 @@ public:
   static const char ObjectDeleterEntry[];
 
 private:
+  void updateObjectsGauge() {
+    if (stats_.has_value()) {
+      stats_->objects_.set(object_pool_.size());
+    }
+  }
+
   const std::thread::id thread_id_;
   absl::flat_hash_map<size_t, std::weak_ptr<T>> object_pool_;
   Event::Dispatcher& dispatcher_;
+  absl::optional<SharedPoolStats> stats_;
   Thread::ThreadSynchronizer sync_;
 };
 
@@ -6,11 +6,13 @@
 #include "source/common/common/empty_string.h"
 #include "source/common/common/fmt.h"
 #include "source/common/config/datasource.h"
+#include "source/common/protobuf/utility.h"
 
 namespace Envoy {
 namespace Ssl {
 
 static const std::string INLINE_STRING = "<inline>";
+static constexpr uint64_t DEFAULT_VERIFIED_CERT_CHAIN_CACHE_TTL_MS = 5 * 60 * 1000;
 
 CertificateValidationContextConfigImpl::CertificateValidationContextConfigImpl(
     const envoy::extensions::transport_sockets::tls::v3::CertificateValidationContext& config,
@@ -35,6 +37,9 @@ CertificateValidationContextConfigImpl::CertificateValidationContextConfigImpl(
               ? absl::make_optional<envoy::config::core::v3::TypedExtensionConfig>(
                     config.custom_validator_config())
               : absl::nullopt),
+      verified_cert_chain_cache_max_entries_(config.verified_cert_chain_cache().max_entries()),
+      verified_cert_chain_cache_ttl_(std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(
+          config.verified_cert_chain_cache(), ttl, DEFAULT_VERIFIED_CERT_CHAIN_CACHE_TTL_MS))),
       api_(api) {
   if (ca_cert_.empty() && custom_validator_config_ == absl::nullopt) {
     if (!certificate_revocation_list_.empty()) {
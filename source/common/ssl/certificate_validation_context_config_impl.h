@@ -46,6 +46,13 @@ public:
     return custom_validator_config_;
   }
 
+  uint32_t verifiedCertChainCacheMaxEntries() const override {
+    return verified_cert_chain_cache_max_entries_;
+  }
+  std::chrono::milliseconds verifiedCertChainCacheTtl() const override {
+    return verified_cert_chain_cache_ttl_;
+  }
+
   Api::Api& api() const override { return api_; }
 
 private:
@@ -60,6 +67,8 @@ private:
   const envoy::extensions::transport_sockets::tls::v3::CertificateValidationContext::
       TrustChainVerification trust_chain_verification_;
   const absl::optional<envoy::config::core::v3::TypedExtensionConfig> custom_validator_config_;
+  const uint32_t verified_cert_chain_cache_max_entries_;
+  const std::chrono::milliseconds verified_cert_chain_cache_ttl_;
   Api::Api& api_;
 };
 
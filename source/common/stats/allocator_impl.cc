@@ -1,5 +1,7 @@
 #include "source/common/stats/allocator_impl.h"
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 
 #include "envoy/stats/stats.h"
@@ -15,6 +17,7 @@
 #include "source/common/stats/stat_merger.h"
 #include "source/common/stats/symbol_table_impl.h"
 
+#include "absl/base/optimization.h"
 #include "absl/container/flat_hash_set.h"
 
 namespace Envoy {
@@ -144,6 +147,68 @@ private:
   std::atomic<uint64_t> pending_increment_{0};
 };
 
+// A counter whose value is split over cache line sized shards. Each thread is assigned a shard
+// when it first increments a sharded counter, and always increments the same shard of every
+// sharded counter, so threads on different cores rarely contend. Reads sum the shards.
+class ShardedCounterImpl : public StatsSharedImpl<Counter> {
+public:
+  ShardedCounterImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
+                     const StatNameTagVector& stat_name_tags)
+      : StatsSharedImpl(name, alloc, tag_extracted_name, stat_name_tags) {}
+
+  void removeFromSetLockHeld() ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) override {
+    const size_t count = alloc_.counters_.erase(statName());
+    ASSERT(count == 1);
+  }
+
+  // Stats::Counter
+  void add(uint64_t amount) override {
+    Shard& shard = shards_[threadShard()];
+    shard.value_.fetch_add(amount, std::memory_order_relaxed);
+    shard.pending_increment_.fetch_add(amount, std::memory_order_relaxed);
+    if (!(flags_.load(std::memory_order_relaxed) & Flags::Used)) {
+      flags_ |= Flags::Used;
+    }
+  }
+  void inc() override { add(1); }
+  uint64_t latch() override {
+    uint64_t pending_increment = 0;
+    for (Shard& shard : shards_) {
+      pending_increment += shard.pending_increment_.exchange(0);
+    }
+    return pending_increment;
+  }
+  void reset() override {
+    for (Shard& shard : shards_) {
+      shard.value_ = 0;
+    }
+  }
+  uint64_t value() const override {
+    uint64_t value = 0;
+    for (const Shard& shard : shards_) {
+      value += shard.value_.load(std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+private:
+  static constexpr uint32_t NumShards = 16;
+
+  struct ABSL_CACHELINE_ALIGNED Shard {
+    std::atomic<uint64_t> value_{0};
+    std::atomic<uint64_t> pending_increment_{0};
+  };
+
+  static uint32_t threadShard() {
+    static std::atomic<uint32_t> next_shard{0};
+    static thread_local const uint32_t shard =
+        next_shard.fetch_add(1, std::memory_order_relaxed) % NumShards;
+    return shard;
+  }
+
+  std::array<Shard, NumShards> shards_;
+};
+
 class GaugeImpl : public StatsSharedImpl<Gauge> {
 public:
   GaugeImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
@@ -272,6 +337,21 @@ CounterSharedPtr AllocatorImpl::makeCounter(StatName name, StatName tag_extracte
   return counter;
 }
 
+CounterSharedPtr AllocatorImpl::makeShardedCounter(StatName name, StatName tag_extracted_name,
+                                                   const StatNameTagVector& stat_name_tags) {
+  Thread::LockGuard lock(mutex_);
+  ASSERT(gauges_.find(name) == gauges_.end());
+  ASSERT(text_readouts_.find(name) == text_readouts_.end());
+  auto iter = counters_.find(name);
+  if (iter != counters_.end()) {
+    return CounterSharedPtr(*iter);
+  }
+  auto counter =
+      CounterSharedPtr(new ShardedCounterImpl(name, *this, tag_extracted_name, stat_name_tags));
+  counters_.insert(counter.get());
+  return counter;
+}
+
 GaugeSharedPtr AllocatorImpl::makeGauge(StatName name, StatName tag_extracted_name,
                                         const StatNameTagVector& stat_name_tags,
                                         Gauge::ImportMode import_mode) {
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "envoy/stats/histogram.h"
+#include "envoy/stats/refcount_ptr.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats.h"
+
+#include "source/common/stats/symbol_table_impl.h"
+#include "source/common/stats/utility.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * A placeholder for a metric which is only created in its scope when it is first
+ * written, for structs of stats of which most may never be used. Until then, the
+ * metric reads as zero and is not in the scope, so it is not reported by the admin
+ * interface or the stats sinks. Anything else needing the metric, such as its name,
+ * creates it as well.
+ *
+ * The placeholder is not itself held in a store, so it must outlive every reference
+ * to it, and the scope must outlive the placeholder.
+ */
+template <class BaseClass> class LazyMetricImpl : public BaseClass {
+public:
+  // Metric
+  std::string name() const override { return metric().name(); }
+  StatName statName() const override { return metric().statName(); }
+  TagVector tags() const override { return metric().tags(); }
+  std::string tagExtractedName() const override { return metric().tagExtractedName(); }
+  StatName tagExtractedStatName() const override { return metric().tagExtractedStatName(); }
+  void iterateTagStatNames(const Metric::TagStatNameIterFn& fn) const override {
+    metric().iterateTagStatNames(fn);
+  }
+  bool used() const override {
+    const BaseClass* metric = created();
+    return metric != nullptr && metric->used();
+  }
+  SymbolTable& symbolTable() override { return scope_.symbolTable(); }
+  const SymbolTable& constSymbolTable() const override { return scope_.constSymbolTable(); }
+
+  // RefcountInterface
+  void incRefCount() override { refcount_helper_.incRefCount(); }
+  bool decRefCount() override { return refcount_helper_.decRefCount(); }
+  uint32_t use_count() const override { return refcount_helper_.use_count(); }
+
+protected:
+  LazyMetricImpl(Scope& scope, StatName prefix, StatName name)
+      : scope_(scope), prefix_(prefix), name_(name) {}
+
+  /**
+   * @return the metric if it has been created, or nullptr.
+   */
+  BaseClass* created() const { return metric_.load(std::memory_order_acquire); }
+
+  /**
+   * @return the metric, creating it if need be. This may be called on any thread: threads
+   *         racing to create the metric are all given the same one by the scope.
+   */
+  BaseClass& metric() const {
+    BaseClass* metric = created();
+    if (metric == nullptr) {
+      metric = &create();
+      metric_.store(metric, std::memory_order_release);
+    }
+    return *metric;
+  }
+
+  /**
+   * Creates the metric in scope_.
+   */
+  virtual BaseClass& create() const PURE;
+
+  Scope& scope_;
+  const StatName prefix_;
+  const StatName name_;
+
+private:
+  mutable std::atomic<BaseClass*> metric_{nullptr};
+  RefcountHelper refcount_helper_;
+};
+
+/**
+ * Counter created when it is first incremented.
+ */
+class LazyCounterImpl : public LazyMetricImpl<Counter> {
+public:
+  LazyCounterImpl(Scope& scope, StatName prefix, StatName name)
+      : LazyMetricImpl<Counter>(scope, prefix, name) {}
+
+  // Counter
+  void add(uint64_t amount) override {
+    if (amount != 0) {
+      metric().add(amount);
+    }
+  }
+  void inc() override { metric().inc(); }
+  uint64_t latch() override {
+    Counter* counter = created();
+    return counter == nullptr ? 0 : counter->latch();
+  }
+  void reset() override {
+    Counter* counter = created();
+    if (counter != nullptr) {
+      counter->reset();
+    }
+  }
+  uint64_t value() const override {
+    const Counter* counter = created();
+    return counter == nullptr ? 0 : counter->value();
+  }
+
+protected:
+  Counter& create() const override {
+    return Utility::counterFromStatNames(scope_, {prefix_, name_});
+  }
+};
+
+/**
+ * Gauge created when it is first changed from zero.
+ */
+class LazyGaugeImpl : public LazyMetricImpl<Gauge> {
+public:
+  LazyGaugeImpl(Scope& scope, StatName prefix, StatName name, Gauge::ImportMode import_mode)
+      : LazyMetricImpl<Gauge>(scope, prefix, name), import_mode_(import_mode) {}
+
+  // Gauge
+  void add(uint64_t amount) override {
+    if (amount != 0) {
+      metric().add(amount);
+    }
+  }
+  void dec() override { metric().dec(); }
+  void inc() override { metric().inc(); }
+  void set(uint64_t value) override {
+    if (value != 0 || created() != nullptr) {
+      metric().set(value);
+    }
+  }
+  void sub(uint64_t amount) override {
+    if (amount != 0) {
+      metric().sub(amount);
+    }
+  }
+  uint64_t value() const override {
+    const Gauge* gauge = created();
+    return gauge == nullptr ? 0 : gauge->value();
+  }
+  void setParentValue(uint64_t parent_value) override { metric().setParentValue(parent_value); }
+  ImportMode importMode() const override {
+    const Gauge* gauge = created();
+    return gauge == nullptr ? import_mode_ : gauge->importMode();
+  }
+  void mergeImportMode(ImportMode import_mode) override { metric().mergeImportMode(import_mode); }
+
+protected:
+  Gauge& create() const override {
+    return Utility::gaugeFromStatNames(scope_, {prefix_, name_}, import_mode_);
+  }
+
+private:
+  const ImportMode import_mode_;
+};
+
+/**
+ * Histogram created when a value is first recorded.
+ */
+class LazyHistogramImpl : public LazyMetricImpl<Histogram> {
+public:
+  LazyHistogramImpl(Scope& scope, StatName prefix, StatName name, Histogram::Unit unit)
+      : LazyMetricImpl<Histogram>(scope, prefix, name), unit_(unit) {}
+
+  // Histogram
+  Unit unit() const override { return unit_; }
+  void recordValue(uint64_t value) override { metric().recordValue(value); }
+
+protected:
+  Histogram& create() const override {
+    return Utility::histogramFromStatNames(scope_, {prefix_, name_}, unit_);
+  }
+
+private:
+  const Unit unit_;
+};
+
+} // namespace Stats
+} // namespace Envoy
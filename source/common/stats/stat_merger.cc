@@ -5,7 +5,8 @@
 namespace Envoy {
 namespace Stats {
 
-StatMerger::StatMerger(Store& target_store) : temp_scope_(target_store.createScope("")) {}
+StatMerger::StatMerger(Store& target_store)
+    : parent_symbol_pool_(target_store.symbolTable()), temp_scope_(target_store.createScope("")) {}
 
 StatMerger::~StatMerger() {
   // By the time a parent exits, all its contributions to accumulated gauges
@@ -92,8 +93,8 @@ void StatMerger::mergeGauges(const Protobuf::Map<std::string, uint64_t>& gauges,
     //
     // 1. Child thinks gauge is Accumulate : data is combined in
     //    gauge_ref.add() below.
-    // 2. Child thinks gauge is NeverImport: we skip this loop entry via
-    //    'continue'.
+    // 2. Child thinks gauge is NeverImport: we skip this loop entry in
+    //    mergeGauge().
     // 3. Child has not yet initialized gauge yet -- this merge is the
     //    first time the child learns of the gauge. It's possible the child
     //    will think the gauge is NeverImport due to a code change. But for
@@ -108,44 +109,123 @@ void StatMerger::mergeGauges(const Protobuf::Map<std::string, uint64_t>& gauges,
     //     retained.
 
     StatMerger::DynamicContext dynamic_context(temp_scope_->symbolTable());
-    StatName stat_name = dynamic_context.makeDynamicStatName(gauge.first, dynamic_map);
-    GaugeOptConstRef gauge_opt = temp_scope_->findGauge(stat_name);
-
-    Gauge::ImportMode import_mode = Gauge::ImportMode::Uninitialized;
-    if (gauge_opt) {
-      import_mode = gauge_opt->get().importMode();
-      if (import_mode == Gauge::ImportMode::NeverImport) {
-        continue;
-      }
-    }
+    mergeGauge(dynamic_context.makeDynamicStatName(gauge.first, dynamic_map), gauge.second);
+  }
+}
 
-    // TODO(snowp): Propagate tag values during hot restarts.
-    auto& gauge_ref = temp_scope_->gaugeFromStatName(stat_name, import_mode);
-    if (gauge_ref.importMode() == Gauge::ImportMode::NeverImport) {
-      // On the first iteration through the loop, the gauge will not be loaded into the scope
-      // cache even though it might exist in another scope. Thus, we need to check again for
-      // the import status to see if we should skip this gauge.
-      //
-      // TODO(mattklein123): There is a race condition here. It's technically possible that
-      // between the time we created this stat, the stat might be created by the child as a
-      // never import stat, making the below math invalid. A follow up solution is to take the
-      // store lock starting from gaugeFromStatName() to the end of this function, but this will
-      // require adding some type of mergeGauge() function to the scope and dealing with recursive
-      // lock acquisition, etc. so we will leave this as a follow up. This race should be incredibly
-      // rare.
-      continue;
+Gauge* StatMerger::mergeGauge(StatName stat_name, uint64_t value) {
+  GaugeOptConstRef gauge_opt = temp_scope_->findGauge(stat_name);
+
+  Gauge::ImportMode import_mode = Gauge::ImportMode::Uninitialized;
+  if (gauge_opt) {
+    import_mode = gauge_opt->get().importMode();
+    if (import_mode == Gauge::ImportMode::NeverImport) {
+      return nullptr;
     }
+  }
 
-    const uint64_t new_parent_value = gauge.second;
-    parent_gauges_.insert(gauge_ref.statName());
-    gauge_ref.setParentValue(new_parent_value);
+  // TODO(snowp): Propagate tag values during hot restarts.
+  auto& gauge_ref = temp_scope_->gaugeFromStatName(stat_name, import_mode);
+  if (gauge_ref.importMode() == Gauge::ImportMode::NeverImport) {
+    // On the first iteration through the loop, the gauge will not be loaded into the scope
+    // cache even though it might exist in another scope. Thus, we need to check again for
+    // the import status to see if we should skip this gauge.
+    //
+    // TODO(mattklein123): There is a race condition here. It's technically possible that
+    // between the time we created this stat, the stat might be created by the child as a
+    // never import stat, making the below math invalid. A follow up solution is to take the
+    // store lock starting from gaugeFromStatName() to the end of this function, but this will
+    // require adding some type of mergeGauge() function to the scope and dealing with recursive
+    // lock acquisition, etc. so we will leave this as a follow up. This race should be incredibly
+    // rare.
+    return nullptr;
   }
+
+  parent_gauges_.insert(gauge_ref.statName());
+  gauge_ref.setParentValue(value);
+  return &gauge_ref;
 }
 
 void StatMerger::retainParentGaugeValue(Stats::StatName gauge_name) {
   parent_gauges_.erase(gauge_name);
 }
 
+void StatMerger::setParentSymbol(uint32_t symbol, absl::string_view token) {
+  auto result = parent_symbols_.insert_or_assign(symbol, parent_symbol_pool_.add(token));
+  if (!result.second) {
+    // The names encoded with the symbol now decode differently.
+    encoded_counters_.clear();
+    encoded_gauges_.clear();
+  }
+}
+
+StatName StatMerger::decodeParentName(absl::string_view encoded_name,
+                                      StatNameDynamicPool& dynamic_pool,
+                                      SymbolTable::StoragePtr& storage) {
+  StatNameVec segments;
+  bool known_symbols = true;
+  SymbolTableImpl::Encoding::decodeTokens(
+      reinterpret_cast<const uint8_t*>(encoded_name.data()), encoded_name.size(),
+      [this, &segments, &known_symbols](Symbol symbol) {
+        auto it = parent_symbols_.find(symbol);
+        if (it == parent_symbols_.end()) {
+          known_symbols = false;
+          return;
+        }
+        segments.push_back(it->second);
+      },
+      [&segments, &dynamic_pool](absl::string_view literal) {
+        segments.push_back(dynamic_pool.add(literal));
+      });
+  if (!known_symbols || segments.empty()) {
+    return {};
+  }
+  storage = temp_scope_->symbolTable().join(segments);
+  return StatName(storage.get());
+}
+
+void StatMerger::mergeEncodedCounter(absl::string_view encoded_name, uint64_t delta) {
+  auto it = encoded_counters_.find(encoded_name);
+  if (it != encoded_counters_.end()) {
+    it->second->add(delta);
+    return;
+  }
+
+  StatNameDynamicPool dynamic_pool(temp_scope_->symbolTable());
+  SymbolTable::StoragePtr storage;
+  const StatName stat_name = decodeParentName(encoded_name, dynamic_pool, storage);
+  if (stat_name.empty()) {
+    ENVOY_BUG(false, "hot restart parent sent a counter with an unknown symbol");
+    return;
+  }
+  Counter& counter = temp_scope_->counterFromStatName(stat_name);
+  encoded_counters_.emplace(std::string(encoded_name), &counter);
+  counter.add(delta);
+}
+
+void StatMerger::mergeEncodedGauge(absl::string_view encoded_name, uint64_t value) {
+  auto it = encoded_gauges_.find(encoded_name);
+  if (it != encoded_gauges_.end()) {
+    // The gauge may have been initialized as NeverImport since it was first merged.
+    if (it->second->importMode() != Gauge::ImportMode::NeverImport) {
+      it->second->setParentValue(value);
+    }
+    return;
+  }
+
+  StatNameDynamicPool dynamic_pool(temp_scope_->symbolTable());
+  SymbolTable::StoragePtr storage;
+  const StatName stat_name = decodeParentName(encoded_name, dynamic_pool, storage);
+  if (stat_name.empty()) {
+    ENVOY_BUG(false, "hot restart parent sent a gauge with an unknown symbol");
+    return;
+  }
+  Gauge* gauge = mergeGauge(stat_name, value);
+  if (gauge != nullptr) {
+    encoded_gauges_.emplace(std::string(encoded_name), gauge);
+  }
+}
+
 void StatMerger::mergeStats(const Protobuf::Map<std::string, uint64_t>& counter_deltas,
                             const Protobuf::Map<std::string, uint64_t>& gauges,
                             const DynamicsMap& dynamics) {
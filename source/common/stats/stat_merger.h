@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 #include "envoy/stats/store.h"
 
 #include "source/common/protobuf/protobuf.h"
@@ -71,13 +73,51 @@ public:
    */
   void retainParentGaugeValue(Stats::StatName gauge_name);
 
+  /**
+   * Maps a symbol of the parent's symbol table to its token, for the merging of the stats whose
+   * names are encoded with the parent's symbols. Mapping a symbol again means that the parent
+   * reused it for another token.
+   *
+   * @param symbol the symbol of the parent.
+   * @param token the token the symbol decodes to.
+   */
+  void setParentSymbol(uint32_t symbol, absl::string_view token);
+
+  /**
+   * Merges the change of a counter from the parent, like mergeStats.
+   *
+   * @param encoded_name the data of the counter's StatName, encoded with the parent's symbols.
+   * @param delta the amount added to the counter since it was last merged.
+   */
+  void mergeEncodedCounter(absl::string_view encoded_name, uint64_t delta);
+
+  /**
+   * Merges the value of a gauge from the parent, like mergeStats.
+   *
+   * @param encoded_name the data of the gauge's StatName, encoded with the parent's symbols.
+   * @param value the value of the gauge in the parent.
+   */
+  void mergeEncodedGauge(absl::string_view encoded_name, uint64_t value);
+
 private:
   void mergeCounters(const Protobuf::Map<std::string, uint64_t>& counter_deltas,
                      const DynamicsMap& dynamics_map);
   void mergeGauges(const Protobuf::Map<std::string, uint64_t>& gauges,
                    const DynamicsMap& dynamics_map);
+  // Returns the gauge the parent's value was merged into, or nullptr if it is not imported.
+  Gauge* mergeGauge(StatName stat_name, uint64_t value);
+  // Decodes a name encoded with the parent's symbols. Returns an empty StatName if one of the
+  // symbols is unknown.
+  StatName decodeParentName(absl::string_view encoded_name, StatNameDynamicPool& dynamic_pool,
+                            SymbolTable::StoragePtr& storage);
 
   StatNameHashSet parent_gauges_;
+  StatNamePool parent_symbol_pool_;
+  absl::flat_hash_map<uint32_t, StatName> parent_symbols_;
+  // The stats already merged, keyed by their name encoded with the parent's symbols, so that
+  // their names only have to be decoded once. Cleared when the parent reuses a symbol.
+  absl::flat_hash_map<std::string, Counter*> encoded_counters_;
+  absl::flat_hash_map<std::string, Gauge*> encoded_gauges_;
   // A stats Scope for our in-the-merging-process counters to live in. Scopes conceptually hold
   // shared_ptrs to the stats that live in them, with the question of which stats are living in a
   // given scope determined by which stat names have been accessed via that scope. E.g., if you
@@ -21,6 +21,10 @@ namespace Stats {
 class StatsMatcherImpl : public StatsMatcher {
 public:
   StatsMatcherImpl(const envoy::config::metrics::v3::StatsConfig& config,
+                   SymbolTable& symbol_table)
+      : StatsMatcherImpl(config.stats_matcher(), symbol_table) {}
+
+  StatsMatcherImpl(const envoy::config::metrics::v3::StatsMatcher& config,
                    SymbolTable& symbol_table);
 
   // Default constructor simply allows everything.
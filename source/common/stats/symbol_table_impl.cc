@@ -219,9 +219,85 @@ void SymbolTableImpl::Encoding::appendToMemBlock(StatName stat_name,
   }
 }
 
+namespace {
+
+// Ids are never reused, so a thread's cache can never be mistaken as belonging
+// to a table allocated after its own was destroyed.
+std::atomic<uint64_t> next_table_id{1};
+
+} // namespace
+
+bool SymbolTableImpl::SharedSymbol::tryIncRefCount(uint32_t generation) {
+  uint64_t state = state_.load(std::memory_order_relaxed);
+  do {
+    if ((state >> 32) != generation || (state & RefCountMask) == 0) {
+      return false;
+    }
+  } while (!state_.compare_exchange_weak(state, state + 1, std::memory_order_relaxed));
+  return true;
+}
+
+bool SymbolTableImpl::SharedSymbol::decRefCount() {
+  uint64_t state = state_.load(std::memory_order_relaxed);
+  uint64_t next;
+  do {
+    ASSERT((state & RefCountMask) != 0);
+    next = (state & RefCountMask) == 1 ? ((state >> 32) + 1) << 32 : state - 1;
+  } while (!state_.compare_exchange_weak(state, next, std::memory_order_relaxed));
+  return (next & RefCountMask) == 0;
+}
+
+// Maps the tokens recently encoded on one thread to their symbols, along with
+// the generation of each symbol when it was cached. A reference can be added
+// through a cached entry just while the symbol is still in that generation,
+// so a stale entry is detected rather than resurrecting a freed symbol.
+class SymbolTableImpl::ThreadCache {
+public:
+  void reset(uint64_t table_id) {
+    if (table_id_ != table_id) {
+      entries_.clear();
+      table_id_ = table_id;
+    }
+  }
+
+  bool tryIncRefCount(absl::string_view token, Symbol& symbol) {
+    auto iter = entries_.find(token);
+    if (iter == entries_.end() ||
+        !iter->second.shared_symbol_->tryIncRefCount(iter->second.generation_)) {
+      return false;
+    }
+    symbol = iter->second.shared_symbol_->symbol_;
+    return true;
+  }
+
+  // Must be called with the table's lock held, so that the generation is stable.
+  void insert(absl::string_view token, SharedSymbol& shared_symbol, uint32_t max_tokens) {
+    const Entry entry{&shared_symbol, shared_symbol.generation()};
+    auto iter = entries_.find(token);
+    if (iter != entries_.end()) {
+      iter->second = entry;
+      return;
+    }
+    if (entries_.size() >= max_tokens) {
+      entries_.clear();
+    }
+    entries_.emplace(std::string(token), entry);
+  }
+
+private:
+  struct Entry {
+    SharedSymbol* shared_symbol_;
+    uint32_t generation_;
+  };
+
+  uint64_t table_id_{0};
+  absl::flat_hash_map<std::string, Entry> entries_;
+};
+
 SymbolTableImpl::SymbolTableImpl()
     // Have to be explicitly initialized, if we want to use the ABSL_GUARDED_BY macro.
-    : next_symbol_(FirstValidSymbol), monotonic_counter_(FirstValidSymbol) {}
+    : next_symbol_(FirstValidSymbol), monotonic_counter_(FirstValidSymbol),
+      id_(next_table_id.fetch_add(1, std::memory_order_relaxed)) {}
 
 SymbolTableImpl::~SymbolTableImpl() {
   // To avoid leaks into the symbol table, we expect all StatNames to be freed.
@@ -245,17 +321,35 @@ void SymbolTableImpl::addTokensToEncoding(const absl::string_view name, Encoding
   std::vector<Symbol> symbols;
   symbols.reserve(tokens.size());
 
-  // Now take the lock and populate the Symbol objects, which involves bumping
-  // ref-counts in this.
-  {
+  // With a thread cache, bump the ref-counts of the leading tokens' symbols
+  // without the lock, stopping at the first token which is not cached.
+  ThreadCache* cache = nullptr;
+  const uint32_t cache_capacity = thread_cache_capacity_.load(std::memory_order_relaxed);
+  if (cache_capacity > 0 && !tracking_recent_lookups_.load(std::memory_order_relaxed)) {
+    cache = &threadCache();
+    Symbol symbol;
+    while (symbols.size() < tokens.size() && cache->tryIncRefCount(tokens[symbols.size()], symbol)) {
+      symbols.push_back(symbol);
+    }
+  }
+
+  // Now take the lock and populate the remaining Symbol objects, which involves
+  // bumping ref-counts in this.
+  if (symbols.size() < tokens.size()) {
     Thread::LockGuard lock(lock_);
     recent_lookups_.lookup(name);
-    for (auto& token : tokens) {
+    for (size_t i = symbols.size(); i < tokens.size(); ++i) {
       // TODO(jmarantz): consider using StatNameDynamicStorage for tokens with
       // length below some threshold, say 4 bytes. It might be preferable not to
       // reserve Symbols for every 3 digit number found (for example) in ipv4
       // addresses.
-      symbols.push_back(toSymbol(token));
+      if (cache != nullptr) {
+        SharedSymbol& shared_symbol = toSharedSymbol(tokens[i]);
+        cache->insert(tokens[i], shared_symbol, cache_capacity);
+        symbols.push_back(shared_symbol.symbol_);
+      } else {
+        symbols.push_back(toSymbol(tokens[i]));
+      }
     }
   }
 
@@ -291,7 +385,7 @@ void SymbolTableImpl::incRefCount(const StatName& stat_name) {
            "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
            "debugging-symbol-table-assertions");
 
-    ++encode_search->second.ref_count_;
+    encode_search->second->state_.fetch_add(1, std::memory_order_relaxed);
   }
 }
 
@@ -310,10 +404,10 @@ void SymbolTableImpl::free(const StatName& stat_name) {
     // If that was the last remaining client usage of the symbol, erase the
     // current mappings and add the now-unused symbol to the reuse pool.
     //
-    // The "if (--EXPR.ref_count_)" pattern speeds up BM_CreateRace by 20% in
-    // symbol_table_speed_test.cc, relative to breaking out the decrement into a
-    // separate step, likely due to the non-trivial dereferences in EXPR.
-    if (--encode_search->second.ref_count_ == 0) {
+    // The generation of the symbol is advanced along with dropping the last
+    // reference, so that thread caches cannot add references through stale
+    // entries hereafter.
+    if (encode_search->second->decRefCount()) {
       decode_map_.erase(decode_search);
       encode_map_.erase(encode_search);
       pool_.push(symbol);
@@ -377,9 +471,27 @@ DynamicSpans SymbolTableImpl::getDynamicSpans(StatName stat_name) const {
   return dynamic_spans;
 }
 
+void SymbolTableImpl::iterateSymbols(const SymbolFn& fn) const {
+  Thread::LockGuard lock(lock_);
+  for (const auto& p : decode_map_) {
+    fn(p.first, p.second->toStringView());
+  }
+}
+
 void SymbolTableImpl::setRecentLookupCapacity(uint64_t capacity) {
   Thread::LockGuard lock(lock_);
   recent_lookups_.setCapacity(capacity);
+  tracking_recent_lookups_.store(capacity > 0, std::memory_order_relaxed);
+}
+
+void SymbolTableImpl::setThreadCacheCapacity(uint32_t max_tokens) {
+  thread_cache_capacity_.store(max_tokens, std::memory_order_relaxed);
+}
+
+SymbolTableImpl::ThreadCache& SymbolTableImpl::threadCache() {
+  static thread_local ThreadCache cache;
+  cache.reset(id_);
+  return cache;
 }
 
 void SymbolTableImpl::clearRecentLookups() {
@@ -398,30 +510,42 @@ StatNameSetPtr SymbolTableImpl::makeSet(absl::string_view name) {
   return stat_name_set;
 }
 
-Symbol SymbolTableImpl::toSymbol(absl::string_view sv) {
-  Symbol result;
+Symbol SymbolTableImpl::toSymbol(absl::string_view sv) { return toSharedSymbol(sv).symbol_; }
+
+SymbolTableImpl::SharedSymbol& SymbolTableImpl::toSharedSymbol(absl::string_view sv) {
   auto encode_find = encode_map_.find(sv);
-  // If the string segment doesn't already exist,
-  if (encode_find == encode_map_.end()) {
-    // We create the actual string, place it in the decode_map_, and then insert
-    // a string_view pointing to it in the encode_map_. This allows us to only
-    // store the string once. We use unique_ptr so copies are not made as
-    // flat_hash_map moves values around.
-    InlineStringPtr str = InlineString::create(sv);
-    auto encode_insert = encode_map_.insert({str->toStringView(), SharedSymbol(next_symbol_)});
-    ASSERT(encode_insert.second);
-    auto decode_insert = decode_map_.insert({next_symbol_, std::move(str)});
-    ASSERT(decode_insert.second);
-
-    result = next_symbol_;
-    newSymbol();
+  // If the string segment already exists, up the refcount at that location.
+  if (encode_find != encode_map_.end()) {
+    encode_find->second->state_.fetch_add(1, std::memory_order_relaxed);
+    return *encode_find->second;
+  }
+
+  // Otherwise we use the holder for next_symbol_, allocating it if the symbol
+  // was not taken from the reuse pool, in which case it is the next one.
+  const size_t index = next_symbol_ - FirstValidSymbol;
+  ASSERT(index <= shared_symbols_.size());
+  if (index == shared_symbols_.size()) {
+    shared_symbols_.push_back(std::make_unique<SharedSymbol>(next_symbol_));
   } else {
-    // If the insertion didn't take place, return the actual value at that location and up the
-    // refcount at that location
-    result = encode_find->second.symbol_;
-    ++(encode_find->second.ref_count_);
+    ASSERT(shared_symbols_[index]->refCount() == 0);
+    shared_symbols_[index]->state_.store(
+        (static_cast<uint64_t>(shared_symbols_[index]->generation()) << 32) | 1,
+        std::memory_order_relaxed);
   }
-  return result;
+  SharedSymbol& shared_symbol = *shared_symbols_[index];
+
+  // We create the actual string, place it in the decode_map_, and then insert
+  // a string_view pointing to it in the encode_map_. This allows us to only
+  // store the string once. We use unique_ptr so copies are not made as
+  // flat_hash_map moves values around.
+  InlineStringPtr str = InlineString::create(sv);
+  auto encode_insert = encode_map_.insert({str->toStringView(), &shared_symbol});
+  ASSERT(encode_insert.second);
+  auto decode_insert = decode_map_.insert({next_symbol_, std::move(str)});
+  ASSERT(decode_insert.second);
+
+  newSymbol();
+  return shared_symbol;
 }
 
 absl::string_view SymbolTableImpl::fromSymbol(const Symbol symbol) const
@@ -469,8 +593,8 @@ void SymbolTableImpl::debugPrint() const {
   std::sort(symbols.begin(), symbols.end());
   for (Symbol symbol : symbols) {
     const InlineString& token = *decode_map_.find(symbol)->second;
-    const SharedSymbol& shared_symbol = encode_map_.find(token.toStringView())->second;
-    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(), shared_symbol.ref_count_);
+    const SharedSymbol& shared_symbol = *encode_map_.find(token.toStringView())->second;
+    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(), shared_symbol.refCount());
   }
 }
 #endif
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <memory>
 #include <stack>
@@ -197,17 +198,64 @@ public:
   void setRecentLookupCapacity(uint64_t capacity) override;
   uint64_t recentLookupCapacity() const override;
   DynamicSpans getDynamicSpans(StatName stat_name) const override;
+  void iterateSymbols(const SymbolFn& fn) const override;
+
+  /**
+   * Enables a per-thread cache of the symbols for tokens encoded on that
+   * thread, so that encoding a name whose tokens are all already interned
+   * does not take lock_. The cache holds no references, so cached symbols are
+   * freed as usual when the last StatName using them is freed. Each thread
+   * caches the tokens of a single table, and drops its cache when the number
+   * of tokens reaches max_tokens, or when it encodes into another table.
+   *
+   * The cache is not used while recent lookups are being tracked, as every
+   * lookup must then be recorded under lock_.
+   *
+   * @param max_tokens the number of tokens each thread may cache, or 0 to
+   *        disable the cache.
+   */
+  void setThreadCacheCapacity(uint32_t max_tokens);
+
+  // A per-thread cache capacity suited to a process's stat names.
+  static constexpr uint32_t DefaultThreadCacheCapacity = 4096;
 
 private:
   friend class StatName;
   friend class StatNameTest;
   friend class StatNameDeathTest;
 
+  class ThreadCache;
+
+  // Holds the ref count of a symbol. There is one per symbol ever allocated,
+  // reused with the symbol from pool_ rather than freed, so that a ThreadCache
+  // can keep a pointer to it without holding a reference. state_ holds the
+  // ref count in its low 32 bits and a generation in its high 32 bits, which
+  // is advanced whenever the ref count drops to zero, so that a cached
+  // generation no longer matches once the symbol has been freed.
   struct SharedSymbol {
-    SharedSymbol(Symbol symbol) : symbol_(symbol), ref_count_(1) {}
+    static constexpr uint64_t RefCountMask = 0xffffffff;
 
-    Symbol symbol_;
-    uint32_t ref_count_;
+    explicit SharedSymbol(Symbol symbol) : symbol_(symbol), state_(1) {}
+
+    uint32_t refCount() const { return state_.load(std::memory_order_relaxed) & RefCountMask; }
+    uint32_t generation() const { return state_.load(std::memory_order_relaxed) >> 32; }
+
+    /**
+     * Adds a reference if the symbol is still in use in the given generation.
+     * This may be called without lock_.
+     * @return whether the reference was added.
+     */
+    bool tryIncRefCount(uint32_t generation);
+
+    /**
+     * Drops a reference, advancing the generation if it was the last. Must be
+     * called with lock_ held.
+     * @return whether that was the last reference.
+     */
+    bool decRefCount();
+
+    const Symbol symbol_;
+    std::atomic<uint64_t> state_;
   };
 
   // This must be held during both encode() and free().
@@ -236,6 +284,15 @@ private:
    */
   Symbol toSymbol(absl::string_view sv) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  /**
+   * Like toSymbol(), but returning the symbol's ref count holder, for
+   * populating a ThreadCache.
+   *
+   * @param sv the individual string to be encoded as a symbol.
+   * @return SharedSymbol& the symbol and its ref count.
+   */
+  SharedSymbol& toSharedSymbol(absl::string_view sv) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   /**
    * Convenience function for decode(), decoding one symbol at a time.
    *
@@ -258,6 +315,12 @@ private:
    */
   void addTokensToEncoding(absl::string_view name, Encoding& encoding);
 
+  /**
+   * @return the calling thread's cache, emptied first if it was last used for
+   *         another table.
+   */
+  ThreadCache& threadCache();
+
   Symbol monotonicCounter() {
     Thread::LockGuard lock(lock_);
     return monotonic_counter_;
@@ -273,7 +336,7 @@ private:
   // Bitmap implementation.
   // The encode map stores both the symbol and the ref count of that symbol.
   // Using absl::string_view lets us only store the complete string once, in the decode map.
-  using EncodeMap = absl::flat_hash_map<absl::string_view, SharedSymbol>;
+  using EncodeMap = absl::flat_hash_map<absl::string_view, SharedSymbol*>;
   using DecodeMap = absl::flat_hash_map<Symbol, InlineStringPtr>;
   EncodeMap encode_map_ ABSL_GUARDED_BY(lock_);
   DecodeMap decode_map_ ABSL_GUARDED_BY(lock_);
@@ -283,6 +346,16 @@ private:
   // using an Envoy::IntervalSet.
   std::stack<Symbol> pool_ ABSL_GUARDED_BY(lock_);
   RecentLookups recent_lookups_ ABSL_GUARDED_BY(lock_);
+
+  // The ref count holders of every symbol allocated so far, indexed by
+  // symbol - 1. These live as long as the table.
+  std::vector<std::unique_ptr<SharedSymbol>> shared_symbols_ ABSL_GUARDED_BY(lock_);
+
+  // Distinguishes this table from any other table, including one later
+  // allocated at the same address, in the per-thread caches.
+  const uint64_t id_;
+  std::atomic<uint32_t> thread_cache_capacity_{0};
+  std::atomic<bool> tracking_recent_lookups_{false};
 };
 
 // Base class for holding the backing-storing for a StatName. The two derived
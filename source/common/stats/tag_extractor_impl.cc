@@ -1,5 +1,6 @@
 #include "source/common/stats/tag_extractor_impl.h"
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 
@@ -10,6 +11,7 @@
 #include "source/common/common/perf_annotation.h"
 #include "source/common/common/regex.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_join.h"
@@ -288,5 +290,88 @@ bool TagExtractorTokensImpl::searchTags(const std::vector<absl::string_view>& in
   return pattern_index == tokens_.size() && input_index == input_tokens.size();
 }
 
+// A node is reached by matching the pattern tokens on the path to it from the
+// root. "*" and "$" both match any single token, and lead to any_token_. "**"
+// matches zero or more tokens, so any_tokens_ is active whenever its parent is,
+// and stays active as each further token is consumed.
+struct TagExtractorTokensTrie::Node {
+  absl::flat_hash_map<std::string, std::unique_ptr<Node>> literals_;
+  std::unique_ptr<Node> any_token_;
+  std::unique_ptr<Node> any_tokens_;
+  bool loops_{false};
+  std::vector<uint32_t> ids_;
+};
+
+TagExtractorTokensTrie::TagExtractorTokensTrie() : root_(std::make_unique<Node>()) {}
+
+TagExtractorTokensTrie::~TagExtractorTokensTrie() = default;
+
+void TagExtractorTokensTrie::add(absl::string_view tokens, uint32_t id) {
+  const std::vector<absl::string_view> pattern = absl::StrSplit(tokens, '.');
+  Node* node = root_.get();
+  for (uint32_t i = 0; i < pattern.size(); ++i) {
+    const absl::string_view token = pattern[i];
+    std::unique_ptr<Node>* next;
+    if (token == "**") {
+      // As TagExtractorTokensImpl::searchTags requires at least one token to match a
+      // trailing "**", that is treated as "*.**".
+      if (i == pattern.size() - 1) {
+        next = &node->any_token_;
+        if (*next == nullptr) {
+          *next = std::make_unique<Node>();
+        }
+        node = next->get();
+      }
+      next = &node->any_tokens_;
+    } else if (token == "*" || token == "$") {
+      next = &node->any_token_;
+    } else {
+      next = &node->literals_[std::string(token)];
+    }
+    if (*next == nullptr) {
+      *next = std::make_unique<Node>();
+      (*next)->loops_ = token == "**";
+    }
+    node = next->get();
+  }
+  node->ids_.push_back(id);
+}
+
+void TagExtractorTokensTrie::addClosure(const Node* node, std::vector<const Node*>& states) {
+  for (; node != nullptr; node = node->any_tokens_.get()) {
+    if (std::find(states.begin(), states.end(), node) == states.end()) {
+      states.push_back(node);
+    }
+  }
+}
+
+void TagExtractorTokensTrie::findMatches(const std::vector<absl::string_view>& input_tokens,
+                                         std::vector<bool>& matched) const {
+  std::vector<const Node*> states, next_states;
+  addClosure(root_.get(), states);
+  for (const absl::string_view token : input_tokens) {
+    next_states.clear();
+    for (const Node* node : states) {
+      if (node->loops_) {
+        addClosure(node, next_states);
+      }
+      const auto iter = node->literals_.find(token);
+      if (iter != node->literals_.end()) {
+        addClosure(iter->second.get(), next_states);
+      }
+      addClosure(node->any_token_.get(), next_states);
+    }
+    if (next_states.empty()) {
+      return;
+    }
+    states.swap(next_states);
+  }
+  for (const Node* node : states) {
+    for (const uint32_t id : node->ids_) {
+      matched[id] = true;
+    }
+  }
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <regex>
 #include <string>
+#include <vector>
 
 #ifdef ENVOY_PERF_ANNOTATION
 #include <fmt/core.h>
@@ -161,5 +163,42 @@ private:
   const uint32_t match_index_;
 };
 
+/**
+ * Matches a stat name against a set of token patterns, with the same syntax
+ * as TagExtractorTokensImpl, by walking a trie merging all of the patterns
+ * over the name's tokens once, rather than searching each pattern in turn.
+ * This only determines which patterns match: the tags are still extracted by
+ * the matching TagExtractorTokensImpl instances.
+ */
+class TagExtractorTokensTrie {
+public:
+  TagExtractorTokensTrie();
+  ~TagExtractorTokensTrie();
+
+  /**
+   * Adds a pattern to the trie.
+   * @param tokens the dot-separated pattern.
+   * @param id identifies the pattern in the results of findMatches(), and must
+   *        be less than the size of the vector passed to it.
+   */
+  void add(absl::string_view tokens, uint32_t id);
+
+  /**
+   * Sets matched[id] for the id of every pattern matching input_tokens.
+   * Entries for the other patterns are left as they are.
+   * @param input_tokens the dot-separated tokens of the stat name.
+   * @param matched the match flags, indexed by pattern id.
+   */
+  void findMatches(const std::vector<absl::string_view>& input_tokens,
+                   std::vector<bool>& matched) const;
+
+private:
+  struct Node;
+
+  static void addClosure(const Node* node, std::vector<const Node*>& states);
+
+  std::unique_ptr<Node> root_;
+};
+
 } // namespace Stats
 } // namespace Envoy
@@ -11,7 +11,9 @@
 namespace Envoy {
 namespace Stats {
 
-TagProducerImpl::TagProducerImpl(const envoy::config::metrics::v3::StatsConfig& config) {
+TagProducerImpl::TagProducerImpl(const envoy::config::metrics::v3::StatsConfig& config,
+                                 bool compile_extractors)
+    : compile_extractors_(compile_extractors) {
   // To check name conflict.
   reserveResources(config);
   absl::node_hash_set<std::string> names = addDefaultExtractors(config);
@@ -34,55 +36,121 @@ TagProducerImpl::TagProducerImpl(const envoy::config::metrics::v3::StatsConfig&
               "No regex specified for tag specifier and no default regex for name: '{}'", name));
         }
       } else {
-        addExtractor(TagExtractorImplBase::createTagExtractor(name, tag_specifier.regex()));
+        addRegexExtractor(name, tag_specifier.regex());
       }
     } else if (tag_specifier.tag_value_case() ==
                envoy::config::metrics::v3::TagSpecifier::TagValueCase::kFixedValue) {
       default_tags_.emplace_back(Tag{name, tag_specifier.fixed_value()});
     }
   }
+  compileRegexes();
 }
 
 int TagProducerImpl::addExtractorsMatching(absl::string_view name) {
   int num_found = 0;
   for (const auto& desc : Config::TagNames::get().descriptorVec()) {
     if (desc.name_ == name) {
-      addExtractor(TagExtractorImplBase::createTagExtractor(desc.name_, desc.regex_, desc.substr_,
-                                                            desc.re_type_));
+      addRegexExtractor(desc.name_, desc.regex_, desc.substr_, desc.re_type_);
       ++num_found;
     }
   }
   for (const auto& desc : Config::TagNames::get().tokenizedDescriptorVec()) {
     if (desc.name_ == name) {
-      addExtractor(std::make_unique<TagExtractorTokensImpl>(desc.name_, desc.pattern_));
+      addTokensExtractor(desc.name_, desc.pattern_);
       ++num_found;
     }
   }
   return num_found;
 }
 
-void TagProducerImpl::addExtractor(TagExtractorPtr extractor) {
+uint32_t TagProducerImpl::addExtractor(TagExtractorPtr extractor) {
+  const uint32_t id = num_extractors_++;
+  // Until it is added to a compiled matcher, an extractor is run on every name.
+  uncompiled_.push_back(true);
   const absl::string_view prefix = extractor->prefixToken();
   if (prefix.empty()) {
-    tag_extractors_without_prefix_.emplace_back(std::move(extractor));
+    tag_extractors_without_prefix_.push_back(IndexedExtractor{std::move(extractor), id});
   } else {
-    tag_extractor_prefix_map_[prefix].emplace_back(std::move(extractor));
+    tag_extractor_prefix_map_[prefix].push_back(IndexedExtractor{std::move(extractor), id});
   }
+  return id;
+}
+
+void TagProducerImpl::addRegexExtractor(absl::string_view name, absl::string_view regex,
+                                        absl::string_view substr, Regex::Type re_type) {
+  const uint32_t id =
+      addExtractor(TagExtractorImplBase::createTagExtractor(name, regex, substr, re_type));
+  if (!compile_extractors_ || re_type != Regex::Type::Re2) {
+    return;
+  }
+  if (regex_set_ == nullptr) {
+    regex_set_ = std::make_unique<re2::RE2::Set>(re2::RE2::DefaultOptions, re2::RE2::UNANCHORED);
+  }
+  // The regex was already parsed by the extractor, so this does not fail in practice.
+  if (regex_set_->Add(re2::StringPiece(regex.data(), regex.size()), nullptr) >= 0) {
+    regex_ids_.push_back(id);
+    uncompiled_[id] = false;
+  }
+}
+
+void TagProducerImpl::addTokensExtractor(absl::string_view name, absl::string_view tokens) {
+  const uint32_t id = addExtractor(std::make_unique<TagExtractorTokensImpl>(name, tokens));
+  if (compile_extractors_) {
+    tokens_trie_.add(tokens, id);
+    uncompiled_[id] = false;
+  }
+}
+
+void TagProducerImpl::compileRegexes() {
+  if (regex_set_ != nullptr && !regex_set_->Compile()) {
+    for (const uint32_t id : regex_ids_) {
+      uncompiled_[id] = true;
+    }
+    regex_ids_.clear();
+    regex_set_.reset();
+  }
+}
+
+std::vector<bool> TagProducerImpl::findCandidates(TagExtractionContext& context) const {
+  std::vector<bool> candidates = uncompiled_;
+  tokens_trie_.findMatches(context.tokens(), candidates);
+  if (regex_set_ != nullptr) {
+    std::vector<int> matches;
+    re2::RE2::Set::ErrorInfo error_info;
+    const absl::string_view name = context.name();
+    if (regex_set_->Match(re2::StringPiece(name.data(), name.size()), &matches, &error_info)) {
+      for (const int index : matches) {
+        candidates[regex_ids_[index]] = true;
+      }
+    } else if (error_info.kind != re2::RE2::Set::kNoError) {
+      // Running out of DFA memory is the only error possible once compiled, in which case
+      // all of the regexes are run as though they were not compiled.
+      for (const uint32_t id : regex_ids_) {
+        candidates[id] = true;
+      }
+    }
+  }
+  return candidates;
 }
 
 void TagProducerImpl::forEachExtractorMatching(
     absl::string_view stat_name, std::function<void(const TagExtractorPtr&)> f) const {
-  IntervalSetImpl<size_t> remove_characters;
-  for (const TagExtractorPtr& tag_extractor : tag_extractors_without_prefix_) {
-    f(tag_extractor);
+  forEachIndexedExtractorMatching(
+      stat_name, [&f](const IndexedExtractor& indexed) { f(indexed.extractor_); });
+}
+
+void TagProducerImpl::forEachIndexedExtractorMatching(
+    absl::string_view stat_name, const std::function<void(const IndexedExtractor&)>& f) const {
+  for (const IndexedExtractor& indexed : tag_extractors_without_prefix_) {
+    f(indexed);
   }
   const absl::string_view::size_type dot = stat_name.find('.');
   if (dot != std::string::npos) {
     const absl::string_view token = absl::string_view(stat_name.data(), dot);
     const auto iter = tag_extractor_prefix_map_.find(token);
     if (iter != tag_extractor_prefix_map_.end()) {
-      for (const TagExtractorPtr& tag_extractor : iter->second) {
-        f(tag_extractor);
+      for (const IndexedExtractor& indexed : iter->second) {
+        f(indexed);
       }
     }
   }
@@ -93,11 +161,23 @@ std::string TagProducerImpl::produceTags(absl::string_view metric_name, TagVecto
   tags.insert(tags.end(), default_tags_.begin(), default_tags_.end());
   IntervalSetImpl<size_t> remove_characters;
   TagExtractionContext tag_extraction_context(metric_name);
-  std::vector<absl::string_view> tokens;
-  forEachExtractorMatching(metric_name, [&remove_characters, &tags, &tag_extraction_context](
-                                            const TagExtractorPtr& tag_extractor) {
-    tag_extractor->extractTag(tag_extraction_context, tags, remove_characters);
-  });
+  if (!compile_extractors_) {
+    forEachExtractorMatching(metric_name, [&remove_characters, &tags, &tag_extraction_context](
+                                              const TagExtractorPtr& tag_extractor) {
+      tag_extractor->extractTag(tag_extraction_context, tags, remove_characters);
+    });
+    return StringUtil::removeCharacters(metric_name, remove_characters);
+  }
+
+  // Run just the candidates, in the same order as above so that the tags are in the same order.
+  const std::vector<bool> candidates = findCandidates(tag_extraction_context);
+  forEachIndexedExtractorMatching(
+      metric_name, [&candidates, &remove_characters, &tags,
+                    &tag_extraction_context](const IndexedExtractor& indexed) {
+        if (candidates[indexed.id_]) {
+          indexed.extractor_->extractTag(tag_extraction_context, tags, remove_characters);
+        }
+      });
   return StringUtil::removeCharacters(metric_name, remove_characters);
 }
 
@@ -111,12 +191,11 @@ TagProducerImpl::addDefaultExtractors(const envoy::config::metrics::v3::StatsCon
   if (!config.has_use_all_default_tags() || config.use_all_default_tags().value()) {
     for (const auto& desc : Config::TagNames::get().descriptorVec()) {
       names.emplace(desc.name_);
-      addExtractor(TagExtractorImplBase::createTagExtractor(desc.name_, desc.regex_, desc.substr_,
-                                                            desc.re_type_));
+      addRegexExtractor(desc.name_, desc.regex_, desc.substr_, desc.re_type_);
     }
     for (const auto& desc : Config::TagNames::get().tokenizedDescriptorVec()) {
       names.emplace(desc.name_);
-      addExtractor(std::make_unique<TagExtractorTokensImpl>(desc.name_, desc.pattern_));
+      addTokensExtractor(desc.name_, desc.pattern_);
     }
   }
   return names;
@@ -14,10 +14,12 @@
 #include "source/common/common/utility.h"
 #include "source/common/config/well_known_names.h"
 #include "source/common/protobuf/protobuf.h"
+#include "source/common/stats/tag_extractor_impl.h"
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_set.h"
 #include "absl/strings/string_view.h"
+#include "re2/set.h"
 
 namespace Envoy {
 namespace Stats {
@@ -25,10 +27,21 @@ namespace Stats {
 /**
  * Organizes a collection of TagExtractors so that stat-names can be processed without
  * iterating through all extractors.
+ *
+ * By default the extractors are also compiled into a single matcher, so that only the
+ * extractors which match a name need be run on it: the token-based extractors are merged
+ * into a TagExtractorTokensTrie, and the RE2 extractors into an RE2::Set. The remaining
+ * extractors, using std::regex, are run on every name as before.
  */
 class TagProducerImpl : public TagProducer {
 public:
-  TagProducerImpl(const envoy::config::metrics::v3::StatsConfig& config);
+  /**
+   * @param config the stats config specifying the tags to extract.
+   * @param compile_extractors whether to compile the extractors into a single matcher, rather
+   *        than running each of them on every name. The tags produced are the same either way.
+   */
+  TagProducerImpl(const envoy::config::metrics::v3::StatsConfig& config,
+                  bool compile_extractors = true);
   TagProducerImpl() = default;
 
   /**
@@ -42,12 +55,44 @@ public:
 private:
   friend class DefaultTagRegexTester;
 
+  // A TagExtractor along with its index into the compiled matcher's results.
+  struct IndexedExtractor {
+    TagExtractorPtr extractor_;
+    uint32_t id_;
+  };
+
   /**
    * Adds a TagExtractor to the collection of tags, tracking prefixes to help make
    * produceTags run efficiently by trying only extractors that have a chance to match.
    * @param extractor TagExtractorPtr the extractor to add.
+   * @return uint32_t the id of the extractor in the compiled matcher.
+   */
+  uint32_t addExtractor(TagExtractorPtr extractor);
+
+  /**
+   * Adds a regex TagExtractor, as TagExtractorImplBase::createTagExtractor does, and
+   * records RE2 regexes for compilation.
+   */
+  void addRegexExtractor(absl::string_view name, absl::string_view regex,
+                         absl::string_view substr = "",
+                         Regex::Type re_type = Regex::Type::StdRegex);
+
+  /**
+   * Adds a TagExtractorTokensImpl, adding its pattern to tokens_trie_.
+   */
+  void addTokensExtractor(absl::string_view name, absl::string_view tokens);
+
+  /**
+   * Compiles the RE2 regexes added to regex_set_. If they cannot be compiled together,
+   * their extractors are run on every name instead.
    */
-  void addExtractor(TagExtractorPtr extractor);
+  void compileRegexes();
+
+  /**
+   * @return the match flags, indexed by extractor id, of the extractors which may match
+   *         the name in context.
+   */
+  std::vector<bool> findCandidates(TagExtractionContext& context) const;
 
   /**
    * Adds all default extractors matching the specified tag name. In this model,
@@ -91,14 +136,25 @@ private:
    */
   void forEachExtractorMatching(absl::string_view stat_name,
                                 std::function<void(const TagExtractorPtr&)> f) const;
+  void forEachIndexedExtractorMatching(absl::string_view stat_name,
+                                       const std::function<void(const IndexedExtractor&)>& f) const;
 
-  std::vector<TagExtractorPtr> tag_extractors_without_prefix_;
+  std::vector<IndexedExtractor> tag_extractors_without_prefix_;
 
   // Maps a prefix word extracted out of a regex to a vector of TagExtractors. Note that
   // the storage for the prefix string is owned by the TagExtractor, which, depending on
   // implementation, may need make a copy of the prefix.
-  absl::flat_hash_map<absl::string_view, std::vector<TagExtractorPtr>> tag_extractor_prefix_map_;
+  absl::flat_hash_map<absl::string_view, std::vector<IndexedExtractor>> tag_extractor_prefix_map_;
   TagVector default_tags_;
+
+  const bool compile_extractors_{false};
+  uint32_t num_extractors_{0};
+  TagExtractorTokensTrie tokens_trie_;
+  // The ids of the RE2 extractors, in the order their regexes are added to regex_set_.
+  std::vector<uint32_t> regex_ids_;
+  std::unique_ptr<re2::RE2::Set> regex_set_;
+  // Flags the extractors which are not compiled, and so are candidates for every name.
+  std::vector<bool> uncompiled_;
 };
 
 } // namespace Stats
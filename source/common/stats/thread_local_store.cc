@@ -5,6 +5,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <thread>
 
 #include "envoy/stats/allocator.h"
 #include "envoy/stats/histogram.h"
@@ -200,6 +201,10 @@ void ThreadLocalStoreImpl::shutdownThreading() {
   shutting_down_ = true;
   ASSERT(!tls_.has_value() || tls_->isShutdown());
 
+  // Wait for any merge running on the pool, which will not be completed.
+  merge_thread_pool_.reset();
+  merging_histograms_.clear();
+
   // We can't call runOnAllThreads here as global threading has already been shutdown. It is okay
   // to simply clear the scopes and central cache entries here as they will be cleaned up during
   // thread local data cleanup in InstanceImpl::shutdownThread().
@@ -216,18 +221,46 @@ void ThreadLocalStoreImpl::shutdownThreading() {
   histogram_set_.clear();
 }
 
+void ThreadLocalStoreImpl::setHistogramMergeThreads(Thread::ThreadFactory& thread_factory,
+                                                    uint32_t num_threads) {
+  ASSERT(!threading_ever_initialized_);
+  if (num_threads == 0) {
+    merge_thread_pool_.reset();
+  } else {
+    merge_thread_pool_ = std::make_unique<HistogramMergeThreadPool>(thread_factory, num_threads);
+  }
+}
+
 void ThreadLocalStoreImpl::mergeHistograms(PostMergeCb merge_complete_cb) {
   if (!shutting_down_) {
     ASSERT(!merge_in_progress_);
     merge_in_progress_ = true;
-    tls_cache_->runOnAllThreads(
-        [](OptRef<TlsCache> tls_cache) {
-          for (const auto& id_hist : tls_cache->tls_histogram_cache_) {
-            const TlsHistogramSharedPtr& tls_hist = id_hist.second;
-            tls_hist->beginMerge();
+    // The TLS histograms are swapped by the merge itself, on whichever thread it runs, so there is
+    // no need to post to every worker first.
+    if (merge_thread_pool_ == nullptr) {
+      main_thread_dispatcher_->post(
+          [this, merge_complete_cb]() -> void { mergeInternal(merge_complete_cb); });
+      return;
+    }
+
+    ASSERT(merging_histograms_.empty());
+    {
+      Thread::LockGuard lock(hist_mutex_);
+      merging_histograms_.reserve(histogram_set_.size());
+      for (ParentHistogramImpl* histogram : histogram_set_) {
+        merging_histograms_.emplace_back(histogram);
+      }
+    }
+    merge_thread_pool_->run(
+        [this](uint32_t shard, uint32_t num_shards) {
+          for (size_t i = shard; i < merging_histograms_.size(); i += num_shards) {
+            merging_histograms_[i]->mergeTlsHistograms();
           }
         },
-        [this, merge_complete_cb]() -> void { mergeInternal(merge_complete_cb); });
+        [this, merge_complete_cb]() {
+          main_thread_dispatcher_->post(
+              [this, merge_complete_cb]() -> void { completeMerge(merge_complete_cb); });
+        });
   } else {
     // If server is shutting down, just call the callback to allow flush to continue.
     merge_complete_cb();
@@ -244,6 +277,17 @@ void ThreadLocalStoreImpl::mergeInternal(PostMergeCb merge_complete_cb) {
   }
 }
 
+void ThreadLocalStoreImpl::completeMerge(PostMergeCb merge_complete_cb) {
+  if (!shutting_down_) {
+    for (const ParentHistogramImplSharedPtr& histogram : merging_histograms_) {
+      histogram->refreshStatistics();
+    }
+    merging_histograms_.clear();
+    merge_complete_cb();
+    merge_in_progress_ = false;
+  }
+}
+
 ThreadLocalStoreImpl::CentralCacheEntry::~CentralCacheEntry() {
   // Assert that the symbol-table is valid, so we get good test coverage of
   // the validity of the symbol table at the time this destructor runs. This
@@ -552,7 +596,7 @@ Counter& ThreadLocalStoreImpl::ScopeImpl::counterFromStatNameWithTags(
   // initialized currently.
   StatRefMap<Counter>* tls_cache = nullptr;
   StatNameHashSet* tls_rejected_stats = nullptr;
-  if (!parent_.shutting_down_ && parent_.tls_cache_) {
+  if (parent_.useTlsCache()) {
     TlsCacheEntry& entry = parent_.tlsCache().insertScope(this->scope_id_);
     tls_cache = &entry.counters_;
     tls_rejected_stats = &entry.rejected_stats_;
@@ -561,8 +605,11 @@ Counter& ThreadLocalStoreImpl::ScopeImpl::counterFromStatNameWithTags(
   return safeMakeStat<Counter>(
       final_stat_name, joiner.tagExtractedName(), stat_name_tags, central_cache_->counters_,
       fast_reject_result, central_cache_->rejected_stats_,
-      [](Allocator& allocator, StatName name, StatName tag_extracted_name,
-         const StatNameTagVector& tags) -> CounterSharedPtr {
+      [this](Allocator& allocator, StatName name, StatName tag_extracted_name,
+             const StatNameTagVector& tags) -> CounterSharedPtr {
+        if (parent_.shardsCounter(name)) {
+          return allocator.makeShardedCounter(name, tag_extracted_name, tags);
+        }
         return allocator.makeCounter(name, tag_extracted_name, tags);
       },
       tls_cache, tls_rejected_stats, parent_.null_counter_);
@@ -609,7 +656,7 @@ Gauge& ThreadLocalStoreImpl::ScopeImpl::gaugeFromStatNameWithTags(
 
   StatRefMap<Gauge>* tls_cache = nullptr;
   StatNameHashSet* tls_rejected_stats = nullptr;
-  if (!parent_.shutting_down_ && parent_.tls_cache_) {
+  if (parent_.useTlsCache()) {
     TlsCacheEntry& entry = parent_.tlsCache().scope_cache_[this->scope_id_];
     tls_cache = &entry.gauges_;
     tls_rejected_stats = &entry.rejected_stats_;
@@ -652,7 +699,7 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogramFromStatNameWithTags(
 
   StatNameHashMap<ParentHistogramSharedPtr>* tls_cache = nullptr;
   StatNameHashSet* tls_rejected_stats = nullptr;
-  if (!parent_.shutting_down_ && parent_.tls_cache_) {
+  if (parent_.useTlsCache()) {
     TlsCacheEntry& entry = parent_.tlsCache().scope_cache_[this->scope_id_];
     tls_cache = &entry.parent_histograms_;
     auto iter = tls_cache->find(final_stat_name);
@@ -733,7 +780,7 @@ TextReadout& ThreadLocalStoreImpl::ScopeImpl::textReadoutFromStatNameWithTags(
   // initialized currently.
   StatRefMap<TextReadout>* tls_cache = nullptr;
   StatNameHashSet* tls_rejected_stats = nullptr;
-  if (!parent_.shutting_down_ && parent_.tls_cache_) {
+  if (parent_.useTlsCache()) {
     TlsCacheEntry& entry = parent_.tlsCache().insertScope(this->scope_id_);
     tls_cache = &entry.text_readouts_;
     tls_rejected_stats = &entry.rejected_stats_;
@@ -779,7 +826,7 @@ Histogram& ThreadLocalStoreImpl::tlsHistogram(ParentHistogramImpl& parent, uint6
   // See comments in counterFromStatName() which explains the logic here.
 
   TlsHistogramSharedPtr* tls_histogram = nullptr;
-  if (!shutting_down_ && tls_cache_) {
+  if (useTlsCache()) {
     tls_histogram = &(tlsCache().tls_histogram_cache_[id]);
     if (*tls_histogram != nullptr) {
       return **tls_histogram;
@@ -806,8 +853,8 @@ ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(StatName name, Histogram::Uni
                                                    const StatNameTagVector& stat_name_tags,
                                                    SymbolTable& symbol_table)
     : HistogramImplHelper(name, tag_extracted_name, stat_name_tags, symbol_table), unit_(unit),
-      current_active_(0), used_(false), created_thread_id_(std::this_thread::get_id()),
-      symbol_table_(symbol_table) {
+      current_active_(0), recording_{false, false}, used_(false),
+      created_thread_id_(std::this_thread::get_id()), symbol_table_(symbol_table) {
   histograms_[0] = hist_alloc();
   histograms_[1] = hist_alloc();
 }
@@ -818,9 +865,29 @@ ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
   hist_free(histograms_[1]);
 }
 
+void ThreadLocalHistogramImpl::beginMerge() {
+  // This switches the current_active_ between 1 and 0. A recordValue() which read the old value
+  // either finds it switched when checking it again, or has set recording_ in time for it to be
+  // seen here, as all of these accesses are sequentially consistent.
+  const uint32_t merging = current_active_.load();
+  current_active_.store(1 - merging);
+  while (recording_[merging].load()) {
+    std::this_thread::yield();
+  }
+}
+
 void ThreadLocalHistogramImpl::recordValue(uint64_t value) {
   ASSERT(std::this_thread::get_id() == created_thread_id_);
-  hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  uint32_t index = current_active_.load();
+  recording_[index].store(true);
+  while (current_active_.load() != index) {
+    // A merge switched the histograms in the meantime.
+    recording_[index].store(false);
+    index = current_active_.load();
+    recording_[index].store(true);
+  }
+  hist_insert_intscale(histograms_[index], value, 0, 1);
+  recording_[index].store(false, std::memory_order_release);
   used_ = true;
 }
 
@@ -910,6 +977,11 @@ bool ParentHistogramImpl::used() const {
 }
 
 void ParentHistogramImpl::merge() {
+  mergeTlsHistograms();
+  refreshStatistics();
+}
+
+void ParentHistogramImpl::mergeTlsHistograms() {
   Thread::ReleasableLockGuard lock(merge_lock_);
   if (merged_ || usedLockHeld()) {
     hist_clear(interval_histogram_);
@@ -918,14 +990,22 @@ void ParentHistogramImpl::merge() {
     // because the tls_histogram merge is not that expensive as it is a single histogram
     // merge and adding TLS histograms is rare.
     for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
+      tls_histogram->beginMerge();
       tls_histogram->merge(interval_histogram_);
     }
     // Since TLS merge is done, we can release the lock here.
     lock.release();
     hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
+    refresh_pending_ = true;
+  }
+}
+
+void ParentHistogramImpl::refreshStatistics() {
+  if (refresh_pending_) {
     cumulative_statistics_.refresh(cumulative_histogram_);
     interval_statistics_.refresh(interval_histogram_);
     merged_ = true;
+    refresh_pending_ = false;
   }
 }
 
@@ -975,5 +1055,70 @@ bool ParentHistogramImpl::usedLockHeld() const {
   return false;
 }
 
+HistogramMergeThreadPool::HistogramMergeThreadPool(Thread::ThreadFactory& thread_factory,
+                                                   uint32_t num_threads)
+    : num_threads_(num_threads) {
+  threads_.reserve(num_threads);
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads_.push_back(thread_factory.createThread([this, i]() { threadRoutine(i); },
+                                                   Thread::Options{"HistogramMerge"}));
+  }
+}
+
+HistogramMergeThreadPool::~HistogramMergeThreadPool() {
+  {
+    Thread::LockGuard lock(mutex_);
+    stopping_ = true;
+    cond_var_.notifyAll();
+  }
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+void HistogramMergeThreadPool::run(ShardFn shard_fn, std::function<void()> done_cb) {
+  Thread::LockGuard lock(mutex_);
+  ASSERT(running_ == 0);
+  shard_fn_ = std::move(shard_fn);
+  done_cb_ = std::move(done_cb);
+  running_ = num_threads_;
+  ++generation_;
+  cond_var_.notifyAll();
+}
+
+void HistogramMergeThreadPool::threadRoutine(uint32_t shard) {
+  uint64_t generation = 0;
+  while (true) {
+    const ShardFn* shard_fn;
+    {
+      Thread::LockGuard lock(mutex_);
+      while (!stopping_ && generation_ == generation) {
+        cond_var_.wait(mutex_);
+      }
+      if (stopping_) {
+        return;
+      }
+      generation = generation_;
+      // Not modified until every thread is done with it.
+      shard_fn = &shard_fn_;
+    }
+
+    (*shard_fn)(shard, num_threads_);
+
+    std::function<void()> done_cb;
+    {
+      Thread::LockGuard lock(mutex_);
+      if (--running_ == 0) {
+        shard_fn_ = nullptr;
+        done_cb = std::move(done_cb_);
+        done_cb_ = nullptr;
+      }
+    }
+    if (done_cb) {
+      done_cb();
+    }
+  }
+}
+
 } // namespace Stats
 } // namespace Envoy
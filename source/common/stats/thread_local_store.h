@@ -8,9 +8,11 @@
 #include <string>
 
 #include "envoy/stats/tag.h"
+#include "envoy/thread/thread.h"
 #include "envoy/thread_local/thread_local.h"
 
 #include "source/common/common/hash.h"
+#include "source/common/common/thread.h"
 #include "source/common/common/thread_synchronizer.h"
 #include "source/common/stats/allocator_impl.h"
 #include "source/common/stats/histogram_impl.h"
@@ -30,7 +32,7 @@ namespace Stats {
 /**
  * A histogram that is stored in TLS and used to record values per thread. This holds two
  * histograms, one to collect the values and other as backup that is used for merge process. The
- * swap happens during the merge process.
+ * swap happens during the merge process, which may run on any thread.
  */
 class ThreadLocalHistogramImpl : public HistogramImplHelper {
 public:
@@ -42,13 +44,11 @@ public:
 
   /**
    * Called in the beginning of merge process. Swaps the histogram used for collection so that we do
-   * not have to lock the histogram in high throughput TLS writes.
+   * not have to lock the histogram in high throughput TLS writes. This may be called from any
+   * thread, and returns once the thread recording into the histogram is done with the one to be
+   * merged.
    */
-  void beginMerge() {
-    // This switches the current_active_ between 1 and 0.
-    ASSERT(std::this_thread::get_id() == created_thread_id_);
-    current_active_ = otherHistogramIndex();
-  }
+  void beginMerge();
 
   // Stats::Histogram
   Histogram::Unit unit() const override {
@@ -64,9 +64,11 @@ public:
 
 private:
   Histogram::Unit unit_;
-  uint64_t otherHistogramIndex() const { return 1 - current_active_; }
-  uint64_t current_active_;
+  uint32_t otherHistogramIndex() const { return 1 - current_active_.load(); }
+  std::atomic<uint32_t> current_active_;
   histogram_t* histograms_[2];
+  // Set while the owning thread records a value into the histogram with the same index.
+  std::atomic<bool> recording_[2];
   std::atomic<bool> used_;
   std::thread::id created_thread_id_;
   SymbolTable& symbol_table_;
@@ -96,10 +98,22 @@ public:
    * This method is called during the main stats flush process for each of the histograms. It
    * iterates through the TLS histograms and collects the histogram data of all of them
    * in to "interval_histogram". Then the collected "interval_histogram" is merged to a
-   * "cumulative_histogram".
+   * "cumulative_histogram". This is mergeTlsHistograms() followed by refreshStatistics().
    */
   void merge() override;
 
+  /**
+   * Collects the TLS histograms into the interval and cumulative histograms. This may be called
+   * from any thread, but not concurrently with another merge of the same histogram.
+   */
+  void mergeTlsHistograms();
+
+  /**
+   * Recomputes the statistics from the histograms collected by mergeTlsHistograms(). This must be
+   * called on the main thread, as the statistics are read there.
+   */
+  void refreshStatistics();
+
   const HistogramStatistics& intervalStatistics() const override { return interval_statistics_; }
   const HistogramStatistics& cumulativeStatistics() const override {
     return cumulative_statistics_;
@@ -132,6 +146,7 @@ private:
   mutable Thread::MutexBasicLockable merge_lock_;
   std::list<TlsHistogramSharedPtr> tls_histograms_ ABSL_GUARDED_BY(merge_lock_);
   bool merged_;
+  bool refresh_pending_{false};
   std::atomic<bool> shutting_down_{false};
   std::atomic<uint32_t> ref_count_{0};
   const uint64_t id_; // Index into TlsCache::histogram_cache_.
@@ -139,6 +154,37 @@ private:
 
 using ParentHistogramImplSharedPtr = RefcountPtr<ParentHistogramImpl>;
 
+/**
+ * Threads which the histograms are merged on when configured, spreading out the work of merging a
+ * large number of histograms and taking it off the main thread.
+ */
+class HistogramMergeThreadPool {
+public:
+  using ShardFn = std::function<void(uint32_t shard, uint32_t num_shards)>;
+
+  HistogramMergeThreadPool(Thread::ThreadFactory& thread_factory, uint32_t num_threads);
+  ~HistogramMergeThreadPool();
+
+  /**
+   * Calls shard_fn on every thread of the pool with the thread's index, and then calls done_cb on
+   * the last thread to finish. This must not be called again until done_cb has been called.
+   */
+  void run(ShardFn shard_fn, std::function<void()> done_cb);
+
+private:
+  void threadRoutine(uint32_t shard);
+
+  const uint32_t num_threads_;
+  Thread::MutexBasicLockable mutex_;
+  Thread::CondVar cond_var_;
+  ShardFn shard_fn_ ABSL_GUARDED_BY(mutex_);
+  std::function<void()> done_cb_ ABSL_GUARDED_BY(mutex_);
+  uint64_t generation_ ABSL_GUARDED_BY(mutex_){0};
+  uint32_t running_ ABSL_GUARDED_BY(mutex_){0};
+  bool stopping_ ABSL_GUARDED_BY(mutex_){false};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
 /**
  * Store implementation with thread local caching. For design details see
  * https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md
@@ -250,7 +296,12 @@ public:
     tag_producer_ = std::move(tag_producer);
   }
   void setStatsMatcher(StatsMatcherPtr&& stats_matcher) override;
+  void setShardedCounterMatcher(StatsMatcherPtr&& sharded_counter_matcher) override {
+    sharded_counter_matcher_ = std::move(sharded_counter_matcher);
+  }
   void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) override;
+  void setHistogramMergeThreads(Thread::ThreadFactory& thread_factory,
+                                uint32_t num_threads) override;
   void initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                            ThreadLocal::Instance& tls) override;
   void shutdownThreading() override;
@@ -477,16 +528,25 @@ private:
   void clearHistogramsFromCaches();
   void releaseScopeCrossThread(ScopeImpl* scope);
   void mergeInternal(PostMergeCb merge_cb);
+  void completeMerge(PostMergeCb merge_cb);
   bool slowRejects(StatsMatcher::FastResult fast_reject_result, StatName name) const;
   bool rejects(StatName name) const { return stats_matcher_->rejects(name); }
   StatsMatcher::FastResult fastRejects(StatName name) const;
   bool rejectsAll() const { return stats_matcher_->rejectsAll(); }
+  bool shardsCounter(StatName name) const {
+    return sharded_counter_matcher_ != nullptr && !sharded_counter_matcher_->rejects(name);
+  }
   template <class StatMapClass, class StatListClass>
   void removeRejectedStats(StatMapClass& map, StatListClass& list);
   bool checkAndRememberRejection(StatName name, StatsMatcher::FastResult fast_reject_result,
                                  StatNameStorageSet& central_rejected_stats,
                                  StatNameHashSet* tls_rejected_stats);
   TlsCache& tlsCache() { return **tls_cache_; }
+  // Stats may also be looked up on threads without thread local storage, such as the cluster init
+  // threads, which then go straight to the central cache.
+  bool useTlsCache() const {
+    return !shutting_down_ && tls_cache_ != nullptr && tls_cache_->currentThreadRegistered();
+  }
 
   Allocator& alloc_;
   Event::Dispatcher* main_thread_dispatcher_{};
@@ -498,10 +558,15 @@ private:
   std::list<std::reference_wrapper<Sink>> timer_sinks_;
   TagProducerPtr tag_producer_;
   StatsMatcherPtr stats_matcher_;
+  StatsMatcherPtr sharded_counter_matcher_;
   HistogramSettingsConstPtr histogram_settings_;
   std::atomic<bool> threading_ever_initialized_{};
   std::atomic<bool> shutting_down_{};
   std::atomic<bool> merge_in_progress_{};
+  std::unique_ptr<HistogramMergeThreadPool> merge_thread_pool_;
+  // The histograms being merged on the merge_thread_pool_, which is only accessed by the main
+  // thread while no merge is running on the pool.
+  std::vector<ParentHistogramImplSharedPtr> merging_histograms_;
   AllocatorImpl heap_allocator_;
   OptRef<ThreadLocal::Instance> tls_;
 
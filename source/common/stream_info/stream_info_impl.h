@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <memory>
 
 #include "envoy/common/time.h"
 #include "envoy/config/core/v3/base.pb.h"
@@ -13,6 +14,7 @@
 
 #include "source/common/common/assert.h"
 #include "source/common/common/dump_state_utils.h"
+#include "source/common/common/empty_string.h"
 #include "source/common/common/macros.h"
 #include "source/common/network/socket_impl.h"
 #include "source/common/stream_info/filter_state_impl.h"
@@ -78,23 +80,23 @@ struct StreamInfoImpl : public StreamInfo {
   }
 
   void setUpstreamTiming(const UpstreamTiming& upstream_timing) override {
-    upstream_timing_ = upstream_timing;
+    cold().upstream_timing_ = upstream_timing;
   }
 
   absl::optional<std::chrono::nanoseconds> firstUpstreamTxByteSent() const override {
-    return duration(upstream_timing_.first_upstream_tx_byte_sent_);
+    return upstreamDuration(&UpstreamTiming::first_upstream_tx_byte_sent_);
   }
 
   absl::optional<std::chrono::nanoseconds> lastUpstreamTxByteSent() const override {
-    return duration(upstream_timing_.last_upstream_tx_byte_sent_);
+    return upstreamDuration(&UpstreamTiming::last_upstream_tx_byte_sent_);
   }
 
   absl::optional<std::chrono::nanoseconds> firstUpstreamRxByteReceived() const override {
-    return duration(upstream_timing_.first_upstream_rx_byte_received_);
+    return upstreamDuration(&UpstreamTiming::first_upstream_rx_byte_received_);
   }
 
   absl::optional<std::chrono::nanoseconds> lastUpstreamRxByteReceived() const override {
-    return duration(upstream_timing_.last_upstream_rx_byte_received_);
+    return upstreamDuration(&UpstreamTiming::last_upstream_rx_byte_received_);
   }
 
   absl::optional<std::chrono::nanoseconds> firstDownstreamTxByteSent() const override {
@@ -145,11 +147,11 @@ struct StreamInfoImpl : public StreamInfo {
   }
 
   const absl::optional<std::string>& connectionTerminationDetails() const override {
-    return connection_termination_details_;
+    return cold_ != nullptr ? cold_->connection_termination_details_ : noDetails();
   }
 
   void setConnectionTerminationDetails(absl::string_view connection_termination_details) override {
-    connection_termination_details_.emplace(connection_termination_details);
+    cold().connection_termination_details_.emplace(connection_termination_details);
   }
 
   void addBytesSent(uint64_t bytes_sent) override { bytes_sent_ += bytes_sent; }
@@ -175,10 +177,14 @@ struct StreamInfoImpl : public StreamInfo {
   Upstream::HostDescriptionConstSharedPtr upstreamHost() const override { return upstream_host_; }
 
   void setRouteName(absl::string_view route_name) override {
-    route_name_ = std::string(route_name);
+    if (cold_ != nullptr || !route_name.empty()) {
+      cold().route_name_ = std::string(route_name);
+    }
   }
 
-  const std::string& getRouteName() const override { return route_name_; }
+  const std::string& getRouteName() const override {
+    return cold_ != nullptr ? cold_->route_name_ : EMPTY_STRING;
+  }
 
   void setUpstreamLocalAddress(
       const Network::Address::InstanceConstSharedPtr& upstream_local_address) override {
@@ -216,11 +222,14 @@ struct StreamInfoImpl : public StreamInfo {
 
   const Router::RouteEntry* routeEntry() const override { return route_entry_; }
 
-  envoy::config::core::v3::Metadata& dynamicMetadata() override { return metadata_; };
-  const envoy::config::core::v3::Metadata& dynamicMetadata() const override { return metadata_; };
+  envoy::config::core::v3::Metadata& dynamicMetadata() override { return cold().metadata_; };
+  const envoy::config::core::v3::Metadata& dynamicMetadata() const override {
+    return cold_ != nullptr ? cold_->metadata_
+                            : envoy::config::core::v3::Metadata::default_instance();
+  };
 
   void setDynamicMetadata(const std::string& name, const ProtobufWkt::Struct& value) override {
-    (*metadata_.mutable_filter_metadata())[name].MergeFrom(value);
+    (*cold().metadata_.mutable_filter_metadata())[name].MergeFrom(value);
   };
 
   const FilterStateSharedPtr& filterState() override { return filter_state_; }
@@ -234,11 +243,13 @@ struct StreamInfoImpl : public StreamInfo {
   }
 
   void setUpstreamTransportFailureReason(absl::string_view failure_reason) override {
-    upstream_transport_failure_reason_ = std::string(failure_reason);
+    if (cold_ != nullptr || !failure_reason.empty()) {
+      cold().upstream_transport_failure_reason_ = std::string(failure_reason);
+    }
   }
 
   const std::string& upstreamTransportFailureReason() const override {
-    return upstream_transport_failure_reason_;
+    return cold_ != nullptr ? cold_->upstream_transport_failure_reason_ : EMPTY_STRING;
   }
 
   void setRequestHeaders(const Http::RequestHeaderMap& headers) override {
@@ -262,7 +273,8 @@ struct StreamInfoImpl : public StreamInfo {
     const char* spaces = spacesForLevel(indent_level);
     os << spaces << "StreamInfoImpl " << this << DUMP_OPTIONAL_MEMBER(protocol_)
        << DUMP_OPTIONAL_MEMBER(response_code_) << DUMP_OPTIONAL_MEMBER(response_code_details_)
-       << DUMP_MEMBER(health_check_request_) << DUMP_MEMBER(route_name_) << "\n";
+       << DUMP_MEMBER(health_check_request_) << DUMP_MEMBER_AS(route_name_, getRouteName())
+       << "\n";
   }
 
   void setUpstreamClusterInfo(
@@ -275,10 +287,14 @@ struct StreamInfoImpl : public StreamInfo {
   }
 
   void setFilterChainName(absl::string_view filter_chain_name) override {
-    filter_chain_name_ = std::string(filter_chain_name);
+    if (cold_ != nullptr || !filter_chain_name.empty()) {
+      cold().filter_chain_name_ = std::string(filter_chain_name);
+    }
   }
 
-  const std::string& filterChainName() const override { return filter_chain_name_; }
+  const std::string& filterChainName() const override {
+    return cold_ != nullptr ? cold_->filter_chain_name_ : EMPTY_STRING;
+  }
 
   TimeSource& time_source_;
   const SystemTime start_time_;
@@ -292,17 +308,44 @@ struct StreamInfoImpl : public StreamInfo {
   absl::optional<Http::Protocol> protocol_;
   absl::optional<uint32_t> response_code_;
   absl::optional<std::string> response_code_details_;
-  absl::optional<std::string> connection_termination_details_;
   uint64_t response_flags_{};
   Upstream::HostDescriptionConstSharedPtr upstream_host_{};
   bool health_check_request_{};
   const Router::RouteEntry* route_entry_{};
-  envoy::config::core::v3::Metadata metadata_{};
   FilterStateSharedPtr filter_state_;
   FilterStateSharedPtr upstream_filter_state_;
-  std::string route_name_;
 
 private:
+  // The fields which most streams do not set until they complete, if ever. They are allocated
+  // together when the first of them is set, instead of being part of every stream.
+  struct ColdFields {
+    UpstreamTiming upstream_timing_;
+    envoy::config::core::v3::Metadata metadata_;
+    std::string route_name_;
+    std::string upstream_transport_failure_reason_;
+    std::string filter_chain_name_;
+    absl::optional<std::string> connection_termination_details_;
+  };
+
+  ColdFields& cold() {
+    if (cold_ == nullptr) {
+      cold_ = std::make_unique<ColdFields>();
+    }
+    return *cold_;
+  }
+
+  absl::optional<std::chrono::nanoseconds>
+  upstreamDuration(absl::optional<MonotonicTime> UpstreamTiming::*time) const {
+    if (cold_ == nullptr) {
+      return {};
+    }
+    return duration(cold_->upstream_timing_.*time);
+  }
+
+  static const absl::optional<std::string>& noDetails() {
+    CONSTRUCT_ON_FIRST_USE(absl::optional<std::string>, absl::nullopt);
+  }
+
   static Network::SocketAddressProviderSharedPtr emptyDownstreamAddressProvider() {
     MUTABLE_CONSTRUCT_ON_FIRST_USE(
         Network::SocketAddressProviderSharedPtr,
@@ -326,13 +369,10 @@ private:
   const Network::SocketAddressProviderSharedPtr downstream_address_provider_;
   Ssl::ConnectionInfoConstSharedPtr downstream_ssl_info_;
   Ssl::ConnectionInfoConstSharedPtr upstream_ssl_info_;
-  std::string requested_server_name_;
   const Http::RequestHeaderMap* request_headers_{};
   Http::RequestIdStreamInfoProviderSharedPtr request_id_provider_;
-  UpstreamTiming upstream_timing_;
-  std::string upstream_transport_failure_reason_;
   absl::optional<Upstream::ClusterInfoConstSharedPtr> upstream_cluster_info_;
-  std::string filter_chain_name_;
+  std::unique_ptr<ColdFields> cold_;
   Tracing::Reason trace_reason_;
 };
 
@@ -181,6 +181,9 @@ public:
   bool maybePreconnect(float preconnect_ratio) override {
     return Envoy::ConnectionPool::ConnPoolImplBase::maybePreconnect(preconnect_ratio);
   }
+  void warmUp(uint32_t connections, WarmUpCb cb) override {
+    Envoy::ConnectionPool::ConnPoolImplBase::warmUp(connections, std::move(cb));
+  }
 
   ConnectionPool::Cancellable*
   newPendingStream(Envoy::ConnectionPool::AttachContext& context) override {
@@ -332,8 +332,8 @@ void OriginalConnPoolImpl::processIdleConnection(ActiveConn& conn, bool new_conn
 OriginalConnPoolImpl::ConnectionWrapper::ConnectionWrapper(ActiveConn& parent) : parent_(parent) {
   parent_.parent_.host_->cluster().stats().upstream_rq_total_.inc();
   parent_.parent_.host_->cluster().stats().upstream_rq_active_.inc();
-  parent_.parent_.host_->stats().rq_total_.inc();
-  parent_.parent_.host_->stats().rq_active_.inc();
+  parent_.parent_.host_->stats().incRqTotal();
+  parent_.parent_.host_->stats().incRqActive();
 }
 
 Network::ClientConnection& OriginalConnPoolImpl::ConnectionWrapper::connection() {
@@ -358,7 +358,7 @@ void OriginalConnPoolImpl::ConnectionWrapper::release(bool closed) {
     }
 
     parent_.parent_.host_->cluster().stats().upstream_rq_active_.dec();
-    parent_.parent_.host_->stats().rq_active_.dec();
+    parent_.parent_.host_->stats().decRqActive();
   }
 }
 
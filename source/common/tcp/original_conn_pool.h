@@ -40,6 +40,7 @@ public:
   ConnectionPool::Cancellable* newConnection(ConnectionPool::Callbacks& callbacks) override;
   // The old pool does not implement preconnecting.
   bool maybePreconnect(float) override { return false; }
+  void warmUp(uint32_t, WarmUpCb cb) override { cb(); }
   Upstream::HostDescriptionConstSharedPtr host() const override { return host_; }
 
 protected:
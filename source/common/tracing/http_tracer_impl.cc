@@ -256,8 +256,9 @@ HttpTracerUtility::createCustomTag(const envoy::type::tracing::v3::CustomTag& ta
   }
 }
 
-HttpTracerImpl::HttpTracerImpl(DriverSharedPtr driver, const LocalInfo::LocalInfo& local_info)
-    : driver_(std::move(driver)), local_info_(local_info) {}
+HttpTracerImpl::HttpTracerImpl(DriverSharedPtr driver, const LocalInfo::LocalInfo& local_info,
+                               TailSamplerSharedPtr tail_sampler)
+    : driver_(std::move(driver)), local_info_(local_info), tail_sampler_(std::move(tail_sampler)) {}
 
 SpanPtr HttpTracerImpl::startSpan(const Config& config, Http::RequestHeaderMap& request_headers,
                                   const StreamInfo::StreamInfo& stream_info,
@@ -272,6 +273,10 @@ SpanPtr HttpTracerImpl::startSpan(const Config& config, Http::RequestHeaderMap&
   SpanPtr active_span = driver_->startSpan(config, request_headers, span_name,
                                            stream_info.startTime(), tracing_decision);
 
+  if (active_span && tail_sampler_ != nullptr) {
+    active_span = tail_sampler_->wrap(std::move(active_span), stream_info.startTimeMonotonic());
+  }
+
   // Set tags related to the local environment
   if (active_span) {
     active_span->setTag(Tracing::Tags::get().NodeId, local_info_.nodeName());
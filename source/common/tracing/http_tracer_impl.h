@@ -18,6 +18,7 @@
 #include "source/common/json/json_loader.h"
 #include "source/common/tracing/common_values.h"
 #include "source/common/tracing/null_span_impl.h"
+#include "source/common/tracing/tail_sampler_impl.h"
 
 namespace Envoy {
 namespace Tracing {
@@ -96,7 +97,9 @@ public:
 
 class HttpTracerImpl : public HttpTracer {
 public:
-  HttpTracerImpl(DriverSharedPtr driver, const LocalInfo::LocalInfo& local_info);
+  // If tail_sampler is set, the traces of the requests are sampled by it once they complete.
+  HttpTracerImpl(DriverSharedPtr driver, const LocalInfo::LocalInfo& local_info,
+                 TailSamplerSharedPtr tail_sampler = nullptr);
 
   // Tracing::HttpTracer
   SpanPtr startSpan(const Config& config, Http::RequestHeaderMap& request_headers,
@@ -108,6 +111,7 @@ public:
 private:
   DriverSharedPtr driver_;
   const LocalInfo::LocalInfo& local_info_;
+  const TailSamplerSharedPtr tail_sampler_;
 };
 
 class CustomTagBase : public CustomTag {
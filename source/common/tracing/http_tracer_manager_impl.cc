@@ -46,9 +46,18 @@ HttpTracerManagerImpl::getOrCreateHttpTracer(const envoy::config::trace::v3::Tra
   ProtobufTypes::MessagePtr message = Envoy::Config::Utility::translateToFactoryConfig(
       *config, factory_context_->messageValidationVisitor(), factory);
 
+  Server::Configuration::ServerFactoryContext& server_context =
+      factory_context_->serverFactoryContext();
+  TailSamplerSharedPtr tail_sampler;
+  if (config->has_tail_sampling()) {
+    tail_sampler = std::make_shared<TailSampler>(
+        config->tail_sampling(), server_context.threadLocal(), server_context.scope(),
+        server_context.timeSource(), server_context.api().randomGenerator());
+  }
+
   HttpTracerSharedPtr http_tracer = std::make_shared<Tracing::HttpTracerImpl>(
-      factory.createTracerDriver(*message, *factory_context_),
-      factory_context_->serverFactoryContext().localInfo());
+      factory.createTracerDriver(*message, *factory_context_), server_context.localInfo(),
+      std::move(tail_sampler));
   http_tracers_.emplace(cache_key, http_tracer); // cache a weak reference
   return http_tracer;
 }
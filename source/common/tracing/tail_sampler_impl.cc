@@ -0,0 +1,180 @@
+#include "source/common/tracing/tail_sampler_impl.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/common/tracing/common_values.h"
+
+namespace Envoy {
+namespace Tracing {
+namespace {
+
+// A rough estimate of what a span of a trace driver holds besides its tags and logs.
+constexpr uint64_t SpanBytes = 512;
+
+constexpr uint64_t DefaultDecisionWaitMs = 10000;
+constexpr uint64_t DefaultMaxBufferedBytes = 1024 * 1024;
+
+} // namespace
+
+TailSampler::TailSampler(const envoy::config::trace::v3::TailSampling& config,
+                         ThreadLocal::SlotAllocator& tls, Stats::Scope& scope,
+                         TimeSource& time_source, Random::RandomGenerator& random)
+    : latency_threshold_(
+          config.has_latency_threshold()
+              ? absl::make_optional(std::chrono::milliseconds(
+                    DurationUtil::durationToMilliseconds(config.latency_threshold())))
+              : absl::nullopt),
+      keep_errors_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, keep_errors, true)),
+      random_sampling_(config.random_sampling().value() / 100.0),
+      decision_wait_(PROTOBUF_GET_MS_OR_DEFAULT(config, decision_wait, DefaultDecisionWaitMs)),
+      max_buffered_bytes_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_buffered_bytes, DefaultMaxBufferedBytes)),
+      time_source_(time_source), random_(random),
+      stats_{ALL_TAIL_SAMPLER_STATS(POOL_COUNTER_PREFIX(scope, "tracing.tail_sampling."),
+                                    POOL_GAUGE_PREFIX(scope, "tracing.tail_sampling."))},
+      tls_(tls) {
+  for (const auto& tag : config.keep_tags()) {
+    keep_tags_.emplace_back(tag.name(), tag.value());
+  }
+  tls_.set(
+      [](Event::Dispatcher& dispatcher) { return std::make_shared<WorkerBuffer>(dispatcher); });
+}
+
+SpanPtr TailSampler::wrap(SpanPtr&& span, MonotonicTime start_time) {
+  auto trace = std::make_shared<TailSampledTrace>(*this, *tls_, start_time);
+  return std::make_unique<TailSampledSpan>(std::move(trace), std::move(span), true);
+}
+
+bool TailSampler::keepsTag(absl::string_view name, absl::string_view value) const {
+  if (keep_errors_ && name == Tags::get().Error && value == Tags::get().True) {
+    return true;
+  }
+  for (const auto& [tag_name, tag_value] : keep_tags_) {
+    if (name == tag_name && (tag_value.empty() || value == tag_value)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TailSampler::keepsTrace(std::chrono::nanoseconds latency) {
+  if (latency_threshold_.has_value() && latency >= latency_threshold_.value()) {
+    return true;
+  }
+  return random_.bernoulli(random_sampling_);
+}
+
+TailSampledTrace::TailSampledTrace(TailSampler& sampler, TailSampler::WorkerBuffer& worker,
+                                   MonotonicTime start_time)
+    : sampler_(sampler), worker_(worker), start_time_(start_time) {}
+
+TailSampledTrace::~TailSampledTrace() {
+  // The request of the trace ended without completing, which keeps what its spans recorded.
+  finishBufferedSpans();
+}
+
+Span& TailSampledTrace::addSpan(SpanPtr&& span) {
+  spans_.push_back(std::move(span));
+  return *spans_.back();
+}
+
+void TailSampledTrace::onTag(absl::string_view name, absl::string_view value) {
+  if (!kept_by_tag_ && sampler_.keepsTag(name, value)) {
+    kept_by_tag_ = true;
+  }
+}
+
+void TailSampledTrace::onFinished(Span& span, uint64_t bytes, bool root) {
+  if (root && !keep_.has_value()) {
+    decide(kept_by_tag_ ||
+           sampler_.keepsTrace(sampler_.time_source_.monotonicTime() - start_time_));
+  }
+  if (keep_.has_value()) {
+    if (!keep_.value()) {
+      span.setSampled(false);
+    }
+    span.finishSpan();
+    return;
+  }
+  if (worker_.buffered_bytes_ + bytes > sampler_.max_buffered_bytes_) {
+    sampler_.stats_.spans_overflowed_.inc();
+    span.finishSpan();
+    return;
+  }
+
+  buffered_spans_.push_back({span, bytes, sampler_.time_source_.systemTime(),
+                             sampler_.time_source_.monotonicTime()});
+  buffered_bytes_ += bytes;
+  worker_.buffered_bytes_ += bytes;
+  sampler_.stats_.buffered_bytes_.add(bytes);
+  sampler_.stats_.buffered_spans_.inc();
+  if (decision_timer_ == nullptr) {
+    decision_timer_ = worker_.dispatcher_.createTimer([this]() { decide(true); });
+    decision_timer_->enableTimer(sampler_.decision_wait_);
+  }
+}
+
+void TailSampledTrace::decide(bool keep) {
+  keep_ = keep;
+  if (keep) {
+    sampler_.stats_.traces_kept_.inc();
+  } else {
+    sampler_.stats_.traces_dropped_.inc();
+  }
+  if (decision_timer_ != nullptr) {
+    decision_timer_->disableTimer();
+  }
+  finishBufferedSpans();
+}
+
+void TailSampledTrace::finishBufferedSpans() {
+  if (buffered_spans_.empty()) {
+    return;
+  }
+  for (const BufferedSpan& buffered : buffered_spans_) {
+    if (!keep_.value_or(true)) {
+      buffered.span_.setSampled(false);
+    }
+    buffered.span_.finishSpanAt(buffered.end_time_, buffered.monotonic_end_time_);
+  }
+  worker_.buffered_bytes_ -= buffered_bytes_;
+  sampler_.stats_.buffered_bytes_.sub(buffered_bytes_);
+  sampler_.stats_.buffered_spans_.sub(buffered_spans_.size());
+  buffered_bytes_ = 0;
+  buffered_spans_.clear();
+}
+
+TailSampledSpan::TailSampledSpan(TailSampledTraceSharedPtr trace, SpanPtr&& span, bool root)
+    : trace_(std::move(trace)), span_(trace_->addSpan(std::move(span))), root_(root),
+      bytes_(SpanBytes) {}
+
+void TailSampledSpan::setOperation(absl::string_view operation) {
+  bytes_ += operation.size();
+  span_.setOperation(operation);
+}
+
+void TailSampledSpan::setTag(absl::string_view name, absl::string_view value) {
+  bytes_ += name.size() + value.size();
+  trace_->onTag(name, value);
+  span_.setTag(name, value);
+}
+
+void TailSampledSpan::log(SystemTime timestamp, const std::string& event) {
+  bytes_ += event.size();
+  span_.log(timestamp, event);
+}
+
+void TailSampledSpan::finishSpan() { trace_->onFinished(span_, bytes_, root_); }
+
+SpanPtr TailSampledSpan::spawnChild(const Config& config, const std::string& name,
+                                    SystemTime start_time) {
+  return std::make_unique<TailSampledSpan>(trace_, span_.spawnChild(config, name, start_time),
+                                           false);
+}
+
+void TailSampledSpan::setBaggage(absl::string_view key, absl::string_view value) {
+  bytes_ += key.size() + value.size();
+  span_.setBaggage(key, value);
+}
+
+} // namespace Tracing
+} // namespace Envoy
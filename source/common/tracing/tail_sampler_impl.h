@@ -0,0 +1,182 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/common/random_generator.h"
+#include "envoy/common/time.h"
+#include "envoy/config/trace/v3/http_tracer.pb.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
+#include "envoy/tracing/trace_driver.h"
+
+#include "source/common/common/interval_value.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Tracing {
+
+/**
+ * All tail sampler stats. @see stats_macros.h
+ */
+#define ALL_TAIL_SAMPLER_STATS(COUNTER, GAUGE)                                                     \
+  COUNTER(spans_overflowed)                                                                        \
+  COUNTER(traces_dropped)                                                                          \
+  COUNTER(traces_kept)                                                                             \
+  GAUGE(buffered_bytes, Accumulate)                                                                \
+  GAUGE(buffered_spans, Accumulate)
+
+/**
+ * Struct definition for all tail sampler stats. @see stats_macros.h
+ */
+struct TailSamplerStats {
+  ALL_TAIL_SAMPLER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+class TailSampledTrace;
+
+/**
+ * Samples the traces of an HTTP tracer once the requests they trace complete, as configured by
+ * envoy::config::trace::v3::TailSampling. The spans of a request are wrapped, so that those which
+ * finish before the request are buffered by its worker until the request completes, and then
+ * finished sampled or not depending on what happened to the request.
+ */
+class TailSampler {
+public:
+  TailSampler(const envoy::config::trace::v3::TailSampling& config,
+              ThreadLocal::SlotAllocator& tls, Stats::Scope& scope, TimeSource& time_source,
+              Random::RandomGenerator& random);
+
+  /**
+   * Wraps the downstream span of a request, whose trace is decided once it finishes.
+   * @param span the span of the request, as started by the trace driver.
+   * @param start_time the monotonic time the request started, which its latency is measured from.
+   * @return the wrapped span.
+   */
+  SpanPtr wrap(SpanPtr&& span, MonotonicTime start_time);
+
+private:
+  friend class TailSampledTrace;
+
+  // The spans buffered by a worker.
+  struct WorkerBuffer : public ThreadLocal::ThreadLocalObject {
+    explicit WorkerBuffer(Event::Dispatcher& dispatcher) : dispatcher_(dispatcher) {}
+
+    Event::Dispatcher& dispatcher_;
+    uint64_t buffered_bytes_{};
+  };
+
+  // Whether a tag set on a span keeps its trace.
+  bool keepsTag(absl::string_view name, absl::string_view value) const;
+  // Whether a trace which none of its tags kept is kept, given the latency of its request.
+  bool keepsTrace(std::chrono::nanoseconds latency);
+
+  const absl::optional<std::chrono::milliseconds> latency_threshold_;
+  const bool keep_errors_;
+  std::vector<std::pair<std::string, std::string>> keep_tags_;
+  const UnitFloat random_sampling_;
+  const std::chrono::milliseconds decision_wait_;
+  const uint64_t max_buffered_bytes_;
+  TimeSource& time_source_;
+  Random::RandomGenerator& random_;
+  TailSamplerStats stats_;
+  ThreadLocal::TypedSlot<WorkerBuffer> tls_;
+};
+
+using TailSamplerPtr = std::unique_ptr<TailSampler>;
+using TailSamplerSharedPtr = std::shared_ptr<TailSampler>;
+
+/**
+ * The spans of a request, which are finished once the trace of the request is decided. The trace
+ * is shared by the wrappers of its spans, and so destroyed with the last of them.
+ */
+class TailSampledTrace {
+public:
+  TailSampledTrace(TailSampler& sampler, TailSampler::WorkerBuffer& worker,
+                   MonotonicTime start_time);
+  ~TailSampledTrace();
+
+  /**
+   * Takes a span of the trace, which stays owned by the trace until it is destroyed so that it
+   * can be finished after its wrapper is.
+   * @return the span.
+   */
+  Span& addSpan(SpanPtr&& span);
+
+  /**
+   * Notes a tag set on a span of the trace, which may keep the trace.
+   */
+  void onTag(absl::string_view name, absl::string_view value);
+
+  /**
+   * Finishes a span once the trace is decided, or right away if it is the downstream span of the
+   * request, which decides the trace.
+   * @param span the span which finished.
+   * @param bytes the estimate of the bytes the span holds.
+   * @param root whether the span is the downstream span of the request.
+   */
+  void onFinished(Span& span, uint64_t bytes, bool root);
+
+private:
+  struct BufferedSpan {
+    Span& span_;
+    uint64_t bytes_;
+    SystemTime end_time_;
+    MonotonicTime monotonic_end_time_;
+  };
+
+  void decide(bool keep);
+  // Finishes the spans buffered, as of the time each of them finished.
+  void finishBufferedSpans();
+
+  TailSampler& sampler_;
+  TailSampler::WorkerBuffer& worker_;
+  const MonotonicTime start_time_;
+  std::vector<SpanPtr> spans_;
+  std::vector<BufferedSpan> buffered_spans_;
+  uint64_t buffered_bytes_{};
+  bool kept_by_tag_{};
+  absl::optional<bool> keep_;
+  Event::TimerPtr decision_timer_;
+};
+
+using TailSampledTraceSharedPtr = std::shared_ptr<TailSampledTrace>;
+
+/**
+ * Wraps a span of the trace driver, to have its trace finish it once the trace is decided.
+ */
+class TailSampledSpan : public Span {
+public:
+  TailSampledSpan(TailSampledTraceSharedPtr trace, SpanPtr&& span, bool root);
+
+  // Tracing::Span
+  void setOperation(absl::string_view operation) override;
+  void setTag(absl::string_view name, absl::string_view value) override;
+  void log(SystemTime timestamp, const std::string& event) override;
+  void finishSpan() override;
+  void injectContext(TraceContext& trace_context) override { span_.injectContext(trace_context); }
+  SpanPtr spawnChild(const Config& config, const std::string& name,
+                     SystemTime start_time) override;
+  void setSampled(bool sampled) override { span_.setSampled(sampled); }
+  std::string getBaggage(absl::string_view key) override { return span_.getBaggage(key); }
+  void setBaggage(absl::string_view key, absl::string_view value) override;
+  std::string getTraceIdAsHex() const override { return span_.getTraceIdAsHex(); }
+
+private:
+  const TailSampledTraceSharedPtr trace_;
+  Span& span_;
+  const bool root_;
+  // The estimate of the bytes the span holds, with what was set on it.
+  uint64_t bytes_;
+};
+
+} // namespace Tracing
+} // namespace Envoy
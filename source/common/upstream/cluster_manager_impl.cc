@@ -20,6 +20,8 @@
 #include "source/common/common/assert.h"
 #include "source/common/common/enum_to_int.h"
 #include "source/common/common/fmt.h"
+#include "source/common/common/hash.h"
+#include "source/common/common/thread.h"
 #include "source/common/common/utility.h"
 #include "source/common/config/new_grpc_mux_impl.h"
 #include "source/common/config/utility.h"
@@ -27,6 +29,7 @@
 #include "source/common/config/xds_resource.h"
 #include "source/common/grpc/async_client_manager_impl.h"
 #include "source/common/http/async_client_impl.h"
+#include "source/common/http/cross_worker_conn_pool.h"
 #include "source/common/http/http1/conn_pool.h"
 #include "source/common/http/http2/conn_pool.h"
 #include "source/common/http/mixed_conn_pool.h"
@@ -259,6 +262,50 @@ void ClusterManagerInitHelper::setPrimaryClustersInitializedCb(
   }
 }
 
+ClusterInitThreadPool::ClusterInitThreadPool(Thread::ThreadFactory& thread_factory,
+                                             uint32_t num_threads) {
+  threads_.reserve(num_threads);
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads_.push_back(thread_factory.createThread([this]() { threadRoutine(); },
+                                                   Thread::Options{"ClusterInit"}));
+  }
+}
+
+ClusterInitThreadPool::~ClusterInitThreadPool() {
+  {
+    Thread::LockGuard lock(mutex_);
+    stopping_ = true;
+    cond_var_.notifyAll();
+  }
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+void ClusterInitThreadPool::post(std::function<void()> cb) {
+  Thread::LockGuard lock(mutex_);
+  queue_.push_back(std::move(cb));
+  cond_var_.notifyOne();
+}
+
+void ClusterInitThreadPool::threadRoutine() {
+  while (true) {
+    std::function<void()> cb;
+    {
+      Thread::LockGuard lock(mutex_);
+      while (!stopping_ && queue_.empty()) {
+        cond_var_.wait(mutex_);
+      }
+      if (stopping_) {
+        return;
+      }
+      cb = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    cb();
+  }
+}
+
 ClusterManagerImpl::ClusterManagerImpl(
     const envoy::config::bootstrap::v3::Bootstrap& bootstrap, ClusterManagerFactory& factory,
     Stats::Store& stats, ThreadLocal::Instance& tls, Runtime::Loader& runtime,
@@ -283,10 +330,17 @@ ClusterManagerImpl::ClusterManagerImpl(
       cluster_circuit_breakers_stat_names_(stats.symbolTable()),
       cluster_request_response_size_stat_names_(stats.symbolTable()),
       cluster_timeout_budget_stat_names_(stats.symbolTable()),
+      lazy_cluster_stats_(bootstrap.stats_config().lazy_cluster_stats()),
+      cluster_init_thread_pool_(bootstrap.cluster_manager().cluster_init_threads() > 0
+                                    ? std::make_unique<ClusterInitThreadPool>(
+                                          api.threadFactory(),
+                                          bootstrap.cluster_manager().cluster_init_threads())
+                                    : nullptr),
       subscription_factory_(local_info, main_thread_dispatcher, *this,
                             validation_context.dynamicValidationVisitor(), api) {
   async_client_manager_ = std::make_unique<Grpc::AsyncClientManagerImpl>(
-      *this, tls, time_source_, api, grpc_context.statNames());
+      *this, tls, time_source_, api, grpc_context.statNames(),
+      bootstrap.cluster_manager().google_grpc_completion_threads());
   const auto& cm_config = bootstrap.cluster_manager();
   if (cm_config.has_outlier_detection()) {
     const std::string event_log_file_path = cm_config.outlier_detection().event_log_path();
@@ -338,6 +392,9 @@ ClusterManagerImpl::ClusterManagerImpl(
   if (dyn_resources.has_ads_config()) {
     if (dyn_resources.ads_config().api_type() ==
         envoy::config::core::v3::ApiConfigSource::DELTA_GRPC) {
+      if (!dyn_resources.ads_resource_cache_directory().empty()) {
+        throw EnvoyException("ads_resource_cache_directory is not supported for DELTA_GRPC ADS");
+      }
       ads_mux_ = std::make_shared<Config::NewGrpcMuxImpl>(
           Config::Utility::factoryForGrpcApiConfigSource(*async_client_manager_,
                                                          dyn_resources.ads_config(), stats, false)
@@ -352,7 +409,9 @@ ClusterManagerImpl::ClusterManagerImpl(
                   : "envoy.service.discovery.v2.AggregatedDiscoveryService."
                     "DeltaAggregatedResources"),
           Config::Utility::getAndCheckTransportVersion(dyn_resources.ads_config()), random_, stats_,
-          Envoy::Config::Utility::parseRateLimitSettings(dyn_resources.ads_config()), local_info);
+          Envoy::Config::Utility::parseRateLimitSettings(dyn_resources.ads_config()), local_info,
+          std::chrono::milliseconds(
+              PROTOBUF_GET_MS_OR_DEFAULT(dyn_resources.ads_config(), update_coalescing_window, 0)));
     } else {
       ads_mux_ = std::make_shared<Config::GrpcMuxImpl>(
           local_info,
@@ -371,7 +430,11 @@ ClusterManagerImpl::ClusterManagerImpl(
                     "StreamAggregatedResources"),
           Config::Utility::getAndCheckTransportVersion(dyn_resources.ads_config()), random_, stats_,
           Envoy::Config::Utility::parseRateLimitSettings(dyn_resources.ads_config()),
-          bootstrap.dynamic_resources().ads_config().set_node_on_first_message_only());
+          bootstrap.dynamic_resources().ads_config().set_node_on_first_message_only(),
+          dyn_resources.ads_resource_cache_directory().empty()
+              ? nullptr
+              : std::make_unique<Config::XdsResourceCache>(
+                    api.fileSystem(), dyn_resources.ads_resource_cache_directory()));
     }
   } else {
     ads_mux_ = std::make_unique<Config::NullGrpcMuxImpl>();
@@ -406,6 +469,10 @@ ClusterManagerImpl::ClusterManagerImpl(
   // Once the initial set of static bootstrap clusters are created (including the local cluster),
   // we can instantiate the thread local cluster manager.
   tls_.set([this, local_cluster_params](Event::Dispatcher& dispatcher) {
+    if (!Thread::MainThread::isMainThread()) {
+      absl::MutexLock lock(&worker_dispatchers_lock_);
+      worker_dispatchers_.push_back(&dispatcher);
+    }
     return std::make_shared<ThreadLocalClusterManagerImpl>(*this, dispatcher, local_cluster_params);
   });
 
@@ -453,6 +520,122 @@ void ClusterManagerImpl::initializeSecondaryClusters(
   }
 }
 
+bool ClusterManagerImpl::runOnClusterInitThread(std::function<void()> work,
+                                                Event::PostCb done) {
+  if (cluster_init_thread_pool_ == nullptr) {
+    return false;
+  }
+  cluster_init_thread_pool_->post(
+      [work = std::move(work), done = std::move(done), &dispatcher = dispatcher_]() mutable {
+        work();
+        dispatcher.post(std::move(done));
+      });
+  return true;
+}
+
+OdCdsApiHandleSharedPtr
+ClusterManagerImpl::allocateOdCdsApi(const envoy::config::core::v3::ConfigSource& odcds_config,
+                                     std::chrono::milliseconds negative_cache_ttl,
+                                     ProtobufMessage::ValidationVisitor& validation_visitor) {
+  // The filters configured with the same discovery service share its subscription.
+  const uint64_t odcds_key = HashUtil::xxHash64(std::to_string(negative_cache_ttl.count()),
+                                                MessageUtil::hash(odcds_config));
+  if (!odcds_apis_.contains(odcds_key)) {
+    odcds_apis_.emplace(odcds_key,
+                        OdCdsApiImpl::create(odcds_config, negative_cache_ttl, *this, *this,
+                                             stats_, time_source_, validation_visitor));
+  }
+  return std::make_shared<OdCdsApiHandleImpl>(*this, odcds_key);
+}
+
+void ClusterManagerImpl::requestOnDemandClusterDiscovery(uint64_t odcds_key,
+                                                         absl::string_view name,
+                                                         ClusterDiscoveryCallbackWeakPtr callback,
+                                                         std::chrono::milliseconds timeout) {
+  ThreadLocalClusterManagerImpl& cluster_manager = *tls_;
+  if (cluster_manager.thread_local_clusters_.contains(name)) {
+    if (auto cb = callback.lock(); cb != nullptr) {
+      (*cb)(ClusterDiscoveryStatus::Available);
+    }
+    return;
+  }
+
+  auto& callbacks = cluster_manager.pending_cluster_discoveries_[std::string(name)];
+  callbacks.push_back(std::move(callback));
+  if (callbacks.size() > 1) {
+    // This worker already waits for the cluster.
+    return;
+  }
+  dispatcher_.post([this, odcds_key, name = std::string(name), timeout]() {
+    discoverCluster(odcds_key, name, timeout);
+  });
+}
+
+void ClusterManagerImpl::discoverCluster(uint64_t odcds_key, const std::string& name,
+                                         std::chrono::milliseconds timeout) {
+  if (active_clusters_.count(name) > 0) {
+    // The cluster was added while the discovery was posted, and the worker may have missed it.
+    notifyClusterDiscovery(name, ClusterDiscoveryStatus::Available);
+    return;
+  }
+  if (pending_cluster_discoveries_.contains(name)) {
+    // Another worker already requested the cluster, the outcome of which is sent to all of them.
+    return;
+  }
+  auto odcds_it = odcds_apis_.find(odcds_key);
+  if (odcds_it == odcds_apis_.end()) {
+    // The cluster manager is shutting down.
+    notifyClusterDiscovery(name, ClusterDiscoveryStatus::Missing);
+    return;
+  }
+  OdCdsApiImpl& odcds = *odcds_it->second;
+  if (odcds.isMissing(name)) {
+    odcds.stats().cluster_negative_cache_hit_.inc();
+    notifyClusterDiscovery(name, ClusterDiscoveryStatus::Missing);
+    return;
+  }
+
+  Event::TimerPtr timeout_timer =
+      dispatcher_.createTimer([this, name]() { onClusterDiscoveryTimeout(name); });
+  timeout_timer->enableTimer(timeout);
+  pending_cluster_discoveries_.emplace(
+      name, PendingClusterDiscovery{odcds_key, std::move(timeout_timer)});
+  // A warming cluster is sent to the workers once it is warm, without being requested again.
+  if (warming_clusters_.count(name) == 0) {
+    odcds.updateOnDemand(name);
+  }
+}
+
+void ClusterManagerImpl::onClusterDiscoveryTimeout(std::string name) {
+  auto it = pending_cluster_discoveries_.find(name);
+  ASSERT(it != pending_cluster_discoveries_.end());
+  auto odcds_it = odcds_apis_.find(it->second.odcds_key_);
+  if (odcds_it != odcds_apis_.end()) {
+    odcds_it->second->stats().cluster_timeout_.inc();
+  }
+  ENVOY_LOG(debug, "on demand discovery of cluster {} timed out", name);
+  // This destroys the timer running this callback, the name being a copy.
+  pending_cluster_discoveries_.erase(it);
+  notifyClusterDiscovery(name, ClusterDiscoveryStatus::Timeout);
+}
+
+void ClusterManagerImpl::notifyMissingCluster(absl::string_view name) {
+  auto it = pending_cluster_discoveries_.find(name);
+  if (it == pending_cluster_discoveries_.end()) {
+    return;
+  }
+  ENVOY_LOG(debug, "cluster {} is missing from on demand discovery", name);
+  pending_cluster_discoveries_.erase(it);
+  notifyClusterDiscovery(std::string(name), ClusterDiscoveryStatus::Missing);
+}
+
+void ClusterManagerImpl::notifyClusterDiscovery(const std::string& name,
+                                                ClusterDiscoveryStatus status) {
+  tls_.runOnAllThreads([name, status](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
+    cluster_manager->processClusterDiscovery(name, status);
+  });
+}
+
 ClusterManagerStats ClusterManagerImpl::generateStats(Stats::Scope& scope) {
   const std::string final_prefix = "cluster_manager.";
   return {ALL_CLUSTER_MANAGER_STATS(POOL_COUNTER_PREFIX(scope, final_prefix),
@@ -474,6 +657,7 @@ void ClusterManagerImpl::onClusterInit(ClusterManagerCluster& cm_cluster) {
     updateClusterCounts();
   }
   cluster_data = active_clusters_.find(cluster.info()->name());
+  Init::StartupProfile::endStep(cluster_data->second->startup_step_);
 
   if (cluster_data->second->thread_aware_lb_ != nullptr) {
     cluster_data->second->thread_aware_lb_->initialize();
@@ -908,6 +1092,15 @@ void ClusterManagerImpl::maybePreconnect(
   }
 }
 
+Event::Dispatcher* ClusterManagerImpl::sharedHttp2PoolOwner(const Host& host) {
+  absl::MutexLock lock(&worker_dispatchers_lock_);
+  if (worker_dispatchers_.empty()) {
+    return nullptr;
+  }
+  return worker_dispatchers_[HashUtil::xxHash64(host.address()->asStringView()) %
+                             worker_dispatchers_.size()];
+}
+
 absl::optional<HttpPoolData>
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::httpConnPool(
     ResourcePriority priority, absl::optional<Http::Protocol> protocol,
@@ -978,6 +1171,11 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(ClusterManagerCluster& cm_
     per_priority.overprovisioning_factor_ = host_set->overprovisioningFactor();
   }
 
+  if (add_or_update_cluster) {
+    // The discovery of the cluster, if any, is done once the workers have it.
+    pending_cluster_discoveries_.erase(cm_cluster.cluster().info()->name());
+  }
+
   tls_.runOnAllThreads(
       [info = cm_cluster.cluster().info(), params = std::move(params), add_or_update_cluster,
        load_balancer_factory](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
@@ -1005,6 +1203,8 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(ClusterManagerCluster& cm_
           for (auto& cb : cluster_manager->update_callbacks_) {
             cb->onClusterAddOrUpdate(*new_cluster);
           }
+          cluster_manager->processClusterDiscovery(info->name(),
+                                                   ClusterDiscoveryStatus::Available);
         }
       });
 }
@@ -1208,14 +1408,24 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
   const auto& cluster_entry = thread_local_clusters_[name];
   ENVOY_LOG(debug, "membership update for TLS cluster {} added {} removed {}", name,
             hosts_added.size(), hosts_removed.size());
-  cluster_entry->priority_set_.updateHosts(priority, std::move(update_hosts_params),
-                                           std::move(locality_weights), hosts_added, hosts_removed,
-                                           overprovisioning_factor);
+  cluster_entry->updateHosts(priority, std::move(update_hosts_params), std::move(locality_weights),
+                             hosts_added, hosts_removed, overprovisioning_factor);
+}
 
-  // If an LB is thread aware, create a new worker local LB on membership changes.
-  if (cluster_entry->lb_factory_ != nullptr) {
-    ENVOY_LOG(debug, "re-creating local LB for TLS cluster {}", name);
-    cluster_entry->lb_ = cluster_entry->lb_factory_->create();
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::processClusterDiscovery(
+    const std::string& name, ClusterDiscoveryStatus status) {
+  auto it = pending_cluster_discoveries_.find(name);
+  if (it == pending_cluster_discoveries_.end()) {
+    return;
+  }
+  // The callbacks may request other discoveries, so they are taken out of the map first.
+  std::vector<ClusterDiscoveryCallbackWeakPtr> callbacks = std::move(it->second);
+  pending_cluster_discoveries_.erase(it);
+  for (const ClusterDiscoveryCallbackWeakPtr& callback : callbacks) {
+    // The callbacks of the requesters which went away are expired.
+    if (auto cb = callback.lock(); cb != nullptr) {
+      (*cb)(status);
+    }
   }
 }
 
@@ -1319,14 +1529,23 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
         cluster->lbType(), priority_set_, parent_.local_priority_set_, cluster->stats(),
         cluster->statsScope(), parent.parent_.runtime_, parent.parent_.random_,
         cluster->lbSubsetInfo(), cluster->lbRingHashConfig(), cluster->lbMaglevConfig(),
-        cluster->lbLeastRequestConfig(), cluster->lbConfig());
+        cluster->lbLeastRequestConfig(), cluster->lbConfig(), parent.parent_.time_source_);
   } else {
     switch (cluster->lbType()) {
     case LoadBalancerType::LeastRequest: {
       ASSERT(lb_factory_ == nullptr);
       lb_ = std::make_unique<LeastRequestLoadBalancer>(
           priority_set_, parent_.local_priority_set_, cluster->stats(), parent.parent_.runtime_,
-          parent.parent_.random_, cluster->lbConfig(), cluster->lbLeastRequestConfig());
+          parent.parent_.random_, cluster->lbConfig(), cluster->lbLeastRequestConfig(),
+          parent.parent_.time_source_);
+      break;
+    }
+    case LoadBalancerType::PeakEwma: {
+      ASSERT(lb_factory_ == nullptr);
+      lb_ = std::make_unique<PeakEwmaLoadBalancer>(
+          priority_set_, parent_.local_priority_set_, cluster->stats(), parent.parent_.runtime_,
+          parent.parent_.random_, cluster->lbConfig(), cluster->lbPeakEwmaConfig(),
+          parent.parent_.time_source_);
       break;
     }
     case LoadBalancerType::Random: {
@@ -1338,9 +1557,9 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
     }
     case LoadBalancerType::RoundRobin: {
       ASSERT(lb_factory_ == nullptr);
-      lb_ = std::make_unique<RoundRobinLoadBalancer>(priority_set_, parent_.local_priority_set_,
-                                                     cluster->stats(), parent.parent_.runtime_,
-                                                     parent.parent_.random_, cluster->lbConfig());
+      lb_ = std::make_unique<RoundRobinLoadBalancer>(
+          priority_set_, parent_.local_priority_set_, cluster->stats(), parent.parent_.runtime_,
+          parent.parent_.random_, cluster->lbConfig(), parent.parent_.time_source_);
       break;
     }
     case LoadBalancerType::ClusterProvided:
@@ -1362,11 +1581,154 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::~ClusterEntry()
   // TODO(mattklein123): Optimally, we would just fire member changed callbacks and remove all of
   // the hosts inside of the HostImpl destructor. That is a change with wide implications, so we are
   // going with a more targeted approach for now.
+  warming_hosts_.clear();
   for (auto& host_set : priority_set_.hostSetsPerPriority()) {
     parent_.drainConnPools(host_set->hosts());
   }
 }
 
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::updateHosts(
+    uint32_t priority, PrioritySet::UpdateHostsParams&& update_hosts_params,
+    LocalityWeightsConstSharedPtr locality_weights, const HostVector& hosts_added,
+    const HostVector& hosts_removed, uint64_t overprovisioning_factor) {
+  if (cluster_info_->warmUpConnections() > 0) {
+    for (const HostSharedPtr& host : hosts_removed) {
+      warming_hosts_.erase(host.get());
+    }
+    // New hosts are only kept out of the load balancing if there are other hosts to send the
+    // traffic to, rather than failing it until they are warmed up.
+    absl::flat_hash_set<const Host*> added;
+    for (const HostSharedPtr& host : hosts_added) {
+      added.insert(host.get());
+    }
+    const bool exclude = std::any_of(
+        update_hosts_params.healthy_hosts->get().begin(),
+        update_hosts_params.healthy_hosts->get().end(), [&](const HostSharedPtr& host) {
+          return !added.contains(host.get()) && !warming_hosts_.contains(host.get());
+        });
+    updating_hosts_ = true;
+    for (const HostSharedPtr& host : hosts_added) {
+      if (host->health() == Host::Health::Healthy) {
+        warmUpHost(host, priority, exclude);
+      }
+    }
+    updating_hosts_ = false;
+    last_updates_[priority] = {update_hosts_params, locality_weights, overprovisioning_factor};
+    if (!warming_hosts_.empty()) {
+      update_hosts_params = excludeWarmingHosts(update_hosts_params);
+    }
+  }
+
+  priority_set_.updateHosts(priority, std::move(update_hosts_params), std::move(locality_weights),
+                            hosts_added, hosts_removed, overprovisioning_factor);
+
+  // If an LB is thread aware, create a new worker local LB on membership changes.
+  if (lb_factory_ != nullptr) {
+    ENVOY_LOG(debug, "re-creating local LB for TLS cluster {}", cluster_info_->name());
+    lb_ = lb_factory_->create();
+  }
+}
+
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::warmUpHost(
+    const HostConstSharedPtr& host, uint32_t priority, bool exclude) {
+  Http::ConnectionPool::Instance* pool =
+      hostConnPool(host, ResourcePriority::Default, absl::nullopt, nullptr);
+  if (pool == nullptr) {
+    return;
+  }
+  if (!exclude) {
+    pool->warmUp(cluster_info_->warmUpConnections(), []() {});
+    return;
+  }
+
+  ENVOY_LOG(debug, "warming up host {} of TLS cluster {}", host->address()->asString(),
+            cluster_info_->name());
+  cluster_info_->stats().upstream_host_warm_up_.inc();
+  auto warming_host = std::make_shared<WarmingHost>(WarmingHost{priority, nullptr});
+  warming_host->timeout_timer_ =
+      parent_.thread_local_dispatcher_.createTimer([this, host = host.get()]() {
+        cluster_info_->stats().upstream_host_warm_up_timeout_.inc();
+        onHostWarmedUp(host);
+      });
+  warming_host->timeout_timer_->enableTimer(cluster_info_->warmUpTimeout());
+  warming_hosts_.emplace(host.get(), warming_host);
+  pool->warmUp(cluster_info_->warmUpConnections(),
+               [this, host = host.get(), weak_warming_host = std::weak_ptr<WarmingHost>(
+                                             warming_host)]() {
+                 if (weak_warming_host.lock() != nullptr) {
+                   onHostWarmedUp(host);
+                 }
+               });
+}
+
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::onHostWarmedUp(
+    const Host* host) {
+  auto it = warming_hosts_.find(host);
+  if (it == warming_hosts_.end()) {
+    return;
+  }
+  const uint32_t priority = it->second->priority_;
+  // This may be the timeout timer's callback, which is then destroyed, as connection pools do with
+  // their connect timers.
+  warming_hosts_.erase(it);
+  if (updating_hosts_) {
+    // The update being applied doesn't exclude the host anymore.
+    return;
+  }
+
+  ENVOY_LOG(debug, "host {} of TLS cluster {} is warmed up", host->address()->asString(),
+            cluster_info_->name());
+  const PriorityUpdate& update = last_updates_.at(priority);
+  priority_set_.updateHosts(priority, excludeWarmingHosts(update.update_hosts_params_),
+                            update.locality_weights_, {}, {}, update.overprovisioning_factor_);
+  if (lb_factory_ != nullptr) {
+    lb_ = lb_factory_->create();
+  }
+}
+
+PrioritySet::UpdateHostsParams
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::excludeWarmingHosts(
+    const PrioritySet::UpdateHostsParams& update_hosts_params) const {
+  auto warming = [this](const Host& host) { return warming_hosts_.contains(&host); };
+  absl::flat_hash_set<const Host*> excluded;
+  for (const HostSharedPtr& host : update_hosts_params.excluded_hosts->get()) {
+    excluded.insert(host.get());
+  }
+
+  auto healthy_hosts = std::make_shared<HealthyHostVector>();
+  for (const HostSharedPtr& host : update_hosts_params.healthy_hosts->get()) {
+    if (!warming(*host)) {
+      healthy_hosts->get().push_back(host);
+    }
+  }
+  auto degraded_hosts = std::make_shared<DegradedHostVector>();
+  for (const HostSharedPtr& host : update_hosts_params.degraded_hosts->get()) {
+    if (!warming(*host)) {
+      degraded_hosts->get().push_back(host);
+    }
+  }
+  // The warming hosts are excluded, so that they don't count as unavailable for the panic
+  // threshold nor the locality weights.
+  auto excluded_hosts = std::make_shared<ExcludedHostVector>();
+  for (const HostSharedPtr& host : update_hosts_params.hosts->get()) {
+    if (excluded.contains(host.get()) || warming(*host)) {
+      excluded_hosts->get().push_back(host);
+    }
+  }
+
+  auto not_warming = [&warming](const Host& host) { return !warming(host); };
+  return HostSetImpl::updateHostsParams(
+      update_hosts_params.hosts, update_hosts_params.hosts_per_locality, std::move(healthy_hosts),
+      update_hosts_params.healthy_hosts_per_locality->filter({not_warming})[0],
+      std::move(degraded_hosts),
+      update_hosts_params.degraded_hosts_per_locality->filter({not_warming})[0],
+      std::move(excluded_hosts),
+      update_hosts_params.hosts_per_locality->filter(
+          {[&excluded, &warming](const Host& host) {
+            return excluded.contains(&host) || warming(host);
+          }})[0]);
+}
+
 Http::ConnectionPool::Instance*
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPool(
     ResourcePriority priority, absl::optional<Http::Protocol> downstream_protocol,
@@ -1379,7 +1741,13 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPool(
     }
     return nullptr;
   }
+  return hostConnPool(host, priority, downstream_protocol, context);
+}
 
+Http::ConnectionPool::Instance*
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::hostConnPool(
+    const HostConstSharedPtr& host, ResourcePriority priority,
+    absl::optional<Http::Protocol> downstream_protocol, LoadBalancerContext* context) {
   // Right now, HTTP, HTTP/2 and ALPN pools are considered separate.
   // We could do better here, and always use the ALPN pool and simply make sure
   // we end up on a connection of the correct protocol, but for simplicity we're
@@ -1421,21 +1789,48 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPool(
     context->downstreamConnection()->hashKey(hash_key);
   }
 
+  // Streams with their own socket or transport socket options, or which need a pool of their own,
+  // stay on this worker's connections.
+  const bool share_across_workers =
+      cluster_info_->shareHttp2ConnectionPoolsAcrossWorkers() &&
+      upstream_protocols.size() == 1 && upstream_protocols[0] == Http::Protocol::Http2 &&
+      upstream_options->empty() && !have_transport_socket_options &&
+      !cluster_info_->connectionPoolPerDownstreamConnection();
+
   ConnPoolsContainer& container = *parent_.getHttpConnPoolsContainer(host, true);
 
   // Note: to simplify this, we assume that the factory is only called in the scope of this
   // function. Otherwise, we'd need to capture a few of these variables by value.
   ConnPoolsContainer::ConnPools::PoolOptRef pool =
-      container.pools_->getPool(priority, hash_key, [&]() {
-        auto pool = parent_.parent_.factory_.allocateConnPool(
-            parent_.thread_local_dispatcher_, host, priority, upstream_protocols,
-            alternate_protocol_options, !upstream_options->empty() ? upstream_options : nullptr,
-            have_transport_socket_options ? context->upstreamTransportSocketOptions() : nullptr,
-            parent_.parent_.time_source_, parent_.cluster_manager_state_);
+      container.pools_->getPool(priority, hash_key, [&]() -> Http::ConnectionPool::InstancePtr {
+        Event::Dispatcher* owner =
+            share_across_workers ? parent_.parent_.sharedHttp2PoolOwner(*host) : nullptr;
+        if (owner == nullptr || owner == &parent_.thread_local_dispatcher_) {
+          return allocateHttpConnPool(
+              host, priority, upstream_protocols, alternate_protocol_options,
+              !upstream_options->empty() ? upstream_options : nullptr,
+              have_transport_socket_options ? context->upstreamTransportSocketOptions() : nullptr,
+              hash_key);
+        }
 
+        ENVOY_LOG(debug, "forwarding HTTP/2 streams for host {} to worker {}", host->address(),
+                  owner->name());
+        // This runs on the owning worker, where the cluster may have been removed already.
+        auto pool = std::make_unique<Http::CrossWorkerConnPool>(
+            parent_.thread_local_dispatcher_, *owner, host,
+            [&cluster_manager = parent_.parent_, cluster_name = cluster_info_->name(), host,
+             priority, alternate_protocol_options,
+             hash_key]() -> Http::ConnectionPool::Instance* {
+              ThreadLocalClusterManagerImpl& owner_cluster_manager = *cluster_manager.tls_;
+              auto entry = owner_cluster_manager.thread_local_clusters_.find(cluster_name);
+              if (entry == owner_cluster_manager.thread_local_clusters_.end()) {
+                return nullptr;
+              }
+              return entry->second->sharedHttp2ConnPool(host, priority,
+                                                        alternate_protocol_options, hash_key);
+            });
         pool->addIdleCallback(
             [this, host, priority, hash_key]() { httpConnPoolIsIdle(host, priority, hash_key); });
-
         return pool;
       });
 
@@ -1446,6 +1841,46 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPool(
   }
 }
 
+Http::ConnectionPool::InstancePtr
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::allocateHttpConnPool(
+    const HostConstSharedPtr& host, ResourcePriority priority,
+    const std::vector<Http::Protocol>& upstream_protocols,
+    const absl::optional<envoy::config::core::v3::AlternateProtocolsCacheOptions>&
+        alternate_protocol_options,
+    const Network::ConnectionSocket::OptionsSharedPtr& options,
+    const Network::TransportSocketOptionsConstSharedPtr& transport_socket_options,
+    const std::vector<uint8_t>& hash_key) {
+  auto pool = parent_.parent_.factory_.allocateConnPool(
+      parent_.thread_local_dispatcher_, host, priority, upstream_protocols,
+      alternate_protocol_options, options, transport_socket_options, parent_.parent_.time_source_,
+      parent_.cluster_manager_state_);
+
+  pool->addIdleCallback(
+      [this, host, priority, hash_key]() { httpConnPoolIsIdle(host, priority, hash_key); });
+
+  return pool;
+}
+
+Http::ConnectionPool::Instance*
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::sharedHttp2ConnPool(
+    const HostConstSharedPtr& host, ResourcePriority priority,
+    const absl::optional<envoy::config::core::v3::AlternateProtocolsCacheOptions>&
+        alternate_protocol_options,
+    const std::vector<uint8_t>& hash_key) {
+  ConnPoolsContainer& container = *parent_.getHttpConnPoolsContainer(host, true);
+  ConnPoolsContainer::ConnPools::PoolOptRef pool =
+      container.pools_->getPool(priority, hash_key, [&]() {
+        return allocateHttpConnPool(host, priority, {Http::Protocol::Http2},
+                                    alternate_protocol_options, nullptr, nullptr, hash_key);
+      });
+
+  if (pool.has_value()) {
+    return &(pool.value().get());
+  } else {
+    return nullptr;
+  }
+}
+
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::httpConnPoolIsIdle(
     HostConstSharedPtr host, ResourcePriority priority, const std::vector<uint8_t>& hash_key) {
   if (parent_.destroying_) {
@@ -2,6 +2,7 @@
 
 #include <array>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <list>
 #include <map>
@@ -27,15 +28,23 @@
 #include "envoy/upstream/cluster_manager.h"
 
 #include "source/common/common/cleanup.h"
+#include "source/common/common/thread.h"
 #include "source/common/config/grpc_mux_impl.h"
 #include "source/common/config/subscription_factory_impl.h"
 #include "source/common/http/alternate_protocols_cache_impl.h"
 #include "source/common/http/alternate_protocols_cache_manager_impl.h"
 #include "source/common/http/async_client_impl.h"
+#include "source/common/init/startup_profile.h"
 #include "source/common/upstream/load_stats_reporter.h"
+#include "source/common/upstream/od_cds_api_impl.h"
 #include "source/common/upstream/priority_conn_pool_map.h"
 #include "source/common/upstream/upstream_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -61,8 +70,8 @@ public:
         dns_resolver_(dns_resolver), ssl_context_manager_(ssl_context_manager),
         local_info_(local_info), secret_manager_(secret_manager), log_manager_(log_manager),
         singleton_manager_(singleton_manager), options_(options),
-        alternate_protocols_cache_manager_factory_(singleton_manager,
-                                                   main_thread_dispatcher.timeSource(), tls_),
+        alternate_protocols_cache_manager_factory_(
+            singleton_manager, main_thread_dispatcher.timeSource(), tls_, api_.fileSystem()),
         alternate_protocols_cache_manager_(alternate_protocols_cache_manager_factory_.get()) {}
 
   // Upstream::ClusterManagerFactory
@@ -136,6 +145,31 @@ public:
   virtual void setAddedOrUpdated() PURE;
 };
 
+/**
+ * Threads on which the CPU heavy parts of creating clusters are done when configured with
+ * cluster_manager.cluster_init_threads. See ClusterManager::runOnClusterInitThread().
+ */
+class ClusterInitThreadPool {
+public:
+  ClusterInitThreadPool(Thread::ThreadFactory& thread_factory, uint32_t num_threads);
+  ~ClusterInitThreadPool();
+
+  /**
+   * Queues cb to run on the first free thread. Callbacks still queued when the pool is destroyed
+   * are dropped.
+   */
+  void post(std::function<void()> cb);
+
+private:
+  void threadRoutine();
+
+  Thread::MutexBasicLockable mutex_;
+  Thread::CondVar cond_var_;
+  std::deque<std::function<void()>> queue_ ABSL_GUARDED_BY(mutex_);
+  bool stopping_ ABSL_GUARDED_BY(mutex_){false};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
 /**
  * This is a helper class used during cluster management initialization. Dealing with primary
  * clusters, secondary clusters, and CDS, is quite complicated, so this makes it easier to test.
@@ -229,7 +263,9 @@ struct ClusterManagerStats {
  * Implementation of ClusterManager that reads from a proto configuration, maintains a central
  * cluster list, as well as thread local caches of each cluster and associated connection pools.
  */
-class ClusterManagerImpl : public ClusterManager, Logger::Loggable<Logger::Id::upstream> {
+class ClusterManagerImpl : public ClusterManager,
+                           public MissingClusterNotifier,
+                           Logger::Loggable<Logger::Id::upstream> {
 public:
   ClusterManagerImpl(const envoy::config::bootstrap::v3::Bootstrap& bootstrap,
                      ClusterManagerFactory& factory, Stats::Store& stats,
@@ -276,6 +312,8 @@ public:
     }
     // Make sure we destroy all potential outgoing connections before this returns.
     cds_api_.reset();
+    pending_cluster_discoveries_.clear();
+    odcds_apis_.clear();
     ads_mux_.reset();
     active_clusters_.clear();
     warming_clusters_.clear();
@@ -314,6 +352,15 @@ public:
   const ClusterTimeoutBudgetStatNames& clusterTimeoutBudgetStatNames() const override {
     return cluster_timeout_budget_stat_names_;
   }
+  bool lazyClusterStats() const override { return lazy_cluster_stats_; }
+  bool runOnClusterInitThread(std::function<void()> work, Event::PostCb done) override;
+  OdCdsApiHandleSharedPtr
+  allocateOdCdsApi(const envoy::config::core::v3::ConfigSource& odcds_config,
+                   std::chrono::milliseconds negative_cache_ttl,
+                   ProtobufMessage::ValidationVisitor& validation_visitor) override;
+
+  // Upstream::MissingClusterNotifier
+  void notifyMissingCluster(absl::string_view name) override;
 
 protected:
   virtual void postThreadLocalDrainConnections(const Cluster& cluster,
@@ -408,14 +455,48 @@ private:
       Http::ConnectionPool::Instance* connPool(ResourcePriority priority,
                                                absl::optional<Http::Protocol> downstream_protocol,
                                                LoadBalancerContext* context, bool peek);
+      // Returns the pool of a host for the given stream, creating it if needed.
+      Http::ConnectionPool::Instance*
+      hostConnPool(const HostConstSharedPtr& host, ResourcePriority priority,
+                   absl::optional<Http::Protocol> downstream_protocol,
+                   LoadBalancerContext* context);
 
       Tcp::ConnectionPool::Instance* tcpConnPool(ResourcePriority priority,
                                                  LoadBalancerContext* context, bool peek);
 
+      Http::ConnectionPool::InstancePtr allocateHttpConnPool(
+          const HostConstSharedPtr& host, ResourcePriority priority,
+          const std::vector<Http::Protocol>& upstream_protocols,
+          const absl::optional<envoy::config::core::v3::AlternateProtocolsCacheOptions>&
+              alternate_protocol_options,
+          const Network::ConnectionSocket::OptionsSharedPtr& options,
+          const Network::TransportSocketOptionsConstSharedPtr& transport_socket_options,
+          const std::vector<uint8_t>& hash_key);
+      // Called on the worker which owns the host's HTTP/2 connections to get the pool that other
+      // workers forward their streams to.
+      Http::ConnectionPool::Instance* sharedHttp2ConnPool(
+          const HostConstSharedPtr& host, ResourcePriority priority,
+          const absl::optional<envoy::config::core::v3::AlternateProtocolsCacheOptions>&
+              alternate_protocol_options,
+          const std::vector<uint8_t>& hash_key);
+
       void httpConnPoolIsIdle(HostConstSharedPtr host, ResourcePriority priority,
                               const std::vector<uint8_t>& hash_key);
       void tcpConnPoolIsIdle(HostConstSharedPtr host, const std::vector<uint8_t>& hash_key);
 
+      // Applies a membership update of the main thread, keeping the hosts being warmed up out of
+      // the load balancing.
+      void updateHosts(uint32_t priority, PrioritySet::UpdateHostsParams&& update_hosts_params,
+                       LocalityWeightsConstSharedPtr locality_weights,
+                       const HostVector& hosts_added, const HostVector& hosts_removed,
+                       uint64_t overprovisioning_factor);
+      // Establishes the warm-up connections of a new host. If exclude is true, the host is kept
+      // out of the load balancing until they are established or the warm-up times out.
+      void warmUpHost(const HostConstSharedPtr& host, uint32_t priority, bool exclude);
+      void onHostWarmedUp(const Host* host);
+      PrioritySet::UpdateHostsParams
+      excludeWarmingHosts(const PrioritySet::UpdateHostsParams& update_hosts_params) const;
+
       // Upstream::ThreadLocalCluster
       const PrioritySet& prioritySet() override { return priority_set_; }
       ClusterInfoConstSharedPtr info() override { return cluster_info_; }
@@ -438,6 +519,22 @@ private:
       LoadBalancerPtr lb_;
       ClusterInfoConstSharedPtr cluster_info_;
       Http::AsyncClientImpl http_async_client_;
+
+      struct WarmingHost {
+        const uint32_t priority_;
+        Event::TimerPtr timeout_timer_;
+      };
+      // The last membership update of a priority, applied again as its hosts are warmed up.
+      struct PriorityUpdate {
+        PrioritySet::UpdateHostsParams update_hosts_params_;
+        LocalityWeightsConstSharedPtr locality_weights_;
+        uint64_t overprovisioning_factor_;
+      };
+      // The hosts kept out of the load balancing while they are warmed up, which they are only if
+      // PreconnectPolicy.warm_up_connections is set. The pools hold weak references to them.
+      absl::flat_hash_map<const Host*, std::shared_ptr<WarmingHost>> warming_hosts_;
+      absl::flat_hash_map<uint32_t, PriorityUpdate> last_updates_;
+      bool updating_hosts_{};
     };
 
     using ClusterEntryPtr = std::unique_ptr<ClusterEntry>;
@@ -461,6 +558,8 @@ private:
                                  const HostVector& hosts_added, const HostVector& hosts_removed,
                                  uint64_t overprovisioning_factor);
     void onHostHealthFailure(const HostSharedPtr& host);
+    // Invokes the callbacks of the discoveries of the cluster requested from this worker.
+    void processClusterDiscovery(const std::string& name, ClusterDiscoveryStatus status);
 
     ConnPoolsContainer* getHttpConnPoolsContainer(const HostConstSharedPtr& host,
                                                   bool allocate = false);
@@ -478,6 +577,9 @@ private:
     absl::node_hash_map<HostConstSharedPtr, TcpConnectionsMap> host_tcp_conn_map_;
 
     std::list<Envoy::Upstream::ClusterUpdateCallbacks*> update_callbacks_;
+    // The callbacks of the discoveries requested from this worker, by the cluster they wait for.
+    absl::flat_hash_map<std::string, std::vector<ClusterDiscoveryCallbackWeakPtr>>
+        pending_cluster_discoveries_;
     const PrioritySet* local_priority_set_{};
     bool destroying_{};
   };
@@ -488,7 +590,10 @@ private:
                 bool added_via_api, ClusterSharedPtr&& cluster, TimeSource& time_source)
         : cluster_config_(cluster_config), config_hash_(cluster_config_hash),
           version_info_(version_info), added_via_api_(added_via_api), cluster_(std::move(cluster)),
-          last_updated_(time_source.systemTime()) {}
+          last_updated_(time_source.systemTime()),
+          startup_step_(Init::StartupProfile::beginStep(Init::StartupProfile::Kind::Cluster,
+                                                        absl::StrCat("cluster ",
+                                                                     cluster_config.name()))) {}
 
     bool blockUpdate(uint64_t hash) { return !added_via_api_ || config_hash_ == hash; }
 
@@ -518,6 +623,8 @@ private:
     bool added_or_updated_{};
     Common::CallbackHandlePtr member_update_cb_;
     Common::CallbackHandlePtr priority_update_cb_;
+    // Startup profile step for warming the cluster, ended when it initializes.
+    const Init::StartupProfile::StepId startup_step_;
   };
 
   struct ClusterUpdateCallbacksHandleImpl : public ClusterUpdateCallbacksHandle,
@@ -527,6 +634,32 @@ private:
         : RaiiListElement<ClusterUpdateCallbacks*>(parent, &cb) {}
   };
 
+  class OdCdsApiHandleImpl : public OdCdsApiHandle {
+  public:
+    OdCdsApiHandleImpl(ClusterManagerImpl& parent, uint64_t odcds_key)
+        : parent_(parent), odcds_key_(odcds_key) {}
+
+    // Upstream::OdCdsApiHandle
+    void requestOnDemandClusterDiscovery(absl::string_view name,
+                                         ClusterDiscoveryCallbackWeakPtr callback,
+                                         std::chrono::milliseconds timeout) override {
+      parent_.requestOnDemandClusterDiscovery(odcds_key_, name, std::move(callback), timeout);
+    }
+
+  private:
+    ClusterManagerImpl& parent_;
+    // The key of the subscription in odcds_apis_, which is looked up on the main thread for the
+    // handle not to keep the subscription alive past shutdown().
+    const uint64_t odcds_key_;
+  };
+
+  // A discovery in progress on the main thread, which the discoveries of the cluster requested
+  // from the workers in the meantime share.
+  struct PendingClusterDiscovery {
+    uint64_t odcds_key_;
+    Event::TimerPtr timeout_timer_;
+  };
+
   using ClusterDataPtr = std::unique_ptr<ClusterData>;
   // This map is ordered so that config dumping is consistent.
   using ClusterMap = std::map<std::string, ClusterDataPtr>;
@@ -588,12 +721,28 @@ private:
   static void maybePreconnect(ThreadLocalClusterManagerImpl::ClusterEntry& cluster_entry,
                               const ClusterConnectivityState& cluster_manager_state,
                               std::function<ConnectionPool::Instance*()> preconnect_pool);
+  // @return the dispatcher of the worker which owns the HTTP/2 connections to the host, or
+  //         nullptr if no worker has registered yet.
+  Event::Dispatcher* sharedHttp2PoolOwner(const Host& host);
+  // Called on a worker, which hands the discovery to the main thread unless the worker already has
+  // the cluster or is waiting for it.
+  void requestOnDemandClusterDiscovery(uint64_t odcds_key, absl::string_view name,
+                                       ClusterDiscoveryCallbackWeakPtr callback,
+                                       std::chrono::milliseconds timeout);
+  void discoverCluster(uint64_t odcds_key, const std::string& name,
+                       std::chrono::milliseconds timeout);
+  void onClusterDiscoveryTimeout(std::string name);
+  void notifyClusterDiscovery(const std::string& name, ClusterDiscoveryStatus status);
 
   ClusterManagerFactory& factory_;
   Runtime::Loader& runtime_;
   Stats::Store& stats_;
   ThreadLocal::TypedSlot<ThreadLocalClusterManagerImpl> tls_;
   Random::RandomGenerator& random_;
+  // Worker dispatchers, in the order their thread local cluster managers were created. This is
+  // only read when a connection pool is created.
+  absl::Mutex worker_dispatchers_lock_;
+  std::vector<Event::Dispatcher*> worker_dispatchers_ ABSL_GUARDED_BY(worker_dispatchers_lock_);
 
 protected:
   ClusterMap active_clusters_;
@@ -604,6 +753,9 @@ private:
   Outlier::EventLoggerSharedPtr outlier_event_logger_;
   const LocalInfo::LocalInfo& local_info_;
   CdsApiPtr cds_api_;
+  // The on demand CDS subscriptions, by the hash of their configuration.
+  absl::flat_hash_map<uint64_t, OdCdsApiImplPtr> odcds_apis_;
+  absl::flat_hash_map<std::string, PendingClusterDiscovery> pending_cluster_discoveries_;
   ClusterManagerStats cm_stats_;
   ClusterManagerInitHelper init_helper_;
   Config::GrpcMuxSharedPtr ads_mux_;
@@ -624,6 +776,9 @@ private:
   ClusterCircuitBreakersStatNames cluster_circuit_breakers_stat_names_;
   ClusterRequestResponseSizeStatNames cluster_request_response_size_stat_names_;
   ClusterTimeoutBudgetStatNames cluster_timeout_budget_stat_names_;
+  const bool lazy_cluster_stats_;
+  // Created before any cluster, so that the static clusters can use it too.
+  std::unique_ptr<ClusterInitThreadPool> cluster_init_thread_pool_;
 
   Config::SubscriptionFactoryImpl subscription_factory_;
   ClusterSet primary_clusters_;
@@ -1,7 +1,13 @@
 #pragma once
+#include <algorithm>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <list>
+#include <memory>
 #include <queue>
+#include <vector>
 
 #include "source/common/common/assert.h"
 
@@ -82,6 +88,31 @@ public:
     ASSERT(queue_.top().deadline_ >= current_time_);
   }
 
+  /**
+   * Builds a scheduler holding all of the given entries. The result picks in exactly the same
+   * order as a scheduler populated by calling add() for each entry in turn, but the queue is
+   * heapified once in O(n) instead of paying O(log n) per insertion, which matters when every
+   * worker rebuilds the schedule for a large host set.
+   * @param entries supplies the entries, in insertion order.
+   * @param calculate_weight supplies the weight of each entry.
+   */
+  template <class Container, class WeightFn>
+  static std::unique_ptr<EdfScheduler> createFromEntries(const Container& entries,
+                                                         WeightFn&& calculate_weight) {
+    auto scheduler = std::make_unique<EdfScheduler>();
+    std::vector<EdfEntry> queue_entries;
+    queue_entries.reserve(entries.size());
+    for (const auto& entry : entries) {
+      const double weight = calculate_weight(*entry);
+      ASSERT(weight > 0);
+      // Equivalent to the deadline computed by add() with current_time_ at zero.
+      queue_entries.push_back({1.0 / weight, scheduler->order_offset_++, entry});
+    }
+    scheduler->queue_ =
+        std::priority_queue<EdfEntry>(std::less<EdfEntry>(), std::move(queue_entries));
+    return scheduler;
+  }
+
   /**
    * Implements empty() on the internal queue. Does not attempt to discard expired elements.
    * @return bool whether or not the internal queue is empty.
@@ -141,6 +172,136 @@ private:
   std::list<std::weak_ptr<C>> prepick_list_;
 };
 
+/**
+ * Index based variant of EdfScheduler for schedules over a dense, stable collection such as the
+ * host vector of a host set. Entries are plain indices stored by value in a flat binary heap, so a
+ * pick touches one contiguous allocation and involves no weak_ptr locking or reference counting.
+ * There is no lazy removal: the scheduler must be rebuilt whenever the indexed collection changes.
+ * Given the same weights, picks are made in exactly the same order as an EdfScheduler populated
+ * with the same entries in index order.
+ */
+class IndexedEdfScheduler {
+public:
+  /**
+   * Builds a scheduler over indices [0, size) in O(size).
+   * @param size supplies the number of entries.
+   * @param calculate_weight supplies the weight of the entry at a given index.
+   */
+  template <class WeightFn> IndexedEdfScheduler(uint32_t size, WeightFn&& calculate_weight) {
+    heap_.reserve(size);
+    for (uint32_t index = 0; index < size; ++index) {
+      const double weight = calculate_weight(index);
+      ASSERT(weight > 0);
+      heap_.push_back({1.0 / weight, order_offset_++, index});
+    }
+    std::make_heap(heap_.begin(), heap_.end(), laterThan);
+  }
+
+  /**
+   * Same semantics as EdfScheduler::peekAgain(): returns the best-effort subsequent pick,
+   * rescheduling the entry as if it had been picked and remembering it for the next pickAndAdd().
+   * @return the index of the peeked entry. The scheduler must not be empty.
+   */
+  template <class WeightFn> uint32_t peekAgain(WeightFn&& calculate_weight) {
+    const uint32_t index = pickFromHeap(calculate_weight);
+    prepick_list_.push_back(index);
+    return index;
+  }
+
+  /**
+   * Picks the entry with the closest deadline and reschedules it using the weight from
+   * calculate_weight.
+   * @return the index of the picked entry. The scheduler must not be empty.
+   */
+  template <class WeightFn> uint32_t pickAndAdd(WeightFn&& calculate_weight) {
+    if (!prepick_list_.empty()) {
+      // The entry was already rescheduled during peekAgain() so don't reschedule it again.
+      const uint32_t index = prepick_list_.front();
+      prepick_list_.pop_front();
+      return index;
+    }
+    return pickFromHeap(calculate_weight);
+  }
+
+  /**
+   * Makes count consecutive picks, appending the picked indices to picks. This is equivalent to
+   * calling pickAndAdd() count times, for callers that need several entries at once.
+   */
+  template <class WeightFn>
+  void pickAndAdd(uint32_t count, WeightFn&& calculate_weight, std::vector<uint32_t>& picks) {
+    picks.reserve(picks.size() + count);
+    for (uint32_t i = 0; i < count; ++i) {
+      picks.push_back(pickAndAdd(calculate_weight));
+    }
+  }
+
+  /**
+   * @return uint32_t the number of entries in the schedule.
+   */
+  uint32_t size() const { return heap_.size(); }
+
+  /**
+   * @return bool whether or not the schedule is empty.
+   */
+  bool empty() const { return heap_.empty(); }
+
+private:
+  struct Entry {
+    double deadline_;
+    // Tie breaker for entries with the same deadline, providing FIFO behavior.
+    uint64_t order_offset_;
+    uint32_t index_;
+  };
+
+  // Heap comparator placing the entry with the earliest deadline at the root.
+  static bool laterThan(const Entry& lhs, const Entry& rhs) {
+    return lhs.deadline_ > rhs.deadline_ ||
+           (lhs.deadline_ == rhs.deadline_ && lhs.order_offset_ > rhs.order_offset_);
+  }
+
+  template <class WeightFn> uint32_t pickFromHeap(WeightFn& calculate_weight) {
+    ASSERT(!heap_.empty());
+    Entry& root = heap_.front();
+    ASSERT(root.deadline_ >= current_time_);
+    current_time_ = root.deadline_;
+    const uint32_t index = root.index_;
+    const double weight = calculate_weight(index);
+    ASSERT(weight > 0);
+    // The picked entry is rescheduled in place: replacing the root and sifting it down once is
+    // cheaper than a separate pop and push.
+    root.deadline_ = current_time_ + 1.0 / weight;
+    root.order_offset_ = order_offset_++;
+    siftDownRoot();
+    return index;
+  }
+
+  void siftDownRoot() {
+    const size_t size = heap_.size();
+    const Entry entry = heap_.front();
+    size_t hole = 0;
+    while (true) {
+      size_t child = 2 * hole + 1;
+      if (child >= size) {
+        break;
+      }
+      if (child + 1 < size && laterThan(heap_[child], heap_[child + 1])) {
+        ++child;
+      }
+      if (!laterThan(entry, heap_[child])) {
+        break;
+      }
+      heap_[hole] = heap_[child];
+      hole = child;
+    }
+    heap_[hole] = entry;
+  }
+
+  double current_time_{};
+  uint64_t order_offset_{};
+  std::vector<Entry> heap_;
+  std::deque<uint32_t> prepick_list_;
+};
+
 #undef EDF_DEBUG
 
 } // namespace Upstream
@@ -7,10 +7,12 @@
 #include "envoy/service/discovery/v3/discovery.pb.h"
 
 #include "source/common/common/assert.h"
+#include "source/common/common/hash.h"
 #include "source/common/common/utility.h"
 #include "source/common/config/api_version.h"
 #include "source/common/config/decoded_resource_impl.h"
 #include "source/common/config/version_converter.h"
+#include "source/common/runtime/runtime_features.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -49,18 +51,45 @@ void EdsClusterImpl::startPreInit() { subscription_->start({cluster_name_}); }
 void EdsClusterImpl::BatchUpdateHelper::batchUpdate(PrioritySet::HostUpdateCb& host_update_cb) {
   absl::flat_hash_map<std::string, HostSharedPtr> updated_hosts;
   absl::flat_hash_set<std::string> all_new_hosts;
+  absl::flat_hash_map<std::string, uint64_t> endpoint_hashes;
+  const bool reuse_unchanged_hosts =
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.eds_reuse_unchanged_hosts");
   PriorityStateManager priority_state_manager(parent_, parent_.local_info_, &host_update_cb);
   for (const auto& locality_lb_endpoint : cluster_load_assignment_.endpoints()) {
     parent_.validateEndpointsForZoneAwareRouting(locality_lb_endpoint);
 
     priority_state_manager.initializePriorityFor(locality_lb_endpoint);
 
+    const uint64_t locality_hash = HashUtil::xxHash64(
+        locality_lb_endpoint.locality().SerializeAsString(), locality_lb_endpoint.priority());
     for (const auto& lb_endpoint : locality_lb_endpoint.lb_endpoints()) {
       auto address = parent_.resolveProtoAddress(lb_endpoint.endpoint().address());
+      const std::string& address_string = address->asString();
+      all_new_hosts.emplace(address_string);
+
+      if (reuse_unchanged_hosts) {
+        // Most endpoints are unchanged between two updates of a large cluster. If this one is
+        // byte-for-byte the same as last time, in the same locality and priority, the existing host
+        // already reflects it, so skip building a HostImpl just for updateDynamicHostList() to
+        // match it back to the existing host and throw it away.
+        const uint64_t endpoint_hash =
+            HashUtil::xxHash64(lb_endpoint.SerializeAsString(), locality_hash);
+        endpoint_hashes[address_string] = endpoint_hash;
+        const auto existing_hash = parent_.endpoint_hashes_.find(address_string);
+        if (existing_hash != parent_.endpoint_hashes_.end() &&
+            existing_hash->second == endpoint_hash) {
+          const auto existing_host = parent_.all_hosts_.find(address_string);
+          if (existing_host != parent_.all_hosts_.end()) {
+            priority_state_manager.registerHostForPriority(existing_host->second,
+                                                           locality_lb_endpoint);
+            continue;
+          }
+        }
+      }
+
       priority_state_manager.registerHostForPriority(lb_endpoint.endpoint().hostname(), address,
                                                      locality_lb_endpoint, lb_endpoint,
                                                      parent_.time_source_);
-      all_new_hosts.emplace(address->asString());
     }
   }
 
@@ -104,6 +133,7 @@ void EdsClusterImpl::BatchUpdateHelper::batchUpdate(PrioritySet::HostUpdateCb& h
   }
 
   parent_.all_hosts_ = std::move(updated_hosts);
+  parent_.endpoint_hashes_ = std::move(endpoint_hashes);
 
   if (!cluster_rebuilt) {
     parent_.info_->stats().update_no_rebuild_.inc();
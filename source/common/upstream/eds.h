@@ -19,6 +19,8 @@
 #include "source/common/upstream/cluster_factory_impl.h"
 #include "source/common/upstream/upstream_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -79,6 +81,9 @@ private:
   const std::string cluster_name_;
   std::vector<LocalityWeightsMap> locality_weights_map_;
   HostMap all_hosts_;
+  // Hash of the endpoint, locality and priority each host in all_hosts_ was last seen with, used
+  // to reuse hosts whose endpoint did not change.
+  absl::flat_hash_map<std::string, uint64_t> endpoint_hashes_;
   Event::TimerPtr assignment_timeout_;
   InitializePhase initialize_phase_;
 };
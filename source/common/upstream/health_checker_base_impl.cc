@@ -1,5 +1,8 @@
 #include "source/common/upstream/health_checker_base_impl.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "envoy/config/core/v3/address.pb.h"
 #include "envoy/config/core/v3/health_check.pb.h"
 #include "envoy/data/core/v3/health_check_event.pb.h"
@@ -8,6 +11,8 @@
 #include "source/common/network/utility.h"
 #include "source/common/router/router.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -29,6 +34,7 @@ HealthCheckerImplBase::HealthCheckerImplBase(const Cluster& cluster,
       no_traffic_healthy_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, no_traffic_healthy_interval,
                                                               no_traffic_interval_.count())),
       initial_jitter_(PROTOBUF_GET_MS_OR_DEFAULT(config, initial_jitter, 0)),
+      initial_jitter_percent_(config.initial_jitter_percent()),
       interval_jitter_(PROTOBUF_GET_MS_OR_DEFAULT(config, interval_jitter, 0)),
       interval_jitter_percent_(config.interval_jitter_percent()),
       unhealthy_interval_(
@@ -71,6 +77,13 @@ MetadataConstSharedPtr HealthCheckerImplBase::initTransportSocketMatchMetadata(
   return nullptr;
 }
 
+void HealthCheckerImplBase::shareSessions(HealthCheckSessionRegistrySharedPtr registry,
+                                          const envoy::config::core::v3::HealthCheck& config) {
+  ASSERT(active_sessions_.empty());
+  session_registry_ = std::move(registry);
+  config_hash_ = MessageUtil::hash(config);
+}
+
 HealthCheckerImplBase::~HealthCheckerImplBase() {
   // ASSERTs inside the session destructor check to make sure we have been previously deferred
   // deleted. Unify that logic here before actual destruction happens.
@@ -159,6 +172,9 @@ void HealthCheckerImplBase::addHosts(const HostVector& hosts) {
     active_sessions_[host] = makeSession(host);
     host->setHealthChecker(
         HealthCheckHostMonitorPtr{new HealthCheckHostMonitorImpl(shared_from_this(), host)});
+    if (session_registry_ != nullptr) {
+      active_sessions_[host]->share(absl::StrCat(host->address()->asString(), "_", config_hash_));
+    }
     active_sessions_[host]->start();
   }
 }
@@ -251,6 +267,11 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::onDeferredDeleteBase() {
   // implementation specific state is destroyed.
   interval_timer_.reset();
   timeout_timer_.reset();
+  if (!shared_key_.empty()) {
+    std::string key;
+    key.swap(shared_key_);
+    parent_.session_registry_->remove(key, *this);
+  }
   if (!host_->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
     parent_.decHealthy();
   }
@@ -260,7 +281,32 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::onDeferredDeleteBase() {
   onDeferredDelete();
 }
 
+void HealthCheckerImplBase::ActiveHealthCheckSession::share(const std::string& key) {
+  shared_key_ = key;
+  follower_ = !parent_.session_registry_->add(key, *this);
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::onPromoted() {
+  follower_ = false;
+  // The host was just health checked by the session which was sending the health checks.
+  const HealthState state = host_->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)
+                                ? HealthState::Unhealthy
+                                : HealthState::Healthy;
+  interval_timer_->enableTimer(parent_.interval(state, HealthTransition::Unchanged));
+}
+
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degraded) {
+  const HealthTransition changed_state = applySuccess(degraded);
+
+  timeout_timer_->disableTimer();
+  interval_timer_->enableTimer(parent_.interval(HealthState::Healthy, changed_state));
+
+  if (!shared_key_.empty()) {
+    parent_.session_registry_->onSuccess(shared_key_, degraded);
+  }
+}
+
+HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::applySuccess(bool degraded) {
   // If we are healthy, reset the # of unhealthy to zero.
   num_unhealthy_ = 0;
 
@@ -278,6 +324,8 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degrade
       host_->healthFlagClear(Host::HealthFlag::EXCLUDED_VIA_IMMEDIATE_HC_FAIL);
 
       host_->healthFlagClear(Host::HealthFlag::FAILED_ACTIVE_HC);
+      // The slow start window of the host, if any, starts over now.
+      host_->setLastHcPassTime(parent_.dispatcher_.timeSource().monotonicTime());
       parent_.incHealthy();
       changed_state = HealthTransition::Changed;
       if (parent_.event_logger_) {
@@ -315,9 +363,7 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degrade
   parent_.stats_.success_.inc();
   first_check_ = false;
   parent_.runCallbacks(host_, changed_state);
-
-  timeout_timer_->disableTimer();
-  interval_timer_->enableTimer(parent_.interval(HealthState::Healthy, changed_state));
+  return changed_state;
 }
 
 namespace {
@@ -386,6 +432,10 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::handleFailure(
   if (interval_timer_ != nullptr) {
     interval_timer_->enableTimer(parent_.interval(HealthState::Unhealthy, changed_state));
   }
+
+  if (!shared_key_.empty()) {
+    parent_.session_registry_->onFailure(shared_key_, type);
+  }
 }
 
 HealthTransition
@@ -412,11 +462,74 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::onTimeoutBase() {
 }
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::onInitialInterval() {
-  if (parent_.initial_jitter_.count() == 0) {
+  if (parent_.initial_jitter_.count() == 0 && parent_.initial_jitter_percent_ == 0) {
     onIntervalBase();
   } else {
-    interval_timer_->enableTimer(
-        std::chrono::milliseconds(parent_.intervalWithJitter(0, parent_.initial_jitter_)));
+    uint64_t base_time_ms = 0;
+    const uint64_t jitter_percent_mod =
+        parent_.initial_jitter_percent_ * parent_.interval_.count() / 100;
+    if (jitter_percent_mod > 0) {
+      base_time_ms = parent_.random_.random() % jitter_percent_mod;
+    }
+    interval_timer_->enableTimer(std::chrono::milliseconds(
+        parent_.intervalWithJitter(base_time_ms, parent_.initial_jitter_)));
+  }
+}
+
+bool HealthCheckSessionRegistry::add(const std::string& key, SharedHealthCheckSession& session) {
+  std::list<SharedHealthCheckSession*>& sessions = sessions_[key];
+  sessions.push_back(&session);
+  return sessions.size() == 1;
+}
+
+void HealthCheckSessionRegistry::remove(const std::string& key,
+                                        SharedHealthCheckSession& session) {
+  auto it = sessions_.find(key);
+  ASSERT(it != sessions_.end());
+  const bool was_first = it->second.front() == &session;
+  it->second.remove(&session);
+  if (it->second.empty()) {
+    sessions_.erase(it);
+  } else if (was_first) {
+    it->second.front()->onPromoted();
+  }
+}
+
+void HealthCheckSessionRegistry::onSuccess(const std::string& key, bool degraded) {
+  forEachFollower(key, [degraded](SharedHealthCheckSession& session) {
+    session.onSharedSuccess(degraded);
+  });
+}
+
+void HealthCheckSessionRegistry::onFailure(const std::string& key,
+                                           envoy::data::core::v3::HealthCheckFailureType type) {
+  forEachFollower(key,
+                  [type](SharedHealthCheckSession& session) { session.onSharedFailure(type); });
+}
+
+size_t HealthCheckSessionRegistry::size(const std::string& key) const {
+  auto it = sessions_.find(key);
+  return it == sessions_.end() ? 0 : it->second.size();
+}
+
+void HealthCheckSessionRegistry::forEachFollower(
+    const std::string& key, const std::function<void(SharedHealthCheckSession&)>& cb) {
+  auto it = sessions_.find(key);
+  if (it == sessions_.end() || it->second.size() < 2) {
+    return;
+  }
+  // The callbacks run by a session may remove hosts from its cluster, and so sessions from the
+  // registry, so the followers are looked up again before each of them applies the result.
+  const std::vector<SharedHealthCheckSession*> followers(std::next(it->second.begin()),
+                                                         it->second.end());
+  for (SharedHealthCheckSession* follower : followers) {
+    it = sessions_.find(key);
+    if (it == sessions_.end()) {
+      return;
+    }
+    if (std::find(it->second.begin(), it->second.end(), follower) != it->second.end()) {
+      cb(*follower);
+    }
   }
 }
 
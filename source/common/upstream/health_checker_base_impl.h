@@ -1,5 +1,9 @@
 #pragma once
 
+#include <functional>
+#include <list>
+#include <string>
+
 #include "envoy/access_log/access_log.h"
 #include "envoy/common/callback.h"
 #include "envoy/common/random_generator.h"
@@ -7,6 +11,7 @@
 #include "envoy/data/core/v3/health_check_event.pb.h"
 #include "envoy/event/timer.h"
 #include "envoy/runtime/runtime.h"
+#include "envoy/singleton/instance.h"
 #include "envoy/stats/scope.h"
 #include "envoy/type/matcher/string.pb.h"
 #include "envoy/upstream/health_checker.h"
@@ -15,6 +20,8 @@
 #include "source/common/common/matchers.h"
 #include "source/common/network/transport_socket_options_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -55,6 +62,69 @@ struct HealthCheckerEqualTo {
   }
 };
 
+/**
+ * A health check session whose health checks are shared with the sessions of the same host in
+ * other clusters. @see HealthCheckSessionRegistry.
+ */
+class SharedHealthCheckSession {
+public:
+  virtual ~SharedHealthCheckSession() = default;
+
+  /**
+   * Applies the success of a health check sent by another session.
+   */
+  virtual void onSharedSuccess(bool degraded) PURE;
+
+  /**
+   * Applies the failure of a health check sent by another session.
+   */
+  virtual void onSharedFailure(envoy::data::core::v3::HealthCheckFailureType type) PURE;
+
+  /**
+   * Called when the session starts sending the health checks of its host, as the session which
+   * sent them is gone.
+   */
+  virtual void onPromoted() PURE;
+};
+
+/**
+ * The health check sessions shared across clusters, by the address of their host and the hash of
+ * their health check configuration. The first session of a key sends the health checks, and its
+ * results are applied by the others, so that a host member of several clusters is health checked
+ * once. Only used on the main thread.
+ */
+class HealthCheckSessionRegistry : public Singleton::Instance {
+public:
+  /**
+   * Adds a session.
+   * @return true if the session is the first one of its key, which sends the health checks.
+   */
+  bool add(const std::string& key, SharedHealthCheckSession& session);
+
+  /**
+   * Removes a session. If it was sending the health checks, the next session of the key, if any,
+   * is promoted to send them.
+   */
+  void remove(const std::string& key, SharedHealthCheckSession& session);
+
+  /**
+   * Applies the result of a health check to the sessions of the key but the first one, which sent
+   * it.
+   */
+  void onSuccess(const std::string& key, bool degraded);
+  void onFailure(const std::string& key, envoy::data::core::v3::HealthCheckFailureType type);
+
+  size_t size(const std::string& key) const;
+
+private:
+  void forEachFollower(const std::string& key,
+                       const std::function<void(SharedHealthCheckSession&)>& cb);
+
+  absl::flat_hash_map<std::string, std::list<SharedHealthCheckSession*>> sessions_;
+};
+
+using HealthCheckSessionRegistrySharedPtr = std::shared_ptr<HealthCheckSessionRegistry>;
+
 /**
  * Base implementation for all health checkers.
  */
@@ -72,13 +142,34 @@ public:
     return transport_socket_match_metadata_;
   }
 
+  /**
+   * Shares the health checks of the hosts with the other health checkers of the registry which
+   * have the same configuration. Must be called before start().
+   */
+  void shareSessions(HealthCheckSessionRegistrySharedPtr registry,
+                     const envoy::config::core::v3::HealthCheck& config);
+
 protected:
-  class ActiveHealthCheckSession : public Event::DeferredDeletable {
+  class ActiveHealthCheckSession : public Event::DeferredDeletable,
+                                   public SharedHealthCheckSession {
   public:
     ~ActiveHealthCheckSession() override;
     HealthTransition setUnhealthy(envoy::data::core::v3::HealthCheckFailureType type);
     void onDeferredDeleteBase();
-    void start() { onInitialInterval(); }
+    void start() {
+      if (!follower_) {
+        onInitialInterval();
+      }
+    }
+    // Shares the health checks of the session with the other sessions of the key.
+    void share(const std::string& key);
+
+    // SharedHealthCheckSession
+    void onSharedSuccess(bool degraded) override { applySuccess(degraded); }
+    void onSharedFailure(envoy::data::core::v3::HealthCheckFailureType type) override {
+      setUnhealthy(type);
+    }
+    void onPromoted() override;
 
   protected:
     ActiveHealthCheckSession(HealthCheckerImplBase& parent, HostSharedPtr host);
@@ -94,6 +185,8 @@ protected:
     // been health checked.
     // Returns the changed state to use following the flag update.
     HealthTransition clearPendingFlag(HealthTransition changed_state);
+    // Updates the host and the stats for a successful health check.
+    HealthTransition applySuccess(bool degraded);
     virtual void onInterval() PURE;
     void onIntervalBase();
     virtual void onTimeout() PURE;
@@ -107,6 +200,10 @@ protected:
     uint32_t num_unhealthy_{};
     uint32_t num_healthy_{};
     bool first_check_{true};
+    // The key of the session in the registry of the parent, if its health checks are shared.
+    std::string shared_key_;
+    // Whether the health checks are sent by another session of the key.
+    bool follower_{};
   };
 
   using ActiveHealthCheckSessionPtr = std::unique_ptr<ActiveHealthCheckSession>;
@@ -169,6 +266,7 @@ private:
   const std::chrono::milliseconds no_traffic_interval_;
   const std::chrono::milliseconds no_traffic_healthy_interval_;
   const std::chrono::milliseconds initial_jitter_;
+  const uint32_t initial_jitter_percent_;
   const std::chrono::milliseconds interval_jitter_;
   const uint32_t interval_jitter_percent_;
   const std::chrono::milliseconds unhealthy_interval_;
@@ -178,6 +276,10 @@ private:
   const std::shared_ptr<const Network::TransportSocketOptionsImpl> transport_socket_options_;
   const MetadataConstSharedPtr transport_socket_match_metadata_;
   const Common::CallbackHandlePtr member_update_cb_;
+  HealthCheckSessionRegistrySharedPtr session_registry_;
+  // The hash of the configuration, which the sessions of the same host in the other clusters have
+  // to share to use the same health checks.
+  uint64_t config_hash_{};
 };
 
 class HealthCheckEventLoggerImpl : public HealthCheckEventLogger {
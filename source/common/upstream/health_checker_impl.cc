@@ -1,6 +1,8 @@
 #include "source/common/upstream/health_checker_impl.h"
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "envoy/config/core/v3/health_check.pb.h"
 #include "envoy/data/core/v3/health_check_event.pb.h"
@@ -30,6 +32,9 @@
 namespace Envoy {
 namespace Upstream {
 
+SINGLETON_MANAGER_REGISTRATION(health_check_session_registry);
+SINGLETON_MANAGER_REGISTRATION(shared_http_health_check_connection_registry);
+
 namespace {
 
 // Helper functions to get the correct hostname for an L7 health check.
@@ -89,28 +94,34 @@ HealthCheckerSharedPtr HealthCheckerFactory::create(
     const envoy::config::core::v3::HealthCheck& health_check_config, Upstream::Cluster& cluster,
     Runtime::Loader& runtime, Event::Dispatcher& dispatcher,
     AccessLog::AccessLogManager& log_manager,
-    ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api) {
+    ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api,
+    Singleton::Manager* singleton_manager) {
   HealthCheckEventLoggerPtr event_logger;
   if (!health_check_config.event_log_path().empty()) {
     event_logger = std::make_unique<HealthCheckEventLoggerImpl>(
         log_manager, dispatcher.timeSource(), health_check_config.event_log_path());
   }
+  HealthCheckerSharedPtr health_checker;
   switch (health_check_config.health_checker_case()) {
   case envoy::config::core::v3::HealthCheck::HealthCheckerCase::kHttpHealthCheck:
-    return std::make_shared<ProdHttpHealthCheckerImpl>(cluster, health_check_config, dispatcher,
-                                                       runtime, api.randomGenerator(),
-                                                       std::move(event_logger));
+    health_checker = std::make_shared<ProdHttpHealthCheckerImpl>(
+        cluster, health_check_config, dispatcher, runtime, api.randomGenerator(),
+        std::move(event_logger));
+    break;
   case envoy::config::core::v3::HealthCheck::HealthCheckerCase::kTcpHealthCheck:
-    return std::make_shared<TcpHealthCheckerImpl>(cluster, health_check_config, dispatcher, runtime,
-                                                  api.randomGenerator(), std::move(event_logger));
+    health_checker = std::make_shared<TcpHealthCheckerImpl>(
+        cluster, health_check_config, dispatcher, runtime, api.randomGenerator(),
+        std::move(event_logger));
+    break;
   case envoy::config::core::v3::HealthCheck::HealthCheckerCase::kGrpcHealthCheck:
     if (!(cluster.info()->features() & Upstream::ClusterInfo::Features::HTTP2)) {
       throw EnvoyException(fmt::format("{} cluster must support HTTP/2 for gRPC healthchecking",
                                        cluster.info()->name()));
     }
-    return std::make_shared<ProdGrpcHealthCheckerImpl>(cluster, health_check_config, dispatcher,
-                                                       runtime, api.randomGenerator(),
-                                                       std::move(event_logger));
+    health_checker = std::make_shared<ProdGrpcHealthCheckerImpl>(
+        cluster, health_check_config, dispatcher, runtime, api.randomGenerator(),
+        std::move(event_logger));
+    break;
   case envoy::config::core::v3::HealthCheck::HealthCheckerCase::kCustomHealthCheck: {
     auto& factory =
         Config::Utility::getAndCheckFactory<Server::Configuration::CustomHealthCheckerFactory>(
@@ -118,12 +129,38 @@ HealthCheckerSharedPtr HealthCheckerFactory::create(
     std::unique_ptr<Server::Configuration::HealthCheckerFactoryContext> context(
         new HealthCheckerFactoryContextImpl(cluster, runtime, dispatcher, std::move(event_logger),
                                             validation_visitor, api));
-    return factory.createCustomHealthChecker(health_check_config, *context);
+    health_checker = factory.createCustomHealthChecker(health_check_config, *context);
+    break;
   }
   default:
     // Checked by schema.
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
+
+  if (health_check_config.http_health_check().share_connection() &&
+      singleton_manager != nullptr) {
+    auto http_health_checker = std::dynamic_pointer_cast<HttpHealthCheckerImpl>(health_checker);
+    ASSERT(http_health_checker != nullptr);
+    http_health_checker->shareConnections(
+        singleton_manager->getTyped<SharedHttpHealthCheckConnectionRegistry>(
+            SINGLETON_MANAGER_REGISTERED_NAME(shared_http_health_check_connection_registry),
+            [] { return std::make_shared<SharedHttpHealthCheckConnectionRegistry>(); }),
+        health_check_config);
+  }
+
+  if (health_check_config.share_across_clusters() && singleton_manager != nullptr) {
+    // Custom health checkers which are not built on HealthCheckerImplBase never share their
+    // health checks.
+    auto health_checker_base = std::dynamic_pointer_cast<HealthCheckerImplBase>(health_checker);
+    if (health_checker_base != nullptr) {
+      health_checker_base->shareSessions(
+          singleton_manager->getTyped<HealthCheckSessionRegistry>(
+              SINGLETON_MANAGER_REGISTERED_NAME(health_check_session_registry),
+              [] { return std::make_shared<HealthCheckSessionRegistry>(); }),
+          health_check_config);
+    }
+  }
+  return health_checker;
 }
 
 HttpHealthCheckerImpl::HttpHealthCheckerImpl(const Cluster& cluster,
@@ -156,6 +193,19 @@ HttpHealthCheckerImpl::HttpHealthCheckerImpl(const Cluster& cluster,
   }
 }
 
+void HttpHealthCheckerImpl::shareConnections(
+    SharedHttpHealthCheckConnectionRegistrySharedPtr registry,
+    const envoy::config::core::v3::HealthCheck& config) {
+  // Streams are multiplexed on HTTP/2 connections only.
+  if (codec_client_type_ != Http::CodecType::HTTP2) {
+    return;
+  }
+  connection_registry_ = std::move(registry);
+  connection_key_suffix_ =
+      absl::StrCat("_", MessageUtil::hash(config.tls_options()), "_",
+                   MessageUtil::hash(config.transport_socket_match_criteria()));
+}
+
 HttpHealthCheckerImpl::HttpStatusChecker::HttpStatusChecker(
     const Protobuf::RepeatedPtrField<envoy::type::v3::Int64Range>& expected_statuses,
     uint64_t default_expected_status) {
@@ -217,13 +267,33 @@ HttpHealthCheckerImpl::HttpActiveHealthCheckSession::HttpActiveHealthCheckSessio
       protocol_(codecClientTypeToProtocol(parent_.codec_client_type_)),
       local_address_provider_(std::make_shared<Network::SocketAddressSetterImpl>(
           Network::Utility::getCanonicalIpv4LoopbackAddress(),
-          Network::Utility::getCanonicalIpv4LoopbackAddress())) {}
+          Network::Utility::getCanonicalIpv4LoopbackAddress())) {
+  if (parent_.connection_registry_ != nullptr) {
+    shared_connection_ = parent_.connection_registry_->get(
+        absl::StrCat(host->healthCheckAddress()->asString(), parent_.connection_key_suffix_),
+        parent_.dispatcher_, parent_.runtime_);
+    shared_connection_->addSession(*this);
+    // The connection is used by the other sessions, hence never closed after a health check.
+    reuse_connection_ = true;
+  }
+}
 
 HttpHealthCheckerImpl::HttpActiveHealthCheckSession::~HttpActiveHealthCheckSession() {
   ASSERT(client_ == nullptr);
+  ASSERT(shared_connection_ == nullptr);
 }
 
 void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onDeferredDelete() {
+  if (shared_connection_ != nullptr) {
+    if (request_in_flight_) {
+      // Only the stream of the session is reset, which is ignored.
+      expect_reset_ = true;
+      request_encoder_->getStream().resetStream(Http::StreamResetReason::LocalReset);
+    }
+    shared_connection_->removeSession(*this);
+    shared_connection_.reset();
+    return;
+  }
   if (client_) {
     // If there is an active request it will get reset, so make sure we ignore the reset.
     expect_reset_ = true;
@@ -251,9 +321,37 @@ void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onEvent(Network::Conne
   }
 }
 
+bool HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onSharedConnectionGoAway() {
+  if (!request_in_flight_) {
+    return false;
+  }
+  expect_reset_ = true;
+  return true;
+}
+
+void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onSharedConnectionGoAwayClosed(
+    Http::GoAwayErrorCode error_code) {
+  if (error_code == Http::GoAwayErrorCode::NoError) {
+    // The server is shutting down gracefully, so the health check is sent again on a new
+    // connection, within its original timeout.
+    onInterval();
+    return;
+  }
+  handleFailure(envoy::data::core::v3::NETWORK);
+}
+
 // TODO(lilika) : Support connection pooling
 void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onInterval() {
-  if (!client_) {
+  if (shared_connection_ != nullptr) {
+    if (shared_connection_->client() == nullptr) {
+      Upstream::Host::CreateConnectionData conn =
+          host_->createHealthCheckConnection(parent_.dispatcher_, parent_.transportSocketOptions(),
+                                             parent_.transportSocketMatchMetadata().get());
+      shared_connection_->setClient(Http::CodecClientPtr{parent_.createCodecClient(conn)});
+    }
+    // The resets of the streams of the shared connection are expected by stream.
+    expect_reset_ = false;
+  } else if (!client_) {
     Upstream::Host::CreateConnectionData conn =
         host_->createHealthCheckConnection(parent_.dispatcher_, parent_.transportSocketOptions(),
                                            parent_.transportSocketMatchMetadata().get());
@@ -264,8 +362,9 @@ void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onInterval() {
     reuse_connection_ = parent_.reuse_connection_;
   }
 
-  Http::RequestEncoder* request_encoder = &client_->newStream(*this);
+  Http::RequestEncoder* request_encoder = &client()->newStream(*this);
   request_encoder->getStream().addCallbacks(*this);
+  request_encoder_ = request_encoder;
   request_in_flight_ = true;
 
   const auto request_headers = Http::createHeaderMap<Http::RequestHeaderMapImpl>(
@@ -291,7 +390,7 @@ void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onInterval() {
 void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onResetStream(Http::StreamResetReason,
                                                                         absl::string_view) {
   request_in_flight_ = false;
-  ENVOY_CONN_LOG(debug, "connection/stream error health_flags={}", *client_,
+  ENVOY_CONN_LOG(debug, "connection/stream error health_flags={}", *client(),
                  HostUtility::healthFlagsToString(*host_));
   if (expect_reset_) {
     return;
@@ -338,7 +437,7 @@ void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onGoAway(
 HttpHealthCheckerImpl::HttpActiveHealthCheckSession::HealthCheckResult
 HttpHealthCheckerImpl::HttpActiveHealthCheckSession::healthCheckResult() {
   const uint64_t response_code = Http::Utility::getResponseStatus(*response_headers_);
-  ENVOY_CONN_LOG(debug, "hc response={} health_flags={}", *client_, response_code,
+  ENVOY_CONN_LOG(debug, "hc response={} health_flags={}", *client(), response_code,
                  HostUtility::healthFlagsToString(*host_));
 
   if (!parent_.http_status_checker_.inRange(response_code)) {
@@ -389,7 +488,7 @@ void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onResponseComplete() {
   }
 
   if (shouldClose()) {
-    client_->close();
+    client()->close();
   }
 
   response_headers_.reset();
@@ -398,7 +497,7 @@ void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onResponseComplete() {
 // It is possible for this session to have been deferred destroyed inline in handleFailure()
 // above so make sure we still have a connection that we might need to close.
 bool HttpHealthCheckerImpl::HttpActiveHealthCheckSession::shouldClose() const {
-  if (client_ == nullptr) {
+  if (client() == nullptr) {
     return false;
   }
 
@@ -406,11 +505,22 @@ bool HttpHealthCheckerImpl::HttpActiveHealthCheckSession::shouldClose() const {
     return true;
   }
 
-  return Http::HeaderUtility::shouldCloseConnection(client_->protocol(), *response_headers_);
+  return Http::HeaderUtility::shouldCloseConnection(client()->protocol(), *response_headers_);
 }
 
 void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onTimeout() {
+  const bool request_in_flight = request_in_flight_;
   request_in_flight_ = false;
+  if (shared_connection_ != nullptr) {
+    if (request_in_flight && shared_connection_->client() != nullptr) {
+      ENVOY_CONN_LOG(debug, "stream timeout health_flags={}", *shared_connection_->client(),
+                     HostUtility::healthFlagsToString(*host_));
+      // Only the stream of the session is reset, which is ignored.
+      expect_reset_ = true;
+      request_encoder_->getStream().resetStream(Http::StreamResetReason::LocalReset);
+    }
+    return;
+  }
   if (client_) {
     ENVOY_CONN_LOG(debug, "connection/stream timeout health_flags={}", *client_,
                    HostUtility::healthFlagsToString(*host_));
@@ -422,6 +532,77 @@ void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onTimeout() {
   }
 }
 
+SharedHttpHealthCheckConnection::SharedHttpHealthCheckConnection(
+    SharedHttpHealthCheckConnectionRegistrySharedPtr registry, std::string key,
+    Event::Dispatcher& dispatcher, Runtime::Loader& runtime)
+    : registry_(std::move(registry)), key_(std::move(key)), dispatcher_(dispatcher),
+      runtime_(runtime) {}
+
+SharedHttpHealthCheckConnection::~SharedHttpHealthCheckConnection() {
+  ASSERT(sessions_.empty());
+  registry_->connections_.erase(key_);
+  if (client_) {
+    client_->close();
+  }
+}
+
+void SharedHttpHealthCheckConnection::setClient(Http::CodecClientPtr&& client) {
+  ASSERT(client_ == nullptr);
+  client_ = std::move(client);
+  client_->addConnectionCallbacks(*this);
+  client_->setCodecConnectionCallbacks(*this);
+}
+
+void SharedHttpHealthCheckConnection::onEvent(Network::ConnectionEvent event) {
+  if (event == Network::ConnectionEvent::RemoteClose ||
+      event == Network::ConnectionEvent::LocalClose) {
+    // The streams were reset already, and the sessions set up their timers accordingly.
+    for (SharedHttpHealthCheckConnectionCallbacks* session : sessions_) {
+      session->onSharedConnectionClose();
+    }
+    if (client_) {
+      dispatcher_.deferredDelete(std::move(client_));
+    }
+  }
+}
+
+void SharedHttpHealthCheckConnection::onGoAway(Http::GoAwayErrorCode error_code) {
+  ENVOY_CONN_LOG(debug, "shared connection going away goaway_code={}", *client_, error_code);
+  // Runtime guard around graceful handling of NO_ERROR GOAWAY handling. The old behavior is to
+  // ignore GOAWAY completely.
+  if (!runtime_.snapshot().runtimeFeatureEnabled(
+          "envoy.reloadable_features.health_check.graceful_goaway_handling")) {
+    return;
+  }
+
+  std::vector<SharedHttpHealthCheckConnectionCallbacks*> in_flight;
+  for (SharedHttpHealthCheckConnectionCallbacks* session : sessions_) {
+    if (session->onSharedConnectionGoAway()) {
+      in_flight.push_back(session);
+    }
+  }
+  client_->close();
+  // A session may leave as the previous ones handle the GOAWAY.
+  for (SharedHttpHealthCheckConnectionCallbacks* session : in_flight) {
+    if (std::find(sessions_.begin(), sessions_.end(), session) != sessions_.end()) {
+      session->onSharedConnectionGoAwayClosed(error_code);
+    }
+  }
+}
+
+SharedHttpHealthCheckConnectionSharedPtr
+SharedHttpHealthCheckConnectionRegistry::get(const std::string& key,
+                                             Event::Dispatcher& dispatcher,
+                                             Runtime::Loader& runtime) {
+  SharedHttpHealthCheckConnectionSharedPtr connection = connections_[key].lock();
+  if (connection == nullptr) {
+    connection = std::make_shared<SharedHttpHealthCheckConnection>(shared_from_this(), key,
+                                                                   dispatcher, runtime);
+    connections_[key] = connection;
+  }
+  return connection;
+}
+
 Http::CodecType
 HttpHealthCheckerImpl::codecClientType(const envoy::type::v3::CodecClientType& type) {
   switch (type) {
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <list>
+#include <memory>
+#include <string>
+
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/api.h"
 #include "envoy/common/random_generator.h"
@@ -7,6 +11,7 @@
 #include "envoy/data/core/v3/health_check_event.pb.h"
 #include "envoy/grpc/status.h"
 #include "envoy/network/socket.h"
+#include "envoy/singleton/manager.h"
 #include "envoy/type/v3/http.pb.h"
 #include "envoy/type/v3/range.pb.h"
 
@@ -18,6 +23,7 @@
 #include "source/common/stream_info/stream_info_impl.h"
 #include "source/common/upstream/health_checker_base_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "src/proto/grpc/health/v1/health.pb.h"
 
 namespace Envoy {
@@ -37,13 +43,112 @@ public:
    * @param log_manager supplies the log_manager.
    * @param validation_visitor message validation visitor instance.
    * @param api reference to the Api object
+   * @param singleton_manager supplies the singleton manager holding the health check sessions
+   *        shared across clusters. If null, the health checks are never shared.
    * @return a health checker.
    */
   static HealthCheckerSharedPtr
   create(const envoy::config::core::v3::HealthCheck& health_check_config,
          Upstream::Cluster& cluster, Runtime::Loader& runtime, Event::Dispatcher& dispatcher,
          AccessLog::AccessLogManager& log_manager,
-         ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api);
+         ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api,
+         Singleton::Manager* singleton_manager = nullptr);
+};
+
+/**
+ * The callbacks of the HTTP health check sessions sending their health checks on a
+ * SharedHttpHealthCheckConnection.
+ */
+class SharedHttpHealthCheckConnectionCallbacks {
+public:
+  virtual ~SharedHttpHealthCheckConnectionCallbacks() = default;
+
+  /**
+   * Called when the connection closed, once the streams on it were reset.
+   */
+  virtual void onSharedConnectionClose() PURE;
+
+  /**
+   * Called when the host sent a GOAWAY, before the connection is closed.
+   * @return whether a health check of the session is in flight. The session must then ignore the
+   *         reset of its stream by the close.
+   */
+  virtual bool onSharedConnectionGoAway() PURE;
+
+  /**
+   * Called once the connection was closed on a GOAWAY, for the sessions which had a health check
+   * in flight.
+   * @param error_code supplies the error code of the GOAWAY.
+   */
+  virtual void onSharedConnectionGoAwayClosed(Http::GoAwayErrorCode error_code) PURE;
+};
+
+class SharedHttpHealthCheckConnectionRegistry;
+using SharedHttpHealthCheckConnectionRegistrySharedPtr =
+    std::shared_ptr<SharedHttpHealthCheckConnectionRegistry>;
+
+/**
+ * An HTTP/2 connection to an address, on which the sessions of the HTTP health checkers sharing
+ * their connections send the health checks of the hosts of that address as streams. It is created
+ * by the first health check which needs it, created again by the next one if it closed meanwhile,
+ * and closed once the last session leaves.
+ */
+class SharedHttpHealthCheckConnection : public Network::ConnectionCallbacks,
+                                        public Http::ConnectionCallbacks,
+                                        Logger::Loggable<Logger::Id::hc> {
+public:
+  SharedHttpHealthCheckConnection(SharedHttpHealthCheckConnectionRegistrySharedPtr registry,
+                                  std::string key, Event::Dispatcher& dispatcher,
+                                  Runtime::Loader& runtime);
+  ~SharedHttpHealthCheckConnection() override;
+
+  // Returns the codec client of the connection, or null if it is not connected.
+  Http::CodecClient* client() const { return client_.get(); }
+  void setClient(Http::CodecClientPtr&& client);
+  void addSession(SharedHttpHealthCheckConnectionCallbacks& session) {
+    sessions_.push_back(&session);
+  }
+  void removeSession(SharedHttpHealthCheckConnectionCallbacks& session) {
+    sessions_.remove(&session);
+  }
+
+  // Network::ConnectionCallbacks
+  void onEvent(Network::ConnectionEvent event) override;
+  void onAboveWriteBufferHighWatermark() override {}
+  void onBelowWriteBufferLowWatermark() override {}
+
+  // Http::ConnectionCallbacks
+  void onGoAway(Http::GoAwayErrorCode error_code) override;
+
+private:
+  const SharedHttpHealthCheckConnectionRegistrySharedPtr registry_;
+  const std::string key_;
+  Event::Dispatcher& dispatcher_;
+  Runtime::Loader& runtime_;
+  Http::CodecClientPtr client_;
+  std::list<SharedHttpHealthCheckConnectionCallbacks*> sessions_;
+};
+
+using SharedHttpHealthCheckConnectionSharedPtr = std::shared_ptr<SharedHttpHealthCheckConnection>;
+
+/**
+ * The HTTP/2 health check connections shared by the HTTP health checkers of the process, by
+ * address and transport socket options of the health checks.
+ */
+class SharedHttpHealthCheckConnectionRegistry
+    : public Singleton::Instance,
+      public std::enable_shared_from_this<SharedHttpHealthCheckConnectionRegistry> {
+public:
+  // Returns the connection of a key, which is created if it doesn't exist.
+  SharedHttpHealthCheckConnectionSharedPtr get(const std::string& key,
+                                               Event::Dispatcher& dispatcher,
+                                               Runtime::Loader& runtime);
+  size_t size() const { return connections_.size(); }
+
+private:
+  friend class SharedHttpHealthCheckConnection;
+
+  absl::flat_hash_map<std::string, std::weak_ptr<SharedHttpHealthCheckConnection>> connections_;
 };
 
 /**
@@ -55,6 +160,14 @@ public:
                         Event::Dispatcher& dispatcher, Runtime::Loader& runtime,
                         Random::RandomGenerator& random, HealthCheckEventLoggerPtr&& event_logger);
 
+  /**
+   * Sends the HTTP/2 health checks of the hosts on the connections of the registry, shared with
+   * the other health checkers of the same address and transport socket options. Must be called
+   * before start().
+   */
+  void shareConnections(SharedHttpHealthCheckConnectionRegistrySharedPtr registry,
+                        const envoy::config::core::v3::HealthCheck& config);
+
   /**
    * Utility class checking if given http status matches configured expectations.
    */
@@ -73,7 +186,8 @@ public:
 private:
   struct HttpActiveHealthCheckSession : public ActiveHealthCheckSession,
                                         public Http::ResponseDecoder,
-                                        public Http::StreamCallbacks {
+                                        public Http::StreamCallbacks,
+                                        public SharedHttpHealthCheckConnectionCallbacks {
     HttpActiveHealthCheckSession(HttpHealthCheckerImpl& parent, const HostSharedPtr& host);
     ~HttpActiveHealthCheckSession() override;
 
@@ -109,8 +223,17 @@ private:
     void onAboveWriteBufferHighWatermark() override {}
     void onBelowWriteBufferLowWatermark() override {}
 
+    // SharedHttpHealthCheckConnectionCallbacks
+    void onSharedConnectionClose() override { response_headers_.reset(); }
+    bool onSharedConnectionGoAway() override;
+    void onSharedConnectionGoAwayClosed(Http::GoAwayErrorCode error_code) override;
+
     void onEvent(Network::ConnectionEvent event);
     void onGoAway(Http::GoAwayErrorCode error_code);
+    // Returns the codec client the health checks are sent on, shared or not, if any.
+    Http::CodecClient* client() const {
+      return shared_connection_ != nullptr ? shared_connection_->client() : client_.get();
+    }
 
     class ConnectionCallbackImpl : public Network::ConnectionCallbacks {
     public:
@@ -138,6 +261,9 @@ private:
     HttpConnectionCallbackImpl http_connection_callback_impl_{*this};
     HttpHealthCheckerImpl& parent_;
     Http::CodecClientPtr client_;
+    // Set instead of client_ if the connection is shared with the other health checkers.
+    SharedHttpHealthCheckConnectionSharedPtr shared_connection_;
+    Http::RequestEncoder* request_encoder_{};
     Http::ResponseHeaderMapPtr response_headers_;
     const std::string& hostname_;
     const Http::Protocol protocol_;
@@ -166,6 +292,9 @@ private:
   absl::optional<Matchers::StringMatcherImpl> service_name_matcher_;
   Router::HeaderParserPtr request_headers_parser_;
   const HttpStatusChecker http_status_checker_;
+  SharedHttpHealthCheckConnectionRegistrySharedPtr connection_registry_;
+  // Appended to the address of a host for the key of its shared connection.
+  std::string connection_key_suffix_;
 
 protected:
   const Http::CodecType codec_client_type_;
@@ -346,8 +475,17 @@ private:
     void onAboveWriteBufferHighWatermark() override {}
     void onBelowWriteBufferLowWatermark() override {}
 
+    // SharedHttpHealthCheckConnectionCallbacks
+    void onSharedConnectionClose() override { response_headers_.reset(); }
+    bool onSharedConnectionGoAway() override;
+    void onSharedConnectionGoAwayClosed(Http::GoAwayErrorCode error_code) override;
+
     void onEvent(Network::ConnectionEvent event);
     void onGoAway(Http::GoAwayErrorCode error_code);
+    // Returns the codec client the health checks are sent on, shared or not, if any.
+    Http::CodecClient* client() const {
+      return shared_connection_ != nullptr ? shared_connection_->client() : client_.get();
+    }
 
     class ConnectionCallbackImpl : public Network::ConnectionCallbacks {
     public:
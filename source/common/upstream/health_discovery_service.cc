@@ -100,13 +100,14 @@ void HdsDelegate::handleFailure() {
   setHdsRetryTimer();
 }
 
-envoy::service::health::v3::HealthCheckRequestOrEndpointHealthResponse HdsDelegate::sendResponse() {
-  envoy::service::health::v3::HealthCheckRequestOrEndpointHealthResponse response;
+void HdsDelegate::buildHealthResponse() {
+  health_response_.Clear();
+  endpoint_health_entries_.clear();
 
   for (const auto& cluster : hds_clusters_) {
     // Add cluster health response and set name.
     auto* cluster_health =
-        response.mutable_endpoint_health_response()->add_cluster_endpoints_health();
+        health_response_.mutable_endpoint_health_response()->add_cluster_endpoints_health();
     cluster_health->set_cluster_name(cluster->info()->name());
 
     // Iterate through all hosts in our priority set.
@@ -120,34 +121,54 @@ envoy::service::health::v3::HealthCheckRequestOrEndpointHealthResponse HdsDelega
 
         // Add all hosts to this locality.
         for (const auto& host : locality_hosts) {
-          // Add this endpoint's health status to this locality grouping.
+          // Add this endpoint to this locality grouping, its health status is set when sending.
           auto* endpoint = locality_health->add_endpoints_health();
           Network::Utility::addressToProtobufAddress(
               *host->address(), *endpoint->mutable_endpoint()->mutable_address());
-          // TODO(lilika): Add support for more granular options of
-          // envoy::config::core::v3::HealthStatus
-          if (host->health() == Host::Health::Healthy) {
-            endpoint->set_health_status(envoy::config::core::v3::HEALTHY);
-          } else {
-            if (host->healthFlagGet(Host::HealthFlag::ACTIVE_HC_TIMEOUT)) {
-              endpoint->set_health_status(envoy::config::core::v3::TIMEOUT);
-            } else {
-              endpoint->set_health_status(envoy::config::core::v3::UNHEALTHY);
-            }
-          }
 
           // TODO(drewsortega): remove this once we are on v4 and endpoint_health_response is
-          // removed. Copy this endpoint's health info to the legacy flat-list.
-          response.mutable_endpoint_health_response()->add_endpoints_health()->MergeFrom(*endpoint);
+          // removed. Copy this endpoint's info to the legacy flat-list.
+          auto* legacy_endpoint =
+              health_response_.mutable_endpoint_health_response()->add_endpoints_health();
+          legacy_endpoint->MergeFrom(*endpoint);
+          endpoint_health_entries_.push_back({host, endpoint, legacy_endpoint});
         }
       }
     }
   }
-  ENVOY_LOG(debug, "Sending EndpointHealthResponse to server {}", response.DebugString());
-  stream_->sendMessage(response, false);
+  health_response_stale_ = false;
+}
+
+const envoy::service::health::v3::HealthCheckRequestOrEndpointHealthResponse&
+HdsDelegate::sendResponse() {
+  // The endpoints only change with the specifier, so the response is built again only then and
+  // each interval only updates the health status of the endpoints whose health changed.
+  if (health_response_stale_) {
+    buildHealthResponse();
+  }
+  for (const auto& entry : endpoint_health_entries_) {
+    // TODO(lilika): Add support for more granular options of
+    // envoy::config::core::v3::HealthStatus
+    envoy::config::core::v3::HealthStatus health_status;
+    if (entry.host_->health() == Host::Health::Healthy) {
+      health_status = envoy::config::core::v3::HEALTHY;
+    } else {
+      if (entry.host_->healthFlagGet(Host::HealthFlag::ACTIVE_HC_TIMEOUT)) {
+        health_status = envoy::config::core::v3::TIMEOUT;
+      } else {
+        health_status = envoy::config::core::v3::UNHEALTHY;
+      }
+    }
+    if (entry.endpoint_health_->health_status() != health_status) {
+      entry.endpoint_health_->set_health_status(health_status);
+      entry.legacy_endpoint_health_->set_health_status(health_status);
+    }
+  }
+  ENVOY_LOG(debug, "Sending EndpointHealthResponse to server {}", health_response_.DebugString());
+  stream_->sendMessage(health_response_, false);
   stats_.responses_.inc();
   setHdsStreamResponseTimer();
-  return response;
+  return health_response_;
 }
 
 void HdsDelegate::onCreateInitialMetadata(Http::RequestHeaderMap& metadata) {
@@ -276,6 +297,7 @@ void HdsDelegate::processMessage(
   // Overwrite our map data structures.
   hds_clusters_name_map_ = std::move(new_hds_clusters_name_map);
   hds_clusters_ = std::move(hds_clusters);
+  health_response_stale_ = true;
 
   // TODO: add stats reporting for number of clusters added, removed, and reused.
 }
@@ -164,7 +164,7 @@ public:
       std::unique_ptr<envoy::service::health::v3::HealthCheckSpecifier>&& message) override;
   void onReceiveTrailingMetadata(Http::ResponseTrailerMapPtr&& metadata) override;
   void onRemoteClose(Grpc::Status::GrpcStatus status, const std::string& message) override;
-  envoy::service::health::v3::HealthCheckRequestOrEndpointHealthResponse sendResponse();
+  const envoy::service::health::v3::HealthCheckRequestOrEndpointHealthResponse& sendResponse();
 
   std::vector<HdsClusterPtr> hdsClusters() { return hds_clusters_; };
 
@@ -182,6 +182,16 @@ private:
   void updateHdsCluster(HdsClusterPtr cluster,
                         const envoy::config::cluster::v3::Cluster& cluster_health_check);
   HdsClusterPtr createHdsCluster(const envoy::config::cluster::v3::Cluster& cluster_health_check);
+  // Builds the health response of the endpoints of hds_clusters_, without their health status.
+  void buildHealthResponse();
+
+  // An endpoint of the health response, with the host whose health status it reports.
+  struct EndpointHealthEntry {
+    HostSharedPtr host_;
+    envoy::service::health::v3::EndpointHealth* endpoint_health_;
+    envoy::service::health::v3::EndpointHealth* legacy_endpoint_health_;
+  };
+
   HdsDelegateStats stats_;
   const Protobuf::MethodDescriptor& service_method_;
 
@@ -210,6 +220,11 @@ private:
   std::vector<HdsClusterPtr> hds_clusters_;
   absl::flat_hash_map<std::string, HdsClusterPtr> hds_clusters_name_map_;
 
+  envoy::service::health::v3::HealthCheckRequestOrEndpointHealthResponse health_response_;
+  std::vector<EndpointHealthEntry> endpoint_health_entries_;
+  // Whether hds_clusters_ changed since health_response_ was built.
+  bool health_response_stale_{true};
+
   Event::TimerPtr hds_stream_response_timer_;
   Event::TimerPtr hds_retry_timer_;
   BackOffStrategyPtr backoff_strategy_;
@@ -1,5 +1,6 @@
 #include "source/common/upstream/load_balancer_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -10,7 +11,9 @@
 #include "envoy/upstream/upstream.h"
 
 #include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
 #include "source/common/protobuf/utility.h"
+#include "source/common/runtime/runtime_key_registry.h"
 
 #include "absl/container/fixed_array.h"
 
@@ -18,9 +21,17 @@ namespace Envoy {
 namespace Upstream {
 
 namespace {
-static const std::string RuntimeZoneEnabled = "upstream.zone_routing.enabled";
-static const std::string RuntimeMinClusterSize = "upstream.zone_routing.min_cluster_size";
-static const std::string RuntimePanicThreshold = "upstream.healthy_panic_threshold";
+// The runtime keys of the load balancers, looked up on every pick.
+struct LoadBalancerRuntimeKeys {
+  const Runtime::KeyHandle zone_enabled_{
+      Runtime::KeyRegistry::registerKey("upstream.zone_routing.enabled")};
+  const Runtime::KeyHandle min_cluster_size_{
+      Runtime::KeyRegistry::registerKey("upstream.zone_routing.min_cluster_size")};
+  const Runtime::KeyHandle panic_threshold_{
+      Runtime::KeyRegistry::registerKey("upstream.healthy_panic_threshold")};
+};
+
+const LoadBalancerRuntimeKeys& runtimeKeys() { CONSTRUCT_ON_FIRST_USE(LoadBalancerRuntimeKeys); }
 
 bool tooManyPreconnects(size_t num_preconnect_picks, uint32_t healthy_hosts) {
   // Currently we only allow the number of preconnected connections to equal the
@@ -250,7 +261,8 @@ void LoadBalancerBase::recalculatePerPriorityPanic() {
       calculateNormalizedTotalAvailability(per_priority_health_, per_priority_degraded_);
 
   const uint64_t panic_threshold = std::min<uint64_t>(
-      100, runtime_.snapshot().getInteger(RuntimePanicThreshold, default_healthy_panic_percent_));
+      100, runtime_.snapshot().getInteger(runtimeKeys().panic_threshold_,
+                                          default_healthy_panic_percent_));
 
   // This is corner case when panic is disabled and there is no hosts available.
   // LoadBalancerBase::choosePriority method expects that the sum of
@@ -498,7 +510,7 @@ bool ZoneAwareLoadBalancerBase::earlyExitNonLocalityRouting() {
 
   // Do not perform locality routing for small clusters.
   const uint64_t min_cluster_size =
-      runtime_.snapshot().getInteger(RuntimeMinClusterSize, min_cluster_size_);
+      runtime_.snapshot().getInteger(runtimeKeys().min_cluster_size_, min_cluster_size_);
   if (host_set.healthyHosts().size() < min_cluster_size) {
     stats_.lb_zone_cluster_too_small_.inc();
     return true;
@@ -527,7 +539,8 @@ HostConstSharedPtr LoadBalancerBase::chooseHost(LoadBalancerContext* context) {
 
 bool LoadBalancerBase::isHostSetInPanic(const HostSet& host_set) const {
   uint64_t global_panic_threshold = std::min<uint64_t>(
-      100, runtime_.snapshot().getInteger(RuntimePanicThreshold, default_healthy_panic_percent_));
+      100, runtime_.snapshot().getInteger(runtimeKeys().panic_threshold_,
+                                          default_healthy_panic_percent_));
   const auto host_count = host_set.hosts().size() - host_set.excludedHosts().size();
   double healthy_percent =
       host_count == 0 ? 0.0 : 100.0 * host_set.healthyHosts().size() / host_count;
@@ -652,7 +665,7 @@ ZoneAwareLoadBalancerBase::hostSourceToUse(LoadBalancerContext* context, uint64_
   }
 
   // Determine if the load balancer should do zone based routing for this pick.
-  if (!runtime_.snapshot().featureEnabled(RuntimeZoneEnabled, routing_enabled_)) {
+  if (!runtime_.snapshot().featureEnabled(runtimeKeys().zone_enabled_, routing_enabled_)) {
     hosts_source.source_type_ = sourceType(host_availability);
     return hosts_source;
   }
@@ -695,10 +708,25 @@ const HostVector& ZoneAwareLoadBalancerBase::hostSourceToHosts(HostsSource hosts
 EdfLoadBalancerBase::EdfLoadBalancerBase(
     const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterStats& stats,
     Runtime::Loader& runtime, Random::RandomGenerator& random,
-    const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config)
+    const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+    TimeSource& time_source)
     : ZoneAwareLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
                                 common_config),
-      seed_(random_.random()) {
+      seed_(random_.random()), time_source_(time_source),
+      slow_start_window_(
+          common_config.slow_start_config().has_slow_start_window()
+              ? absl::make_optional(std::chrono::milliseconds(DurationUtil::durationToMilliseconds(
+                    common_config.slow_start_config().slow_start_window())))
+              : absl::nullopt),
+      slow_start_aggression_runtime_(
+          common_config.slow_start_config().has_aggression()
+              ? std::make_unique<Runtime::Double>(common_config.slow_start_config().aggression(),
+                                                  runtime)
+              : nullptr),
+      slow_start_min_weight_(
+          common_config.slow_start_config().has_min_weight_percent()
+              ? common_config.slow_start_config().min_weight_percent().value() / 100.0
+              : 0.1) {
   // We fully recompute the schedulers for a given host set here on membership change, which is
   // consistent with what other LB implementations do (e.g. thread aware).
   // The downside of a full recompute is that time complexity is O(n * log n),
@@ -714,42 +742,95 @@ void EdfLoadBalancerBase::initialize() {
   }
 }
 
+double EdfLoadBalancerBase::slowStartFactor(const Host& host, MonotonicTime now) const {
+  MonotonicTime start = host.creationTime();
+  const absl::optional<MonotonicTime> last_hc_pass_time = host.lastHcPassTime();
+  if (last_hc_pass_time.has_value() && last_hc_pass_time.value() > start) {
+    start = last_hc_pass_time.value();
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start);
+  if (elapsed >= slow_start_window_.value()) {
+    return 1.0;
+  }
+
+  double aggression =
+      slow_start_aggression_runtime_ != nullptr ? slow_start_aggression_runtime_->value() : 1.0;
+  if (aggression <= 0.0) {
+    aggression = 1.0;
+  }
+  const double time_factor =
+      std::max(0.0, static_cast<double>(elapsed.count())) / slow_start_window_.value().count();
+  // The EDF schedule requires positive weights, even with a minimum weight of 0%.
+  return std::max({slow_start_min_weight_, std::pow(time_factor, 1.0 / aggression), 0.001});
+}
+
+void EdfLoadBalancerBase::maybeRefreshSlowStart() {
+  if (next_slow_start_refresh_.has_value() &&
+      time_source_.monotonicTime() >= next_slow_start_refresh_.value()) {
+    // Set again by refresh() if some hosts are still in their window.
+    next_slow_start_refresh_.reset();
+    initialize();
+  }
+}
+
 void EdfLoadBalancerBase::refresh(uint32_t priority) {
-  const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts) {
+  const MonotonicTime now = time_source_.monotonicTime();
+  const auto add_hosts_source = [this, now](HostsSource source, const HostVector& hosts) {
     // Nuke existing scheduler if it exists.
     auto& scheduler = scheduler_[source] = Scheduler{};
     refreshHostSource(source);
 
+    if (slow_start_window_.has_value()) {
+      bool in_slow_start = false;
+      std::vector<double> factors;
+      factors.reserve(hosts.size());
+      for (const HostSharedPtr& host : hosts) {
+        factors.push_back(slowStartFactor(*host, now));
+        in_slow_start |= factors.back() < 1.0;
+      }
+      if (in_slow_start) {
+        scheduler.slow_start_factors_ = std::move(factors);
+        const MonotonicTime next_refresh =
+            now + std::max(slow_start_window_.value() / 10, std::chrono::milliseconds(1));
+        if (!next_slow_start_refresh_.has_value() ||
+            next_refresh < next_slow_start_refresh_.value()) {
+          next_slow_start_refresh_ = next_refresh;
+        }
+      }
+    }
+
     // Check if the original host weights are equal and skip EDF creation if they are. When all
     // original weights are equal we can rely on unweighted host pick to do optimal round robin and
-    // least-loaded host selection with lower memory and CPU overhead.
-    if (hostWeightsAreEqual(hosts)) {
+    // least-loaded host selection with lower memory and CPU overhead. The hosts in their slow start
+    // window need the EDF schedule though.
+    if (scheduler.slow_start_factors_.empty() && hostWeightsAreEqual(hosts)) {
       // Skip edf creation.
       return;
     }
 
-    scheduler.edf_ = std::make_unique<EdfScheduler<const Host>>();
-
     // Populate scheduler with host list.
     // TODO(mattklein123): We must build the EDF schedule even if all of the hosts are currently
     // weighted 1. This is because currently we don't refresh host sets if only weights change.
     // We should probably change this to refresh at all times. See the comment in
     // BaseDynamicClusterImpl::updateDynamicHostList about this.
-    for (const auto& host : hosts) {
-      // We use a fixed weight here. While the weight may change without
-      // notification, this will only be stale until this host is next picked,
-      // at which point it is reinserted into the EdfScheduler with its new
-      // weight in chooseHost().
-      scheduler.edf_->add(hostWeight(*host), host);
-    }
+    // We use a fixed weight here. While the weight may change without notification, this will
+    // only be stale until this host is next picked, at which point it is reinserted into the
+    // EdfScheduler with its new weight in chooseHost().
+    // The schedule refers to hosts by their index in the source's host vector, which stays valid
+    // until the next refresh since every membership change rebuilds the schedulers.
+    const std::vector<double>& factors = scheduler.slow_start_factors_;
+    const auto host_weight = [this, &hosts, &factors](uint32_t index) {
+      const double weight = hostWeight(*hosts[index]);
+      return factors.empty() ? weight : weight * factors[index];
+    };
+    scheduler.edf_.emplace(hosts.size(), host_weight);
 
     // Cycle through hosts to achieve the intended offset behavior.
     // TODO(htuch): Consider how we can avoid biasing towards earlier hosts in the schedule across
     // refreshes for the weighted case.
     if (!hosts.empty()) {
       for (uint32_t i = 0; i < seed_ % hosts.size(); ++i) {
-        auto host =
-            scheduler.edf_->pickAndAdd([this](const Host& host) { return hostWeight(host); });
+        scheduler.edf_->pickAndAdd(host_weight);
       }
     }
   };
@@ -775,10 +856,28 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
   }
 }
 
+HostConstSharedPtr EdfLoadBalancerBase::pickWeightedHost(Scheduler& scheduler,
+                                                         const HostsSource& source, bool peek) {
+  IndexedEdfScheduler& edf = *scheduler.edf_;
+  const HostVector& hosts = hostSourceToHosts(source);
+  // The schedule is rebuilt on every membership change, so it always covers the current hosts.
+  ASSERT(edf.size() == hosts.size());
+  if (edf.empty() || edf.size() != hosts.size()) {
+    return nullptr;
+  }
+  const std::vector<double>& factors = scheduler.slow_start_factors_;
+  const auto host_weight = [this, &hosts, &factors](uint32_t index) {
+    const double weight = hostWeight(*hosts[index]);
+    return factors.empty() ? weight : weight * factors[index];
+  };
+  return hosts[peek ? edf.peekAgain(host_weight) : edf.pickAndAdd(host_weight)];
+}
+
 HostConstSharedPtr EdfLoadBalancerBase::peekAnotherHost(LoadBalancerContext* context) {
   if (tooManyPreconnects(stashed_random_.size(), total_healthy_hosts_)) {
     return nullptr;
   }
+  maybeRefreshSlowStart();
 
   const absl::optional<HostsSource> hosts_source = hostSourceToUse(context, random(true));
   if (!hosts_source) {
@@ -795,8 +894,8 @@ HostConstSharedPtr EdfLoadBalancerBase::peekAnotherHost(LoadBalancerContext* con
   // BaseDynamicClusterImpl::updateDynamicHostList, we must do a runtime pivot here to determine
   // whether to use EDF or do unweighted (fast) selection. EDF is non-null iff the original weights
   // of 2 or more hosts differ.
-  if (scheduler.edf_ != nullptr) {
-    return scheduler.edf_->peekAgain([this](const Host& host) { return hostWeight(host); });
+  if (scheduler.edf_.has_value()) {
+    return pickWeightedHost(scheduler, *hosts_source, true);
   } else {
     const HostVector& hosts_to_use = hostSourceToHosts(*hosts_source);
     if (hosts_to_use.empty()) {
@@ -807,6 +906,7 @@ HostConstSharedPtr EdfLoadBalancerBase::peekAnotherHost(LoadBalancerContext* con
 }
 
 HostConstSharedPtr EdfLoadBalancerBase::chooseHostOnce(LoadBalancerContext* context) {
+  maybeRefreshSlowStart();
   const absl::optional<HostsSource> hosts_source = hostSourceToUse(context, random(false));
   if (!hosts_source) {
     return nullptr;
@@ -821,9 +921,8 @@ HostConstSharedPtr EdfLoadBalancerBase::chooseHostOnce(LoadBalancerContext* cont
   // BaseDynamicClusterImpl::updateDynamicHostList, we must do a runtime pivot here to determine
   // whether to use EDF or do unweighted (fast) selection. EDF is non-null iff the original weights
   // of 2 or more hosts differ.
-  if (scheduler.edf_ != nullptr) {
-    auto host = scheduler.edf_->pickAndAdd([this](const Host& host) { return hostWeight(host); });
-    return host;
+  if (scheduler.edf_.has_value()) {
+    return pickWeightedHost(scheduler, *hosts_source, false);
   } else {
     const HostVector& hosts_to_use = hostSourceToHosts(*hosts_source);
     if (hosts_to_use.empty()) {
@@ -864,6 +963,47 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector
   return candidate_host;
 }
 
+double PeakEwmaLoadBalancer::hostCost(const Host& host) {
+  const uint64_t active_rq = host.stats().rq_active_.value();
+  const ResponseTimeTracker* tracker = host.responseTimeTracker();
+  const double response_time = tracker != nullptr ? tracker->responseTime() : 0.0;
+  if (response_time == 0.0) {
+    return active_rq == 0 ? 0.0 : UnknownResponseTimePenalty + active_rq;
+  }
+  return response_time * (active_rq + 1);
+}
+
+double PeakEwmaLoadBalancer::hostWeight(const Host& host) {
+  // Keep the weight finite for idle hosts without a response time estimate. These are the hosts
+  // P2C would pick first, so they get the highest weight rather than infinity.
+  return static_cast<double>(host.weight()) / std::max(hostCost(host), 1.0);
+}
+
+HostConstSharedPtr PeakEwmaLoadBalancer::unweightedHostPeek(const HostVector&,
+                                                            const HostsSource&) {
+  // As with LeastRequestLoadBalancer, the host chosen depends on state that changes between the
+  // peek and the pick, so deterministic preconnecting is not possible.
+  return nullptr;
+}
+
+HostConstSharedPtr PeakEwmaLoadBalancer::unweightedHostPick(const HostVector& hosts_to_use,
+                                                            const HostsSource&) {
+  HostSharedPtr candidate_host = nullptr;
+  double candidate_cost = 0;
+  for (uint32_t choice_idx = 0; choice_idx < choice_count_; ++choice_idx) {
+    const int rand_idx = random_.random() % hosts_to_use.size();
+    const HostSharedPtr& sampled_host = hosts_to_use[rand_idx];
+    const double sampled_cost = hostCost(*sampled_host);
+
+    if (candidate_host == nullptr || sampled_cost < candidate_cost) {
+      candidate_host = sampled_host;
+      candidate_cost = sampled_cost;
+    }
+  }
+
+  return candidate_host;
+}
+
 HostConstSharedPtr RandomLoadBalancer::peekAnotherHost(LoadBalancerContext* context) {
   if (tooManyPreconnects(stashed_random_.size(), total_healthy_hosts_)) {
     return nullptr;
@@ -9,6 +9,7 @@
 
 #include "envoy/common/callback.h"
 #include "envoy/common/random_generator.h"
+#include "envoy/common/time.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/upstream/load_balancer.h"
@@ -373,13 +374,20 @@ private:
  *
  * This base class also supports unweighted selection which derived classes can use to customize
  * behavior. Derived classes can also override how host weight is determined when in weighted mode.
+ *
+ * With slow start configured, the weight of a host is scaled down while it's in its slow start
+ * window, which begins when the host is created or passes a health check after failing health
+ * checks. The scaling factors are computed when the schedulers are built, and the schedulers are
+ * rebuilt ten times over the window so that the factors follow the ramp up. Weighted mode is used
+ * for as long as some hosts are in their window.
  */
 class EdfLoadBalancerBase : public ZoneAwareLoadBalancerBase {
 public:
   EdfLoadBalancerBase(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
                       ClusterStats& stats, Runtime::Loader& runtime,
                       Random::RandomGenerator& random,
-                      const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config);
+                      const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+                      TimeSource& time_source);
 
   // Upstream::LoadBalancerBase
   HostConstSharedPtr peekAnotherHost(LoadBalancerContext* context) override;
@@ -387,10 +395,14 @@ public:
 
 protected:
   struct Scheduler {
-    // EdfScheduler for weighted LB. The edf_ is only created when the original
-    // host weights of 2 or more hosts differ. When not present, the
+    // EDF schedule for weighted LB, indexing into the hosts of the HostsSource. The edf_ is only
+    // created when the original host weights of 2 or more hosts differ. When not present, the
     // implementation of chooseHostOnce falls back to unweightedHostPick.
-    std::unique_ptr<EdfScheduler<const Host>> edf_;
+    absl::optional<IndexedEdfScheduler> edf_;
+    // The factors the weights of the hosts are multiplied by, by index, while some of them are in
+    // their slow start window. Empty if none is. They are only recomputed by refresh(), which keeps
+    // the picks about as cheap as without slow start.
+    std::vector<double> slow_start_factors_;
   };
 
   void initialize();
@@ -411,10 +423,24 @@ private:
                                                 const HostsSource& source) PURE;
   virtual HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
                                                 const HostsSource& source) PURE;
+  HostConstSharedPtr pickWeightedHost(Scheduler& scheduler, const HostsSource& source, bool peek);
+  // Returns the factor the weight of a host is multiplied by at now, 1.0 once the host is out of
+  // its slow start window.
+  double slowStartFactor(const Host& host, MonotonicTime now) const;
+  // Recomputes the slow start factors of the hosts, if it's time to.
+  void maybeRefreshSlowStart();
 
   // Scheduler for each valid HostsSource.
   absl::node_hash_map<HostsSource, Scheduler, HostsSourceHash> scheduler_;
   Common::CallbackHandlePtr priority_update_cb_;
+
+  TimeSource& time_source_;
+  // Slow start is disabled if slow_start_window_ is not set.
+  const absl::optional<std::chrono::milliseconds> slow_start_window_;
+  const std::unique_ptr<Runtime::Double> slow_start_aggression_runtime_;
+  const double slow_start_min_weight_;
+  // When the slow start factors are next recomputed, while some hosts are in their window.
+  absl::optional<MonotonicTime> next_slow_start_refresh_;
 };
 
 /**
@@ -426,9 +452,10 @@ public:
   RoundRobinLoadBalancer(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
                          ClusterStats& stats, Runtime::Loader& runtime,
                          Random::RandomGenerator& random,
-                         const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config)
-      : EdfLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
-                            common_config) {
+                         const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+                         TimeSource& time_source)
+      : EdfLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random, common_config,
+                            time_source) {
     initialize();
   }
 
@@ -493,9 +520,10 @@ public:
       Runtime::Loader& runtime, Random::RandomGenerator& random,
       const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
       const absl::optional<envoy::config::cluster::v3::Cluster::LeastRequestLbConfig>
-          least_request_config)
-      : EdfLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
-                            common_config),
+          least_request_config,
+      TimeSource& time_source)
+      : EdfLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random, common_config,
+                            time_source),
         choice_count_(
             least_request_config.has_value()
                 ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(least_request_config.value(), choice_count, 2)
@@ -568,6 +596,61 @@ private:
   const std::unique_ptr<Runtime::Double> active_request_bias_runtime_;
 };
 
+/**
+ * Peak EWMA load balancer.
+ *
+ * When all hosts have the same weight it randomly picks N healthy hosts (where N is specified in
+ * the LB configuration) and chooses the one with the lowest cost, where cost is the host's peak
+ * EWMA response time (see PeakEwmaTracker) multiplied by its number of active requests plus one.
+ * This favors hosts that are both fast and lightly loaded, so slow hosts in a heterogeneous
+ * cluster receive proportionally less traffic. The technique is the one used by Finagle's
+ * PeakEwma balancer.
+ *
+ * A host with no recorded response time has no latency estimate. Such a host is preferred while
+ * it is idle, so that new hosts are probed quickly, but once it has active requests it is ranked
+ * below every host with a latency estimate.
+ *
+ * When hosts have different weights, an RR EDF schedule is used and the host weight is divided by
+ * the host's cost at pick/insert time, as is done by the least request load balancer.
+ */
+class PeakEwmaLoadBalancer : public EdfLoadBalancerBase {
+public:
+  PeakEwmaLoadBalancer(
+      const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterStats& stats,
+      Runtime::Loader& runtime, Random::RandomGenerator& random,
+      const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+      const absl::optional<envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig>&
+          peak_ewma_config,
+      TimeSource& time_source)
+      : EdfLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random, common_config,
+                            time_source),
+        choice_count_(
+            peak_ewma_config.has_value()
+                ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(peak_ewma_config.value(), choice_count, 2)
+                : 2) {
+    initialize();
+  }
+
+  /**
+   * @return the cost of sending a request to the host. Lower is better.
+   */
+  static double hostCost(const Host& host);
+
+private:
+  void refreshHostSource(const HostsSource&) override {}
+  double hostWeight(const Host& host) override;
+  HostConstSharedPtr unweightedHostPeek(const HostVector& hosts_to_use,
+                                        const HostsSource& source) override;
+  HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
+                                        const HostsSource& source) override;
+
+  // Cost of a host with active requests but no response time estimate, in microseconds. It is
+  // larger than any realistic response time times active requests product.
+  static constexpr double UnknownResponseTimePenalty = 1e15;
+
+  const uint32_t choice_count_;
+};
+
 /**
  * Random load balancer that picks a random host out of all hosts.
  */
@@ -628,7 +711,9 @@ public:
         default_subset_(subset_config.default_subset()),
         locality_weight_aware_(subset_config.locality_weight_aware()),
         scale_locality_weight_(subset_config.scale_locality_weight()),
-        panic_mode_any_(subset_config.panic_mode_any()), list_as_any_(subset_config.list_as_any()) {
+        panic_mode_any_(subset_config.panic_mode_any()), list_as_any_(subset_config.list_as_any()),
+        lazy_build_(subset_config.lazy_build()),
+        max_built_subsets_(subset_config.max_built_subsets()) {
     for (const auto& subset : subset_config.subset_selectors()) {
       if (!subset.keys().empty()) {
         subset_selectors_.emplace_back(std::make_shared<SubsetSelectorImpl>(
@@ -652,6 +737,8 @@ public:
   bool scaleLocalityWeight() const override { return scale_locality_weight_; }
   bool panicModeAny() const override { return panic_mode_any_; }
   bool listAsAny() const override { return list_as_any_; }
+  bool lazyBuild() const override { return lazy_build_; }
+  uint32_t maxBuiltSubsets() const override { return max_built_subsets_; }
 
 private:
   const bool enabled_;
@@ -663,6 +750,8 @@ private:
   const bool scale_locality_weight_;
   const bool panic_mode_any_;
   const bool list_as_any_;
+  const bool lazy_build_;
+  const uint32_t max_built_subsets_;
 };
 
 } // namespace Upstream
@@ -6,6 +6,8 @@
 #include "source/common/config/version_converter.h"
 #include "source/common/protobuf/protobuf.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -76,31 +78,39 @@ void LoadStatsReporter::sendLoadStatsRequest() {
     if (cluster.info()->edsServiceName().has_value()) {
       cluster_stats->set_cluster_service_name(cluster.info()->edsServiceName().value());
     }
+    // The hosts count their load per locality, so this reads the load of each locality rather than
+    // the stats of each host.
+    absl::flat_hash_set<const LocalityLoadStats*> reported_localities;
     for (auto& host_set : cluster.prioritySet().hostSetsPerPriority()) {
       ENVOY_LOG(trace, "Load report locality count {}", host_set->hostsPerLocality().get().size());
       for (auto& hosts : host_set->hostsPerLocality().get()) {
         ASSERT(!hosts.empty());
-        uint64_t rq_success = 0;
-        uint64_t rq_error = 0;
-        uint64_t rq_active = 0;
-        uint64_t rq_issued = 0;
-        for (const auto& host : hosts) {
-          rq_success += host->stats().rq_success_.latch();
-          rq_error += host->stats().rq_error_.latch();
-          rq_active += host->stats().rq_active_.value();
-          rq_issued += host->stats().rq_total_.latch();
+        LocalityLoadStats* locality_load_stats = hosts[0]->stats().locality_load_stats_;
+        // The load of a locality with hosts at several priorities is reported at the first of them.
+        if (locality_load_stats == nullptr ||
+            !reported_localities.insert(locality_load_stats).second) {
+          continue;
         }
-        if (rq_success + rq_error + rq_active != 0) {
+        const LocalityLoadStats::Load load = locality_load_stats->latch();
+        if (load.rq_success_ + load.rq_error_ + load.rq_active_ != 0) {
           auto* locality_stats = cluster_stats->add_upstream_locality_stats();
           locality_stats->mutable_locality()->MergeFrom(hosts[0]->locality());
           locality_stats->set_priority(host_set->priority());
-          locality_stats->set_total_successful_requests(rq_success);
-          locality_stats->set_total_error_requests(rq_error);
-          locality_stats->set_total_requests_in_progress(rq_active);
-          locality_stats->set_total_issued_requests(rq_issued);
+          locality_stats->set_total_successful_requests(load.rq_success_);
+          locality_stats->set_total_error_requests(load.rq_error_);
+          locality_stats->set_total_requests_in_progress(load.rq_active_);
+          locality_stats->set_total_issued_requests(load.rq_issued_);
         }
       }
     }
+    // As when the stats of the hosts were read, the load of the localities left without hosts is
+    // dropped.
+    cluster.info()->localityLoadStats().iterate(
+        [&reported_localities](LocalityLoadStats& locality_load_stats) {
+          if (!reported_localities.contains(&locality_load_stats)) {
+            locality_load_stats.latch();
+          }
+        });
     cluster_stats->set_total_dropped_requests(
         cluster.info()->loadReportStats().upstream_rq_dropped_.latch());
     const auto now = time_source_.monotonicTime().time_since_epoch();
@@ -187,13 +197,8 @@ void LoadStatsReporter::startLoadReportPeriod() {
       return;
     }
     auto& cluster = it->second.get();
-    for (auto& host_set : cluster.prioritySet().hostSetsPerPriority()) {
-      for (const auto& host : host_set->hosts()) {
-        host->stats().rq_success_.latch();
-        host->stats().rq_error_.latch();
-        host->stats().rq_total_.latch();
-      }
-    }
+    cluster.info()->localityLoadStats().iterate(
+        [](LocalityLoadStats& locality_load_stats) { locality_load_stats.latch(); });
     cluster.info()->loadReportStats().upstream_rq_dropped_.latch();
   };
   if (message_->send_all_clusters()) {
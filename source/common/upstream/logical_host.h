@@ -90,6 +90,9 @@ public:
   Outlier::DetectorHostMonitor& outlierDetector() const override {
     return logical_host_->outlierDetector();
   }
+  ResponseTimeTracker* responseTimeTracker() const override {
+    return logical_host_->responseTimeTracker();
+  }
   HostStats& stats() const override { return logical_host_->stats(); }
   const std::string& hostnameForHealthChecks() const override {
     return logical_host_->hostnameForHealthChecks();
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 #include "envoy/common/random_generator.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/stats/scope.h"
@@ -46,22 +50,36 @@ public:
 
 private:
   struct TableBuildEntry {
-    TableBuildEntry(const HostConstSharedPtr& host, uint64_t offset, uint64_t skip, double weight)
-        : host_(host), offset_(offset), skip_(skip), weight_(weight) {}
+    TableBuildEntry(uint32_t host_index, uint64_t offset, uint64_t skip, double weight)
+        : host_index_(host_index), skip_(skip), weight_(weight), permutation_(offset) {}
 
-    HostConstSharedPtr host_;
-    const uint64_t offset_;
+    const uint32_t host_index_;
     const uint64_t skip_;
     const double weight_;
     double target_weight_{};
-    uint64_t next_{};
+    // Current position in this entry's permutation, i.e. (offset + skip * next) % table_size.
+    uint64_t permutation_;
     uint64_t count_{};
   };
 
-  uint64_t permutation(const TableBuildEntry& entry);
+  // Marks a table slot which has not yet been assigned a host.
+  static constexpr uint32_t UnassignedEntry = std::numeric_limits<uint32_t>::max();
+
+  // Advances the entry to the next slot of its permutation. This is equivalent to incrementing
+  // next in the paper's pseudocode but avoids a 64-bit modulo per probe.
+  void nextPermutation(TableBuildEntry& entry) const {
+    entry.permutation_ += entry.skip_;
+    if (entry.permutation_ >= table_size_) {
+      entry.permutation_ -= table_size_;
+    }
+  }
 
   const uint64_t table_size_;
-  std::vector<HostConstSharedPtr> table_;
+  std::vector<HostConstSharedPtr> hosts_;
+  // Each entry is an index into hosts_. Storing indices rather than shared pointers keeps the
+  // table a quarter of the size, which matters for both the build and lookups, and avoids a
+  // reference count update per table entry.
+  std::vector<uint32_t> table_;
   MaglevLoadBalancerStats& stats_;
 };
 
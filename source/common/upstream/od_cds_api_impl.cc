@@ -0,0 +1,121 @@
+#include "source/common/upstream/od_cds_api_impl.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/grpc/common.h"
+
+#include "absl/strings/str_join.h"
+
+namespace Envoy {
+namespace Upstream {
+
+OdCdsApiImplPtr OdCdsApiImpl::create(const envoy::config::core::v3::ConfigSource& odcds_config,
+                                     std::chrono::milliseconds negative_cache_ttl,
+                                     ClusterManager& cm, MissingClusterNotifier& notifier,
+                                     Stats::Scope& scope, TimeSource& time_source,
+                                     ProtobufMessage::ValidationVisitor& validation_visitor) {
+  return OdCdsApiImplPtr{new OdCdsApiImpl(odcds_config, negative_cache_ttl, cm, notifier, scope,
+                                          time_source, validation_visitor)};
+}
+
+OdCdsApiImpl::OdCdsApiImpl(const envoy::config::core::v3::ConfigSource& odcds_config,
+                           std::chrono::milliseconds negative_cache_ttl, ClusterManager& cm,
+                           MissingClusterNotifier& notifier, Stats::Scope& scope,
+                           TimeSource& time_source,
+                           ProtobufMessage::ValidationVisitor& validation_visitor)
+    : Envoy::Config::SubscriptionBase<envoy::config::cluster::v3::Cluster>(
+          odcds_config.resource_api_version(), validation_visitor, "name"),
+      helper_(cm, "odcds"), notifier_(notifier),
+      scope_(scope.createScope("cluster_manager.odcds.")),
+      stats_({ALL_ODCDS_STATS(POOL_COUNTER(*scope_), POOL_GAUGE(*scope_))}),
+      time_source_(time_source), negative_cache_ttl_(negative_cache_ttl) {
+  const auto resource_name = getResourceName();
+  subscription_ = cm.subscriptionFactory().subscriptionFromConfigSource(
+      odcds_config, Grpc::Common::typeUrl(resource_name), *scope_, *this, resource_decoder_, {});
+}
+
+void OdCdsApiImpl::updateOnDemand(const std::string& name) {
+  stats_.cluster_discovery_requested_.inc();
+  if (!started_) {
+    started_ = true;
+    subscription_->start({name});
+    return;
+  }
+  subscription_->requestOnDemandUpdate({name});
+}
+
+bool OdCdsApiImpl::isMissing(const std::string& name) {
+  auto it = negative_cache_index_.find(name);
+  if (it == negative_cache_index_.end()) {
+    return false;
+  }
+  if (it->second->expiry_ <= time_source_.monotonicTime()) {
+    negative_cache_.erase(it->second);
+    negative_cache_index_.erase(it);
+    stats_.negative_cache_size_.dec();
+    return false;
+  }
+  return true;
+}
+
+void OdCdsApiImpl::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& resources,
+                                  const std::string& version_info) {
+  // The state of the world of an on demand subscription only holds the requested clusters, so the
+  // ones it lacks are not removed.
+  onConfigUpdate(resources, {}, version_info);
+}
+
+void OdCdsApiImpl::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& added_resources,
+                                  const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+                                  const std::string& system_version_info) {
+  for (const auto& resource : added_resources) {
+    removeFromNegativeCache(resource.get().name());
+  }
+  auto exception_msgs =
+      helper_.onConfigUpdate(added_resources, removed_resources, system_version_info);
+  for (const auto& name : removed_resources) {
+    stats_.cluster_missing_.inc();
+    addToNegativeCache(name);
+    notifier_.notifyMissingCluster(name);
+  }
+  if (!exception_msgs.empty()) {
+    throw EnvoyException(
+        fmt::format("Error adding/updating cluster(s) {}", absl::StrJoin(exception_msgs, ", ")));
+  }
+}
+
+void OdCdsApiImpl::onConfigUpdateFailed(Envoy::Config::ConfigUpdateFailureReason reason,
+                                        const EnvoyException*) {
+  ASSERT(Envoy::Config::ConfigUpdateFailureReason::ConnectionFailure != reason);
+  // The pending discoveries are left to time out.
+}
+
+void OdCdsApiImpl::addToNegativeCache(const std::string& name) {
+  if (negative_cache_ttl_.count() == 0) {
+    return;
+  }
+  removeFromNegativeCache(name);
+  const MonotonicTime now = time_source_.monotonicTime();
+  // Drop the expired clusters first, and then the oldest ones if the cache is still full.
+  while (!negative_cache_.empty() && (negative_cache_.front().expiry_ <= now ||
+                                      negative_cache_.size() >= MaxNegativeCacheSize)) {
+    negative_cache_index_.erase(negative_cache_.front().name_);
+    negative_cache_.pop_front();
+    stats_.negative_cache_size_.dec();
+  }
+  negative_cache_.push_back({name, now + negative_cache_ttl_});
+  negative_cache_index_[name] = std::prev(negative_cache_.end());
+  stats_.negative_cache_size_.inc();
+}
+
+void OdCdsApiImpl::removeFromNegativeCache(const std::string& name) {
+  auto it = negative_cache_index_.find(name);
+  if (it == negative_cache_index_.end()) {
+    return;
+  }
+  negative_cache_.erase(it->second);
+  negative_cache_index_.erase(it);
+  stats_.negative_cache_size_.dec();
+}
+
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/config/cluster/v3/cluster.pb.validate.h"
+#include "envoy/config/core/v3/config_source.pb.h"
+#include "envoy/config/subscription.h"
+#include "envoy/protobuf/message_validator.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/upstream/cluster_manager.h"
+
+#include "source/common/config/subscription_base.h"
+#include "source/common/protobuf/protobuf.h"
+#include "source/common/upstream/cds_api_helper.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * All on demand CDS stats. @see stats_macros.h
+ */
+#define ALL_ODCDS_STATS(COUNTER, GAUGE)                                                            \
+  COUNTER(cluster_discovery_requested)                                                             \
+  COUNTER(cluster_missing)                                                                         \
+  COUNTER(cluster_negative_cache_hit)                                                              \
+  COUNTER(cluster_timeout)                                                                         \
+  GAUGE(negative_cache_size, NeverImport)
+
+/**
+ * Struct definition for all on demand CDS stats. @see stats_macros.h
+ */
+struct OdCdsStats {
+  ALL_ODCDS_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * Told about the clusters the discovery service does not know.
+ */
+class MissingClusterNotifier {
+public:
+  virtual ~MissingClusterNotifier() = default;
+
+  /**
+   * Called on the main thread when the discovery service tells that it does not know a cluster.
+   * @param name supplies the name of the cluster.
+   */
+  virtual void notifyMissingCluster(absl::string_view name) PURE;
+};
+
+/**
+ * On demand CDS API implementation, which fetches the clusters one by one as they are requested,
+ * over a delta subscription which is only started with the first request. The clusters the
+ * discovery service removes, which it does for the requested ones it does not know, are kept in a
+ * negative cache for a while, so that the requests for them do not reach the discovery service
+ * each time.
+ */
+class OdCdsApiImpl : Envoy::Config::SubscriptionBase<envoy::config::cluster::v3::Cluster> {
+public:
+  // The most clusters kept in the negative cache, the oldest ones being evicted first, so that it
+  // stays bounded whatever the names the requests reference.
+  static constexpr size_t MaxNegativeCacheSize = 65536;
+
+  static std::unique_ptr<OdCdsApiImpl>
+  create(const envoy::config::core::v3::ConfigSource& odcds_config,
+         std::chrono::milliseconds negative_cache_ttl, ClusterManager& cm,
+         MissingClusterNotifier& notifier, Stats::Scope& scope, TimeSource& time_source,
+         ProtobufMessage::ValidationVisitor& validation_visitor);
+  ~OdCdsApiImpl() override { stats_.negative_cache_size_.sub(negative_cache_.size()); }
+
+  /**
+   * Request a cluster from the discovery service, starting the subscription if needed.
+   * @param name supplies the name of the cluster.
+   */
+  void updateOnDemand(const std::string& name);
+
+  /**
+   * @return whether the discovery service told recently enough that it does not know the cluster.
+   */
+  bool isMissing(const std::string& name);
+
+  OdCdsStats& stats() { return stats_; }
+
+private:
+  OdCdsApiImpl(const envoy::config::core::v3::ConfigSource& odcds_config,
+               std::chrono::milliseconds negative_cache_ttl, ClusterManager& cm,
+               MissingClusterNotifier& notifier, Stats::Scope& scope, TimeSource& time_source,
+               ProtobufMessage::ValidationVisitor& validation_visitor);
+
+  // Config::SubscriptionCallbacks
+  void onConfigUpdate(const std::vector<Config::DecodedResourceRef>& resources,
+                      const std::string& version_info) override;
+  void onConfigUpdate(const std::vector<Config::DecodedResourceRef>& added_resources,
+                      const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+                      const std::string& system_version_info) override;
+  void onConfigUpdateFailed(Envoy::Config::ConfigUpdateFailureReason reason,
+                            const EnvoyException* e) override;
+
+  void addToNegativeCache(const std::string& name);
+  void removeFromNegativeCache(const std::string& name);
+
+  struct NegativeCacheEntry {
+    std::string name_;
+    MonotonicTime expiry_;
+  };
+  using NegativeCacheList = std::list<NegativeCacheEntry>;
+
+  CdsApiHelper helper_;
+  MissingClusterNotifier& notifier_;
+  Stats::ScopePtr scope_;
+  OdCdsStats stats_;
+  TimeSource& time_source_;
+  const std::chrono::milliseconds negative_cache_ttl_;
+  Config::SubscriptionPtr subscription_;
+  bool started_{};
+  // The clusters the discovery service does not know, in the order they expire, all of them
+  // living for the same TTL.
+  NegativeCacheList negative_cache_;
+  absl::flat_hash_map<std::string, NegativeCacheList::iterator> negative_cache_index_;
+};
+
+using OdCdsApiImplPtr = std::unique_ptr<OdCdsApiImpl>;
+
+} // namespace Upstream
+} // namespace Envoy
@@ -60,15 +60,18 @@ HostConstSharedPtr OriginalDstCluster::LoadBalancer::chooseHost(LoadBalancerCont
             envoy::config::core::v3::UNKNOWN, parent_->time_source_));
         ENVOY_LOG(debug, "Created host {}.", host->address()->asString());
 
-        // Tell the cluster about the new host
-        // lambda cannot capture a member by value.
-        std::weak_ptr<OriginalDstCluster> post_parent = parent_;
-        parent_->dispatcher_.post([post_parent, host]() mutable {
-          // The main cluster may have disappeared while this post was queued.
-          if (std::shared_ptr<OriginalDstCluster> parent = post_parent.lock()) {
-            parent->addHost(host);
-          }
-        });
+        // Tell the cluster about the new host, along with the other hosts created before the main
+        // thread gets to add them.
+        if (parent_->queueHost(host)) {
+          // lambda cannot capture a member by value.
+          std::weak_ptr<OriginalDstCluster> post_parent = parent_;
+          parent_->dispatcher_.post([post_parent]() {
+            // The main cluster may have disappeared while this post was queued.
+            if (std::shared_ptr<OriginalDstCluster> parent = post_parent.lock()) {
+              parent->addQueuedHosts();
+            }
+          });
+        }
         return host;
       } else {
         ENVOY_LOG(debug, "Failed to create host for {}.", dst_addr.asString());
@@ -125,22 +128,41 @@ OriginalDstCluster::OriginalDstCluster(
   cleanup_timer_->enableTimer(cleanup_interval_ms_);
 }
 
-void OriginalDstCluster::addHost(HostSharedPtr& host) {
+bool OriginalDstCluster::queueHost(HostSharedPtr host) {
+  absl::MutexLock lock(&queued_hosts_lock_);
+  queued_hosts_.emplace_back(std::move(host));
+  return queued_hosts_.size() == 1;
+}
+
+void OriginalDstCluster::addQueuedHosts() {
+  HostVector queued_hosts;
+  {
+    absl::MutexLock lock(&queued_hosts_lock_);
+    queued_hosts.swap(queued_hosts_);
+  }
+
+  // The host map and the host set are copied once for all the queued hosts.
   HostMapSharedPtr new_host_map = std::make_shared<HostMap>(*getCurrentHostMap());
-  auto pair = new_host_map->emplace(host->address()->asString(), host);
-  bool added = pair.second;
-  if (added) {
-    ENVOY_LOG(debug, "addHost() adding {}", host->address()->asString());
-    setHostMap(new_host_map);
-    // Given the current config, only EDS clusters support multiple priorities.
-    ASSERT(priority_set_.hostSetsPerPriority().size() == 1);
-    const auto& first_host_set = priority_set_.getOrCreateHostSet(0);
-    HostVectorSharedPtr all_hosts(new HostVector(first_host_set.hosts()));
-    all_hosts->emplace_back(host);
-    priority_set_.updateHosts(0,
-                              HostSetImpl::partitionHosts(all_hosts, HostsPerLocalityImpl::empty()),
-                              {}, {std::move(host)}, {}, absl::nullopt);
+  HostVector hosts_added;
+  for (HostSharedPtr& host : queued_hosts) {
+    if (new_host_map->emplace(host->address()->asString(), host).second) {
+      ENVOY_LOG(debug, "addQueuedHosts() adding {}", host->address()->asString());
+      hosts_added.emplace_back(std::move(host));
+    }
   }
+  if (hosts_added.empty()) {
+    return;
+  }
+
+  setHostMap(new_host_map);
+  // Given the current config, only EDS clusters support multiple priorities.
+  ASSERT(priority_set_.hostSetsPerPriority().size() == 1);
+  const auto& first_host_set = priority_set_.getOrCreateHostSet(0);
+  HostVectorSharedPtr all_hosts(new HostVector(first_host_set.hosts()));
+  all_hosts->insert(all_hosts->end(), hosts_added.begin(), hosts_added.end());
+  priority_set_.updateHosts(0,
+                            HostSetImpl::partitionHosts(all_hosts, HostsPerLocalityImpl::empty()),
+                            {}, hosts_added, {}, absl::nullopt);
 }
 
 void OriginalDstCluster::cleanup() {
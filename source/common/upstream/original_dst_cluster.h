@@ -43,9 +43,10 @@ public:
    * Original Dst cluster has a Host for the original destination. Normally load balancers can't
    * modify clusters, but in this case we access a singleton OriginalDstCluster that we can ask to
    * add hosts on demand. Additions are synced with all other threads so that the host set in the
-   * cluster remains (eventually) consistent. If multiple threads add a host to the same upstream
-   * address then two distinct HostSharedPtr's (with the same upstream IP address) will be added,
-   * and both of them will eventually time out.
+   * cluster remains (eventually) consistent. The hosts created by the workers are queued, and
+   * added by the main thread in a single update for all the hosts queued since the previous one.
+   * If multiple threads create a host for the same upstream address before the update, only the
+   * first one queued is added to the cluster.
    */
   class LoadBalancer : public Upstream::LoadBalancer {
   public:
@@ -97,7 +98,13 @@ private:
     host_map_ = new_host_map;
   }
 
-  void addHost(HostSharedPtr&);
+  /**
+   * Queues a host created by a worker, to be added by the main thread.
+   * @return bool whether the host is the first one queued since the last update, in which case
+   *         the caller has to post addQueuedHosts() to the main thread.
+   */
+  bool queueHost(HostSharedPtr host);
+  void addQueuedHosts();
   void cleanup();
 
   // ClusterImplBase
@@ -111,6 +118,9 @@ private:
   absl::Mutex host_map_lock_;
   HostMapConstSharedPtr host_map_ ABSL_GUARDED_BY(host_map_lock_);
 
+  absl::Mutex queued_hosts_lock_;
+  HostVector queued_hosts_ ABSL_GUARDED_BY(queued_hosts_lock_);
+
   friend class OriginalDstClusterFactory;
 };
 
@@ -1,6 +1,8 @@
 #include "source/common/upstream/outlier_detection_impl.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -46,6 +48,10 @@ DetectorHostMonitorImpl::DetectorHostMonitorImpl(std::shared_ptr<DetectorImpl> d
   put_result_func_ = detector->config().splitExternalLocalOriginErrors()
                          ? &DetectorHostMonitorImpl::putResultWithLocalExternalSplit
                          : &DetectorHostMonitorImpl::putResultNoLocalExternalSplit;
+  if (detector->config().latencyEnabled()) {
+    latency_accumulator_ = std::make_unique<LatencyAccumulator>();
+    updateCurrentLatencyBucket();
+  }
 }
 
 void DetectorHostMonitorImpl::eject(MonotonicTime ejection_time) {
@@ -64,6 +70,19 @@ void DetectorHostMonitorImpl::updateCurrentSuccessRateBucket() {
   local_origin_sr_monitor_.updateCurrentSuccessRateBucket();
 }
 
+void DetectorHostMonitorImpl::updateCurrentLatencyBucket() {
+  if (latency_accumulator_ != nullptr) {
+    latency_accumulator_bucket_.store(latency_accumulator_->updateCurrentWriter());
+  }
+}
+
+void DetectorHostMonitorImpl::putResponseTime(std::chrono::milliseconds response_time) {
+  LatencyAccumulatorBucket* bucket = latency_accumulator_bucket_.load();
+  if (bucket != nullptr) {
+    bucket->record(response_time.count() < 0 ? 0 : response_time.count());
+  }
+}
+
 void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
   external_origin_sr_monitor_.incTotalReqCounter();
   if (Http::CodeUtility::is5xx(response_code)) {
@@ -254,7 +273,16 @@ DetectorConfig::DetectorConfig(const envoy::config::cluster::v3::OutlierDetectio
       // base_ejection_time whatever is larger.
       max_ejection_time_ms_(static_cast<uint64_t>(PROTOBUF_GET_MS_OR_DEFAULT(
           config, max_ejection_time,
-          std::max(DEFAULT_MAX_EJECTION_TIME_MS, base_ejection_time_ms_)))) {}
+          std::max(DEFAULT_MAX_EJECTION_TIME_MS, base_ejection_time_ms_)))),
+      latency_enabled_(config.has_latency_threshold_factor()),
+      latency_threshold_factor_(static_cast<uint64_t>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config, latency_threshold_factor, DEFAULT_LATENCY_THRESHOLD_FACTOR))),
+      enforcing_latency_(static_cast<uint64_t>(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, enforcing_latency, DEFAULT_ENFORCING_LATENCY))),
+      latency_minimum_hosts_(static_cast<uint64_t>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config, latency_minimum_hosts, DEFAULT_LATENCY_MINIMUM_HOSTS))),
+      latency_request_volume_(static_cast<uint64_t>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config, latency_request_volume, DEFAULT_LATENCY_REQUEST_VOLUME))) {}
 
 DetectorImpl::DetectorImpl(const Cluster& cluster,
                            const envoy::config::cluster::v3::OutlierDetection& config,
@@ -389,6 +417,8 @@ bool DetectorImpl::enforceEjection(envoy::data::cluster::v3::OutlierEjectionType
   case envoy::data::cluster::v3::FAILURE_PERCENTAGE_LOCAL_ORIGIN:
     return runtime_.snapshot().featureEnabled(EnforcingFailurePercentageLocalOriginRuntime,
                                               config_.enforcingFailurePercentageLocalOrigin());
+  case envoy::data::cluster::v3::LATENCY:
+    return runtime_.snapshot().featureEnabled(EnforcingLatencyRuntime, config_.enforcingLatency());
   default:
     // Checked by schema.
     NOT_REACHED_GCOVR_EXCL_LINE;
@@ -421,6 +451,9 @@ void DetectorImpl::updateEnforcedEjectionStats(envoy::data::cluster::v3::Outlier
   case envoy::data::cluster::v3::FAILURE_PERCENTAGE_LOCAL_ORIGIN:
     stats_.ejections_enforced_local_origin_failure_percentage_.inc();
     break;
+  case envoy::data::cluster::v3::LATENCY:
+    stats_.ejections_enforced_latency_.inc();
+    break;
   default:
     // Checked by schema.
     NOT_REACHED_GCOVR_EXCL_LINE;
@@ -450,6 +483,9 @@ void DetectorImpl::updateDetectedEjectionStats(envoy::data::cluster::v3::Outlier
   case envoy::data::cluster::v3::FAILURE_PERCENTAGE_LOCAL_ORIGIN:
     stats_.ejections_detected_local_origin_failure_percentage_.inc();
     break;
+  case envoy::data::cluster::v3::LATENCY:
+    stats_.ejections_detected_latency_.inc();
+    break;
   default:
     // Checked by schema.
     NOT_REACHED_GCOVR_EXCL_LINE;
@@ -701,6 +737,69 @@ void DetectorImpl::processSuccessRateEjections(
   }
 }
 
+void DetectorImpl::processLatencyEjections() {
+  // Reset the Detector's latency median and threshold.
+  latency_median_ = -1;
+  latency_ejection_threshold_ = -1;
+
+  if (!config_.latencyEnabled()) {
+    return;
+  }
+  const uint64_t latency_minimum_hosts =
+      runtime_.snapshot().getInteger(LatencyMinimumHostsRuntime, config_.latencyMinimumHosts());
+  const uint64_t latency_request_volume =
+      runtime_.snapshot().getInteger(LatencyRequestVolumeRuntime, config_.latencyRequestVolume());
+
+  // Exit early if there are not enough hosts.
+  if (host_monitors_.size() < latency_minimum_hosts) {
+    return;
+  }
+
+  std::vector<HostLatencyPair> valid_latency_hosts;
+  valid_latency_hosts.reserve(host_monitors_.size());
+  for (const auto& host : host_monitors_) {
+    // Don't do work if the host is already ejected.
+    if (host.first->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
+      continue;
+    }
+    absl::optional<std::pair<double, uint64_t>> host_latency_and_volume =
+        host.second->latencyAccumulator()->getLatencyAndVolume(0.99);
+    if (!host_latency_and_volume ||
+        host_latency_and_volume.value().second < latency_request_volume) {
+      continue;
+    }
+    const double latency = host_latency_and_volume.value().first;
+    host.second->latency(latency);
+    valid_latency_hosts.emplace_back(HostLatencyPair(host.first, latency));
+  }
+
+  if (valid_latency_hosts.empty() || valid_latency_hosts.size() < latency_minimum_hosts) {
+    return;
+  }
+
+  std::vector<double> latencies;
+  latencies.reserve(valid_latency_hosts.size());
+  for (const auto& host_latency_pair : valid_latency_hosts) {
+    latencies.push_back(host_latency_pair.latency_);
+  }
+  std::sort(latencies.begin(), latencies.end());
+  const size_t middle = latencies.size() / 2;
+  latency_median_ = latencies.size() % 2 == 1 ? latencies[middle]
+                                               : (latencies[middle - 1] + latencies[middle]) / 2;
+  latency_ejection_threshold_ =
+      latency_median_ *
+      runtime_.snapshot().getInteger(LatencyThresholdFactorRuntime,
+                                     config_.latencyThresholdFactor()) /
+      100.0;
+
+  for (const auto& host_latency_pair : valid_latency_hosts) {
+    if (host_latency_pair.latency_ > latency_ejection_threshold_) {
+      updateDetectedEjectionStats(envoy::data::cluster::v3::LATENCY);
+      ejectHost(host_latency_pair.host_, envoy::data::cluster::v3::LATENCY);
+    }
+  }
+}
+
 void DetectorImpl::onIntervalTimer() {
   MonotonicTime now = time_source_.monotonicTime();
 
@@ -709,14 +808,17 @@ void DetectorImpl::onIntervalTimer() {
 
     // Need to update the writer bucket to keep the data valid.
     host.second->updateCurrentSuccessRateBucket();
+    host.second->updateCurrentLatencyBucket();
     // Refresh host success rate stat for the /clusters endpoint. If there is a new valid value, it
     // will get updated in processSuccessRateEjections().
     host.second->successRate(DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin, -1);
     host.second->successRate(DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin, -1);
+    host.second->latency(-1);
   }
 
   processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin);
   processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin);
+  processLatencyEjections();
 
   armIntervalTimer();
 }
@@ -759,6 +861,11 @@ void EventLoggerImpl::logEject(const HostDescriptionConstSharedPtr& host, Detect
             : DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin;
     event.mutable_eject_failure_percentage_event()->set_host_success_rate(
         host->outlierDetector().successRate(monitor_type));
+  } else if (type == envoy::data::cluster::v3::LATENCY) {
+    event.mutable_eject_latency_event()->set_host_latency_ms(host->outlierDetector().latency());
+    event.mutable_eject_latency_event()->set_cluster_median_latency_ms(detector.latencyMedian());
+    event.mutable_eject_latency_event()->set_cluster_latency_ejection_threshold_ms(
+        detector.latencyEjectionThreshold());
   } else {
     event.mutable_eject_consecutive_event();
   }
@@ -819,6 +926,62 @@ absl::optional<std::pair<double, uint64_t>> SuccessRateAccumulator::getSuccessRa
   return {{success_rate, backup_success_rate_bucket_->total_request_counter_}};
 }
 
+uint32_t LatencyAccumulatorBucket::bucketIndex(uint64_t latency_ms) {
+  if (latency_ms < LinearBuckets) {
+    return static_cast<uint32_t>(latency_ms);
+  }
+  latency_ms = std::min<uint64_t>(latency_ms, (1ULL << MaxLatencyLog2) - 1);
+  uint32_t log2 = 4;
+  while ((latency_ms >> (log2 + 1)) != 0) {
+    ++log2;
+  }
+  // The 3 bits after the most significant one select the sub-bucket.
+  return LinearBuckets + (log2 - 4) * SubBuckets + ((latency_ms >> (log2 - 3)) & (SubBuckets - 1));
+}
+
+uint64_t LatencyAccumulatorBucket::bucketUpperBound(uint32_t index) {
+  if (index < LinearBuckets) {
+    return index + 1;
+  }
+  const uint32_t log2 = 4 + (index - LinearBuckets) / SubBuckets;
+  const uint64_t sub_bucket = (index - LinearBuckets) % SubBuckets;
+  return (SubBuckets + sub_bucket + 1) << (log2 - 3);
+}
+
+LatencyAccumulatorBucket* LatencyAccumulator::updateCurrentWriter() {
+  // Right now current is being written to and backup is not. Flush the backup and swap.
+  for (std::atomic<uint32_t>& counter : backup_latency_bucket_->counters_) {
+    counter = 0;
+  }
+  backup_latency_bucket_->total_request_counter_ = 0;
+
+  current_latency_bucket_.swap(backup_latency_bucket_);
+
+  return current_latency_bucket_.get();
+}
+
+absl::optional<std::pair<double, uint64_t>>
+LatencyAccumulator::getLatencyAndVolume(double percentile) {
+  const uint64_t total = backup_latency_bucket_->total_request_counter_;
+  if (!total) {
+    return absl::nullopt;
+  }
+
+  // The rank of the percentile, from 1 to the number of requests.
+  const uint64_t rank =
+      std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile * total)));
+  uint64_t count = 0;
+  uint32_t index = 0;
+  for (; index < LatencyAccumulatorBucket::NumBuckets - 1; ++index) {
+    count += backup_latency_bucket_->counters_[index];
+    if (count >= rank) {
+      break;
+    }
+  }
+
+  return {{static_cast<double>(LatencyAccumulatorBucket::bucketUpperBound(index)), total}};
+}
+
 } // namespace Outlier
 } // namespace Upstream
 } // namespace Envoy
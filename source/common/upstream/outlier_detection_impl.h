@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
@@ -41,6 +42,7 @@ public:
   const absl::optional<MonotonicTime>& lastEjectionTime() override { return time_; }
   const absl::optional<MonotonicTime>& lastUnejectionTime() override { return time_; }
   double successRate(SuccessRateMonitorType) const override { return -1; }
+  double latency() const override { return -1; }
 
 private:
   const absl::optional<MonotonicTime> time_{};
@@ -131,6 +133,72 @@ private:
   double success_rate_;
 };
 
+/**
+ * Thin struct to facilitate calculations for latency outlier detection.
+ */
+struct HostLatencyPair {
+  HostLatencyPair(HostSharedPtr host, double latency) : host_(host), latency_(latency) {}
+  HostSharedPtr host_;
+  double latency_;
+};
+
+/**
+ * The response times of a host over an interval, as a histogram of buckets of growing widths: the
+ * response times below 16ms have a bucket each, and every next power of two range is split into 8
+ * buckets, which bounds the error of a percentile to 1/8th of its value. Like the
+ * SuccessRateAccumulatorBucket it is written to by the workers without locking, so recording a
+ * response time is a single atomic increment.
+ */
+struct LatencyAccumulatorBucket {
+  static constexpr uint32_t LinearBuckets = 16;
+  static constexpr uint32_t SubBuckets = 8;
+  // The response times are capped to 2^24ms, about 4.6 hours.
+  static constexpr uint32_t MaxLatencyLog2 = 24;
+  static constexpr uint32_t NumBuckets = LinearBuckets + (MaxLatencyLog2 - 4) * SubBuckets;
+
+  static uint32_t bucketIndex(uint64_t latency_ms);
+  // The exclusive upper bound of the response times of a bucket in milliseconds.
+  static uint64_t bucketUpperBound(uint32_t index);
+
+  void record(uint64_t latency_ms) {
+    counters_[bucketIndex(latency_ms)].fetch_add(1, std::memory_order_relaxed);
+    total_request_counter_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  std::array<std::atomic<uint32_t>, NumBuckets> counters_{};
+  std::atomic<uint64_t> total_request_counter_{};
+};
+
+/**
+ * The LatencyAccumulator computes the percentiles of the response times of a host over the
+ * interval, swapping a bucket to write to and a bucket to read from like the
+ * SuccessRateAccumulator.
+ */
+class LatencyAccumulator {
+public:
+  LatencyAccumulator()
+      : current_latency_bucket_(new LatencyAccumulatorBucket()),
+        backup_latency_bucket_(new LatencyAccumulatorBucket()) {}
+
+  /**
+   * This function updates the bucket to write data to.
+   * @return a pointer to the LatencyAccumulatorBucket.
+   */
+  LatencyAccumulatorBucket* updateCurrentWriter();
+  /**
+   * This function returns a percentile of the response times of a host over the last interval, as
+   * the upper bound of the bucket it falls in, along with the number of requests of the interval.
+   * @param percentile the percentile to return, in the (0, 1] range.
+   * @return the percentile in milliseconds and the request volume, or an invalid absl::optional if
+   *         there were no requests.
+   */
+  absl::optional<std::pair<double, uint64_t>> getLatencyAndVolume(double percentile);
+
+private:
+  std::unique_ptr<LatencyAccumulatorBucket> current_latency_bucket_;
+  std::unique_ptr<LatencyAccumulatorBucket> backup_latency_bucket_;
+};
+
 class DetectorImpl;
 
 /**
@@ -154,7 +222,7 @@ public:
   uint32_t numEjections() override { return num_ejections_; }
   void putHttpResponseCode(uint64_t response_code) override;
   void putResult(Result result, absl::optional<uint64_t> code) override;
-  void putResponseTime(std::chrono::milliseconds) override {}
+  void putResponseTime(std::chrono::milliseconds response_time) override;
   const absl::optional<MonotonicTime>& lastEjectionTime() override { return last_ejection_time_; }
   const absl::optional<MonotonicTime>& lastUnejectionTime() override {
     return last_unejection_time_;
@@ -179,6 +247,12 @@ public:
     getSRMonitor(type).setSuccessRate(new_success_rate);
   }
 
+  double latency() const override { return latency_; }
+  void latency(double new_latency) { latency_ = new_latency; }
+  // Only set if latency based outlier detection is configured.
+  LatencyAccumulator* latencyAccumulator() { return latency_accumulator_.get(); }
+  void updateCurrentLatencyBucket();
+
   // handlers for reporting local origin errors
   void localOriginFailure();
   void localOriginNoFailure();
@@ -209,6 +283,12 @@ private:
   SuccessRateMonitor external_origin_sr_monitor_;
   SuccessRateMonitor local_origin_sr_monitor_;
 
+  // The response times are only tracked if latency based outlier detection is configured, as the
+  // buckets take about a kilobyte per host.
+  std::unique_ptr<LatencyAccumulator> latency_accumulator_;
+  std::atomic<LatencyAccumulatorBucket*> latency_accumulator_bucket_{};
+  double latency_{-1};
+
   void putResultNoLocalExternalSplit(Result result, absl::optional<uint64_t> code);
   void putResultWithLocalExternalSplit(Result result, absl::optional<uint64_t> code);
   std::function<void(DetectorHostMonitorImpl*, Result, absl::optional<uint64_t> code)>
@@ -234,6 +314,8 @@ private:
   COUNTER(ejections_enforced_local_origin_success_rate)                                            \
   COUNTER(ejections_detected_local_origin_failure_percentage)                                      \
   COUNTER(ejections_enforced_local_origin_failure_percentage)                                      \
+  COUNTER(ejections_detected_latency)                                                              \
+  COUNTER(ejections_enforced_latency)                                                              \
   COUNTER(ejections_enforced_total)                                                                \
   COUNTER(ejections_overflow)                                                                      \
   COUNTER(ejections_success_rate)                                                                  \
@@ -283,6 +365,12 @@ constexpr absl::string_view SuccessRateStdevFactorRuntime =
     "outlier_detection.success_rate_stdev_factor";
 constexpr absl::string_view FailurePercentageThresholdRuntime =
     "outlier_detection.failure_percentage_threshold";
+constexpr absl::string_view LatencyThresholdFactorRuntime =
+    "outlier_detection.latency_threshold_factor";
+constexpr absl::string_view EnforcingLatencyRuntime = "outlier_detection.enforcing_latency";
+constexpr absl::string_view LatencyMinimumHostsRuntime = "outlier_detection.latency_minimum_hosts";
+constexpr absl::string_view LatencyRequestVolumeRuntime =
+    "outlier_detection.latency_request_volume";
 
 /**
  * Configuration for the outlier detection.
@@ -318,6 +406,11 @@ public:
   }
   uint64_t enforcingLocalOriginSuccessRate() const { return enforcing_local_origin_success_rate_; }
   uint64_t maxEjectionTimeMs() const { return max_ejection_time_ms_; }
+  bool latencyEnabled() const { return latency_enabled_; }
+  uint64_t latencyThresholdFactor() const { return latency_threshold_factor_; }
+  uint64_t enforcingLatency() const { return enforcing_latency_; }
+  uint64_t latencyMinimumHosts() const { return latency_minimum_hosts_; }
+  uint64_t latencyRequestVolume() const { return latency_request_volume_; }
 
 private:
   const uint64_t interval_ms_;
@@ -341,6 +434,11 @@ private:
   const uint64_t enforcing_consecutive_local_origin_failure_;
   const uint64_t enforcing_local_origin_success_rate_;
   const uint64_t max_ejection_time_ms_;
+  const bool latency_enabled_;
+  const uint64_t latency_threshold_factor_;
+  const uint64_t enforcing_latency_;
+  const uint64_t latency_minimum_hosts_;
+  const uint64_t latency_request_volume_;
 
   static constexpr uint64_t DEFAULT_INTERVAL_MS = 10000;
   static constexpr uint64_t DEFAULT_BASE_EJECTION_TIME_MS = 30000;
@@ -362,6 +460,10 @@ private:
   static constexpr uint64_t DEFAULT_ENFORCING_CONSECUTIVE_LOCAL_ORIGIN_FAILURE = 100;
   static constexpr uint64_t DEFAULT_ENFORCING_LOCAL_ORIGIN_SUCCESS_RATE = 100;
   static constexpr uint64_t DEFAULT_MAX_EJECTION_TIME_MS = 10 * DEFAULT_BASE_EJECTION_TIME_MS;
+  static constexpr uint64_t DEFAULT_LATENCY_THRESHOLD_FACTOR = 300;
+  static constexpr uint64_t DEFAULT_ENFORCING_LATENCY = 100;
+  static constexpr uint64_t DEFAULT_LATENCY_MINIMUM_HOSTS = 5;
+  static constexpr uint64_t DEFAULT_LATENCY_REQUEST_VOLUME = 100;
 };
 
 /**
@@ -393,6 +495,8 @@ public:
       DetectorHostMonitor::SuccessRateMonitorType monitor_type) const override {
     return getSRNums(monitor_type).ejection_threshold_;
   }
+  double latencyMedian() const override { return latency_median_; }
+  double latencyEjectionThreshold() const override { return latency_ejection_threshold_; }
 
   /**
    * This function returns pair of double values for success rate outlier detection. The pair
@@ -433,6 +537,7 @@ private:
   void updateEnforcedEjectionStats(envoy::data::cluster::v3::OutlierEjectionType type);
   void updateDetectedEjectionStats(envoy::data::cluster::v3::OutlierEjectionType type);
   void processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType monitor_type);
+  void processLatencyEjections();
 
   // The helper to double write value and gauge. The gauge could be null value since because any
   // stat might be deactivated.
@@ -470,6 +575,8 @@ private:
   // for external events and local_origin_sr_num_ is used for local origin events.
   EjectionPair external_origin_sr_num_;
   EjectionPair local_origin_sr_num_;
+  double latency_median_{-1};
+  double latency_ejection_threshold_{-1};
 
   const EjectionPair& getSRNums(DetectorHostMonitor::SuccessRateMonitorType monitor_type) const {
     return (DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin == monitor_type)
@@ -0,0 +1,42 @@
+#include "source/common/upstream/peak_ewma_tracker.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Envoy {
+namespace Upstream {
+
+PeakEwmaTracker::PeakEwmaTracker(TimeSource& time_source, std::chrono::nanoseconds decay_time)
+    : time_source_(time_source), decay_time_ns_(decay_time.count()), last_update_ns_(nowNs()) {}
+
+void PeakEwmaTracker::putResponseTime(std::chrono::microseconds response_time) {
+  const int64_t now_ns = nowNs();
+  const double observed = response_time.count();
+  const double average = average_us_.load(std::memory_order_relaxed);
+  if (observed > average) {
+    average_us_.store(observed, std::memory_order_relaxed);
+  } else {
+    const double weight = decayFactor(now_ns);
+    average_us_.store(average * weight + observed * (1 - weight), std::memory_order_relaxed);
+  }
+  last_update_ns_.store(now_ns, std::memory_order_relaxed);
+}
+
+double PeakEwmaTracker::responseTime() const {
+  return average_us_.load(std::memory_order_relaxed) * decayFactor(nowNs());
+}
+
+int64_t PeakEwmaTracker::nowNs() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time_source_.monotonicTime().time_since_epoch())
+      .count();
+}
+
+double PeakEwmaTracker::decayFactor(int64_t now_ns) const {
+  const int64_t elapsed_ns =
+      std::max<int64_t>(now_ns - last_update_ns_.load(std::memory_order_relaxed), 0);
+  return std::exp(-elapsed_ns / decay_time_ns_);
+}
+
+} // namespace Upstream
+} // namespace Envoy
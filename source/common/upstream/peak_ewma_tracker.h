@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include "envoy/common/time.h"
+#include "envoy/upstream/host_description.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Peak exponentially weighted moving average of a host's response times, as used by Finagle's
+ * peak EWMA load balancer. A response time above the current average replaces it outright so that
+ * a host which becomes slow is penalized immediately, while lower response times are blended in
+ * with a weight that grows with the time since the previous observation. The average decays
+ * towards zero while no responses are observed, so that idle hosts are eventually retried.
+ *
+ * Responses may be recorded from any worker. Updates are not serialized: an observation racing
+ * with another one on the same host may be lost, which only makes the average slightly less
+ * accurate.
+ */
+class PeakEwmaTracker : public ResponseTimeTracker {
+public:
+  PeakEwmaTracker(TimeSource& time_source, std::chrono::nanoseconds decay_time);
+
+  // Upstream::ResponseTimeTracker
+  void putResponseTime(std::chrono::microseconds response_time) override;
+  double responseTime() const override;
+
+  static constexpr std::chrono::seconds DefaultDecayTime{10};
+
+private:
+  int64_t nowNs() const;
+  double decayFactor(int64_t now_ns) const;
+
+  TimeSource& time_source_;
+  const double decay_time_ns_;
+  // Average response time in microseconds and the time of its last update in nanoseconds.
+  std::atomic<double> average_us_{0};
+  std::atomic<int64_t> last_update_ns_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
@@ -78,7 +78,8 @@ public:
                       uint64_t max_connections, uint64_t max_pending_requests,
                       uint64_t max_requests, uint64_t max_retries, uint64_t max_connection_pools,
                       ClusterCircuitBreakersStats cb_stats, absl::optional<double> budget_percent,
-                      absl::optional<uint32_t> min_retry_concurrency)
+                      absl::optional<uint32_t> min_retry_concurrency,
+                      bool per_worker_retry_budget = false)
       : connections_(max_connections, runtime, runtime_key + "max_connections", cb_stats.cx_open_,
                      cb_stats.remaining_cx_),
         pending_requests_(max_pending_requests, runtime, runtime_key + "max_pending_requests",
@@ -90,7 +91,12 @@ public:
         retries_(budget_percent, min_retry_concurrency, max_retries, runtime,
                  runtime_key + "retry_budget.", runtime_key + "max_retries",
                  cb_stats.rq_retry_open_, cb_stats.remaining_retries_, requests_,
-                 pending_requests_) {}
+                 pending_requests_) {
+    if (per_worker_retry_budget && budget_percent.has_value()) {
+      worker_retry_budget_ =
+          WorkerRetryBudgetSettings{*budget_percent, min_retry_concurrency.value_or(3)};
+    }
+  }
 
   // Upstream::ResourceManager
   ResourceLimit& connections() override { return connections_; }
@@ -98,6 +104,9 @@ public:
   ResourceLimit& requests() override { return requests_; }
   ResourceLimit& retries() override { return retries_; }
   ResourceLimit& connectionPools() override { return connection_pools_; }
+  const WorkerRetryBudgetSettings* workerRetryBudget() const override {
+    return worker_retry_budget_.has_value() ? &worker_retry_budget_.value() : nullptr;
+  }
 
 private:
   class RetryBudgetImpl : public ResourceLimit {
@@ -189,6 +198,7 @@ private:
   ManagedResourceImpl requests_;
   ManagedResourceImpl connection_pools_;
   RetryBudgetImpl retries_;
+  absl::optional<WorkerRetryBudgetSettings> worker_retry_budget_;
 };
 
 using ResourceManagerImplPtr = std::unique_ptr<ResourceManagerImpl>;
@@ -130,9 +130,9 @@ void StrictDnsClusterImpl::ResolveTarget::startResolve() {
             new_hosts.emplace_back(new HostImpl(
                 parent_.info_, hostname_,
                 Network::Utility::getAddressWithPort(*(resp.address_), port_),
-                // TODO(zyfjeff): Created through metadata shared pool
-                std::make_shared<const envoy::config::core::v3::Metadata>(lb_endpoint_.metadata()),
-                lb_endpoint_.load_balancing_weight().value(), locality_lb_endpoints_.locality(),
+                parent_.constMetadataSharedPool()->getObject(lb_endpoint_.metadata()),
+                lb_endpoint_.load_balancing_weight().value(),
+                parent_.constLocalitySharedPool()->getObject(locality_lb_endpoints_.locality()),
                 lb_endpoint_.endpoint().health_check_config(), locality_lb_endpoints_.priority(),
                 lb_endpoint_.health_status(), parent_.time_source_));
             all_new_hosts.emplace(new_hosts.back()->address()->asString());
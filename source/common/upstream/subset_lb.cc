@@ -28,19 +28,28 @@ SubsetLoadBalancer::SubsetLoadBalancer(
     const absl::optional<envoy::config::cluster::v3::Cluster::MaglevLbConfig>& lb_maglev_config,
     const absl::optional<envoy::config::cluster::v3::Cluster::LeastRequestLbConfig>&
         least_request_config,
-    const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config)
+    const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+    TimeSource& time_source)
     : lb_type_(lb_type), lb_ring_hash_config_(lb_ring_hash_config),
       lb_maglev_config_(lb_maglev_config), least_request_config_(least_request_config),
       common_config_(common_config), stats_(stats), scope_(scope), runtime_(runtime),
-      random_(random), fallback_policy_(subsets.fallbackPolicy()),
+      random_(random), time_source_(time_source), fallback_policy_(subsets.fallbackPolicy()),
       default_subset_metadata_(subsets.defaultSubset().fields().begin(),
                                subsets.defaultSubset().fields().end()),
       subset_selectors_(subsets.subsetSelectors()), original_priority_set_(priority_set),
       original_local_priority_set_(local_priority_set),
       locality_weight_aware_(subsets.localityWeightAware()),
-      scale_locality_weight_(subsets.scaleLocalityWeight()), list_as_any_(subsets.listAsAny()) {
+      scale_locality_weight_(subsets.scaleLocalityWeight()), list_as_any_(subsets.listAsAny()),
+      lazy_build_(subsets.lazyBuild()), max_built_subsets_(subsets.maxBuiltSubsets()) {
   ASSERT(subsets.isEnabled());
 
+  if (lazy_build_) {
+    // Like the single host per subset duplicate gauge, this is kept out of `ClusterStats` since
+    // only clusters building subsets lazily can evict them.
+    Stats::StatNameManagedStorage name_storage("lb_subsets_evicted", scope_.symbolTable());
+    evicted_stat_ = &Stats::Utility::counterFromElements(scope_, {name_storage.statName()});
+  }
+
   if (fallback_policy_ != envoy::config::cluster::v3::Cluster::LbSubsetConfig::NO_FALLBACK) {
     HostPredicate predicate;
     if (fallback_policy_ == envoy::config::cluster::v3::Cluster::LbSubsetConfig::ANY_ENDPOINT) {
@@ -385,6 +394,9 @@ HostConstSharedPtr SubsetLoadBalancer::tryChooseHostFromContext(LoadBalancerCont
 
   // Route has metadata match criteria defined, see if we have a matching subset.
   LbSubsetEntryPtr entry = findSubset(match_criteria->metadataMatchCriteria());
+  if (entry != nullptr && lazy_build_) {
+    useLazySubset(*entry);
+  }
   if (entry == nullptr || !entry->active()) {
     // No matching subset or subset not active: use fallback policy.
     return nullptr;
@@ -523,6 +535,11 @@ void SubsetLoadBalancer::processSubsets(
 // new subsets as necessary.
 void SubsetLoadBalancer::update(uint32_t priority, const HostVector& hosts_added,
                                 const HostVector& hosts_removed) {
+  if (lazy_build_) {
+    updateLazy(priority, hosts_added, hosts_removed);
+    return;
+  }
+
   updateFallbackSubset(priority, hosts_added, hosts_removed);
 
   processSubsets(
@@ -543,6 +560,66 @@ void SubsetLoadBalancer::update(uint32_t priority, const HostVector& hosts_added
       });
 }
 
+// In lazy mode only the subsets that have been selected have a load balancer to keep up to date.
+// The rest of the trie records which subsets currently have hosts, so that they survive
+// purgeEmptySubsets() and can be built when first selected.
+void SubsetLoadBalancer::updateLazy(uint32_t priority, const HostVector& hosts_added,
+                                    const HostVector& hosts_removed) {
+  updateFallbackSubset(priority, hosts_added, hosts_removed);
+
+  for (LbSubsetEntry* entry : built_subsets_) {
+    entry->priority_subset_->update(priority, hosts_added, hosts_removed);
+  }
+
+  // The deltas don't tell whether a subset lost its last host, so live subsets are marked again
+  // from all hosts. This is linear in the number of hosts, unlike eager mode which copies the host
+  // set of every subset on each update.
+  ++live_generation_;
+  for (const auto& host_set : original_priority_set_.hostSetsPerPriority()) {
+    for (const auto& host : host_set->hosts()) {
+      for (const auto& subset_selector : subset_selectors_) {
+        for (const auto& kvs : extractSubsetMetadata(subset_selector->selectorKeys(), *host)) {
+          LbSubsetEntryPtr entry = findOrCreateSubset(subsets_, kvs, 0);
+          entry->live_generation_ = live_generation_;
+          if (!entry->predicate_) {
+            entry->predicate_ = [this, kvs](const Host& host) -> bool {
+              return hostMatches(kvs, host);
+            };
+          }
+        }
+      }
+    }
+  }
+}
+
+void SubsetLoadBalancer::useLazySubset(LbSubsetEntry& entry) {
+  if (entry.initialized()) {
+    built_subsets_.splice(built_subsets_.begin(), built_subsets_, entry.built_position_);
+    return;
+  }
+  if (entry.live_generation_ != live_generation_) {
+    // No host belongs to this exact subset, e.g. it only exists as a prefix of a longer one.
+    return;
+  }
+
+  ENVOY_LOG(debug, "subset lb: creating load balancer on first use of subset");
+  entry.priority_subset_ = std::make_shared<PrioritySubsetImpl>(
+      *this, entry.predicate_, locality_weight_aware_, scale_locality_weight_);
+  stats_.lb_subsets_active_.inc();
+  stats_.lb_subsets_created_.inc();
+  built_subsets_.push_front(&entry);
+  entry.built_position_ = built_subsets_.begin();
+
+  if (max_built_subsets_ != 0 && built_subsets_.size() > max_built_subsets_) {
+    // The entry stays in the trie and is rebuilt the next time it is selected.
+    LbSubsetEntry& evicted = *built_subsets_.back();
+    built_subsets_.pop_back();
+    evicted.priority_subset_.reset();
+    stats_.lb_subsets_active_.dec();
+    evicted_stat_->inc();
+  }
+}
+
 bool SubsetLoadBalancer::hostMatches(const SubsetMetadata& kvs, const Host& host) {
   return Config::Metadata::metadataLabelMatch(
       kvs, host.metadata().get(), Config::MetadataFilters::get().ENVOY_LB, list_as_any_);
@@ -695,7 +772,8 @@ void SubsetLoadBalancer::purgeEmptySubsets(LbSubsetMap& subsets) {
 
       purgeEmptySubsets(entry->children_);
 
-      if (entry->active() || entry->hasChildren()) {
+      if (entry->active() || entry->hasChildren() ||
+          (lazy_build_ && entry->live_generation_ == live_generation_)) {
         it++;
         continue;
       }
@@ -704,6 +782,9 @@ void SubsetLoadBalancer::purgeEmptySubsets(LbSubsetMap& subsets) {
       if (entry->initialized()) {
         stats_.lb_subsets_active_.dec();
         stats_.lb_subsets_removed_.inc();
+        if (lazy_build_) {
+          built_subsets_.erase(entry->built_position_);
+        }
       }
 
       auto next_it = std::next(it);
@@ -742,7 +823,8 @@ SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalan
   case LoadBalancerType::LeastRequest:
     lb_ = std::make_unique<LeastRequestLoadBalancer>(
         *this, subset_lb.original_local_priority_set_, subset_lb.stats_, subset_lb.runtime_,
-        subset_lb.random_, subset_lb.common_config_, subset_lb.least_request_config_);
+        subset_lb.random_, subset_lb.common_config_, subset_lb.least_request_config_,
+        subset_lb.time_source_);
     break;
 
   case LoadBalancerType::Random:
@@ -752,9 +834,9 @@ SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalan
     break;
 
   case LoadBalancerType::RoundRobin:
-    lb_ = std::make_unique<RoundRobinLoadBalancer>(*this, subset_lb.original_local_priority_set_,
-                                                   subset_lb.stats_, subset_lb.runtime_,
-                                                   subset_lb.random_, subset_lb.common_config_);
+    lb_ = std::make_unique<RoundRobinLoadBalancer>(
+        *this, subset_lb.original_local_priority_set_, subset_lb.stats_, subset_lb.runtime_,
+        subset_lb.random_, subset_lb.common_config_, subset_lb.time_source_);
     break;
 
   case LoadBalancerType::RingHash:
@@ -781,8 +863,10 @@ SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalan
 
   case LoadBalancerType::OriginalDst:
   case LoadBalancerType::ClusterProvided:
-    // LoadBalancerType::OriginalDst is blocked in the factory. LoadBalancerType::ClusterProvided
-    // is impossible because the subset LB returns a null load balancer from its factory.
+  case LoadBalancerType::PeakEwma:
+    // LoadBalancerType::OriginalDst and LoadBalancerType::PeakEwma are blocked in the factory.
+    // LoadBalancerType::ClusterProvided is impossible because the subset LB returns a null load
+    // balancer from its factory.
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
 
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <functional>
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
 
+#include "envoy/common/time.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
@@ -32,7 +34,8 @@ public:
       const absl::optional<envoy::config::cluster::v3::Cluster::MaglevLbConfig>& lb_maglev_config,
       const absl::optional<envoy::config::cluster::v3::Cluster::LeastRequestLbConfig>&
           least_request_config,
-      const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config);
+      const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+      TimeSource& time_source);
   ~SubsetLoadBalancer() override;
 
   // Upstream::LoadBalancer
@@ -191,6 +194,13 @@ private:
 
     // Only initialized if a match exists at this level.
     PrioritySubsetImplPtr priority_subset_;
+
+    // The following are only used when subsets are built lazily. The predicate used to build the
+    // subset on first use; the last live generation in which a host belonged to this subset; and
+    // the position in the LRU list of built subsets while initialized.
+    HostPredicate predicate_;
+    uint64_t live_generation_{};
+    std::list<LbSubsetEntry*>::iterator built_position_;
   };
 
   // Create filtered default subset (if necessary) and other subsets based on current hosts.
@@ -199,6 +209,10 @@ private:
 
   // Called by HostSet::MemberUpdateCb
   void update(uint32_t priority, const HostVector& hosts_added, const HostVector& hosts_removed);
+  void updateLazy(uint32_t priority, const HostVector& hosts_added,
+                  const HostVector& hosts_removed);
+  // Builds the given subset on first use in lazy mode, or marks it as recently used.
+  void useLazySubset(LbSubsetEntry& entry);
 
   // Rebuild the map for single_host_per_subset mode.
   void rebuildSingle();
@@ -242,6 +256,7 @@ private:
   Stats::Scope& scope_;
   Runtime::Loader& runtime_;
   Random::RandomGenerator& random_;
+  TimeSource& time_source_;
 
   const envoy::config::cluster::v3::Cluster::LbSubsetConfig::LbSubsetFallbackPolicy
       fallback_policy_;
@@ -272,6 +287,14 @@ private:
   const bool scale_locality_weight_;
   const bool list_as_any_;
 
+  const bool lazy_build_;
+  const uint32_t max_built_subsets_;
+  // Incremented each time live subsets are marked in lazy mode.
+  uint64_t live_generation_{};
+  // Subsets built in lazy mode, most recently used first.
+  std::list<LbSubsetEntry*> built_subsets_;
+  Stats::Counter* evicted_stat_{};
+
   friend class SubsetLoadBalancerDescribeMetadataTester;
 };
 
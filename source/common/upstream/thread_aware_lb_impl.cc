@@ -247,10 +247,16 @@ ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost(uint64_t
   // next one in the ring. The random sequence is seeded by the hash, so the same input gets the
   // same sequence of hosts all the time.
   const uint32_t num_hosts = normalized_host_weights_.size();
-  auto host_index = std::vector<uint32_t>(num_hosts);
-  for (uint32_t i = 0; i < num_hosts; i++) {
-    host_index[i] = i;
-  }
+
+  // The shuffle below is a Fisher-Yates shuffle of the host indices [0, num_hosts) which stops
+  // as soon as an eligible host is found. Usually only a handful of positions are visited, so
+  // rather than materializing all num_hosts indices on every overloaded pick only the positions
+  // that have been swapped are tracked. A position that is absent holds its own index.
+  absl::flat_hash_map<uint32_t, uint32_t> host_index;
+  auto index_at = [&host_index](uint32_t position) -> uint32_t {
+    const auto it = host_index.find(position);
+    return it == host_index.end() ? position : it->second;
+  };
 
   // Not using Random::RandomGenerator as it does not take a seed. Seeded RNG is a requirement
   // here as we need the same shuffle sequence for the same hash every time.
@@ -273,9 +279,12 @@ ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost(uint64_t
   for (uint32_t i = 0; i < num_hosts; i++) {
     // The random shuffle algorithm
     const uint32_t j = uniform_int(random, num_hosts - i);
-    std::swap(host_index[i], host_index[i + j]);
+    // Position i is never visited again, so only position i + j needs to record the swap.
+    const uint32_t k = index_at(i + j);
+    if (j != 0) {
+      host_index[i + j] = index_at(i);
+    }
 
-    const uint32_t k = host_index[i];
     alt_host = normalized_host_weights_[k].first;
     if (alt_host == host) {
       continue;
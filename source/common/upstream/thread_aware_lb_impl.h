@@ -8,6 +8,7 @@
 #include "source/common/config/well_known_names.h"
 #include "source/common/upstream/load_balancer_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 
@@ -15,7 +16,7 @@ namespace Envoy {
 namespace Upstream {
 
 using NormalizedHostWeightVector = std::vector<std::pair<HostConstSharedPtr, double>>;
-using NormalizedHostWeightMap = std::map<HostConstSharedPtr, double>;
+using NormalizedHostWeightMap = absl::flat_hash_map<HostConstSharedPtr, double>;
 
 class ThreadAwareLoadBalancerBase : public LoadBalancerBase, public ThreadAwareLoadBalancer {
 public:
@@ -74,6 +75,7 @@ public:
     const NormalizedHostWeightMap
     initNormalizedHostWeightMap(const NormalizedHostWeightVector& normalized_host_weights) {
       NormalizedHostWeightMap normalized_host_weights_map;
+      normalized_host_weights_map.reserve(normalized_host_weights.size());
       for (auto const& item : normalized_host_weights) {
         normalized_host_weights_map[item.first] = item.second;
       }
@@ -23,6 +23,7 @@
 #include "envoy/secret/secret_manager.h"
 #include "envoy/server/filter_config.h"
 #include "envoy/server/transport_socket_config.h"
+#include "envoy/singleton/manager.h"
 #include "envoy/ssl/context_manager.h"
 #include "envoy/stats/scope.h"
 #include "envoy/upstream/health_checker.h"
@@ -48,6 +49,7 @@
 #include "source/common/upstream/health_checker_impl.h"
 #include "source/common/upstream/logical_dns_cluster.h"
 #include "source/common/upstream/original_dst_cluster.h"
+#include "source/common/upstream/peak_ewma_tracker.h"
 #include "source/extensions/filters/network/common/utility.h"
 #include "source/server/transport_socket_config_impl.h"
 
@@ -56,8 +58,40 @@
 
 namespace Envoy {
 namespace Upstream {
+
+SINGLETON_MANAGER_REGISTRATION(const_locality_shared_pool);
+
 namespace {
 
+// The localities of the hosts of all the clusters, most of which are shared by many hosts.
+ConstLocalitySharedPoolSharedPtr getConstLocalitySharedPool(Singleton::Manager& manager,
+                                                            Event::Dispatcher& dispatcher,
+                                                            Stats::Scope& scope) {
+  return manager
+      .getTyped<SharedPool::ObjectSharedPool<const envoy::config::core::v3::Locality, MessageUtil>>(
+          SINGLETON_MANAGER_REGISTERED_NAME(const_locality_shared_pool), [&dispatcher, &scope] {
+            return std::make_shared<
+                SharedPool::ObjectSharedPool<const envoy::config::core::v3::Locality, MessageUtil>>(
+                dispatcher, SharedPool::SharedPoolStats{ALL_SHARED_POOL_STATS(
+                                POOL_COUNTER_PREFIX(scope, "shared_pool.locality."),
+                                POOL_GAUGE_PREFIX(scope, "shared_pool.locality."))});
+          });
+}
+
+std::unique_ptr<ResponseTimeTracker> createResponseTimeTracker(const ClusterInfo& cluster,
+                                                               TimeSource& time_source) {
+  if (cluster.lbType() != LoadBalancerType::PeakEwma) {
+    return nullptr;
+  }
+
+  const auto& config = cluster.lbPeakEwmaConfig();
+  const std::chrono::nanoseconds decay_time =
+      config.has_value() && config->has_decay_time()
+          ? std::chrono::milliseconds(DurationUtil::durationToMilliseconds(config->decay_time()))
+          : PeakEwmaTracker::DefaultDecayTime;
+  return std::make_unique<PeakEwmaTracker>(time_source, decay_time);
+}
+
 const Network::Address::InstanceConstSharedPtr
 getSourceAddress(const envoy::config::cluster::v3::Cluster& cluster,
                  const envoy::config::core::v3::BindConfig& bind_config) {
@@ -241,7 +275,7 @@ HostVector filterHosts(const absl::node_hash_set<HostSharedPtr>& hosts,
 HostDescriptionImpl::HostDescriptionImpl(
     ClusterInfoConstSharedPtr cluster, const std::string& hostname,
     Network::Address::InstanceConstSharedPtr dest_address, MetadataConstSharedPtr metadata,
-    const envoy::config::core::v3::Locality& locality,
+    LocalityConstSharedPtr locality,
     const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
     uint32_t priority, TimeSource& time_source)
     : cluster_(cluster), hostname_(hostname),
@@ -250,8 +284,9 @@ HostDescriptionImpl::HostDescriptionImpl(
                                               Config::MetadataFilters::get().ENVOY_LB,
                                               Config::MetadataEnvoyLbKeys::get().CANARY)
                   .bool_value()),
-      metadata_(metadata), locality_(locality),
-      locality_zone_stat_name_(locality.zone(), cluster->statsScope().symbolTable()),
+      metadata_(metadata), locality_(std::move(locality)),
+      locality_zone_stat_name_(locality_->zone(), cluster->statsScope().symbolTable()),
+      response_time_tracker_(createResponseTimeTracker(*cluster, time_source)),
       priority_(priority),
       socket_factory_(resolveTransportSocketFactory(dest_address, metadata_.get())),
       creation_time_(time_source.monotonicTime()) {
@@ -265,6 +300,17 @@ HostDescriptionImpl::HostDescriptionImpl(
       health_check_config.port_value() == 0
           ? dest_address
           : Network::Utility::getAddressWithPort(*dest_address, health_check_config.port_value());
+  stats_.locality_load_stats_ = &cluster_->localityLoadStats().get(*locality_);
+}
+
+LocalityConstSharedPtr
+HostDescriptionImpl::ownLocality(const envoy::config::core::v3::Locality& locality) {
+  static const LocalityConstSharedPtr* empty_locality =
+      new LocalityConstSharedPtr(std::make_shared<const envoy::config::core::v3::Locality>());
+  if (locality.region().empty() && locality.zone().empty() && locality.sub_zone().empty()) {
+    return *empty_locality;
+  }
+  return std::make_shared<const envoy::config::core::v3::Locality>(locality);
 }
 
 Network::TransportSocketFactory& HostDescriptionImpl::resolveTransportSocketFactory(
@@ -744,10 +790,22 @@ ClusterInfoImpl::ClusterInfoImpl(
           config.preconnect_policy(), per_upstream_preconnect_ratio, 1.0)),
       peekahead_ratio_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.preconnect_policy(),
                                                        predictive_preconnect_ratio, 0)),
+      adaptive_preconnect_window_(
+          PROTOBUF_GET_OPTIONAL_MS(config.preconnect_policy(), adaptive_preconnect_window)),
+      warm_up_connections_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.preconnect_policy(), warm_up_connections, 0)),
+      warm_up_timeout_(std::chrono::milliseconds(
+          PROTOBUF_GET_MS_OR_DEFAULT(config.preconnect_policy(), warm_up_timeout, 1000))),
       per_connection_buffer_limit_bytes_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, per_connection_buffer_limit_bytes, 1024 * 1024)),
       socket_matcher_(std::move(socket_matcher)), stats_scope_(std::move(stats_scope)),
-      stats_(generateStats(*stats_scope_, factory_context.clusterManager().clusterStatNames())),
+      lazy_stats_(factory_context.clusterManager().lazyClusterStats()
+                      ? std::make_unique<LazyClusterStats>(
+                            factory_context.clusterManager().clusterStatNames(), *stats_scope_)
+                      : nullptr),
+      stats_(lazy_stats_ != nullptr
+                 ? ClusterStats(*lazy_stats_)
+                 : generateStats(*stats_scope_, factory_context.clusterManager().clusterStatNames())),
       load_report_stats_store_(stats_scope_->symbolTable()),
       load_report_stats_(generateLoadReportStats(
           load_report_stats_store_, factory_context.clusterManager().clusterLoadReportStatNames())),
@@ -762,6 +820,7 @@ ClusterInfoImpl::ClusterInfoImpl(
       maintenance_mode_runtime_key_(absl::StrCat("upstream.maintenance_mode.", name_)),
       source_address_(getSourceAddress(config, bind_config)),
       lb_least_request_config_(config.least_request_lb_config()),
+      lb_peak_ewma_config_(config.peak_ewma_lb_config()),
       lb_ring_hash_config_(config.ring_hash_lb_config()),
       lb_maglev_config_(config.maglev_lb_config()),
       lb_original_dst_config_(config.original_dst_lb_config()),
@@ -777,6 +836,8 @@ ClusterInfoImpl::ClusterInfoImpl(
       drain_connections_on_host_removal_(config.ignore_health_on_host_removal()),
       connection_pool_per_downstream_connection_(
           config.connection_pool_per_downstream_connection()),
+      share_http2_connection_pools_across_workers_(
+          config.share_http2_connection_pools_across_workers()),
       warm_hosts_(!config.health_checks().empty() &&
                   common_lb_config_.ignore_new_hosts_until_first_hc()),
       cluster_type_(
@@ -827,6 +888,15 @@ ClusterInfoImpl::ClusterInfoImpl(
 
     lb_type_ = LoadBalancerType::ClusterProvided;
     break;
+  case envoy::config::cluster::v3::Cluster::PEAK_EWMA:
+    if (config.has_lb_subset_config()) {
+      throw EnvoyException(
+          fmt::format("cluster: LB policy {} cannot be combined with lb_subset_config",
+                      envoy::config::cluster::v3::Cluster::LbPolicy_Name(config.lb_policy())));
+    }
+
+    lb_type_ = LoadBalancerType::PeakEwma;
+    break;
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
@@ -943,7 +1013,11 @@ ClusterImplBase::ClusterImplBase(
       local_cluster_(factory_context.clusterManager().localClusterName().value_or("") ==
                      cluster.name()),
       const_metadata_shared_pool_(Config::Metadata::getConstMetadataSharedPool(
-          factory_context.singletonManager(), factory_context.dispatcher())) {
+          factory_context.singletonManager(), factory_context.dispatcher(),
+          factory_context.stats())),
+      const_locality_shared_pool_(getConstLocalitySharedPool(factory_context.singletonManager(),
+                                                             factory_context.dispatcher(),
+                                                             factory_context.stats())) {
   factory_context.setInitManager(init_manager_);
   auto socket_factory = createTransportSocketFactory(cluster, factory_context);
   auto* raw_factory_pointer = socket_factory.get();
@@ -1314,6 +1388,7 @@ ClusterInfoImpl::ResourceManagers::load(const envoy::config::cluster::v3::Cluste
 
   absl::optional<double> budget_percent;
   absl::optional<uint32_t> min_retry_concurrency;
+  bool per_worker_retry_budget = false;
   if (it != thresholds.cend()) {
     max_connections = PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_connections, max_connections);
     max_pending_requests =
@@ -1324,13 +1399,14 @@ ClusterInfoImpl::ResourceManagers::load(const envoy::config::cluster::v3::Cluste
     max_connection_pools =
         PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_connection_pools, max_connection_pools);
     std::tie(budget_percent, min_retry_concurrency) = ClusterInfoImpl::getRetryBudgetParams(*it);
+    per_worker_retry_budget = it->retry_budget().per_worker();
   }
   return std::make_unique<ResourceManagerImpl>(
       runtime, runtime_prefix, max_connections, max_pending_requests, max_requests, max_retries,
       max_connection_pools,
       ClusterInfoImpl::generateCircuitBreakersStats(stats_scope, priority_stat_name,
                                                     track_remaining, circuit_breakers_stat_names_),
-      budget_percent, min_retry_concurrency);
+      budget_percent, min_retry_concurrency, per_worker_retry_budget);
 }
 
 PriorityStateManager::PriorityStateManager(ClusterImplBase& cluster,
@@ -1362,8 +1438,9 @@ void PriorityStateManager::registerHostForPriority(
                       : nullptr;
   const auto host = std::make_shared<HostImpl>(
       parent_.info(), hostname, address, metadata, lb_endpoint.load_balancing_weight().value(),
-      locality_lb_endpoint.locality(), lb_endpoint.endpoint().health_check_config(),
-      locality_lb_endpoint.priority(), lb_endpoint.health_status(), time_source);
+      parent_.constLocalitySharedPool()->getObject(locality_lb_endpoint.locality()),
+      lb_endpoint.endpoint().health_check_config(), locality_lb_endpoint.priority(),
+      lb_endpoint.health_status(), time_source);
   registerHostForPriority(host, locality_lb_endpoint);
 }
 
@@ -72,6 +72,10 @@ public:
   void setUnhealthy(UnhealthyType) override {}
 };
 
+using LocalityConstSharedPtr = std::shared_ptr<const envoy::config::core::v3::Locality>;
+using ConstLocalitySharedPoolSharedPtr = std::shared_ptr<
+    SharedPool::ObjectSharedPool<const envoy::config::core::v3::Locality, MessageUtil>>;
+
 /**
  * Implementation of Upstream::HostDescription.
  */
@@ -81,9 +85,23 @@ public:
   HostDescriptionImpl(
       ClusterInfoConstSharedPtr cluster, const std::string& hostname,
       Network::Address::InstanceConstSharedPtr dest_address, MetadataConstSharedPtr metadata,
-      const envoy::config::core::v3::Locality& locality,
+      LocalityConstSharedPtr locality,
       const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
       uint32_t priority, TimeSource& time_source);
+  HostDescriptionImpl(
+      ClusterInfoConstSharedPtr cluster, const std::string& hostname,
+      Network::Address::InstanceConstSharedPtr dest_address, MetadataConstSharedPtr metadata,
+      const envoy::config::core::v3::Locality& locality,
+      const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
+      uint32_t priority, TimeSource& time_source)
+      : HostDescriptionImpl(cluster, hostname, dest_address, metadata, ownLocality(locality),
+                            health_check_config, priority, time_source) {}
+
+  /**
+   * @return the locality for a host which was not given one from a shared pool. The hosts without
+   * a locality share the same empty one, the others get a copy of their own.
+   */
+  static LocalityConstSharedPtr ownLocality(const envoy::config::core::v3::Locality& locality);
 
   Network::TransportSocketFactory& transportSocketFactory() const override {
     absl::ReaderMutexLock lock(&metadata_mutex_);
@@ -132,6 +150,9 @@ public:
         new Outlier::DetectorHostMonitorNullImpl();
     return *null_outlier_detector;
   }
+  ResponseTimeTracker* responseTimeTracker() const override {
+    return response_time_tracker_.get();
+  }
   HostStats& stats() const override { return stats_; }
   const std::string& hostnameForHealthChecks() const override { return health_checks_hostname_; }
   const std::string& hostname() const override { return hostname_; }
@@ -142,7 +163,7 @@ public:
   Network::Address::InstanceConstSharedPtr healthCheckAddress() const override {
     return health_check_address_;
   }
-  const envoy::config::core::v3::Locality& locality() const override { return locality_; }
+  const envoy::config::core::v3::Locality& locality() const override { return *locality_; }
   Stats::StatName localityZoneStatName() const override {
     return locality_zone_stat_name_.statName();
   }
@@ -178,11 +199,13 @@ private:
   std::atomic<bool> canary_;
   mutable absl::Mutex metadata_mutex_;
   MetadataConstSharedPtr metadata_ ABSL_GUARDED_BY(metadata_mutex_);
-  const envoy::config::core::v3::Locality locality_;
+  // Immutable, and shared with the other hosts of the same locality when it comes from a pool.
+  const LocalityConstSharedPtr locality_;
   Stats::StatNameDynamicStorage locality_zone_stat_name_;
   mutable HostStats stats_;
   Outlier::DetectorHostMonitorPtr outlier_detector_;
   HealthCheckHostMonitorPtr health_checker_;
+  const std::unique_ptr<ResponseTimeTracker> response_time_tracker_;
   std::atomic<uint32_t> priority_;
   std::reference_wrapper<Network::TransportSocketFactory>
       socket_factory_ ABSL_GUARDED_BY(metadata_mutex_);
@@ -198,16 +221,24 @@ class HostImpl : public HostDescriptionImpl,
 public:
   HostImpl(ClusterInfoConstSharedPtr cluster, const std::string& hostname,
            Network::Address::InstanceConstSharedPtr address, MetadataConstSharedPtr metadata,
-           uint32_t initial_weight, const envoy::config::core::v3::Locality& locality,
+           uint32_t initial_weight, LocalityConstSharedPtr locality,
            const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
            uint32_t priority, const envoy::config::core::v3::HealthStatus health_status,
            TimeSource& time_source)
-      : HostDescriptionImpl(cluster, hostname, address, metadata, locality, health_check_config,
-                            priority, time_source),
+      : HostDescriptionImpl(cluster, hostname, address, metadata, std::move(locality),
+                            health_check_config, priority, time_source),
         used_(true) {
     setEdsHealthFlag(health_status);
     HostImpl::weight(initial_weight);
   }
+  HostImpl(ClusterInfoConstSharedPtr cluster, const std::string& hostname,
+           Network::Address::InstanceConstSharedPtr address, MetadataConstSharedPtr metadata,
+           uint32_t initial_weight, const envoy::config::core::v3::Locality& locality,
+           const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
+           uint32_t priority, const envoy::config::core::v3::HealthStatus health_status,
+           TimeSource& time_source)
+      : HostImpl(cluster, hostname, address, metadata, initial_weight, ownLocality(locality),
+                 health_check_config, priority, health_status, time_source) {}
 
   // Upstream::Host
   std::vector<std::pair<absl::string_view, Stats::PrimitiveCounterReference>>
@@ -260,6 +291,16 @@ public:
   void weight(uint32_t new_weight) override;
   bool used() const override { return used_; }
   void used(bool new_used) override { used_ = new_used; }
+  absl::optional<MonotonicTime> lastHcPassTime() const override {
+    const MonotonicTime last_hc_pass_time = last_hc_pass_time_;
+    if (last_hc_pass_time == MonotonicTime()) {
+      return absl::nullopt;
+    }
+    return last_hc_pass_time;
+  }
+  void setLastHcPassTime(MonotonicTime last_hc_pass_time) override {
+    last_hc_pass_time_ = last_hc_pass_time;
+  }
 
 protected:
   static Network::ClientConnectionPtr
@@ -275,6 +316,9 @@ private:
   std::atomic<uint32_t> health_flags_{};
   std::atomic<uint32_t> weight_;
   std::atomic<bool> used_;
+  // Read by the load balancers of the workers while the health checkers set it. The epoch means
+  // never.
+  std::atomic<MonotonicTime> last_hc_pass_time_{MonotonicTime()};
 };
 
 class HostsPerLocalityImpl : public HostsPerLocality {
@@ -577,6 +621,11 @@ public:
   }
   float perUpstreamPreconnectRatio() const override { return per_upstream_preconnect_ratio_; }
   float peekaheadRatio() const override { return peekahead_ratio_; }
+  const absl::optional<std::chrono::milliseconds> adaptivePreconnectWindow() const override {
+    return adaptive_preconnect_window_;
+  }
+  uint32_t warmUpConnections() const override { return warm_up_connections_; }
+  std::chrono::milliseconds warmUpTimeout() const override { return warm_up_timeout_; }
   uint32_t perConnectionBufferLimitBytes() const override {
     return per_connection_buffer_limit_bytes_;
   }
@@ -605,6 +654,10 @@ public:
   lbLeastRequestConfig() const override {
     return lb_least_request_config_;
   }
+  const absl::optional<envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig>&
+  lbPeakEwmaConfig() const override {
+    return lb_peak_ewma_config_;
+  }
   const absl::optional<envoy::config::cluster::v3::Cluster::RingHashLbConfig>&
   lbRingHashConfig() const override {
     return lb_ring_hash_config_;
@@ -641,6 +694,7 @@ public:
   }
 
   ClusterLoadReportStats& loadReportStats() const override { return load_report_stats_; }
+  LocalityLoadStatsMap& localityLoadStats() const override { return locality_load_stats_; }
 
   ClusterTimeoutBudgetStatsOptRef timeoutBudgetStats() const override {
     if (optional_cluster_stats_ == nullptr ||
@@ -666,6 +720,9 @@ public:
   bool connectionPoolPerDownstreamConnection() const override {
     return connection_pool_per_downstream_connection_;
   }
+  bool shareHttp2ConnectionPoolsAcrossWorkers() const override {
+    return share_http2_connection_pools_across_workers_;
+  }
   bool warmHosts() const override { return warm_hosts_; }
   const absl::optional<envoy::config::core::v3::UpstreamHttpProtocolOptions>&
   upstreamHttpProtocolOptions() const override {
@@ -729,12 +786,18 @@ private:
   absl::optional<std::chrono::milliseconds> idle_timeout_;
   const float per_upstream_preconnect_ratio_;
   const float peekahead_ratio_;
+  const absl::optional<std::chrono::milliseconds> adaptive_preconnect_window_;
+  const uint32_t warm_up_connections_;
+  const std::chrono::milliseconds warm_up_timeout_;
   const uint32_t per_connection_buffer_limit_bytes_;
   TransportSocketMatcherPtr socket_matcher_;
   Stats::ScopePtr stats_scope_;
+  // Set only with StatsConfig.lazy_cluster_stats, in which case stats_ refers to its placeholders.
+  std::unique_ptr<LazyClusterStats> lazy_stats_;
   mutable ClusterStats stats_;
   Stats::IsolatedStoreImpl load_report_stats_store_;
   mutable ClusterLoadReportStats load_report_stats_;
+  mutable LocalityLoadStatsMap locality_load_stats_;
   const std::unique_ptr<OptionalClusterStats> optional_cluster_stats_;
   const uint64_t features_;
   mutable ResourceManagers resource_managers_;
@@ -743,6 +806,7 @@ private:
   LoadBalancerType lb_type_;
   absl::optional<envoy::config::cluster::v3::Cluster::LeastRequestLbConfig>
       lb_least_request_config_;
+  absl::optional<envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig> lb_peak_ewma_config_;
   absl::optional<envoy::config::cluster::v3::Cluster::RingHashLbConfig> lb_ring_hash_config_;
   absl::optional<envoy::config::cluster::v3::Cluster::MaglevLbConfig> lb_maglev_config_;
   absl::optional<envoy::config::cluster::v3::Cluster::OriginalDstLbConfig> lb_original_dst_config_;
@@ -755,6 +819,7 @@ private:
   const Network::ConnectionSocket::OptionsSharedPtr cluster_socket_options_;
   const bool drain_connections_on_host_removal_;
   const bool connection_pool_per_downstream_connection_;
+  const bool share_http2_connection_pools_across_workers_;
   const bool warm_hosts_;
   const absl::optional<envoy::config::core::v3::UpstreamHttpProtocolOptions>
       upstream_http_protocol_options_;
@@ -822,6 +887,9 @@ public:
   Config::ConstMetadataSharedPoolSharedPtr constMetadataSharedPool() {
     return const_metadata_shared_pool_;
   }
+  ConstLocalitySharedPoolSharedPtr constLocalitySharedPool() {
+    return const_locality_shared_pool_;
+  }
 
   // Upstream::Cluster
   HealthChecker* healthChecker() override { return health_checker_.get(); }
@@ -889,6 +957,7 @@ private:
   uint64_t pending_initialize_health_checks_{};
   const bool local_cluster_;
   Config::ConstMetadataSharedPoolSharedPtr const_metadata_shared_pool_;
+  ConstLocalitySharedPoolSharedPtr const_locality_shared_pool_;
   Common::CallbackHandlePtr priority_update_cb_;
 };
 
@@ -50,6 +50,10 @@ MainCommonBase::MainCommonBase(const Server::Options& options, Event::TimeSystem
                                std::unique_ptr<ProcessContext> process_context)
     : platform_impl_(std::move(platform_impl)), options_(options),
       component_factory_(component_factory), stats_allocator_(symbol_table_) {
+  // Workers encoding stat names from per-request data would otherwise contend on
+  // the symbol table's lock for tokens which are almost always already interned.
+  symbol_table_.setThreadCacheCapacity(Stats::SymbolTableImpl::DefaultThreadCacheCapacity);
+
   // Process the option to disable extensions as early as possible,
   // before we do any configuration loading.
   OptionsImpl::disableExtensions(options.disabledExtensions());
@@ -73,9 +77,10 @@ MainCommonBase::MainCommonBase(const Server::Options& options, Event::TimeSystem
     Thread::BasicLockable& log_lock = restarter_->logLock();
     Thread::BasicLockable& access_log_lock = restarter_->accessLogLock();
     auto local_address = Network::Utility::getLocalAddress(options_.localAddressIpVersion());
-    logging_context_ = std::make_unique<Logger::Context>(options_.logLevel(), options_.logFormat(),
-                                                         log_lock, options_.logFormatEscaped(),
-                                                         options_.enableFineGrainLogging());
+    logging_context_ = std::make_unique<Logger::Context>(
+        options_.logLevel(), options_.logFormat(), log_lock, options_.logFormatEscaped(),
+        options_.enableFineGrainLogging(),
+        options_.enableAsyncLogging() ? &platform_impl_->threadFactory() : nullptr);
 
     configureComponentLogLevels();
 
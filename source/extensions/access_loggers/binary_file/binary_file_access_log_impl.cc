@@ -0,0 +1,85 @@
+#include "source/extensions/access_loggers/binary_file/binary_file_access_log_impl.h"
+
+#include "absl/strings/numbers.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+
+BinaryFileAccessLog::BinaryFileAccessLog(AccessLog::AccessLogFileSharedPtr log_file,
+                                         AccessLog::FilterPtr&& filter,
+                                         std::vector<Column>&& columns, uint32_t records_per_block,
+                                         std::chrono::milliseconds block_flush_interval,
+                                         ThreadLocal::SlotAllocator& tls)
+    : ImplBase(std::move(filter)), columns_(std::move(columns)),
+      records_per_block_(records_per_block),
+      tls_slot_(ThreadLocal::TypedSlot<ThreadLocalEncoder>::makeUnique(tls)) {
+  std::vector<ColumnSchema> schema;
+  schema.reserve(columns_.size());
+  for (const Column& column : columns_) {
+    schema.push_back(column.schema_);
+  }
+  tls_slot_->set([schema, log_file, block_flush_interval](Event::Dispatcher& dispatcher) {
+    return std::make_shared<ThreadLocalEncoder>(schema, log_file, dispatcher,
+                                                block_flush_interval);
+  });
+}
+
+BinaryFileAccessLog::ThreadLocalEncoder::ThreadLocalEncoder(
+    std::vector<ColumnSchema> schema, AccessLog::AccessLogFileSharedPtr log_file,
+    Event::Dispatcher& dispatcher, std::chrono::milliseconds block_flush_interval)
+    : encoder_(std::move(schema)), log_file_(std::move(log_file)),
+      block_flush_interval_(block_flush_interval), flush_timer_(dispatcher.createTimer([this]() {
+        flush();
+        flush_timer_->enableTimer(block_flush_interval_);
+      })) {
+  flush_timer_->enableTimer(block_flush_interval_);
+}
+
+BinaryFileAccessLog::ThreadLocalEncoder::~ThreadLocalEncoder() { flush(); }
+
+void BinaryFileAccessLog::ThreadLocalEncoder::flush() {
+  if (encoder_.records() == 0) {
+    return;
+  }
+  block_.clear();
+  encoder_.finish(block_);
+  log_file_->write(block_);
+}
+
+void BinaryFileAccessLog::emitLog(const Http::RequestHeaderMap& request_headers,
+                                  const Http::ResponseHeaderMap& response_headers,
+                                  const Http::ResponseTrailerMap& response_trailers,
+                                  const StreamInfo::StreamInfo& stream_info) {
+  ThreadLocalEncoder& tls = tls_slot_->get().ref();
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    tls.value_.clear();
+    bool has_value = false;
+    for (const Formatter::FormatterProviderPtr& provider : columns_[i].providers_) {
+      has_value |= provider->formatTo(tls.value_, request_headers, response_headers,
+                                      response_trailers, stream_info, absl::string_view());
+    }
+    if (!has_value) {
+      continue;
+    }
+    if (columns_[i].schema_.type_ == ColumnType::String) {
+      tls.encoder_.setString(i, tls.value_);
+      continue;
+    }
+    int64_t value;
+    if (absl::SimpleAtoi(tls.value_, &value)) {
+      tls.encoder_.setInteger(i, value);
+    }
+  }
+  tls.encoder_.endRecord();
+
+  if (tls.encoder_.records() >= records_per_block_) {
+    tls.flush();
+  }
+}
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/access_log/access_log.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/formatter/substitution_formatter.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/extensions/access_loggers/binary_file/block_encoder.h"
+#include "source/extensions/access_loggers/common/access_log_base.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+
+/**
+ * A column of the binary file access log, and the providers of its values.
+ */
+struct Column {
+  ColumnSchema schema_;
+  std::vector<Formatter::FormatterProviderPtr> providers_;
+};
+
+/**
+ * Access log Instance that writes logs to a file in a columnar binary format. Each thread encodes
+ * its own blocks of records, which it writes to the file once full or periodically.
+ */
+class BinaryFileAccessLog : public Common::ImplBase {
+public:
+  BinaryFileAccessLog(AccessLog::AccessLogFileSharedPtr log_file, AccessLog::FilterPtr&& filter,
+                      std::vector<Column>&& columns, uint32_t records_per_block,
+                      std::chrono::milliseconds block_flush_interval,
+                      ThreadLocal::SlotAllocator& tls);
+
+private:
+  struct ThreadLocalEncoder : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalEncoder(std::vector<ColumnSchema> schema, AccessLog::AccessLogFileSharedPtr log_file,
+                       Event::Dispatcher& dispatcher,
+                       std::chrono::milliseconds block_flush_interval);
+    ~ThreadLocalEncoder() override;
+
+    // Writes the block being filled to the file, if not empty.
+    void flush();
+
+    BlockEncoder encoder_;
+    const AccessLog::AccessLogFileSharedPtr log_file_;
+    const std::chrono::milliseconds block_flush_interval_;
+    Event::TimerPtr flush_timer_;
+    // Reused for the formatted values and the encoded blocks, to keep their memory.
+    std::string value_;
+    std::string block_;
+  };
+
+  // Common::ImplBase
+  void emitLog(const Http::RequestHeaderMap& request_headers,
+               const Http::ResponseHeaderMap& response_headers,
+               const Http::ResponseTrailerMap& response_trailers,
+               const StreamInfo::StreamInfo& stream_info) override;
+
+  const std::vector<Column> columns_;
+  const uint32_t records_per_block_;
+  ThreadLocal::TypedSlotPtr<ThreadLocalEncoder> tls_slot_;
+};
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
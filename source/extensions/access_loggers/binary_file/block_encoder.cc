@@ -0,0 +1,113 @@
+#include "source/extensions/access_loggers/binary_file/block_encoder.h"
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+
+BlockEncoder::BlockEncoder(std::vector<ColumnSchema> schema)
+    : schema_(std::move(schema)), columns_(schema_.size()) {}
+
+void BlockEncoder::setValue(size_t column) {
+  ASSERT(column < columns_.size());
+  Column& encoded = columns_[column];
+  ASSERT(!encoded.set_);
+  encoded.set_ = true;
+  if (encoded.bitmap_.size() <= records_ / 8) {
+    encoded.bitmap_.resize(records_ / 8 + 1, '\0');
+  }
+  encoded.bitmap_[records_ / 8] |= static_cast<char>(1 << (records_ % 8));
+}
+
+void BlockEncoder::setString(size_t column, absl::string_view value) {
+  ASSERT(schema_[column].type_ == ColumnType::String);
+  setValue(column);
+  auto symbol = symbols_.find(value);
+  if (symbol == symbols_.end()) {
+    symbol = symbols_.emplace(std::string(value), symbols_.size()).first;
+    appendVarint(dictionary_, value.size());
+    dictionary_.append(value.data(), value.size());
+  }
+  appendVarint(columns_[column].values_, symbol->second);
+}
+
+void BlockEncoder::setInteger(size_t column, int64_t value) {
+  ASSERT(schema_[column].type_ == ColumnType::Integer);
+  setValue(column);
+  appendSignedVarint(columns_[column].values_, value);
+}
+
+void BlockEncoder::endRecord() {
+  for (Column& column : columns_) {
+    column.set_ = false;
+  }
+  ++records_;
+}
+
+void BlockEncoder::finish(std::string& output) {
+  const size_t start = output.size();
+  output.append(Magic.data(), Magic.size());
+  // The length of the block is set once it is known.
+  appendFixed32(output, 0);
+
+  const size_t body_start = output.size();
+  appendVarint(output, symbols_.size());
+  output.append(dictionary_);
+  std::vector<uint64_t> offsets;
+  offsets.reserve(columns_.size());
+  for (Column& column : columns_) {
+    offsets.push_back(output.size() - body_start);
+    column.bitmap_.resize((records_ + 7) / 8, '\0');
+    output.append(column.bitmap_);
+    output.append(column.values_);
+  }
+
+  const size_t index_start = output.size();
+  appendVarint(output, Version);
+  appendVarint(output, records_);
+  appendVarint(output, schema_.size());
+  for (size_t i = 0; i < schema_.size(); ++i) {
+    appendVarint(output, schema_[i].name_.size());
+    output.append(schema_[i].name_);
+    output.push_back(static_cast<char>(schema_[i].type_));
+    appendVarint(output, offsets[i]);
+  }
+  appendFixed32(output, output.size() - index_start);
+
+  std::string length;
+  appendFixed32(length, output.size() - body_start);
+  output.replace(start + Magic.size(), length.size(), length);
+
+  records_ = 0;
+  for (Column& column : columns_) {
+    column.bitmap_.clear();
+    column.values_.clear();
+  }
+  symbols_.clear();
+  dictionary_.clear();
+}
+
+void BlockEncoder::appendVarint(std::string& output, uint64_t value) {
+  while (value >= 0x80) {
+    output.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  output.push_back(static_cast<char>(value));
+}
+
+void BlockEncoder::appendSignedVarint(std::string& output, int64_t value) {
+  appendVarint(output, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void BlockEncoder::appendFixed32(std::string& output, uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    output.push_back(static_cast<char>(value >> (8 * i)));
+  }
+}
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+
+/**
+ * The type of the values of a column, as written in the index of a block.
+ */
+enum class ColumnType : uint8_t { String = 0, Integer = 1 };
+
+struct ColumnSchema {
+  std::string name_;
+  ColumnType type_;
+};
+
+/**
+ * Encodes log records into the self-contained columnar blocks of the binary file access log. See
+ * the BinaryFileAccessLog proto for the format. Not thread safe.
+ */
+class BlockEncoder {
+public:
+  static constexpr absl::string_view Magic = "EALB";
+  static constexpr uint64_t Version = 1;
+
+  explicit BlockEncoder(std::vector<ColumnSchema> schema);
+
+  // Set the value of a column of the current record. The columns which aren't set before
+  // endRecord() are null.
+  void setString(size_t column, absl::string_view value);
+  void setInteger(size_t column, int64_t value);
+
+  // Ends the current record.
+  void endRecord();
+
+  uint32_t records() const { return records_; }
+
+  // Appends the block of the records ended since the last call to output, and starts a new block.
+  void finish(std::string& output);
+
+  static void appendVarint(std::string& output, uint64_t value);
+  static void appendSignedVarint(std::string& output, int64_t value);
+  static void appendFixed32(std::string& output, uint32_t value);
+
+private:
+  struct Column {
+    // A bit per record, set if the record has a value.
+    std::string bitmap_;
+    std::string values_;
+    // Whether the current record has a value.
+    bool set_{};
+  };
+
+  void setValue(size_t column);
+
+  const std::vector<ColumnSchema> schema_;
+  std::vector<Column> columns_;
+  uint32_t records_{};
+  // The indexes of the strings of the block in its dictionary, and the encoded strings.
+  absl::flat_hash_map<std::string, uint32_t> symbols_;
+  std::string dictionary_;
+};
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,63 @@
+#include "source/extensions/access_loggers/binary_file/config.h"
+
+#include <memory>
+
+#include "envoy/extensions/access_loggers/binary_file/v3alpha/binary_file.pb.h"
+#include "envoy/extensions/access_loggers/binary_file/v3alpha/binary_file.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/formatter/substitution_formatter.h"
+#include "source/common/protobuf/protobuf.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/access_loggers/binary_file/binary_file_access_log_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+
+AccessLog::InstanceSharedPtr BinaryFileAccessLogFactory::createAccessLogInstance(
+    const Protobuf::Message& config, AccessLog::FilterPtr&& filter,
+    Server::Configuration::CommonFactoryContext& context) {
+  const auto& proto_config = MessageUtil::downcastAndValidate<
+      const envoy::extensions::access_loggers::binary_file::v3alpha::BinaryFileAccessLog&>(
+      config, context.messageValidationVisitor());
+
+  std::vector<Column> columns;
+  columns.reserve(proto_config.columns_size());
+  for (const auto& column : proto_config.columns()) {
+    columns.push_back(
+        {{column.name(),
+          column.type() ==
+                  envoy::extensions::access_loggers::binary_file::v3alpha::BinaryFileAccessLog::
+                      Column::INTEGER
+              ? ColumnType::Integer
+              : ColumnType::String},
+         Formatter::SubstitutionFormatParser::parse(column.format())});
+  }
+
+  Filesystem::FilePathAndType file_info{Filesystem::DestinationType::File, proto_config.path()};
+  return std::make_shared<BinaryFileAccessLog>(
+      context.accessLogManager().createAccessLog(file_info), std::move(filter), std::move(columns),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config, records_per_block, 1024),
+      std::chrono::milliseconds(
+          PROTOBUF_GET_MS_OR_DEFAULT(proto_config, block_flush_interval, 1000)),
+      context.threadLocal());
+}
+
+ProtobufTypes::MessagePtr BinaryFileAccessLogFactory::createEmptyConfigProto() {
+  return std::make_unique<
+      envoy::extensions::access_loggers::binary_file::v3alpha::BinaryFileAccessLog>();
+}
+
+std::string BinaryFileAccessLogFactory::name() const { return "envoy.access_loggers.binary_file"; }
+
+/**
+ * Static registration for the binary file access log. @see RegisterFactory.
+ */
+REGISTER_FACTORY(BinaryFileAccessLogFactory, Server::Configuration::AccessLogInstanceFactory);
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
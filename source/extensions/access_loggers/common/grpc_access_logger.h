@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 
 #include "envoy/config/core/v3/config_source.pb.h"
@@ -10,8 +12,11 @@
 #include "envoy/thread_local/thread_local.h"
 
 #include "source/common/common/assert.h"
+#include "source/common/grpc/common.h"
 #include "source/common/grpc/typed_async_client.h"
+#include "source/common/http/headers.h"
 #include "source/common/protobuf/utility.h"
+#include "source/extensions/compression/gzip/compressor/zlib_compressor_impl.h"
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/types/optional.h"
@@ -23,6 +28,19 @@ namespace Common {
 
 enum class GrpcAccessLoggerType { TCP, HTTP };
 
+/**
+ * Options of the batching and of the transport of the messages of a gRPC access logger.
+ */
+struct GrpcAccessLoggerOptions {
+  // Upper bound of the flush interval, which adapts to the rate of the logs when above the flush
+  // interval of the logger.
+  std::chrono::milliseconds max_buffer_flush_interval_{};
+  // Whether the messages are compressed with gzip.
+  bool compress_messages_{};
+  // Whether the client is a Google gRPC client, which compresses the messages itself.
+  bool google_grpc_{};
+};
+
 namespace Detail {
 
 /**
@@ -81,16 +99,25 @@ public:
       : GrpcAccessLogClient(std::move(client), service_method, absl::nullopt) {}
   GrpcAccessLogClient(Grpc::RawAsyncClientPtr&& client,
                       const Protobuf::MethodDescriptor& service_method,
-                      envoy::config::core::v3::ApiVersion transport_api_version)
+                      absl::optional<envoy::config::core::v3::ApiVersion> transport_api_version,
+                      const GrpcAccessLoggerOptions& options = {})
       : client_(std::move(client)), service_method_(service_method),
-        transport_api_version_(transport_api_version) {}
+        transport_api_version_(transport_api_version),
+        compress_messages_(options.compress_messages_), google_grpc_(options.google_grpc_) {}
 
 public:
   struct LocalStream : public Grpc::AsyncStreamCallbacks<LogResponse> {
     LocalStream(GrpcAccessLogClient& parent) : parent_(parent) {}
 
     // Grpc::AsyncStreamCallbacks
-    void onCreateInitialMetadata(Http::RequestHeaderMap&) override {}
+    void onCreateInitialMetadata(Http::RequestHeaderMap& metadata) override {
+      if (parent_.compress_messages_) {
+        metadata.setReferenceKey(parent_.google_grpc_
+                                     ? Http::CustomHeaders::get().GrpcInternalEncodingRequest
+                                     : Http::CustomHeaders::get().GrpcEncoding,
+                                 Http::CustomHeaders::get().GrpcEncodingValues.Gzip);
+      }
+    }
     void onReceiveInitialMetadata(Http::ResponseHeaderMapPtr&&) override {}
     void onReceiveMessage(std::unique_ptr<LogResponse>&&) override {}
     void onReceiveTrailingMetadata(Http::ResponseTrailerMapPtr&&) override {}
@@ -109,7 +136,10 @@ public:
 
   bool isStreamStarted() { return stream_ != nullptr && stream_->stream_ != nullptr; }
 
-  bool log(const LogRequest& request) {
+  // Sends the request, setting sent_bytes to the size of the message sent, if any. Returns false if
+  // the stream is above its high watermark, in which case the request is kept.
+  bool log(const LogRequest& request, uint64_t& sent_bytes) {
+    sent_bytes = 0;
     if (!stream_) {
       stream_ = std::make_unique<LocalStream>(*this);
     }
@@ -124,9 +154,17 @@ public:
         return false;
       }
       if (transport_api_version_.has_value()) {
-        stream_->stream_->sendMessage(request, transport_api_version_.value(), false);
+        Config::VersionConverter::prepareMessageForGrpcWire(const_cast<LogRequest&>(request),
+                                                            transport_api_version_.value());
+      }
+      Buffer::InstancePtr message = Grpc::Common::serializeMessage(request);
+      if (compress_messages_ && !google_grpc_) {
+        compress(*message);
+        sent_bytes = message->length();
+        stream_->stream_->sendCompressedMessageRaw(std::move(message), false);
       } else {
-        stream_->stream_->sendMessage(request, false);
+        sent_bytes = message->length();
+        stream_->stream_->sendMessageRaw(std::move(message), false);
       }
     } else {
       // Clear out the stream data due to stream creation failure.
@@ -135,10 +173,22 @@ public:
     return true;
   }
 
+  // Each message is compressed on its own, as gRPC requires.
+  static void compress(Buffer::Instance& message) {
+    using Extensions::Compression::Gzip::Compressor::ZlibCompressorImpl;
+    ZlibCompressorImpl compressor;
+    // The window bits of zlib plus 16 for a gzip header, and the default memory level.
+    compressor.init(ZlibCompressorImpl::CompressionLevel::Standard,
+                    ZlibCompressorImpl::CompressionStrategy::Standard, 15 + 16, 8);
+    compressor.compress(message, Envoy::Compression::Compressor::State::Finish);
+  }
+
   Grpc::AsyncClient<LogRequest, LogResponse> client_;
   std::unique_ptr<LocalStream> stream_;
   const Protobuf::MethodDescriptor& service_method_;
   const absl::optional<envoy::config::core::v3::ApiVersion> transport_api_version_;
+  const bool compress_messages_;
+  const bool google_grpc_;
 };
 
 } // namespace Detail
@@ -148,7 +198,10 @@ public:
  */
 #define ALL_GRPC_ACCESS_LOGGER_STATS(COUNTER)                                                      \
   COUNTER(logs_written)                                                                            \
-  COUNTER(logs_dropped)
+  COUNTER(logs_dropped)                                                                            \
+  COUNTER(bytes_logged)                                                                            \
+  COUNTER(bytes_sent)                                                                              \
+  COUNTER(messages_sent)
 
 /**
  * Wrapper struct for the access log stats. @see stats_macros.h
@@ -180,12 +233,16 @@ public:
                    uint64_t max_buffer_size_bytes, Event::Dispatcher& dispatcher,
                    Stats::Scope& scope, std::string access_log_prefix,
                    const Protobuf::MethodDescriptor& service_method,
-                   envoy::config::core::v3::ApiVersion transport_api_version)
-      : client_(std::move(client), service_method, transport_api_version),
+                   absl::optional<envoy::config::core::v3::ApiVersion> transport_api_version,
+                   const GrpcAccessLoggerOptions& options = {})
+      : client_(std::move(client), service_method, transport_api_version, options),
         buffer_flush_interval_msec_(buffer_flush_interval_msec),
+        max_buffer_flush_interval_msec_(
+            std::max(buffer_flush_interval_msec, options.max_buffer_flush_interval_)),
+        flush_interval_msec_(buffer_flush_interval_msec),
         flush_timer_(dispatcher.createTimer([this]() {
           flush();
-          flush_timer_->enableTimer(buffer_flush_interval_msec_);
+          flush_timer_->enableTimer(nextFlushInterval());
         })),
         max_buffer_size_bytes_(max_buffer_size_bytes),
         stats_({ALL_GRPC_ACCESS_LOGGER_STATS(POOL_COUNTER_PREFIX(scope, access_log_prefix))}) {
@@ -196,7 +253,7 @@ public:
     if (!canLogMore()) {
       return;
     }
-    approximate_message_size_bytes_ += entry.ByteSizeLong();
+    addEntrySize(entry.ByteSizeLong());
     addEntry(std::move(entry));
     if (approximate_message_size_bytes_ >= max_buffer_size_bytes_) {
       flush();
@@ -204,7 +261,7 @@ public:
   }
 
   void log(TcpLogProto&& entry) {
-    approximate_message_size_bytes_ += entry.ByteSizeLong();
+    addEntrySize(entry.ByteSizeLong());
     addEntry(std::move(entry));
     if (approximate_message_size_bytes_ >= max_buffer_size_bytes_) {
       flush();
@@ -232,13 +289,45 @@ private:
       initMessage();
     }
 
-    if (client_.log(message_)) {
+    uint64_t sent_bytes;
+    if (client_.log(message_, sent_bytes)) {
+      if (sent_bytes > 0) {
+        stats_.messages_sent_.inc();
+        stats_.bytes_sent_.add(sent_bytes);
+      }
       // Clear the message regardless of the success.
       approximate_message_size_bytes_ = 0;
       clearMessage();
     }
   }
 
+  void addEntrySize(uint64_t size) {
+    approximate_message_size_bytes_ += size;
+    interval_logged_bytes_ += size;
+    stats_.bytes_logged_.add(size);
+  }
+
+  // The time the logs take to fill the buffer at the rate of the last flush interval, bounded by
+  // the configured flush intervals.
+  std::chrono::milliseconds nextFlushInterval() {
+    const uint64_t logged_bytes = interval_logged_bytes_;
+    interval_logged_bytes_ = 0;
+    if (max_buffer_flush_interval_msec_ == buffer_flush_interval_msec_ ||
+        max_buffer_size_bytes_ == 0) {
+      return buffer_flush_interval_msec_;
+    }
+    if (logged_bytes == 0) {
+      flush_interval_msec_ = max_buffer_flush_interval_msec_;
+    } else {
+      const double fill_time_msec = static_cast<double>(flush_interval_msec_.count()) *
+                                    max_buffer_size_bytes_ / logged_bytes;
+      flush_interval_msec_ = std::chrono::milliseconds(static_cast<int64_t>(
+          std::min(fill_time_msec, static_cast<double>(max_buffer_flush_interval_msec_.count()))));
+      flush_interval_msec_ = std::max(flush_interval_msec_, buffer_flush_interval_msec_);
+    }
+    return flush_interval_msec_;
+  }
+
   bool canLogMore() {
     if (max_buffer_size_bytes_ == 0 || approximate_message_size_bytes_ < max_buffer_size_bytes_) {
       stats_.logs_written_.inc();
@@ -254,9 +343,14 @@ private:
   }
 
   const std::chrono::milliseconds buffer_flush_interval_msec_;
+  const std::chrono::milliseconds max_buffer_flush_interval_msec_;
+  // The current flush interval, between the two above.
+  std::chrono::milliseconds flush_interval_msec_;
   const Event::TimerPtr flush_timer_;
   const uint64_t max_buffer_size_bytes_;
   uint64_t approximate_message_size_bytes_ = 0;
+  // The size of the entries logged since the flush timer was last enabled.
+  uint64_t interval_logged_bytes_ = 0;
   GrpcAccessLoggerStats stats_;
 };
 
@@ -291,11 +385,16 @@ public:
     }
     const Grpc::AsyncClientFactoryPtr factory =
         async_client_manager_.factoryForGrpcService(config.grpc_service(), scope_, false);
+    GrpcAccessLoggerOptions options;
+    options.max_buffer_flush_interval_ =
+        std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, max_buffer_flush_interval, 0));
+    options.compress_messages_ = config.compress_messages();
+    options.google_grpc_ = config.grpc_service().has_google_grpc();
     const auto logger = createLogger(
         config, transport_version, factory->create(),
         std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, buffer_flush_interval, 1000)),
-        PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, 16384), cache.dispatcher_,
-        scope);
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, 16384), options,
+        cache.dispatcher_, scope);
     cache.access_loggers_.emplace(cache_key, logger);
     return logger;
   }
@@ -319,7 +418,8 @@ private:
   createLogger(const ConfigProto& config, envoy::config::core::v3::ApiVersion transport_version,
                Grpc::RawAsyncClientPtr&& client,
                std::chrono::milliseconds buffer_flush_interval_msec, uint64_t max_buffer_size_bytes,
-               Event::Dispatcher& dispatcher, Stats::Scope& scope) PURE;
+               const GrpcAccessLoggerOptions& options, Event::Dispatcher& dispatcher,
+               Stats::Scope& scope) PURE;
 
   Grpc::AsyncClientManager& async_client_manager_;
   Stats::Scope& scope_;
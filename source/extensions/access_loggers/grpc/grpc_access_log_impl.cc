@@ -19,14 +19,15 @@ GrpcAccessLoggerImpl::GrpcAccessLoggerImpl(
     Grpc::RawAsyncClientPtr&& client, std::string log_name,
     std::chrono::milliseconds buffer_flush_interval_msec, uint64_t max_buffer_size_bytes,
     Event::Dispatcher& dispatcher, const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
-    envoy::config::core::v3::ApiVersion transport_api_version)
+    envoy::config::core::v3::ApiVersion transport_api_version,
+    const Common::GrpcAccessLoggerOptions& options)
     : GrpcAccessLogger(
           std::move(client), buffer_flush_interval_msec, max_buffer_size_bytes, dispatcher, scope,
           GRPC_LOG_STATS_PREFIX,
           Grpc::VersionedMethods("envoy.service.accesslog.v3.AccessLogService.StreamAccessLogs",
                                  "envoy.service.accesslog.v2.AccessLogService.StreamAccessLogs")
               .getMethodDescriptorForVersion(transport_api_version),
-          transport_api_version),
+          transport_api_version, options),
       log_name_(log_name), local_info_(local_info) {}
 
 void GrpcAccessLoggerImpl::addEntry(envoy::data::accesslog::v3::HTTPAccessLogEntry&& entry) {
@@ -57,10 +58,12 @@ GrpcAccessLoggerImpl::SharedPtr GrpcAccessLoggerCacheImpl::createLogger(
     const envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig& config,
     envoy::config::core::v3::ApiVersion transport_version, Grpc::RawAsyncClientPtr&& client,
     std::chrono::milliseconds buffer_flush_interval_msec, uint64_t max_buffer_size_bytes,
-    Event::Dispatcher& dispatcher, Stats::Scope& scope) {
+    const Common::GrpcAccessLoggerOptions& options, Event::Dispatcher& dispatcher,
+    Stats::Scope& scope) {
   return std::make_shared<GrpcAccessLoggerImpl>(std::move(client), config.log_name(),
                                                 buffer_flush_interval_msec, max_buffer_size_bytes,
-                                                dispatcher, local_info_, scope, transport_version);
+                                                dispatcher, local_info_, scope, transport_version,
+                                                options);
 }
 
 } // namespace GrpcCommon
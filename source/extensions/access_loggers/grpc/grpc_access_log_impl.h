@@ -27,7 +27,8 @@ public:
                        std::chrono::milliseconds buffer_flush_interval_msec,
                        uint64_t max_buffer_size_bytes, Event::Dispatcher& dispatcher,
                        const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
-                       envoy::config::core::v3::ApiVersion transport_api_version);
+                       envoy::config::core::v3::ApiVersion transport_api_version,
+                       const Common::GrpcAccessLoggerOptions& options = {});
 
 private:
   // Extensions::AccessLoggers::GrpcCommon::GrpcAccessLogger
@@ -56,7 +57,8 @@ private:
                envoy::config::core::v3::ApiVersion transport_version,
                Grpc::RawAsyncClientPtr&& client,
                std::chrono::milliseconds buffer_flush_interval_msec, uint64_t max_buffer_size_bytes,
-               Event::Dispatcher& dispatcher, Stats::Scope& scope) override;
+               const Common::GrpcAccessLoggerOptions& options, Event::Dispatcher& dispatcher,
+               Stats::Scope& scope) override;
 
   const LocalInfo::LocalInfo& local_info_;
 };
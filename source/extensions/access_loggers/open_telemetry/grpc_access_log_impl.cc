@@ -24,14 +24,15 @@ GrpcAccessLoggerImpl::GrpcAccessLoggerImpl(
     Grpc::RawAsyncClientPtr&& client, std::string log_name,
     std::chrono::milliseconds buffer_flush_interval_msec, uint64_t max_buffer_size_bytes,
     Event::Dispatcher& dispatcher, const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
-    envoy::config::core::v3::ApiVersion transport_api_version)
+    envoy::config::core::v3::ApiVersion transport_api_version,
+    const Common::GrpcAccessLoggerOptions& options)
     : GrpcAccessLogger(
           std::move(client), buffer_flush_interval_msec, max_buffer_size_bytes, dispatcher, scope,
           GRPC_LOG_STATS_PREFIX,
           Grpc::VersionedMethods("opentelemetry.proto.collector.logs.v1.LogsService.Export",
                                  "opentelemetry.proto.collector.logs.v1.LogsService.Export")
               .getMethodDescriptorForVersion(transport_api_version),
-          transport_api_version) {
+          transport_api_version, options) {
   initMessageRoot(log_name, local_info);
 }
 
@@ -80,10 +81,12 @@ GrpcAccessLoggerImpl::SharedPtr GrpcAccessLoggerCacheImpl::createLogger(
     const envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig& config,
     envoy::config::core::v3::ApiVersion transport_version, Grpc::RawAsyncClientPtr&& client,
     std::chrono::milliseconds buffer_flush_interval_msec, uint64_t max_buffer_size_bytes,
-    Event::Dispatcher& dispatcher, Stats::Scope& scope) {
+    const Common::GrpcAccessLoggerOptions& options, Event::Dispatcher& dispatcher,
+    Stats::Scope& scope) {
   return std::make_shared<GrpcAccessLoggerImpl>(std::move(client), config.log_name(),
                                                 buffer_flush_interval_msec, max_buffer_size_bytes,
-                                                dispatcher, local_info_, scope, transport_version);
+                                                dispatcher, local_info_, scope, transport_version,
+                                                options);
 }
 
 } // namespace OpenTelemetry
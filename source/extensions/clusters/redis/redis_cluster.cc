@@ -52,9 +52,13 @@ RedisCluster::RedisCluster(
           factory_context.clusterManager(), factory_context.api().timeSource())),
       registration_handle_(refresh_manager_->registerCluster(
           cluster_name_, redirect_refresh_interval_, redirect_refresh_threshold_,
-          failure_refresh_threshold_, host_degraded_refresh_threshold_, [&]() {
+          failure_refresh_threshold_, host_degraded_refresh_threshold_,
+          [&]() {
             redis_discovery_session_.resolve_timer_->enableTimer(std::chrono::milliseconds(0));
-          })) {
+          },
+          lb_factory_ ? Common::Redis::SlotsMovedCB(
+                            [&](const Common::Redis::MovedSlots& moved) { onSlotsMoved(moved); })
+                      : nullptr)) {
   const auto& locality_lb_endpoints = load_assignment_.endpoints();
   for (const auto& locality_lb_endpoint : locality_lb_endpoints) {
     for (const auto& lb_endpoint : locality_lb_endpoint.lb_endpoints()) {
@@ -90,6 +94,19 @@ void RedisCluster::updateAllHosts(const Upstream::HostVector& hosts_added,
 }
 
 void RedisCluster::onClusterSlotUpdate(ClusterSlotsPtr&& slots) {
+  // An unchanged topology is detected before creating its hosts, unless hosts pending removal are
+  // left to be removed by the update.
+  sortClusterSlots(*slots);
+  if (current_cluster_slots_ && *current_cluster_slots_ == *slots &&
+      std::none_of(hosts_.begin(), hosts_.end(), [](const Upstream::HostSharedPtr& host) {
+        return host->healthFlagGet(Upstream::Host::HealthFlag::PENDING_DYNAMIC_REMOVAL);
+      })) {
+    info_->stats().update_no_rebuild_.inc();
+    onPreInitComplete();
+    return;
+  }
+  current_cluster_slots_ = std::make_unique<std::vector<ClusterSlot>>(*slots);
+
   Upstream::HostVector new_hosts;
   absl::flat_hash_set<std::string> all_new_hosts;
 
@@ -130,6 +147,18 @@ void RedisCluster::onClusterSlotUpdate(ClusterSlotsPtr&& slots) {
   onPreInitComplete();
 }
 
+void RedisCluster::onSlotsMoved(const Common::Redis::MovedSlots& moved_slots) {
+  if (!lb_factory_->onSlotsMoved(moved_slots)) {
+    return;
+  }
+  ENVOY_LOG(debug, "applied {} moved slots to the slot map of cluster {}", moved_slots.size(),
+            cluster_name_);
+  // The slots no longer match the last CLUSTER SLOTS response, so the next one is always applied.
+  current_cluster_slots_ = nullptr;
+  // Force the update of the thread local load balancers.
+  updateAllHosts({}, {}, localityLbEndpoint().priority());
+}
+
 void RedisCluster::reloadHealthyHostsHelper(const Upstream::HostSharedPtr& host) {
   if (lb_factory_) {
     lb_factory_->onHostHealthUpdate();
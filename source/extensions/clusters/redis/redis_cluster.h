@@ -128,6 +128,8 @@ private:
 
   void onClusterSlotUpdate(ClusterSlotsPtr&&);
 
+  void onSlotsMoved(const Common::Redis::MovedSlots& moved_slots);
+
   void reloadHealthyHostsHelper(const Upstream::HostSharedPtr& host) override;
 
   const envoy::config::endpoint::v3::LocalityLbEndpoints& localityLbEndpoint() const {
@@ -221,6 +223,7 @@ private:
     bool enableRedirection() const override { return false; }
     uint32_t maxBufferSizeBeforeFlush() const override { return 0; }
     std::chrono::milliseconds bufferFlushTimeoutInMs() const override { return buffer_timeout_; }
+    bool flushOnEventLoopIteration() const override { return false; }
     uint32_t maxUpstreamUnknownConnections() const override { return 0; }
     bool enableCommandStats() const override { return false; }
     // For any readPolicy other than Primary, the RedisClientFactory will send a READONLY command
@@ -277,6 +280,8 @@ private:
 
   Upstream::HostVector hosts_;
   Upstream::HostMap all_hosts_;
+  // The sorted slots of the last CLUSTER SLOTS response applied, if they are still current.
+  ClusterSlotsPtr current_cluster_slots_;
 
   const std::string auth_username_;
   const std::string auth_password_;
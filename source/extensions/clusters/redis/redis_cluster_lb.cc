@@ -1,5 +1,7 @@
 #include "redis_cluster_lb.h"
 
+#include "absl/container/inlined_vector.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Clusters {
@@ -16,20 +18,31 @@ bool ClusterSlot::operator==(const Envoy::Extensions::Clusters::Redis::ClusterSl
                     [](const auto& it1, const auto& it2) { return it1.first == it2.first; });
 }
 
+void sortClusterSlots(std::vector<ClusterSlot>& slots) {
+  std::sort(slots.begin(), slots.end(), [](const ClusterSlot& lhs, const ClusterSlot& rhs) -> bool {
+    return lhs.start() < rhs.start() || (!(lhs.start() < rhs.start()) && lhs.end() < rhs.end());
+  });
+}
+
 // RedisClusterLoadBalancerFactory
 bool RedisClusterLoadBalancerFactory::onClusterSlotUpdate(ClusterSlotsPtr&& slots,
                                                           Envoy::Upstream::HostMap all_hosts) {
   // The slots is sorted, allowing for a quick comparison to make sure we need to update the slot
   // array sort based on start and end to enable efficient comparison
-  std::sort(
-      slots->begin(), slots->end(), [](const ClusterSlot& lhs, const ClusterSlot& rhs) -> bool {
-        return lhs.start() < rhs.start() || (!(lhs.start() < rhs.start()) && lhs.end() < rhs.end());
-      });
+  sortClusterSlots(*slots);
 
   if (current_cluster_slot_ && *current_cluster_slot_ == *slots) {
     return false;
   }
 
+  // The shards whose hosts didn't change are reused rather than rebuilt.
+  absl::flat_hash_map<std::string, RedisShardSharedPtr> current_shards;
+  if (shard_vector_) {
+    for (const RedisShardSharedPtr& shard : *shard_vector_) {
+      current_shards.emplace(shard->primary()->address()->asString(), shard);
+    }
+  }
+
   auto updated_slots = std::make_shared<SlotArray>();
   auto shard_vector = std::make_shared<std::vector<RedisShardSharedPtr>>();
   absl::flat_hash_map<std::string, uint64_t> shards;
@@ -56,8 +69,14 @@ bool RedisClusterLoadBalancerFactory::onClusterSlotUpdate(ClusterSlotsPtr&& slot
         primary_and_replicas->push_back(replica_host->second);
       }
 
-      shard_vector->emplace_back(
-          std::make_shared<RedisShard>(primary_host->second, replicas, primary_and_replicas));
+      auto current_shard = current_shards.find(primary_address);
+      if (current_shard != current_shards.end() &&
+          current_shard->second->allHosts().hosts() == *primary_and_replicas) {
+        shard_vector->push_back(current_shard->second);
+      } else {
+        shard_vector->emplace_back(
+            std::make_shared<RedisShard>(primary_host->second, replicas, primary_and_replicas));
+      }
     }
 
     for (auto i = slot.start(); i <= slot.end(); ++i) {
@@ -74,6 +93,50 @@ bool RedisClusterLoadBalancerFactory::onClusterSlotUpdate(ClusterSlotsPtr&& slot
   return true;
 }
 
+bool RedisClusterLoadBalancerFactory::onSlotsMoved(const Common::Redis::MovedSlots& moved_slots) {
+  SlotArraySharedPtr current_slot_array;
+  {
+    absl::ReaderMutexLock lock(&mutex_);
+    current_slot_array = slot_array_;
+  }
+
+  // The slots can only be moved once the Redis Cluster topology is resolved.
+  if (!current_slot_array) {
+    return false;
+  }
+
+  absl::flat_hash_map<std::string, uint64_t> shards;
+  for (uint64_t i = 0; i < shard_vector_->size(); ++i) {
+    shards.emplace((*shard_vector_)[i]->primary()->address()->asString(), i);
+  }
+
+  // Only the moved slots are updated, in a copy of the slot array.
+  std::shared_ptr<SlotArray> updated_slots;
+  for (const auto& moved_slot : moved_slots) {
+    auto shard = shards.find(moved_slot.second);
+    if (moved_slot.first >= MaxSlot || shard == shards.end() ||
+        current_slot_array->at(moved_slot.first) == shard->second) {
+      continue;
+    }
+    if (!updated_slots) {
+      updated_slots = std::make_shared<SlotArray>(*current_slot_array);
+    }
+    updated_slots->at(moved_slot.first) = shard->second;
+  }
+
+  if (!updated_slots) {
+    return false;
+  }
+
+  // The slots no longer match the last cluster slot update, so the next one is always applied.
+  current_cluster_slot_ = nullptr;
+  {
+    absl::WriterMutexLock lock(&mutex_);
+    slot_array_ = std::move(updated_slots);
+  }
+  return true;
+}
+
 void RedisClusterLoadBalancerFactory::onHostHealthUpdate() {
   ShardVectorSharedPtr current_shard_vector;
   {
@@ -106,21 +169,54 @@ Upstream::LoadBalancerPtr RedisClusterLoadBalancerFactory::create() {
 
 namespace {
 Upstream::HostConstSharedPtr chooseRandomHost(const Upstream::HostSetImpl& host_set,
+                                              const RedisLoadBalancerContext& context,
                                               Random::RandomGenerator& random) {
-  auto hosts = host_set.healthyHosts();
-  if (hosts.empty()) {
-    hosts = host_set.degradedHosts();
+  const Upstream::HostVector* hosts = &host_set.healthyHosts();
+  if (hosts->empty()) {
+    hosts = &host_set.degradedHosts();
   }
 
-  if (hosts.empty()) {
-    hosts = host_set.hosts();
+  if (hosts->empty()) {
+    hosts = &host_set.hosts();
   }
 
-  if (!hosts.empty()) {
-    return hosts[random.random() % hosts.size()];
-  } else {
+  // The hosts of the preferred zone are chosen from, if there are any.
+  absl::InlinedVector<const Upstream::HostSharedPtr*, 8> candidates;
+  const absl::string_view zone = context.preferredZone();
+  for (const Upstream::HostSharedPtr& host : *hosts) {
+    if (zone.empty() || host->locality().zone() == zone) {
+      candidates.push_back(&host);
+    }
+  }
+  if (candidates.empty()) {
+    for (const Upstream::HostSharedPtr& host : *hosts) {
+      candidates.push_back(&host);
+    }
+  }
+
+  if (candidates.empty()) {
     return nullptr;
   }
+
+  const uint64_t first = random.random() % candidates.size();
+  const HostLatencyTracker* latencies = context.hostLatencies();
+  if (latencies == nullptr || candidates.size() < 2) {
+    return *candidates[first];
+  }
+
+  // Power of two choices: the host with the lowest latency among two distinct random ones is
+  // chosen, a host without measured latency being chosen first.
+  uint64_t second = random.random() % (candidates.size() - 1);
+  if (second >= first) {
+    ++second;
+  }
+  const absl::optional<double> first_latency = latencies->latency(**candidates[first]);
+  const absl::optional<double> second_latency = latencies->latency(**candidates[second]);
+  if (first_latency.has_value() &&
+      (!second_latency.has_value() || second_latency.value() < first_latency.value())) {
+    return *candidates[second];
+  }
+  return *candidates[first];
 }
 } // namespace
 
@@ -150,18 +246,18 @@ Upstream::HostConstSharedPtr RedisClusterLoadBalancerFactory::RedisClusterLoadBa
       if (shard->primary()->health() == Upstream::Host::Health::Healthy) {
         return shard->primary();
       } else {
-        return chooseRandomHost(shard->allHosts(), random_);
+        return chooseRandomHost(shard->allHosts(), *redis_context, random_);
       }
     case NetworkFilters::Common::Redis::Client::ReadPolicy::Replica:
-      return chooseRandomHost(shard->replicas(), random_);
+      return chooseRandomHost(shard->replicas(), *redis_context, random_);
     case NetworkFilters::Common::Redis::Client::ReadPolicy::PreferReplica:
       if (!shard->replicas().healthyHosts().empty()) {
-        return chooseRandomHost(shard->replicas(), random_);
+        return chooseRandomHost(shard->replicas(), *redis_context, random_);
       } else {
-        return chooseRandomHost(shard->allHosts(), random_);
+        return chooseRandomHost(shard->allHosts(), *redis_context, random_);
       }
     case NetworkFilters::Common::Redis::Client::ReadPolicy::Any:
-      return chooseRandomHost(shard->allHosts(), random_);
+      return chooseRandomHost(shard->allHosts(), *redis_context, random_);
     }
   }
   return shard->primary();
@@ -189,10 +285,12 @@ bool RedisLoadBalancerContextImpl::isReadRequest(
 RedisLoadBalancerContextImpl::RedisLoadBalancerContextImpl(
     const std::string& key, bool enabled_hashtagging, bool is_redis_cluster,
     const NetworkFilters::Common::Redis::RespValue& request,
-    NetworkFilters::Common::Redis::Client::ReadPolicy read_policy)
+    NetworkFilters::Common::Redis::Client::ReadPolicy read_policy,
+    const HostLatencyTracker* host_latencies, absl::string_view preferred_zone)
     : hash_key_(is_redis_cluster ? Crc16::crc16(hashtag(key, true))
                                  : MurmurHash::murmurHash2(hashtag(key, enabled_hashtagging))),
-      is_read_(isReadRequest(request)), read_policy_(read_policy) {}
+      is_read_(isReadRequest(request)), read_policy_(read_policy), host_latencies_(host_latencies),
+      preferred_zone_(preferred_zone) {}
 
 // Inspired by the redis-cluster hashtagging algorithm
 // https://redis.io/topics/cluster-spec#keys-hash-tags
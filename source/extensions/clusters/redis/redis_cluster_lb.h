@@ -11,6 +11,7 @@
 #include "source/common/upstream/load_balancer_impl.h"
 #include "source/common/upstream/upstream_impl.h"
 #include "source/extensions/clusters/redis/crc16.h"
+#include "source/extensions/common/redis/cluster_refresh_manager.h"
 #include "source/extensions/filters/network/common/redis/client.h"
 #include "source/extensions/filters/network/common/redis/codec.h"
 #include "source/extensions/filters/network/common/redis/supported_commands.h"
@@ -52,12 +53,44 @@ private:
 using ClusterSlotsPtr = std::unique_ptr<std::vector<ClusterSlot>>;
 using ClusterSlotsSharedPtr = std::shared_ptr<std::vector<ClusterSlot>>;
 
+/**
+ * Sorts the cluster slots by range, so that the slots of two CLUSTER SLOTS responses can be
+ * compared whatever the order the hosts listed them in.
+ */
+void sortClusterSlots(std::vector<ClusterSlot>& slots);
+
+/**
+ * The latencies of the upstream hosts measured by a worker, used to choose the host serving a read
+ * command.
+ */
+class HostLatencyTracker {
+public:
+  virtual ~HostLatencyTracker() = default;
+
+  /**
+   * @param host supplies the upstream host.
+   * @return the latency of the host in microseconds, or nullopt if it wasn't measured yet.
+   */
+  virtual absl::optional<double> latency(const Upstream::Host& host) const PURE;
+};
+
 class RedisLoadBalancerContext {
 public:
   virtual ~RedisLoadBalancerContext() = default;
 
   virtual bool isReadCommand() const PURE;
   virtual NetworkFilters::Common::Redis::Client::ReadPolicy readPolicy() const PURE;
+
+  /**
+   * @return the latencies used to choose the host serving a read command between two random ones,
+   * or nullptr to choose it at random.
+   */
+  virtual const HostLatencyTracker* hostLatencies() const PURE;
+
+  /**
+   * @return the zone whose hosts are preferred to serve a read command, or an empty string.
+   */
+  virtual absl::string_view preferredZone() const PURE;
 };
 
 class RedisLoadBalancerContextImpl : public RedisLoadBalancerContext,
@@ -73,12 +106,17 @@ public:
    * will be hashed using crc16.
    * @param request specify the Redis request.
    * @param read_policy specify the read policy.
+   * @param host_latencies specify the latencies used to choose the host of a read command, or
+   * nullptr to choose it at random.
+   * @param preferred_zone specify the zone whose hosts are preferred for a read command.
    */
   RedisLoadBalancerContextImpl(const std::string& key, bool enabled_hashtagging,
                                bool is_redis_cluster,
                                const NetworkFilters::Common::Redis::RespValue& request,
                                NetworkFilters::Common::Redis::Client::ReadPolicy read_policy =
-                                   NetworkFilters::Common::Redis::Client::ReadPolicy::Primary);
+                                   NetworkFilters::Common::Redis::Client::ReadPolicy::Primary,
+                               const HostLatencyTracker* host_latencies = nullptr,
+                               absl::string_view preferred_zone = "");
 
   // Upstream::LoadBalancerContextBase
   absl::optional<uint64_t> computeHashKey() override { return hash_key_; }
@@ -89,6 +127,10 @@ public:
     return read_policy_;
   }
 
+  const HostLatencyTracker* hostLatencies() const override { return host_latencies_; }
+
+  absl::string_view preferredZone() const override { return preferred_zone_; }
+
 private:
   absl::string_view hashtag(absl::string_view v, bool enabled);
 
@@ -97,6 +139,8 @@ private:
   const absl::optional<uint64_t> hash_key_;
   const bool is_read_;
   const NetworkFilters::Common::Redis::Client::ReadPolicy read_policy_;
+  const HostLatencyTracker* const host_latencies_;
+  const absl::string_view preferred_zone_;
 };
 
 class ClusterSlotUpdateCallBack {
@@ -111,6 +155,15 @@ public:
    */
   virtual bool onClusterSlotUpdate(ClusterSlotsPtr&& slots, Upstream::HostMap all_hosts) PURE;
 
+  /**
+   * Callback when slots are moved by MOVED redirection errors between the cluster slot updates.
+   * The slots moved to a host that isn't the primary of a known shard are ignored, and left to the
+   * next cluster slot update.
+   * @param moved_slots provides the address of the host each slot is moved to.
+   * @return indicate if the cluster slot is updated or not.
+   */
+  virtual bool onSlotsMoved(const Common::Redis::MovedSlots& moved_slots) PURE;
+
   /**
    * Callback when a host's health status is updated
    */
@@ -131,6 +184,8 @@ public:
   // ClusterSlotUpdateCallBack
   bool onClusterSlotUpdate(ClusterSlotsPtr&& slots, Upstream::HostMap all_hosts) override;
 
+  bool onSlotsMoved(const Common::Redis::MovedSlots& moved_slots) override;
+
   void onHostHealthUpdate() override;
 
   // Upstream::LoadBalancerFactory
@@ -101,20 +101,14 @@ DnsCacheImpl::loadDnsCacheEntry(absl::string_view host, uint16_t default_port,
   ENVOY_LOG(debug, "thread local lookup for host '{}'", host);
   ThreadLocalHostInfo& tls_host_info = *tls_slot_;
 
-  auto [is_overflow, host_info] = [&]() {
-    absl::ReaderMutexLock read_lock{&primary_hosts_lock_};
-    auto tls_host = primary_hosts_.find(host);
-    return std::make_tuple(
-        primary_hosts_.size() >= max_hosts_,
-        (tls_host != primary_hosts_.end() && tls_host->second->host_info_->firstResolveComplete())
-            ? absl::optional<DnsHostInfoSharedPtr>(tls_host->second->host_info_)
-            : absl::nullopt);
-  }();
-
-  if (host_info) {
+  // A host missing from the thread local map has either not completed its first resolution yet,
+  // or the update for it has yet to reach this thread, in which case the update completes the
+  // pending resolution.
+  auto tls_host = tls_host_info.resolved_hosts_.find(host);
+  if (tls_host != tls_host_info.resolved_hosts_.end()) {
     ENVOY_LOG(debug, "cache hit for host '{}'", host);
-    return {LoadDnsCacheEntryStatus::InCache, nullptr, host_info};
-  } else if (is_overflow) {
+    return {LoadDnsCacheEntryStatus::InCache, nullptr, tls_host->second};
+  } else if (num_primary_hosts_.load() >= max_hosts_) {
     ENVOY_LOG(debug, "DNS cache overflow for host '{}'", host);
     stats_.host_overflow_.inc();
     return {LoadDnsCacheEntryStatus::Overflow, nullptr, absl::nullopt};
@@ -258,7 +252,7 @@ void DnsCacheImpl::onReResolve(const std::string& host) {
       host_to_erase = std::move(host_it->second);
       primary_hosts_.erase(host_it);
     }
-    notifyThreads(host, primary_host.host_info_);
+    notifyThreads(host, primary_host.host_info_, true);
   } else {
     startResolve(host, primary_host);
   }
@@ -365,8 +359,8 @@ void DnsCacheImpl::runRemoveCallbacks(const std::string& host) {
 }
 
 void DnsCacheImpl::notifyThreads(const std::string& host,
-                                 const DnsHostInfoImplSharedPtr& resolved_info) {
-  auto shared_info = std::make_shared<HostMapUpdateInfo>(host, resolved_info);
+                                 const DnsHostInfoImplSharedPtr& resolved_info, bool removed) {
+  auto shared_info = std::make_shared<HostMapUpdateInfo>(host, resolved_info, removed);
   tls_slot_.runOnAllThreads([shared_info](OptRef<ThreadLocalHostInfo> local_host_info) {
     local_host_info->onHostMapUpdate(shared_info);
   });
@@ -383,6 +377,12 @@ DnsCacheImpl::ThreadLocalHostInfo::~ThreadLocalHostInfo() {
 
 void DnsCacheImpl::ThreadLocalHostInfo::onHostMapUpdate(
     const HostMapUpdateInfoSharedPtr& resolved_host) {
+  if (resolved_host->removed_) {
+    resolved_hosts_.erase(resolved_host->host_);
+  } else {
+    resolved_hosts_.insert_or_assign(resolved_host->host_, resolved_host->info_);
+  }
+
   auto host_it = pending_resolutions_.find(resolved_host->host_);
   if (host_it != pending_resolutions_.end()) {
     for (auto* resolution : host_it->second) {
@@ -406,11 +406,13 @@ DnsCacheImpl::PrimaryHostInfo::PrimaryHostInfo(DnsCacheImpl& parent,
                                                    host_to_resolve, is_ip_address)) {
   parent_.stats_.host_added_.inc();
   parent_.stats_.num_hosts_.inc();
+  parent_.num_primary_hosts_++;
 }
 
 DnsCacheImpl::PrimaryHostInfo::~PrimaryHostInfo() {
   parent_.stats_.host_removed_.inc();
   parent_.stats_.num_hosts_.dec();
+  parent_.num_primary_hosts_--;
 }
 
 } // namespace DynamicForwardProxy
@@ -75,10 +75,12 @@ private:
   using DnsHostInfoImplSharedPtr = std::shared_ptr<DnsHostInfoImpl>;
 
   struct HostMapUpdateInfo {
-    HostMapUpdateInfo(const std::string& host, DnsHostInfoImplSharedPtr info)
-        : host_(host), info_(std::move(info)) {}
+    HostMapUpdateInfo(const std::string& host, DnsHostInfoImplSharedPtr info, bool removed)
+        : host_(host), info_(std::move(info)), removed_(removed) {}
     std::string host_;
     DnsHostInfoImplSharedPtr info_;
+    // Whether the host was removed from the cache rather than resolved.
+    bool removed_;
   };
   using HostMapUpdateInfoSharedPtr = std::shared_ptr<HostMapUpdateInfo>;
 
@@ -88,6 +90,9 @@ private:
     ~ThreadLocalHostInfo() override;
     void onHostMapUpdate(const HostMapUpdateInfoSharedPtr& resolved_info);
     absl::flat_hash_map<std::string, std::list<LoadDnsCacheEntryHandleImpl*>> pending_resolutions_;
+    // The hosts which completed their first resolution, as known to this thread. Cache hits are
+    // looked up here, without taking the locks of the primary hosts.
+    absl::flat_hash_map<std::string, DnsHostInfoImplSharedPtr> resolved_hosts_;
     DnsCacheImpl& parent_;
   };
 
@@ -173,7 +178,8 @@ private:
                      std::list<Network::DnsResponse>&& response);
   void runAddUpdateCallbacks(const std::string& host, const DnsHostInfoSharedPtr& host_info);
   void runRemoveCallbacks(const std::string& host);
-  void notifyThreads(const std::string& host, const DnsHostInfoImplSharedPtr& resolved_info);
+  void notifyThreads(const std::string& host, const DnsHostInfoImplSharedPtr& resolved_info,
+                     bool removed = false);
   void onReResolve(const std::string& host);
   void onResolveTimeout(const std::string& host);
   PrimaryHostInfo& getPrimaryHost(const std::string& host);
@@ -185,6 +191,8 @@ private:
   Stats::ScopePtr scope_;
   DnsCacheStats stats_;
   std::list<AddUpdateCallbacksHandleImpl*> update_callbacks_;
+  // The size of primary_hosts_, for the workers to check for overflows without the lock.
+  std::atomic<size_t> num_primary_hosts_{0};
   absl::Mutex primary_hosts_lock_;
   absl::flat_hash_map<std::string, PrimaryHostInfoPtr>
       primary_hosts_ ABSL_GUARDED_BY(primary_hosts_lock_);
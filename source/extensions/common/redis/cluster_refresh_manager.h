@@ -8,6 +8,8 @@
 
 #include "envoy/common/pure.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Common {
@@ -15,6 +17,12 @@ namespace Redis {
 
 using RefreshCB = std::function<void()>;
 
+/**
+ * The slots moved by MOVED redirection errors, to the address of the host now serving each of them.
+ */
+using MovedSlots = absl::flat_hash_map<uint64_t, std::string>;
+using SlotsMovedCB = std::function<void(const MovedSlots& moved_slots)>;
+
 /**
  * A manager for tracking events that would trigger a cluster refresh, and calling registered
  * callbacks when the error rate exceeds a configurable threshold (while ensuring that a minimum
@@ -55,6 +63,18 @@ public:
    */
   virtual bool onHostDegraded(const std::string& cluster_name) PURE;
 
+  /**
+   * Notifies the manager that a MOVED redirection error has been received for a given cluster, so
+   * that the slot can be updated without waiting for the next refresh. The slots moved until the
+   * cluster's registered slots moved callback is called on the main thread are passed to it
+   * together.
+   * @param cluster_name is the name of the cluster.
+   * @param slot is the slot of the redirection.
+   * @param host_address is the address of the host the slot is redirected to.
+   */
+  virtual void onSlotMoved(const std::string& cluster_name, uint64_t slot,
+                           const std::string& host_address) PURE;
+
   /**
    * Register a cluster to be tracked by the manager (called by main thread only).
    * @param cluster_name is the name of the cluster.
@@ -63,6 +83,8 @@ public:
    * @param redirects_threshold is the number of redirects that must be reached to consider
    * calling the callback.
    * @param cb is the cluster callback function.
+   * @param slots_moved_cb is the cluster callback function for the moved slots, or nullptr to
+   * ignore them.
    * @return HandlePtr is a smart pointer to an opaque Handle that will unregister the cluster upon
    * destruction.
    */
@@ -71,7 +93,8 @@ public:
                                     const uint32_t redirects_threshold,
                                     const uint32_t failure_threshold,
                                     const uint32_t host_degraded_threshold,
-                                    const RefreshCB& cb) PURE;
+                                    const RefreshCB& cb,
+                                    const SlotsMovedCB& slots_moved_cb) PURE;
 };
 
 using ClusterRefreshManagerSharedPtr = std::shared_ptr<ClusterRefreshManager>;
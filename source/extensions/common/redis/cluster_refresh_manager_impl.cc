@@ -31,17 +31,50 @@ bool ClusterRefreshManagerImpl::onRedirection(const std::string& cluster_name) {
   return onEvent(cluster_name, EventType::Redirection);
 }
 
-bool ClusterRefreshManagerImpl::onEvent(const std::string& cluster_name, EventType event_type) {
-  ClusterInfoSharedPtr info;
+void ClusterRefreshManagerImpl::onSlotMoved(const std::string& cluster_name, uint64_t slot,
+                                            const std::string& host_address) {
+  ClusterInfoSharedPtr info = findClusterInfo(cluster_name);
+  if (!info || !info->slots_moved_cb_) {
+    return;
+  }
   {
-    // Hold the map lock to avoid a race condition with calls to unregisterCluster
-    // on the main thread.
-    Thread::LockGuard lock(map_mutex_);
-    auto it = info_map_.find(cluster_name);
-    if (it != info_map_.end()) {
-      info = it->second;
+    // Only the first move since the callback was last posted posts it, the others are passed to
+    // the same call.
+    Thread::LockGuard lock(info->moved_slots_mutex_);
+    const bool post_callback = info->moved_slots_.empty();
+    info->moved_slots_[slot] = host_address;
+    if (!post_callback) {
+      return;
     }
   }
+  main_thread_dispatcher_.post([this, cluster_name, info]() {
+    MovedSlots moved_slots;
+    {
+      Thread::LockGuard lock(info->moved_slots_mutex_);
+      moved_slots.swap(info->moved_slots_);
+    }
+    // Ensure that cluster is still active before calling callback.
+    auto maps = cm_.clusters();
+    if (maps.active_clusters_.find(cluster_name) != maps.active_clusters_.end()) {
+      info->slots_moved_cb_(moved_slots);
+    }
+  });
+}
+
+ClusterRefreshManagerImpl::ClusterInfoSharedPtr
+ClusterRefreshManagerImpl::findClusterInfo(const std::string& cluster_name) {
+  // Hold the map lock to avoid a race condition with calls to unregisterCluster
+  // on the main thread.
+  Thread::LockGuard lock(map_mutex_);
+  auto it = info_map_.find(cluster_name);
+  if (it != info_map_.end()) {
+    return it->second;
+  }
+  return nullptr;
+}
+
+bool ClusterRefreshManagerImpl::onEvent(const std::string& cluster_name, EventType event_type) {
+  ClusterInfoSharedPtr info = findClusterInfo(cluster_name);
   // No locks needed for thread safety while accessing clusterInfoSharedPtr members as
   // all potentially modified members are atomic (redirects_count_, last_callback_time_ms_).
   if (info.get()) {
@@ -149,11 +182,12 @@ bool ClusterRefreshManagerImpl::onEvent(const std::string& cluster_name, EventTy
 ClusterRefreshManagerImpl::HandlePtr ClusterRefreshManagerImpl::registerCluster(
     const std::string& cluster_name, std::chrono::milliseconds min_time_between_triggering,
     const uint32_t redirects_threshold, const uint32_t failure_threshold,
-    const uint32_t host_degraded_threshold, const RefreshCB& cb) {
+    const uint32_t host_degraded_threshold, const RefreshCB& cb,
+    const SlotsMovedCB& slots_moved_cb) {
   Thread::LockGuard lock(map_mutex_);
-  ClusterInfoSharedPtr info =
-      std::make_shared<ClusterInfo>(cluster_name, min_time_between_triggering, redirects_threshold,
-                                    failure_threshold, host_degraded_threshold, cb);
+  ClusterInfoSharedPtr info = std::make_shared<ClusterInfo>(
+      cluster_name, min_time_between_triggering, redirects_threshold, failure_threshold,
+      host_degraded_threshold, cb, slots_moved_cb);
   info_map_[cluster_name] = info;
 
   return std::make_unique<ClusterRefreshManagerImpl::HandleImpl>(this, info);
@@ -29,11 +29,12 @@ public:
   struct ClusterInfo {
     ClusterInfo(std::string cluster_name, std::chrono::milliseconds min_time_between_triggering,
                 const uint32_t redirects_threshold, const uint32_t failure_threshold,
-                const uint32_t host_degraded_threshold, RefreshCB cb)
+                const uint32_t host_degraded_threshold, RefreshCB cb, SlotsMovedCB slots_moved_cb)
         : cluster_name_(std::move(cluster_name)),
           min_time_between_triggering_(min_time_between_triggering),
           redirects_threshold_(redirects_threshold), failure_threshold_(failure_threshold),
-          host_degraded_threshold_(host_degraded_threshold), cb_(std::move(cb)) {}
+          host_degraded_threshold_(host_degraded_threshold), cb_(std::move(cb)),
+          slots_moved_cb_(std::move(slots_moved_cb)) {}
     std::string cluster_name_;
     std::atomic<uint64_t> last_callback_time_ms_{};
     std::atomic<uint32_t> redirects_count_{};
@@ -44,6 +45,10 @@ public:
     const uint32_t failure_threshold_;
     const uint32_t host_degraded_threshold_;
     RefreshCB cb_;
+    const SlotsMovedCB slots_moved_cb_;
+    Thread::MutexBasicLockable moved_slots_mutex_;
+    // The slots moved since the slots moved callback was last posted to the main thread.
+    MovedSlots moved_slots_ ABSL_GUARDED_BY(moved_slots_mutex_);
   };
 
   using ClusterInfoSharedPtr = std::shared_ptr<ClusterInfo>;
@@ -67,11 +72,14 @@ public:
   bool onRedirection(const std::string& cluster_name) override;
   bool onFailure(const std::string& cluster_name) override;
   bool onHostDegraded(const std::string& cluster_name) override;
+  void onSlotMoved(const std::string& cluster_name, uint64_t slot,
+                   const std::string& host_address) override;
 
   HandlePtr registerCluster(const std::string& cluster_name,
                             std::chrono::milliseconds min_time_between_triggering,
                             const uint32_t redirects_threshold, const uint32_t failure_threshold,
-                            const uint32_t host_degraded_threshold, const RefreshCB& cb) override;
+                            const uint32_t host_degraded_threshold, const RefreshCB& cb,
+                            const SlotsMovedCB& slots_moved_cb) override;
 
 private:
   void unregisterCluster(const ClusterInfoSharedPtr& cluster_info);
@@ -88,6 +96,7 @@ private:
   };
 
   bool onEvent(const std::string& cluster_name, EventType event_type);
+  ClusterInfoSharedPtr findClusterInfo(const std::string& cluster_name);
 
   Event::Dispatcher& main_thread_dispatcher_;
   Upstream::ClusterManager& cm_;
@@ -0,0 +1,190 @@
+#include "source/extensions/common/tap/buffered_file_sink.h"
+
+#include "envoy/common/exception.h"
+
+#include "source/common/common/fmt.h"
+#include "source/common/protobuf/protobuf.h"
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Tap {
+
+static constexpr uint32_t DefaultMaxBufferedTraces = 1024;
+
+BufferedFileSink::BufferedFileSink(const envoy::config::tap::v3::BufferedFileSink& config,
+                                   envoy::config::tap::v3::OutputSink::Format format,
+                                   Api::Api& api)
+    : thread_factory_(api.threadFactory()), file_format_(config.file_format()),
+      max_buffered_traces_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_buffered_traces, DefaultMaxBufferedTraces)),
+      sampling_(config.has_sampling()
+                    ? absl::make_optional<envoy::type::v3::FractionalPercent>(config.sampling())
+                    : absl::nullopt),
+      stats_{ALL_BUFFERED_FILE_SINK_STATS(
+          POOL_COUNTER_PREFIX(api.rootScope(), "tap.buffered_file_sink."))} {
+  if (file_format_ == envoy::config::tap::v3::BufferedFileSink::TRACE_WRAPPER &&
+      format != envoy::config::tap::v3::OutputSink::PROTO_BINARY_LENGTH_DELIMITED) {
+    throw EnvoyException(
+        "buffered file sink only supports the PROTO_BINARY_LENGTH_DELIMITED format");
+  }
+
+  // When reading and writing binary files, we need to be sure std::ios_base::binary is set,
+  // otherwise we will not get the expected results on Windows.
+  output_file_.open(config.path(), std::ios_base::binary);
+  if (!output_file_.is_open()) {
+    throw EnvoyException(fmt::format("unable to open tap file '{}'", config.path()));
+  }
+  if (file_format_ == envoy::config::tap::v3::BufferedFileSink::PCAPNG) {
+    output_file_ << PcapngWriter::header();
+  }
+
+  drain_thread_ = thread_factory_.createThread([this]() -> void { drainThread(); },
+                                               Thread::Options{"TapFileSink"});
+}
+
+BufferedFileSink::~BufferedFileSink() {
+  {
+    absl::MutexLock lock(&wake_up_mutex_);
+    woken_up_ = true;
+    shutdown_ = true;
+  }
+  // The background thread writes the traces that are still buffered before it exits.
+  drain_thread_->join();
+}
+
+PerTapSinkHandlePtr BufferedFileSink::createPerTapSinkHandle(uint64_t trace_id) {
+  // Sampling on the trace ID keeps all the segments of a streamed trace together.
+  if (sampling_.has_value() &&
+      !ProtobufPercentHelper::evaluateFractionalPercent(sampling_.value(), trace_id)) {
+    return std::make_unique<BufferedFileSinkHandle>(*this, nullptr);
+  }
+  return std::make_unique<BufferedFileSinkHandle>(*this, &ringOfThisThread());
+}
+
+bool BufferedFileSink::TraceRing::push(TraceWrapperPtr&& trace) {
+  const uint64_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+    return false;
+  }
+  slots_[tail % slots_.size()] = std::move(trace);
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+TraceWrapperPtr BufferedFileSink::TraceRing::pop() {
+  const uint64_t head = head_.load(std::memory_order_relaxed);
+  if (head == tail_.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  TraceWrapperPtr trace = std::move(slots_[head % slots_.size()]);
+  head_.store(head + 1, std::memory_order_release);
+  return trace;
+}
+
+void BufferedFileSink::BufferedFileSinkHandle::submitTrace(
+    TraceWrapperPtr&& trace, envoy::config::tap::v3::OutputSink::Format) {
+  if (ring_ == nullptr) {
+    return;
+  }
+  if (!ring_->push(std::move(trace))) {
+    parent_.stats_.traces_dropped_.inc();
+    return;
+  }
+  parent_.wakeUp();
+}
+
+BufferedFileSink::TraceRing& BufferedFileSink::ringOfThisThread() {
+  // The handles are created on the threads that submit their traces, once per tap, so the lock is
+  // not taken for each trace.
+  absl::MutexLock lock(&rings_mutex_);
+  std::unique_ptr<TraceRing>& ring = rings_[thread_factory_.currentThreadId()];
+  if (ring == nullptr) {
+    ring = std::make_unique<TraceRing>(max_buffered_traces_);
+  }
+  return *ring;
+}
+
+void BufferedFileSink::wakeUp() {
+  // Pairs with the fence of the background thread, so that either the background thread sees the
+  // pushed trace before it waits, or the pushing thread sees that it is waiting.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (waiting_.load(std::memory_order_relaxed) && waiting_.exchange(false)) {
+    absl::MutexLock lock(&wake_up_mutex_);
+    woken_up_ = true;
+  }
+}
+
+void BufferedFileSink::drainThread() {
+  while (true) {
+    if (drainRings() > 0) {
+      continue;
+    }
+    // The traces written so far are flushed to the file while there are no others to write.
+    output_file_.flush();
+
+    waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (drainRings() > 0) {
+      waiting_.store(false, std::memory_order_relaxed);
+      continue;
+    }
+
+    absl::MutexLock lock(&wake_up_mutex_);
+    wake_up_mutex_.Await(absl::Condition(&woken_up_));
+    woken_up_ = false;
+    waiting_.store(false, std::memory_order_relaxed);
+    if (shutdown_) {
+      break;
+    }
+  }
+
+  drainRings();
+  output_file_.flush();
+}
+
+uint64_t BufferedFileSink::drainRings() {
+  // The rings are never removed, so they can be drained without holding the lock.
+  std::vector<TraceRing*> rings;
+  {
+    absl::MutexLock lock(&rings_mutex_);
+    rings.reserve(rings_.size());
+    for (const auto& ring : rings_) {
+      rings.push_back(ring.second.get());
+    }
+  }
+
+  uint64_t drained = 0;
+  for (TraceRing* ring : rings) {
+    for (TraceWrapperPtr trace = ring->pop(); trace != nullptr; trace = ring->pop()) {
+      writeTrace(*trace);
+      drained++;
+    }
+  }
+  return drained;
+}
+
+void BufferedFileSink::writeTrace(const envoy::data::tap::v3::TraceWrapper& trace) {
+  output_buffer_.clear();
+  if (file_format_ == envoy::config::tap::v3::BufferedFileSink::PCAPNG) {
+    if (!pcapng_writer_.write(trace, output_buffer_)) {
+      stats_.traces_skipped_.inc();
+      return;
+    }
+  } else {
+    Protobuf::io::StringOutputStream stream(&output_buffer_);
+    Protobuf::io::CodedOutputStream coded_stream(&stream);
+    coded_stream.WriteVarint32(trace.ByteSizeLong());
+    trace.SerializeWithCachedSizes(&coded_stream);
+  }
+
+  output_file_.write(output_buffer_.data(), output_buffer_.size());
+  stats_.traces_written_.inc();
+  stats_.bytes_written_.add(output_buffer_.size());
+}
+
+} // namespace Tap
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/config/tap/v3/common.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
+#include "envoy/type/v3/percent.pb.h"
+
+#include "source/extensions/common/tap/pcapng_writer.h"
+#include "source/extensions/common/tap/tap.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Tap {
+
+/**
+ * All stats for the buffered file sink. @see stats_macros.h
+ */
+#define ALL_BUFFERED_FILE_SINK_STATS(COUNTER)                                                      \
+  COUNTER(bytes_written)                                                                           \
+  COUNTER(traces_dropped)                                                                          \
+  COUNTER(traces_skipped)                                                                          \
+  COUNTER(traces_written)
+
+/**
+ * Wrapper struct for the buffered file sink stats. @see stats_macros.h
+ */
+struct BufferedFileSinkStats {
+  ALL_BUFFERED_FILE_SINK_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * A tap sink that writes the traces of all the taps to a single file, as configured by
+ * envoy::config::tap::v3::BufferedFileSink. The traces submitted on each thread are moved into a
+ * single producer, single consumer ring of the thread without taking any locks, and a background
+ * thread drains the rings, serializes the traces and writes them to the file. The traces that don't
+ * fit in the ring of their thread are dropped.
+ */
+class BufferedFileSink : public Sink {
+public:
+  BufferedFileSink(const envoy::config::tap::v3::BufferedFileSink& config,
+                   envoy::config::tap::v3::OutputSink::Format format, Api::Api& api);
+  ~BufferedFileSink() override;
+
+  // Sink
+  PerTapSinkHandlePtr createPerTapSinkHandle(uint64_t trace_id) override;
+
+private:
+  // The ring of the traces submitted on a thread, which only that thread pushes to and only the
+  // background thread pops from.
+  class TraceRing {
+  public:
+    explicit TraceRing(uint32_t capacity) : slots_(capacity) {}
+
+    // @return false if the ring is full and the trace was dropped.
+    bool push(TraceWrapperPtr&& trace);
+    // @return the oldest trace of the ring, or nullptr if the ring is empty.
+    TraceWrapperPtr pop();
+
+  private:
+    std::vector<TraceWrapperPtr> slots_;
+    // The positions of the next traces to pop and to push, on cache lines of their own since they
+    // are written by different threads.
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+  };
+
+  struct BufferedFileSinkHandle : public PerTapSinkHandle {
+    BufferedFileSinkHandle(BufferedFileSink& parent, TraceRing* ring)
+        : parent_(parent), ring_(ring) {}
+
+    // PerTapSinkHandle
+    void submitTrace(TraceWrapperPtr&& trace,
+                     envoy::config::tap::v3::OutputSink::Format format) override;
+
+    BufferedFileSink& parent_;
+    // The ring of the thread of the tap, or nullptr if the tap was not sampled.
+    TraceRing* const ring_;
+  };
+
+  // @return the ring of the calling thread.
+  TraceRing& ringOfThisThread();
+  // Wakes the background thread up if it is waiting for traces.
+  void wakeUp();
+  void drainThread();
+  // Writes the traces of all the rings to the file. @return the number of traces drained.
+  uint64_t drainRings();
+  void writeTrace(const envoy::data::tap::v3::TraceWrapper& trace);
+
+  Thread::ThreadFactory& thread_factory_;
+  const envoy::config::tap::v3::BufferedFileSink::FileFormat file_format_;
+  const uint32_t max_buffered_traces_;
+  const absl::optional<envoy::type::v3::FractionalPercent> sampling_;
+  BufferedFileSinkStats stats_;
+  // Only used by the background thread once it started.
+  std::ofstream output_file_;
+  PcapngWriter pcapng_writer_;
+  std::string output_buffer_;
+
+  absl::Mutex rings_mutex_;
+  absl::flat_hash_map<Thread::ThreadId, std::unique_ptr<TraceRing>>
+      rings_ ABSL_GUARDED_BY(rings_mutex_);
+
+  // Set by the background thread before it waits for traces, so that the threads pushing traces
+  // know to wake it up.
+  std::atomic<bool> waiting_{false};
+  absl::Mutex wake_up_mutex_;
+  // Set to wake the background thread up, either for new traces or to shut it down.
+  bool woken_up_ ABSL_GUARDED_BY(wake_up_mutex_){false};
+  bool shutdown_ ABSL_GUARDED_BY(wake_up_mutex_){false};
+  Thread::ThreadPtr drain_thread_;
+};
+
+} // namespace Tap
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
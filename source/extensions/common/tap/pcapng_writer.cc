@@ -0,0 +1,261 @@
+#include "source/extensions/common/tap/pcapng_writer.h"
+
+#include <algorithm>
+
+#include "source/common/network/utility.h"
+#include "source/common/protobuf/protobuf.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Tap {
+namespace {
+
+// The pcapng block types, and the link type of the raw IP packets.
+constexpr uint32_t SectionHeaderBlockType = 0x0A0D0D0A;
+constexpr uint32_t InterfaceDescriptionBlockType = 0x00000001;
+constexpr uint32_t EnhancedPacketBlockType = 0x00000006;
+constexpr uint32_t ByteOrderMagic = 0x1A2B3C4D;
+constexpr uint16_t LinkTypeRaw = 101;
+
+constexpr size_t Ipv4HeaderLength = 20;
+constexpr size_t Ipv6HeaderLength = 40;
+constexpr size_t TcpHeaderLength = 20;
+// The payload of a packet is kept well under the 64KiB limit of the IP payload length.
+constexpr size_t MaxPacketPayload = 65000;
+
+constexpr uint8_t TcpFlagFin = 0x01;
+constexpr uint8_t TcpFlagPsh = 0x08;
+constexpr uint8_t TcpFlagAck = 0x10;
+
+// The blocks are written in little endian, as told by the byte order magic of the section.
+void appendLittleEndian16(std::string& output, uint16_t value) {
+  output.push_back(static_cast<char>(value & 0xFF));
+  output.push_back(static_cast<char>(value >> 8));
+}
+
+void appendLittleEndian32(std::string& output, uint32_t value) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    output.push_back(static_cast<char>((value >> shift) & 0xFF));
+  }
+}
+
+// The headers of the packets are written in network byte order.
+void appendNetwork16(std::string& output, uint16_t value) {
+  output.push_back(static_cast<char>(value >> 8));
+  output.push_back(static_cast<char>(value & 0xFF));
+}
+
+void appendNetwork32(std::string& output, uint32_t value) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    output.push_back(static_cast<char>((value >> shift) & 0xFF));
+  }
+}
+
+// @return the checksum of an IPv4 header.
+uint16_t ipv4Checksum(absl::string_view header) {
+  uint32_t sum = 0;
+  for (size_t i = 0; i + 1 < header.size(); i += 2) {
+    sum += (static_cast<uint8_t>(header[i]) << 8) | static_cast<uint8_t>(header[i + 1]);
+  }
+  while (sum >> 16) {
+    sum = (sum & 0xFFFF) + (sum >> 16);
+  }
+  return static_cast<uint16_t>(~sum);
+}
+
+const envoy::data::tap::v3::Body* dataOf(const envoy::data::tap::v3::SocketEvent& event) {
+  if (event.has_read()) {
+    return &event.read().data();
+  }
+  if (event.has_write()) {
+    return &event.write().data();
+  }
+  return nullptr;
+}
+
+} // namespace
+
+std::string PcapngWriter::header() {
+  std::string output;
+  appendLittleEndian32(output, SectionHeaderBlockType);
+  appendLittleEndian32(output, 28);
+  appendLittleEndian32(output, ByteOrderMagic);
+  appendLittleEndian16(output, 1);
+  appendLittleEndian16(output, 0);
+  // The length of the section is unspecified.
+  appendLittleEndian32(output, 0xFFFFFFFF);
+  appendLittleEndian32(output, 0xFFFFFFFF);
+  appendLittleEndian32(output, 28);
+
+  appendLittleEndian32(output, InterfaceDescriptionBlockType);
+  appendLittleEndian32(output, 20);
+  appendLittleEndian16(output, LinkTypeRaw);
+  appendLittleEndian16(output, 0);
+  // No limit on the captured length of the packets.
+  appendLittleEndian32(output, 0);
+  appendLittleEndian32(output, 20);
+  return output;
+}
+
+bool PcapngWriter::write(const envoy::data::tap::v3::TraceWrapper& trace, std::string& output) {
+  switch (trace.trace_case()) {
+  case envoy::data::tap::v3::TraceWrapper::TraceCase::kSocketBufferedTrace: {
+    const auto& buffered_trace = trace.socket_buffered_trace();
+    Connection connection = connectionOf(buffered_trace.connection());
+    for (const auto& event : buffered_trace.events()) {
+      writeEvent(connection, event, output);
+    }
+    return true;
+  }
+  case envoy::data::tap::v3::TraceWrapper::TraceCase::kSocketStreamedTraceSegment: {
+    const auto& segment = trace.socket_streamed_trace_segment();
+    if (segment.has_connection()) {
+      connections_[segment.trace_id()] = connectionOf(segment.connection());
+    } else if (segment.has_event()) {
+      auto it = connections_.find(segment.trace_id());
+      if (it == connections_.end()) {
+        it = connections_.emplace(segment.trace_id(), connectionOf({})).first;
+      }
+      writeEvent(it->second, segment.event(), output);
+      if (segment.event().has_closed()) {
+        connections_.erase(it);
+      }
+    }
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+PcapngWriter::Connection
+PcapngWriter::connectionOf(const envoy::data::tap::v3::Connection& connection) {
+  Connection result;
+  const auto& local = connection.local_address().socket_address();
+  const auto& remote = connection.remote_address().socket_address();
+  const auto local_address = Network::Utility::parseInternetAddressNoThrow(local.address());
+  const auto remote_address = Network::Utility::parseInternetAddressNoThrow(remote.address());
+  if (local_address != nullptr && remote_address != nullptr &&
+      local_address->ip()->version() == remote_address->ip()->version()) {
+    if (local_address->ip()->version() == Network::Address::IpVersion::v4) {
+      const uint32_t local_ip = local_address->ip()->ipv4()->address();
+      const uint32_t remote_ip = remote_address->ip()->ipv4()->address();
+      result.local_ip_.assign(reinterpret_cast<const char*>(&local_ip), sizeof(local_ip));
+      result.remote_ip_.assign(reinterpret_cast<const char*>(&remote_ip), sizeof(remote_ip));
+    } else {
+      const absl::uint128 local_ip = local_address->ip()->ipv6()->address();
+      const absl::uint128 remote_ip = remote_address->ip()->ipv6()->address();
+      result.local_ip_.assign(reinterpret_cast<const char*>(&local_ip), sizeof(local_ip));
+      result.remote_ip_.assign(reinterpret_cast<const char*>(&remote_ip), sizeof(remote_ip));
+    }
+    result.local_port_ = local.port_value();
+    result.remote_port_ = remote.port_value();
+  } else {
+    // Pipes and mismatched address families have no IP packets to stand for them.
+    result.local_ip_.assign(4, '\0');
+    result.remote_ip_.assign(4, '\0');
+  }
+  return result;
+}
+
+void PcapngWriter::writeEvent(Connection& connection,
+                              const envoy::data::tap::v3::SocketEvent& event,
+                              std::string& output) {
+  const envoy::data::tap::v3::Body* body = dataOf(event);
+  if (body == nullptr) {
+    return;
+  }
+  const absl::string_view data =
+      body->has_as_string() ? absl::string_view(body->as_string()) : body->as_bytes();
+  const bool from_local = event.has_write();
+  const bool end_stream = from_local && event.write().end_stream();
+  if (data.empty() && !end_stream) {
+    return;
+  }
+  const uint64_t timestamp_us =
+      Protobuf::util::TimeUtil::TimestampToMicroseconds(event.timestamp());
+
+  uint32_t& seq = from_local ? connection.write_seq_ : connection.read_seq_;
+  const uint32_t ack = from_local ? connection.read_seq_ : connection.write_seq_;
+  size_t offset = 0;
+  do {
+    const absl::string_view payload = data.substr(offset, MaxPacketPayload);
+    offset += payload.size();
+    const bool fin = end_stream && offset >= data.size();
+    writePacket(connection, from_local, seq, ack, fin, payload, timestamp_us, output);
+    // The FIN takes a sequence number of its own.
+    seq += payload.size() + (fin ? 1 : 0);
+  } while (offset < data.size());
+}
+
+void PcapngWriter::writePacket(const Connection& connection, bool from_local, uint32_t seq,
+                               uint32_t ack, bool fin, absl::string_view payload,
+                               uint64_t timestamp_us, std::string& output) {
+  const bool ipv6 = connection.local_ip_.size() == 16;
+  const absl::string_view source_ip = from_local ? connection.local_ip_ : connection.remote_ip_;
+  const absl::string_view destination_ip =
+      from_local ? connection.remote_ip_ : connection.local_ip_;
+  const size_t ip_header_length = ipv6 ? Ipv6HeaderLength : Ipv4HeaderLength;
+  const size_t packet_length = ip_header_length + TcpHeaderLength + payload.size();
+  const size_t padding = (4 - packet_length % 4) % 4;
+  const uint32_t block_length = 32 + packet_length + padding;
+
+  appendLittleEndian32(output, EnhancedPacketBlockType);
+  appendLittleEndian32(output, block_length);
+  // The packets are all captured on the only interface of the section.
+  appendLittleEndian32(output, 0);
+  appendLittleEndian32(output, static_cast<uint32_t>(timestamp_us >> 32));
+  appendLittleEndian32(output, static_cast<uint32_t>(timestamp_us));
+  appendLittleEndian32(output, packet_length);
+  appendLittleEndian32(output, packet_length);
+
+  const size_t ip_header_start = output.size();
+  if (ipv6) {
+    appendNetwork32(output, 0x60000000);
+    appendNetwork16(output, TcpHeaderLength + payload.size());
+    // The next header is TCP, with a hop limit of 64.
+    output.push_back(6);
+    output.push_back(64);
+    output.append(source_ip.data(), source_ip.size());
+    output.append(destination_ip.data(), destination_ip.size());
+  } else {
+    output.push_back(0x45);
+    output.push_back(0);
+    appendNetwork16(output, packet_length);
+    appendNetwork16(output, 0);
+    // Don't fragment.
+    appendNetwork16(output, 0x4000);
+    // A TTL of 64, with TCP as the protocol.
+    output.push_back(64);
+    output.push_back(6);
+    appendNetwork16(output, 0);
+    output.append(source_ip.data(), source_ip.size());
+    output.append(destination_ip.data(), destination_ip.size());
+    const uint16_t checksum =
+        ipv4Checksum(absl::string_view(output).substr(ip_header_start, Ipv4HeaderLength));
+    output[ip_header_start + 10] = static_cast<char>(checksum >> 8);
+    output[ip_header_start + 11] = static_cast<char>(checksum & 0xFF);
+  }
+
+  appendNetwork16(output, from_local ? connection.local_port_ : connection.remote_port_);
+  appendNetwork16(output, from_local ? connection.remote_port_ : connection.local_port_);
+  appendNetwork32(output, seq);
+  appendNetwork32(output, ack);
+  // A header of 5 words without options.
+  output.push_back(0x50);
+  output.push_back(TcpFlagPsh | TcpFlagAck | (fin ? TcpFlagFin : 0));
+  appendNetwork16(output, 0xFFFF);
+  // The TCP checksum is left out, as captures of offloaded traffic commonly do.
+  appendNetwork16(output, 0);
+  appendNetwork16(output, 0);
+  output.append(payload.data(), payload.size());
+  output.append(padding, '\0');
+
+  appendLittleEndian32(output, block_length);
+}
+
+} // namespace Tap
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
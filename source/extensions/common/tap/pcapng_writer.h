@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "envoy/data/tap/v3/transport.pb.h"
+#include "envoy/data/tap/v3/wrapper.pb.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Tap {
+
+/**
+ * Converts the traces of the tap transport socket to a pcapng capture of raw IP packets. The IP and
+ * TCP headers of the packets are synthesized from the addresses of the connections, with sequence
+ * numbers that follow the data of each direction, so that the capture can be analyzed as TCP
+ * streams. The writer keeps the state of the connections of the streamed traces, so all the
+ * segments of a trace must be converted by the same writer, in order.
+ */
+class PcapngWriter {
+public:
+  /**
+   * @return the section header and interface description blocks that must start the capture.
+   */
+  static std::string header();
+
+  /**
+   * Appends the packets of the data events of a trace to the capture.
+   * @param trace supplies the trace to convert.
+   * @param output supplies the capture to append to.
+   * @return false if the trace is not a transport socket trace and was skipped.
+   */
+  bool write(const envoy::data::tap::v3::TraceWrapper& trace, std::string& output);
+
+private:
+  struct Connection {
+    // The addresses in network byte order, 4 bytes long for IPv4 and 16 bytes long for IPv6.
+    std::string local_ip_;
+    std::string remote_ip_;
+    uint16_t local_port_{0};
+    uint16_t remote_port_{0};
+    // The sequence numbers of the next bytes written and read by Envoy.
+    uint32_t write_seq_{0};
+    uint32_t read_seq_{0};
+  };
+
+  static Connection connectionOf(const envoy::data::tap::v3::Connection& connection);
+  static void writeEvent(Connection& connection, const envoy::data::tap::v3::SocketEvent& event,
+                         std::string& output);
+  static void writePacket(const Connection& connection, bool from_local, uint32_t seq,
+                          uint32_t ack, bool fin, absl::string_view payload, uint64_t timestamp_us,
+                          std::string& output);
+
+  // The connections of the streamed traces, by trace ID, until they are closed.
+  absl::flat_hash_map<uint64_t, Connection> connections_;
+};
+
+} // namespace Tap
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
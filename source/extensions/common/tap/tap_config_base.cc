@@ -9,6 +9,7 @@
 #include "source/common/config/version_converter.h"
 #include "source/common/protobuf/utility.h"
 #include "source/extensions/common/matcher/matcher.h"
+#include "source/extensions/common/tap/buffered_file_sink.h"
 
 #include "absl/container/fixed_array.h"
 
@@ -46,7 +47,7 @@ bool Utility::addBufferToProtoBytes(envoy::data::tap::v3::Body& output_body,
 }
 
 TapConfigBaseImpl::TapConfigBaseImpl(const envoy::config::tap::v3::TapConfig& proto_config,
-                                     Common::Tap::Sink* admin_streamer)
+                                     Common::Tap::Sink* admin_streamer, Api::Api* api)
     : max_buffered_rx_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
           proto_config.output_config(), max_buffered_rx_bytes, DefaultMaxBufferedBytes)),
       max_buffered_tx_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
@@ -71,6 +72,14 @@ TapConfigBaseImpl::TapConfigBaseImpl(const envoy::config::tap::v3::TapConfig& pr
         std::make_unique<FilePerTapSink>(proto_config.output_config().sinks()[0].file_per_tap());
     sink_to_use_ = sink_.get();
     break;
+  case envoy::config::tap::v3::OutputSink::OutputSinkTypeCase::kBufferedFile:
+    if (api == nullptr) {
+      throw EnvoyException("buffered file output is not supported by this tap");
+    }
+    sink_ = std::make_unique<BufferedFileSink>(
+        proto_config.output_config().sinks()[0].buffered_file(), sink_format_, *api);
+    sink_to_use_ = sink_.get();
+    break;
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
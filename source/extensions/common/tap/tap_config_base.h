@@ -2,6 +2,7 @@
 
 #include <fstream>
 
+#include "envoy/api/api.h"
 #include "envoy/buffer/buffer.h"
 #include "envoy/config/tap/v3/common.pb.h"
 #include "envoy/data/tap/v3/common.pb.h"
@@ -101,8 +102,10 @@ public:
   bool streaming() const override { return streaming_; }
 
 protected:
+  // @param api supplies the api used by the buffered file sink, which can't be configured without
+  // it.
   TapConfigBaseImpl(const envoy::config::tap::v3::TapConfig& proto_config,
-                    Common::Tap::Sink* admin_streamer);
+                    Common::Tap::Sink* admin_streamer, Api::Api* api = nullptr);
 
 private:
   // This is the default setting for both RX/TX max buffered bytes. (This means that per tap, the
@@ -65,11 +65,7 @@ using CelStatePrototype = Filters::Common::Expr::CelStatePrototype;
 Http::RequestTrailerMapPtr buildRequestTrailerMapFromPairs(const Pairs& pairs) {
   auto map = Http::RequestTrailerMapImpl::create();
   for (auto& p : pairs) {
-    // Note: because of the lack of a string_view interface for addCopy and
-    // the lack of an interface to add an entry with an empty value and return
-    // the entry, there is no efficient way to prevent either a double copy
-    // of the value or a double lookup of the entry.
-    map->addCopy(Http::LowerCaseString(std::string(p.first)), std::string(p.second));
+    map->addCopy(Http::LowerCaseString(std::string(p.first)), toAbslStringView(p.second));
   }
   return map;
 }
@@ -77,11 +73,7 @@ Http::RequestTrailerMapPtr buildRequestTrailerMapFromPairs(const Pairs& pairs) {
 Http::RequestHeaderMapPtr buildRequestHeaderMapFromPairs(const Pairs& pairs) {
   auto map = Http::RequestHeaderMapImpl::create();
   for (auto& p : pairs) {
-    // Note: because of the lack of a string_view interface for addCopy and
-    // the lack of an interface to add an entry with an empty value and return
-    // the entry, there is no efficient way to prevent either a double copy
-    // of the value or a double lookup of the entry.
-    map->addCopy(Http::LowerCaseString(std::string(p.first)), std::string(p.second));
+    map->addCopy(Http::LowerCaseString(std::string(p.first)), toAbslStringView(p.second));
   }
   return map;
 }
@@ -725,7 +717,7 @@ WasmResult Context::addHeaderMapValue(WasmHeaderMapType type, std::string_view k
     return WasmResult::BadArgument;
   }
   const Http::LowerCaseString lower_key{std::string(key)};
-  map->addCopy(lower_key, std::string(value));
+  map->addCopy(lower_key, toAbslStringView(value));
   if (type == WasmHeaderMapType::RequestHeaders && decoder_callbacks_) {
     decoder_callbacks_->clearRouteCache();
   }
@@ -788,18 +780,11 @@ WasmResult Context::setHeaderMapPairs(WasmHeaderMapType type, const Pairs& pairs
   if (!map) {
     return WasmResult::BadArgument;
   }
-  std::vector<std::string> keys;
-  map->iterate([&keys](const Http::HeaderEntry& header) -> Http::HeaderMap::Iterate {
-    keys.push_back(std::string(header.key().getStringView()));
-    return Http::HeaderMap::Iterate::Continue;
-  });
-  for (auto& k : keys) {
-    const Http::LowerCaseString lower_key{k};
-    map->remove(lower_key);
-  }
+  // Clearing the map at once avoids copying its keys to remove them one by one.
+  map->clear();
   for (auto& p : pairs) {
     const Http::LowerCaseString lower_key{std::string(p.first)};
-    map->addCopy(lower_key, std::string(p.second));
+    map->addCopy(lower_key, toAbslStringView(p.second));
   }
   if (type == WasmHeaderMapType::RequestHeaders && decoder_callbacks_) {
     decoder_callbacks_->clearRouteCache();
@@ -10,6 +10,7 @@
 #include "source/extensions/common/wasm/wasm_extension.h"
 
 #include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
 
 #define WASM_CONTEXT(_c)                                                                           \
   static_cast<Context*>(proxy_wasm::exports::ContextOrEffectiveContext(                            \
@@ -85,6 +86,18 @@ void Wasm::initializeLifecycle(Server::ServerLifecycleNotifier& lifecycle_notifi
                                       });
 }
 
+void Wasm::onLoaded(MonotonicTime start) {
+  wasm_stats_.load_ms_.recordValue(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                       time_source_.monotonicTime() - start)
+                                       .count());
+}
+
+void Wasm::onCloned(MonotonicTime start) {
+  wasm_stats_.clone_ms_.recordValue(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                        time_source_.monotonicTime() - start)
+                                        .count());
+}
+
 Wasm::Wasm(WasmConfig& config, absl::string_view vm_key, const Stats::ScopeSharedPtr& scope,
            Upstream::ClusterManager& cluster_manager, Event::Dispatcher& dispatcher)
     : WasmBase(
@@ -97,7 +110,9 @@ Wasm::Wasm(WasmConfig& config, absl::string_view vm_key, const Stats::ScopeShare
           POOL_COUNTER_PREFIX(*scope_,
                               absl::StrCat("wasm.", config.config().vm_config().runtime(), ".")),
           POOL_GAUGE_PREFIX(*scope_,
-                            absl::StrCat("wasm.", config.config().vm_config().runtime(), ".")))}) {
+                            absl::StrCat("wasm.", config.config().vm_config().runtime(), ".")),
+          POOL_HISTOGRAM_PREFIX(
+              *scope_, absl::StrCat("wasm.", config.config().vm_config().runtime(), ".")))}) {
   initializeStats();
   ENVOY_LOG(debug, "Base Wasm created {} now active", active_wasms);
 }
@@ -386,9 +401,13 @@ bool createWasm(const PluginSharedPtr& plugin, const Stats::ScopeSharedPtr& scop
 
     auto wasm_factory = wasm_extension->wasmFactory();
     auto config = plugin->wasmConfig();
+    // The factory is only called when there is no base VM for the key yet, so that reusing one is
+    // not timed as a load.
+    absl::optional<MonotonicTime> load_start;
     proxy_wasm::WasmHandleFactory proxy_wasm_factory =
-        [&config, scope, &cluster_manager, &dispatcher, &lifecycle_notifier,
-         wasm_factory](std::string_view vm_key) -> WasmHandleBaseSharedPtr {
+        [&config, scope, &cluster_manager, &dispatcher, &lifecycle_notifier, wasm_factory,
+         &load_start](std::string_view vm_key) -> WasmHandleBaseSharedPtr {
+      load_start = dispatcher.timeSource().monotonicTime();
       return wasm_factory(config, scope, cluster_manager, dispatcher, lifecycle_notifier,
                           toAbslStringView(vm_key));
     };
@@ -405,7 +424,11 @@ bool createWasm(const PluginSharedPtr& plugin, const Stats::ScopeSharedPtr& scop
       cb(nullptr);
       return false;
     }
-    cb(std::static_pointer_cast<WasmHandle>(wasm));
+    auto wasm_handle = std::static_pointer_cast<WasmHandle>(wasm);
+    if (load_start.has_value()) {
+      wasm_handle->wasm()->onLoaded(load_start.value());
+    }
+    cb(wasm_handle);
     return true;
   };
 
@@ -478,10 +501,23 @@ getOrCreateThreadLocalPlugin(const WasmHandleSharedPtr& base_wasm, const PluginS
     // we still create PluginHandle with null WasmBase.
     return std::make_shared<PluginHandle>(nullptr, plugin);
   }
-  return std::static_pointer_cast<PluginHandle>(proxy_wasm::getOrCreateThreadLocalPlugin(
-      std::static_pointer_cast<WasmHandle>(base_wasm), plugin,
-      getCloneFactory(getWasmExtension(), dispatcher, create_root_context_for_testing),
-      getPluginFactory(getWasmExtension())));
+  // As for the base VM, only the thread-local VMs which are cloned are timed.
+  absl::optional<MonotonicTime> clone_start;
+  auto wasm_clone_factory =
+      getCloneFactory(getWasmExtension(), dispatcher, create_root_context_for_testing);
+  auto plugin_handle =
+      std::static_pointer_cast<PluginHandle>(proxy_wasm::getOrCreateThreadLocalPlugin(
+          std::static_pointer_cast<WasmHandle>(base_wasm), plugin,
+          [&dispatcher, &clone_start,
+           &wasm_clone_factory](WasmHandleBaseSharedPtr wasm) -> WasmHandleBaseSharedPtr {
+            clone_start = dispatcher.timeSource().monotonicTime();
+            return wasm_clone_factory(wasm);
+          },
+          getPluginFactory(getWasmExtension())));
+  if (clone_start.has_value() && plugin_handle && plugin_handle->wasmHandle()) {
+    plugin_handle->wasmHandle()->wasm()->onCloned(clone_start.value());
+  }
+  return plugin_handle;
 }
 
 } // namespace Wasm
@@ -32,14 +32,16 @@ namespace Extensions {
 namespace Common {
 namespace Wasm {
 
-#define ALL_WASM_STATS(COUNTER, GAUGE)                                                             \
+#define ALL_WASM_STATS(COUNTER, GAUGE, HISTOGRAM)                                                  \
   COUNTER(created)                                                                                 \
-  GAUGE(active, NeverImport)
+  GAUGE(active, NeverImport)                                                                       \
+  HISTOGRAM(clone_ms, Milliseconds)                                                                \
+  HISTOGRAM(load_ms, Milliseconds)
 
 class WasmHandle;
 
 struct WasmStats {
-  ALL_WASM_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+  ALL_WASM_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
 // Wasm execution instance. Manages the Envoy side of the Wasm interface.
@@ -80,6 +82,10 @@ public:
   virtual std::string buildVersion() { return BUILD_VERSION_NUMBER; }
 
   void initializeLifecycle(Server::ServerLifecycleNotifier& lifecycle_notifier);
+  // Records the time it took to load and start the base VM since start.
+  void onLoaded(MonotonicTime start);
+  // Records the time it took to clone and start the thread-local VM since start.
+  void onCloned(MonotonicTime start);
   uint32_t nextDnsToken() {
     do {
       dns_token_++;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/buffer/buffer.h"
+
+#include "zstd.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Common {
+
+// Keeps a `Zstd` compression stream's state.
+struct ZstdContext {
+  ZstdContext(const uint32_t chunk_size);
+
+  void setInput(const Buffer::RawSlice& input_slice);
+  // Moves the output chunk to the output buffer if it is full.
+  // @return whether the output chunk was full.
+  bool updateOutput(Buffer::Instance& output_buffer);
+  void finalizeOutput(Buffer::Instance& output_buffer);
+
+  const uint32_t chunk_size_;
+  std::unique_ptr<uint8_t[]> chunk_ptr_;
+  ZSTD_inBuffer input_;
+  ZSTD_outBuffer output_;
+
+private:
+  void resetOut();
+};
+
+} // namespace Common
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
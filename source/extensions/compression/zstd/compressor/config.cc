@@ -0,0 +1,64 @@
+#include "source/extensions/compression/zstd/compressor/config.h"
+
+#include "envoy/common/exception.h"
+
+#include "source/common/config/datasource.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Compressor {
+
+namespace {
+// Default compression level.
+const uint32_t DefaultCompressionLevel = 3;
+
+// Default zstd chunk size.
+const uint32_t DefaultChunkSize = 4096;
+} // namespace
+
+ZstdCompressorFactory::ZstdCompressorFactory(
+    const envoy::extensions::compression::zstd::compressor::v3::Zstd& zstd, Api::Api& api)
+    : chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(zstd, chunk_size, DefaultChunkSize)),
+      compression_level_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(zstd, compression_level, DefaultCompressionLevel)),
+      enable_checksum_(zstd.enable_checksum()), strategy_(zstd.strategy()) {
+  if (zstd.has_dictionary()) {
+    const std::string dictionary = Config::DataSource::read(zstd.dictionary(), false, api);
+    // The decompressor finds the dictionary of a frame by the ID written in it.
+    if (ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size()) == 0) {
+      throw EnvoyException("zstd dictionary has no ID, it has to be trained with zstd --train");
+    }
+    cdict_ = ZstdCDictSharedPtr(
+        ZSTD_createCDict(dictionary.data(), dictionary.size(), compression_level_),
+        &ZSTD_freeCDict);
+    if (cdict_ == nullptr) {
+      throw EnvoyException("invalid zstd dictionary");
+    }
+  }
+}
+
+Envoy::Compression::Compressor::CompressorPtr ZstdCompressorFactory::createCompressor() {
+  return std::make_unique<ZstdCompressorImpl>(compression_level_, enable_checksum_, strategy_,
+                                              cdict_, chunk_size_);
+}
+
+Envoy::Compression::Compressor::CompressorFactoryPtr
+ZstdCompressorLibraryFactory::createCompressorFactoryFromProtoTyped(
+    const envoy::extensions::compression::zstd::compressor::v3::Zstd& proto_config,
+    Server::Configuration::FactoryContext& context) {
+  return std::make_unique<ZstdCompressorFactory>(proto_config, context.api());
+}
+
+/**
+ * Static registration for the zstd compressor library. @see NamedCompressorLibraryConfigFactory.
+ */
+REGISTER_FACTORY(ZstdCompressorLibraryFactory,
+                 Envoy::Compression::Compressor::NamedCompressorLibraryConfigFactory);
+
+} // namespace Compressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
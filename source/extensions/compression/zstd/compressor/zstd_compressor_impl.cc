@@ -0,0 +1,78 @@
+#include "source/extensions/compression/zstd/compressor/zstd_compressor_impl.h"
+
+#include "source/common/buffer/buffer_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Compressor {
+
+ZstdCompressorImpl::ZstdCompressorImpl(const uint32_t compression_level,
+                                       const bool enable_checksum, const uint32_t strategy,
+                                       const ZstdCDictSharedPtr& cdict, const uint32_t chunk_size)
+    : chunk_size_{chunk_size}, cdict_(cdict), cctx_(ZSTD_createCCtx(), &ZSTD_freeCCtx) {
+  RELEASE_ASSERT(cctx_ != nullptr, "");
+
+  size_t result;
+  if (cdict_ != nullptr) {
+    result = ZSTD_CCtx_refCDict(cctx_.get(), cdict_.get());
+  } else {
+    RELEASE_ASSERT(static_cast<int>(compression_level) <= ZSTD_maxCLevel(), "");
+    result = ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_compressionLevel, compression_level);
+  }
+  RELEASE_ASSERT(!ZSTD_isError(result), "");
+
+  result = ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_checksumFlag, enable_checksum);
+  RELEASE_ASSERT(!ZSTD_isError(result), "");
+
+  RELEASE_ASSERT(strategy <= ZSTD_btultra2, "");
+  result = ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_strategy, strategy);
+  RELEASE_ASSERT(!ZSTD_isError(result), "");
+}
+
+void ZstdCompressorImpl::compress(Buffer::Instance& buffer,
+                                  Envoy::Compression::Compressor::State state) {
+  Common::ZstdContext ctx(chunk_size_);
+
+  Buffer::OwnedImpl accumulation_buffer;
+  for (const Buffer::RawSlice& input_slice : buffer.getRawSlices()) {
+    ctx.setInput(input_slice);
+
+    while (ctx.input_.pos < ctx.input_.size) {
+      process(ctx, accumulation_buffer, ZSTD_e_continue);
+    }
+
+    buffer.drain(input_slice.len_);
+  }
+
+  ASSERT(buffer.length() == 0);
+  buffer.move(accumulation_buffer);
+
+  // The encoder buffers the input it consumes, and may not fit all of it in the output chunk when
+  // it's flushed. And in case of the `Finish` operation the encoder closes the frame, possibly
+  // with its checksum. Thus keep processing until the encoder's output is fully depleted.
+  ctx.setInput({nullptr, 0});
+  size_t remaining;
+  do {
+    remaining = process(ctx, buffer,
+                        state == Envoy::Compression::Compressor::State::Finish ? ZSTD_e_end
+                                                                               : ZSTD_e_flush);
+  } while (remaining > 0);
+
+  ctx.finalizeOutput(buffer);
+}
+
+size_t ZstdCompressorImpl::process(Common::ZstdContext& ctx, Buffer::Instance& output_buffer,
+                                   const ZSTD_EndDirective mode) {
+  const size_t result = ZSTD_compressStream2(cctx_.get(), &ctx.output_, &ctx.input_, mode);
+  RELEASE_ASSERT(!ZSTD_isError(result), "unable to compress");
+  ctx.updateOutput(output_buffer);
+  return result;
+}
+
+} // namespace Compressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/compression/compressor/compressor.h"
+
+#include "source/extensions/compression/zstd/common/base.h"
+
+#include "zstd.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Compressor {
+
+// A digested dictionary, shared by the compressors of a factory.
+using ZstdCDictSharedPtr = std::shared_ptr<ZSTD_CDict>;
+
+/**
+ * Implementation of compressor's interface.
+ */
+class ZstdCompressorImpl : public Envoy::Compression::Compressor::Compressor, NonCopyable {
+public:
+  /**
+   * Constructor.
+   * @param compression_level sets compression level. The higher the level, the slower the
+   * compression. Ignored if a dictionary is set, since it is digested for a level.
+   * @param enable_checksum if true, a checksum of the content is written at the end of each frame.
+   * @param strategy sets the match finding strategy, 0 picking it by the compression level.
+   * @see ZSTD_c_strategy in zstd manual.
+   * @param cdict supplies the dictionary to compress with, if not nullptr.
+   * @param chunk_size amount of memory reserved for the compressor output.
+   */
+  ZstdCompressorImpl(const uint32_t compression_level, const bool enable_checksum,
+                     const uint32_t strategy, const ZstdCDictSharedPtr& cdict,
+                     const uint32_t chunk_size);
+
+  // Compression::Compressor::Compressor
+  void compress(Buffer::Instance& buffer, Envoy::Compression::Compressor::State state) override;
+
+private:
+  // @return the number of bytes the encoder still has to flush.
+  size_t process(Common::ZstdContext& ctx, Buffer::Instance& output_buffer,
+                 const ZSTD_EndDirective mode);
+
+  const uint32_t chunk_size_;
+  // Outlives the context, which references it.
+  const ZstdCDictSharedPtr cdict_;
+  std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx_;
+};
+
+} // namespace Compressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
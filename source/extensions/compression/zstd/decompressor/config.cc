@@ -0,0 +1,67 @@
+#include "source/extensions/compression/zstd/decompressor/config.h"
+
+#include "envoy/common/exception.h"
+
+#include "source/common/config/datasource.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Decompressor {
+
+namespace {
+
+const uint32_t DefaultChunkSize = 4096;
+
+} // namespace
+
+ZstdDecompressorFactory::ZstdDecompressorFactory(
+    const envoy::extensions::compression::zstd::decompressor::v3::Zstd& zstd, Stats::Scope& scope,
+    Api::Api& api)
+    : scope_(scope),
+      chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(zstd, chunk_size, DefaultChunkSize)),
+      ddicts_(loadDictionaries(zstd, api)) {}
+
+ZstdDDictMapConstSharedPtr ZstdDecompressorFactory::loadDictionaries(
+    const envoy::extensions::compression::zstd::decompressor::v3::Zstd& zstd, Api::Api& api) {
+  auto ddicts = std::make_shared<ZstdDDictMap>();
+  for (const auto& source : zstd.dictionaries()) {
+    const std::string dictionary = Config::DataSource::read(source, false, api);
+    const uint32_t dict_id = ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+    if (dict_id == 0) {
+      throw EnvoyException("zstd dictionary has no ID, it has to be trained with zstd --train");
+    }
+    ZstdDDictPtr ddict(ZSTD_createDDict(dictionary.data(), dictionary.size()), &ZSTD_freeDDict);
+    if (ddict == nullptr) {
+      throw EnvoyException("invalid zstd dictionary");
+    }
+    if (!ddicts->emplace(dict_id, std::move(ddict)).second) {
+      throw EnvoyException(fmt::format("duplicate zstd dictionary ID {}", dict_id));
+    }
+  }
+  return ddicts;
+}
+
+Envoy::Compression::Decompressor::DecompressorPtr
+ZstdDecompressorFactory::createDecompressor(const std::string& stats_prefix) {
+  return std::make_unique<ZstdDecompressorImpl>(scope_, stats_prefix, ddicts_, chunk_size_);
+}
+
+Envoy::Compression::Decompressor::DecompressorFactoryPtr
+ZstdDecompressorLibraryFactory::createDecompressorFactoryFromProtoTyped(
+    const envoy::extensions::compression::zstd::decompressor::v3::Zstd& proto_config,
+    Server::Configuration::FactoryContext& context) {
+  return std::make_unique<ZstdDecompressorFactory>(proto_config, context.scope(), context.api());
+}
+
+/**
+ * Static registration for the zstd decompressor. @see NamedDecompressorLibraryConfigFactory.
+ */
+REGISTER_FACTORY(ZstdDecompressorLibraryFactory,
+                 Envoy::Compression::Decompressor::NamedDecompressorLibraryConfigFactory);
+} // namespace Decompressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
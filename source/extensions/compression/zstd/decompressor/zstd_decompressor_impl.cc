@@ -0,0 +1,113 @@
+#include "source/extensions/compression/zstd/decompressor/zstd_decompressor_impl.h"
+
+#include "zstd_errors.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Decompressor {
+
+ZstdDecompressorImpl::ZstdDecompressorImpl(Stats::Scope& scope, const std::string& stats_prefix,
+                                           const ZstdDDictMapConstSharedPtr& ddicts,
+                                           const uint32_t chunk_size)
+    : chunk_size_{chunk_size}, ddicts_(ddicts), dctx_(ZSTD_createDCtx(), &ZSTD_freeDCtx),
+      stats_(generateStats(stats_prefix, scope)) {
+  RELEASE_ASSERT(dctx_ != nullptr, "");
+}
+
+void ZstdDecompressorImpl::decompress(const Buffer::Instance& input_buffer,
+                                      Buffer::Instance& output_buffer) {
+  Common::ZstdContext ctx(chunk_size_);
+
+  for (const Buffer::RawSlice& input_slice : input_buffer.getRawSlices()) {
+    ctx.setInput(input_slice);
+
+    // Even though the input has been fully consumed by the decoder it still can be unfolded into
+    // output not fitting the output chunk. Thus keep processing until the decoder leaves room in
+    // the output chunk.
+    bool output_full;
+    do {
+      if (!process(ctx, output_buffer, output_full)) {
+        ctx.finalizeOutput(output_buffer);
+        return;
+      }
+    } while (ctx.input_.pos < ctx.input_.size || output_full);
+  }
+
+  ctx.finalizeOutput(output_buffer);
+}
+
+bool ZstdDecompressorImpl::process(Common::ZstdContext& ctx, Buffer::Instance& output_buffer,
+                                   bool& output_full) {
+  output_full = false;
+  if (frame_start_ && ctx.input_.pos < ctx.input_.size) {
+    if (!selectDictionary(ctx)) {
+      return false;
+    }
+    frame_start_ = false;
+  }
+
+  const size_t result = ZSTD_decompressStream(dctx_.get(), &ctx.output_, &ctx.input_);
+  if (ZSTD_isError(result)) {
+    onError(result);
+    return false;
+  }
+  // The frame is fully decoded and flushed, so the next input starts another frame.
+  frame_start_ = result == 0;
+
+  output_full = ctx.updateOutput(output_buffer);
+  return true;
+}
+
+bool ZstdDecompressorImpl::selectDictionary(Common::ZstdContext& ctx) {
+  if (ddicts_->empty()) {
+    return true;
+  }
+
+  // The ID is 0 if the frame was compressed without a dictionary, or if its header is split
+  // across the slices of the input, in which case the decoder fails over on a wrong dictionary.
+  const uint32_t dict_id =
+      ZSTD_getDictID_fromFrame(static_cast<const uint8_t*>(ctx.input_.src) + ctx.input_.pos,
+                               ctx.input_.size - ctx.input_.pos);
+  const ZSTD_DDict* ddict = nullptr;
+  if (dict_id != 0) {
+    const auto it = ddicts_->find(dict_id);
+    if (it == ddicts_->end()) {
+      stats_.zstd_dictionary_error_.inc();
+      return false;
+    }
+    ddict = it->second.get();
+  }
+
+  const size_t result = ZSTD_DCtx_refDDict(dctx_.get(), ddict);
+  if (ZSTD_isError(result)) {
+    onError(result);
+    return false;
+  }
+  return true;
+}
+
+void ZstdDecompressorImpl::onError(size_t result) {
+  switch (ZSTD_getErrorCode(result)) {
+  case ZSTD_error_dictionary_corrupted:
+  case ZSTD_error_dictionary_wrong:
+    stats_.zstd_dictionary_error_.inc();
+    break;
+  case ZSTD_error_checksum_wrong:
+    stats_.zstd_checksum_wrong_error_.inc();
+    break;
+  case ZSTD_error_memory_allocation:
+    stats_.zstd_memory_error_.inc();
+    break;
+  default:
+    stats_.zstd_generic_error_.inc();
+    break;
+  }
+}
+
+} // namespace Decompressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/compression/decompressor/decompressor.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/extensions/compression/zstd/common/base.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "zstd.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Decompressor {
+
+// The digested dictionaries by ID, shared by the decompressors of a factory.
+using ZstdDDictPtr = std::unique_ptr<ZSTD_DDict, decltype(&ZSTD_freeDDict)>;
+using ZstdDDictMap = absl::flat_hash_map<uint32_t, ZstdDDictPtr>;
+using ZstdDDictMapConstSharedPtr = std::shared_ptr<const ZstdDDictMap>;
+
+/**
+ * All zstd decompressor stats. @see stats_macros.h
+ */
+#define ALL_ZSTD_DECOMPRESSOR_STATS(COUNTER)                                                       \
+  COUNTER(zstd_generic_error)                                                                      \
+  COUNTER(zstd_dictionary_error)                                                                   \
+  COUNTER(zstd_checksum_wrong_error)                                                               \
+  COUNTER(zstd_memory_error)
+
+/**
+ * Struct definition for zstd decompressor stats. @see stats_macros.h
+ */
+struct ZstdDecompressorStats {
+  ALL_ZSTD_DECOMPRESSOR_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Implementation of decompressor's interface.
+ */
+class ZstdDecompressorImpl : public Envoy::Compression::Decompressor::Decompressor, NonCopyable {
+public:
+  /**
+   * Constructor.
+   * @param ddicts supplies the dictionaries the content may have been compressed with.
+   * @param chunk_size amount of memory reserved for the decompressor output.
+   */
+  ZstdDecompressorImpl(Stats::Scope& scope, const std::string& stats_prefix,
+                       const ZstdDDictMapConstSharedPtr& ddicts, const uint32_t chunk_size);
+
+  // Envoy::Compression::Decompressor::Decompressor
+  void decompress(const Buffer::Instance& input_buffer, Buffer::Instance& output_buffer) override;
+
+private:
+  static ZstdDecompressorStats generateStats(const std::string& prefix, Stats::Scope& scope) {
+    return ZstdDecompressorStats{ALL_ZSTD_DECOMPRESSOR_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
+  }
+
+  // @param output_full set to whether the output chunk was filled, in which case the decoder may
+  //        have more output for the input it consumed.
+  // @return false on an error.
+  bool process(Common::ZstdContext& ctx, Buffer::Instance& output_buffer, bool& output_full);
+  // Picks the dictionary of the frame starting at the input.
+  bool selectDictionary(Common::ZstdContext& ctx);
+  void onError(size_t result);
+
+  const uint32_t chunk_size_;
+  // Outlive the context, which references them.
+  const ZstdDDictMapConstSharedPtr ddicts_;
+  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dctx_;
+  const ZstdDecompressorStats stats_;
+  bool frame_start_{true};
+};
+
+} // namespace Decompressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
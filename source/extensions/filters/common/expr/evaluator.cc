@@ -1,5 +1,7 @@
 #include "source/extensions/filters/common/expr/evaluator.h"
 
+#include <array>
+
 #include "envoy/common/exception.h"
 
 #include "eval/public/builtin_func_registrar.h"
@@ -11,23 +13,123 @@ namespace Filters {
 namespace Common {
 namespace Expr {
 
+namespace {
+
+// The root context attributes, in the order of their bits in ContextAttributes.
+enum RootAttribute : size_t {
+  RequestRoot,
+  ResponseRoot,
+  ConnectionRoot,
+  UpstreamRoot,
+  SourceRoot,
+  DestinationRoot,
+  MetadataRoot,
+  FilterStateRoot,
+  RootAttributeCount
+};
+
+static_assert(RootAttributeCount == ContextAttributes().size(),
+              "a bit of ContextAttributes per root attribute");
+
+constexpr std::array<absl::string_view, RootAttributeCount> RootAttributeNames = {
+    Request, Response, Connection, Upstream, Source, Destination, Metadata, FilterState};
+
+void collectAttributes(const google::api::expr::v1alpha1::Expr& expr,
+                       ContextAttributes& attributes) {
+  using google::api::expr::v1alpha1::Expr;
+  switch (expr.expr_kind_case()) {
+  case Expr::kIdentExpr: {
+    // A qualified identifier references the attribute of its first name.
+    const absl::string_view name = expr.ident_expr().name();
+    const absl::string_view root = name.substr(0, name.find('.'));
+    for (size_t i = 0; i < RootAttributeCount; i++) {
+      if (root == RootAttributeNames[i]) {
+        attributes.set(i);
+      }
+    }
+    break;
+  }
+  case Expr::kSelectExpr:
+    collectAttributes(expr.select_expr().operand(), attributes);
+    break;
+  case Expr::kCallExpr:
+    if (expr.call_expr().has_target()) {
+      collectAttributes(expr.call_expr().target(), attributes);
+    }
+    for (const Expr& arg : expr.call_expr().args()) {
+      collectAttributes(arg, attributes);
+    }
+    break;
+  case Expr::kListExpr:
+    for (const Expr& element : expr.list_expr().elements()) {
+      collectAttributes(element, attributes);
+    }
+    break;
+  case Expr::kStructExpr:
+    for (const auto& entry : expr.struct_expr().entries()) {
+      if (entry.has_map_key()) {
+        collectAttributes(entry.map_key(), attributes);
+      }
+      collectAttributes(entry.value(), attributes);
+    }
+    break;
+  case Expr::kComprehensionExpr: {
+    const auto& comprehension = expr.comprehension_expr();
+    collectAttributes(comprehension.iter_range(), attributes);
+    collectAttributes(comprehension.accu_init(), attributes);
+    collectAttributes(comprehension.loop_condition(), attributes);
+    collectAttributes(comprehension.loop_step(), attributes);
+    collectAttributes(comprehension.result(), attributes);
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+} // namespace
+
+ContextAttributes referencedAttributes(const google::api::expr::v1alpha1::Expr& expr) {
+  ContextAttributes attributes;
+  collectAttributes(expr, attributes);
+  return attributes;
+}
+
 ActivationPtr createActivation(Protobuf::Arena& arena, const StreamInfo::StreamInfo& info,
                                const Http::RequestHeaderMap* request_headers,
                                const Http::ResponseHeaderMap* response_headers,
-                               const Http::ResponseTrailerMap* response_trailers) {
+                               const Http::ResponseTrailerMap* response_trailers,
+                               const ContextAttributes& attributes) {
   auto activation = std::make_unique<Activation>();
-  activation->InsertValueProducer(Request,
-                                  std::make_unique<RequestWrapper>(arena, request_headers, info));
-  activation->InsertValueProducer(Response, std::make_unique<ResponseWrapper>(
-                                                arena, response_headers, response_trailers, info));
-  activation->InsertValueProducer(Connection, std::make_unique<ConnectionWrapper>(info));
-  activation->InsertValueProducer(Upstream, std::make_unique<UpstreamWrapper>(info));
-  activation->InsertValueProducer(Source, std::make_unique<PeerWrapper>(info, false));
-  activation->InsertValueProducer(Destination, std::make_unique<PeerWrapper>(info, true));
-  activation->InsertValueProducer(Metadata,
-                                  std::make_unique<MetadataProducer>(info.dynamicMetadata()));
-  activation->InsertValueProducer(FilterState,
-                                  std::make_unique<FilterStateWrapper>(info.filterState()));
+  if (attributes[RequestRoot]) {
+    activation->InsertValueProducer(Request,
+                                    std::make_unique<RequestWrapper>(arena, request_headers, info));
+  }
+  if (attributes[ResponseRoot]) {
+    activation->InsertValueProducer(Response,
+                                    std::make_unique<ResponseWrapper>(arena, response_headers,
+                                                                      response_trailers, info));
+  }
+  if (attributes[ConnectionRoot]) {
+    activation->InsertValueProducer(Connection, std::make_unique<ConnectionWrapper>(info));
+  }
+  if (attributes[UpstreamRoot]) {
+    activation->InsertValueProducer(Upstream, std::make_unique<UpstreamWrapper>(info));
+  }
+  if (attributes[SourceRoot]) {
+    activation->InsertValueProducer(Source, std::make_unique<PeerWrapper>(info, false));
+  }
+  if (attributes[DestinationRoot]) {
+    activation->InsertValueProducer(Destination, std::make_unique<PeerWrapper>(info, true));
+  }
+  if (attributes[MetadataRoot]) {
+    activation->InsertValueProducer(Metadata,
+                                    std::make_unique<MetadataProducer>(info.dynamicMetadata()));
+  }
+  if (attributes[FilterStateRoot]) {
+    activation->InsertValueProducer(FilterState,
+                                    std::make_unique<FilterStateWrapper>(info.filterState()));
+  }
   return activation;
 }
 
@@ -72,9 +174,10 @@ absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena& arena
                                   const StreamInfo::StreamInfo& info,
                                   const Http::RequestHeaderMap* request_headers,
                                   const Http::ResponseHeaderMap* response_headers,
-                                  const Http::ResponseTrailerMap* response_trailers) {
-  auto activation =
-      createActivation(arena, info, request_headers, response_headers, response_trailers);
+                                  const Http::ResponseTrailerMap* response_trailers,
+                                  const ContextAttributes& attributes) {
+  auto activation = createActivation(arena, info, request_headers, response_headers,
+                                     response_trailers, attributes);
   auto eval_status = expr.Evaluate(*activation, &arena);
   if (!eval_status.ok()) {
     return {};
@@ -84,9 +187,9 @@ absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena& arena
 }
 
 bool matches(const Expression& expr, const StreamInfo::StreamInfo& info,
-             const Http::RequestHeaderMap& headers) {
+             const Http::RequestHeaderMap& headers, const ContextAttributes& attributes) {
   Protobuf::Arena arena;
-  auto eval_status = Expr::evaluate(expr, arena, info, &headers, nullptr, nullptr);
+  auto eval_status = Expr::evaluate(expr, arena, info, &headers, nullptr, nullptr, attributes);
   if (!eval_status.has_value()) {
     return false;
   }
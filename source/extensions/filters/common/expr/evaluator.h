@@ -1,5 +1,7 @@
 #pragma once
 
+#include <bitset>
+
 #include "envoy/stream_info/stream_info.h"
 
 #include "source/common/http/headers.h"
@@ -22,12 +24,25 @@ using BuilderPtr = std::unique_ptr<Builder>;
 using Expression = google::api::expr::runtime::CelExpression;
 using ExpressionPtr = std::unique_ptr<Expression>;
 
-// Creates an activation providing the common context attributes.
+// A set of the root context attributes, such as "request" or "connection", with a bit per root
+// attribute.
+using ContextAttributes = std::bitset<8>;
+
+// The set of all the root context attributes.
+const ContextAttributes AllContextAttributes = ContextAttributes().set();
+
+// Collects the root context attributes an expression references, so that the activations
+// evaluating it only provide these.
+ContextAttributes referencedAttributes(const google::api::expr::v1alpha1::Expr& expr);
+
+// Creates an activation providing the common context attributes, or only the given root
+// attributes of them.
 // The activation lazily creates wrappers during an evaluation using the evaluation arena.
 ActivationPtr createActivation(Protobuf::Arena& arena, const StreamInfo::StreamInfo& info,
                                const Http::RequestHeaderMap* request_headers,
                                const Http::ResponseHeaderMap* response_headers,
-                               const Http::ResponseTrailerMap* response_trailers);
+                               const Http::ResponseTrailerMap* response_trailers,
+                               const ContextAttributes& attributes = AllContextAttributes);
 
 // Creates an expression builder. The optional arena is used to enable constant folding
 // for intermediate evaluation results.
@@ -39,17 +54,20 @@ BuilderPtr createBuilder(Protobuf::Arena* arena);
 ExpressionPtr createExpression(Builder& builder, const google::api::expr::v1alpha1::Expr& expr);
 
 // Evaluates an expression for a request. The arena is used to hold intermediate computational
-// results and potentially the final value.
+// results and potentially the final value. The attributes supply the root context attributes the
+// expression references.
 absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena& arena,
                                   const StreamInfo::StreamInfo& info,
                                   const Http::RequestHeaderMap* request_headers,
                                   const Http::ResponseHeaderMap* response_headers,
-                                  const Http::ResponseTrailerMap* response_trailers);
+                                  const Http::ResponseTrailerMap* response_trailers,
+                                  const ContextAttributes& attributes = AllContextAttributes);
 
 // Evaluates an expression and returns true if the expression evaluates to "true".
 // Returns false if the expression fails to evaluate.
 bool matches(const Expression& expr, const StreamInfo::StreamInfo& info,
-             const Http::RequestHeaderMap& headers);
+             const Http::RequestHeaderMap& headers,
+             const ContextAttributes& attributes = AllContextAttributes);
 
 // Returns a string for a CelValue.
 std::string print(CelValue value);
@@ -1,5 +1,8 @@
 #include "source/extensions/filters/common/local_ratelimit/local_ratelimit_impl.h"
 
+#include <functional>
+#include <thread>
+
 #include "source/common/protobuf/utility.h"
 
 namespace Envoy {
@@ -7,16 +10,26 @@ namespace Extensions {
 namespace Filters {
 namespace Common {
 namespace LocalRateLimit {
+namespace {
+
+// @return the tokens the shard of the index holds at most, the tokens of the bucket being split as
+// evenly as possible between its shards.
+uint32_t maxTokensOfShard(uint32_t max_tokens, size_t shards, size_t index) {
+  return max_tokens / shards + (index < max_tokens % shards ? 1 : 0);
+}
+
+} // namespace
 
 LocalRateLimiterImpl::LocalRateLimiterImpl(
     const std::chrono::milliseconds fill_interval, const uint32_t max_tokens,
     const uint32_t tokens_per_fill, Event::Dispatcher& dispatcher,
     const Protobuf::RepeatedPtrField<
-        envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors)
+        envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors,
+    const uint32_t shards)
     : fill_timer_(fill_interval > std::chrono::milliseconds(0)
                       ? dispatcher.createTimer([this] { onFillTimer(); })
                       : nullptr),
-      time_source_(dispatcher.timeSource()) {
+      time_source_(dispatcher.timeSource()), tokens_(std::max<uint32_t>(shards, 1)) {
   if (fill_timer_ && fill_interval < std::chrono::milliseconds(50)) {
     throw EnvoyException("local rate limit token bucket fill timer must be >= 50ms");
   }
@@ -24,7 +37,9 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
   token_bucket_.max_tokens_ = max_tokens;
   token_bucket_.tokens_per_fill_ = tokens_per_fill;
   token_bucket_.fill_interval_ = absl::FromChrono(fill_interval);
-  tokens_.tokens_ = max_tokens;
+  for (size_t i = 0; i < tokens_.shards_.size(); i++) {
+    tokens_.shards_[i].tokens_ = maxTokensOfShard(max_tokens, tokens_.shards_.size(), i);
+  }
 
   if (fill_timer_) {
     fill_timer_->enableTimer(fill_interval);
@@ -45,10 +60,29 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
     token_bucket.max_tokens_ = descriptor.token_bucket().max_tokens();
     token_bucket.tokens_per_fill_ =
         PROTOBUF_GET_WRAPPED_OR_DEFAULT(descriptor.token_bucket(), tokens_per_fill, 1);
+    if (descriptor.max_value_buckets() > 0) {
+      auto value_buckets = std::make_unique<ValueBuckets>();
+      for (const auto& entry : new_descriptor.entries_) {
+        value_buckets->keys_.push_back(entry.key_);
+      }
+      value_buckets->token_bucket_ = token_bucket;
+      value_buckets->max_buckets_ = descriptor.max_value_buckets();
+      for (const ValueBucketsPtr& other : value_buckets_) {
+        if (other->keys_ == value_buckets->keys_) {
+          throw EnvoyException(absl::StrCat("duplicate descriptor in the local rate descriptor: ",
+                                            value_buckets->toString()));
+        }
+      }
+      value_buckets_.push_back(std::move(value_buckets));
+      continue;
+    }
     new_descriptor.token_bucket_ = token_bucket;
 
-    auto token_state = std::make_unique<TokenState>();
-    token_state->tokens_ = token_bucket.max_tokens_;
+    auto token_state = std::make_unique<TokenState>(tokens_.shards_.size());
+    for (size_t i = 0; i < token_state->shards_.size(); i++) {
+      token_state->shards_[i].tokens_ =
+          maxTokensOfShard(token_bucket.max_tokens_, token_state->shards_.size(), i);
+    }
     token_state->fill_time_ = time_source_.monotonicTime();
     new_descriptor.token_state_ = std::move(token_state);
 
@@ -74,20 +108,40 @@ void LocalRateLimiterImpl::onFillTimer() {
 
 void LocalRateLimiterImpl::onFillTimerHelper(const TokenState& tokens,
                                              const RateLimit::TokenBucket& bucket) {
+  const size_t shards = tokens.shards_.size();
+  uint32_t remaining = bucket.tokens_per_fill_;
+  // Each shard first gets its share of the tokens of the fill, then the tokens the full shards
+  // couldn't take go to the shards which still have room for them.
+  for (size_t i = 0; i < shards && remaining > 0; i++) {
+    remaining -= addTokens(tokens.shards_[i], remaining / (shards - i),
+                           maxTokensOfShard(bucket.max_tokens_, shards, i));
+  }
+  for (size_t i = 0; i < shards && remaining > 0; i++) {
+    remaining -=
+        addTokens(tokens.shards_[i], remaining, maxTokensOfShard(bucket.max_tokens_, shards, i));
+  }
+}
+
+uint32_t LocalRateLimiterImpl::addTokens(const TokenShard& shard, uint32_t tokens,
+                                         uint32_t max_tokens) {
+  if (tokens == 0) {
+    return 0;
+  }
   // Relaxed consistency is used for all operations because we don't care about ordering, just the
   // final atomic correctness.
-  uint32_t expected_tokens = tokens.tokens_.load(std::memory_order_relaxed);
+  uint32_t expected_tokens = shard.tokens_.load(std::memory_order_relaxed);
   uint32_t new_tokens_value;
   do {
     // expected_tokens is either initialized above or reloaded during the CAS failure below.
-    new_tokens_value = std::min(bucket.max_tokens_, expected_tokens + bucket.tokens_per_fill_);
+    new_tokens_value = std::min(max_tokens, expected_tokens + tokens);
 
     // Testing hook.
     synchronizer_.syncPoint("on_fill_timer_pre_cas");
 
     // Loop while the weak CAS fails trying to update the tokens value.
-  } while (!tokens.tokens_.compare_exchange_weak(expected_tokens, new_tokens_value,
-                                                 std::memory_order_relaxed));
+  } while (!shard.tokens_.compare_exchange_weak(expected_tokens, new_tokens_value,
+                                                std::memory_order_relaxed));
+  return new_tokens_value - std::min(expected_tokens, new_tokens_value);
 }
 
 void LocalRateLimiterImpl::onFillTimerDescriptorHelper() {
@@ -103,9 +157,25 @@ void LocalRateLimiterImpl::onFillTimerDescriptorHelper() {
 }
 
 bool LocalRateLimiterImpl::requestAllowedHelper(const TokenState& tokens) const {
+  const size_t shards = tokens.shards_.size();
+  if (shards == 1) {
+    return takeToken(tokens.shards_[0]);
+  }
+  // The thread takes a token from another shard when its own is empty, so that the tokens of the
+  // bucket are shared by all the threads as without shards.
+  const size_t first = std::hash<std::thread::id>()(std::this_thread::get_id()) % shards;
+  for (size_t i = 0; i < shards; i++) {
+    if (takeToken(tokens.shards_[(first + i) % shards])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool LocalRateLimiterImpl::takeToken(const TokenShard& shard) const {
   // Relaxed consistency is used for all operations because we don't care about ordering, just the
   // final atomic correctness.
-  uint32_t expected_tokens = tokens.tokens_.load(std::memory_order_relaxed);
+  uint32_t expected_tokens = shard.tokens_.load(std::memory_order_relaxed);
   do {
     // expected_tokens is either initialized above or reloaded during the CAS failure below.
     if (expected_tokens == 0) {
@@ -116,21 +186,83 @@ bool LocalRateLimiterImpl::requestAllowedHelper(const TokenState& tokens) const
     synchronizer_.syncPoint("allowed_pre_cas");
 
     // Loop while the weak CAS fails trying to subtract 1 from expected.
-  } while (!tokens.tokens_.compare_exchange_weak(expected_tokens, expected_tokens - 1,
-                                                 std::memory_order_relaxed));
+  } while (!shard.tokens_.compare_exchange_weak(expected_tokens, expected_tokens - 1,
+                                                std::memory_order_relaxed));
 
   // We successfully decremented the counter by 1.
   return true;
 }
 
+bool LocalRateLimiterImpl::matchesKeys(const ValueBuckets& value_buckets,
+                                       const RateLimit::LocalDescriptor& request_descriptor) {
+  if (request_descriptor.entries_.size() != value_buckets.keys_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < value_buckets.keys_.size(); i++) {
+    if (request_descriptor.entries_[i].key_ != value_buckets.keys_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool LocalRateLimiterImpl::requestAllowedHelper(
+    ValueBuckets& value_buckets, const RateLimit::LocalDescriptor& request_descriptor) const {
+  std::vector<std::string> values;
+  values.reserve(request_descriptor.entries_.size());
+  for (const auto& entry : request_descriptor.entries_) {
+    values.push_back(entry.value_);
+  }
+  const MonotonicTime now = time_source_.monotonicTime();
+  const auto fill_interval = absl::ToChronoMilliseconds(value_buckets.token_bucket_.fill_interval_);
+
+  absl::MutexLock lock(&value_buckets.mutex_);
+  auto [it, inserted] = value_buckets.buckets_.try_emplace(values);
+  ValueBucket& bucket = it->second;
+  if (inserted) {
+    value_buckets.lru_.push_front(std::move(values));
+    bucket.lru_position_ = value_buckets.lru_.begin();
+    bucket.tokens_ = value_buckets.token_bucket_.max_tokens_;
+    bucket.fill_time_ = now;
+    if (value_buckets.buckets_.size() > value_buckets.max_buckets_) {
+      value_buckets.buckets_.erase(value_buckets.lru_.back());
+      value_buckets.lru_.pop_back();
+    }
+  } else {
+    value_buckets.lru_.splice(value_buckets.lru_.begin(), value_buckets.lru_,
+                              bucket.lru_position_);
+    if (fill_interval.count() > 0) {
+      // The fills the bucket missed since it was last filled.
+      const int64_t fills = (now - bucket.fill_time_) / fill_interval;
+      if (fills > 0) {
+        const uint64_t tokens =
+            bucket.tokens_ + fills * uint64_t(value_buckets.token_bucket_.tokens_per_fill_);
+        bucket.tokens_ = std::min<uint64_t>(value_buckets.token_bucket_.max_tokens_, tokens);
+        bucket.fill_time_ += fills * fill_interval;
+      }
+    }
+  }
+
+  if (bucket.tokens_ == 0) {
+    return false;
+  }
+  bucket.tokens_--;
+  return true;
+}
+
 bool LocalRateLimiterImpl::requestAllowed(
     absl::Span<const RateLimit::LocalDescriptor> request_descriptors) const {
-  if (!descriptors_.empty() && !request_descriptors.empty()) {
+  if ((!descriptors_.empty() || !value_buckets_.empty()) && !request_descriptors.empty()) {
     for (const auto& request_descriptor : request_descriptors) {
       auto it = descriptors_.find(request_descriptor);
       if (it != descriptors_.end()) {
         return requestAllowedHelper(*it->token_state_);
       }
+      for (const ValueBucketsPtr& value_buckets : value_buckets_) {
+        if (matchesKeys(*value_buckets, request_descriptor)) {
+          return requestAllowedHelper(*value_buckets, request_descriptor);
+        }
+      }
     }
   }
   return requestAllowedHelper(tokens_);
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/timer.h"
@@ -10,6 +14,9 @@
 #include "source/common/common/thread_synchronizer.h"
 #include "source/common/protobuf/protobuf.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Filters {
@@ -22,14 +29,23 @@ public:
       const std::chrono::milliseconds fill_interval, const uint32_t max_tokens,
       const uint32_t tokens_per_fill, Event::Dispatcher& dispatcher,
       const Protobuf::RepeatedPtrField<
-          envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors);
+          envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors,
+      const uint32_t shards = 1);
   ~LocalRateLimiterImpl();
 
   bool requestAllowed(absl::Span<const RateLimit::LocalDescriptor> request_descriptors) const;
 
 private:
+  // A shard of the tokens of a bucket, on a cache line of its own so that the threads taking
+  // tokens from different shards don't contend.
+  struct alignas(64) TokenShard {
+    mutable std::atomic<uint32_t> tokens_{0};
+  };
   struct TokenState {
-    mutable std::atomic<uint32_t> tokens_;
+    explicit TokenState(uint32_t shards) : shards_(shards) {}
+
+    // Each thread takes its tokens from the shard of its thread ID first.
+    std::vector<TokenShard> shards_;
     MonotonicTime fill_time_;
   };
   struct LocalDescriptorImpl : public RateLimit::LocalDescriptor {
@@ -58,16 +74,46 @@ private:
     }
   };
 
+  // The bucket of one set of the values of a descriptor with value buckets.
+  struct ValueBucket {
+    uint32_t tokens_;
+    MonotonicTime fill_time_;
+    std::list<std::vector<std::string>>::iterator lru_position_;
+  };
+  // A descriptor matching the request descriptors of its keys, with a bucket for each distinct set
+  // of values. The buckets are refilled when they are used rather than on the fill timer, so that
+  // there can be many of them.
+  struct ValueBuckets {
+    std::string toString() const { return absl::StrJoin(keys_, ", "); }
+
+    std::vector<std::string> keys_;
+    RateLimit::TokenBucket token_bucket_;
+    uint32_t max_buckets_;
+    absl::Mutex mutex_;
+    absl::flat_hash_map<std::vector<std::string>, ValueBucket> buckets_ ABSL_GUARDED_BY(mutex_);
+    // The values of the buckets, the most recently used first.
+    std::list<std::vector<std::string>> lru_ ABSL_GUARDED_BY(mutex_);
+  };
+  using ValueBucketsPtr = std::unique_ptr<ValueBuckets>;
+
   void onFillTimer();
   void onFillTimerHelper(const TokenState& state, const RateLimit::TokenBucket& bucket);
   void onFillTimerDescriptorHelper();
+  // @return the number of the tokens added to the shard, which holds at most max_tokens.
+  uint32_t addTokens(const TokenShard& shard, uint32_t tokens, uint32_t max_tokens);
   bool requestAllowedHelper(const TokenState& tokens) const;
+  bool takeToken(const TokenShard& shard) const;
+  bool requestAllowedHelper(ValueBuckets& value_buckets,
+                            const RateLimit::LocalDescriptor& request_descriptor) const;
+  static bool matchesKeys(const ValueBuckets& value_buckets,
+                          const RateLimit::LocalDescriptor& request_descriptor);
 
   RateLimit::TokenBucket token_bucket_;
   const Event::TimerPtr fill_timer_;
   TimeSource& time_source_;
   TokenState tokens_;
   absl::flat_hash_set<LocalDescriptorImpl, LocalDescriptorHash, LocalDescriptorEqual> descriptors_;
+  std::vector<ValueBucketsPtr> value_buckets_;
   mutable Thread::ThreadSynchronizer synchronizer_; // Used for testing only.
 
   friend class LocalRateLimiterImplTest;
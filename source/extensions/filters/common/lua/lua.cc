@@ -14,8 +14,28 @@ namespace Filters {
 namespace Common {
 namespace Lua {
 
-Coroutine::Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state)
-    : coroutine_state_(new_thread_state, false) {}
+namespace {
+
+// The maximum number of idle coroutines kept per Lua state. Beyond it, the threads of the finished
+// coroutines are left for the GC to collect.
+constexpr size_t MaxIdleCoroutines = 256;
+
+} // namespace
+
+Coroutine::Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state,
+                     IdleCoroutines* idle_coroutines, bool reused)
+    : coroutine_state_(new_thread_state, false), parent_state_(new_thread_state.second),
+      idle_coroutines_(idle_coroutines), reused_(reused) {}
+
+Coroutine::~Coroutine() {
+  // A thread that yielded or raised an error can't be resumed from the start again.
+  if (idle_coroutines_ == nullptr || !returned_ || idle_coroutines_->size() >= MaxIdleCoroutines) {
+    return;
+  }
+  lua_settop(coroutine_state_.get(), 0);
+  coroutine_state_.pushStack();
+  idle_coroutines_->push_back(luaL_ref(parent_state_, LUA_REGISTRYINDEX));
+}
 
 void Coroutine::start(int function_ref, int num_args, const std::function<void()>& yield_callback) {
   ASSERT(state_ == State::NotStarted);
@@ -36,6 +56,7 @@ void Coroutine::resume(int num_args, const std::function<void()>& yield_callback
 
   if (0 == rc) {
     state_ = State::Finished;
+    returned_ = true;
     ENVOY_LOG(debug, "coroutine finished");
   } else if (LUA_YIELD == rc) {
     state_ = State::Yielded;
@@ -90,8 +111,18 @@ uint64_t ThreadLocalState::registerGlobal(const std::string& global,
 }
 
 CoroutinePtr ThreadLocalState::createCoroutine() {
-  lua_State* state = tlsState().get();
-  return std::make_unique<Coroutine>(std::make_pair(lua_newthread(state), state));
+  LuaThreadLocal& tls = **tls_slot_;
+  lua_State* state = tls.state_.get();
+  if (!tls.idle_coroutines_.empty()) {
+    const int ref = tls.idle_coroutines_.back();
+    tls.idle_coroutines_.pop_back();
+    lua_rawgeti(state, LUA_REGISTRYINDEX, ref);
+    luaL_unref(state, LUA_REGISTRYINDEX, ref);
+    return std::make_unique<Coroutine>(std::make_pair(lua_tothread(state, -1), state),
+                                       &tls.idle_coroutines_, true);
+  }
+  return std::make_unique<Coroutine>(std::make_pair(lua_newthread(state), state),
+                                     &tls.idle_coroutines_, false);
 }
 
 ThreadLocalState::LuaThreadLocal::LuaThreadLocal(const std::string& code)
@@ -324,6 +324,12 @@ public:
   }
 };
 
+/**
+ * The references of the Lua threads of the finished coroutines of a Lua state, which the next
+ * coroutines reuse instead of allocating new threads for the GC to collect.
+ */
+using IdleCoroutines = std::vector<int>;
+
 /**
  * This is a wrapper for a Lua coroutine. Lua intermixes coroutine and "thread." Lua does not have
  * real threads, only cooperatively scheduled coroutines.
@@ -332,10 +338,24 @@ class Coroutine : Logger::Loggable<Logger::Id::lua> {
 public:
   enum class State { NotStarted, Yielded, Finished };
 
-  Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state);
+  /**
+   * @param new_thread_state supplies the thread of the coroutine, at the top of the stack of its
+   *        parent state, and its parent state.
+   * @param idle_coroutines supplies the idle coroutines of the parent state, to which the thread
+   *        is returned on destruction if the coroutine finished without error. May be nullptr.
+   * @param reused supplies whether the thread was previously used by another coroutine.
+   */
+  Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state,
+            IdleCoroutines* idle_coroutines = nullptr, bool reused = false);
+  ~Coroutine();
   lua_State* luaState() { return coroutine_state_.get(); }
   State state() { return state_; }
 
+  /**
+   * @return whether the coroutine reuses the thread of a finished coroutine.
+   */
+  bool reused() const { return reused_; }
+
   /**
    * Start a coroutine.
    * @param function_ref supplies the previously registered function to call. Registered with
@@ -356,7 +376,12 @@ public:
 
 private:
   LuaRef<lua_State> coroutine_state_;
+  lua_State* const parent_state_;
+  IdleCoroutines* const idle_coroutines_;
+  const bool reused_;
   State state_{State::NotStarted};
+  // Whether the coroutine returned without error, so that its thread can be reused.
+  bool returned_{};
 };
 
 using CoroutinePtr = std::unique_ptr<Coroutine>;
@@ -373,7 +398,7 @@ public:
   ThreadLocalState(const std::string& code, ThreadLocal::SlotAllocator& tls);
 
   /**
-   * @return CoroutinePtr a new coroutine.
+   * @return CoroutinePtr a new coroutine, reusing the thread of a finished coroutine if it can.
    */
   CoroutinePtr createCoroutine();
 
@@ -421,6 +446,7 @@ private:
 
     CSmartPtr<lua_State, lua_close> state_;
     std::vector<int> global_slots_;
+    IdleCoroutines idle_coroutines_;
   };
 
   CSmartPtr<lua_State, lua_close>& tlsState() { return (*tls_slot_)->state_; }
@@ -21,13 +21,14 @@ namespace RateLimit {
 
 GrpcClientImpl::GrpcClientImpl(Grpc::RawAsyncClientPtr&& async_client,
                                const absl::optional<std::chrono::milliseconds>& timeout,
-                               envoy::config::core::v3::ApiVersion transport_api_version)
+                               envoy::config::core::v3::ApiVersion transport_api_version,
+                               uint32_t hits_addend)
     : async_client_(std::move(async_client)), timeout_(timeout),
       service_method_(
           Grpc::VersionedMethods("envoy.service.ratelimit.v3.RateLimitService.ShouldRateLimit",
                                  "envoy.service.ratelimit.v2.RateLimitService.ShouldRateLimit")
               .getMethodDescriptorForVersion(transport_api_version)),
-      transport_api_version_(transport_api_version) {}
+      transport_api_version_(transport_api_version), hits_addend_(hits_addend) {}
 
 GrpcClientImpl::~GrpcClientImpl() { ASSERT(!callbacks_); }
 
@@ -67,6 +68,7 @@ void GrpcClientImpl::limit(RequestCallbacks& callbacks, const std::string& domai
 
   envoy::service::ratelimit::v3::RateLimitRequest request;
   createRequest(request, domain, descriptors);
+  request.set_hits_addend(hits_addend_);
 
   request_ =
       async_client_->send(service_method_, request, *this, parent_span,
@@ -125,14 +127,15 @@ void GrpcClientImpl::onFailure(Grpc::Status::GrpcStatus status, const std::strin
 ClientPtr rateLimitClient(Server::Configuration::FactoryContext& context,
                           const envoy::config::core::v3::GrpcService& grpc_service,
                           const std::chrono::milliseconds timeout,
-                          envoy::config::core::v3::ApiVersion transport_api_version) {
+                          envoy::config::core::v3::ApiVersion transport_api_version,
+                          uint32_t hits_addend) {
   // TODO(ramaraochavali): register client to singleton when GrpcClientImpl supports concurrent
   // requests.
   const auto async_client_factory =
       context.clusterManager().grpcAsyncClientManager().factoryForGrpcService(
           grpc_service, context.scope(), true);
   return std::make_unique<Filters::Common::RateLimit::GrpcClientImpl>(
-      async_client_factory->create(), timeout, transport_api_version);
+      async_client_factory->create(), timeout, transport_api_version, hits_addend);
 }
 
 } // namespace RateLimit
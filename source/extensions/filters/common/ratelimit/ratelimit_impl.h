@@ -46,7 +46,8 @@ class GrpcClientImpl : public Client,
 public:
   GrpcClientImpl(Grpc::RawAsyncClientPtr&& async_client,
                  const absl::optional<std::chrono::milliseconds>& timeout,
-                 envoy::config::core::v3::ApiVersion transport_api_version);
+                 envoy::config::core::v3::ApiVersion transport_api_version,
+                 uint32_t hits_addend = 0);
   ~GrpcClientImpl() override;
 
   static void createRequest(envoy::service::ratelimit::v3::RateLimitRequest& request,
@@ -75,15 +76,17 @@ private:
   RequestCallbacks* callbacks_{};
   const Protobuf::MethodDescriptor& service_method_;
   const envoy::config::core::v3::ApiVersion transport_api_version_;
+  const uint32_t hits_addend_;
 };
 
 /**
- * Builds the rate limit client.
+ * Builds the rate limit client, which asks for hits_addend hits per request if it is set.
  */
 ClientPtr rateLimitClient(Server::Configuration::FactoryContext& context,
                           const envoy::config::core::v3::GrpcService& grpc_service,
                           const std::chrono::milliseconds timeout,
-                          envoy::config::core::v3::ApiVersion transport_api_version);
+                          envoy::config::core::v3::ApiVersion transport_api_version,
+                          uint32_t hits_addend = 0);
 
 } // namespace RateLimit
 } // namespace Common
@@ -0,0 +1,295 @@
+#include "source/extensions/filters/common/rbac/compiled_policies.h"
+
+#include <algorithm>
+#include <map>
+
+#include "source/common/http/header_utility.h"
+#include "source/common/http/path_utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RBAC {
+
+CompiledPolicies::CompiledPolicies(const envoy::config::rbac::v3::RBAC& rules,
+                                   Expr::Builder* builder) {
+  // The policies are evaluated in name order.
+  std::map<std::string, const envoy::config::rbac::v3::Policy*> sorted_policies;
+  for (const auto& policy : rules.policies()) {
+    sorted_policies.emplace(policy.first, &policy.second);
+  }
+
+  policies_.reserve(sorted_policies.size());
+  for (const auto& [name, policy] : sorted_policies) {
+    Policy& compiled = policies_.emplace_back();
+    compiled.name_ = name;
+    compiled.permissions_ = compileComposite(NodeType::Or, compileAll(policy->permissions()));
+    compiled.principals_ = compileComposite(NodeType::Or, compileAll(policy->principals()));
+    if (policy->has_condition()) {
+      compiled.condition_ =
+          std::make_unique<google::api::expr::v1alpha1::Expr>(policy->condition());
+      compiled.attributes_ = Expr::referencedAttributes(*compiled.condition_);
+      compiled.expr_ = Expr::createExpression(*builder, *compiled.condition_);
+    }
+  }
+
+  for (IpGroup& group : ip_groups_) {
+    if (!group.ranges_.empty()) {
+      group.trie_ = std::make_unique<Network::LcTrie::LcTrie<uint32_t>>(group.ranges_);
+      group.ranges_ = {};
+    }
+  }
+  // The keys are only needed to share the nodes while compiling.
+  node_ids_ = {};
+  header_group_ids_ = {};
+}
+
+const std::string* CompiledPolicies::firstMatch(const Network::Connection& connection,
+                                                const Envoy::Http::RequestHeaderMap& headers,
+                                                const StreamInfo::StreamInfo& info) const {
+  Evaluation evaluation{connection, headers, info,
+                        std::vector<Result>(nodes_.size(), Result::Unknown)};
+  for (const Policy& policy : policies_) {
+    if (evaluate(policy.permissions_, evaluation) && evaluate(policy.principals_, evaluation) &&
+        (policy.expr_ == nullptr ||
+         Expr::matches(*policy.expr_, info, headers, policy.attributes_))) {
+      return &policy.name_;
+    }
+  }
+  return nullptr;
+}
+
+uint32_t CompiledPolicies::compile(const envoy::config::rbac::v3::Permission& permission) {
+  switch (permission.rule_case()) {
+  case envoy::config::rbac::v3::Permission::RuleCase::kAndRules:
+    return compileComposite(NodeType::And, compileAll(permission.and_rules().rules()));
+  case envoy::config::rbac::v3::Permission::RuleCase::kOrRules:
+    return compileComposite(NodeType::Or, compileAll(permission.or_rules().rules()));
+  case envoy::config::rbac::v3::Permission::RuleCase::kNotRule:
+    return compileComposite(NodeType::Not, {compile(permission.not_rule())});
+  case envoy::config::rbac::v3::Permission::RuleCase::kHeader:
+    return compileHeader(permission.header());
+  case envoy::config::rbac::v3::Permission::RuleCase::kDestinationIp:
+    return compileIp(permission.destination_ip(), IPMatcher::Type::DownstreamLocal);
+  case envoy::config::rbac::v3::Permission::RuleCase::kUrlPath:
+    return compilePath(permission.url_path());
+  default:
+    return compileMatcher(permission);
+  }
+}
+
+uint32_t CompiledPolicies::compile(const envoy::config::rbac::v3::Principal& principal) {
+  switch (principal.identifier_case()) {
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kAndIds:
+    return compileComposite(NodeType::And, compileAll(principal.and_ids().ids()));
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kOrIds:
+    return compileComposite(NodeType::Or, compileAll(principal.or_ids().ids()));
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kNotId:
+    return compileComposite(NodeType::Not, {compile(principal.not_id())});
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kHeader:
+    return compileHeader(principal.header());
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kSourceIp:
+    return compileIp(principal.source_ip(), IPMatcher::Type::ConnectionRemote);
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kDirectRemoteIp:
+    return compileIp(principal.direct_remote_ip(), IPMatcher::Type::DownstreamDirectRemote);
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kRemoteIp:
+    return compileIp(principal.remote_ip(), IPMatcher::Type::DownstreamRemote);
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kUrlPath:
+    return compilePath(principal.url_path());
+  default:
+    return compileMatcher(principal);
+  }
+}
+
+template <class Rule>
+std::vector<uint32_t>
+CompiledPolicies::compileAll(const Protobuf::RepeatedPtrField<Rule>& rules) {
+  std::vector<uint32_t> ids;
+  ids.reserve(rules.size());
+  for (const auto& rule : rules) {
+    ids.push_back(compile(rule));
+  }
+  return ids;
+}
+
+uint32_t CompiledPolicies::compileComposite(NodeType type, std::vector<uint32_t>&& children) {
+  // The operands are compiled first, so identical composites have the same operand ids.
+  std::string key = absl::StrCat("composite:", static_cast<int>(type), ":",
+                                 absl::StrJoin(children, ","));
+  if (const auto id = findNode(key); id.has_value()) {
+    return id.value();
+  }
+  return addNode(std::move(key), {type, nullptr, std::move(children)});
+}
+
+// A key serializes the rule it is compiled from. The serialization of map fields, as in the
+// metadata matchers, is not deterministic, which may only keep identical rules from being shared.
+template <class Rule> uint32_t CompiledPolicies::compileMatcher(const Rule& rule) {
+  std::string key = absl::StrCat(Rule::descriptor()->name(), ":", rule.SerializeAsString());
+  if (const auto id = findNode(key); id.has_value()) {
+    return id.value();
+  }
+  return addNode(std::move(key), {NodeType::Matcher, Matcher::create(rule)});
+}
+
+uint32_t CompiledPolicies::compileHeader(const envoy::config::route::v3::HeaderMatcher& header) {
+  std::string key = absl::StrCat("header:", header.SerializeAsString());
+  if (const auto id = findNode(key); id.has_value()) {
+    return id.value();
+  }
+  // An empty exact value matches any value of the header.
+  if (header.header_match_specifier_case() !=
+          envoy::config::route::v3::HeaderMatcher::HeaderMatchSpecifierCase::kExactMatch ||
+      header.exact_match().empty() || header.invert_match()) {
+    return addNode(std::move(key),
+                   {NodeType::Matcher, std::make_shared<const HeaderMatcher>(header)});
+  }
+
+  const Envoy::Http::LowerCaseString name(header.name());
+  const auto [group_id, inserted] =
+      header_group_ids_.try_emplace(name.get(), header_groups_.size());
+  if (inserted) {
+    header_groups_.emplace_back(name.get());
+  }
+  const uint32_t id = addNode(std::move(key), {NodeType::Header, nullptr, {}, group_id->second});
+  HeaderGroup& group = header_groups_[group_id->second];
+  group.nodes_.push_back(id);
+  group.values_[header.exact_match()].push_back(id);
+  return id;
+}
+
+uint32_t CompiledPolicies::compileIp(const envoy::config::core::v3::CidrRange& range,
+                                     IPMatcher::Type type) {
+  std::string key = absl::StrCat("ip:", static_cast<int>(type), ":", range.SerializeAsString());
+  if (const auto id = findNode(key); id.has_value()) {
+    return id.value();
+  }
+  Network::Address::CidrRange cidr_range = Network::Address::CidrRange::create(range);
+  const uint32_t id =
+      addNode(std::move(key), {NodeType::Ip, nullptr, {}, static_cast<uint32_t>(type)});
+  IpGroup& group = ip_groups_[type];
+  group.nodes_.push_back(id);
+  group.ranges_.push_back({id, {std::move(cidr_range)}});
+  return id;
+}
+
+uint32_t CompiledPolicies::compilePath(const envoy::type::matcher::v3::PathMatcher& path) {
+  std::string key = absl::StrCat("path:", path.SerializeAsString());
+  if (const auto id = findNode(key); id.has_value()) {
+    return id.value();
+  }
+  if (path.path().match_pattern_case() != envoy::type::matcher::v3::StringMatcher::kExact ||
+      path.path().ignore_case()) {
+    return addNode(std::move(key), {NodeType::Matcher, std::make_shared<const PathMatcher>(path)});
+  }
+
+  const uint32_t id = addNode(std::move(key), {NodeType::Path});
+  path_group_.nodes_.push_back(id);
+  path_group_.values_[path.path().exact()].push_back(id);
+  return id;
+}
+
+absl::optional<uint32_t> CompiledPolicies::findNode(const std::string& key) const {
+  const auto it = node_ids_.find(key);
+  if (it == node_ids_.end()) {
+    return absl::nullopt;
+  }
+  return it->second;
+}
+
+uint32_t CompiledPolicies::addNode(std::string&& key, Node&& node) {
+  const uint32_t id = nodes_.size();
+  nodes_.push_back(std::move(node));
+  node_ids_.emplace(std::move(key), id);
+  return id;
+}
+
+bool CompiledPolicies::evaluate(uint32_t id, Evaluation& evaluation) const {
+  if (evaluation.results_[id] != Result::Unknown) {
+    return evaluation.results_[id] == Result::True;
+  }
+
+  const Node& node = nodes_[id];
+  const auto evaluate_child = [this, &evaluation](uint32_t child) {
+    return evaluate(child, evaluation);
+  };
+  bool matched = false;
+  switch (node.type_) {
+  case NodeType::Matcher:
+    matched = node.matcher_->matches(evaluation.connection_, evaluation.headers_, evaluation.info_);
+    break;
+  case NodeType::And:
+    matched = std::all_of(node.children_.begin(), node.children_.end(), evaluate_child);
+    break;
+  case NodeType::Or:
+    matched = std::any_of(node.children_.begin(), node.children_.end(), evaluate_child);
+    break;
+  case NodeType::Not:
+    matched = !evaluate_child(node.children_[0]);
+    break;
+  // The group nodes set the results of all the nodes of their group.
+  case NodeType::Ip:
+    evaluateIpGroup(static_cast<IPMatcher::Type>(node.group_), evaluation);
+    return evaluation.results_[id] == Result::True;
+  case NodeType::Header: {
+    const HeaderGroup& group = header_groups_[node.group_];
+    const auto value =
+        Envoy::Http::HeaderUtility::getAllOfHeaderAsString(evaluation.headers_, group.name_);
+    evaluateValueGroup(group, value.result(), evaluation);
+    return evaluation.results_[id] == Result::True;
+  }
+  case NodeType::Path: {
+    absl::optional<absl::string_view> path;
+    if (evaluation.headers_.Path() != nullptr) {
+      path = Envoy::Http::PathUtil::removeQueryAndFragment(evaluation.headers_.getPathValue());
+    }
+    evaluateValueGroup(path_group_, path, evaluation);
+    return evaluation.results_[id] == Result::True;
+  }
+  }
+  evaluation.results_[id] = matched ? Result::True : Result::False;
+  return matched;
+}
+
+void CompiledPolicies::evaluateIpGroup(IPMatcher::Type type, Evaluation& evaluation) const {
+  const IpGroup& group = ip_groups_[type];
+  for (const uint32_t id : group.nodes_) {
+    evaluation.results_[id] = Result::False;
+  }
+  const Network::Address::InstanceConstSharedPtr& address =
+      IPMatcher::extractIpAddress(type, evaluation.connection_, evaluation.info_);
+  if (address->ip() == nullptr) {
+    return;
+  }
+  for (const uint32_t id : group.trie_->getData(address)) {
+    evaluation.results_[id] = Result::True;
+  }
+}
+
+void CompiledPolicies::evaluateValueGroup(const ValueGroup& group,
+                                          absl::optional<absl::string_view> value,
+                                          Evaluation& evaluation) const {
+  for (const uint32_t id : group.nodes_) {
+    evaluation.results_[id] = Result::False;
+  }
+  if (!value.has_value()) {
+    return;
+  }
+  const auto it = group.values_.find(value.value());
+  if (it == group.values_.end()) {
+    return;
+  }
+  for (const uint32_t id : it->second) {
+    evaluation.results_[id] = Result::True;
+  }
+}
+
+} // namespace RBAC
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
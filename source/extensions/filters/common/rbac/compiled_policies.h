@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/rbac/v3/rbac.pb.h"
+#include "envoy/http/header_map.h"
+#include "envoy/network/connection.h"
+#include "envoy/stream_info/stream_info.h"
+
+#include "source/common/network/lc_trie.h"
+#include "source/extensions/filters/common/expr/evaluator.h"
+#include "source/extensions/filters/common/rbac/matchers.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RBAC {
+
+/**
+ * The policies of an RBAC engine, compiled so that a request evaluates each distinct permission and
+ * principal at most once, however many policies share it. Identical permissions and principals are
+ * compiled into a single predicate. The predicates matching an address of the connection against a
+ * CIDR range are evaluated together with a single LC-trie lookup per address, and those matching
+ * the exact value of a header or the exact path with a single hash map lookup per header.
+ */
+class CompiledPolicies : NonCopyable {
+public:
+  /**
+   * @param rules supplies the policies to compile.
+   * @param builder supplies the builder of the conditions, which must be set if any policy has a
+   *        condition.
+   */
+  CompiledPolicies(const envoy::config::rbac::v3::RBAC& rules, Expr::Builder* builder);
+
+  /**
+   * @return the name of the first policy, in name order, matching the request, or nullptr if none
+   *         does.
+   */
+  const std::string* firstMatch(const Network::Connection& connection,
+                                const Envoy::Http::RequestHeaderMap& headers,
+                                const StreamInfo::StreamInfo& info) const;
+
+  /**
+   * @return the number of distinct predicates the policies were compiled into.
+   */
+  uint32_t predicateCount() const { return nodes_.size(); }
+
+private:
+  enum class NodeType : uint8_t { Matcher, And, Or, Not, Ip, Header, Path };
+  enum class Result : uint8_t { Unknown, False, True };
+
+  struct Node {
+    NodeType type_;
+    // The matcher of a Matcher node.
+    MatcherConstSharedPtr matcher_;
+    // The operands of an And, Or or Not node.
+    std::vector<uint32_t> children_;
+    // The group evaluating an Ip or Header node.
+    uint32_t group_{};
+  };
+
+  struct IpGroup {
+    std::vector<uint32_t> nodes_;
+    std::vector<std::pair<uint32_t, std::vector<Network::Address::CidrRange>>> ranges_;
+    std::unique_ptr<Network::LcTrie::LcTrie<uint32_t>> trie_;
+  };
+
+  using NodesByValue = absl::flat_hash_map<std::string, std::vector<uint32_t>>;
+
+  struct ValueGroup {
+    std::vector<uint32_t> nodes_;
+    NodesByValue values_;
+  };
+
+  struct HeaderGroup : public ValueGroup {
+    explicit HeaderGroup(const std::string& name) : name_(name) {}
+
+    const Envoy::Http::LowerCaseString name_;
+  };
+
+  struct Policy {
+    std::string name_;
+    uint32_t permissions_;
+    uint32_t principals_;
+    std::unique_ptr<google::api::expr::v1alpha1::Expr> condition_;
+    Expr::ContextAttributes attributes_;
+    Expr::ExpressionPtr expr_;
+  };
+
+  // The state of the evaluation of the policies for a request.
+  struct Evaluation {
+    const Network::Connection& connection_;
+    const Envoy::Http::RequestHeaderMap& headers_;
+    const StreamInfo::StreamInfo& info_;
+    std::vector<Result> results_;
+  };
+
+  uint32_t compile(const envoy::config::rbac::v3::Permission& permission);
+  uint32_t compile(const envoy::config::rbac::v3::Principal& principal);
+  template <class Rule>
+  std::vector<uint32_t> compileAll(const Protobuf::RepeatedPtrField<Rule>& rules);
+  uint32_t compileComposite(NodeType type, std::vector<uint32_t>&& children);
+  template <class Rule> uint32_t compileMatcher(const Rule& rule);
+  uint32_t compileHeader(const envoy::config::route::v3::HeaderMatcher& header);
+  uint32_t compileIp(const envoy::config::core::v3::CidrRange& range, IPMatcher::Type type);
+  uint32_t compilePath(const envoy::type::matcher::v3::PathMatcher& path);
+
+  // @return the id of the node compiled from key, if any.
+  absl::optional<uint32_t> findNode(const std::string& key) const;
+  uint32_t addNode(std::string&& key, Node&& node);
+
+  bool evaluate(uint32_t id, Evaluation& evaluation) const;
+  void evaluateIpGroup(IPMatcher::Type type, Evaluation& evaluation) const;
+  void evaluateValueGroup(const ValueGroup& group, absl::optional<absl::string_view> value,
+                          Evaluation& evaluation) const;
+
+  std::vector<Node> nodes_;
+  absl::flat_hash_map<std::string, uint32_t> node_ids_;
+  // Indexed by IPMatcher::Type.
+  std::array<IpGroup, 4> ip_groups_;
+  std::vector<HeaderGroup> header_groups_;
+  absl::flat_hash_map<std::string, uint32_t> header_group_ids_;
+  ValueGroup path_group_;
+  std::vector<Policy> policies_;
+};
+
+} // namespace RBAC
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -21,9 +21,7 @@ RoleBasedAccessControlEngineImpl::RoleBasedAccessControlEngineImpl(
     }
   }
 
-  for (const auto& policy : rules.policies()) {
-    policies_.emplace(policy.first, std::make_unique<PolicyMatcher>(policy.second, builder_.get()));
-  }
+  policies_ = std::make_unique<const CompiledPolicies>(rules, builder_.get());
 }
 
 bool RoleBasedAccessControlEngineImpl::handleAction(const Network::Connection& connection,
@@ -63,19 +61,11 @@ bool RoleBasedAccessControlEngineImpl::handleAction(const Network::Connection& c
 bool RoleBasedAccessControlEngineImpl::checkPolicyMatch(
     const Network::Connection& connection, const StreamInfo::StreamInfo& info,
     const Envoy::Http::RequestHeaderMap& headers, std::string* effective_policy_id) const {
-  bool matched = false;
-
-  for (const auto& policy : policies_) {
-    if (policy.second->matches(connection, headers, info)) {
-      matched = true;
-      if (effective_policy_id != nullptr) {
-        *effective_policy_id = policy.first;
-      }
-      break;
-    }
+  const std::string* policy = policies_->firstMatch(connection, headers, info);
+  if (policy != nullptr && effective_policy_id != nullptr) {
+    *effective_policy_id = *policy;
   }
-
-  return matched;
+  return policy != nullptr;
 }
 
 } // namespace RBAC
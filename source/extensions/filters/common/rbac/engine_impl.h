@@ -2,8 +2,8 @@
 
 #include "envoy/config/rbac/v3/rbac.pb.h"
 
+#include "source/extensions/filters/common/rbac/compiled_policies.h"
 #include "source/extensions/filters/common/rbac/engine.h"
-#include "source/extensions/filters/common/rbac/matchers.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -46,7 +46,7 @@ private:
   const envoy::config::rbac::v3::RBAC::Action action_;
   const EnforcementMode mode_;
 
-  std::map<std::string, std::unique_ptr<PolicyMatcher>> policies_;
+  std::unique_ptr<const CompiledPolicies> policies_;
 
   Protobuf::Arena constant_arena_;
   Expr::BuilderPtr builder_;
@@ -132,24 +132,24 @@ bool HeaderMatcher::matches(const Network::Connection&,
 
 bool IPMatcher::matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap&,
                         const StreamInfo::StreamInfo& info) const {
-  Envoy::Network::Address::InstanceConstSharedPtr ip;
-  switch (type_) {
+  return range_.isInRange(*extractIpAddress(type_, connection, info));
+}
+
+const Envoy::Network::Address::InstanceConstSharedPtr&
+IPMatcher::extractIpAddress(Type type, const Network::Connection& connection,
+                            const StreamInfo::StreamInfo& info) {
+  switch (type) {
   case ConnectionRemote:
-    ip = connection.addressProvider().remoteAddress();
-    break;
+    return connection.addressProvider().remoteAddress();
   case DownstreamLocal:
-    ip = info.downstreamAddressProvider().localAddress();
-    break;
+    return info.downstreamAddressProvider().localAddress();
   case DownstreamDirectRemote:
-    ip = info.downstreamAddressProvider().directRemoteAddress();
-    break;
+    return info.downstreamAddressProvider().directRemoteAddress();
   case DownstreamRemote:
-    ip = info.downstreamAddressProvider().remoteAddress();
-    break;
+    return info.downstreamAddressProvider().remoteAddress();
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
-  return range_.isInRange(*ip.get());
 }
 
 bool PortMatcher::matches(const Network::Connection&, const Envoy::Http::RequestHeaderMap&,
@@ -198,7 +198,7 @@ bool PolicyMatcher::matches(const Network::Connection& connection,
                             const StreamInfo::StreamInfo& info) const {
   return permissions_.matches(connection, headers, info) &&
          principals_.matches(connection, headers, info) &&
-         (expr_ == nullptr ? true : Expr::matches(*expr_, info, headers));
+         (expr_ == nullptr ? true : Expr::matches(*expr_, info, headers, attributes_));
 }
 
 bool RequestedServerNameMatcher::matches(const Network::Connection& connection,
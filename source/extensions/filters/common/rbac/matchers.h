@@ -144,6 +144,13 @@ public:
   bool matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap& headers,
                const StreamInfo::StreamInfo& info) const override;
 
+  /**
+   * @return the address of the connection an IPMatcher of the type matches.
+   */
+  static const Network::Address::InstanceConstSharedPtr&
+  extractIpAddress(Type type, const Network::Connection& connection,
+                   const StreamInfo::StreamInfo& info);
+
 private:
   const Network::Address::CidrRange range_;
   const Type type_;
@@ -190,7 +197,7 @@ class PolicyMatcher : public Matcher, NonCopyable {
 public:
   PolicyMatcher(const envoy::config::rbac::v3::Policy& policy, Expr::Builder* builder)
       : permissions_(policy.permissions()), principals_(policy.principals()),
-        condition_(policy.condition()) {
+        condition_(policy.condition()), attributes_(Expr::referencedAttributes(condition_)) {
     if (policy.has_condition()) {
       expr_ = Expr::createExpression(*builder, condition_);
     }
@@ -204,6 +211,7 @@ private:
   const OrMatcher principals_;
 
   const google::api::expr::v1alpha1::Expr condition_;
+  const Expr::ContextAttributes attributes_;
   Expr::ExpressionPtr expr_;
 };
 
@@ -8,6 +8,7 @@
 #include "envoy/extensions/filters/http/adaptive_concurrency/v3/adaptive_concurrency.pb.h"
 
 #include "source/common/common/assert.h"
+#include "source/common/http/utility.h"
 #include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/http/adaptive_concurrency/controller/controller.h"
 
@@ -21,13 +22,37 @@ AdaptiveConcurrencyFilterConfig::AdaptiveConcurrencyFilterConfig(
         proto_config,
     Runtime::Loader& runtime, std::string stats_prefix, Stats::Scope&, TimeSource& time_source)
     : stats_prefix_(std::move(stats_prefix)), time_source_(time_source),
-      adaptive_concurrency_feature_(proto_config.enabled(), runtime) {}
+      adaptive_concurrency_feature_(proto_config.enabled(), runtime),
+      priority_header_(proto_config.has_priority_limits()
+                           ? absl::make_optional<Http::LowerCaseString>(
+                                 proto_config.priority_limits().header())
+                           : absl::nullopt),
+      default_limit_(PROTOBUF_PERCENT_TO_DOUBLE_OR_DEFAULT(proto_config.priority_limits(),
+                                                           default_limit, 100) /
+                     100) {
+  for (const auto& priority : proto_config.priority_limits().priorities()) {
+    priority_limits_.emplace(priority.priority(), priority.limit().value() / 100);
+  }
+}
+
+double AdaptiveConcurrencyFilterConfig::limitFraction(const Http::RequestHeaderMap& headers) const {
+  ASSERT(priority_header_.has_value());
+  const auto priority = headers.get(priority_header_.value());
+  if (!priority.empty()) {
+    const auto it = priority_limits_.find(priority[0]->value().getStringView());
+    if (it != priority_limits_.end()) {
+      return it->second;
+    }
+  }
+  return default_limit_;
+}
 
 AdaptiveConcurrencyFilter::AdaptiveConcurrencyFilter(
     AdaptiveConcurrencyFilterConfigSharedPtr config, ConcurrencyControllerSharedPtr controller)
     : config_(std::move(config)), controller_(std::move(controller)) {}
 
-Http::FilterHeadersStatus AdaptiveConcurrencyFilter::decodeHeaders(Http::RequestHeaderMap&, bool) {
+Http::FilterHeadersStatus AdaptiveConcurrencyFilter::decodeHeaders(Http::RequestHeaderMap& headers,
+                                                                   bool) {
   // In addition to not sampling if the filter is disabled, health checks should also not be sampled
   // by the concurrency controller since they may potentially bias the sample aggregate to lower
   // latency measurements.
@@ -35,7 +60,18 @@ Http::FilterHeadersStatus AdaptiveConcurrencyFilter::decodeHeaders(Http::Request
     return Http::FilterHeadersStatus::Continue;
   }
 
-  if (controller_->forwardingDecision() == Controller::RequestForwardingAction::Block) {
+  const auto* route_config =
+      Http::Utility::resolveMostSpecificPerFilterConfig<AdaptiveConcurrencyRouteConfig>(
+          "envoy.filters.http.adaptive_concurrency", decoder_callbacks_->route());
+  if (route_config != nullptr) {
+    controller_ = route_config->controller();
+  }
+
+  const Controller::RequestForwardingAction action =
+      config_->hasPriorityLimits()
+          ? controller_->forwardingDecision(config_->limitFraction(headers))
+          : controller_->forwardingDecision();
+  if (action == Controller::RequestForwardingAction::Block) {
     decoder_callbacks_->sendLocalReply(Http::Code::ServiceUnavailable, "reached concurrency limit",
                                        nullptr, absl::nullopt, "reached_concurrency_limit");
     return Http::FilterHeadersStatus::StopIteration;
@@ -7,6 +7,7 @@
 #include "envoy/common/time.h"
 #include "envoy/extensions/filters/http/adaptive_concurrency/v3/adaptive_concurrency.pb.h"
 #include "envoy/http/filter.h"
+#include "envoy/router/router.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
@@ -16,6 +17,8 @@
 #include "source/extensions/filters/http/adaptive_concurrency/controller/controller.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -35,16 +38,45 @@ public:
   bool filterEnabled() const { return adaptive_concurrency_feature_.enabled(); }
   TimeSource& timeSource() const { return time_source_; }
 
+  // True if the requests of some priorities may only use a share of the concurrency limit.
+  bool hasPriorityLimits() const { return priority_header_.has_value(); }
+
+  /**
+   * @param headers supplies the headers of the request.
+   * @return the share of the concurrency limit the request may use, given its priority, in the
+   *         range [0.0, 1.0].
+   */
+  double limitFraction(const Http::RequestHeaderMap& headers) const;
+
 private:
   const std::string stats_prefix_;
   TimeSource& time_source_;
   Runtime::FeatureFlag adaptive_concurrency_feature_;
+  const absl::optional<Http::LowerCaseString> priority_header_;
+  // The shares of the concurrency limit of the priorities, normalized to the range [0.0, 1.0].
+  absl::flat_hash_map<std::string, double> priority_limits_;
+  const double default_limit_;
 };
 
 using AdaptiveConcurrencyFilterConfigSharedPtr =
     std::shared_ptr<const AdaptiveConcurrencyFilterConfig>;
 using ConcurrencyControllerSharedPtr = std::shared_ptr<Controller::ConcurrencyController>;
 
+/**
+ * Per-route configuration of the adaptive concurrency limit filter, with the concurrency controller
+ * of the requests of the route.
+ */
+class AdaptiveConcurrencyRouteConfig : public Router::RouteSpecificFilterConfig {
+public:
+  explicit AdaptiveConcurrencyRouteConfig(ConcurrencyControllerSharedPtr controller)
+      : controller_(std::move(controller)) {}
+
+  const ConcurrencyControllerSharedPtr& controller() const { return controller_; }
+
+private:
+  const ConcurrencyControllerSharedPtr controller_;
+};
+
 /**
  * A filter that samples request latencies and dynamically adjusts the request
  * concurrency window.
@@ -64,7 +96,9 @@ public:
 
 private:
   AdaptiveConcurrencyFilterConfigSharedPtr config_;
-  const ConcurrencyControllerSharedPtr controller_;
+  // The controller of the filter, replaced by the controller of the route of the request if it has
+  // one.
+  ConcurrencyControllerSharedPtr controller_;
   std::unique_ptr<Cleanup> deferred_sample_task_;
 };
 
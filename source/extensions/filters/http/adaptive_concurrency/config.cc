@@ -7,6 +7,8 @@
 #include "source/extensions/filters/http/adaptive_concurrency/adaptive_concurrency_filter.h"
 #include "source/extensions/filters/http/adaptive_concurrency/controller/gradient_controller.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -39,6 +41,24 @@ Http::FilterFactoryCb AdaptiveConcurrencyFilterFactory::createFilterFactoryFromP
   };
 }
 
+Router::RouteSpecificFilterConfigConstSharedPtr
+AdaptiveConcurrencyFilterFactory::createRouteSpecificFilterConfigTyped(
+    const envoy::extensions::filters::http::adaptive_concurrency::v3::AdaptiveConcurrencyPerRoute&
+        config,
+    Server::Configuration::ServerFactoryContext& context, ProtobufMessage::ValidationVisitor&) {
+  using Proto =
+      envoy::extensions::filters::http::adaptive_concurrency::v3::AdaptiveConcurrencyPerRoute;
+  ASSERT(config.concurrency_controller_config_case() ==
+         Proto::ConcurrencyControllerConfigCase::kGradientControllerConfig);
+  auto gradient_controller_config =
+      Controller::GradientControllerConfig(config.gradient_controller_config(), context.runtime());
+  auto controller = std::make_shared<Controller::GradientController>(
+      std::move(gradient_controller_config), context.dispatcher(), context.runtime(),
+      absl::StrCat("adaptive_concurrency.", config.stat_prefix(), ".gradient_controller."),
+      context.scope(), context.api().randomGenerator(), context.timeSource());
+  return std::make_shared<const AdaptiveConcurrencyRouteConfig>(std::move(controller));
+}
+
 /**
  * Static registration for the adaptive_concurrency filter. @see RegisterFactory.
  */
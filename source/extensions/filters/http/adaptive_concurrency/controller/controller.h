@@ -37,6 +37,16 @@ public:
    */
   virtual RequestForwardingAction forwardingDecision() PURE;
 
+  /**
+   * Called during decoding when the adaptive concurrency filter is attempting to forward a request
+   * which may only use a share of the concurrency limit, such as a request of a low priority.
+   * Returns its decision on whether to forward a request.
+   *
+   * @param limit_fraction the share of the concurrency limit the outstanding requests may reach
+   *                       before the request is blocked, in the range [0.0, 1.0].
+   */
+  virtual RequestForwardingAction forwardingDecision(double limit_fraction) PURE;
+
   /**
    * Called during encoding when the request latency is known. Records the
    * request latency to update the internal state of the controller for
@@ -2,6 +2,8 @@
 
 #include <atomic>
 #include <chrono>
+#include <functional>
+#include <thread>
 
 #include "envoy/common/random_generator.h"
 #include "envoy/event/dispatcher.h"
@@ -102,16 +104,42 @@ void GradientController::enterMinRTTSamplingWindow() {
 
   // Throw away any latency samples from before the recalculation window as it may not represent
   // the minRTT.
-  hist_clear(latency_sample_hist_.get());
+  clearSamples();
+  min_rtt_sample_count_.store(0);
 
   min_rtt_epoch_ = time_source_.monotonicTime();
 }
 
+GradientController::SampleShard& GradientController::sampleShard() {
+  return sample_shards_[std::hash<std::thread::id>()(std::this_thread::get_id()) %
+                        NumSampleShards];
+}
+
+void GradientController::mergeSampleShards() {
+  for (SampleShard& shard : sample_shards_) {
+    absl::MutexLock ml(&shard.mtx_);
+    histogram_t* shard_hist = shard.hist_.get();
+    hist_accumulate(latency_sample_hist_.get(), &shard_hist, 1);
+    hist_clear(shard_hist);
+  }
+}
+
+void GradientController::clearSamples() {
+  for (SampleShard& shard : sample_shards_) {
+    absl::MutexLock ml(&shard.mtx_);
+    hist_clear(shard.hist_.get());
+  }
+  hist_clear(latency_sample_hist_.get());
+}
+
 void GradientController::updateMinRTT() {
   // Only update minRTT when it is in minRTT sampling window and
   // number of samples is greater than or equal to the minRTTAggregateRequestCount.
-  if (!inMinRTTSamplingWindow() ||
-      hist_sample_count(latency_sample_hist_.get()) < config_.minRTTAggregateRequestCount()) {
+  if (!inMinRTTSamplingWindow()) {
+    return;
+  }
+  mergeSampleShards();
+  if (hist_sample_count(latency_sample_hist_.get()) < config_.minRTTAggregateRequestCount()) {
     return;
   }
 
@@ -141,6 +169,7 @@ void GradientController::resetSampleWindow() {
   // The sampling window must not be reset while sampling for the new minRTT value.
   ASSERT(!inMinRTTSamplingWindow());
 
+  mergeSampleShards();
   if (hist_sample_count(latency_sample_hist_.get()) == 0) {
     return;
   }
@@ -182,6 +211,10 @@ uint32_t GradientController::calculateNewLimit() {
 }
 
 RequestForwardingAction GradientController::forwardingDecision() {
+  return forwardingDecision(1.0);
+}
+
+RequestForwardingAction GradientController::forwardingDecision(double limit_fraction) {
   // Note that a race condition exists here which would allow more outstanding requests than the
   // concurrency limit bounded by the number of worker threads. After loading num_rq_outstanding_
   // and before loading concurrency_limit_, another thread could potentially swoop in and modify
@@ -189,7 +222,7 @@ RequestForwardingAction GradientController::forwardingDecision() {
   // num_rq_outstanding_.
   //
   // TODO (tonya11en): Reconsider using a CAS loop here.
-  if (num_rq_outstanding_.load() < concurrencyLimit()) {
+  if (num_rq_outstanding_.load() < concurrencyLimit() * limit_fraction) {
     ++num_rq_outstanding_;
     return RequestForwardingAction::Forward;
   }
@@ -211,8 +244,14 @@ void GradientController::recordLatencySample(MonotonicTime rq_send_time) {
                                                             rq_send_time);
   synchronizer_.syncPoint("pre_hist_insert");
   {
+    SampleShard& shard = sampleShard();
+    absl::MutexLock ml(&shard.mtx_);
+    hist_insert(shard.hist_.get(), rq_latency.count(), 1);
+  }
+
+  if (inMinRTTSamplingWindow() &&
+      min_rtt_sample_count_.fetch_add(1) + 1 >= config_.minRTTAggregateRequestCount()) {
     absl::MutexLock ml(&sample_mutation_mtx_);
-    hist_insert(latency_sample_hist_.get(), rq_latency.count(), 1);
     updateMinRTT();
   }
 }
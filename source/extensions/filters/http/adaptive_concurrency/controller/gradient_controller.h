@@ -1,6 +1,8 @@
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <memory>
 #include <vector>
 
 #include "envoy/common/random_generator.h"
@@ -208,6 +210,11 @@ using GradientControllerConfigSharedPtr = std::shared_ptr<GradientControllerConf
  * prevent the overlap of these windows. It is necessary for a worker thread to know specifically if
  * the controller is inside of a minRTT recalculation window during the recording of a latency
  * sample, so this extra bit of information is stored in inMinRTTSamplingWindow().
+ *
+ * The latency samples are recorded into one of several histogram shards picked by the thread, each
+ * with a lock of its own, so that the workers don't contend on the sample mutation mutex for each
+ * sample. The shards are merged into the aggregate histogram when a calculation window ends. Only
+ * the samples completing the minRTT calculation take the sample mutation mutex.
  */
 class GradientController : public ConcurrencyController {
 public:
@@ -223,13 +230,27 @@ public:
 
   // ConcurrencyController.
   RequestForwardingAction forwardingDecision() override;
+  RequestForwardingAction forwardingDecision(double limit_fraction) override;
   void recordLatencySample(MonotonicTime rq_send_time) override;
   void cancelLatencySample() override;
   uint32_t concurrencyLimit() const override { return concurrency_limit_.load(); }
 
 private:
+  // A histogram of the latency samples recorded by some of the threads.
+  struct alignas(64) SampleShard {
+    absl::Mutex mtx_;
+    std::unique_ptr<histogram_t, decltype(&hist_free)> hist_ ABSL_GUARDED_BY(mtx_){
+        hist_fast_alloc(), hist_free};
+  };
+
+  static constexpr size_t NumSampleShards = 16;
+
   static GradientControllerStats generateStats(Stats::Scope& scope,
                                                const std::string& stats_prefix);
+  SampleShard& sampleShard();
+  // Moves the samples of all the shards into the aggregate histogram.
+  void mergeSampleShards() ABSL_EXCLUSIVE_LOCKS_REQUIRED(sample_mutation_mtx_);
+  void clearSamples() ABSL_EXCLUSIVE_LOCKS_REQUIRED(sample_mutation_mtx_);
   void updateMinRTT() ABSL_EXCLUSIVE_LOCKS_REQUIRED(sample_mutation_mtx_);
   std::chrono::microseconds processLatencySamplesAndClear()
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(sample_mutation_mtx_);
@@ -278,6 +299,13 @@ private:
   std::unique_ptr<histogram_t, decltype(&hist_free)>
       latency_sample_hist_ ABSL_GUARDED_BY(sample_mutation_mtx_);
 
+  // The latency samples recorded since the shards were last merged.
+  std::array<SampleShard, NumSampleShards> sample_shards_;
+
+  // Counts the latency samples recorded in the minRTT sampling window, so that the shards are only
+  // merged to update the minRTT once enough samples were recorded.
+  std::atomic<uint32_t> min_rtt_sample_count_{0};
+
   // Tracks the number of consecutive times that the concurrency limit is set to the minimum. This
   // is used to determine whether the controller should trigger an additional minRTT measurement
   // after remaining at the minimum limit for too long.
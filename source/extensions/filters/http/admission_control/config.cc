@@ -32,8 +32,13 @@ Http::FilterFactoryCb AdmissionControlFilterFactory::createFilterFactoryFromProt
   auto sampling_window = std::chrono::seconds(
       PROTOBUF_GET_MS_OR_DEFAULT(config, sampling_window, 1000 * defaultSamplingWindow.count()) /
       1000);
-  tls->set([sampling_window, &context](Event::Dispatcher&) {
-    return std::make_shared<ThreadLocalControllerImpl>(context.timeSource(), sampling_window);
+  WorkerSummariesSharedPtr worker_summaries =
+      config.aggregate_across_workers()
+          ? std::make_shared<WorkerSummaries>(context.timeSource(), sampling_window)
+          : nullptr;
+  tls->set([sampling_window, worker_summaries, &context](Event::Dispatcher&) {
+    return std::make_shared<ThreadLocalControllerImpl>(context.timeSource(), sampling_window,
+                                                       worker_summaries);
   });
 
   std::unique_ptr<ResponseEvaluator> response_evaluator;
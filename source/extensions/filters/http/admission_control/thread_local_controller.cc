@@ -1,5 +1,6 @@
 #include "source/extensions/filters/http/admission_control/thread_local_controller.h"
 
+#include <algorithm>
 #include <cstdint>
 
 #include "envoy/common/pure.h"
@@ -13,43 +14,163 @@ namespace AdmissionControl {
 
 static constexpr std::chrono::seconds defaultHistoryGranularity{1};
 
+namespace {
+
+// Returns the age of a sample started at a time published in a summary.
+std::chrono::microseconds ageOf(MonotonicTime now, MonotonicTime::rep start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      now - MonotonicTime(MonotonicTime::duration(start)));
+}
+
+// Returns the average RPS of the requests of a window whose oldest sample has some age.
+uint32_t averageRpsOf(uint32_t requests, std::chrono::microseconds oldest_sample_age) {
+  using std::chrono::seconds;
+  const seconds secs =
+      std::max(seconds(1), std::chrono::duration_cast<seconds>(oldest_sample_age));
+  return requests / secs.count();
+}
+
+} // namespace
+
+WorkerSummaries::~WorkerSummaries() {
+  Summary* summary = head_.load();
+  while (summary != nullptr) {
+    Summary* next = summary->next_;
+    delete summary;
+    summary = next;
+  }
+}
+
+WorkerSummaries::Summary& WorkerSummaries::acquire() {
+  // Reuse the summary of a worker that went away, such as on a configuration update.
+  for (Summary* summary = head_.load(); summary != nullptr; summary = summary->next_) {
+    bool in_use = false;
+    if (summary->in_use_.compare_exchange_strong(in_use, true)) {
+      return *summary;
+    }
+  }
+
+  auto* summary = new Summary();
+  summary->in_use_.store(true);
+  summary->next_ = head_.load();
+  while (!head_.compare_exchange_weak(summary->next_, summary)) {
+  }
+  return *summary;
+}
+
+void WorkerSummaries::release(Summary& summary) {
+  summary.counts_.store(0, std::memory_order_relaxed);
+  summary.in_use_.store(false);
+}
+
+template <class Callback> void WorkerSummaries::forEachRecentSummary(Callback callback) const {
+  const MonotonicTime now = time_source_.monotonicTime();
+  for (const Summary* summary = head_.load(); summary != nullptr; summary = summary->next_) {
+    const uint64_t counts = summary->counts_.load(std::memory_order_relaxed);
+    // The window of a worker that recorded nothing for a whole window is stale, since the worker
+    // only removes its stale samples when it handles a request.
+    if (counts == 0 ||
+        ageOf(now, summary->newest_sample_.load(std::memory_order_relaxed)) >= sampling_window_) {
+      continue;
+    }
+    callback(static_cast<uint32_t>(counts >> 32), static_cast<uint32_t>(counts),
+             ageOf(now, summary->oldest_sample_.load(std::memory_order_relaxed)));
+  }
+}
+
+ThreadLocalController::RequestData WorkerSummaries::requestCounts() const {
+  ThreadLocalController::RequestData counts;
+  forEachRecentSummary([&counts](uint32_t requests, uint32_t successes, std::chrono::microseconds) {
+    counts.requests += requests;
+    counts.successes += successes;
+  });
+  return counts;
+}
+
+uint32_t WorkerSummaries::averageRps() const {
+  uint32_t rps = 0;
+  forEachRecentSummary(
+      [&rps](uint32_t requests, uint32_t, std::chrono::microseconds oldest_sample_age) {
+        rps += averageRpsOf(requests, oldest_sample_age);
+      });
+  return rps;
+}
+
 ThreadLocalControllerImpl::ThreadLocalControllerImpl(TimeSource& time_source,
-                                                     std::chrono::seconds sampling_window)
-    : time_source_(time_source), sampling_window_(sampling_window) {}
+                                                     std::chrono::seconds sampling_window,
+                                                     WorkerSummariesSharedPtr worker_summaries)
+    : time_source_(time_source),
+      historical_data_(std::max<std::chrono::seconds::rep>(
+          1, sampling_window.count() / defaultHistoryGranularity.count())),
+      sampling_window_(sampling_window), worker_summaries_(std::move(worker_summaries)) {
+  if (worker_summaries_ != nullptr) {
+    summary_ = &worker_summaries_->acquire();
+  }
+}
+
+ThreadLocalControllerImpl::~ThreadLocalControllerImpl() {
+  if (summary_ != nullptr) {
+    worker_summaries_->release(*summary_);
+  }
+}
+
+ThreadLocalController::RequestData ThreadLocalControllerImpl::requestCounts() {
+  maybeUpdateHistoricalData();
+  if (worker_summaries_ != nullptr) {
+    publishSummary();
+    return worker_summaries_->requestCounts();
+  }
+  return global_data_;
+}
 
 uint32_t ThreadLocalControllerImpl::averageRps() const {
-  if (historical_data_.empty() || global_data_.requests == 0) {
+  if (worker_summaries_ != nullptr) {
+    return worker_summaries_->averageRps();
+  }
+  if (sample_count_ == 0 || global_data_.requests == 0) {
     return 0;
   }
-  using std::chrono::seconds;
-  seconds secs = std::max(seconds(1), std::chrono::duration_cast<seconds>(ageOfOldestSample()));
-  return global_data_.requests / secs.count();
+  return averageRpsOf(global_data_.requests, ageOfOldestSample());
 }
 
 void ThreadLocalControllerImpl::maybeUpdateHistoricalData() {
   // Purge stale samples.
-  while (!historical_data_.empty() && ageOfOldestSample() >= sampling_window_) {
+  while (sample_count_ > 0 && ageOfOldestSample() >= sampling_window_) {
     removeOldestSample();
   }
 
   // It's possible we purged stale samples from the history and are left with nothing, so it's
   // necessary to add an empty entry. We will also need to roll over into a new entry in the
   // historical data if we've exceeded the time specified by the granularity.
-  if (historical_data_.empty() || ageOfNewestSample() >= defaultHistoryGranularity) {
-    historical_data_.emplace_back(time_source_.monotonicTime(), RequestData());
+  if (sample_count_ == 0 || ageOfNewestSample() >= defaultHistoryGranularity) {
+    addNewestSample();
   }
 }
 
 void ThreadLocalControllerImpl::recordRequest(bool success) {
   maybeUpdateHistoricalData();
 
-  // The back of the deque will be the most recent samples.
-  ++historical_data_.back().second.requests;
+  ++newestSample().second.requests;
   ++global_data_.requests;
   if (success) {
-    ++historical_data_.back().second.successes;
+    ++newestSample().second.successes;
     ++global_data_.successes;
   }
+  publishSummary();
+}
+
+void ThreadLocalControllerImpl::publishSummary() {
+  if (summary_ == nullptr) {
+    return;
+  }
+  // Only this worker writes to its summary, so the stores need no ordering between each other.
+  summary_->oldest_sample_.store(oldestSample().first.time_since_epoch().count(),
+                                 std::memory_order_relaxed);
+  summary_->newest_sample_.store(newestSample().first.time_since_epoch().count(),
+                                 std::memory_order_relaxed);
+  summary_->counts_.store((static_cast<uint64_t>(global_data_.requests) << 32) |
+                              global_data_.successes,
+                          std::memory_order_relaxed);
 }
 
 } // namespace AdmissionControl
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include "envoy/common/pure.h"
 #include "envoy/common/time.h"
 #include "envoy/http/codes.h"
@@ -42,13 +48,64 @@ public:
   virtual uint32_t averageRps() const PURE;
 };
 
+/**
+ * The request counts of the rolling time windows of all the workers, so that the admission
+ * controllers can make their decisions on the requests of all the workers rather than on their own
+ * only. Each worker publishes a summary of its window with atomic stores, which the other workers
+ * read without taking any locks.
+ */
+class WorkerSummaries {
+public:
+  /**
+   * The summary of the window of a worker, only written to by the worker.
+   */
+  struct alignas(64) Summary {
+    // Set once the summary belongs to a worker.
+    std::atomic<bool> in_use_{false};
+    // The request count in the high bits and the success count in the low bits, so that they are
+    // consistent with each other.
+    std::atomic<uint64_t> counts_{0};
+    // The times the oldest and the newest samples of the window were started at.
+    std::atomic<MonotonicTime::rep> oldest_sample_{0};
+    std::atomic<MonotonicTime::rep> newest_sample_{0};
+    Summary* next_{nullptr};
+  };
+
+  WorkerSummaries(TimeSource& time_source, std::chrono::seconds sampling_window)
+      : time_source_(time_source), sampling_window_(sampling_window) {}
+  ~WorkerSummaries();
+
+  // Returns a summary for a worker to publish to, until it releases it.
+  Summary& acquire();
+  void release(Summary& summary);
+
+  // Returns the request counts of the windows of all the workers.
+  ThreadLocalController::RequestData requestCounts() const;
+
+  // Returns the sum of the average RPS across the windows of all the workers.
+  uint32_t averageRps() const;
+
+private:
+  // Calls the callback with the summaries that had samples in the window.
+  template <class Callback> void forEachRecentSummary(Callback callback) const;
+
+  TimeSource& time_source_;
+  const std::chrono::seconds sampling_window_;
+  // The summaries are never freed before the object is, so that they can be read without locks.
+  std::atomic<Summary*> head_{nullptr};
+};
+
+using WorkerSummariesSharedPtr = std::shared_ptr<WorkerSummaries>;
+
 /**
  * Thread-local object to track request counts and successes over a rolling time window. Request
  * data for the time window is kept recent via a circular buffer that phases out old request/success
  * counts when recording new samples.
  *
  * This controller is thread-local so that we do not need to take any locks on the sample histories
- * to update them, at the cost of decreasing the number of samples.
+ * to update them, at the cost of decreasing the number of samples. If it is given the summaries of
+ * the workers, it publishes the summary of its window and makes its decisions on the request counts
+ * of all the workers.
  *
  * The look-back window for request samples is accurate up to a hard-coded 1-second granularity.
  * TODO (tonya11en): Allow the granularity to be configurable.
@@ -56,60 +113,83 @@ public:
 class ThreadLocalControllerImpl : public ThreadLocalController,
                                   public ThreadLocal::ThreadLocalObject {
 public:
-  ThreadLocalControllerImpl(TimeSource& time_source, std::chrono::seconds sampling_window);
-  ~ThreadLocalControllerImpl() override = default;
+  ThreadLocalControllerImpl(TimeSource& time_source, std::chrono::seconds sampling_window,
+                            WorkerSummariesSharedPtr worker_summaries = nullptr);
+  ~ThreadLocalControllerImpl() override;
   void recordSuccess() override { recordRequest(true); }
   void recordFailure() override { recordRequest(false); }
 
-  RequestData requestCounts() override {
-    maybeUpdateHistoricalData();
-    return global_data_;
-  }
+  RequestData requestCounts() override;
 
   uint32_t averageRps() const override;
 
 private:
+  using Sample = std::pair<MonotonicTime, RequestData>;
+
   void recordRequest(bool success);
 
+  // Publishes the summary of the window for the other workers, if they are aggregated.
+  void publishSummary();
+
+  Sample& oldestSample() { return historical_data_[oldest_]; }
+  const Sample& oldestSample() const { return historical_data_[oldest_]; }
+  Sample& newestSample() {
+    return historical_data_[(oldest_ + sample_count_ - 1) % historical_data_.size()];
+  }
+  const Sample& newestSample() const {
+    return historical_data_[(oldest_ + sample_count_ - 1) % historical_data_.size()];
+  }
+
   // Potentially remove any stale samples and record sample aggregates to the historical data.
   void maybeUpdateHistoricalData();
 
   // Returns the age of the oldest sample in the historical data.
   std::chrono::microseconds ageOfOldestSample() const {
-    ASSERT(!historical_data_.empty());
+    ASSERT(sample_count_ > 0);
     using namespace std::chrono;
-    return duration_cast<microseconds>(time_source_.monotonicTime() -
-                                       historical_data_.front().first);
+    return duration_cast<microseconds>(time_source_.monotonicTime() - oldestSample().first);
   }
 
   // Returns the age of the newest sample in the historical data.
   std::chrono::microseconds ageOfNewestSample() const {
-    ASSERT(!historical_data_.empty());
+    ASSERT(sample_count_ > 0);
     using namespace std::chrono;
-    return duration_cast<microseconds>(time_source_.monotonicTime() -
-                                       historical_data_.back().first);
+    return duration_cast<microseconds>(time_source_.monotonicTime() - newestSample().first);
   }
 
   // Removes the oldest sample in the historical data and reconciles the global data.
   void removeOldestSample() {
-    ASSERT(!historical_data_.empty());
-    global_data_.successes -= historical_data_.front().second.successes;
-    global_data_.requests -= historical_data_.front().second.requests;
-    historical_data_.pop_front();
+    ASSERT(sample_count_ > 0);
+    global_data_.successes -= oldestSample().second.successes;
+    global_data_.requests -= oldestSample().second.requests;
+    oldest_ = (oldest_ + 1) % historical_data_.size();
+    --sample_count_;
+  }
+
+  // Adds an empty sample started now as the newest sample in the historical data.
+  void addNewestSample() {
+    ASSERT(sample_count_ < historical_data_.size());
+    ++sample_count_;
+    newestSample() = {time_source_.monotonicTime(), RequestData()};
   }
 
   TimeSource& time_source_;
 
-  // Stores samples from oldest (front) to newest (back). Since there is no need to read/modify
-  // entries that are not the oldest or newest (front/back), we can get away with using a deque
-  // which allocates memory in chunks and keeps most elements contiguous and cache-friendly.
-  std::deque<std::pair<MonotonicTime, RequestData>> historical_data_;
+  // Stores samples from oldest to newest in a ring buffer, starting at oldest_. The samples are
+  // started at least a second apart and are removed once they are as old as the window, so the
+  // buffer is allocated once with a slot per second of the window.
+  std::vector<Sample> historical_data_;
+  size_t oldest_{0};
+  size_t sample_count_{0};
 
   // Request data aggregated for the whole look-back window.
   RequestData global_data_;
 
   // The rolling time window size.
   const std::chrono::seconds sampling_window_;
+
+  const WorkerSummariesSharedPtr worker_summaries_;
+  WorkerSummaries::Summary* summary_{nullptr};
 };
 
 } // namespace AdmissionControl
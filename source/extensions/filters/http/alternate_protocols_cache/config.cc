@@ -16,7 +16,8 @@ Http::FilterFactoryCb AlternateProtocolsCacheFilterFactory::createFilterFactoryF
         proto_config,
     const std::string&, Server::Configuration::FactoryContext& context) {
   Http::AlternateProtocolsCacheManagerFactoryImpl alternate_protocol_cache_manager_factory(
-      context.singletonManager(), context.dispatcher().timeSource(), context.threadLocal());
+      context.singletonManager(), context.dispatcher().timeSource(), context.threadLocal(),
+      context.api().fileSystem());
   FilterConfigSharedPtr filter_config(std::make_shared<FilterConfig>(
       proto_config, alternate_protocol_cache_manager_factory, context.dispatcher().timeSource()));
   return [filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
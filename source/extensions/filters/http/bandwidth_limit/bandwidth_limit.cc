@@ -8,6 +8,8 @@
 #include "source/common/http/utility.h"
 #include "source/common/stats/timespan_impl.h"
 
+#include "absl/strings/str_cat.h"
+
 using envoy::extensions::filters::http::bandwidth_limit::v3alpha::BandwidthLimit;
 using Envoy::Extensions::HttpFilters::Common::StreamRateLimiter;
 
@@ -17,23 +19,46 @@ namespace HttpFilters {
 namespace BandwidthLimitFilter {
 
 FilterConfig::FilterConfig(const BandwidthLimit& config, Stats::Scope& scope,
-                           Runtime::Loader& runtime, TimeSource& time_source, bool per_route)
+                           Runtime::Loader& runtime, TimeSource& time_source, bool per_route,
+                           BandwidthPoolRegistrySharedPtr pool_registry)
     : runtime_(runtime), time_source_(time_source), enable_mode_(config.enable_mode()),
       limit_kbps_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, limit_kbps, 0)),
       fill_interval_(std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(
           config, fill_interval, StreamRateLimiter::DefaultFillInterval.count()))),
       enabled_(config.runtime_enabled(), runtime),
-      stats_(generateStats(config.stat_prefix(), scope)) {
-  if (per_route && !config.has_limit_kbps()) {
+      stats_(generateStats(config.stat_prefix(), scope)),
+      shared_pool_(config.has_shared_pool() ? absl::make_optional(config.shared_pool())
+                                            : absl::nullopt),
+      pool_registry_(std::move(pool_registry)) {
+  if (per_route && !config.has_limit_kbps() && !config.has_shared_pool()) {
     throw EnvoyException("bandwidthlimitfilter: limit must be set for per route filter config");
   }
+  ASSERT(!shared_pool_.has_value() || pool_registry_ != nullptr);
+
+  route_pool_ = std::make_shared<BandwidthPool>(limit_kbps_, time_source, false);
+}
+
+BandwidthPoolSharedPtr FilterConfig::pool(Http::StreamFilterCallbacks& callbacks,
+                                          absl::string_view direction) const {
+  if (!shared_pool_.has_value()) {
+    return route_pool_;
+  }
 
-  // The token bucket is configured with a max token count of the number of
-  // bytes per second, and refills at the same rate, so that we have a per
-  // second limit which refills gradually in 1/fill_interval increments.
-  token_bucket_ = std::make_shared<SharedTokenBucketImpl>(
-      StreamRateLimiter::kiloBytesToBytes(limit_kbps_), time_source,
-      StreamRateLimiter::kiloBytesToBytes(limit_kbps_));
+  // The streams without a cluster or an IP address share the pool of the empty key.
+  std::string key;
+  if (shared_pool_->key() == SharedPool::CLUSTER) {
+    const Router::RouteConstSharedPtr route = callbacks.route();
+    if (route != nullptr && route->routeEntry() != nullptr) {
+      key = route->routeEntry()->clusterName();
+    }
+  } else if (shared_pool_->key() == SharedPool::DOWNSTREAM_IP) {
+    const auto& address = callbacks.streamInfo().downstreamAddressProvider().remoteAddress();
+    if (address != nullptr && address->ip() != nullptr) {
+      key = address->ip()->addressAsString();
+    }
+  }
+  return pool_registry_->get(shared_pool_->name(), absl::StrCat(direction, ":", key),
+                             shared_pool_->limit_kbps());
 }
 
 BandwidthLimitStats FilterConfig::generateStats(const std::string& prefix, Stats::Scope& scope) {
@@ -50,8 +75,9 @@ Http::FilterHeadersStatus BandwidthLimiter::decodeHeaders(Http::RequestHeaderMap
 
   if (config.enabled() && (config.enableMode() & BandwidthLimit::REQUEST)) {
     config.stats().request_enabled_.inc();
+    const BandwidthPoolSharedPtr pool = config.pool(*decoder_callbacks_, "request");
     request_limiter_ = std::make_unique<StreamRateLimiter>(
-        config.limit(), decoder_callbacks_->decoderBufferLimit(),
+        pool->limit(), decoder_callbacks_->decoderBufferLimit(),
         [this] { decoder_callbacks_->onDecoderFilterAboveWriteBufferHighWatermark(); },
         [this] { decoder_callbacks_->onDecoderFilterBelowWriteBufferLowWatermark(); },
         [this](Buffer::Instance& data, bool end_stream) {
@@ -66,7 +92,7 @@ Http::FilterHeadersStatus BandwidthLimiter::decodeHeaders(Http::RequestHeaderMap
         },
         [config](uint64_t len) { config.stats().request_allowed_size_.set(len); },
         const_cast<FilterConfig*>(&config)->timeSource(), decoder_callbacks_->dispatcher(),
-        decoder_callbacks_->scope(), config.tokenBucket(), config.fillInterval());
+        decoder_callbacks_->scope(), pool->streamBucket(), config.fillInterval());
   }
 
   return Http::FilterHeadersStatus::Continue;
@@ -109,8 +135,9 @@ Http::FilterHeadersStatus BandwidthLimiter::encodeHeaders(Http::ResponseHeaderMa
   if (config.enabled() && (config.enableMode() & BandwidthLimit::RESPONSE)) {
     config.stats().response_enabled_.inc();
 
+    const BandwidthPoolSharedPtr pool = config.pool(*encoder_callbacks_, "response");
     response_limiter_ = std::make_unique<StreamRateLimiter>(
-        config.limit(), encoder_callbacks_->encoderBufferLimit(),
+        pool->limit(), encoder_callbacks_->encoderBufferLimit(),
         [this] { encoder_callbacks_->onEncoderFilterAboveWriteBufferHighWatermark(); },
         [this] { encoder_callbacks_->onEncoderFilterBelowWriteBufferLowWatermark(); },
         [this](Buffer::Instance& data, bool end_stream) {
@@ -125,7 +152,7 @@ Http::FilterHeadersStatus BandwidthLimiter::encodeHeaders(Http::ResponseHeaderMa
         },
         [config](uint64_t len) { config.stats().response_allowed_size_.set(len); },
         const_cast<FilterConfig*>(&config)->timeSource(), encoder_callbacks_->dispatcher(),
-        encoder_callbacks_->scope(), config.tokenBucket(), config.fillInterval());
+        encoder_callbacks_->scope(), pool->streamBucket(), config.fillInterval());
   }
 
   return Http::FilterHeadersStatus::Continue;
@@ -13,13 +13,13 @@
 #include "envoy/stats/timespan.h"
 
 #include "source/common/common/assert.h"
-#include "source/common/common/shared_token_bucket_impl.h"
 #include "source/common/http/header_map_impl.h"
 #include "source/common/router/header_parser.h"
 #include "source/common/runtime/runtime_protos.h"
+#include "source/extensions/filters/http/bandwidth_limit/bandwidth_pool.h"
 #include "source/extensions/filters/http/common/stream_rate_limiter.h"
 
-#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -57,10 +57,13 @@ public:
   using EnableMode =
       envoy::extensions::filters::http::bandwidth_limit::v3alpha::BandwidthLimit_EnableMode;
 
+  using SharedPool =
+      envoy::extensions::filters::http::bandwidth_limit::v3alpha::BandwidthLimit_SharedPool;
+
   FilterConfig(
       const envoy::extensions::filters::http::bandwidth_limit::v3alpha::BandwidthLimit& config,
       Stats::Scope& scope, Runtime::Loader& runtime, TimeSource& time_source,
-      bool per_route = false);
+      bool per_route = false, BandwidthPoolRegistrySharedPtr pool_registry = nullptr);
   ~FilterConfig() override = default;
   Runtime::Loader& runtime() { return runtime_; }
   BandwidthLimitStats& stats() const { return stats_; }
@@ -69,9 +72,18 @@ public:
   uint64_t limit() const { return limit_kbps_; }
   bool enabled() const { return enabled_.enabled(); }
   EnableMode enableMode() const { return enable_mode_; };
-  const std::shared_ptr<SharedTokenBucketImpl> tokenBucket() const { return token_bucket_; }
+  // The pool of the streams of the route, unless they draw from a shared pool.
+  const BandwidthPoolSharedPtr& routePool() const { return route_pool_; }
   std::chrono::milliseconds fillInterval() const { return fill_interval_; }
 
+  /**
+   * @param callbacks supplies the callbacks of the stream.
+   * @param direction supplies the direction of the stream the pool limits.
+   * @return the pool the direction of the stream draws from.
+   */
+  BandwidthPoolSharedPtr pool(Http::StreamFilterCallbacks& callbacks,
+                              absl::string_view direction) const;
+
 private:
   friend class FilterTest;
 
@@ -84,8 +96,10 @@ private:
   const std::chrono::milliseconds fill_interval_;
   const Runtime::FeatureFlag enabled_;
   mutable BandwidthLimitStats stats_;
-  // Filter chain's shared token bucket
-  std::shared_ptr<SharedTokenBucketImpl> token_bucket_;
+  // Filter chain's shared pool
+  BandwidthPoolSharedPtr route_pool_;
+  const absl::optional<SharedPool> shared_pool_;
+  const BandwidthPoolRegistrySharedPtr pool_registry_;
 };
 
 using FilterConfigSharedPtr = std::shared_ptr<FilterConfig>;
@@ -0,0 +1,120 @@
+#include "source/extensions/filters/http/bandwidth_limit/bandwidth_pool.h"
+
+#include <algorithm>
+
+#include "source/common/common/lock_guard.h"
+#include "source/extensions/filters/http/common/stream_rate_limiter.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+
+using Envoy::Extensions::HttpFilters::Common::StreamRateLimiter;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace BandwidthLimitFilter {
+
+/**
+ * The token bucket of a stream, drawing from its pool.
+ */
+class BandwidthPool::StreamBucket : public TokenBucket {
+public:
+  explicit StreamBucket(BandwidthPoolSharedPtr pool) : pool_(std::move(pool)) {
+    pool_->active_streams_.fetch_add(1, std::memory_order_relaxed);
+  }
+  ~StreamBucket() override { pool_->active_streams_.fetch_sub(1, std::memory_order_relaxed); }
+
+  // TokenBucket
+  uint64_t consume(uint64_t tokens, bool allow_partial) override {
+    if (!allow_partial || !pool_->fair_share_) {
+      return pool_->token_bucket_.consume(tokens, allow_partial);
+    }
+    const MonotonicTime now = pool_->time_source_.monotonicTime();
+    const double elapsed =
+        backlogged_since_.has_value()
+            ? std::chrono::duration<double>(now - backlogged_since_.value()).count()
+            : 0;
+    const uint64_t consumed =
+        pool_->token_bucket_.consume([this, tokens, elapsed](uint64_t available) -> uint64_t {
+          const uint64_t streams = std::max<uint64_t>(pool_->activeStreams(), 1);
+          // The stream takes an equal share of the tokens available, rounded up so that the last
+          // stream scheduled still gets the remainder, and at least an equal share of the tokens
+          // refilled since it was last scheduled, as the streams scheduled before it took most of
+          // the tokens available.
+          const uint64_t share =
+              std::max<uint64_t>((available + streams - 1) / streams,
+                                 static_cast<uint64_t>(pool_->fill_rate_ * elapsed / streams));
+          return std::min(tokens, share);
+        });
+    // A stream which sent all its data isn't owed the tokens refilled until it has more.
+    if (consumed < tokens) {
+      backlogged_since_ = now;
+    } else {
+      backlogged_since_.reset();
+    }
+    return consumed;
+  }
+  uint64_t consume(uint64_t tokens, bool allow_partial,
+                   std::chrono::milliseconds& time_to_next_token) override {
+    const uint64_t tokens_consumed = consume(tokens, allow_partial);
+    time_to_next_token = nextTokenAvailable();
+    return tokens_consumed;
+  }
+  std::chrono::milliseconds nextTokenAvailable() override {
+    return pool_->token_bucket_.nextTokenAvailable();
+  }
+  void maybeReset(uint64_t num_tokens) override { pool_->token_bucket_.maybeReset(num_tokens); }
+
+private:
+  const BandwidthPoolSharedPtr pool_;
+  // The last time the stream was scheduled without getting all the tokens it asked for.
+  absl::optional<MonotonicTime> backlogged_since_;
+};
+
+// The token bucket is configured with a max token count of the number of bytes per second, and
+// refills at the same rate, so that we have a per second limit which refills gradually in
+// 1/fill_interval increments.
+BandwidthPool::BandwidthPool(uint64_t limit_kbps, TimeSource& time_source, bool fair_share)
+    : limit_kbps_(limit_kbps), fill_rate_(StreamRateLimiter::kiloBytesToBytes(limit_kbps)),
+      fair_share_(fair_share), time_source_(time_source),
+      token_bucket_(fill_rate_, time_source, fill_rate_) {}
+
+std::shared_ptr<TokenBucket> BandwidthPool::streamBucket() {
+  return std::make_shared<StreamBucket>(shared_from_this());
+}
+
+BandwidthPoolSharedPtr BandwidthPoolRegistry::get(absl::string_view name, absl::string_view key,
+                                                  uint64_t limit_kbps) {
+  // The name is prefixed with its length so that it can't run into the key.
+  const std::string pool_key = absl::StrCat(name.size(), ":", name, key);
+  Thread::LockGuard lock(mutex_);
+  std::weak_ptr<BandwidthPool>& weak_pool = pools_[pool_key];
+  BandwidthPoolSharedPtr pool = weak_pool.lock();
+  if (pool == nullptr) {
+    pool = std::make_shared<BandwidthPool>(limit_kbps, time_source_, true);
+    weak_pool = pool;
+  }
+
+  // The pools of the keys with no stream left, such as the downstream addresses of the clients
+  // which went away, are removed once their number doubled.
+  if (pools_.size() > sweep_size_) {
+    absl::erase_if(pools_, [](const auto& entry) { return entry.second.expired(); });
+    sweep_size_ = std::max(MinSweepSize, 2 * pools_.size());
+  }
+  return pool;
+}
+
+SINGLETON_MANAGER_REGISTRATION(bandwidth_limit_pool_registry);
+
+BandwidthPoolRegistrySharedPtr
+BandwidthPoolRegistry::singleton(Singleton::Manager& singleton_manager, TimeSource& time_source) {
+  return singleton_manager.getTyped<BandwidthPoolRegistry>(
+      SINGLETON_MANAGER_REGISTERED_NAME(bandwidth_limit_pool_registry),
+      [&time_source] { return std::make_shared<BandwidthPoolRegistry>(time_source); });
+}
+
+} // namespace BandwidthLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
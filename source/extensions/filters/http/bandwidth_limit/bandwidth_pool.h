@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/common/token_bucket.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/singleton/manager.h"
+
+#include "source/common/common/atomic_token_bucket_impl.h"
+#include "source/common/common/thread.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace BandwidthLimitFilter {
+
+class BandwidthPool;
+using BandwidthPoolSharedPtr = std::shared_ptr<BandwidthPool>;
+
+/**
+ * The bandwidth shared by the streams of a route, or of a pool shared across the routes and the
+ * listeners. Its token bucket is refilled without a lock.
+ */
+class BandwidthPool : public std::enable_shared_from_this<BandwidthPool> {
+public:
+  /**
+   * @param limit_kbps supplies the limit of the pool in KiB/s.
+   * @param time_source supplies the time source to refill the pool with.
+   * @param fair_share supplies whether each stream only takes about an equal share of the bandwidth
+   *                   when it is scheduled, so that a stream with a lot of buffered data doesn't
+   *                   starve the others. Otherwise a stream takes all the tokens it can.
+   */
+  BandwidthPool(uint64_t limit_kbps, TimeSource& time_source, bool fair_share);
+
+  /**
+   * @return the token bucket of a stream drawing from the pool. The stream takes its share of the
+   *         pool for as long as it holds the bucket, which also keeps the pool alive.
+   */
+  std::shared_ptr<TokenBucket> streamBucket();
+
+  // @return the limit of the pool in KiB/s.
+  uint64_t limit() const { return limit_kbps_; }
+
+  // @return the number of the streams drawing from the pool.
+  uint32_t activeStreams() const { return active_streams_.load(std::memory_order_relaxed); }
+
+private:
+  class StreamBucket;
+
+  const uint64_t limit_kbps_;
+  // The bytes refilled each second, which is also the size of the token bucket.
+  const uint64_t fill_rate_;
+  const bool fair_share_;
+  TimeSource& time_source_;
+  AtomicTokenBucketImpl token_bucket_;
+  std::atomic<uint32_t> active_streams_{0};
+};
+
+/**
+ * The process-wide registry of the bandwidth pools shared across the routes and the listeners,
+ * indexed by their name, direction and key. A pool is only kept while streams draw from it. It is
+ * accessed from the workers when the streams start.
+ */
+class BandwidthPoolRegistry : public Singleton::Instance {
+public:
+  explicit BandwidthPoolRegistry(TimeSource& time_source) : time_source_(time_source) {}
+
+  /**
+   * @param name supplies the name of the pool.
+   * @param key supplies the key of the pool, such as the cluster or the downstream address of the
+   *            stream, if any.
+   * @param limit_kbps supplies the limit of the pool if no stream draws from it yet.
+   * @return the pool of the name and key.
+   */
+  BandwidthPoolSharedPtr get(absl::string_view name, absl::string_view key, uint64_t limit_kbps);
+
+  // Get the registry singleton.
+  static std::shared_ptr<BandwidthPoolRegistry> singleton(Singleton::Manager& singleton_manager,
+                                                          TimeSource& time_source);
+
+private:
+  TimeSource& time_source_;
+  Thread::MutexBasicLockable mutex_;
+  absl::flat_hash_map<std::string, std::weak_ptr<BandwidthPool>> pools_ ABSL_GUARDED_BY(mutex_);
+  // The number of pools above which the pools no stream draws from are removed.
+  size_t sweep_size_ ABSL_GUARDED_BY(mutex_){MinSweepSize};
+
+  static constexpr size_t MinSweepSize = 64;
+};
+
+using BandwidthPoolRegistrySharedPtr = std::shared_ptr<BandwidthPoolRegistry>;
+
+} // namespace BandwidthLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -16,7 +16,8 @@ Http::FilterFactoryCb BandwidthLimitFilterConfig::createFilterFactoryFromProtoTy
     const envoy::extensions::filters::http::bandwidth_limit::v3alpha::BandwidthLimit& proto_config,
     const std::string&, Server::Configuration::FactoryContext& context) {
   FilterConfigSharedPtr filter_config = std::make_shared<FilterConfig>(
-      proto_config, context.scope(), context.runtime(), context.timeSource());
+      proto_config, context.scope(), context.runtime(), context.timeSource(), false,
+      BandwidthPoolRegistry::singleton(context.singletonManager(), context.timeSource()));
   return [filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<BandwidthLimiter>(filter_config));
   };
@@ -26,8 +27,9 @@ Router::RouteSpecificFilterConfigConstSharedPtr
 BandwidthLimitFilterConfig::createRouteSpecificFilterConfigTyped(
     const envoy::extensions::filters::http::bandwidth_limit::v3alpha::BandwidthLimit& proto_config,
     Server::Configuration::ServerFactoryContext& context, ProtobufMessage::ValidationVisitor&) {
-  return std::make_shared<const FilterConfig>(proto_config, context.scope(), context.runtime(),
-                                              context.timeSource(), true);
+  return std::make_shared<const FilterConfig>(
+      proto_config, context.scope(), context.runtime(), context.timeSource(), true,
+      BandwidthPoolRegistry::singleton(context.singletonManager(), context.timeSource()));
 }
 
 /**
@@ -34,6 +34,15 @@ BufferFilterConfig::BufferFilterConfig(
     const envoy::extensions::filters::http::buffer::v3::Buffer& proto_config)
     : settings_(proto_config) {}
 
+BufferFilterConfig::BufferFilterConfig(
+    const envoy::extensions::filters::http::buffer::v3::Buffer& proto_config,
+    const std::string& stats_prefix, Stats::Scope& scope)
+    : settings_(proto_config) {
+  if (proto_config.has_spill()) {
+    spill_ = Buffer::DiskSpill::create(proto_config.spill(), scope, stats_prefix + "buffer.spill.");
+  }
+}
+
 BufferFilter::BufferFilter(BufferFilterConfigSharedPtr config)
     : config_(config), settings_(config->settings()) {}
 
@@ -74,6 +83,7 @@ Http::FilterDataStatus BufferFilter::decodeData(Buffer::Instance& data, bool end
     return Http::FilterDataStatus::Continue;
   }
 
+  maybeSpill(data);
   // Buffer until the complete request has been processed or the ConnectionManagerImpl sends a 413.
   return Http::FilterDataStatus::StopIterationAndBuffer;
 }
@@ -88,6 +98,19 @@ void BufferFilter::setDecoderFilterCallbacks(Http::StreamDecoderFilterCallbacks&
   callbacks_ = &callbacks;
 }
 
+void BufferFilter::maybeSpill(Buffer::Instance& data) {
+  const Buffer::DiskSpillSharedPtr& spill = config_->spill();
+  if (spill == nullptr || content_length_ <= spill->memoryThreshold()) {
+    return;
+  }
+  if (spiller_ == nullptr) {
+    spiller_ = std::make_unique<Buffer::DiskSpiller>(spill);
+  }
+  // The chunks which can't be spilled stay in memory, the request still being bounded by the
+  // buffer limit.
+  spiller_->spill(data);
+}
+
 void BufferFilter::maybeAddContentLength() {
   // request_headers_ is initialized iff plugin is enabled.
   if (request_headers_ != nullptr && request_headers_->ContentLength() == nullptr) {
@@ -7,8 +7,10 @@
 
 #include "envoy/extensions/filters/http/buffer/v3/buffer.pb.h"
 #include "envoy/http/filter.h"
+#include "envoy/stats/scope.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/disk_spill_impl.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -34,11 +36,16 @@ private:
 class BufferFilterConfig {
 public:
   BufferFilterConfig(const envoy::extensions::filters::http::buffer::v3::Buffer& proto_config);
+  BufferFilterConfig(const envoy::extensions::filters::http::buffer::v3::Buffer& proto_config,
+                     const std::string& stats_prefix, Stats::Scope& scope);
 
   const BufferFilterSettings* settings() const { return &settings_; }
+  // The spilling of the buffered requests to disk, or nullptr if not configured.
+  const Buffer::DiskSpillSharedPtr& spill() const { return spill_; }
 
 private:
   const BufferFilterSettings settings_;
+  Buffer::DiskSpillSharedPtr spill_;
 };
 
 using BufferFilterConfigSharedPtr = std::shared_ptr<BufferFilterConfig>;
@@ -63,11 +70,13 @@ public:
 private:
   void initConfig();
   void maybeAddContentLength();
+  void maybeSpill(Buffer::Instance& data);
 
   BufferFilterConfigSharedPtr config_;
   const BufferFilterSettings* settings_;
   Http::StreamDecoderFilterCallbacks* callbacks_{};
   Http::RequestHeaderMap* request_headers_{};
+  Buffer::DiskSpillerPtr spiller_;
   uint64_t content_length_{};
   bool config_initialized_{};
 };
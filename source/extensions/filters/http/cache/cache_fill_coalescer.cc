@@ -0,0 +1,113 @@
+#include "source/extensions/filters/http/cache/cache_fill_coalescer.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/http/header_map_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+void CacheFill::setHeaders(const Http::ResponseHeaderMap& response_headers, bool end_stream) {
+  absl::MutexLock lock(&mutex_);
+  ASSERT(status_ == Status::Pending);
+  response_headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers);
+  status_ = Status::Receiving;
+  if (end_stream) {
+    end();
+  }
+  notifyFollowers();
+}
+
+void CacheFill::addBody(const Buffer::Instance& chunk, bool end_stream) {
+  absl::MutexLock lock(&mutex_);
+  ASSERT(status_ == Status::Receiving);
+  body_.add(chunk);
+  if (end_stream) {
+    end();
+  }
+  notifyFollowers();
+}
+
+void CacheFill::abort() {
+  absl::MutexLock lock(&mutex_);
+  if (status_ == Status::Complete || status_ == Status::Aborted) {
+    return;
+  }
+  status_ = Status::Aborted;
+  end();
+  notifyFollowers();
+}
+
+uint64_t CacheFill::addFollower(Event::Dispatcher& dispatcher, std::function<void()> on_progress) {
+  absl::MutexLock lock(&mutex_);
+  const uint64_t id = next_follower_id_++;
+  followers_.emplace(id, Follower{dispatcher, std::move(on_progress)});
+  return id;
+}
+
+void CacheFill::removeFollower(uint64_t id) {
+  absl::MutexLock lock(&mutex_);
+  followers_.erase(id);
+}
+
+CacheFill::Status CacheFill::read(Http::ResponseHeaderMapPtr* headers, uint64_t body_offset,
+                                  Buffer::Instance& body) {
+  absl::MutexLock lock(&mutex_);
+  if (status_ == Status::Pending || status_ == Status::Aborted) {
+    return status_;
+  }
+  if (headers != nullptr) {
+    *headers = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*response_headers_);
+  }
+  if (body_offset < body_.length()) {
+    // The body stays whole for the followers still reading it, so the bytes are copied.
+    const uint64_t size = body_.length() - body_offset;
+    auto reservation = body.reserveSingleSlice(size);
+    body_.copyOut(body_offset, size, reservation.slice().mem_);
+    reservation.commit(size);
+  }
+  return status_;
+}
+
+void CacheFill::notifyFollowers() {
+  for (const auto& follower : followers_) {
+    follower.second.dispatcher_.post(follower.second.on_progress_);
+  }
+}
+
+void CacheFill::end() {
+  if (status_ != Status::Aborted) {
+    status_ = Status::Complete;
+  }
+  coalescer_->remove(key_, this);
+}
+
+CacheFillSharedPtr CacheFillCoalescer::join(const Key& key, bool& leader) {
+  absl::MutexLock lock(&mutex_);
+  std::weak_ptr<CacheFill>& existing_fill = fills_[key];
+  CacheFillSharedPtr fill = existing_fill.lock();
+  leader = fill == nullptr;
+  if (leader) {
+    fill = std::make_shared<CacheFill>(shared_from_this(), key);
+    existing_fill = fill;
+  }
+  return fill;
+}
+
+void CacheFillCoalescer::remove(const Key& key, const CacheFill* fill) {
+  absl::MutexLock lock(&mutex_);
+  auto it = fills_.find(key);
+  // The fill may have been replaced by another one after all its requests went away.
+  if (it != fills_.end()) {
+    CacheFillSharedPtr existing_fill = it->second.lock();
+    if (existing_fill == nullptr || existing_fill.get() == fill) {
+      fills_.erase(it);
+    }
+  }
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
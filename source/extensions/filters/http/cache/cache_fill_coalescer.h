@@ -0,0 +1,122 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/header_map.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/key.pb.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+class CacheFillCoalescer;
+using CacheFillCoalescerSharedPtr = std::shared_ptr<CacheFillCoalescer>;
+
+/**
+ * A response being fetched from the origin by the first request to miss the cache for it, the
+ * leader of the fill, on behalf of the requests which miss the cache for the same key meanwhile,
+ * its followers. The leader publishes the response as it inserts it into the cache, and the
+ * followers, which may be on other workers, are notified on their own dispatchers as it arrives.
+ * The body is kept until the fill ends, so that a follower joining late is served all of it.
+ */
+class CacheFill {
+public:
+  enum class Status {
+    // The response headers haven't arrived yet.
+    Pending,
+    // The response headers, and possibly some of the body, have arrived.
+    Receiving,
+    // The whole response has arrived.
+    Complete,
+    // The leader gave up on the fill, e.g. as the response wasn't cacheable.
+    Aborted
+  };
+
+  CacheFill(CacheFillCoalescerSharedPtr coalescer, const Key& key)
+      : coalescer_(std::move(coalescer)), key_(key) {}
+
+  // Leader methods, called on the worker of the leader.
+  void setHeaders(const Http::ResponseHeaderMap& response_headers, bool end_stream);
+  void addBody(const Buffer::Instance& chunk, bool end_stream);
+  // Fails the fill over for its followers, if it isn't complete yet.
+  void abort();
+
+  /**
+   * Adds a follower.
+   * @param dispatcher supplies the dispatcher of the worker of the follower.
+   * @param on_progress supplies the callback posted to the dispatcher whenever the fill progresses
+   *        from now on. It has to check that the follower is still alive.
+   * @return an id which removes the follower.
+   */
+  uint64_t addFollower(Event::Dispatcher& dispatcher, std::function<void()> on_progress);
+  void removeFollower(uint64_t id);
+
+  /**
+   * Reads the progress of the fill.
+   * @param headers supplies where to copy the response headers, if set and they have arrived.
+   * @param body_offset supplies the offset of the body from which to copy it into body.
+   * @return the status of the fill. The body copied is the whole body if the fill is complete.
+   */
+  Status read(Http::ResponseHeaderMapPtr* headers, uint64_t body_offset, Buffer::Instance& body);
+
+private:
+  struct Follower {
+    Event::Dispatcher& dispatcher_;
+    std::function<void()> on_progress_;
+  };
+
+  void notifyFollowers() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Called once the fill is complete or aborted.
+  void end() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const CacheFillCoalescerSharedPtr coalescer_;
+  const Key key_;
+  absl::Mutex mutex_;
+  Status status_ ABSL_GUARDED_BY(mutex_){Status::Pending};
+  Http::ResponseHeaderMapPtr response_headers_ ABSL_GUARDED_BY(mutex_);
+  Buffer::OwnedImpl body_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<uint64_t, Follower> followers_ ABSL_GUARDED_BY(mutex_);
+  uint64_t next_follower_id_ ABSL_GUARDED_BY(mutex_){};
+};
+
+using CacheFillSharedPtr = std::shared_ptr<CacheFill>;
+
+/**
+ * The fills in progress of the filters of a cache filter config, by key, shared by all the
+ * workers. Thread safe.
+ */
+class CacheFillCoalescer : public std::enable_shared_from_this<CacheFillCoalescer> {
+public:
+  /**
+   * Joins the fill of a key, which is started if there's none in progress.
+   * @param leader set to whether the fill was started, in which case the caller leads it.
+   * @return the fill.
+   */
+  CacheFillSharedPtr join(const Key& key, bool& leader);
+
+private:
+  friend class CacheFill;
+
+  // Called by a fill once it ends, so that the next requests for its key look up the cache.
+  void remove(const Key& key, const CacheFill* fill);
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<Key, std::weak_ptr<CacheFill>, MessageUtil, MessageUtil>
+      fills_ ABSL_GUARDED_BY(mutex_);
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
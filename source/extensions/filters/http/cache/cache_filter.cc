@@ -5,6 +5,7 @@
 #include "source/common/common/enum_to_int.h"
 #include "source/common/http/headers.h"
 #include "source/common/http/utility.h"
+#include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/http/cache/cache_custom_headers.h"
 #include "source/extensions/filters/http/cache/cacheability_utils.h"
 
@@ -25,18 +26,22 @@ inline bool isResponseNotModified(const Http::ResponseHeaderMap& response_header
 
 struct CacheResponseCodeDetailValues {
   const absl::string_view ResponseFromCacheFilter = "cache.response_from_cache_filter";
+  const absl::string_view ResponseFromCoalescedFill = "cache.response_from_coalesced_fill";
 };
 
 using CacheResponseCodeDetails = ConstSingleton<CacheResponseCodeDetailValues>;
 
 CacheFilter::CacheFilter(
     const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config, const std::string&,
-    Stats::Scope&, TimeSource& time_source, HttpCache& http_cache)
-    : time_source_(time_source), cache_(http_cache),
+    Stats::Scope&, TimeSource& time_source, HttpCache& http_cache,
+    CacheFillCoalescerSharedPtr fill_coalescer)
+    : time_source_(time_source), cache_(http_cache), fill_coalescer_(std::move(fill_coalescer)),
+      fill_timeout_(PROTOBUF_GET_MS_OR_DEFAULT(config, request_coalescing_timeout, 0)),
       vary_allow_list_(config.allowed_vary_headers()) {}
 
 void CacheFilter::onDestroy() {
   filter_state_ = FilterState::Destroyed;
+  leaveFill();
   if (lookup_) {
     lookup_->onDestroy();
   }
@@ -65,6 +70,11 @@ Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::RequestHeaderMap& hea
   LookupRequest lookup_request(headers, time_source_.systemTime(), vary_allow_list_);
   request_allows_inserts_ = !lookup_request.requestCacheControl().no_store_;
   is_head_request_ = headers.getMethodValue() == Http::Headers::get().MethodValues.Head;
+  if (fill_coalescer_ != nullptr && request_allows_inserts_ && !is_head_request_ &&
+      headers.get(Http::Headers::get().Range).empty()) {
+    // Only the requests which would insert the whole response share its fill.
+    fill_key_ = lookup_request.key();
+  }
   lookup_ = cache_.makeLookupContext(std::move(lookup_request));
 
   ASSERT(lookup_);
@@ -77,7 +87,8 @@ Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::RequestHeaderMap& hea
 
 Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& headers,
                                                      bool end_stream) {
-  if (filter_state_ == FilterState::DecodeServingFromCache) {
+  if (filter_state_ == FilterState::DecodeServingFromCache ||
+      filter_state_ == FilterState::DecodeServingFromFill) {
     // This call was invoked during decoding by decoder_callbacks_->encodeHeaders because a fresh
     // cached response was found and is being added to the encoding stream -- ignore it.
     return Http::FilterHeadersStatus::Continue;
@@ -109,11 +120,27 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     const ResponseMetadata metadata = {time_source_.systemTime()};
     insert_->insertHeaders(headers, metadata, end_stream);
   }
+
+  if (leads_fill_) {
+    // The fill is keyed without the vary headers of the request, so the followers can only be
+    // served responses that don't vary.
+    if (insert_ && headers.get(Http::CustomHeaders::get().Vary).empty()) {
+      fill_->setHeaders(headers, end_stream);
+      if (end_stream) {
+        leaveFill();
+      }
+    } else {
+      ENVOY_STREAM_LOG(debug, "CacheFilter::encodeHeaders aborting the fill of the response",
+                       *encoder_callbacks_);
+      leaveFill();
+    }
+  }
   return Http::FilterHeadersStatus::Continue;
 }
 
 Http::FilterDataStatus CacheFilter::encodeData(Buffer::Instance& data, bool end_stream) {
-  if (filter_state_ == FilterState::DecodeServingFromCache) {
+  if (filter_state_ == FilterState::DecodeServingFromCache ||
+      filter_state_ == FilterState::DecodeServingFromFill) {
     // This call was invoked during decoding by decoder_callbacks_->encodeData because a fresh
     // cached response was found and is being added to the encoding stream -- ignore it.
     return Http::FilterDataStatus::Continue;
@@ -128,9 +155,23 @@ Http::FilterDataStatus CacheFilter::encodeData(Buffer::Instance& data, bool end_
     insert_->insertBody(
         data, [](bool) {}, end_stream);
   }
+  if (leads_fill_) {
+    fill_->addBody(data, end_stream);
+    if (end_stream) {
+      leaveFill();
+    }
+  }
   return Http::FilterDataStatus::Continue;
 }
 
+Http::FilterTrailersStatus CacheFilter::encodeTrailers(Http::ResponseTrailerMap&) {
+  if (leads_fill_) {
+    // TODO(toddmgreer): Share trailers with the followers once they are cached.
+    leaveFill();
+  }
+  return Http::FilterTrailersStatus::Continue;
+}
+
 void CacheFilter::getHeaders(Http::RequestHeaderMap& request_headers) {
   ASSERT(lookup_, "CacheFilter is trying to call getHeaders with no LookupContext");
 
@@ -248,6 +289,10 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
     injectValidationHeaders(request_headers);
     break;
   case CacheEntryStatus::Unusable:
+    if (fill_key_.has_value() && joinFill()) {
+      // Decoding continues only if the request stops waiting for the fill it follows.
+      return;
+    }
     break;
   case CacheEntryStatus::NotSatisfiableRange:
     lookup_result_ = std::make_unique<LookupResult>(std::move(result));
@@ -350,6 +395,112 @@ void CacheFilter::onTrailers(Http::ResponseTrailerMapPtr&& trailers) {
   finalizeEncodingCachedResponse();
 }
 
+bool CacheFilter::joinFill() {
+  bool leader;
+  fill_ = fill_coalescer_->join(*fill_key_, leader);
+  if (leader) {
+    leads_fill_ = true;
+    return false;
+  }
+
+  ENVOY_STREAM_LOG(debug, "CacheFilter::joinFill waiting for the fill of another request",
+                   *decoder_callbacks_);
+  filter_state_ = FilterState::WaitingForFill;
+  // The fill may be led from another worker, so it posts the callback to this worker's dispatcher.
+  // A weak_ptr to the CacheFilter is captured, as the CacheFilter may be destroyed before the
+  // posted callback runs.
+  CacheFilterWeakPtr self = weak_from_this();
+  fill_follower_id_ = fill_->addFollower(decoder_callbacks_->dispatcher(), [self]() {
+    if (CacheFilterSharedPtr cache_filter = self.lock()) {
+      cache_filter->onFillProgress();
+    }
+  });
+  fill_timer_ = decoder_callbacks_->dispatcher().createTimer([this]() { onFillTimeout(); });
+  fill_timer_->enableTimer(fill_timeout_);
+  // The response may have started arriving before the request joined the fill.
+  onFillProgress();
+  return true;
+}
+
+void CacheFilter::onFillProgress() {
+  if (filter_state_ == FilterState::Destroyed || fill_ == nullptr) {
+    // The filter is being destroyed, or has already served or left the fill.
+    return;
+  }
+  const bool waiting = filter_state_ == FilterState::WaitingForFill;
+  Http::ResponseHeaderMapPtr headers;
+  Buffer::OwnedImpl body;
+  const CacheFill::Status status =
+      fill_->read(waiting ? &headers : nullptr, fill_body_offset_, body);
+  if (status == CacheFill::Status::Pending) {
+    return;
+  }
+  if (status == CacheFill::Status::Aborted) {
+    if (waiting) {
+      ENVOY_STREAM_LOG(debug, "CacheFilter::onFillProgress fill aborted, going to the origin",
+                       *decoder_callbacks_);
+      onFillTimeout();
+    } else {
+      // Part of the response has already been served.
+      leaveFill();
+      decoder_callbacks_->resetStream();
+    }
+    return;
+  }
+
+  const bool end_stream = status == CacheFill::Status::Complete;
+  if (waiting) {
+    fill_timer_->disableTimer();
+    filter_state_ = FilterState::DecodeServingFromFill;
+    decoder_callbacks_->streamInfo().setResponseFlag(
+        StreamInfo::ResponseFlag::ResponseFromCacheFilter);
+    decoder_callbacks_->streamInfo().setResponseCodeDetails(
+        CacheResponseCodeDetails::get().ResponseFromCoalescedFill);
+    const bool headers_end_stream = end_stream && body.length() == 0;
+    decoder_callbacks_->encodeHeaders(std::move(headers), headers_end_stream,
+                                      CacheResponseCodeDetails::get().ResponseFromCoalescedFill);
+    if (headers_end_stream) {
+      leaveFill();
+      filter_state_ = FilterState::ResponseServedFromCache;
+      return;
+    }
+  }
+  if (body.length() > 0 || end_stream) {
+    fill_body_offset_ += body.length();
+    decoder_callbacks_->encodeData(body, end_stream);
+  }
+  if (end_stream) {
+    leaveFill();
+    filter_state_ = FilterState::ResponseServedFromCache;
+  }
+}
+
+void CacheFilter::onFillTimeout() {
+  ASSERT(filter_state_ == FilterState::WaitingForFill);
+  ENVOY_STREAM_LOG(debug, "CacheFilter::onFillTimeout going to the origin", *decoder_callbacks_);
+  leaveFill();
+  filter_state_ = FilterState::Initial;
+  // decodeHeaders returned StopIteration waiting for the lookup -- continue decoding
+  decoder_callbacks_->continueDecoding();
+}
+
+void CacheFilter::leaveFill() {
+  if (fill_ == nullptr) {
+    return;
+  }
+  if (leads_fill_) {
+    // Does nothing if the fill is complete.
+    fill_->abort();
+  } else {
+    fill_->removeFollower(fill_follower_id_);
+  }
+  if (fill_timer_) {
+    fill_timer_->disableTimer();
+  }
+  fill_ = nullptr;
+  leads_fill_ = false;
+}
+
 void CacheFilter::processSuccessfulValidation(Http::ResponseHeaderMap& response_headers) {
   ASSERT(lookup_result_, "CacheFilter trying to validate a non-existent lookup result");
   ASSERT(
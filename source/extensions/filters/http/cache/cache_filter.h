@@ -5,9 +5,11 @@
 #include <string>
 #include <vector>
 
+#include "envoy/event/timer.h"
 #include "envoy/extensions/filters/http/cache/v3alpha/cache.pb.h"
 
 #include "source/common/common/logger.h"
+#include "source/extensions/filters/http/cache/cache_fill_coalescer.h"
 #include "source/extensions/filters/http/cache/cache_headers_utils.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
@@ -26,7 +28,7 @@ class CacheFilter : public Http::PassThroughFilter,
 public:
   CacheFilter(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
               const std::string& stats_prefix, Stats::Scope& scope, TimeSource& time_source,
-              HttpCache& http_cache);
+              HttpCache& http_cache, CacheFillCoalescerSharedPtr fill_coalescer);
   // Http::StreamFilterBase
   void onDestroy() override;
   // Http::StreamDecoderFilter
@@ -36,6 +38,7 @@ public:
   Http::FilterHeadersStatus encodeHeaders(Http::ResponseHeaderMap& headers,
                                           bool end_stream) override;
   Http::FilterDataStatus encodeData(Buffer::Instance& buffer, bool end_stream) override;
+  Http::FilterTrailersStatus encodeTrailers(Http::ResponseTrailerMap& trailers) override;
 
 private:
   // Utility functions; make any necessary checks and call the corresponding lookup_ functions
@@ -48,6 +51,21 @@ private:
   void onBody(Buffer::InstancePtr&& body);
   void onTrailers(Http::ResponseTrailerMapPtr&& trailers);
 
+  // Precondition: the cache lookup missed, and fill_key_ is set.
+  // Joins the fill of fill_key_, leading it if there's none in progress.
+  // Returns true if the request follows another request's fill, and so waits for it.
+  bool joinFill();
+
+  // Callback for CacheFill to call on the worker thread when the fill progresses.
+  // Serves the response headers and body of the followed fill as they arrive.
+  void onFillProgress();
+
+  // Stops waiting for the followed fill, and lets the request go to the origin.
+  void onFillTimeout();
+
+  // Aborts the led fill, or stops following the followed fill.
+  void leaveFill();
+
   // Precondition: lookup_result_ points to a cache lookup result that requires validation.
   //               filter_state_ is ValidatingCachedResponse.
   // Serves a validated cached response after updating it with a 304 response.
@@ -76,6 +94,9 @@ private:
 
   TimeSource& time_source_;
   HttpCache& cache_;
+  // Null unless request coalescing is configured.
+  const CacheFillCoalescerSharedPtr fill_coalescer_;
+  const std::chrono::milliseconds fill_timeout_;
   LookupContextPtr lookup_;
   InsertContextPtr insert_;
   LookupResultPtr lookup_result_;
@@ -85,6 +106,16 @@ private:
   // onHeaders for Range Responses, otherwise initialized by encodeCachedResponse.
   std::vector<AdjustedByteRange> remaining_ranges_;
 
+  // The key of the request, if its cache fill may be coalesced with the fills of other requests.
+  absl::optional<Key> fill_key_;
+  // The fill that the request leads or follows, if any.
+  CacheFillSharedPtr fill_;
+  bool leads_fill_ = false;
+  uint64_t fill_follower_id_ = 0;
+  // The bytes of the body of the followed fill already served.
+  uint64_t fill_body_offset_ = 0;
+  Event::TimerPtr fill_timer_;
+
   // TODO(#12901): The allow list could be constructed only once directly from the config, instead
   // of doing it per-request. A good example of such config is found in the gzip filter:
   // source/extensions/filters/http/gzip/gzip_filter.h.
@@ -108,6 +139,13 @@ private:
     // Cache lookup found a fresh cached response and it is being added to the encoding stream.
     DecodeServingFromCache,
 
+    // Cache lookup missed, and the request waits for the response of another request for the same
+    // key, which is being fetched from the origin.
+    WaitingForFill,
+
+    // The response of another request is being added to the encoding stream as it arrives.
+    DecodeServingFromFill,
+
     // A cached response was successfully validated and it is being added to the encoding stream
     EncodeServingFromCache,
 
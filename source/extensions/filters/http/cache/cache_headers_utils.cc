@@ -1,5 +1,6 @@
 #include "source/extensions/filters/http/cache/cache_headers_utils.h"
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <string>
@@ -12,7 +13,10 @@
 
 #include "absl/algorithm/container.h"
 #include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
 #include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 
 namespace Envoy {
@@ -230,6 +234,37 @@ CacheHeadersUtils::parseCommaDelimitedList(const Http::HeaderMap::GetResult& ent
   return header_values;
 }
 
+std::string CacheHeadersUtils::normalizeAcceptEncoding(absl::string_view accept_encoding) {
+  std::vector<std::string> codings;
+  for (absl::string_view token :
+       absl::StrSplit(accept_encoding, absl::ByAnyChar(",\r"), absl::SkipWhitespace())) {
+    const std::vector<absl::string_view> params = absl::StrSplit(token, ';');
+    std::string coding = absl::AsciiStrToLower(absl::StripAsciiWhitespace(params[0]));
+    float q_value = 1;
+    bool valid = !coding.empty();
+    for (size_t i = 1; i < params.size(); ++i) {
+      const std::pair<absl::string_view, absl::string_view> param =
+          absl::StrSplit(params[i], absl::MaxSplits('=', 1));
+      if (absl::EqualsIgnoreCase(absl::StripAsciiWhitespace(param.first), "q") &&
+          !absl::SimpleAtof(absl::StripAsciiWhitespace(param.second), &q_value)) {
+        // Like the compressor filter, ignores the codings with an invalid q-value.
+        valid = false;
+      }
+    }
+    if (!valid) {
+      continue;
+    }
+    if (q_value == 0) {
+      codings.push_back(absl::StrCat(coding, ";q=0"));
+    } else if (coding != Http::CustomHeaders::get().AcceptEncodingValues.Identity) {
+      codings.push_back(std::move(coding));
+    }
+  }
+  std::sort(codings.begin(), codings.end());
+  codings.erase(std::unique(codings.begin(), codings.end()), codings.end());
+  return absl::StrJoin(codings, ",");
+}
+
 VaryHeader::VaryHeader(
     const Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>& allow_list) {
 
@@ -308,9 +343,15 @@ std::string VaryHeader::createVaryKey(const Http::HeaderMap::GetResult& vary_hea
     // The config should enable and control the bucketing wanted.
     const auto all_values = Http::HeaderUtility::getAllOfHeaderAsString(
         entry_headers, Http::LowerCaseString(header), in_value_separator);
-    absl::StrAppend(&vary_key, header, in_value_separator,
-                    all_values.result().has_value() ? all_values.result().value() : "",
-                    header_separator);
+    absl::string_view values = all_values.result().has_value() ? all_values.result().value() : "";
+    // The responses compressed by a compressor filter after the cache filter are cached once per
+    // set of accepted codings, rather than once per spelling of accept-encoding.
+    std::string normalized_values;
+    if (absl::EqualsIgnoreCase(header, Http::CustomHeaders::get().AcceptEncoding.get())) {
+      normalized_values = CacheHeadersUtils::normalizeAcceptEncoding(values);
+      values = normalized_values;
+    }
+    absl::StrAppend(&vary_key, header, in_value_separator, values, header_separator);
   }
 
   return vary_key;
@@ -118,6 +118,12 @@ public:
   // Parses the values of a comma-delimited list as defined per
   // https://tools.ietf.org/html/rfc7230#section-7.
   static std::vector<std::string> parseCommaDelimitedList(const Http::HeaderMap::GetResult& entry);
+
+  // Normalizes the values of accept-encoding headers, separated by commas or by the separator of
+  // the values of a vary key, into the sorted set of its content codings, as requests which accept
+  // the same codings can be served the same compressed response. The codings the request refuses
+  // are kept as "coding;q=0", and the identity coding is dropped unless it is refused.
+  static std::string normalizeAcceptEncoding(absl::string_view accept_encoding);
 };
 
 class VaryHeader {
@@ -18,11 +18,17 @@ Http::FilterFactoryCb CacheFilterFactory::createFilterFactoryFromProtoTyped(
         fmt::format("Didn't find a registered implementation for type: '{}'", type));
   }
 
-  return [config, stats_prefix, &context,
-          http_cache_factory](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+  HttpCacheSharedPtr http_cache = http_cache_factory->getCache(config, context);
+  // Shared by the filters created from the config on all the workers.
+  CacheFillCoalescerSharedPtr fill_coalescer;
+  if (config.has_request_coalescing_timeout()) {
+    fill_coalescer = std::make_shared<CacheFillCoalescer>();
+  }
+  return [config, stats_prefix, &context, http_cache,
+          fill_coalescer](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<CacheFilter>(config, stats_prefix, context.scope(),
-                                                            context.timeSource(),
-                                                            http_cache_factory->getCache(config)));
+                                                            context.timeSource(), *http_cache,
+                                                            fill_coalescer));
   };
 }
 
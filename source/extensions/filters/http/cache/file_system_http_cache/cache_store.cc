@@ -0,0 +1,283 @@
+#include "source/extensions/filters/http/cache/file_system_http_cache/cache_store.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include "envoy/common/exception.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/fmt.h"
+#include "source/common/common/utility.h"
+#include "source/common/filesystem/directory.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+namespace {
+
+constexpr char IndexMagic[8] = {'E', 'N', 'V', 'O', 'Y', 'H', 'C', 'I'};
+constexpr uint32_t IndexVersion = 1;
+constexpr uint32_t WaysPerBucket = 4;
+constexpr absl::string_view SegmentPrefix = "segment-";
+
+struct IndexHeader {
+  char magic_[8];
+  uint32_t version_;
+  uint32_t buckets_;
+};
+
+// The slots start on their own cache line.
+constexpr uint64_t IndexHeaderSize = 64;
+static_assert(sizeof(IndexHeader) <= IndexHeaderSize, "index header too large");
+
+} // namespace
+
+CacheStore::Segment::~Segment() { ::close(fd_); }
+
+CacheStore::CacheStore(const std::string& path, uint64_t max_size_bytes,
+                       uint64_t segment_size_bytes, uint32_t index_buckets,
+                       FileSystemHttpCacheStats& stats)
+    : path_(path), max_size_bytes_(max_size_bytes), segment_size_bytes_(segment_size_bytes),
+      stats_(stats) {
+  openIndex(index_buckets);
+  openSegments();
+}
+
+CacheStore::~CacheStore() {
+  ::munmap(index_mapping_, index_size_);
+  ::close(index_fd_);
+}
+
+void CacheStore::openIndex(uint32_t index_buckets) {
+  const std::string index_path = absl::StrCat(path_, "/index");
+  index_fd_ = ::open(index_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (index_fd_ == -1) {
+    throw EnvoyException(
+        fmt::format("unable to open http cache index '{}': {}", index_path, errorDetails(errno)));
+  }
+  index_buckets_ = index_buckets;
+  index_size_ = IndexHeaderSize + uint64_t(index_buckets) * WaysPerBucket * sizeof(IndexSlot);
+
+  struct stat info;
+  const bool same_size =
+      ::fstat(index_fd_, &info) == 0 && static_cast<uint64_t>(info.st_size) == index_size_;
+  void* mapping = MAP_FAILED;
+  if (same_size || (::ftruncate(index_fd_, 0) == 0 && ::ftruncate(index_fd_, index_size_) == 0)) {
+    mapping = ::mmap(nullptr, index_size_, PROT_READ | PROT_WRITE, MAP_SHARED, index_fd_, 0);
+  }
+  if (mapping == MAP_FAILED) {
+    const int error = errno;
+    ::close(index_fd_);
+    throw EnvoyException(
+        fmt::format("unable to map http cache index '{}': {}", index_path, errorDetails(error)));
+  }
+  index_mapping_ = static_cast<uint8_t*>(mapping);
+
+  IndexHeader& header = *reinterpret_cast<IndexHeader*>(index_mapping_);
+  if (!same_size || memcmp(header.magic_, IndexMagic, sizeof(IndexMagic)) != 0 ||
+      header.version_ != IndexVersion || header.buckets_ != index_buckets) {
+    // The index is new or has another layout, so the records it indexed cannot be found anymore.
+    ENVOY_LOG(info, "starting an empty http cache index '{}'", index_path);
+    memset(index_mapping_, 0, index_size_);
+    memcpy(header.magic_, IndexMagic, sizeof(IndexMagic));
+    header.version_ = IndexVersion;
+    header.buckets_ = index_buckets;
+  }
+}
+
+void CacheStore::openSegments() {
+  absl::MutexLock lock(&mutex_);
+  for (const Filesystem::DirectoryEntry& entry : Filesystem::Directory(path_)) {
+    uint32_t id;
+    if (entry.type_ != Filesystem::FileType::Regular ||
+        !absl::StartsWith(entry.name_, SegmentPrefix) ||
+        !absl::SimpleAtoi(absl::string_view(entry.name_).substr(SegmentPrefix.size()), &id) ||
+        id == 0) {
+      continue;
+    }
+    const int fd = ::open(segmentPath(id).c_str(), O_RDWR | O_CLOEXEC);
+    struct stat info;
+    if (fd == -1 || ::fstat(fd, &info) != 0) {
+      ENVOY_LOG(warn, "unable to open http cache segment '{}': {}", segmentPath(id),
+                errorDetails(errno));
+      if (fd != -1) {
+        ::close(fd);
+      }
+      continue;
+    }
+    segments_.emplace(id, SegmentSharedPtr(new Segment{id, fd, uint64_t(info.st_size)}));
+    size_bytes_ += info.st_size;
+    next_segment_id_ = std::max(next_segment_id_, id + 1);
+  }
+  stats_.size_bytes_.set(size_bytes_);
+  // The size bound may have been lowered since the segments were written.
+  while (size_bytes_ > max_size_bytes_) {
+    evictOldestSegment();
+  }
+}
+
+bool CacheStore::startSegment() {
+  const uint32_t id = next_segment_id_++;
+  const int fd = ::open(segmentPath(id).c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd == -1) {
+    ENVOY_LOG_EVERY_POW_2(warn, "unable to create http cache segment '{}': {}", segmentPath(id),
+                          errorDetails(errno));
+    return false;
+  }
+  current_segment_.reset(new Segment{id, fd, 0});
+  segments_.emplace(id, current_segment_);
+  return true;
+}
+
+void CacheStore::evictOldestSegment() {
+  auto oldest = segments_.begin();
+  if (::unlink(segmentPath(oldest->first).c_str()) != 0) {
+    ENVOY_LOG_EVERY_POW_2(warn, "unable to delete http cache segment '{}': {}",
+                          segmentPath(oldest->first), errorDetails(errno));
+  }
+  size_bytes_ -= oldest->second->size_;
+  stats_.size_bytes_.sub(oldest->second->size_);
+  stats_.segment_eviction_.inc();
+  if (oldest->second == current_segment_) {
+    current_segment_ = nullptr;
+  }
+  // Reads of its records still in progress keep the file open.
+  segments_.erase(oldest);
+}
+
+absl::optional<CacheStore::Location> CacheStore::find(uint64_t hash) {
+  absl::MutexLock lock(&mutex_);
+  const IndexSlot* slots = bucket(hash);
+  for (uint32_t way = 0; way < WaysPerBucket; ++way) {
+    const IndexSlot& slot = slots[way];
+    if (slot.segment_ == 0 || slot.hash_ != hash) {
+      continue;
+    }
+    auto segment = segments_.find(slot.segment_);
+    if (segment == segments_.end() || slot.offset_ + slot.size_ > segment->second->size_) {
+      // The segment was evicted, or the slot was garbled by a crash.
+      return absl::nullopt;
+    }
+    return Location{segment->second, slot.offset_, slot.size_};
+  }
+  return absl::nullopt;
+}
+
+bool CacheStore::append(uint64_t hash, absl::string_view record) {
+  SegmentSharedPtr segment;
+  uint64_t offset;
+  {
+    absl::MutexLock lock(&mutex_);
+    if ((current_segment_ == nullptr ||
+         current_segment_->size_ + record.size() > segment_size_bytes_) &&
+        !startSegment()) {
+      stats_.io_error_.inc();
+      return false;
+    }
+    // The record is given its place in the segment right away, so that other records can be
+    // written concurrently.
+    segment = current_segment_;
+    offset = segment->size_;
+    segment->size_ += record.size();
+    size_bytes_ += record.size();
+    stats_.size_bytes_.add(record.size());
+    while (size_bytes_ > max_size_bytes_ && segments_.begin()->second != current_segment_) {
+      evictOldestSegment();
+    }
+  }
+
+  uint64_t written = 0;
+  while (written < record.size()) {
+    const ssize_t rc = ::pwrite(segment->fd_, record.data() + written, record.size() - written,
+                                offset + written);
+    if (rc == -1 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      ENVOY_LOG_EVERY_POW_2(warn, "unable to write http cache segment '{}': {}",
+                            segmentPath(segment->id_), errorDetails(errno));
+      stats_.io_error_.inc();
+      return false;
+    }
+    written += rc;
+  }
+
+  // The record is only indexed once it is written, so it is never read before.
+  absl::MutexLock lock(&mutex_);
+  if (segments_.count(segment->id_) == 0) {
+    return true;
+  }
+  IndexSlot* slots = bucket(hash);
+  IndexSlot* replaced = nullptr;
+  for (uint32_t way = 0; way < WaysPerBucket && replaced == nullptr; ++way) {
+    if (slots[way].segment_ != 0 && slots[way].hash_ == hash) {
+      replaced = &slots[way];
+    }
+  }
+  for (uint32_t way = 0; way < WaysPerBucket && replaced == nullptr; ++way) {
+    if (slots[way].segment_ == 0 || segments_.count(slots[way].segment_) == 0) {
+      replaced = &slots[way];
+    }
+  }
+  if (replaced == nullptr) {
+    // The bucket is full, so the oldest of its records is dropped.
+    replaced = &slots[0];
+    for (uint32_t way = 1; way < WaysPerBucket; ++way) {
+      if (std::make_pair(slots[way].segment_, slots[way].offset_) <
+          std::make_pair(replaced->segment_, replaced->offset_)) {
+        replaced = &slots[way];
+      }
+    }
+  }
+  *replaced = IndexSlot{hash, offset, record.size(), segment->id_, 0};
+  return true;
+}
+
+bool CacheStore::read(const Location& location, uint64_t offset, uint64_t length, char* data) {
+  ASSERT(offset + length <= location.size_);
+  uint64_t done = 0;
+  while (done < length) {
+    const ssize_t rc = ::pread(location.segment_->fd_, data + done, length - done,
+                               location.offset_ + offset + done);
+    if (rc == -1 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      // A short read means that the segment was truncated, e.g. by a crash.
+      ENVOY_LOG_EVERY_POW_2(warn, "unable to read http cache segment '{}': {}",
+                            segmentPath(location.segment_->id_),
+                            rc == 0 ? "unexpected end of file" : errorDetails(errno));
+      stats_.io_error_.inc();
+      return false;
+    }
+    done += rc;
+  }
+  return true;
+}
+
+CacheStore::IndexSlot* CacheStore::bucket(uint64_t hash) const {
+  return reinterpret_cast<IndexSlot*>(index_mapping_ + IndexHeaderSize) +
+         (hash % index_buckets_) * WaysPerBucket;
+}
+
+std::string CacheStore::segmentPath(uint32_t id) const {
+  return absl::StrCat(path_, "/", SegmentPrefix, id);
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All file system http cache stats. @see stats_macros.h
+ */
+#define ALL_FILE_SYSTEM_HTTP_CACHE_STATS(COUNTER, GAUGE)                                           \
+  COUNTER(hit)                                                                                     \
+  COUNTER(insert)                                                                                  \
+  COUNTER(insert_too_large)                                                                        \
+  COUNTER(io_error)                                                                                \
+  COUNTER(miss)                                                                                    \
+  COUNTER(segment_eviction)                                                                        \
+  GAUGE(size_bytes, NeverImport)
+
+/**
+ * Struct definition for all file system http cache stats. @see stats_macros.h
+ */
+struct FileSystemHttpCacheStats {
+  ALL_FILE_SYSTEM_HTTP_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * The files of a FileSystemHttpCache: append-only segment files holding the records of the cached
+ * responses, and a memory-mapped hash index from the hashes of the keys of the records to their
+ * location. Each bucket of the index holds a few records, the oldest of which is replaced when the
+ * bucket is full, and the oldest segment file is deleted once the files reach their size bound.
+ * The index and the segments are kept across restarts, but appends always go to a new segment. It
+ * is thread safe, and does blocking file I/O, so it is only used by the I/O threads of the cache.
+ */
+class CacheStore : Logger::Loggable<Logger::Id::cache_filter> {
+public:
+  /**
+   * @param path supplies the directory of the files, which has to exist.
+   * @param max_size_bytes supplies the maximum size of the segment files.
+   * @param segment_size_bytes supplies the size at which a new segment file is started.
+   * @param index_buckets supplies the number of buckets of the index. An index with a different
+   *        number of buckets is dropped.
+   * @throw EnvoyException if the index cannot be opened or mapped.
+   */
+  CacheStore(const std::string& path, uint64_t max_size_bytes, uint64_t segment_size_bytes,
+             uint32_t index_buckets, FileSystemHttpCacheStats& stats);
+  ~CacheStore();
+
+  struct Segment {
+    ~Segment();
+
+    const uint32_t id_;
+    const int fd_;
+    // The bytes appended or being appended to the segment.
+    uint64_t size_;
+  };
+  using SegmentSharedPtr = std::shared_ptr<Segment>;
+
+  /**
+   * The location of a record. It keeps the segment file open, so the record can be read even once
+   * its segment is evicted.
+   */
+  struct Location {
+    SegmentSharedPtr segment_;
+    uint64_t offset_;
+    uint64_t size_;
+  };
+
+  /**
+   * @return the location of the record last appended with the hash, or nullopt if it was replaced
+   *         or evicted since. The record may have been appended with another key of the same hash.
+   */
+  absl::optional<Location> find(uint64_t hash);
+
+  /**
+   * Appends a record to the current segment, starting a new one when it is full, and indexes it by
+   * the hash, replacing the record previously indexed by it. Evicts the oldest segments to stay
+   * within the size bound.
+   * @return whether the record was written.
+   */
+  bool append(uint64_t hash, absl::string_view record);
+
+  /**
+   * Reads length bytes at offset in a record.
+   * @return whether they were all read.
+   */
+  bool read(const Location& location, uint64_t offset, uint64_t length, char* data);
+
+private:
+  struct IndexSlot {
+    uint64_t hash_;
+    uint64_t offset_;
+    uint64_t size_;
+    // Zero for unused slots, since the segment ids start at one.
+    uint32_t segment_;
+    uint32_t unused_;
+  };
+
+  IndexSlot* bucket(uint64_t hash) const;
+  std::string segmentPath(uint32_t id) const;
+  void openIndex(uint32_t index_buckets);
+  void openSegments();
+  bool startSegment() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void evictOldestSegment() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const std::string path_;
+  const uint64_t max_size_bytes_;
+  const uint64_t segment_size_bytes_;
+  FileSystemHttpCacheStats& stats_;
+  int index_fd_{-1};
+  uint8_t* index_mapping_{};
+  uint64_t index_size_{};
+  uint32_t index_buckets_{};
+
+  absl::Mutex mutex_;
+  // By id, so the oldest first.
+  std::map<uint32_t, SegmentSharedPtr> segments_ ABSL_GUARDED_BY(mutex_);
+  SegmentSharedPtr current_segment_ ABSL_GUARDED_BY(mutex_);
+  uint32_t next_segment_id_ ABSL_GUARDED_BY(mutex_){1};
+  uint64_t size_bytes_ ABSL_GUARDED_BY(mutex_){};
+};
+
+using CacheStorePtr = std::unique_ptr<CacheStore>;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
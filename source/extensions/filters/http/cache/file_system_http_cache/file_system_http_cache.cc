@@ -0,0 +1,475 @@
+#include "source/extensions/filters/http/cache/file_system_http_cache/file_system_http_cache.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "envoy/config/core/v3/base.pb.h"
+#include "envoy/extensions/cache/file_system_http_cache/v3alpha/config.pb.h"
+#include "envoy/extensions/cache/file_system_http_cache/v3alpha/config.pb.validate.h"
+#include "envoy/registry/registry.h"
+#include "envoy/singleton/manager.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/http/headers.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/cache_headers_utils.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+constexpr absl::string_view Name = "envoy.extensions.http.cache.file_system";
+constexpr uint32_t RecordMagic = 0x45484352;
+constexpr uint64_t DefaultSegmentSizeBytes = 256 * 1024 * 1024;
+constexpr uint64_t DefaultMaxEntrySizeBytes = 64 * 1024 * 1024;
+
+// The start of a record, which is followed by the serialized key, the serialized response headers
+// and the body.
+struct RecordHeader {
+  uint32_t magic_;
+  uint32_t key_size_;
+  uint32_t headers_size_;
+  uint32_t unused_;
+  int64_t response_time_us_;
+  uint64_t body_size_;
+};
+
+// Keeps the I/O threads from calling the callbacks of a context once it is destroyed.
+class CallbackGuard {
+public:
+  void destroy() {
+    absl::MutexLock lock(&mutex_);
+    destroyed_ = true;
+  }
+
+  // Runs cb unless the context is destroyed. Destroying the context waits for cb to return.
+  void run(const std::function<void()>& cb) {
+    absl::MutexLock lock(&mutex_);
+    if (!destroyed_) {
+      cb();
+    }
+  }
+
+private:
+  absl::Mutex mutex_;
+  bool destroyed_ ABSL_GUARDED_BY(mutex_){false};
+};
+
+using CallbackGuardSharedPtr = std::shared_ptr<CallbackGuard>;
+
+std::string serializeHeaders(const Http::ResponseHeaderMap& headers) {
+  envoy::config::core::v3::HeaderMap proto;
+  headers.iterate([&proto](const Http::HeaderEntry& header) -> Http::HeaderMap::Iterate {
+    auto* header_value = proto.add_headers();
+    header_value->set_key(std::string(header.key().getStringView()));
+    header_value->set_value(std::string(header.value().getStringView()));
+    return Http::HeaderMap::Iterate::Continue;
+  });
+  return proto.SerializeAsString();
+}
+
+Http::ResponseHeaderMapPtr parseHeaders(absl::string_view data) {
+  envoy::config::core::v3::HeaderMap proto;
+  if (!proto.ParseFromArray(data.data(), data.size())) {
+    return nullptr;
+  }
+  Http::ResponseHeaderMapPtr headers = Http::createHeaderMap<Http::ResponseHeaderMapImpl>({});
+  for (const auto& header : proto.headers()) {
+    headers->addCopy(Http::LowerCaseString(header.key()), header.value());
+  }
+  return headers;
+}
+
+Key variedKey(const Key& key, const Http::HeaderMap::GetResult& vary_header,
+              const Http::RequestHeaderMap& request_vary_headers) {
+  Key varied_key = key;
+  varied_key.add_custom_fields(VaryHeader::createVaryKey(vary_header, request_vary_headers));
+  return varied_key;
+}
+
+uint64_t segmentSizeBytes(
+    const envoy::extensions::cache::file_system_http_cache::v3alpha::FileSystemHttpCacheConfig&
+        config) {
+  return std::min(
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, segment_size_bytes, DefaultSegmentSizeBytes),
+      config.max_cache_size_bytes());
+}
+
+class FileSystemLookupContext : public LookupContext {
+public:
+  FileSystemLookupContext(FileSystemHttpCache& cache, LookupRequest&& request)
+      : cache_(cache), request_(std::make_shared<const LookupRequest>(std::move(request))) {}
+  ~FileSystemLookupContext() override { guard_->destroy(); }
+
+  void getHeaders(LookupHeadersCallback&& cb) override {
+    // The vary headers are copied, since they must not be read off the worker thread.
+    std::shared_ptr<const Http::RequestHeaderMap> vary_headers =
+        Http::createHeaderMap<Http::RequestHeaderMapImpl>(request_->getVaryHeaders());
+    cache_.post([this, &cache = cache_, request = request_, vary_headers, guard = guard_, cb]() {
+      absl::optional<FileSystemHttpCache::Record> record =
+          cache.lookup(request->key(), *vary_headers);
+      guard->run([this, &request, &record, &cb]() {
+        if (!record.has_value()) {
+          cb(LookupResult{});
+          return;
+        }
+        Http::ResponseHeaderMapPtr headers = std::move(record->response_headers_);
+        ResponseMetadata metadata = record->metadata_;
+        const uint64_t body_size = record->body_size_;
+        record_ = std::make_shared<const FileSystemHttpCache::Record>(std::move(*record));
+        cb(request->makeLookupResult(std::move(headers), std::move(metadata), body_size));
+      });
+    });
+  }
+
+  void getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) override {
+    ASSERT(record_ != nullptr && range.end() <= record_->body_size_,
+           "Attempt to read past end of body.");
+    cache_.post([&cache = cache_, record = record_, guard = guard_, range, cb]() {
+      // A null body aborts the response, as the body cannot be read.
+      Buffer::InstancePtr body = cache.readBody(*record, range.begin(), range.length());
+      guard->run([&body, &cb]() { cb(std::move(body)); });
+    });
+  }
+
+  void getTrailers(LookupTrailersCallback&&) override {
+    // TODO(toddmgreer): Support trailers.
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+  }
+
+  void onDestroy() override { guard_->destroy(); }
+
+  const LookupRequest& request() const { return *request_; }
+  // The record found by getHeaders(), or nullptr on a miss.
+  const std::shared_ptr<const FileSystemHttpCache::Record>& record() const { return record_; }
+
+private:
+  FileSystemHttpCache& cache_;
+  const std::shared_ptr<const LookupRequest> request_;
+  const CallbackGuardSharedPtr guard_{std::make_shared<CallbackGuard>()};
+  // Set by an I/O thread before the callback of getHeaders(), and only read after it.
+  std::shared_ptr<const FileSystemHttpCache::Record> record_;
+};
+
+// A complete response, owned by the I/O thread writing it.
+struct PendingInsert {
+  Key key_;
+  Http::ResponseHeaderMapPtr response_headers_;
+  ResponseMetadata metadata_;
+  Buffer::OwnedImpl body_;
+  Http::RequestHeaderMapPtr vary_headers_;
+};
+
+class FileSystemInsertContext : public InsertContext {
+public:
+  FileSystemInsertContext(FileSystemHttpCache& cache, const LookupRequest& request)
+      : cache_(cache), pending_(std::make_shared<PendingInsert>()) {
+    pending_->key_ = request.key();
+    pending_->vary_headers_ =
+        Http::createHeaderMap<Http::RequestHeaderMapImpl>(request.getVaryHeaders());
+  }
+
+  void insertHeaders(const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata, bool end_stream) override {
+    ASSERT(!committed_);
+    pending_->response_headers_ =
+        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers);
+    pending_->metadata_ = metadata;
+    if (end_stream) {
+      commit();
+    }
+  }
+
+  void insertBody(const Buffer::Instance& chunk, InsertCallback ready_for_next_chunk,
+                  bool end_stream) override {
+    ASSERT(!committed_);
+    ASSERT(ready_for_next_chunk || end_stream);
+
+    pending_->body_.add(chunk);
+    if (pending_->response_headers_->byteSize() + pending_->body_.length() >
+        cache_.maxEntrySizeBytes()) {
+      // Buffering the rest of the response would be wasted.
+      committed_ = true;
+      cache_.stats().insert_too_large_.inc();
+      if (!end_stream) {
+        ready_for_next_chunk(false);
+      }
+      return;
+    }
+    if (end_stream) {
+      commit();
+    } else {
+      ready_for_next_chunk(true);
+    }
+  }
+
+  void insertTrailers(const Http::ResponseTrailerMap&) override {
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE; // TODO(toddmgreer): support trailers
+  }
+
+  // The I/O threads never call back into the context.
+  void onDestroy() override {}
+
+private:
+  void commit() {
+    committed_ = true;
+    cache_.post([&cache = cache_, pending = std::move(pending_)]() {
+      cache.insert(pending->key_, *pending->response_headers_, pending->metadata_,
+                   pending->body_.toString(), *pending->vary_headers_);
+    });
+  }
+
+  FileSystemHttpCache& cache_;
+  std::shared_ptr<PendingInsert> pending_;
+  bool committed_ = false;
+};
+
+} // namespace
+
+FileSystemHttpCache::FileSystemHttpCache(
+    const envoy::extensions::cache::file_system_http_cache::v3alpha::FileSystemHttpCacheConfig&
+        config,
+    Stats::Scope& scope, Thread::ThreadFactory& thread_factory)
+    : max_entry_size_bytes_(std::min(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entry_size_bytes, DefaultMaxEntrySizeBytes),
+          segmentSizeBytes(config))),
+      stats_(generateStats(scope, absl::StrCat("http_cache.file_system.", config.name()))),
+      store_(std::make_unique<CacheStore>(config.cache_path(), config.max_cache_size_bytes(),
+                                          segmentSizeBytes(config),
+                                          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, index_buckets,
+                                                                          65536),
+                                          stats_)),
+      io_threads_(std::make_unique<IoThreadPool>(
+          thread_factory, PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, io_threads, 4))) {}
+
+FileSystemHttpCacheStats FileSystemHttpCache::generateStats(Stats::Scope& scope,
+                                                            const std::string& prefix) {
+  return {ALL_FILE_SYSTEM_HTTP_CACHE_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                           POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+LookupContextPtr FileSystemHttpCache::makeLookupContext(LookupRequest&& request) {
+  return std::make_unique<FileSystemLookupContext>(*this, std::move(request));
+}
+
+InsertContextPtr FileSystemHttpCache::makeInsertContext(LookupContextPtr&& lookup_context) {
+  ASSERT(lookup_context != nullptr);
+  return std::make_unique<FileSystemInsertContext>(
+      *this, dynamic_cast<FileSystemLookupContext&>(*lookup_context).request());
+}
+
+void FileSystemHttpCache::updateHeaders(const LookupContext& lookup_context,
+                                        const Http::ResponseHeaderMap& response_headers,
+                                        const ResponseMetadata& metadata) {
+  const auto& context = dynamic_cast<const FileSystemLookupContext&>(lookup_context);
+  std::shared_ptr<const Record> record = context.record();
+  if (record == nullptr) {
+    return;
+  }
+  const auto vary_header = response_headers.get(Http::CustomHeaders::get().Vary);
+  Key key = vary_header.empty() ? context.request().key()
+                                : variedKey(context.request().key(), vary_header,
+                                            context.request().getVaryHeaders());
+  std::shared_ptr<const Http::ResponseHeaderMap> headers =
+      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers);
+  post([this, key = std::move(key), record, headers, metadata]() {
+    // The records are never modified, so the body is copied to a new record with the headers.
+    std::string body(record->body_size_, '\0');
+    if (!body.empty() &&
+        !store_->read(record->location_, record->body_offset_, body.size(), body.data())) {
+      return;
+    }
+    write(key, *headers, metadata, body);
+  });
+}
+
+CacheInfo FileSystemHttpCache::cacheInfo() const {
+  CacheInfo cache_info;
+  cache_info.name_ = Name;
+  return cache_info;
+}
+
+absl::optional<FileSystemHttpCache::Record>
+FileSystemHttpCache::lookup(const Key& key, const Http::RequestHeaderMap& request_vary_headers) {
+  absl::optional<Record> record = readRecord(key);
+  if (record.has_value()) {
+    const auto vary_header = record->response_headers_->get(Http::CustomHeaders::get().Vary);
+    if (!vary_header.empty()) {
+      // The response varies, so it is cached under the vary key of the request.
+      record = readRecord(variedKey(key, vary_header, request_vary_headers));
+    }
+  }
+  if (record.has_value()) {
+    stats_.hit_.inc();
+  } else {
+    stats_.miss_.inc();
+  }
+  return record;
+}
+
+Buffer::InstancePtr FileSystemHttpCache::readBody(const Record& record, uint64_t offset,
+                                                  uint64_t length) {
+  length = std::min(length, MaxReadSizeBytes);
+  auto body = std::make_unique<Buffer::OwnedImpl>();
+  // The body is read straight into the slice of the buffer.
+  auto reservation = body->reserveSingleSlice(length);
+  if (!store_->read(record.location_, record.body_offset_ + offset, length,
+                    static_cast<char*>(reservation.slice().mem_))) {
+    return nullptr;
+  }
+  reservation.commit(length);
+  return body;
+}
+
+void FileSystemHttpCache::insert(const Key& key, const Http::ResponseHeaderMap& response_headers,
+                                 const ResponseMetadata& metadata, absl::string_view body,
+                                 const Http::RequestHeaderMap& request_vary_headers) {
+  const auto vary_header = response_headers.get(Http::CustomHeaders::get().Vary);
+  if (vary_header.empty()) {
+    write(key, response_headers, metadata, body);
+    return;
+  }
+
+  write(variedKey(key, vary_header, request_vary_headers), response_headers, metadata, body);
+  // Flags that the responses for the key vary, and on which headers.
+  Http::ResponseHeaderMapPtr vary_only_headers =
+      Http::createHeaderMap<Http::ResponseHeaderMapImpl>({});
+  for (size_t i = 0; i < vary_header.size(); ++i) {
+    vary_only_headers->addCopy(Http::CustomHeaders::get().Vary,
+                               vary_header[i]->value().getStringView());
+  }
+  write(key, *vary_only_headers, {}, "");
+}
+
+absl::optional<FileSystemHttpCache::Record> FileSystemHttpCache::readRecord(const Key& key) {
+  absl::optional<CacheStore::Location> location = store_->find(stableHashKey(key));
+  if (!location.has_value()) {
+    return absl::nullopt;
+  }
+  RecordHeader header;
+  if (location->size_ < sizeof(header) ||
+      !store_->read(*location, 0, sizeof(header), reinterpret_cast<char*>(&header))) {
+    return absl::nullopt;
+  }
+  const uint64_t body_offset = sizeof(header) + uint64_t(header.key_size_) + header.headers_size_;
+  if (header.magic_ != RecordMagic || body_offset + header.body_size_ != location->size_) {
+    ENVOY_LOG_EVERY_POW_2(warn, "dropping a corrupt http cache record");
+    stats_.io_error_.inc();
+    return absl::nullopt;
+  }
+
+  std::string data(body_offset - sizeof(header), '\0');
+  if (!store_->read(*location, sizeof(header), data.size(), data.data())) {
+    return absl::nullopt;
+  }
+  Key record_key;
+  if (!record_key.ParseFromArray(data.data(), header.key_size_) ||
+      !Protobuf::util::MessageDifferencer::Equals(key, record_key)) {
+    // The record is of another key of the same hash.
+    return absl::nullopt;
+  }
+  Http::ResponseHeaderMapPtr response_headers =
+      parseHeaders(absl::string_view(data).substr(header.key_size_));
+  if (response_headers == nullptr) {
+    ENVOY_LOG_EVERY_POW_2(warn, "dropping a corrupt http cache record");
+    stats_.io_error_.inc();
+    return absl::nullopt;
+  }
+  const SystemTime response_time(std::chrono::duration_cast<SystemTime::duration>(
+      std::chrono::microseconds(header.response_time_us_)));
+  return Record{std::move(*location), std::move(response_headers), ResponseMetadata{response_time},
+                body_offset, header.body_size_};
+}
+
+void FileSystemHttpCache::write(const Key& key, const Http::ResponseHeaderMap& response_headers,
+                                const ResponseMetadata& metadata, absl::string_view body) {
+  const std::string key_data = key.SerializeAsString();
+  const std::string headers_data = serializeHeaders(response_headers);
+  const RecordHeader header{
+      RecordMagic,
+      static_cast<uint32_t>(key_data.size()),
+      static_cast<uint32_t>(headers_data.size()),
+      0,
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          metadata.response_time_.time_since_epoch())
+          .count(),
+      body.size()};
+  std::string record;
+  record.reserve(sizeof(header) + key_data.size() + headers_data.size() + body.size());
+  record.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  record.append(key_data);
+  record.append(headers_data);
+  record.append(body.data(), body.size());
+  if (store_->append(stableHashKey(key), record)) {
+    stats_.insert_.inc();
+  }
+}
+
+FileSystemHttpCacheSharedPtr FileSystemHttpCacheManager::getCache(
+    const envoy::extensions::cache::file_system_http_cache::v3alpha::FileSystemHttpCacheConfig&
+        config) {
+  auto existing_cache = caches_.find(config.cache_path());
+  if (existing_cache != caches_.end()) {
+    FileSystemHttpCacheSharedPtr cache = existing_cache->second.cache_.lock();
+    if (cache != nullptr) {
+      if (!Protobuf::util::MessageDifferencer::Equivalent(config, existing_cache->second.config_)) {
+        throw EnvoyException(
+            fmt::format("config specified file system http cache '{}' with different settings",
+                        config.cache_path()));
+      }
+      return cache;
+    }
+  }
+
+  auto cache = std::make_shared<FileSystemHttpCache>(config, root_scope_, thread_factory_);
+  caches_.insert_or_assign(config.cache_path(), ActiveCache{config, cache});
+  return cache;
+}
+
+SINGLETON_MANAGER_REGISTRATION(file_system_http_cache_manager);
+
+class FileSystemHttpCacheFactory : public HttpCacheFactory {
+public:
+  // From UntypedFactory
+  std::string name() const override { return std::string(Name); }
+  // From TypedFactory
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<
+        envoy::extensions::cache::file_system_http_cache::v3alpha::FileSystemHttpCacheConfig>();
+  }
+  // From HttpCacheFactory
+  HttpCacheSharedPtr
+  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
+           Server::Configuration::FactoryContext& context) override {
+    envoy::extensions::cache::file_system_http_cache::v3alpha::FileSystemHttpCacheConfig
+        cache_config;
+    MessageUtil::anyConvertAndValidate(config.typed_config(), cache_config,
+                                       context.messageValidationVisitor());
+    FileSystemHttpCacheManagerSharedPtr manager =
+        context.singletonManager().getTyped<FileSystemHttpCacheManager>(
+            SINGLETON_MANAGER_REGISTERED_NAME(file_system_http_cache_manager), [&context] {
+              return std::make_shared<FileSystemHttpCacheManager>(
+                  context.getServerFactoryContext().scope(), context.api().threadFactory());
+            });
+    // The filters using the cache also hold the manager, so that the filters configured later with
+    // the same directory find the cache.
+    auto holder =
+        std::make_shared<std::pair<FileSystemHttpCacheManagerSharedPtr, HttpCacheSharedPtr>>(
+            manager, manager->getCache(cache_config));
+    return HttpCacheSharedPtr(holder, holder->second.get());
+  }
+};
+
+static Registry::RegisterFactory<FileSystemHttpCacheFactory, HttpCacheFactory> register_;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/cache/file_system_http_cache/v3alpha/config.pb.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/stats/scope.h"
+#include "envoy/thread/thread.h"
+
+#include "source/extensions/filters/http/cache/file_system_http_cache/cache_store.h"
+#include "source/extensions/filters/http/cache/file_system_http_cache/io_thread_pool.h"
+#include "source/extensions/filters/http/cache/http_cache.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * A cache stored in a directory of the local file system, @see CacheStore for the files. The
+ * lookups and inserts only queue their file I/O to the I/O threads of the cache, which call the
+ * callbacks of the cache filter, so the workers never wait for the disk. The headers of a response
+ * are read on lookup, and its body is read range by range as the cache filter asks for it. The
+ * responses are buffered in memory until they are complete, and then written at once.
+ */
+class FileSystemHttpCache : public HttpCache, Logger::Loggable<Logger::Id::cache_filter> {
+public:
+  /**
+   * @throw EnvoyException if the files of the cache cannot be opened.
+   */
+  FileSystemHttpCache(
+      const envoy::extensions::cache::file_system_http_cache::v3alpha::FileSystemHttpCacheConfig&
+          config,
+      Stats::Scope& scope, Thread::ThreadFactory& thread_factory);
+
+  // HttpCache
+  LookupContextPtr makeLookupContext(LookupRequest&& request) override;
+  InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context) override;
+  void updateHeaders(const LookupContext& lookup_context,
+                     const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata) override;
+  CacheInfo cacheInfo() const override;
+
+  // A record read from the files, without its body.
+  struct Record {
+    CacheStore::Location location_;
+    Http::ResponseHeaderMapPtr response_headers_;
+    ResponseMetadata metadata_;
+    // The offset of the body in the record.
+    uint64_t body_offset_;
+    uint64_t body_size_;
+  };
+
+  /**
+   * Reads the record of a request, following the vary header of the response to the record of
+   * the variant of the request. Called on the I/O threads.
+   * @return the record, or nullopt on a miss.
+   */
+  absl::optional<Record> lookup(const Key& key, const Http::RequestHeaderMap& request_vary_headers);
+
+  /**
+   * Reads length bytes of a body at offset, at most MaxReadSizeBytes. Called on the I/O threads.
+   * @return the bytes read, or nullptr on an error.
+   */
+  Buffer::InstancePtr readBody(const Record& record, uint64_t offset, uint64_t length);
+
+  /**
+   * Writes a response, and for a response which varies, a record with just its vary header under
+   * the key of the request. Called on the I/O threads.
+   */
+  void insert(const Key& key, const Http::ResponseHeaderMap& response_headers,
+              const ResponseMetadata& metadata, absl::string_view body,
+              const Http::RequestHeaderMap& request_vary_headers);
+
+  /**
+   * Queues file I/O to the I/O threads.
+   */
+  void post(std::function<void()> cb) { io_threads_->post(std::move(cb)); }
+
+  uint64_t maxEntrySizeBytes() const { return max_entry_size_bytes_; }
+  FileSystemHttpCacheStats& stats() { return stats_; }
+
+  // The largest chunk of a body read at once.
+  static constexpr uint64_t MaxReadSizeBytes = 1024 * 1024;
+
+private:
+  static FileSystemHttpCacheStats generateStats(Stats::Scope& scope, const std::string& prefix);
+  absl::optional<Record> readRecord(const Key& key);
+  void write(const Key& key, const Http::ResponseHeaderMap& response_headers,
+             const ResponseMetadata& metadata, absl::string_view body);
+
+  const uint64_t max_entry_size_bytes_;
+  FileSystemHttpCacheStats stats_;
+  CacheStorePtr store_;
+  // Destroyed first, so that no I/O is in progress once the rest of the cache is destroyed.
+  std::unique_ptr<IoThreadPool> io_threads_;
+};
+
+using FileSystemHttpCacheSharedPtr = std::shared_ptr<FileSystemHttpCache>;
+
+/**
+ * Keeps the caches by directory, so that the cache filters configured with the same directory,
+ * including the filters of a listener and of its update, share a cache.
+ */
+class FileSystemHttpCacheManager : public Singleton::Instance {
+public:
+  FileSystemHttpCacheManager(Stats::Scope& root_scope, Thread::ThreadFactory& thread_factory)
+      : root_scope_(root_scope), thread_factory_(thread_factory) {}
+
+  /**
+   * @return the cache of the directory of the config, which is created if no filter uses it
+   *         anymore.
+   * @throw EnvoyException if the cache is in use with a different config, or cannot be opened.
+   */
+  FileSystemHttpCacheSharedPtr getCache(
+      const envoy::extensions::cache::file_system_http_cache::v3alpha::FileSystemHttpCacheConfig&
+          config);
+
+private:
+  struct ActiveCache {
+    envoy::extensions::cache::file_system_http_cache::v3alpha::FileSystemHttpCacheConfig config_;
+    std::weak_ptr<FileSystemHttpCache> cache_;
+  };
+
+  Stats::Scope& root_scope_;
+  Thread::ThreadFactory& thread_factory_;
+  absl::flat_hash_map<std::string, ActiveCache> caches_;
+};
+
+using FileSystemHttpCacheManagerSharedPtr = std::shared_ptr<FileSystemHttpCacheManager>;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,54 @@
+#include "source/extensions/filters/http/cache/file_system_http_cache/io_thread_pool.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+IoThreadPool::IoThreadPool(Thread::ThreadFactory& thread_factory, uint32_t num_threads) {
+  threads_.reserve(num_threads);
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads_.push_back(thread_factory.createThread([this]() { threadRoutine(); },
+                                                   Thread::Options{"HttpCacheIo"}));
+  }
+}
+
+IoThreadPool::~IoThreadPool() {
+  {
+    Thread::LockGuard lock(mutex_);
+    stopping_ = true;
+    cond_var_.notifyAll();
+  }
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+void IoThreadPool::post(std::function<void()> cb) {
+  Thread::LockGuard lock(mutex_);
+  queue_.push_back(std::move(cb));
+  cond_var_.notifyOne();
+}
+
+void IoThreadPool::threadRoutine() {
+  while (true) {
+    std::function<void()> cb;
+    {
+      Thread::LockGuard lock(mutex_);
+      while (!stopping_ && queue_.empty()) {
+        cond_var_.wait(mutex_);
+      }
+      if (stopping_) {
+        return;
+      }
+      cb = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    cb();
+  }
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
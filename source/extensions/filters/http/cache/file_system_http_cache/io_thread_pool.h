@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/thread.h"
+
+#include "absl/base/thread_annotations.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * The threads doing the file I/O of a FileSystemHttpCache, so that the workers never block on
+ * the disk.
+ */
+class IoThreadPool {
+public:
+  IoThreadPool(Thread::ThreadFactory& thread_factory, uint32_t num_threads);
+  ~IoThreadPool();
+
+  /**
+   * Queues cb to run on the first free thread. Callbacks still queued when the pool is destroyed
+   * are dropped.
+   */
+  void post(std::function<void()> cb);
+
+private:
+  void threadRoutine();
+
+  Thread::MutexBasicLockable mutex_;
+  Thread::CondVar cond_var_;
+  std::deque<std::function<void()>> queue_ ABSL_GUARDED_BY(mutex_);
+  bool stopping_ ABSL_GUARDED_BY(mutex_){false};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,374 @@
+#include "source/extensions/filters/http/cache/sharded_http_cache/sharded_http_cache.h"
+
+#include <algorithm>
+
+#include "envoy/extensions/cache/sharded_http_cache/v3alpha/config.pb.h"
+#include "envoy/extensions/cache/sharded_http_cache/v3alpha/config.pb.validate.h"
+#include "envoy/registry/registry.h"
+#include "envoy/singleton/manager.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/macros.h"
+#include "source/common/http/header_map_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+class ShardedLookupContext : public LookupContext {
+public:
+  ShardedLookupContext(ShardedHttpCache& cache, LookupRequest&& request)
+      : cache_(cache), request_(std::move(request)) {}
+
+  void getHeaders(LookupHeadersCallback&& cb) override {
+    auto entry = cache_.lookup(request_);
+    body_ = std::move(entry.body_);
+    cb(entry.response_headers_
+           ? request_.makeLookupResult(std::move(entry.response_headers_),
+                                       std::move(entry.metadata_), body_->size())
+           : LookupResult{});
+  }
+
+  void getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) override {
+    ASSERT(body_ != nullptr && range.end() <= body_->size(), "Attempt to read past end of body.");
+    // The fragment references the cached body, which it keeps alive until it is drained.
+    auto* fragment = new Buffer::BufferFragmentImpl(
+        body_->data() + range.begin(), range.length(),
+        [body = body_](const void*, size_t, const Buffer::BufferFragmentImpl* fragment) {
+          delete fragment;
+        });
+    auto buffer = std::make_unique<Buffer::OwnedImpl>();
+    buffer->addBufferFragment(*fragment);
+    cb(std::move(buffer));
+  }
+
+  void getTrailers(LookupTrailersCallback&&) override {
+    // TODO(toddmgreer): Support trailers.
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+  }
+
+  const LookupRequest& request() const { return request_; }
+  void onDestroy() override {}
+
+private:
+  ShardedHttpCache& cache_;
+  const LookupRequest request_;
+  std::shared_ptr<const std::string> body_;
+};
+
+class ShardedInsertContext : public InsertContext {
+public:
+  ShardedInsertContext(LookupContextPtr&& lookup_context, ShardedHttpCache& cache)
+      : lookup_context_(std::move(lookup_context)),
+        request_(dynamic_cast<ShardedLookupContext&>(*lookup_context_).request()), cache_(cache) {}
+
+  void insertHeaders(const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata, bool end_stream) override {
+    ASSERT(!committed_);
+    response_headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers);
+    metadata_ = metadata;
+    if (end_stream) {
+      commit();
+    }
+  }
+
+  void insertBody(const Buffer::Instance& chunk, InsertCallback ready_for_next_chunk,
+                  bool end_stream) override {
+    ASSERT(!committed_);
+    ASSERT(ready_for_next_chunk || end_stream);
+
+    body_.add(chunk);
+    if (response_headers_->byteSize() + body_.length() > cache_.maxEntrySizeBytes()) {
+      // Buffering the rest of the response would be wasted.
+      committed_ = true;
+      cache_.stats().insert_too_large_.inc();
+      if (!end_stream) {
+        ready_for_next_chunk(false);
+      }
+      return;
+    }
+    if (end_stream) {
+      commit();
+    } else {
+      ready_for_next_chunk(true);
+    }
+  }
+
+  void insertTrailers(const Http::ResponseTrailerMap&) override {
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE; // TODO(toddmgreer): support trailers
+  }
+
+  void onDestroy() override {}
+
+private:
+  void commit() {
+    committed_ = true;
+    cache_.insert(request_.key(), std::move(response_headers_), std::move(metadata_),
+                  body_.toString(), request_.getVaryHeaders());
+  }
+
+  // Owns the request, whose vary headers are needed to insert a response which varies.
+  const LookupContextPtr lookup_context_;
+  const LookupRequest& request_;
+  ShardedHttpCache& cache_;
+  Http::ResponseHeaderMapPtr response_headers_;
+  ResponseMetadata metadata_;
+  Buffer::OwnedImpl body_;
+  bool committed_ = false;
+};
+
+constexpr absl::string_view Name = "envoy.extensions.http.cache.sharded";
+
+const std::shared_ptr<const std::string>& emptyBody() {
+  CONSTRUCT_ON_FIRST_USE(std::shared_ptr<const std::string>, std::make_shared<std::string>());
+}
+
+Key variedKey(const Key& key, const Http::HeaderMap::GetResult& vary_header,
+              const Http::RequestHeaderMap& request_vary_headers) {
+  Key varied_key = key;
+  varied_key.add_custom_fields(VaryHeader::createVaryKey(vary_header, request_vary_headers));
+  return varied_key;
+}
+
+} // namespace
+
+ShardedHttpCache::ShardedHttpCache(
+    const envoy::extensions::cache::sharded_http_cache::v3alpha::ShardedHttpCacheConfig& config,
+    Stats::Scope& scope)
+    : max_shard_size_bytes_(std::max<uint64_t>(
+          1, config.max_size_bytes() / PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, shards, 16))),
+      max_entry_size_bytes_(std::min(
+          max_shard_size_bytes_, PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+                                     config, max_entry_size_bytes,
+                                     std::max<uint64_t>(1, max_shard_size_bytes_ / 8)))),
+      stats_(generateStats(scope, absl::StrCat("http_cache.sharded.", config.name()))) {
+  const uint32_t shards = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, shards, 16);
+  shards_.reserve(shards);
+  for (uint32_t i = 0; i < shards; ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+ShardedHttpCacheStats ShardedHttpCache::generateStats(Stats::Scope& scope,
+                                                      const std::string& prefix) {
+  return {ALL_SHARDED_HTTP_CACHE_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                       POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+LookupContextPtr ShardedHttpCache::makeLookupContext(LookupRequest&& request) {
+  return std::make_unique<ShardedLookupContext>(*this, std::move(request));
+}
+
+InsertContextPtr ShardedHttpCache::makeInsertContext(LookupContextPtr&& lookup_context) {
+  ASSERT(lookup_context != nullptr);
+  return std::make_unique<ShardedInsertContext>(std::move(lookup_context), *this);
+}
+
+ShardedHttpCache::Entry ShardedHttpCache::lookup(const LookupRequest& request) {
+  std::string vary_key;
+  {
+    Shard& shard = shardOf(request.key());
+    absl::MutexLock lock(&shard.mutex_);
+    const Item* item = findLocked(shard, request.key());
+    if (item == nullptr) {
+      stats_.miss_.inc();
+      return Entry{};
+    }
+    const auto vary_header = item->entry_.response_headers_->get(Http::CustomHeaders::get().Vary);
+    if (vary_header.empty()) {
+      stats_.hit_.inc();
+      return Entry{
+          Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*item->entry_.response_headers_),
+          item->entry_.metadata_, item->entry_.body_};
+    }
+    vary_key = VaryHeader::createVaryKey(vary_header, request.getVaryHeaders());
+  }
+
+  // The response varies, so it is cached under the vary key of the request.
+  Key varied_key = request.key();
+  varied_key.add_custom_fields(vary_key);
+  Shard& shard = shardOf(varied_key);
+  absl::MutexLock lock(&shard.mutex_);
+  const Item* item = findLocked(shard, varied_key);
+  if (item == nullptr) {
+    stats_.miss_.inc();
+    return Entry{};
+  }
+  stats_.hit_.inc();
+  return Entry{Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*item->entry_.response_headers_),
+               item->entry_.metadata_, item->entry_.body_};
+}
+
+bool ShardedHttpCache::insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
+                              ResponseMetadata&& metadata, std::string&& body,
+                              const Http::RequestHeaderMap& request_vary_headers) {
+  auto cached_body = std::make_shared<const std::string>(std::move(body));
+  const auto vary_header = response_headers->get(Http::CustomHeaders::get().Vary);
+  if (vary_header.empty()) {
+    return insertEntry(Key(key),
+                       Entry{std::move(response_headers), std::move(metadata), cached_body});
+  }
+
+  Key varied_key = variedKey(key, vary_header, request_vary_headers);
+  Http::ResponseHeaderMapPtr vary_only_headers =
+      Http::createHeaderMap<Http::ResponseHeaderMapImpl>({});
+  for (size_t i = 0; i < vary_header.size(); ++i) {
+    vary_only_headers->addCopy(Http::CustomHeaders::get().Vary,
+                               vary_header[i]->value().getStringView());
+  }
+  if (!insertEntry(std::move(varied_key),
+                   Entry{std::move(response_headers), std::move(metadata), cached_body})) {
+    return false;
+  }
+  // Flags that the responses for the key vary, and on which headers.
+  return insertEntry(Key(key), Entry{std::move(vary_only_headers), {}, emptyBody()});
+}
+
+void ShardedHttpCache::updateHeaders(const LookupContext& lookup_context,
+                                     const Http::ResponseHeaderMap& response_headers,
+                                     const ResponseMetadata& metadata) {
+  const LookupRequest& request =
+      dynamic_cast<const ShardedLookupContext&>(lookup_context).request();
+  const auto vary_header = response_headers.get(Http::CustomHeaders::get().Vary);
+  const Key key = vary_header.empty()
+                      ? request.key()
+                      : variedKey(request.key(), vary_header, request.getVaryHeaders());
+
+  Shard& shard = shardOf(key);
+  absl::MutexLock lock(&shard.mutex_);
+  Item* item = findLocked(shard, key);
+  if (item == nullptr) {
+    // The entry was evicted since the lookup.
+    return;
+  }
+  item->entry_.response_headers_ =
+      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers);
+  item->entry_.metadata_ = metadata;
+  const uint64_t size_bytes = sizeOf(item->key_, item->entry_);
+  shard.size_bytes_ = shard.size_bytes_ - item->size_bytes_ + size_bytes;
+  stats_.size_bytes_.sub(item->size_bytes_);
+  stats_.size_bytes_.add(size_bytes);
+  item->size_bytes_ = size_bytes;
+  evictLocked(shard);
+}
+
+CacheInfo ShardedHttpCache::cacheInfo() const {
+  CacheInfo cache_info;
+  cache_info.name_ = Name;
+  return cache_info;
+}
+
+ShardedHttpCache::Shard& ShardedHttpCache::shardOf(const Key& key) {
+  return *shards_[MessageUtil::hash(key) % shards_.size()];
+}
+
+uint64_t ShardedHttpCache::sizeOf(const Key& key, const Entry& entry) {
+  return key.ByteSizeLong() + entry.response_headers_->byteSize() + entry.body_->size();
+}
+
+bool ShardedHttpCache::insertEntry(Key&& key, Entry&& entry) {
+  const uint64_t size_bytes = sizeOf(key, entry);
+  if (size_bytes > max_entry_size_bytes_) {
+    stats_.insert_too_large_.inc();
+    return false;
+  }
+
+  Shard& shard = shardOf(key);
+  absl::MutexLock lock(&shard.mutex_);
+  auto existing = shard.index_.find(&key);
+  if (existing != shard.index_.end()) {
+    removeLocked(shard, existing->second);
+  }
+  shard.items_.push_front(Item{std::move(key), std::move(entry), size_bytes});
+  shard.index_.emplace(&shard.items_.front().key_, shard.items_.begin());
+  shard.size_bytes_ += size_bytes;
+  stats_.size_bytes_.add(size_bytes);
+  stats_.entries_.inc();
+  stats_.insert_.inc();
+  evictLocked(shard);
+  return true;
+}
+
+ShardedHttpCache::Item* ShardedHttpCache::findLocked(Shard& shard, const Key& key) {
+  auto found = shard.index_.find(&key);
+  if (found == shard.index_.end()) {
+    return nullptr;
+  }
+  shard.items_.splice(shard.items_.begin(), shard.items_, found->second);
+  return &*found->second;
+}
+
+void ShardedHttpCache::removeLocked(Shard& shard, ItemList::iterator item) {
+  shard.size_bytes_ -= item->size_bytes_;
+  stats_.size_bytes_.sub(item->size_bytes_);
+  stats_.entries_.dec();
+  shard.index_.erase(&item->key_);
+  shard.items_.erase(item);
+}
+
+void ShardedHttpCache::evictLocked(Shard& shard) {
+  while (shard.size_bytes_ > max_shard_size_bytes_ && shard.items_.size() > 1) {
+    removeLocked(shard, std::prev(shard.items_.end()));
+    stats_.eviction_.inc();
+  }
+}
+
+ShardedHttpCacheSharedPtr ShardedHttpCacheManager::getCache(
+    const envoy::extensions::cache::sharded_http_cache::v3alpha::ShardedHttpCacheConfig& config) {
+  auto existing_cache = caches_.find(config.name());
+  if (existing_cache != caches_.end()) {
+    ShardedHttpCacheSharedPtr cache = existing_cache->second.cache_.lock();
+    if (cache != nullptr) {
+      if (!Protobuf::util::MessageDifferencer::Equivalent(config, existing_cache->second.config_)) {
+        throw EnvoyException(fmt::format(
+            "config specified sharded http cache '{}' with different settings", config.name()));
+      }
+      return cache;
+    }
+  }
+
+  auto cache = std::make_shared<ShardedHttpCache>(config, root_scope_);
+  caches_.insert_or_assign(config.name(), ActiveCache{config, cache});
+  return cache;
+}
+
+SINGLETON_MANAGER_REGISTRATION(sharded_http_cache_manager);
+
+class ShardedHttpCacheFactory : public HttpCacheFactory {
+public:
+  // From UntypedFactory
+  std::string name() const override { return std::string(Name); }
+  // From TypedFactory
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<
+        envoy::extensions::cache::sharded_http_cache::v3alpha::ShardedHttpCacheConfig>();
+  }
+  // From HttpCacheFactory
+  HttpCacheSharedPtr
+  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
+           Server::Configuration::FactoryContext& context) override {
+    envoy::extensions::cache::sharded_http_cache::v3alpha::ShardedHttpCacheConfig cache_config;
+    MessageUtil::anyConvertAndValidate(config.typed_config(), cache_config,
+                                       context.messageValidationVisitor());
+    ShardedHttpCacheManagerSharedPtr manager =
+        context.singletonManager().getTyped<ShardedHttpCacheManager>(
+            SINGLETON_MANAGER_REGISTERED_NAME(sharded_http_cache_manager), [&context] {
+              return std::make_shared<ShardedHttpCacheManager>(
+                  context.getServerFactoryContext().scope());
+            });
+    // The filters using the cache also hold the manager, so that the filters configured later with
+    // the same name find the cache.
+    auto holder = std::make_shared<std::pair<ShardedHttpCacheManagerSharedPtr, HttpCacheSharedPtr>>(
+        manager, manager->getCache(cache_config));
+    return HttpCacheSharedPtr(holder, holder->second.get());
+  }
+};
+
+static Registry::RegisterFactory<ShardedHttpCacheFactory, HttpCacheFactory> register_;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/cache/sharded_http_cache/v3alpha/config.pb.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/http_cache.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All sharded http cache stats. @see stats_macros.h
+ */
+#define ALL_SHARDED_HTTP_CACHE_STATS(COUNTER, GAUGE)                                               \
+  COUNTER(eviction)                                                                                \
+  COUNTER(hit)                                                                                     \
+  COUNTER(insert)                                                                                  \
+  COUNTER(insert_too_large)                                                                        \
+  COUNTER(miss)                                                                                    \
+  GAUGE(entries, NeverImport)                                                                      \
+  GAUGE(size_bytes, NeverImport)
+
+/**
+ * Struct definition for all sharded http cache stats. @see stats_macros.h
+ */
+struct ShardedHttpCacheStats {
+  ALL_SHARDED_HTTP_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * An in-memory cache shared by all the workers. The entries are split between shards by the hash
+ * of their key, each shard with its own lock and its share of the memory budget, and the least
+ * recently used entries of a shard are evicted to make room for new ones. The bodies are shared
+ * with the lookups serving them, which reference them rather than copying them, so an entry can be
+ * evicted or replaced while its body is being served.
+ */
+class ShardedHttpCache : public HttpCache {
+public:
+  ShardedHttpCache(
+      const envoy::extensions::cache::sharded_http_cache::v3alpha::ShardedHttpCacheConfig& config,
+      Stats::Scope& scope);
+
+  struct Entry {
+    Http::ResponseHeaderMapPtr response_headers_;
+    ResponseMetadata metadata_;
+    std::shared_ptr<const std::string> body_;
+  };
+
+  // HttpCache
+  LookupContextPtr makeLookupContext(LookupRequest&& request) override;
+  InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context) override;
+  void updateHeaders(const LookupContext& lookup_context,
+                     const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata) override;
+  CacheInfo cacheInfo() const override;
+
+  /**
+   * @return a copy of the headers of the response cached for the request, with its metadata and a
+   *         reference to its body, or an Entry without headers if there is none.
+   */
+  Entry lookup(const LookupRequest& request);
+
+  /**
+   * Caches a response, evicting the least recently used entries of its shard to make room for it.
+   * A response which varies is cached under the key of the request with its vary key added, and
+   * the key of the request gets an entry with just the vary header of the response.
+   * @param request_vary_headers supplies the headers of the request which the response may vary on.
+   * @return whether the response was cached, which it is not if it is larger than
+   *         maxEntrySizeBytes().
+   */
+  bool insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
+              ResponseMetadata&& metadata, std::string&& body,
+              const Http::RequestHeaderMap& request_vary_headers);
+
+  uint64_t maxEntrySizeBytes() const { return max_entry_size_bytes_; }
+  ShardedHttpCacheStats& stats() { return stats_; }
+
+private:
+  struct Item {
+    Key key_;
+    Entry entry_;
+    uint64_t size_bytes_;
+  };
+  using ItemList = std::list<Item>;
+
+  struct KeyPtrHash {
+    size_t operator()(const Key* key) const { return MessageUtil::hash(*key); }
+  };
+  struct KeyPtrEqual {
+    bool operator()(const Key* lhs, const Key* rhs) const { return MessageUtil()(*lhs, *rhs); }
+  };
+
+  struct Shard {
+    absl::Mutex mutex_;
+    // The most recently used items first.
+    ItemList items_ ABSL_GUARDED_BY(mutex_);
+    // Keyed by the keys held by the items, which do not move.
+    absl::flat_hash_map<const Key*, ItemList::iterator, KeyPtrHash, KeyPtrEqual>
+        index_ ABSL_GUARDED_BY(mutex_);
+    uint64_t size_bytes_ ABSL_GUARDED_BY(mutex_){};
+  };
+
+  static ShardedHttpCacheStats generateStats(Stats::Scope& scope, const std::string& prefix);
+  Shard& shardOf(const Key& key);
+  static uint64_t sizeOf(const Key& key, const Entry& entry);
+  bool insertEntry(Key&& key, Entry&& entry);
+  // Returns the item of key, marked as the most recently used, or nullptr if there is none.
+  Item* findLocked(Shard& shard, const Key& key) ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+  void removeLocked(Shard& shard, ItemList::iterator item)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+  // Evicts the least recently used items of the shard until it fits its budget, always keeping
+  // the most recently used one.
+  void evictLocked(Shard& shard) ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  const uint64_t max_shard_size_bytes_;
+  const uint64_t max_entry_size_bytes_;
+  ShardedHttpCacheStats stats_;
+};
+
+using ShardedHttpCacheSharedPtr = std::shared_ptr<ShardedHttpCache>;
+
+/**
+ * Keeps the caches by name, so that the cache filters configured with the same name share a cache,
+ * including the filters of a listener and of its update.
+ */
+class ShardedHttpCacheManager : public Singleton::Instance {
+public:
+  explicit ShardedHttpCacheManager(Stats::Scope& root_scope) : root_scope_(root_scope) {}
+
+  /**
+   * @return the cache of the name of the config, which is created if no filter uses it anymore.
+   * @throw EnvoyException if the cache is in use with a different config.
+   */
+  ShardedHttpCacheSharedPtr
+  getCache(const envoy::extensions::cache::sharded_http_cache::v3alpha::ShardedHttpCacheConfig&
+               config);
+
+private:
+  struct ActiveCache {
+    envoy::extensions::cache::sharded_http_cache::v3alpha::ShardedHttpCacheConfig config_;
+    std::weak_ptr<ShardedHttpCache> cache_;
+  };
+
+  Stats::Scope& root_scope_;
+  absl::flat_hash_map<std::string, ActiveCache> caches_;
+};
+
+using ShardedHttpCacheManagerSharedPtr = std::shared_ptr<ShardedHttpCacheManager>;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -43,9 +43,21 @@ CorsFilterConfig::CorsFilterConfig(const std::string& stats_prefix, Stats::Scope
 CorsFilter::CorsFilter(CorsFilterConfigSharedPtr config)
     : policies_({{nullptr, nullptr}}), config_(std::move(config)) {}
 
+Http::FilterHeadersStatus CorsFilter::decodeHeaders(Http::RequestHeaderMap& headers, bool) {
+  const Http::FilterHeadersStatus status = decodeCorsHeaders(headers);
+  if (status == Http::FilterHeadersStatus::Continue) {
+    // The body and trailers are never of interest, and the response only is for CORS requests.
+    decoder_callbacks_->skipRemainingCallbacks();
+    if (!is_cors_request_) {
+      encoder_callbacks_->skipRemainingCallbacks();
+    }
+  }
+  return status;
+}
+
 // This handles the CORS preflight request as described in
 // https://www.w3.org/TR/cors/#resource-preflight-requests
-Http::FilterHeadersStatus CorsFilter::decodeHeaders(Http::RequestHeaderMap& headers, bool) {
+Http::FilterHeadersStatus CorsFilter::decodeCorsHeaders(Http::RequestHeaderMap& headers) {
   if (decoder_callbacks_->route() == nullptr ||
       decoder_callbacks_->route()->routeEntry() == nullptr) {
     return Http::FilterHeadersStatus::Continue;
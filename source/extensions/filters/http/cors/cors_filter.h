@@ -82,6 +82,7 @@ public:
 private:
   friend class CorsFilterTest;
 
+  Http::FilterHeadersStatus decodeCorsHeaders(Http::RequestHeaderMap& headers);
   const std::vector<Matchers::StringMatcherPtr>* allowOrigins();
   const std::string& allowMethods();
   const std::string& allowHeaders();
@@ -13,6 +13,7 @@
 #include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/common/ext_authz/ext_authz_grpc_impl.h"
 #include "source/extensions/filters/common/ext_authz/ext_authz_http_impl.h"
+#include "source/extensions/filters/http/ext_authz/decision_cache.h"
 #include "source/extensions/filters/http/ext_authz/ext_authz.h"
 
 namespace Envoy {
@@ -23,9 +24,16 @@ namespace ExtAuthz {
 Http::FilterFactoryCb ExtAuthzFilterConfig::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::http::ext_authz::v3::ExtAuthz& proto_config,
     const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
+  DecisionCacheSharedPtr decision_cache;
+  if (proto_config.has_decision_cache()) {
+    decision_cache = std::make_shared<DecisionCache>(
+        proto_config.decision_cache(), context.threadLocal(), context.timeSource(),
+        context.scope(),
+        absl::StrCat(stats_prefix, "ext_authz.", proto_config.stat_prefix(), "decision_cache."));
+  }
   const auto filter_config = std::make_shared<FilterConfig>(
       proto_config, context.scope(), context.runtime(), context.httpContext(), stats_prefix,
-      context.getServerFactoryContext().bootstrap());
+      context.getServerFactoryContext().bootstrap(), std::move(decision_cache));
   Http::FilterFactoryCb callback;
 
   if (proto_config.has_http_service()) {
@@ -0,0 +1,171 @@
+#include "source/extensions/filters/http/ext_authz/decision_cache.h"
+
+#include <map>
+
+#include "source/common/http/header_utility.h"
+#include "source/common/http/path_utility.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+namespace {
+
+constexpr uint64_t DefaultTtlMs = 60000;
+constexpr uint32_t DefaultMaxEntries = 10000;
+
+// Appends an attribute of the request to a key, prefixed with its length so that the attributes
+// can't run into each other.
+void appendAttribute(std::string& key, absl::string_view attribute) {
+  absl::StrAppend(&key, attribute.size(), ":", attribute);
+}
+
+// Appends the marker of an attribute the request is missing to a key, which tells it apart from
+// an empty attribute.
+void appendMissingAttribute(std::string& key) { key.push_back('-'); }
+
+// @return the leading segments of a path.
+absl::string_view pathPrefix(absl::string_view path, uint32_t segments) {
+  size_t end = 0;
+  for (uint32_t i = 0; i < segments && end < path.size(); i++) {
+    end = path.find('/', end + 1);
+    if (end == absl::string_view::npos) {
+      end = path.size();
+    }
+  }
+  return path.substr(0, end);
+}
+
+} // namespace
+
+DecisionCache::DecisionCache(
+    const envoy::extensions::filters::http::ext_authz::v3::DecisionCache& config,
+    ThreadLocal::SlotAllocator& tls, TimeSource& time_source, Stats::Scope& scope,
+    const std::string& stats_prefix)
+    : key_headers_(config.key_headers().begin(), config.key_headers().end()),
+      key_path_segments_(config.key_path_segments()),
+      key_peer_identity_(config.key_peer_identity()),
+      ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, ttl, DefaultTtlMs)),
+      ttl_metadata_key_(config.ttl_metadata_key()), cache_denials_(config.cache_denials()),
+      max_entries_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entries, DefaultMaxEntries)),
+      time_source_(time_source),
+      stats_{ALL_DECISION_CACHE_STATS(POOL_COUNTER_PREFIX(scope, stats_prefix))}, tls_(tls) {
+  tls_.set([](Event::Dispatcher&) { return std::make_shared<WorkerCache>(); });
+}
+
+std::string DecisionCache::key(const Http::RequestHeaderMap& headers,
+                               const Network::Connection* connection,
+                               const ContextExtensionsMap& context_extensions) const {
+  std::string key;
+  for (const Http::LowerCaseString& name : key_headers_) {
+    const auto value = Http::HeaderUtility::getAllOfHeaderAsString(headers, name);
+    if (value.result().has_value()) {
+      appendAttribute(key, value.result().value());
+    } else {
+      appendMissingAttribute(key);
+    }
+  }
+
+  if (key_path_segments_ > 0) {
+    if (headers.Path() != nullptr) {
+      const absl::string_view path =
+          Http::PathUtil::removeQueryAndFragment(headers.getPathValue());
+      appendAttribute(key, pathPrefix(path, key_path_segments_));
+    } else {
+      appendMissingAttribute(key);
+    }
+  }
+
+  if (key_peer_identity_) {
+    const Ssl::ConnectionInfoConstSharedPtr ssl =
+        connection != nullptr ? connection->ssl() : nullptr;
+    if (ssl != nullptr && ssl->peerCertificatePresented()) {
+      appendAttribute(key, !ssl->uriSanPeerCertificate().empty()
+                               ? absl::StrJoin(ssl->uriSanPeerCertificate(), ",")
+                               : ssl->subjectPeerCertificate());
+    } else {
+      appendMissingAttribute(key);
+    }
+  }
+
+  // The iteration order of a protobuf map is unspecified.
+  const std::map<std::string, std::string> sorted_extensions(context_extensions.begin(),
+                                                             context_extensions.end());
+  for (const auto& [name, value] : sorted_extensions) {
+    appendAttribute(key, name);
+    appendAttribute(key, value);
+  }
+  return key;
+}
+
+Filters::Common::ExtAuthz::ResponsePtr DecisionCache::lookup(const std::string& key) {
+  WorkerCache& cache = *tls_;
+  const auto it = cache.entries_.find(key);
+  if (it == cache.entries_.end()) {
+    stats_.miss_.inc();
+    return nullptr;
+  }
+  if (time_source_.monotonicTime() >= it->second.expiry_) {
+    stats_.expired_.inc();
+    stats_.miss_.inc();
+    cache.lru_.erase(it->second.lru_position_);
+    cache.entries_.erase(it);
+    return nullptr;
+  }
+
+  stats_.hit_.inc();
+  cache.lru_.splice(cache.lru_.begin(), cache.lru_, it->second.lru_position_);
+  return std::make_unique<Filters::Common::ExtAuthz::Response>(it->second.response_);
+}
+
+void DecisionCache::insert(const std::string& key,
+                           const Filters::Common::ExtAuthz::Response& response) {
+  using Filters::Common::ExtAuthz::CheckStatus;
+  if (response.status == CheckStatus::Error ||
+      (response.status == CheckStatus::Denied && !cache_denials_)) {
+    return;
+  }
+  const std::chrono::milliseconds response_ttl = ttl(response);
+  if (response_ttl.count() <= 0) {
+    return;
+  }
+
+  WorkerCache& cache = *tls_;
+  const auto [it, inserted] = cache.entries_.try_emplace(key);
+  if (inserted) {
+    cache.lru_.push_front(key);
+    it->second.lru_position_ = cache.lru_.begin();
+  } else {
+    cache.lru_.splice(cache.lru_.begin(), cache.lru_, it->second.lru_position_);
+  }
+  it->second.response_ = response;
+  it->second.expiry_ = time_source_.monotonicTime() + response_ttl;
+
+  if (cache.entries_.size() > max_entries_) {
+    stats_.evicted_.inc();
+    cache.entries_.erase(cache.lru_.back());
+    cache.lru_.pop_back();
+  }
+}
+
+std::chrono::milliseconds
+DecisionCache::ttl(const Filters::Common::ExtAuthz::Response& response) const {
+  if (!ttl_metadata_key_.empty()) {
+    const auto& fields = response.dynamic_metadata.fields();
+    const auto it = fields.find(ttl_metadata_key_);
+    if (it != fields.end() && it->second.kind_case() == ProtobufWkt::Value::kNumberValue) {
+      const double seconds = it->second.number_value();
+      return std::chrono::milliseconds(seconds > 0 ? static_cast<int64_t>(seconds * 1000) : 0);
+    }
+  }
+  return ttl_;
+}
+
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
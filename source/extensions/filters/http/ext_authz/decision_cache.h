@@ -0,0 +1,111 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/http/ext_authz/v3/ext_authz.pb.h"
+#include "envoy/http/header_map.h"
+#include "envoy/network/connection.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/extensions/filters/common/ext_authz/ext_authz.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+
+/**
+ * All stats for the decision cache of the Ext Authz filter. @see stats_macros.h
+ */
+#define ALL_DECISION_CACHE_STATS(COUNTER)                                                          \
+  COUNTER(evicted)                                                                                 \
+  COUNTER(expired)                                                                                 \
+  COUNTER(hit)                                                                                     \
+  COUNTER(miss)
+
+/**
+ * Wrapper struct for the decision cache stats. @see stats_macros.h
+ */
+struct DecisionCacheStats {
+  ALL_DECISION_CACHE_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * The cache of the decisions of the authorization service, as configured by
+ * envoy::extensions::filters::http::ext_authz::v3::DecisionCache. Each worker caches the decisions
+ * of the requests it authorizes, so that the cache is only accessed from its thread.
+ */
+class DecisionCache {
+public:
+  using ContextExtensionsMap = Protobuf::Map<std::string, std::string>;
+
+  DecisionCache(const envoy::extensions::filters::http::ext_authz::v3::DecisionCache& config,
+                ThreadLocal::SlotAllocator& tls, TimeSource& time_source, Stats::Scope& scope,
+                const std::string& stats_prefix);
+
+  /**
+   * @param headers supplies the headers of the request.
+   * @param connection supplies the downstream connection of the request, if any.
+   * @param context_extensions supplies the context extensions of the route of the request.
+   * @return the key of the decision of the request.
+   */
+  std::string key(const Http::RequestHeaderMap& headers, const Network::Connection* connection,
+                  const ContextExtensionsMap& context_extensions) const;
+
+  /**
+   * @return a copy of the decision the worker caches for the key, or nullptr if it has none or if
+   *         it expired.
+   */
+  Filters::Common::ExtAuthz::ResponsePtr lookup(const std::string& key);
+
+  /**
+   * Caches the decision of the authorization service for the key, unless the configuration or the
+   * TTL the service returned keep it from being cached.
+   */
+  void insert(const std::string& key, const Filters::Common::ExtAuthz::Response& response);
+
+private:
+  struct Entry {
+    Filters::Common::ExtAuthz::Response response_;
+    MonotonicTime expiry_;
+    std::list<std::string>::iterator lru_position_;
+  };
+
+  struct WorkerCache : public ThreadLocal::ThreadLocalObject {
+    absl::flat_hash_map<std::string, Entry> entries_;
+    // The keys of the entries, the most recently used first.
+    std::list<std::string> lru_;
+  };
+
+  // @return how long the response is cached.
+  std::chrono::milliseconds ttl(const Filters::Common::ExtAuthz::Response& response) const;
+
+  const std::vector<Http::LowerCaseString> key_headers_;
+  const uint32_t key_path_segments_;
+  const bool key_peer_identity_;
+  const std::chrono::milliseconds ttl_;
+  const std::string ttl_metadata_key_;
+  const bool cache_denials_;
+  const uint32_t max_entries_;
+  TimeSource& time_source_;
+  DecisionCacheStats stats_;
+  ThreadLocal::TypedSlot<WorkerCache> tls_;
+};
+
+using DecisionCacheSharedPtr = std::shared_ptr<DecisionCache>;
+
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -49,30 +49,47 @@ void Filter::initiateCall(const Http::RequestHeaderMap& headers,
     context_extensions = maybe_merged_per_route_config.value().takeContextExtensions();
   }
 
-  // If metadata_context_namespaces is specified, pass matching metadata to the ext_authz service.
-  envoy::config::core::v3::Metadata metadata_context;
-  const auto& request_metadata =
-      decoder_callbacks_->streamInfo().dynamicMetadata().filter_metadata();
-  for (const auto& context_key : config_->metadataContextNamespaces()) {
-    const auto& metadata_it = request_metadata.find(context_key);
-    if (metadata_it != request_metadata.end()) {
-      (*metadata_context.mutable_filter_metadata())[metadata_it->first] = metadata_it->second;
-    }
+  Filters::Common::ExtAuthz::ResponsePtr cached_response;
+  DecisionCache* decision_cache = config_->decisionCache();
+  if (decision_cache != nullptr) {
+    decision_cache_key_ =
+        decision_cache->key(headers, decoder_callbacks_->connection(), context_extensions);
+    cached_response = decision_cache->lookup(decision_cache_key_);
   }
 
-  Filters::Common::ExtAuthz::CheckRequestUtils::createHttpCheck(
-      decoder_callbacks_, headers, std::move(context_extensions), std::move(metadata_context),
-      check_request_, config_->maxRequestBytes(), config_->packAsBytes(),
-      config_->includePeerCertificate(), config_->destinationLabels());
+  if (cached_response == nullptr) {
+    // If metadata_context_namespaces is specified, pass matching metadata to the ext_authz
+    // service.
+    envoy::config::core::v3::Metadata metadata_context;
+    const auto& request_metadata =
+        decoder_callbacks_->streamInfo().dynamicMetadata().filter_metadata();
+    for (const auto& context_key : config_->metadataContextNamespaces()) {
+      const auto& metadata_it = request_metadata.find(context_key);
+      if (metadata_it != request_metadata.end()) {
+        (*metadata_context.mutable_filter_metadata())[metadata_it->first] = metadata_it->second;
+      }
+    }
+
+    Filters::Common::ExtAuthz::CheckRequestUtils::createHttpCheck(
+        decoder_callbacks_, headers, std::move(context_extensions), std::move(metadata_context),
+        check_request_, config_->maxRequestBytes(), config_->packAsBytes(),
+        config_->includePeerCertificate(), config_->destinationLabels());
+  }
 
-  ENVOY_STREAM_LOG(trace, "ext_authz filter calling authorization server", *decoder_callbacks_);
   state_ = State::Calling;
   filter_return_ = FilterReturn::StopDecoding; // Don't let the filter chain continue as we are
                                                // going to invoke check call.
   cluster_ = decoder_callbacks_->clusterInfo();
   initiating_call_ = true;
-  client_->check(*this, check_request_, decoder_callbacks_->activeSpan(),
-                 decoder_callbacks_->streamInfo());
+  if (cached_response != nullptr) {
+    ENVOY_STREAM_LOG(trace, "ext_authz filter reusing a cached decision", *decoder_callbacks_);
+    cached_decision_ = true;
+    onComplete(std::move(cached_response));
+  } else {
+    ENVOY_STREAM_LOG(trace, "ext_authz filter calling authorization server", *decoder_callbacks_);
+    client_->check(*this, check_request_, decoder_callbacks_->activeSpan(),
+                   decoder_callbacks_->streamInfo());
+  }
   initiating_call_ = false;
 }
 
@@ -206,6 +223,10 @@ void Filter::onComplete(Filters::Common::ExtAuthz::ResponsePtr&& response) {
   using Filters::Common::ExtAuthz::CheckStatus;
   Stats::StatName empty_stat_name;
 
+  if (config_->decisionCache() != nullptr && !cached_decision_) {
+    config_->decisionCache()->insert(decision_cache_key_, *response);
+  }
+
   if (!response->dynamic_metadata.fields().empty()) {
     decoder_callbacks_->streamInfo().setDynamicMetadata("envoy.filters.http.ext_authz",
                                                         response->dynamic_metadata);
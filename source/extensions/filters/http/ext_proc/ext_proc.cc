@@ -78,7 +78,7 @@ FilterHeadersStatus Filter::onHeaders(ProcessorState& state,
   MutationUtils::headersToProto(headers, *headers_req->mutable_headers());
   headers_req->set_end_of_stream(end_stream);
   state.setCallbackState(ProcessorState::CallbackState::HeadersCallback);
-  state.startMessageTimer(std::bind(&Filter::onMessageTimeout, this), config_->messageTimeout());
+  startMessageTimer(state);
   ENVOY_LOG(debug, "Sending headers message");
   stream_->send(std::move(req), false);
   stats_.stream_msgs_sent_.inc();
@@ -93,6 +93,10 @@ FilterHeadersStatus Filter::decodeHeaders(RequestHeaderMap& headers, bool end_st
 
   if (!decoding_state_.sendHeaders()) {
     ENVOY_LOG(trace, "decodeHeaders: Skipped");
+    if (decoding_state_.bodyMode() == ProcessingMode::STREAMED) {
+      // The chunks may change size on their way through the processor.
+      headers.removeContentLength();
+    }
     return FilterHeadersStatus::Continue;
   }
 
@@ -143,6 +147,26 @@ FilterDataStatus Filter::onData(ProcessorState& state, Buffer::Instance& data, b
     }
   }
 
+  if (state.bodyMode() == ProcessingMode::STREAMED || state.hasStreamedChunks()) {
+    // Keep streaming while chunks are queued, even if the mode changed, so that the body
+    // stays in order.
+    switch (openStream()) {
+    case StreamOpenState::Error:
+      return FilterDataStatus::StopIterationNoBuffer;
+    case StreamOpenState::IgnoreError:
+      return FilterDataStatus::Continue;
+    case StreamOpenState::Ok:
+      // Fall through
+      break;
+    }
+
+    // The chunk is passed on once its response comes back, along with any trailers
+    // that were just added, so it leaves the filter chain here.
+    ENVOY_LOG(trace, "onData: Streaming chunk");
+    state.enqueueStreamedChunk(data, end_stream);
+    return FilterDataStatus::StopIterationNoBuffer;
+  }
+
   FilterDataStatus result;
   switch (state.bodyMode()) {
   case ProcessingMode::BUFFERED:
@@ -172,7 +196,6 @@ FilterDataStatus Filter::onData(ProcessorState& state, Buffer::Instance& data, b
     break;
 
   case ProcessingMode::BUFFERED_PARTIAL:
-  case ProcessingMode::STREAMED:
     ENVOY_LOG(debug, "Ignoring unimplemented request body processing mode");
     result = FilterDataStatus::Continue;
     break;
@@ -219,7 +242,8 @@ FilterTrailersStatus Filter::onTrailers(ProcessorState& state, Http::HeaderMap&
   state.setTrailers(&trailers);
 
   if (state.callbackState() == ProcessorState::CallbackState::HeadersCallback ||
-      state.callbackState() == ProcessorState::CallbackState::BufferedBodyCallback) {
+      state.callbackState() == ProcessorState::CallbackState::BufferedBodyCallback ||
+      state.callbackState() == ProcessorState::CallbackState::StreamedBodyCallback) {
     ENVOY_LOG(trace, "Previous callback still executing -- holding header iteration");
     return FilterTrailersStatus::StopIteration;
   }
@@ -266,6 +290,10 @@ FilterHeadersStatus Filter::encodeHeaders(ResponseHeaderMap& headers, bool end_s
 
   if (processing_complete_ || !encoding_state_.sendHeaders()) {
     ENVOY_LOG(trace, "encodeHeaders: Continue");
+    if (!processing_complete_ && encoding_state_.bodyMode() == ProcessingMode::STREAMED) {
+      // The chunks may change size on their way through the processor.
+      headers.removeContentLength();
+    }
     return FilterHeadersStatus::Continue;
   }
 
@@ -288,10 +316,19 @@ FilterTrailersStatus Filter::encodeTrailers(ResponseTrailerMap& trailers) {
   return status;
 }
 
-void Filter::sendBodyChunk(ProcessorState& state, const Buffer::Instance& data, bool end_stream) {
-  ENVOY_LOG(debug, "Sending a body chunk of {} bytes", data.length());
-  state.setCallbackState(ProcessorState::CallbackState::BufferedBodyCallback);
+void Filter::startMessageTimer(ProcessorState& state) {
   state.startMessageTimer(std::bind(&Filter::onMessageTimeout, this), config_->messageTimeout());
+}
+
+void Filter::sendBodyChunk(ProcessorState& state, const Buffer::Instance& data,
+                           ProcessorState::CallbackState new_state, bool end_stream) {
+  ENVOY_LOG(debug, "Sending a body chunk of {} bytes", data.length());
+  if (state.callbackState() != new_state) {
+    // While streamed chunks are waiting for their responses, the timer keeps timing the
+    // oldest of them.
+    state.setCallbackState(new_state);
+    startMessageTimer(state);
+  }
   ProcessingRequest req;
   auto* body_req = state.mutableBody(req);
   body_req->set_end_of_stream(end_stream);
@@ -305,7 +342,7 @@ void Filter::sendTrailers(ProcessorState& state, const Http::HeaderMap& trailers
   auto* trailers_req = state.mutableTrailers(req);
   MutationUtils::headersToProto(trailers, *trailers_req->mutable_trailers());
   state.setCallbackState(ProcessorState::CallbackState::TrailersCallback);
-  state.startMessageTimer(std::bind(&Filter::onMessageTimeout, this), config_->messageTimeout());
+  startMessageTimer(state);
   ENVOY_LOG(debug, "Sending trailers message");
   stream_->send(std::move(req), false);
   stats_.stream_msgs_sent_.inc();
@@ -13,6 +13,7 @@
 #include "envoy/stats/stats_macros.h"
 
 #include "source/common/common/logger.h"
+#include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
 #include "source/extensions/filters/http/ext_proc/client.h"
 #include "source/extensions/filters/http/ext_proc/processor_state.h"
@@ -43,7 +44,9 @@ public:
                const std::string& stats_prefix)
       : failure_mode_allow_(config.failure_mode_allow()), message_timeout_(message_timeout),
         stats_(generateStats(stats_prefix, config.stat_prefix(), scope)),
-        processing_mode_(config.processing_mode()) {}
+        processing_mode_(config.processing_mode()),
+        max_streamed_chunks_in_flight_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+            config, max_streamed_chunks_in_flight, DefaultMaxStreamedChunksInFlight)) {}
 
   bool failureModeAllow() const { return failure_mode_allow_; }
 
@@ -56,7 +59,11 @@ public:
     return processing_mode_;
   }
 
+  uint32_t maxStreamedChunksInFlight() const { return max_streamed_chunks_in_flight_; }
+
 private:
+  static constexpr uint32_t DefaultMaxStreamedChunksInFlight = 8;
+
   ExtProcFilterStats generateStats(const std::string& prefix,
                                    const std::string& filter_stats_prefix, Stats::Scope& scope) {
     const std::string final_prefix = absl::StrCat(prefix, "ext_proc.", filter_stats_prefix);
@@ -68,6 +75,7 @@ private:
 
   ExtProcFilterStats stats_;
   const envoy::extensions::filters::http::ext_proc::v3alpha::ProcessingMode processing_mode_;
+  const uint32_t max_streamed_chunks_in_flight_;
 };
 
 using FilterConfigSharedPtr = std::shared_ptr<FilterConfig>;
@@ -90,8 +98,8 @@ class Filter : public Logger::Loggable<Logger::Id::filter>,
 public:
   Filter(const FilterConfigSharedPtr& config, ExternalProcessorClientPtr&& client)
       : config_(config), client_(std::move(client)), stats_(config->stats()),
-        decoding_state_(*this, config->processingMode()),
-        encoding_state_(*this, config->processingMode()) {}
+        decoding_state_(*this, config->processingMode(), config->maxStreamedChunksInFlight()),
+        encoding_state_(*this, config->processingMode(), config->maxStreamedChunksInFlight()) {}
 
   void onDestroy() override;
   void setDecoderFilterCallbacks(Http::StreamDecoderFilterCallbacks& callbacks) override;
@@ -118,10 +126,16 @@ public:
 
   void onMessageTimeout();
 
+  // Starts, or restarts, the timer of the message the state is waiting for.
+  void startMessageTimer(ProcessorState& state);
+
   void sendBufferedData(ProcessorState& state, bool end_stream) {
-    sendBodyChunk(state, *state.bufferedData(), end_stream);
+    sendBodyChunk(state, *state.bufferedData(), ProcessorState::CallbackState::BufferedBodyCallback,
+                  end_stream);
   }
 
+  void sendBodyChunk(ProcessorState& state, const Buffer::Instance& data,
+                     ProcessorState::CallbackState new_state, bool end_stream);
   void sendTrailers(ProcessorState& state, const Http::HeaderMap& trailers);
 
 private:
@@ -130,7 +144,6 @@ private:
   void cleanUpTimers();
   void clearAsyncState();
   void sendImmediateResponse(const envoy::service::ext_proc::v3alpha::ImmediateResponse& response);
-  void sendBodyChunk(ProcessorState& state, const Buffer::Instance& data, bool end_stream);
 
   Http::FilterHeadersStatus onHeaders(ProcessorState& state,
                                       Http::RequestOrResponseHeaderMap& headers, bool end_stream);
@@ -76,6 +76,25 @@ bool ProcessorState::handleHeadersResponse(const HeadersResponse& response) {
         return true;
       }
 
+      if (body_mode_ == ProcessingMode::STREAMED) {
+        // The chunks may change size on their way through the processor.
+        headers_->removeContentLength();
+        if (bufferedData() != nullptr) {
+          if (complete_body_available_) {
+            // All the body data came in before the header message was complete, so there
+            // is nothing left to stream: send it all at once, as in the buffered mode.
+            ENVOY_LOG(debug, "Sending buffered body as a single streamed chunk");
+            filter_.sendBufferedData(*this, true);
+            return true;
+          }
+          // Stream the body data that came in so far as the first chunk. The rest of the
+          // chunks follow it once the headers continue.
+          Buffer::OwnedImpl first_chunk;
+          modifyBufferedData([&first_chunk](Buffer::Instance& data) { first_chunk.move(data); });
+          enqueueStreamedChunk(first_chunk, false);
+        }
+      }
+
       if (send_trailers_ && trailers_available_) {
         // Trailers came in while we were waiting for this response, and the server
         // is not interested in the body, so send them now.
@@ -93,7 +112,75 @@ bool ProcessorState::handleHeadersResponse(const HeadersResponse& response) {
   return false;
 }
 
+void ProcessorState::enqueueStreamedChunk(Buffer::Instance& data, bool end_stream) {
+  auto chunk = std::make_unique<StreamedChunk>();
+  chunk->data_.move(data);
+  chunk->end_stream_ = end_stream;
+  streamed_chunks_.push_back(std::move(chunk));
+  sendStreamedChunks();
+  if (streamed_chunks_.size() >= max_streamed_chunks_in_flight_) {
+    // Pause the sender of the body until the processor catches up.
+    requestWatermark();
+  }
+}
+
+void ProcessorState::sendStreamedChunks() {
+  while (streamed_chunks_in_flight_ < streamed_chunks_.size() &&
+         streamed_chunks_in_flight_ < max_streamed_chunks_in_flight_) {
+    const StreamedChunk& chunk = *streamed_chunks_[streamed_chunks_in_flight_];
+    filter_.sendBodyChunk(*this, chunk.data_, CallbackState::StreamedBodyCallback,
+                          chunk.end_stream_);
+    streamed_chunks_in_flight_++;
+  }
+}
+
+void ProcessorState::flushStreamedChunks() {
+  streamed_chunks_in_flight_ = 0;
+  while (!streamed_chunks_.empty()) {
+    std::unique_ptr<StreamedChunk> chunk = std::move(streamed_chunks_.front());
+    streamed_chunks_.pop_front();
+    injectDataToFilterChain(chunk->data_, chunk->end_stream_ && !trailers_available_);
+  }
+  clearWatermark();
+}
+
 bool ProcessorState::handleBodyResponse(const BodyResponse& response) {
+  if (callback_state_ == CallbackState::StreamedBodyCallback) {
+    ENVOY_LOG(debug, "Applying body response to the oldest streamed chunk");
+    std::unique_ptr<StreamedChunk> chunk = std::move(streamed_chunks_.front());
+    streamed_chunks_.pop_front();
+    streamed_chunks_in_flight_--;
+    // The headers already went on, so only the body of the chunk can change.
+    MutationUtils::applyCommonBodyResponse(response, nullptr, chunk->data_);
+    if (response.response().clear_route_cache()) {
+      filter_callbacks_->clearRouteCache();
+    }
+
+    sendStreamedChunks();
+    if (streamed_chunks_in_flight_ == 0) {
+      callback_state_ = CallbackState::Idle;
+      message_timer_->disableTimer();
+    } else {
+      // Time the response of the next chunk from now on.
+      filter_.startMessageTimer(*this);
+    }
+    if (streamed_chunks_.size() < max_streamed_chunks_in_flight_) {
+      clearWatermark();
+    }
+    injectDataToFilterChain(chunk->data_, chunk->end_stream_ && !trailers_available_);
+
+    if (streamed_chunks_.empty() && trailers_available_) {
+      if (send_trailers_) {
+        // Trailers came in while the chunks were streamed, and the server asked to see
+        // them -- send them now.
+        filter_.sendTrailers(*this, *trailers_);
+      } else {
+        continueProcessing();
+      }
+    }
+    return true;
+  }
+
   if (callback_state_ == CallbackState::BufferedBodyCallback) {
     ENVOY_LOG(debug, "Applying body response to buffered data");
     modifyBufferedData([this, &response](Buffer::Instance& data) {
@@ -136,6 +223,15 @@ bool ProcessorState::handleTrailersResponse(const TrailersResponse& response) {
 
 void ProcessorState::clearAsyncState() {
   cleanUpTimer();
+  if (callback_state_ == CallbackState::StreamedBodyCallback) {
+    // Let the chunks go on unprocessed, and only continue if trailers were held behind them.
+    callback_state_ = CallbackState::Idle;
+    flushStreamedChunks();
+    if (trailers_available_) {
+      continueProcessing();
+    }
+    return;
+  }
   if (callback_state_ != CallbackState::Idle) {
     continueProcessing();
     callback_state_ = CallbackState::Idle;
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <deque>
+#include <memory>
+
 #include "envoy/buffer/buffer.h"
 #include "envoy/event/timer.h"
 #include "envoy/extensions/filters/http/ext_proc/v3alpha/processing_mode.pb.h"
@@ -7,6 +10,7 @@
 #include "envoy/http/header_map.h"
 #include "envoy/service/ext_proc/v3alpha/external_processor.pb.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/logger.h"
 
 namespace Envoy {
@@ -26,13 +30,16 @@ public:
     HeadersCallback,
     // Waiting for a "body" response in buffered mode
     BufferedBodyCallback,
+    // Waiting for the "body" responses of one or more chunks in streamed mode
+    StreamedBodyCallback,
     // and waiting for a "trailers" response
     TrailersCallback,
   };
 
-  explicit ProcessorState(Filter& filter)
-      : filter_(filter), watermark_requested_(false), complete_body_available_(false),
-        trailers_available_(false), body_replaced_(false) {}
+  ProcessorState(Filter& filter, uint32_t max_streamed_chunks_in_flight)
+      : filter_(filter), max_streamed_chunks_in_flight_(max_streamed_chunks_in_flight),
+        watermark_requested_(false), complete_body_available_(false), trailers_available_(false),
+        body_replaced_(false) {}
   ProcessorState(const ProcessorState&) = delete;
   virtual ~ProcessorState() = default;
   ProcessorState& operator=(const ProcessorState&) = delete;
@@ -64,6 +71,11 @@ public:
   virtual void requestWatermark() PURE;
   virtual void clearWatermark() PURE;
 
+  // Moves a chunk of the body to the end of the queue of the chunks streamed to the processor,
+  // and sends it unless the maximum number of chunks are already waiting for a response.
+  void enqueueStreamedChunk(Buffer::Instance& data, bool end_stream);
+  bool hasStreamedChunks() const { return !streamed_chunks_.empty(); }
+
   bool handleHeadersResponse(const envoy::service::ext_proc::v3alpha::HeadersResponse& response);
   bool handleBodyResponse(const envoy::service::ext_proc::v3alpha::BodyResponse& response);
   bool handleTrailersResponse(const envoy::service::ext_proc::v3alpha::TrailersResponse& response);
@@ -75,6 +87,7 @@ public:
   virtual Http::HeaderMap* addTrailers() PURE;
 
   virtual void continueProcessing() const PURE;
+  virtual void injectDataToFilterChain(Buffer::Instance& data, bool end_stream) const PURE;
   void clearAsyncState();
 
   virtual envoy::service::ext_proc::v3alpha::HttpHeaders*
@@ -85,10 +98,26 @@ public:
   mutableTrailers(envoy::service::ext_proc::v3alpha::ProcessingRequest& request) const PURE;
 
 protected:
+  struct StreamedChunk {
+    Buffer::OwnedImpl data_;
+    bool end_stream_;
+  };
+
+  // Sends the queued chunks which weren't sent yet, while there is room for them.
+  void sendStreamedChunks();
+  // Passes the queued chunks on without waiting for their responses.
+  void flushStreamedChunks();
+
   Filter& filter_;
   Http::StreamFilterCallbacks* filter_callbacks_;
   CallbackState callback_state_ = CallbackState::Idle;
 
+  // The chunks of the body streamed to the processor, in the order they arrived. The first
+  // streamed_chunks_in_flight_ of them were sent and are waiting for their responses.
+  std::deque<std::unique_ptr<StreamedChunk>> streamed_chunks_;
+  uint32_t streamed_chunks_in_flight_ = 0;
+  const uint32_t max_streamed_chunks_in_flight_;
+
   // Keep track of whether we requested a watermark.
   bool watermark_requested_ : 1;
 
@@ -114,10 +143,11 @@ protected:
 
 class DecodingProcessorState : public ProcessorState {
 public:
-  explicit DecodingProcessorState(
+  DecodingProcessorState(
       Filter& filter,
-      const envoy::extensions::filters::http::ext_proc::v3alpha::ProcessingMode& mode)
-      : ProcessorState(filter) {
+      const envoy::extensions::filters::http::ext_proc::v3alpha::ProcessingMode& mode,
+      uint32_t max_streamed_chunks_in_flight)
+      : ProcessorState(filter, max_streamed_chunks_in_flight) {
     setProcessingModeInternal(mode);
   }
   DecodingProcessorState(const DecodingProcessorState&) = delete;
@@ -147,6 +177,10 @@ public:
 
   void continueProcessing() const override { decoder_callbacks_->continueDecoding(); }
 
+  void injectDataToFilterChain(Buffer::Instance& data, bool end_stream) const override {
+    decoder_callbacks_->injectDecodedDataToFilterChain(data, end_stream);
+  }
+
   envoy::service::ext_proc::v3alpha::HttpHeaders*
   mutableHeaders(envoy::service::ext_proc::v3alpha::ProcessingRequest& request) const override {
     return request.mutable_request_headers();
@@ -179,10 +213,11 @@ private:
 
 class EncodingProcessorState : public ProcessorState {
 public:
-  explicit EncodingProcessorState(
+  EncodingProcessorState(
       Filter& filter,
-      const envoy::extensions::filters::http::ext_proc::v3alpha::ProcessingMode& mode)
-      : ProcessorState(filter) {
+      const envoy::extensions::filters::http::ext_proc::v3alpha::ProcessingMode& mode,
+      uint32_t max_streamed_chunks_in_flight)
+      : ProcessorState(filter, max_streamed_chunks_in_flight) {
     setProcessingModeInternal(mode);
   }
   EncodingProcessorState(const EncodingProcessorState&) = delete;
@@ -212,6 +247,10 @@ public:
 
   void continueProcessing() const override { encoder_callbacks_->continueEncoding(); }
 
+  void injectDataToFilterChain(Buffer::Instance& data, bool end_stream) const override {
+    encoder_callbacks_->injectEncodedDataToFilterChain(data, end_stream);
+  }
+
   envoy::service::ext_proc::v3alpha::HttpHeaders*
   mutableHeaders(envoy::service::ext_proc::v3alpha::ProcessingRequest& request) const override {
     return request.mutable_response_headers();
@@ -15,8 +15,9 @@ Http::FilterFactoryCb GrpcJsonTranscoderFilterConfig::createFilterFactoryFromPro
     const envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder&
         proto_config,
     const std::string&, Server::Configuration::FactoryContext& context) {
-  JsonTranscoderConfigSharedPtr filter_config =
-      std::make_shared<JsonTranscoderConfig>(proto_config, context.api());
+  JsonTranscoderConfigSharedPtr filter_config = std::make_shared<JsonTranscoderConfig>(
+      proto_config, context.api(),
+      CompiledDescriptorPoolCache::singleton(context.singletonManager()));
 
   return [filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<JsonTranscoderFilter>(*filter_config));
@@ -29,7 +30,9 @@ GrpcJsonTranscoderFilterConfig::createRouteSpecificFilterConfigTyped(
         proto_config,
     Server::Configuration::ServerFactoryContext& context, ProtobufMessage::ValidationVisitor&) {
 
-  return std::make_shared<JsonTranscoderConfig>(proto_config, context.api());
+  return std::make_shared<JsonTranscoderConfig>(
+      proto_config, context.api(),
+      CompiledDescriptorPoolCache::singleton(context.singletonManager()));
 }
 
 /**
@@ -0,0 +1,166 @@
+#include "source/extensions/filters/http/grpc_json_transcoder/http_body_stream_decoder.h"
+
+#include <algorithm>
+
+#include "source/common/grpc/codec.h"
+
+#include "google/api/httpbody.pb.h"
+
+using Envoy::Protobuf::internal::WireFormatLite;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace GrpcJsonTranscoder {
+
+namespace {
+
+// A field header is made of a tag of up to 5 bytes, followed by either a varint value or a varint
+// length of up to 10 bytes.
+constexpr uint64_t MaxFieldHeaderSize = 15;
+
+} // namespace
+
+bool HttpBodyStreamDecoder::decode(Buffer::Instance& input, Buffer::Instance& output) {
+  pending_.move(input);
+  while (true) {
+    Result result;
+    if (field_remaining_ > 0) {
+      result = decodeFieldData(output);
+    } else if (message_ends_.empty()) {
+      result = decodeFrameHeader();
+    } else if (decoded_ == message_ends_.back()) {
+      if (message_ends_.size() == field_path_.size() + 1) {
+        // A body without data has no content to wait for.
+        content_type_decoded_ = true;
+      }
+      message_ends_.pop_back();
+      continue;
+    } else {
+      result = decodeFieldHeader();
+    }
+
+    if (result == Result::Invalid) {
+      return false;
+    }
+    if (result == Result::NeedMoreData) {
+      return true;
+    }
+  }
+}
+
+HttpBodyStreamDecoder::Result HttpBodyStreamDecoder::decodeFrameHeader() {
+  if (pending_.length() < Grpc::GRPC_FRAME_HEADER_SIZE) {
+    return Result::NeedMoreData;
+  }
+  if (pending_.peekInt<uint8_t>() & Grpc::GRPC_FH_COMPRESSED) {
+    return Result::Invalid;
+  }
+  const uint32_t length = pending_.peekBEInt<uint32_t>(1);
+  consume(Grpc::GRPC_FRAME_HEADER_SIZE);
+  message_ends_.push_back(decoded_ + length);
+  return Result::Progress;
+}
+
+HttpBodyStreamDecoder::Result HttpBodyStreamDecoder::decodeFieldHeader() {
+  const uint64_t message_remaining = message_ends_.back() - decoded_;
+  const uint64_t header_limit = std::min(message_remaining, MaxFieldHeaderSize);
+  const uint64_t available = std::min<uint64_t>(pending_.length(), header_limit);
+  uint8_t header[MaxFieldHeaderSize];
+  pending_.copyOut(0, available, header);
+  // A header that can't be parsed is only invalid once all the bytes it could span are available.
+  const Result incomplete = available == header_limit ? Result::Invalid : Result::NeedMoreData;
+
+  Protobuf::io::CodedInputStream input(header, available);
+  const uint32_t tag = input.ReadTag();
+  if (tag == 0) {
+    return incomplete;
+  }
+  uint64_t length = 0;
+  switch (WireFormatLite::GetTagWireType(tag)) {
+  case WireFormatLite::WIRETYPE_VARINT: {
+    uint64_t value;
+    if (!input.ReadVarint64(&value)) {
+      return incomplete;
+    }
+    break;
+  }
+  case WireFormatLite::WIRETYPE_FIXED64:
+    length = sizeof(uint64_t);
+    break;
+  case WireFormatLite::WIRETYPE_FIXED32:
+    length = sizeof(uint32_t);
+    break;
+  case WireFormatLite::WIRETYPE_LENGTH_DELIMITED:
+    if (!input.ReadVarint64(&length)) {
+      return incomplete;
+    }
+    break;
+  default:
+    // Groups are not used by HttpBody and the response messages embedding it.
+    return Result::Invalid;
+  }
+  const uint64_t header_size = input.CurrentPosition();
+  if (length > message_remaining - header_size) {
+    return Result::Invalid;
+  }
+
+  const bool length_delimited =
+      WireFormatLite::GetTagWireType(tag) == WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+  const int field_number = WireFormatLite::GetTagFieldNumber(tag);
+  const size_t depth = message_ends_.size() - 1;
+  if (depth < field_path_.size()) {
+    if (length_delimited && field_number == field_path_[depth]->number()) {
+      consume(header_size);
+      message_ends_.push_back(decoded_ + length);
+      return Result::Progress;
+    }
+  } else if (length_delimited && field_number == google::api::HttpBody::kContentTypeFieldNumber) {
+    // The content type is small, so it is decoded once it is received whole.
+    if (pending_.length() < header_size + length) {
+      return Result::NeedMoreData;
+    }
+    if (!content_type_decoded_) {
+      content_type_.resize(length);
+      pending_.copyOut(header_size, length, content_type_.data());
+    }
+    consume(header_size + length);
+    return Result::Progress;
+  } else if (length_delimited && field_number == google::api::HttpBody::kDataFieldNumber) {
+    content_type_decoded_ = true;
+    consume(header_size);
+    field_remaining_ = length;
+    forwarding_field_ = true;
+    return Result::Progress;
+  }
+
+  consume(header_size);
+  field_remaining_ = length;
+  forwarding_field_ = false;
+  return Result::Progress;
+}
+
+HttpBodyStreamDecoder::Result HttpBodyStreamDecoder::decodeFieldData(Buffer::Instance& output) {
+  const uint64_t length = std::min(field_remaining_, pending_.length());
+  if (length == 0) {
+    return Result::NeedMoreData;
+  }
+  if (forwarding_field_) {
+    output.move(pending_, length);
+  } else {
+    pending_.drain(length);
+  }
+  decoded_ += length;
+  field_remaining_ -= length;
+  return Result::Progress;
+}
+
+void HttpBodyStreamDecoder::consume(uint64_t length) {
+  pending_.drain(length);
+  decoded_ += length;
+}
+
+} // namespace GrpcJsonTranscoder
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/protobuf/protobuf.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace GrpcJsonTranscoder {
+
+/**
+ * Decodes a gRPC response stream of google.api.HttpBody messages incrementally. The bytes of the
+ * data field of the messages are forwarded as they are received, rather than once their whole
+ * gRPC frame is, so that only the few bytes of an incomplete field header or content type are ever
+ * buffered. The HttpBody messages can be nested in the response messages, as told by the response
+ * body field path of the method.
+ */
+class HttpBodyStreamDecoder {
+public:
+  explicit HttpBodyStreamDecoder(const std::vector<const ProtobufWkt::Field*>& field_path)
+      : field_path_(field_path) {}
+
+  /**
+   * Decodes the response data received so far.
+   * @param input supplies the gRPC response data, which is drained.
+   * @param output supplies the buffer the bytes of the body are moved to.
+   * @return false if the data is not a stream of uncompressed gRPC frames of HttpBody messages.
+   */
+  bool decode(Buffer::Instance& input, Buffer::Instance& output);
+
+  /**
+   * @return whether the content type of the response is known, which is once the data field or the
+   *         end of the first HttpBody message was decoded.
+   */
+  bool contentTypeDecoded() const { return content_type_decoded_; }
+
+  /**
+   * @return the content type of the first HttpBody message of the response.
+   */
+  const std::string& contentType() const { return content_type_; }
+
+private:
+  enum class Result { Progress, NeedMoreData, Invalid };
+
+  Result decodeFrameHeader();
+  Result decodeFieldHeader();
+  Result decodeFieldData(Buffer::Instance& output);
+  void consume(uint64_t length);
+
+  const std::vector<const ProtobufWkt::Field*>& field_path_;
+  Buffer::OwnedImpl pending_;
+  // The number of bytes of the stream decoded so far.
+  uint64_t decoded_{0};
+  // The offsets in the stream where the current frame message and the messages nested in it end.
+  std::vector<uint64_t> message_ends_;
+  // The bytes to skip or to forward, of the field being decoded.
+  uint64_t field_remaining_{0};
+  bool forwarding_field_{false};
+  std::string content_type_;
+  bool content_type_decoded_{false};
+};
+
+} // namespace GrpcJsonTranscoder
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
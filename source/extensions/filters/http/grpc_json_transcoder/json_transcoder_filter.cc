@@ -1,5 +1,6 @@
 #include "source/extensions/filters/http/grpc_json_transcoder/json_transcoder_filter.h"
 
+#include <algorithm>
 #include <memory>
 #include <unordered_set>
 
@@ -9,6 +10,7 @@
 
 #include "source/common/common/assert.h"
 #include "source/common/common/enum_to_int.h"
+#include "source/common/common/lock_guard.h"
 #include "source/common/common/utility.h"
 #include "source/common/grpc/common.h"
 #include "source/common/http/headers.h"
@@ -110,42 +112,20 @@ private:
 
 } // namespace
 
-JsonTranscoderConfig::JsonTranscoderConfig(
+CompiledDescriptorPool::CompiledDescriptorPool(
     const envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder&
         proto_config,
-    Api::Api& api) {
-
-  disabled_ = proto_config.services().empty();
-  if (disabled_) {
-    return;
-  }
-
+    const std::string& descriptor_set_bin) {
   FileDescriptorSet descriptor_set;
-
-  switch (proto_config.descriptor_set_case()) {
-  case envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder::
-      DescriptorSetCase::kProtoDescriptor:
-    if (!descriptor_set.ParseFromString(
-            api.fileSystem().fileReadToEnd(proto_config.proto_descriptor()))) {
-      throw EnvoyException("transcoding_filter: Unable to parse proto descriptor");
-    }
-    break;
-  case envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder::
-      DescriptorSetCase::kProtoDescriptorBin:
-    if (!descriptor_set.ParseFromString(proto_config.proto_descriptor_bin())) {
-      throw EnvoyException("transcoding_filter: Unable to parse proto descriptor");
-    }
-    break;
-  default:
-    NOT_REACHED_GCOVR_EXCL_LINE;
+  if (!descriptor_set.ParseFromString(descriptor_set_bin)) {
+    throw EnvoyException("transcoding_filter: Unable to parse proto descriptor");
   }
 
   for (const auto& file : descriptor_set.file()) {
     addFileDescriptor(file);
   }
 
-  convert_grpc_status_ = proto_config.convert_grpc_status();
-  if (convert_grpc_status_) {
+  if (proto_config.convert_grpc_status()) {
     addBuiltinSymbolDescriptor("google.protobuf.Any");
     addBuiltinSymbolDescriptor("google.rpc.Status");
   }
@@ -216,25 +196,15 @@ JsonTranscoderConfig::JsonTranscoderConfig(
   }
 
   path_matcher_ = pmb.Build();
-
-  const auto& print_config = proto_config.print_options();
-  print_options_.add_whitespace = print_config.add_whitespace();
-  print_options_.always_print_primitive_fields = print_config.always_print_primitive_fields();
-  print_options_.always_print_enums_as_ints = print_config.always_print_enums_as_ints();
-  print_options_.preserve_proto_field_names = print_config.preserve_proto_field_names();
-
-  match_incoming_request_route_ = proto_config.match_incoming_request_route();
-  ignore_unknown_query_parameters_ = proto_config.ignore_unknown_query_parameters();
-  request_validation_options_ = proto_config.request_validation_options();
 }
 
-void JsonTranscoderConfig::addFileDescriptor(const Protobuf::FileDescriptorProto& file) {
+void CompiledDescriptorPool::addFileDescriptor(const Protobuf::FileDescriptorProto& file) {
   if (descriptor_pool_.BuildFile(file) == nullptr) {
     throw EnvoyException("transcoding_filter: Unable to build proto descriptor pool");
   }
 }
 
-void JsonTranscoderConfig::addBuiltinSymbolDescriptor(const std::string& symbol_name) {
+void CompiledDescriptorPool::addBuiltinSymbolDescriptor(const std::string& symbol_name) {
   if (descriptor_pool_.FindFileContainingSymbol(symbol_name) != nullptr) {
     return;
   }
@@ -250,7 +220,7 @@ void JsonTranscoderConfig::addBuiltinSymbolDescriptor(const std::string& symbol_
   addFileDescriptor(file_proto);
 }
 
-Status JsonTranscoderConfig::resolveField(const Protobuf::Descriptor* descriptor,
+Status CompiledDescriptorPool::resolveField(const Protobuf::Descriptor* descriptor,
                                           const std::string& field_path_str,
                                           std::vector<const ProtobufWkt::Field*>* field_path,
                                           bool* is_http_body) {
@@ -278,7 +248,7 @@ Status JsonTranscoderConfig::resolveField(const Protobuf::Descriptor* descriptor
   return Status();
 }
 
-Status JsonTranscoderConfig::createMethodInfo(const Protobuf::MethodDescriptor* descriptor,
+Status CompiledDescriptorPool::createMethodInfo(const Protobuf::MethodDescriptor* descriptor,
                                               const HttpRule& http_rule,
                                               MethodInfoSharedPtr& method_info) {
   method_info = std::make_shared<MethodInfo>();
@@ -308,6 +278,102 @@ Status JsonTranscoderConfig::createMethodInfo(const Protobuf::MethodDescriptor*
   return Status();
 }
 
+CompiledDescriptorPoolConstSharedPtr CompiledDescriptorPoolCache::get(
+    const envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder&
+        proto_config,
+    const std::string& descriptor_set) {
+  // The key is made of the fields the pool is built from, so that the configs which only differ
+  // by how they print, validate or stream the messages share their pool. The config has no map
+  // field, so its serialization is deterministic.
+  envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder key_config;
+  key_config.set_proto_descriptor_bin(descriptor_set);
+  *key_config.mutable_services() = proto_config.services();
+  *key_config.mutable_ignored_query_parameters() = proto_config.ignored_query_parameters();
+  key_config.set_auto_mapping(proto_config.auto_mapping());
+  key_config.set_convert_grpc_status(proto_config.convert_grpc_status());
+  key_config.set_url_unescape_spec(proto_config.url_unescape_spec());
+  const std::string key = key_config.SerializeAsString();
+
+  Thread::LockGuard lock(mutex_);
+  auto it = pools_.find(key);
+  if (it != pools_.end()) {
+    CompiledDescriptorPoolConstSharedPtr pool = it->second.lock();
+    if (pool != nullptr) {
+      return pool;
+    }
+  }
+
+  // The pool is only added once it is built, as building it throws if the config is invalid.
+  auto pool = std::make_shared<const CompiledDescriptorPool>(proto_config, descriptor_set);
+  pools_[key] = pool;
+
+  // The pools of the descriptor sets no config uses anymore are removed once their number doubled.
+  if (pools_.size() > sweep_size_) {
+    absl::erase_if(pools_, [](const auto& entry) { return entry.second.expired(); });
+    sweep_size_ = std::max(MinSweepSize, 2 * pools_.size());
+  }
+  return pool;
+}
+
+size_t CompiledDescriptorPoolCache::size() const {
+  Thread::LockGuard lock(mutex_);
+  return pools_.size();
+}
+
+SINGLETON_MANAGER_REGISTRATION(grpc_json_transcoder_descriptor_pool_cache);
+
+CompiledDescriptorPoolCacheSharedPtr
+CompiledDescriptorPoolCache::singleton(Singleton::Manager& singleton_manager) {
+  return singleton_manager.getTyped<CompiledDescriptorPoolCache>(
+      SINGLETON_MANAGER_REGISTERED_NAME(grpc_json_transcoder_descriptor_pool_cache),
+      [] { return std::make_shared<CompiledDescriptorPoolCache>(); });
+}
+
+JsonTranscoderConfig::JsonTranscoderConfig(
+    const envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder&
+        proto_config,
+    Api::Api& api, CompiledDescriptorPoolCacheSharedPtr cache)
+    : cache_(std::move(cache)) {
+
+  disabled_ = proto_config.services().empty();
+  if (disabled_) {
+    return;
+  }
+
+  std::string descriptor_set;
+
+  switch (proto_config.descriptor_set_case()) {
+  case envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder::
+      DescriptorSetCase::kProtoDescriptor:
+    descriptor_set = api.fileSystem().fileReadToEnd(proto_config.proto_descriptor());
+    break;
+  case envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder::
+      DescriptorSetCase::kProtoDescriptorBin:
+    descriptor_set = proto_config.proto_descriptor_bin();
+    break;
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+
+  descriptor_pool_ =
+      cache_ != nullptr
+          ? cache_->get(proto_config, descriptor_set)
+          : std::make_shared<const CompiledDescriptorPool>(proto_config, descriptor_set);
+
+  convert_grpc_status_ = proto_config.convert_grpc_status();
+  stream_responses_ = proto_config.stream_responses();
+
+  const auto& print_config = proto_config.print_options();
+  print_options_.add_whitespace = print_config.add_whitespace();
+  print_options_.always_print_primitive_fields = print_config.always_print_primitive_fields();
+  print_options_.always_print_enums_as_ints = print_config.always_print_enums_as_ints();
+  print_options_.preserve_proto_field_names = print_config.preserve_proto_field_names();
+
+  match_incoming_request_route_ = proto_config.match_incoming_request_route();
+  ignore_unknown_query_parameters_ = proto_config.ignore_unknown_query_parameters();
+  request_validation_options_ = proto_config.request_validation_options();
+}
+
 bool JsonTranscoderConfig::matchIncomingRequestInfo() const {
   return match_incoming_request_route_;
 }
@@ -332,8 +398,8 @@ ProtobufUtil::Status JsonTranscoderConfig::createTranscoder(
 
   struct RequestInfo request_info;
   std::vector<VariableBinding> variable_bindings;
-  method_info =
-      path_matcher_->Lookup(method, path, args, &variable_bindings, &request_info.body_field_path);
+  method_info = descriptor_pool_->pathMatcher().Lookup(method, path, args, &variable_bindings,
+                                                       &request_info.body_field_path);
   if (!method_info) {
     return ProtobufUtil::Status(StatusCode::kNotFound,
                                 "Could not resolve " + path + " to a method.");
@@ -344,10 +410,12 @@ ProtobufUtil::Status JsonTranscoderConfig::createTranscoder(
     return status;
   }
 
+  const google::grpc::transcoding::TypeHelper& type_helper = descriptor_pool_->typeHelper();
+
   for (const auto& binding : variable_bindings) {
     google::grpc::transcoding::RequestWeaver::BindingInfo resolved_binding;
-    status = type_helper_->ResolveFieldPath(*request_info.message_type, binding.field_path,
-                                            &resolved_binding.field_path);
+    status = type_helper.ResolveFieldPath(*request_info.message_type, binding.field_path,
+                                          &resolved_binding.field_path);
     if (!status.ok()) {
       if (ignore_unknown_query_parameters_) {
         continue;
@@ -370,19 +438,19 @@ ProtobufUtil::Status JsonTranscoderConfig::createTranscoder(
   RequestMessageTranslatorPtr request_translator;
   JsonRequestTranslatorPtr json_request_translator;
   if (method_info->request_type_is_http_body_) {
-    request_translator = std::make_unique<RequestMessageTranslator>(*type_helper_->Resolver(),
-                                                                    false, std::move(request_info));
+    request_translator = std::make_unique<RequestMessageTranslator>(*type_helper.Resolver(), false,
+                                                                    std::move(request_info));
     request_translator->Input().StartObject("")->EndObject();
   } else {
     json_request_translator = std::make_unique<JsonRequestTranslator>(
-        type_helper_->Resolver(), &request_input, std::move(request_info),
+        type_helper.Resolver(), &request_input, std::move(request_info),
         method_info->descriptor_->client_streaming(), true);
   }
 
   const auto response_type_url =
       Grpc::Common::typeUrl(method_info->descriptor_->output_type()->full_name());
   ResponseToJsonTranslatorPtr response_translator{new ResponseToJsonTranslator(
-      type_helper_->Resolver(), response_type_url, method_info->descriptor_->server_streaming(),
+      type_helper.Resolver(), response_type_url, method_info->descriptor_->server_streaming(),
       &response_input, print_options_)};
 
   transcoder = std::make_unique<TranscoderImpl>(std::move(request_translator),
@@ -396,7 +464,7 @@ JsonTranscoderConfig::methodToRequestInfo(const MethodInfoSharedPtr& method_info
                                           google::grpc::transcoding::RequestInfo* info) const {
   const std::string& request_type_full_name = method_info->descriptor_->input_type()->full_name();
   auto request_type_url = Grpc::Common::typeUrl(request_type_full_name);
-  info->message_type = type_helper_->Info()->GetTypeByTypeUrl(request_type_url);
+  info->message_type = descriptor_pool_->typeHelper().Info()->GetTypeByTypeUrl(request_type_url);
   if (info->message_type == nullptr) {
     ENVOY_LOG(debug, "Cannot resolve input-type: {}", request_type_full_name);
     return ProtobufUtil::Status(StatusCode::kNotFound,
@@ -410,8 +478,9 @@ ProtobufUtil::Status
 JsonTranscoderConfig::translateProtoMessageToJson(const Protobuf::Message& message,
                                                   std::string* json_out) const {
   return ProtobufUtil::BinaryToJsonString(
-      type_helper_->Resolver(), Grpc::Common::typeUrl(message.GetDescriptor()->full_name()),
-      message.SerializeAsString(), json_out, print_options_);
+      descriptor_pool_->typeHelper().Resolver(),
+      Grpc::Common::typeUrl(message.GetDescriptor()->full_name()), message.SerializeAsString(),
+      json_out, print_options_);
 }
 
 JsonTranscoderFilter::JsonTranscoderFilter(JsonTranscoderConfig& config) : config_(config) {}
@@ -469,6 +538,11 @@ Http::FilterHeadersStatus JsonTranscoderFilter::decodeHeaders(Http::RequestHeade
     return Http::FilterHeadersStatus::StopIteration;
   }
 
+  if (method_->response_type_is_http_body_ && per_route_config_->streamResponses()) {
+    http_body_stream_decoder_ =
+        std::make_unique<HttpBodyStreamDecoder>(method_->response_body_field_path);
+  }
+
   if (method_->request_type_is_http_body_) {
     if (headers.ContentType() != nullptr) {
       absl::string_view content_type = headers.getContentTypeValue();
@@ -633,6 +707,10 @@ Http::FilterDataStatus JsonTranscoderFilter::encodeData(Buffer::Instance& data,
 
   has_body_ = true;
 
+  if (http_body_stream_decoder_ != nullptr) {
+    return encodeHttpBodyStream(data);
+  }
+
   if (method_->response_type_is_http_body_) {
     bool frame_processed = buildResponseFromHttpBodyOutput(*response_headers_, data);
     if (!method_->descriptor_->server_streaming()) {
@@ -655,7 +733,12 @@ Http::FilterDataStatus JsonTranscoderFilter::encodeData(Buffer::Instance& data,
 
   readToBuffer(*transcoder_->ResponseOutput(), data);
 
-  if (!method_->descriptor_->server_streaming() && !end_stream) {
+  if (!method_->descriptor_->server_streaming() && per_route_config_->streamResponses() &&
+      data.length() > 0) {
+    streamResponseHeaders();
+  }
+
+  if (!method_->descriptor_->server_streaming() && !response_streamed_ && !end_stream) {
     // Buffer until the response is complete.
     return Http::FilterDataStatus::StopIterationAndBuffer;
   }
@@ -697,7 +780,7 @@ void JsonTranscoderFilter::doTrailers(Http::ResponseHeaderOrTrailerMap& headers_
   const bool is_trailers_only_response = response_headers_ == &headers_or_trailers;
   const bool is_server_streaming = method_->descriptor_->server_streaming();
 
-  if (is_server_streaming && !is_trailers_only_response) {
+  if ((is_server_streaming || response_streamed_) && !is_trailers_only_response) {
     // Continue if headers were sent already.
     return;
   }
@@ -785,6 +868,39 @@ void JsonTranscoderFilter::maybeSendHttpBodyRequestMessage() {
   first_request_sent_ = true;
 }
 
+Http::FilterDataStatus JsonTranscoderFilter::encodeHttpBodyStream(Buffer::Instance& data) {
+  Buffer::OwnedImpl body;
+  if (!http_body_stream_decoder_->decode(data, body)) {
+    ENVOY_LOG(debug, "Response is not a stream of uncompressed HttpBody messages");
+    // TODO(euroelessar): Return error to client.
+    encoder_callbacks_->resetStream();
+    return Http::FilterDataStatus::StopIterationNoBuffer;
+  }
+  data.move(body);
+
+  if (!http_body_response_headers_set_) {
+    // The headers are held until the content type of the first message is decoded.
+    if (!http_body_stream_decoder_->contentTypeDecoded()) {
+      return Http::FilterDataStatus::StopIterationAndBuffer;
+    }
+    response_headers_->setContentType(http_body_stream_decoder_->contentType());
+    http_body_response_headers_set_ = true;
+    if (!method_->descriptor_->server_streaming()) {
+      streamResponseHeaders();
+    }
+  }
+  return Http::FilterDataStatus::Continue;
+}
+
+void JsonTranscoderFilter::streamResponseHeaders() {
+  if (response_streamed_) {
+    return;
+  }
+  // The length of the response is unknown until it is complete.
+  response_headers_->removeContentLength();
+  response_streamed_ = true;
+}
+
 bool JsonTranscoderFilter::buildResponseFromHttpBodyOutput(
     Http::ResponseHeaderMap& response_headers, Buffer::Instance& data) {
   std::vector<Grpc::Frame> frames;
@@ -5,13 +5,18 @@
 #include "envoy/extensions/filters/http/grpc_json_transcoder/v3/transcoder.pb.h"
 #include "envoy/http/filter.h"
 #include "envoy/http/header_map.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/singleton/manager.h"
 
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/logger.h"
 #include "source/common/grpc/codec.h"
+#include "source/common/common/thread.h"
 #include "source/common/protobuf/protobuf.h"
+#include "source/extensions/filters/http/grpc_json_transcoder/http_body_stream_decoder.h"
 #include "source/extensions/filters/http/grpc_json_transcoder/transcoder_input_stream_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "google/api/http.pb.h"
 #include "grpc_transcoding/path_matcher.h"
 #include "grpc_transcoding/request_message_translator.h"
@@ -49,6 +54,86 @@ struct MethodInfo {
 };
 using MethodInfoSharedPtr = std::shared_ptr<MethodInfo>;
 
+/**
+ * The descriptor pool of a transcoder config and the index of the methods of its services: the
+ * path matcher of their HTTP rules and the type helper resolving their fields. It is immutable once
+ * built, so it is shared by the configs of the same descriptor set and method mapping.
+ */
+class CompiledDescriptorPool {
+public:
+  /**
+   * Builds the descriptor pool and the path matcher of the services of the config.
+   * @param proto_config supplies the config whose services are indexed.
+   * @param descriptor_set_bin supplies the serialized descriptor set of the config.
+   */
+  CompiledDescriptorPool(
+      const envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder&
+          proto_config,
+      const std::string& descriptor_set_bin);
+
+  const google::grpc::transcoding::TypeHelper& typeHelper() const { return *type_helper_; }
+
+  const google::grpc::transcoding::PathMatcher<MethodInfoSharedPtr>& pathMatcher() const {
+    return *path_matcher_;
+  }
+
+private:
+  void addFileDescriptor(const Protobuf::FileDescriptorProto& file);
+  void addBuiltinSymbolDescriptor(const std::string& symbol_name);
+  ProtobufUtil::Status resolveField(const Protobuf::Descriptor* descriptor,
+                                    const std::string& field_path_str,
+                                    std::vector<const ProtobufWkt::Field*>* field_path,
+                                    bool* is_http_body);
+  ProtobufUtil::Status createMethodInfo(const Protobuf::MethodDescriptor* descriptor,
+                                        const google::api::HttpRule& http_rule,
+                                        MethodInfoSharedPtr& method_info);
+
+  Protobuf::DescriptorPool descriptor_pool_;
+  std::unique_ptr<google::grpc::transcoding::TypeHelper> type_helper_;
+  // The method infos point into the descriptor pool and the type helper.
+  google::grpc::transcoding::PathMatcherPtr<MethodInfoSharedPtr> path_matcher_;
+};
+
+using CompiledDescriptorPoolConstSharedPtr = std::shared_ptr<const CompiledDescriptorPool>;
+
+/**
+ * The process-wide cache of the compiled descriptor pools, indexed by the descriptor set and the
+ * method mapping options they are built from. A pool is only kept while a config uses it, so that
+ * the configs of a listener or route update reuse the pools of the configs they replace rather than
+ * building them again. It is only accessed from the main thread.
+ */
+class CompiledDescriptorPoolCache : public Singleton::Instance {
+public:
+  /**
+   * @param proto_config supplies the config the pool is built for.
+   * @param descriptor_set supplies the serialized descriptor set of the config.
+   * @return the pool of the descriptor set and method mapping of the config, built if no config
+   *         uses it yet.
+   */
+  CompiledDescriptorPoolConstSharedPtr
+  get(const envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder&
+          proto_config,
+      const std::string& descriptor_set);
+
+  // @return the number of the pools in the cache, including the ones no config uses anymore.
+  size_t size() const;
+
+  // Get the cache singleton.
+  static std::shared_ptr<CompiledDescriptorPoolCache>
+  singleton(Singleton::Manager& singleton_manager);
+
+private:
+  mutable Thread::MutexBasicLockable mutex_;
+  absl::flat_hash_map<std::string, std::weak_ptr<const CompiledDescriptorPool>>
+      pools_ ABSL_GUARDED_BY(mutex_);
+  // The number of pools above which the pools no config uses are removed.
+  size_t sweep_size_ ABSL_GUARDED_BY(mutex_){MinSweepSize};
+
+  static constexpr size_t MinSweepSize = 16;
+};
+
+using CompiledDescriptorPoolCacheSharedPtr = std::shared_ptr<CompiledDescriptorPoolCache>;
+
 /**
  * Global configuration for the gRPC JSON transcoder filter. Factory for the Transcoder interface.
  */
@@ -59,11 +144,13 @@ public:
   /**
    * constructor that loads protobuf descriptors from the file specified in the JSON config.
    * and construct a path matcher for HTTP path bindings.
+   * @param cache supplies the cache to share the descriptor pool with the other configs of the
+   *              same descriptor set, if any. Otherwise the config builds its own.
    */
   JsonTranscoderConfig(
       const envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder&
           proto_config,
-      Api::Api& api);
+      Api::Api& api, CompiledDescriptorPoolCacheSharedPtr cache = nullptr);
 
   /**
    * Create an instance of Transcoder interface based on incoming request.
@@ -102,8 +189,17 @@ public:
    */
   bool convertGrpcStatus() const;
 
+  /**
+   * If true, forward the responses as they are transcoded rather than once they are complete, and
+   * decode the HttpBody responses incrementally.
+   */
+  bool streamResponses() const { return stream_responses_; }
+
   bool disabled() const { return disabled_; }
 
+  // @return the descriptor pool of the config, which is null if the config is disabled.
+  const CompiledDescriptorPoolConstSharedPtr& descriptorPool() const { return descriptor_pool_; }
+
   envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder::
       RequestValidationOptions request_validation_options_{};
 
@@ -114,24 +210,15 @@ private:
   ProtobufUtil::Status methodToRequestInfo(const MethodInfoSharedPtr& method_info,
                                            google::grpc::transcoding::RequestInfo* info) const;
 
-  void addFileDescriptor(const Protobuf::FileDescriptorProto& file);
-  void addBuiltinSymbolDescriptor(const std::string& symbol_name);
-  ProtobufUtil::Status resolveField(const Protobuf::Descriptor* descriptor,
-                                    const std::string& field_path_str,
-                                    std::vector<const ProtobufWkt::Field*>* field_path,
-                                    bool* is_http_body);
-  ProtobufUtil::Status createMethodInfo(const Protobuf::MethodDescriptor* descriptor,
-                                        const google::api::HttpRule& http_rule,
-                                        MethodInfoSharedPtr& method_info);
-
-  Protobuf::DescriptorPool descriptor_pool_;
-  google::grpc::transcoding::PathMatcherPtr<MethodInfoSharedPtr> path_matcher_;
-  std::unique_ptr<google::grpc::transcoding::TypeHelper> type_helper_;
+  // Keeps the cache alive for as long as a config may share its pools.
+  const CompiledDescriptorPoolCacheSharedPtr cache_;
+  CompiledDescriptorPoolConstSharedPtr descriptor_pool_;
   Protobuf::util::JsonPrintOptions print_options_;
 
   bool match_incoming_request_route_{false};
   bool ignore_unknown_query_parameters_{false};
   bool convert_grpc_status_{false};
+  bool stream_responses_{false};
 
   bool disabled_;
 };
@@ -181,6 +268,9 @@ private:
   bool maybeConvertGrpcStatus(Grpc::Status::GrpcStatus grpc_status,
                               Http::ResponseHeaderOrTrailerMap& trailers);
   bool hasHttpBodyAsOutputType();
+  Http::FilterDataStatus encodeHttpBodyStream(Buffer::Instance& data);
+  // Forwards the response headers with the first transcoded data of a streamed unary response.
+  void streamResponseHeaders();
   void doTrailers(Http::ResponseHeaderOrTrailerMap& headers_or_trailers);
   void initPerRouteConfig();
 
@@ -198,6 +288,7 @@ private:
   MethodInfoSharedPtr method_;
   Http::ResponseHeaderMap* response_headers_{};
   Grpc::Decoder decoder_;
+  std::unique_ptr<HttpBodyStreamDecoder> http_body_stream_decoder_;
 
   // Data of the initial request message, initialized from query arguments, path, etc.
   Buffer::OwnedImpl initial_request_data_;
@@ -208,6 +299,8 @@ private:
   bool error_{false};
   bool has_body_{false};
   bool http_body_response_headers_set_{false};
+  // Whether the headers of a unary response were forwarded before its end.
+  bool response_streamed_{false};
 };
 
 } // namespace GrpcJsonTranscoder
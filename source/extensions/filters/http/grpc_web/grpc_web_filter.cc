@@ -157,6 +157,9 @@ void GrpcWebFilter::setTransformedNonProtoEncodedResponseHeaders(Buffer::Instanc
 // TODO(fengli): Implements the subtypes of gRPC-Web content-type other than proto, like +json, etc.
 Http::FilterHeadersStatus GrpcWebFilter::decodeHeaders(Http::RequestHeaderMap& headers, bool) {
   if (!isGrpcWebRequest(headers)) {
+    // Nothing else of the stream is translated.
+    decoder_callbacks_->skipRemainingCallbacks();
+    encoder_callbacks_->skipRemainingCallbacks();
     return Http::FilterHeadersStatus::Continue;
   }
   is_grpc_web_request_ = true;
@@ -3,10 +3,14 @@
 #include "envoy/config/core/v3/address.pb.h"
 #include "envoy/extensions/filters/http/ip_tagging/v3/ip_tagging.pb.h"
 
+#include "source/common/common/thread.h"
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/headers.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -15,24 +19,23 @@ namespace IpTagging {
 
 IpTaggingFilterConfig::IpTaggingFilterConfig(
     const envoy::extensions::filters::http::ip_tagging::v3::IPTagging& config,
-    const std::string& stat_prefix, Stats::Scope& scope, Runtime::Loader& runtime)
-    : request_type_(requestTypeEnum(config.request_type())), scope_(scope), runtime_(runtime),
-      stat_name_set_(scope.symbolTable().makeSet("IpTagging")),
+    const std::string& stat_prefix, Server::Configuration::FactoryContext& context)
+    : request_type_(requestTypeEnum(config.request_type())), scope_(context.scope()),
+      runtime_(context.runtime()), stat_name_set_(scope_.symbolTable().makeSet("IpTagging")),
       stats_prefix_(stat_name_set_->add(stat_prefix + "ip_tagging")),
       no_hit_(stat_name_set_->add("no_hit")), total_(stat_name_set_->add("total")),
-      unknown_tag_(stat_name_set_->add("unknown_tag.hit")) {
-
-  // Once loading IP tags from a file system is supported, the restriction on the size
-  // of the set should be removed and observability into what tags are loaded needs
-  // to be implemented.
-  // TODO(ccaraman): Remove size check once file system support is implemented.
-  // Work is tracked by issue https://github.com/envoyproxy/envoy/issues/2695.
-  if (config.ip_tags().empty()) {
-    throw EnvoyException("HTTP IP Tagging Filter requires ip_tags to be specified.");
+      unknown_tag_(stat_name_set_->add("unknown_tag.hit")),
+      reload_success_(stat_name_set_->add("ip_tags_reload_success")),
+      reload_failure_(stat_name_set_->add("ip_tags_reload_failure")),
+      ip_tags_files_(config.ip_tags_files().begin(), config.ip_tags_files().end()),
+      api_(context.api()), main_thread_dispatcher_(context.dispatcher()),
+      cluster_manager_(context.clusterManager()) {
+  if (config.ip_tags().empty() && ip_tags_files_.empty()) {
+    throw EnvoyException(
+        "HTTP IP Tagging Filter requires ip_tags or ip_tags_files to be specified.");
   }
 
-  std::vector<std::pair<std::string, std::vector<Network::Address::CidrRange>>> tag_data;
-  tag_data.reserve(config.ip_tags().size());
+  config_tag_data_.reserve(config.ip_tags().size());
   for (const auto& ip_tag : config.ip_tags()) {
     std::vector<Network::Address::CidrRange> cidr_set;
     cidr_set.reserve(ip_tag.ip_list().size());
@@ -49,10 +52,113 @@ IpTaggingFilterConfig::IpTaggingFilterConfig(
       }
     }
 
-    tag_data.emplace_back(ip_tag.ip_tag_name(), cidr_set);
-    stat_name_set_->rememberBuiltin(absl::StrCat(ip_tag.ip_tag_name(), ".hit"));
+    config_tag_data_.emplace_back(ip_tag.ip_tag_name(), cidr_set);
+  }
+  if (ip_tags_files_.empty()) {
+    for (const auto& tag : config_tag_data_) {
+      stat_name_set_->rememberBuiltin(absl::StrCat(tag.first, ".hit"));
+    }
+    trie_ = std::make_shared<const IpTagsTrie>(config_tag_data_);
+    config_tag_data_.clear();
+    return;
+  }
+
+  // The files are loaded inline at first, so that a config with an invalid file is rejected.
+  IpTagsData tag_data = config_tag_data_;
+  for (const std::string& path : ip_tags_files_) {
+    parseIpTagsFile(api_.fileSystem().fileReadToEnd(path), tag_data);
+  }
+  // The IP tags which are only in the reloaded files are not remembered as builtins, so their
+  // hits are counted as unknown_tag.hit.
+  for (const auto& tag : tag_data) {
+    stat_name_set_->rememberBuiltin(absl::StrCat(tag.first, ".hit"));
+  }
+  trie_ = std::make_shared<const IpTagsTrie>(tag_data);
+
+  tls_ = ThreadLocal::TypedSlot<ThreadLocalTrie>::makeUnique(context.threadLocal());
+  tls_->set([trie = trie_](Event::Dispatcher&) { return std::make_shared<ThreadLocalTrie>(trie); });
+  watcher_ = main_thread_dispatcher_.createFilesystemWatcher();
+  for (const std::string& path : ip_tags_files_) {
+    watcher_->addWatch(path, Filesystem::Watcher::Events::MovedTo,
+                       [this](uint32_t) { reloadIpTagsFiles(); });
+  }
+}
+
+void IpTaggingFilterConfig::parseIpTagsFile(absl::string_view content, IpTagsData& tag_data) {
+  // The ranges of each tag are appended to the first entry of the tag added by the file.
+  absl::flat_hash_map<std::string, size_t> tag_indexes;
+  for (absl::string_view line : absl::StrSplit(content, '\n')) {
+    line = absl::StripAsciiWhitespace(line);
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    const std::vector<absl::string_view> fields =
+        absl::StrSplit(line, absl::ByAnyChar(" \t"), absl::SkipEmpty());
+    if (fields.size() != 2) {
+      throw EnvoyException(
+          fmt::format("invalid IP tags line '{}' (format is <tag> <ip>/<# mask bits>)", line));
+    }
+    Network::Address::CidrRange cidr_entry =
+        Network::Address::CidrRange::create(std::string(fields[1]));
+    if (!cidr_entry.isValid()) {
+      throw EnvoyException(
+          fmt::format("invalid ip/mask combo '{}' (format is <ip>/<# mask bits>)", fields[1]));
+    }
+    const auto index = tag_indexes.try_emplace(fields[0], tag_data.size());
+    if (index.second) {
+      tag_data.emplace_back(std::string(fields[0]), std::vector<Network::Address::CidrRange>());
+    }
+    tag_data[index.first->second].second.emplace_back(std::move(cidr_entry));
+  }
+}
+
+void IpTaggingFilterConfig::reloadIpTagsFiles() {
+  if (reloading_) {
+    reload_again_ = true;
+    return;
+  }
+  reloading_ = true;
+
+  // The build only reads copies of the config, so it may outlive the config on another thread.
+  auto trie = std::make_shared<IpTagsTrieSharedPtr>();
+  auto build = [trie, tag_data = config_tag_data_, paths = ip_tags_files_,
+                &file_system = api_.fileSystem()]() mutable {
+    TRY_NEEDS_AUDIT {
+      for (const std::string& path : paths) {
+        parseIpTagsFile(file_system.fileReadToEnd(path), tag_data);
+      }
+      *trie = std::make_shared<const IpTagsTrie>(tag_data);
+    }
+    catch (const EnvoyException& e) {
+      ENVOY_LOG(error, "failed to reload the IP tags files: {}", e.what());
+    }
+  };
+  auto publish = [this, trie, alive = std::weak_ptr<bool>(alive_)]() {
+    // The config is destroyed on the main thread, so it is alive unless it has expired.
+    if (alive.expired()) {
+      return;
+    }
+    onIpTagsReloaded(std::move(*trie));
+  };
+  if (!cluster_manager_.runOnClusterInitThread(build, publish)) {
+    build();
+    publish();
+  }
+}
+
+void IpTaggingFilterConfig::onIpTagsReloaded(IpTagsTrieSharedPtr trie) {
+  reloading_ = false;
+  if (trie == nullptr) {
+    incCounter(reload_failure_);
+  } else {
+    incCounter(reload_success_);
+    trie_ = trie;
+    tls_->runOnAllThreads([trie](OptRef<ThreadLocalTrie> tls_trie) { tls_trie->trie_ = trie; });
+  }
+  if (reload_again_) {
+    reload_again_ = false;
+    reloadIpTagsFiles();
   }
-  trie_ = std::make_unique<Network::LcTrie::LcTrie<std::string>>(tag_data);
 }
 
 void IpTaggingFilterConfig::incCounter(Stats::StatName name) {
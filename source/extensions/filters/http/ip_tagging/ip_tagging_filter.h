@@ -6,12 +6,18 @@
 #include <utility>
 #include <vector>
 
+#include "envoy/api/api.h"
 #include "envoy/common/exception.h"
 #include "envoy/extensions/filters/http/ip_tagging/v3/ip_tagging.pb.h"
+#include "envoy/filesystem/watcher.h"
 #include "envoy/http/filter.h"
 #include "envoy/runtime/runtime.h"
+#include "envoy/server/filter_config.h"
 #include "envoy/stats/scope.h"
+#include "envoy/thread_local/thread_local.h"
+#include "envoy/upstream/cluster_manager.h"
 
+#include "source/common/common/logger.h"
 #include "source/common/network/cidr_range.h"
 #include "source/common/network/lc_trie.h"
 #include "source/common/stats/symbol_table_impl.h"
@@ -26,18 +32,22 @@ namespace IpTagging {
  */
 enum class FilterRequestType { INTERNAL, EXTERNAL, BOTH };
 
+using IpTagsTrie = Network::LcTrie::LcTrie<std::string>;
+using IpTagsTrieSharedPtr = std::shared_ptr<const IpTagsTrie>;
+using IpTagsData = std::vector<std::pair<std::string, std::vector<Network::Address::CidrRange>>>;
+
 /**
  * Configuration for the HTTP IP Tagging filter.
  */
-class IpTaggingFilterConfig {
+class IpTaggingFilterConfig : Logger::Loggable<Logger::Id::filter> {
 public:
   IpTaggingFilterConfig(const envoy::extensions::filters::http::ip_tagging::v3::IPTagging& config,
-                        const std::string& stat_prefix, Stats::Scope& scope,
-                        Runtime::Loader& runtime);
+                        const std::string& stat_prefix,
+                        Server::Configuration::FactoryContext& context);
 
   Runtime::Loader& runtime() { return runtime_; }
   FilterRequestType requestType() const { return request_type_; }
-  const Network::LcTrie::LcTrie<std::string>& trie() const { return *trie_; }
+  const IpTagsTrie& trie() const { return tls_ != nullptr ? *(*tls_)->trie_ : *trie_; }
 
   void incHit(absl::string_view tag) {
     incCounter(stat_name_set_->getBuiltin(absl::StrCat(tag, ".hit"), unknown_tag_));
@@ -45,7 +55,25 @@ public:
   void incNoHit() { incCounter(no_hit_); }
   void incTotal() { incCounter(total_); }
 
+  /**
+   * Parses the IP tags of a file of ip_tags_files.
+   * @param content supplies the content of the file.
+   * @param tag_data supplies the IP tags to add the IP tags of the file to.
+   * @throw EnvoyException if a line of the file is not valid.
+   */
+  static void parseIpTagsFile(absl::string_view content, IpTagsData& tag_data);
+
 private:
+  struct ThreadLocalTrie : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalTrie(IpTagsTrieSharedPtr trie) : trie_(std::move(trie)) {}
+    IpTagsTrieSharedPtr trie_;
+  };
+
+  // Rebuilds the IP tags from the files, off the main thread if possible, and swaps them into the
+  // workers.
+  void reloadIpTagsFiles();
+  void onIpTagsReloaded(IpTagsTrieSharedPtr trie);
+
   static FilterRequestType requestTypeEnum(
       envoy::extensions::filters::http::ip_tagging::v3::IPTagging::RequestType request_type) {
     switch (request_type) {
@@ -70,7 +98,23 @@ private:
   const Stats::StatName no_hit_;
   const Stats::StatName total_;
   const Stats::StatName unknown_tag_;
-  std::unique_ptr<Network::LcTrie::LcTrie<std::string>> trie_;
+  const Stats::StatName reload_success_;
+  const Stats::StatName reload_failure_;
+  // The IP tags of the config, added to the IP tags of the files when they are reloaded.
+  IpTagsData config_tag_data_;
+  const std::vector<std::string> ip_tags_files_;
+  Api::Api& api_;
+  Event::Dispatcher& main_thread_dispatcher_;
+  Upstream::ClusterManager& cluster_manager_;
+  // The latest IP tags, and if there are files, their copies on the workers.
+  IpTagsTrieSharedPtr trie_;
+  ThreadLocal::TypedSlotPtr<ThreadLocalTrie> tls_;
+  Filesystem::WatcherPtr watcher_;
+  bool reloading_{};
+  bool reload_again_{};
+  // Expires with the config, so that a reload finishing on the main thread after the config is
+  // destroyed is dropped.
+  std::shared_ptr<bool> alive_{std::make_shared<bool>(true)};
 };
 
 using IpTaggingFilterConfigSharedPtr = std::shared_ptr<IpTaggingFilterConfig>;
@@ -58,6 +58,12 @@ private:
   // Verify with a specific public key.
   void verifyKey();
 
+  // Handle a JWT whose signature is verified, either just now or when it was cached.
+  void handleGoodJwt(bool cache_hit);
+
+  // Lookup the current token in the cache of the verified JWTs of the provider.
+  ::google::jwt_verify::Jwt* lookupJwtCache();
+
   // Calls the callback with status.
   void doneWithStatus(const Status& status);
 
@@ -79,8 +85,10 @@ private:
   // The token data
   std::vector<JwtLocationConstPtr> tokens_;
   JwtLocationConstPtr curr_token_;
-  // The JWT object.
-  std::unique_ptr<::google::jwt_verify::Jwt> jwt_;
+  // The JWT object parsed from the current token.
+  std::unique_ptr<::google::jwt_verify::Jwt> owned_jwt_;
+  // The JWT object being verified, either parsed or found in the cache.
+  ::google::jwt_verify::Jwt* jwt_{};
   // The JWKS data object
   JwksCache::JwksData* jwks_data_{};
 
@@ -140,12 +148,25 @@ void AuthenticatorImpl::startVerify() {
   curr_token_ = std::move(tokens_.back());
   tokens_.pop_back();
 
-  jwt_ = std::make_unique<::google::jwt_verify::Jwt>();
-  ENVOY_LOG(debug, "{}: Parse Jwt {}", name(), curr_token_->token());
-  Status status = jwt_->parseFromString(curr_token_->token());
-  if (status != Status::Ok) {
-    doneWithStatus(status);
-    return;
+  jwt_ = nullptr;
+  jwks_data_ = nullptr;
+  if (provider_) {
+    // The provider is known before the JWT is parsed, so a cached JWT saves parsing it too.
+    jwks_data_ = jwks_cache_.findByProvider(provider_.value());
+    jwt_ = lookupJwtCache();
+  }
+  const bool cache_hit = jwt_ != nullptr;
+
+  Status status = Status::Ok;
+  if (!cache_hit) {
+    owned_jwt_ = std::make_unique<::google::jwt_verify::Jwt>();
+    ENVOY_LOG(debug, "{}: Parse Jwt {}", name(), curr_token_->token());
+    status = owned_jwt_->parseFromString(curr_token_->token());
+    if (status != Status::Ok) {
+      doneWithStatus(status);
+      return;
+    }
+    jwt_ = owned_jwt_.get();
   }
 
   ENVOY_LOG(debug, "{}: Verifying JWT token of issuer {}", name(), jwt_->iss_);
@@ -158,8 +179,9 @@ void AuthenticatorImpl::startVerify() {
   }
 
   // Check the issuer is configured or not.
-  jwks_data_ = provider_ ? jwks_cache_.findByProvider(provider_.value())
-                         : jwks_cache_.findByIssuer(jwt_->iss_);
+  if (!provider_) {
+    jwks_data_ = jwks_cache_.findByIssuer(jwt_->iss_);
+  }
   // When `provider` is valid, findByProvider should never return nullptr.
   // Only when `allow_missing` or `allow_failed` is used, `provider` is invalid,
   // and this authenticator is checking tokens from all providers. In this case,
@@ -191,6 +213,12 @@ void AuthenticatorImpl::startVerify() {
     return;
   }
 
+  if (cache_hit || (!provider_ && lookupJwtCache() != nullptr)) {
+    // The signature of the JWT was verified when it was cached.
+    handleGoodJwt(true);
+    return;
+  }
+
   auto jwks_obj = jwks_data_->getJwksObj();
   if (jwks_obj != nullptr && !jwks_data_->isExpired()) {
     // TODO(qiwzhang): It would seem there's a window of error whereby if the JWT issuer
@@ -251,6 +279,24 @@ void AuthenticatorImpl::verifyKey() {
     return;
   }
 
+  handleGoodJwt(false);
+}
+
+::google::jwt_verify::Jwt* AuthenticatorImpl::lookupJwtCache() {
+  JwtCache* jwt_cache = jwks_data_->getJwtCache();
+  if (jwt_cache == nullptr) {
+    return nullptr;
+  }
+  ::google::jwt_verify::Jwt* jwt = jwt_cache->lookup(curr_token_->token());
+  if (jwt != nullptr) {
+    jwks_cache_.stats().jwt_cache_hit_.inc();
+  } else {
+    jwks_cache_.stats().jwt_cache_miss_.inc();
+  }
+  return jwt;
+}
+
+void AuthenticatorImpl::handleGoodJwt(bool cache_hit) {
   // Forward the payload
   const auto& provider = jwks_data_->getJwtProvider();
 
@@ -275,6 +321,10 @@ void AuthenticatorImpl::verifyKey() {
     set_payload_cb_(provider.payload_in_metadata(), jwt_->payload_pb_);
   }
 
+  JwtCache* jwt_cache = jwks_data_->getJwtCache();
+  if (!cache_hit && jwt_cache != nullptr) {
+    jwt_cache->insert(curr_token_->token(), std::move(owned_jwt_));
+  }
   doneWithStatus(Status::Ok);
 }
 
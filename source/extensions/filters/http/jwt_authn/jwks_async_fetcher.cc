@@ -19,9 +19,11 @@ constexpr int PubkeyCacheExpirationSec = 600;
 JwksAsyncFetcher::JwksAsyncFetcher(const RemoteJwks& remote_jwks,
                                    Server::Configuration::FactoryContext& context,
                                    CreateJwksFetcherCb create_fetcher_fn,
-                                   JwtAuthnFilterStats& stats, JwksDoneFetched done_fn)
+                                   JwtAuthnFilterStats& stats, JwksDoneFetched done_fn,
+                                   JwksFresh fresh_fn)
     : remote_jwks_(remote_jwks), context_(context), create_fetcher_fn_(create_fetcher_fn),
-      stats_(stats), done_fn_(done_fn), cache_duration_(getCacheDuration(remote_jwks)),
+      stats_(stats), done_fn_(done_fn), fresh_fn_(fresh_fn),
+      cache_duration_(getCacheDuration(remote_jwks)),
       debug_name_(absl::StrCat("Jwks async fetching url=", remote_jwks_.http_uri().uri())) {
   // if async_fetch is not enabled, do nothing.
   if (!remote_jwks_.has_async_fetch()) {
@@ -53,6 +55,12 @@ void JwksAsyncFetcher::fetch() {
     fetcher_->cancel();
   }
 
+  if (fresh_fn_ && fresh_fn_()) {
+    ENVOY_LOG(debug, "{}: skipped, the Jwks is fresh", debug_name_);
+    handleFetchDone();
+    return;
+  }
+
   ENVOY_LOG(debug, "{}: started", debug_name_);
   fetcher_ = create_fetcher_fn_(context_.clusterManager());
   fetcher_->fetch(remote_jwks_.http_uri(), Tracing::NullSpan::instance(), *this);
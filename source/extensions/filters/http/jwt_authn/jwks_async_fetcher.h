@@ -23,18 +23,25 @@ using CreateJwksFetcherCb = std::function<Common::JwksFetcherPtr(Upstream::Clust
  *  JwksDoneFetched is a callback interface to set a Jwks when fetch is done.
  */
 using JwksDoneFetched = std::function<void(google::jwt_verify::JwksPtr&& jwks)>;
+/**
+ *  JwksFresh is a callback interface to check if a Jwks was fetched recently enough, e.g. for
+ *  another provider with the same remote Jwks, that fetching it again can be skipped.
+ */
+using JwksFresh = std::function<bool()>;
 
 // This class handles fetching Jwks asynchronously.
 // It will be no-op if async_fetch is not enabled.
 // At its constructor, it will start to fetch Jwks, register with init_manager if not fast_listener.
 // and handle fetching response. When cache is expired, it will fetch again.
-// When a Jwks is fetched, done_fn is called to set the Jwks.
+// When a Jwks is fetched, done_fn is called to set the Jwks. A fetch is skipped if fresh_fn, when
+// set, returns true.
 class JwksAsyncFetcher : public Logger::Loggable<Logger::Id::jwt>,
                          public Common::JwksFetcher::JwksReceiver {
 public:
   JwksAsyncFetcher(const envoy::extensions::filters::http::jwt_authn::v3::RemoteJwks& remote_jwks,
                    Server::Configuration::FactoryContext& context, CreateJwksFetcherCb fetcher_fn,
-                   JwtAuthnFilterStats& stats, JwksDoneFetched done_fn);
+                   JwtAuthnFilterStats& stats, JwksDoneFetched done_fn,
+                   JwksFresh fresh_fn = nullptr);
 
   // Get the remote Jwks cache duration.
   static std::chrono::seconds
@@ -60,6 +67,8 @@ private:
   JwtAuthnFilterStats& stats_;
   // the Jwks done function.
   const JwksDoneFetched done_fn_;
+  // the function to check if the Jwks is fresh.
+  const JwksFresh fresh_fn_;
 
   // The Jwks fetcher object
   Common::JwksFetcherPtr fetcher_;
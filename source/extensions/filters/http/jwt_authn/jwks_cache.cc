@@ -1,7 +1,5 @@
 #include "source/extensions/filters/http/jwt_authn/jwks_cache.h"
 
-#include <chrono>
-
 #include "envoy/common/time.h"
 #include "envoy/extensions/filters/http/jwt_authn/v3/config.pb.h"
 
@@ -25,7 +23,8 @@ namespace {
 class JwksDataImpl : public JwksCache::JwksData, public Logger::Loggable<Logger::Id::jwt> {
 public:
   JwksDataImpl(const JwtProvider& jwt_provider, Server::Configuration::FactoryContext& context,
-               CreateJwksFetcherCb fetcher_cb, JwtAuthnFilterStats& stats)
+               CreateJwksFetcherCb fetcher_cb, JwtAuthnFilterStats& stats,
+               JwksRegistry& jwks_registry)
       : jwt_provider_(jwt_provider), time_source_(context.timeSource()),
         tls_(context.threadLocal()) {
 
@@ -35,7 +34,13 @@ public:
     }
     audiences_ = std::make_unique<::google::jwt_verify::CheckAudience>(audiences);
 
-    tls_.set([](Envoy::Event::Dispatcher&) { return std::make_shared<ThreadLocalCache>(); });
+    tls_.set([this](Envoy::Event::Dispatcher&) {
+      auto cache = std::make_shared<ThreadLocalCache>();
+      if (jwt_provider_.has_jwt_cache_config()) {
+        cache->jwt_cache_ = JwtCache::create(jwt_provider_.jwt_cache_config(), time_source_);
+      }
+      return cache;
+    });
 
     const auto inline_jwks =
         Config::DataSource::read(jwt_provider_.local_jwks(), true, context.api());
@@ -46,16 +51,30 @@ public:
         ENVOY_LOG(warn, "Invalid inline jwks for issuer: {}, jwks: {}", jwt_provider_.issuer(),
                   inline_jwks);
       } else {
-        setJwksToAllThreads(std::move(jwks));
+        shared_jwks_ = jwks_registry.create();
+        shared_jwks_->setJwksToAllThreads(std::move(jwks), MonotonicTime::max());
       }
     } else {
       // create async_fetch for remote_jwks, if is no-op if async_fetch is not enabled.
       if (jwt_provider_.has_remote_jwks()) {
+        // The Jwks of the remote URI is shared with the providers of all the filter configs.
+        shared_jwks_ = jwks_registry.get(jwt_provider_.remote_jwks());
         async_fetcher_ = std::make_unique<JwksAsyncFetcher>(
             jwt_provider_.remote_jwks(), context, fetcher_cb, stats,
-            [this](google::jwt_verify::JwksPtr&& jwks) { setJwksToAllThreads(std::move(jwks)); });
+            [this](google::jwt_verify::JwksPtr&& jwks) {
+              // The fetched Jwks doesn't expire, it is refreshed by the async fetcher.
+              shared_jwks_->setJwksToAllThreads(std::move(jwks), MonotonicTime::max());
+            },
+            [this]() {
+              return shared_jwks_->isFresh(
+                  JwksAsyncFetcher::getCacheDuration(jwt_provider_.remote_jwks()));
+            });
       }
     }
+    if (shared_jwks_ == nullptr) {
+      // No Jwks is ever set.
+      shared_jwks_ = jwks_registry.create();
+    }
   }
 
   const JwtProvider& getJwtProvider() const override { return jwt_provider_; }
@@ -64,36 +83,23 @@ public:
     return audiences_->areAudiencesAllowed(jwt_audiences);
   }
 
-  const Jwks* getJwksObj() const override { return tls_->jwks_.get(); }
+  const Jwks* getJwksObj() const override { return shared_jwks_->getJwksObj(); }
 
-  bool isExpired() const override { return time_source_.monotonicTime() >= tls_->expire_; }
+  bool isExpired() const override { return shared_jwks_->isExpired(); }
 
   const ::google::jwt_verify::Jwks* setRemoteJwks(JwksConstPtr&& jwks) override {
-    // convert unique_ptr to shared_ptr
-    JwksConstSharedPtr shared_jwks = std::move(jwks);
-    tls_->jwks_ = shared_jwks;
-    tls_->expire_ = time_source_.monotonicTime() +
-                    JwksAsyncFetcher::getCacheDuration(jwt_provider_.remote_jwks());
-    return shared_jwks.get();
+    return shared_jwks_->setRemoteJwks(
+        std::move(jwks), JwksAsyncFetcher::getCacheDuration(jwt_provider_.remote_jwks()));
   }
 
+  JwtCache* getJwtCache() override { return tls_->jwt_cache_.get(); }
+
 private:
   struct ThreadLocalCache : public ThreadLocal::ThreadLocalObject {
-    // The jwks object.
-    JwksConstSharedPtr jwks_;
-    // The pubkey expiration time.
-    MonotonicTime expire_;
+    // The verified JWTs.
+    JwtCachePtr jwt_cache_;
   };
 
-  // Set jwks shared_ptr to all threads.
-  void setJwksToAllThreads(JwksConstPtr&& jwks) {
-    JwksConstSharedPtr shared_jwks = std::move(jwks);
-    tls_.runOnAllThreads([shared_jwks](OptRef<ThreadLocalCache> obj) {
-      obj->jwks_ = shared_jwks;
-      obj->expire_ = std::chrono::steady_clock::time_point::max();
-    });
-  }
-
   // The jwt provider config.
   const JwtProvider& jwt_provider_;
   // Check audience object
@@ -102,6 +108,8 @@ private:
   TimeSource& time_source_;
   // the thread local slot for cache
   ThreadLocal::TypedSlot<ThreadLocalCache> tls_;
+  // the Jwks, shared with the other providers of the same remote Jwks.
+  SharedJwksSharedPtr shared_jwks_;
   // async fetcher
   JwksAsyncFetcherPtr async_fetcher_;
 };
@@ -113,10 +121,11 @@ public:
   // Load the config from envoy config.
   JwksCacheImpl(const JwtAuthentication& config, Server::Configuration::FactoryContext& context,
                 CreateJwksFetcherCb fetcher_fn, JwtAuthnFilterStats& stats)
-      : stats_(stats) {
+      : stats_(stats), jwks_registry_(JwksRegistry::singleton(context)) {
     for (const auto& it : config.providers()) {
       const auto& provider = it.second;
-      auto jwks_data = std::make_unique<JwksDataImpl>(provider, context, fetcher_fn, stats);
+      auto jwks_data =
+          std::make_unique<JwksDataImpl>(provider, context, fetcher_fn, stats, *jwks_registry_);
       if (issuer_ptr_map_.find(provider.issuer()) == issuer_ptr_map_.end()) {
         issuer_ptr_map_.emplace(provider.issuer(), jwks_data.get());
       }
@@ -155,6 +164,8 @@ private:
 
   // stats
   JwtAuthnFilterStats& stats_;
+  // The registry of the shared Jwks, kept alive as long as the providers use it.
+  const JwksRegistrySharedPtr jwks_registry_;
   // The Jwks data map indexed by provider.
   absl::node_hash_map<std::string, JwksDataImplPtr> jwks_data_map_;
   // The Jwks data pointer map indexed by issuer.
@@ -8,6 +8,8 @@
 
 #include "source/extensions/filters/http/common/jwks_fetcher.h"
 #include "source/extensions/filters/http/jwt_authn/jwks_async_fetcher.h"
+#include "source/extensions/filters/http/jwt_authn/jwks_registry.h"
+#include "source/extensions/filters/http/jwt_authn/jwt_cache.h"
 #include "source/extensions/filters/http/jwt_authn/stats.h"
 
 #include "jwt_verify_lib/jwks.h"
@@ -20,9 +22,6 @@ namespace JwtAuthn {
 class JwksCache;
 using JwksCachePtr = std::unique_ptr<JwksCache>;
 
-using JwksConstPtr = std::unique_ptr<const ::google::jwt_verify::Jwks>;
-using JwksConstSharedPtr = std::shared_ptr<const ::google::jwt_verify::Jwks>;
-
 /**
  * Interface to access all configured Jwt rules and their cached Jwks objects.
  * It only caches Jwks specified in the config.
@@ -65,6 +64,9 @@ public:
 
     // Set a remote Jwks.
     virtual const ::google::jwt_verify::Jwks* setRemoteJwks(JwksConstPtr&& jwks) PURE;
+
+    // Get the cache of the verified JWTs, or nullptr if the provider doesn't cache them.
+    virtual JwtCache* getJwtCache() PURE;
   };
 
   // Lookup issuer cache map. The cache only stores Jwks specified in the config.
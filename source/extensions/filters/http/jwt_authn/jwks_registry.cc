@@ -0,0 +1,85 @@
+#include "source/extensions/filters/http/jwt_authn/jwks_registry.h"
+
+#include "envoy/singleton/manager.h"
+
+#include "absl/strings/str_cat.h"
+
+using envoy::extensions::filters::http::jwt_authn::v3::RemoteJwks;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+
+SharedJwks::SharedJwks(ThreadLocal::SlotAllocator& tls, Event::Dispatcher& main_dispatcher,
+                       TimeSource& time_source)
+    : main_dispatcher_(main_dispatcher), time_source_(time_source), tls_(tls) {
+  tls_.set([](Envoy::Event::Dispatcher&) { return std::make_shared<ThreadLocalJwks>(); });
+}
+
+const ::google::jwt_verify::Jwks* SharedJwks::setRemoteJwks(JwksConstPtr&& jwks,
+                                                            std::chrono::seconds cache_duration) {
+  // convert unique_ptr to shared_ptr
+  JwksConstSharedPtr shared_jwks = std::move(jwks);
+  const MonotonicTime expire = time_source_.monotonicTime() + cache_duration;
+  tls_->jwks_ = shared_jwks;
+  tls_->expire_ = expire;
+
+  // The other workers would otherwise fetch the same Jwks when they next need it.
+  std::weak_ptr<SharedJwks> weak_this = weak_from_this();
+  main_dispatcher_.post([weak_this, shared_jwks, expire]() {
+    if (auto shared_this = weak_this.lock()) {
+      shared_this->setJwksToAllThreads(shared_jwks, expire);
+    }
+  });
+  return shared_jwks.get();
+}
+
+void SharedJwks::setJwksToAllThreads(JwksConstSharedPtr jwks, MonotonicTime expire) {
+  last_published_ = time_source_.monotonicTime();
+  tls_.runOnAllThreads([jwks, expire](OptRef<ThreadLocalJwks> obj) {
+    obj->jwks_ = jwks;
+    obj->expire_ = expire;
+  });
+}
+
+bool SharedJwks::isFresh(std::chrono::seconds cache_duration) const {
+  return last_published_.has_value() &&
+         time_source_.monotonicTime() < last_published_.value() + cache_duration;
+}
+
+JwksRegistry::JwksRegistry(ThreadLocal::SlotAllocator& tls, Event::Dispatcher& main_dispatcher,
+                           TimeSource& time_source)
+    : tls_(tls), main_dispatcher_(main_dispatcher), time_source_(time_source) {}
+
+SharedJwksSharedPtr JwksRegistry::get(const RemoteJwks& remote_jwks) {
+  const auto& http_uri = remote_jwks.http_uri();
+  // The cluster name is prefixed with its length so that it can't run into the URI.
+  std::weak_ptr<SharedJwks>& weak_jwks = shared_jwks_[absl::StrCat(
+      http_uri.cluster().size(), ":", http_uri.cluster(), http_uri.uri())];
+  SharedJwksSharedPtr jwks = weak_jwks.lock();
+  if (jwks == nullptr) {
+    jwks = create();
+    weak_jwks = jwks;
+  }
+  return jwks;
+}
+
+SharedJwksSharedPtr JwksRegistry::create() {
+  return std::make_shared<SharedJwks>(tls_, main_dispatcher_, time_source_);
+}
+
+SINGLETON_MANAGER_REGISTRATION(jwt_authn_jwks_registry);
+
+JwksRegistrySharedPtr JwksRegistry::singleton(Server::Configuration::FactoryContext& context) {
+  return context.singletonManager().getTyped<JwksRegistry>(
+      SINGLETON_MANAGER_REGISTERED_NAME(jwt_authn_jwks_registry), [&context] {
+        return std::make_shared<JwksRegistry>(context.threadLocal(), context.dispatcher(),
+                                              context.timeSource());
+      });
+}
+
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/extensions/filters/http/jwt_authn/v3/config.pb.h"
+#include "envoy/server/factory_context.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
+#include "jwt_verify_lib/jwks.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+
+using JwksConstPtr = std::unique_ptr<const ::google::jwt_verify::Jwks>;
+using JwksConstSharedPtr = std::shared_ptr<const ::google::jwt_verify::Jwks>;
+
+class SharedJwks;
+using SharedJwksSharedPtr = std::shared_ptr<SharedJwks>;
+
+/**
+ * A Jwks object published to all the workers. The Jwks of a remote URI is shared by all the
+ * providers fetching it, whatever their listener, so that it is fetched and parsed once, and each
+ * worker only references the same immutable Jwks object.
+ */
+class SharedJwks : public std::enable_shared_from_this<SharedJwks> {
+public:
+  SharedJwks(ThreadLocal::SlotAllocator& tls, Event::Dispatcher& main_dispatcher,
+             TimeSource& time_source);
+
+  // Get the Jwks object of the worker.
+  const ::google::jwt_verify::Jwks* getJwksObj() const { return tls_->jwks_.get(); }
+
+  // Return true if the Jwks object of the worker is expired.
+  bool isExpired() const { return time_source_.monotonicTime() >= tls_->expire_; }
+
+  // Set a Jwks the worker fetched, and publish it to the other workers from the main thread.
+  const ::google::jwt_verify::Jwks* setRemoteJwks(JwksConstPtr&& jwks,
+                                                  std::chrono::seconds cache_duration);
+
+  // Publish a Jwks to all the workers, expiring at `expire`. Must be called from the main thread.
+  void setJwksToAllThreads(JwksConstSharedPtr jwks, MonotonicTime expire);
+
+  // Return true if a Jwks was published to all the workers less than `cache_duration` ago, so that
+  // another provider fetching the same URI doesn't have to fetch it again. Must be called from the
+  // main thread.
+  bool isFresh(std::chrono::seconds cache_duration) const;
+
+private:
+  struct ThreadLocalJwks : public ThreadLocal::ThreadLocalObject {
+    // The jwks object.
+    JwksConstSharedPtr jwks_;
+    // The pubkey expiration time.
+    MonotonicTime expire_;
+  };
+
+  // the main dispatcher
+  Event::Dispatcher& main_dispatcher_;
+  // the time source
+  TimeSource& time_source_;
+  // the last time a Jwks was published to all the workers, only used on the main thread.
+  absl::optional<MonotonicTime> last_published_;
+  // the thread local slot for the Jwks
+  ThreadLocal::TypedSlot<ThreadLocalJwks> tls_;
+};
+
+/**
+ * The process-wide registry of the Jwks of the remote URIs, indexed by their cluster and URI. It is
+ * only accessed from the main thread, when the filter configs are created.
+ */
+class JwksRegistry : public Singleton::Instance {
+public:
+  JwksRegistry(ThreadLocal::SlotAllocator& tls, Event::Dispatcher& main_dispatcher,
+               TimeSource& time_source);
+
+  // Get the shared Jwks of a remote URI, creating it if no provider references it yet.
+  SharedJwksSharedPtr
+  get(const envoy::extensions::filters::http::jwt_authn::v3::RemoteJwks& remote_jwks);
+
+  // Create a Jwks object only shared by the workers, for a provider with local Jwks.
+  SharedJwksSharedPtr create();
+
+  // Get the registry singleton.
+  static std::shared_ptr<JwksRegistry> singleton(Server::Configuration::FactoryContext& context);
+
+private:
+  ThreadLocal::SlotAllocator& tls_;
+  Event::Dispatcher& main_dispatcher_;
+  TimeSource& time_source_;
+  // The shared Jwks, freed with the last provider referencing them.
+  absl::flat_hash_map<std::string, std::weak_ptr<SharedJwks>> shared_jwks_;
+};
+
+using JwksRegistrySharedPtr = std::shared_ptr<JwksRegistry>;
+
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,92 @@
+#include "source/extensions/filters/http/jwt_authn/jwt_cache.h"
+
+#include <list>
+
+#include "source/common/common/utility.h"
+
+#include "absl/container/flat_hash_map.h"
+
+using ::google::jwt_verify::Jwt;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+namespace {
+
+// Default number of JWTs each worker caches for a provider.
+constexpr uint32_t kDefaultJwtCacheSize = 100;
+
+class JwtCacheImpl : public JwtCache {
+public:
+  JwtCacheImpl(const envoy::extensions::filters::http::jwt_authn::v3::JwtCacheConfig& config,
+               TimeSource& time_source)
+      : max_size_(config.jwt_cache_size() > 0 ? config.jwt_cache_size() : kDefaultJwtCacheSize),
+        time_source_(time_source) {}
+
+  Jwt* lookup(const std::string& token) override {
+    const auto it = entries_.find(token);
+    if (it == entries_.end()) {
+      return nullptr;
+    }
+    if (isExpired(*it->second.jwt_)) {
+      lru_.erase(it->second.lru_position_);
+      entries_.erase(it);
+      return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second.lru_position_);
+    return it->second.jwt_.get();
+  }
+
+  void insert(const std::string& token, std::unique_ptr<Jwt>&& jwt) override {
+    if (isExpired(*jwt)) {
+      return;
+    }
+    const auto [it, inserted] = entries_.try_emplace(token);
+    if (inserted) {
+      lru_.push_front(token);
+      it->second.lru_position_ = lru_.begin();
+    } else {
+      lru_.splice(lru_.begin(), lru_, it->second.lru_position_);
+    }
+    it->second.jwt_ = std::move(jwt);
+
+    if (entries_.size() > max_size_) {
+      entries_.erase(lru_.back());
+      lru_.pop_back();
+    }
+  }
+
+private:
+  struct Entry {
+    std::unique_ptr<Jwt> jwt_;
+    std::list<std::string>::iterator lru_position_;
+  };
+
+  // A JWT without `exp` never expires.
+  bool isExpired(const Jwt& jwt) const {
+    return jwt.exp_ != 0 && DateUtil::nowToSeconds(time_source_) > jwt.exp_;
+  }
+
+  // The maximum number of cached JWTs.
+  const uint32_t max_size_;
+  // The time source.
+  TimeSource& time_source_;
+  // The cached JWTs indexed by their token.
+  absl::flat_hash_map<std::string, Entry> entries_;
+  // The tokens of the cached JWTs, the most recently used first.
+  std::list<std::string> lru_;
+};
+
+} // namespace
+
+JwtCachePtr
+JwtCache::create(const envoy::extensions::filters::http::jwt_authn::v3::JwtCacheConfig& config,
+                 TimeSource& time_source) {
+  return std::make_unique<JwtCacheImpl>(config, time_source);
+}
+
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "envoy/common/pure.h"
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/http/jwt_authn/v3/config.pb.h"
+
+#include "jwt_verify_lib/jwt.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+
+class JwtCache;
+using JwtCachePtr = std::unique_ptr<JwtCache>;
+
+/**
+ * Interface to cache the JWTs a worker verified for a provider, keyed by their token.
+ * Its usage:
+ *     auto jwt = jwt_cache->lookup(token);
+ *     if (jwt == nullptr) {
+ *        // Parse and verify the token.
+ *        jwt_cache->insert(token, std::move(verified_jwt));
+ *     }
+ *
+ * The JWT returned by lookup() is only valid until the next insert().
+ */
+class JwtCache {
+public:
+  virtual ~JwtCache() = default;
+
+  // Lookup a verified JWT by its token. Returns nullptr if it isn't cached or it expired.
+  virtual ::google::jwt_verify::Jwt* lookup(const std::string& token) PURE;
+
+  // Cache a verified JWT by its token, unless it expired.
+  virtual void insert(const std::string& token,
+                      std::unique_ptr<::google::jwt_verify::Jwt>&& jwt) PURE;
+
+  // Factory function to create an instance.
+  static JwtCachePtr
+  create(const envoy::extensions::filters::http::jwt_authn::v3::JwtCacheConfig& config,
+         TimeSource& time_source);
+};
+
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -12,10 +12,11 @@ namespace HttpFilters {
 namespace Lua {
 
 Http::FilterFactoryCb LuaFilterConfig::createFilterFactoryFromProtoTyped(
-    const envoy::extensions::filters::http::lua::v3::Lua& proto_config, const std::string&,
-    Server::Configuration::FactoryContext& context) {
-  FilterConfigConstSharedPtr filter_config(new FilterConfig{
-      proto_config, context.threadLocal(), context.clusterManager(), context.api()});
+    const envoy::extensions::filters::http::lua::v3::Lua& proto_config,
+    const std::string& stat_prefix, Server::Configuration::FactoryContext& context) {
+  FilterConfigConstSharedPtr filter_config(
+      new FilterConfig{proto_config, context.threadLocal(), context.clusterManager(),
+                       context.api(), context.scope(), stat_prefix});
   auto& time_source = context.dispatcher().timeSource();
   return [filter_config, &time_source](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<Filter>(filter_config, time_source));
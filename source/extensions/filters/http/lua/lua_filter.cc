@@ -680,8 +680,10 @@ int StreamHandleWrapper::luaTimestamp(lua_State* state) {
 
 FilterConfig::FilterConfig(const envoy::extensions::filters::http::lua::v3::Lua& proto_config,
                            ThreadLocal::SlotAllocator& tls,
-                           Upstream::ClusterManager& cluster_manager, Api::Api& api)
-    : cluster_manager_(cluster_manager) {
+                           Upstream::ClusterManager& cluster_manager, Api::Api& api,
+                           Stats::Scope& scope, const std::string& stat_prefix)
+    : cluster_manager_(cluster_manager),
+      stats_{ALL_LUA_FILTER_STATS(POOL_COUNTER_PREFIX(scope, stat_prefix + "lua."))} {
   auto global_setup_ptr = std::make_unique<PerLuaCodeSetup>(proto_config.inline_code(), tls);
   if (global_setup_ptr) {
     per_lua_code_setups_map_[GLOBAL_SCRIPT_NAME] = std::move(global_setup_ptr);
@@ -730,6 +732,11 @@ Http::FilterHeadersStatus Filter::doHeaders(StreamHandleRef& handle,
   }
   ASSERT(setup);
   coroutine = setup->createCoroutine();
+  if (coroutine->reused()) {
+    config_->stats().coroutines_reused_.inc();
+  } else {
+    config_->stats().coroutines_created_.inc();
+  }
 
   handle.reset(StreamHandleWrapper::create(coroutine->luaState(), *coroutine, headers, end_stream,
                                            *this, callbacks, time_source_),
@@ -2,6 +2,8 @@
 
 #include "envoy/extensions/filters/http/lua/v3/lua.pb.h"
 #include "envoy/http/filter.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "source/common/crypto/utility.h"
@@ -18,6 +20,20 @@ namespace Lua {
 
 constexpr char GLOBAL_SCRIPT_NAME[] = "GLOBAL";
 
+/**
+ * All stats for the Lua filter. @see stats_macros.h
+ */
+#define ALL_LUA_FILTER_STATS(COUNTER)                                                              \
+  COUNTER(coroutines_created)                                                                      \
+  COUNTER(coroutines_reused)
+
+/**
+ * Wrapper struct for the Lua filter stats. @see stats_macros.h
+ */
+struct LuaFilterStats {
+  ALL_LUA_FILTER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
 class PerLuaCodeSetup : Logger::Loggable<Logger::Id::lua> {
 public:
   PerLuaCodeSetup(const std::string& lua_code, ThreadLocal::SlotAllocator& tls);
@@ -351,7 +367,7 @@ class FilterConfig : Logger::Loggable<Logger::Id::lua> {
 public:
   FilterConfig(const envoy::extensions::filters::http::lua::v3::Lua& proto_config,
                ThreadLocal::SlotAllocator& tls, Upstream::ClusterManager& cluster_manager,
-               Api::Api& api);
+               Api::Api& api, Stats::Scope& scope, const std::string& stat_prefix);
 
   PerLuaCodeSetup* perLuaCodeSetup(const std::string& name) const {
     const auto iter = per_lua_code_setups_map_.find(name);
@@ -361,9 +377,12 @@ public:
     return nullptr;
   }
 
+  const LuaFilterStats& stats() const { return stats_; }
+
   Upstream::ClusterManager& cluster_manager_;
 
 private:
+  const LuaFilterStats stats_;
   absl::flat_hash_map<std::string, PerLuaCodeSetupPtr> per_lua_code_setups_map_;
 };
 
@@ -429,8 +448,6 @@ PerLuaCodeSetup* getPerLuaCodeSetup(const FilterConfig* filter_config,
 
 } // namespace
 
-// TODO(mattklein123): Filter stats.
-
 /**
  * The HTTP Lua filter. Allows scripts to run in both the request an response flow.
  */
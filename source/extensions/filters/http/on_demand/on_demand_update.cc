@@ -4,16 +4,30 @@
 #include "source/common/common/enum_to_int.h"
 #include "source/common/common/logger.h"
 #include "source/common/http/codes.h"
+#include "source/common/protobuf/utility.h"
 
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
 namespace OnDemand {
 
-Http::FilterHeadersStatus OnDemandRouteUpdate::decodeHeaders(Http::RequestHeaderMap&, bool) {
+OnDemandFilterConfig::OnDemandFilterConfig(
+    const envoy::extensions::filters::http::on_demand::v3::OnDemand& proto_config,
+    Upstream::ClusterManager& cm, ProtobufMessage::ValidationVisitor& validation_visitor)
+    : cm_(cm),
+      odcds_(proto_config.has_odcds()
+                 ? cm.allocateOdCdsApi(proto_config.odcds().source(),
+                                       std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(
+                                           proto_config.odcds(), negative_cache_ttl, 30000)),
+                                       validation_visitor)
+                 : nullptr),
+      odcds_timeout_(PROTOBUF_GET_MS_OR_DEFAULT(proto_config.odcds(), timeout, 5000)) {}
 
-  if (callbacks_->route() != nullptr) {
+Http::FilterHeadersStatus OnDemandRouteUpdate::decodeHeaders(Http::RequestHeaderMap&, bool) {
+  Router::RouteConstSharedPtr route = callbacks_->route();
+  if (route != nullptr) {
     filter_iteration_state_ = Http::FilterHeadersStatus::Continue;
+    maybeDiscoverCluster(*route);
     return filter_iteration_state_;
   }
   // decodeHeaders() is interrupted.
@@ -28,6 +42,25 @@ Http::FilterHeadersStatus OnDemandRouteUpdate::decodeHeaders(Http::RequestHeader
   return filter_iteration_state_;
 }
 
+void OnDemandRouteUpdate::maybeDiscoverCluster(const Router::Route& route) {
+  const Router::RouteEntry* route_entry = route.routeEntry();
+  if (config_->odcds() == nullptr || route_entry == nullptr ||
+      config_->clusterManager().getThreadLocalCluster(route_entry->clusterName()) != nullptr) {
+    return;
+  }
+  // decodeHeaders() is interrupted.
+  decode_headers_active_ = true;
+  cluster_discovery_callback_ = std::make_shared<Upstream::ClusterDiscoveryCallback>(
+      [this](Upstream::ClusterDiscoveryStatus status) -> void {
+        onClusterDiscoveryCompletion(status);
+      });
+  filter_iteration_state_ = Http::FilterHeadersStatus::StopIteration;
+  config_->odcds()->requestOnDemandClusterDiscovery(
+      route_entry->clusterName(), cluster_discovery_callback_, config_->odcdsTimeout());
+  // decodeHeaders() is completed.
+  decode_headers_active_ = false;
+}
+
 Http::FilterDataStatus OnDemandRouteUpdate::decodeData(Buffer::Instance&, bool) {
   return filter_iteration_state_ == Http::FilterHeadersStatus::StopIteration
              ? Http::FilterDataStatus::StopIterationAndWatermark
@@ -43,9 +76,13 @@ void OnDemandRouteUpdate::setDecoderFilterCallbacks(Http::StreamDecoderFilterCal
 }
 
 // A weak_ptr copy of the route_config_updated_callback_ is kept by RdsRouteConfigProviderImpl
-// in config_update_callbacks_. By resetting the pointer in onDestroy() callback we ensure
+// in config_update_callbacks_, and one of the cluster_discovery_callback_ by the cluster manager.
+// By resetting the pointers in onDestroy() callback we ensure
 // that this filter/filter-chain will not be resumed if the corresponding has been closed
-void OnDemandRouteUpdate::onDestroy() { route_config_updated_callback_.reset(); }
+void OnDemandRouteUpdate::onDestroy() {
+  route_config_updated_callback_.reset();
+  cluster_discovery_callback_.reset();
+}
 
 // This is the callback which is called when an update requested in requestRouteConfigUpdate()
 // has been propagated to workers, at which point the request processing is restarted from the
@@ -70,6 +107,19 @@ void OnDemandRouteUpdate::onRouteConfigUpdateCompletion(bool route_exists) {
   callbacks_->continueDecoding();
 }
 
+// This is the callback which is called on the worker of the stream once the discovery requested
+// in requestOnDemandClusterDiscovery() is done. The request continues to the router whatever the
+// outcome, which rejects it if the cluster is still unknown.
+void OnDemandRouteUpdate::onClusterDiscoveryCompletion(Upstream::ClusterDiscoveryStatus) {
+  filter_iteration_state_ = Http::FilterHeadersStatus::Continue;
+
+  // Don't call continueDecoding in the middle of decodeHeaders()
+  if (decode_headers_active_) {
+    return;
+  }
+  callbacks_->continueDecoding();
+}
+
 } // namespace OnDemand
 } // namespace HttpFilters
 } // namespace Extensions
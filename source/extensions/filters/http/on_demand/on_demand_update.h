@@ -1,18 +1,52 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
+
+#include "envoy/extensions/filters/http/on_demand/v3/on_demand.pb.h"
 #include "envoy/http/filter.h"
+#include "envoy/protobuf/message_validator.h"
+#include "envoy/router/router.h"
+#include "envoy/upstream/cluster_manager.h"
 
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
 namespace OnDemand {
 
+/**
+ * Configuration of the on demand filter, shared by its instances.
+ */
+class OnDemandFilterConfig {
+public:
+  OnDemandFilterConfig(
+      const envoy::extensions::filters::http::on_demand::v3::OnDemand& proto_config,
+      Upstream::ClusterManager& cm, ProtobufMessage::ValidationVisitor& validation_visitor);
+  OnDemandFilterConfig(Upstream::ClusterManager& cm, Upstream::OdCdsApiHandleSharedPtr odcds,
+                       std::chrono::milliseconds odcds_timeout)
+      : cm_(cm), odcds_(std::move(odcds)), odcds_timeout_(odcds_timeout) {}
+
+  Upstream::ClusterManager& clusterManager() const { return cm_; }
+  // The on demand CDS subscription, if the clusters are discovered on demand.
+  const Upstream::OdCdsApiHandleSharedPtr& odcds() const { return odcds_; }
+  std::chrono::milliseconds odcdsTimeout() const { return odcds_timeout_; }
+
+private:
+  Upstream::ClusterManager& cm_;
+  const Upstream::OdCdsApiHandleSharedPtr odcds_;
+  const std::chrono::milliseconds odcds_timeout_;
+};
+
+using OnDemandFilterConfigSharedPtr = std::shared_ptr<const OnDemandFilterConfig>;
+
 class OnDemandRouteUpdate : public Http::StreamDecoderFilter {
 public:
-  OnDemandRouteUpdate() = default;
+  explicit OnDemandRouteUpdate(OnDemandFilterConfigSharedPtr config) : config_(std::move(config)) {}
 
   void onRouteConfigUpdateCompletion(bool route_exists);
 
+  void onClusterDiscoveryCompletion(Upstream::ClusterDiscoveryStatus status);
+
   void setFilterIterationState(Envoy::Http::FilterHeadersStatus status) {
     filter_iteration_state_ = status;
   }
@@ -30,8 +64,13 @@ public:
   void onDestroy() override;
 
 private:
+  // Discovers the cluster of the route if it is not known yet.
+  void maybeDiscoverCluster(const Router::Route& route);
+
+  const OnDemandFilterConfigSharedPtr config_;
   Http::StreamDecoderFilterCallbacks* callbacks_{};
   Http::RouteConfigUpdatedCallbackSharedPtr route_config_updated_callback_;
+  Upstream::ClusterDiscoveryCallbackSharedPtr cluster_discovery_callback_;
   Envoy::Http::FilterHeadersStatus filter_iteration_state_{Http::FilterHeadersStatus::Continue};
   bool decode_headers_active_{false};
 };
@@ -21,20 +21,22 @@ Http::FilterFactoryCb RateLimitFilterConfig::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::http::ratelimit::v3::RateLimit& proto_config,
     const std::string&, Server::Configuration::FactoryContext& context) {
   ASSERT(!proto_config.domain().empty());
-  FilterConfigSharedPtr filter_config(new FilterConfig(proto_config, context.localInfo(),
-                                                       context.scope(), context.runtime(),
-                                                       context.httpContext()));
+  FilterConfigSharedPtr filter_config(new FilterConfig(
+      proto_config, context.localInfo(), context.scope(), context.runtime(), context.httpContext(),
+      context.threadLocal(), context.dispatcher().timeSource()));
   const std::chrono::milliseconds timeout =
       std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(proto_config, timeout, 20));
+  const uint32_t hits_addend =
+      filter_config->quotaLeases() != nullptr ? filter_config->quotaLeases()->hits() : 0;
 
-  return [proto_config, &context, timeout,
+  return [proto_config, &context, timeout, hits_addend,
           transport_version =
               Config::Utility::getAndCheckTransportVersion(proto_config.rate_limit_service()),
           filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<Filter>(
         filter_config, Filters::Common::RateLimit::rateLimitClient(
                            context, proto_config.rate_limit_service().grpc_service(), timeout,
-                           transport_version)));
+                           transport_version, hits_addend)));
   };
 }
 
@@ -0,0 +1,104 @@
+#include "source/extensions/filters/http/ratelimit/quota_lease.h"
+
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace RateLimitFilter {
+namespace {
+
+constexpr uint32_t DefaultMaxLeases = 1000;
+
+// Appends a part of the descriptors to a key, prefixed with its length so that the parts can't run
+// into each other.
+void appendPart(std::string& key, absl::string_view part) {
+  absl::StrAppend(&key, part.size(), ":", part);
+}
+
+} // namespace
+
+QuotaLeases::QuotaLeases(
+    const envoy::extensions::filters::http::ratelimit::v3::RateLimit::QuotaLease& config,
+    ThreadLocal::SlotAllocator& tls, TimeSource& time_source, Stats::Scope& scope)
+    : hits_(config.hits()),
+      duration_(DurationUtil::durationToMilliseconds(config.duration())),
+      max_leases_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_leases, DefaultMaxLeases)),
+      time_source_(time_source),
+      stats_{ALL_QUOTA_LEASE_STATS(POOL_COUNTER_PREFIX(scope, "ratelimit.quota_lease."))},
+      tls_(tls) {
+  tls_.set([](Event::Dispatcher&) { return std::make_shared<WorkerLeases>(); });
+}
+
+std::string QuotaLeases::key(const std::vector<Envoy::RateLimit::Descriptor>& descriptors) {
+  std::string key;
+  for (const Envoy::RateLimit::Descriptor& descriptor : descriptors) {
+    absl::StrAppend(&key, descriptor.entries_.size(), ";");
+    for (const Envoy::RateLimit::DescriptorEntry& entry : descriptor.entries_) {
+      appendPart(key, entry.key_);
+      appendPart(key, entry.value_);
+    }
+    if (descriptor.limit_.has_value()) {
+      absl::StrAppend(&key, descriptor.limit_->requests_per_unit_, "/", descriptor.limit_->unit_,
+                      ";");
+    } else {
+      key.push_back('-');
+    }
+  }
+  return key;
+}
+
+bool QuotaLeases::tryAcquire(const std::string& key) {
+  WorkerLeases& worker = *tls_;
+  const auto it = worker.leases_.find(key);
+  if (it != worker.leases_.end()) {
+    Lease& lease = it->second;
+    if (time_source_.monotonicTime() >= lease.expiry_) {
+      stats_.hits_wasted_.add(lease.hits_left_);
+      worker.lru_.erase(lease.lru_position_);
+      worker.leases_.erase(it);
+    } else if (lease.hits_left_ > 0) {
+      lease.hits_left_--;
+      worker.lru_.splice(worker.lru_.begin(), worker.lru_, lease.lru_position_);
+      stats_.local_ok_.inc();
+      return true;
+    }
+  }
+  stats_.remote_.inc();
+  return false;
+}
+
+void QuotaLeases::onLeased(const std::string& key) {
+  WorkerLeases& worker = *tls_;
+  const MonotonicTime now = time_source_.monotonicTime();
+  const auto [it, inserted] = worker.leases_.try_emplace(key);
+  Lease& lease = it->second;
+  if (inserted) {
+    worker.lru_.push_front(key);
+    lease.lru_position_ = worker.lru_.begin();
+  } else {
+    // The worker already has a lease when several of its requests asked for one at the same time,
+    // and the hits of the new lease are added to it.
+    if (now >= lease.expiry_) {
+      stats_.hits_wasted_.add(lease.hits_left_);
+      lease.hits_left_ = 0;
+    }
+    worker.lru_.splice(worker.lru_.begin(), worker.lru_, lease.lru_position_);
+  }
+  lease.hits_left_ += hits_ - 1;
+  lease.expiry_ = now + duration_;
+
+  if (worker.leases_.size() > max_leases_) {
+    const auto evicted = worker.leases_.find(worker.lru_.back());
+    stats_.hits_wasted_.add(evicted->second.hits_left_);
+    worker.leases_.erase(evicted);
+    worker.lru_.pop_back();
+  }
+}
+
+} // namespace RateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/http/ratelimit/v3/rate_limit.pb.h"
+#include "envoy/ratelimit/ratelimit.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace RateLimitFilter {
+
+/**
+ * All stats for the quota leases of the HTTP rate limit filter. @see stats_macros.h
+ */
+#define ALL_QUOTA_LEASE_STATS(COUNTER)                                                             \
+  COUNTER(hits_wasted)                                                                             \
+  COUNTER(local_ok)                                                                                \
+  COUNTER(remote)
+
+/**
+ * Wrapper struct for the quota lease stats. @see stats_macros.h
+ */
+struct QuotaLeaseStats {
+  ALL_QUOTA_LEASE_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * The hits leased from the rate limit service, as configured by
+ * envoy::extensions::filters::http::ratelimit::v3::RateLimit::QuotaLease. Each worker keeps the
+ * leases of the requests it handles, so that they are only accessed from its thread.
+ */
+class QuotaLeases {
+public:
+  QuotaLeases(const envoy::extensions::filters::http::ratelimit::v3::RateLimit::QuotaLease& config,
+              ThreadLocal::SlotAllocator& tls, TimeSource& time_source, Stats::Scope& scope);
+
+  /**
+   * @return the key of the lease of the descriptors of a request.
+   */
+  static std::string key(const std::vector<Envoy::RateLimit::Descriptor>& descriptors);
+
+  /**
+   * Takes a hit from the lease the worker has for the key, if it has one which isn't used up or
+   * expired. Otherwise the request has to call the rate limit service.
+   * @return whether the request is allowed by the lease.
+   */
+  bool tryAcquire(const std::string& key);
+
+  /**
+   * Records the lease the rate limit service allowed for the key, less the hit of the request
+   * which asked for it.
+   */
+  void onLeased(const std::string& key);
+
+  /**
+   * @return the hits each call to the rate limit service asks for.
+   */
+  uint32_t hits() const { return hits_; }
+
+private:
+  struct Lease {
+    uint32_t hits_left_{};
+    MonotonicTime expiry_;
+    std::list<std::string>::iterator lru_position_;
+  };
+
+  struct WorkerLeases : public ThreadLocal::ThreadLocalObject {
+    absl::flat_hash_map<std::string, Lease> leases_;
+    // The keys of the leases, the most recently used first.
+    std::list<std::string> lru_;
+  };
+
+  const uint32_t hits_;
+  const std::chrono::milliseconds duration_;
+  const uint32_t max_leases_;
+  TimeSource& time_source_;
+  QuotaLeaseStats stats_;
+  ThreadLocal::TypedSlot<WorkerLeases> tls_;
+};
+
+using QuotaLeasesSharedPtr = std::shared_ptr<QuotaLeases>;
+
+} // namespace RateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -69,6 +69,13 @@ void Filter::initiateCall(const Http::RequestHeaderMap& headers) {
   }
 
   if (!descriptors.empty()) {
+    QuotaLeases* quota_leases = config_->quotaLeases();
+    if (quota_leases != nullptr) {
+      lease_key_ = QuotaLeases::key(descriptors);
+      if (quota_leases->tryAcquire(lease_key_)) {
+        return;
+      }
+    }
     state_ = State::Calling;
     initiating_call_ = true;
     client_->limit(*this, config_->domain(), descriptors, callbacks_->activeSpan(),
@@ -157,6 +164,9 @@ void Filter::complete(Filters::Common::RateLimit::LimitStatus status,
   switch (status) {
   case Filters::Common::RateLimit::LimitStatus::OK:
     cluster_->statsScope().counterFromStatName(stat_names.ok_).inc();
+    if (!lease_key_.empty()) {
+      config_->quotaLeases()->onLeased(lease_key_);
+    }
     break;
   case Filters::Common::RateLimit::LimitStatus::Error:
     cluster_->statsScope().counterFromStatName(stat_names.error_).inc();
@@ -97,7 +97,7 @@ Network::FilterStatus Filter::onAccept(Network::ListenerFilterCallbacks& cb) {
 }
 
 ParseState Filter::onRead() {
-  auto result = cb_->socket().ioHandle().recv(buf_, Config::MAX_INSPECT_SIZE, MSG_PEEK);
+  auto result = cb_->peek(buf_, Config::MAX_INSPECT_SIZE);
   ENVOY_LOG(trace, "http inspector: recv: {}", result.rc_);
   if (!result.ok()) {
     if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
@@ -333,7 +333,10 @@ ReadOrParseState Filter::parseExtensions(Network::IoHandle& io_handle, uint8_t*
  *        };
  *        See https://www.haproxy.org/download/2.1/doc/proxy-protocol.txt for details
  */
-bool Filter::parseTlvs(const std::vector<uint8_t>& tlvs) {
+bool Filter::parseTlvs(absl::Span<const uint8_t> tlvs) {
+  // The values of the TLVs needed, by metadata namespace, which are only set once all TLVs have
+  // been parsed.
+  absl::flat_hash_map<absl::string_view, ProtobufWkt::Struct> metadata_by_namespace;
   size_t idx{0};
   while (idx < tlvs.size()) {
     const uint8_t tlv_type = tlvs[idx];
@@ -366,18 +369,16 @@ bool Filter::parseTlvs(const std::vector<uint8_t>& tlvs) {
     // Only save to dynamic metadata if this type of TLV is needed.
     auto key_value_pair = config_->isTlvTypeNeeded(tlv_type);
     if (nullptr != key_value_pair) {
-      ProtobufWkt::Value metadata_value;
-      metadata_value.set_string_value(reinterpret_cast<char const*>(tlvs.data() + idx),
-                                      tlv_value_length);
-
-      std::string metadata_key = key_value_pair->metadata_namespace().empty()
-                                     ? "envoy.filters.listener.proxy_protocol"
-                                     : key_value_pair->metadata_namespace();
-
-      ProtobufWkt::Struct metadata(
-          (*cb_->dynamicMetadata().mutable_filter_metadata())[metadata_key]);
-      metadata.mutable_fields()->insert({key_value_pair->key(), metadata_value});
-      cb_->setDynamicMetadata(metadata_key, metadata);
+      const absl::string_view metadata_namespace = key_value_pair->metadata_namespace().empty()
+                                                       ? "envoy.filters.listener.proxy_protocol"
+                                                       : key_value_pair->metadata_namespace();
+      // The first value of a key is kept.
+      auto& fields = *metadata_by_namespace[metadata_namespace].mutable_fields();
+      if (fields.count(key_value_pair->key()) == 0 &&
+          !hasDynamicMetadata(metadata_namespace, key_value_pair->key())) {
+        fields[key_value_pair->key()].set_string_value(
+            reinterpret_cast<char const*>(tlvs.data() + idx), tlv_value_length);
+      }
     } else {
       ENVOY_LOG(trace, "proxy_protocol: Skip TLV of type {} since it's not needed", tlv_type);
     }
@@ -385,9 +386,20 @@ bool Filter::parseTlvs(const std::vector<uint8_t>& tlvs) {
     idx += tlv_value_length;
     ASSERT(idx <= tlvs.size());
   }
+
+  for (const auto& [metadata_namespace, metadata] : metadata_by_namespace) {
+    cb_->setDynamicMetadata(std::string(metadata_namespace), metadata);
+  }
   return true;
 }
 
+bool Filter::hasDynamicMetadata(absl::string_view metadata_namespace,
+                                const std::string& key) const {
+  const auto& filter_metadata = cb_->dynamicMetadata().filter_metadata();
+  const auto it = filter_metadata.find(std::string(metadata_namespace));
+  return it != filter_metadata.end() && it->second.fields().count(key) != 0;
+}
+
 ReadOrParseState Filter::readExtensions(Network::IoHandle& io_handle) {
   // Parse and discard the extensions if this is a local command or there's no TLV needs to be saved
   // to metadata.
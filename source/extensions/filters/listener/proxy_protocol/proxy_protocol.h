@@ -10,6 +10,8 @@
 #include "source/extensions/common/proxy_protocol/proxy_protocol_header.h"
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "proxy_protocol_header.h"
 
 using Envoy::Extensions::Common::ProxyProtocol::PROXY_PROTO_V2_ADDR_LEN_UNIX;
@@ -107,7 +109,8 @@ private:
    */
   ReadOrParseState parseExtensions(Network::IoHandle& io_handle, uint8_t* buf, size_t buf_size,
                                    size_t* buf_off = nullptr);
-  bool parseTlvs(const std::vector<uint8_t>& tlvs);
+  bool parseTlvs(absl::Span<const uint8_t> tlvs);
+  bool hasDynamicMetadata(absl::string_view metadata_namespace, const std::string& key) const;
   ReadOrParseState readExtensions(Network::IoHandle& io_handle);
 
   /**
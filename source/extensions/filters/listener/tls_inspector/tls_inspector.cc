@@ -165,7 +165,7 @@ ParseState Filter::onRead() {
   //
   // TODO(ggreenway): write an integration test to ensure the events work as expected on all
   // platforms.
-  const auto result = cb_->socket().ioHandle().recv(buf_, config_->maxClientHelloSize(), MSG_PEEK);
+  const auto result = cb_->peek(buf_, config_->maxClientHelloSize());
   ENVOY_LOG(trace, "tls inspector: recv: {}", result.rc_);
 
   if (!result.ok()) {
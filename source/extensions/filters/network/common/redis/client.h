@@ -158,6 +158,13 @@ public:
    */
   virtual std::chrono::milliseconds bufferFlushTimeoutInMs() const PURE;
 
+  /**
+   * @return when enabled, the commands batched for a single upstream host are flushed at the end
+   * of the current event loop iteration rather than on each command or after
+   * bufferFlushTimeoutInMs().
+   */
+  virtual bool flushOnEventLoopIteration() const PURE;
+
   /**
    * @return the maximum number of upstream connections to unknown hosts when enableRedirection() is
    * true.
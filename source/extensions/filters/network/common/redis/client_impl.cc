@@ -26,6 +26,7 @@ ConfigImpl::ConfigImpl(
           config, buffer_flush_timeout,
           3)), // Default timeout is 3ms. If max_buffer_size_before_flush is zero, this is not used
                // as the buffer is flushed on each request immediately.
+      flush_on_event_loop_iteration_(config.flush_on_event_loop_iteration()),
       max_upstream_unknown_connections_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_upstream_unknown_connections, 100)),
       enable_command_stats_(config.enable_command_stats()) {
@@ -77,6 +78,9 @@ ClientImpl::ClientImpl(Upstream::HostConstSharedPtr host, Event::Dispatcher& dis
       flush_timer_(dispatcher.createTimer([this]() { flushBufferAndResetTimer(); })),
       time_source_(dispatcher.timeSource()), redis_command_stats_(redis_command_stats),
       scope_(scope) {
+  if (config_.flushOnEventLoopIteration()) {
+    flush_cb_ = dispatcher.createSchedulableCallback([this]() { flushBufferAndResetTimer(); });
+  }
   host->cluster().stats().upstream_cx_total_.inc();
   host->stats().cx_total_.inc();
   host->cluster().stats().upstream_cx_active_.inc();
@@ -97,6 +101,9 @@ void ClientImpl::flushBufferAndResetTimer() {
   if (flush_timer_->enabled()) {
     flush_timer_->disableTimer();
   }
+  if (flush_cb_ != nullptr) {
+    flush_cb_->cancel();
+  }
   connection_->write(encoder_buffer_, false);
 }
 
@@ -118,11 +125,20 @@ PoolRequest* ClientImpl::makeRequest(const RespValue& request, ClientCallbacks&
   pending_requests_.emplace_back(*this, callbacks, command);
   encoder_->encode(request, encoder_buffer_);
 
-  // If buffer is full, flush. If the buffer was empty before the request, start the timer.
-  if (encoder_buffer_.length() >= config_.maxBufferSizeBeforeFlush()) {
+  // If buffer is full, flush. If the buffer was empty before the request, start the timer, or
+  // schedule the flush at the end of the event loop iteration so that the requests of all the
+  // downstream connections processed in this iteration are written together. Without a buffer
+  // size, only the end of the iteration flushes the buffer in this case.
+  const uint32_t max_buffer_size = config_.maxBufferSizeBeforeFlush();
+  if ((max_buffer_size > 0 || flush_cb_ == nullptr) &&
+      encoder_buffer_.length() >= max_buffer_size) {
     flushBufferAndResetTimer();
   } else if (empty_buffer) {
-    flush_timer_->enableTimer(std::chrono::milliseconds(config_.bufferFlushTimeoutInMs()));
+    if (flush_cb_ != nullptr) {
+      flush_cb_->scheduleCallbackCurrentIteration();
+    } else {
+      flush_timer_->enableTimer(std::chrono::milliseconds(config_.bufferFlushTimeoutInMs()));
+    }
   }
 
   // Only boost the op timeout if:
@@ -157,7 +173,7 @@ void ClientImpl::onData(Buffer::Instance& data) {
   } catch (ProtocolError&) {
     putOutlierEvent(Upstream::Outlier::Result::ExtOriginRequestFailed);
     host_->cluster().stats().upstream_cx_protocol_error_.inc();
-    host_->stats().rq_error_.inc();
+    host_->stats().incRqError();
     connection_->close(Network::ConnectionCloseType::NoFlush);
   }
 }
@@ -272,14 +288,14 @@ ClientImpl::PendingRequest::PendingRequest(ClientImpl& parent, ClientCallbacks&
         parent_.scope_, command_, parent_.time_source_);
   }
   parent.host_->cluster().stats().upstream_rq_total_.inc();
-  parent.host_->stats().rq_total_.inc();
+  parent.host_->stats().incRqTotal();
   parent.host_->cluster().stats().upstream_rq_active_.inc();
-  parent.host_->stats().rq_active_.inc();
+  parent.host_->stats().incRqActive();
 }
 
 ClientImpl::PendingRequest::~PendingRequest() {
   parent_.host_->cluster().stats().upstream_rq_active_.dec();
-  parent_.host_->stats().rq_active_.dec();
+  parent_.host_->stats().decRqActive();
 }
 
 void ClientImpl::PendingRequest::cancel() {
@@ -126,6 +126,18 @@ public:
   CompositeArray& asCompositeArray();
   const CompositeArray& asCompositeArray() const;
 
+  /**
+   * A bulk string may keep its content in a buffer rather than in its string, so that large values
+   * are passed from the decoded data to the encoded data without being copied. The buffer is
+   * shared by the copies of the value and doesn't change. asString() copies the content of the
+   * buffer into the string the first time it is called, and drops the buffer.
+   * @return the buffer of the bulk string if its content is held in one, otherwise nullptr.
+   */
+  const std::shared_ptr<const Buffer::Instance>& bufferedString() const {
+    return buffered_string_;
+  }
+  void bufferedString(std::shared_ptr<const Buffer::Instance> buffer);
+
   /**
    * Get/set the type of the RespValue. A RespValue can only be a single type at a time. Each time
    * type() is called the type is changed and then the type specific as* methods can be used.
@@ -136,12 +148,15 @@ public:
 private:
   union {
     std::vector<RespValue> array_;
-    std::string string_;
+    // Mutable so that the content of a buffered string can be copied into it on first access.
+    mutable std::string string_;
     int64_t integer_;
     CompositeArray composite_array_;
   };
+  mutable std::shared_ptr<const Buffer::Instance> buffered_string_;
 
   void cleanup();
+  void copyBufferedString() const;
 
   RespType type_{};
 };
@@ -68,15 +68,30 @@ const std::vector<RespValue>& RespValue::asArray() const {
 std::string& RespValue::asString() {
   ASSERT(type_ == RespType::BulkString || type_ == RespType::Error ||
          type_ == RespType::SimpleString);
+  copyBufferedString();
   return string_;
 }
 
 const std::string& RespValue::asString() const {
   ASSERT(type_ == RespType::BulkString || type_ == RespType::Error ||
          type_ == RespType::SimpleString);
+  copyBufferedString();
   return string_;
 }
 
+void RespValue::bufferedString(std::shared_ptr<const Buffer::Instance> buffer) {
+  ASSERT(type_ == RespType::BulkString);
+  string_.clear();
+  buffered_string_ = std::move(buffer);
+}
+
+void RespValue::copyBufferedString() const {
+  if (buffered_string_ != nullptr) {
+    string_ = buffered_string_->toString();
+    buffered_string_.reset();
+  }
+}
+
 int64_t& RespValue::asInteger() {
   ASSERT(type_ == RespType::Integer);
   return integer_;
@@ -98,6 +113,7 @@ const RespValue::CompositeArray& RespValue::asCompositeArray() const {
 }
 
 void RespValue::cleanup() {
+  buffered_string_.reset();
   // Need to manually delete because of the union.
   switch (type_) {
   case RespType::Array: {
@@ -162,7 +178,9 @@ RespValue::RespValue(const RespValue& other) : type_(RespType::Null) {
   case RespType::SimpleString:
   case RespType::BulkString:
   case RespType::Error: {
-    asString() = other.asString();
+    // The buffer of a buffered string is shared rather than copied.
+    string_ = other.string_;
+    buffered_string_ = other.buffered_string_;
     break;
   }
   case RespType::Integer: {
@@ -188,6 +206,7 @@ RespValue::RespValue(RespValue&& other) noexcept : type_(other.type_) {
   case RespType::BulkString:
   case RespType::Error: {
     new (&string_) std::string(std::move(other.string_));
+    buffered_string_ = std::move(other.buffered_string_);
     break;
   }
   case RespType::Integer: {
@@ -216,7 +235,9 @@ RespValue& RespValue::operator=(const RespValue& other) {
   case RespType::SimpleString:
   case RespType::BulkString:
   case RespType::Error: {
-    asString() = other.asString();
+    // The buffer of a buffered string is shared rather than copied.
+    string_ = other.string_;
+    buffered_string_ = other.buffered_string_;
     break;
   }
   case RespType::Integer: {
@@ -248,6 +269,7 @@ RespValue& RespValue::operator=(RespValue&& other) noexcept {
   case RespType::BulkString:
   case RespType::Error: {
     string_ = std::move(other.string_);
+    buffered_string_ = std::move(other.buffered_string_);
     break;
   }
   case RespType::Integer: {
@@ -330,18 +352,47 @@ RespValue::CompositeArray::CompositeArrayConstIterator::empty() {
 }
 
 void DecoderImpl::decode(Buffer::Instance& data) {
-  for (const Buffer::RawSlice& slice : data.getRawSlices()) {
-    parseSlice(slice);
+  while (data.length() > 0) {
+    if (pending_buffered_string_ != nullptr) {
+      moveBulkStringBody(data);
+    } else {
+      data.drain(parseSlice(data.frontSlice()));
+    }
   }
+}
 
-  data.drain(data.length());
+bool DecoderImpl::shouldBufferBulkString() const {
+  if (buffered_bulk_string_size_ == 0 || pending_integer_.integer_ < buffered_bulk_string_size_) {
+    return false;
+  }
+  // The first element of an array is the command of a request.
+  auto parent = std::next(pending_value_stack_.begin());
+  return parent == pending_value_stack_.end() || parent->current_array_element_ > 0;
+}
+
+void DecoderImpl::moveBulkStringBody(Buffer::Instance& data) {
+  ASSERT(state_ == State::BulkStringBody);
+  const uint64_t length = std::min(static_cast<uint64_t>(pending_integer_.integer_), data.length());
+  pending_buffered_string_->move(data, length);
+  pending_integer_.integer_ -= length;
+
+  if (pending_integer_.integer_ == 0) {
+    ENVOY_LOG(trace, "parse slice: BulkStringBody complete: {} bytes buffered",
+              pending_buffered_string_->length());
+    pending_value_stack_.front().value_->bufferedString(std::move(pending_buffered_string_));
+    state_ = State::CR;
+  }
 }
 
-void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
+uint64_t DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
   const char* buffer = reinterpret_cast<const char*>(slice.mem_);
   uint64_t remaining = slice.len_;
 
   while (remaining || state_ == State::ValueComplete) {
+    if (pending_buffered_string_ != nullptr) {
+      // The body of the bulk string is moved from the data rather than parsed.
+      break;
+    }
     ENVOY_LOG(trace, "parse slice: {} remaining", remaining);
     switch (state_) {
     case State::ValueRootStart: {
@@ -460,6 +511,9 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
         if (!pending_integer_.negative_) {
           // TODO(mattklein123): reserve and define max length since we don't stream currently.
           state_ = State::BulkStringBody;
+          if (shouldBufferBulkString()) {
+            pending_buffered_string_ = std::make_shared<Buffer::OwnedImpl>();
+          }
         } else {
           // Null bulk string. Switch type to null and move to value complete.
           current_value.value_->type(RespType::Null);
@@ -547,6 +601,8 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
     }
     }
   }
+
+  return slice.len_ - remaining;
 }
 
 void EncoderImpl::encode(const RespValue& value, Buffer::Instance& out) {
@@ -564,7 +620,11 @@ void EncoderImpl::encode(const RespValue& value, Buffer::Instance& out) {
     break;
   }
   case RespType::BulkString: {
-    encodeBulkString(value.asString(), out);
+    if (value.bufferedString() != nullptr) {
+      encodeBufferedBulkString(value.bufferedString(), out);
+    } else {
+      encodeBulkString(value.asString(), out);
+    }
     break;
   }
   case RespType::Error: {
@@ -621,6 +681,27 @@ void EncoderImpl::encodeBulkString(const std::string& string, Buffer::Instance&
   out.add("\r\n", 2);
 }
 
+void EncoderImpl::encodeBufferedBulkString(const std::shared_ptr<const Buffer::Instance>& string,
+                                           Buffer::Instance& out) {
+  char buffer[32];
+  char* current = buffer;
+  *current++ = '$';
+  current += StringUtil::itoa(current, 21, string->length());
+  *current++ = '\r';
+  *current++ = '\n';
+  out.add(buffer, current - buffer);
+  // The slices of the string are referenced rather than copied, each keeping the string alive
+  // until it is written.
+  for (const Buffer::RawSlice& slice : string->getRawSlices()) {
+    out.addBufferFragment(*new Buffer::BufferFragmentImpl(
+        slice.mem_, slice.len_,
+        [string](const void*, size_t, const Buffer::BufferFragmentImpl* fragment) {
+          delete fragment;
+        }));
+  }
+  out.add("\r\n", 2);
+}
+
 void EncoderImpl::encodeError(const std::string& string, Buffer::Instance& out) {
   out.add("-", 1);
   out.add(string);
@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/logger.h"
 #include "source/extensions/filters/network/common/redis/codec.h"
 
@@ -18,10 +19,22 @@ namespace Redis {
  * Decoder implementation of https://redis.io/topics/protocol
  *
  * This implementation buffers when needed and will always consume all bytes passed for decoding.
+ * The large bulk strings are kept in the slices of the decoded data rather than copied, see
+ * RespValue::bufferedString().
  */
 class DecoderImpl : public Decoder, Logger::Loggable<Logger::Id::redis> {
 public:
-  DecoderImpl(DecoderCallbacks& callbacks) : callbacks_(callbacks) {}
+  /**
+   * @param buffered_bulk_string_size supplies the size from which the content of the bulk strings
+   *        is kept in a buffer, or 0 to always copy it into their string. The command names are
+   *        always copied, as they are inspected.
+   */
+  DecoderImpl(DecoderCallbacks& callbacks, uint64_t buffered_bulk_string_size = 0)
+      : callbacks_(callbacks), buffered_bulk_string_size_(buffered_bulk_string_size) {}
+
+  // The size from which the decoders of the factory buffer the bulk strings, which is the size of
+  // a buffer slice so that most of the slices of a value are moved whole.
+  static constexpr uint64_t DefaultBufferedBulkStringSize = 16 * 1024;
 
   // RedisProxy::Decoder
   void decode(Buffer::Instance& data) override;
@@ -55,13 +68,20 @@ private:
     uint64_t current_array_element_;
   };
 
-  void parseSlice(const Buffer::RawSlice& slice);
+  // @return the number of bytes of the slice parsed, which is less than its length if the body of a
+  //         buffered bulk string starts within it.
+  uint64_t parseSlice(const Buffer::RawSlice& slice);
+  bool shouldBufferBulkString() const;
+  void moveBulkStringBody(Buffer::Instance& data);
 
   DecoderCallbacks& callbacks_;
+  const uint64_t buffered_bulk_string_size_;
   State state_{State::ValueRootStart};
   PendingInteger pending_integer_;
   RespValuePtr pending_value_root_;
   std::forward_list<PendingValue> pending_value_stack_;
+  // The content of the bulk string being decoded, if it is buffered.
+  std::shared_ptr<Buffer::OwnedImpl> pending_buffered_string_;
 };
 
 /**
@@ -71,7 +91,7 @@ class DecoderFactoryImpl : public DecoderFactory {
 public:
   // RedisProxy::DecoderFactory
   DecoderPtr create(DecoderCallbacks& callbacks) override {
-    return DecoderPtr{new DecoderImpl(callbacks)};
+    return DecoderPtr{new DecoderImpl(callbacks, DecoderImpl::DefaultBufferedBulkStringSize)};
   }
 };
 
@@ -87,6 +107,8 @@ private:
   void encodeArray(const std::vector<RespValue>& array, Buffer::Instance& out);
   void encodeCompositeArray(const RespValue::CompositeArray& array, Buffer::Instance& out);
   void encodeBulkString(const std::string& string, Buffer::Instance& out);
+  void encodeBufferedBulkString(const std::shared_ptr<const Buffer::Instance>& string,
+                                Buffer::Instance& out);
   void encodeError(const std::string& string, Buffer::Instance& out);
   void encodeInteger(int64_t integer, Buffer::Instance& out);
   void encodeSimpleString(const std::string& string, Buffer::Instance& out);
@@ -9,11 +9,21 @@ namespace DubboProxy {
 
 RpcInvocationImpl::Attachment::Attachment(MapPtr&& value, size_t offset)
     : attachment_(std::move(value)), attachment_offset_(offset) {
-  headers_ = Http::RequestHeaderMapImpl::create();
-
   ASSERT(attachment_);
   ASSERT(attachment_->toMutableUntypedMap());
+}
 
+const Http::HeaderMap& RpcInvocationImpl::Attachment::headers() const {
+  assignHeadersIfNeed();
+  return *headers_;
+}
+
+void RpcInvocationImpl::Attachment::assignHeadersIfNeed() const {
+  if (headers_ != nullptr) {
+    return;
+  }
+
+  headers_ = Http::RequestHeaderMapImpl::create();
   for (const auto& pair : *attachment_->toMutableUntypedMap()) {
     const auto key = pair.first->toString();
     const auto value = pair.second->toString();
@@ -29,6 +39,10 @@ void RpcInvocationImpl::Attachment::insert(const std::string& key, const std::st
 
   ASSERT(attachment_->toMutableUntypedMap());
 
+  // An inserted value replaces the header even if the key is already in the attachment, so the
+  // headers are built from the attachment before it is updated.
+  assignHeadersIfNeed();
+
   attachment_->toMutableUntypedMap()->emplace(std::make_unique<String>(key),
                                               std::make_unique<String>(value));
 
@@ -43,7 +57,9 @@ void RpcInvocationImpl::Attachment::remove(const std::string& key) {
   ASSERT(attachment_->toMutableUntypedMap());
 
   attachment_->toMutableUntypedMap()->erase(std::make_unique<String>(key));
-  headers_->remove(Http::LowerCaseString(key));
+  if (headers_ != nullptr) {
+    headers_->remove(Http::LowerCaseString(key));
+  }
 }
 
 const std::string* RpcInvocationImpl::Attachment::lookup(const std::string& key) const {
@@ -71,8 +71,8 @@ public:
     void remove(const std::string& key);
     const std::string* lookup(const std::string& key) const;
 
-    // Http::HeaderMap wrapper to attachment.
-    const Http::HeaderMap& headers() const { return *headers_; }
+    // Http::HeaderMap wrapper to attachment, built on first use.
+    const Http::HeaderMap& headers() const;
 
     // Whether the attachment should be re-serialized.
     bool attachmentUpdated() const { return attachment_updated_; }
@@ -80,6 +80,8 @@ public:
     size_t attachmentOffset() const { return attachment_offset_; }
 
   private:
+    void assignHeadersIfNeed() const;
+
     bool attachment_updated_{false};
 
     MapPtr attachment_;
@@ -91,7 +93,8 @@ public:
     // To reuse the HeaderMatcher API and related tools provided by Envoy, we store the key/value
     // pair of the string type in the attachment in the Http::HeaderMap. This introduces additional
     // overhead and ignores the case of the key in the attachment. But for now, it's acceptable.
-    Http::HeaderMapPtr headers_;
+    // The map is only built for the requests that need it, such as those routed by attachment.
+    mutable Http::HeaderMapPtr headers_;
   };
   using AttachmentPtr = std::unique_ptr<Attachment>;
 
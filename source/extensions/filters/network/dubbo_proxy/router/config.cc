@@ -3,6 +3,7 @@
 #include "envoy/extensions/filters/network/dubbo_proxy/router/v3/router.pb.h"
 #include "envoy/extensions/filters/network/dubbo_proxy/router/v3/router.pb.validate.h"
 #include "envoy/registry/registry.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "source/extensions/filters/network/dubbo_proxy/router/router_impl.h"
 
@@ -13,10 +14,20 @@ namespace DubboProxy {
 namespace Router {
 
 DubboFilters::FilterFactoryCb RouterFilterConfig::createFilterFactoryFromProtoTyped(
-    const envoy::extensions::filters::network::dubbo_proxy::router::v3::Router&, const std::string&,
-    Server::Configuration::FactoryContext& context) {
-  return [&context](DubboFilters::FilterChainFactoryCallbacks& callbacks) -> void {
-    callbacks.addFilter(std::make_shared<Router>(context.clusterManager()));
+    const envoy::extensions::filters::network::dubbo_proxy::router::v3::Router& proto_config,
+    const std::string&, Server::Configuration::FactoryContext& context) {
+  // Upstream connections are multiplexed by worker, across the downstream connections it handles.
+  std::shared_ptr<ThreadLocal::TypedSlot<ConnectionMultiplexer>> multiplexers;
+  if (proto_config.multiplex_upstream_connections()) {
+    multiplexers = ThreadLocal::TypedSlot<ConnectionMultiplexer>::makeUnique(context.threadLocal());
+    multiplexers->set([](Event::Dispatcher& dispatcher) {
+      return std::make_shared<ConnectionMultiplexer>(dispatcher);
+    });
+  }
+
+  return [&context, multiplexers](DubboFilters::FilterChainFactoryCallbacks& callbacks) -> void {
+    ConnectionMultiplexer* multiplexer = multiplexers ? &**multiplexers : nullptr;
+    callbacks.addFilter(std::make_shared<Router>(context.clusterManager(), multiplexer));
   };
 }
 
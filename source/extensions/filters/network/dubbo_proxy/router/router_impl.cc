@@ -244,7 +244,9 @@ Router::UpstreamRequest::UpstreamRequest(Router& parent, Upstream::TcpPoolData&
 Router::UpstreamRequest::~UpstreamRequest() = default;
 
 FilterStatus Router::UpstreamRequest::start() {
-  Tcp::ConnectionPool::Cancellable* handle = conn_pool_data_.newConnection(*this);
+  Tcp::ConnectionPool::Cancellable* handle =
+      parent_.multiplexer_ != nullptr ? parent_.multiplexer_->newConnection(conn_pool_data_, *this)
+                                      : conn_pool_data_.newConnection(*this);
   if (handle) {
     // Pause while we wait for a connection.
     conn_pool_handle_ = handle;
@@ -266,7 +268,12 @@ void Router::UpstreamRequest::resetStream() {
 
   if (conn_data_) {
     ASSERT(!conn_pool_handle_);
-    conn_data_->connection().close(Network::ConnectionCloseType::NoFlush);
+    // A shared connection is left open for the other requests, the response of the request is
+    // dropped when it arrives.
+    if (multiplexed_stream_ == nullptr) {
+      conn_data_->connection().close(Network::ConnectionCloseType::NoFlush);
+    }
+    multiplexed_stream_ = nullptr;
     conn_data_.reset();
     ENVOY_LOG(debug, "dubbo upstream request: reset connection data");
   }
@@ -277,6 +284,10 @@ void Router::UpstreamRequest::encodeData(Buffer::Instance& data) {
   ASSERT(!conn_pool_handle_);
 
   ENVOY_STREAM_LOG(trace, "proxying {} bytes", *parent_.callbacks_, data.length());
+  if (multiplexed_stream_ != nullptr) {
+    multiplexed_stream_->writeRequest(data);
+    return;
+  }
   conn_data_->connection().write(data, false);
 }
 
@@ -320,6 +331,9 @@ void Router::UpstreamRequest::onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr
   conn_data_ = std::move(conn_data);
   conn_data_->addUpstreamCallbacks(parent_);
   conn_pool_handle_ = nullptr;
+  if (parent_.multiplexer_ != nullptr) {
+    multiplexed_stream_ = static_cast<MultiplexedStream*>(conn_data_.get());
+  }
 
   onRequestStart(continue_decoding);
   encodeData(parent_.upstream_request_buffer_);
@@ -339,6 +353,7 @@ void Router::UpstreamRequest::onRequestComplete() { request_complete_ = true; }
 
 void Router::UpstreamRequest::onResponseComplete() {
   response_complete_ = true;
+  multiplexed_stream_ = nullptr;
   conn_data_.reset();
 }
 
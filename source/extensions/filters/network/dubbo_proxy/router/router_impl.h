@@ -10,6 +10,7 @@
 #include "source/common/upstream/load_balancer_impl.h"
 #include "source/extensions/filters/network/dubbo_proxy/filters/filter.h"
 #include "source/extensions/filters/network/dubbo_proxy/router/router.h"
+#include "source/extensions/filters/network/dubbo_proxy/router/upstream_multiplexer.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -22,7 +23,8 @@ class Router : public Tcp::ConnectionPool::UpstreamCallbacks,
                public DubboFilters::CodecFilter,
                Logger::Loggable<Logger::Id::dubbo> {
 public:
-  Router(Upstream::ClusterManager& cluster_manager) : cluster_manager_(cluster_manager) {}
+  Router(Upstream::ClusterManager& cluster_manager, ConnectionMultiplexer* multiplexer)
+      : cluster_manager_(cluster_manager), multiplexer_(multiplexer) {}
   ~Router() override = default;
 
   // DubboFilters::DecoderFilter
@@ -78,6 +80,8 @@ private:
 
     Tcp::ConnectionPool::Cancellable* conn_pool_handle_{};
     Tcp::ConnectionPool::ConnectionDataPtr conn_data_;
+    // Set if the request shares a multiplexed connection.
+    MultiplexedStream* multiplexed_stream_{};
     Upstream::HostDescriptionConstSharedPtr upstream_host_;
     SerializerPtr serializer_;
     ProtocolPtr protocol_;
@@ -91,6 +95,7 @@ private:
   void cleanup();
 
   Upstream::ClusterManager& cluster_manager_;
+  ConnectionMultiplexer* const multiplexer_;
 
   DubboFilters::DecoderFilterCallbacks* callbacks_{};
   DubboFilters::EncoderFilterCallbacks* encoder_callbacks_{};
@@ -0,0 +1,286 @@
+#include "source/extensions/filters/network/dubbo_proxy/router/upstream_multiplexer.h"
+
+#include <vector>
+
+#include "source/extensions/filters/network/dubbo_proxy/dubbo_protocol_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace DubboProxy {
+namespace Router {
+namespace {
+
+constexpr uint16_t MagicNumber = 0xdabb;
+constexpr uint8_t MessageTypeMask = 0x80;
+constexpr uint8_t TwoWayMask = 0x40;
+constexpr uint64_t FlagOffset = 2;
+constexpr uint64_t RequestIDOffset = 4;
+constexpr uint64_t BodySizeOffset = 12;
+
+/**
+ * Replaces the request id in the header of a message.
+ */
+void setRequestId(Buffer::Instance& message, int64_t request_id) {
+  Buffer::OwnedImpl header;
+  header.writeBEInt<uint32_t>(message.peekBEInt<uint32_t>());
+  header.writeBEInt<int64_t>(request_id);
+  message.drain(RequestIDOffset + sizeof(int64_t));
+  message.prepend(header);
+}
+
+} // namespace
+
+MultiplexedStream::MultiplexedStream(MultiplexedConnection& parent, int64_t request_id)
+    : parent_(&parent), request_id_(request_id) {}
+
+MultiplexedStream::~MultiplexedStream() {
+  if (parent_ != nullptr) {
+    parent_->onStreamReleased(*this);
+  }
+}
+
+Network::ClientConnection& MultiplexedStream::connection() {
+  ASSERT(parent_ != nullptr && parent_->conn_data_ != nullptr);
+  return parent_->conn_data_->connection();
+}
+
+void MultiplexedStream::writeRequest(Buffer::Instance& request) {
+  ASSERT(request.length() >= DubboProtocolImpl::MessageSize);
+  original_request_id_ = request.peekBEInt<int64_t>(RequestIDOffset);
+  // Oneway requests get no response.
+  request_sent_ = (request.peekInt<uint8_t>(FlagOffset) & TwoWayMask) != 0;
+  setRequestId(request, request_id_);
+  connection().write(request, false);
+}
+
+MultiplexedConnection::~MultiplexedConnection() {
+  detachStreams();
+  if (conn_pool_handle_) {
+    conn_pool_handle_->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+  }
+}
+
+Tcp::ConnectionPool::Cancellable*
+MultiplexedConnection::newStream(Upstream::TcpPoolData& pool_data,
+                                 Tcp::ConnectionPool::Callbacks& callbacks) {
+  ASSERT(!closing_);
+  if (conn_data_ == nullptr && conn_pool_handle_ == nullptr) {
+    // The pool may invoke the callbacks before returning.
+    Tcp::ConnectionPool::Cancellable* handle = pool_data.newConnection(*this);
+    if (handle) {
+      conn_pool_handle_ = handle;
+    }
+  }
+
+  if (conn_data_ != nullptr) {
+    attachStream(callbacks);
+    return nullptr;
+  }
+
+  if (conn_pool_handle_ == nullptr) {
+    ASSERT(pool_failure_.has_value());
+    callbacks.onPoolFailure(pool_failure_.value(), "", host_);
+    return nullptr;
+  }
+
+  LinkedList::moveIntoListBack(std::make_unique<PendingStream>(*this, callbacks),
+                               pending_streams_);
+  return pending_streams_.back().get();
+}
+
+void MultiplexedConnection::onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                                          absl::string_view transport_failure_reason,
+                                          Upstream::HostDescriptionConstSharedPtr host) {
+  conn_pool_handle_ = nullptr;
+  pool_failure_ = reason;
+  host_ = host;
+  remove();
+
+  while (!pending_streams_.empty()) {
+    PendingStreamPtr pending = pending_streams_.front()->removeFromList(pending_streams_);
+    pending->callbacks_.onPoolFailure(reason, transport_failure_reason, host);
+  }
+}
+
+void MultiplexedConnection::onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn_data,
+                                        Upstream::HostDescriptionConstSharedPtr host) {
+  ENVOY_LOG(debug, "dubbo: multiplexed connection ready to {}", host->address()->asString());
+  conn_pool_handle_ = nullptr;
+  conn_data_ = std::move(conn_data);
+  conn_data_->addUpstreamCallbacks(*this);
+  host_ = host;
+
+  while (!pending_streams_.empty() && conn_data_ != nullptr) {
+    PendingStreamPtr pending = pending_streams_.front()->removeFromList(pending_streams_);
+    attachStream(pending->callbacks_);
+  }
+  releaseIfIdle();
+}
+
+void MultiplexedConnection::attachStream(Tcp::ConnectionPool::Callbacks& callbacks) {
+  while (streams_.contains(next_request_id_)) {
+    next_request_id_++;
+  }
+
+  auto stream = std::make_unique<MultiplexedStream>(*this, next_request_id_++);
+  streams_[stream->request_id_] = stream.get();
+  callbacks.onPoolReady(std::move(stream), host_);
+}
+
+void MultiplexedConnection::onStreamReleased(MultiplexedStream& stream) {
+  auto it = streams_.find(stream.request_id_);
+  if (it == streams_.end() || it->second != &stream) {
+    return;
+  }
+
+  if (stream.request_sent_ && !stream.response_received_ && !closing_) {
+    // The response still has to be read off the connection.
+    it->second = nullptr;
+    return;
+  }
+  streams_.erase(it);
+  releaseIfIdle();
+}
+
+void MultiplexedConnection::releaseIfIdle() {
+  if (closing_ || conn_data_ == nullptr || !streams_.empty() || !pending_streams_.empty()) {
+    return;
+  }
+
+  ENVOY_LOG(debug, "dubbo: releasing idle multiplexed connection");
+  remove();
+  conn_data_.reset();
+}
+
+void MultiplexedConnection::remove() { parent_.remove(*this); }
+
+void MultiplexedConnection::detachStreams() {
+  for (const auto& stream : streams_) {
+    if (stream.second != nullptr) {
+      stream.second->parent_ = nullptr;
+    }
+  }
+  streams_.clear();
+}
+
+void MultiplexedConnection::onUpstreamData(Buffer::Instance& data, bool end_stream) {
+  response_buffer_.move(data);
+
+  while (conn_data_ != nullptr && !closing_ &&
+         response_buffer_.length() >= DubboProtocolImpl::MessageSize) {
+    const uint32_t body_size = response_buffer_.peekBEInt<uint32_t>(BodySizeOffset);
+    if (response_buffer_.peekBEInt<uint16_t>() != MagicNumber ||
+        body_size > static_cast<uint32_t>(DubboProtocolImpl::MaxBodySize)) {
+      ENVOY_LOG(debug, "dubbo: invalid message on multiplexed connection");
+      closing_ = true;
+      conn_data_->connection().close(Network::ConnectionCloseType::NoFlush);
+      return;
+    }
+
+    const uint64_t size = DubboProtocolImpl::MessageSize + body_size;
+    if (response_buffer_.length() < size) {
+      break;
+    }
+
+    Buffer::OwnedImpl message;
+    message.move(response_buffer_, size);
+    if ((message.peekInt<uint8_t>(FlagOffset) & MessageTypeMask) != 0) {
+      // Requests from the upstream, such as heartbeats, are not for any of the streams.
+      ENVOY_LOG(debug, "dubbo: dropping request on multiplexed connection");
+      continue;
+    }
+
+    const int64_t request_id = message.peekBEInt<int64_t>(RequestIDOffset);
+    auto it = streams_.find(request_id);
+    if (it == streams_.end()) {
+      ENVOY_LOG(debug, "dubbo: dropping response with unknown request id {}", request_id);
+      continue;
+    }
+
+    MultiplexedStream* stream = it->second;
+    if (stream == nullptr) {
+      // The request of the response is gone.
+      streams_.erase(it);
+      releaseIfIdle();
+      continue;
+    }
+
+    stream->response_received_ = true;
+    setRequestId(message, stream->original_request_id_);
+    if (stream->callbacks_ != nullptr) {
+      stream->callbacks_->onUpstreamData(message, false);
+    }
+  }
+
+  if (end_stream && conn_data_ != nullptr && !closing_) {
+    // No more responses are coming, the requests waiting for one get an incomplete response.
+    closing_ = true;
+    remove();
+    std::vector<int64_t> request_ids;
+    for (const auto& stream : streams_) {
+      request_ids.push_back(stream.first);
+    }
+    for (const int64_t request_id : request_ids) {
+      auto it = streams_.find(request_id);
+      if (it != streams_.end() && it->second != nullptr && it->second->callbacks_ != nullptr) {
+        Buffer::OwnedImpl empty;
+        it->second->callbacks_->onUpstreamData(empty, true);
+      }
+    }
+    if (conn_data_ != nullptr) {
+      conn_data_->connection().close(Network::ConnectionCloseType::NoFlush);
+    }
+  }
+}
+
+void MultiplexedConnection::onEvent(Network::ConnectionEvent event) {
+  ASSERT(event != Network::ConnectionEvent::Connected);
+  ENVOY_LOG(debug, "dubbo: multiplexed connection closed");
+  closing_ = true;
+  remove();
+
+  // Streams may outlive the connection, as the router keeps them until the request is done.
+  std::vector<int64_t> request_ids;
+  for (const auto& stream : streams_) {
+    request_ids.push_back(stream.first);
+  }
+  for (const int64_t request_id : request_ids) {
+    auto it = streams_.find(request_id);
+    if (it != streams_.end() && it->second != nullptr && it->second->callbacks_ != nullptr) {
+      it->second->callbacks_->onEvent(event);
+    }
+  }
+
+  detachStreams();
+  conn_data_.reset();
+}
+
+Tcp::ConnectionPool::Cancellable*
+ConnectionMultiplexer::newConnection(Upstream::TcpPoolData& pool_data,
+                                     Tcp::ConnectionPool::Callbacks& callbacks) {
+  const Upstream::HostDescription* host = pool_data.host().get();
+  auto it = connections_.find(host);
+  if (it == connections_.end()) {
+    it = connections_.emplace(host, std::make_unique<MultiplexedConnection>(*this, host)).first;
+  }
+
+  // The connection may be removed at once, if the pool fails synchronously.
+  return it->second->newStream(pool_data, callbacks);
+}
+
+void ConnectionMultiplexer::remove(MultiplexedConnection& connection) {
+  auto it = connections_.find(connection.pool_host_);
+  if (it == connections_.end() || it->second.get() != &connection) {
+    return;
+  }
+
+  dispatcher_.deferredDelete(std::move(it->second));
+  connections_.erase(it);
+}
+
+} // namespace Router
+} // namespace DubboProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
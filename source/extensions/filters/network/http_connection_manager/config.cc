@@ -43,6 +43,8 @@
 
 #include "source/extensions/filters/http/common/pass_through_filter.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -308,7 +310,10 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
           config.common_http_protocol_options().headers_with_underscores_action()),
       local_reply_(LocalReply::Factory::create(config.local_reply_config(), context)),
       path_with_escaped_slashes_action_(getPathWithEscapedSlashesAction(config, context)),
-      strip_trailing_host_dot_(config.strip_trailing_host_dot()) {
+      strip_trailing_host_dot_(config.strip_trailing_host_dot()),
+      filter_cost_sampling_(config.has_filter_cost_sampling()
+                                ? UnitFloat(config.filter_cost_sampling().value() / 100.0)
+                                : UnitFloat::min()) {
   // If idle_timeout_ was not configured in common_http_protocol_options, use value in deprecated
   // idle_timeout field.
   // TODO(asraa): Remove when idle_timeout is removed.
@@ -642,6 +647,7 @@ void HttpConnectionManagerConfig::processFilter(
                     : static_cast<const Protobuf::Message&>(
                           proto_config.hidden_envoy_deprecated_config()),
                 true));
+  addFilterCostHistogram(*filter_config_provider);
   filter_factories.push_back(std::move(filter_config_provider));
 }
 
@@ -668,9 +674,22 @@ void HttpConnectionManagerConfig::processDynamicFilterConfig(
   auto filter_config_provider = filter_config_provider_manager_.createDynamicFilterConfigProvider(
       config_discovery, name, context_, stats_prefix_, last_filter_in_current_config,
       filter_chain_type);
+  addFilterCostHistogram(*filter_config_provider);
   filter_factories.push_back(std::move(filter_config_provider));
 }
 
+void HttpConnectionManagerConfig::addFilterCostHistogram(
+    Filter::Http::FilterConfigProvider& filter_config_provider) {
+  if (filter_cost_sampling_ == UnitFloat::min()) {
+    return;
+  }
+  Stats::StatNameManagedStorage storage(
+      absl::StrCat(stats_prefix_, "filter_cost.", filter_config_provider.name(), ".cpu_us"),
+      context_.scope().symbolTable());
+  filter_cost_histograms_[&filter_config_provider] = &context_.scope().histogramFromStatName(
+      storage.statName(), Stats::Histogram::Unit::Microseconds);
+}
+
 Http::ServerConnectionPtr
 HttpConnectionManagerConfig::createCodec(Network::Connection& connection,
                                          const Buffer::Instance& data,
@@ -711,7 +730,14 @@ HttpConnectionManagerConfig::createCodec(Network::Connection& connection,
 void HttpConnectionManagerConfig::createFilterChainForFactories(
     Http::FilterChainFactoryCallbacks& callbacks, const FilterFactoriesList& filter_factories) {
   bool added_missing_config_filter = false;
+  // The stream is sampled as a whole, so that the filter costs add up to the cost of the streams.
+  const bool record_filter_costs =
+      filter_cost_sampling_ != UnitFloat::min() &&
+      context_.api().randomGenerator().bernoulli(filter_cost_sampling_);
   for (const auto& filter_config_provider : filter_factories) {
+    if (record_filter_costs) {
+      callbacks.recordFilterCost(*filter_cost_histograms_.at(filter_config_provider.get()));
+    }
     auto config = filter_config_provider->config();
     if (config.has_value()) {
       config.value()(callbacks);
@@ -16,6 +16,7 @@
 #include "envoy/http/original_ip_detection.h"
 #include "envoy/http/request_id_extension.h"
 #include "envoy/router/route_config_provider_manager.h"
+#include "envoy/stats/histogram.h"
 #include "envoy/tracing/http_tracer_manager.h"
 
 #include "source/common/common/logger.h"
@@ -29,11 +30,14 @@
 #include "source/common/local_reply/local_reply.h"
 #include "source/common/router/rds_impl.h"
 #include "source/common/router/scoped_rds.h"
+#include "source/common/stats/symbol_table_impl.h"
 #include "source/common/tracing/http_tracer_impl.h"
 #include "source/extensions/filters/network/common/factory_base.h"
 #include "source/extensions/filters/network/http_connection_manager/dependency_manager.h"
 #include "source/extensions/filters/network/well_known_names.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -209,6 +213,7 @@ private:
                              bool last_filter_in_current_config);
   void createFilterChainForFactories(Http::FilterChainFactoryCallbacks& callbacks,
                                      const FilterFactoriesList& filter_factories);
+  void addFilterCostHistogram(Filter::Http::FilterConfigProvider& filter_config_provider);
 
   /**
    * Determines what tracing provider to use for a given
@@ -286,6 +291,11 @@ private:
   const envoy::extensions::filters::network::http_connection_manager::v3::HttpConnectionManager::
       PathWithEscapedSlashesAction path_with_escaped_slashes_action_;
   const bool strip_trailing_host_dot_;
+  // The fraction of the streams for which the cost of each filter is recorded, into the histogram
+  // of the provider of the filter.
+  const UnitFloat filter_cost_sampling_;
+  absl::flat_hash_map<const Filter::Http::FilterConfigProvider*, Stats::Histogram*>
+      filter_cost_histograms_;
 };
 
 /**
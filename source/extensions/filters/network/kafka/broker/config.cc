@@ -3,8 +3,11 @@
 #include "envoy/registry/registry.h"
 #include "envoy/server/filter_config.h"
 #include "envoy/stats/scope.h"
+#include "envoy/thread_local/thread_local.h"
 
+#include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/network/kafka/broker/filter.h"
+#include "source/extensions/filters/network/kafka/broker/produce_aggregator.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -18,10 +21,33 @@ Network::FilterFactoryCb KafkaConfigFactory::createFilterFactoryFromProtoTyped(
   ASSERT(!proto_config.stat_prefix().empty());
 
   const std::string& stat_prefix = proto_config.stat_prefix();
+  const bool skip_payload_parsing = proto_config.skip_payload_parsing();
 
-  return [&context, stat_prefix](Network::FilterManager& filter_manager) -> void {
+  // Produce requests are aggregated by worker, across the connections it handles.
+  std::shared_ptr<ThreadLocal::TypedSlot<ProduceAggregator>> produce_aggregators;
+  if (proto_config.has_produce_aggregation()) {
+    const auto& aggregation = proto_config.produce_aggregation();
+    const std::string cluster = aggregation.cluster();
+    const std::chrono::milliseconds linger{PROTOBUF_GET_MS_OR_DEFAULT(aggregation, linger, 5)};
+    const uint32_t batch_size =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(aggregation, batch_size, 1024 * 1024);
+    produce_aggregators =
+        ThreadLocal::TypedSlot<ProduceAggregator>::makeUnique(context.threadLocal());
+    Upstream::ClusterManager& cluster_manager = context.clusterManager();
+    produce_aggregators->set(
+        [&cluster_manager, cluster, linger, batch_size](Event::Dispatcher& dispatcher) {
+          return std::make_shared<ProduceAggregatorImpl>(cluster_manager, dispatcher, cluster,
+                                                         linger, batch_size);
+        });
+  }
+
+  return [&context, stat_prefix, skip_payload_parsing,
+          produce_aggregators](Network::FilterManager& filter_manager) -> void {
+    ProduceAggregator* produce_aggregator =
+        produce_aggregators ? &**produce_aggregators : nullptr;
     Network::FilterSharedPtr filter =
-        std::make_shared<KafkaBrokerFilter>(context.scope(), context.timeSource(), stat_prefix);
+        std::make_shared<KafkaBrokerFilter>(context.scope(), context.timeSource(), stat_prefix,
+                                            skip_payload_parsing, produce_aggregator);
     filter_manager.addFilter(filter);
   };
 }
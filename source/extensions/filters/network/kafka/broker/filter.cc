@@ -70,14 +70,29 @@ absl::flat_hash_map<int32_t, MonotonicTime>& KafkaMetricsFacadeImpl::getRequestA
 }
 
 KafkaBrokerFilter::KafkaBrokerFilter(Stats::Scope& scope, TimeSource& time_source,
-                                     const std::string& stat_prefix)
+                                     const std::string& stat_prefix,
+                                     const bool skip_payload_parsing,
+                                     ProduceAggregator* produce_aggregator)
     : KafkaBrokerFilter{
-          std::make_shared<KafkaMetricsFacadeImpl>(scope, time_source, stat_prefix)} {};
-
-KafkaBrokerFilter::KafkaBrokerFilter(const KafkaMetricsFacadeSharedPtr& metrics)
-    : metrics_{metrics}, response_decoder_{new ResponseDecoder({metrics})},
-      request_decoder_{
-          new RequestDecoder({std::make_shared<Forwarder>(*response_decoder_), metrics})} {};
+          std::make_shared<KafkaMetricsFacadeImpl>(scope, time_source, stat_prefix),
+          skip_payload_parsing ? HeaderOnlyRequestParserResolver::getInstance()
+                               : RequestParserResolver::getDefaultInstance(),
+          skip_payload_parsing ? HeaderOnlyResponseParserResolver::getInstance()
+                               : ResponseParserResolver::getDefaultInstance(),
+          produce_aggregator} {};
+
+KafkaBrokerFilter::KafkaBrokerFilter(const KafkaMetricsFacadeSharedPtr& metrics,
+                                     const RequestParserResolver& request_parser_resolver,
+                                     const ResponseParserResolver& response_parser_resolver,
+                                     ProduceAggregator* produce_aggregator)
+    : metrics_{metrics}, response_decoder_{new ResponseDecoder(
+                             ResponseInitialParserFactory::getDefaultInstance(),
+                             response_parser_resolver, {metrics})},
+      request_decoder_{new RequestDecoder(InitialParserFactory::getDefaultInstance(),
+                                          request_parser_resolver,
+                                          {std::make_shared<Forwarder>(*response_decoder_),
+                                           metrics})},
+      produce_aggregator_{produce_aggregator} {};
 
 KafkaBrokerFilter::KafkaBrokerFilter(KafkaMetricsFacadeSharedPtr metrics,
                                      ResponseDecoderSharedPtr response_decoder,
@@ -88,23 +103,36 @@ Network::FilterStatus KafkaBrokerFilter::onNewConnection() {
   return Network::FilterStatus::Continue;
 }
 
-void KafkaBrokerFilter::initializeReadFilterCallbacks(Network::ReadFilterCallbacks&) {}
+void KafkaBrokerFilter::initializeReadFilterCallbacks(Network::ReadFilterCallbacks& callbacks) {
+  if (produce_aggregator_ != nullptr) {
+    produce_interceptor_ =
+        std::make_unique<ProduceInterceptor>(*produce_aggregator_, callbacks.connection());
+  }
+}
 
 Network::FilterStatus KafkaBrokerFilter::onData(Buffer::Instance& data, bool) {
   ENVOY_LOG(trace, "data from Kafka client [{} request bytes]", data.length());
   try {
     request_decoder_->onData(data);
-    return Network::FilterStatus::Continue;
   } catch (const EnvoyException& e) {
     ENVOY_LOG(debug, "could not process data from Kafka client: {}", e.what());
     metrics_->onRequestException();
     request_decoder_->reset();
     return Network::FilterStatus::StopIteration;
   }
+  // Metrics are computed first, as the requests taken over are removed from the data.
+  if (produce_interceptor_) {
+    produce_interceptor_->onData(data);
+  }
+  return Network::FilterStatus::Continue;
 }
 
 Network::FilterStatus KafkaBrokerFilter::onWrite(Buffer::Instance& data, bool) {
   ENVOY_LOG(trace, "data from Kafka broker [{} response bytes]", data.length());
+  // Responses are released to the client, and so parsed, in the order of its requests.
+  if (produce_interceptor_) {
+    produce_interceptor_->onWrite(data);
+  }
   try {
     response_decoder_->onData(data);
     return Network::FilterStatus::Continue;
@@ -4,6 +4,8 @@
 #include "envoy/stats/scope.h"
 
 #include "source/common/common/logger.h"
+#include "source/extensions/filters/network/kafka/broker/produce_aggregator.h"
+#include "source/extensions/filters/network/kafka/broker/produce_interceptor.h"
 #include "source/extensions/filters/network/kafka/external/request_metrics.h"
 #include "source/extensions/filters/network/kafka/external/response_metrics.h"
 #include "source/extensions/filters/network/kafka/parser.h"
@@ -136,9 +138,12 @@ public:
   /**
    * Main constructor.
    * Creates decoders that eventually update prefixed metrics stored in scope, using time source for
-   * duration calculation.
+   * duration calculation. If payload parsing is skipped, the decoders only parse message headers.
+   * If a produce aggregator is given, the produce requests are handed over to it instead of being
+   * forwarded.
    */
-  KafkaBrokerFilter(Stats::Scope& scope, TimeSource& time_source, const std::string& stat_prefix);
+  KafkaBrokerFilter(Stats::Scope& scope, TimeSource& time_source, const std::string& stat_prefix,
+                    bool skip_payload_parsing, ProduceAggregator* produce_aggregator);
 
   /**
    * Visible for testing.
@@ -160,13 +165,18 @@ public:
 private:
   /**
    * Helper delegate constructor.
-   * Passes metrics facade as argument to decoders.
+   * Passes metrics facade and parser resolvers as arguments to decoders.
    */
-  KafkaBrokerFilter(const KafkaMetricsFacadeSharedPtr& metrics);
+  KafkaBrokerFilter(const KafkaMetricsFacadeSharedPtr& metrics,
+                    const RequestParserResolver& request_parser_resolver,
+                    const ResponseParserResolver& response_parser_resolver,
+                    ProduceAggregator* produce_aggregator);
 
   const KafkaMetricsFacadeSharedPtr metrics_;
   const ResponseDecoderSharedPtr response_decoder_;
   const RequestDecoderSharedPtr request_decoder_;
+  ProduceAggregator* const produce_aggregator_{nullptr};
+  ProduceInterceptorPtr produce_interceptor_;
 };
 
 } // namespace Broker
@@ -0,0 +1,330 @@
+#include "source/extensions/filters/network/kafka/broker/produce_aggregator.h"
+
+#include <algorithm>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/network/kafka/request_codec.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Broker {
+
+ProduceAggregatorImpl::PendingProduce::PendingProduce(const ProduceRequest& request,
+                                                      ProduceCallbacks& callbacks)
+    : callbacks_{&callbacks}, remaining_{0} {
+  for (const TopicProduceData& topic : request.topics_) {
+    topic_names_.push_back(topic.name_);
+    results_.emplace_back(topic.partitions_.size());
+    remaining_ += topic.partitions_.size();
+  }
+}
+
+void ProduceAggregatorImpl::PendingProduce::onPartitionResponse(
+    const size_t topic, const size_t partition, PartitionProduceResponse response) {
+  absl::optional<PartitionProduceResponse>& result = results_[topic][partition];
+  if (result) {
+    return;
+  }
+  result.emplace(std::move(response));
+  if (--remaining_ > 0 || callbacks_ == nullptr) {
+    return;
+  }
+
+  std::vector<TopicProduceResponse> topics;
+  for (size_t i = 0; i < topic_names_.size(); ++i) {
+    std::vector<PartitionProduceResponse> partitions;
+    for (const absl::optional<PartitionProduceResponse>& partition_result : results_[i]) {
+      partitions.push_back(*partition_result);
+    }
+    topics.emplace_back(topic_names_[i], partitions);
+  }
+  ProduceCallbacks* callbacks = callbacks_;
+  callbacks_ = nullptr;
+  callbacks->onProduceResponse(ProduceResponse{topics, 0});
+}
+
+Network::FilterStatus ProduceAggregatorImpl::UpstreamReadFilter::onData(Buffer::Instance& data,
+                                                                        bool) {
+  parent_.onUpstreamData(data);
+  data.drain(data.length());
+  return Network::FilterStatus::StopIteration;
+}
+
+void ProduceAggregatorImpl::UpstreamResponseCallback::onMessage(
+    AbstractResponseSharedPtr response) {
+  const auto produce_response = std::dynamic_pointer_cast<Response<ProduceResponse>>(response);
+  parent_.onUpstreamResponse(response->metadata_.correlation_id_,
+                             produce_response ? &produce_response->data_ : nullptr);
+}
+
+void ProduceAggregatorImpl::UpstreamResponseCallback::onFailedParse(
+    ResponseMetadataSharedPtr metadata) {
+  parent_.onUpstreamResponse(metadata->correlation_id_, nullptr);
+}
+
+ProduceAggregatorImpl::ProduceAggregatorImpl(Upstream::ClusterManager& cluster_manager,
+                                             Event::Dispatcher& dispatcher,
+                                             const std::string& cluster_name,
+                                             const std::chrono::milliseconds linger,
+                                             const uint32_t batch_size)
+    : cluster_manager_{cluster_manager}, dispatcher_{dispatcher}, cluster_name_{cluster_name},
+      linger_{linger}, batch_size_{batch_size},
+      flush_timer_{dispatcher.createTimer([this]() { flush(); })} {}
+
+ProduceAggregatorImpl::~ProduceAggregatorImpl() {
+  if (connection_) {
+    connection_->close(Network::ConnectionCloseType::NoFlush);
+  }
+}
+
+ProduceHandle* ProduceAggregatorImpl::produce(const int16_t api_version,
+                                              const ProduceRequest& request,
+                                              ProduceCallbacks& callbacks) {
+  const PendingProduceSharedPtr pending = std::make_shared<PendingProduce>(request, callbacks);
+  Group& group = groups_[{api_version, request.acks_}];
+  group.timeout_ms_ = std::max(group.timeout_ms_, request.timeout_ms_);
+  for (size_t t = 0; t < request.topics_.size(); ++t) {
+    const TopicProduceData& topic = request.topics_[t];
+    for (size_t p = 0; p < topic.partitions_.size(); ++p) {
+      const PartitionProduceData& partition = topic.partitions_[p];
+      enqueue(group, {topic.name_, partition.partition_index_}, partition.records_,
+              {pending, t, p, 0, 0});
+    }
+  }
+
+  // The batches are always sent from the timer, so that the callbacks are never invoked inline.
+  if (buffered_size_ >= batch_size_) {
+    flush_timer_->enableTimer(std::chrono::milliseconds(0));
+  } else if (!flush_timer_->enabled()) {
+    flush_timer_->enableTimer(linger_);
+  }
+  return pending.get();
+}
+
+void ProduceAggregatorImpl::enqueue(Group& group, const TopicPartition& topic_partition,
+                                    const NullableBytes& records,
+                                    const Contribution& contribution) {
+  std::deque<PartitionBatch>& queue = group.partitions_[topic_partition];
+  if (records) {
+    const absl::string_view bytes{reinterpret_cast<const char*>(records->data()),
+                                  records->size()};
+
+    // Records are only merged into the last batch of the queue, so that the ones of a partition
+    // are still written in the order they were received.
+    if (!queue.empty() && queue.back().merger_ &&
+        queue.back().size() + bytes.size() <= batch_size_) {
+      PartitionBatch& batch = queue.back();
+      const uint64_t previous_size = batch.size();
+      const absl::optional<int32_t> first_record = batch.merger_->add(bytes);
+      if (first_record) {
+        buffered_size_ += batch.size() - previous_size;
+        batch.contributions_.push_back({contribution.request_, contribution.topic_,
+                                        contribution.partition_, *first_record,
+                                        batch.merger_->recordCount() - *first_record});
+        return;
+      }
+    }
+
+    auto merger = std::make_unique<RecordBatchMerger>();
+    if (merger->add(bytes)) {
+      PartitionBatch& batch = queue.emplace_back();
+      batch.contributions_.push_back({contribution.request_, contribution.topic_,
+                                      contribution.partition_, 0, merger->recordCount()});
+      batch.merger_ = std::move(merger);
+      buffered_size_ += batch.size();
+      return;
+    }
+  }
+
+  // The records that cannot be merged are sent as they are.
+  PartitionBatch& batch = queue.emplace_back();
+  batch.records_ = records;
+  batch.contributions_.push_back(contribution);
+  buffered_size_ += batch.size();
+}
+
+void ProduceAggregatorImpl::flush() {
+  std::map<GroupKey, Group> groups;
+  groups.swap(groups_);
+  buffered_size_ = 0;
+
+  for (auto& [key, group] : groups) {
+    while (!group.partitions_.empty()) {
+      std::map<TopicPartition, PartitionBatch> batches;
+      for (auto it = group.partitions_.begin(); it != group.partitions_.end();) {
+        batches.emplace(it->first, std::move(it->second.front()));
+        it->second.pop_front();
+        it = it->second.empty() ? group.partitions_.erase(it) : std::next(it);
+      }
+      sendRequest(key.first, key.second, group.timeout_ms_, std::move(batches));
+    }
+  }
+}
+
+void ProduceAggregatorImpl::sendRequest(const int16_t api_version, const int16_t acks,
+                                        const int32_t timeout_ms,
+                                        std::map<TopicPartition, PartitionBatch> batches) {
+  if (!ensureConnection()) {
+    for (const auto& entry : batches) {
+      failBatch(entry.first, entry.second, NetworkException);
+    }
+    return;
+  }
+
+  // Batches are ordered by topic-partition, so the ones of a topic are adjacent.
+  std::vector<TopicProduceData> topics;
+  std::vector<PartitionProduceData> partitions;
+  for (auto it = batches.begin(); it != batches.end(); ++it) {
+    const PartitionBatch& batch = it->second;
+    partitions.emplace_back(it->first.second,
+                            batch.merger_ ? NullableBytes{batch.merger_->build()} : batch.records_);
+    const auto next = std::next(it);
+    if (next == batches.end() || next->first.first != it->first.first) {
+      topics.emplace_back(it->first.first, partitions);
+      partitions.clear();
+    }
+  }
+
+  const int32_t correlation_id = next_correlation_id_++;
+  const RequestHeader header{ProduceApiKey, api_version, correlation_id, "envoy"};
+  const Request<ProduceRequest> request{header, {absl::nullopt, acks, timeout_ms, topics}};
+  Buffer::OwnedImpl buffer;
+  RequestEncoder{buffer}.encode(request);
+
+  response_decoder_->expectResponse(correlation_id, ProduceApiKey, api_version);
+  in_flight_[correlation_id].batches_ = std::move(batches);
+  connection_->write(buffer, false);
+}
+
+void ProduceAggregatorImpl::onUpstreamResponse(const int32_t correlation_id,
+                                               const ProduceResponse* response) {
+  const auto it = in_flight_.find(correlation_id);
+  if (it == in_flight_.end()) {
+    return;
+  }
+  InFlightRequest request = std::move(it->second);
+  in_flight_.erase(it);
+
+  if (response != nullptr) {
+    for (const TopicProduceResponse& topic : response->responses_) {
+      for (const PartitionProduceResponse& partition : topic.partitions_) {
+        const auto batch = request.batches_.find({topic.name_, partition.partition_index_});
+        if (batch != request.batches_.end()) {
+          completeBatch(batch->second, partition);
+          request.batches_.erase(batch);
+        }
+      }
+    }
+  }
+  // Partitions missing from the response (or all of them, if it could not be parsed).
+  for (const auto& entry : request.batches_) {
+    failBatch(entry.first, entry.second, UnknownServerError);
+  }
+}
+
+void ProduceAggregatorImpl::onUpstreamData(Buffer::Instance& data) {
+  // The decoder is kept alive, as the callbacks it notifies might close the connection.
+  const ResponseDecoderSharedPtr decoder = response_decoder_;
+  try {
+    decoder->onData(data);
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(debug, "could not process data from Kafka cluster {}: {}", cluster_name_, e.what());
+    closeConnection();
+  }
+}
+
+void ProduceAggregatorImpl::onEvent(const Network::ConnectionEvent event) {
+  if (event != Network::ConnectionEvent::RemoteClose &&
+      event != Network::ConnectionEvent::LocalClose) {
+    return;
+  }
+  ENVOY_LOG(debug, "connection to Kafka cluster {} closed", cluster_name_);
+  dispatcher_.deferredDelete(std::move(connection_));
+  response_decoder_ = nullptr;
+
+  // The records of the requests in flight might have been written, but their results are unknown.
+  absl::flat_hash_map<int32_t, InFlightRequest> in_flight;
+  in_flight.swap(in_flight_);
+  for (const auto& request : in_flight) {
+    for (const auto& entry : request.second.batches_) {
+      failBatch(entry.first, entry.second, NetworkException);
+    }
+  }
+}
+
+bool ProduceAggregatorImpl::ensureConnection() {
+  if (connection_) {
+    return true;
+  }
+  Upstream::ThreadLocalCluster* cluster = cluster_manager_.getThreadLocalCluster(cluster_name_);
+  if (cluster == nullptr) {
+    ENVOY_LOG(debug, "unknown Kafka cluster {}", cluster_name_);
+    return false;
+  }
+  Upstream::Host::CreateConnectionData data = cluster->tcpConn(nullptr);
+  if (data.connection_ == nullptr) {
+    ENVOY_LOG(debug, "no healthy host in Kafka cluster {}", cluster_name_);
+    return false;
+  }
+
+  connection_ = std::move(data.connection_);
+  response_decoder_ = std::make_shared<ResponseDecoder>(
+      std::vector<ResponseCallbackSharedPtr>{std::make_shared<UpstreamResponseCallback>(*this)});
+  connection_->addConnectionCallbacks(*this);
+  connection_->addReadFilter(std::make_shared<UpstreamReadFilter>(*this));
+  connection_->connect();
+  connection_->noDelay(true);
+  return true;
+}
+
+void ProduceAggregatorImpl::closeConnection() {
+  if (connection_) {
+    connection_->close(Network::ConnectionCloseType::NoFlush);
+  }
+}
+
+void ProduceAggregatorImpl::failBatch(const TopicPartition& topic_partition,
+                                      const PartitionBatch& batch, const int16_t error_code) {
+  const PartitionProduceResponse response{
+      topic_partition.second, error_code, -1, -1, -1, {}, absl::nullopt};
+  for (const Contribution& contribution : batch.contributions_) {
+    contribution.request_->onPartitionResponse(contribution.topic_, contribution.partition_,
+                                               response);
+  }
+}
+
+void ProduceAggregatorImpl::completeBatch(const PartitionBatch& batch,
+                                          const PartitionProduceResponse& response) {
+  if (!batch.merger_) {
+    const Contribution& contribution = batch.contributions_.front();
+    contribution.request_->onPartitionResponse(contribution.topic_, contribution.partition_,
+                                               response);
+    return;
+  }
+
+  // The offsets and record indexes of the merged batch are shifted to the ones of each request.
+  for (const Contribution& contribution : batch.contributions_) {
+    const int32_t first = contribution.first_record_;
+    std::vector<BatchIndexAndErrorMessage> record_errors;
+    for (const BatchIndexAndErrorMessage& error : response.record_errors_) {
+      if (error.batch_index_ >= first && error.batch_index_ < first + contribution.record_count_) {
+        record_errors.emplace_back(error.batch_index_ - first, error.batch_index_error_message_);
+      }
+    }
+    const int64_t base_offset =
+        response.base_offset_ < 0 ? response.base_offset_ : response.base_offset_ + first;
+    contribution.request_->onPartitionResponse(
+        contribution.topic_, contribution.partition_,
+        {response.partition_index_, response.error_code_, base_offset,
+         response.log_append_time_ms_, response.log_start_offset_, record_errors,
+         response.error_message_});
+  }
+}
+
+} // namespace Broker
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
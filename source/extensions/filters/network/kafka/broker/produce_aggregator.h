@@ -0,0 +1,242 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/network/connection.h"
+#include "envoy/thread_local/thread_local_object.h"
+#include "envoy/upstream/cluster_manager.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/network/filter_impl.h"
+#include "source/extensions/filters/network/kafka/external/requests.h"
+#include "source/extensions/filters/network/kafka/external/responses.h"
+#include "source/extensions/filters/network/kafka/record_batch.h"
+#include "source/extensions/filters/network/kafka/response_codec.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Broker {
+
+/**
+ * Kafka error codes used when the aggregated records could not be produced.
+ * @see http://kafka.apache.org/protocol.html#protocol_error_codes
+ */
+constexpr int16_t UnknownServerError = -1;
+constexpr int16_t NetworkException = 13;
+
+constexpr int16_t ProduceApiKey = 0;
+
+/**
+ * Callbacks for a produce request that has been handed over to the aggregator.
+ */
+class ProduceCallbacks {
+public:
+  virtual ~ProduceCallbacks() = default;
+
+  /**
+   * Called when the results of all the partitions of the produce request are known.
+   * @param response the response to the produce request (without the header).
+   */
+  virtual void onProduceResponse(const ProduceResponse& response) PURE;
+};
+
+/**
+ * Handle to a produce request that is being aggregated.
+ */
+class ProduceHandle {
+public:
+  virtual ~ProduceHandle() = default;
+
+  /**
+   * Cancels the request, so its callbacks are not invoked. The records of the request might still
+   * be produced.
+   */
+  virtual void cancel() PURE;
+};
+
+/**
+ * Aggregates produce requests received from multiple clients, so that the records sent to each
+ * topic-partition are written upstream in larger batches and fewer requests.
+ * This interface was extracted to facilitate mock injection in unit tests.
+ */
+class ProduceAggregator : public ThreadLocal::ThreadLocalObject {
+public:
+  /**
+   * Takes over a produce request. Its callbacks are never invoked inline.
+   * @param api_version version of the request, that the response needs to be encoded with.
+   * @param request the produce request (v3 or newer, with acks != 0 and not transactional).
+   * @param callbacks callbacks to notify when the response is known.
+   * @return handle to the request, valid until its callbacks are invoked.
+   */
+  virtual ProduceHandle* produce(int16_t api_version, const ProduceRequest& request,
+                                 ProduceCallbacks& callbacks) PURE;
+};
+
+/**
+ * Produce aggregator that sends the aggregated requests to a single upstream cluster, over one
+ * connection per worker.
+ * Produce requests are grouped by their version and acks, and each group keeps queues of the
+ * batches to be sent to each topic-partition. The record batches that can be merged are appended
+ * to the last batch of the queue; the others are queued as they are. Groups are flushed when the
+ * linger time elapses or when the buffered batches reach the batch size, and an upstream request
+ * then carries at most one batch per topic-partition.
+ */
+class ProduceAggregatorImpl : public ProduceAggregator,
+                              public Network::ConnectionCallbacks,
+                              private Logger::Loggable<Logger::Id::kafka> {
+public:
+  ProduceAggregatorImpl(Upstream::ClusterManager& cluster_manager, Event::Dispatcher& dispatcher,
+                        const std::string& cluster_name, std::chrono::milliseconds linger,
+                        uint32_t batch_size);
+  ~ProduceAggregatorImpl() override;
+
+  // ProduceAggregator
+  ProduceHandle* produce(int16_t api_version, const ProduceRequest& request,
+                         ProduceCallbacks& callbacks) override;
+
+  // Network::ConnectionCallbacks
+  void onEvent(Network::ConnectionEvent event) override;
+  void onAboveWriteBufferHighWatermark() override {}
+  void onBelowWriteBufferLowWatermark() override {}
+
+  /**
+   * Receives the responses of the aggregated requests from the upstream broker.
+   * @param correlation_id correlation id of the response.
+   * @param response the produce response, or nullptr if it could not be parsed.
+   */
+  void onUpstreamResponse(int32_t correlation_id, const ProduceResponse* response);
+
+private:
+  /**
+   * A produce request received from a client, that collects the results of its partitions.
+   */
+  class PendingProduce : public ProduceHandle {
+  public:
+    PendingProduce(const ProduceRequest& request, ProduceCallbacks& callbacks);
+
+    // ProduceHandle
+    void cancel() override { callbacks_ = nullptr; }
+
+    /**
+     * Stores the result of a partition, and notifies the callbacks once all results are known.
+     */
+    void onPartitionResponse(size_t topic, size_t partition, PartitionProduceResponse response);
+
+  private:
+    ProduceCallbacks* callbacks_;
+    std::vector<std::string> topic_names_;
+    std::vector<std::vector<absl::optional<PartitionProduceResponse>>> results_;
+    uint32_t remaining_;
+  };
+
+  using PendingProduceSharedPtr = std::shared_ptr<PendingProduce>;
+
+  /**
+   * Part of a queued batch that comes from a single produce request.
+   */
+  struct Contribution {
+    PendingProduceSharedPtr request_;
+    size_t topic_;
+    size_t partition_;
+    // Index of the first record of the request in a merged batch, and the request's record count.
+    int32_t first_record_;
+    int32_t record_count_;
+  };
+
+  /**
+   * Batch queued for a topic-partition. Either merged from the batches of multiple requests, or
+   * the records of a single request kept as they were received.
+   */
+  struct PartitionBatch {
+    std::unique_ptr<RecordBatchMerger> merger_;
+    NullableBytes records_;
+    std::vector<Contribution> contributions_;
+
+    uint64_t size() const {
+      return merger_ ? merger_->size() : (records_ ? records_->size() : 0);
+    }
+  };
+
+  using TopicPartition = std::pair<std::string, int32_t>;
+
+  /**
+   * Batches of the produce requests of the same version and acks.
+   */
+  struct Group {
+    std::map<TopicPartition, std::deque<PartitionBatch>> partitions_;
+    int32_t timeout_ms_{0};
+  };
+
+  using GroupKey = std::pair<int16_t, int16_t>;
+
+  /**
+   * Upstream request whose response has not been received yet.
+   */
+  struct InFlightRequest {
+    std::map<TopicPartition, PartitionBatch> batches_;
+  };
+
+  struct UpstreamReadFilter : public Network::ReadFilterBaseImpl {
+    UpstreamReadFilter(ProduceAggregatorImpl& parent) : parent_(parent) {}
+
+    // Network::ReadFilter
+    Network::FilterStatus onData(Buffer::Instance& data, bool) override;
+
+    ProduceAggregatorImpl& parent_;
+  };
+
+  struct UpstreamResponseCallback : public ResponseCallback {
+    UpstreamResponseCallback(ProduceAggregatorImpl& parent) : parent_(parent) {}
+
+    // ResponseCallback
+    void onMessage(AbstractResponseSharedPtr response) override;
+    void onFailedParse(ResponseMetadataSharedPtr metadata) override;
+
+    ProduceAggregatorImpl& parent_;
+  };
+
+  void enqueue(Group& group, const TopicPartition& topic_partition,
+               const NullableBytes& records, const Contribution& contribution);
+  void flush();
+  void sendRequest(int16_t api_version, int16_t acks, int32_t timeout_ms,
+                   std::map<TopicPartition, PartitionBatch> batches);
+  bool ensureConnection();
+  void closeConnection();
+  void onUpstreamData(Buffer::Instance& data);
+  static void failBatch(const TopicPartition& topic_partition, const PartitionBatch& batch,
+                        int16_t error_code);
+  static void completeBatch(const PartitionBatch& batch, const PartitionProduceResponse& response);
+
+  Upstream::ClusterManager& cluster_manager_;
+  Event::Dispatcher& dispatcher_;
+  const std::string cluster_name_;
+  const std::chrono::milliseconds linger_;
+  const uint32_t batch_size_;
+  const Event::TimerPtr flush_timer_;
+  std::map<GroupKey, Group> groups_;
+  uint64_t buffered_size_{0};
+
+  Network::ClientConnectionPtr connection_;
+  ResponseDecoderSharedPtr response_decoder_;
+  int32_t next_correlation_id_{0};
+  absl::flat_hash_map<int32_t, InFlightRequest> in_flight_;
+};
+
+} // namespace Broker
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,197 @@
+#include "source/extensions/filters/network/kafka/broker/produce_interceptor.h"
+
+#include <algorithm>
+
+#include "source/extensions/filters/network/kafka/response_codec.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Broker {
+
+namespace {
+
+// Size of the length field that precedes every request and response.
+constexpr uint64_t LengthSize = sizeof(int32_t);
+
+// Offsets of the request header fields used to pick the requests to take over.
+constexpr uint64_t ApiKeyOffset = LengthSize;
+constexpr uint64_t ApiVersionOffset = ApiKeyOffset + sizeof(int16_t);
+constexpr uint64_t ClientIdOffset = ApiVersionOffset + sizeof(int16_t) + sizeof(int32_t);
+
+// First version of produce requests that carries only v2 record batches.
+constexpr int16_t MinInterceptedProduceVersion = 3;
+
+/**
+ * Reads a nullable string length at given offset, advancing the offset past the string.
+ * @return whether the string is not null, or absl::nullopt if the request is too short.
+ */
+absl::optional<bool> skipNullableString(const Buffer::Instance& request, uint64_t& offset) {
+  if (request.length() < offset + sizeof(int16_t)) {
+    return absl::nullopt;
+  }
+  const int16_t length = request.peekBEInt<int16_t>(offset);
+  offset += sizeof(int16_t) + std::max<int16_t>(length, 0);
+  return length >= 0;
+}
+
+/**
+ * Reads the acks of a produce request, and whether it is transactional, without parsing the
+ * whole request. Produce requests do not have tagged fields in their header.
+ * @return whether the request should be taken over, or absl::nullopt if it expects no response.
+ */
+absl::optional<bool> shouldIntercept(const Buffer::Instance& request, const int16_t api_version) {
+  uint64_t offset = ClientIdOffset;
+  if (!skipNullableString(request, offset)) {
+    return false;
+  }
+  bool transactional = false;
+  if (api_version >= MinInterceptedProduceVersion) {
+    const absl::optional<bool> transactional_id = skipNullableString(request, offset);
+    if (!transactional_id) {
+      return false;
+    }
+    transactional = *transactional_id;
+  }
+  if (request.length() < offset + sizeof(int16_t)) {
+    return false;
+  }
+  const int16_t acks = request.peekBEInt<int16_t>(offset);
+  if (acks == 0) {
+    return absl::nullopt;
+  }
+  return api_version >= MinInterceptedProduceVersion && !transactional;
+}
+
+} // namespace
+
+void ProduceInterceptor::InterceptedRequest::onProduceResponse(const ProduceResponse& response) {
+  parent_.onInterceptedResponse(*this, response);
+}
+
+ProduceInterceptor::ProduceInterceptor(ProduceAggregator& aggregator,
+                                       Network::Connection& connection)
+    : aggregator_{aggregator}, connection_{connection},
+      capture_{std::make_shared<ProduceRequestCapture>()},
+      decoder_{std::vector<RequestCallbackSharedPtr>{capture_}} {}
+
+ProduceInterceptor::~ProduceInterceptor() {
+  for (const InterceptedRequestPtr& request : intercepted_) {
+    request->handle_->cancel();
+  }
+}
+
+void ProduceInterceptor::onData(Buffer::Instance& data) {
+  request_buffer_.move(data);
+  while (request_buffer_.length() >= LengthSize) {
+    const int32_t size = request_buffer_.peekBEInt<int32_t>();
+    if (size < 0) {
+      // Malformed data is forwarded as it is, the broker closes the connection anyway.
+      data.move(request_buffer_);
+      return;
+    }
+    if (request_buffer_.length() < LengthSize + size) {
+      return;
+    }
+    Buffer::OwnedImpl request;
+    request.move(request_buffer_, LengthSize + size);
+    processRequest(request, data);
+  }
+}
+
+void ProduceInterceptor::processRequest(Buffer::Instance& request, Buffer::Instance& forwarded) {
+  absl::optional<bool> intercept = false;
+  if (request.length() >= ClientIdOffset &&
+      request.peekBEInt<int16_t>(ApiKeyOffset) == ProduceApiKey) {
+    intercept = shouldIntercept(request, request.peekBEInt<int16_t>(ApiVersionOffset));
+  }
+
+  if (intercept && *intercept) {
+    try {
+      decoder_.onData(request);
+    } catch (const EnvoyException& e) {
+      ENVOY_LOG(debug, "could not parse produce request: {}", e.what());
+      decoder_.reset();
+    }
+    const auto produce_request =
+        std::dynamic_pointer_cast<Request<ProduceRequest>>(capture_->request_);
+    capture_->request_ = nullptr;
+
+    if (produce_request && !produce_request->data_.topics_.empty()) {
+      slots_.push_back(std::make_unique<ResponseSlot>(false));
+      intercepted_.push_back(std::make_unique<InterceptedRequest>(
+          *this, produce_request->request_header_, *slots_.back()));
+      InterceptedRequest& intercepted = *intercepted_.back();
+      intercepted.handle_ = aggregator_.produce(produce_request->request_header_.api_version_,
+                                                produce_request->data_, intercepted);
+      return;
+    }
+  }
+
+  // Produce requests with no acks get no response.
+  if (intercept) {
+    slots_.push_back(std::make_unique<ResponseSlot>(true));
+  }
+  forwarded.move(request);
+}
+
+void ProduceInterceptor::onWrite(Buffer::Instance& data) {
+  if (injecting_) {
+    return;
+  }
+  response_buffer_.move(data);
+  while (response_buffer_.length() >= LengthSize) {
+    const int32_t size = response_buffer_.peekBEInt<int32_t>();
+    if (size < 0) {
+      data.move(response_buffer_);
+      break;
+    }
+    if (response_buffer_.length() < LengthSize + size) {
+      break;
+    }
+    const auto slot = std::find_if(slots_.begin(), slots_.end(), [](const auto& slot) {
+      return slot->forwarded_ && !slot->complete_;
+    });
+    if (slot == slots_.end()) {
+      // Response the client did not send a request for, it is passed as it is.
+      data.move(response_buffer_, LengthSize + size);
+      continue;
+    }
+    (*slot)->data_.move(response_buffer_, LengthSize + size);
+    (*slot)->complete_ = true;
+  }
+  releaseResponses(data);
+}
+
+void ProduceInterceptor::onInterceptedResponse(InterceptedRequest& request,
+                                               const ProduceResponse& response) {
+  const RequestHeader& header = request.header_;
+  const Response<ProduceResponse> message{
+      {header.api_key_, header.api_version_, header.correlation_id_}, response};
+  ResponseEncoder{request.slot_.data_}.encode(message);
+  request.slot_.complete_ = true;
+  intercepted_.remove_if(
+      [&request](const InterceptedRequestPtr& element) { return element.get() == &request; });
+
+  Buffer::OwnedImpl output;
+  releaseResponses(output);
+  if (output.length() > 0 && connection_.state() == Network::Connection::State::Open) {
+    injecting_ = true;
+    connection_.write(output, false);
+    injecting_ = false;
+  }
+}
+
+void ProduceInterceptor::releaseResponses(Buffer::Instance& output) {
+  while (!slots_.empty() && slots_.front()->complete_) {
+    output.move(slots_.front()->data_);
+    slots_.pop_front();
+  }
+}
+
+} // namespace Broker
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
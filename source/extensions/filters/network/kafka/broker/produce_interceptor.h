@@ -0,0 +1,117 @@
+#pragma once
+
+#include <deque>
+#include <list>
+#include <memory>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/network/connection.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/logger.h"
+#include "source/extensions/filters/network/kafka/broker/produce_aggregator.h"
+#include "source/extensions/filters/network/kafka/request_codec.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Broker {
+
+/**
+ * Takes the produce requests of a client connection over, handing them to a produce aggregator
+ * instead of forwarding them to the broker, and injects their responses.
+ * All the other requests are forwarded, and as Kafka clients expect the responses in the order
+ * of their requests, the responses received from the broker are held back until the ones of the
+ * preceding produce requests are injected.
+ * Only the produce requests (v3 or newer) that are not transactional and expect a response are
+ * taken over. As requests need to be parsed whole to be taken over, complete requests are
+ * buffered before being forwarded.
+ */
+class ProduceInterceptor : private Logger::Loggable<Logger::Id::kafka> {
+public:
+  ProduceInterceptor(ProduceAggregator& aggregator, Network::Connection& connection);
+  ~ProduceInterceptor();
+
+  /**
+   * Processes the data received from the client, leaving only the data to be forwarded in it.
+   * @param data data received from the client.
+   */
+  void onData(Buffer::Instance& data);
+
+  /**
+   * Processes the data received from the broker, leaving only the data to be sent to the client in
+   * it.
+   * @param data data received from the broker.
+   */
+  void onWrite(Buffer::Instance& data);
+
+private:
+  /**
+   * A response expected by the client, either forwarded by the broker or injected.
+   */
+  struct ResponseSlot {
+    ResponseSlot(bool forwarded) : forwarded_{forwarded} {}
+
+    const bool forwarded_;
+    bool complete_{false};
+    Buffer::OwnedImpl data_;
+  };
+
+  /**
+   * Request taken over, whose response is to be injected.
+   */
+  struct InterceptedRequest : public ProduceCallbacks {
+    InterceptedRequest(ProduceInterceptor& parent, const RequestHeader& header, ResponseSlot& slot)
+        : parent_{parent}, header_{header}, slot_{slot} {}
+
+    // ProduceCallbacks
+    void onProduceResponse(const ProduceResponse& response) override;
+
+    ProduceInterceptor& parent_;
+    const RequestHeader header_;
+    ResponseSlot& slot_;
+    ProduceHandle* handle_{nullptr};
+  };
+
+  using InterceptedRequestPtr = std::unique_ptr<InterceptedRequest>;
+
+  /**
+   * Request callback that keeps the produce request parsed, if any.
+   */
+  struct ProduceRequestCapture : public RequestCallback {
+    // RequestCallback
+    void onMessage(AbstractRequestSharedPtr request) override { request_ = request; }
+    void onFailedParse(RequestParseFailureSharedPtr) override {}
+
+    AbstractRequestSharedPtr request_;
+  };
+
+  void processRequest(Buffer::Instance& request, Buffer::Instance& forwarded);
+  void onInterceptedResponse(InterceptedRequest& request, const ProduceResponse& response);
+  void releaseResponses(Buffer::Instance& output);
+
+  ProduceAggregator& aggregator_;
+  Network::Connection& connection_;
+  const std::shared_ptr<ProduceRequestCapture> capture_;
+  RequestDecoder decoder_;
+
+  // Request data received from the client, that does not make a complete request yet.
+  Buffer::OwnedImpl request_buffer_;
+  // Response data received from the broker, that does not make a complete response yet.
+  Buffer::OwnedImpl response_buffer_;
+  // Responses expected by the client, in order.
+  std::deque<std::unique_ptr<ResponseSlot>> slots_;
+  // Requests taken over, whose responses are not known yet.
+  std::list<InterceptedRequestPtr> intercepted_;
+  // Whether the responses being written are injected ones, that are already in order.
+  bool injecting_{false};
+};
+
+using ProduceInterceptorPtr = std::unique_ptr<ProduceInterceptor>;
+
+} // namespace Broker
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
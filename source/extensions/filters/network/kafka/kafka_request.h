@@ -121,6 +121,33 @@ public:
 
 using AbstractRequestSharedPtr = std::shared_ptr<AbstractRequest>;
 
+/**
+ * Request whose data has been skipped instead of being parsed, so only its header is known.
+ * As the data is not kept, the request cannot be encoded.
+ */
+class UnparsedRequest : public AbstractRequest {
+public:
+  /**
+   * Constructs a request with given header, followed by data of given size.
+   * @param request_header request's header.
+   * @param data_size size of the skipped request data.
+   */
+  UnparsedRequest(const RequestHeader& request_header, const uint32_t data_size)
+      : AbstractRequest{request_header}, data_size_{data_size} {};
+
+  uint32_t computeSize() const override {
+    const EncodingContext context{request_header_.api_version_};
+    return context.computeSize(request_header_) + data_size_;
+  }
+
+  uint32_t encode(Buffer::Instance&) const override {
+    throw EnvoyException("unparsed request cannot be encoded");
+  }
+
+private:
+  const uint32_t data_size_;
+};
+
 /**
  * Concrete request that carries data particular to given request type.
  * @param Data concrete request data type.
@@ -163,7 +190,9 @@ public:
     return request_header_ == rhs.request_header_ && data_ == rhs.data_;
   };
 
-private:
+  /**
+   * The request-specific data.
+   */
   const Data data_;
 };
 
@@ -1,5 +1,7 @@
 #include "source/extensions/filters/network/kafka/kafka_request_parser.h"
 
+#include <algorithm>
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -9,6 +11,19 @@ const RequestParserResolver& RequestParserResolver::getDefaultInstance() {
   CONSTRUCT_ON_FIRST_USE(RequestParserResolver);
 }
 
+RequestParserSharedPtr
+HeaderOnlyRequestParserResolver::createParser(int16_t api_key, int16_t api_version,
+                                              RequestContextSharedPtr context) const {
+  if (requestHasParser(api_key, api_version)) {
+    return std::make_shared<UnparsedRequestParser>(context);
+  }
+  return std::make_shared<SentinelParser>(context);
+}
+
+const RequestParserResolver& HeaderOnlyRequestParserResolver::getInstance() {
+  CONSTRUCT_ON_FIRST_USE(HeaderOnlyRequestParserResolver);
+}
+
 RequestParseResponse RequestStartParser::parse(absl::string_view& data) {
   request_length_.feed(data);
   if (request_length_.ready()) {
@@ -67,6 +82,19 @@ RequestParseResponse RequestHeaderParser::parse(absl::string_view& data) {
   }
 }
 
+RequestParseResponse UnparsedRequestParser::parse(absl::string_view& data) {
+  const uint32_t min = std::min<uint32_t>(context_->remaining_request_size_, data.size());
+  data = {data.data() + min, data.size() - min};
+  context_->remaining_request_size_ -= min;
+  if (0 == context_->remaining_request_size_) {
+    AbstractRequestSharedPtr msg =
+        std::make_shared<UnparsedRequest>(context_->request_header_, data_size_);
+    return RequestParseResponse::parsedMessage(msg);
+  } else {
+    return RequestParseResponse::stillWaiting();
+  }
+}
+
 } // namespace Kafka
 } // namespace NetworkFilters
 } // namespace Extensions
@@ -46,6 +46,15 @@ struct RequestContext {
 
 using RequestContextSharedPtr = std::shared_ptr<RequestContext>;
 
+/**
+ * Decides if request with given api key & version has a parser, i.e. is supported by the filter.
+ * This method gets implemented in generated code through 'kafka_request_resolver_cc.j2'.
+ * @param api_key Kafka request key.
+ * @param api_version Kafka request's version.
+ * @return Whether the request can be parsed.
+ */
+bool requestHasParser(const int16_t api_key, const int16_t api_version);
+
 /**
  * Request decoder configuration object.
  * Resolves the parser that will be responsible for consuming the request-specific data.
@@ -71,6 +80,29 @@ public:
   static const RequestParserResolver& getDefaultInstance();
 };
 
+/**
+ * Resolver providing parsers that skip the data of supported requests instead of parsing it, so
+ * that the cost of processing a request does not depend on its size.
+ * Requests that are not supported are handled as by the default resolver.
+ */
+class HeaderOnlyRequestParserResolver : public RequestParserResolver {
+public:
+  /**
+   * Creates a parser that is going to skip data of request with given api_key & api_version.
+   * @param api_key request type.
+   * @param api_version request version.
+   * @param context context to be used by parser.
+   * @return UnparsedRequestParser if request is supported, SentinelParser otherwise.
+   */
+  RequestParserSharedPtr createParser(int16_t api_key, int16_t api_version,
+                                      RequestContextSharedPtr context) const override;
+
+  /**
+   * Return the resolver instance.
+   */
+  static const RequestParserResolver& getInstance();
+};
+
 /**
  * Request parser responsible for consuming request length and setting up context with this data.
  * @see http://kafka.apache.org/protocol.html#protocol_common
@@ -175,6 +207,24 @@ public:
   }
 };
 
+/**
+ * Parser that consumes request data without capturing it, and then returns a request carrying only
+ * the header.
+ */
+class UnparsedRequestParser : public RequestParser {
+public:
+  UnparsedRequestParser(RequestContextSharedPtr context)
+      : context_{context}, data_size_{context->remaining_request_size_} {};
+
+  RequestParseResponse parse(absl::string_view& data) override;
+
+  const RequestContextSharedPtr contextForTest() const { return context_; }
+
+private:
+  const RequestContextSharedPtr context_;
+  const uint32_t data_size_;
+};
+
 /**
  * Request parser uses a single deserializer to construct a request object.
  * This parser is responsible for consuming request-specific data (e.g. topic names) and always
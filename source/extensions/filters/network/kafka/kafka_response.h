@@ -1,5 +1,7 @@
 #pragma once
 
+#include "envoy/common/exception.h"
+
 #include "source/extensions/filters/network/kafka/external/serialization_composite.h"
 #include "source/extensions/filters/network/kafka/serialization.h"
 #include "source/extensions/filters/network/kafka/tagged_fields.h"
@@ -101,6 +103,33 @@ public:
 
 using AbstractResponseSharedPtr = std::shared_ptr<AbstractResponse>;
 
+/**
+ * Response whose data has been skipped instead of being parsed, so only its metadata is known.
+ * As the data is not kept, the response cannot be encoded.
+ */
+class UnparsedResponse : public AbstractResponse {
+public:
+  /**
+   * Constructs a response with given metadata, followed by data of given size.
+   * @param metadata response metadata.
+   * @param data_size size of the skipped response data.
+   */
+  UnparsedResponse(const ResponseMetadata& metadata, const uint32_t data_size)
+      : AbstractResponse{metadata}, data_size_{data_size} {};
+
+  uint32_t computeSize() const override {
+    const EncodingContext context{metadata_.api_version_};
+    return context.computeSize(metadata_) + data_size_;
+  }
+
+  uint32_t encode(Buffer::Instance&) const override {
+    throw EnvoyException("unparsed response cannot be encoded");
+  }
+
+private:
+  const uint32_t data_size_;
+};
+
 /**
  * Concrete response that carries data particular to given response type.
  * @param Data concrete response data type.
@@ -141,7 +170,9 @@ public:
     return metadata_ == rhs.metadata_ && data_ == rhs.data_;
   };
 
-private:
+  /**
+   * The response-specific data.
+   */
   const Data data_;
 };
 
@@ -1,5 +1,7 @@
 #include "source/extensions/filters/network/kafka/kafka_response_parser.h"
 
+#include <algorithm>
+
 #include "absl/strings/str_cat.h"
 
 namespace Envoy {
@@ -11,6 +13,18 @@ const ResponseParserResolver& ResponseParserResolver::getDefaultInstance() {
   CONSTRUCT_ON_FIRST_USE(ResponseParserResolver);
 }
 
+ResponseParserSharedPtr
+HeaderOnlyResponseParserResolver::createParser(ResponseContextSharedPtr context) const {
+  if (responseHasParser(context->api_key_, context->api_version_)) {
+    return std::make_shared<UnparsedResponseParser>(context);
+  }
+  return std::make_shared<SentinelResponseParser>(context);
+}
+
+const ResponseParserResolver& HeaderOnlyResponseParserResolver::getInstance() {
+  CONSTRUCT_ON_FIRST_USE(HeaderOnlyResponseParserResolver);
+}
+
 ResponseParseResponse ResponseHeaderParser::parse(absl::string_view& data) {
   length_deserializer_.feed(data);
   if (!length_deserializer_.ready()) {
@@ -66,6 +80,21 @@ ExpectedResponseSpec ResponseHeaderParser::getResponseSpec(const int32_t correla
   }
 };
 
+ResponseParseResponse UnparsedResponseParser::parse(absl::string_view& data) {
+  const uint32_t min = std::min<uint32_t>(context_->remaining_response_size_, data.size());
+  data = {data.data() + min, data.size() - min};
+  context_->remaining_response_size_ -= min;
+  if (0 == context_->remaining_response_size_) {
+    const ResponseMetadata metadata = {context_->api_key_, context_->api_version_,
+                                       context_->correlation_id_, context_->tagged_fields_};
+    const AbstractResponseSharedPtr response =
+        std::make_shared<UnparsedResponse>(metadata, data_size_);
+    return ResponseParseResponse::parsedMessage(response);
+  } else {
+    return ResponseParseResponse::stillWaiting();
+  }
+}
+
 } // namespace Kafka
 } // namespace NetworkFilters
 } // namespace Extensions
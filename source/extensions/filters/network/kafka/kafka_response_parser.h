@@ -72,6 +72,15 @@ using ExpectedResponseSpec = std::pair<int16_t, int16_t>;
 using ExpectedResponses = std::map<int32_t, ExpectedResponseSpec>;
 using ExpectedResponsesSharedPtr = std::shared_ptr<ExpectedResponses>;
 
+/**
+ * Decides if response with given api key & version has a parser, i.e. is supported by the filter.
+ * This method gets implemented in generated code through 'kafka_response_resolver_cc.j2'.
+ * @param api_key Kafka response key.
+ * @param api_version Kafka response's version.
+ * @return Whether the response can be parsed.
+ */
+bool responseHasParser(const int16_t api_key, const int16_t api_version);
+
 /**
  * Response decoder configuration object.
  * Resolves the parser that will be responsible for consuming the response.
@@ -94,6 +103,26 @@ public:
   static const ResponseParserResolver& getDefaultInstance();
 };
 
+/**
+ * Resolver providing parsers that skip the data of supported responses instead of parsing it, so
+ * that the cost of processing a response does not depend on its size.
+ * Responses that are not supported are handled as by the default resolver.
+ */
+class HeaderOnlyResponseParserResolver : public ResponseParserResolver {
+public:
+  /**
+   * Creates a parser that is going to skip data of given response.
+   * @param metadata expected response metadata.
+   * @return UnparsedResponseParser if response is supported, SentinelResponseParser otherwise.
+   */
+  ResponseParserSharedPtr createParser(ResponseContextSharedPtr metadata) const override;
+
+  /**
+   * Return the resolver instance.
+   */
+  static const ResponseParserResolver& getInstance();
+};
+
 /**
  * Response parser responsible for consuming response header (payload length and correlation id) and
  * setting up context with this data.
@@ -151,6 +180,24 @@ public:
   }
 };
 
+/**
+ * Parser that consumes response data without capturing it, and then returns a response carrying
+ * only the metadata.
+ */
+class UnparsedResponseParser : public ResponseParser {
+public:
+  UnparsedResponseParser(ResponseContextSharedPtr context)
+      : context_{context}, data_size_{context->remaining_response_size_} {};
+
+  ResponseParseResponse parse(absl::string_view& data) override;
+
+  const ResponseContextSharedPtr contextForTest() const { return context_; }
+
+private:
+  const ResponseContextSharedPtr context_;
+  const uint32_t data_size_;
+};
+
 /**
  * Response parser uses a single deserializer to construct a response object.
  * This parser is responsible for consuming response-specific data (e.g. topic names) and always
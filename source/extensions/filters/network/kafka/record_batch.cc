@@ -0,0 +1,222 @@
+#include "source/extensions/filters/network/kafka/record_batch.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/byte_order.h"
+#include "source/common/common/macros.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+
+namespace {
+
+// Offsets of the record batch header fields.
+constexpr uint32_t BaseOffsetOffset = 0;
+constexpr uint32_t BatchLengthOffset = 8;
+constexpr uint32_t PartitionLeaderEpochOffset = 12;
+constexpr uint32_t MagicOffset = 16;
+constexpr uint32_t CrcOffset = 17;
+constexpr uint32_t AttributesOffset = 21;
+constexpr uint32_t LastOffsetDeltaOffset = 23;
+constexpr uint32_t FirstTimestampOffset = 27;
+constexpr uint32_t MaxTimestampOffset = 35;
+constexpr uint32_t ProducerIdOffset = 43;
+constexpr uint32_t ProducerEpochOffset = 51;
+constexpr uint32_t BaseSequenceOffset = 53;
+constexpr uint32_t RecordCountOffset = 57;
+
+constexpr int8_t CurrentMagic = 2;
+
+// Attributes of the batches that can be merged are all unset: no compression (bits 0-2), create
+// time timestamps (bit 3), not transactional (bit 4) and not a control batch (bit 5).
+constexpr int16_t UnmergeableAttributes = 0x3f;
+
+// Reflected CRC-32C polynomial.
+constexpr uint32_t Crc32cPolynomial = 0x82f63b78;
+
+std::array<uint32_t, 256> makeCrc32cTable() {
+  std::array<uint32_t, 256> table;
+  for (uint32_t i = 0; i < table.size(); ++i) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ ((crc & 1) ? Crc32cPolynomial : 0);
+    }
+    table[i] = crc;
+  }
+  return table;
+}
+
+const std::array<uint32_t, 256>& crc32cTable() {
+  CONSTRUCT_ON_FIRST_USE(std::array<uint32_t, 256>, makeCrc32cTable());
+}
+
+template <typename T> T readBigEndian(absl::string_view data, uint32_t offset) {
+  T value;
+  memcpy(&value, data.data() + offset, sizeof(T));
+  return fromEndianness<ByteOrder::BigEndian>(value);
+}
+
+template <typename T> void writeBigEndian(unsigned char* dst, T value) {
+  value = toEndianness<ByteOrder::BigEndian>(value);
+  memcpy(dst, &value, sizeof(T));
+}
+
+// Reads a zigzag-encoded variable-length integer, as used in records.
+bool readVarlong(absl::string_view& data, int64_t& result) {
+  uint64_t raw = 0;
+  for (uint32_t shift = 0; shift < 64; shift += 7) {
+    if (data.empty()) {
+      return false;
+    }
+    const uint8_t byte = data[0];
+    data.remove_prefix(1);
+    raw |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      result = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool readVarint(absl::string_view& data, int32_t& result) {
+  int64_t value;
+  if (!readVarlong(data, value) || value < std::numeric_limits<int32_t>::min() ||
+      value > std::numeric_limits<int32_t>::max()) {
+    return false;
+  }
+  result = static_cast<int32_t>(value);
+  return true;
+}
+
+// Maximum size of an encoded variable-length integer.
+constexpr uint32_t MaxVarlongSize = 10;
+
+// Writes a zigzag-encoded variable-length integer, returning its size.
+uint32_t writeVarlong(uint8_t* dst, int64_t value) {
+  uint64_t raw = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+  uint32_t length = 0;
+  while (raw >= 0x80) {
+    dst[length++] = static_cast<uint8_t>(raw | 0x80);
+    raw >>= 7;
+  }
+  dst[length++] = static_cast<uint8_t>(raw);
+  return length;
+}
+
+} // namespace
+
+uint32_t crc32c(absl::string_view data, uint32_t previous) {
+  const std::array<uint32_t, 256>& table = crc32cTable();
+  uint32_t crc = ~previous;
+  for (const char c : data) {
+    crc = table[(crc ^ static_cast<uint8_t>(c)) & 0xff] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+absl::optional<int32_t> RecordBatchMerger::add(absl::string_view batch) {
+  if (batch.size() < HeaderSize ||
+      readBigEndian<int32_t>(batch, BatchLengthOffset) !=
+          static_cast<int64_t>(batch.size() - PartitionLeaderEpochOffset) ||
+      static_cast<int8_t>(batch[MagicOffset]) != CurrentMagic ||
+      (readBigEndian<int16_t>(batch, AttributesOffset) & UnmergeableAttributes) != 0 ||
+      readBigEndian<int64_t>(batch, ProducerIdOffset) != -1 ||
+      readBigEndian<uint32_t>(batch, CrcOffset) != crc32c(batch.substr(AttributesOffset))) {
+    return absl::nullopt;
+  }
+
+  const int64_t first_timestamp = readBigEndian<int64_t>(batch, FirstTimestampOffset);
+  const int32_t count = readBigEndian<int32_t>(batch, RecordCountOffset);
+  if (count <= 0 || count > std::numeric_limits<int32_t>::max() - record_count_) {
+    return absl::nullopt;
+  }
+  // The timestamps of the merged records are relative to the ones of the first batch.
+  const int64_t base_timestamp = record_count_ == 0 ? first_timestamp : first_timestamp_;
+  int64_t max_timestamp = std::numeric_limits<int64_t>::min();
+
+  // Each record starts with its length, attributes, timestamp delta and offset delta, followed by
+  // its key, value and headers that are kept as they are.
+  Buffer::OwnedImpl rewritten;
+  absl::string_view records = batch.substr(HeaderSize);
+  for (int32_t i = 0; i < count; ++i) {
+    int32_t length;
+    if (!readVarint(records, length) || length < 1 ||
+        static_cast<uint64_t>(length) > records.size()) {
+      return absl::nullopt;
+    }
+    absl::string_view record = records.substr(0, length);
+    records.remove_prefix(length);
+
+    const uint8_t attributes = record[0];
+    record.remove_prefix(1);
+    int64_t timestamp_delta;
+    int32_t offset_delta;
+    if (!readVarlong(record, timestamp_delta) || !readVarint(record, offset_delta) ||
+        offset_delta != i) {
+      return absl::nullopt;
+    }
+    const int64_t timestamp = first_timestamp + timestamp_delta;
+    max_timestamp = std::max(max_timestamp, timestamp);
+
+    uint8_t prefix[1 + 2 * MaxVarlongSize];
+    uint32_t prefix_size = 0;
+    prefix[prefix_size++] = attributes;
+    prefix_size += writeVarlong(prefix + prefix_size, timestamp - base_timestamp);
+    prefix_size += writeVarlong(prefix + prefix_size, record_count_ + i);
+    uint8_t new_length[MaxVarlongSize];
+    rewritten.add(new_length, writeVarlong(new_length, prefix_size + record.size()));
+    rewritten.add(prefix, prefix_size);
+    rewritten.add(record.data(), record.size());
+  }
+  if (!records.empty()) {
+    return absl::nullopt;
+  }
+
+  const int32_t first_record = record_count_;
+  if (record_count_ == 0) {
+    first_timestamp_ = first_timestamp;
+    max_timestamp_ = max_timestamp;
+  } else {
+    max_timestamp_ = std::max(max_timestamp_, max_timestamp);
+  }
+  record_count_ += count;
+  records_.move(rewritten);
+  return first_record;
+}
+
+Bytes RecordBatchMerger::build() const {
+  ASSERT(record_count_ > 0);
+  Bytes result(size());
+  unsigned char* dst = result.data();
+  writeBigEndian<int64_t>(dst + BaseOffsetOffset, 0);
+  writeBigEndian<int32_t>(dst + BatchLengthOffset, result.size() - PartitionLeaderEpochOffset);
+  writeBigEndian<int32_t>(dst + PartitionLeaderEpochOffset, -1);
+  dst[MagicOffset] = CurrentMagic;
+  writeBigEndian<int16_t>(dst + AttributesOffset, 0);
+  writeBigEndian<int32_t>(dst + LastOffsetDeltaOffset, record_count_ - 1);
+  writeBigEndian<int64_t>(dst + FirstTimestampOffset, first_timestamp_);
+  writeBigEndian<int64_t>(dst + MaxTimestampOffset, max_timestamp_);
+  writeBigEndian<int64_t>(dst + ProducerIdOffset, -1);
+  writeBigEndian<int16_t>(dst + ProducerEpochOffset, -1);
+  writeBigEndian<int32_t>(dst + BaseSequenceOffset, -1);
+  writeBigEndian<int32_t>(dst + RecordCountOffset, record_count_);
+  records_.copyOut(0, records_.length(), dst + HeaderSize);
+
+  // The checksum covers everything from the attributes to the end of the batch.
+  const absl::string_view checksummed{reinterpret_cast<const char*>(dst + AttributesOffset),
+                                      result.size() - AttributesOffset};
+  writeBigEndian<uint32_t>(dst + CrcOffset, crc32c(checksummed));
+  return result;
+}
+
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
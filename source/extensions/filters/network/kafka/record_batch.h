@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/network/kafka/kafka_types.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+
+/**
+ * Computes the CRC-32C (Castagnoli) checksum of given data, as used by record batches.
+ * @param data data to compute the checksum of.
+ * @param previous checksum of the data preceding the given one, if it is computed in parts.
+ * @return checksum of the data.
+ */
+uint32_t crc32c(absl::string_view data, uint32_t previous = 0);
+
+/**
+ * Merges record batches into a single one, so that the records sent to a partition by multiple
+ * produce requests can be written by the broker at once.
+ * Only the batches that can be rewritten without changing their meaning are merged, i.e. the v2
+ * (magic 2) batches that are uncompressed, use create time timestamps, and were not written by
+ * idempotent or transactional producers.
+ * @see http://kafka.apache.org/documentation/#recordbatch
+ */
+class RecordBatchMerger {
+public:
+  // Size of the record batch header, that precedes the records.
+  static constexpr uint32_t HeaderSize = 61;
+
+  /**
+   * Appends the records of given record batch to the merged batch.
+   * The batch is validated (including its checksum), so a malformed batch is never merged.
+   * @param batch bytes of a single record batch.
+   * @return index of the first record of the batch in the merged batch, or absl::nullopt if the
+   * batch cannot be merged (in which case the merged batch is unchanged).
+   */
+  absl::optional<int32_t> add(absl::string_view batch);
+
+  /**
+   * @return number of records in the merged batch.
+   */
+  int32_t recordCount() const { return record_count_; }
+
+  /**
+   * @return size of the merged batch.
+   */
+  uint64_t size() const { return HeaderSize + records_.length(); }
+
+  /**
+   * Serializes the merged batch. Must only be invoked after a batch has been added.
+   * @return bytes of the merged batch.
+   */
+  Bytes build() const;
+
+private:
+  // The records of the batches added, with their offset and timestamp deltas rewritten to be
+  // relative to the merged batch.
+  Buffer::OwnedImpl records_;
+  int32_t record_count_{0};
+  int64_t first_timestamp_{0};
+  int64_t max_timestamp_{0};
+};
+
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -573,6 +573,41 @@ const Field* DocumentImpl::find(const std::string& name, Field::Type type) const
   return nullptr;
 }
 
+DocumentSharedPtr LazyDocumentImpl::create(Buffer::Instance& data) {
+  // Minimum size is 5, for the length and the terminating null byte.
+  const int32_t length = BufferHelper::peekInt32(data);
+  if (length < static_cast<int32_t>(sizeof(int32_t) + 1) ||
+      static_cast<uint64_t>(length) > data.length()) {
+    throw EnvoyException("invalid BSON message length");
+  }
+
+  std::shared_ptr<LazyDocumentImpl> new_doc{new LazyDocumentImpl()};
+  new_doc->encoded_.move(data, length);
+  return new_doc;
+}
+
+int32_t LazyDocumentImpl::byteSize() const {
+  return decoded_ ? decoded_->byteSize() : static_cast<int32_t>(encoded_.length());
+}
+
+void LazyDocumentImpl::encode(Buffer::Instance& output) const {
+  if (decoded_) {
+    decoded_->encode(output);
+  } else {
+    output.add(encoded_);
+  }
+}
+
+Document& LazyDocumentImpl::decoded() const {
+  if (!decoded_) {
+    // The encoded document is kept until it is decoded successfully.
+    Buffer::OwnedImpl encoded{encoded_};
+    decoded_ = DocumentImpl::create(encoded);
+    encoded_.drain(encoded_.length());
+  }
+  return *decoded_;
+}
+
 } // namespace Bson
 } // namespace MongoProxy
 } // namespace NetworkFilters
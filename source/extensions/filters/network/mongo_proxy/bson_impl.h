@@ -7,6 +7,7 @@
 #include "envoy/buffer/buffer.h"
 #include "envoy/common/exception.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/logger.h"
 #include "source/common/common/utility.h"
 #include "source/extensions/filters/network/mongo_proxy/bson.h"
@@ -275,6 +276,112 @@ private:
   std::list<FieldPtr> fields_;
 };
 
+/**
+ * Document that keeps its encoded bytes, and is only decoded when its fields are first accessed.
+ * Its size is known without decoding it, so the documents that are only counted and measured
+ * (such as the ones inserted or returned by queries) are never decoded. As a consequence, such a
+ * malformed document is only detected if its fields are accessed.
+ */
+class LazyDocumentImpl : public Document, public std::enable_shared_from_this<LazyDocumentImpl> {
+public:
+  static DocumentSharedPtr create(Buffer::Instance& data);
+
+  // Mongo::Document
+  DocumentSharedPtr addDouble(const std::string& key, double value) override {
+    decoded().addDouble(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addString(const std::string& key, std::string&& value) override {
+    decoded().addString(key, std::move(value));
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addSymbol(const std::string& key, std::string&& value) override {
+    decoded().addSymbol(key, std::move(value));
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addDocument(const std::string& key, DocumentSharedPtr value) override {
+    decoded().addDocument(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addArray(const std::string& key, DocumentSharedPtr value) override {
+    decoded().addArray(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addBinary(const std::string& key, std::string&& value) override {
+    decoded().addBinary(key, std::move(value));
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addObjectId(const std::string& key, Field::ObjectId&& value) override {
+    decoded().addObjectId(key, std::move(value));
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addBoolean(const std::string& key, bool value) override {
+    decoded().addBoolean(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addDatetime(const std::string& key, int64_t value) override {
+    decoded().addDatetime(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addNull(const std::string& key) override {
+    decoded().addNull(key);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addRegex(const std::string& key, Field::Regex&& value) override {
+    decoded().addRegex(key, std::move(value));
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addInt32(const std::string& key, int32_t value) override {
+    decoded().addInt32(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addTimestamp(const std::string& key, int64_t value) override {
+    decoded().addTimestamp(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addInt64(const std::string& key, int64_t value) override {
+    decoded().addInt64(key, value);
+    return shared_from_this();
+  }
+
+  bool operator==(const Document& rhs) const override { return decoded() == rhs; }
+  int32_t byteSize() const override;
+  void encode(Buffer::Instance& output) const override;
+  const Field* find(const std::string& name) const override { return decoded().find(name); }
+  const Field* find(const std::string& name, Field::Type type) const override {
+    return decoded().find(name, type);
+  }
+  std::string toString() const override { return decoded().toString(); }
+  const std::list<FieldPtr>& values() const override { return decoded().values(); }
+
+  /**
+   * @return whether the document has been decoded.
+   */
+  bool isDecoded() const { return decoded_ != nullptr; }
+
+private:
+  LazyDocumentImpl() = default;
+
+  Document& decoded() const;
+
+  // The encoded document, until it gets decoded.
+  mutable Buffer::OwnedImpl encoded_;
+  mutable DocumentSharedPtr decoded_;
+};
+
 } // namespace Bson
 } // namespace MongoProxy
 } // namespace NetworkFilters
@@ -67,7 +67,7 @@ void InsertMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instance& da
   flags_ = Bson::BufferHelper::removeInt32(data);
   full_collection_name_ = Bson::BufferHelper::removeCString(data);
   while (data.length() - (original_buffer_length - message_length) > 0) {
-    documents_.emplace_back(Bson::DocumentImpl::create(data));
+    documents_.emplace_back(Bson::LazyDocumentImpl::create(data));
   }
 
   ENVOY_LOG(trace, "{}", toString(true));
@@ -189,7 +189,7 @@ void ReplyMessageImpl::fromBuffer(uint32_t, Buffer::Instance& data) {
   starting_from_ = Bson::BufferHelper::removeInt32(data);
   number_returned_ = Bson::BufferHelper::removeInt32(data);
   for (int32_t i = 0; i < number_returned_; i++) {
-    documents_.emplace_back(Bson::DocumentImpl::create(data));
+    documents_.emplace_back(Bson::LazyDocumentImpl::create(data));
   }
 
   ENVOY_LOG(trace, "{}", toString(true));
@@ -238,7 +238,7 @@ void CommandMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instance& d
   // message_length is mongo message length. original_data_length contains
   // mongo message and possibly first few bytes of next message.
   while (data.length() - (original_data_length - message_length) > 0) {
-    input_docs_.emplace_back(Bson::DocumentImpl::create(data));
+    input_docs_.emplace_back(Bson::LazyDocumentImpl::create(data));
   }
 
   ENVOY_LOG(trace, "{}", toString(true));
@@ -298,7 +298,7 @@ void CommandReplyMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instan
   // message_length is mongo message length. original_data_length contains
   // mongo message and possibly first few bytes of next message.
   while (data.length() - (original_data_length - message_length) > 0) {
-    output_docs_.emplace_back(Bson::DocumentImpl::create(data));
+    output_docs_.emplace_back(Bson::LazyDocumentImpl::create(data));
   }
 
   ENVOY_LOG(trace, "{}", toString(true));
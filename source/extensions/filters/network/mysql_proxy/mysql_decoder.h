@@ -38,7 +38,12 @@ class Decoder {
 public:
   virtual ~Decoder() = default;
 
-  virtual void onData(Buffer::Instance& data) PURE;
+  /**
+   * Decodes the packets in a buffer, and drains them.
+   * @param data the buffered data of one direction of the connection.
+   * @param from_server whether the data is sent by the server.
+   */
+  virtual void onData(Buffer::Instance& data, bool from_server) PURE;
   virtual MySQLSession& getSession() PURE;
 
   const Extensions::Common::SQLUtils::SQLUtils::DecoderAttributes& getAttributes() const {
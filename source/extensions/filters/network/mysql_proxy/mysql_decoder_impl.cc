@@ -1,5 +1,7 @@
 #include "source/extensions/filters/network/mysql_proxy/mysql_decoder_impl.h"
 
+#include <algorithm>
+
 #include "source/common/common/logger.h"
 #include "source/extensions/filters/network/mysql_proxy/mysql_codec.h"
 #include "source/extensions/filters/network/mysql_proxy/mysql_codec_clogin_resp.h"
@@ -167,7 +169,7 @@ void DecoderImpl::parseMessage(Buffer::Instance& message, uint8_t seq, uint32_t
             static_cast<int>(session_.getState()));
 }
 
-bool DecoderImpl::decode(Buffer::Instance& data) {
+bool DecoderImpl::decode(Buffer::Instance& data, uint32_t& bytes_to_skip) {
   ENVOY_LOG(trace, "mysql_proxy: decoding {} bytes", data.length());
   uint32_t len = 0;
   uint8_t seq = 0;
@@ -178,10 +180,29 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
     return true;
   }
 
+  // Drop the rest of a skipped packet.
+  if (bytes_to_skip > 0) {
+    skipMessage(data, bytes_to_skip);
+    return true;
+  }
+
   if (BufferHelper::peekHdr(data, len, seq) != DecodeStatus::Success) {
     throw EnvoyException("error parsing mysql packet header");
   }
   ENVOY_LOG(trace, "mysql_proxy: seq {}, len {}", seq, len);
+
+  // Ignore duplicate and out-of-sync packets, such as the rows of result sets. They are not
+  // parsed, so they are dropped as they arrive rather than buffered.
+  if (seq != session_.getExpectedSeq()) {
+    BufferHelper::consumeHdr(data);
+    callbacks_.onNewMessage(session_.getState());
+    callbacks_.onProtocolError();
+    ENVOY_LOG(info, "mysql_proxy: ignoring out-of-sync packet");
+    bytes_to_skip = len;
+    skipMessage(data, bytes_to_skip);
+    return true;
+  }
+
   // If message is split over multiple packets, hold off until the entire message is available.
   // Consider the size of the header here as it's not consumed yet.
   if (sizeof(uint32_t) + len > data.length()) {
@@ -190,14 +211,6 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
 
   BufferHelper::consumeHdr(data); // Consume the header once the message is fully available.
   callbacks_.onNewMessage(session_.getState());
-
-  // Ignore duplicate and out-of-sync packets.
-  if (seq != session_.getExpectedSeq()) {
-    callbacks_.onProtocolError();
-    ENVOY_LOG(info, "mysql_proxy: ignoring out-of-sync packet");
-    data.drain(len); // Ensure that the whole message was consumed
-    return true;
-  }
   session_.setExpectedSeq(seq + 1);
 
   const ssize_t data_len = data.length();
@@ -209,10 +222,18 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
   return true;
 }
 
-void DecoderImpl::onData(Buffer::Instance& data) {
+void DecoderImpl::skipMessage(Buffer::Instance& data, uint32_t& bytes_to_skip) {
+  const uint32_t len = std::min<uint64_t>(data.length(), bytes_to_skip);
+  data.drain(len);
+  bytes_to_skip -= len;
+  ENVOY_LOG(trace, "mysql_proxy: skipped {} bytes, {} bytes to skip", len, bytes_to_skip);
+}
+
+void DecoderImpl::onData(Buffer::Instance& data, bool from_server) {
+  uint32_t& bytes_to_skip = from_server ? server_bytes_to_skip_ : client_bytes_to_skip_;
   // TODO(venilnoronha): handle messages over 16 mb. See
   // https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_basic_packets.html#sect_protocol_basic_packets_sending_mt_16mb.
-  while (!BufferHelper::endOfBuffer(data) && decode(data)) {
+  while (!BufferHelper::endOfBuffer(data) && decode(data, bytes_to_skip)) {
   }
 }
 
@@ -11,15 +11,19 @@ public:
   DecoderImpl(DecoderCallbacks& callbacks) : callbacks_(callbacks) {}
 
   // MySQLProxy::Decoder
-  void onData(Buffer::Instance& data) override;
+  void onData(Buffer::Instance& data, bool from_server) override;
   MySQLSession& getSession() override { return session_; }
 
 private:
-  bool decode(Buffer::Instance& data);
+  bool decode(Buffer::Instance& data, uint32_t& bytes_to_skip);
+  void skipMessage(Buffer::Instance& data, uint32_t& bytes_to_skip);
   void parseMessage(Buffer::Instance& message, uint8_t seq, uint32_t len);
 
   DecoderCallbacks& callbacks_;
   MySQLSession session_;
+  // Number of bytes of the packet being skipped which have not arrived yet, by direction.
+  uint32_t client_bytes_to_skip_{};
+  uint32_t server_bytes_to_skip_{};
 };
 
 class DecoderFactoryImpl : public DecoderFactory {
@@ -90,7 +90,7 @@ public:
   void onCommand(Command& message) override;
   void onCommandResponse(CommandResponse&) override{};
 
-  void doDecode(Buffer::Instance& buffer);
+  void doDecode(Buffer::Instance& buffer, bool from_server);
   DecoderPtr createDecoder(DecoderCallbacks& callbacks);
   MySQLSession& getSession() { return decoder_->getSession(); }
 
@@ -1,5 +1,6 @@
 #include "source/extensions/filters/network/postgres_proxy/postgres_decoder.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "absl/strings/str_split.h"
@@ -50,6 +51,9 @@ void DecoderImpl::initialize() {
   FE_known_msgs['X'] =
       MessageProcessor{"Terminate", NO_BODY, {&DecoderImpl::decodeFrontendTerminate}};
 
+  // Frontend bulk data messages.
+  FE_messages_.skipped_ = {'d'};
+
   // Handler for unknown Frontend messages.
   FE_messages_.unknown_ =
       MessageProcessor{"Other", BODY_FORMAT(ByteN), {&DecoderImpl::incMessagesUnknown}};
@@ -94,6 +98,9 @@ void DecoderImpl::initialize() {
       BODY_FORMAT(Array<Sequence<String, Int32, Int16, Int32, Int16, Int32, Int16>>),
       {}};
 
+  // Backend bulk data messages.
+  BE_messages_.skipped_ = {'D', 'd'};
+
   // Handler for unknown Backend messages.
   BE_messages_.unknown_ =
       MessageProcessor{"Other", BODY_FORMAT(ByteN), {&DecoderImpl::incMessagesUnknown}};
@@ -315,6 +322,14 @@ void DecoderImpl::processMessageBody(Buffer::Instance& data, absl::string_view d
 Decoder::Result DecoderImpl::onDataInSync(Buffer::Instance& data, bool frontend) {
   ENVOY_LOG(trace, "postgres_proxy: decoding {} bytes", data.length());
 
+  MsgGroup& msg_processor = std::ref(frontend ? FE_messages_ : BE_messages_);
+
+  // Drop the rest of the body of a skipped message.
+  if (msg_processor.bytes_to_skip_ > 0) {
+    skipMessageBody(data, msg_processor);
+    return Decoder::Result::ReadyForNext;
+  }
+
   ENVOY_LOG(trace, "postgres_proxy: parsing message, len {}", data.length());
 
   // The minimum size of the message sufficient for parsing is 5 bytes.
@@ -329,7 +344,6 @@ Decoder::Result DecoderImpl::onDataInSync(Buffer::Instance& data, bool frontend)
   // The 1 byte message type and message length should be in the buffer
   // Find the message processor and validate the message syntax.
 
-  MsgGroup& msg_processor = std::ref(frontend ? FE_messages_ : BE_messages_);
   frontend ? callbacks_->incMessagesFrontend() : callbacks_->incMessagesBackend();
 
   // Set processing to the handler of unknown messages.
@@ -344,6 +358,18 @@ Decoder::Result DecoderImpl::onDataInSync(Buffer::Instance& data, bool frontend)
   // Validate the message before processing.
   const MsgBodyReader& f = std::get<1>(msg.get());
   message_len_ = data.peekBEInt<uint32_t>(1);
+
+  // Bulk data messages are not inspected, their body is dropped without waiting for all of it.
+  if (message_len_ >= 4 && msg_processor.skipped_.contains(command_)) {
+    ENVOY_LOG(debug, "({}) command = {} ({})", msg_processor.direction_, command_,
+              std::get<0>(msg.get()));
+    ENVOY_LOG(debug, "({}) length = {}", msg_processor.direction_, message_len_);
+    data.drain(5);
+    msg_processor.bytes_to_skip_ = message_len_ - 4;
+    skipMessageBody(data, msg_processor);
+    return Decoder::Result::ReadyForNext;
+  }
+
   const auto msgParser = f();
   // Run the validation.
   // Because the message validation may return NeedMoreData error, data must stay intact (no
@@ -373,6 +399,15 @@ Decoder::Result DecoderImpl::onDataInSync(Buffer::Instance& data, bool frontend)
 
   return Decoder::Result::ReadyForNext;
 }
+
+void DecoderImpl::skipMessageBody(Buffer::Instance& data, MsgGroup& msg_processor) {
+  const uint64_t length = std::min(data.length(), msg_processor.bytes_to_skip_);
+  data.drain(length);
+  msg_processor.bytes_to_skip_ -= length;
+  ENVOY_LOG(trace, "postgres_proxy: skipped {} bytes, {} bytes to skip", length,
+            msg_processor.bytes_to_skip_);
+}
+
 /*
   onDataIgnore method is called when the decoder does not inspect passing
   messages. This happens when the decoder detected encrypted packets or
@@ -10,6 +10,7 @@
 #include "source/extensions/filters/network/postgres_proxy/postgres_session.h"
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -98,6 +99,7 @@ protected:
   Result onDataInit(Buffer::Instance& data, bool frontend);
   Result onDataInSync(Buffer::Instance& data, bool frontend);
   Result onDataIgnore(Buffer::Instance& data, bool frontend);
+  void skipMessageBody(Buffer::Instance& data, MsgGroup& msg_processor);
 
   // MsgAction defines the Decoder's method which will be invoked
   // when a specific message has been decoded.
@@ -124,6 +126,11 @@ protected:
     absl::flat_hash_map<char, MessageProcessor> messages_;
     // Handler used for processing messages not found in hash map.
     MessageProcessor unknown_;
+    // Bulk data messages, which are counted from their header and then skipped as their body
+    // arrives, so that large result sets and copies are not buffered.
+    absl::flat_hash_set<char> skipped_;
+    // Number of bytes of the body of a skipped message which have not arrived yet.
+    uint64_t bytes_to_skip_{};
   };
 
   // Hash map binding keyword found in a message to an
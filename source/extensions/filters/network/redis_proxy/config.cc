@@ -79,7 +79,7 @@ Network::FilterFactoryCb RedisProxyFilterConfigFactory::createFilterFactoryFromP
     auto conn_pool_ptr = std::make_shared<ConnPool::InstanceImpl>(
         cluster, context.clusterManager(), Common::Redis::Client::ClientFactoryImpl::instance_,
         context.threadLocal(), proto_config.settings(), context.api(), std::move(stats_scope),
-        redis_command_stats, refresh_manager);
+        redis_command_stats, refresh_manager, context.localInfo());
     conn_pool_ptr->init();
     upstreams.emplace(cluster, conn_pool_ptr);
   }
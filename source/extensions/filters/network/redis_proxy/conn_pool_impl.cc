@@ -13,9 +13,12 @@
 
 #include "source/common/common/assert.h"
 #include "source/common/common/logger.h"
+#include "source/common/common/utility.h"
 #include "source/common/stats/utility.h"
 #include "source/extensions/filters/network/redis_proxy/config.h"
 
+#include "absl/strings/numbers.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -35,6 +38,23 @@ const Common::Redis::RespValue& getRequest(const RespVariant& request) {
 }
 } // namespace
 
+absl::optional<double> HostLatencyTrackerImpl::latency(const Upstream::Host& host) const {
+  auto it = latencies_.find(&host);
+  if (it == latencies_.end()) {
+    return absl::nullopt;
+  }
+  return it->second;
+}
+
+void HostLatencyTrackerImpl::onResponseTime(const Upstream::Host& host,
+                                            std::chrono::microseconds response_time) {
+  const double sample = response_time.count();
+  auto result = latencies_.try_emplace(&host, sample);
+  if (!result.second) {
+    result.first->second += ResponseTimeWeight * (sample - result.first->second);
+  }
+}
+
 InstanceImpl::InstanceImpl(
     const std::string& cluster_name, Upstream::ClusterManager& cm,
     Common::Redis::Client::ClientFactory& client_factory, ThreadLocal::SlotAllocator& tls,
@@ -42,13 +62,17 @@ InstanceImpl::InstanceImpl(
         config,
     Api::Api& api, Stats::ScopePtr&& stats_scope,
     const Common::Redis::RedisCommandStatsSharedPtr& redis_command_stats,
-    Extensions::Common::Redis::ClusterRefreshManagerSharedPtr refresh_manager)
+    Extensions::Common::Redis::ClusterRefreshManagerSharedPtr refresh_manager,
+    const LocalInfo::LocalInfo& local_info)
     : cluster_name_(cluster_name), cm_(cm), client_factory_(client_factory),
       tls_(tls.allocateSlot()), config_(new Common::Redis::Client::ConfigImpl(config)), api_(api),
       stats_scope_(std::move(stats_scope)),
       redis_command_stats_(redis_command_stats), redis_cluster_stats_{REDIS_CLUSTER_STATS(
                                                      POOL_COUNTER(*stats_scope_))},
-      refresh_manager_(std::move(refresh_manager)) {}
+      refresh_manager_(std::move(refresh_manager)),
+      least_latency_replica_selection_(config.replica_selection().least_latency()),
+      preferred_zone_(config.replica_selection().prefer_local_zone() ? local_info.zoneName()
+                                                                     : "") {}
 
 void InstanceImpl::init() {
   // Note: `this` and `cluster_name` have a a lifetime of the filter.
@@ -89,7 +113,9 @@ InstanceImpl::ThreadLocalPool::ThreadLocalPool(std::shared_ptr<InstanceImpl> par
       is_redis_cluster_(false), client_factory_(parent->client_factory_), config_(parent->config_),
       stats_scope_(parent->stats_scope_), redis_command_stats_(parent->redis_command_stats_),
       redis_cluster_stats_(parent->redis_cluster_stats_),
-      refresh_manager_(parent->refresh_manager_) {
+      refresh_manager_(parent->refresh_manager_),
+      least_latency_replica_selection_(parent->least_latency_replica_selection_),
+      preferred_zone_(parent->preferred_zone_) {
   cluster_update_handle_ = parent->cm_.addThreadLocalClusterUpdateCallbacks(*this);
   Upstream::ThreadLocalCluster* cluster = parent->cm_.getThreadLocalCluster(cluster_name_);
   if (cluster != nullptr) {
@@ -172,6 +198,7 @@ void InstanceImpl::ThreadLocalPool::onClusterRemoval(const std::string& cluster_
 
   cluster_ = nullptr;
   host_address_map_.clear();
+  host_latencies_.clear();
 }
 
 void InstanceImpl::ThreadLocalPool::onHostsAdded(
@@ -215,6 +242,7 @@ void InstanceImpl::ThreadLocalPool::onHostsRemoved(
     if ((it2 != host_address_map_.end()) && (it2->second == host)) {
       host_address_map_.erase(it2);
     }
+    host_latencies_.removeHost(*host);
   }
 }
 
@@ -250,9 +278,10 @@ InstanceImpl::ThreadLocalPool::makeRequest(const std::string& key, RespVariant&&
     return nullptr;
   }
 
-  Clusters::Redis::RedisLoadBalancerContextImpl lb_context(key, config_->enableHashtagging(),
-                                                           is_redis_cluster_, getRequest(request),
-                                                           config_->readPolicy());
+  Clusters::Redis::RedisLoadBalancerContextImpl lb_context(
+      key, config_->enableHashtagging(), is_redis_cluster_, getRequest(request),
+      config_->readPolicy(), least_latency_replica_selection_ ? &host_latencies_ : nullptr,
+      preferred_zone_);
   Upstream::HostConstSharedPtr host = cluster_->loadBalancer().chooseHost(&lb_context);
   if (!host) {
     ENVOY_LOG(debug, "host not found: '{}'", key);
@@ -260,6 +289,10 @@ InstanceImpl::ThreadLocalPool::makeRequest(const std::string& key, RespVariant&&
   }
   pending_requests_.emplace_back(*this, std::move(request), callbacks);
   PendingRequest& pending_request = pending_requests_.back();
+  if (least_latency_replica_selection_) {
+    pending_request.measured_host_ = host;
+    pending_request.start_time_ = dispatcher_.timeSource().monotonicTime();
+  }
   ThreadLocalActiveClientPtr& client = this->threadLocalActiveClient(host);
   pending_request.request_handler_ = client->redis_client_->makeRequest(
       getRequest(pending_request.incoming_request_), pending_request);
@@ -392,6 +425,11 @@ InstanceImpl::PendingRequest::~PendingRequest() {
 
 void InstanceImpl::PendingRequest::onResponse(Common::Redis::RespValuePtr&& response) {
   request_handler_ = nullptr;
+  if (measured_host_ != nullptr) {
+    parent_.host_latencies_.onResponseTime(
+        *measured_host_, std::chrono::duration_cast<std::chrono::microseconds>(
+                             parent_.dispatcher_.timeSource().monotonicTime() - start_time_));
+  }
   pool_callbacks_.onResponse(std::move(response));
   parent_.onRequestCompleted();
 }
@@ -417,12 +455,24 @@ bool InstanceImpl::PendingRequest::onRedirection(Common::Redis::RespValuePtr&& v
     onResponse(std::move(value));
     return false;
   }
+  // The response time of a redirected request is not the one of the host it was sent to.
+  measured_host_ = nullptr;
   request_handler_ = parent_.makeRequestToHost(host_address, getRequest(incoming_request_), *this);
   if (!request_handler_) {
     onResponse(std::move(value));
     return false;
   } else {
     parent_.refresh_manager_->onRedirection(parent_.cluster_name_);
+    if (!ask_redirection) {
+      // A MOVED redirection error has the slot of the key as its second substring, see
+      // Common::Redis::Client::ClientImpl::onRespValue().
+      const std::vector<absl::string_view> err =
+          StringUtil::splitToken(value->asString(), " ", false);
+      uint64_t slot;
+      if (err.size() == 3 && absl::SimpleAtoi(err[1], &slot) && slot < Clusters::Redis::MaxSlot) {
+        parent_.refresh_manager_->onSlotMoved(parent_.cluster_name_, slot, host_address);
+      }
+    }
     return true;
   }
 }
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "envoy/extensions/filters/network/redis_proxy/v3/redis_proxy.pb.h"
+#include "envoy/local_info/local_info.h"
 #include "envoy/stats/stats_macros.h"
 #include "envoy/thread_local/thread_local.h"
 #include "envoy/upstream/cluster_manager.h"
@@ -27,6 +28,7 @@
 #include "source/extensions/filters/network/common/redis/utility.h"
 #include "source/extensions/filters/network/redis_proxy/conn_pool.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 
 namespace Envoy {
@@ -52,6 +54,26 @@ public:
   void onFailure() override{};
 };
 
+/**
+ * Measures the latency of the upstream hosts of a worker as an exponentially weighted moving
+ * average of their response times.
+ */
+class HostLatencyTrackerImpl : public Clusters::Redis::HostLatencyTracker {
+public:
+  // The weight of a response time in the average.
+  static constexpr double ResponseTimeWeight = 0.2;
+
+  // Clusters::Redis::HostLatencyTracker
+  absl::optional<double> latency(const Upstream::Host& host) const override;
+
+  void onResponseTime(const Upstream::Host& host, std::chrono::microseconds response_time);
+  void removeHost(const Upstream::Host& host) { latencies_.erase(&host); }
+  void clear() { latencies_.clear(); }
+
+private:
+  absl::flat_hash_map<const Upstream::Host*, double> latencies_;
+};
+
 class InstanceImpl : public Instance, public std::enable_shared_from_this<InstanceImpl> {
 public:
   InstanceImpl(
@@ -61,7 +83,8 @@ public:
           config,
       Api::Api& api, Stats::ScopePtr&& stats_scope,
       const Common::Redis::RedisCommandStatsSharedPtr& redis_command_stats,
-      Extensions::Common::Redis::ClusterRefreshManagerSharedPtr refresh_manager);
+      Extensions::Common::Redis::ClusterRefreshManagerSharedPtr refresh_manager,
+      const LocalInfo::LocalInfo& local_info);
   // RedisProxy::ConnPool::Instance
   Common::Redis::Client::PoolRequest* makeRequest(const std::string& key, RespVariant&& request,
                                                   PoolCallbacks& callbacks) override;
@@ -121,6 +144,9 @@ private:
     const RespVariant incoming_request_;
     Common::Redis::Client::PoolRequest* request_handler_;
     PoolCallbacks& pool_callbacks_;
+    // The host whose response time is measured, if any.
+    Upstream::HostConstSharedPtr measured_host_;
+    MonotonicTime start_time_;
   };
 
   struct ThreadLocalPool : public ThreadLocal::ThreadLocalObject,
@@ -177,6 +203,9 @@ private:
     Common::Redis::RedisCommandStatsSharedPtr redis_command_stats_;
     RedisClusterStats redis_cluster_stats_;
     const Extensions::Common::Redis::ClusterRefreshManagerSharedPtr refresh_manager_;
+    const bool least_latency_replica_selection_;
+    const std::string preferred_zone_;
+    HostLatencyTrackerImpl host_latencies_;
   };
 
   const std::string cluster_name_;
@@ -189,6 +218,9 @@ private:
   Common::Redis::RedisCommandStatsSharedPtr redis_command_stats_;
   RedisClusterStats redis_cluster_stats_;
   const Extensions::Common::Redis::ClusterRefreshManagerSharedPtr refresh_manager_;
+  const bool least_latency_replica_selection_;
+  // The zone of the replicas preferred for the read commands, if any.
+  const std::string preferred_zone_;
 };
 
 } // namespace ConnPool
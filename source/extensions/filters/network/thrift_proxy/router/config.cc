@@ -3,6 +3,7 @@
 #include "envoy/extensions/filters/network/thrift_proxy/router/v3/router.pb.h"
 #include "envoy/extensions/filters/network/thrift_proxy/router/v3/router.pb.validate.h"
 #include "envoy/registry/registry.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "source/extensions/filters/network/thrift_proxy/router/router_impl.h"
 
@@ -15,11 +16,20 @@ namespace Router {
 ThriftFilters::FilterFactoryCb RouterFilterConfig::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::network::thrift_proxy::router::v3::Router& proto_config,
     const std::string& stat_prefix, Server::Configuration::FactoryContext& context) {
-  UNREFERENCED_PARAMETER(proto_config);
+  // Upstream connections are multiplexed by worker, across the downstream connections it handles.
+  std::shared_ptr<ThreadLocal::TypedSlot<ConnectionMultiplexer>> multiplexers;
+  if (proto_config.multiplex_upstream_connections()) {
+    multiplexers = ThreadLocal::TypedSlot<ConnectionMultiplexer>::makeUnique(context.threadLocal());
+    multiplexers->set([](Event::Dispatcher& dispatcher) {
+      return std::make_shared<ConnectionMultiplexer>(dispatcher);
+    });
+  }
 
-  return [&context, stat_prefix](ThriftFilters::FilterChainFactoryCallbacks& callbacks) -> void {
-    callbacks.addDecoderFilter(
-        std::make_shared<Router>(context.clusterManager(), stat_prefix, context.scope()));
+  return [&context, stat_prefix,
+          multiplexers](ThriftFilters::FilterChainFactoryCallbacks& callbacks) -> void {
+    ConnectionMultiplexer* multiplexer = multiplexers ? &**multiplexers : nullptr;
+    callbacks.addDecoderFilter(std::make_shared<Router>(context.clusterManager(), stat_prefix,
+                                                        context.scope(), multiplexer));
   };
 }
 
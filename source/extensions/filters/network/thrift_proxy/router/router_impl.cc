@@ -185,7 +185,12 @@ RouteConstSharedPtr RouteMatcher::route(const MessageMetadata& metadata,
 
 void Router::onDestroy() {
   if (upstream_request_ != nullptr) {
-    upstream_request_->resetStream();
+    if (upstream_request_->multiplexer_ != nullptr) {
+      // The connection is shared with other requests, the response is dropped when it arrives.
+      upstream_request_->releaseConnection(false);
+    } else {
+      upstream_request_->resetStream();
+    }
     cleanup();
   }
 }
@@ -300,8 +305,8 @@ FilterStatus Router::messageBegin(MessageMetadataSharedPtr metadata) {
     }
   }
 
-  upstream_request_ =
-      std::make_unique<UpstreamRequest>(*this, *conn_pool_data, metadata, transport, protocol);
+  upstream_request_ = std::make_unique<UpstreamRequest>(*this, *conn_pool_data, metadata, transport,
+                                                        protocol, multiplexer_);
   return upstream_request_->start();
 }
 
@@ -319,6 +324,10 @@ FilterStatus Router::messageEnd() {
   recordClusterScopeHistogram({upstream_rq_size_}, Stats::Histogram::Unit::Bytes, request_size_);
 
   upstream_request_->conn_data_->connection().write(transport_buffer, false);
+  if (upstream_request_->multiplexed_stream_ != nullptr &&
+      upstream_request_->metadata_->messageType() != MessageType::Oneway) {
+    upstream_request_->multiplexed_stream_->onRequestSent();
+  }
   upstream_request_->onRequestComplete();
   return FilterStatus::Continue;
 }
@@ -440,11 +449,16 @@ void Router::cleanup() { upstream_request_.reset(); }
 
 Router::UpstreamRequest::UpstreamRequest(Router& parent, Upstream::TcpPoolData& pool_data,
                                          MessageMetadataSharedPtr& metadata,
-                                         TransportType transport_type, ProtocolType protocol_type)
+                                         TransportType transport_type, ProtocolType protocol_type,
+                                         ConnectionMultiplexer* multiplexer)
     : parent_(parent), conn_pool_data_(pool_data), metadata_(metadata),
       transport_(NamedTransportConfigFactory::getFactory(transport_type).createTransport()),
       protocol_(NamedProtocolConfigFactory::getFactory(protocol_type).createProtocol()),
-      request_complete_(false), response_started_(false), response_complete_(false) {}
+      request_complete_(false), response_started_(false), response_complete_(false) {
+  if (multiplexer != nullptr && ConnectionMultiplexer::supports(transport_type, *protocol_)) {
+    multiplexer_ = multiplexer;
+  }
+}
 
 Router::UpstreamRequest::~UpstreamRequest() {
   if (conn_pool_handle_) {
@@ -453,7 +467,11 @@ Router::UpstreamRequest::~UpstreamRequest() {
 }
 
 FilterStatus Router::UpstreamRequest::start() {
-  Tcp::ConnectionPool::Cancellable* handle = conn_pool_data_.newConnection(*this);
+  Tcp::ConnectionPool::Cancellable* handle =
+      multiplexer_ != nullptr
+          ? multiplexer_->newConnection(conn_pool_data_, transport_->type(), protocol_->type(),
+                                        *this)
+          : conn_pool_data_.newConnection(*this);
   if (handle) {
     // Pause while we wait for a connection.
     conn_pool_handle_ = handle;
@@ -479,6 +497,7 @@ void Router::UpstreamRequest::releaseConnection(const bool close) {
   }
 
   conn_state_ = nullptr;
+  multiplexed_stream_ = nullptr;
 
   // The event triggered by close will also release this connection so clear conn_data_ before
   // closing.
@@ -511,6 +530,9 @@ void Router::UpstreamRequest::onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr
   conn_data_ = std::move(conn_data);
   conn_data_->addUpstreamCallbacks(parent_);
   conn_pool_handle_ = nullptr;
+  if (multiplexer_ != nullptr) {
+    multiplexed_stream_ = static_cast<MultiplexedStream*>(conn_data_.get());
+  }
 
   conn_state_ = conn_data_->connectionStateTyped<ThriftConnectionState>();
   if (conn_state_ == nullptr) {
@@ -552,6 +574,7 @@ void Router::UpstreamRequest::onResponseComplete() {
   chargeResponseTiming();
   response_complete_ = true;
   conn_state_ = nullptr;
+  multiplexed_stream_ = nullptr;
   conn_data_.reset();
 }
 
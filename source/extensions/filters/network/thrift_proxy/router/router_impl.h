@@ -18,6 +18,7 @@
 #include "source/extensions/filters/network/thrift_proxy/filters/filter.h"
 #include "source/extensions/filters/network/thrift_proxy/router/router.h"
 #include "source/extensions/filters/network/thrift_proxy/router/router_ratelimit_impl.h"
+#include "source/extensions/filters/network/thrift_proxy/router/upstream_multiplexer.h"
 #include "source/extensions/filters/network/thrift_proxy/thrift_object.h"
 
 #include "absl/types/optional.h"
@@ -176,8 +177,9 @@ class Router : public Tcp::ConnectionPool::UpstreamCallbacks,
                Logger::Loggable<Logger::Id::thrift> {
 public:
   Router(Upstream::ClusterManager& cluster_manager, const std::string& stat_prefix,
-         Stats::Scope& scope)
-      : cluster_manager_(cluster_manager), stats_(generateStats(stat_prefix, scope)),
+         Stats::Scope& scope, ConnectionMultiplexer* multiplexer)
+      : cluster_manager_(cluster_manager), multiplexer_(multiplexer),
+        stats_(generateStats(stat_prefix, scope)),
         stat_name_set_(scope.symbolTable().makeSet("thrift_proxy")),
         symbol_table_(scope.symbolTable()),
         upstream_rq_call_(stat_name_set_->add("thrift.upstream_rq_call")),
@@ -225,7 +227,7 @@ private:
   struct UpstreamRequest : public Tcp::ConnectionPool::Callbacks {
     UpstreamRequest(Router& parent, Upstream::TcpPoolData& pool_data,
                     MessageMetadataSharedPtr& metadata, TransportType transport_type,
-                    ProtocolType protocol_type);
+                    ProtocolType protocol_type, ConnectionMultiplexer* multiplexer);
     ~UpstreamRequest() override;
 
     FilterStatus start();
@@ -257,6 +259,9 @@ private:
     TransportPtr transport_;
     ProtocolPtr protocol_;
     ThriftObjectPtr upgrade_response_;
+    // Set if the request shares a multiplexed connection.
+    ConnectionMultiplexer* multiplexer_{};
+    MultiplexedStream* multiplexed_stream_{};
 
     bool request_complete_ : 1;
     bool response_started_ : 1;
@@ -289,6 +294,7 @@ private:
   }
 
   Upstream::ClusterManager& cluster_manager_;
+  ConnectionMultiplexer* const multiplexer_;
   RouterStats stats_;
   Stats::StatNameSetPtr stat_name_set_;
   Stats::SymbolTable& symbol_table_;
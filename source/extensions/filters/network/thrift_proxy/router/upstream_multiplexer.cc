@@ -0,0 +1,278 @@
+#include "source/extensions/filters/network/thrift_proxy/router/upstream_multiplexer.h"
+
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "source/extensions/filters/network/thrift_proxy/metadata.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace ThriftProxy {
+namespace Router {
+
+MultiplexedStream::MultiplexedStream(MultiplexedConnection& parent, int32_t sequence_id)
+    : parent_(parent), sequence_id_(sequence_id),
+      state_(std::make_unique<ThriftConnectionState>(sequence_id)) {}
+
+MultiplexedStream::~MultiplexedStream() { parent_.onStreamReleased(*this); }
+
+Network::ClientConnection& MultiplexedStream::connection() {
+  ASSERT(parent_.conn_data_ != nullptr);
+  return parent_.conn_data_->connection();
+}
+
+MultiplexedConnection::MultiplexedConnection(ConnectionMultiplexer& parent,
+                                             const Upstream::HostDescription* pool_host,
+                                             TransportType transport_type,
+                                             ProtocolType protocol_type)
+    : parent_(parent), pool_host_(pool_host),
+      transport_(NamedTransportConfigFactory::getFactory(transport_type).createTransport()),
+      protocol_(NamedProtocolConfigFactory::getFactory(protocol_type).createProtocol()) {}
+
+MultiplexedConnection::~MultiplexedConnection() {
+  ASSERT(streams_.empty() || closing_);
+  if (conn_pool_handle_) {
+    conn_pool_handle_->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+  }
+}
+
+Tcp::ConnectionPool::Cancellable*
+MultiplexedConnection::newStream(Upstream::TcpPoolData& pool_data,
+                                 Tcp::ConnectionPool::Callbacks& callbacks) {
+  ASSERT(!closing_);
+  if (conn_data_ == nullptr && conn_pool_handle_ == nullptr) {
+    // The pool may invoke the callbacks before returning.
+    Tcp::ConnectionPool::Cancellable* handle = pool_data.newConnection(*this);
+    if (handle) {
+      conn_pool_handle_ = handle;
+    }
+  }
+
+  if (conn_data_ != nullptr) {
+    attachStream(callbacks);
+    return nullptr;
+  }
+
+  if (conn_pool_handle_ == nullptr) {
+    ASSERT(pool_failure_.has_value());
+    callbacks.onPoolFailure(pool_failure_.value(), "", host_);
+    return nullptr;
+  }
+
+  LinkedList::moveIntoListBack(std::make_unique<PendingStream>(*this, callbacks),
+                               pending_streams_);
+  return pending_streams_.back().get();
+}
+
+void MultiplexedConnection::onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                                          absl::string_view transport_failure_reason,
+                                          Upstream::HostDescriptionConstSharedPtr host) {
+  conn_pool_handle_ = nullptr;
+  pool_failure_ = reason;
+  host_ = host;
+  remove();
+
+  while (!pending_streams_.empty()) {
+    PendingStreamPtr pending = pending_streams_.front()->removeFromList(pending_streams_);
+    pending->callbacks_.onPoolFailure(reason, transport_failure_reason, host);
+  }
+}
+
+void MultiplexedConnection::onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn_data,
+                                        Upstream::HostDescriptionConstSharedPtr host) {
+  ENVOY_LOG(debug, "thrift: multiplexed connection ready to {}", host->address()->asString());
+  conn_pool_handle_ = nullptr;
+  conn_data_ = std::move(conn_data);
+  conn_data_->addUpstreamCallbacks(*this);
+  host_ = host;
+
+  while (!pending_streams_.empty() && conn_data_ != nullptr) {
+    PendingStreamPtr pending = pending_streams_.front()->removeFromList(pending_streams_);
+    attachStream(pending->callbacks_);
+  }
+  releaseIfIdle();
+}
+
+void MultiplexedConnection::attachStream(Tcp::ConnectionPool::Callbacks& callbacks) {
+  int32_t sequence_id = sequence_ids_.nextSequenceId();
+  while (streams_.contains(sequence_id)) {
+    sequence_id = sequence_ids_.nextSequenceId();
+  }
+
+  auto stream = std::make_unique<MultiplexedStream>(*this, sequence_id);
+  streams_[sequence_id] = stream.get();
+  callbacks.onPoolReady(std::move(stream), host_);
+}
+
+void MultiplexedConnection::onStreamReleased(MultiplexedStream& stream) {
+  auto it = streams_.find(stream.sequence_id_);
+  if (it == streams_.end() || it->second != &stream) {
+    return;
+  }
+
+  if (stream.request_sent_ && !stream.response_received_ && !closing_) {
+    // The response still has to be read off the connection.
+    it->second = nullptr;
+    return;
+  }
+  streams_.erase(it);
+  releaseIfIdle();
+}
+
+void MultiplexedConnection::releaseIfIdle() {
+  if (closing_ || conn_data_ == nullptr || !streams_.empty() || !pending_streams_.empty()) {
+    return;
+  }
+
+  ENVOY_LOG(debug, "thrift: releasing idle multiplexed connection");
+  remove();
+  conn_data_.reset();
+}
+
+void MultiplexedConnection::remove() { parent_.remove(*this); }
+
+void MultiplexedConnection::onUpstreamData(Buffer::Instance& data, bool end_stream) {
+  response_buffer_.move(data);
+
+  // Both framed and header transports start frames with their size.
+  while (conn_data_ != nullptr && !closing_ && response_buffer_.length() >= sizeof(uint32_t)) {
+    const uint64_t size = sizeof(uint32_t) + response_buffer_.peekBEInt<uint32_t>();
+    if (response_buffer_.length() < size) {
+      break;
+    }
+
+    Buffer::OwnedImpl frame;
+    frame.move(response_buffer_, size);
+    const absl::optional<int32_t> sequence_id = responseSequenceId(frame);
+    if (!sequence_id.has_value()) {
+      ENVOY_LOG(debug, "thrift: invalid response on multiplexed connection");
+      closing_ = true;
+      conn_data_->connection().close(Network::ConnectionCloseType::NoFlush);
+      return;
+    }
+
+    auto it = streams_.find(sequence_id.value());
+    if (it == streams_.end()) {
+      ENVOY_LOG(debug, "thrift: dropping response with unknown sequence id {}",
+                sequence_id.value());
+      continue;
+    }
+
+    MultiplexedStream* stream = it->second;
+    if (stream == nullptr) {
+      // The request of the response is gone.
+      streams_.erase(it);
+      releaseIfIdle();
+      continue;
+    }
+
+    stream->response_received_ = true;
+    if (stream->callbacks_ != nullptr) {
+      stream->callbacks_->onUpstreamData(frame, false);
+    }
+  }
+
+  if (end_stream && conn_data_ != nullptr && !closing_) {
+    // No more responses are coming, the requests waiting for one get an incomplete response.
+    closing_ = true;
+    remove();
+    std::vector<int32_t> sequence_ids;
+    for (const auto& stream : streams_) {
+      sequence_ids.push_back(stream.first);
+    }
+    for (const int32_t sequence_id : sequence_ids) {
+      auto it = streams_.find(sequence_id);
+      if (it != streams_.end() && it->second != nullptr && it->second->callbacks_ != nullptr) {
+        Buffer::OwnedImpl empty;
+        it->second->callbacks_->onUpstreamData(empty, true);
+      }
+    }
+    if (conn_data_ != nullptr) {
+      conn_data_->connection().close(Network::ConnectionCloseType::NoFlush);
+    }
+  }
+}
+
+void MultiplexedConnection::onEvent(Network::ConnectionEvent event) {
+  ASSERT(event != Network::ConnectionEvent::Connected);
+  ENVOY_LOG(debug, "thrift: multiplexed connection closed");
+  closing_ = true;
+  remove();
+
+  // Streams are released by their callbacks as they get the event.
+  std::vector<int32_t> sequence_ids;
+  for (const auto& stream : streams_) {
+    sequence_ids.push_back(stream.first);
+  }
+  for (const int32_t sequence_id : sequence_ids) {
+    auto it = streams_.find(sequence_id);
+    if (it != streams_.end() && it->second != nullptr && it->second->callbacks_ != nullptr) {
+      it->second->callbacks_->onEvent(event);
+    }
+  }
+
+  streams_.clear();
+  conn_data_.reset();
+}
+
+absl::optional<int32_t> MultiplexedConnection::responseSequenceId(const Buffer::Instance& frame) {
+  Buffer::OwnedImpl header;
+  header.add(frame);
+
+  MessageMetadata metadata;
+  try {
+    if (!transport_->decodeFrameStart(header, metadata) ||
+        !protocol_->readMessageBegin(header, metadata)) {
+      return absl::nullopt;
+    }
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(debug, "thrift: {}", e.what());
+    return absl::nullopt;
+  }
+
+  if (!metadata.hasSequenceId()) {
+    return absl::nullopt;
+  }
+  return metadata.sequenceId();
+}
+
+Tcp::ConnectionPool::Cancellable*
+ConnectionMultiplexer::newConnection(Upstream::TcpPoolData& pool_data, TransportType transport_type,
+                                     ProtocolType protocol_type,
+                                     Tcp::ConnectionPool::Callbacks& callbacks) {
+  const Key key{pool_data.host().get(), transport_type, protocol_type};
+  auto it = connections_.find(key);
+  if (it == connections_.end()) {
+    it = connections_
+             .emplace(key, std::make_unique<MultiplexedConnection>(*this, std::get<0>(key),
+                                                                   transport_type, protocol_type))
+             .first;
+  }
+
+  // New connections may be removed at once, if the pool fails synchronously.
+  return it->second->newStream(pool_data, callbacks);
+}
+
+bool ConnectionMultiplexer::supports(TransportType transport_type, const Protocol& protocol) {
+  return (transport_type == TransportType::Framed || transport_type == TransportType::Header) &&
+         !protocol.supportsUpgrade();
+}
+
+void ConnectionMultiplexer::remove(MultiplexedConnection& connection) {
+  auto it = connections_.find(
+      Key{connection.pool_host_, connection.transport_->type(), connection.protocol_->type()});
+  if (it == connections_.end() || it->second.get() != &connection) {
+    return;
+  }
+
+  dispatcher_.deferredDelete(std::move(it->second));
+  connections_.erase(it);
+}
+
+} // namespace Router
+} // namespace ThriftProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
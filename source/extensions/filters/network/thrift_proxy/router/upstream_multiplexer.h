@@ -0,0 +1,200 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <tuple>
+
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/tcp/conn_pool.h"
+#include "envoy/thread_local/thread_local_object.h"
+#include "envoy/upstream/thread_local_cluster.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/linked_object.h"
+#include "source/common/common/logger.h"
+#include "source/extensions/filters/network/thrift_proxy/conn_state.h"
+#include "source/extensions/filters/network/thrift_proxy/protocol.h"
+#include "source/extensions/filters/network/thrift_proxy/transport.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace ThriftProxy {
+namespace Router {
+
+class ConnectionMultiplexer;
+class MultiplexedConnection;
+
+/**
+ * A request sharing a multiplexed upstream connection. It is handed to the router as the data of
+ * a pooled connection: the router writes its request to the shared connection, and gets only the
+ * response matching the sequence id reserved for the request.
+ * The connection state of the stream gives the reserved sequence id as its next sequence id.
+ */
+class MultiplexedStream : public Tcp::ConnectionPool::ConnectionData {
+public:
+  MultiplexedStream(MultiplexedConnection& parent, int32_t sequence_id);
+  ~MultiplexedStream() override;
+
+  // Tcp::ConnectionPool::ConnectionData
+  Network::ClientConnection& connection() override;
+  void setConnectionState(Tcp::ConnectionPool::ConnectionStatePtr&& state) override {
+    state_ = std::move(state);
+  }
+  void addUpstreamCallbacks(Tcp::ConnectionPool::UpstreamCallbacks& callbacks) override {
+    callbacks_ = &callbacks;
+  }
+
+  /**
+   * Marks the request as written with a response expected, that is then dropped when it arrives if
+   * the stream is released first.
+   */
+  void onRequestSent() { request_sent_ = true; }
+
+protected:
+  // Tcp::ConnectionPool::ConnectionData
+  Tcp::ConnectionPool::ConnectionState* connectionState() override { return state_.get(); }
+
+private:
+  friend class MultiplexedConnection;
+
+  MultiplexedConnection& parent_;
+  const int32_t sequence_id_;
+  Tcp::ConnectionPool::ConnectionStatePtr state_;
+  Tcp::ConnectionPool::UpstreamCallbacks* callbacks_{};
+  bool request_sent_{false};
+  bool response_received_{false};
+};
+
+/**
+ * An upstream connection from the pool of a host, shared by the requests of a worker. Responses are
+ * read frame by frame, and handed to the stream of the request with the same sequence id. The
+ * connection is released to the pool once it has neither requests nor expected responses left.
+ */
+class MultiplexedConnection : public Tcp::ConnectionPool::Callbacks,
+                              public Tcp::ConnectionPool::UpstreamCallbacks,
+                              public Event::DeferredDeletable,
+                              Logger::Loggable<Logger::Id::thrift> {
+public:
+  MultiplexedConnection(ConnectionMultiplexer& parent, const Upstream::HostDescription* pool_host,
+                        TransportType transport_type, ProtocolType protocol_type);
+  ~MultiplexedConnection() override;
+
+  /**
+   * Starts a request on the connection, connecting first if needed.
+   * @param pool_data the pool to get the connection from.
+   * @param callbacks the callbacks to give the request stream to.
+   * @return a handle to cancel the request while connecting, or nullptr if callbacks were invoked.
+   */
+  Tcp::ConnectionPool::Cancellable* newStream(Upstream::TcpPoolData& pool_data,
+                                              Tcp::ConnectionPool::Callbacks& callbacks);
+
+  // Tcp::ConnectionPool::Callbacks
+  void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                     absl::string_view transport_failure_reason,
+                     Upstream::HostDescriptionConstSharedPtr host) override;
+  void onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn_data,
+                   Upstream::HostDescriptionConstSharedPtr host) override;
+
+  // Tcp::ConnectionPool::UpstreamCallbacks
+  void onUpstreamData(Buffer::Instance& data, bool end_stream) override;
+  void onEvent(Network::ConnectionEvent event) override;
+  void onAboveWriteBufferHighWatermark() override {}
+  void onBelowWriteBufferLowWatermark() override {}
+
+private:
+  friend class MultiplexedStream;
+
+  /**
+   * Request waiting for the connection to be ready.
+   */
+  struct PendingStream : public Tcp::ConnectionPool::Cancellable,
+                         public LinkedObject<PendingStream> {
+    PendingStream(MultiplexedConnection& parent, Tcp::ConnectionPool::Callbacks& callbacks)
+        : parent_(parent), callbacks_(callbacks) {}
+
+    // Tcp::ConnectionPool::Cancellable
+    void cancel(Tcp::ConnectionPool::CancelPolicy) override {
+      removeFromList(parent_.pending_streams_);
+    }
+
+    MultiplexedConnection& parent_;
+    Tcp::ConnectionPool::Callbacks& callbacks_;
+  };
+
+  using PendingStreamPtr = std::unique_ptr<PendingStream>;
+
+  void attachStream(Tcp::ConnectionPool::Callbacks& callbacks);
+  void onStreamReleased(MultiplexedStream& stream);
+  void releaseIfIdle();
+  void remove();
+  absl::optional<int32_t> responseSequenceId(const Buffer::Instance& frame);
+
+  ConnectionMultiplexer& parent_;
+  // Host of the pool the connection is from, only used to find the connection.
+  const Upstream::HostDescription* const pool_host_;
+  TransportPtr transport_;
+  ProtocolPtr protocol_;
+
+  Tcp::ConnectionPool::Cancellable* conn_pool_handle_{};
+  Tcp::ConnectionPool::ConnectionDataPtr conn_data_;
+  Upstream::HostDescriptionConstSharedPtr host_;
+  absl::optional<ConnectionPool::PoolFailureReason> pool_failure_;
+  std::list<PendingStreamPtr> pending_streams_;
+
+  // Streams by sequence id, with no stream for the responses to drop.
+  absl::flat_hash_map<int32_t, MultiplexedStream*> streams_;
+  ThriftConnectionState sequence_ids_;
+  Buffer::OwnedImpl response_buffer_;
+  // Whether the connection is closing or closed, and cannot take new requests.
+  bool closing_{false};
+};
+
+using MultiplexedConnectionPtr = std::unique_ptr<MultiplexedConnection>;
+
+/**
+ * Keeps the multiplexed upstream connections of a worker, one per upstream host and upstream
+ * transport and protocol.
+ */
+class ConnectionMultiplexer : public ThreadLocal::ThreadLocalObject {
+public:
+  ConnectionMultiplexer(Event::Dispatcher& dispatcher) : dispatcher_(dispatcher) {}
+
+  /**
+   * Starts a request on the multiplexed connection to the host of a pool.
+   * @param pool_data the pool of the upstream host.
+   * @param transport_type the upstream transport, which must be framed or header.
+   * @param protocol_type the upstream protocol, which must not need an upgrade.
+   * @param callbacks the callbacks to give the request stream to, as connection data.
+   * @return a handle to cancel the request while connecting, or nullptr if callbacks were invoked.
+   */
+  Tcp::ConnectionPool::Cancellable* newConnection(Upstream::TcpPoolData& pool_data,
+                                                  TransportType transport_type,
+                                                  ProtocolType protocol_type,
+                                                  Tcp::ConnectionPool::Callbacks& callbacks);
+
+  /**
+   * @return whether requests with the given upstream transport and protocol can be multiplexed.
+   */
+  static bool supports(TransportType transport_type, const Protocol& protocol);
+
+private:
+  friend class MultiplexedConnection;
+
+  using Key = std::tuple<const Upstream::HostDescription*, TransportType, ProtocolType>;
+
+  void remove(MultiplexedConnection& connection);
+
+  Event::Dispatcher& dispatcher_;
+  absl::flat_hash_map<Key, MultiplexedConnectionPtr> connections_;
+};
+
+} // namespace Router
+} // namespace ThriftProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -156,6 +156,12 @@ DnsFilterEnvoyConfig::DnsFilterEnvoyConfig(
     domain_ttl_.emplace(virtual_domain.name(), ttl);
   }
 
+  // The answers for the configured addresses only depend on the domain, so they are serialized
+  // once here rather than for each query, once the addresses and TTLs of all domains are known.
+  for (const auto& virtual_domain : dns_table.virtual_domains()) {
+    serializeAddressAnswers(virtual_domain.name());
+  }
+
   forward_queries_ = config.has_client_config();
   if (forward_queries_) {
     const auto& client_config = config.client_config();
@@ -174,6 +180,7 @@ DnsFilterEnvoyConfig::DnsFilterEnvoyConfig(
     resolver_timeout_ = std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(
         client_config, resolver_timeout, DEFAULT_RESOLVER_TIMEOUT.count()));
     max_pending_lookups_ = client_config.max_pending_lookups();
+    max_cached_lookups_ = client_config.max_cached_lookups();
   }
 }
 
@@ -188,6 +195,34 @@ void DnsFilterEnvoyConfig::addEndpointToSuffix(const absl::string_view suffix,
   ASSERT(success, "Unable to overwrite existing suffix in dns_filter trie");
 }
 
+void DnsFilterEnvoyConfig::serializeAddressAnswers(const absl::string_view domain_name) {
+  auto virtual_domains = dns_lookup_trie_.find(Utils::getDomainSuffix(domain_name));
+  if (virtual_domains == nullptr) {
+    return;
+  }
+  auto endpoint_config = virtual_domains->find(domain_name);
+  if (endpoint_config == virtual_domains->end() ||
+      !endpoint_config->second.address_list.has_value() ||
+      !endpoint_config->second.serialized_address_answers.empty()) {
+    return;
+  }
+
+  const std::chrono::seconds ttl = domain_ttl_.at(domain_name);
+  auto& serialized_answers = endpoint_config->second.serialized_address_answers;
+  for (const auto& address : endpoint_config->second.address_list.value()) {
+    const auto type = Utils::getAddressRecordType(address);
+    if (!type.has_value()) {
+      // The answers are only used once they are all serialized.
+      serialized_answers.clear();
+      return;
+    }
+    DnsAnswerRecord record(domain_name, type.value(), DNS_RECORD_CLASS_IN, ttl, address);
+    Buffer::OwnedImpl serialized;
+    record.serialize(serialized);
+    serialized_answers.push_back(serialized.toString());
+  }
+}
+
 bool DnsFilterEnvoyConfig::loadServerConfig(
     const envoy::extensions::filters::udp::dns_filter::v3alpha::DnsFilterConfig::
         ServerContextConfig& config,
@@ -247,6 +282,7 @@ DnsFilter::DnsFilter(Network::UdpReadFilterCallbacks& callbacks,
     }
 
     incrementExternalQueryTypeCount(query->type_);
+    cacheLookup(*query, iplist, context->resolved_ttl_);
     for (const auto& ip : iplist) {
       incrementExternalQueryTypeAnswerCount(query->type_);
       const std::chrono::seconds ttl = getDomainTTL(query->name_);
@@ -331,6 +367,10 @@ DnsLookupResponseCode DnsFilter::getResponseForQuery(DnsQueryContextPtr& context
     // Forwarding queries is enabled if the configuration contains a client configuration
     // for the dns_filter.
     if (forward_queries) {
+      if (resolveViaCache(context, *query)) {
+        continue;
+      }
+
       ENVOY_LOG(debug, "resolving name [{}] via external resolvers", query->name_);
       resolver_->resolveExternalQuery(std::move(context), query.get());
 
@@ -358,6 +398,46 @@ bool DnsFilter::resolveViaConfiguredHosts(DnsQueryContextPtr& context,
   }
 }
 
+bool DnsFilter::resolveViaCache(DnsQueryContextPtr& context, const DnsQueryRecord& query) {
+  if (lookup_cache_.empty()) {
+    return false;
+  }
+
+  const auto iter = lookup_cache_.find(std::make_pair(query.name_, query.type_));
+  if (iter == lookup_cache_.end()) {
+    return false;
+  }
+  if (iter->second.expiry <= listener_.dispatcher().timeSource().monotonicTime()) {
+    lookup_cache_.erase(iter);
+    return false;
+  }
+
+  ENVOY_LOG(trace, "using cached answers for name [{}]", query.name_);
+  config_->stats().externally_resolved_cached_queries_.inc();
+  incrementExternalQueryTypeCount(query.type_);
+  const std::chrono::seconds ttl = getDomainTTL(query.name_);
+  for (const auto& ip : iter->second.addresses) {
+    incrementExternalQueryTypeAnswerCount(query.type_);
+    message_parser_.storeDnsAnswerRecord(context, query, ttl, ip);
+  }
+  return true;
+}
+
+void DnsFilter::cacheLookup(const DnsQueryRecord& query, const AddressConstPtrVec& addresses,
+                            std::chrono::seconds ttl) {
+  if (config_->maxCachedLookups() == 0 || addresses.empty() || ttl.count() <= 0) {
+    return;
+  }
+
+  auto key = std::make_pair(query.name_, query.type_);
+  if (lookup_cache_.size() >= config_->maxCachedLookups() && !lookup_cache_.contains(key)) {
+    lookup_cache_.erase(lookup_cache_.begin());
+  }
+  lookup_cache_.insert_or_assign(
+      std::move(key),
+      CachedLookup{addresses, listener_.dispatcher().timeSource().monotonicTime() + ttl});
+}
+
 std::chrono::seconds DnsFilter::getDomainTTL(const absl::string_view domain) {
   const auto& domain_ttl_config = config_->domainTtl();
   const auto& iter = domain_ttl_config.find(domain);
@@ -530,17 +610,28 @@ bool DnsFilter::resolveViaClusters(DnsQueryContextPtr& context, const DnsQueryRe
 }
 
 bool DnsFilter::resolveConfiguredDomain(DnsQueryContextPtr& context, const DnsQueryRecord& query) {
-  const auto* configured_address_list = getAddressListForDomain(query.name_);
+  const DnsEndpointConfig* endpoint_config = getEndpointConfigForDomain(query.name_);
   uint64_t hosts_found = 0;
-  if (configured_address_list != nullptr) {
+  if (endpoint_config != nullptr && endpoint_config->address_list.has_value()) {
+    const auto& configured_address_list = endpoint_config->address_list.value();
+    const auto& serialized_answers = endpoint_config->serialized_address_answers;
+    const bool use_serialized_answers = query.class_ == DNS_RECORD_CLASS_IN &&
+                                        serialized_answers.size() == configured_address_list.size();
+    const std::chrono::seconds ttl = getDomainTTL(query.name_);
+
     // Build an answer record from each configured IP address
-    for (const auto& configured_address : *configured_address_list) {
+    for (size_t i = 0; i < configured_address_list.size(); i++) {
+      const auto& configured_address = configured_address_list[i];
       ASSERT(configured_address != nullptr);
       ENVOY_LOG(trace, "using local address {} for domain [{}]",
                 configured_address->ip()->addressAsString(), query.name_);
       ++hosts_found;
-      const std::chrono::seconds ttl = getDomainTTL(query.name_);
-      if (message_parser_.storeDnsAnswerRecord(context, query, ttl, configured_address)) {
+      const bool stored = use_serialized_answers
+                              ? message_parser_.storeSerializedDnsAnswerRecord(
+                                    context, query, ttl, configured_address, serialized_answers[i])
+                              : message_parser_.storeDnsAnswerRecord(context, query, ttl,
+                                                                     configured_address);
+      if (stored) {
         incrementLocalQueryTypeAnswerCount(query.type_);
       }
     }
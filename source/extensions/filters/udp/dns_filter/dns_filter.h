@@ -12,6 +12,7 @@
 #include "source/extensions/filters/udp/dns_filter/dns_filter_resolver.h"
 #include "source/extensions/filters/udp/dns_filter/dns_parser.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 
 namespace Envoy {
@@ -40,6 +41,7 @@ namespace DnsFilter {
   COUNTER(external_unsupported_answers)                                                            \
   COUNTER(external_unsupported_queries)                                                            \
   COUNTER(externally_resolved_queries)                                                             \
+  COUNTER(externally_resolved_cached_queries)                                                      \
   COUNTER(known_domain_queries)                                                                    \
   COUNTER(local_a_record_answers)                                                                  \
   COUNTER(local_aaaa_record_answers)                                                               \
@@ -64,6 +66,9 @@ struct DnsFilterStats {
 
 struct DnsEndpointConfig {
   absl::optional<AddressConstPtrVec> address_list;
+  // The serialized answer records of the addresses in address_list, in the same order, for the
+  // queries of class IN.
+  std::vector<std::string> serialized_address_answers;
   absl::optional<std::string> cluster_name;
   absl::optional<DnsSrvRecordPtr> service_list;
 };
@@ -91,6 +96,7 @@ public:
   uint64_t retryCount() const { return retry_count_; }
   Random::RandomGenerator& random() const { return random_; }
   uint64_t maxPendingLookups() const { return max_pending_lookups_; }
+  uint64_t maxCachedLookups() const { return max_cached_lookups_; }
   const envoy::config::core::v3::DnsResolverOptions& dnsResolverOptions() const {
     return dns_resolver_options_;
   }
@@ -112,6 +118,8 @@ private:
   void addEndpointToSuffix(const absl::string_view suffix, const absl::string_view domain_name,
                            DnsEndpointConfig& endpoint_config);
 
+  void serializeAddressAnswers(const absl::string_view domain_name);
+
   Stats::Scope& root_scope_;
   Upstream::ClusterManager& cluster_manager_;
   Network::DnsResolverSharedPtr resolver_;
@@ -127,6 +135,7 @@ private:
   std::chrono::milliseconds resolver_timeout_;
   Random::RandomGenerator& random_;
   uint64_t max_pending_lookups_;
+  uint64_t max_cached_lookups_{};
   envoy::config::core::v3::DnsResolverOptions dns_resolver_options_;
 };
 
@@ -230,6 +239,25 @@ private:
    */
   bool resolveViaConfiguredHosts(DnsQueryContextPtr& context, const DnsQueryRecord& query);
 
+  /**
+   * @brief Resolves the supplied query from the answers cached for an earlier external resolution
+   *
+   * @param context object containing the query context
+   * @param query query object containing the name to be resolved
+   * @return bool true if the answers of the query were cached and have not expired
+   */
+  bool resolveViaCache(DnsQueryContextPtr& context, const DnsQueryRecord& query);
+
+  /**
+   * @brief Caches the answers of an external resolution when the cache is enabled
+   *
+   * @param query query object containing the name which was resolved
+   * @param addresses the addresses resolved for the name
+   * @param ttl the lowest TTL of the resolved addresses
+   */
+  void cacheLookup(const DnsQueryRecord& query, const AddressConstPtrVec& addresses,
+                   std::chrono::seconds ttl);
+
   /**
    * @brief Increment the counter for the given query type for external queries
    *
@@ -375,6 +403,13 @@ private:
   Network::Address::InstanceConstSharedPtr local_;
   Network::Address::InstanceConstSharedPtr peer_;
   DnsFilterResolverCallback resolver_callback_;
+
+  struct CachedLookup {
+    AddressConstPtrVec addresses;
+    MonotonicTime expiry;
+  };
+  // The answers of the external resolutions by name and record type, for this worker only.
+  absl::flat_hash_map<std::pair<std::string, uint16_t>, CachedLookup> lookup_cache_;
 };
 
 } // namespace DnsFilter
@@ -86,7 +86,6 @@ void DnsFilterResolver::resolveExternalQuery(DnsQueryContextPtr context,
                        ctx.query_context->resolution_status_ = status;
                        ctx.resolver_status = DnsFilterResolverStatus::Complete;
 
-                       // C-ares doesn't expose the TTL in the data available here.
                        if (status == Network::DnsResolver::ResolutionStatus::Success) {
                          ctx.resolved_hosts.reserve(response.size());
                          for (const auto& resp : response) {
@@ -94,6 +93,10 @@ void DnsFilterResolver::resolveExternalQuery(DnsQueryContextPtr context,
                            ENVOY_LOG(trace, "Resolved address: {} for {}",
                                      resp.address_->ip()->addressAsString(), ctx.query_rec->name_);
                            ctx.resolved_hosts.emplace_back(std::move(resp.address_));
+                           if (ctx.resolved_hosts.size() == 1 ||
+                               resp.ttl_ < ctx.query_context->resolved_ttl_) {
+                             ctx.query_context->resolved_ttl_ = resp.ttl_;
+                           }
                          }
                        }
                        // Invoke the filter callback notifying it of resolved addresses
@@ -26,37 +26,25 @@ bool BaseDnsRecord::serializeSpecificName(Buffer::OwnedImpl& output, const absl:
 
   size_t last = 0;
   size_t count = name.find_first_of(SEPARATOR);
-  auto iter = name.begin();
 
+  // Each label is written at once rather than byte by byte
   while (count != std::string::npos) {
     if ((count - last) > MAX_LABEL_LENGTH) {
       return false;
     }
 
-    count -= last;
-    output.writeBEInt<uint8_t>(count);
-    for (size_t i = 0; i < count; i++) {
-      output.writeByte(*iter);
-      ++iter;
-    }
-
-    // periods are not serialized. Skip to the next character
-    if (*iter == SEPARATOR) {
-      ++iter;
-    }
+    output.writeBEInt<uint8_t>(count - last);
+    output.add(name.data() + last, count - last);
 
-    // Move our last marker to the first position after where we stopped. Search for the next name
-    // separator
-    last += count;
-    count = name.find_first_of(SEPARATOR, ++last);
+    // periods are not serialized. Search for the next name separator after this one
+    last = count + 1;
+    count = name.find_first_of(SEPARATOR, last);
   }
 
   // Write the remaining segment prepended by its length
   count = name.size() - last;
   output.writeBEInt<uint8_t>(count);
-  for (size_t i = 0; i < count; i++) {
-    output.writeByte(*iter++);
-  }
+  output.add(name.data() + last, count);
 
   // Terminate the name record with a null byte
   output.writeByte(0x00);
@@ -101,6 +89,11 @@ bool DnsAnswerRecord::serialize(Buffer::OwnedImpl& output) {
   return (output.length() > 0);
 }
 
+bool DnsSerializedAnswerRecord::serialize(Buffer::OwnedImpl& output) {
+  output.add(serialized_);
+  return (output.length() > 0);
+}
+
 bool DnsSrvRecord::serialize(Buffer::OwnedImpl& output) {
   if (!targets_.empty()) {
     // The Service Record being serialized should have only one target
@@ -537,26 +530,34 @@ void DnsMessageParser::setDnsResponseFlags(DnsQueryContextPtr& query_context,
   query_context->response_header_.additional_rrs = additional_rrs;
 }
 
-bool DnsMessageParser::createAndStoreDnsAnswerRecord(
-    const absl::string_view name, const uint16_t rec_type, const uint16_t rec_class,
-    const std::chrono::seconds ttl, Network::Address::InstanceConstSharedPtr ipaddr,
-    DnsAnswerMap& collection) {
-  // Verify that we have an address matching the query record type
+bool DnsMessageParser::addressMatchesRecordType(const uint16_t rec_type,
+                                                const Network::Address::Instance& ipaddr) {
   switch (rec_type) {
   case DNS_RECORD_TYPE_AAAA:
-    if (ipaddr->ip()->ipv6() == nullptr) {
+    if (ipaddr.ip()->ipv6() == nullptr) {
       ENVOY_LOG(debug, "Unable to return IPV6 address for query");
       return false;
     }
     break;
 
   case DNS_RECORD_TYPE_A:
-    if (ipaddr->ip()->ipv4() == nullptr) {
+    if (ipaddr.ip()->ipv4() == nullptr) {
       ENVOY_LOG(debug, "Unable to return IPV4 address for query");
       return false;
     }
     break;
   }
+  return true;
+}
+
+bool DnsMessageParser::createAndStoreDnsAnswerRecord(
+    const absl::string_view name, const uint16_t rec_type, const uint16_t rec_class,
+    const std::chrono::seconds ttl, Network::Address::InstanceConstSharedPtr ipaddr,
+    DnsAnswerMap& collection) {
+  // Verify that we have an address matching the query record type
+  if (!addressMatchesRecordType(rec_type, *ipaddr)) {
+    return false;
+  }
 
   auto answer_record =
       std::make_unique<DnsAnswerRecord>(name, rec_type, rec_class, ttl, std::move(ipaddr));
@@ -582,6 +583,19 @@ bool DnsMessageParser::storeDnsAnswerRecord(DnsQueryContextPtr& context,
                                        std::move(ipaddr), context->answers_);
 }
 
+bool DnsMessageParser::storeSerializedDnsAnswerRecord(
+    DnsQueryContextPtr& context, const DnsQueryRecord& query_rec, const std::chrono::seconds ttl,
+    Network::Address::InstanceConstSharedPtr ipaddr, const std::string& serialized) {
+  if (!addressMatchesRecordType(query_rec.type_, *ipaddr)) {
+    return false;
+  }
+
+  context->answers_.emplace(query_rec.name_, std::make_unique<DnsSerializedAnswerRecord>(
+                                                 query_rec.name_, query_rec.type_, query_rec.class_,
+                                                 ttl, std::move(ipaddr), serialized));
+  return true;
+}
+
 void DnsMessageParser::addNewDnsSrvAnswerRecord(DnsQueryContextPtr& context,
                                                 const DnsQueryRecord& query_rec,
                                                 DnsSrvRecordPtr service) {
@@ -711,7 +725,7 @@ void DnsMessageParser::buildResponseBuffer(DnsQueryContextPtr& query_context,
               continue;
             }
             total_buffer_size += serialized_rr.length();
-            addl_rec_buffer.add(serialized_rr);
+            addl_rec_buffer.move(serialized_rr);
             ++serialized_additional_rrs;
           }
         }
@@ -727,7 +741,7 @@ void DnsMessageParser::buildResponseBuffer(DnsQueryContextPtr& query_context,
         if (total_buffer_size > MAX_DNS_RESPONSE_SIZE) {
           break;
         }
-        answer_buffer.add(serialized_answer);
+        answer_buffer.move(serialized_answer);
         if (++serialized_answers == MAX_RETURNED_RECORDS) {
           break;
         }
@@ -72,6 +72,25 @@ public:
   const Network::Address::InstanceConstSharedPtr ip_addr_;
 };
 
+/**
+ * DnsSerializedAnswerRecord is an answer record whose serialized form is known ahead of the query,
+ * such as the answers for the addresses of a configured domain. The serialized record is owned by
+ * the configuration, which outlives the queries.
+ */
+class DnsSerializedAnswerRecord : public DnsAnswerRecord {
+public:
+  DnsSerializedAnswerRecord(const absl::string_view query_name, const uint16_t rec_type,
+                            const uint16_t rec_class, const std::chrono::seconds ttl,
+                            Network::Address::InstanceConstSharedPtr ipaddr,
+                            const std::string& serialized)
+      : DnsAnswerRecord(query_name, rec_type, rec_class, ttl, std::move(ipaddr)),
+        serialized_(serialized) {}
+  bool serialize(Buffer::OwnedImpl& output) override;
+
+private:
+  const std::string& serialized_;
+};
+
 using DnsAnswerRecordPtr = std::unique_ptr<DnsAnswerRecord>;
 using DnsAnswerMap = std::unordered_multimap<std::string, DnsAnswerRecordPtr>;
 
@@ -186,6 +205,8 @@ public:
   DnsAnswerMap answers_;
   DnsAnswerMap additional_;
   bool in_callback_;
+  // The lowest TTL of the addresses resolved by the external resolvers for the query.
+  std::chrono::seconds resolved_ttl_{};
 
   /**
    * @param context the query context for which we are querying the response code
@@ -349,6 +370,23 @@ public:
                             const std::chrono::seconds ttl,
                             Network::Address::InstanceConstSharedPtr ipaddr);
 
+  /**
+   * @brief Stores a DNS Answer record for a given IP Address, whose serialized form is already
+   * known, in the map of the answers to the query.
+   *
+   * @param context the query context for which we are generating a response
+   * @param query_rec to which the answer is matched.
+   * @param ttl the TTL specifying how long the returned answer is cached
+   * @param ipaddr the address that is returned in the answer record
+   * @param serialized the serialized answer record for the query name, which must outlive the
+   * context
+   * @return true if the answer record matches the query type
+   */
+  bool storeSerializedDnsAnswerRecord(DnsQueryContextPtr& context, const DnsQueryRecord& query_rec,
+                                      const std::chrono::seconds ttl,
+                                      Network::Address::InstanceConstSharedPtr ipaddr,
+                                      const std::string& serialized);
+
   /**
    * @brief Parse the incoming query and create a context object for the filter
    *
@@ -364,6 +402,12 @@ public:
   bool parseDnsObject(DnsQueryContextPtr& context, const Buffer::InstancePtr& buffer);
 
 private:
+  /**
+   * @return bool true if the address can be returned in an answer record of the given type
+   */
+  static bool addressMatchesRecordType(const uint16_t rec_type,
+                                       const Network::Address::Instance& ipaddr);
+
   enum class DnsQueryParseState {
     Init,
     Flags,     // 2 bytes
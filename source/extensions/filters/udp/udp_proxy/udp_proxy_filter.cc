@@ -167,6 +167,8 @@ UdpProxyFilter::ActiveSession::ActiveSession(ClusterInfo& cluster,
       cluster.filter_.read_callbacks_->udpListener().dispatcher(),
       [this](uint32_t) { onReadReady(); }, Event::PlatformDefaultTriggerType,
       Event::FileReadyType::Read);
+  onActivity();
+  idle_timer_->enableTimer(cluster_.filter_.config_->sessionTimeout());
   ENVOY_LOG(debug, "creating new session: downstream={} local={} upstream={}",
             addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
             host->address()->asStringView());
@@ -206,7 +208,20 @@ UdpProxyFilter::ActiveSession::~ActiveSession() {
       .dec();
 }
 
+void UdpProxyFilter::ActiveSession::onActivity() {
+  last_activity_time_ =
+      cluster_.filter_.read_callbacks_->udpListener().dispatcher().approximateMonotonicTime();
+}
+
 void UdpProxyFilter::ActiveSession::onIdleTimer() {
+  const std::chrono::milliseconds idle_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+      cluster_.filter_.read_callbacks_->udpListener().dispatcher().approximateMonotonicTime() -
+      last_activity_time_);
+  if (idle_time < cluster_.filter_.config_->sessionTimeout()) {
+    idle_timer_->enableTimer(cluster_.filter_.config_->sessionTimeout() - idle_time);
+    return;
+  }
+
   ENVOY_LOG(debug, "session idle timeout: downstream={} local={}", addresses_.peer_->asStringView(),
             addresses_.local_->asStringView());
   cluster_.filter_.config_->stats().idle_timeout_.inc();
@@ -214,7 +229,7 @@ void UdpProxyFilter::ActiveSession::onIdleTimer() {
 }
 
 void UdpProxyFilter::ActiveSession::onReadReady() {
-  idle_timer_->enableTimer(cluster_.filter_.config_->sessionTimeout());
+  onActivity();
 
   // TODO(mattklein123): We should not be passing *addresses_.local_ to this function as we are
   //                     not trying to populate the local address for received packets.
@@ -241,7 +256,7 @@ void UdpProxyFilter::ActiveSession::write(const Buffer::Instance& buffer) {
   cluster_.filter_.config_->stats().downstream_sess_rx_bytes_.add(buffer_length);
   cluster_.filter_.config_->stats().downstream_sess_rx_datagrams_.inc();
 
-  idle_timer_->enableTimer(cluster_.filter_.config_->sessionTimeout());
+  onActivity();
 
   // NOTE: On the first write, a local ephemeral port is bound, and thus this write can fail due to
   //       port exhaustion.
@@ -166,6 +166,7 @@ private:
   private:
     void onIdleTimer();
     void onReadReady();
+    void onActivity();
 
     // Network::UdpPacketProcessor
     void processPacket(Network::Address::InstanceConstSharedPtr local_address,
@@ -177,6 +178,7 @@ private:
     void onDatagramsDropped(uint32_t dropped) override {
       cluster_.cluster_stats_.sess_rx_datagrams_dropped_.add(dropped);
     }
+    void onDatagramsRead(uint64_t) override {}
     size_t numPacketsExpectedPerEventLoop() const final {
       // TODO(mattklein123) change this to a reasonable number if needed.
       return Network::MAX_NUM_PACKETS_PER_EVENT_LOOP;
@@ -186,12 +188,12 @@ private:
     const bool use_original_src_ip_;
     const Network::UdpRecvData::LocalPeerAddresses addresses_;
     const Upstream::HostConstSharedPtr host_;
-    // TODO(mattklein123): Consider replacing an idle timer for each session with a last used
-    // time stamp and a periodic scan of all sessions to look for timeouts. This solution is simple,
-    // though it might not perform well for high volume traffic. Note that this is how TCP proxy
-    // idle timeouts work so we should consider unifying the implementation if we move to a time
-    // stamp and scan approach.
+    // The idle timer is armed for the session timeout when the session is created, and is not
+    // touched by the datagrams of the session. When it fires, the session either expires or rearms
+    // the timer for the rest of its timeout counted from its last activity. This keeps the timer
+    // out of the per datagram path, which only records the time of the activity.
     const Event::TimerPtr idle_timer_;
+    MonotonicTime last_activity_time_;
     // The socket is used for writing packets to the selected upstream host as well as receiving
     // packets from the upstream host. Note that a a local ephemeral port is bound on the first
     // write to the upstream host.
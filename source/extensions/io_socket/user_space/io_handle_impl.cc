@@ -23,7 +23,9 @@ Api::SysCallIntResult makeInvalidSyscallResult() {
 
 /**
  * Move at most max_length from src to dst. If the dst is close or beyond high watermark, move no
- * more than 16K. It's not an error if src buffer doesn't contain enough data.
+ * more than 16K. It's not an error if src buffer doesn't contain enough data. The move stops at the
+ * end of the last whole slice within the limit if any, since whole slices are moved by reference
+ * while the part of a slice is copied.
  * @param dst supplies the buffer where the data is move to.
  * @param src supplies the buffer where the data is move from.
  * @param max_length supplies the max bytes the call can move.
@@ -43,6 +45,18 @@ uint64_t moveUpTo(Buffer::Instance& dst, Buffer::Instance& src, uint64_t max_len
     }
   }
   uint64_t res = std::min(max_length, src.length());
+  if (res < src.length()) {
+    uint64_t whole_slices_length = 0;
+    for (const Buffer::RawSlice& slice : src.getRawSlices()) {
+      if (whole_slices_length + slice.len_ > res) {
+        break;
+      }
+      whole_slices_length += slice.len_;
+    }
+    if (whole_slices_length > 0) {
+      res = whole_slices_length;
+    }
+  }
   dst.move(src, res);
   return res;
 }
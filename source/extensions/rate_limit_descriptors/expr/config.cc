@@ -25,7 +25,8 @@ public:
       const envoy::extensions::rate_limit_descriptors::expr::v3::Descriptor& config,
       Filters::Common::Expr::Builder& builder, const google::api::expr::v1alpha1::Expr& input_expr)
       : input_expr_(input_expr), descriptor_key_(config.descriptor_key()),
-        skip_if_error_(config.skip_if_error()) {
+        skip_if_error_(config.skip_if_error()),
+        attributes_(Filters::Common::Expr::referencedAttributes(input_expr_)) {
     compiled_expr_ = Extensions::Filters::Common::Expr::createExpression(builder, input_expr_);
   }
 
@@ -35,7 +36,7 @@ public:
                           const StreamInfo::StreamInfo& info) const override {
     ProtobufWkt::Arena arena;
     const auto result = Filters::Common::Expr::evaluate(*compiled_expr_.get(), arena, info,
-                                                        &headers, nullptr, nullptr);
+                                                        &headers, nullptr, nullptr, attributes_);
     if (!result.has_value() || result.value().IsError()) {
       // If result is an error and if skip_if_error is true skip this descriptor,
       // while calling rate limiting service. If skip_if_error is false, do not call rate limiting
@@ -50,6 +51,7 @@ private:
   const google::api::expr::v1alpha1::Expr input_expr_;
   const std::string descriptor_key_;
   const bool skip_if_error_;
+  const Filters::Common::Expr::ContextAttributes attributes_;
   Extensions::Filters::Common::Expr::ExpressionPtr compiled_expr_;
 };
 
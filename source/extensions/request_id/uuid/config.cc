@@ -16,7 +16,9 @@ void UUIDRequestIDExtension::set(Http::RequestHeaderMap& request_headers, bool f
   }
 
   // TODO(PiotrSikora) PERF: Write UUID directly to the header map.
-  std::string uuid = random_.uuid();
+  std::string uuid = use_non_cryptographic_random_
+                         ? Random::RandomGeneratorImpl::nonCryptographicUuid()
+                         : random_.uuid();
   ASSERT(!uuid.empty());
   request_headers.setRequestId(uuid);
 }
@@ -0,0 +1,198 @@
+#include "source/extensions/resource_monitors/cgroup/cgroup_monitor.h"
+
+#include <algorithm>
+
+#include "envoy/common/exception.h"
+#include "envoy/extensions/resource_monitors/cgroup/v3/cgroup.pb.h"
+
+#include "source/common/common/assert.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMonitor {
+namespace {
+
+using envoy::extensions::resource_monitors::cgroup::v3::CgroupConfig;
+
+constexpr absl::string_view DefaultCgroupPath = "/sys/fs/cgroup";
+// cgroup v1 reports the lack of memory limit as the largest page aligned signed 64 bits value.
+constexpr uint64_t NoMemoryLimitV1 = uint64_t(1) << 62;
+
+// Parses the value of a file holding a single number, or "max" on cgroup v2 for no limit.
+absl::optional<uint64_t> parseValue(absl::string_view contents, const std::string& path) {
+  contents = absl::StripAsciiWhitespace(contents);
+  if (contents == "max") {
+    return absl::nullopt;
+  }
+  uint64_t value;
+  if (!absl::SimpleAtoi(contents, &value)) {
+    throw EnvoyException(absl::StrCat("unable to parse the value of ", path));
+  }
+  return value;
+}
+
+} // namespace
+
+CgroupMonitor::CgroupMonitor(const CgroupConfig& config, Filesystem::Instance& file_system)
+    : file_system_(file_system), resource_(config.resource()),
+      max_memory_bytes_(config.max_memory_bytes()),
+      exclude_inactive_file_(config.exclude_inactive_file()) {
+  const std::string root(absl::StripSuffix(
+      config.cgroup_path().empty() ? DefaultCgroupPath : config.cgroup_path(), "/"));
+  cgroup_v2_ = file_system_.fileExists(absl::StrCat(root, "/cgroup.controllers"));
+
+  switch (resource_) {
+  case CgroupConfig::MEMORY:
+    if (cgroup_v2_) {
+      usage_path_ = absl::StrCat(root, "/memory.current");
+      limit_path_ = absl::StrCat(root, "/memory.max");
+      stat_path_ = absl::StrCat(root, "/memory.stat");
+    } else {
+      usage_path_ = absl::StrCat(root, "/memory/memory.usage_in_bytes");
+      limit_path_ = absl::StrCat(root, "/memory/memory.limit_in_bytes");
+      stat_path_ = absl::StrCat(root, "/memory/memory.stat");
+    }
+    return;
+  case CgroupConfig::CPU_THROTTLING:
+    stat_path_ = absl::StrCat(root, cgroup_v2_ ? "/cpu.stat" : "/cpu/cpu.stat");
+    return;
+  case CgroupConfig::MEMORY_PRESSURE:
+    usage_path_ = absl::StrCat(root, "/memory.pressure");
+    break;
+  case CgroupConfig::CPU_PRESSURE:
+    usage_path_ = absl::StrCat(root, "/cpu.pressure");
+    break;
+  case CgroupConfig::IO_PRESSURE:
+    usage_path_ = absl::StrCat(root, "/io.pressure");
+    break;
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+
+  if (!cgroup_v2_) {
+    throw EnvoyException(
+        absl::StrCat("the pressure stall information of ", root, " requires cgroup v2"));
+  }
+}
+
+void CgroupMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  Server::ResourceUsage usage;
+  TRY_ASSERT_MAIN_THREAD {
+    switch (resource_) {
+    case CgroupConfig::MEMORY:
+      usage.resource_pressure_ = memoryPressure();
+      break;
+    case CgroupConfig::CPU_THROTTLING:
+      usage.resource_pressure_ = cpuThrottlingPressure();
+      break;
+    default:
+      usage.resource_pressure_ = stallPressure();
+      break;
+    }
+  }
+  END_TRY
+  catch (const EnvoyException& error) {
+    callbacks.onFailure(error);
+    return;
+  }
+  callbacks.onSuccess(usage);
+}
+
+double CgroupMonitor::memoryPressure() {
+  const absl::optional<uint64_t> used =
+      parseValue(file_system_.fileReadToEnd(usage_path_), usage_path_);
+  if (!used.has_value()) {
+    throw EnvoyException(absl::StrCat("unable to parse the value of ", usage_path_));
+  }
+
+  absl::optional<uint64_t> limit = parseValue(file_system_.fileReadToEnd(limit_path_), limit_path_);
+  if (limit.has_value() && !cgroup_v2_ && limit.value() >= NoMemoryLimitV1) {
+    limit.reset();
+  }
+  if (max_memory_bytes_ > 0) {
+    limit = std::min(limit.value_or(max_memory_bytes_), max_memory_bytes_);
+  }
+  if (!limit.has_value() || limit.value() == 0) {
+    throw EnvoyException(absl::StrCat("no memory limit in ", limit_path_));
+  }
+
+  uint64_t working_set = used.value();
+  if (exclude_inactive_file_) {
+    // The hierarchical total is the one accounted in the usage on cgroup v1.
+    const uint64_t inactive_file =
+        readField(stat_path_, cgroup_v2_ ? "inactive_file" : "total_inactive_file");
+    working_set -= std::min(working_set, inactive_file);
+  }
+  return working_set / static_cast<double>(limit.value());
+}
+
+double CgroupMonitor::cpuThrottlingPressure() {
+  const std::string contents = file_system_.fileReadToEnd(stat_path_);
+  absl::optional<uint64_t> periods;
+  absl::optional<uint64_t> throttled;
+  for (absl::string_view line : absl::StrSplit(contents, '\n', absl::SkipEmpty())) {
+    std::pair<absl::string_view, absl::string_view> field = absl::StrSplit(line, ' ');
+    uint64_t value;
+    if (!absl::SimpleAtoi(field.second, &value)) {
+      continue;
+    }
+    if (field.first == "nr_periods") {
+      periods = value;
+    } else if (field.first == "nr_throttled") {
+      throttled = value;
+    }
+  }
+  if (!periods.has_value() || !throttled.has_value()) {
+    throw EnvoyException(absl::StrCat("no CPU bandwidth periods in ", stat_path_));
+  }
+
+  // The counters only ever grow, the pressure is computed over the periods since the last update.
+  const absl::optional<std::pair<uint64_t, uint64_t>> last = last_cpu_periods_;
+  last_cpu_periods_ = {periods.value(), throttled.value()};
+  if (!last.has_value() || periods.value() <= last->first || throttled.value() < last->second) {
+    return 0;
+  }
+  const uint64_t new_throttled = throttled.value() - last->second;
+  const uint64_t new_periods = periods.value() - last->first;
+  return std::min(1.0, new_throttled / static_cast<double>(new_periods));
+}
+
+double CgroupMonitor::stallPressure() {
+  const std::string contents = file_system_.fileReadToEnd(usage_path_);
+  for (absl::string_view line : absl::StrSplit(contents, '\n', absl::SkipEmpty())) {
+    if (!absl::ConsumePrefix(&line, "some ")) {
+      continue;
+    }
+    for (absl::string_view average : absl::StrSplit(line, ' ', absl::SkipEmpty())) {
+      double percent;
+      if (absl::ConsumePrefix(&average, "avg10=") && absl::SimpleAtod(average, &percent)) {
+        return std::min(1.0, std::max(0.0, percent / 100));
+      }
+    }
+  }
+  throw EnvoyException(absl::StrCat("no 10 seconds average of stalled tasks in ", usage_path_));
+}
+
+uint64_t CgroupMonitor::readField(const std::string& path, absl::string_view key) {
+  const std::string contents = file_system_.fileReadToEnd(path);
+  for (absl::string_view line : absl::StrSplit(contents, '\n', absl::SkipEmpty())) {
+    std::pair<absl::string_view, absl::string_view> field = absl::StrSplit(line, ' ');
+    uint64_t value;
+    if (field.first == key && absl::SimpleAtoi(field.second, &value)) {
+      return value;
+    }
+  }
+  throw EnvoyException(absl::StrCat("no ", key, " in ", path));
+}
+
+} // namespace CgroupMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
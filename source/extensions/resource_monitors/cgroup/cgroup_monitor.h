@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "envoy/extensions/resource_monitors/cgroup/v3/cgroup.pb.h"
+#include "envoy/filesystem/filesystem.h"
+#include "envoy/server/resource_monitor.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMonitor {
+
+/**
+ * Monitor of a resource of a cgroup, read from the cgroup v2 or v1 filesystem. The version of the
+ * cgroup and the files of the resource are resolved once, when the monitor is created.
+ */
+class CgroupMonitor : public Server::ResourceMonitor {
+public:
+  CgroupMonitor(const envoy::extensions::resource_monitors::cgroup::v3::CgroupConfig& config,
+                Filesystem::Instance& file_system);
+
+  // Server::ResourceMonitor
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  using Resource = envoy::extensions::resource_monitors::cgroup::v3::CgroupConfig::Resource;
+
+  double memoryPressure();
+  double cpuThrottlingPressure();
+  double stallPressure();
+  uint64_t readField(const std::string& path, absl::string_view key);
+
+  Filesystem::Instance& file_system_;
+  const Resource resource_;
+  const uint64_t max_memory_bytes_;
+  const bool exclude_inactive_file_;
+  bool cgroup_v2_{};
+  // The files read for the resource, the unused ones are empty.
+  std::string usage_path_;
+  std::string limit_path_;
+  std::string stat_path_;
+  // The CPU bandwidth periods and throttled periods of the previous update.
+  absl::optional<std::pair<uint64_t, uint64_t>> last_cpu_periods_;
+};
+
+} // namespace CgroupMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,29 @@
+#include "source/extensions/resource_monitors/cgroup/config.h"
+
+#include "envoy/extensions/resource_monitors/cgroup/v3/cgroup.pb.h"
+#include "envoy/extensions/resource_monitors/cgroup/v3/cgroup.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/resource_monitors/cgroup/cgroup_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMonitor {
+
+Server::ResourceMonitorPtr CgroupMonitorFactory::createResourceMonitorFromProtoTyped(
+    const envoy::extensions::resource_monitors::cgroup::v3::CgroupConfig& config,
+    Server::Configuration::ResourceMonitorFactoryContext& context) {
+  return std::make_unique<CgroupMonitor>(config, context.api().fileSystem());
+}
+
+/**
+ * Static registration for the cgroup resource monitor factory. @see RegistryFactory.
+ */
+REGISTER_FACTORY(CgroupMonitorFactory, Server::Configuration::ResourceMonitorFactory);
+
+} // namespace CgroupMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
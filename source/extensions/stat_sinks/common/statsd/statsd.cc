@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <string>
 
 #include "envoy/buffer/buffer.h"
@@ -21,6 +22,7 @@
 #include "source/common/network/utility.h"
 #include "source/common/stats/symbol_table_impl.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 
 namespace Envoy {
@@ -40,8 +42,32 @@ void UdpStatsdSink::WriterImpl::write(const std::string& message) {
   Network::Utility::writeToSocket(*io_handle_, &slice, 1, nullptr, *parent_.server_address_);
 }
 
-void UdpStatsdSink::WriterImpl::writeBuffer(Buffer::Instance& data) {
-  Network::Utility::writeToSocket(*io_handle_, data, nullptr, *parent_.server_address_);
+void UdpStatsdSink::WriterImpl::writeDatagrams(const std::vector<std::string>& messages) {
+  if (!io_handle_->supportsMmsg()) {
+    Writer::writeDatagrams(messages);
+    return;
+  }
+
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  std::vector<struct mmsghdr> headers(messages.size());
+  std::vector<struct iovec> iovs(messages.size());
+  for (size_t i = 0; i < messages.size(); i++) {
+    iovs[i].iov_base = const_cast<char*>(messages[i].data());
+    iovs[i].iov_len = messages[i].size();
+    struct msghdr& header = headers[i].msg_hdr;
+    memset(&header, 0, sizeof(header));
+    header.msg_name = const_cast<sockaddr*>(parent_.server_address_->sockAddr());
+    header.msg_namelen = parent_.server_address_->sockAddrLen();
+    header.msg_iov = &iovs[i];
+    header.msg_iovlen = 1;
+  }
+  size_t sent = 0;
+  while (sent < messages.size()) {
+    const Api::SysCallIntResult result = os_sys_calls.sendmmsg(
+        io_handle_->fdDoNotUse(), headers.data() + sent, messages.size() - sent, 0);
+    // Like with write(), a datagram which fails to be sent is dropped.
+    sent += result.return_value_ > 0 ? result.return_value_ : 1;
+  }
 }
 
 UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
@@ -57,52 +83,99 @@ UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
 }
 
 void UdpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
-  Writer& writer = tls_->getTyped<Writer>();
-  Buffer::OwnedImpl buffer;
+  DatagramWriter writer(tls_->getTyped<Writer>(), buffer_size_);
+  flushes_++;
 
   for (const auto& counter : snapshot.counters()) {
     if (counter.counter_.get().used()) {
-      const std::string counter_str = buildMessage(counter.counter_.get(), counter.delta_, "|c");
-      writeBuffer(buffer, writer, counter_str);
+      flushMetric(counter.counter_.get(), counter.delta_, "|c", writer);
     }
   }
 
   for (const auto& gauge : snapshot.gauges()) {
     if (gauge.get().used()) {
-      const std::string gauge_str = buildMessage(gauge.get(), gauge.get().value(), "|g");
-      writeBuffer(buffer, writer, gauge_str);
+      flushMetric(gauge.get(), gauge.get().value(), "|g", writer);
     }
   }
 
-  flushBuffer(buffer, writer);
+  writer.flush();
+  // Forget the stats which were not flushed, such as the removed ones.
+  absl::erase_if(rendered_stats_, [this](const auto& rendered_stat) {
+    return rendered_stat.second.flush_ != flushes_;
+  });
   // TODO(efimki): Add support of text readouts stats.
 }
 
-void UdpStatsdSink::writeBuffer(Buffer::OwnedImpl& buffer, Writer& writer,
-                                const std::string& statsd_metric) const {
-  if (statsd_metric.length() >= buffer_size_) {
-    // Our statsd_metric is too large to fit into the buffer, skip buffering and write directly
-    writer.write(statsd_metric);
-  } else {
-    if ((buffer.length() + statsd_metric.length() + 1) > buffer_size_) {
-      // If we add the new statsd_metric, we'll overflow our buffer. Flush the buffer to make
-      // room for the new statsd_metric.
-      flushBuffer(buffer, writer);
-    } else if (buffer.length() > 0) {
-      // We have room and have metrics already in the buffer, add a newline to separate
-      // metric entries.
-      buffer.add("\n");
+void UdpStatsdSink::flushMetric(const Stats::Metric& metric, uint64_t value,
+                                absl::string_view type, DatagramWriter& writer) {
+  message_.clear();
+  if (use_tag_) {
+    // The tags of a stat are extracted from its name, so its rendering changes with its name.
+    const std::string name = metric.name();
+    auto it = rendered_stats_.find(name);
+    if (it == rendered_stats_.end()) {
+      it = rendered_stats_.emplace(name, render(metric)).first;
     }
-    buffer.add(statsd_metric);
+    it->second.flush_ = flushes_;
+    absl::StrAppend(&message_, it->second.before_value_, value, type, it->second.after_type_);
+  } else {
+    absl::StrAppend(&message_, prefix_, ".", metric.name(), ":", value, type);
+  }
+  writer.add(message_);
+}
+
+UdpStatsdSink::RenderedStat UdpStatsdSink::render(const Stats::Metric& metric) const {
+  RenderedStat rendered;
+  switch (tag_format_.tag_position) {
+  case Statsd::TagPosition::TagAfterValue:
+    rendered.before_value_ = absl::StrCat(prefix_, ".", getName(metric), ":");
+    rendered.after_type_ = buildTagStr(metric.tags());
+    break;
+  case Statsd::TagPosition::TagAfterName:
+    rendered.before_value_ =
+        absl::StrCat(prefix_, ".", getName(metric), buildTagStr(metric.tags()), ":");
+    break;
   }
+  return rendered;
 }
 
-void UdpStatsdSink::flushBuffer(Buffer::OwnedImpl& buffer, Writer& writer) const {
-  if (buffer.length() == 0) {
+void UdpStatsdSink::DatagramWriter::add(const std::string& message) {
+  if (message.length() >= buffer_size_) {
+    // The message is too large to fit into the buffer, skip buffering and write it on its own.
+    addDatagram(message);
     return;
   }
-  writer.writeBuffer(buffer);
-  buffer.drain(buffer.length());
+  if (buffer_.length() + message.length() + 1 > buffer_size_) {
+    // If we add the new message, we'll overflow our buffer. Flush the buffer to make room for
+    // the new message.
+    if (!buffer_.empty()) {
+      addDatagram(std::move(buffer_));
+      buffer_.clear();
+    }
+  } else if (!buffer_.empty()) {
+    // We have room and have messages already in the buffer, add a newline to separate them.
+    buffer_.push_back('\n');
+  }
+  buffer_.append(message);
+}
+
+void UdpStatsdSink::DatagramWriter::flush() {
+  if (!buffer_.empty()) {
+    addDatagram(std::move(buffer_));
+    buffer_.clear();
+  }
+  if (!datagrams_.empty()) {
+    writer_.writeDatagrams(datagrams_);
+    datagrams_.clear();
+  }
+}
+
+void UdpStatsdSink::DatagramWriter::addDatagram(std::string datagram) {
+  datagrams_.push_back(std::move(datagram));
+  if (datagrams_.size() == DatagramsPerWrite) {
+    writer_.writeDatagrams(datagrams_);
+    datagrams_.clear();
+  }
 }
 
 void UdpStatsdSink::onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) {
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "envoy/buffer/buffer.h"
 #include "envoy/common/platform.h"
 #include "envoy/local_info/local_info.h"
@@ -17,6 +20,8 @@
 #include "source/common/network/io_socket_handle_impl.h"
 #include "source/extensions/stat_sinks/common/statsd/tag_formats.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -38,7 +43,16 @@ public:
   class Writer : public ThreadLocal::ThreadLocalObject {
   public:
     virtual void write(const std::string& message) PURE;
-    virtual void writeBuffer(Buffer::Instance& data) PURE;
+
+    /**
+     * Write each of the messages as a datagram, by default one at a time with write().
+     * @param messages the messages to write, in order.
+     */
+    virtual void writeDatagrams(const std::vector<std::string>& messages) {
+      for (const std::string& message : messages) {
+        write(message);
+      }
+    }
   };
 
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, Network::Address::InstanceConstSharedPtr address,
@@ -75,16 +89,46 @@ private:
 
     // Writer
     void write(const std::string& message) override;
-    void writeBuffer(Buffer::Instance& data) override;
+    // Sends the datagrams with sendmmsg() where it is supported.
+    void writeDatagrams(const std::vector<std::string>& messages) override;
 
   private:
     UdpStatsdSink& parent_;
     const Network::IoHandlePtr io_handle_;
   };
 
-  void flushBuffer(Buffer::OwnedImpl& buffer, Writer& writer) const;
-  void writeBuffer(Buffer::OwnedImpl& buffer, Writer& writer, const std::string& data) const;
+  // The parts of the message of a stat around its value and type, which only depend on its name.
+  struct RenderedStat {
+    std::string before_value_;
+    std::string after_type_;
+    // The flush which last used the rendering.
+    uint64_t flush_{};
+  };
+
+  // Packs the messages of a flush into datagrams, and writes them in batches.
+  class DatagramWriter {
+  public:
+    DatagramWriter(Writer& writer, uint64_t buffer_size)
+        : writer_(writer), buffer_size_(buffer_size) {}
+
+    void add(const std::string& message);
+    void flush();
+
+  private:
+    // The datagrams written at once.
+    static constexpr size_t DatagramsPerWrite = 64;
+
+    void addDatagram(std::string datagram);
+
+    Writer& writer_;
+    const uint64_t buffer_size_;
+    std::string buffer_;
+    std::vector<std::string> datagrams_;
+  };
 
+  void flushMetric(const Stats::Metric& metric, uint64_t value, absl::string_view type,
+                   DatagramWriter& writer);
+  RenderedStat render(const Stats::Metric& metric) const;
   const std::string buildMessage(const Stats::Metric& metric, uint64_t value,
                                  const std::string& type) const;
   const std::string getName(const Stats::Metric& metric) const;
@@ -97,6 +141,11 @@ private:
   const std::string prefix_;
   const uint64_t buffer_size_;
   const Statsd::TagFormat tag_format_;
+  // The renderings of the tagged stats by name, as decoding and joining their tags is the most
+  // costly part of a flush. Only used by flush() on the main thread.
+  absl::flat_hash_map<std::string, RenderedStat> rendered_stats_;
+  uint64_t flushes_{};
+  std::string message_;
 };
 
 /**
@@ -4,6 +4,7 @@
 #include <ctime>
 #include <iostream>
 #include <sstream>
+#include <string>
 
 #include "envoy/stats/scope.h"
 
@@ -43,26 +44,27 @@ void ClusterStatsCache::printToStream(std::stringstream& out_str) {
   printRollingWindow(absl::StrCat(cluster_name_prefix, "total"), total_, out_str);
 }
 
-void ClusterStatsCache::printRollingWindow(absl::string_view name, RollingWindow rolling_window,
+void ClusterStatsCache::printRollingWindow(absl::string_view name,
+                                           const RollingWindow& rolling_window,
                                            std::stringstream& out_str) {
   out_str << name << " | ";
-  for (uint64_t& specific_stat_vec_itr : rolling_window) {
+  for (const uint64_t specific_stat_vec_itr : rolling_window) {
     out_str << specific_stat_vec_itr << " | ";
   }
   out_str << std::endl;
 }
 
 void HystrixSink::addHistogramToStream(const QuantileLatencyMap& latency_map, absl::string_view key,
-                                       std::stringstream& ss) {
+                                       std::string& ss) {
   // TODO: Consider if we better use join here
-  ss << ", \"" << key << "\": {";
+  absl::StrAppend(&ss, ", \"", key, "\": {");
   bool is_first = true;
   for (const auto& element : latency_map) {
     const std::string quantile = fmt::sprintf("%g", element.first * 100);
     HystrixSink::addDoubleToStream(quantile, element.second, ss, is_first);
     is_first = false;
   }
-  ss << "}";
+  ss += "}";
 }
 
 // Add new value to rolling window, in place of oldest one.
@@ -74,7 +76,7 @@ void HystrixSink::pushNewValue(RollingWindow& rolling_window, uint64_t value) {
   }
 }
 
-uint64_t HystrixSink::getRollingValue(RollingWindow rolling_window) {
+uint64_t HystrixSink::getRollingValue(const RollingWindow& rolling_window) {
 
   if (rolling_window.empty()) {
     return 0;
@@ -122,46 +124,45 @@ void HystrixSink::updateRollingWindowMap(const Upstream::ClusterInfo& cluster_in
   // leading to wrong results such as error percentage higher than 100%
   uint64_t total = errors + timeouts + success + rejected;
   pushNewValue(cluster_stats_cache.total_, total);
-
-  ENVOY_LOG(trace, "{}", printRollingWindows());
 }
 
 void HystrixSink::resetRollingWindow() { cluster_stats_cache_map_.clear(); }
 
 void HystrixSink::addStringToStream(absl::string_view key, absl::string_view value,
-                                    std::stringstream& info, bool is_first) {
-  std::string quoted_value = absl::StrCat("\"", value, "\"");
-  addInfoToStream(key, quoted_value, info, is_first);
+                                    std::string& info, bool is_first) {
+  if (!is_first) {
+    info += ", ";
+  }
+  absl::StrAppend(&info, "\"", key, "\": \"", value, "\"");
 }
 
-void HystrixSink::addIntToStream(absl::string_view key, uint64_t value, std::stringstream& info,
+void HystrixSink::addIntToStream(absl::string_view key, uint64_t value, std::string& info,
                                  bool is_first) {
-  addInfoToStream(key, std::to_string(value), info, is_first);
+  addInfoToStream(key, absl::AlphaNum(value).Piece(), info, is_first);
 }
 
-void HystrixSink::addDoubleToStream(absl::string_view key, double value, std::stringstream& info,
+void HystrixSink::addDoubleToStream(absl::string_view key, double value, std::string& info,
                                     bool is_first) {
   addInfoToStream(key, std::to_string(value), info, is_first);
 }
 
 void HystrixSink::addInfoToStream(absl::string_view key, absl::string_view value,
-                                  std::stringstream& info, bool is_first) {
+                                  std::string& info, bool is_first) {
   if (!is_first) {
-    info << ", ";
+    info += ", ";
   }
-  std::string added_info = absl::StrCat("\"", key, "\": ", value);
-  info << added_info;
+  absl::StrAppend(&info, "\"", key, "\": ", value);
 }
 
 void HystrixSink::addHystrixCommand(ClusterStatsCache& cluster_stats_cache,
                                     absl::string_view cluster_name,
                                     uint64_t max_concurrent_requests, uint64_t reporting_hosts,
                                     std::chrono::milliseconds rolling_window_ms,
-                                    const QuantileLatencyMap& histogram, std::stringstream& ss) {
+                                    const QuantileLatencyMap& histogram, std::string& ss) {
 
   std::time_t currentTime = std::chrono::system_clock::to_time_t(server_.timeSource().systemTime());
 
-  ss << "data: {";
+  ss += "data: {";
   addStringToStream("type", "HystrixCommand", ss, true);
   addStringToStream("name", cluster_name, ss);
   addStringToStream("group", "NA", ss);
@@ -218,15 +219,15 @@ void HystrixSink::addHystrixCommand(ClusterStatsCache& cluster_stats_cache,
   addIntToStream("propertyValue_metricsRollingStatisticalWindowInMilliseconds",
                  rolling_window_ms.count(), ss);
 
-  ss << "}" << std::endl << std::endl;
+  ss += "}\n\n";
 }
 
 void HystrixSink::addHystrixThreadPool(absl::string_view cluster_name, uint64_t queue_size,
                                        uint64_t reporting_hosts,
                                        std::chrono::milliseconds rolling_window_ms,
-                                       std::stringstream& ss) {
+                                       std::string& ss) {
 
-  ss << "data: {";
+  ss += "data: {";
   addIntToStream("currentPoolSize", 0, ss, true);
   addIntToStream("rollingMaxActiveThreads", 0, ss);
   addIntToStream("currentActiveCount", 0, ss);
@@ -244,7 +245,7 @@ void HystrixSink::addHystrixThreadPool(absl::string_view cluster_name, uint64_t
   addIntToStream("rollingCountThreadsExecuted", 0, ss);
   addIntToStream("currentMaximumPoolSize", 0, ss);
 
-  ss << "}" << std::endl << std::endl;
+  ss += "}\n\n";
 }
 
 void HystrixSink::addClusterStatsToStream(ClusterStatsCache& cluster_stats_cache,
@@ -252,8 +253,7 @@ void HystrixSink::addClusterStatsToStream(ClusterStatsCache& cluster_stats_cache
                                           uint64_t max_concurrent_requests,
                                           uint64_t reporting_hosts,
                                           std::chrono::milliseconds rolling_window_ms,
-                                          const QuantileLatencyMap& histogram,
-                                          std::stringstream& ss) {
+                                          const QuantileLatencyMap& histogram, std::string& ss) {
 
   addHystrixCommand(cluster_stats_cache, cluster_name, max_concurrent_requests, reporting_hosts,
                     rolling_window_ms, histogram, ss);
@@ -261,6 +261,14 @@ void HystrixSink::addClusterStatsToStream(ClusterStatsCache& cluster_stats_cache
                        ss);
 }
 
+ClusterStatsCache& HystrixSink::clusterStatsCache(const std::string& cluster_name) {
+  ClusterStatsCachePtr& cluster_stats_cache = cluster_stats_cache_map_[cluster_name];
+  if (cluster_stats_cache == nullptr) {
+    cluster_stats_cache = std::make_unique<ClusterStatsCache>(cluster_name);
+  }
+  return *cluster_stats_cache;
+}
+
 const std::string HystrixSink::printRollingWindows() {
   std::stringstream out_str;
 
@@ -342,22 +350,20 @@ void HystrixSink::flush(Stats::MetricSnapshot& snapshot) {
     return;
   }
   incCounter();
-  std::stringstream ss;
+  flush_count_++;
   Upstream::ClusterManager::ClusterInfoMaps all_clusters = server_.clusterManager().clusters();
 
-  // Save a map of the relevant histograms per cluster in a convenient format.
-  absl::node_hash_map<std::string, QuantileLatencyMap> time_histograms;
+  // Save the relevant histograms in the cache of their cluster, in a convenient format.
   for (const auto& histogram : snapshot.histograms()) {
     if (histogram.get().tagExtractedStatName() == cluster_upstream_rq_time_) {
       absl::optional<Stats::StatName> value =
           Stats::Utility::findTag(histogram.get(), cluster_name_);
       // Make sure we found the cluster name tag
       ASSERT(value);
-      std::string value_str = server_.scope().symbolTable().toString(*value);
-      auto it_bool_pair = time_histograms.emplace(std::make_pair(value_str, QuantileLatencyMap()));
+      QuantileLatencyMap& hist_map =
+          clusterStatsCache(server_.scope().symbolTable().toString(*value)).latency_;
       // Make sure histogram with this name was not already added
-      ASSERT(it_bool_pair.second);
-      QuantileLatencyMap& hist_map = it_bool_pair.first->second;
+      ASSERT(hist_map.empty());
 
       const std::vector<double>& supported_quantiles =
           histogram.get().intervalStatistics().supportedQuantiles();
@@ -367,38 +373,38 @@ void HystrixSink::flush(Stats::MetricSnapshot& snapshot) {
             hystrix_quantiles.end()) {
           const double value = histogram.get().intervalStatistics().computedQuantiles()[i];
           if (!std::isnan(value)) {
-            hist_map[supported_quantiles[i]] = value;
+            hist_map.emplace_back(supported_quantiles[i], value);
           }
         }
       }
     }
   }
 
+  // Clearing keeps the capacity of the previous flush, so the stream is not grown again.
+  event_stream_.clear();
   for (auto& cluster : all_clusters.active_clusters_) {
     Upstream::ClusterInfoConstSharedPtr cluster_info = cluster.second.get().info();
-
-    std::unique_ptr<ClusterStatsCache>& cluster_stats_cache_ptr =
-        cluster_stats_cache_map_[cluster_info->name()];
-    if (cluster_stats_cache_ptr == nullptr) {
-      cluster_stats_cache_ptr = std::make_unique<ClusterStatsCache>(cluster_info->name());
-    }
+    ClusterStatsCache& cluster_stats_cache = clusterStatsCache(cluster_info->name());
+    cluster_stats_cache.flush_ = flush_count_;
 
     // update rolling window with cluster stats
-    updateRollingWindowMap(*cluster_info, *cluster_stats_cache_ptr);
+    updateRollingWindowMap(*cluster_info, cluster_stats_cache);
 
     // append it to stream to be sent
     addClusterStatsToStream(
-        *cluster_stats_cache_ptr, cluster_info->name(),
+        cluster_stats_cache, cluster_info->name(),
         cluster_info->resourceManager(Upstream::ResourcePriority::Default).pendingRequests().max(),
         cluster_info->statsScope()
             .gaugeFromStatName(membership_total_, Stats::Gauge::ImportMode::NeverImport)
             .value(),
-        server_.statsConfig().flushInterval(), time_histograms[cluster_info->name()], ss);
+        server_.statsConfig().flushInterval(), cluster_stats_cache.latency_, event_stream_);
+    cluster_stats_cache.latency_.clear();
   }
+  ENVOY_LOG(trace, "{}", printRollingWindows());
 
   Buffer::OwnedImpl data;
   for (auto callbacks : callbacks_list_) {
-    data.add(ss.str());
+    data.add(event_stream_);
     callbacks->encodeData(data, false);
   }
 
@@ -410,18 +416,10 @@ void HystrixSink::flush(Stats::MetricSnapshot& snapshot) {
     callbacks->encodeData(ping_data, false);
   }
 
-  // check if any clusters were removed, and remove from cache
-  if (all_clusters.active_clusters_.size() < cluster_stats_cache_map_.size()) {
-    for (auto it = cluster_stats_cache_map_.begin(); it != cluster_stats_cache_map_.end();) {
-      if (all_clusters.active_clusters_.find(it->first) == all_clusters.active_clusters_.end()) {
-        auto next_it = std::next(it);
-        cluster_stats_cache_map_.erase(it);
-        it = next_it;
-      } else {
-        ++it;
-      }
-    }
-  }
+  // Remove the cache of the clusters which were not active in this flush.
+  absl::erase_if(cluster_stats_cache_map_, [this](const auto& entry) {
+    return entry.second->flush_ != flush_count_;
+  });
 }
 
 void HystrixSink::registerConnection(Http::StreamDecoderFilterCallbacks* callbacks_to_register) {
@@ -2,6 +2,8 @@
 
 #include <map>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "envoy/server/admin.h"
@@ -11,6 +13,8 @@
 
 #include "source/common/stats/symbol_table_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace StatSinks {
@@ -19,7 +23,8 @@ namespace Hystrix {
 using RollingWindow = std::vector<uint64_t>;
 using RollingStatsMap = std::map<const std::string, RollingWindow>;
 
-using QuantileLatencyMap = absl::node_hash_map<double, double>;
+// Pairs of quantile and latency, in the order of the supported quantiles of the histogram.
+using QuantileLatencyMap = std::vector<std::pair<double, double>>;
 static const std::vector<double> hystrix_quantiles = {0,    0.25, 0.5,   0.75, 0.90,
                                                       0.95, 0.99, 0.995, 1};
 
@@ -31,9 +36,13 @@ struct ClusterStatsCache {
   ClusterStatsCache(const std::string& cluster_name);
 
   void printToStream(std::stringstream& out_str);
-  void printRollingWindow(absl::string_view name, RollingWindow rolling_window,
+  void printRollingWindow(absl::string_view name, const RollingWindow& rolling_window,
                           std::stringstream& out_str);
   std::string cluster_name_;
+  // The last flush the cluster was active in, to remove the windows of the clusters which are gone.
+  uint64_t flush_{};
+  // The latency quantiles of the cluster in the current flush.
+  QuantileLatencyMap latency_;
 
   // Rolling windows
   RollingWindow errors_;
@@ -80,7 +89,7 @@ public:
                                absl::string_view cluster_name, uint64_t max_concurrent_requests,
                                uint64_t reporting_hosts,
                                std::chrono::milliseconds rolling_window_ms,
-                               const QuantileLatencyMap& histogram, std::stringstream& ss);
+                               const QuantileLatencyMap& histogram, std::string& ss);
 
   /**
    * Calculate values needed to create the stream and write into the map.
@@ -100,62 +109,71 @@ public:
   /**
    * Get the statistic's value change over the rolling window time frame.
    */
-  uint64_t getRollingValue(RollingWindow rolling_window);
+  uint64_t getRollingValue(const RollingWindow& rolling_window);
 
   /**
-   * Format the given key and value to "key"=value, and adding to the stringstream.
+   * Format the given key and value to "key"=value, and adding to the string.
    */
   static void addInfoToStream(absl::string_view key, absl::string_view value,
-                              std::stringstream& info, bool is_first = false);
+                              std::string& info, bool is_first = false);
 
   /**
    * Format the given key and double value to "key"=<string of uint64_t>, and adding to the
-   * stringstream.
+   * string.
    */
-  static void addDoubleToStream(absl::string_view key, double value, std::stringstream& info,
+  static void addDoubleToStream(absl::string_view key, double value, std::string& info,
                                 bool is_first);
 
   /**
    * Format the given key and absl::string_view value to "key"="value", and adding to the
-   * stringstream.
+   * string.
    */
   static void addStringToStream(absl::string_view key, absl::string_view value,
-                                std::stringstream& info, bool is_first = false);
+                                std::string& info, bool is_first = false);
 
   /**
    * Format the given key and uint64_t value to "key"=<string of uint64_t>, and adding to the
-   * stringstream.
+   * string.
    */
-  static void addIntToStream(absl::string_view key, uint64_t value, std::stringstream& info,
+  static void addIntToStream(absl::string_view key, uint64_t value, std::string& info,
                              bool is_first = false);
 
   static void addHistogramToStream(const QuantileLatencyMap& latency_map, absl::string_view key,
-                                   std::stringstream& ss);
+                                   std::string& ss);
 
 private:
+  /**
+   * Get the cache of the cluster, creating it if needed.
+   */
+  ClusterStatsCache& clusterStatsCache(const std::string& cluster_name);
+
   /**
    * Generate HystrixCommand event stream.
    */
   void addHystrixCommand(ClusterStatsCache& cluster_stats_cache, absl::string_view cluster_name,
                          uint64_t max_concurrent_requests, uint64_t reporting_hosts,
                          std::chrono::milliseconds rolling_window_ms,
-                         const QuantileLatencyMap& histogram, std::stringstream& ss);
+                         const QuantileLatencyMap& histogram, std::string& ss);
 
   /**
    * Generate HystrixThreadPool event stream.
    */
   void addHystrixThreadPool(absl::string_view cluster_name, uint64_t queue_size,
                             uint64_t reporting_hosts, std::chrono::milliseconds rolling_window_ms,
-                            std::stringstream& ss);
+                            std::string& ss);
 
   std::vector<Http::StreamDecoderFilterCallbacks*> callbacks_list_;
   Server::Configuration::ServerFactoryContext& server_;
   uint64_t current_index_;
   const uint64_t window_size_;
   static const uint64_t DEFAULT_NUM_BUCKETS = 10;
+  uint64_t flush_count_{};
 
   // Map from cluster names to a struct of all of that cluster's stat windows.
-  absl::node_hash_map<std::string, ClusterStatsCachePtr> cluster_stats_cache_map_;
+  absl::flat_hash_map<std::string, ClusterStatsCachePtr> cluster_stats_cache_map_;
+
+  // The event stream of the last flush, kept to reuse its capacity.
+  std::string event_stream_;
 
   // Saved StatNames for fast comparisons in loop.
   // TODO(mattklein123): Many/all of these stats should just be pulled directly from the cluster
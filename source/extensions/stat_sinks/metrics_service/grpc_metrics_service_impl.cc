@@ -1,6 +1,8 @@
 #include "source/extensions/stat_sinks/metrics_service/grpc_metrics_service_impl.h"
 
+#include <algorithm>
 #include <chrono>
+#include <vector>
 
 #include "envoy/common/exception.h"
 #include "envoy/event/dispatcher.h"
@@ -20,7 +22,7 @@ namespace MetricsService {
 
 GrpcMetricsStreamerImpl::GrpcMetricsStreamerImpl(
     Grpc::AsyncClientFactoryPtr&& factory, const LocalInfo::LocalInfo& local_info,
-    envoy::config::core::v3::ApiVersion transport_api_version)
+    envoy::config::core::v3::ApiVersion transport_api_version, uint32_t max_metrics_per_message)
     : GrpcMetricsStreamer<envoy::service::metrics::v3::StreamMetricsMessage,
                           envoy::service::metrics::v3::StreamMetricsResponse>(*factory),
       local_info_(local_info),
@@ -28,25 +30,55 @@ GrpcMetricsStreamerImpl::GrpcMetricsStreamerImpl(
           Grpc::VersionedMethods("envoy.service.metrics.v3.MetricsService.StreamMetrics",
                                  "envoy.service.metrics.v2.MetricsService.StreamMetrics")
               .getMethodDescriptorForVersion(transport_api_version)),
-      transport_api_version_(transport_api_version) {}
+      transport_api_version_(transport_api_version),
+      max_metrics_per_message_(max_metrics_per_message) {}
 
 void GrpcMetricsStreamerImpl::send(MetricsPtr&& metrics) {
-  envoy::service::metrics::v3::StreamMetricsMessage message;
-  message.mutable_envoy_metrics()->Reserve(metrics->size());
-  message.mutable_envoy_metrics()->MergeFrom(*metrics);
+  if (max_metrics_per_message_ == 0 ||
+      static_cast<uint32_t>(metrics->size()) <= max_metrics_per_message_) {
+    envoy::service::metrics::v3::StreamMetricsMessage message;
+    // The metrics are moved into the message, which only swaps their pointers.
+    message.mutable_envoy_metrics()->Swap(metrics.get());
+    sendMessage(message);
+    return;
+  }
+
+  // The metric families are released from the metrics once, then added to each message in turn.
+  std::vector<io::prometheus::client::MetricFamily*> families(metrics->size());
+  metrics->ExtractSubrange(0, metrics->size(), families.data());
+  for (size_t first = 0; first < families.size(); first += max_metrics_per_message_) {
+    envoy::service::metrics::v3::StreamMetricsMessage message;
+    const size_t last = std::min<size_t>(first + max_metrics_per_message_, families.size());
+    message.mutable_envoy_metrics()->Reserve(last - first);
+    for (size_t i = first; i < last; i++) {
+      message.mutable_envoy_metrics()->AddAllocated(families[i]);
+    }
+    if (!sendMessage(message)) {
+      // The metric families which are not sent are dropped.
+      for (size_t i = last; i < families.size(); i++) {
+        delete families[i];
+      }
+      return;
+    }
+  }
+}
 
+bool GrpcMetricsStreamerImpl::sendMessage(
+    envoy::service::metrics::v3::StreamMetricsMessage& message) {
   if (stream_ == nullptr) {
     stream_ = client_->start(service_method_, *this, Http::AsyncClient::StreamOptions());
     // For perf reasons, the identifier is only sent on establishing the stream.
     auto* identifier = message.mutable_identifier();
     *identifier->mutable_node() = local_info_.node();
   }
-  if (stream_ != nullptr) {
-    stream_->sendMessage(message, transport_api_version_, false);
+  if (stream_ == nullptr) {
+    return false;
   }
+  stream_->sendMessage(message, transport_api_version_, false);
+  return true;
 }
 
-MetricsPtr MetricsFlusher::flush(Stats::MetricSnapshot& snapshot) const {
+MetricsPtr MetricsFlusher::flush(Stats::MetricSnapshot& snapshot) {
   auto metrics =
       std::make_unique<Envoy::Protobuf::RepeatedPtrField<io::prometheus::client::MetricFamily>>();
 
@@ -58,17 +90,24 @@ MetricsPtr MetricsFlusher::flush(Stats::MetricSnapshot& snapshot) const {
   int64_t snapshot_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                                  snapshot.snapshotTime().time_since_epoch())
                                  .count();
+  flushes_++;
   for (const auto& counter : snapshot.counters()) {
-    if (predicate_(counter.counter_.get())) {
+    if (predicate_(counter.counter_.get()) && (!report_only_changed_ || counter.delta_ > 0)) {
       flushCounter(*metrics->Add(), counter, snapshot_time_ms);
     }
   }
 
   for (const auto& gauge : snapshot.gauges()) {
-    if (predicate_(gauge)) {
+    if (predicate_(gauge) && (!report_only_changed_ || gaugeChanged(gauge.get()))) {
       flushGauge(*metrics->Add(), gauge.get(), snapshot_time_ms);
     }
   }
+  if (report_only_changed_) {
+    // Forget the gauges which were not in this flush, such as the removed ones.
+    absl::erase_if(flushed_gauges_, [this](const auto& flushed_gauge) {
+      return flushed_gauge.second.flush_ != flushes_;
+    });
+  }
 
   for (const auto& histogram : snapshot.histograms()) {
     if (predicate_(histogram.get())) {
@@ -79,6 +118,17 @@ MetricsPtr MetricsFlusher::flush(Stats::MetricSnapshot& snapshot) const {
   return metrics;
 }
 
+bool MetricsFlusher::gaugeChanged(const Stats::Gauge& gauge) {
+  const auto result = flushed_gauges_.try_emplace(gauge.name());
+  FlushedGauge& flushed_gauge = result.first->second;
+  flushed_gauge.flush_ = flushes_;
+  if (!result.second && flushed_gauge.value_ == gauge.value()) {
+    return false;
+  }
+  flushed_gauge.value_ = gauge.value();
+  return true;
+}
+
 void MetricsFlusher::flushCounter(io::prometheus::client::MetricFamily& metrics_family,
                                   const Stats::MetricSnapshot::CounterSnapshot& counter_snapshot,
                                   int64_t snapshot_time_ms) const {
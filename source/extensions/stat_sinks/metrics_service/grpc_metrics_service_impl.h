@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include "envoy/grpc/async_client.h"
 #include "envoy/local_info/local_info.h"
@@ -15,6 +16,8 @@
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/grpc/typed_async_client.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace StatSinks {
@@ -62,9 +65,14 @@ class GrpcMetricsStreamerImpl
       public GrpcMetricsStreamer<envoy::service::metrics::v3::StreamMetricsMessage,
                                  envoy::service::metrics::v3::StreamMetricsResponse> {
 public:
+  /**
+   * @param max_metrics_per_message the most metric families sent in a message, the metrics
+   *        being split across several messages if needed, or 0 to send them in a single message.
+   */
   GrpcMetricsStreamerImpl(Grpc::AsyncClientFactoryPtr&& factory,
                           const LocalInfo::LocalInfo& local_info,
-                          envoy::config::core::v3::ApiVersion transport_api_version);
+                          envoy::config::core::v3::ApiVersion transport_api_version,
+                          uint32_t max_metrics_per_message);
 
   // GrpcMetricsStreamer
   void send(MetricsPtr&& metrics) override;
@@ -73,25 +81,44 @@ public:
   void onRemoteClose(Grpc::Status::GrpcStatus, const std::string&) override { stream_ = nullptr; }
 
 private:
+  // Sends the message, starting a stream if needed. Returns whether there was a stream to send it.
+  bool sendMessage(envoy::service::metrics::v3::StreamMetricsMessage& message);
+
   const LocalInfo::LocalInfo& local_info_;
   const Protobuf::MethodDescriptor& service_method_;
   const envoy::config::core::v3::ApiVersion transport_api_version_;
+  const uint32_t max_metrics_per_message_;
 };
 
 using GrpcMetricsStreamerImplPtr = std::unique_ptr<GrpcMetricsStreamerImpl>;
 
 class MetricsFlusher {
 public:
+  /**
+   * @param report_only_changed whether to only flush the counters which changed since the last
+   *        flush and the gauges whose value differs from the one they were last flushed with.
+   */
   MetricsFlusher(
       bool report_counters_as_deltas, bool emit_labels,
       std::function<bool(const Stats::Metric&)> predicate =
-          [](const auto& metric) { return metric.used(); })
+          [](const auto& metric) { return metric.used(); },
+      bool report_only_changed = false)
       : report_counters_as_deltas_(report_counters_as_deltas), emit_labels_(emit_labels),
-        predicate_(predicate) {}
+        report_only_changed_(report_only_changed), predicate_(predicate) {}
 
-  MetricsPtr flush(Stats::MetricSnapshot& snapshot) const;
+  MetricsPtr flush(Stats::MetricSnapshot& snapshot);
 
 private:
+  // The value a gauge was last flushed with.
+  struct FlushedGauge {
+    uint64_t value_{};
+    // The last flush the gauge was in.
+    uint64_t flush_{};
+  };
+
+  // Records the value of the gauge in this flush, and returns whether it changed since it was
+  // last flushed.
+  bool gaugeChanged(const Stats::Gauge& gauge);
   void flushCounter(io::prometheus::client::MetricFamily& metrics_family,
                     const Stats::MetricSnapshot::CounterSnapshot& counter_snapshot,
                     int64_t snapshot_time_ms) const;
@@ -109,7 +136,12 @@ private:
 
   const bool report_counters_as_deltas_;
   const bool emit_labels_;
+  const bool report_only_changed_;
   const std::function<bool(const Stats::Metric&)> predicate_;
+  // The gauges flushed by name, if report_only_changed_ is set. A gauge is kept by name rather
+  // than by address, as another gauge could take the address of a removed one.
+  absl::flat_hash_map<std::string, FlushedGauge> flushed_gauges_;
+  uint64_t flushes_{};
 };
 
 /**
@@ -119,9 +151,12 @@ template <class RequestProto, class ResponseProto> class MetricsServiceSink : pu
 public:
   MetricsServiceSink(
       const GrpcMetricsStreamerSharedPtr<RequestProto, ResponseProto>& grpc_metrics_streamer,
-      bool report_counters_as_deltas, bool emit_labels)
-      : MetricsServiceSink(grpc_metrics_streamer,
-                           MetricsFlusher(report_counters_as_deltas, emit_labels)) {}
+      bool report_counters_as_deltas, bool emit_labels, bool report_only_changed = false)
+      : MetricsServiceSink(
+            grpc_metrics_streamer,
+            MetricsFlusher(
+                report_counters_as_deltas, emit_labels,
+                [](const auto& metric) { return metric.used(); }, report_only_changed)) {}
 
   MetricsServiceSink(
       const GrpcMetricsStreamerSharedPtr<RequestProto, ResponseProto>& grpc_metrics_streamer,
@@ -135,7 +170,7 @@ public:
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
 
 private:
-  const MetricsFlusher flusher_;
+  MetricsFlusher flusher_;
   GrpcMetricsStreamerSharedPtr<RequestProto, ResponseProto> grpc_metrics_streamer_;
 };
 
@@ -0,0 +1,40 @@
+#include "source/extensions/stat_sinks/shared_memory/config.h"
+
+#include <memory>
+
+#include "envoy/extensions/stat_sinks/shared_memory/v3/shared_memory.pb.h"
+#include "envoy/extensions/stat_sinks/shared_memory/v3/shared_memory.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/extensions/stat_sinks/shared_memory/shared_memory_sink.h"
+#include "source/extensions/stat_sinks/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace SharedMemory {
+
+Stats::SinkPtr
+SharedMemorySinkFactory::createStatsSink(const Protobuf::Message& config,
+                                         Server::Configuration::ServerFactoryContext& server) {
+  const auto& sink_config = MessageUtil::downcastAndValidate<
+      const envoy::extensions::stat_sinks::shared_memory::v3::SharedMemorySink&>(
+      config, server.messageValidationContext().staticValidationVisitor());
+  return std::make_unique<SharedMemorySink>(server.scope().symbolTable(), sink_config.path());
+}
+
+ProtobufTypes::MessagePtr SharedMemorySinkFactory::createEmptyConfigProto() {
+  return std::make_unique<envoy::extensions::stat_sinks::shared_memory::v3::SharedMemorySink>();
+}
+
+std::string SharedMemorySinkFactory::name() const { return StatsSinkNames::get().SharedMemory; }
+
+/**
+ * Static registration for the shared memory sink factory. @see RegisterFactory.
+ */
+REGISTER_FACTORY(SharedMemorySinkFactory, Server::Configuration::StatsSinkFactory);
+
+} // namespace SharedMemory
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace SharedMemory {
+
+/**
+ * Layout of the file written by the shared memory stats sink. These definitions are meant to be
+ * usable by readers outside of Envoy, so they only depend on the standard library.
+ *
+ * The file starts with a FileHeader, followed by the symbol, counter, gauge and histogram sections
+ * which the header points to. Integers are in host byte order, and every record starts at an
+ * offset which is a multiple of RecordAlignment.
+ *
+ * A stat name is stored as the bytes of its StatName encoding, without the leading length. This
+ * is a sequence of tokens, each either:
+ *   - a symbol, encoded as a little-endian base-128 varint (7 bits per byte, with the high bit set
+ *     on every byte but the last), whose token is found in the symbol section; or
+ *   - a 0 byte, followed by a varint length and that many bytes of a token which was created
+ *     dynamically and so has no symbol.
+ * Joining the tokens with '.' gives the stat's full name.
+ *
+ * The file is rewritten in place on every flush, guarded by FileHeader::sequence_ as a seqlock.
+ * A reader should load the sequence, copy out the data it needs, and then load the sequence again,
+ * retrying if it was odd or has changed. The file only ever grows, and a reader whose mapping is
+ * smaller than FileHeader::size_ should remap it.
+ */
+
+constexpr char Magic[8] = {'E', 'N', 'V', 'O', 'Y', 'S', 'T', 'T'};
+constexpr uint32_t Version = 1;
+constexpr uint64_t RecordAlignment = 8;
+
+struct Section {
+  // The offset of the first record of the section from the start of the file.
+  uint64_t offset_;
+  // The number of bytes in the section, including padding.
+  uint64_t size_;
+  // The number of records in the section.
+  uint64_t count_;
+};
+
+struct FileHeader {
+  char magic_[8];
+  uint32_t version_;
+  uint32_t header_size_;
+  // Odd while a snapshot is being written.
+  std::atomic<uint64_t> sequence_;
+  // The number of bytes of the file holding the current snapshot, including this header.
+  uint64_t size_;
+  // The time of the snapshot, in milliseconds since the epoch.
+  int64_t snapshot_time_ms_;
+  Section symbols_;
+  Section counters_;
+  Section gauges_;
+  Section histograms_;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "the sequence must be usable from other processes");
+static_assert(sizeof(FileHeader) % RecordAlignment == 0, "records must be aligned");
+
+// Followed by size_ bytes of the symbol's token.
+struct SymbolRecord {
+  uint32_t symbol_;
+  uint32_t size_;
+};
+
+// Followed by name_size_ bytes of the counter's name.
+struct CounterRecord {
+  uint64_t value_;
+  // The amount the counter has changed by since the previous flush.
+  uint64_t delta_;
+  uint32_t name_size_;
+  uint32_t reserved_;
+};
+
+// Followed by name_size_ bytes of the gauge's name.
+struct GaugeRecord {
+  uint64_t value_;
+  uint32_t name_size_;
+  uint32_t reserved_;
+};
+
+// Followed by quantile_count_ QuantileRecords of the histogram's cumulative statistics, and then
+// by name_size_ bytes of the histogram's name.
+struct HistogramRecord {
+  uint64_t sample_count_;
+  double sample_sum_;
+  uint32_t quantile_count_;
+  uint32_t name_size_;
+};
+
+struct QuantileRecord {
+  double quantile_;
+  double value_;
+};
+
+} // namespace SharedMemory
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
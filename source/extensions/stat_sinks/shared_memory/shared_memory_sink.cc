@@ -0,0 +1,192 @@
+#include "source/extensions/stat_sinks/shared_memory/shared_memory_sink.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "envoy/common/exception.h"
+#include "envoy/stats/histogram.h"
+#include "envoy/stats/stats.h"
+
+#include "source/common/common/fmt.h"
+#include "source/common/common/utility.h"
+#include "source/common/stats/symbol_table_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace SharedMemory {
+
+namespace {
+
+// The file is grown at least this much at a time, and at least doubled, so that a growing set of
+// stats doesn't need a remap on every flush.
+constexpr uint64_t MinFileSize = 64 * 1024;
+
+uint64_t alignUp(uint64_t size) { return (size + RecordAlignment - 1) & ~(RecordAlignment - 1); }
+
+} // namespace
+
+SharedMemorySink::SharedMemorySink(Stats::SymbolTable& symbol_table, const std::string& path)
+    : symbol_table_(symbol_table), path_(path),
+      fd_(::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)) {
+  if (fd_ == -1) {
+    throw EnvoyException(
+        fmt::format("unable to open stats snapshot file '{}': {}", path_, errorDetails(errno)));
+  }
+  if (!ensureMapped(sizeof(FileHeader))) {
+    const int error = errno;
+    ::close(fd_);
+    throw EnvoyException(
+        fmt::format("unable to map stats snapshot file '{}': {}", path_, errorDetails(error)));
+  }
+
+  // The file was just extended from zero bytes, so everything not set here is zero, including the
+  // sequence.
+  FileHeader& file_header = header();
+  memcpy(file_header.magic_, Magic, sizeof(Magic));
+  file_header.version_ = Version;
+  file_header.header_size_ = sizeof(FileHeader);
+  file_header.size_ = sizeof(FileHeader);
+}
+
+SharedMemorySink::~SharedMemorySink() {
+  ::munmap(mapping_, mapped_size_);
+  ::close(fd_);
+}
+
+void SharedMemorySink::flush(Stats::MetricSnapshot& snapshot) {
+  serialize(snapshot);
+  const uint64_t size = sizeof(FileHeader) + body_.size();
+  if (!ensureMapped(size)) {
+    ENVOY_LOG_EVERY_POW_2(warn, "unable to grow stats snapshot file '{}' to {} bytes: {}", path_,
+                          size, errorDetails(errno));
+    return;
+  }
+
+  FileHeader& file_header = header();
+  const uint64_t sequence = file_header.sequence_.load(std::memory_order_relaxed);
+  file_header.sequence_.store(sequence + 1, std::memory_order_relaxed);
+  // Keeps the writes below from being seen before the odd sequence.
+  std::atomic_thread_fence(std::memory_order_release);
+
+  if (!body_.empty()) {
+    memcpy(mapping_ + sizeof(FileHeader), body_.data(), body_.size());
+  }
+  file_header.size_ = size;
+  file_header.snapshot_time_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                      snapshot.snapshotTime().time_since_epoch())
+                                      .count();
+  file_header.symbols_ = symbols_;
+  file_header.counters_ = counters_;
+  file_header.gauges_ = gauges_;
+  file_header.histograms_ = histograms_;
+
+  file_header.sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+void SharedMemorySink::serialize(Stats::MetricSnapshot& snapshot) {
+  body_.clear();
+
+  // The snapshot holds references to all of its metrics, so every symbol their names use is in
+  // the table until the flush completes.
+  symbols_ = beginSection();
+  uint64_t symbol_count = 0;
+  symbol_table_.iterateSymbols([this, &symbol_count](uint32_t symbol, absl::string_view token) {
+    const SymbolRecord record{symbol, static_cast<uint32_t>(token.size())};
+    appendBytes(&record, sizeof(record));
+    appendBytes(token.data(), token.size());
+    pad();
+    ++symbol_count;
+  });
+  endSection(symbols_, symbol_count);
+
+  counters_ = beginSection();
+  for (const auto& counter : snapshot.counters()) {
+    const Stats::StatName name = counter.counter_.get().statName();
+    const CounterRecord record{counter.counter_.get().value(), counter.delta_,
+                               static_cast<uint32_t>(name.dataSize()), 0};
+    appendBytes(&record, sizeof(record));
+    appendName(name);
+  }
+  endSection(counters_, snapshot.counters().size());
+
+  gauges_ = beginSection();
+  for (const Stats::Gauge& gauge : snapshot.gauges()) {
+    const Stats::StatName name = gauge.statName();
+    const GaugeRecord record{gauge.value(), static_cast<uint32_t>(name.dataSize()), 0};
+    appendBytes(&record, sizeof(record));
+    appendName(name);
+  }
+  endSection(gauges_, snapshot.gauges().size());
+
+  histograms_ = beginSection();
+  for (const Stats::ParentHistogram& histogram : snapshot.histograms()) {
+    const Stats::StatName name = histogram.statName();
+    const Stats::HistogramStatistics& statistics = histogram.cumulativeStatistics();
+    const std::vector<double>& quantiles = statistics.supportedQuantiles();
+    const std::vector<double>& values = statistics.computedQuantiles();
+    const HistogramRecord record{statistics.sampleCount(), statistics.sampleSum(),
+                                 static_cast<uint32_t>(quantiles.size()),
+                                 static_cast<uint32_t>(name.dataSize())};
+    appendBytes(&record, sizeof(record));
+    for (size_t i = 0; i < quantiles.size(); ++i) {
+      const QuantileRecord quantile{quantiles[i], values[i]};
+      appendBytes(&quantile, sizeof(quantile));
+    }
+    appendName(name);
+  }
+  endSection(histograms_, snapshot.histograms().size());
+}
+
+void SharedMemorySink::appendBytes(const void* data, uint64_t size) {
+  if (size == 0) {
+    return;
+  }
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  body_.insert(body_.end(), bytes, bytes + size);
+}
+
+void SharedMemorySink::appendName(Stats::StatName name) {
+  appendBytes(name.data(), name.dataSize());
+  pad();
+}
+
+void SharedMemorySink::pad() { body_.resize(alignUp(body_.size())); }
+
+Section SharedMemorySink::beginSection() const { return {sizeof(FileHeader) + body_.size(), 0, 0}; }
+
+void SharedMemorySink::endSection(Section& section, uint64_t count) const {
+  section.size_ = sizeof(FileHeader) + body_.size() - section.offset_;
+  section.count_ = count;
+}
+
+bool SharedMemorySink::ensureMapped(uint64_t size) {
+  if (size <= mapped_size_) {
+    return true;
+  }
+  // The file is never shrunk, since readers may have mapped all of it.
+  const uint64_t new_size = std::max({size, 2 * mapped_size_, MinFileSize});
+  if (::ftruncate(fd_, new_size) != 0) {
+    return false;
+  }
+  void* mapping = ::mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+  if (mapping_ != nullptr) {
+    ::munmap(mapping_, mapped_size_);
+  }
+  mapping_ = static_cast<uint8_t*>(mapping);
+  mapped_size_ = new_size;
+  return true;
+}
+
+} // namespace SharedMemory
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
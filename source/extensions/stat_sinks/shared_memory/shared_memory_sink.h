@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/stats/sink.h"
+#include "envoy/stats/symbol_table.h"
+
+#include "source/common/common/logger.h"
+#include "source/extensions/stat_sinks/shared_memory/shared_memory_format.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace SharedMemory {
+
+/**
+ * Writes a snapshot of the stats on every flush into a memory-mapped file, laid out as described
+ * in shared_memory_format.h, so that other processes on the host can read them without any
+ * formatting work on the Envoy side.
+ */
+class SharedMemorySink : public Stats::Sink, Logger::Loggable<Logger::Id::stats> {
+public:
+  /**
+   * Creates the file at path, or truncates it if it exists.
+   * @throw EnvoyException if the file cannot be created or mapped.
+   */
+  SharedMemorySink(Stats::SymbolTable& symbol_table, const std::string& path);
+  ~SharedMemorySink() override;
+
+  // Stats::Sink
+  void flush(Stats::MetricSnapshot& snapshot) override;
+  void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
+
+private:
+  void serialize(Stats::MetricSnapshot& snapshot);
+  void appendBytes(const void* data, uint64_t size);
+  void appendName(Stats::StatName name);
+  void pad();
+  Section beginSection() const;
+  void endSection(Section& section, uint64_t count) const;
+  // Grows the file and its mapping to at least size bytes. On failure, returns false with errno
+  // set, and the existing mapping is still usable.
+  bool ensureMapped(uint64_t size);
+  FileHeader& header() { return *reinterpret_cast<FileHeader*>(mapping_); }
+
+  Stats::SymbolTable& symbol_table_;
+  const std::string path_;
+  int fd_;
+  uint8_t* mapping_{};
+  uint64_t mapped_size_{};
+  // The sections of the snapshot being written, which are copied into the file after the header.
+  std::vector<uint8_t> body_;
+  Section symbols_{};
+  Section counters_{};
+  Section gauges_{};
+  Section histograms_{};
+};
+
+} // namespace SharedMemory
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -24,6 +24,8 @@ public:
   const std::string MetricsService = "envoy.stat_sinks.metrics_service";
   // Hystrix sink
   const std::string Hystrix = "envoy.stat_sinks.hystrix";
+  // Shared memory sink
+  const std::string SharedMemory = "envoy.stat_sinks.shared_memory";
   // WebAssembly sink
   const std::string Wasm = "envoy.stat_sinks.wasm";
 };
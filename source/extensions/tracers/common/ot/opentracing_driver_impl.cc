@@ -103,6 +103,12 @@ OpenTracingSpan::OpenTracingSpan(OpenTracingDriver& driver,
 
 void OpenTracingSpan::finishSpan() { span_->FinishWithOptions(finish_options_); }
 
+void OpenTracingSpan::finishSpanAt(SystemTime, MonotonicTime monotonic_end_time) {
+  // OpenTracing derives the end of a span from its steady timestamp.
+  finish_options_.finish_steady_timestamp = monotonic_end_time;
+  span_->FinishWithOptions(finish_options_);
+}
+
 void OpenTracingSpan::setOperation(absl::string_view operation) {
   span_->SetOperationName({operation.data(), operation.length()});
 }
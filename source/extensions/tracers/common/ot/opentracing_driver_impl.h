@@ -34,6 +34,7 @@ public:
 
   // Tracing::Span
   void finishSpan() override;
+  void finishSpanAt(SystemTime end_time, MonotonicTime monotonic_end_time) override;
   void setOperation(absl::string_view operation) override;
   void setTag(absl::string_view name, const absl::string_view) override;
   void log(SystemTime timestamp, const std::string& event) override;
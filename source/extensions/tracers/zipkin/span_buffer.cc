@@ -2,12 +2,12 @@
 
 #include "envoy/config/trace/v3/zipkin.pb.h"
 
+#include "source/common/common/assert.h"
 #include "source/common/protobuf/utility.h"
 #include "source/extensions/tracers/zipkin/util.h"
 #include "source/extensions/tracers/zipkin/zipkin_core_constants.h"
 #include "source/extensions/tracers/zipkin/zipkin_json_field_names.h"
 
-#include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
 
 namespace Envoy {
@@ -29,7 +29,7 @@ SpanBuffer::SpanBuffer(
 
 bool SpanBuffer::addSpan(Span&& span) {
   const auto& annotations = span.annotations();
-  if (span_buffer_.size() == span_buffer_.capacity() || annotations.empty() ||
+  if (pending_spans_ == max_spans_ || annotations.empty() ||
       annotations.end() ==
           std::find_if(annotations.begin(), annotations.end(), [](const auto& annotation) {
             return annotation.value() == CLIENT_SEND || annotation.value() == SERVER_RECV;
@@ -39,11 +39,26 @@ bool SpanBuffer::addSpan(Span&& span) {
     return false;
   }
 
-  span_buffer_.push_back(std::move(span));
+  serializer_->encode(span, encoded_spans_);
+  ++pending_spans_;
 
   return true;
 }
 
+std::string SpanBuffer::serialize() const {
+  Buffer::OwnedImpl report;
+  report.add(encoded_spans_);
+  serializer_->finish(report);
+  return report.toString();
+}
+
+void SpanBuffer::moveSerialized(Buffer::Instance& report) {
+  ASSERT(report.length() == 0);
+  report.move(encoded_spans_);
+  serializer_->finish(report);
+  pending_spans_ = 0;
+}
+
 SerializerPtr SpanBuffer::makeSerializer(
     const envoy::config::trace::v3::ZipkinConfig::CollectorEndpointVersion& version,
     const bool shared_span_context) {
@@ -59,54 +74,57 @@ SerializerPtr SpanBuffer::makeSerializer(
   }
 }
 
-std::string JsonV1Serializer::serialize(const std::vector<Span>& zipkin_spans) {
-  const std::string serialized_elements =
-      absl::StrJoin(zipkin_spans, ",", [](std::string* element, const Span& zipkin_span) {
-        absl::StrAppend(element, zipkin_span.toJson());
-      });
-  return absl::StrCat("[", serialized_elements, "]");
+void JsonV1Serializer::encode(const Span& zipkin_span, Buffer::Instance& encoded) {
+  if (encoded.length() > 0) {
+    encoded.add(",");
+  }
+  encoded.add(zipkin_span.toJson());
+}
+
+void JsonV1Serializer::finish(Buffer::Instance& report) {
+  report.prepend("[");
+  report.add("]");
 }
 
 JsonV2Serializer::JsonV2Serializer(const bool shared_span_context)
     : shared_span_context_{shared_span_context} {}
 
-std::string JsonV2Serializer::serialize(const std::vector<Span>& zipkin_spans) {
+void JsonV2Serializer::encode(const Span& zipkin_span, Buffer::Instance& encoded) {
   Util::Replacements replacements;
-  const std::string serialized_elements = absl::StrJoin(
-      zipkin_spans, ",", [this, &replacements](std::string* out, const Span& zipkin_span) {
-        const auto& replacement_values = replacements;
-        absl::StrAppend(
-            out, absl::StrJoin(
-                     toListOfSpans(zipkin_span, replacements), ",",
-                     [&replacement_values](std::string* element, const ProtobufWkt::Struct& span) {
-                       const std::string json = MessageUtil::getJsonStringFromMessageOrDie(
-                           span, /* pretty_print */ false,
-                           /* always_print_primitive_fields */ true);
-
-                       // The Zipkin API V2 specification mandates to store timestamp value as int64
-                       // https://github.com/openzipkin/zipkin-api/blob/228fabe660f1b5d1e28eac9df41f7d1deed4a1c2/zipkin2-api.yaml#L447-L463
-                       // (often translated as uint64 in some of the official implementations:
-                       // https://github.com/openzipkin/zipkin-go/blob/62dc8b26c05e0e8b88eb7536eff92498e65bbfc3/model/span.go#L114,
-                       // and see the discussion here:
-                       // https://github.com/openzipkin/zipkin-go/pull/161#issuecomment-598558072).
-                       // However, when the timestamp is stored as number value in a protobuf
-                       // struct, it is stored as a double. Because of how protobuf serializes
-                       // doubles, there is a possibility that the value will be rendered as a
-                       // number with scientific notation as reported in:
-                       // https://github.com/envoyproxy/envoy/issues/9341#issuecomment-566912973. To
-                       // deal with that issue, here we do a workaround by storing the timestamp as
-                       // string and keeping track of that with the corresponding integer
-                       // replacements, and do the replacement here so we can meet the Zipkin API V2
-                       // requirements.
-                       //
-                       // TODO(dio): The right fix for this is to introduce additional knob when
-                       // serializing double in protobuf DoubleToBuffer function, and make it
-                       // available to be controlled at caller site.
-                       // https://github.com/envoyproxy/envoy/issues/10411).
-                       absl::StrAppend(element, absl::StrReplaceAll(json, replacement_values));
-                     }));
-      });
-  return absl::StrCat("[", serialized_elements, "]");
+  for (const ProtobufWkt::Struct& span : toListOfSpans(zipkin_span, replacements)) {
+    const std::string json = MessageUtil::getJsonStringFromMessageOrDie(
+        span, /* pretty_print */ false, /* always_print_primitive_fields */ true);
+    if (encoded.length() > 0) {
+      encoded.add(",");
+    }
+
+    // The Zipkin API V2 specification mandates to store timestamp value as int64
+    // https://github.com/openzipkin/zipkin-api/blob/228fabe660f1b5d1e28eac9df41f7d1deed4a1c2/zipkin2-api.yaml#L447-L463
+    // (often translated as uint64 in some of the official implementations:
+    // https://github.com/openzipkin/zipkin-go/blob/62dc8b26c05e0e8b88eb7536eff92498e65bbfc3/model/span.go#L114,
+    // and see the discussion here:
+    // https://github.com/openzipkin/zipkin-go/pull/161#issuecomment-598558072).
+    // However, when the timestamp is stored as number value in a protobuf
+    // struct, it is stored as a double. Because of how protobuf serializes
+    // doubles, there is a possibility that the value will be rendered as a
+    // number with scientific notation as reported in:
+    // https://github.com/envoyproxy/envoy/issues/9341#issuecomment-566912973. To
+    // deal with that issue, here we do a workaround by storing the timestamp as
+    // string and keeping track of that with the corresponding integer
+    // replacements, and do the replacement here so we can meet the Zipkin API V2
+    // requirements.
+    //
+    // TODO(dio): The right fix for this is to introduce additional knob when
+    // serializing double in protobuf DoubleToBuffer function, and make it
+    // available to be controlled at caller site.
+    // https://github.com/envoyproxy/envoy/issues/10411).
+    encoded.add(absl::StrReplaceAll(json, replacements));
+  }
+}
+
+void JsonV2Serializer::finish(Buffer::Instance& report) {
+  report.prepend("[");
+  report.add("]");
 }
 
 const std::vector<ProtobufWkt::Struct>
@@ -219,14 +237,16 @@ const ProtobufWkt::Struct JsonV2Serializer::toProtoEndpoint(const Endpoint& zipk
 ProtobufSerializer::ProtobufSerializer(const bool shared_span_context)
     : shared_span_context_{shared_span_context} {}
 
-std::string ProtobufSerializer::serialize(const std::vector<Span>& zipkin_spans) {
-  zipkin::proto3::ListOfSpans spans;
-  for (const Span& zipkin_span : zipkin_spans) {
-    spans.MergeFrom(toListOfSpans(zipkin_span));
+void ProtobufSerializer::encode(const Span& zipkin_span, Buffer::Instance& encoded) {
+  const zipkin::proto3::ListOfSpans spans = toListOfSpans(zipkin_span);
+  const size_t size = spans.ByteSizeLong();
+  if (size == 0) {
+    return;
   }
-  std::string serialized;
-  spans.SerializeToString(&serialized);
-  return serialized;
+  auto reservation = encoded.reserveSingleSlice(size);
+  ASSERT(reservation.slice().len_ >= size);
+  spans.SerializeWithCachedSizesToArray(static_cast<uint8_t*>(reservation.slice().mem_));
+  reservation.commit(size);
 }
 
 const zipkin::proto3::ListOfSpans ProtobufSerializer::toListOfSpans(const Span& zipkin_span) const {
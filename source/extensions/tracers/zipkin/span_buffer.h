@@ -2,6 +2,7 @@
 
 #include "envoy/config/trace/v3/zipkin.pb.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/protobuf/protobuf.h"
 #include "source/extensions/tracers/zipkin/tracer_interface.h"
 #include "source/extensions/tracers/zipkin/zipkin_core_types.h"
@@ -15,7 +16,8 @@ namespace Zipkin {
 
 /**
  * This class implements a simple buffer to store Zipkin tracing spans
- * prior to flushing them.
+ * prior to flushing them. The spans are encoded as they are added, so that the buffer holds their
+ * encoding rather than the spans themselves.
  */
 class SpanBuffer {
 public:
@@ -48,7 +50,7 @@ public:
    *
    * @param size The desired buffer size.
    */
-  void allocateBuffer(uint64_t size) { span_buffer_.reserve(size); }
+  void allocateBuffer(uint64_t size) { max_spans_ = size; }
 
   /**
    * Adds the given Zipkin span to the buffer.
@@ -63,30 +65,46 @@ public:
    * Empties the buffer. This method is supposed to be called when all buffered spans
    * have been sent to the Zipkin service.
    */
-  void clear() { span_buffer_.clear(); }
+  void clear() {
+    encoded_spans_.drain(encoded_spans_.length());
+    pending_spans_ = 0;
+  }
 
   /**
    * @return the number of spans currently buffered.
    */
-  uint64_t pendingSpans() { return span_buffer_.size(); }
+  uint64_t pendingSpans() { return pending_spans_; }
 
   /**
-   * Serializes std::vector<Span> span_buffer_ to std::string as payload for the reporter when the
-   * reporter does spans flushing. This function does only serialization and does not clear
-   * span_buffer_.
+   * @return the number of bytes of the spans currently buffered, once encoded.
+   */
+  uint64_t pendingBytes() const { return encoded_spans_.length(); }
+
+  /**
+   * Serializes the buffered spans as payload for the reporter. This function does only
+   * serialization and does not clear the buffer.
    *
    * @return std::string the contents of the buffer, a collection of serialized pending Zipkin
    * spans.
    */
-  std::string serialize() const { return serializer_->serialize(span_buffer_); }
+  std::string serialize() const;
+
+  /**
+   * Moves the serialized buffered spans to the payload of a report, without copying them, and
+   * empties the buffer.
+   *
+   * @param report the payload of the report, which must be empty.
+   */
+  void moveSerialized(Buffer::Instance& report);
 
 private:
   SerializerPtr
   makeSerializer(const envoy::config::trace::v3::ZipkinConfig::CollectorEndpointVersion& version,
                  bool shared_span_context);
 
-  // We use a pre-allocated vector to improve performance
-  std::vector<Span> span_buffer_;
+  uint64_t max_spans_{};
+  uint64_t pending_spans_{};
+  Buffer::OwnedImpl encoded_spans_;
   SerializerPtr serializer_;
 };
 
@@ -100,11 +118,9 @@ class JsonV1Serializer : public Serializer {
 public:
   JsonV1Serializer() = default;
 
-  /**
-   * Serialize list of Zipkin spans into Zipkin v1 JSON array.
-   * @return std::string serialized pending spans as Zipkin v1 JSON array.
-   */
-  std::string serialize(const std::vector<Span>& pending_spans) override;
+  // Zipkin::Serializer
+  void encode(const Span& span, Buffer::Instance& encoded) override;
+  void finish(Buffer::Instance& report) override;
 };
 
 /**
@@ -115,11 +131,9 @@ class JsonV2Serializer : public Serializer {
 public:
   JsonV2Serializer(bool shared_span_context);
 
-  /**
-   * Serialize list of Zipkin spans into Zipkin v2 JSON array.
-   * @return std::string serialized pending spans as Zipkin v2 JSON array.
-   */
-  std::string serialize(const std::vector<Span>& pending_spans) override;
+  // Zipkin::Serializer
+  void encode(const Span& span, Buffer::Instance& encoded) override;
+  void finish(Buffer::Instance& report) override;
 
 private:
   const std::vector<ProtobufWkt::Struct> toListOfSpans(const Span& zipkin_span,
@@ -131,17 +145,17 @@ private:
 
 /**
  * ProtobufSerializer implements Zipkin::Serializer that serializes list of Zipkin spans into
- * stringified (SerializeToString) protobuf message.
+ * a serialized zipkin::proto3::ListOfSpans protobuf message.
  */
 class ProtobufSerializer : public Serializer {
 public:
   ProtobufSerializer(bool shared_span_context);
 
-  /**
-   * Serialize list of Zipkin spans into Zipkin v2 zipkin::proto3::ListOfSpans.
-   * @return std::string serialized pending spans as Zipkin zipkin::proto3::ListOfSpans.
-   */
-  std::string serialize(const std::vector<Span>& pending_spans) override;
+  // Zipkin::Serializer
+  // The spans are serialized straight into the buffer, each as a zipkin::proto3::ListOfSpans:
+  // the concatenation of these messages parses as the single list of all the spans.
+  void encode(const Span& span, Buffer::Instance& encoded) override;
+  void finish(Buffer::Instance&) override {}
 
 private:
   const zipkin::proto3::ListOfSpans toListOfSpans(const Span& zipkin_span) const;
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 
+#include "envoy/buffer/buffer.h"
 #include "envoy/common/pure.h"
 
 namespace Envoy {
@@ -36,18 +37,27 @@ public:
 };
 
 /**
- * Buffered pending spans serializer.
+ * Buffered pending spans serializer. The spans are encoded one by one as they are finished, and
+ * the encoded spans are completed into a report when they are flushed.
  */
 class Serializer {
 public:
   virtual ~Serializer() = default;
 
   /**
-   * Serialize buffered pending spans.
+   * Encodes a span, appending it to the spans encoded before.
    *
-   * @return std::string serialized buffered pending spans.
+   * @param span the span to encode.
+   * @param encoded the spans encoded so far, empty for the first span of a report.
    */
-  virtual std::string serialize(const std::vector<Span>& spans) PURE;
+  virtual void encode(const Span& span, Buffer::Instance& encoded) PURE;
+
+  /**
+   * Completes a report from the spans encoded into it, e.g. by enclosing them in a JSON array.
+   *
+   * @param report the encoded spans, completed in place.
+   */
+  virtual void finish(Buffer::Instance& report) PURE;
 };
 
 using SerializerPtr = std::unique_ptr<Serializer>;
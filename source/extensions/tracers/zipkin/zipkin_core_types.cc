@@ -187,24 +187,26 @@ const ProtobufWkt::Struct Span::toStruct(Util::Replacements& replacements) const
   return span;
 }
 
-void Span::finish() {
+void Span::finish() { finish(time_source_.systemTime(), time_source_.monotonicTime()); }
+
+void Span::finish(SystemTime end_time, MonotonicTime monotonic_end_time) {
   // Assumption: Span will have only one annotation when this method is called.
   SpanContext context(*this);
   if (annotations_[0].value() == SERVER_RECV) {
     // Need to set the SS annotation
     Annotation ss;
     ss.setEndpoint(annotations_[0].endpoint());
-    ss.setTimestamp(std::chrono::duration_cast<std::chrono::microseconds>(
-                        time_source_.systemTime().time_since_epoch())
-                        .count());
+    ss.setTimestamp(
+        std::chrono::duration_cast<std::chrono::microseconds>(end_time.time_since_epoch())
+            .count());
     ss.setValue(SERVER_SEND);
     annotations_.push_back(std::move(ss));
   } else if (annotations_[0].value() == CLIENT_SEND) {
     // Need to set the CR annotation.
     Annotation cr;
-    const uint64_t stop_timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
-                                        time_source_.systemTime().time_since_epoch())
-                                        .count();
+    const uint64_t stop_timestamp =
+        std::chrono::duration_cast<std::chrono::microseconds>(end_time.time_since_epoch())
+            .count();
     cr.setEndpoint(annotations_[0].endpoint());
     cr.setTimestamp(stop_timestamp);
     cr.setValue(CLIENT_RECV);
@@ -213,7 +215,7 @@ void Span::finish() {
 
   if (monotonic_start_time_) {
     const int64_t monotonic_stop_time = std::chrono::duration_cast<std::chrono::microseconds>(
-                                            time_source_.monotonicTime().time_since_epoch())
+                                            monotonic_end_time.time_since_epoch())
                                             .count();
     setDuration(monotonic_stop_time - monotonic_start_time_);
   }
@@ -582,6 +582,15 @@ public:
    */
   void finish();
 
+  /**
+   * Like finish(), for a span which finished at the given times rather than now.
+   *
+   * @param end_time the time the span finished.
+   * @param monotonic_end_time the monotonic time the span finished, which its duration is
+   * computed from.
+   */
+  void finish(SystemTime end_time, MonotonicTime monotonic_end_time);
+
   /**
    * Adds a binary annotation to the span.
    *
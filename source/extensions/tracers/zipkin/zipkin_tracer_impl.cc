@@ -10,7 +10,9 @@
 #include "source/common/http/headers.h"
 #include "source/common/http/message_impl.h"
 #include "source/common/http/utility.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/common/tracing/http_tracer_impl.h"
+#include "source/extensions/compression/gzip/compressor/zlib_compressor_impl.h"
 #include "source/extensions/tracers/zipkin/span_context_extractor.h"
 #include "source/extensions/tracers/zipkin/zipkin_core_constants.h"
 
@@ -23,6 +25,10 @@ ZipkinSpan::ZipkinSpan(Zipkin::Span& span, Zipkin::Tracer& tracer) : span_(span)
 
 void ZipkinSpan::finishSpan() { span_.finish(); }
 
+void ZipkinSpan::finishSpanAt(SystemTime end_time, MonotonicTime monotonic_end_time) {
+  span_.finish(end_time, monotonic_end_time);
+}
+
 void ZipkinSpan::setOperation(absl::string_view operation) {
   span_.setName(std::string(operation));
 }
@@ -59,6 +65,10 @@ void ZipkinSpan::injectContext(Tracing::TraceContext& trace_context) {
 
 void ZipkinSpan::setSampled(bool sampled) { span_.setSampled(sampled); }
 
+void UnsampledSpan::injectContext(Tracing::TraceContext& trace_context) {
+  trace_context.setTraceContextReferenceKey(ZipkinCoreConstants::get().X_B3_SAMPLED, NOT_SAMPLED);
+}
+
 Tracing::SpanPtr ZipkinSpan::spawnChild(const Tracing::Config& config, const std::string& name,
                                         SystemTime start_time) {
   SpanContext previous_context(span_);
@@ -95,6 +105,9 @@ Driver::Driver(const envoy::config::trace::v3::ZipkinConfig& zipkin_config,
   const bool shared_span_context = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
       zipkin_config, shared_span_context, DEFAULT_SHARED_SPAN_CONTEXT);
   collector.shared_span_context_ = shared_span_context;
+  collector.compress_reports_ = zipkin_config.compress_reports();
+  collector.max_buffered_bytes_ =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(zipkin_config, max_buffered_bytes, 0);
 
   tls_->set([this, collector, &random_generator, trace_id_128bit, shared_span_context](
                 Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
@@ -115,6 +128,16 @@ Tracing::SpanPtr Driver::startSpan(const Tracing::Config& config,
   SpanPtr new_zipkin_span;
   SpanContextExtractor extractor(trace_context);
   bool sampled{extractor.extractSampled(tracing_decision)};
+  if (!sampled &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.zipkin_skip_unsampled_spans")) {
+    // Nothing is reported for the requests which aren't sampled, so they get no Zipkin span. The
+    // trace context they came with, if any, is propagated untouched.
+    if (trace_context.getTraceContext(ZipkinCoreConstants::get().B3).has_value() ||
+        trace_context.getTraceContext(ZipkinCoreConstants::get().X_B3_TRACE_ID).has_value()) {
+      return std::make_unique<Tracing::NullSpan>();
+    }
+    return std::make_unique<UnsampledSpan>();
+  }
   try {
     auto ret_span_context = extractor.extractSpanContext(sampled);
     if (!ret_span_context.second) {
@@ -164,6 +187,11 @@ ReporterPtr ReporterImpl::NewInstance(Driver& driver, Event::Dispatcher& dispatc
 }
 
 void ReporterImpl::reportSpan(Span&& span) {
+  if (collector_.max_buffered_bytes_ > 0 &&
+      span_buffer_->pendingBytes() + in_flight_bytes_ >= collector_.max_buffered_bytes_) {
+    driver_.tracerStats().spans_dropped_.inc();
+    return;
+  }
   span_buffer_->addSpan(std::move(span));
 
   const uint64_t min_flush_spans =
@@ -183,7 +211,6 @@ void ReporterImpl::enableTimer() {
 void ReporterImpl::flushSpans() {
   if (span_buffer_->pendingSpans()) {
     driver_.tracerStats().spans_sent_.add(span_buffer_->pendingSpans());
-    const std::string request_body = span_buffer_->serialize();
     Http::RequestMessagePtr message = std::make_unique<Http::RequestMessageImpl>();
     message->headers().setReferenceMethod(Http::Headers::get().MethodValues.Post);
     message->headers().setPath(collector_.endpoint_);
@@ -193,7 +220,18 @@ void ReporterImpl::flushSpans() {
             ? Http::Headers::get().ContentTypeValues.Protobuf
             : Http::Headers::get().ContentTypeValues.Json);
 
-    message->body().add(request_body);
+    span_buffer_->moveSerialized(message->body());
+    if (collector_.compress_reports_) {
+      using Extensions::Compression::Gzip::Compressor::ZlibCompressorImpl;
+      ZlibCompressorImpl compressor;
+      // The window bits of zlib plus 16 for a gzip header, and the default memory level.
+      compressor.init(ZlibCompressorImpl::CompressionLevel::Standard,
+                      ZlibCompressorImpl::CompressionStrategy::Standard, 15 + 16, 8);
+      compressor.compress(message->body(), Envoy::Compression::Compressor::State::Finish);
+      message->headers().setReferenceKey(Http::CustomHeaders::get().ContentEncoding,
+                                         Http::CustomHeaders::get().ContentEncodingValues.Gzip);
+    }
+    const uint64_t report_bytes = message->body().length();
 
     const uint64_t timeout =
         driver_.runtime().snapshot().getInteger("tracing.zipkin.request_timeout", 5000U);
@@ -205,25 +243,34 @@ void ReporterImpl::flushSpans() {
               Http::AsyncClient::RequestOptions().setTimeout(std::chrono::milliseconds(timeout)));
       if (request) {
         active_requests_.add(*request);
+        active_request_bytes_[request] = report_bytes;
+        in_flight_bytes_ += report_bytes;
       }
     } else {
       ENVOY_LOG(debug, "collector cluster '{}' does not exist", driver_.cluster());
       driver_.tracerStats().reports_skipped_no_cluster_.inc();
     }
+  }
+}
 
-    span_buffer_->clear();
+void ReporterImpl::removeActiveRequest(const Http::AsyncClient::Request& request) {
+  active_requests_.remove(request);
+  const auto it = active_request_bytes_.find(&request);
+  if (it != active_request_bytes_.end()) {
+    in_flight_bytes_ -= it->second;
+    active_request_bytes_.erase(it);
   }
 }
 
 void ReporterImpl::onFailure(const Http::AsyncClient::Request& request,
                              Http::AsyncClient::FailureReason) {
-  active_requests_.remove(request);
+  removeActiveRequest(request);
   driver_.tracerStats().reports_failed_.inc();
 }
 
 void ReporterImpl::onSuccess(const Http::AsyncClient::Request& request,
                              Http::ResponseMessagePtr&& http_response) {
-  active_requests_.remove(request);
+  removeActiveRequest(request);
   if (Http::Utility::getResponseStatus(http_response->headers()) !=
       enumToInt(Http::Code::Accepted)) {
     driver_.tracerStats().reports_dropped_.inc();
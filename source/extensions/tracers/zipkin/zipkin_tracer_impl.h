@@ -19,6 +19,8 @@
 #include "source/extensions/tracers/zipkin/tracer.h"
 #include "source/extensions/tracers/zipkin/zipkin_core_constants.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Tracers {
@@ -26,6 +28,7 @@ namespace Zipkin {
 
 #define ZIPKIN_TRACER_STATS(COUNTER)                                                               \
   COUNTER(spans_sent)                                                                              \
+  COUNTER(spans_dropped)                                                                           \
   COUNTER(timer_flushed)                                                                           \
   COUNTER(reports_skipped_no_cluster)                                                              \
   COUNTER(reports_sent)                                                                            \
@@ -36,6 +39,20 @@ struct ZipkinTracerStats {
   ZIPKIN_TRACER_STATS(GENERATE_COUNTER_STRUCT)
 };
 
+/**
+ * The span of a request which isn't sampled and came without a trace context. Nothing is recorded
+ * for it: only the decision not to sample the request is propagated, so that the services it
+ * calls don't sample it either.
+ */
+class UnsampledSpan : public Tracing::NullSpan {
+public:
+  // Tracing::Span
+  void injectContext(Tracing::TraceContext& trace_context) override;
+  Tracing::SpanPtr spawnChild(const Tracing::Config&, const std::string&, SystemTime) override {
+    return std::make_unique<UnsampledSpan>();
+  }
+};
+
 /**
  * Class for Zipkin spans, wrapping a Zipkin::Span object.
  */
@@ -53,6 +70,7 @@ public:
    * This function is called by Tracing::HttpTracerUtility::finalizeSpan().
    */
   void finishSpan() override;
+  void finishSpanAt(SystemTime end_time, MonotonicTime monotonic_end_time) override;
 
   /**
    * This method sets the operation name on the span.
@@ -169,6 +187,13 @@ struct CollectorInfo {
       envoy::config::trace::v3::ZipkinConfig::hidden_envoy_deprecated_HTTP_JSON_V1};
 
   bool shared_span_context_{DEFAULT_SHARED_SPAN_CONTEXT};
+
+  // Whether the reports are compressed with gzip.
+  bool compress_reports_{};
+
+  // The maximum number of bytes of the spans buffered or in flight to the collector, or 0 if not
+  // limited.
+  uint64_t max_buffered_bytes_{};
 };
 
 /**
@@ -184,6 +209,9 @@ struct CollectorInfo {
  * expires, whichever happens first.
  *
  * The default values for the runtime parameters are 5 spans and 5000ms.
+ *
+ * If max_buffered_bytes is set, the spans finished while the buffered spans and the reports in
+ * flight to Zipkin add up to that many bytes are dropped.
  */
 class ReporterImpl : Logger::Loggable<Logger::Id::tracing>,
                      public Reporter,
@@ -240,6 +268,11 @@ private:
    */
   void flushSpans();
 
+  /**
+   * Stops tracking a request which completed, and the bytes of its report.
+   */
+  void removeActiveRequest(const Http::AsyncClient::Request& request);
+
   Driver& driver_;
   Event::TimerPtr flush_timer_;
   const CollectorInfo collector_;
@@ -247,6 +280,9 @@ private:
   Upstream::ClusterUpdateTracker collector_cluster_;
   // Track active HTTP requests to be able to cancel them on destruction.
   Http::AsyncClientRequestTracker active_requests_;
+  // The bytes of the reports of the active requests, which count against max_buffered_bytes_.
+  absl::flat_hash_map<const Http::AsyncClient::Request*, uint64_t> active_request_bytes_;
+  uint64_t in_flight_bytes_{};
 };
 } // namespace Zipkin
 } // namespace Tracers
@@ -46,6 +46,10 @@ DefaultCertValidator::DefaultCertValidator(
     allow_untrusted_certificate_ = config_->trustChainVerification() ==
                                    envoy::extensions::transport_sockets::tls::v3::
                                        CertificateValidationContext::ACCEPT_UNTRUSTED;
+    if (config_->verifiedCertChainCacheMaxEntries() > 0) {
+      verified_cert_chain_cache_ = std::make_unique<VerifiedCertChainCache>(
+          config_->verifiedCertChainCacheMaxEntries(), time_source_);
+    }
   }
 };
 
@@ -185,6 +189,28 @@ int DefaultCertValidator::initializeSslContexts(std::vector<SSL_CTX*> contexts,
 int DefaultCertValidator::doVerifyCertChain(
     X509_STORE_CTX* store_ctx, Ssl::SslExtendedSocketInfo* ssl_extended_info, X509& leaf_cert,
     const Network::TransportSocketOptions* transport_socket_options) {
+  const std::vector<std::string> no_san_list;
+  const std::vector<std::string>& verify_san_list =
+      transport_socket_options != nullptr
+          ? transport_socket_options->verifySubjectAltNameListOverride()
+          : no_san_list;
+
+  std::string cache_key;
+  if (verified_cert_chain_cache_ != nullptr) {
+    cache_key = VerifiedCertChainCache::key(leaf_cert, X509_STORE_CTX_get0_untrusted(store_ctx),
+                                            verify_san_list);
+    const absl::optional<Envoy::Ssl::ClientValidationStatus> cached_status =
+        verified_cert_chain_cache_->lookup(cache_key);
+    if (cached_status.has_value()) {
+      stats_.verified_cert_chain_cache_hit_.inc();
+      if (ssl_extended_info) {
+        ssl_extended_info->setCertificateValidationStatus(cached_status.value());
+      }
+      return 1;
+    }
+    stats_.verified_cert_chain_cache_miss_.inc();
+  }
+
   if (verify_trusted_ca_) {
     int ret = X509_verify_cert(store_ctx);
     if (ssl_extended_info) {
@@ -200,11 +226,7 @@ int DefaultCertValidator::doVerifyCertChain(
   }
 
   Envoy::Ssl::ClientValidationStatus validated =
-      verifyCertificate(&leaf_cert,
-                        transport_socket_options != nullptr
-                            ? transport_socket_options->verifySubjectAltNameListOverride()
-                            : std::vector<std::string>{},
-                        subject_alt_name_matchers_);
+      verifyCertificate(&leaf_cert, verify_san_list, subject_alt_name_matchers_);
 
   if (ssl_extended_info) {
     if (ssl_extended_info->certificateValidationStatus() ==
@@ -215,10 +237,45 @@ int DefaultCertValidator::doVerifyCertChain(
     }
   }
 
+  if (!cache_key.empty() && validated != Envoy::Ssl::ClientValidationStatus::Failed) {
+    const absl::optional<MonotonicTime> expiry = verifiedCertChainExpiry(store_ctx, leaf_cert);
+    if (expiry.has_value()) {
+      verified_cert_chain_cache_->insert(
+          cache_key, verify_trusted_ca_ ? Envoy::Ssl::ClientValidationStatus::Validated : validated,
+          expiry.value());
+    }
+  }
+
   return allow_untrusted_certificate_ ? 1
                                       : (validated != Envoy::Ssl::ClientValidationStatus::Failed);
 }
 
+absl::optional<MonotonicTime>
+DefaultCertValidator::verifiedCertChainExpiry(X509_STORE_CTX* store_ctx, X509& leaf_cert) const {
+  std::chrono::milliseconds ttl = config_->verifiedCertChainCacheTtl();
+  if (!config_->allowExpiredCertificate()) {
+    // The chain isn't cached past the expiration of any of its certificates, which are all in the
+    // chain built by the verification if the trusted CA is verified.
+    const SystemTime now = time_source_.systemTime();
+    const auto bound_ttl = [&ttl, now](const X509& cert) {
+      ttl = std::min(ttl, std::chrono::duration_cast<std::chrono::milliseconds>(
+                              Utility::getExpirationTime(cert) - now));
+    };
+    bound_ttl(leaf_cert);
+    const STACK_OF(X509)* chain = verify_trusted_ca_ ? X509_STORE_CTX_get0_chain(store_ctx)
+                                                     : X509_STORE_CTX_get0_untrusted(store_ctx);
+    if (chain != nullptr) {
+      for (const X509* cert : chain) {
+        bound_ttl(*cert);
+      }
+    }
+  }
+  if (ttl <= std::chrono::milliseconds::zero()) {
+    return absl::nullopt;
+  }
+  return time_source_.monotonicTime() + ttl;
+}
+
 Envoy::Ssl::ClientValidationStatus DefaultCertValidator::verifyCertificate(
     X509* cert, const std::vector<std::string>& verify_san_list,
     const std::vector<Matchers::StringMatcherImpl>& subject_alt_name_matchers) {
@@ -454,6 +511,84 @@ size_t DefaultCertValidator::daysUntilFirstCertExpires() const {
   return Utility::getDaysUntilExpiration(ca_cert_.get(), time_source_);
 }
 
+std::string VerifiedCertChainCache::key(X509& leaf_cert, const STACK_OF(X509)* intermediates,
+                                        const std::vector<std::string>& verify_san_list) {
+  bssl::ScopedEVP_MD_CTX md;
+  int rc = EVP_DigestInit(md.get(), EVP_sha256());
+  RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+
+  // The certificates are hashed by their own SHA-256 and the names prefixed by their length, so
+  // that no two different chains or name lists are hashed the same.
+  uint8_t cert_hash[SHA256_DIGEST_LENGTH];
+  const auto add_cert = [&md, &cert_hash](const X509& cert) {
+    unsigned int n;
+    int cert_rc = X509_digest(&cert, EVP_sha256(), cert_hash, &n);
+    RELEASE_ASSERT(cert_rc == 1 && n == SHA256_DIGEST_LENGTH,
+                   Utility::getLastCryptoError().value_or(""));
+    cert_rc = EVP_DigestUpdate(md.get(), cert_hash, n);
+    RELEASE_ASSERT(cert_rc == 1, Utility::getLastCryptoError().value_or(""));
+  };
+  add_cert(leaf_cert);
+  const uint64_t intermediate_count = intermediates != nullptr ? sk_X509_num(intermediates) : 0;
+  rc = EVP_DigestUpdate(md.get(), &intermediate_count, sizeof(intermediate_count));
+  RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+  for (uint64_t i = 0; i < intermediate_count; ++i) {
+    add_cert(*sk_X509_value(intermediates, i));
+  }
+  for (const std::string& san : verify_san_list) {
+    const uint64_t size = san.size();
+    rc = EVP_DigestUpdate(md.get(), &size, sizeof(size));
+    RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+    rc = EVP_DigestUpdate(md.get(), san.data(), san.size());
+    RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+  }
+
+  std::string key(SHA256_DIGEST_LENGTH, '\0');
+  rc = EVP_DigestFinal(md.get(), reinterpret_cast<uint8_t*>(key.data()), nullptr);
+  RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+  return key;
+}
+
+absl::optional<Envoy::Ssl::ClientValidationStatus>
+VerifiedCertChainCache::lookup(const std::string& key) {
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return absl::nullopt;
+  }
+  if (it->second->expiry_ <= time_source_.monotonicTime()) {
+    entries_.erase(it->second);
+    index_.erase(it);
+    return absl::nullopt;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->status_;
+}
+
+void VerifiedCertChainCache::insert(const std::string& key,
+                                    Envoy::Ssl::ClientValidationStatus status,
+                                    MonotonicTime expiry) {
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    it->second->status_ = status;
+    it->second->expiry_ = expiry;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
+  }
+  if (entries_.size() >= max_entries_) {
+    index_.erase(entries_.back().key_);
+    entries_.pop_back();
+  }
+  entries_.push_front(Entry{key, status, expiry});
+  index_.emplace(entries_.front().key_, entries_.begin());
+}
+
+size_t VerifiedCertChainCache::size() const {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
 class DefaultCertValidatorFactory : public CertValidatorFactory {
 public:
   CertValidatorPtr createCertValidator(const Envoy::Ssl::CertificateValidationContextConfig* config,
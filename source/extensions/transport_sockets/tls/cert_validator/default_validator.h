@@ -3,10 +3,12 @@
 #include <array>
 #include <deque>
 #include <functional>
+#include <list>
 #include <string>
 #include <vector>
 
 #include "envoy/common/pure.h"
+#include "envoy/common/time.h"
 #include "envoy/network/transport_socket.h"
 #include "envoy/registry/registry.h"
 #include "envoy/ssl/context.h"
@@ -19,7 +21,9 @@
 #include "source/extensions/transport_sockets/tls/cert_validator/cert_validator.h"
 #include "source/extensions/transport_sockets/tls/stats.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
 #include "openssl/ssl.h"
 #include "openssl/x509v3.h"
 
@@ -28,6 +32,49 @@ namespace Extensions {
 namespace TransportSockets {
 namespace Tls {
 
+/**
+ * A bounded cache of the certificate chains which passed verification, evicting the least recently
+ * used chain once full. It's shared by the workers, the validator of a context being shared.
+ */
+class VerifiedCertChainCache {
+public:
+  VerifiedCertChainCache(uint32_t max_entries, TimeSource& time_source)
+      : max_entries_(max_entries), time_source_(time_source) {}
+
+  /**
+   * @return the key of a chain, the SHA-256 of its certificates and of the subject alt names it's
+   *         verified against.
+   */
+  static std::string key(X509& leaf_cert, const STACK_OF(X509)* intermediates,
+                         const std::vector<std::string>& verify_san_list);
+
+  /**
+   * @return the validation status the chain was verified with, or nullopt if it isn't cached or
+   *         has expired.
+   */
+  absl::optional<Envoy::Ssl::ClientValidationStatus> lookup(const std::string& key);
+
+  void insert(const std::string& key, Envoy::Ssl::ClientValidationStatus status,
+              MonotonicTime expiry);
+
+  size_t size() const;
+
+private:
+  struct Entry {
+    std::string key_;
+    Envoy::Ssl::ClientValidationStatus status_;
+    MonotonicTime expiry_;
+  };
+
+  const uint32_t max_entries_;
+  TimeSource& time_source_;
+  mutable absl::Mutex mutex_;
+  // The entries from the most to the least recently used.
+  std::list<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<absl::string_view, std::list<Entry>::iterator>
+      index_ ABSL_GUARDED_BY(mutex_);
+};
+
 class DefaultCertValidator : public CertValidator {
 public:
   DefaultCertValidator(const Envoy::Ssl::CertificateValidationContextConfig* config,
@@ -106,6 +153,10 @@ public:
                       const std::vector<Matchers::StringMatcherImpl>& subject_alt_name_matchers);
 
 private:
+  // @return when a verified chain expires from the cache, nullopt if it's not to be cached.
+  absl::optional<MonotonicTime> verifiedCertChainExpiry(X509_STORE_CTX* store_ctx,
+                                                        X509& leaf_cert) const;
+
   const Envoy::Ssl::CertificateValidationContextConfig* config_;
   SslStats& stats_;
   TimeSource& time_source_;
@@ -117,6 +168,7 @@ private:
   std::vector<std::vector<uint8_t>> verify_certificate_hash_list_;
   std::vector<std::vector<uint8_t>> verify_certificate_spki_list_;
   bool verify_trusted_ca_{false};
+  std::unique_ptr<VerifiedCertChainCache> verified_cert_chain_cache_;
 };
 
 DECLARE_FACTORY(DefaultCertValidatorFactory);
@@ -20,8 +20,8 @@ Network::TransportSocketFactoryPtr UpstreamSslSocketFactory::createTransportSock
           const envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext&>(
           message, context.messageValidationVisitor()),
       context);
-  return std::make_unique<ClientSslSocketFactory>(std::move(client_config),
-                                                  context.sslContextManager(), context.scope());
+  return std::make_unique<ClientSslSocketFactory>(
+      std::move(client_config), context.sslContextManager(), context.scope(), context);
 }
 
 ProtobufTypes::MessagePtr UpstreamSslSocketFactory::createEmptyConfigProto() {
@@ -8,6 +8,7 @@
 #include "source/common/common/assert.h"
 #include "source/common/common/empty_string.h"
 #include "source/common/config/datasource.h"
+#include "source/common/config/utility.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/secret/sds_api.h"
 #include "source/common/ssl/certificate_validation_context_config_impl.h"
@@ -181,7 +182,8 @@ ContextConfigImpl::ContextConfigImpl(
       min_protocol_version_(tlsVersionFromProto(config.tls_params().tls_minimum_protocol_version(),
                                                 default_min_protocol_version)),
       max_protocol_version_(tlsVersionFromProto(config.tls_params().tls_maximum_protocol_version(),
-                                                default_max_protocol_version)) {
+                                                default_max_protocol_version)),
+      kernel_tls_enabled_(config.enable_kernel_tls()) {
   if (certificate_validation_context_provider_ != nullptr) {
     if (default_cvc_) {
       // We need to validate combined certificate validation context.
@@ -418,6 +420,16 @@ ServerContextConfigImpl::ServerContextConfigImpl(
     session_timeout_ =
         std::chrono::seconds(DurationUtil::durationToSeconds(config.session_timeout()));
   }
+
+  if (config.has_session_cache()) {
+    auto& session_cache_factory =
+        Config::Utility::getAndCheckFactory<Ssl::SessionCacheFactory>(config.session_cache());
+    ProtobufTypes::MessagePtr session_cache_config = Config::Utility::translateAnyToFactoryConfig(
+        config.session_cache().typed_config(), factory_context.messageValidationVisitor(),
+        session_cache_factory);
+    session_cache_ =
+        session_cache_factory.createSessionCache(*session_cache_config, factory_context);
+  }
 }
 
 void ServerContextConfigImpl::setSecretUpdateCallback(std::function<void()> callback) {
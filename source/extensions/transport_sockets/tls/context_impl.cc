@@ -25,7 +25,9 @@
 #include "source/extensions/transport_sockets/tls/stats.h"
 #include "source/extensions/transport_sockets/tls/utility.h"
 
-#include "absl/container/node_hash_set.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_join.h"
 #include "openssl/evp.h"
@@ -53,6 +55,26 @@ bool cbsContainsU16(CBS& cbs, uint16_t n) {
   return false;
 }
 
+// The server names a certificate is valid for, in lower case: its DNS SANs, or its subject CN if it
+// has none. Wildcard names are kept as is, e.g. "*.example.com".
+std::vector<std::string> certificateServerNames(X509& cert) {
+  std::vector<std::string> names = Utility::getSubjectAltNames(cert, GEN_DNS);
+  if (names.empty()) {
+    X509_NAME* subject = X509_get_subject_name(&cert);
+    const int index = X509_NAME_get_index_by_NID(subject, NID_commonName, -1);
+    if (index >= 0) {
+      const ASN1_STRING* common_name =
+          X509_NAME_ENTRY_get_data(X509_NAME_get_entry(subject, index));
+      names.emplace_back(reinterpret_cast<const char*>(ASN1_STRING_get0_data(common_name)),
+                         ASN1_STRING_length(common_name));
+    }
+  }
+  for (std::string& name : names) {
+    absl::AsciiStrToLower(&name);
+  }
+  return names;
+}
+
 } // namespace
 
 int ContextImpl::sslExtendedSocketInfoIndex() {
@@ -75,7 +97,8 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
       ssl_ciphers_(stat_name_set_->add("ssl.ciphers")),
       ssl_versions_(stat_name_set_->add("ssl.versions")),
       ssl_curves_(stat_name_set_->add("ssl.curves")),
-      ssl_sigalgs_(stat_name_set_->add("ssl.sigalgs")), capabilities_(config.capabilities()) {
+      ssl_sigalgs_(stat_name_set_->add("ssl.sigalgs")), capabilities_(config.capabilities()),
+      kernel_tls_enabled_(config.kernelTlsEnabled()) {
 
   auto cert_validator_name = getCertValidatorName(config.certificateValidationContext());
   auto cert_validator_factory =
@@ -160,7 +183,8 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
   }
 #endif
 
-  absl::node_hash_set<int> cert_pkey_ids;
+  // The key types of the certificates by server name.
+  absl::flat_hash_map<std::string, absl::flat_hash_set<int>> cert_pkey_ids;
   if (!capabilities_.provides_certificates) {
     for (uint32_t i = 0; i < tls_certificates.size(); ++i) {
       auto& ctx = tls_contexts_[i];
@@ -216,10 +240,12 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
 
       bssl::UniquePtr<EVP_PKEY> public_key(X509_get_pubkey(ctx.cert_chain_.get()));
       const int pkey_id = EVP_PKEY_id(public_key.get());
-      if (!cert_pkey_ids.insert(pkey_id).second) {
-        throw EnvoyException(fmt::format("Failed to load certificate chain from {}, at most one "
-                                         "certificate of a given type may be specified",
-                                         ctx.cert_chain_file_path_));
+      for (const std::string& name : certificateServerNames(*ctx.cert_chain_)) {
+        if (!cert_pkey_ids[name].insert(pkey_id).second) {
+          throw EnvoyException(fmt::format("Failed to load certificate chain from {}, at most one "
+                                           "certificate of a given type may be specified for {}",
+                                           ctx.cert_chain_file_path_, name));
+        }
       }
       ctx.is_ecdsa_ = pkey_id == EVP_PKEY_EC;
       switch (pkey_id) {
@@ -706,7 +732,9 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
                                      const std::vector<std::string>& server_names,
                                      TimeSource& time_source)
     : ContextImpl(scope, config, time_source), session_ticket_keys_(config.sessionTicketKeys()),
-      ocsp_staple_policy_(config.ocspStaplePolicy()) {
+      ocsp_staple_policy_(config.ocspStaplePolicy()),
+      session_cache_(config.capabilities().handles_session_resumption ? nullptr
+                                                                      : config.sessionCache()) {
   if (config.tlsCertificates().empty() && !config.capabilities().provides_certificates) {
     throw EnvoyException("Server TlsCertificates must have a certificate specified");
   }
@@ -720,6 +748,7 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   // TODO(htuch): replace with SSL_IDENTITY when we have this as a means to do multi-cert in
   // BoringSSL.
   if (!config.capabilities().provides_certificates) {
+    indexTlsContexts();
     SSL_CTX_set_select_certificate_cb(
         tls_contexts_[0].ssl_ctx_.get(),
         [](const SSL_CLIENT_HELLO* client_hello) -> ssl_select_cert_result_t {
@@ -771,6 +800,39 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
       SSL_CTX_set_timeout(ctx.ssl_ctx_.get(), uint32_t(timeout));
     }
 
+    if (session_cache_ != nullptr) {
+      // The sessions are only kept in the shared cache, so that they are resumed with any of the
+      // contexts sharing it.
+      SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(),
+                                     SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+      SSL_CTX_sess_set_new_cb(ctx.ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
+        ContextImpl* context_impl =
+            static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+        ServerContextImpl* server_context_impl = dynamic_cast<ServerContextImpl*>(context_impl);
+        RELEASE_ASSERT(server_context_impl != nullptr, ""); // for Coverity
+        return server_context_impl->newSession(session);
+      });
+      SSL_CTX_sess_set_get_cb(
+          ctx.ssl_ctx_.get(),
+          [](SSL* ssl, const uint8_t* session_id, int session_id_len,
+             int* out_copy) -> SSL_SESSION* {
+            ContextImpl* context_impl =
+                static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+            ServerContextImpl* server_context_impl =
+                dynamic_cast<ServerContextImpl*>(context_impl);
+            RELEASE_ASSERT(server_context_impl != nullptr, ""); // for Coverity
+            // The session returned is owned by the connection.
+            *out_copy = 0;
+            return server_context_impl->getSession(ssl, session_id, session_id_len);
+          });
+      SSL_CTX_sess_set_remove_cb(ctx.ssl_ctx_.get(), [](SSL_CTX* ssl_ctx, SSL_SESSION* session) {
+        ContextImpl* context_impl = static_cast<ContextImpl*>(SSL_CTX_get_app_data(ssl_ctx));
+        ServerContextImpl* server_context_impl = dynamic_cast<ServerContextImpl*>(context_impl);
+        RELEASE_ASSERT(server_context_impl != nullptr, ""); // for Coverity
+        server_context_impl->removeSession(session);
+      });
+    }
+
     int rc =
         SSL_CTX_set_session_id_context(ctx.ssl_ctx_.get(), session_id.data(), session_id.size());
     RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
@@ -795,6 +857,98 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   }
 }
 
+void ServerContextImpl::registerSessionCacheLookups(SSL* ssl, Event::Dispatcher& dispatcher,
+                                                    std::function<void()> resume_handshake) {
+  if (session_cache_ != nullptr) {
+    SSL_set_ex_data(ssl, sessionCacheLookupIndex(),
+                    new SessionCacheLookup(dispatcher, std::move(resume_handshake)));
+  }
+}
+
+void ServerContextImpl::unregisterSessionCacheLookups(SSL* ssl) {
+  if (session_cache_ != nullptr) {
+    auto* lookup =
+        static_cast<SessionCacheLookup*>(SSL_get_ex_data(ssl, sessionCacheLookupIndex()));
+    SSL_set_ex_data(ssl, sessionCacheLookupIndex(), nullptr);
+    delete lookup;
+  }
+}
+
+int ServerContextImpl::sessionCacheLookupIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, []() -> int {
+    int ssl_context_index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    RELEASE_ASSERT(ssl_context_index >= 0, "");
+    return ssl_context_index;
+  }());
+}
+
+int ServerContextImpl::newSession(SSL_SESSION* session) {
+  unsigned session_id_len;
+  const uint8_t* session_id = SSL_SESSION_get_id(session, &session_id_len);
+  uint8_t* bytes;
+  size_t bytes_len;
+  if (SSL_SESSION_to_bytes(session, &bytes, &bytes_len)) {
+    session_cache_->insert(
+        absl::string_view(reinterpret_cast<const char*>(session_id), session_id_len),
+        std::string(reinterpret_cast<const char*>(bytes), bytes_len),
+        std::chrono::seconds(SSL_SESSION_get_timeout(session)));
+    OPENSSL_free(bytes);
+  }
+  // Tell BoringSSL that the session wasn't retained.
+  return 0;
+}
+
+SSL_SESSION* ServerContextImpl::getSession(SSL* ssl, const uint8_t* session_id,
+                                           int session_id_len) {
+  auto* lookup = static_cast<SessionCacheLookup*>(SSL_get_ex_data(ssl, sessionCacheLookupIndex()));
+  if (lookup == nullptr) {
+    // The connection can't wait for the cache, e.g. as it isn't owned by an SslSocket.
+    return nullptr;
+  }
+
+  if (!lookup->done_) {
+    if (lookup->pending_) {
+      return SSL_magic_pending_session_ptr();
+    }
+    lookup->handle_ = session_cache_->lookup(
+        absl::string_view(reinterpret_cast<const char*>(session_id), session_id_len),
+        lookup->dispatcher_, [lookup](absl::optional<std::string>&& session) {
+          lookup->session_ = std::move(session);
+          lookup->done_ = true;
+          if (lookup->pending_) {
+            lookup->resume_timer_->enableTimer(std::chrono::milliseconds(0));
+          }
+        });
+    if (!lookup->done_) {
+      lookup->pending_ = true;
+      return SSL_magic_pending_session_ptr();
+    }
+  }
+
+  lookup->pending_ = false;
+  lookup->done_ = false;
+  absl::optional<std::string> bytes = std::move(lookup->session_);
+  lookup->session_.reset();
+  bssl::UniquePtr<SSL_SESSION> session;
+  if (bytes.has_value()) {
+    session.reset(SSL_SESSION_from_bytes(reinterpret_cast<const uint8_t*>(bytes->data()),
+                                         bytes->size(), SSL_get_SSL_CTX(ssl)));
+  }
+  if (session == nullptr) {
+    stats_.session_cache_miss_.inc();
+    return nullptr;
+  }
+  stats_.session_cache_hit_.inc();
+  return session.release();
+}
+
+void ServerContextImpl::removeSession(SSL_SESSION* session) {
+  unsigned session_id_len;
+  const uint8_t* session_id = SSL_SESSION_get_id(session, &session_id_len);
+  session_cache_->remove(
+      absl::string_view(reinterpret_cast<const char*>(session_id), session_id_len));
+}
+
 ServerContextImpl::SessionContextID
 ServerContextImpl::generateHashForSessionContextId(const std::vector<std::string>& server_names) {
   uint8_t hash_buffer[EVP_MAX_MD_SIZE];
@@ -1089,27 +1243,87 @@ OcspStapleAction ServerContextImpl::ocspStapleAction(const TlsContext& ctx,
   }
 }
 
-enum ssl_select_cert_result_t
-ServerContextImpl::selectTlsContext(const SSL_CLIENT_HELLO* ssl_client_hello) {
-  const bool client_ecdsa_capable = isClientEcdsaCapable(ssl_client_hello);
-  const bool client_ocsp_capable = isClientOcspCapable(ssl_client_hello);
+void ServerContextImpl::indexTlsContexts() {
+  for (uint32_t i = 0; i < tls_contexts_.size(); ++i) {
+    if (tls_contexts_[i].cert_chain_ == nullptr) {
+      continue;
+    }
+    for (const std::string& name : certificateServerNames(*tls_contexts_[i].cert_chain_)) {
+      if (absl::StartsWith(name, "*.")) {
+        wildcard_server_names_[name.substr(2)].push_back(i);
+      } else {
+        exact_server_names_[name].push_back(i);
+      }
+    }
+  }
+}
 
-  // Fallback on first certificate.
-  const TlsContext* selected_ctx = &tls_contexts_[0];
-  auto ocsp_staple_action = ocspStapleAction(*selected_ctx, client_ocsp_capable);
-  for (const auto& ctx : tls_contexts_) {
+const std::vector<uint32_t>*
+ServerContextImpl::findTlsContexts(absl::string_view server_name) const {
+  if (server_name.empty()) {
+    return nullptr;
+  }
+  const std::string name = absl::AsciiStrToLower(server_name);
+  auto exact = exact_server_names_.find(name);
+  if (exact != exact_server_names_.end()) {
+    return &exact->second;
+  }
+  // A wildcard only matches a single label.
+  const size_t dot = name.find('.');
+  if (dot != std::string::npos) {
+    auto wildcard = wildcard_server_names_.find(absl::string_view(name).substr(dot + 1));
+    if (wildcard != wildcard_server_names_.end()) {
+      return &wildcard->second;
+    }
+  }
+  return nullptr;
+}
+
+const TlsContext* ServerContextImpl::findTlsContext(const std::vector<uint32_t>* indices,
+                                                    bool client_ecdsa_capable,
+                                                    bool client_ocsp_capable,
+                                                    OcspStapleAction& action) {
+  const size_t size = indices != nullptr ? indices->size() : tls_contexts_.size();
+  for (size_t i = 0; i < size; ++i) {
+    const TlsContext& ctx = tls_contexts_[indices != nullptr ? (*indices)[i] : i];
     if (client_ecdsa_capable != ctx.is_ecdsa_) {
       continue;
     }
 
-    auto action = ocspStapleAction(ctx, client_ocsp_capable);
-    if (action == OcspStapleAction::Fail) {
+    auto ctx_action = ocspStapleAction(ctx, client_ocsp_capable);
+    if (ctx_action == OcspStapleAction::Fail) {
       continue;
     }
 
-    selected_ctx = &ctx;
-    ocsp_staple_action = action;
-    break;
+    action = ctx_action;
+    return &ctx;
+  }
+  return nullptr;
+}
+
+enum ssl_select_cert_result_t
+ServerContextImpl::selectTlsContext(const SSL_CLIENT_HELLO* ssl_client_hello) {
+  const bool client_ecdsa_capable = isClientEcdsaCapable(ssl_client_hello);
+  const bool client_ocsp_capable = isClientOcspCapable(ssl_client_hello);
+
+  // Look for a certificate for the server name first, and then for any certificate, so that the
+  // selection doesn't depend on the SNI when there is a single certificate of each type.
+  OcspStapleAction ocsp_staple_action = OcspStapleAction::ClientNotCapable;
+  const std::vector<uint32_t>* server_name_ctxs = findTlsContexts(absl::NullSafeStringView(
+      SSL_get_servername(ssl_client_hello->ssl, TLSEXT_NAMETYPE_host_name)));
+  const TlsContext* selected_ctx = nullptr;
+  if (server_name_ctxs != nullptr) {
+    selected_ctx = findTlsContext(server_name_ctxs, client_ecdsa_capable, client_ocsp_capable,
+                                  ocsp_staple_action);
+  }
+  if (selected_ctx == nullptr) {
+    selected_ctx =
+        findTlsContext(nullptr, client_ecdsa_capable, client_ocsp_capable, ocsp_staple_action);
+  }
+  if (selected_ctx == nullptr) {
+    // Fallback on first certificate.
+    selected_ctx = &tls_contexts_[0];
+    ocsp_staple_action = ocspStapleAction(*selected_ctx, client_ocsp_capable);
   }
 
   // Apply the selected context. This must be done before OCSP stapling below
@@ -6,10 +6,13 @@
 #include <string>
 #include <vector>
 
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
 #include "envoy/network/transport_socket.h"
 #include "envoy/ssl/context.h"
 #include "envoy/ssl/context_config.h"
 #include "envoy/ssl/private_key/private_key.h"
+#include "envoy/ssl/session_cache.h"
 #include "envoy/ssl/ssl_socket_extended_info.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
@@ -21,6 +24,7 @@
 #include "source/extensions/transport_sockets/tls/ocsp/ocsp.h"
 #include "source/extensions/transport_sockets/tls/stats.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
 #include "openssl/ssl.h"
 #include "openssl/x509v3.h"
@@ -66,6 +70,12 @@ public:
 
   SslStats& stats() { return stats_; }
 
+  /**
+   * @return true if the TLS records of the connections are to be offloaded to the kernel once
+   *         their handshake completes.
+   */
+  bool kernelTlsEnabled() const { return kernel_tls_enabled_; }
+
   /**
    * The global SSL-library index used for storing a pointer to the SslExtendedSocketInfo
    * class in the SSL instance, for retrieval in callbacks.
@@ -80,6 +90,21 @@ public:
 
   std::vector<Ssl::PrivateKeyMethodProviderSharedPtr> getPrivateKeyMethodProviders();
 
+  /**
+   * Associates a connection with the session cache lookups of the context, if it has a session
+   * cache.
+   * @param ssl the connection.
+   * @param dispatcher the dispatcher of the connection.
+   * @param resume_handshake the callback resuming the handshake once a lookup completes.
+   */
+  virtual void registerSessionCacheLookups(SSL*, Event::Dispatcher&, std::function<void()>) {}
+
+  /**
+   * Cancels the session cache lookup of a connection, if any.
+   * @param ssl the connection.
+   */
+  virtual void unregisterSessionCacheLookups(SSL*) {}
+
   bool verifyCertChain(X509& leaf_cert, STACK_OF(X509) & intermediates, std::string& error_details);
 
 protected:
@@ -124,6 +149,7 @@ protected:
   const Stats::StatName ssl_curves_;
   const Stats::StatName ssl_sigalgs_;
   const Ssl::HandshakerCapabilities capabilities_;
+  const bool kernel_tls_enabled_;
 };
 
 using ContextImplSharedPtr = std::shared_ptr<ContextImpl>;
@@ -159,9 +185,33 @@ public:
   // manually create and use this as a client hello callback.
   enum ssl_select_cert_result_t selectTlsContext(const SSL_CLIENT_HELLO* ssl_client_hello);
 
+  // ContextImpl
+  void registerSessionCacheLookups(SSL* ssl, Event::Dispatcher& dispatcher,
+                                   std::function<void()> resume_handshake) override;
+  void unregisterSessionCacheLookups(SSL* ssl) override;
+
 private:
   using SessionContextID = std::array<uint8_t, SSL_MAX_SSL_SESSION_ID_LENGTH>;
 
+  // The session cache lookups of a connection, one at a time.
+  struct SessionCacheLookup {
+    SessionCacheLookup(Event::Dispatcher& dispatcher, std::function<void()> resume_handshake)
+        : dispatcher_(dispatcher), resume_timer_(dispatcher.createTimer(resume_handshake)) {}
+
+    Event::Dispatcher& dispatcher_;
+    // Resumes the handshake once an asynchronous lookup completes, out of the callback of the
+    // lookup, which may be destroyed by the handshake.
+    const Event::TimerPtr resume_timer_;
+    Ssl::SessionCacheLookupHandlePtr handle_;
+    // Whether the handshake waits for the lookup.
+    bool pending_{};
+    bool done_{};
+    absl::optional<std::string> session_;
+  };
+
+  // The SSL user data index of the session cache lookup of a connection.
+  static int sessionCacheLookupIndex();
+
   int alpnSelectCallback(const unsigned char** out, unsigned char* outlen, const unsigned char* in,
                          unsigned int inlen);
   int sessionTicketProcess(SSL* ssl, uint8_t* key_name, uint8_t* iv, EVP_CIPHER_CTX* ctx,
@@ -169,11 +219,30 @@ private:
   bool isClientEcdsaCapable(const SSL_CLIENT_HELLO* ssl_client_hello);
   bool isClientOcspCapable(const SSL_CLIENT_HELLO* ssl_client_hello);
   OcspStapleAction ocspStapleAction(const TlsContext& ctx, bool client_ocsp_capable);
+  // Indexes the certificates by the server names they are valid for.
+  void indexTlsContexts();
+  // The certificates for a server name, exact names first, or nullptr if there are none.
+  const std::vector<uint32_t>* findTlsContexts(absl::string_view server_name) const;
+  // Looks for the first certificate matching the key type of the client and the OCSP policy
+  // among the given certificates, or among all of them if indices is nullptr.
+  const TlsContext* findTlsContext(const std::vector<uint32_t>* indices, bool client_ecdsa_capable,
+                                   bool client_ocsp_capable, OcspStapleAction& action);
 
   SessionContextID generateHashForSessionContextId(const std::vector<std::string>& server_names);
 
+  // The session cache callbacks.
+  int newSession(SSL_SESSION* session);
+  SSL_SESSION* getSession(SSL* ssl, const uint8_t* session_id, int session_id_len);
+  void removeSession(SSL_SESSION* session);
+
   const std::vector<Envoy::Ssl::ServerContextConfig::SessionTicketKey> session_ticket_keys_;
   const Ssl::ServerContextConfig::OcspStaplePolicy ocsp_staple_policy_;
+  const Ssl::SessionCacheSharedPtr session_cache_;
+  // The indices in tls_contexts_ of the certificates by exact server name, and of the wildcard
+  // certificates by the domain following their wildcard label, e.g. "example.com" for
+  // "*.example.com".
+  absl::flat_hash_map<std::string, std::vector<uint32_t>> exact_server_names_;
+  absl::flat_hash_map<std::string, std::vector<uint32_t>> wildcard_server_names_;
 };
 
 } // namespace Tls
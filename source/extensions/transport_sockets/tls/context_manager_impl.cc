@@ -15,6 +15,7 @@ namespace TransportSockets {
 namespace Tls {
 
 ContextManagerImpl::~ContextManagerImpl() {
+  absl::MutexLock lock(&mutex_);
   removeEmptyContexts();
   KNOWN_ISSUE_ASSERT(contexts_.empty(), "https://github.com/envoyproxy/envoy/issues/10030");
 }
@@ -35,6 +36,14 @@ void ContextManagerImpl::removeOldContext(std::shared_ptr<Envoy::Ssl::Context> o
   }
 }
 
+void ContextManagerImpl::addContext(std::shared_ptr<Envoy::Ssl::Context> context,
+                                    std::shared_ptr<Envoy::Ssl::Context> old_context) {
+  absl::MutexLock lock(&mutex_);
+  removeOldContext(old_context);
+  removeEmptyContexts();
+  contexts_.emplace_back(context);
+}
+
 Envoy::Ssl::ClientContextSharedPtr
 ContextManagerImpl::createSslClientContext(Stats::Scope& scope,
                                            const Envoy::Ssl::ClientContextConfig& config,
@@ -45,9 +54,7 @@ ContextManagerImpl::createSslClientContext(Stats::Scope& scope,
 
   Envoy::Ssl::ClientContextSharedPtr context =
       std::make_shared<ClientContextImpl>(scope, config, time_source_);
-  removeOldContext(old_context);
-  removeEmptyContexts();
-  contexts_.emplace_back(context);
+  addContext(context, old_context);
   return context;
 }
 
@@ -60,14 +67,13 @@ Envoy::Ssl::ServerContextSharedPtr ContextManagerImpl::createSslServerContext(
 
   Envoy::Ssl::ServerContextSharedPtr context =
       std::make_shared<ServerContextImpl>(scope, config, server_names, time_source_);
-  removeOldContext(old_context);
-  removeEmptyContexts();
-  contexts_.emplace_back(context);
+  addContext(context, old_context);
   return context;
 }
 
 size_t ContextManagerImpl::daysUntilFirstCertExpires() const {
   size_t ret = std::numeric_limits<int>::max();
+  absl::MutexLock lock(&mutex_);
   for (const auto& ctx_weak_ptr : contexts_) {
     Envoy::Ssl::ContextSharedPtr context = ctx_weak_ptr.lock();
     if (context) {
@@ -79,6 +85,7 @@ size_t ContextManagerImpl::daysUntilFirstCertExpires() const {
 
 absl::optional<uint64_t> ContextManagerImpl::secondsUntilFirstOcspResponseExpires() const {
   absl::optional<uint64_t> ret;
+  absl::MutexLock lock(&mutex_);
   for (const auto& ctx_weak_ptr : contexts_) {
     Envoy::Ssl::ContextSharedPtr context = ctx_weak_ptr.lock();
     if (context) {
@@ -93,7 +100,12 @@ absl::optional<uint64_t> ContextManagerImpl::secondsUntilFirstOcspResponseExpire
 }
 
 void ContextManagerImpl::iterateContexts(std::function<void(const Envoy::Ssl::Context&)> callback) {
-  for (const auto& ctx_weak_ptr : contexts_) {
+  std::list<std::weak_ptr<Envoy::Ssl::Context>> contexts;
+  {
+    absl::MutexLock lock(&mutex_);
+    contexts = contexts_;
+  }
+  for (const auto& ctx_weak_ptr : contexts) {
     Envoy::Ssl::ContextSharedPtr context = ctx_weak_ptr.lock();
     if (context) {
       callback(*context);
@@ -10,6 +10,8 @@
 
 #include "source/extensions/transport_sockets/tls/private_key/private_key_manager_impl.h"
 
+#include "absl/synchronization/mutex.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace TransportSockets {
@@ -17,9 +19,9 @@ namespace Tls {
 
 /**
  * The SSL context manager has the following threading model:
- * Contexts can be allocated via any thread (through in practice they are only allocated on the main
- * thread). They can be released from any thread (and in practice are since cluster information can
- * be released from any thread). Context allocation/free is a very uncommon thing so we just do a
+ * Contexts can be allocated via any thread (in practice on the main thread and, when configured,
+ * on the cluster init threads). They can be released from any thread (and in practice are since
+ * cluster information can be released from any thread). Context allocation/free is a very uncommon thing so we just do a
  * global lock to protect it all.
  */
 class ContextManagerImpl final : public Envoy::Ssl::ContextManager {
@@ -43,10 +45,14 @@ public:
   };
 
 private:
-  void removeEmptyContexts();
-  void removeOldContext(std::shared_ptr<Envoy::Ssl::Context> old_context);
+  void addContext(std::shared_ptr<Envoy::Ssl::Context> context,
+                  std::shared_ptr<Envoy::Ssl::Context> old_context);
+  void removeEmptyContexts() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void removeOldContext(std::shared_ptr<Envoy::Ssl::Context> old_context)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   TimeSource& time_source_;
-  std::list<std::weak_ptr<Envoy::Ssl::Context>> contexts_;
+  mutable absl::Mutex mutex_;
+  std::list<std::weak_ptr<Envoy::Ssl::Context>> contexts_ ABSL_GUARDED_BY(mutex_);
   PrivateKeyMethodManagerImpl private_key_method_manager_{};
 };
 
@@ -0,0 +1,233 @@
+#include "source/extensions/transport_sockets/tls/kernel_tls.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "source/common/api/os_sys_calls_impl.h"
+
+#include "absl/strings/str_cat.h"
+#include "openssl/digest.h"
+#include "openssl/hkdf.h"
+
+#ifdef __linux__
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace KernelTls {
+
+#ifdef __linux__
+
+namespace {
+
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+
+// The sizes of the keys and implicit IVs of a cipher.
+struct CipherSizes {
+  size_t key_len_;
+  size_t iv_len_;
+};
+
+// The keys of a direction, in the layout of the kernel.
+union CryptoInfo {
+  tls12_crypto_info_aes_gcm_128 aes_gcm_128_;
+  tls12_crypto_info_aes_gcm_256 aes_gcm_256_;
+  tls12_crypto_info_chacha20_poly1305 chacha20_poly1305_;
+};
+
+// Fills the keys of a direction. The IV is the implicit IV of the connection, its salt followed by
+// the IV of the kernel, which is the explicit nonce of the records with TLS 1.2 AES-GCM.
+template <class CryptoInfoT>
+socklen_t fillCryptoInfo(CryptoInfoT& info, uint16_t version, uint16_t cipher_type,
+                         const uint8_t* key, const uint8_t* iv, uint64_t seq) {
+  uint8_t seq_bytes[8];
+  for (size_t i = 0; i < sizeof(seq_bytes); i++) {
+    seq_bytes[i] = static_cast<uint8_t>(seq >> (56 - 8 * i));
+  }
+  info.info.version = version;
+  info.info.cipher_type = cipher_type;
+  memcpy(info.key, key, sizeof(info.key));
+  memcpy(info.salt, iv, sizeof(info.salt));
+  if (version == TLS_1_2_VERSION && cipher_type != TLS_CIPHER_CHACHA20_POLY1305) {
+    // BoringSSL uses the sequence number of the records as their explicit nonce.
+    memcpy(info.iv, seq_bytes, sizeof(info.iv));
+  } else {
+    memcpy(info.iv, iv + sizeof(info.salt), sizeof(info.iv));
+  }
+  memcpy(info.rec_seq, seq_bytes, sizeof(info.rec_seq));
+  return sizeof(info);
+}
+
+socklen_t fillCryptoInfo(CryptoInfo& info, uint16_t version, int cipher_nid, const uint8_t* key,
+                         const uint8_t* iv, uint64_t seq) {
+  switch (cipher_nid) {
+  case NID_aes_128_gcm:
+    return fillCryptoInfo(info.aes_gcm_128_, version, TLS_CIPHER_AES_GCM_128, key, iv, seq);
+  case NID_aes_256_gcm:
+    return fillCryptoInfo(info.aes_gcm_256_, version, TLS_CIPHER_AES_GCM_256, key, iv, seq);
+  default:
+    return fillCryptoInfo(info.chacha20_poly1305_, version, TLS_CIPHER_CHACHA20_POLY1305, key, iv,
+                          seq);
+  }
+}
+
+// HKDF-Expand-Label of RFC 8446, with an empty context.
+bool expandLabel(const EVP_MD* digest, bssl::Span<const uint8_t> secret, absl::string_view label,
+                 uint8_t* out, size_t out_len) {
+  const std::string full_label = absl::StrCat("tls13 ", label);
+  std::vector<uint8_t> info;
+  info.push_back(static_cast<uint8_t>(out_len >> 8));
+  info.push_back(static_cast<uint8_t>(out_len));
+  info.push_back(static_cast<uint8_t>(full_label.size()));
+  info.insert(info.end(), full_label.begin(), full_label.end());
+  info.push_back(0);
+  return HKDF_expand(out, out_len, digest, secret.data(), secret.size(), info.data(),
+                     info.size()) == 1;
+}
+
+// The keys and implicit IVs of both directions of a connection.
+struct TrafficKeys {
+  std::vector<uint8_t> write_key_;
+  std::vector<uint8_t> write_iv_;
+  std::vector<uint8_t> read_key_;
+  std::vector<uint8_t> read_iv_;
+};
+
+bool getTls12Keys(SSL* ssl, const CipherSizes& sizes, TrafficKeys& keys) {
+  // The key block of an AEAD cipher has no MAC keys: the client key, the server key, the client IV
+  // and the server IV.
+  const size_t key_block_len = 2 * (sizes.key_len_ + sizes.iv_len_);
+  if (SSL_get_key_block_len(ssl) != key_block_len) {
+    return false;
+  }
+  std::vector<uint8_t> key_block(key_block_len);
+  if (SSL_generate_key_block(ssl, key_block.data(), key_block.size()) != 1) {
+    return false;
+  }
+  const uint8_t* client_key = key_block.data();
+  const uint8_t* server_key = client_key + sizes.key_len_;
+  const uint8_t* client_iv = server_key + sizes.key_len_;
+  const uint8_t* server_iv = client_iv + sizes.iv_len_;
+  const bool server = SSL_is_server(ssl);
+  const uint8_t* write_key = server ? server_key : client_key;
+  const uint8_t* write_iv = server ? server_iv : client_iv;
+  const uint8_t* read_key = server ? client_key : server_key;
+  const uint8_t* read_iv = server ? client_iv : server_iv;
+  keys.write_key_.assign(write_key, write_key + sizes.key_len_);
+  keys.write_iv_.assign(write_iv, write_iv + sizes.iv_len_);
+  keys.read_key_.assign(read_key, read_key + sizes.key_len_);
+  keys.read_iv_.assign(read_iv, read_iv + sizes.iv_len_);
+  return true;
+}
+
+bool getTls13Keys(SSL* ssl, const SSL_CIPHER* cipher, const CipherSizes& sizes,
+                  TrafficKeys& keys) {
+  bssl::Span<const uint8_t> read_secret;
+  bssl::Span<const uint8_t> write_secret;
+  const EVP_MD* digest = EVP_get_digestbynid(SSL_CIPHER_get_prf_nid(cipher));
+  if (digest == nullptr || !bssl::SSL_get_traffic_secrets(ssl, &read_secret, &write_secret)) {
+    return false;
+  }
+  keys.write_key_.resize(sizes.key_len_);
+  keys.write_iv_.resize(sizes.iv_len_);
+  keys.read_key_.resize(sizes.key_len_);
+  keys.read_iv_.resize(sizes.iv_len_);
+  return expandLabel(digest, write_secret, "key", keys.write_key_.data(), sizes.key_len_) &&
+         expandLabel(digest, write_secret, "iv", keys.write_iv_.data(), sizes.iv_len_) &&
+         expandLabel(digest, read_secret, "key", keys.read_key_.data(), sizes.key_len_) &&
+         expandLabel(digest, read_secret, "iv", keys.read_iv_.data(), sizes.iv_len_);
+}
+
+} // namespace
+
+Offload offload(SSL* ssl, Network::IoHandle& io_handle) {
+  const uint16_t version = SSL_version(ssl);
+  if (version != TLS1_2_VERSION && version != TLS1_3_VERSION) {
+    return {};
+  }
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  if (cipher == nullptr) {
+    return {};
+  }
+  const int cipher_nid = SSL_CIPHER_get_cipher_nid(cipher);
+  CipherSizes sizes;
+  switch (cipher_nid) {
+  case NID_aes_128_gcm:
+    sizes = {TLS_CIPHER_AES_GCM_128_KEY_SIZE, version == TLS1_2_VERSION ? 4u : 12u};
+    break;
+  case NID_aes_256_gcm:
+    sizes = {TLS_CIPHER_AES_GCM_256_KEY_SIZE, version == TLS1_2_VERSION ? 4u : 12u};
+    break;
+  case NID_chacha20_poly1305:
+    sizes = {TLS_CIPHER_CHACHA20_POLY1305_KEY_SIZE, 12};
+    break;
+  default:
+    return {};
+  }
+
+  TrafficKeys keys;
+  if (!(version == TLS1_2_VERSION ? getTls12Keys(ssl, sizes, keys)
+                                  : getTls13Keys(ssl, cipher, sizes, keys))) {
+    return {};
+  }
+
+  // Until its keys are installed, a socket with the TLS ULP behaves as a plain TCP socket.
+  static constexpr char Ulp[] = "tls";
+  if (io_handle.setOption(IPPROTO_TCP, TCP_ULP, Ulp, sizeof(Ulp)).rc_ != 0) {
+    return {};
+  }
+  Offload result;
+  CryptoInfo info;
+  socklen_t info_len = fillCryptoInfo(info, version, cipher_nid, keys.write_key_.data(),
+                                      keys.write_iv_.data(), SSL_get_write_sequence(ssl));
+  result.tx_ = io_handle.setOption(SOL_TLS, TLS_TX, &info, info_len).rc_ == 0;
+  if (result.tx_ && !SSL_has_pending(ssl) && (version == TLS1_2_VERSION || SSL_is_server(ssl))) {
+    info_len = fillCryptoInfo(info, version, cipher_nid, keys.read_key_.data(),
+                              keys.read_iv_.data(), SSL_get_read_sequence(ssl));
+    result.rx_ = io_handle.setOption(SOL_TLS, TLS_RX, &info, info_len).rc_ == 0;
+  }
+  OPENSSL_cleanse(&info, sizeof(info));
+  return result;
+}
+
+bool sendCloseNotify(Network::IoHandle& io_handle) {
+  // A warning level close_notify alert, sent as a record of the alert content type.
+  static constexpr uint8_t AlertContentType = 21;
+  uint8_t alert[] = {1, 0};
+  iovec iov{alert, sizeof(alert)};
+  char control[CMSG_SPACE(sizeof(AlertContentType))] = {};
+  msghdr message{};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(AlertContentType));
+  *CMSG_DATA(cmsg) = AlertContentType;
+  return Api::OsSysCallsSingleton::get()
+             .sendmsg(io_handle.fdDoNotUse(), &message, MSG_NOSIGNAL)
+             .rc_ == static_cast<ssize_t>(sizeof(alert));
+}
+
+#else
+
+Offload offload(SSL*, Network::IoHandle&) { return {}; }
+
+bool sendCloseNotify(Network::IoHandle&) { return false; }
+
+#endif
+
+} // namespace KernelTls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
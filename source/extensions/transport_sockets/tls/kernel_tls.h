@@ -0,0 +1,44 @@
+#pragma once
+
+#include "envoy/network/io_handle.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace KernelTls {
+
+/**
+ * The directions of a connection whose TLS records are encrypted and decrypted by the kernel.
+ */
+struct Offload {
+  bool tx_{};
+  bool rx_{};
+};
+
+/**
+ * Installs the keys of a connection whose handshake completed into the kernel, which then
+ * encrypts what is written to the socket and decrypts what is read from it. Once a direction is
+ * offloaded, BoringSSL must not be used for it anymore. The reads of TLS 1.3 clients are left to
+ * BoringSSL, as the servers send them session tickets after the handshake, as well as the reads of
+ * the connections with records already buffered by BoringSSL.
+ * @param ssl the connection.
+ * @param io_handle the socket of the connection.
+ * @return the directions offloaded, none if the kernel or the cipher of the connection doesn't
+ *         support it.
+ */
+Offload offload(SSL* ssl, Network::IoHandle& io_handle);
+
+/**
+ * Sends a close_notify alert on a connection whose writes are offloaded.
+ * @return true if the alert was sent.
+ */
+bool sendCloseNotify(Network::IoHandle& io_handle);
+
+} // namespace KernelTls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
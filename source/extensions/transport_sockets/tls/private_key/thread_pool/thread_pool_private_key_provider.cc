@@ -0,0 +1,389 @@
+#include "source/extensions/transport_sockets/tls/private_key/thread_pool/thread_pool_private_key_provider.h"
+
+#include <algorithm>
+
+#include "envoy/common/exception.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
+#include "source/common/config/datasource.h"
+#include "source/common/protobuf/utility.h"
+
+#include "openssl/err.h"
+#include "openssl/evp.h"
+#include "openssl/pem.h"
+#include "openssl/rsa.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+namespace {
+
+constexpr uint32_t DefaultMaxQueueDepth = 1024;
+
+bool signWith(EVP_PKEY* pkey, uint16_t signature_algorithm, const std::vector<uint8_t>& in,
+              std::vector<uint8_t>& out) {
+  if (SSL_get_signature_algorithm_key_type(signature_algorithm) != EVP_PKEY_id(pkey)) {
+    return false;
+  }
+  const EVP_MD* md = SSL_get_signature_algorithm_digest(signature_algorithm);
+  if (md == nullptr) {
+    return false;
+  }
+
+  bssl::ScopedEVP_MD_CTX ctx;
+  EVP_PKEY_CTX* pctx;
+  if (!EVP_DigestSignInit(ctx.get(), &pctx, md, nullptr, pkey)) {
+    return false;
+  }
+  if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm) &&
+      (!EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_PKCS1_PSS_PADDING) ||
+       // A salt as long as the digest.
+       !EVP_PKEY_CTX_set_rsa_pss_saltlen(pctx, -1))) {
+    return false;
+  }
+
+  size_t out_len = EVP_PKEY_size(pkey);
+  out.resize(out_len);
+  if (!EVP_DigestSign(ctx.get(), out.data(), &out_len, in.data(), in.size())) {
+    return false;
+  }
+  out.resize(out_len);
+  return true;
+}
+
+bool decryptWith(EVP_PKEY* pkey, const std::vector<uint8_t>& in, std::vector<uint8_t>& out) {
+  RSA* rsa = EVP_PKEY_get0_RSA(pkey);
+  if (rsa == nullptr) {
+    return false;
+  }
+  size_t out_len;
+  out.resize(RSA_size(rsa));
+  if (!RSA_decrypt(rsa, &out_len, out.data(), out.size(), in.data(), in.size(), RSA_NO_PADDING)) {
+    return false;
+  }
+  out.resize(out_len);
+  return true;
+}
+
+ThreadPoolPrivateKeyConnection* getConnection(SSL* ssl, int index) {
+  return static_cast<ThreadPoolPrivateKeyConnection*>(SSL_get_ex_data(ssl, index));
+}
+
+ssl_private_key_result_t privateKeySign(SSL* ssl, int index, uint8_t* out, size_t* out_len,
+                                        size_t max_out, uint16_t signature_algorithm,
+                                        const uint8_t* in, size_t in_len) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl, index);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  return connection->sign(out, out_len, max_out, signature_algorithm, in, in_len);
+}
+
+ssl_private_key_result_t privateKeyDecrypt(SSL* ssl, int index, uint8_t* out, size_t* out_len,
+                                           size_t max_out, const uint8_t* in, size_t in_len) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl, index);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  return connection->decrypt(out, out_len, max_out, in, in_len);
+}
+
+ssl_private_key_result_t privateKeyComplete(SSL* ssl, int index, uint8_t* out, size_t* out_len,
+                                            size_t max_out) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl, index);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  return connection->complete(out, out_len, max_out);
+}
+
+ssl_private_key_result_t rsaPrivateKeySign(SSL* ssl, uint8_t* out, size_t* out_len, size_t max_out,
+                                           uint16_t signature_algorithm, const uint8_t* in,
+                                           size_t in_len) {
+  return privateKeySign(ssl, ThreadPoolPrivateKeyMethodProvider::rsaConnectionIndex(), out,
+                        out_len, max_out, signature_algorithm, in, in_len);
+}
+
+ssl_private_key_result_t rsaPrivateKeyDecrypt(SSL* ssl, uint8_t* out, size_t* out_len,
+                                              size_t max_out, const uint8_t* in, size_t in_len) {
+  return privateKeyDecrypt(ssl, ThreadPoolPrivateKeyMethodProvider::rsaConnectionIndex(), out,
+                           out_len, max_out, in, in_len);
+}
+
+ssl_private_key_result_t rsaPrivateKeyComplete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                               size_t max_out) {
+  return privateKeyComplete(ssl, ThreadPoolPrivateKeyMethodProvider::rsaConnectionIndex(), out,
+                            out_len, max_out);
+}
+
+ssl_private_key_result_t ecdsaPrivateKeySign(SSL* ssl, uint8_t* out, size_t* out_len,
+                                             size_t max_out, uint16_t signature_algorithm,
+                                             const uint8_t* in, size_t in_len) {
+  return privateKeySign(ssl, ThreadPoolPrivateKeyMethodProvider::ecdsaConnectionIndex(), out,
+                        out_len, max_out, signature_algorithm, in, in_len);
+}
+
+ssl_private_key_result_t ecdsaPrivateKeyDecrypt(SSL*, uint8_t*, size_t*, size_t, const uint8_t*,
+                                                size_t) {
+  // Only RSA keys decrypt.
+  return ssl_private_key_failure;
+}
+
+ssl_private_key_result_t ecdsaPrivateKeyComplete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                                 size_t max_out) {
+  return privateKeyComplete(ssl, ThreadPoolPrivateKeyMethodProvider::ecdsaConnectionIndex(), out,
+                            out_len, max_out);
+}
+
+int createIndex() {
+  int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+  RELEASE_ASSERT(index >= 0, "Failed to get SSL user data index.");
+  return index;
+}
+
+} // namespace
+
+SigningThreadPool::SigningThreadPool(Thread::ThreadFactory& thread_factory, uint32_t num_threads,
+                                     uint32_t max_queue_depth, Stats::Gauge& queue_depth)
+    : max_queue_depth_(max_queue_depth), queue_depth_(queue_depth) {
+  threads_.reserve(num_threads);
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads_.push_back(thread_factory.createThread([this]() { threadRoutine(); },
+                                                   Thread::Options{"PrivateKeyOps"}));
+  }
+}
+
+SigningThreadPool::~SigningThreadPool() {
+  {
+    Thread::LockGuard lock(mutex_);
+    stopping_ = true;
+    cond_var_.notifyAll();
+  }
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+  Thread::LockGuard lock(mutex_);
+  queue_depth_.sub(queue_.size());
+}
+
+bool SigningThreadPool::tryPost(std::function<void()> cb) {
+  Thread::LockGuard lock(mutex_);
+  if (queue_.size() >= max_queue_depth_) {
+    return false;
+  }
+  queue_.push_back(std::move(cb));
+  queue_depth_.inc();
+  cond_var_.notifyOne();
+  return true;
+}
+
+void SigningThreadPool::threadRoutine() {
+  while (true) {
+    std::function<void()> cb;
+    {
+      Thread::LockGuard lock(mutex_);
+      while (!stopping_ && queue_.empty()) {
+        cond_var_.wait(mutex_);
+      }
+      if (stopping_) {
+        return;
+      }
+      cb = std::move(queue_.front());
+      queue_.pop_front();
+      queue_depth_.dec();
+    }
+    cb();
+  }
+}
+
+void PrivateKeyOperation::finish(std::vector<uint8_t>&& output, bool success) {
+  output_ = std::move(output);
+  success_ = success;
+  absl::MutexLock lock(&mutex_);
+  if (cancelled_) {
+    return;
+  }
+  dispatcher_.post([operation = shared_from_this()]() {
+    {
+      absl::MutexLock lock(&operation->mutex_);
+      if (operation->cancelled_) {
+        return;
+      }
+    }
+    operation->done_ = true;
+    operation->cb_.onPrivateKeyMethodComplete();
+  });
+}
+
+void PrivateKeyOperation::cancel() {
+  absl::MutexLock lock(&mutex_);
+  cancelled_ = true;
+}
+
+ThreadPoolPrivateKeyConnection::~ThreadPoolPrivateKeyConnection() {
+  if (operation_ != nullptr) {
+    operation_->cancel();
+  }
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyConnection::sign(uint8_t* out, size_t* out_len,
+                                                              size_t max_out,
+                                                              uint16_t signature_algorithm,
+                                                              const uint8_t* in, size_t in_len) {
+  EVP_PKEY* pkey = provider_.privateKey();
+  return start(
+      [pkey, signature_algorithm, in = std::vector<uint8_t>(in, in + in_len)](
+          std::vector<uint8_t>& output) { return signWith(pkey, signature_algorithm, in, output); },
+      out, out_len, max_out);
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyConnection::decrypt(uint8_t* out, size_t* out_len,
+                                                                 size_t max_out, const uint8_t* in,
+                                                                 size_t in_len) {
+  EVP_PKEY* pkey = provider_.privateKey();
+  return start([pkey, in = std::vector<uint8_t>(in, in + in_len)](
+                   std::vector<uint8_t>& output) { return decryptWith(pkey, in, output); },
+               out, out_len, max_out);
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyConnection::complete(uint8_t* out, size_t* out_len,
+                                                                  size_t max_out) {
+  if (operation_ == nullptr) {
+    return ssl_private_key_failure;
+  }
+  if (!operation_->done()) {
+    return ssl_private_key_retry;
+  }
+  PrivateKeyOperationSharedPtr operation = std::move(operation_);
+  if (!operation->success()) {
+    provider_.stats().failures_.inc();
+    return ssl_private_key_failure;
+  }
+  return copyOutput(operation->output(), out, out_len, max_out);
+}
+
+ssl_private_key_result_t
+ThreadPoolPrivateKeyConnection::start(std::function<bool(std::vector<uint8_t>&)> op, uint8_t* out,
+                                      size_t* out_len, size_t max_out) {
+  ASSERT(operation_ == nullptr);
+  auto operation = std::make_shared<PrivateKeyOperation>(cb_, dispatcher_);
+  if (provider_.pool().tryPost([operation, op]() {
+        std::vector<uint8_t> output;
+        const bool success = op(output);
+        // The errors of the operation stay on the pool thread, where no one reads them.
+        ERR_clear_error();
+        operation->finish(std::move(output), success);
+      })) {
+    provider_.stats().offloaded_.inc();
+    operation_ = std::move(operation);
+    return ssl_private_key_retry;
+  }
+
+  // The pool is overloaded, so the operation runs right away, as it would without the provider.
+  provider_.stats().inline_fallback_.inc();
+  std::vector<uint8_t> output;
+  if (!op(output)) {
+    provider_.stats().failures_.inc();
+    return ssl_private_key_failure;
+  }
+  return copyOutput(output, out, out_len, max_out);
+}
+
+ssl_private_key_result_t
+ThreadPoolPrivateKeyConnection::copyOutput(const std::vector<uint8_t>& output, uint8_t* out,
+                                           size_t* out_len, size_t max_out) {
+  if (output.size() > max_out) {
+    provider_.stats().failures_.inc();
+    return ssl_private_key_failure;
+  }
+  std::copy(output.begin(), output.end(), out);
+  *out_len = output.size();
+  return ssl_private_key_success;
+}
+
+ThreadPoolPrivateKeyMethodProvider::ThreadPoolPrivateKeyMethodProvider(
+    const envoy::extensions::private_key_providers::thread_pool::v3alpha::
+        ThreadPoolPrivateKeyMethodConfig& config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context)
+    : stats_({ALL_THREAD_POOL_PRIVATE_KEY_PROVIDER_STATS(
+          POOL_COUNTER_PREFIX(factory_context.scope(), "thread_pool_private_key_provider."),
+          POOL_GAUGE_PREFIX(factory_context.scope(), "thread_pool_private_key_provider."))}) {
+  const std::string private_key =
+      Config::DataSource::read(config.private_key(), false, factory_context.api());
+  bssl::UniquePtr<BIO> bio(
+      BIO_new_mem_buf(const_cast<char*>(private_key.data()), private_key.size()));
+  pkey_.reset(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+  if (pkey_ == nullptr) {
+    throw EnvoyException("Failed to load the private key of the thread pool private key provider.");
+  }
+
+  method_ = std::make_shared<SSL_PRIVATE_KEY_METHOD>();
+  switch (EVP_PKEY_id(pkey_.get())) {
+  case EVP_PKEY_RSA:
+    method_->sign = rsaPrivateKeySign;
+    method_->decrypt = rsaPrivateKeyDecrypt;
+    method_->complete = rsaPrivateKeyComplete;
+    break;
+  case EVP_PKEY_EC:
+    method_->sign = ecdsaPrivateKeySign;
+    method_->decrypt = ecdsaPrivateKeyDecrypt;
+    method_->complete = ecdsaPrivateKeyComplete;
+    break;
+  default:
+    throw EnvoyException(
+        "The private key of the thread pool private key provider has to be an RSA or ECDSA key.");
+  }
+
+  const uint32_t thread_count = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      config, thread_count, std::max(factory_context.options().concurrency(), 1U));
+  pool_ = std::make_unique<SigningThreadPool>(
+      factory_context.api().threadFactory(), thread_count,
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_queue_depth, DefaultMaxQueueDepth),
+      stats_.queue_depth_);
+}
+
+int ThreadPoolPrivateKeyMethodProvider::connectionIndex() const {
+  return EVP_PKEY_id(pkey_.get()) == EVP_PKEY_RSA ? rsaConnectionIndex() : ecdsaConnectionIndex();
+}
+
+void ThreadPoolPrivateKeyMethodProvider::registerPrivateKeyMethod(
+    SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher) {
+  const int index = connectionIndex();
+  if (SSL_get_ex_data(ssl, index) != nullptr) {
+    throw EnvoyException(
+        "Can't distinguish between two registered providers for the same SSL object.");
+  }
+  SSL_set_ex_data(ssl, index, new ThreadPoolPrivateKeyConnection(*this, cb, dispatcher));
+}
+
+void ThreadPoolPrivateKeyMethodProvider::unregisterPrivateKeyMethod(SSL* ssl) {
+  const int index = connectionIndex();
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl, index);
+  SSL_set_ex_data(ssl, index, nullptr);
+  delete connection;
+}
+
+bool ThreadPoolPrivateKeyMethodProvider::checkFips() {
+  if (EVP_PKEY_id(pkey_.get()) == EVP_PKEY_RSA) {
+    RSA* rsa_private_key = EVP_PKEY_get0_RSA(pkey_.get());
+    return rsa_private_key != nullptr && RSA_check_fips(rsa_private_key);
+  }
+  const EC_KEY* ecdsa_private_key = EVP_PKEY_get0_EC_KEY(pkey_.get());
+  return ecdsa_private_key != nullptr && EC_KEY_check_fips(ecdsa_private_key);
+}
+
+int ThreadPoolPrivateKeyMethodProvider::rsaConnectionIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, createIndex());
+}
+
+int ThreadPoolPrivateKeyMethodProvider::ecdsaConnectionIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, createIndex());
+}
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/extensions/private_key_providers/thread_pool/v3alpha/thread_pool.pb.h"
+#include "envoy/server/transport_socket_config.h"
+#include "envoy/ssl/private_key/private_key.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/thread.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+/**
+ * All thread pool private key provider stats. @see stats_macros.h
+ */
+#define ALL_THREAD_POOL_PRIVATE_KEY_PROVIDER_STATS(COUNTER, GAUGE)                                 \
+  COUNTER(failures)                                                                                \
+  COUNTER(inline_fallback)                                                                         \
+  COUNTER(offloaded)                                                                               \
+  GAUGE(queue_depth, NeverImport)
+
+/**
+ * Struct definition for all thread pool private key provider stats. @see stats_macros.h
+ */
+struct ThreadPoolPrivateKeyProviderStats {
+  ALL_THREAD_POOL_PRIVATE_KEY_PROVIDER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * The threads running the private key operations of a ThreadPoolPrivateKeyMethodProvider, with a
+ * bounded queue.
+ */
+class SigningThreadPool {
+public:
+  SigningThreadPool(Thread::ThreadFactory& thread_factory, uint32_t num_threads,
+                    uint32_t max_queue_depth, Stats::Gauge& queue_depth);
+  ~SigningThreadPool();
+
+  /**
+   * Queues cb to run on the first free thread. Callbacks still queued when the pool is destroyed
+   * are dropped.
+   * @return false if the queue is full, in which case cb isn't queued.
+   */
+  bool tryPost(std::function<void()> cb);
+
+private:
+  void threadRoutine();
+
+  const uint32_t max_queue_depth_;
+  Stats::Gauge& queue_depth_;
+  Thread::MutexBasicLockable mutex_;
+  Thread::CondVar cond_var_;
+  std::deque<std::function<void()>> queue_ ABSL_GUARDED_BY(mutex_);
+  bool stopping_ ABSL_GUARDED_BY(mutex_){false};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+/**
+ * A private key operation queued to the pool. It's shared by the connection which started it and
+ * the pool, so that a connection closed during the operation doesn't wait for it.
+ */
+class PrivateKeyOperation : public std::enable_shared_from_this<PrivateKeyOperation> {
+public:
+  PrivateKeyOperation(Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher)
+      : cb_(cb), dispatcher_(dispatcher) {}
+
+  /**
+   * Called on the pool once the operation is done, to resume the handshake on the worker of the
+   * connection unless it was closed meanwhile.
+   */
+  void finish(std::vector<uint8_t>&& output, bool success);
+
+  /**
+   * Called on the worker of the connection when it's closed.
+   */
+  void cancel();
+
+  // Read on the worker of the connection once the handshake is resumed.
+  bool done() const { return done_; }
+  bool success() const { return success_; }
+  const std::vector<uint8_t>& output() const { return output_; }
+
+private:
+  Ssl::PrivateKeyConnectionCallbacks& cb_;
+  // Only used while the connection is open, which keeps the worker running.
+  Event::Dispatcher& dispatcher_;
+  absl::Mutex mutex_;
+  bool cancelled_ ABSL_GUARDED_BY(mutex_){false};
+  bool done_{false};
+  bool success_{false};
+  std::vector<uint8_t> output_;
+};
+
+using PrivateKeyOperationSharedPtr = std::shared_ptr<PrivateKeyOperation>;
+
+class ThreadPoolPrivateKeyMethodProvider;
+
+/**
+ * The private key operations of a connection, which runs at most one at a time.
+ */
+class ThreadPoolPrivateKeyConnection {
+public:
+  ThreadPoolPrivateKeyConnection(ThreadPoolPrivateKeyMethodProvider& provider,
+                                 Ssl::PrivateKeyConnectionCallbacks& cb,
+                                 Event::Dispatcher& dispatcher)
+      : provider_(provider), cb_(cb), dispatcher_(dispatcher) {}
+  ~ThreadPoolPrivateKeyConnection();
+
+  ssl_private_key_result_t sign(uint8_t* out, size_t* out_len, size_t max_out,
+                                uint16_t signature_algorithm, const uint8_t* in, size_t in_len);
+  ssl_private_key_result_t decrypt(uint8_t* out, size_t* out_len, size_t max_out,
+                                   const uint8_t* in, size_t in_len);
+  ssl_private_key_result_t complete(uint8_t* out, size_t* out_len, size_t max_out);
+
+private:
+  // Queues op to the pool, or runs it right away if the queue is full.
+  ssl_private_key_result_t start(std::function<bool(std::vector<uint8_t>&)> op, uint8_t* out,
+                                 size_t* out_len, size_t max_out);
+  ssl_private_key_result_t copyOutput(const std::vector<uint8_t>& output, uint8_t* out,
+                                      size_t* out_len, size_t max_out);
+
+  ThreadPoolPrivateKeyMethodProvider& provider_;
+  Ssl::PrivateKeyConnectionCallbacks& cb_;
+  Event::Dispatcher& dispatcher_;
+  PrivateKeyOperationSharedPtr operation_;
+};
+
+/**
+ * A private key provider running the operations with a local RSA or ECDSA private key on a pool of
+ * threads, and on the workers when the queue of the pool is full.
+ */
+class ThreadPoolPrivateKeyMethodProvider : public virtual Ssl::PrivateKeyMethodProvider {
+public:
+  /**
+   * @throw EnvoyException if the private key cannot be read or isn't an RSA or ECDSA key.
+   */
+  ThreadPoolPrivateKeyMethodProvider(
+      const envoy::extensions::private_key_providers::thread_pool::v3alpha::
+          ThreadPoolPrivateKeyMethodConfig& config,
+      Server::Configuration::TransportSocketFactoryContext& factory_context);
+
+  // Ssl::PrivateKeyMethodProvider
+  void registerPrivateKeyMethod(SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb,
+                                Event::Dispatcher& dispatcher) override;
+  void unregisterPrivateKeyMethod(SSL* ssl) override;
+  bool checkFips() override;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr getBoringSslPrivateKeyMethod() override {
+    return method_;
+  }
+
+  EVP_PKEY* privateKey() { return pkey_.get(); }
+  SigningThreadPool& pool() { return *pool_; }
+  ThreadPoolPrivateKeyProviderStats& stats() { return stats_; }
+
+  // The SSL user data indexes of the connections, by key type, so that an SSL object serving both
+  // an RSA and an ECDSA certificate can use a provider for each.
+  static int rsaConnectionIndex();
+  static int ecdsaConnectionIndex();
+
+private:
+  int connectionIndex() const;
+
+  bssl::UniquePtr<EVP_PKEY> pkey_;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr method_;
+  ThreadPoolPrivateKeyProviderStats stats_;
+  // Destroyed first, so that no operation is in progress once the key is freed.
+  std::unique_ptr<SigningThreadPool> pool_;
+};
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
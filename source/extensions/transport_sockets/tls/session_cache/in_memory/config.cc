@@ -0,0 +1,41 @@
+#include "source/extensions/transport_sockets/tls/session_cache/in_memory/config.h"
+
+#include "envoy/extensions/tls_session_caches/in_memory/v3alpha/in_memory.pb.validate.h"
+#include "envoy/registry/registry.h"
+#include "envoy/server/transport_socket_config.h"
+#include "envoy/singleton/manager.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/transport_sockets/tls/session_cache/in_memory/in_memory_session_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace SessionCache {
+
+SINGLETON_MANAGER_REGISTRATION(in_memory_session_cache_manager);
+
+Ssl::SessionCacheSharedPtr InMemorySessionCacheFactory::createSessionCache(
+    const Protobuf::Message& config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context) {
+  const auto& cache_config = MessageUtil::downcastAndValidate<
+      const envoy::extensions::tls_session_caches::in_memory::v3alpha::InMemorySessionCacheConfig&>(
+      config, factory_context.messageValidationVisitor());
+  InMemorySessionCacheManagerSharedPtr manager =
+      factory_context.singletonManager().getTyped<InMemorySessionCacheManager>(
+          SINGLETON_MANAGER_REGISTERED_NAME(in_memory_session_cache_manager),
+          [&factory_context] {
+            return std::make_shared<InMemorySessionCacheManager>(
+                factory_context.stats(), factory_context.api().timeSource());
+          });
+  return manager->getCache(cache_config);
+}
+
+REGISTER_FACTORY(InMemorySessionCacheFactory, Ssl::SessionCacheFactory);
+
+} // namespace SessionCache
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "envoy/extensions/tls_session_caches/in_memory/v3alpha/in_memory.pb.h"
+#include "envoy/ssl/session_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace SessionCache {
+
+class InMemorySessionCacheFactory : public Ssl::SessionCacheFactory {
+public:
+  // Ssl::SessionCacheFactory
+  Ssl::SessionCacheSharedPtr createSessionCache(
+      const Protobuf::Message& config,
+      Server::Configuration::TransportSocketFactoryContext& factory_context) override;
+
+  std::string name() const override { return "envoy.tls.session_cache.in_memory"; }
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<
+        envoy::extensions::tls_session_caches::in_memory::v3alpha::InMemorySessionCacheConfig>();
+  }
+};
+
+} // namespace SessionCache
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,107 @@
+#include "source/extensions/transport_sockets/tls/session_cache/in_memory/in_memory_session_cache.h"
+
+#include "envoy/common/exception.h"
+
+#include "source/common/common/fmt.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace SessionCache {
+
+InMemorySessionCache::InMemorySessionCache(
+    const envoy::extensions::tls_session_caches::in_memory::v3alpha::InMemorySessionCacheConfig&
+        config,
+    Stats::Scope& scope, TimeSource& time_source)
+    : max_sessions_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_sessions, DefaultMaxSessions)),
+      stats_({ALL_IN_MEMORY_SESSION_CACHE_STATS(
+          POOL_COUNTER_PREFIX(scope, absl::StrCat("tls_session_cache.in_memory.", config.name())),
+          POOL_GAUGE_PREFIX(scope, absl::StrCat("tls_session_cache.in_memory.", config.name())))}),
+      time_source_(time_source) {}
+
+InMemorySessionCache::~InMemorySessionCache() {
+  absl::MutexLock lock(&mutex_);
+  stats_.sessions_.sub(entries_.size());
+}
+
+void InMemorySessionCache::insert(absl::string_view session_id, std::string&& session,
+                                  std::chrono::seconds timeout) {
+  absl::MutexLock lock(&mutex_);
+  auto existing = index_.find(session_id);
+  if (existing != index_.end()) {
+    erase(existing->second);
+  }
+  while (entries_.size() >= max_sessions_) {
+    erase(std::prev(entries_.end()));
+    stats_.evictions_.inc();
+  }
+  entries_.push_front(
+      Entry{std::string(session_id), std::move(session), time_source_.monotonicTime() + timeout});
+  index_.emplace(entries_.front().session_id_, entries_.begin());
+  stats_.sessions_.inc();
+}
+
+Ssl::SessionCacheLookupHandlePtr InMemorySessionCache::lookup(absl::string_view session_id,
+                                                              Event::Dispatcher&,
+                                                              LookupCallback cb) {
+  absl::optional<std::string> session;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = index_.find(session_id);
+    if (it != index_.end()) {
+      if (it->second->expiry_ <= time_source_.monotonicTime()) {
+        erase(it->second);
+      } else {
+        entries_.splice(entries_.begin(), entries_, it->second);
+        session = entries_.front().session_;
+      }
+    }
+  }
+  cb(std::move(session));
+  return nullptr;
+}
+
+void InMemorySessionCache::remove(absl::string_view session_id) {
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(session_id);
+  if (it != index_.end()) {
+    erase(it->second);
+  }
+}
+
+void InMemorySessionCache::erase(EntryList::iterator it) {
+  index_.erase(it->session_id_);
+  entries_.erase(it);
+  stats_.sessions_.dec();
+}
+
+InMemorySessionCacheSharedPtr InMemorySessionCacheManager::getCache(
+    const envoy::extensions::tls_session_caches::in_memory::v3alpha::InMemorySessionCacheConfig&
+        config) {
+  auto existing_cache = caches_.find(config.name());
+  if (existing_cache != caches_.end()) {
+    InMemorySessionCacheSharedPtr cache = existing_cache->second.cache_.lock();
+    if (cache != nullptr) {
+      if (!Protobuf::util::MessageDifferencer::Equivalent(config, existing_cache->second.config_)) {
+        throw EnvoyException(fmt::format(
+            "config specified in-memory TLS session cache '{}' with different settings",
+            config.name()));
+      }
+      return cache;
+    }
+  }
+
+  auto cache = std::make_shared<InMemorySessionCache>(config, root_scope_, time_source_);
+  caches_.insert_or_assign(config.name(), ActiveCache{config, cache});
+  return cache;
+}
+
+} // namespace SessionCache
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
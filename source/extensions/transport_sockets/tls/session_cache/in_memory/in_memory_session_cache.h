@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/tls_session_caches/in_memory/v3alpha/in_memory.pb.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/ssl/session_cache.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace SessionCache {
+
+/**
+ * All in-memory session cache stats. @see stats_macros.h
+ */
+#define ALL_IN_MEMORY_SESSION_CACHE_STATS(COUNTER, GAUGE)                                          \
+  COUNTER(evictions)                                                                               \
+  GAUGE(sessions, NeverImport)
+
+/**
+ * Struct definition for all in-memory session cache stats. @see stats_macros.h
+ */
+struct InMemorySessionCacheStats {
+  ALL_IN_MEMORY_SESSION_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * A session cache in the memory of the process, bounded in number of sessions and evicted least
+ * recently used first. Lookups complete before returning.
+ */
+class InMemorySessionCache : public Ssl::SessionCache {
+public:
+  InMemorySessionCache(
+      const envoy::extensions::tls_session_caches::in_memory::v3alpha::InMemorySessionCacheConfig&
+          config,
+      Stats::Scope& scope, TimeSource& time_source);
+  ~InMemorySessionCache() override;
+
+  // Ssl::SessionCache
+  void insert(absl::string_view session_id, std::string&& session,
+              std::chrono::seconds timeout) override;
+  Ssl::SessionCacheLookupHandlePtr lookup(absl::string_view session_id,
+                                          Event::Dispatcher& dispatcher,
+                                          LookupCallback cb) override;
+  void remove(absl::string_view session_id) override;
+
+  // The default of max_sessions, the default size of the session cache of BoringSSL.
+  static constexpr uint32_t DefaultMaxSessions = 20 * 1024;
+
+private:
+  struct Entry {
+    std::string session_id_;
+    std::string session_;
+    MonotonicTime expiry_;
+  };
+  using EntryList = std::list<Entry>;
+
+  void erase(EntryList::iterator it) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const uint32_t max_sessions_;
+  InMemorySessionCacheStats stats_;
+  TimeSource& time_source_;
+  absl::Mutex mutex_;
+  // Most recently used first.
+  EntryList entries_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<absl::string_view, EntryList::iterator> index_ ABSL_GUARDED_BY(mutex_);
+};
+
+using InMemorySessionCacheSharedPtr = std::shared_ptr<InMemorySessionCache>;
+
+/**
+ * Keeps the caches by name, so that the TLS contexts configured with the same name, including the
+ * contexts of a listener and of its update, share a cache.
+ */
+class InMemorySessionCacheManager : public Singleton::Instance {
+public:
+  InMemorySessionCacheManager(Stats::Scope& root_scope, TimeSource& time_source)
+      : root_scope_(root_scope), time_source_(time_source) {}
+
+  /**
+   * @return the cache of the name of the config, which is created if no context uses it anymore.
+   * @throw EnvoyException if the cache is in use with a different config.
+   */
+  InMemorySessionCacheSharedPtr getCache(
+      const envoy::extensions::tls_session_caches::in_memory::v3alpha::InMemorySessionCacheConfig&
+          config);
+
+private:
+  struct ActiveCache {
+    envoy::extensions::tls_session_caches::in_memory::v3alpha::InMemorySessionCacheConfig config_;
+    std::weak_ptr<InMemorySessionCache> cache_;
+  };
+
+  Stats::Scope& root_scope_;
+  TimeSource& time_source_;
+  absl::flat_hash_map<std::string, ActiveCache> caches_;
+};
+
+using InMemorySessionCacheManagerSharedPtr = std::shared_ptr<InMemorySessionCacheManager>;
+
+} // namespace SessionCache
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -70,6 +70,8 @@ void SslSocket::setTransportSocketCallbacks(Network::TransportSocketCallbacks& c
   for (auto const& provider : ctx_->getPrivateKeyMethodProviders()) {
     provider->registerPrivateKeyMethod(rawSsl(), *this, callbacks_->connection().dispatcher());
   }
+  ctx_->registerSessionCacheLookups(rawSsl(), callbacks_->connection().dispatcher(),
+                                    [this]() { resumeHandshake(); });
 
   // Use custom BIO that reads from/writes to IoHandle
   BIO* bio = BIO_new_io_handle(&callbacks_->ioHandle());
@@ -107,6 +109,9 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
       return {action, 0, false};
     }
   }
+  if (kernel_tls_.rx_) {
+    return kernelTlsRead(read_buffer);
+  }
 
   bool keep_reading = true;
   bool end_stream = false;
@@ -163,7 +168,43 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
   return {action, bytes_read, end_stream};
 }
 
-void SslSocket::onPrivateKeyMethodComplete() {
+Network::IoResult SslSocket::kernelTlsRead(Buffer::Instance& read_buffer) {
+  PostIoAction action = PostIoAction::KeepOpen;
+  uint64_t bytes_read = 0;
+  bool end_stream = false;
+  while (true) {
+    Api::IoCallUint64Result result = callbacks_->ioHandle().read(read_buffer, absl::nullopt);
+    if (result.ok()) {
+      ENVOY_CONN_LOG(trace, "kernel TLS read returns: {}", callbacks_->connection(), result.rc_);
+      if (result.rc_ == 0) {
+        end_stream = true;
+        break;
+      }
+      bytes_read += result.rc_;
+      if (callbacks_->shouldDrainReadBuffer()) {
+        callbacks_->setTransportSocketIsReadable();
+        break;
+      }
+    } else {
+      // The kernel fails the reads of the records other than application data, e.g. alerts and
+      // TLS 1.3 key updates, which close the connection.
+      ENVOY_CONN_LOG(trace, "kernel TLS read error: {}", callbacks_->connection(),
+                     result.err_->getErrorDetails());
+      if (result.err_->getErrorCode() != Api::IoError::IoErrorCode::Again) {
+        action = PostIoAction::Close;
+      }
+      break;
+    }
+  }
+
+  ENVOY_CONN_LOG(trace, "kernel TLS read {} bytes", callbacks_->connection(), bytes_read);
+
+  return {action, bytes_read, end_stream};
+}
+
+void SslSocket::onPrivateKeyMethodComplete() { resumeHandshake(); }
+
+void SslSocket::resumeHandshake() {
   ASSERT(isThreadSafe());
   ASSERT(info_->state() == Ssl::SocketState::HandshakeInProgress);
 
@@ -179,6 +220,16 @@ Network::Connection& SslSocket::connection() const { return callbacks_->connecti
 
 void SslSocket::onSuccess(SSL* ssl) {
   ctx_->logHandshake(ssl);
+  if (ctx_->kernelTlsEnabled()) {
+    kernel_tls_ = KernelTls::offload(ssl, callbacks_->ioHandle());
+    if (kernel_tls_.tx_) {
+      ctx_->stats().kernel_tls_offloaded_.inc();
+    } else {
+      ctx_->stats().kernel_tls_not_offloaded_.inc();
+    }
+    ENVOY_CONN_LOG(debug, "kernel TLS offload: tx={} rx={}", callbacks_->connection(),
+                   kernel_tls_.tx_, kernel_tls_.rx_);
+  }
   callbacks_->raiseEvent(Network::ConnectionEvent::Connected);
 }
 
@@ -225,6 +276,9 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
       return {action, 0, false};
     }
   }
+  if (kernel_tls_.tx_) {
+    return kernelTlsWrite(write_buffer, end_stream);
+  }
 
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
@@ -276,6 +330,29 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
   return {PostIoAction::KeepOpen, total_bytes_written, false};
 }
 
+Network::IoResult SslSocket::kernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream) {
+  uint64_t bytes_written = 0;
+  while (write_buffer.length() > 0) {
+    Api::IoCallUint64Result result = callbacks_->ioHandle().write(write_buffer);
+    if (!result.ok()) {
+      ENVOY_CONN_LOG(trace, "kernel TLS write error: {}", callbacks_->connection(),
+                     result.err_->getErrorDetails());
+      if (result.err_->getErrorCode() != Api::IoError::IoErrorCode::Again) {
+        return {PostIoAction::Close, bytes_written, false};
+      }
+      break;
+    }
+    ENVOY_CONN_LOG(trace, "kernel TLS write returns: {}", callbacks_->connection(), result.rc_);
+    bytes_written += result.rc_;
+  }
+
+  if (write_buffer.length() == 0 && end_stream) {
+    shutdownSsl();
+  }
+
+  return {PostIoAction::KeepOpen, bytes_written, false};
+}
+
 void SslSocket::onConnected() { ASSERT(info_->state() == Ssl::SocketState::PreHandshake); }
 
 Ssl::ConnectionInfoConstSharedPtr SslSocket::ssl() const { return info_; }
@@ -284,6 +361,13 @@ void SslSocket::shutdownSsl() {
   ASSERT(info_->state() != Ssl::SocketState::PreHandshake);
   if (info_->state() != Ssl::SocketState::ShutdownSent &&
       callbacks_->connection().state() != Network::Connection::State::Closed) {
+    if (kernel_tls_.tx_) {
+      // BoringSSL cannot write on the connection anymore, so the kernel sends the alert.
+      const bool sent = KernelTls::sendCloseNotify(callbacks_->ioHandle());
+      ENVOY_CONN_LOG(debug, "kernel TLS shutdown: sent={}", callbacks_->connection(), sent);
+      info_->setState(Ssl::SocketState::ShutdownSent);
+      return;
+    }
     int rc = SSL_shutdown(rawSsl());
     if constexpr (Event::PlatformDefaultTriggerType == Event::FileTriggerType::EmulatedEdge) {
       // Windows operate under `EmulatedEdge`. These are level events that are artificially
@@ -316,6 +400,7 @@ void SslSocket::closeSocket(Network::ConnectionEvent) {
   for (auto const& provider : ctx_->getPrivateKeyMethodProviders()) {
     provider->unregisterPrivateKeyMethod(rawSsl());
   }
+  ctx_->unregisterSessionCacheLookups(rawSsl());
 
   // Attempt to send a shutdown before closing the socket. It's possible this won't go out if
   // there is no room on the socket. We can extend the state machine to handle this at some point
@@ -355,6 +440,85 @@ ClientSslSocketFactory::ClientSslSocketFactory(Envoy::Ssl::ClientContextConfigPt
   config_->setSecretUpdateCallback([this]() { onAddOrUpdateSecret(); });
 }
 
+ClientSslSocketFactory::ClientSslSocketFactory(
+    Envoy::Ssl::ClientContextConfigPtr config, Envoy::Ssl::ContextManager& manager,
+    Stats::Scope& stats_scope, Server::Configuration::TransportSocketFactoryContext& context)
+    : manager_(manager), stats_scope_(stats_scope), stats_(generateStats("client", stats_scope)),
+      config_(std::move(config)) {
+  // A config waiting for SDS secrets has no context to build yet.
+  if (!config_->isReady() || !buildSslCtxOnClusterInitThread(context)) {
+    absl::WriterMutexLock l(&ssl_ctx_mu_);
+    ssl_ctx_ = manager_.createSslClientContext(stats_scope_, *config_, nullptr);
+  }
+  config_->setSecretUpdateCallback([this]() { onAddOrUpdateSecret(); });
+}
+
+ClientSslSocketFactory::~ClientSslSocketFactory() {
+  if (pending_ssl_ctx_ != nullptr) {
+    // The context is built from config_ and stats_scope_, so wait for a build in progress.
+    absl::MutexLock lock(&pending_ssl_ctx_->mutex_);
+    pending_ssl_ctx_->cancelled_ = true;
+    pending_ssl_ctx_->mutex_.Await(absl::Condition(&pending_ssl_ctx_->idle_));
+  }
+}
+
+bool ClientSslSocketFactory::buildSslCtxOnClusterInitThread(
+    Server::Configuration::TransportSocketFactoryContext& context) {
+  auto pending = std::make_shared<PendingSslCtx>();
+  auto build = [this, pending]() {
+    {
+      absl::MutexLock lock(&pending->mutex_);
+      if (pending->cancelled_) {
+        return;
+      }
+      pending->idle_ = false;
+    }
+    Envoy::Ssl::ClientContextSharedPtr ssl_ctx;
+    TRY_NEEDS_AUDIT { ssl_ctx = manager_.createSslClientContext(stats_scope_, *config_, nullptr); }
+    catch (const EnvoyException& e) {
+      ENVOY_LOG(error, "failed to build an upstream TLS context: {}", e.what());
+    }
+    absl::MutexLock lock(&pending->mutex_);
+    pending->ssl_ctx_ = std::move(ssl_ctx);
+    pending->idle_ = true;
+  };
+  auto publish = [this, pending]() {
+    Envoy::Ssl::ClientContextSharedPtr ssl_ctx;
+    {
+      // The factory is destroyed on the main thread, so it is alive unless it was cancelled.
+      absl::MutexLock lock(&pending->mutex_);
+      if (pending->cancelled_) {
+        return;
+      }
+      ssl_ctx = std::move(pending->ssl_ctx_);
+    }
+    onSslCtxBuilt(std::move(ssl_ctx));
+  };
+  if (!context.clusterManager().runOnClusterInitThread(std::move(build), std::move(publish))) {
+    return false;
+  }
+  pending_ssl_ctx_ = std::move(pending);
+  init_target_ = std::make_unique<Init::TargetImpl>("ClientSslSocketFactory", [this]() {
+    if (ssl_ctx_built_) {
+      init_target_->ready();
+    }
+  });
+  context.initManager().add(*init_target_);
+  return true;
+}
+
+void ClientSslSocketFactory::onSslCtxBuilt(Envoy::Ssl::ClientContextSharedPtr ssl_ctx) {
+  {
+    absl::WriterMutexLock l(&ssl_ctx_mu_);
+    // An SDS update may have installed a newer context in the meantime.
+    if (ssl_ctx_ == nullptr) {
+      ssl_ctx_ = std::move(ssl_ctx);
+    }
+  }
+  ssl_ctx_built_ = true;
+  init_target_->ready();
+}
+
 Network::TransportSocketPtr ClientSslSocketFactory::createTransportSocket(
     Network::TransportSocketOptionsConstSharedPtr transport_socket_options) const {
   // onAddOrUpdateSecret() could be invoked in the middle of checking the existence of ssl_ctx and
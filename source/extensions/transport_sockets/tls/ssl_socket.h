@@ -6,6 +6,7 @@
 #include "envoy/network/connection.h"
 #include "envoy/network/transport_socket.h"
 #include "envoy/secret/secret_callbacks.h"
+#include "envoy/server/transport_socket_config.h"
 #include "envoy/ssl/handshaker.h"
 #include "envoy/ssl/private_key/private_key_callbacks.h"
 #include "envoy/ssl/ssl_socket_extended_info.h"
@@ -14,7 +15,9 @@
 #include "envoy/stats/stats_macros.h"
 
 #include "source/common/common/logger.h"
+#include "source/common/init/target_impl.h"
 #include "source/extensions/transport_sockets/tls/context_impl.h"
+#include "source/extensions/transport_sockets/tls/kernel_tls.h"
 #include "source/extensions/transport_sockets/tls/ssl_handshaker.h"
 #include "source/extensions/transport_sockets/tls/utility.h"
 
@@ -81,8 +84,13 @@ private:
     absl::optional<int> error_;
   };
   ReadResult sslReadIntoSlice(Buffer::RawSlice& slice);
+  // Read and write the socket directly, once the kernel handles the TLS records.
+  Network::IoResult kernelTlsRead(Buffer::Instance& read_buffer);
+  Network::IoResult kernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream);
 
   Network::PostIoAction doHandshake();
+  // Resumes a handshake waiting for a private key operation or a session cache lookup.
+  void resumeHandshake();
   void drainErrorQueue();
   void shutdownSsl();
   void shutdownBasic();
@@ -95,6 +103,7 @@ private:
   ContextImplSharedPtr ctx_;
   uint64_t bytes_to_retry_{};
   std::string failure_reason_;
+  KernelTls::Offload kernel_tls_;
 
   SslHandshakerImplSharedPtr info_;
 };
@@ -106,6 +115,16 @@ public:
   ClientSslSocketFactory(Envoy::Ssl::ClientContextConfigPtr config,
                          Envoy::Ssl::ContextManager& manager, Stats::Scope& stats_scope);
 
+  /**
+   * As above, but builds the context on the cluster init threads if there are any, see
+   * Upstream::ClusterManager::runOnClusterInitThread(). The factory has no context until it is
+   * built, and holds back the initialization of its cluster through context.initManager().
+   */
+  ClientSslSocketFactory(Envoy::Ssl::ClientContextConfigPtr config,
+                         Envoy::Ssl::ContextManager& manager, Stats::Scope& stats_scope,
+                         Server::Configuration::TransportSocketFactoryContext& context);
+  ~ClientSslSocketFactory() override;
+
   Network::TransportSocketPtr
   createTransportSocket(Network::TransportSocketOptionsConstSharedPtr options) const override;
   bool implementsSecureTransport() const override;
@@ -120,12 +139,27 @@ public:
   Envoy::Ssl::ClientContextSharedPtr sslCtx();
 
 private:
+  // Shared with the cluster init thread building the context.
+  struct PendingSslCtx {
+    absl::Mutex mutex_;
+    bool cancelled_ ABSL_GUARDED_BY(mutex_){};
+    // False while the context is being built.
+    bool idle_ ABSL_GUARDED_BY(mutex_){true};
+    Envoy::Ssl::ClientContextSharedPtr ssl_ctx_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  bool buildSslCtxOnClusterInitThread(Server::Configuration::TransportSocketFactoryContext& context);
+  void onSslCtxBuilt(Envoy::Ssl::ClientContextSharedPtr ssl_ctx);
+
   Envoy::Ssl::ContextManager& manager_;
   Stats::Scope& stats_scope_;
   SslSocketFactoryStats stats_;
   Envoy::Ssl::ClientContextConfigPtr config_;
   mutable absl::Mutex ssl_ctx_mu_;
   Envoy::Ssl::ClientContextSharedPtr ssl_ctx_ ABSL_GUARDED_BY(ssl_ctx_mu_);
+  std::shared_ptr<PendingSslCtx> pending_ssl_ctx_;
+  std::unique_ptr<Init::TargetImpl> init_target_;
+  bool ssl_ctx_built_{};
 };
 
 class ServerSslSocketFactory : public Network::TransportSocketFactory,
@@ -54,6 +54,12 @@ void HttpConnPool::onPoolFailure(ConnectionPool::PoolFailureReason reason,
   callbacks_->onPoolFailure(reason, transport_failure_reason, host);
 }
 
+Envoy::ConnectionPool::PendingStreamOptions HttpConnPool::pendingStreamOptions() const {
+  const Router::UpstreamToDownstream& upstream_to_downstream = callbacks_->upstreamToDownstream();
+  return {upstream_to_downstream.routeEntry().queuePriority(),
+          upstream_to_downstream.downstreamDeadline()};
+}
+
 void HttpConnPool::onPoolReady(Envoy::Http::RequestEncoder& request_encoder,
                                Upstream::HostDescriptionConstSharedPtr host,
                                const StreamInfo::StreamInfo& info,
@@ -42,6 +42,7 @@ public:
   void onPoolReady(Envoy::Http::RequestEncoder& callbacks_encoder,
                    Upstream::HostDescriptionConstSharedPtr host, const StreamInfo::StreamInfo& info,
                    absl::optional<Envoy::Http::Protocol> protocol) override;
+  Envoy::ConnectionPool::PendingStreamOptions pendingStreamOptions() const override;
   Upstream::HostDescriptionConstSharedPtr host() const override {
     return pool_data_.value().host();
   }
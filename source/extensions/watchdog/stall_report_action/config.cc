@@ -0,0 +1,32 @@
+#include "source/extensions/watchdog/stall_report_action/config.h"
+
+#include "envoy/registry/registry.h"
+
+#include "source/common/config/utility.h"
+#include "source/common/protobuf/message_validator_impl.h"
+#include "source/extensions/watchdog/stall_report_action/stall_report_action.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Watchdog {
+namespace StallReportAction {
+
+Server::Configuration::GuardDogActionPtr StallReportActionFactory::createGuardDogActionFromProto(
+    const envoy::config::bootstrap::v3::Watchdog::WatchdogAction& config,
+    Server::Configuration::GuardDogActionFactoryContext& context) {
+  auto message = createEmptyConfigProto();
+  Config::Utility::translateOpaqueConfig(config.config().typed_config(), ProtobufWkt::Struct(),
+                                         ProtobufMessage::getStrictValidationVisitor(), *message);
+  return std::make_unique<StallReportAction>(dynamic_cast<StallReportActionConfig&>(*message),
+                                             context);
+}
+
+/**
+ * Static registration for the StallReportAction factory. @see RegistryFactory.
+ */
+REGISTER_FACTORY(StallReportActionFactory, Server::Configuration::GuardDogActionFactory);
+
+} // namespace StallReportAction
+} // namespace Watchdog
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "envoy/extensions/watchdog/stall_report_action/v3alpha/stall_report_action.pb.h"
+#include "envoy/server/guarddog_config.h"
+
+#include "source/common/protobuf/protobuf.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Watchdog {
+namespace StallReportAction {
+
+class StallReportActionFactory : public Server::Configuration::GuardDogActionFactory {
+public:
+  StallReportActionFactory() = default;
+
+  Server::Configuration::GuardDogActionPtr createGuardDogActionFromProto(
+      const envoy::config::bootstrap::v3::Watchdog::WatchdogAction& config,
+      Server::Configuration::GuardDogActionFactoryContext& context) override;
+
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<StallReportActionConfig>();
+  }
+
+  std::string name() const override { return "envoy.watchdog.stall_report_action"; }
+
+private:
+  using StallReportActionConfig =
+      envoy::extensions::watchdog::stall_report_action::v3alpha::StallReportActionConfig;
+};
+
+} // namespace StallReportAction
+} // namespace Watchdog
+} // namespace Extensions
+} // namespace Envoy
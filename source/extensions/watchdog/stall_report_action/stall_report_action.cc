@@ -0,0 +1,210 @@
+#include "source/extensions/watchdog/stall_report_action/stall_report_action.h"
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+
+#include "source/common/common/logger.h"
+#include "source/common/common/macros.h"
+#include "source/common/common/utility.h"
+#include "source/common/profiler/sampling_profiler.h"
+#include "source/common/protobuf/utility.h"
+#include "source/common/signal/fatal_error_handler.h"
+#include "source/common/stats/symbol_table_impl.h"
+#include "source/server/backtrace.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/time/clock.h"
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace Watchdog {
+namespace StallReportAction {
+namespace {
+
+constexpr uint64_t DefaultMinReportIntervalMs = 10000;
+constexpr uint64_t DefaultCaptureTimeoutMs = 100;
+
+#ifdef __linux__
+// The signal sent to the stalled threads, which Envoy does not otherwise use.
+constexpr int StallSignal = SIGURG;
+
+// The states of the capture, other than the id of the thread to capture.
+constexpr int64_t CaptureIdle = -1;
+constexpr int64_t CaptureRunning = -2;
+constexpr int64_t CaptureDone = -3;
+
+// The stack and tracked objects of a stalled thread. A single capture runs at a time, since the
+// guard dog waits for it: the guard dog sets the state to the id of the stalled thread before
+// signalling it, and the stalled thread claims the capture from its signal handler, so that a
+// signal handled after the guard dog gave up on it captures nothing.
+struct StallCapture {
+  std::atomic<int64_t> state_{CaptureIdle};
+  BackwardsTrace trace_;
+  char tracked_objects_[16384];
+  int tracked_objects_length_{0};
+};
+
+StallCapture& stallCapture() { MUTABLE_CONSTRUCT_ON_FIRST_USE(StallCapture); }
+
+// Runs on the stalled thread, so it has to be async-signal-safe.
+void onStallSignal(int, siginfo_t*, void* context) {
+  const int saved_errno = errno;
+  StallCapture& capture = stallCapture();
+  int64_t expected = static_cast<int64_t>(syscall(SYS_gettid));
+  if (capture.state_.compare_exchange_strong(expected, CaptureRunning)) {
+    if (context != nullptr) {
+      capture.trace_.captureFrom(context);
+    } else {
+      capture.trace_.capture();
+    }
+    // The dispatcher of the thread dumps the state of the objects it tracks.
+    OutputBufferStream os(capture.tracked_objects_, sizeof(capture.tracked_objects_));
+    FatalErrorHandler::callFatalErrorHandlers(os);
+    capture.tracked_objects_length_ = os.bytesWritten();
+    capture.state_.store(CaptureDone);
+  }
+  errno = saved_errno;
+}
+
+bool installStallSignalHandler() {
+  stallCapture();
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_SIGINFO | SA_ONSTACK | SA_RESTART;
+  action.sa_sigaction = onStallSignal;
+  return sigaction(StallSignal, &action, nullptr) == 0;
+}
+
+// Signals the thread to capture its stack, and waits up to the timeout for it to do so. Returns
+// whether it was captured, in which case the capture has to be released once read.
+bool captureStall(int64_t thread_id, std::chrono::milliseconds timeout) {
+  static const bool installed = installStallSignalHandler();
+  if (!installed) {
+    return false;
+  }
+
+  StallCapture& capture = stallCapture();
+  capture.state_.store(thread_id);
+  if (syscall(SYS_tgkill, getpid(), thread_id, StallSignal) != 0) {
+    capture.state_.store(CaptureIdle);
+    return false;
+  }
+  for (int64_t waited_ms = 0; capture.state_.load() != CaptureDone; waited_ms++) {
+    if (waited_ms >= timeout.count()) {
+      // Give up on the capture, unless the thread is already running it.
+      int64_t expected = thread_id;
+      if (capture.state_.compare_exchange_strong(expected, CaptureIdle)) {
+        return false;
+      }
+    }
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  return true;
+}
+
+void releaseCapture() { stallCapture().state_.store(CaptureIdle); }
+#endif
+
+Stats::Counter& makeCounter(Server::Configuration::GuardDogActionFactoryContext& context,
+                            absl::string_view name) {
+  return context.stats_.counterFromStatName(
+      Stats::StatNameManagedStorage(
+          absl::StrCat(context.guarddog_name_, ".stall_report_action.", name),
+          context.stats_.symbolTable())
+          .statName());
+}
+
+} // namespace
+
+StallReportAction::StallReportAction(
+    envoy::extensions::watchdog::stall_report_action::v3alpha::StallReportActionConfig& config,
+    Server::Configuration::GuardDogActionFactoryContext& context)
+    : min_report_interval_(
+          PROTOBUF_GET_MS_OR_DEFAULT(config, min_report_interval, DefaultMinReportIntervalMs)),
+      capture_timeout_(
+          PROTOBUF_GET_MS_OR_DEFAULT(config, capture_timeout, DefaultCaptureTimeoutMs)),
+      context_(context), stalls_(makeCounter(context, "stalls")),
+      reports_(makeCounter(context, "reports")),
+      captures_failed_(makeCounter(context, "captures_failed")) {}
+
+void StallReportAction::run(
+    envoy::config::bootstrap::v3::Watchdog::WatchdogAction::WatchdogEvent /*event*/,
+    const std::vector<std::pair<Thread::ThreadId, MonotonicTime>>& thread_last_checkin_pairs,
+    MonotonicTime now) {
+  for (const auto& [thread_id, last_checkin] : thread_last_checkin_pairs) {
+    stalls_.inc();
+    auto it = last_reports_.find(thread_id.getId());
+    if (it != last_reports_.end() && now - it->second < min_report_interval_) {
+      continue;
+    }
+    last_reports_.insert_or_assign(thread_id.getId(), now);
+    report(thread_id, last_checkin, now);
+  }
+}
+
+void StallReportAction::report(const Thread::ThreadId& thread_id, MonotonicTime last_checkin,
+                               MonotonicTime now) {
+  reports_.inc();
+  const auto stalled_for =
+      std::chrono::duration_cast<std::chrono::milliseconds>(now - last_checkin).count();
+#ifdef __linux__
+  if (!captureStall(thread_id.getId(), capture_timeout_)) {
+    captures_failed_.inc();
+    ENVOY_LOG_MISC(warn,
+                   "Stall report action: thread {} stalled for {}ms, its stack wasn't captured.",
+                   thread_id.debugString(), stalled_for);
+    return;
+  }
+
+  StallCapture& capture = stallCapture();
+  std::string stack;
+  absl::optional<std::string> filter_name;
+  capture.trace_.visitTrace([&](int index, const char* symbol, void* address) {
+    absl::StrAppend(&stack, "#", index, ": ", symbol != nullptr ? symbol : "UNKNOWN", " [",
+                    fmt::format("{}", address), "]\n");
+    if (!filter_name.has_value() && symbol != nullptr) {
+      filter_name = Profiler::Sampling::filterName(symbol);
+    }
+  });
+  const std::string tracked_objects(capture.tracked_objects_, capture.tracked_objects_length_);
+  releaseCapture();
+
+  if (filter_name.has_value()) {
+    filterCounter(filter_name.value()).inc();
+  }
+  ENVOY_LOG_MISC(warn,
+                 "Stall report action: thread {} stalled for {}ms in {}.\nTracked objects:\n{}\n"
+                 "Stack trace:\n{}",
+                 thread_id.debugString(), stalled_for, filter_name.value_or("no filter"),
+                 tracked_objects, stack);
+#else
+  captures_failed_.inc();
+  ENVOY_LOG_MISC(warn, "Stall report action: thread {} stalled for {}ms, its stack can only be "
+                       "captured on Linux.",
+                 thread_id.debugString(), stalled_for);
+#endif
+}
+
+Stats::Counter& StallReportAction::filterCounter(absl::string_view filter_name) {
+  auto it = filter_counters_.find(filter_name);
+  if (it == filter_counters_.end()) {
+    it = filter_counters_
+             .emplace(filter_name, &makeCounter(context_, absl::StrCat("filter.", filter_name,
+                                                                        ".stalls")))
+             .first;
+  }
+  return *it->second;
+}
+
+} // namespace StallReportAction
+} // namespace Watchdog
+} // namespace Extensions
+} // namespace Envoy
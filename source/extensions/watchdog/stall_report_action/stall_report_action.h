@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#include "envoy/extensions/watchdog/stall_report_action/v3alpha/stall_report_action.pb.h"
+#include "envoy/server/guarddog_config.h"
+#include "envoy/stats/stats.h"
+#include "envoy/thread/thread.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Watchdog {
+namespace StallReportAction {
+
+/**
+ * A GuardDogAction that reports the stalls of the threads missing their watchdog: it signals each
+ * stalled thread to capture its stack and the state of its tracked objects, logs them, and counts
+ * the stall against the innermost filter in the stack.
+ */
+class StallReportAction : public Server::Configuration::GuardDogAction {
+public:
+  StallReportAction(
+      envoy::extensions::watchdog::stall_report_action::v3alpha::StallReportActionConfig& config,
+      Server::Configuration::GuardDogActionFactoryContext& context);
+
+  void run(envoy::config::bootstrap::v3::Watchdog::WatchdogAction::WatchdogEvent event,
+           const std::vector<std::pair<Thread::ThreadId, MonotonicTime>>& thread_last_checkin_pairs,
+           MonotonicTime now) override;
+
+private:
+  void report(const Thread::ThreadId& thread_id, MonotonicTime last_checkin, MonotonicTime now);
+  Stats::Counter& filterCounter(absl::string_view filter_name);
+
+  const std::chrono::milliseconds min_report_interval_;
+  const std::chrono::milliseconds capture_timeout_;
+  Server::Configuration::GuardDogActionFactoryContext& context_;
+  Stats::Counter& stalls_;
+  Stats::Counter& reports_;
+  Stats::Counter& captures_failed_;
+  // The time of the last report of each thread.
+  absl::flat_hash_map<int64_t, MonotonicTime> last_reports_;
+  absl::flat_hash_map<std::string, Stats::Counter*> filter_counters_;
+};
+
+} // namespace StallReportAction
+} // namespace Watchdog
+} // namespace Extensions
+} // namespace Envoy
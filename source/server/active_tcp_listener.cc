@@ -1,6 +1,7 @@
 #include "source/server/active_tcp_listener.h"
 
 #include <chrono>
+#include <vector>
 
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/timer.h"
@@ -10,6 +11,7 @@
 #include "source/common/common/assert.h"
 #include "source/common/event/deferred_task.h"
 #include "source/common/network/connection_impl.h"
+#include "source/common/network/idle_connection_state.h"
 #include "source/common/network/utility.h"
 #include "source/common/stats/timespan_impl.h"
 
@@ -27,16 +29,23 @@ void emitLogs(Network::ListenerConfig& config, StreamInfo::StreamInfo& stream_in
 
 ActiveTcpListener::ActiveTcpListener(Network::TcpConnectionHandler& parent,
                                      Network::ListenerConfig& config)
-    : ActiveTcpListener(
-          parent,
-          parent.dispatcher().createListener(config.listenSocketFactory().getListenSocket(), *this,
-                                             config.bindToPort(), config.tcpBacklogSize()),
-          config) {}
+    : ActiveTcpListener(parent, config, config.listenSocketFactory().getListenSocket()) {}
+
+ActiveTcpListener::ActiveTcpListener(Network::TcpConnectionHandler& parent,
+                                     Network::ListenerConfig& config,
+                                     Network::SocketSharedPtr&& listen_socket)
+    : ActiveTcpListener(parent,
+                        parent.dispatcher().createListener(Network::SocketSharedPtr(listen_socket),
+                                                           *this, config.bindToPort(),
+                                                           config.tcpBacklogSize()),
+                        config, listen_socket) {}
 
 ActiveTcpListener::ActiveTcpListener(Network::TcpConnectionHandler& parent,
                                      Network::ListenerPtr&& listener,
-                                     Network::ListenerConfig& config)
-    : ActiveListenerImplBase(parent, &config), parent_(parent), listener_(std::move(listener)),
+                                     Network::ListenerConfig& config,
+                                     Network::SocketSharedPtr listen_socket)
+    : ActiveListenerImplBase(parent, &config), parent_(parent),
+      listen_socket_(std::move(listen_socket)), listener_(std::move(listener)),
       listener_filters_timeout_(config.listenerFiltersTimeout()),
       continue_on_listener_filters_timeout_(config.continueOnListenerFiltersTimeout()) {
   config.connectionBalancer().registerHandler(*this);
@@ -367,6 +376,44 @@ void ActiveTcpListener::deferredRemoveFilterChains(
   is_deleting_ = was_deleting;
 }
 
+void ActiveTcpListener::releaseIdleConnections(std::chrono::milliseconds min_idle_time,
+                                               std::vector<Network::IoHandlePtr>& released) {
+  const MonotonicTime now = parent_.dispatcher().timeSource().monotonicTime();
+  // Closing a connection removes it from its list, so the connections are collected first.
+  std::vector<Network::Connection*> idle_connections;
+  for (const auto& chain_and_connections : connections_by_context_) {
+    for (const auto& active_connection : chain_and_connections.second->connections_) {
+      Network::Connection& connection = *active_connection->connection_;
+      const StreamInfo::FilterState& filter_state = *connection.streamInfo().filterState();
+      if (connection.state() != Network::Connection::State::Open || !connection.readEnabled() ||
+          connection.ssl() != nullptr ||
+          !filter_state.hasData<Network::IdleConnectionState>(
+              Network::IdleConnectionState::key())) {
+        continue;
+      }
+      const auto& idle_since =
+          filter_state
+              .getDataReadOnly<Network::IdleConnectionState>(Network::IdleConnectionState::key())
+              .idleSince();
+      if (idle_since.has_value() && now - idle_since.value() >= min_idle_time) {
+        idle_connections.push_back(&connection);
+      }
+    }
+  }
+
+  for (Network::Connection* connection : idle_connections) {
+    auto* transport_callbacks = dynamic_cast<Network::TransportSocketCallbacks*>(connection);
+    if (transport_callbacks == nullptr) {
+      continue;
+    }
+    ENVOY_CONN_LOG(debug, "releasing idle connection", *connection);
+    released.push_back(transport_callbacks->ioHandle().duplicate());
+    // The duplicate keeps the socket open, so that only the data already buffered is written
+    // by this process before it lets go of the connection.
+    connection->close(Network::ConnectionCloseType::FlushWrite);
+  }
+}
+
 void ActiveTcpListener::post(Network::ConnectionSocketPtr&& socket) {
   // It is not possible to capture a unique_ptr because the post() API copies the lambda, so we must
   // bundle the socket inside a shared_ptr that can be captured.
@@ -5,6 +5,7 @@
 #include "envoy/stats/timespan.h"
 
 #include "source/common/common/linked_object.h"
+#include "source/common/network/listener_filter_peek_buffer.h"
 #include "source/common/stream_info/stream_info_impl.h"
 #include "source/server/active_listener_base.h"
 
@@ -36,7 +37,8 @@ class ActiveTcpListener final : public Network::TcpListenerCallbacks,
 public:
   ActiveTcpListener(Network::TcpConnectionHandler& parent, Network::ListenerConfig& config);
   ActiveTcpListener(Network::TcpConnectionHandler& parent, Network::ListenerPtr&& listener,
-                    Network::ListenerConfig& config);
+                    Network::ListenerConfig& config,
+                    Network::SocketSharedPtr listen_socket = nullptr);
   ~ActiveTcpListener() override;
   bool listenerConnectionLimitReached() const {
     // TODO(tonya11en): Delegate enforcement of per-listener connection limits to overload
@@ -48,6 +50,7 @@ public:
     ASSERT(num_listener_connections_ > 0);
     --num_listener_connections_;
     config_->openConnections().dec();
+    config_->connectionBalancer().onConnectionClosed(*this);
   }
 
   // Network::TcpListenerCallbacks
@@ -69,6 +72,12 @@ public:
   void post(Network::ConnectionSocketPtr&& socket) override;
   void onAcceptWorker(Network::ConnectionSocketPtr&& socket,
                       bool hand_off_restored_destination_connections, bool rebalanced) override;
+  Network::SocketOptRef listenSocket() override {
+    return listen_socket_ != nullptr ? Network::SocketOptRef(*listen_socket_) : absl::nullopt;
+  }
+  std::chrono::microseconds averageLoopDuration() override {
+    return parent_.dispatcher().averageLoopDuration();
+  }
 
   /**
    * Remove and destroy an active connection.
@@ -100,7 +109,16 @@ public:
    */
   void updateListenerConfig(Network::ListenerConfig& config);
 
+  /**
+   * Close the connections which have been idle for at least min_idle_time and can be handed off
+   * to another process, adding the duplicates of their sockets to released.
+   */
+  void releaseIdleConnections(std::chrono::milliseconds min_idle_time,
+                              std::vector<Network::IoHandlePtr>& released);
+
   Network::TcpConnectionHandler& parent_;
+  // The socket the listener accepts from, if known, kept for the connection balancer.
+  const Network::SocketSharedPtr listen_socket_;
   Network::ListenerPtr listener_;
   const std::chrono::milliseconds listener_filters_timeout_;
   const bool continue_on_listener_filters_timeout_;
@@ -111,6 +129,10 @@ public:
   // connection balancing across per-handler listeners.
   std::atomic<uint64_t> num_listener_connections_{};
   bool is_deleting_{false};
+
+private:
+  ActiveTcpListener(Network::TcpConnectionHandler& parent, Network::ListenerConfig& config,
+                    Network::SocketSharedPtr&& listen_socket);
 };
 
 /**
@@ -168,7 +190,7 @@ struct ActiveTcpSocket : public Network::ListenerFilterManager,
                   bool hand_off_restored_destination_connections)
       : listener_(listener), socket_(std::move(socket)),
         hand_off_restored_destination_connections_(hand_off_restored_destination_connections),
-        iter_(accept_filters_.end()),
+        iter_(accept_filters_.end()), peek_buffer_(*socket_, listener_.parent_.dispatcher()),
         stream_info_(std::make_unique<StreamInfo::StreamInfoImpl>(
             listener_.parent_.dispatcher().timeSource(), socket_->addressProviderSharedPtr(),
             StreamInfo::FilterState::LifeSpan::Connection)) {
@@ -235,6 +257,9 @@ struct ActiveTcpSocket : public Network::ListenerFilterManager,
   Network::ConnectionSocket& socket() override { return *socket_.get(); }
   Event::Dispatcher& dispatcher() override { return listener_.parent_.dispatcher(); }
   void continueFilterChain(bool success) override;
+  Api::IoCallUint64Result peek(void* buffer, uint64_t length) override {
+    return peek_buffer_.peek(buffer, length);
+  }
   void setDynamicMetadata(const std::string& name, const ProtobufWkt::Struct& value) override;
   envoy::config::core::v3::Metadata& dynamicMetadata() override {
     return stream_info_->dynamicMetadata();
@@ -250,6 +275,7 @@ struct ActiveTcpSocket : public Network::ListenerFilterManager,
   const bool hand_off_restored_destination_connections_;
   std::list<ListenerFilterWrapperPtr> accept_filters_;
   std::list<ListenerFilterWrapperPtr>::iterator iter_;
+  Network::ListenerFilterPeekBuffer peek_buffer_;
   Event::TimerPtr timer_;
   std::unique_ptr<StreamInfo::StreamInfo> stream_info_;
   bool connected_{false};
@@ -18,7 +18,8 @@ ActiveUdpListenerBase::ActiveUdpListenerBase(uint32_t worker_index, uint32_t con
     : ActiveListenerImplBase(parent, config), worker_index_(worker_index),
       concurrency_(concurrency), parent_(parent), listen_socket_(listen_socket),
       udp_listener_(std::move(listener)),
-      udp_stats_({ALL_UDP_LISTENER_STATS(POOL_COUNTER_PREFIX(config->listenerScope(), "udp"))}) {
+      udp_stats_({ALL_UDP_LISTENER_STATS(POOL_COUNTER_PREFIX(config->listenerScope(), "udp"),
+                                         POOL_HISTOGRAM_PREFIX(config->listenerScope(), "udp"))}) {
   ASSERT(worker_index_ < concurrency_);
   config_->udpListenerConfig()->listenerWorkerRouter().registerWorkerForListener(*this);
 }
@@ -59,6 +60,7 @@ void ActiveUdpListenerBase::onData(Network::UdpRecvData&& data) {
   if (dest == worker_index_) {
     onDataWorker(std::move(data));
   } else {
+    udp_stats_.downstream_rx_datagram_misrouted_.inc();
     config_->udpListenerConfig()->listenerWorkerRouter().deliver(dest, std::move(data));
   }
 }
@@ -110,7 +112,7 @@ ActiveRawUdpListener::ActiveRawUdpListener(uint32_t worker_index, uint32_t concu
 
   // Create udp_packet_writer
   udp_packet_writer_ = config_->udpListenerConfig()->packetWriterFactory().createUdpPacketWriter(
-      listen_socket_.ioHandle(), config.listenerScope());
+      listen_socket_.ioHandle(), udp_listener_->dispatcher(), config.listenerScope());
 }
 
 void ActiveRawUdpListener::onDataWorker(Network::UdpRecvData&& data) { read_filter_->onData(data); }
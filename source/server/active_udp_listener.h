@@ -14,13 +14,16 @@
 namespace Envoy {
 namespace Server {
 
-#define ALL_UDP_LISTENER_STATS(COUNTER) COUNTER(downstream_rx_datagram_dropped)
+#define ALL_UDP_LISTENER_STATS(COUNTER, HISTOGRAM)                                                 \
+  COUNTER(downstream_rx_datagram_dropped)                                                          \
+  COUNTER(downstream_rx_datagram_misrouted)                                                        \
+  HISTOGRAM(downstream_rx_datagrams_per_read, Unspecified)
 
 /**
  * Wrapper struct for UDP listener stats. @see stats_macros.h
  */
 struct UdpListenerStats {
-  ALL_UDP_LISTENER_STATS(GENERATE_COUNTER_STRUCT)
+  ALL_UDP_LISTENER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
 class ActiveUdpListenerBase : public ActiveListenerImplBase,
@@ -38,6 +41,9 @@ public:
   void onDatagramsDropped(uint32_t dropped) final {
     udp_stats_.downstream_rx_datagram_dropped_.add(dropped);
   }
+  void onDatagramsRead(uint64_t datagrams) final {
+    udp_stats_.downstream_rx_datagrams_per_read_.recordValue(datagrams);
+  }
 
   // ActiveListenerImplBase
   Network::Listener* listener() override { return udp_listener_.get(); }
@@ -171,6 +171,11 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
            MAKE_ADMIN_HANDLER(stats_handler_.handlerContention), false, false},
           {"/cpuprofiler", "enable/disable the CPU profiler",
            MAKE_ADMIN_HANDLER(profiling_handler_.handlerCpuProfiler), false, true},
+          {"/cpuprofiler/continuous", "enable/disable the continuous sampling CPU profiler",
+           MAKE_ADMIN_HANDLER(profiling_handler_.handlerContinuousCpuProfiler), false, true},
+          {"/cpuprofiler/continuous/pprof",
+           "print the profile of the continuous CPU profiler, in the pprof format",
+           MAKE_ADMIN_HANDLER(profiling_handler_.handlerContinuousCpuProfile), false, false},
           {"/heapprofiler", "enable/disable the heap profiler",
            MAKE_ADMIN_HANDLER(profiling_handler_.handlerHeapProfiler), false, true},
           {"/healthcheck/fail", "cause the server to fail health checks",
@@ -185,6 +190,8 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
            MAKE_ADMIN_HANDLER(logs_handler_.handlerLogging), false, true},
           {"/memory", "print current allocation/heap usage",
            MAKE_ADMIN_HANDLER(server_info_handler_.handlerMemory), false, false},
+          {"/memory/tcmalloc", "print detailed allocator stats, such as of each size class",
+           MAKE_ADMIN_HANDLER(server_info_handler_.handlerMemoryTcmalloc), false, false},
           {"/quitquitquit", "exit the server",
            MAKE_ADMIN_HANDLER(server_cmd_handler_.handlerQuitQuitQuit), false, true},
           {"/reset_counters", "reset all counters to zero",
@@ -2,6 +2,7 @@
 
 #include "source/common/http/headers.h"
 #include "source/common/http/utility.h"
+#include "source/common/init/startup_profile.h"
 #include "source/common/network/utility.h"
 #include "source/server/admin/utils.h"
 
@@ -39,11 +40,14 @@ InitDumpHandler::dumpUnreadyTargets(const absl::optional<std::string>& component
   if (component.has_value()) {
     if (component.value() == "listener") {
       dumpListenerUnreadyTargets(*unready_targets_dumps);
+    } else if (component.value() == "startup") {
+      dumpStartupProfile(*unready_targets_dumps);
     }
     // More options for unready targets config dump.
   } else {
     // Dump all possible information of unready targets.
     dumpListenerUnreadyTargets(*unready_targets_dumps);
+    dumpStartupProfile(*unready_targets_dumps);
     // More unready targets to add into config dump.
   }
   return unready_targets_dumps;
@@ -64,5 +68,13 @@ void InitDumpHandler::dumpListenerUnreadyTargets(
   }
 }
 
+void InitDumpHandler::dumpStartupProfile(
+    envoy::admin::v3::UnreadyTargetsDumps& unready_targets_dumps) const {
+  const Init::StartupProfile* startup_profile = Init::StartupProfileSingleton::getExisting();
+  if (startup_profile != nullptr) {
+    startup_profile->dump(*unready_targets_dumps.mutable_startup_profile());
+  }
+}
+
 } // namespace Server
 } // namespace Envoy
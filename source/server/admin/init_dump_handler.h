@@ -35,6 +35,11 @@ private:
    */
   void
   dumpListenerUnreadyTargets(envoy::admin::v3::UnreadyTargetsDumps& unready_targets_dumps) const;
+
+  /**
+   * Helper methods for the /init_dump url handler to add the startup profile of the server.
+   */
+  void dumpStartupProfile(envoy::admin::v3::UnreadyTargetsDumps& unready_targets_dumps) const;
 };
 
 } // namespace Server
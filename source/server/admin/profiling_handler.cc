@@ -1,10 +1,23 @@
 #include "source/server/admin/profiling_handler.h"
 
+#include <algorithm>
+
+#include "source/common/http/headers.h"
 #include "source/common/profiler/profiler.h"
+#include "source/common/profiler/sampling_profiler.h"
 #include "source/server/admin/utils.h"
 
+#include "absl/strings/numbers.h"
+
 namespace Envoy {
 namespace Server {
+namespace {
+
+// The window of the continuous CPU profile served by default, and the longest one.
+constexpr uint64_t DefaultContinuousProfileSeconds = 30;
+constexpr uint64_t MaxContinuousProfileSeconds = 24 * 3600;
+
+} // namespace
 
 ProfilingHandler::ProfilingHandler(const std::string& profile_path) : profile_path_(profile_path) {}
 
@@ -18,6 +31,10 @@ Http::Code ProfilingHandler::handlerCpuProfiler(absl::string_view url, Http::Res
   }
 
   bool enable = query_params.begin()->second == "y";
+  if (enable && Profiler::Sampling::profilerStarted()) {
+    response.add("the continuous CPU profiler is started");
+    return Http::Code::BadRequest;
+  }
   if (enable && !Profiler::Cpu::profilerEnabled()) {
     if (!Profiler::Cpu::startProfiler(profile_path_)) {
       response.add("failure to start the profiler");
@@ -32,6 +49,64 @@ Http::Code ProfilingHandler::handlerCpuProfiler(absl::string_view url, Http::Res
   return Http::Code::OK;
 }
 
+Http::Code
+ProfilingHandler::handlerContinuousCpuProfiler(absl::string_view url, Http::ResponseHeaderMap&,
+                                               Buffer::Instance& response, AdminStream&) {
+  Http::Utility::QueryParams query_params = Http::Utility::parseAndDecodeQueryString(url);
+  const auto enable = query_params.find("enable");
+  const auto hz = query_params.find("hz");
+  uint32_t frequency_hz = Profiler::Sampling::DefaultFrequencyHz;
+  if (enable == query_params.end() || (enable->second != "y" && enable->second != "n") ||
+      query_params.size() != (hz == query_params.end() ? 1 : 2) ||
+      (hz != query_params.end() &&
+       (!absl::SimpleAtoi(hz->second, &frequency_hz) || frequency_hz == 0 ||
+        frequency_hz > Profiler::Sampling::MaxFrequencyHz))) {
+    response.add(fmt::format("?enable=<y|n>&hz=<frequency, 1 to {}>\n",
+                             Profiler::Sampling::MaxFrequencyHz));
+    return Http::Code::BadRequest;
+  }
+
+  if (!Profiler::Sampling::profilerAvailable()) {
+    response.add("The current platform does not support the continuous CPU profiler");
+    return Http::Code::NotImplemented;
+  }
+  if (enable->second == "n") {
+    Profiler::Sampling::stopProfiler();
+  } else if (Profiler::Cpu::profilerEnabled()) {
+    response.add("the CPU profiler is enabled");
+    return Http::Code::BadRequest;
+  } else {
+    // Restarted to apply the frequency, keeping the samples already taken.
+    Profiler::Sampling::stopProfiler();
+    if (!Profiler::Sampling::startProfiler(frequency_hz)) {
+      response.add("failure to start the continuous CPU profiler");
+      return Http::Code::InternalServerError;
+    }
+  }
+
+  response.add("OK\n");
+  return Http::Code::OK;
+}
+
+Http::Code ProfilingHandler::handlerContinuousCpuProfile(absl::string_view url,
+                                                         Http::ResponseHeaderMap& response_headers,
+                                                         Buffer::Instance& response,
+                                                         AdminStream&) {
+  Http::Utility::QueryParams query_params = Http::Utility::parseAndDecodeQueryString(url);
+  uint64_t seconds = DefaultContinuousProfileSeconds;
+  const auto it = query_params.find("seconds");
+  if (query_params.size() > (it == query_params.end() ? 0 : 1) ||
+      (it != query_params.end() && (!absl::SimpleAtoi(it->second, &seconds) || seconds == 0))) {
+    response.add("?seconds=<window>\n");
+    return Http::Code::BadRequest;
+  }
+
+  response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Protobuf);
+  response.add(Profiler::Sampling::profile(
+      std::chrono::seconds(std::min(seconds, MaxContinuousProfileSeconds))));
+  return Http::Code::OK;
+}
+
 Http::Code ProfilingHandler::handlerHeapProfiler(absl::string_view url, Http::ResponseHeaderMap&,
                                                  Buffer::Instance& response, AdminStream&) {
   if (!Profiler::Heap::profilerEnabled()) {
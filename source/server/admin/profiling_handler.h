@@ -19,6 +19,14 @@ public:
                                 Http::ResponseHeaderMap& response_headers,
                                 Buffer::Instance& response, AdminStream&);
 
+  Http::Code handlerContinuousCpuProfiler(absl::string_view path_and_query,
+                                          Http::ResponseHeaderMap& response_headers,
+                                          Buffer::Instance& response, AdminStream&);
+
+  Http::Code handlerContinuousCpuProfile(absl::string_view path_and_query,
+                                         Http::ResponseHeaderMap& response_headers,
+                                         Buffer::Instance& response, AdminStream&);
+
   Http::Code handlerHeapProfiler(absl::string_view path_and_query,
                                  Http::ResponseHeaderMap& response_headers,
                                  Buffer::Instance& response, AdminStream&);
@@ -1,5 +1,9 @@
 #include "source/server/admin/prometheus_stats.h"
 
+#include <limits>
+#include <map>
+#include <type_traits>
+
 #include "source/common/common/empty_string.h"
 #include "source/common/common/macros.h"
 #include "source/common/stats/histogram_impl.h"
@@ -48,88 +52,6 @@ struct MetricLessThan {
   }
 };
 
-/**
- * Processes a stat type (counter, gauge, histogram) by generating all output lines, sorting
- * them by tag-extracted metric name, and then outputting them in the correct sorted order into
- * response.
- *
- * @param response The buffer to put the output into.
- * @param used_only Whether to only output stats that are used.
- * @param regex A filter on which stats to output.
- * @param metrics The metrics to output stats for. This must contain all stats of the given type
- *        to be included in the same output.
- * @param generate_output A function which returns the output text for this metric.
- * @param type The name of the prometheus metric type for used in TYPE annotations.
- */
-template <class StatType>
-uint64_t outputStatType(
-    Buffer::Instance& response, const bool used_only, const absl::optional<std::regex>& regex,
-    const std::vector<Stats::RefcountPtr<StatType>>& metrics,
-    const std::function<std::string(
-        const StatType& metric, const std::string& prefixed_tag_extracted_name)>& generate_output,
-    absl::string_view type) {
-
-  /*
-   * From
-   * https:*github.com/prometheus/docs/blob/master/content/docs/instrumenting/exposition_formats.md#grouping-and-sorting:
-   *
-   * All lines for a given metric must be provided as one single group, with the optional HELP and
-   * TYPE lines first (in no particular order). Beyond that, reproducible sorting in repeated
-   * expositions is preferred but not required, i.e. do not sort if the computational cost is
-   * prohibitive.
-   */
-
-  // This is an unsorted collection of dumb-pointers (no need to increment then decrement every
-  // refcount; ownership is held throughout by `metrics`). It is unsorted for efficiency, but will
-  // be sorted before producing the final output to satisfy the "preferred" ordering from the
-  // prometheus spec: metrics will be sorted by their tags' textual representation, which will be
-  // consistent across calls.
-  using StatTypeUnsortedCollection = std::vector<const StatType*>;
-
-  // Return early to avoid crashing when getting the symbol table from the first metric.
-  if (metrics.empty()) {
-    return 0;
-  }
-
-  // There should only be one symbol table for all of the stats in the admin
-  // interface. If this assumption changes, the name comparisons in this function
-  // will have to change to compare to convert all StatNames to strings before
-  // comparison.
-  const Stats::SymbolTable& global_symbol_table = metrics.front()->constSymbolTable();
-
-  // Sorted collection of metrics sorted by their tagExtractedName, to satisfy the requirements
-  // of the exposition format.
-  std::map<Stats::StatName, StatTypeUnsortedCollection, Stats::StatNameLessThan> groups(
-      global_symbol_table);
-
-  for (const auto& metric : metrics) {
-    ASSERT(&global_symbol_table == &metric->constSymbolTable());
-
-    if (!shouldShowMetric(*metric, used_only, regex)) {
-      continue;
-    }
-
-    groups[metric->tagExtractedStatName()].push_back(metric.get());
-  }
-
-  for (auto& group : groups) {
-    const std::string prefixed_tag_extracted_name =
-        PrometheusStatsFormatter::metricName(global_symbol_table.toString(group.first));
-    response.add(fmt::format("# TYPE {0} {1}\n", prefixed_tag_extracted_name, type));
-
-    // Sort before producing the final output to satisfy the "preferred" ordering from the
-    // prometheus spec: metrics will be sorted by their tags' textual representation, which will
-    // be consistent across calls.
-    std::sort(group.second.begin(), group.second.end(), MetricLessThan());
-
-    for (const auto& metric : group.second) {
-      response.add(generate_output(*metric, prefixed_tag_extracted_name));
-    }
-    response.add("\n");
-  }
-  return groups.size();
-}
-
 /*
  * Return the prometheus output for a numeric Stat (Counter or Gauge).
  */
@@ -213,18 +135,10 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
     const std::vector<Stats::GaugeSharedPtr>& gauges,
     const std::vector<Stats::ParentHistogramSharedPtr>& histograms, Buffer::Instance& response,
     const bool used_only, const absl::optional<std::regex>& regex) {
-
-  uint64_t metric_name_count = 0;
-  metric_name_count += outputStatType<Stats::Counter>(
-      response, used_only, regex, counters, generateNumericOutput<Stats::Counter>, "counter");
-
-  metric_name_count += outputStatType<Stats::Gauge>(response, used_only, regex, gauges,
-                                                    generateNumericOutput<Stats::Gauge>, "gauge");
-
-  metric_name_count += outputStatType<Stats::ParentHistogram>(
-      response, used_only, regex, histograms, generateHistogramOutput, "histogram");
-
-  return metric_name_count;
+  PrometheusStatsRenderer renderer(counters, gauges, histograms, used_only, regex);
+  while (renderer.nextChunk(response, std::numeric_limits<uint64_t>::max())) {
+  }
+  return renderer.metricNameCount();
 }
 
 bool PrometheusStatsFormatter::registerPrometheusNamespace(absl::string_view prometheus_namespace) {
@@ -245,5 +159,104 @@ bool PrometheusStatsFormatter::unregisterPrometheusNamespace(
   return true;
 }
 
+PrometheusStatsRenderer::PrometheusStatsRenderer(
+    std::vector<Stats::CounterSharedPtr> counters, std::vector<Stats::GaugeSharedPtr> gauges,
+    std::vector<Stats::ParentHistogramSharedPtr> histograms, const bool used_only,
+    const absl::optional<std::regex>& regex)
+    : counters_(std::move(counters)), gauges_(std::move(gauges)),
+      histograms_(std::move(histograms)),
+      counter_groups_(groupMetrics(counters_, used_only, regex)),
+      gauge_groups_(groupMetrics(gauges_, used_only, regex)),
+      histogram_groups_(groupMetrics(histograms_, used_only, regex)) {}
+
+template <class StatType>
+PrometheusStatsRenderer::MetricGroups<StatType>
+PrometheusStatsRenderer::groupMetrics(const std::vector<Stats::RefcountPtr<StatType>>& metrics,
+                                      const bool used_only,
+                                      const absl::optional<std::regex>& regex) {
+  /*
+   * From
+   * https:*github.com/prometheus/docs/blob/master/content/docs/instrumenting/exposition_formats.md#grouping-and-sorting:
+   *
+   * All lines for a given metric must be provided as one single group, with the optional HELP and
+   * TYPE lines first (in no particular order). Beyond that, reproducible sorting in repeated
+   * expositions is preferred but not required, i.e. do not sort if the computational cost is
+   * prohibitive.
+   */
+
+  // Return early to avoid crashing when getting the symbol table from the first metric.
+  if (metrics.empty()) {
+    return {};
+  }
+
+  // There should only be one symbol table for all of the stats in the admin
+  // interface. If this assumption changes, the name comparisons in this function
+  // will have to change to compare to convert all StatNames to strings before
+  // comparison.
+  const Stats::SymbolTable& global_symbol_table = metrics.front()->constSymbolTable();
+
+  // Sorted collection of metrics sorted by their tagExtractedName, to satisfy the requirements
+  // of the exposition format. The metrics are dumb-pointers, as ownership is held by `metrics`.
+  std::map<Stats::StatName, std::vector<const StatType*>, Stats::StatNameLessThan> groups(
+      global_symbol_table);
+
+  for (const auto& metric : metrics) {
+    ASSERT(&global_symbol_table == &metric->constSymbolTable());
+
+    if (!shouldShowMetric(*metric, used_only, regex)) {
+      continue;
+    }
+
+    groups[metric->tagExtractedStatName()].push_back(metric.get());
+  }
+
+  MetricGroups<StatType> sorted_groups;
+  sorted_groups.reserve(groups.size());
+  for (auto& group : groups) {
+    // Sort before producing the final output to satisfy the "preferred" ordering from the
+    // prometheus spec: metrics will be sorted by their tags' textual representation, which will
+    // be consistent across calls.
+    std::sort(group.second.begin(), group.second.end(), MetricLessThan());
+    sorted_groups.emplace_back(group.first, std::move(group.second));
+  }
+  return sorted_groups;
+}
+
+template <class StatType>
+bool PrometheusStatsRenderer::renderGroups(const MetricGroups<StatType>& groups,
+                                           size_t& next_group, absl::string_view type,
+                                           Buffer::Instance& response, uint64_t end_length) {
+  for (; next_group < groups.size(); ++next_group) {
+    if (response.length() >= end_length) {
+      return false;
+    }
+
+    const auto& group = groups[next_group];
+    const std::string prefixed_tag_extracted_name = PrometheusStatsFormatter::metricName(
+        group.second.front()->constSymbolTable().toString(group.first));
+    response.add(fmt::format("# TYPE {0} {1}\n", prefixed_tag_extracted_name, type));
+    for (const StatType* metric : group.second) {
+      if constexpr (std::is_same_v<StatType, Stats::ParentHistogram>) {
+        response.add(generateHistogramOutput(*metric, prefixed_tag_extracted_name));
+      } else {
+        response.add(generateNumericOutput(*metric, prefixed_tag_extracted_name));
+      }
+    }
+    response.add("\n");
+  }
+  return true;
+}
+
+bool PrometheusStatsRenderer::nextChunk(Buffer::Instance& response, uint64_t chunk_size) {
+  const uint64_t end_length =
+      chunk_size > std::numeric_limits<uint64_t>::max() - response.length()
+          ? std::numeric_limits<uint64_t>::max()
+          : response.length() + chunk_size;
+  return !(renderGroups(counter_groups_, next_counter_group_, "counter", response, end_length) &&
+           renderGroups(gauge_groups_, next_gauge_group_, "gauge", response, end_length) &&
+           renderGroups(histogram_groups_, next_histogram_group_, "histogram", response,
+                        end_length));
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -2,6 +2,8 @@
 
 #include <regex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "envoy/buffer/buffer.h"
 #include "envoy/stats/histogram.h"
@@ -55,5 +57,60 @@ public:
   static bool unregisterPrometheusNamespace(absl::string_view prometheus_namespace);
 };
 
+/**
+ * Renders stats in the Prometheus exposition format a chunk at a time, so that a large response
+ * does not need to be held in memory at once. The metrics are grouped and sorted by name when the
+ * renderer is created, and their values are read as they are rendered.
+ */
+class PrometheusStatsRenderer {
+public:
+  PrometheusStatsRenderer(std::vector<Stats::CounterSharedPtr> counters,
+                          std::vector<Stats::GaugeSharedPtr> gauges,
+                          std::vector<Stats::ParentHistogramSharedPtr> histograms,
+                          const bool used_only, const absl::optional<std::regex>& regex);
+
+  /**
+   * Appends the output for further metric names to response, until it has grown by at least
+   * chunk_size bytes or all the output has been rendered.
+   * @return bool true if there is more output to render.
+   */
+  bool nextChunk(Buffer::Instance& response, uint64_t chunk_size);
+
+  /**
+   * @return uint64_t total number of metric types in the output.
+   */
+  uint64_t metricNameCount() const {
+    return counter_groups_.size() + gauge_groups_.size() + histogram_groups_.size();
+  }
+
+private:
+  // Metrics sharing each tag extracted name, sorted by name and then by their tags.
+  template <class StatType>
+  using MetricGroups = std::vector<std::pair<Stats::StatName, std::vector<const StatType*>>>;
+
+  template <class StatType>
+  static MetricGroups<StatType>
+  groupMetrics(const std::vector<Stats::RefcountPtr<StatType>>& metrics, const bool used_only,
+               const absl::optional<std::regex>& regex);
+
+  // Renders groups from next_group onwards until response has grown past end_length.
+  // @return bool true if all of the groups have been rendered.
+  template <class StatType>
+  bool renderGroups(const MetricGroups<StatType>& groups, size_t& next_group,
+                    absl::string_view type, Buffer::Instance& response, uint64_t end_length);
+
+  // These hold a reference to every metric rendered.
+  const std::vector<Stats::CounterSharedPtr> counters_;
+  const std::vector<Stats::GaugeSharedPtr> gauges_;
+  const std::vector<Stats::ParentHistogramSharedPtr> histograms_;
+
+  const MetricGroups<Stats::Counter> counter_groups_;
+  const MetricGroups<Stats::Gauge> gauge_groups_;
+  const MetricGroups<Stats::ParentHistogram> histogram_groups_;
+  size_t next_counter_group_{0};
+  size_t next_gauge_group_{0};
+  size_t next_histogram_group_{0};
+};
+
 } // namespace Server
 } // namespace Envoy
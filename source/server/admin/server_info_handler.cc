@@ -55,6 +55,14 @@ Http::Code ServerInfoHandler::handlerMemory(absl::string_view,
   return Http::Code::OK;
 }
 
+Http::Code ServerInfoHandler::handlerMemoryTcmalloc(absl::string_view,
+                                                    Http::ResponseHeaderMap& response_headers,
+                                                    Buffer::Instance& response, AdminStream&) {
+  response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Text);
+  response.add(Memory::Stats::detailedStats());
+  return Http::Code::OK;
+}
+
 Http::Code ServerInfoHandler::handlerReady(absl::string_view, Http::ResponseHeaderMap&,
                                            Buffer::Instance& response, AdminStream&) {
   const envoy::admin::v3::ServerInfo::State state =
@@ -2,6 +2,7 @@
 
 #include "envoy/admin/v3/mutex_stats.pb.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/empty_string.h"
 #include "source/common/html/utility.h"
 #include "source/common/http/headers.h"
@@ -14,6 +15,73 @@ namespace Server {
 
 const uint64_t RecentLookupsCapacity = 100;
 
+// The Prometheus output is rendered and sent in chunks of about this many bytes.
+const uint64_t PrometheusStatsChunkSize = 64 * 1024;
+
+namespace {
+
+/**
+ * Sends the rest of a Prometheus response after its first chunk, rendering each chunk once the
+ * downstream has taken the previous one, so that at most a chunk or two of the response is
+ * buffered at a time. Each chunk is rendered on its own dispatcher iteration, so other events on
+ * the main thread are serviced during a large scrape.
+ */
+class PrometheusStatsStream : public Http::DownstreamWatermarkCallbacks {
+public:
+  PrometheusStatsStream(std::unique_ptr<PrometheusStatsRenderer> renderer,
+                        Http::StreamDecoderFilterCallbacks& decoder_callbacks)
+      : renderer_(std::move(renderer)), decoder_callbacks_(decoder_callbacks),
+        next_chunk_(decoder_callbacks.dispatcher().createSchedulableCallback(
+            [this]() { sendNextChunk(); })) {
+    decoder_callbacks_.addDownstreamWatermarkCallbacks(*this);
+    next_chunk_->scheduleCallbackNextIteration();
+  }
+
+  // Called when the admin stream is destroyed.
+  void onDestroy() {
+    next_chunk_->cancel();
+    if (!done_) {
+      done_ = true;
+      decoder_callbacks_.removeDownstreamWatermarkCallbacks(*this);
+    }
+    renderer_.reset();
+  }
+
+  // Http::DownstreamWatermarkCallbacks
+  void onAboveWriteBufferHighWatermark() override { ++high_watermark_count_; }
+  void onBelowWriteBufferLowWatermark() override {
+    ASSERT(high_watermark_count_ > 0);
+    if (--high_watermark_count_ == 0 && !done_) {
+      next_chunk_->scheduleCallbackNextIteration();
+    }
+  }
+
+private:
+  void sendNextChunk() {
+    if (done_ || high_watermark_count_ > 0) {
+      return;
+    }
+    Buffer::OwnedImpl chunk;
+    const bool more = renderer_->nextChunk(chunk, PrometheusStatsChunkSize);
+    if (more) {
+      next_chunk_->scheduleCallbackNextIteration();
+    } else {
+      // Ending the stream may destroy it, so stop listening to it first.
+      done_ = true;
+      decoder_callbacks_.removeDownstreamWatermarkCallbacks(*this);
+    }
+    decoder_callbacks_.encodeData(chunk, !more);
+  }
+
+  std::unique_ptr<PrometheusStatsRenderer> renderer_;
+  Http::StreamDecoderFilterCallbacks& decoder_callbacks_;
+  const Event::SchedulableCallbackPtr next_chunk_;
+  uint32_t high_watermark_count_{0};
+  bool done_{false};
+};
+
+} // namespace
+
 StatsHandler::StatsHandler(Server::Instance& server) : HandlerContextBase(server) {}
 
 Http::Code StatsHandler::handlerResetCounters(absl::string_view, Http::ResponseHeaderMap&,
@@ -128,7 +196,8 @@ Http::Code StatsHandler::handlerStats(absl::string_view url,
 
 Http::Code StatsHandler::handlerPrometheusStats(absl::string_view path_and_query,
                                                 Http::ResponseHeaderMap&,
-                                                Buffer::Instance& response, AdminStream&) {
+                                                Buffer::Instance& response,
+                                                AdminStream& admin_stream) {
   const Http::Utility::QueryParams params =
       Http::Utility::parseAndDecodeQueryString(path_and_query);
   const bool used_only = params.find("usedonly") != params.end();
@@ -136,9 +205,18 @@ Http::Code StatsHandler::handlerPrometheusStats(absl::string_view path_and_query
   if (!Utility::filterParam(params, response, regex)) {
     return Http::Code::BadRequest;
   }
-  PrometheusStatsFormatter::statsAsPrometheus(server_.stats().counters(), server_.stats().gauges(),
-                                              server_.stats().histograms(), response, used_only,
-                                              regex);
+  auto renderer = std::make_unique<PrometheusStatsRenderer>(
+      server_.stats().counters(), server_.stats().gauges(), server_.stats().histograms(), used_only,
+      regex);
+  if (!renderer->nextChunk(response, PrometheusStatsChunkSize)) {
+    return Http::Code::OK;
+  }
+
+  // The rest of the response is streamed once the first chunk has been sent.
+  admin_stream.setEndStreamOnComplete(false);
+  auto stream = std::make_shared<PrometheusStatsStream>(std::move(renderer),
+                                                        admin_stream.getDecoderFilterCallbacks());
+  admin_stream.addOnDestroyCallback([stream]() { stream->onDestroy(); });
   return Http::Code::OK;
 }
 
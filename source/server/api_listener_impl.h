@@ -96,6 +96,7 @@ protected:
         NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
       }
       bool initializeReadFilters() override { return true; }
+      void recordFilterCost(Stats::Histogram&) override { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
 
       // Network::Connection
       void addConnectionCallbacks(Network::ConnectionCallbacks& cb) override {
@@ -5,6 +5,7 @@
 #include "envoy/event/dispatcher.h"
 #include "envoy/network/filter.h"
 
+#include "source/common/common/utility.h"
 #include "source/common/event/deferred_task.h"
 #include "source/common/network/utility.h"
 #include "source/common/runtime/runtime_features.h"
@@ -14,8 +15,9 @@ namespace Envoy {
 namespace Server {
 
 ConnectionHandlerImpl::ConnectionHandlerImpl(Event::Dispatcher& dispatcher,
-                                             absl::optional<uint32_t> worker_index)
-    : worker_index_(worker_index), dispatcher_(dispatcher),
+                                             absl::optional<uint32_t> worker_index,
+                                             absl::optional<uint32_t> incoming_cpu)
+    : worker_index_(worker_index), incoming_cpu_(incoming_cpu), dispatcher_(dispatcher),
       per_handler_stat_prefix_(dispatcher.name() + "."), disable_listeners_(false) {}
 
 void ConnectionHandlerImpl::incNumConnections() { ++num_handler_connections_; }
@@ -39,6 +41,9 @@ void ConnectionHandlerImpl::addListener(absl::optional<uint64_t> overridden_list
       NOT_REACHED_GCOVR_EXCL_LINE;
     }
     auto tcp_listener = std::make_unique<ActiveTcpListener>(*this, config);
+    if (incoming_cpu_.has_value()) {
+      setIncomingCpu(*tcp_listener, config);
+    }
     details.typed_listener_ = *tcp_listener;
     details.listener_ = std::move(tcp_listener);
   } else {
@@ -59,6 +64,27 @@ void ConnectionHandlerImpl::addListener(absl::optional<uint64_t> overridden_list
   listeners_.emplace_back(config.listenSocketFactory().localAddress(), std::move(details));
 }
 
+void ConnectionHandlerImpl::setIncomingCpu(ActiveTcpListener& listener,
+                                           Network::ListenerConfig& config) {
+  // Only a worker's own SO_REUSEPORT socket can be steered to it. A socket shared between workers
+  // would be steered to whichever worker set the option last.
+  Network::SocketOptRef socket = listener.listenSocket();
+  if (!socket.has_value() || config.listenSocketFactory().sharedSocket().has_value()) {
+    return;
+  }
+#ifdef SO_INCOMING_CPU
+  const int cpu = incoming_cpu_.value();
+  const Api::SysCallIntResult result =
+      socket->get().setSocketOption(SOL_SOCKET, SO_INCOMING_CPU, &cpu, sizeof(cpu));
+  if (result.rc_ != 0) {
+    ENVOY_LOG(warn, "unable to set SO_INCOMING_CPU {} on listener {}: {}", cpu, config.name(),
+              errorDetails(result.errno_));
+  }
+#else
+  ENVOY_LOG(warn, "SO_INCOMING_CPU is not supported, not steering listener {}", config.name());
+#endif
+}
+
 void ConnectionHandlerImpl::removeListeners(uint64_t listener_tag) {
   for (auto listener = listeners_.begin(); listener != listeners_.end();) {
     if (listener->second.listener_->listenerTag() == listener_tag) {
@@ -132,6 +158,33 @@ void ConnectionHandlerImpl::setListenerRejectFraction(UnitFloat reject_fraction)
   }
 }
 
+std::vector<Network::IoHandlePtr>
+ConnectionHandlerImpl::releaseIdleConnections(std::chrono::milliseconds min_idle_time) {
+  std::vector<Network::IoHandlePtr> released;
+  for (auto& listener : listeners_) {
+    ActiveTcpListenerOptRef tcp_listener = listener.second.tcpListener();
+    if (tcp_listener.has_value()) {
+      tcp_listener->get().releaseIdleConnections(min_idle_time, released);
+    }
+  }
+  return released;
+}
+
+bool ConnectionHandlerImpl::adoptConnection(Network::ConnectionSocketPtr&& socket) {
+  const Network::Address::InstanceConstSharedPtr& local_address =
+      socket->addressProvider().localAddress();
+  if (local_address == nullptr || local_address->type() != Network::Address::Type::Ip) {
+    return false;
+  }
+  Network::BalancedConnectionHandlerOptRef listener = getBalancedHandlerByAddress(*local_address);
+  if (!listener.has_value()) {
+    return false;
+  }
+  // The connection goes through the listener filters and the balancer like an accepted one.
+  listener->get().onAcceptWorker(std::move(socket), false, false);
+  return true;
+}
+
 ActiveTcpListenerOptRef ConnectionHandlerImpl::ActiveListenerDetails::tcpListener() {
   auto* val = absl::get_if<std::reference_wrapper<ActiveTcpListener>>(&typed_listener_);
   return (val != nullptr) ? absl::make_optional(*val) : absl::nullopt;
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <vector>
 
 #include "envoy/network/connection_handler.h"
 #include "envoy/network/filter.h"
@@ -35,7 +36,12 @@ public:
       absl::optional<std::reference_wrapper<Network::UdpListenerCallbacks>>;
   using ActiveTcpListenerOptRef = absl::optional<std::reference_wrapper<ActiveTcpListener>>;
 
-  ConnectionHandlerImpl(Event::Dispatcher& dispatcher, absl::optional<uint32_t> worker_index);
+  /**
+   * @param incoming_cpu supplies the CPU the worker is pinned to, if its listen sockets should
+   *        set SO_INCOMING_CPU to it.
+   */
+  ConnectionHandlerImpl(Event::Dispatcher& dispatcher, absl::optional<uint32_t> worker_index,
+                        absl::optional<uint32_t> incoming_cpu = absl::nullopt);
 
   // Network::ConnectionHandler
   uint64_t numConnections() const override { return num_handler_connections_; }
@@ -53,6 +59,9 @@ public:
   void enableListeners() override;
   void setListenerRejectFraction(UnitFloat reject_fraction) override;
   const std::string& statPrefix() const override { return per_handler_stat_prefix_; }
+  std::vector<Network::IoHandlePtr>
+  releaseIdleConnections(std::chrono::milliseconds min_idle_time) override;
+  bool adoptConnection(Network::ConnectionSocketPtr&& socket) override;
 
   // Network::TcpConnectionHandler
   Event::Dispatcher& dispatcher() override { return dispatcher_; }
@@ -80,9 +89,11 @@ private:
   };
   using ActiveListenerDetailsOptRef = absl::optional<std::reference_wrapper<ActiveListenerDetails>>;
   ActiveListenerDetailsOptRef findActiveListenerByTag(uint64_t listener_tag);
+  void setIncomingCpu(ActiveTcpListener& listener, Network::ListenerConfig& config);
 
   // This has a value on worker threads, and no value on the main thread.
   const absl::optional<uint32_t> worker_index_;
+  const absl::optional<uint32_t> incoming_cpu_;
   Event::Dispatcher& dispatcher_;
   const std::string per_handler_stat_prefix_;
   std::list<std::pair<Network::Address::InstanceConstSharedPtr, ActiveListenerDetails>> listeners_;
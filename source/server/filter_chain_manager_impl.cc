@@ -146,6 +146,19 @@ FilterChainManagerImpl::FilterChainManagerImpl(
     : address_(address), parent_context_(factory_context), origin_(&parent_manager),
       init_manager_(init_manager) {}
 
+FcContextKey::FcContextKey(const envoy::config::listener::v3::FilterChain& message)
+    : message_(&message), hash_(MessageUtil::hash(message)) {}
+
+FcContextKey FcContextKey::withOwnedMessage() const {
+  return {std::make_shared<const envoy::config::listener::v3::FilterChain>(*message_), hash_};
+}
+
+bool FcContextKey::operator==(const FcContextKey& other) const {
+  return message_ == other.message_ ||
+         (hash_ == other.hash_ &&
+          Protobuf::util::MessageDifferencer::Equivalent(*message_, *other.message_));
+}
+
 bool FilterChainManagerImpl::isWildcardServerName(const std::string& name) {
   return absl::StartsWith(name, "*.");
 }
@@ -209,10 +222,12 @@ void FilterChainManagerImpl::addFilterChains(
     // Reuse created filter chain if possible.
     // FilterChainManager maintains the lifetime of FilterChainFactoryContext
     // ListenerImpl maintains the dependencies of FilterChainFactoryContext
-    auto filter_chain_impl = findExistingFilterChain(*filter_chain);
+    const FcContextKey key(*filter_chain);
+    auto filter_chain_impl = findExistingFilterChain(key);
     if (filter_chain_impl == nullptr) {
       filter_chain_impl =
           filter_chain_factory_builder.buildFilterChain(*filter_chain, context_creator);
+      fc_contexts_.emplace(key.withOwnedMessage(), filter_chain_impl);
       ++new_filter_chain_size;
     }
 
@@ -223,10 +238,9 @@ void FilterChainManagerImpl::addFilterChains(
         filter_chain_match.application_protocols(), direct_source_ips,
         filter_chain_match.source_type(), source_ips, filter_chain_match.source_ports(),
         filter_chain_impl);
-
-    fc_contexts_[*filter_chain] = filter_chain_impl;
   }
   convertIPsToTries();
+  compileServerNameDecisions();
   copyOrRebuildDefaultFilterChain(default_filter_chain, filter_chain_factory_builder,
                                   context_creator);
   ENVOY_LOG(debug, "new fc_contexts has {} filter chains, including {} newly built",
@@ -455,6 +469,39 @@ std::pair<T, std::vector<Network::Address::CidrRange>> makeCidrListEntry(const s
   return std::make_pair<T, std::vector<Network::Address::CidrRange>>(T(data), std::move(subnets));
 }
 
+// Returns the entry for the server name of a map keyed as ServerNamesMap is: the entry of the exact
+// server name, or else of the longest matching wildcard domain, or else of the filter chains
+// without server name requirements. Returns nullptr if there is no such entry.
+template <class T>
+const T* findServerNameEntry(const absl::flat_hash_map<std::string, T>& server_names_map,
+                             absl::string_view server_name) {
+  ASSERT(absl::AsciiStrToLower(server_name) == server_name);
+
+  // Match on exact server name, i.e. "www.example.com" for "www.example.com".
+  auto match = server_names_map.find(server_name);
+  if (match != server_names_map.end()) {
+    return &match->second;
+  }
+
+  // Match on all wildcard domains, i.e. ".example.com" and ".com" for "www.example.com".
+  size_t pos = server_name.find('.', 1);
+  while (pos < server_name.size() - 1 && pos != absl::string_view::npos) {
+    match = server_names_map.find(server_name.substr(pos));
+    if (match != server_names_map.end()) {
+      return &match->second;
+    }
+    pos = server_name.find('.', pos + 1);
+  }
+
+  // Match on a filter chain without server name requirements.
+  match = server_names_map.find(EMPTY_STRING);
+  if (match != server_names_map.end()) {
+    return &match->second;
+  }
+
+  return nullptr;
+}
+
 }; // namespace
 
 const Network::FilterChain*
@@ -466,7 +513,8 @@ FilterChainManagerImpl::findFilterChain(const Network::ConnectionSocket& socket)
   if (address->type() == Network::Address::Type::Ip) {
     const auto port_match = destination_ports_map_.find(address->ip()->port());
     if (port_match != destination_ports_map_.end()) {
-      best_match_filter_chain = findFilterChainForDestinationIP(*port_match->second.second, socket);
+      best_match_filter_chain =
+          findFilterChainForDestinationPort(port_match->first, *port_match->second.second, socket);
       if (best_match_filter_chain != nullptr) {
         return best_match_filter_chain;
       } else {
@@ -479,7 +527,8 @@ FilterChainManagerImpl::findFilterChain(const Network::ConnectionSocket& socket)
   // Match on catch-all port 0 if there is no specific port sub tree.
   const auto port_match = destination_ports_map_.find(0);
   if (port_match != destination_ports_map_.end()) {
-    best_match_filter_chain = findFilterChainForDestinationIP(*port_match->second.second, socket);
+    best_match_filter_chain =
+        findFilterChainForDestinationPort(port_match->first, *port_match->second.second, socket);
   }
   return best_match_filter_chain != nullptr
              ? best_match_filter_chain
@@ -487,6 +536,37 @@ FilterChainManagerImpl::findFilterChain(const Network::ConnectionSocket& socket)
              : default_filter_chain_.get();
 }
 
+const Network::FilterChain* FilterChainManagerImpl::findFilterChainForDestinationPort(
+    uint16_t destination_port, const DestinationIPsTrie& destination_ips_trie,
+    const Network::ConnectionSocket& socket) const {
+  const auto decisions = server_name_decisions_.find(destination_port);
+  if (decisions != server_name_decisions_.end()) {
+    return findFilterChainForServerNameDecisions(decisions->second, socket);
+  }
+  return findFilterChainForDestinationIP(destination_ips_trie, socket);
+}
+
+const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerNameDecisions(
+    const ServerNameDecisions& server_name_decisions,
+    const Network::ConnectionSocket& socket) const {
+  const TransportProtocolDecisions* transport_protocol_decisions =
+      findServerNameEntry(server_name_decisions, socket.requestedServerName());
+  if (transport_protocol_decisions == nullptr) {
+    return nullptr;
+  }
+
+  // Match on exact transport protocol, e.g. "tls", or else on a filter chain without transport
+  // protocol requirements.
+  auto transport_protocol_match =
+      transport_protocol_decisions->find(socket.detectedTransportProtocol());
+  if (transport_protocol_match == transport_protocol_decisions->end()) {
+    transport_protocol_match = transport_protocol_decisions->find(EMPTY_STRING);
+  }
+  return transport_protocol_match != transport_protocol_decisions->end()
+             ? transport_protocol_match->second
+             : nullptr;
+}
+
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForDestinationIP(
     const DestinationIPsTrie& destination_ips_trie, const Network::ConnectionSocket& socket) const {
   auto address = socket.addressProvider().localAddress();
@@ -506,33 +586,11 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForDestinatio
 
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName(
     const ServerNamesMap& server_names_map, const Network::ConnectionSocket& socket) const {
-  ASSERT(absl::AsciiStrToLower(socket.requestedServerName()) == socket.requestedServerName());
-  const std::string server_name(socket.requestedServerName());
-
-  // Match on exact server name, i.e. "www.example.com" for "www.example.com".
-  const auto server_name_exact_match = server_names_map.find(server_name);
-  if (server_name_exact_match != server_names_map.end()) {
-    return findFilterChainForTransportProtocol(server_name_exact_match->second, socket);
-  }
-
-  // Match on all wildcard domains, i.e. ".example.com" and ".com" for "www.example.com".
-  size_t pos = server_name.find('.', 1);
-  while (pos < server_name.size() - 1 && pos != std::string::npos) {
-    const std::string wildcard = server_name.substr(pos);
-    const auto server_name_wildcard_match = server_names_map.find(wildcard);
-    if (server_name_wildcard_match != server_names_map.end()) {
-      return findFilterChainForTransportProtocol(server_name_wildcard_match->second, socket);
-    }
-    pos = server_name.find('.', pos + 1);
-  }
-
-  // Match on a filter chain without server name requirements.
-  const auto server_name_catchall_match = server_names_map.find(EMPTY_STRING);
-  if (server_name_catchall_match != server_names_map.end()) {
-    return findFilterChainForTransportProtocol(server_name_catchall_match->second, socket);
-  }
-
-  return nullptr;
+  const TransportProtocolsMap* transport_protocols_map =
+      findServerNameEntry(server_names_map, socket.requestedServerName());
+  return transport_protocols_map != nullptr
+             ? findFilterChainForTransportProtocol(*transport_protocols_map, socket)
+             : nullptr;
 }
 
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForTransportProtocol(
@@ -716,17 +774,91 @@ void FilterChainManagerImpl::convertIPsToTries() {
   }
 }
 
-Network::DrainableFilterChainSharedPtr FilterChainManagerImpl::findExistingFilterChain(
-    const envoy::config::listener::v3::FilterChain& filter_chain_message) {
+void FilterChainManagerImpl::compileServerNameDecisions() {
+  // The catch-all entries of the tries only cover the supported IP families, so only when both are
+  // supported do they match every connection, as the compiled decisions do.
+  if (!Network::SocketInterfaceSingleton::get().ipFamilySupported(AF_INET) ||
+      !Network::SocketInterfaceSingleton::get().ipFamilySupported(AF_INET6)) {
+    return;
+  }
+
+  for (const auto& [destination_port, destination_ips_pair] : destination_ports_map_) {
+    const DestinationIPsMap& destination_ips_map = destination_ips_pair.first;
+    if (destination_ips_map.size() != 1 || !destination_ips_map.contains(EMPTY_STRING)) {
+      continue;
+    }
+
+    ServerNameDecisions server_name_decisions;
+    bool compiled = true;
+    for (const auto& [server_name, transport_protocols_map] :
+         *destination_ips_map.begin()->second) {
+      TransportProtocolDecisions& transport_protocol_decisions =
+          server_name_decisions[server_name];
+      for (const auto& [transport_protocol, application_protocols_map] : transport_protocols_map) {
+        const Network::FilterChain* filter_chain = constantFilterChain(application_protocols_map);
+        if (filter_chain == nullptr) {
+          compiled = false;
+          break;
+        }
+        transport_protocol_decisions[transport_protocol] = filter_chain;
+      }
+      if (!compiled) {
+        break;
+      }
+    }
+    if (compiled) {
+      server_name_decisions_.emplace(destination_port, std::move(server_name_decisions));
+    }
+  }
+}
+
+const Network::FilterChain* FilterChainManagerImpl::constantFilterChain(
+    const ApplicationProtocolsMap& application_protocols_map) {
+  const auto any_application_protocol = application_protocols_map.find(EMPTY_STRING);
+  if (application_protocols_map.size() != 1 ||
+      any_application_protocol == application_protocols_map.end()) {
+    return nullptr;
+  }
+
+  const DirectSourceIPsMap& direct_source_ips_map = any_application_protocol->second.first;
+  const auto any_direct_source_ip = direct_source_ips_map.find(EMPTY_STRING);
+  if (direct_source_ips_map.size() != 1 || any_direct_source_ip == direct_source_ips_map.end()) {
+    return nullptr;
+  }
+
+  const SourceTypesArray& source_types = *any_direct_source_ip->second;
+  if (!source_types[envoy::config::listener::v3::FilterChainMatch::SAME_IP_OR_LOOPBACK]
+           .first.empty() ||
+      !source_types[envoy::config::listener::v3::FilterChainMatch::EXTERNAL].first.empty()) {
+    return nullptr;
+  }
+
+  const SourceIPsMap& source_ips_map =
+      source_types[envoy::config::listener::v3::FilterChainMatch::ANY].first;
+  const auto any_source_ip = source_ips_map.find(EMPTY_STRING);
+  if (source_ips_map.size() != 1 || any_source_ip == source_ips_map.end()) {
+    return nullptr;
+  }
+
+  const SourcePortsMap& source_ports_map = *any_source_ip->second;
+  const auto any_source_port = source_ports_map.find(0);
+  if (source_ports_map.size() != 1 || any_source_port == source_ports_map.end()) {
+    return nullptr;
+  }
+  return any_source_port->second.get();
+}
+
+Network::DrainableFilterChainSharedPtr
+FilterChainManagerImpl::findExistingFilterChain(const FcContextKey& key) {
   // Origin filter chain manager could be empty if the current is the ancestor.
   const auto* origin = getOriginFilterChainManager();
   if (origin == nullptr) {
     return nullptr;
   }
-  auto iter = origin->fc_contexts_.find(filter_chain_message);
+  auto iter = origin->fc_contexts_.find(key);
   if (iter != origin->fc_contexts_.end()) {
-    // copy the context to this filter chain manager.
-    fc_contexts_.emplace(filter_chain_message, iter->second);
+    // copy the context to this filter chain manager, sharing the message of the origin key.
+    fc_contexts_.emplace(iter->first, iter->second);
     return iter->second;
   }
   return nullptr;
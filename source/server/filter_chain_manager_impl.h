@@ -175,6 +175,37 @@ private:
   Stats::Scope& listener_scope_;
 };
 
+/**
+ * Key of a filter chain message, with its hash computed once. The successive generations of a
+ * listener share the message of each unchanged filter chain, rather than each keeping a copy, and
+ * keys sharing a message compare equal without comparing the messages.
+ */
+class FcContextKey {
+public:
+  // A key referencing a message owned by the caller, for lookups.
+  explicit FcContextKey(const envoy::config::listener::v3::FilterChain& message);
+
+  // Returns a key owning a copy of the message of this key.
+  FcContextKey withOwnedMessage() const;
+
+  const envoy::config::listener::v3::FilterChain& message() const { return *message_; }
+
+  bool operator==(const FcContextKey& other) const;
+
+  template <typename H> friend H AbslHashValue(H h, const FcContextKey& key) {
+    return H::combine(std::move(h), key.hash_);
+  }
+
+private:
+  FcContextKey(std::shared_ptr<const envoy::config::listener::v3::FilterChain> owned_message,
+               size_t hash)
+      : message_(owned_message.get()), owned_message_(std::move(owned_message)), hash_(hash) {}
+
+  const envoy::config::listener::v3::FilterChain* message_;
+  std::shared_ptr<const envoy::config::listener::v3::FilterChain> owned_message_;
+  size_t hash_;
+};
+
 /**
  * Implementation of FilterChainManager. It owns and exchange filter chains.
  */
@@ -182,9 +213,7 @@ class FilterChainManagerImpl : public Network::FilterChainManager,
                                public FilterChainFactoryContextCreator,
                                Logger::Loggable<Logger::Id::config> {
 public:
-  using FcContextMap =
-      absl::flat_hash_map<envoy::config::listener::v3::FilterChain,
-                          Network::DrainableFilterChainSharedPtr, MessageUtil, MessageUtil>;
+  using FcContextMap = absl::flat_hash_map<FcContextKey, Network::DrainableFilterChainSharedPtr>;
   FilterChainManagerImpl(const Network::Address::InstanceConstSharedPtr& address,
                          Configuration::FactoryContext& factory_context,
                          Init::Manager& init_manager)
@@ -266,6 +295,13 @@ private:
   using DestinationPortsMap =
       absl::flat_hash_map<uint16_t, std::pair<DestinationIPsMap, DestinationIPsTriePtr>>;
 
+  // Compiled form of the match tree of a destination port whose filter chains match on nothing but
+  // server names and transport protocols, which is the common SNI case. The server names are keyed
+  // as in ServerNamesMap, and each transport protocol maps directly to the filter chain it resolves
+  // to, skipping the maps and tries below it on every new connection.
+  using TransportProtocolDecisions = absl::flat_hash_map<std::string, const Network::FilterChain*>;
+  using ServerNameDecisions = absl::flat_hash_map<std::string, TransportProtocolDecisions>;
+
   void addFilterChainForDestinationPorts(
       DestinationPortsMap& destination_ports_map, uint16_t destination_port,
       const std::vector<std::string>& destination_ips,
@@ -321,6 +357,21 @@ private:
                                     uint32_t source_port,
                                     const Network::FilterChainSharedPtr& filter_chain);
 
+  // Compiles server_name_decisions_ for the destination ports that allow it. Called by
+  // addFilterChains() once the tries are built.
+  void compileServerNameDecisions();
+  // Returns the filter chain that the application protocols map resolves to for any connection, or
+  // nullptr if that depends on the application protocols or the source of the connection.
+  static const Network::FilterChain*
+  constantFilterChain(const ApplicationProtocolsMap& application_protocols_map);
+
+  const Network::FilterChain*
+  findFilterChainForDestinationPort(uint16_t destination_port,
+                                    const DestinationIPsTrie& destination_ips_trie,
+                                    const Network::ConnectionSocket& socket) const;
+  const Network::FilterChain*
+  findFilterChainForServerNameDecisions(const ServerNameDecisions& server_name_decisions,
+                                        const Network::ConnectionSocket& socket) const;
   const Network::FilterChain*
   findFilterChainForDestinationIP(const DestinationIPsTrie& destination_ips_trie,
                                   const Network::ConnectionSocket& socket) const;
@@ -345,9 +396,8 @@ private:
                                     const Network::ConnectionSocket& socket) const;
 
   const FilterChainManagerImpl* getOriginFilterChainManager() { return origin_.value(); }
-  // Duplicate the inherent factory context if any.
-  Network::DrainableFilterChainSharedPtr
-  findExistingFilterChain(const envoy::config::listener::v3::FilterChain& filter_chain_message);
+  // Duplicate the inherent factory context if any, sharing its message.
+  Network::DrainableFilterChainSharedPtr findExistingFilterChain(const FcContextKey& key);
 
   // Mapping from filter chain message to filter chain. This is used by LDS response handler to
   // detect the filter chains in the intersection of existing listener and new listener.
@@ -361,6 +411,9 @@ private:
   // Mapping of FilterChain's configured destination ports, IPs, server names, transport protocols
   // and application protocols, using structures defined above.
   DestinationPortsMap destination_ports_map_;
+  // Compiled match trees of the destination ports of destination_ports_map_ that only match on
+  // server names and transport protocols.
+  absl::flat_hash_map<uint16_t, ServerNameDecisions> server_name_decisions_;
 
   const Network::Address::InstanceConstSharedPtr address_;
   // This is the reference to a factory context which all the generations of listener share.
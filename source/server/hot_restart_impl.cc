@@ -118,6 +118,10 @@ int HotRestartImpl::duplicateParentListenSocket(const std::string& address) {
   return as_child_.duplicateParentListenSocket(address);
 }
 
+int HotRestartImpl::duplicateParentIdleConnection() {
+  return as_child_.duplicateParentIdleConnection();
+}
+
 void HotRestartImpl::initialize(Event::Dispatcher& dispatcher, Server::Instance& server) {
   as_parent_.initialize(dispatcher, server);
 }
@@ -133,10 +137,17 @@ HotRestartImpl::mergeParentStatsIfAny(Stats::StoreRoot& stats_store) {
   std::unique_ptr<envoy::HotRestartMessage> wrapper_msg = as_child_.getParentStats();
   ServerStatsFromParent response;
   // getParentStats() will happily and cleanly return nullptr if we have no parent.
-  if (wrapper_msg) {
-    as_child_.mergeParentStats(stats_store, wrapper_msg->reply().stats());
-    response.parent_memory_allocated_ = wrapper_msg->reply().stats().memory_allocated();
-    response.parent_connections_ = wrapper_msg->reply().stats().num_connections();
+  while (wrapper_msg) {
+    const envoy::HotRestartMessage::Reply::Stats& stats = wrapper_msg->reply().stats();
+    as_child_.mergeParentStats(stats_store, stats);
+    // The last reply has the values of the parent's server stats.
+    response.parent_memory_allocated_ = stats.memory_allocated();
+    response.parent_connections_ = stats.num_connections();
+    response.parent_stats_replies_++;
+    response.parent_stats_merged_ += stats.counter_deltas_size() + stats.gauges_size() +
+                                     stats.encoded_counter_deltas_size() +
+                                     stats.encoded_gauges_size();
+    wrapper_msg = stats.more() ? as_child_.getMoreParentStats() : nullptr;
   }
   return response;
 }
@@ -1,6 +1,7 @@
 #include "source/server/hot_restarting_child.h"
 
 #include "source/common/common/utility.h"
+#include "source/common/runtime/runtime_features.h"
 
 namespace Envoy {
 namespace Server {
@@ -34,15 +35,40 @@ int HotRestartingChild::duplicateParentListenSocket(const std::string& address)
   return wrapped_reply->reply().pass_listen_socket().fd();
 }
 
+int HotRestartingChild::duplicateParentIdleConnection() {
+  if (restart_epoch_ == 0 || parent_terminated_) {
+    return -1;
+  }
+
+  HotRestartMessage wrapped_request;
+  wrapped_request.mutable_request()->mutable_pass_connection();
+  sendHotRestartMessage(parent_address_, wrapped_request);
+
+  // Parents which do not hand off connections do not recognize the request.
+  std::unique_ptr<HotRestartMessage> wrapped_reply = receiveHotRestartMessage(Blocking::Yes);
+  if (!replyIsExpectedType(wrapped_reply.get(), HotRestartMessage::Reply::kPassConnection)) {
+    return -1;
+  }
+  return wrapped_reply->reply().pass_connection().fd();
+}
+
 std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats() {
   if (restart_epoch_ == 0 || parent_terminated_) {
     return nullptr;
   }
 
   HotRestartMessage wrapped_request;
-  wrapped_request.mutable_request()->mutable_stats();
+  HotRestartMessage::Request::Stats* request = wrapped_request.mutable_request()->mutable_stats();
+  // Parents which do not encode the stats ignore the request for it, and send a single reply.
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.hot_restart_encoded_stats")) {
+    request->set_encoded(true);
+    request->set_all_symbols(stat_merger_ == nullptr);
+  }
   sendHotRestartMessage(parent_address_, wrapped_request);
+  return getMoreParentStats();
+}
 
+std::unique_ptr<HotRestartMessage> HotRestartingChild::getMoreParentStats() {
   std::unique_ptr<HotRestartMessage> wrapped_reply = receiveHotRestartMessage(Blocking::Yes);
   RELEASE_ASSERT(replyIsExpectedType(wrapped_reply.get(), HotRestartMessage::Reply::kStats),
                  "Hot restart parent did not respond as expected to get stats request.");
@@ -114,6 +140,16 @@ void HotRestartingChild::mergeParentStats(Stats::Store& stats_store,
     }
   }
   stat_merger_->mergeStats(stats_proto.counter_deltas(), stats_proto.gauges(), dynamics);
+
+  for (const auto& symbol : stats_proto.symbols()) {
+    stat_merger_->setParentSymbol(symbol.first, symbol.second);
+  }
+  for (const auto& counter : stats_proto.encoded_counter_deltas()) {
+    stat_merger_->mergeEncodedCounter(counter.name(), counter.value());
+  }
+  for (const auto& gauge : stats_proto.encoded_gauges()) {
+    stat_merger_->mergeEncodedGauge(gauge.name(), gauge.value());
+  }
 }
 
 } // namespace Server
@@ -15,7 +15,10 @@ public:
                      mode_t socket_mode);
 
   int duplicateParentListenSocket(const std::string& address);
+  int duplicateParentIdleConnection();
   std::unique_ptr<envoy::HotRestartMessage> getParentStats();
+  // Returns the next reply of the parent's stats, once one has more set.
+  std::unique_ptr<envoy::HotRestartMessage> getMoreParentStats();
   void drainParentListeners();
   void sendParentAdminShutdownRequest(time_t& original_start_time);
   void sendParentTerminateRequest();
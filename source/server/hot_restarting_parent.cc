@@ -14,6 +14,20 @@ namespace Server {
 
 using HotRestartMessage = envoy::HotRestartMessage;
 
+namespace {
+
+// Number of stats sent in each of the replies of an encoded stats export, so that neither process
+// has to hold all of them in a single message.
+constexpr int EncodedStatsPerReply = 10000;
+
+void setEncodedStat(HotRestartMessage::Reply::Stats::EncodedStat* encoded_stat,
+                    Stats::StatName stat_name, uint64_t value) {
+  encoded_stat->set_name(reinterpret_cast<const char*>(stat_name.data()), stat_name.dataSize());
+  encoded_stat->set_value(value);
+}
+
+} // namespace
+
 HotRestartingParent::HotRestartingParent(int base_id, int restart_epoch,
                                          const std::string& socket_path, mode_t socket_mode)
     : HotRestartingBase(base_id), restart_epoch_(restart_epoch) {
@@ -55,6 +69,13 @@ void HotRestartingParent::onSocketEvent() {
     }
 
     case HotRestartMessage::Request::kStats: {
+      if (wrapped_request->request().stats().encoded()) {
+        internal_->exportEncodedStatsToChild(
+            wrapped_request->request().stats(), [this](const HotRestartMessage& wrapped_reply) {
+              sendHotRestartMessage(child_address_, wrapped_reply);
+            });
+        break;
+      }
       HotRestartMessage wrapped_reply;
       internal_->exportStatsToChild(wrapped_reply.mutable_reply()->mutable_stats());
       sendHotRestartMessage(child_address_, wrapped_reply);
@@ -66,6 +87,16 @@ void HotRestartingParent::onSocketEvent() {
       break;
     }
 
+    case HotRestartMessage::Request::kPassConnection: {
+      // The handle is only closed once its fd has been sent to the child.
+      Network::IoHandlePtr connection = internal_->takeIdleConnection();
+      HotRestartMessage wrapped_reply;
+      wrapped_reply.mutable_reply()->mutable_pass_connection()->set_fd(
+          connection != nullptr ? connection->fdDoNotUse() : -1);
+      sendHotRestartMessage(child_address_, wrapped_reply);
+      break;
+    }
+
     case HotRestartMessage::Request::kTerminate: {
       ENVOY_LOG(info, "shutting down due to child request");
       kill(getpid(), SIGTERM);
@@ -147,6 +178,59 @@ void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply:
   stats->set_num_connections(server_->listenerManager().numConnections());
 }
 
+void HotRestartingParent::Internal::exportEncodedStatsToChild(
+    const HotRestartMessage::Request::Stats& request,
+    const std::function<void(const HotRestartMessage&)>& send_reply) {
+  // The stats keep the symbols of their names in the table until they are sent.
+  const std::vector<Stats::GaugeSharedPtr> gauges = server_->stats().gauges();
+  const std::vector<Stats::CounterSharedPtr> counters = server_->stats().counters();
+
+  HotRestartMessage wrapped_reply;
+  HotRestartMessage::Reply::Stats* stats = wrapped_reply.mutable_reply()->mutable_stats();
+  if (request.all_symbols()) {
+    symbols_sent_.clear();
+  }
+  server_->stats().symbolTable().iterateSymbols(
+      [this, stats](uint32_t symbol, absl::string_view token) {
+        auto it = symbols_sent_.find(symbol);
+        if (it == symbols_sent_.end() || it->second != token) {
+          symbols_sent_.insert_or_assign(symbol, std::string(token));
+          (*stats->mutable_symbols())[symbol] = std::string(token);
+        }
+      });
+
+  int stats_in_reply = 0;
+  const auto send_reply_if_full = [&]() {
+    if (++stats_in_reply < EncodedStatsPerReply) {
+      return;
+    }
+    stats->set_more(true);
+    send_reply(wrapped_reply);
+    stats->Clear();
+    stats_in_reply = 0;
+  };
+
+  for (const auto& gauge : gauges) {
+    if (gauge->used()) {
+      setEncodedStat(stats->add_encoded_gauges(), gauge->statName(), gauge->value());
+      send_reply_if_full();
+    }
+  }
+  for (const auto& counter : counters) {
+    if (counter->used()) {
+      // As in exportStatsToChild(), the stats are no longer latched by the stat exporting.
+      const uint64_t latched_value = counter->latch();
+      if (latched_value > 0) {
+        setEncodedStat(stats->add_encoded_counter_deltas(), counter->statName(), latched_value);
+        send_reply_if_full();
+      }
+    }
+  }
+  stats->set_memory_allocated(Memory::Stats::totalCurrentlyAllocated());
+  stats->set_num_connections(server_->listenerManager().numConnections());
+  send_reply(wrapped_reply);
+}
+
 void HotRestartingParent::Internal::recordDynamics(HotRestartMessage::Reply::Stats* stats,
                                                    const std::string& name,
                                                    Stats::StatName stat_name) {
@@ -173,5 +257,21 @@ void HotRestartingParent::Internal::recordDynamics(HotRestartMessage::Reply::Sta
 
 void HotRestartingParent::Internal::drainListeners() { server_->drainListeners(); }
 
+Network::IoHandlePtr HotRestartingParent::Internal::takeIdleConnection() {
+  if (idle_connections_.empty()) {
+    // Connections must have been idle for a while, so that no request is racing the hand off.
+    server_->listenerManager().releaseIdleConnections(
+        std::chrono::seconds(1), [this](std::vector<Network::IoHandlePtr>&& released) -> void {
+          for (auto& connection : released) {
+            idle_connections_.push_back(std::move(connection));
+          }
+        });
+    return nullptr;
+  }
+  Network::IoHandlePtr connection = std::move(idle_connections_.front());
+  idle_connections_.pop_front();
+  return connection;
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -1,8 +1,16 @@
 #pragma once
 
+#include <functional>
+#include <list>
+#include <string>
+
+#include "envoy/network/io_handle.h"
+
 #include "source/common/common/hash.h"
 #include "source/server/hot_restarting_base.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -32,10 +40,22 @@ public:
     void exportStatsToChild(envoy::HotRestartMessage::Reply::Stats* stats);
     void recordDynamics(envoy::HotRestartMessage::Reply::Stats* stats, const std::string& name,
                         Stats::StatName stat_name);
+    // Streams the stats to the child with their names encoded with the symbols of this process,
+    // in a series of replies passed to send_reply. The symbols which were already sent are only
+    // sent again if their token changed, unless request asks for all of them.
+    void exportEncodedStatsToChild(
+        const envoy::HotRestartMessage::Request::Stats& request,
+        const std::function<void(const envoy::HotRestartMessage&)>& send_reply);
     void drainListeners();
+    // Returns an idle connection to hand off to the child, or nullptr if there is none yet. The
+    // workers are asked to release their idle connections whenever none is left.
+    Network::IoHandlePtr takeIdleConnection();
 
   private:
     Server::Instance* const server_{};
+    std::list<Network::IoHandlePtr> idle_connections_;
+    // The tokens of the symbols sent to the child.
+    absl::flat_hash_map<uint32_t, std::string> symbols_sent_;
   };
 
 private:
@@ -16,6 +16,7 @@
 #include "source/common/config/utility.h"
 #include "source/common/network/connection_balancer_impl.h"
 #include "source/common/network/resolver_impl.h"
+#include "source/common/network/reuse_port_bpf_connection_balancer_impl.h"
 #include "source/common/network/socket_option_factory.h"
 #include "source/common/network/socket_option_impl.h"
 #include "source/common/network/udp_listener_impl.h"
@@ -33,6 +34,7 @@
 #ifdef ENVOY_ENABLE_QUIC
 #include "source/common/quic/active_quic_listener.h"
 #include "source/common/quic/udp_gso_batch_writer.h"
+#include "source/common/quic/udp_sendmmsg_batch_writer.h"
 #endif
 
 namespace Envoy {
@@ -316,7 +318,7 @@ ListenerImpl::ListenerImpl(const envoy::config::listener::v3::Listener& config,
   validateFilterChains(socket_type);
   buildFilterChains();
   if (socket_type != Network::Socket::Type::Datagram) {
-    buildSocketOptions();
+    buildSocketOptions(concurrency);
     buildOriginalDstListenerFilter();
     buildProxyProtocolListenerFilter();
     buildTlsInspectorListenerFilter();
@@ -374,7 +376,7 @@ ListenerImpl::ListenerImpl(ListenerImpl& origin,
   validateFilterChains(socket_type);
   buildFilterChains();
   // In place update is tcp only so it's safe to apply below tcp only initialization.
-  buildSocketOptions();
+  buildSocketOptions(concurrency);
   buildOriginalDstListenerFilter();
   buildProxyProtocolListenerFilter();
   buildTlsInspectorListenerFilter();
@@ -406,13 +408,23 @@ void ListenerImpl::buildUdpListenerFactory(Network::Socket::Type socket_type,
 #ifdef ENVOY_ENABLE_QUIC
     udp_listener_config_->listener_factory_ = std::make_unique<Quic::ActiveQuicListenerFactory>(
         config_.udp_listener_config().quic_options(), concurrency, quic_stat_names_);
+#if UDP_SENDMMSG_BATCH_WRITER_COMPILETIME_SUPPORT
+    // The writer sends the packets of all the connections of the listener at the end of each event
+    // loop iteration, with GSO itself if supported.
+    if (config_.udp_listener_config().quic_options().batch_writes_per_event_loop() &&
+        Api::OsSysCallsSingleton::get().supportsMmsg()) {
+      udp_listener_config_->writer_factory_ =
+          std::make_unique<Quic::UdpSendmmsgBatchWriterFactory>();
+    }
+#endif
 #if UDP_GSO_BATCH_WRITER_COMPILETIME_SUPPORT
     // TODO(mattklein123): We should be able to use GSO without QUICHE/QUIC. Right now this causes
     // non-QUIC integration tests to fail, which I haven't investigated yet. Additionally, from
     // looking at the GSO code there are substantial copying inefficiency so I don't think it's
     // wise to enable to globally for now. I will circle back and fix both of the above with
     // a non-QUICHE GSO implementation.
-    if (Api::OsSysCallsSingleton::get().supportsUdpGso()) {
+    if (udp_listener_config_->writer_factory_ == nullptr &&
+        Api::OsSysCallsSingleton::get().supportsUdpGso()) {
       udp_listener_config_->writer_factory_ = std::make_unique<Quic::UdpGsoBatchWriterFactory>();
     }
 #endif
@@ -520,12 +532,27 @@ void ListenerImpl::buildFilterChains() {
       filter_chain_manager_);
 }
 
-void ListenerImpl::buildSocketOptions() {
+void ListenerImpl::buildSocketOptions(uint32_t concurrency) {
   // TCP specific setup.
   if (connection_balancer_ == nullptr) {
     // Not in place listener update.
-    if (config_.has_connection_balance_config()) {
-      // Currently exact balance is the only supported type and there are no options.
+    if (config_.connection_balance_config().has_reuse_port_bpf_balance()) {
+      // The kernel only steers connections between the sockets of a SO_REUSEPORT group.
+      if (!config_.reuse_port()) {
+        throw EnvoyException(
+            fmt::format("error adding listener '{}': reuse_port_bpf_balance requires reuse_port",
+                        address_->asString()));
+      }
+      connection_balancer_ =
+          std::make_shared<Network::ReusePortBpfConnectionBalancerImpl>(concurrency);
+    } else if (config_.connection_balance_config().has_power_of_two_choices_balance()) {
+      connection_balancer_ = std::make_shared<Network::PowerOfTwoChoicesConnectionBalancerImpl>(
+          parent_.server_.api().randomGenerator(), concurrency,
+          config_.connection_balance_config()
+              .power_of_two_choices_balance()
+              .weight_by_loop_duration());
+    } else if (config_.has_connection_balance_config()) {
+      // There are no options for exact balance.
       ASSERT(config_.connection_balance_config().has_exact_balance());
       connection_balancer_ = std::make_shared<Network::ExactConnectionBalancerImpl>();
     } else {
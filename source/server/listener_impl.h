@@ -374,7 +374,7 @@ private:
   void createListenerFilterFactories(Network::Socket::Type socket_type);
   void validateFilterChains(Network::Socket::Type socket_type);
   void buildFilterChains();
-  void buildSocketOptions();
+  void buildSocketOptions(uint32_t concurrency);
   void buildOriginalDstListenerFilter();
   void buildProxyProtocolListenerFilter();
   void buildTlsInspectorListenerFilter();
@@ -23,7 +23,9 @@
 #include "source/common/network/socket_option_factory.h"
 #include "source/common/network/utility.h"
 #include "source/common/protobuf/utility.h"
+#include "source/common/stats/symbol_table_impl.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/blocking_counter.h"
 
 #if defined(ENVOY_ENABLE_QUIC)
@@ -75,6 +77,38 @@ void fillState(envoy::admin::v3::ListenersConfigDump::DynamicListenerState& stat
   state.mutable_listener()->PackFrom(API_RECOVER_ORIGINAL(listener.config()));
   TimestampUtil::systemClockToTimestamp(listener.last_updated_, *(state.mutable_last_updated()));
 }
+
+// Wraps the factories of the filters of a filter chain into one, which charges the cost of each
+// filter to its histogram for the connections sampled by filter_cost_sampling. The connection is
+// sampled as a whole, so that the filter costs add up to the cost of the connections.
+std::vector<Network::FilterFactoryCb>
+sampleFilterCosts(const envoy::config::listener::v3::Listener& config,
+                  const Protobuf::RepeatedPtrField<envoy::config::listener::v3::Filter>& filters,
+                  std::vector<Network::FilterFactoryCb>&& filter_factories, Stats::Scope& scope,
+                  Random::RandomGenerator& random) {
+  if (!config.has_filter_cost_sampling() || filter_factories.empty()) {
+    return std::move(filter_factories);
+  }
+  ASSERT(filter_factories.size() == static_cast<size_t>(filters.size()));
+  std::vector<Stats::Histogram*> histograms;
+  for (const auto& filter : filters) {
+    Stats::StatNameManagedStorage storage(absl::StrCat("filter_cost.", filter.name(), ".cpu_us"),
+                                          scope.symbolTable());
+    histograms.push_back(
+        &scope.histogramFromStatName(storage.statName(), Stats::Histogram::Unit::Microseconds));
+  }
+  const UnitFloat sampling(config.filter_cost_sampling().value() / 100.0);
+  return {[filter_factories = std::move(filter_factories), histograms = std::move(histograms),
+           sampling, &random](Network::FilterManager& filter_manager) {
+    const bool record_filter_costs = random.bernoulli(sampling);
+    for (size_t i = 0; i < filter_factories.size(); i++) {
+      if (record_filter_costs) {
+        filter_manager.recordFilterCost(*histograms[i]);
+      }
+      filter_factories[i](filter_manager);
+    }
+  }};
+}
 } // namespace
 
 bool ListenSocketCreationParams::operator==(const ListenSocketCreationParams& rhs) const {
@@ -929,6 +963,28 @@ void ListenerManagerImpl::stopWorkers() {
   }
 }
 
+void ListenerManagerImpl::releaseIdleConnections(
+    std::chrono::milliseconds min_idle_time, Worker::ReleaseIdleConnectionsCompletion completion) {
+  for (const auto& worker : workers_) {
+    worker->releaseIdleConnections(
+        min_idle_time, [this, completion](std::vector<Network::IoHandlePtr>&& released) {
+          // Posted callbacks have to be copyable.
+          auto handles = std::make_shared<std::vector<Network::IoHandlePtr>>(std::move(released));
+          server_.dispatcher().post(
+              [completion, handles]() -> void { completion(std::move(*handles)); });
+        });
+  }
+}
+
+void ListenerManagerImpl::adoptConnection(Network::ConnectionSocketPtr&& socket) {
+  if (!workers_started_ || workers_.empty()) {
+    ENVOY_LOG(debug, "closing the connection handed off before the workers started");
+    socket->close();
+    return;
+  }
+  workers_[next_adopting_worker_++ % workers_.size()]->adoptConnection(std::move(socket));
+}
+
 void ListenerManagerImpl::endListenerUpdate(FailureStates&& failure_states) {
   overall_error_state_ = std::move(failure_states);
 }
@@ -985,8 +1041,10 @@ Network::DrainableFilterChainSharedPtr ListenerFilterChainFactoryBuilder::buildF
   auto filter_chain_res = std::make_shared<FilterChainImpl>(
       config_factory.createTransportSocketFactory(*message, factory_context_,
                                                   std::move(server_names)),
-      listener_component_factory_.createNetworkFilterFactoryList(filter_chain.filters(),
-                                                                 *filter_chain_factory_context),
+      sampleFilterCosts(listener_.config_, filter_chain.filters(),
+                        listener_component_factory_.createNetworkFilterFactoryList(
+                            filter_chain.filters(), *filter_chain_factory_context),
+                        listener_.listenerScope(), factory_context_.api().randomGenerator()),
       std::chrono::milliseconds(
           PROTOBUF_GET_MS_OR_DEFAULT(filter_chain, transport_socket_connect_timeout, 0)),
       filter_chain.name());
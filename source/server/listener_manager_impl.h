@@ -200,6 +200,9 @@ public:
   void beginListenerUpdate() override { error_state_tracker_.clear(); }
   void endListenerUpdate(FailureStates&& failure_state) override;
   bool isWorkerStarted() override { return workers_started_; }
+  void releaseIdleConnections(std::chrono::milliseconds min_idle_time,
+                              Worker::ReleaseIdleConnectionsCompletion completion) override;
+  void adoptConnection(Network::ConnectionSocketPtr&& socket) override;
   Http::Context& httpContext() { return server_.httpContext(); }
   ApiListenerOptRef apiListener() override;
 
@@ -310,6 +313,8 @@ private:
 
   std::vector<WorkerPtr> workers_;
   bool workers_started_{};
+  // Worker the next connection handed off by the hot restart parent is adopted on.
+  uint64_t next_adopting_worker_{};
   absl::optional<StopListenersType> stop_listeners_type_;
   Stats::ScopePtr scope_;
   ListenerManagerStats stats_;
@@ -109,6 +109,10 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   TCLAP::SwitchArg enable_fine_grain_logging(
       "", "enable-fine-grain-logging",
       "Logger mode: enable file level log control(Fancy Logger)or not", cmd, false);
+  TCLAP::SwitchArg enable_async_logging(
+      "", "enable-async-logging",
+      "Write the application logs from a background thread, dropping them if it falls behind",
+      cmd, false);
   TCLAP::ValueArg<std::string> log_path("", "log-path", "Path to logfile", false, "", "string",
                                         cmd);
   TCLAP::ValueArg<uint32_t> restart_epoch("", "restart-epoch", "hot restart epoch #", false, 0,
@@ -192,6 +196,7 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   log_format_ = log_format.getValue();
   log_format_escaped_ = log_format_escaped.getValue();
   enable_fine_grain_logging_ = enable_fine_grain_logging.getValue();
+  enable_async_logging_ = enable_async_logging.getValue();
 
   parseComponentLogLevels(component_log_level.getValue());
 
@@ -368,6 +373,7 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   command_line_options->set_log_format(logFormat());
   command_line_options->set_log_format_escaped(logFormatEscaped());
   command_line_options->set_enable_fine_grain_logging(enableFineGrainLogging());
+  command_line_options->set_enable_async_logging(enableAsyncLogging());
   command_line_options->set_log_path(logPath());
   command_line_options->set_service_cluster(serviceClusterName());
   command_line_options->set_service_node(serviceNodeName());
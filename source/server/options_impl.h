@@ -73,6 +73,9 @@ public:
   void setLogLevel(spdlog::level::level_enum log_level) { log_level_ = log_level; }
   void setLogFormat(const std::string& log_format) { log_format_ = log_format; }
   void setLogPath(const std::string& log_path) { log_path_ = log_path; }
+  void setEnableAsyncLogging(bool enable_async_logging) {
+    enable_async_logging_ = enable_async_logging;
+  }
   void setRestartEpoch(uint64_t restart_epoch) { restart_epoch_ = restart_epoch; }
   void setMode(Server::Mode mode) { mode_ = mode; }
   void setFileFlushIntervalMsec(std::chrono::milliseconds file_flush_interval_msec) {
@@ -134,6 +137,7 @@ public:
   const std::string& logFormat() const override { return log_format_; }
   bool logFormatEscaped() const override { return log_format_escaped_; }
   bool enableFineGrainLogging() const override { return enable_fine_grain_logging_; }
+  bool enableAsyncLogging() const override { return enable_async_logging_; }
   const std::string& logPath() const override { return log_path_; }
   uint64_t restartEpoch() const override { return restart_epoch_; }
   Server::Mode mode() const override { return mode_; }
@@ -208,6 +212,7 @@ private:
   // Initialization added here to avoid integration_admin_test failure caused by uninitialized
   // enable_fine_grain_logging_.
   bool enable_fine_grain_logging_ = false;
+  bool enable_async_logging_{false};
   std::string socket_path_{"@envoy_domain_socket"};
   mode_t socket_mode_{0};
 };
@@ -262,10 +262,13 @@ OverloadManagerImpl::OverloadManagerImpl(Event::Dispatcher& dispatcher, Stats::S
                                          ThreadLocal::SlotAllocator& slot_allocator,
                                          const envoy::config::overload::v3::OverloadManager& config,
                                          ProtobufMessage::ValidationVisitor& validation_visitor,
-                                         Api::Api& api, const Server::Options& options)
+                                         Api::Api& api, const Server::Options& options,
+                                         absl::optional<std::chrono::milliseconds>
+                                             timer_wheel_granularity)
     : started_(false), dispatcher_(dispatcher), tls_(slot_allocator),
       refresh_interval_(
-          std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, refresh_interval, 1000))) {
+          std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, refresh_interval, 1000))),
+      timer_wheel_granularity_(timer_wheel_granularity) {
   Configuration::ResourceMonitorFactoryContextImpl context(dispatcher, options, api,
                                                            validation_visitor);
   for (const auto& resource : config.resource_monitors()) {
@@ -392,7 +395,8 @@ Event::ScaledRangeTimerManagerFactory OverloadManagerImpl::scaledTimerFactory()
 Event::ScaledRangeTimerManagerPtr OverloadManagerImpl::createScaledRangeTimerManager(
     Event::Dispatcher& dispatcher,
     const Event::ScaledTimerTypeMapConstSharedPtr& timer_minimums) const {
-  return std::make_unique<Event::ScaledRangeTimerManagerImpl>(dispatcher, timer_minimums);
+  return std::make_unique<Event::ScaledRangeTimerManagerImpl>(dispatcher, timer_minimums,
+                                                              timer_wheel_granularity_);
 }
 
 void OverloadManagerImpl::updateResourcePressure(const std::string& resource, double pressure,
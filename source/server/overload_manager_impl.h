@@ -110,7 +110,9 @@ public:
                       ThreadLocal::SlotAllocator& slot_allocator,
                       const envoy::config::overload::v3::OverloadManager& config,
                       ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api,
-                      const Server::Options& options);
+                      const Server::Options& options,
+                      absl::optional<std::chrono::milliseconds> timer_wheel_granularity =
+                          absl::nullopt);
 
   // Server::OverloadManager
   void start() override;
@@ -176,6 +178,8 @@ private:
   absl::node_hash_map<NamedOverloadActionSymbolTable::Symbol, OverloadAction> actions_;
 
   Event::ScaledTimerTypeMapConstSharedPtr timer_minimums_;
+  // The granularity of the timer wheel of the scaled timer managers, if they use one.
+  const absl::optional<std::chrono::milliseconds> timer_wheel_granularity_;
 
   absl::flat_hash_map<NamedOverloadActionSymbolTable::Symbol, OverloadActionState>
       state_updates_to_flush_;
@@ -26,6 +26,7 @@
 
 #include "source/common/api/api_impl.h"
 #include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/enum_to_int.h"
 #include "source/common/common/mutex_tracer_impl.h"
 #include "source/common/common/utility.h"
@@ -38,6 +39,9 @@
 #include "source/common/local_info/local_info_impl.h"
 #include "source/common/memory/stats.h"
 #include "source/common/network/address_impl.h"
+#include "source/common/network/caching_dns_resolver_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/network/listen_socket_impl.h"
 #include "source/common/network/socket_interface.h"
 #include "source/common/network/socket_interface_impl.h"
 #include "source/common/network/tcp_listener_impl.h"
@@ -57,6 +61,8 @@
 #include "source/server/listener_hooks.h"
 #include "source/server/ssl_context_manager.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -91,6 +97,8 @@ InstanceImpl::InstanceImpl(
       grpc_context_(store.symbolTable()), http_context_(store.symbolTable()),
       router_context_(store.symbolTable()), process_context_(std::move(process_context)),
       hooks_(hooks), server_contexts_(*this), stats_flush_in_progress_(false) {
+  startup_profile_singleton_ = std::make_unique<Init::ScopedStartupProfileSingleton>(
+      std::make_unique<Init::StartupProfile>(time_source_));
   TRY_ASSERT_MAIN_THREAD {
     if (!options.logPath().empty()) {
       TRY_ASSERT_MAIN_THREAD {
@@ -222,7 +230,12 @@ void InstanceImpl::flushStats() {
   if (initManager().state() == Init::Manager::State::Initialized) {
     // A shutdown initiated before this callback may prevent this from being called as per
     // the semantics documented in ThreadLocal's runOnAllThreads method.
-    stats_store_.mergeHistograms([this]() -> void { flushStatsInternal(); });
+    histogram_merge_timer_ = std::make_unique<Stats::HistogramCompletableTimespanImpl>(
+        server_stats_->histogram_merge_time_ms_, timeSource());
+    stats_store_.mergeHistograms([this]() -> void {
+      histogram_merge_timer_->complete();
+      flushStatsInternal();
+    });
   } else {
     ENVOY_LOG(debug, "Envoy is not fully initialized, skipping histogram merge and flushing stats");
     flushStatsInternal();
@@ -231,7 +244,16 @@ void InstanceImpl::flushStats() {
 
 void InstanceImpl::updateServerStats() {
   // mergeParentStatsIfAny() does nothing and returns a struct of 0s if there is no parent.
+  const MonotonicTime merge_start = timeSource().monotonicTime();
   HotRestart::ServerStatsFromParent parent_stats = restarter_.mergeParentStatsIfAny(stats_store_);
+  if (parent_stats.parent_stats_replies_ > 0) {
+    server_stats_->hot_restart_stats_replies_.add(parent_stats.parent_stats_replies_);
+    server_stats_->hot_restart_stats_merged_.add(parent_stats.parent_stats_merged_);
+    server_stats_->hot_restart_stats_merge_time_ms_.recordValue(
+        std::chrono::duration_cast<std::chrono::milliseconds>(timeSource().monotonicTime() -
+                                                              merge_start)
+            .count());
+  }
 
   server_stats_->uptime_.set(time(nullptr) - original_start_time_);
   server_stats_->memory_allocated_.set(Memory::Stats::totalCurrentlyAllocated() +
@@ -239,6 +261,9 @@ void InstanceImpl::updateServerStats() {
   server_stats_->memory_heap_size_.set(Memory::Stats::totalCurrentlyReserved());
   server_stats_->memory_physical_size_.set(Memory::Stats::totalPhysicalBytes());
   server_stats_->parent_connections_.set(parent_stats.parent_connections_);
+  if (parent_stats.parent_connections_ > 0) {
+    adoptParentIdleConnections();
+  }
   server_stats_->total_connections_.set(listener_manager_->numConnections() +
                                         parent_stats.parent_connections_);
   server_stats_->days_until_first_cert_expiring_.set(
@@ -254,6 +279,46 @@ void InstanceImpl::updateServerStats() {
       enumToInt(Utility::serverState(initManager().state(), healthCheckFailed())));
   server_stats_->stats_recent_lookups_.set(
       stats_store_.symbolTable().getRecentLookups([](absl::string_view, uint64_t) {}));
+
+  const std::vector<Buffer::Slice::PoolStats> pool_stats = Buffer::Slice::poolStats();
+  ASSERT(pool_stats.size() == slice_pool_stats_.size());
+  for (size_t i = 0; i < pool_stats.size(); i++) {
+    SlicePoolSizeClassStats& stats = slice_pool_stats_[i];
+    stats.hits_.add(pool_stats[i].hits_ - stats.last_hits_);
+    stats.misses_.add(pool_stats[i].misses_ - stats.last_misses_);
+    stats.last_hits_ = pool_stats[i].hits_;
+    stats.last_misses_ = pool_stats[i].misses_;
+  }
+}
+
+void InstanceImpl::adoptParentIdleConnections() {
+  if (!listener_manager_->isWorkerStarted() ||
+      !Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.hot_restart_connection_handoff")) {
+    return;
+  }
+  // The parent releases its idle connections when asked for one, so they are adopted on the
+  // following stats flushes.
+  int fd;
+  while ((fd = restarter_.duplicateParentIdleConnection()) != -1) {
+    Network::IoHandlePtr io_handle = std::make_unique<Network::IoSocketHandleImpl>(fd);
+    Network::Address::InstanceConstSharedPtr local_address;
+    Network::Address::InstanceConstSharedPtr remote_address;
+    // The peer may have gone away since the parent released the connection.
+    TRY_ASSERT_MAIN_THREAD {
+      local_address = io_handle->localAddress();
+      remote_address = io_handle->peerAddress();
+    }
+    END_TRY
+    catch (const EnvoyException& e) {
+      ENVOY_LOG(debug, "dropping connection obtained from parent: {}", e.what());
+      continue;
+    }
+    ENVOY_LOG(debug, "obtained connection from {} to {} from parent", remote_address->asString(),
+              local_address->asString());
+    listener_manager_->adoptConnection(std::make_unique<Network::AcceptedSocketImpl>(
+        std::move(io_handle), local_address, remote_address));
+  }
 }
 
 void InstanceImpl::flushStatsInternal() {
@@ -345,8 +410,11 @@ void InstanceImpl::initialize(const Options& options,
   }
 
   // Handle configuration that needs to take place prior to the main configuration load.
+  const Init::StartupProfile::StepId bootstrap_step =
+      Init::StartupProfile::beginStep(Init::StartupProfile::Kind::Phase, "bootstrap");
   InstanceUtil::loadBootstrapConfig(bootstrap_, options,
                                     messageValidationContext().staticValidationVisitor(), *api_);
+  Init::StartupProfile::endStep(bootstrap_step);
   bootstrap_config_update_time_ = time_source_.systemTime();
 
   // Immediate after the bootstrap has been loaded, override the header prefix, if configured to
@@ -368,7 +436,11 @@ void InstanceImpl::initialize(const Options& options,
   stats_store_.setTagProducer(Config::Utility::createTagProducer(bootstrap_));
   stats_store_.setStatsMatcher(
       Config::Utility::createStatsMatcher(bootstrap_, stats_store_.symbolTable()));
+  stats_store_.setShardedCounterMatcher(
+      Config::Utility::createShardedCounterMatcher(bootstrap_, stats_store_.symbolTable()));
   stats_store_.setHistogramSettings(Config::Utility::createHistogramSettings(bootstrap_));
+  stats_store_.setHistogramMergeThreads(api_->threadFactory(),
+                                        bootstrap_.stats_config().histogram_merge_threads());
 
   const std::string server_stats_prefix = "server.";
   const std::string server_compilation_settings_stats_prefix = "server.compilation_settings";
@@ -391,6 +463,12 @@ void InstanceImpl::initialize(const Options& options,
       server_stats_->initialization_time_ms_, timeSource());
   server_stats_->concurrency_.set(options_.concurrency());
   server_stats_->hot_restart_epoch_.set(options_.restartEpoch());
+  for (const Buffer::Slice::PoolStats& pool_stats : Buffer::Slice::poolStats()) {
+    const std::string prefix =
+        absl::StrCat(server_stats_prefix, "buffer_slice_pool.size_", pool_stats.size_, ".");
+    slice_pool_stats_.push_back({stats_store_.counterFromString(prefix + "hits"),
+                                 stats_store_.counterFromString(prefix + "misses"), 0, 0});
+  }
 
   assert_action_registration_ = Assert::addDebugAssertionFailureRecordAction(
       [this](const char*) { server_stats_->debug_assertion_failures_.inc(); });
@@ -465,10 +543,15 @@ void InstanceImpl::initialize(const Options& options,
   // Initialize the overload manager early so other modules can register for actions.
   overload_manager_ = std::make_unique<OverloadManagerImpl>(
       *dispatcher_, stats_store_, thread_local_, bootstrap_.overload_manager(),
-      messageValidationContext().staticValidationVisitor(), *api_, options);
+      messageValidationContext().staticValidationVisitor(), *api_, options,
+      PROTOBUF_GET_OPTIONAL_MS(bootstrap_, scaled_timer_wheel_granularity));
 
   heap_shrinker_ =
       std::make_unique<Memory::HeapShrinker>(*dispatcher_, *overload_manager_, stats_store_);
+  if (bootstrap_.has_memory_allocator_manager()) {
+    memory_allocator_manager_ = std::make_unique<Memory::AllocatorManager>(
+        *dispatcher_, bootstrap_.memory_allocator_manager(), stats_store_);
+  }
 
   for (const auto& bootstrap_extension : bootstrap_.bootstrap_extensions()) {
     auto& factory = Config::Utility::getAndCheckFactory<Configuration::BootstrapExtensionFactory>(
@@ -510,6 +593,7 @@ void InstanceImpl::initialize(const Options& options,
   }
 
   // Workers get created first so they register for thread local updates.
+  worker_factory_.setWorkerPlacement(bootstrap_.worker_placement());
   listener_manager_ = std::make_unique<ListenerManagerImpl>(
       *this, listener_component_factory_, worker_factory_, bootstrap_.enable_dispatcher_stats());
 
@@ -578,7 +662,10 @@ void InstanceImpl::initialize(const Options& options,
     // utilize bootstrap_.use_tcp_for_dns_lookups() if `bootstrap_.dns_resolver_options` is not set.
     dns_resolver_options.set_use_tcp_for_dns_lookups(bootstrap_.use_tcp_for_dns_lookups());
   }
-  dns_resolver_ = dispatcher_->createDnsResolver(resolvers, dns_resolver_options);
+  // The resolver is shared by all the clusters not configured with their own resolvers, which
+  // share its resolutions as well.
+  dns_resolver_ = std::make_shared<Network::CachingDnsResolverImpl>(
+      *dispatcher_, dispatcher_->createDnsResolver(resolvers, dns_resolver_options));
 
   cluster_manager_factory_ = std::make_unique<Upstream::ProdClusterManagerFactory>(
       *admin_, Runtime::LoaderSingleton::get(), stats_store_, thread_local_, dns_resolver_,
@@ -590,7 +677,12 @@ void InstanceImpl::initialize(const Options& options,
   // thread local data per above. See MainImpl::initialize() for why ConfigImpl
   // is constructed as part of the InstanceImpl and then populated once
   // cluster_manager_factory_ is available.
+  const Init::StartupProfile::StepId static_resources_step =
+      Init::StartupProfile::beginStep(Init::StartupProfile::Kind::Phase, "static_resources");
+  primary_clusters_step_ =
+      Init::StartupProfile::beginStep(Init::StartupProfile::Kind::Phase, "primary_clusters");
   config_.initialize(bootstrap_, *this, *cluster_manager_factory_);
+  Init::StartupProfile::endStep(static_resources_step);
 
   // Instruct the listener manager to create the LDS provider if needed. This must be done later
   // because various items do not yet exist when the listener manager is created.
@@ -638,11 +730,14 @@ void InstanceImpl::initialize(const Options& options,
 }
 
 void InstanceImpl::onClusterManagerPrimaryInitializationComplete() {
+  Init::StartupProfile::endStep(primary_clusters_step_);
+  runtime_step_ = Init::StartupProfile::beginStep(Init::StartupProfile::Kind::Phase, "runtime");
   // If RTDS was not configured the `onRuntimeReady` callback is immediately invoked.
   Runtime::LoaderSingleton::get().startRtdsSubscriptions([this]() { onRuntimeReady(); });
 }
 
 void InstanceImpl::onRuntimeReady() {
+  Init::StartupProfile::endStep(runtime_step_);
   // Begin initializing secondary clusters after RTDS configuration has been applied.
   // Initializing can throw exceptions, so catch these.
   TRY_ASSERT_MAIN_THREAD { clusterManager().initializeSecondaryClusters(bootstrap_); }
@@ -655,7 +750,8 @@ void InstanceImpl::onRuntimeReady() {
   if (bootstrap_.has_hds_config()) {
     const auto& hds_config = bootstrap_.hds_config();
     async_client_manager_ = std::make_unique<Grpc::AsyncClientManagerImpl>(
-        *config_.clusterManager(), thread_local_, time_source_, *api_, grpc_context_.statNames());
+        *config_.clusterManager(), thread_local_, time_source_, *api_, grpc_context_.statNames(),
+        bootstrap_.cluster_manager().google_grpc_completion_threads());
     TRY_ASSERT_MAIN_THREAD {
       hds_delegate_ = std::make_unique<Upstream::HdsDelegate>(
           stats_store_,
@@ -686,13 +782,20 @@ void InstanceImpl::onRuntimeReady() {
 }
 
 void InstanceImpl::startWorkers() {
+  const Init::StartupProfile::StepId workers_step =
+      Init::StartupProfile::beginStep(Init::StartupProfile::Kind::Phase, "workers");
   // The callback will be called after workers are started.
-  listener_manager_->startWorkers(*worker_guard_dog_, [this]() {
+  listener_manager_->startWorkers(*worker_guard_dog_, [this, workers_step]() {
     if (isShutdown()) {
       return;
     }
 
     initialization_timer_->complete();
+    Init::StartupProfile* startup_profile = Init::StartupProfileSingleton::getExisting();
+    if (startup_profile != nullptr) {
+      startup_profile->end(workers_step);
+      startup_profile->complete(stats_store_);
+    }
     // Update server stats as soon as initialization is done.
     updateServerStats();
     workers_started_ = true;
@@ -769,7 +872,10 @@ RunHelper::RunHelper(Instance& instance, const Options& options, Event::Dispatch
   // this can fire immediately if all clusters have already initialized. Also note that we need
   // to guard against shutdown at two different levels since SIGTERM can come in once the run loop
   // starts.
-  cm.setInitializedCb([&instance, &init_manager, &cm, this]() {
+  const Init::StartupProfile::StepId clusters_step =
+      Init::StartupProfile::beginStep(Init::StartupProfile::Kind::Phase, "clusters");
+  cm.setInitializedCb([&instance, &init_manager, &cm, clusters_step, this]() {
+    Init::StartupProfile::endStep(clusters_step);
     if (instance.isShutdown()) {
       return;
     }
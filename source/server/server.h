@@ -31,6 +31,8 @@
 #include "source/common/grpc/context_impl.h"
 #include "source/common/http/context_impl.h"
 #include "source/common/init/manager_impl.h"
+#include "source/common/init/startup_profile.h"
+#include "source/common/memory/allocator_manager.h"
 #include "source/common/memory/heap_shrinker.h"
 #include "source/common/protobuf/message_validator_impl.h"
 #include "source/common/router/context_impl.h"
@@ -71,6 +73,8 @@ struct ServerCompilationSettingsStats {
   COUNTER(dynamic_unknown_fields)                                                                  \
   COUNTER(static_unknown_fields)                                                                   \
   COUNTER(dropped_stat_flushes)                                                                    \
+  COUNTER(hot_restart_stats_merged)                                                                \
+  COUNTER(hot_restart_stats_replies)                                                               \
   GAUGE(concurrency, NeverImport)                                                                  \
   GAUGE(days_until_first_cert_expiring, NeverImport)                                               \
   GAUGE(seconds_until_first_ocsp_response_expiring, NeverImport)                                   \
@@ -86,6 +90,8 @@ struct ServerCompilationSettingsStats {
   GAUGE(total_connections, Accumulate)                                                             \
   GAUGE(uptime, Accumulate)                                                                        \
   GAUGE(version, NeverImport)                                                                      \
+  HISTOGRAM(histogram_merge_time_ms, Milliseconds)                                                 \
+  HISTOGRAM(hot_restart_stats_merge_time_ms, Milliseconds)                                         \
   HISTOGRAM(initialization_time_ms, Milliseconds)
 
 struct ServerStats {
@@ -301,6 +307,7 @@ private:
   ProtobufTypes::MessagePtr dumpBootstrapConfig();
   void flushStatsInternal();
   void updateServerStats();
+  void adoptParentIdleConnections();
   void initialize(const Options& options, Network::Address::InstanceConstSharedPtr local_address,
                   ComponentFactory& component_factory);
   void loadServerFlags(const absl::optional<std::string>& flags_path);
@@ -338,6 +345,15 @@ private:
   time_t original_start_time_;
   Stats::StoreRoot& stats_store_;
   std::unique_ptr<ServerStats> server_stats_;
+  // The buffer slice storage pool counters of each size class, and the totals they last added up
+  // to, as the pools only keep running totals.
+  struct SlicePoolSizeClassStats {
+    Stats::Counter& hits_;
+    Stats::Counter& misses_;
+    uint64_t last_hits_;
+    uint64_t last_misses_;
+  };
+  std::vector<SlicePoolSizeClassStats> slice_pool_stats_;
   std::unique_ptr<CompilationSettings::ServerCompilationSettingsStats>
       server_compilation_settings_stats_;
   Assert::ActionRegistrationPtr assert_action_registration_;
@@ -350,6 +366,10 @@ private:
   Singleton::ManagerPtr singleton_manager_;
   Network::ConnectionHandlerPtr handler_;
   std::unique_ptr<Runtime::ScopedLoaderSingleton> runtime_singleton_;
+  std::unique_ptr<Init::ScopedStartupProfileSingleton> startup_profile_singleton_;
+  // Startup profile steps for the phases which end in callbacks.
+  Init::StartupProfile::StepId primary_clusters_step_{Init::StartupProfile::NoStep};
+  Init::StartupProfile::StepId runtime_step_{Init::StartupProfile::NoStep};
   std::unique_ptr<Ssl::ContextManager> ssl_context_manager_;
   ProdListenerComponentFactory listener_component_factory_;
   ProdWorkerFactory worker_factory_;
@@ -380,9 +400,11 @@ private:
   Router::ContextImpl router_context_;
   std::unique_ptr<ProcessContext> process_context_;
   std::unique_ptr<Memory::HeapShrinker> heap_shrinker_;
+  std::unique_ptr<Memory::AllocatorManager> memory_allocator_manager_;
   // initialization_time is a histogram for tracking the initialization time across hot restarts
   // whenever we have support for histogram merge across hot restarts.
   Stats::TimespanPtr initialization_timer_;
+  Stats::TimespanPtr histogram_merge_timer_;
   ListenerHooks& hooks_;
 
   ServerFactoryContextImpl server_contexts_;
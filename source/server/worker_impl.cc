@@ -9,25 +9,67 @@
 #include "envoy/server/configuration.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "source/common/common/utility.h"
 #include "source/server/connection_handler_impl.h"
 
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace Envoy {
 namespace Server {
+namespace {
+
+// How often a placed worker samples the CPU and NUMA node it runs on.
+constexpr std::chrono::milliseconds PlacementSampleInterval{1000};
+
+// Returns the CPU and NUMA node the calling thread currently runs on.
+absl::optional<std::pair<uint32_t, uint32_t>> currentCpuAndNode() {
+#if defined(__linux__)
+  unsigned cpu;
+  unsigned node;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return std::make_pair(cpu, node);
+  }
+#endif
+  return absl::nullopt;
+}
+
+} // namespace
 
 WorkerPtr ProdWorkerFactory::createWorker(uint32_t index, OverloadManager& overload_manager,
                                           const std::string& worker_name) {
+  WorkerPlacement placement;
+  if (!placement_.cpus().empty()) {
+    placement.cpu_ = placement_.cpus(index % placement_.cpus_size());
+  }
+  placement.numa_local_memory_ = placement_.numa_local_memory();
+  const absl::optional<uint32_t> incoming_cpu =
+      placement_.incoming_cpu_steering() ? placement.cpu_ : absl::nullopt;
+
   Event::DispatcherPtr dispatcher(
       api_.allocateDispatcher(worker_name, overload_manager.scaledTimerFactory()));
-  auto conn_handler = std::make_unique<ConnectionHandlerImpl>(*dispatcher, index);
+  auto conn_handler = std::make_unique<ConnectionHandlerImpl>(*dispatcher, index, incoming_cpu);
   return std::make_unique<WorkerImpl>(tls_, hooks_, std::move(dispatcher), std::move(conn_handler),
-                                      overload_manager, api_);
+                                      overload_manager, api_, placement);
 }
 
 WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks,
                        Event::DispatcherPtr&& dispatcher, Network::ConnectionHandlerPtr handler,
-                       OverloadManager& overload_manager, Api::Api& api)
+                       OverloadManager& overload_manager, Api::Api& api,
+                       const WorkerPlacement& placement)
     : tls_(tls), hooks_(hooks), dispatcher_(std::move(dispatcher)), handler_(std::move(handler)),
-      api_(api) {
+      api_(api), placement_(placement),
+      reset_streams_counter_(api_.rootScope().counterFromString(
+          absl::StrCat("overload.", OverloadActionNames::get().ResetStreams, ".count"))) {
+  if (placement_.cpu_.has_value() || placement_.numa_local_memory_) {
+    const std::string prefix =
+        absl::StrCat("listener_manager.", dispatcher_->name(), ".placement.");
+    placement_stats_ = std::make_unique<WorkerPlacementStats>(WorkerPlacementStats{
+        ALL_WORKER_PLACEMENT_STATS(POOL_COUNTER_PREFIX(api_.rootScope(), prefix))});
+  }
   tls_.registerThread(*dispatcher_, false);
   overload_manager.registerForAction(
       OverloadActionNames::get().StopAcceptingConnections, *dispatcher_,
@@ -35,6 +77,9 @@ WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks,
   overload_manager.registerForAction(
       OverloadActionNames::get().RejectIncomingConnections, *dispatcher_,
       [this](OverloadActionState state) { rejectIncomingConnectionsCb(state); });
+  overload_manager.registerForAction(
+      OverloadActionNames::get().ResetStreams, *dispatcher_,
+      [this](OverloadActionState state) { resetStreamsUsingExcessiveMemory(state); });
 }
 
 void WorkerImpl::addListener(absl::optional<uint64_t> overridden_listener,
@@ -100,7 +145,7 @@ void WorkerImpl::start(GuardDog& guard_dog, const Event::PostCb& cb) {
   //
   // TODO(jmarantz): consider refactoring how this naming works so this naming
   // architecture is centralized, resulting in clearer names.
-  Thread::Options options{absl::StrCat("wrk:", dispatcher_->name())};
+  Thread::Options options{absl::StrCat("wrk:", dispatcher_->name()), placement_.cpu_};
   thread_ = api_.threadFactory().createThread(
       [this, &guard_dog, cb]() -> void { threadRoutine(guard_dog, cb); }, options);
 }
@@ -127,7 +172,38 @@ void WorkerImpl::stopListener(Network::ListenerConfig& listener, std::function<v
   });
 }
 
+void WorkerImpl::releaseIdleConnections(std::chrono::milliseconds min_idle_time,
+                                        ReleaseIdleConnectionsCompletion completion) {
+  ASSERT(thread_);
+  dispatcher_->post([this, min_idle_time, completion]() -> void {
+    completion(handler_->releaseIdleConnections(min_idle_time));
+  });
+}
+
+void WorkerImpl::adoptConnection(Network::ConnectionSocketPtr&& socket) {
+  ASSERT(thread_);
+  // The posted callback has to be copyable, so the socket is bundled in a shared_ptr.
+  auto adopted = std::make_shared<Network::ConnectionSocketPtr>(std::move(socket));
+  dispatcher_->post([this, adopted]() -> void {
+    if (!handler_->adoptConnection(std::move(*adopted))) {
+      ENVOY_LOG(debug, "closing adopted connection: no listener for its address");
+      (*adopted)->close();
+    }
+  });
+}
+
 void WorkerImpl::threadRoutine(GuardDog& guard_dog, const Event::PostCb& cb) {
+  if (placement_.numa_local_memory_) {
+    preferLocalMemory();
+  }
+  if (placement_stats_ != nullptr) {
+    placement_timer_ = dispatcher_->createTimer([this]() -> void {
+      samplePlacement();
+      placement_timer_->enableTimer(PlacementSampleInterval);
+    });
+    samplePlacement();
+    placement_timer_->enableTimer(PlacementSampleInterval);
+  }
   ENVOY_LOG(debug, "worker entering dispatch loop");
   // The watch dog must be created after the dispatcher starts running and has post events flushed,
   // as this is when TLS stat scopes start working.
@@ -139,6 +215,7 @@ void WorkerImpl::threadRoutine(GuardDog& guard_dog, const Event::PostCb& cb) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
   ENVOY_LOG(debug, "worker exited dispatch loop");
   guard_dog.stopWatching(watch_dog_);
+  placement_timer_.reset();
   dispatcher_->shutdown();
 
   // We must close all active connections before we actually exit the thread. This prevents any
@@ -149,6 +226,46 @@ void WorkerImpl::threadRoutine(GuardDog& guard_dog, const Event::PostCb& cb) {
   watch_dog_.reset();
 }
 
+void WorkerImpl::preferLocalMemory() {
+  // The thread is already pinned when its routine starts, so the node it runs on now is the node it
+  // keeps running on, unless it is not pinned or the pinning failed.
+  const auto cpu_and_node = currentCpuAndNode();
+  if (!cpu_and_node.has_value()) {
+    ENVOY_LOG(warn, "preferring NUMA local memory is not supported, ignoring it");
+    return;
+  }
+  const uint32_t node = cpu_and_node->second;
+#if defined(__linux__)
+  constexpr uint32_t MaxNodes = sizeof(unsigned long) * 8;
+  if (node >= MaxNodes) {
+    ENVOY_LOG(warn, "unable to prefer memory of NUMA node {}: more than {} nodes", node, MaxNodes);
+    return;
+  }
+  const unsigned long node_mask = 1UL << node;
+  // set_mempolicy() takes the number of bits of the mask plus one.
+  if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, &node_mask, MaxNodes + 1) != 0) {
+    ENVOY_LOG(warn, "unable to prefer memory of NUMA node {}: {}", node, errorDetails(errno));
+    return;
+  }
+  memory_node_ = node;
+  ENVOY_LOG(debug, "worker prefers memory of NUMA node {}", node);
+#endif
+}
+
+void WorkerImpl::samplePlacement() {
+  const auto cpu_and_node = currentCpuAndNode();
+  if (!cpu_and_node.has_value()) {
+    return;
+  }
+  if (last_cpu_.has_value() && last_cpu_.value() != cpu_and_node->first) {
+    placement_stats_->cpu_migrations_.inc();
+  }
+  last_cpu_ = cpu_and_node->first;
+  if (memory_node_.has_value() && memory_node_.value() != cpu_and_node->second) {
+    placement_stats_->remote_node_samples_.inc();
+  }
+}
+
 void WorkerImpl::stopAcceptingConnectionsCb(OverloadActionState state) {
   if (state.isSaturated()) {
     handler_->disableListeners();
@@ -161,5 +278,11 @@ void WorkerImpl::rejectIncomingConnectionsCb(OverloadActionState state) {
   handler_->setListenerRejectFraction(state.value());
 }
 
+void WorkerImpl::resetStreamsUsingExcessiveMemory(OverloadActionState state) {
+  const uint64_t streams_reset =
+      dispatcher_->getWatermarkFactory().resetAccountsGivenPressure(state.value().value());
+  reset_streams_counter_.add(streams_reset);
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -4,10 +4,14 @@
 #include <memory>
 
 #include "envoy/api/api.h"
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/event/timer.h"
 #include "envoy/network/connection_handler.h"
 #include "envoy/server/guarddog.h"
 #include "envoy/server/listener_manager.h"
 #include "envoy/server/worker.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/thread_local/thread_local.h"
 
 #include "source/common/common/logger.h"
@@ -16,6 +20,30 @@
 namespace Envoy {
 namespace Server {
 
+/**
+ * All worker placement stats. @see stats_macros.h
+ */
+#define ALL_WORKER_PLACEMENT_STATS(COUNTER)                                                        \
+  COUNTER(cpu_migrations)                                                                          \
+  COUNTER(remote_node_samples)
+
+/**
+ * Struct definition for all worker placement stats. @see stats_macros.h
+ */
+struct WorkerPlacementStats {
+  ALL_WORKER_PLACEMENT_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Where a worker thread runs and allocates its memory.
+ */
+struct WorkerPlacement {
+  // The CPU to pin the worker thread to, if any.
+  absl::optional<uint32_t> cpu_;
+  // Whether the worker thread prefers allocating memory on the NUMA node it runs on.
+  bool numa_local_memory_{};
+};
+
 class ProdWorkerFactory : public WorkerFactory, Logger::Loggable<Logger::Id::main> {
 public:
   ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, ListenerHooks& hooks)
@@ -25,10 +53,18 @@ public:
   WorkerPtr createWorker(uint32_t index, OverloadManager& overload_manager,
                          const std::string& worker_name) override;
 
+  /**
+   * Sets the placement of the workers created afterwards.
+   */
+  void setWorkerPlacement(const envoy::config::bootstrap::v3::WorkerPlacement& placement) {
+    placement_ = placement;
+  }
+
 private:
   ThreadLocal::Instance& tls_;
   Api::Api& api_;
   ListenerHooks& hooks_;
+  envoy::config::bootstrap::v3::WorkerPlacement placement_;
 };
 
 /**
@@ -38,7 +74,7 @@ class WorkerImpl : public Worker, Logger::Loggable<Logger::Id::main> {
 public:
   WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks, Event::DispatcherPtr&& dispatcher,
              Network::ConnectionHandlerPtr handler, OverloadManager& overload_manager,
-             Api::Api& api);
+             Api::Api& api, const WorkerPlacement& placement = {});
 
   // Server::Worker
   void addListener(absl::optional<uint64_t> overridden_listener, Network::ListenerConfig& listener,
@@ -53,11 +89,17 @@ public:
   void initializeStats(Stats::Scope& scope) override;
   void stop() override;
   void stopListener(Network::ListenerConfig& listener, std::function<void()> completion) override;
+  void releaseIdleConnections(std::chrono::milliseconds min_idle_time,
+                              ReleaseIdleConnectionsCompletion completion) override;
+  void adoptConnection(Network::ConnectionSocketPtr&& socket) override;
 
 private:
   void threadRoutine(GuardDog& guard_dog, const Event::PostCb& cb);
   void stopAcceptingConnectionsCb(OverloadActionState state);
   void rejectIncomingConnectionsCb(OverloadActionState state);
+  void resetStreamsUsingExcessiveMemory(OverloadActionState state);
+  void preferLocalMemory();
+  void samplePlacement();
 
   ThreadLocal::Instance& tls_;
   ListenerHooks& hooks_;
@@ -66,6 +108,13 @@ private:
   Api::Api& api_;
   Thread::ThreadPtr thread_;
   WatchDogSharedPtr watch_dog_;
+  const WorkerPlacement placement_;
+  // Only set when the worker has a placement, and only used on the worker thread.
+  std::unique_ptr<WorkerPlacementStats> placement_stats_;
+  Event::TimerPtr placement_timer_;
+  absl::optional<uint32_t> last_cpu_;
+  absl::optional<uint32_t> memory_node_;
+  Stats::Counter& reset_streams_counter_;
 };
 
 } // namespace Server
@@ -19,6 +19,7 @@
 #include "test/mocks/access_log/mocks.h"
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/filesystem/mocks.h"
+#include "test/mocks/router/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/server/factory_context.h"
 #include "test/mocks/upstream/cluster_info.h"
@@ -1630,6 +1631,107 @@ TEST_F(AccessLogImplTest, DEPRECATED_FEATURE_TEST(DeprecatedExtensionFilterName)
   }
 }
 
+class AdaptiveSamplingFilterTest : public Event::TestUsingSimulatedTime, public testing::Test {
+public:
+  FilterPtr createFilter(const std::string& filter_yaml) {
+    envoy::config::accesslog::v3::AccessLogFilter config;
+    TestUtility::loadFromYamlAndValidate(filter_yaml, config);
+    timer_ = new NiceMock<Event::MockTimer>(&context_.dispatcher_);
+    EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(1000), _));
+    return FilterFactory::fromProto(config, context_);
+  }
+
+  // Returns how many of count requests of the given duration are logged.
+  uint32_t evaluate(const Filter& filter, uint32_t count,
+                    std::chrono::milliseconds duration = std::chrono::milliseconds(3)) {
+    stream_info_.end_time_ = stream_info_.startTimeMonotonic() + duration;
+    uint32_t logged = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+      logged += filter.evaluate(stream_info_, request_headers_, response_headers_,
+                                response_trailers_);
+    }
+    return logged;
+  }
+
+  Http::TestRequestHeaderMapImpl request_headers_{{":method", "GET"}, {":path", "/"}};
+  Http::TestResponseHeaderMapImpl response_headers_;
+  Http::TestResponseTrailerMapImpl response_trailers_;
+  TestStreamInfo stream_info_;
+  NiceMock<Server::Configuration::MockServerFactoryContext> context_;
+  Event::MockTimer* timer_;
+};
+
+// Each pair of route and response class is sampled with its own bucket, and the errors are always
+// logged.
+TEST_F(AdaptiveSamplingFilterTest, SamplesEachPairAtRate) {
+  FilterPtr filter = createFilter(R"EOF(
+adaptive_sampling_filter:
+  logs_per_second: 2
+  )EOF");
+
+  stream_info_.response_code_ = 200;
+  EXPECT_EQ(2U, evaluate(*filter, 10));
+  stream_info_.response_code_ = 404;
+  EXPECT_EQ(2U, evaluate(*filter, 10));
+  stream_info_.response_code_ = 503;
+  EXPECT_EQ(10U, evaluate(*filter, 10));
+  stream_info_.response_code_.reset();
+  EXPECT_EQ(10U, evaluate(*filter, 10));
+
+  NiceMock<Router::MockRouteEntry> route_entry;
+  stream_info_.route_entry_ = &route_entry;
+  stream_info_.response_code_ = 200;
+  EXPECT_EQ(2U, evaluate(*filter, 10));
+
+  simTime().advanceTimeWait(std::chrono::milliseconds(500));
+  EXPECT_EQ(1U, evaluate(*filter, 10));
+  stream_info_.route_entry_ = nullptr;
+  EXPECT_EQ(1U, evaluate(*filter, 10));
+}
+
+TEST_F(AdaptiveSamplingFilterTest, ErrorStatusCode) {
+  FilterPtr filter = createFilter(R"EOF(
+adaptive_sampling_filter:
+  logs_per_second: 1
+  error_status_code: 400
+  )EOF");
+
+  stream_info_.response_code_ = 404;
+  EXPECT_EQ(10U, evaluate(*filter, 10));
+  stream_info_.response_code_ = 302;
+  EXPECT_EQ(1U, evaluate(*filter, 10));
+}
+
+// Once reconciled, the requests slower than the percentile of the durations of their pair during
+// the last interval are always logged.
+TEST_F(AdaptiveSamplingFilterTest, LogsSlowRequests) {
+  FilterPtr filter = createFilter(R"EOF(
+adaptive_sampling_filter:
+  logs_per_second: 1
+  slow_request_percentile: 50
+  )EOF");
+
+  stream_info_.response_code_ = 200;
+  uint32_t logged = 0;
+  for (uint32_t i = 1; i <= 10; ++i) {
+    logged += evaluate(*filter, 1, std::chrono::milliseconds(i));
+  }
+  EXPECT_EQ(1U, logged);
+
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(1000), _));
+  timer_->invokeCallback();
+  EXPECT_EQ(10U, evaluate(*filter, 10, std::chrono::milliseconds(20)));
+  // The bucket keeps the tokens it had before the reconciliation.
+  EXPECT_EQ(0U, evaluate(*filter, 10, std::chrono::milliseconds(1)));
+
+  // A pair without requests during an interval is sampled at the whole rate again.
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(1000), _));
+  timer_->invokeCallback();
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(1000), _));
+  timer_->invokeCallback();
+  EXPECT_EQ(1U, evaluate(*filter, 10, std::chrono::milliseconds(1)));
+}
+
 } // namespace
 } // namespace AccessLog
 } // namespace Envoy
@@ -146,6 +146,8 @@ public:
     src.size_ -= length;
   }
 
+  void movePinned(Buffer::Instance& rhs, uint64_t length) override { move(rhs, length); }
+
   Buffer::Reservation reserveForRead() override {
     auto reservation = Buffer::Reservation::bufferImplUseOnlyConstruct(*this);
     Buffer::RawSlice slice;
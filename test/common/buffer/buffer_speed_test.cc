@@ -258,6 +258,43 @@ BENCHMARK(bufferReserveCommitPartial)
     ->Arg(64 * 1024)
     ->Arg(128 * 1024);
 
+// Test filling and freeing a slice of each size, which reuses storage from the thread's slice
+// storage pool, or with the second argument set, trims the pool first so that storage comes from
+// the allocator instead.
+static void bufferSliceStoragePool(benchmark::State& state) {
+  const std::string data(state.range(0), 'a');
+  const bool trim = state.range(1) != 0;
+  const uint64_t page_size = Buffer::Slice::page_size_;
+  const auto pool_totals = [size = (data.size() + page_size - 1) / page_size * page_size]() {
+    std::pair<uint64_t, uint64_t> totals{0, 0};
+    for (const Buffer::Slice::PoolStats& stats : Buffer::Slice::poolStats()) {
+      if (stats.size_ == size) {
+        totals = {stats.hits_, stats.misses_};
+      }
+    }
+    return totals;
+  };
+  const auto before = pool_totals();
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    if (trim) {
+      Buffer::Slice::trimPools();
+    }
+    Buffer::OwnedImpl buffer(data);
+    benchmark::DoNotOptimize(buffer.length());
+  }
+  const auto after = pool_totals();
+  state.counters["hits"] = after.first - before.first;
+  state.counters["misses"] = after.second - before.second;
+}
+BENCHMARK(bufferSliceStoragePool)
+    ->Args({4 * 1024, 0})
+    ->Args({4 * 1024, 1})
+    ->Args({16 * 1024, 0})
+    ->Args({16 * 1024, 1})
+    ->Args({60 * 1024, 0})
+    ->Args({60 * 1024, 1});
+
 // Test the linearization of a buffer in the best case where the data is in one slice.
 static void bufferLinearizeSimple(benchmark::State& state) {
   const std::string data(state.range(0), 'a');
@@ -0,0 +1,131 @@
+#include <string>
+
+#include "envoy/config/core/v3/base.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/disk_spill_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+class DiskSpillTest : public testing::Test {
+protected:
+  void setup(uint64_t max_disk_bytes = 1024 * 1024) {
+    envoy::config::core::v3::BufferSpillConfig config;
+    config.set_directory(TestEnvironment::temporaryDirectory());
+    config.mutable_segment_size_bytes()->set_value(SegmentSize);
+    config.mutable_max_disk_bytes()->set_value(max_disk_bytes);
+    spill_ = DiskSpill::create(config, store_, "spill.");
+  }
+
+  uint64_t counter(const std::string& name) {
+    return TestUtility::findCounter(store_, "spill." + name)->value();
+  }
+  uint64_t diskBytes() { return TestUtility::findGauge(store_, "spill.disk_bytes")->value(); }
+
+  static constexpr uint64_t SegmentSize = 4096;
+
+  Stats::IsolatedStoreImpl store_;
+  DiskSpillSharedPtr spill_;
+};
+
+// The spilled data reads back as it was buffered.
+TEST_F(DiskSpillTest, SpillsContent) {
+  setup();
+  DiskSpiller spiller(spill_);
+
+  OwnedImpl data("hello world");
+  EXPECT_TRUE(spiller.spill(data));
+  EXPECT_EQ("hello world", data.toString());
+  EXPECT_EQ(SegmentSize, diskBytes());
+  EXPECT_EQ(11, counter("spilled_bytes"));
+
+  data.drain(6);
+  EXPECT_EQ("world", data.toString());
+}
+
+// The chunks of a body are packed one after another, across as many segments as they need.
+TEST_F(DiskSpillTest, PacksChunksAcrossSegments) {
+  setup();
+  DiskSpiller spiller(spill_);
+
+  const std::string first(6000, 'a');
+  const std::string second(3000, 'b');
+  OwnedImpl body;
+  OwnedImpl data(first);
+  EXPECT_TRUE(spiller.spill(data));
+  body.move(data);
+  EXPECT_EQ(2 * SegmentSize, diskBytes());
+  data.add(second);
+  EXPECT_TRUE(spiller.spill(data));
+  body.move(data);
+  EXPECT_EQ(3 * SegmentSize, diskBytes());
+  EXPECT_EQ(first + second, body.toString());
+}
+
+// A chunk which does not fit under the maximum disk space is left in memory.
+TEST_F(DiskSpillTest, DiskFull) {
+  setup(2 * SegmentSize);
+  DiskSpiller spiller(spill_);
+
+  const std::string content(3 * SegmentSize, 'a');
+  OwnedImpl data(content);
+  EXPECT_FALSE(spiller.spill(data));
+  EXPECT_EQ(content, data.toString());
+  EXPECT_EQ(1, counter("spill_disk_full"));
+  EXPECT_EQ(0, counter("spilled_bytes"));
+  EXPECT_EQ(0, diskBytes());
+}
+
+// The disk space is freed once neither the buffers nor the spiller reference the segments anymore.
+TEST_F(DiskSpillTest, ReleasesDiskWithBufferedData) {
+  setup(SegmentSize);
+
+  {
+    OwnedImpl data(std::string(100, 'a'));
+    {
+      DiskSpiller spiller(spill_);
+      EXPECT_TRUE(spiller.spill(data));
+    }
+    EXPECT_EQ(SegmentSize, diskBytes());
+
+    DiskSpiller other(spill_);
+    OwnedImpl other_data("b");
+    EXPECT_FALSE(other.spill(other_data));
+  }
+  EXPECT_EQ(0, diskBytes());
+
+  DiskSpiller spiller(spill_);
+  OwnedImpl data("b");
+  EXPECT_TRUE(spiller.spill(data));
+  EXPECT_EQ(SegmentSize, diskBytes());
+}
+
+// A segment which can't be created fails the spill without leaking its reservation.
+TEST_F(DiskSpillTest, CreateFailure) {
+  envoy::config::core::v3::BufferSpillConfig config;
+  config.set_directory(TestEnvironment::temporaryPath("missing_spill_directory"));
+  config.mutable_segment_size_bytes()->set_value(SegmentSize);
+  config.mutable_max_disk_bytes()->set_value(SegmentSize);
+  spill_ = DiskSpill::create(config, store_, "spill.");
+  DiskSpiller spiller(spill_);
+
+  OwnedImpl data("hello");
+  EXPECT_FALSE(spiller.spill(data));
+  EXPECT_FALSE(spiller.spill(data));
+  EXPECT_EQ("hello", data.toString());
+  EXPECT_EQ(2, counter("spill_failed"));
+  EXPECT_EQ(0, counter("spill_disk_full"));
+  EXPECT_EQ(0, diskBytes());
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
@@ -627,6 +627,55 @@ TEST_F(OwnedImplTest, PartialMoveDrainTrackers) {
   buffer2.drain(buffer2.length());
 }
 
+TEST_F(OwnedImplTest, MovePinned) {
+  Buffer::OwnedImpl buffer1;
+  buffer1.add("a");
+
+  Buffer::OwnedImpl buffer2;
+  buffer2.add(std::string(10000, 'c'));
+  const Buffer::RawSliceVector slices = buffer2.getRawSlices();
+  ASSERT_EQ(1, slices.size());
+
+  // Move part of the slice. Unlike move() the moved data keeps its address and is not coalesced
+  // into the last slice of buffer1, while the remainder is copied into a new slice.
+  buffer1.movePinned(buffer2, 4999);
+  EXPECT_EQ(5000, buffer1.length());
+  EXPECT_EQ(5001, buffer2.length());
+  const Buffer::RawSliceVector moved_slices = buffer1.getRawSlices();
+  ASSERT_EQ(2, moved_slices.size());
+  EXPECT_EQ(slices[0].mem_, moved_slices[1].mem_);
+  EXPECT_EQ(4999, moved_slices[1].len_);
+  EXPECT_NE(slices[0].mem_, buffer2.frontSlice().mem_);
+  EXPECT_EQ("a" + std::string(4999, 'c'), buffer1.toString());
+  EXPECT_EQ(std::string(5001, 'c'), buffer2.toString());
+
+  // Move the rest.
+  buffer1.movePinned(buffer2, buffer2.length());
+  EXPECT_EQ(10001, buffer1.length());
+  EXPECT_EQ(0, buffer2.length());
+  EXPECT_EQ(3, buffer1.getRawSlices().size());
+}
+
+TEST_F(OwnedImplTest, MovePinnedDrainTrackers) {
+  testing::InSequence s;
+
+  Buffer::OwnedImpl buffer1;
+  Buffer::OwnedImpl buffer2;
+  buffer2.add(std::string(100, 'a'));
+  testing::MockFunction<void()> tracker;
+  buffer2.addDrainTracker(tracker.AsStdFunction());
+
+  // The tracker sticks with the pinned storage and only fires when it is released.
+  buffer1.movePinned(buffer2, 50);
+  buffer2.drain(buffer2.length());
+
+  testing::MockFunction<void()> done;
+  EXPECT_CALL(tracker, Call());
+  EXPECT_CALL(done, Call());
+  buffer1.drain(buffer1.length());
+  done.Call();
+}
+
 TEST_F(OwnedImplTest, DrainTrackingOnDestruction) {
   testing::InSequence s;
 
@@ -938,8 +987,10 @@ TEST_F(OwnedImplTest, ReserveSingleOverCommit) {
       "length <= slice_.len_. Details: commit() length must be <= size of the Reservation");
 }
 
-// Test functionality of the `freelist` (a performance optimization)
-TEST_F(OwnedImplTest, SliceFreeList) {
+// Test functionality of the slice storage pool (a performance optimization)
+TEST_F(OwnedImplTest, SliceStoragePool) {
+  // Start from an empty pool, so that it has room for all of the storage freed below.
+  Slice::trimPools();
   Buffer::OwnedImpl b1, b2;
   std::vector<void*> slices;
   {
@@ -958,19 +1009,21 @@ TEST_F(OwnedImplTest, SliceFreeList) {
     EXPECT_EQ(slices[1], b2.getRawSlices()[0].mem_);
   }
 
+  // Storage freed by draining goes back to the pool as well, and is reused first.
   b1.drain(1);
   EXPECT_EQ(0, b1.getRawSlices().size());
   {
     auto r = b2.reserveForRead();
     // slices()[0] is the partially used slice that is already part of this buffer.
-    EXPECT_EQ(slices[2], r.slices()[1].mem_);
+    EXPECT_EQ(slices[0], r.slices()[1].mem_);
+    EXPECT_EQ(slices[2], r.slices()[2].mem_);
   }
   {
     auto r = b1.reserveForRead();
-    EXPECT_EQ(slices[2], r.slices()[0].mem_);
+    EXPECT_EQ(slices[0], r.slices()[0].mem_);
   }
   {
-    // This causes an underflow in the `freelist` on creation, and overflows it on deletion.
+    // This causes an underflow in the pool on creation, and overflows it on deletion.
     auto r1 = b1.reserveForRead();
     auto r2 = b2.reserveForRead();
     for (auto& r1_slice : absl::MakeSpan(r1.slices(), r1.numSlices())) {
@@ -984,6 +1037,47 @@ TEST_F(OwnedImplTest, SliceFreeList) {
   }
 }
 
+TEST_F(OwnedImplTest, SliceStoragePoolStats) {
+  const auto pool_stats = [](uint64_t size) {
+    for (const Slice::PoolStats& stats : Slice::poolStats()) {
+      if (stats.size_ == size) {
+        return stats;
+      }
+    }
+    return Slice::PoolStats{size, 0, 0};
+  };
+  const auto add_and_free = [](uint64_t size) {
+    Buffer::OwnedImpl buffer;
+    buffer.add(std::string(size, 'a'));
+  };
+
+  Slice::trimPools();
+  const Slice::PoolStats before = pool_stats(8192);
+  add_and_free(8000);
+  add_and_free(8000);
+  Slice::PoolStats after = pool_stats(8192);
+  EXPECT_EQ(before.misses_ + 1, after.misses_);
+  EXPECT_EQ(before.hits_ + 1, after.hits_);
+
+  // Trimming empties the pool.
+  Slice::trimPools();
+  add_and_free(8000);
+  after = pool_stats(8192);
+  EXPECT_EQ(before.misses_ + 2, after.misses_);
+  EXPECT_EQ(before.hits_ + 1, after.hits_);
+
+  // Storage bigger than the largest size class isn't pooled.
+  const std::vector<Slice::PoolStats> all_before = Slice::poolStats();
+  add_and_free(Slice::max_pooled_size_ + 1);
+  add_and_free(Slice::max_pooled_size_ + 1);
+  const std::vector<Slice::PoolStats> all_after = Slice::poolStats();
+  ASSERT_EQ(all_before.size(), all_after.size());
+  for (size_t i = 0; i < all_before.size(); i++) {
+    EXPECT_EQ(all_before[i].hits_, all_after[i].hits_);
+    EXPECT_EQ(all_before[i].misses_, all_after[i].misses_);
+  }
+}
+
 TEST_F(OwnedImplTest, Search) {
   // Populate a buffer with a string split across many small slices, to
   // exercise edge cases in the search implementation.
@@ -1,4 +1,6 @@
 #include <array>
+#include <memory>
+#include <vector>
 
 #include "source/common/api/os_sys_calls_impl.h"
 #include "source/common/buffer/buffer_impl.h"
@@ -6,8 +8,10 @@
 #include "source/common/network/io_socket_handle_impl.h"
 
 #include "test/common/buffer/utility.h"
+#include "test/mocks/http/stream.h"
 #include "test/test_common/test_runtime.h"
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -570,6 +574,115 @@ TEST_F(WatermarkBufferTest, MoveWatermarksOverflow) {
   EXPECT_EQ(1, overflow_watermark_buffer1);
 }
 
+constexpr uint64_t MinTrackedBalance = 1 << TrackedBufferMemoryAccountImpl::MinTrackedBalanceShift;
+
+class TrackedAccountTest : public testing::Test {
+public:
+  WatermarkBufferFactory factory_;
+};
+
+TEST_F(TrackedAccountTest, AccountsMoveBetweenSizeClasses) {
+  testing::StrictMock<Http::MockStream> stream;
+  BufferMemoryAccountSharedPtr account = factory_.createAccount(stream);
+  auto& tracked = static_cast<TrackedBufferMemoryAccountImpl&>(*account);
+
+  // Balances under the minimum are not tracked.
+  account->charge(MinTrackedBalance - 1);
+  EXPECT_FALSE(tracked.balanceToSizeClass().has_value());
+  EXPECT_EQ(0, factory_.accountsInSizeClass(0));
+
+  account->charge(1);
+  EXPECT_EQ(0, tracked.balanceToSizeClass());
+  EXPECT_EQ(1, factory_.accountsInSizeClass(0));
+
+  account->charge(3 * MinTrackedBalance);
+  EXPECT_EQ(2, tracked.balanceToSizeClass());
+  EXPECT_EQ(0, factory_.accountsInSizeClass(0));
+  EXPECT_EQ(1, factory_.accountsInSizeClass(2));
+
+  // The last class holds all the larger balances.
+  account->charge(1024 * MinTrackedBalance);
+  EXPECT_EQ(TrackedBufferMemoryAccountImpl::NumSizeClasses - 1, tracked.balanceToSizeClass());
+  EXPECT_EQ(1, factory_.accountsInSizeClass(TrackedBufferMemoryAccountImpl::NumSizeClasses - 1));
+
+  account->credit(1028 * MinTrackedBalance);
+  EXPECT_FALSE(tracked.balanceToSizeClass().has_value());
+  for (uint32_t i = 0; i < TrackedBufferMemoryAccountImpl::NumSizeClasses; i++) {
+    EXPECT_EQ(0, factory_.accountsInSizeClass(i));
+  }
+}
+
+TEST_F(TrackedAccountTest, ClearedAccountsAreNotTracked) {
+  testing::StrictMock<Http::MockStream> stream;
+  BufferMemoryAccountSharedPtr account = factory_.createAccount(stream);
+  account->charge(MinTrackedBalance);
+  EXPECT_EQ(1, factory_.accountsInSizeClass(0));
+
+  // Slices may still charge the account after the stream is done.
+  account->clearDownstream();
+  EXPECT_EQ(0, factory_.accountsInSizeClass(0));
+  account->charge(MinTrackedBalance);
+  EXPECT_EQ(0, factory_.accountsInSizeClass(1));
+  EXPECT_EQ(0, factory_.resetAccountsGivenPressure(1.0));
+  account->resetDownstream();
+  account->credit(2 * MinTrackedBalance);
+}
+
+TEST_F(TrackedAccountTest, ResetsLargestAccountsGivenPressure) {
+  constexpr uint32_t num_size_classes = TrackedBufferMemoryAccountImpl::NumSizeClasses;
+  std::array<testing::StrictMock<Http::MockStream>, num_size_classes> streams;
+  std::vector<BufferMemoryAccountSharedPtr> accounts;
+  for (uint32_t i = 0; i < num_size_classes; i++) {
+    accounts.push_back(factory_.createAccount(streams[i]));
+    accounts.back()->charge(MinTrackedBalance << i);
+  }
+
+  // No pressure, no reset.
+  EXPECT_EQ(0, factory_.resetAccountsGivenPressure(0.0));
+
+  // The least pressure resets the largest class.
+  EXPECT_CALL(streams[num_size_classes - 1],
+              resetStream(Http::StreamResetReason::OverloadManager));
+  EXPECT_EQ(1, factory_.resetAccountsGivenPressure(0.05));
+  EXPECT_EQ(0, factory_.accountsInSizeClass(num_size_classes - 1));
+
+  // Half the pressure resets half the classes, the accounts already reset are not reset again.
+  for (uint32_t i = num_size_classes / 2; i < num_size_classes - 1; i++) {
+    EXPECT_CALL(streams[i], resetStream(Http::StreamResetReason::OverloadManager));
+  }
+  EXPECT_EQ(num_size_classes / 2 - 1, factory_.resetAccountsGivenPressure(0.45));
+
+  // Full pressure resets all the classes.
+  for (uint32_t i = 0; i < num_size_classes / 2; i++) {
+    EXPECT_CALL(streams[i], resetStream(Http::StreamResetReason::OverloadManager));
+  }
+  EXPECT_EQ(num_size_classes / 2, factory_.resetAccountsGivenPressure(1.0));
+
+  for (uint32_t i = 0; i < num_size_classes; i++) {
+    accounts[i]->credit(MinTrackedBalance << i);
+  }
+}
+
+TEST_F(TrackedAccountTest, LimitsResetsPerCall) {
+  constexpr uint32_t num_streams = WatermarkBufferFactory::MaxStreamsToResetPerCall + 10;
+  std::vector<std::unique_ptr<testing::NiceMock<Http::MockStream>>> streams;
+  std::vector<BufferMemoryAccountSharedPtr> accounts;
+  for (uint32_t i = 0; i < num_streams; i++) {
+    streams.push_back(std::make_unique<testing::NiceMock<Http::MockStream>>());
+    accounts.push_back(factory_.createAccount(*streams.back()));
+    accounts.back()->charge(MinTrackedBalance);
+  }
+
+  EXPECT_EQ(WatermarkBufferFactory::MaxStreamsToResetPerCall,
+            factory_.resetAccountsGivenPressure(1.0));
+  EXPECT_EQ(10, factory_.accountsInSizeClass(0));
+  EXPECT_EQ(10, factory_.resetAccountsGivenPressure(1.0));
+
+  for (const auto& account : accounts) {
+    account->credit(MinTrackedBalance);
+  }
+}
+
 } // namespace
 } // namespace Buffer
 } // namespace Envoy
@@ -0,0 +1,83 @@
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/zero_copy_output_stream_impl.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+class ZeroCopyOutputStreamTest : public testing::Test {
+public:
+  Buffer::OwnedImpl buffer_;
+
+  void* data_;
+  int size_;
+};
+
+TEST_F(ZeroCopyOutputStreamTest, NextCommitsPreviousReservation) {
+  ZeroCopyOutputStreamImpl stream(buffer_);
+  EXPECT_TRUE(stream.Next(&data_, &size_));
+  EXPECT_EQ(Slice::default_slice_size_, size_);
+  memset(data_, 'a', size_);
+  EXPECT_EQ(0, buffer_.length());
+
+  EXPECT_TRUE(stream.Next(&data_, &size_));
+  EXPECT_EQ(Slice::default_slice_size_, buffer_.length());
+  EXPECT_EQ(2 * Slice::default_slice_size_, stream.ByteCount());
+}
+
+TEST_F(ZeroCopyOutputStreamTest, BackUp) {
+  {
+    ZeroCopyOutputStreamImpl stream(buffer_);
+    EXPECT_TRUE(stream.Next(&data_, &size_));
+    memcpy(data_, "abcd", 4);
+    stream.BackUp(size_ - 4);
+    EXPECT_EQ(4, stream.ByteCount());
+    EXPECT_EQ("abcd", buffer_.toString());
+
+    EXPECT_TRUE(stream.Next(&data_, &size_));
+    memcpy(data_, "ef", 2);
+    stream.BackUp(size_ - 2);
+    EXPECT_EQ(6, stream.ByteCount());
+  }
+  EXPECT_EQ("abcdef", buffer_.toString());
+}
+
+TEST_F(ZeroCopyOutputStreamTest, SizeHint) {
+  ZeroCopyOutputStreamImpl stream(buffer_, Slice::default_slice_size_ + 100);
+  EXPECT_TRUE(stream.Next(&data_, &size_));
+  EXPECT_EQ(Slice::default_slice_size_, size_);
+  EXPECT_TRUE(stream.Next(&data_, &size_));
+  EXPECT_EQ(100, size_);
+  // Once the hint is used up, further writes get default sized reservations.
+  EXPECT_TRUE(stream.Next(&data_, &size_));
+  EXPECT_EQ(Slice::default_slice_size_, size_);
+}
+
+TEST_F(ZeroCopyOutputStreamTest, DestructionCommits) {
+  buffer_.add("x");
+  {
+    ZeroCopyOutputStreamImpl stream(buffer_, 3);
+    EXPECT_TRUE(stream.Next(&data_, &size_));
+    EXPECT_EQ(3, size_);
+    memcpy(data_, "abc", 3);
+  }
+  EXPECT_EQ("xabc", buffer_.toString());
+}
+
+TEST_F(ZeroCopyOutputStreamTest, LargeMessageIsNotContiguous) {
+  const std::string data(4 * Slice::default_slice_size_ + 10, 'a');
+  {
+    ZeroCopyOutputStreamImpl stream(buffer_, data.size());
+    Protobuf::io::CodedOutputStream codec_stream(&stream);
+    codec_stream.WriteRaw(data.data(), data.size());
+  }
+  EXPECT_EQ(data, buffer_.toString());
+  EXPECT_EQ(5, buffer_.getRawSlices().size());
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
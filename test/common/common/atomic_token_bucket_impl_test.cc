@@ -0,0 +1,138 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "source/common/common/atomic_token_bucket_impl.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+
+class AtomicTokenBucketImplTest : public testing::Test {
+protected:
+  Event::SimulatedTimeSystem time_system_;
+  std::chrono::milliseconds time_to_next_token;
+};
+
+// Verifies TokenBucket initialization.
+TEST_F(AtomicTokenBucketImplTest, Initialization) {
+  AtomicTokenBucketImpl token_bucket{1, time_system_, -1.0};
+
+  EXPECT_EQ(1, token_bucket.consume(1, false));
+  EXPECT_EQ(0, token_bucket.consume(1, false));
+}
+
+// Verifies TokenBucket's maximum capacity.
+TEST_F(AtomicTokenBucketImplTest, MaxBucketSize) {
+  AtomicTokenBucketImpl token_bucket{3, time_system_, 1};
+
+  EXPECT_EQ(3, token_bucket.consume(3, false));
+  time_system_.setMonotonicTime(std::chrono::seconds(10));
+  EXPECT_EQ(0, token_bucket.consume(4, false));
+  EXPECT_EQ(3, token_bucket.consume(3, false));
+}
+
+// Verifies that TokenBucket can consume tokens.
+TEST_F(AtomicTokenBucketImplTest, Consume) {
+  AtomicTokenBucketImpl token_bucket{10, time_system_, 1};
+
+  EXPECT_EQ(0, token_bucket.consume(20, false));
+  EXPECT_EQ(9, token_bucket.consume(9, false));
+
+  EXPECT_EQ(1, token_bucket.consume(1, false));
+
+  time_system_.setMonotonicTime(std::chrono::milliseconds(999));
+  EXPECT_EQ(0, token_bucket.consume(1, false));
+
+  time_system_.setMonotonicTime(std::chrono::milliseconds(5999));
+  EXPECT_EQ(0, token_bucket.consume(6, false));
+
+  time_system_.setMonotonicTime(std::chrono::milliseconds(6000));
+  EXPECT_EQ(6, token_bucket.consume(6, false));
+  EXPECT_EQ(0, token_bucket.consume(1, false));
+}
+
+// Verifies that TokenBucket can refill tokens.
+TEST_F(AtomicTokenBucketImplTest, Refill) {
+  AtomicTokenBucketImpl token_bucket{1, time_system_, 0.5};
+  EXPECT_EQ(1, token_bucket.consume(1, false));
+
+  time_system_.setMonotonicTime(std::chrono::milliseconds(500));
+  EXPECT_EQ(0, token_bucket.consume(1, false));
+  time_system_.setMonotonicTime(std::chrono::milliseconds(1500));
+  EXPECT_EQ(0, token_bucket.consume(1, false));
+  time_system_.setMonotonicTime(std::chrono::milliseconds(2000));
+  EXPECT_EQ(1, token_bucket.consume(1, false));
+}
+
+// The time to the next token accounts for the fraction of a token left in the bucket.
+TEST_F(AtomicTokenBucketImplTest, NextTokenAvailable) {
+  AtomicTokenBucketImpl token_bucket{8, time_system_, 4};
+  EXPECT_EQ(7, token_bucket.consume(7, false, time_to_next_token));
+  EXPECT_EQ(std::chrono::milliseconds(0), time_to_next_token);
+  EXPECT_EQ(1, token_bucket.consume(1, false));
+  EXPECT_EQ(0, token_bucket.consume(1, false));
+  EXPECT_EQ(std::chrono::milliseconds(250), token_bucket.nextTokenAvailable());
+  time_system_.advanceTimeWait(std::chrono::milliseconds(125));
+  EXPECT_EQ(std::chrono::milliseconds(125), token_bucket.nextTokenAvailable());
+}
+
+// Test partial consumption of tokens.
+TEST_F(AtomicTokenBucketImplTest, PartialConsumption) {
+  AtomicTokenBucketImpl token_bucket{16, time_system_, 16};
+  EXPECT_EQ(16, token_bucket.consume(18, true));
+  EXPECT_EQ(std::chrono::milliseconds(63), token_bucket.nextTokenAvailable());
+  time_system_.advanceTimeWait(std::chrono::milliseconds(62));
+  EXPECT_EQ(0, token_bucket.consume(1, true));
+  time_system_.advanceTimeWait(std::chrono::milliseconds(1));
+  EXPECT_EQ(1, token_bucket.consume(2, true));
+}
+
+// The callback decides how many of the available tokens are consumed.
+TEST_F(AtomicTokenBucketImplTest, ConsumeFromCallback) {
+  AtomicTokenBucketImpl token_bucket{16, time_system_, 16};
+  EXPECT_EQ(8, token_bucket.consume([](uint64_t available) {
+    EXPECT_EQ(16, available);
+    return available / 2;
+  }));
+  EXPECT_EQ(8, token_bucket.consume([](uint64_t available) { return available * 2; }));
+  EXPECT_EQ(0, token_bucket.consume([](uint64_t available) {
+    EXPECT_EQ(0, available);
+    return 1;
+  }));
+}
+
+// Only the first reset of the bucket is honored, as it is shared.
+TEST_F(AtomicTokenBucketImplTest, Reset) {
+  AtomicTokenBucketImpl token_bucket{16, time_system_, 16};
+  token_bucket.maybeReset(1);
+  EXPECT_EQ(1, token_bucket.consume(2, true));
+
+  token_bucket.maybeReset(5);
+  EXPECT_EQ(0, token_bucket.consume(5, true));
+}
+
+// The threads consuming the bucket at the same time consume all its tokens, and no more.
+TEST_F(AtomicTokenBucketImplTest, ConcurrentConsume) {
+  AtomicTokenBucketImpl token_bucket{100000, time_system_, 1};
+  std::atomic<uint64_t> consumed{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&] {
+      uint64_t tokens;
+      while ((tokens = token_bucket.consume(3, true)) > 0) {
+        consumed += tokens;
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, token_bucket.consume(1, true));
+  EXPECT_EQ(100000, consumed.load());
+}
+
+} // namespace Envoy
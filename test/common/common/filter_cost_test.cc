@@ -0,0 +1,78 @@
+#include <chrono>
+
+#include "source/common/common/filter_cost.h"
+
+#include "test/mocks/stats/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+using std::chrono::milliseconds;
+
+// Keeps the thread busy until it used the given CPU time.
+void burnCpu(std::chrono::nanoseconds cpu_time) {
+  const std::chrono::nanoseconds end = FilterCostTimer::threadCpuTime() + cpu_time;
+  while (FilterCostTimer::threadCpuTime() < end) {
+  }
+}
+
+class FilterCostTest : public testing::Test {
+protected:
+  void SetUp() override {
+    if (FilterCostTimer::threadCpuTime() == std::chrono::nanoseconds(0)) {
+      GTEST_SKIP() << "The thread CPU time can't be measured";
+    }
+  }
+
+  testing::NiceMock<Stats::MockHistogram> histogram_;
+};
+
+TEST_F(FilterCostTest, ChargesTheTimeOfEachTimer) {
+  FilterCost cost(histogram_);
+  for (int i = 0; i < 2; i++) {
+    const FilterCostTimer timer(&cost);
+    burnCpu(milliseconds(1));
+  }
+  EXPECT_GE(cost.cpu_time_, milliseconds(2));
+}
+
+TEST_F(FilterCostTest, NestedTimersPauseTheirParent) {
+  FilterCost outer(histogram_);
+  FilterCost inner(histogram_);
+  {
+    const FilterCostTimer outer_timer(&outer);
+    burnCpu(milliseconds(2));
+    {
+      const FilterCostTimer inner_timer(&inner);
+      burnCpu(milliseconds(20));
+    }
+    burnCpu(milliseconds(2));
+  }
+  EXPECT_GE(inner.cpu_time_, milliseconds(20));
+  EXPECT_GE(outer.cpu_time_, milliseconds(4));
+  EXPECT_LT(outer.cpu_time_, milliseconds(20));
+}
+
+TEST_F(FilterCostTest, NullCostMeasuresNothing) {
+  FilterCost outer(histogram_);
+  {
+    const FilterCostTimer outer_timer(&outer);
+    // A timer without a cost does not pause the timer it is nested in.
+    const FilterCostTimer timer(nullptr);
+    burnCpu(milliseconds(1));
+  }
+  EXPECT_GE(outer.cpu_time_, milliseconds(1));
+}
+
+TEST_F(FilterCostTest, RecordsMicroseconds) {
+  FilterCost cost(histogram_);
+  cost.cpu_time_ = std::chrono::microseconds(1500);
+  EXPECT_CALL(histogram_, recordValue(1500));
+  cost.record();
+}
+
+} // namespace
+} // namespace Envoy
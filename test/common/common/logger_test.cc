@@ -1,11 +1,17 @@
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "source/common/common/async_log_writer.h"
 #include "source/common/common/json_escape_string.h"
 #include "source/common/common/logger.h"
 
 #include "test/test_common/environment.h"
+#include "test/test_common/logging.h"
+#include "test/test_common/thread_factory_for_test.h"
 
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -151,5 +157,109 @@ TEST_F(LoggerCustomFlagsTest, LogMessageAsJsonStringEscaped) {
       "\\\"transport: Error while dialing dial tcp [::1]:15012: connect: connection refused\\\"");
 }
 
+class AsyncLogWriterTest : public testing::Test {
+public:
+  AsyncLogWriterTest()
+      : writer_([this](const spdlog::details::log_msg& msg) {
+          absl::MutexLock lock(&mutex_);
+          written_.emplace_back(msg.payload.data(), msg.payload.size());
+        }) {}
+
+  void log(const std::string& payload) {
+    writer_.log(spdlog::details::log_msg("test", spdlog::level::info, payload));
+  }
+
+  std::vector<std::string> written() {
+    absl::MutexLock lock(&mutex_);
+    return written_;
+  }
+
+  absl::Mutex mutex_;
+  std::vector<std::string> written_ ABSL_GUARDED_BY(mutex_);
+  AsyncLogWriter writer_;
+};
+
+TEST_F(AsyncLogWriterTest, WritesMessagesOfEachThreadInOrder) {
+  writer_.start(Thread::threadFactoryForTest());
+
+  const int messages = 2 * AsyncLogWriter::DefaultRingCapacity;
+  std::vector<Thread::ThreadPtr> threads;
+  for (int thread = 0; thread < 2; thread++) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([this, thread]() {
+      for (int i = 0; i < messages; i++) {
+        log(absl::StrCat(thread, " ", i));
+        if (i % 64 == 0) {
+          // Leaves the background thread the time to keep up, so that no message is dropped.
+          writer_.flush();
+        }
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  writer_.flush();
+  EXPECT_EQ(0, writer_.dropped());
+
+  std::vector<int> next(2, 0);
+  for (const std::string& message : written()) {
+    const std::vector<std::string> parts = absl::StrSplit(message, ' ');
+    ASSERT_EQ(2, parts.size());
+    const int thread = std::stoi(parts[0]);
+    EXPECT_EQ(next[thread]++, std::stoi(parts[1]));
+  }
+  EXPECT_EQ(messages, next[0]);
+  EXPECT_EQ(messages, next[1]);
+  writer_.stop();
+}
+
+TEST(AsyncLogWriterDropTest, DropsMessagesOfFullRing) {
+  absl::Mutex mutex;
+  std::vector<std::string> written;
+  AsyncLogWriter writer(
+      [&](const spdlog::details::log_msg& msg) {
+        absl::MutexLock lock(&mutex);
+        written.emplace_back(msg.payload.data(), msg.payload.size());
+      },
+      4);
+
+  // The background thread is not started yet, so the ring of this thread fills up.
+  for (int i = 0; i < 6; i++) {
+    writer.log(spdlog::details::log_msg("test", spdlog::level::info, absl::StrCat(i)));
+  }
+  EXPECT_EQ(2, writer.dropped());
+
+  writer.start(Thread::threadFactoryForTest());
+  writer.flush();
+  {
+    absl::MutexLock lock(&mutex);
+    EXPECT_THAT(written, testing::ElementsAre("0", "1", "2", "3", "dropped 2 log messages"));
+  }
+
+  // Stopping writes the messages buffered since the last flush.
+  writer.log(spdlog::details::log_msg("test", spdlog::level::info, "4"));
+  writer.stop();
+  absl::MutexLock lock(&mutex);
+  EXPECT_EQ("4", written.back());
+}
+
+TEST(AsyncLogSinkTest, WritesFromBackgroundThread) {
+  LogLevelSetter save_levels(spdlog::level::info);
+  LogRecordingSink recording_sink(Registry::getSink());
+  Registry::getSink()->startAsync(Thread::threadFactoryForTest());
+
+  ENVOY_LOG_MISC(info, "async message");
+  Registry::getSink()->flush();
+  Registry::getSink()->stopAsync();
+  EXPECT_EQ(0, Registry::getSink()->asyncDroppedMessages());
+  ASSERT_EQ(1, recording_sink.messages().size());
+  EXPECT_THAT(recording_sink.messages()[0], testing::HasSubstr("async message"));
+
+  // Once stopped, the messages are written from the thread logging them again.
+  ENVOY_LOG_MISC(info, "sync message");
+  ASSERT_EQ(2, recording_sink.messages().size());
+  EXPECT_THAT(recording_sink.messages()[1], testing::HasSubstr("sync message"));
+}
+
 } // namespace Logger
 } // namespace Envoy
@@ -0,0 +1,38 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "source/common/common/random_generator.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Random {
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_Random(benchmark::State& state) {
+  RandomGeneratorImpl random;
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(random.random());
+  }
+}
+BENCHMARK(BM_Random);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_Uuid(benchmark::State& state) {
+  RandomGeneratorImpl random;
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(random.uuid());
+  }
+}
+BENCHMARK(BM_Uuid);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_NonCryptographicUuid(benchmark::State& state) {
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(RandomGeneratorImpl::nonCryptographicUuid());
+  }
+}
+BENCHMARK(BM_NonCryptographicUuid);
+
+} // namespace Random
+} // namespace Envoy
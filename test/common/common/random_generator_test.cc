@@ -3,6 +3,8 @@
 #include "source/common/common/interval_value.h"
 #include "source/common/common/random_generator.h"
 
+#include "test/test_common/thread_factory_for_test.h"
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -68,6 +70,35 @@ TEST(UUID, SanityCheckOfUniqueness) {
   EXPECT_EQ(num_of_uuids, uuids.size());
 }
 
+TEST(UUID, FormatOfUUID) {
+  Random::RandomGeneratorImpl random;
+
+  for (const std::string& uuid : {random.uuid(), RandomGeneratorImpl::nonCryptographicUuid()}) {
+    EXPECT_THAT(uuid, testing::MatchesRegex(
+                          "[0-9a-f]{8}-[0-9a-f]{4}-4[0-9a-f]{3}-[89ab][0-9a-f]{3}-[0-9a-f]{12}"));
+  }
+}
+
+TEST(UUID, SanityCheckOfUniquenessOfNonCryptographicUUID) {
+  std::set<std::string> uuids;
+  const size_t num_of_uuids = 100000;
+
+  for (size_t i = 0; i < num_of_uuids; ++i) {
+    uuids.insert(RandomGeneratorImpl::nonCryptographicUuid());
+  }
+
+  EXPECT_EQ(num_of_uuids, uuids.size());
+}
+
+TEST(UUID, NonCryptographicUUIDsDifferAcrossThreads) {
+  std::string other_thread_uuid;
+  Thread::ThreadPtr thread = Thread::threadFactoryForTest().createThread(
+      [&other_thread_uuid]() { other_thread_uuid = RandomGeneratorImpl::nonCryptographicUuid(); });
+  thread->join();
+
+  EXPECT_NE(other_thread_uuid, RandomGeneratorImpl::nonCryptographicUuid());
+}
+
 TEST(Random, Bernoilli) {
   Random::RandomGeneratorImpl random;
 
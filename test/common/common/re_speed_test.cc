@@ -2,8 +2,14 @@
 // a quiescent system with disabled cstate power management.
 
 #include <regex>
+#include <string>
+#include <vector>
+
+#include "envoy/type/matcher/v3/regex.pb.h"
 
 #include "source/common/common/assert.h"
+#include "source/common/common/fmt.h"
+#include "source/common/common/regex.h"
 
 #include "absl/strings/string_view.h"
 #include "benchmark/benchmark.h"
@@ -126,3 +132,55 @@ static void BM_RE2_AltPattern(benchmark::State& state) {
   RELEASE_ASSERT(passes > 0, "");
 }
 BENCHMARK(BM_RE2_AltPattern);
+
+// The regexes of as many routes as the benchmark argument, of which only the last one matches
+// RoutePath.
+static std::vector<std::string> routeRegexes(int64_t count) {
+  std::vector<std::string> regexes;
+  for (int64_t i = 0; i < count; ++i) {
+    regexes.push_back(fmt::format("/api/v[0-9]+/service{}/[a-z]+/[0-9]+", i));
+  }
+  return regexes;
+}
+
+static const char RoutePath[] = "/api/v1/service{}/users/42";
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_RE2_OneByOne(benchmark::State& state) {
+  std::vector<Envoy::Regex::CompiledMatcherPtr> matchers;
+  for (const std::string& regex : routeRegexes(state.range(0))) {
+    envoy::type::matcher::v3::RegexMatcher config;
+    config.mutable_google_re2();
+    config.set_regex(regex);
+    matchers.push_back(Envoy::Regex::Utility::parseRegex(config));
+  }
+  const std::string path = fmt::format(RoutePath, state.range(0) - 1);
+  uint32_t passes = 0;
+  for (auto _ : state) { // NOLINT
+    for (const Envoy::Regex::CompiledMatcherPtr& matcher : matchers) {
+      if (matcher->match(path)) {
+        ++passes;
+      }
+    }
+  }
+  RELEASE_ASSERT(passes == state.iterations(), "");
+}
+BENCHMARK(BM_RE2_OneByOne)->Arg(10)->Arg(100)->Arg(1000);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_RE2_Set(benchmark::State& state) {
+  Envoy::Regex::CompiledMatcherSetPtr matcher_set =
+      Envoy::Regex::Utility::parseRegexSet(routeRegexes(state.range(0)));
+  RELEASE_ASSERT(matcher_set != nullptr, "");
+  const std::string path = fmt::format(RoutePath, state.range(0) - 1);
+  uint32_t passes = 0;
+  std::vector<uint32_t> matches;
+  for (auto _ : state) { // NOLINT
+    matches.clear();
+    if (matcher_set->match(path, matches) && !matches.empty()) {
+      ++passes;
+    }
+  }
+  RELEASE_ASSERT(passes == state.iterations(), "");
+}
+BENCHMARK(BM_RE2_Set)->Arg(10)->Arg(100)->Arg(1000);
@@ -29,6 +29,23 @@ TEST(Utility, ParseStdRegex) {
   }
 }
 
+TEST(Utility, ParseRegexSet) {
+  const CompiledMatcherSetPtr matcher_set =
+      Utility::parseRegexSet({"/foo/[0-9]+", "/foo/.*", "/bar"});
+  ASSERT_NE(nullptr, matcher_set);
+
+  std::vector<uint32_t> matches;
+  EXPECT_TRUE(matcher_set->match("/foo/42", matches));
+  EXPECT_EQ((std::vector<uint32_t>{0, 1}), matches);
+
+  // The regexes match the whole value.
+  matches.clear();
+  EXPECT_TRUE(matcher_set->match("/bar/baz", matches));
+  EXPECT_TRUE(matches.empty());
+
+  EXPECT_EQ(nullptr, Utility::parseRegexSet({"/foo", "(+invalid)"}));
+}
+
 TEST(Utility, ParseRegex) {
   {
     envoy::type::matcher::v3::RegexMatcher matcher;
@@ -1,5 +1,9 @@
 #include <functional>
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 #include "source/common/common/thread.h"
 #include "source/common/common/thread_synchronizer.h"
 
@@ -246,6 +250,31 @@ TEST_F(ThreadAsyncPtrTest, NameNotSpecifiedWait) {
   thread->join();
 }
 
+#ifdef __linux__
+TEST_F(ThreadAsyncPtrTest, PinToCpu) {
+  cpu_set_t allowed;
+  ASSERT_EQ(0, sched_getaffinity(0, sizeof(allowed), &allowed));
+  uint32_t cpu = 0;
+  while (!CPU_ISSET(cpu, &allowed)) {
+    ++cpu;
+  }
+
+  cpu_set_t affinity;
+  int running_cpu = -1;
+  auto thread = thread_factory_.createThread(
+      [&]() {
+        sched_getaffinity(0, sizeof(affinity), &affinity);
+        running_cpu = sched_getcpu();
+      },
+      Options{"pinned", cpu});
+  thread->join();
+
+  EXPECT_EQ(1, CPU_COUNT(&affinity));
+  EXPECT_TRUE(CPU_ISSET(cpu, &affinity));
+  EXPECT_EQ(static_cast<int>(cpu), running_cpu);
+}
+#endif
+
 } // namespace
 } // namespace Thread
 } // namespace Envoy
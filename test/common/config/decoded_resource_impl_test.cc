@@ -5,6 +5,7 @@
 
 #include "gtest/gtest.h"
 
+using ::testing::_;
 using ::testing::InvokeWithoutArgs;
 using ::testing::Return;
 
@@ -80,6 +81,77 @@ TEST(DecodedResourceImplTest, All) {
   }
 }
 
+// Unchanged resources of an accepted response are reused rather than decoded again.
+TEST(DecodedResourceCacheTest, ReuseAccepted) {
+  MockOpaqueResourceDecoder resource_decoder;
+  DecodedResourceCache cache;
+  ProtobufWkt::Any foo;
+  foo.set_type_url("some_type_url");
+  foo.set_value("foo");
+  ProtobufWkt::Any bar;
+  bar.set_type_url("some_type_url");
+  bar.set_value("bar");
+  auto decode_empty = []() -> ProtobufTypes::MessagePtr {
+    return std::make_unique<ProtobufWkt::Empty>();
+  };
+
+  EXPECT_CALL(resource_decoder, decodeResource(ProtoEq(foo)))
+      .WillOnce(InvokeWithoutArgs(decode_empty));
+  EXPECT_CALL(resource_decoder, resourceName(_)).WillOnce(Return("foo_name"));
+  auto first = cache.decode(resource_decoder, foo, "1");
+  EXPECT_EQ("foo_name", first->name());
+  EXPECT_EQ("1", first->version());
+
+  // The resources of a rejected response are not reused.
+  cache.reject();
+  EXPECT_CALL(resource_decoder, decodeResource(ProtoEq(foo)))
+      .WillOnce(InvokeWithoutArgs(decode_empty));
+  EXPECT_CALL(resource_decoder, resourceName(_)).WillOnce(Return("foo_name"));
+  first = cache.decode(resource_decoder, foo, "1");
+  cache.accept();
+
+  // Only the changed resource is decoded, and the reused one has the new version.
+  EXPECT_CALL(resource_decoder, decodeResource(ProtoEq(bar)))
+      .WillOnce(InvokeWithoutArgs(decode_empty));
+  EXPECT_CALL(resource_decoder, resourceName(_)).WillOnce(Return("bar_name"));
+  auto reused = cache.decode(resource_decoder, foo, "2");
+  auto decoded = cache.decode(resource_decoder, bar, "2");
+  EXPECT_EQ("foo_name", reused->name());
+  EXPECT_EQ("2", reused->version());
+  EXPECT_TRUE(reused->hasResource());
+  EXPECT_EQ(first->sharedResource(), reused->sharedResource());
+  EXPECT_EQ("bar_name", decoded->name());
+  cache.accept();
+
+  // Resources missing from the last accepted response are no longer kept.
+  EXPECT_CALL(resource_decoder, decodeResource(ProtoEq(bar))).Times(0);
+  cache.decode(resource_decoder, bar, "3");
+  cache.accept();
+  EXPECT_CALL(resource_decoder, decodeResource(ProtoEq(foo)))
+      .WillOnce(InvokeWithoutArgs(decode_empty));
+  EXPECT_CALL(resource_decoder, resourceName(_)).WillOnce(Return("foo_name"));
+  cache.decode(resource_decoder, foo, "4");
+}
+
+// Resources wrapped in a Resource are always decoded.
+TEST(DecodedResourceCacheTest, WrappedResourcesDecoded) {
+  MockOpaqueResourceDecoder resource_decoder;
+  DecodedResourceCache cache;
+  envoy::service::discovery::v3::Resource resource_wrapper;
+  resource_wrapper.set_name("real_name");
+  resource_wrapper.mutable_resource()->set_type_url("some_type_url");
+  ProtobufWkt::Any wrapped;
+  wrapped.PackFrom(resource_wrapper);
+
+  EXPECT_CALL(resource_decoder, decodeResource(_))
+      .Times(2)
+      .WillRepeatedly(InvokeWithoutArgs(
+          []() -> ProtobufTypes::MessagePtr { return std::make_unique<ProtobufWkt::Empty>(); }));
+  EXPECT_EQ("real_name", cache.decode(resource_decoder, wrapped, "1")->name());
+  cache.accept();
+  EXPECT_EQ("real_name", cache.decode(resource_decoder, wrapped, "2")->name());
+}
+
 } // namespace
 } // namespace Config
 } // namespace Envoy
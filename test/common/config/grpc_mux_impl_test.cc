@@ -11,6 +11,7 @@
 #include "source/common/config/protobuf_link_hacks.h"
 #include "source/common/config/utility.h"
 #include "source/common/config/version_converter.h"
+#include "source/common/config/xds_resource_cache.h"
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/stats/isolated_store_impl.h"
 
@@ -21,6 +22,8 @@
 #include "test/mocks/grpc/mocks.h"
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/file_system_for_test.h"
 #include "test/test_common/logging.h"
 #include "test/test_common/resources.h"
 #include "test/test_common/simulated_time_system.h"
@@ -73,6 +76,15 @@ public:
         true);
   }
 
+  void setup(XdsResourceCachePtr resource_cache) {
+    grpc_mux_ = std::make_unique<GrpcMuxImpl>(
+        local_info_, std::unique_ptr<Grpc::MockAsyncClient>(async_client_), dispatcher_,
+        *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
+            "envoy.service.discovery.v2.AggregatedDiscoveryService.StreamAggregatedResources"),
+        envoy::config::core::v3::ApiVersion::AUTO, random_, stats_, rate_limit_settings_, true,
+        std::move(resource_cache));
+  }
+
   void expectSendMessage(const std::string& type_url,
                          const std::vector<std::string>& resource_names, const std::string& version,
                          bool first = false, const std::string& nonce = "",
@@ -525,6 +537,76 @@ TEST_F(GrpcMuxImplTest, WildcardWatch) {
   }
 }
 
+// Validate that watches are warmed from the cached resources of their type until the first
+// response, which is cached in turn.
+TEST_F(GrpcMuxImplTest, WarmFromResourceCache) {
+  const std::string directory = TestEnvironment::temporaryPath("grpc_mux_resource_cache");
+  TestEnvironment::removePath(directory);
+  TestEnvironment::createPath(directory);
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  envoy::service::discovery::v3::DiscoveryResponse cached_response;
+  cached_response.set_type_url(type_url);
+  cached_response.set_version_info("1");
+  envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+  load_assignment.set_cluster_name("x");
+  cached_response.add_resources()->PackFrom(load_assignment);
+  load_assignment.set_cluster_name("y");
+  cached_response.add_resources()->PackFrom(load_assignment);
+  XdsResourceCache(Filesystem::fileSystemForTest(), directory).store(cached_response);
+
+  setup(std::make_unique<XdsResourceCache>(Filesystem::fileSystemForTest(), directory));
+  InSequence s;
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      resource_decoder("cluster_name");
+  NiceMock<MockSubscriptionCallbacks> x_callbacks;
+  NiceMock<MockSubscriptionCallbacks> y_callbacks;
+  auto* warm_timer = new Event::MockTimer(&dispatcher_);
+  // The TTL timer is created first, with the state of the type.
+  new Event::MockTimer(&dispatcher_);
+  EXPECT_CALL(*warm_timer, enableTimer(std::chrono::milliseconds(0), _));
+  auto x_sub = grpc_mux_->addWatch(type_url, {"x"}, x_callbacks, resource_decoder, {});
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  // The cached version is not requested, so that the first response has all the resources.
+  expectSendMessage(type_url, {"x"}, "", true);
+  grpc_mux_->start();
+
+  EXPECT_CALL(x_callbacks, onConfigUpdate(_, "1"))
+      .WillOnce(Invoke([](const std::vector<DecodedResourceRef>& resources, const std::string&) {
+        ASSERT_EQ(1, resources.size());
+        EXPECT_EQ("x", resources[0].get().name());
+      }));
+  warm_timer->invokeCallback();
+
+  // A later watch is warmed without warming the earlier one again.
+  EXPECT_CALL(*warm_timer, enableTimer(std::chrono::milliseconds(0), _));
+  expectSendMessage(type_url, {"y", "x"}, "");
+  auto y_sub = grpc_mux_->addWatch(type_url, {"y"}, y_callbacks, resource_decoder, {});
+  EXPECT_CALL(y_callbacks, onConfigUpdate(_, "1"));
+  warm_timer->invokeCallback();
+
+  auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+  response->set_type_url(type_url);
+  response->set_version_info("2");
+  load_assignment.set_cluster_name("x");
+  response->add_resources()->PackFrom(load_assignment);
+  EXPECT_CALL(y_callbacks, onConfigUpdate(_, _)).Times(0);
+  EXPECT_CALL(x_callbacks, onConfigUpdate(_, "2"));
+  expectSendMessage(type_url, {"y", "x"}, "2");
+  grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+
+  // The response is cached, and watches are no longer warmed.
+  auto stored = XdsResourceCache(Filesystem::fileSystemForTest(), directory).load(type_url);
+  ASSERT_NE(nullptr, stored);
+  EXPECT_EQ("2", stored->version_info());
+  expectSendMessage(type_url, {"z", "y", "x"}, "2");
+  auto z_sub = grpc_mux_->addWatch(type_url, {"z"}, callbacks_, resource_decoder, {});
+
+  expectSendMessage(type_url, {"y", "x"}, "2");
+  expectSendMessage(type_url, {"x"}, "2");
+  expectSendMessage(type_url, {}, "2");
+  TestEnvironment::removePath(directory);
+}
+
 // Validate behavior when watches specify resources (potentially overlapping).
 TEST_F(GrpcMuxImplTest, WatchDemux) {
   setup();
@@ -57,7 +57,7 @@ public:
         *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
             "envoy.service.discovery.v2.AggregatedDiscoveryService.StreamAggregatedResources"),
         envoy::config::core::v3::ApiVersion::AUTO, random_, stats_, rate_limit_settings_,
-        local_info_);
+        local_info_, update_coalescing_window_);
   }
 
   void expectSendMessage(const std::string& type_url,
@@ -99,6 +99,7 @@ public:
       resource_decoder_{"cluster_name"};
   Stats::TestUtil::TestStore stats_;
   Envoy::Config::RateLimitSettings rate_limit_settings_;
+  std::chrono::milliseconds update_coalescing_window_{0};
   ControlPlaneStats control_plane_stats_;
   Stats::Gauge& control_plane_connected_state_;
 };
@@ -178,6 +179,81 @@ TEST_F(NewGrpcMuxImplTest, ReconnectionResetsNonceAndAcks) {
   expectSendMessage(type_url, {}, {"x", "y"});
 }
 
+// Validate that responses received within the coalescing window are merged and applied once at
+// its end, keeping the latest update of each resource.
+TEST_F(NewGrpcMuxImplTest, CoalesceUpdates) {
+  // Timers are created for the gRPC stream retry, the TTL and then the coalescing window.
+  Event::MockTimer* coalescing_timer = new Event::MockTimer(&dispatcher_);
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  update_coalescing_window_ = std::chrono::milliseconds(100);
+  setup();
+
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  auto watch = grpc_mux_->addWatch(type_url, {"x", "y", "z"}, callbacks_, resource_decoder_, {});
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  EXPECT_CALL(async_stream_, sendMessageRaw_(_, false));
+  grpc_mux_->start();
+
+  auto add_resource = [](const std::string& name,
+                         envoy::service::discovery::v3::DeltaDiscoveryResponse& response) {
+    envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+    load_assignment.set_cluster_name(name);
+    auto* resource = response.add_resources();
+    resource->set_name(name);
+    resource->set_version(response.system_version_info());
+    resource->mutable_resource()->PackFrom(load_assignment);
+  };
+  auto response = [&type_url](const std::string& version, const std::string& nonce) {
+    auto response = std::make_unique<envoy::service::discovery::v3::DeltaDiscoveryResponse>();
+    response->set_type_url(type_url);
+    response->set_system_version_info(version);
+    response->set_nonce(nonce);
+    return response;
+  };
+
+  // The first response is applied immediately and opens a window.
+  auto first = response("1", "a");
+  add_resource("x", *first);
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, _, "1"));
+  expectSendMessage(type_url, {}, {}, "a");
+  grpc_mux_->onDiscoveryResponse(std::move(first), control_plane_stats_);
+  EXPECT_TRUE(coalescing_timer->enabled());
+
+  // The responses within the window are held.
+  auto second = response("2", "b");
+  add_resource("x", *second);
+  add_resource("y", *second);
+  auto third = response("3", "c");
+  third->add_removed_resources("y");
+  add_resource("z", *third);
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, _, _)).Times(0);
+  grpc_mux_->onDiscoveryResponse(std::move(second), control_plane_stats_);
+  grpc_mux_->onDiscoveryResponse(std::move(third), control_plane_stats_);
+  EXPECT_EQ(1, stats_.counter("control_plane.update_coalesced").value());
+
+  // The merged response is applied and ACKed with the latest nonce at the end of the window.
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, _, "3"))
+      .WillOnce(Invoke([](const std::vector<DecodedResourceRef>& added_resources,
+                          const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+                          const std::string&) {
+        ASSERT_EQ(2, added_resources.size());
+        EXPECT_EQ("x", added_resources[0].get().name());
+        EXPECT_EQ("2", added_resources[0].get().version());
+        EXPECT_EQ("z", added_resources[1].get().name());
+        ASSERT_EQ(1, removed_resources.size());
+        EXPECT_EQ("y", removed_resources[0]);
+      }));
+  expectSendMessage(type_url, {}, {}, "c");
+  coalescing_timer->invokeCallback();
+  EXPECT_TRUE(coalescing_timer->enabled());
+
+  // A window without responses applies nothing.
+  coalescing_timer->invokeCallback();
+
+  EXPECT_CALL(async_stream_, sendMessageRaw_(_, false));
+}
+
 // Validate resources are not sent on wildcard watch reconnection.
 // Regression test of https://github.com/envoyproxy/envoy/issues/16063.
 TEST_F(NewGrpcMuxImplTest, ReconnectionResetsWildcardSubscription) {
@@ -0,0 +1,85 @@
+#include <string>
+
+#include "envoy/config/endpoint/v3/endpoint.pb.h"
+#include "envoy/service/discovery/v3/discovery.pb.h"
+
+#include "source/common/config/xds_resource_cache.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/file_system_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Config {
+namespace {
+
+class XdsResourceCacheTest : public testing::Test {
+protected:
+  XdsResourceCacheTest()
+      : directory_(TestEnvironment::temporaryPath("xds_resource_cache_test")),
+        cache_(Filesystem::fileSystemForTest(), directory_) {
+    TestEnvironment::removePath(directory_);
+    TestEnvironment::createPath(directory_);
+  }
+
+  ~XdsResourceCacheTest() override { TestEnvironment::removePath(directory_); }
+
+  envoy::service::discovery::v3::DiscoveryResponse response(const std::string& version,
+                                                            uint32_t resources) {
+    envoy::service::discovery::v3::DiscoveryResponse response;
+    response.set_type_url(type_url_);
+    response.set_version_info(version);
+    for (uint32_t i = 0; i < resources; ++i) {
+      envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+      load_assignment.set_cluster_name(absl::StrCat("cluster_", i));
+      response.add_resources()->PackFrom(load_assignment);
+    }
+    return response;
+  }
+
+  const std::string type_url_{"type.googleapis.com/envoy.config.endpoint.v3.ClusterLoadAssignment"};
+  const std::string directory_;
+  XdsResourceCache cache_;
+};
+
+TEST_F(XdsResourceCacheTest, Missing) { EXPECT_EQ(nullptr, cache_.load(type_url_)); }
+
+TEST_F(XdsResourceCacheTest, StoreAndLoad) {
+  const auto first = response("1", 3);
+  cache_.store(first);
+  EXPECT_TRUE(Filesystem::fileSystemForTest().fileExists(absl::StrCat(
+      directory_, "/type.googleapis.com_envoy.config.endpoint.v3.ClusterLoadAssignment")));
+  auto loaded = cache_.load(type_url_);
+  ASSERT_NE(nullptr, loaded);
+  EXPECT_TRUE(TestUtility::protoEqual(first, *loaded));
+
+  // A smaller response replaces the previous one entirely.
+  const auto second = response("2", 1);
+  cache_.store(second);
+  loaded = cache_.load(type_url_);
+  ASSERT_NE(nullptr, loaded);
+  EXPECT_TRUE(TestUtility::protoEqual(second, *loaded));
+
+  // Each type URL has its own file.
+  EXPECT_EQ(nullptr, cache_.load("type.googleapis.com/envoy.config.cluster.v3.Cluster"));
+}
+
+TEST_F(XdsResourceCacheTest, Invalid) {
+  TestEnvironment::writeStringToFileForTest(
+      absl::StrCat(directory_,
+                   "/type.googleapis.com_envoy.config.endpoint.v3.ClusterLoadAssignment"),
+      "not a DiscoveryResponse", true);
+  EXPECT_EQ(nullptr, cache_.load(type_url_));
+}
+
+TEST_F(XdsResourceCacheTest, MissingDirectory) {
+  TestEnvironment::removePath(directory_);
+  cache_.store(response("1", 1));
+  EXPECT_EQ(nullptr, cache_.load(type_url_));
+}
+
+} // namespace
+} // namespace Config
+} // namespace Envoy
@@ -4,6 +4,7 @@
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/upstream/cluster_info.h"
 #include "test/mocks/upstream/host.h"
+#include "test/test_common/simulated_time_system.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -15,6 +16,7 @@ using testing::AnyNumber;
 using testing::HasSubstr;
 using testing::Invoke;
 using testing::InvokeWithoutArgs;
+using testing::Ref;
 using testing::Return;
 
 class TestActiveClient : public ActiveClient {
@@ -29,10 +31,20 @@ public:
   uint32_t active_streams_{};
 };
 
+// A context carrying the options its stream is queued with.
+struct TestAttachContext : public AttachContext {
+  PendingStreamOptions options_;
+};
+
+PendingStreamOptions testPendingStreamOptions(AttachContext& context) {
+  auto* test_context = dynamic_cast<TestAttachContext*>(&context);
+  return test_context != nullptr ? test_context->options_ : PendingStreamOptions();
+}
+
 class TestPendingStream : public PendingStream {
 public:
   TestPendingStream(ConnPoolImplBase& parent, AttachContext& context)
-      : PendingStream(parent), context_(context) {}
+      : PendingStream(parent, testPendingStreamOptions(context)), context_(context) {}
   AttachContext& context() override { return context_; }
   AttachContext& context_;
 };
@@ -44,6 +56,9 @@ public:
     auto entry = std::make_unique<TestPendingStream>(*this, context);
     return addPendingStream(std::move(entry));
   }
+  PendingStreamOptions pendingStreamOptions(AttachContext& context) override {
+    return testPendingStreamOptions(context);
+  }
   MOCK_METHOD(ActiveClientPtr, instantiateActiveClient, ());
   MOCK_METHOD(void, onPoolFailure,
               (const Upstream::HostDescriptionConstSharedPtr& n, absl::string_view,
@@ -202,6 +217,40 @@ TEST_F(ConnPoolImplBaseTest, ExplicitPreconnectNotHealthy) {
   EXPECT_FALSE(pool_.maybePreconnect(1));
 }
 
+TEST_F(ConnPoolImplBaseTest, WarmUp) {
+  EXPECT_CALL(dispatcher_, createTimer_(_)).Times(AnyNumber());
+  testing::MockFunction<void()> warm_up_callback;
+
+  // Connections are created regardless of the load, and the callback waits for all of them.
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(3);
+  pool_.warmUp(3, warm_up_callback.AsStdFunction());
+  CHECK_STATE(0 /*active*/, 0 /*pending*/, 3 /*connecting capacity*/);
+  EXPECT_EQ(3, cluster_->stats_.upstream_cx_warm_up_.value());
+  clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+  clients_[1]->onEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(warm_up_callback, Call());
+  clients_[2]->onEvent(Network::ConnectionEvent::Connected);
+
+  // A warm pool calls back right away.
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(0);
+  EXPECT_CALL(warm_up_callback, Call());
+  pool_.warmUp(2, warm_up_callback.AsStdFunction());
+  pool_.destructAllConnections();
+}
+
+TEST_F(ConnPoolImplBaseTest, WarmUpWithinCircuitBreaker) {
+  cluster_->resetResourceManager(1, 1024, 1024, 1, 1);
+  testing::MockFunction<void()> warm_up_callback;
+
+  EXPECT_CALL(pool_, instantiateActiveClient);
+  pool_.warmUp(3, warm_up_callback.AsStdFunction());
+  EXPECT_EQ(1, cluster_->stats_.upstream_cx_warm_up_.value());
+  EXPECT_EQ(0, cluster_->stats_.upstream_cx_overflow_.value());
+  EXPECT_CALL(warm_up_callback, Call());
+  clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+  pool_.destructAllConnections();
+}
+
 // Remote close simulates the peer closing the connection.
 TEST_F(ConnPoolImplBaseTest, PoolIdleCallbackTriggeredRemoteClose) {
   EXPECT_CALL(dispatcher_, createTimer_(_)).Times(AnyNumber());
@@ -258,5 +307,174 @@ TEST_F(ConnPoolImplBaseTest, PoolIdleCallbackTriggeredLocalClose) {
   pool_.startDrainImpl();
 }
 
+class PendingStreamQueueTest : public Event::TestUsingSimulatedTime, public ConnPoolImplBaseTest {
+public:
+  PendingStreamQueueTest() {
+    low_.options_.queue_priority_ = 0;
+    high_.options_.queue_priority_ = 1;
+    other_low_.options_.queue_priority_ = 0;
+  }
+
+  TestAttachContext low_;
+  TestAttachContext high_;
+  TestAttachContext other_low_;
+};
+
+// The pending streams of higher priority are served first, and each priority in order.
+TEST_F(PendingStreamQueueTest, ServesHigherPriorityFirst) {
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(3);
+  pool_.newStream(low_);
+  pool_.newStream(high_);
+  pool_.newStream(other_low_);
+  CHECK_STATE(0 /*active*/, 3 /*pending*/, 3 /*connecting capacity*/);
+
+  testing::InSequence s;
+  EXPECT_CALL(pool_, onPoolReady(_, Ref(high_)));
+  clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+  EXPECT_CALL(pool_, onPoolReady(_, Ref(low_)));
+  clients_[1]->onEvent(Network::ConnectionEvent::Connected);
+  EXPECT_CALL(pool_, onPoolReady(_, Ref(other_low_)));
+  clients_[2]->onEvent(Network::ConnectionEvent::Connected);
+  CHECK_STATE(3 /*active*/, 0 /*pending*/, 0 /*connecting capacity*/);
+  pool_.destructAllConnections();
+}
+
+// Once the queue is full, a stream displaces the most recently queued stream of lower priority,
+// but not one of its own priority.
+TEST_F(PendingStreamQueueTest, DisplacesLowerPriorityWhenFull) {
+  cluster_->resetResourceManager(1024, 2, 1024, 1, 1);
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(2);
+  pool_.newStream(low_);
+  pool_.newStream(other_low_);
+
+  EXPECT_CALL(pool_, onPoolFailure(_, _, PoolFailureReason::Overflow, Ref(other_low_)));
+  EXPECT_NE(nullptr, pool_.newStream(high_));
+  CHECK_STATE(0 /*active*/, 2 /*pending*/, 2 /*connecting capacity*/);
+  EXPECT_EQ(1, cluster_->stats_.upstream_rq_pending_displaced_.value());
+
+  TestAttachContext other_high;
+  other_high.options_.queue_priority_ = 1;
+  EXPECT_CALL(pool_, onPoolFailure(_, _, PoolFailureReason::Overflow, Ref(low_)));
+  EXPECT_NE(nullptr, pool_.newStream(other_high));
+  EXPECT_CALL(pool_, onPoolFailure(_, _, PoolFailureReason::Overflow, Ref(other_low_)));
+  EXPECT_EQ(nullptr, pool_.newStream(other_low_));
+  EXPECT_EQ(2, cluster_->stats_.upstream_rq_pending_displaced_.value());
+  EXPECT_EQ(1, cluster_->stats_.upstream_rq_pending_overflow_.value());
+
+  EXPECT_CALL(pool_, onPoolFailure).Times(2);
+  pool_.destructAllConnections();
+}
+
+// The streams past their deadline are failed rather than served.
+TEST_F(PendingStreamQueueTest, FailsExpiredStreams) {
+  low_.options_.deadline_ = simTime().monotonicTime() + std::chrono::milliseconds(10);
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(2);
+  pool_.newStream(low_);
+  pool_.newStream(other_low_);
+
+  simTime().advanceTimeWait(std::chrono::milliseconds(10));
+  testing::InSequence s;
+  EXPECT_CALL(pool_, onPoolFailure(_, _, PoolFailureReason::Overflow, Ref(low_)));
+  EXPECT_CALL(pool_, onPoolReady(_, Ref(other_low_)));
+  clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+  CHECK_STATE(1 /*active*/, 0 /*pending*/, 1 /*connecting capacity*/);
+  EXPECT_EQ(1, cluster_->stats_.upstream_rq_pending_deadline_exceeded_.value());
+  pool_.destructAllConnections();
+}
+
+// Once the queue is full, a stream past its deadline makes room whatever its priority.
+TEST_F(PendingStreamQueueTest, ExpiredStreamMakesRoomWhenFull) {
+  cluster_->resetResourceManager(1024, 1, 1024, 1, 1);
+  high_.options_.deadline_ = simTime().monotonicTime() + std::chrono::milliseconds(10);
+  EXPECT_CALL(pool_, instantiateActiveClient);
+  pool_.newStream(high_);
+
+  simTime().advanceTimeWait(std::chrono::milliseconds(10));
+  EXPECT_CALL(pool_, onPoolFailure(_, _, PoolFailureReason::Overflow, Ref(high_)));
+  EXPECT_NE(nullptr, pool_.newStream(low_));
+  CHECK_STATE(0 /*active*/, 1 /*pending*/, 1 /*connecting capacity*/);
+  EXPECT_EQ(1, cluster_->stats_.upstream_rq_pending_deadline_exceeded_.value());
+  EXPECT_EQ(0, cluster_->stats_.upstream_rq_pending_overflow_.value());
+
+  EXPECT_CALL(pool_, onPoolFailure);
+  pool_.destructAllConnections();
+}
+
+TEST(AdaptivePreconnectEstimatorTest, ExpectedStreams) {
+  AdaptivePreconnectEstimator estimator(std::chrono::seconds(1));
+  MonotonicTime now;
+  // No connect latency has been observed yet, so no streams are anticipated.
+  estimator.onNewStream(now);
+  EXPECT_EQ(0, estimator.expectedStreams(now));
+
+  // A steady 100 streams per second with a connect latency of 50ms.
+  for (int i = 0; i < 1000; ++i) {
+    now += std::chrono::milliseconds(10);
+    estimator.onNewStream(now);
+  }
+  estimator.onConnected(std::chrono::milliseconds(50));
+  EXPECT_EQ(5, estimator.expectedStreams(now));
+
+  // Connect latency is smoothed.
+  estimator.onConnected(std::chrono::milliseconds(150));
+  EXPECT_EQ(8, estimator.expectedStreams(now));
+
+  // The rate decays once streams stop arriving.
+  now += std::chrono::seconds(10);
+  EXPECT_EQ(0, estimator.expectedStreams(now));
+}
+
+class AdaptivePreconnectTest : public Event::TestUsingSimulatedTime, public ConnPoolImplBaseTest {
+public:
+  AdaptivePreconnectTest() {
+    ON_CALL(*cluster_, adaptivePreconnectWindow)
+        .WillByDefault(Return(std::chrono::milliseconds(10)));
+    ON_CALL(dispatcher_, approximateMonotonicTime).WillByDefault(Invoke([this]() {
+      return simTime().monotonicTime();
+    }));
+    new NiceMock<Event::MockSchedulableCallback>(&dispatcher_);
+    adaptive_pool_ = std::make_unique<TestConnPoolImplBase>(
+        host_, Upstream::ResourcePriority::Default, dispatcher_, nullptr, nullptr, state_);
+    ON_CALL(*adaptive_pool_, instantiateActiveClient)
+        .WillByDefault(Invoke([&]() -> ActiveClientPtr {
+          auto ret = std::make_unique<NiceMock<TestActiveClient>>(*adaptive_pool_, stream_limit_,
+                                                                  concurrent_streams_);
+          clients_.push_back(ret.get());
+          ret->real_host_description_ = descr_;
+          return ret;
+        }));
+    ON_CALL(*adaptive_pool_, onPoolReady(_, _))
+        .WillByDefault(Invoke([](ActiveClient& client, AttachContext&) -> void {
+          ++(reinterpret_cast<TestActiveClient*>(&client)->active_streams_);
+        }));
+  }
+
+  std::unique_ptr<TestConnPoolImplBase> adaptive_pool_;
+};
+
+TEST_F(AdaptivePreconnectTest, PreconnectsForExpectedArrivals) {
+  EXPECT_CALL(dispatcher_, createTimer_(_)).Times(AnyNumber());
+
+  // With no connect latency observed, only the stream itself gets a connection.
+  EXPECT_CALL(*adaptive_pool_, instantiateActiveClient);
+  adaptive_pool_->newStream(context_);
+  ASSERT_EQ(1, clients_.size());
+
+  simTime().advanceTimeWait(std::chrono::milliseconds(50));
+  EXPECT_CALL(*adaptive_pool_, onPoolReady);
+  clients_.back()->onEvent(Network::ConnectionEvent::Connected);
+
+  // Streams arrive at about 100 per second and connecting takes 50ms, so 5 more streams are
+  // expected. Preconnecting is capped at 3 connections per new stream.
+  EXPECT_CALL(*adaptive_pool_, instantiateActiveClient).Times(3);
+  adaptive_pool_->newStream(context_);
+  EXPECT_EQ(4, clients_.size());
+
+  // The two connections beyond the pending stream are closed before ever serving a stream.
+  EXPECT_CALL(*adaptive_pool_, onPoolFailure);
+  adaptive_pool_->destructAllConnections();
+  EXPECT_EQ(2, cluster_->stats_.upstream_cx_preconnect_unused_.value());
+}
+
 } // namespace ConnectionPool
 } // namespace Envoy
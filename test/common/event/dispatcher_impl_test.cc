@@ -1,4 +1,5 @@
 #include <functional>
+#include <map>
 
 #include "envoy/common/scope_tracker.h"
 #include "envoy/thread/thread.h"
@@ -280,6 +281,62 @@ TEST(DeferredDeleteTest, DeferredDelete) {
   dispatcher->clearDeferredDeleteList();
 }
 
+TEST(DeferredDeleteTest, DeferredDeleteIsSpreadOverLoopIterations) {
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher(api->allocateDispatcher("test_thread"));
+  const size_t num_to_delete = 3 * MaxDeferredDeletesPerPass + 1;
+  size_t num_deleted = 0;
+  uint32_t iteration = 0;
+  std::map<uint32_t, size_t> deleted_per_iteration;
+
+  // Counts the event loop iterations until everything has been deleted.
+  SchedulableCallbackPtr counter;
+  counter = dispatcher->createSchedulableCallback([&]() {
+    ++iteration;
+    if (num_deleted < num_to_delete) {
+      counter->scheduleCallbackNextIteration();
+    }
+  });
+  counter->scheduleCallbackNextIteration();
+  for (size_t i = 0; i < num_to_delete; i++) {
+    dispatcher->deferredDelete(std::make_unique<TestDeferredDeletable>([&]() -> void {
+      ++num_deleted;
+      ++deleted_per_iteration[iteration];
+    }));
+  }
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+
+  EXPECT_EQ(num_to_delete, num_deleted);
+  EXPECT_LE(2, deleted_per_iteration.size());
+  // The order of the counter and of the deferred deletion callback in an iteration is not defined,
+  // so an iteration count can see the passes of two iterations.
+  for (const auto& [counted_iteration, deleted] : deleted_per_iteration) {
+    EXPECT_LE(deleted, 2 * MaxDeferredDeletesPerPass) << "iteration " << counted_iteration;
+  }
+}
+
+TEST(DeferredDeleteTest, ClearDeferredDeleteListDestroysLeftovers) {
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher(api->allocateDispatcher("test_thread"));
+  const size_t num_to_delete = MaxDeferredDeletesPerPass + 1;
+  size_t num_deleted = 0;
+  for (size_t i = 0; i < num_to_delete; i++) {
+    dispatcher->deferredDelete(
+        std::make_unique<TestDeferredDeletable>([&]() -> void { ++num_deleted; }));
+  }
+
+  // The post runs after a bounded pass, and leaves the rest to clearDeferredDeleteList().
+  dispatcher->post([&]() {
+    EXPECT_EQ(MaxDeferredDeletesPerPass, num_deleted);
+    dispatcher->deferredDelete(
+        std::make_unique<TestDeferredDeletable>([&]() -> void { ++num_deleted; }));
+    dispatcher->clearDeferredDeleteList();
+    EXPECT_EQ(num_to_delete + 1, num_deleted);
+  });
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(num_to_delete + 1, num_deleted);
+}
+
 TEST(DeferredTaskTest, DeferredTask) {
   InSequence s;
   Api::ApiPtr api = Api::createApiForTest();
@@ -386,9 +443,49 @@ TEST_F(DispatcherImplTest, InitializeStats) {
               histogram("test.dispatcher.loop_duration_us", Stats::Histogram::Unit::Microseconds));
   EXPECT_CALL(scope_,
               histogram("test.dispatcher.poll_delay_us", Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.file_event_duration_us",
+                                Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_,
+              histogram("test.dispatcher.timer_duration_us", Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.schedulable_callback_duration_us",
+                                Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.post_callback_duration_us",
+                                Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.deferred_delete_duration_us",
+                                Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.deferred_delete_queue_size",
+                                Stats::Histogram::Unit::Unspecified));
+  EXPECT_CALL(scope_,
+              histogram("test.dispatcher.events_per_loop", Stats::Histogram::Unit::Unspecified));
+  EXPECT_CALL(scope_,
+              histogram("test.dispatcher.post_batch_size", Stats::Histogram::Unit::Unspecified));
   dispatcher_->initializeStats(scope_, "test.");
 }
 
+TEST(DispatcherStatsTest, RecordsCallbacks) {
+  NiceMock<Stats::MockStore> store;
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher(api->allocateDispatcher("test_thread"));
+  dispatcher->initializeStats(store, "test.");
+  // Runs the post that creates the stats.
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+
+  auto histogram = [](const std::string& name) {
+    return testing::Property(&Stats::Metric::name, "test.dispatcher." + name);
+  };
+  EXPECT_CALL(store, deliverHistogramToSinks(_, _)).Times(testing::AnyNumber());
+  EXPECT_CALL(store, deliverHistogramToSinks(histogram("post_callback_duration_us"), _)).Times(2);
+  EXPECT_CALL(store, deliverHistogramToSinks(histogram("post_batch_size"), 2));
+  EXPECT_CALL(store, deliverHistogramToSinks(histogram("deferred_delete_duration_us"), _));
+  EXPECT_CALL(store, deliverHistogramToSinks(histogram("events_per_loop"), _))
+      .Times(testing::AtLeast(1));
+
+  dispatcher->post([]() {});
+  dispatcher->post([]() {});
+  dispatcher->deferredDelete(std::make_unique<TestDeferredDeletable>([]() {}));
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+}
+
 TEST_F(DispatcherImplTest, Post) {
   dispatcher_->post([this]() {
     {
@@ -405,6 +502,29 @@ TEST_F(DispatcherImplTest, Post) {
   }
 }
 
+TEST_F(DispatcherImplTest, PostBatch) {
+  std::vector<int> order;
+  std::vector<std::function<void()>> callbacks;
+  for (int i = 0; i < 3; i++) {
+    callbacks.push_back([&order, i]() { order.push_back(i); });
+  }
+  callbacks.push_back([this]() {
+    {
+      Thread::LockGuard lock(mu_);
+      ASSERT(!work_finished_);
+      work_finished_ = true;
+    }
+    cv_.notifyOne();
+  });
+  dispatcher_->postBatch(std::move(callbacks));
+
+  Thread::LockGuard lock(mu_);
+  while (!work_finished_) {
+    cv_.wait(mu_);
+  }
+  EXPECT_EQ((std::vector<int>{0, 1, 2}), order);
+}
+
 TEST_F(DispatcherImplTest, PostExecuteAndDestructOrder) {
   ReadyWatcher parent_watcher;
   ReadyWatcher deferred_delete_watcher;
@@ -468,8 +588,8 @@ TEST_F(DispatcherImplTest, RunPostCallbacksLocking) {
     // Block dispatcher first to ensure that both posted events below are handled
     // by a single call to runPostCallbacks().
     //
-    // This also ensures that the post_lock_ is not held while callbacks are called,
-    // or else this would deadlock.
+    // This also ensures that no lock is held while callbacks are called, or else this would
+    // deadlock.
     Thread::LockGuard lock(mu_);
     dispatcher_->post([this]() { Thread::LockGuard lock(mu_); });
 
@@ -0,0 +1,95 @@
+// Compares PostCallbackQueue with the mutex protected std::list that Dispatcher::post() used
+// before, with many producer threads posting to a single consumer, as the main thread does when it
+// fans out cluster updates to all workers.
+
+#include <functional>
+#include <list>
+
+#include "source/common/common/thread.h"
+#include "source/common/event/post_callback_queue.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Event {
+
+class MutexPostQueue {
+public:
+  bool push(std::function<void()> callback) {
+    Thread::LockGuard lock(lock_);
+    const bool was_empty = callbacks_.empty();
+    callbacks_.push_back(std::move(callback));
+    return was_empty;
+  }
+
+  size_t runAll() {
+    std::list<std::function<void()>> callbacks;
+    {
+      Thread::LockGuard lock(lock_);
+      callbacks = std::move(callbacks_);
+    }
+    size_t ran = 0;
+    while (!callbacks.empty()) {
+      callbacks.front()();
+      callbacks.pop_front();
+      ran++;
+    }
+    return ran;
+  }
+
+private:
+  Thread::MutexBasicLockable lock_;
+  std::list<std::function<void()>> callbacks_ ABSL_GUARDED_BY(lock_);
+};
+
+class LockFreePostQueue {
+public:
+  bool push(std::function<void()> callback) { return queue_.push(std::move(callback)); }
+
+  size_t runAll() {
+    PostCallbackQueue::Batch callbacks = queue_.popAll();
+    size_t ran = 0;
+    while (!callbacks.empty()) {
+      callbacks.front()();
+      callbacks.popFront();
+      ran++;
+    }
+    return ran;
+  }
+
+private:
+  PostCallbackQueue queue_;
+};
+
+// Thread 0 is the consumer and drains the queue once per iteration; every other thread posts one
+// callback per iteration. items_per_second is the aggregate posting rate.
+template <class Queue> static void postCallbacks(benchmark::State& state) {
+  static Queue* queue = new Queue();
+  if (state.thread_index == 0) {
+    // Drop anything left over from the previous run.
+    queue->runAll();
+    for (auto _ : state) { // NOLINT
+      benchmark::DoNotOptimize(queue->runAll());
+    }
+  } else {
+    uint64_t counter = 0;
+    for (auto _ : state) { // NOLINT
+      // The consumer may run the callback after this thread is done, so capture by value.
+      queue->push([value = counter++] { benchmark::DoNotOptimize(value); });
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+}
+BENCHMARK_TEMPLATE(postCallbacks, MutexPostQueue)
+    ->Threads(2)
+    ->Threads(9)
+    ->Threads(33)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(postCallbacks, LockFreePostQueue)
+    ->Threads(2)
+    ->Threads(9)
+    ->Threads(33)
+    ->UseRealTime();
+
+} // namespace Event
+} // namespace Envoy
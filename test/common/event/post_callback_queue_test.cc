@@ -0,0 +1,111 @@
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "source/common/event/post_callback_queue.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+TEST(PostCallbackQueueTest, PushReportsEmpty) {
+  PostCallbackQueue queue;
+  EXPECT_TRUE(queue.push([] {}));
+  EXPECT_FALSE(queue.push([] {}));
+  EXPECT_EQ(2, queue.size());
+
+  queue.popAll();
+  EXPECT_EQ(0, queue.size());
+  EXPECT_TRUE(queue.push([] {}));
+}
+
+TEST(PostCallbackQueueTest, PopAllIsFifo) {
+  PostCallbackQueue queue;
+  std::vector<int> order;
+  queue.push([&order] { order.push_back(1); });
+  std::vector<std::function<void()>> batch;
+  batch.push_back([&order] { order.push_back(2); });
+  batch.push_back([&order] { order.push_back(3); });
+  EXPECT_FALSE(queue.push(std::move(batch)));
+  queue.push([&order] { order.push_back(4); });
+
+  PostCallbackQueue::Batch callbacks = queue.popAll();
+  while (!callbacks.empty()) {
+    callbacks.front()();
+    callbacks.popFront();
+  }
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 4}), order);
+}
+
+TEST(PostCallbackQueueTest, EmptyBatch) {
+  PostCallbackQueue queue;
+  EXPECT_FALSE(queue.push(std::vector<std::function<void()>>{}));
+  EXPECT_TRUE(queue.popAll().empty());
+
+  std::vector<std::function<void()>> batch;
+  batch.push_back([] {});
+  EXPECT_TRUE(queue.push(std::move(batch)));
+}
+
+TEST(PostCallbackQueueTest, UnrunCallbacksAreDestroyed) {
+  auto tracker = std::make_shared<int>(0);
+  {
+    PostCallbackQueue queue;
+    queue.push([tracker] {});
+    queue.push([tracker] {});
+    EXPECT_EQ(3, tracker.use_count());
+    PostCallbackQueue::Batch callbacks = queue.popAll();
+    callbacks.popFront();
+    EXPECT_EQ(2, tracker.use_count());
+    queue.push([tracker] {});
+  }
+  EXPECT_EQ(1, tracker.use_count());
+}
+
+// Many producers race a single consumer; every callback must run exactly once and in per-producer
+// posting order.
+TEST(PostCallbackQueueTest, ConcurrentProducers) {
+  constexpr int NumProducers = 8;
+  constexpr int PerProducer = 10000;
+  PostCallbackQueue queue;
+  std::vector<int> next_expected(NumProducers, 0);
+  std::atomic<int> done{0};
+  int ran = 0;
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < NumProducers; p++) {
+    producers.emplace_back([&, p] {
+      for (int i = 0; i < PerProducer; i++) {
+        queue.push([&, p, i] {
+          EXPECT_EQ(next_expected[p], i);
+          next_expected[p]++;
+          ran++;
+        });
+      }
+      done++;
+    });
+  }
+
+  while (ran < NumProducers * PerProducer) {
+    const bool finished = done == NumProducers;
+    PostCallbackQueue::Batch callbacks = queue.popAll();
+    while (!callbacks.empty()) {
+      callbacks.front()();
+      callbacks.popFront();
+    }
+    if (finished) {
+      break;
+    }
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  EXPECT_EQ(NumProducers * PerProducer, ran);
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
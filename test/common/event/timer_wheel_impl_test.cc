@@ -0,0 +1,123 @@
+#include <chrono>
+#include <vector>
+
+#include "source/common/event/dispatcher_impl.h"
+#include "source/common/event/timer_wheel_impl.h"
+
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+using testing::MockFunction;
+
+class TimerWheelTest : public testing::Test, public TestUsingSimulatedTime {
+public:
+  TimerWheelTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")),
+        wheel_(*dispatcher_, std::chrono::milliseconds(10)) {}
+
+  void advance(std::chrono::milliseconds duration) {
+    simTime().advanceTimeAndRun(duration, *dispatcher_, Dispatcher::RunType::Block);
+  }
+
+  Api::ApiPtr api_;
+  DispatcherPtr dispatcher_;
+  TimerWheel wheel_;
+};
+
+TEST_F(TimerWheelTest, FiresWithinGranularityAfterTimeout) {
+  MockFunction<TimerCb> callback;
+  TimerPtr timer = wheel_.createTimer(callback.AsStdFunction());
+  EXPECT_FALSE(timer->enabled());
+
+  timer->enableTimer(std::chrono::milliseconds(25));
+  EXPECT_TRUE(timer->enabled());
+  EXPECT_EQ(1, wheel_.size());
+  advance(std::chrono::milliseconds(24));
+  EXPECT_TRUE(timer->enabled());
+
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::milliseconds(10));
+  EXPECT_FALSE(timer->enabled());
+  EXPECT_EQ(0, wheel_.size());
+}
+
+TEST_F(TimerWheelTest, DisableAndReEnable) {
+  MockFunction<TimerCb> callback;
+  TimerPtr timer = wheel_.createTimer(callback.AsStdFunction());
+
+  timer->enableTimer(std::chrono::milliseconds(50));
+  timer->disableTimer();
+  EXPECT_FALSE(timer->enabled());
+  EXPECT_EQ(0, wheel_.size());
+  advance(std::chrono::milliseconds(100));
+
+  // Enabling a pending timer resets its timeout.
+  timer->enableTimer(std::chrono::milliseconds(50));
+  advance(std::chrono::milliseconds(40));
+  timer->enableTimer(std::chrono::milliseconds(50));
+  advance(std::chrono::milliseconds(40));
+  EXPECT_TRUE(timer->enabled());
+
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::milliseconds(20));
+}
+
+// Timeouts beyond a revolution of the first level wait on the higher levels, and move down as
+// the wheel turns.
+TEST_F(TimerWheelTest, LongTimeoutsCascade) {
+  const std::vector<std::chrono::milliseconds> timeouts = {
+      std::chrono::milliseconds(30), std::chrono::seconds(3), std::chrono::seconds(700),
+      std::chrono::hours(50)};
+  const MonotonicTime start = simTime().monotonicTime();
+  std::vector<MonotonicTime> fired(timeouts.size());
+  std::vector<TimerPtr> timers;
+  for (size_t i = 0; i < timeouts.size(); i++) {
+    timers.push_back(
+        wheel_.createTimer([this, &fired, i]() { fired[i] = simTime().monotonicTime(); }));
+    timers.back()->enableTimer(timeouts[i]);
+  }
+
+  const std::chrono::seconds step(10);
+  while (wheel_.size() > 0) {
+    advance(step);
+  }
+  for (size_t i = 0; i < timeouts.size(); i++) {
+    EXPECT_GE(fired[i] - start, timeouts[i]) << i;
+    EXPECT_LE(fired[i] - start, timeouts[i] + step) << i;
+  }
+}
+
+TEST_F(TimerWheelTest, CallbacksCanReEnableAndDisableTimers) {
+  MockFunction<TimerCb> other_callback;
+  TimerPtr other = wheel_.createTimer(other_callback.AsStdFunction());
+  uint32_t calls = 0;
+  TimerPtr timer;
+  timer = wheel_.createTimer([&]() {
+    ++calls;
+    other->disableTimer();
+    if (calls < 3) {
+      timer->enableTimer(std::chrono::milliseconds(0));
+    }
+  });
+
+  // Both timers expire at the same tick, and the first one to run disables the other.
+  timer->enableTimer(std::chrono::milliseconds(10));
+  other->enableTimer(std::chrono::milliseconds(10));
+  EXPECT_CALL(other_callback, Call()).Times(testing::AtMost(1));
+  for (int i = 0; i < 5; i++) {
+    advance(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(3, calls);
+  EXPECT_EQ(0, wheel_.size());
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
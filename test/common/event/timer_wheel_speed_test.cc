@@ -0,0 +1,73 @@
+// Compares arming, re-arming and disarming many coarse timers, such as the idle timeouts of a large
+// number of connections, on the timer heap of the event loop and on a TimerWheel.
+//
+// Note: this should be run with --compilation_mode=opt.
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "source/common/event/dispatcher_impl.h"
+#include "source/common/event/timer_wheel_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+// Each iteration arms every timer, re-arms it with another timeout as an idle timer is on activity,
+// and disarms it.
+void armRearmDisarm(benchmark::State& state, std::vector<TimerPtr>& timers) {
+  std::mt19937 random(0);
+  std::uniform_int_distribution<int64_t> timeout_ms(1000, 60000);
+  std::vector<std::chrono::milliseconds> timeouts;
+  timeouts.reserve(timers.size());
+  for (size_t i = 0; i < timers.size(); i++) {
+    timeouts.emplace_back(timeout_ms(random));
+  }
+
+  for (auto _ : state) { // NOLINT
+    for (size_t i = 0; i < timers.size(); i++) {
+      timers[i]->enableTimer(timeouts[i]);
+    }
+    for (size_t i = 0; i < timers.size(); i++) {
+      timers[i]->enableTimer(timeouts[timers.size() - 1 - i]);
+    }
+    for (TimerPtr& timer : timers) {
+      timer->disableTimer();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * timers.size() * 3);
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_DispatcherTimers(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  std::vector<TimerPtr> timers;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    timers.push_back(dispatcher->createTimer([]() {}));
+  }
+  armRearmDisarm(state, timers);
+}
+BENCHMARK(BM_DispatcherTimers)->Arg(1 << 14)->Arg(1 << 17)->Arg(1 << 20)->Arg(1 << 21);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_TimerWheelTimers(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  TimerWheel wheel(*dispatcher, std::chrono::milliseconds(10));
+  std::vector<TimerPtr> timers;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    timers.push_back(wheel.createTimer([]() {}));
+  }
+  armRearmDisarm(state, timers);
+}
+BENCHMARK(BM_TimerWheelTimers)->Arg(1 << 14)->Arg(1 << 17)->Arg(1 << 20)->Arg(1 << 21);
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
@@ -2609,6 +2609,67 @@ TEST(SubstitutionFormatterTest, JsonFormatterTest) {
   EXPECT_TRUE(TestUtility::jsonStringEqual(out_json, expected));
 }
 
+// The JSON of JsonFormatterImpl is serialized directly, and must match the serialization of the
+// Struct of StructFormatter.
+TEST(SubstitutionFormatterTest, JsonFormatterMatchesStructFormatterTest) {
+  StreamInfo::MockStreamInfo stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"quoted", "say \"hi\"\\\t\x01"},
+                                                {"long", "0123456789"}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body = "body";
+
+  absl::optional<Http::Protocol> protocol = Http::Protocol::Http11;
+  EXPECT_CALL(stream_info, protocol()).WillRepeatedly(Return(protocol));
+  EXPECT_CALL(Const(stream_info), lastDownstreamRxByteReceived())
+      .WillRepeatedly(Return(std::chrono::nanoseconds(5000000)));
+  ProtobufWkt::Struct s;
+  (*s.mutable_fields())["number"] = ValueUtil::numberValue(3.14);
+  stream_info.filter_state_->setData("test_obj",
+                                     std::make_unique<TestSerializedStructFilterState>(s),
+                                     StreamInfo::FilterState::StateType::ReadOnly);
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    request_duration: '%REQUEST_DURATION%'
+    quoted: '%REQ(QUOTED)%'
+    truncated: '%REQ(LONG):4%'
+    missing: '%REQ(MISSING)%'
+    multi: '%REQ(MISSING)% %LOCAL_REPLY_BODY% %PROTOCOL%'
+    filter_state: '%FILTER_STATE(test_obj)%'
+    nested_level:
+      empty: {}
+      list: ['%REQ(MISSING)%', '%REQUEST_DURATION%', ['%PROTOCOL%']]
+  )EOF",
+                            key_mapping);
+
+  for (const bool preserve_types : {false, true}) {
+    for (const bool omit_empty_values : {false, true}) {
+      JsonFormatterImpl json_formatter(key_mapping, preserve_types, omit_empty_values);
+      StructFormatter struct_formatter(key_mapping, preserve_types, omit_empty_values);
+      const std::string expected = MessageUtil::getJsonStringFromMessageOrDie(
+          struct_formatter.format(request_header, response_header, response_trailer, stream_info,
+                                  body),
+          false, true);
+      const std::string out_json = json_formatter.format(request_header, response_header,
+                                                         response_trailer, stream_info, body);
+      EXPECT_EQ('\n', out_json.back());
+      EXPECT_TRUE(TestUtility::jsonStringEqual(out_json, expected))
+          << out_json << " vs " << expected;
+    }
+  }
+
+  TestUtility::loadFromYaml(R"EOF(
+    quoted: '%REQ(QUOTED)%'
+    missing: '%REQ(MISSING)%'
+    list: ['%REQ(MISSING)%', '%REQ(LONG):4%']
+  )EOF",
+                            key_mapping);
+  JsonFormatterImpl formatter(key_mapping, false, true);
+  EXPECT_EQ("{\"list\":[\"0123\"],\"quoted\":\"say \\\"hi\\\"\\\\\\t\\u0001\"}\n",
+            formatter.format(request_header, response_header, response_trailer, stream_info, body));
+}
+
 TEST(SubstitutionFormatterTest, CompositeFormatterSuccess) {
   StreamInfo::MockStreamInfo stream_info;
   Http::TestRequestHeaderMapImpl request_header{{"first", "GET"}, {":path", "/"}};
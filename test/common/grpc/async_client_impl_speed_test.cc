@@ -0,0 +1,124 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the unary calls of the Envoy gRPC async client, from sending the request to receiving
+// the response, over an HTTP async client answering inline.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/core/v3/grpc_service.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/grpc/async_client_impl.h"
+#include "source/common/grpc/common.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/tracing/null_span_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/test_common/test_time.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Grpc {
+namespace {
+
+// Keeps the deferred deletions to destroy them once the call is done.
+class FastMockDispatcher : public Event::MockDispatcher {
+public:
+  void deferredDelete(Event::DeferredDeletablePtr&& to_delete) override {
+    to_delete_.push_back(std::move(to_delete));
+  }
+  bool isThreadSafe() const override { return true; }
+};
+
+// Answers each stream with a response once its request is sent.
+class FastHttpAsyncClient : public Http::AsyncClient, public Http::AsyncClient::Stream {
+public:
+  // Http::AsyncClient
+  Request* send(Http::RequestMessagePtr&&, Callbacks&, const RequestOptions&) override {
+    return nullptr;
+  }
+  Stream* start(StreamCallbacks& callbacks, const StreamOptions&) override {
+    callbacks_ = &callbacks;
+    return this;
+  }
+  Event::Dispatcher& dispatcher() override { return dispatcher_; }
+
+  // Http::AsyncClient::Stream
+  void sendHeaders(Http::RequestHeaderMap&, bool) override {}
+  void sendData(Buffer::Instance& data, bool end_stream) override {
+    data.drain(data.length());
+    if (!end_stream) {
+      return;
+    }
+    callbacks_->onHeaders(
+        Http::ResponseHeaderMapPtr{new Http::TestResponseHeaderMapImpl{
+            {":status", "200"}, {"content-type", "application/grpc"}}},
+        false);
+    Buffer::OwnedImpl response(response_);
+    Common::prependGrpcFrameHeader(response);
+    callbacks_->onData(response, false);
+    callbacks_->onTrailers(
+        Http::ResponseTrailerMapPtr{new Http::TestResponseTrailerMapImpl{{"grpc-status", "0"}}});
+  }
+  void sendTrailers(Http::RequestTrailerMap&) override {}
+  void reset() override {}
+  bool isAboveWriteBufferHighWatermark() const override { return false; }
+
+  NiceMock<FastMockDispatcher> dispatcher_;
+  StreamCallbacks* callbacks_{};
+  std::string response_ = std::string(64, 'r');
+};
+
+class RequestCallbacks : public RawAsyncRequestCallbacks {
+public:
+  void onCreateInitialMetadata(Http::RequestHeaderMap&) override {}
+  void onSuccessRaw(Buffer::InstancePtr&&, Tracing::Span&) override { successes_++; }
+  void onFailure(Status::GrpcStatus, const std::string&, Tracing::Span&) override {}
+
+  uint64_t successes_{0};
+};
+
+// Sends unary calls, with state.range(0) entries of initial metadata configured.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_UnaryCalls(benchmark::State& state) {
+  envoy::config::core::v3::GrpcService config;
+  config.mutable_envoy_grpc()->set_cluster_name("control_plane_cluster");
+  for (int64_t i = 0; i < state.range(0); i++) {
+    auto* initial_metadata = config.add_initial_metadata();
+    initial_metadata->set_key(absl::StrCat("x-metadata-", i));
+    initial_metadata->set_value("value");
+  }
+  NiceMock<Upstream::MockClusterManager> cm;
+  cm.initializeThreadLocalClusters({"control_plane_cluster"});
+  FastHttpAsyncClient http_client;
+  ON_CALL(cm.thread_local_cluster_, httpAsyncClient()).WillByDefault(ReturnRef(http_client));
+  DangerousDeprecatedTestTime test_time;
+  AsyncClientImpl grpc_client(cm, config, test_time.timeSystem());
+  RequestCallbacks callbacks;
+  Http::AsyncClient::RequestOptions options;
+  options.setTimeout(std::chrono::milliseconds(200));
+
+  for (auto _ : state) { // NOLINT
+    grpc_client.sendRaw("envoy.service.auth.v3.Authorization", "Check",
+                        std::make_unique<Buffer::OwnedImpl>(std::string(128, 'q')), callbacks,
+                        Tracing::NullSpan::instance(), options);
+    http_client.dispatcher_.to_delete_.clear();
+  }
+  RELEASE_ASSERT(callbacks.successes_ == state.iterations(), "");
+}
+BENCHMARK(BM_UnaryCalls)->Arg(0)->Arg(4);
+
+} // namespace
+} // namespace Grpc
+} // namespace Envoy
@@ -1,5 +1,6 @@
 #include "envoy/config/core/v3/grpc_service.pb.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/grpc/async_client_impl.h"
 #include "source/common/network/address_impl.h"
 #include "source/common/network/socket_impl.h"
@@ -141,6 +142,25 @@ TEST_F(EnvoyAsyncClientImplTest, MetadataIsInitialized) {
   EXPECT_EQ(grpc_stream, nullptr);
 }
 
+// Validate that a compressed message is sent in a gRPC frame flagged as compressed.
+TEST_F(EnvoyAsyncClientImplTest, SendCompressedMessage) {
+  NiceMock<MockAsyncStreamCallbacks<helloworld::HelloReply>> grpc_callbacks;
+  Http::MockAsyncClientStream http_stream;
+  EXPECT_CALL(http_client_, start(_, _)).WillOnce(Return(&http_stream));
+  EXPECT_CALL(http_stream, sendHeaders(_, false));
+  auto grpc_stream =
+      grpc_client_->start(*method_descriptor_, grpc_callbacks, Http::AsyncClient::StreamOptions());
+  ASSERT_NE(grpc_stream, nullptr);
+
+  EXPECT_CALL(http_stream, sendData(_, false)).WillOnce(Invoke([](Buffer::Instance& data, bool) {
+    EXPECT_EQ(std::string("\x01\x00\x00\x00\x03xyz", 8), data.toString());
+  }));
+  grpc_stream->sendCompressedMessageRaw(std::make_unique<Buffer::OwnedImpl>("xyz"), false);
+
+  EXPECT_CALL(http_stream, reset());
+  grpc_stream->resetStream();
+}
+
 // Validate that a failure in the HTTP client returns immediately with status
 // UNAVAILABLE.
 TEST_F(EnvoyAsyncClientImplTest, StreamHttpStartFail) {
@@ -395,5 +395,25 @@ TEST(GrpcContextTest, PrependGrpcFrameHeader) {
   EXPECT_EQ(buffer->toString(), header_string + "test");
 }
 
+// Ensure that a large message is framed across several slices and parses back.
+TEST(GrpcContextTest, SerializeLargeMessageToGrpcFrame) {
+  helloworld::HelloRequest request;
+  request.set_name(std::string(100 * 1024, 'a'));
+  Buffer::InstancePtr buffer = Common::serializeToGrpcFrame(request);
+  EXPECT_EQ(5 + request.ByteSizeLong(), buffer->length());
+  EXPECT_GT(buffer->getRawSlices().size(), 1);
+
+  std::array<char, 5> expected_header;
+  expected_header[0] = 0; // flags
+  const uint32_t nsize = htonl(request.ByteSizeLong());
+  std::memcpy(&expected_header[1], reinterpret_cast<const void*>(&nsize), sizeof(uint32_t));
+  EXPECT_EQ(std::string(&expected_header[0], 5), buffer->toString().substr(0, 5));
+
+  buffer->drain(5);
+  helloworld::HelloRequest parsed;
+  EXPECT_TRUE(Common::parseBufferInstance(std::move(buffer), parsed));
+  EXPECT_EQ(request.name(), parsed.name());
+}
+
 } // namespace Grpc
 } // namespace Envoy
@@ -65,12 +65,13 @@ public:
     initial_metadata_entry.set_key("downstream-local-address");
     initial_metadata_entry.set_value("%DOWNSTREAM_LOCAL_ADDRESS_WITHOUT_PORT%");
 
-    tls_ = std::make_unique<GoogleAsyncClientThreadLocal>(*api_);
+    tls_ = std::make_unique<GoogleAsyncClientThreadLocal>(
+        std::make_shared<GoogleAsyncClientSharedState>(*api_, 0));
   }
 
   virtual void initialize() {
     grpc_client_ = std::make_unique<GoogleAsyncClientImpl>(*dispatcher_, *tls_, stub_factory_,
-                                                           scope_, config_, *api_, stat_names_);
+                                                           scope_, config_, stat_names_);
   }
 
   envoy::config::core::v3::GrpcService config_;
@@ -165,7 +166,7 @@ class EnvoyGoogleLessMockedAsyncClientImplTest : public EnvoyGoogleAsyncClientIm
 public:
   void initialize() override {
     grpc_client_ = std::make_unique<GoogleAsyncClientImpl>(*dispatcher_, *tls_, real_stub_factory_,
-                                                           scope_, config_, *api_, stat_names_);
+                                                           scope_, config_, stat_names_);
   }
 
   GoogleGenericStubFactory real_stub_factory_;
@@ -194,6 +195,77 @@ TEST_F(EnvoyGoogleLessMockedAsyncClientImplTest, TestOverflow) {
   EXPECT_TRUE(grpc_stream->isAboveWriteBufferHighWatermark());
 }
 
+class ChannelRecordingStubFactory : public MockStubFactory {
+public:
+  GoogleStubSharedPtr createStub(std::shared_ptr<grpc::Channel> channel) override {
+    channels_.push_back(channel);
+    return shared_stub_;
+  }
+
+  std::vector<std::shared_ptr<grpc::Channel>> channels_;
+};
+
+// Validate that the silos share the completion queue threads round robin, if any.
+TEST_F(EnvoyGoogleAsyncClientImplTest, SharedCompletionQueueThreads) {
+  auto shared_state = std::make_shared<GoogleAsyncClientSharedState>(*api_, 2);
+  GoogleAsyncClientThreadLocal first(shared_state);
+  GoogleAsyncClientThreadLocal second(shared_state);
+  GoogleAsyncClientThreadLocal third(shared_state);
+  EXPECT_NE(&first.completionQueue(), &second.completionQueue());
+  EXPECT_EQ(&first.completionQueue(), &third.completionQueue());
+
+  auto dedicated_state = std::make_shared<GoogleAsyncClientSharedState>(*api_, 0);
+  GoogleAsyncClientThreadLocal fourth(dedicated_state);
+  GoogleAsyncClientThreadLocal fifth(dedicated_state);
+  EXPECT_NE(&fourth.completionQueue(), &fifth.completionQueue());
+}
+
+// Validate that the clients of identical configs share their channel across silos.
+TEST_F(EnvoyGoogleAsyncClientImplTest, ChannelSharedByIdenticalConfigs) {
+  GoogleAsyncClientThreadLocal other_tls(std::make_shared<GoogleAsyncClientSharedState>(*api_, 0));
+  ChannelRecordingStubFactory stub_factory;
+  auto other_config = config_;
+  other_config.mutable_google_grpc()->set_target_uri("other_fake_address");
+
+  GoogleAsyncClientImpl first(*dispatcher_, *tls_, stub_factory, scope_, config_, stat_names_);
+  GoogleAsyncClientImpl second(*dispatcher_, *tls_, stub_factory, scope_, config_, stat_names_);
+  GoogleAsyncClientImpl third(*dispatcher_, *tls_, stub_factory, scope_, other_config, stat_names_);
+  ASSERT_EQ(3, stub_factory.channels_.size());
+  EXPECT_EQ(stub_factory.channels_[0], stub_factory.channels_[1]);
+  EXPECT_NE(stub_factory.channels_[0], stub_factory.channels_[2]);
+
+  // Silos that don't share their state don't share channels.
+  GoogleAsyncClientImpl fourth(*dispatcher_, other_tls, stub_factory, scope_, config_, stat_names_);
+  EXPECT_NE(stub_factory.channels_[0], stub_factory.channels_[3]);
+
+  // Once no client uses a channel, a new one is created.
+  stub_factory.channels_.clear();
+  GoogleAsyncClientImpl fifth(*dispatcher_, *tls_, stub_factory, scope_, config_, stat_names_);
+  ASSERT_EQ(1, stub_factory.channels_.size());
+}
+
+// Validate that a silo drains its streams on destruction when its completion queue is shared with
+// other silos.
+TEST_F(EnvoyGoogleLessMockedAsyncClientImplTest, DrainStreamsOfSharedCompletionQueue) {
+  auto shared_state = std::make_shared<GoogleAsyncClientSharedState>(*api_, 1);
+  GoogleAsyncClientThreadLocal other_tls(shared_state);
+  tls_ = std::make_unique<GoogleAsyncClientThreadLocal>(shared_state);
+  initialize();
+
+  NiceMock<MockAsyncStreamCallbacks<helloworld::HelloReply>> grpc_callbacks;
+  AsyncStream<helloworld::HelloRequest> grpc_stream =
+      grpc_client_->start(*method_descriptor_, grpc_callbacks, Http::AsyncClient::StreamOptions());
+  EXPECT_FALSE(grpc_stream == nullptr);
+  helloworld::HelloRequest request_msg;
+  request_msg.set_name("bob");
+  grpc_stream->sendMessage(request_msg, false);
+
+  // The stream is reset with its client, and only freed once its cancelled ops are drained by the
+  // destruction of its silo, as the dispatcher doesn't run.
+  grpc_client_.reset();
+  tls_.reset();
+}
+
 } // namespace
 } // namespace Grpc
 } // namespace Envoy
@@ -332,10 +332,11 @@ public:
 
   RawAsyncClientPtr createGoogleAsyncClientImpl() {
 #ifdef ENVOY_GOOGLE_GRPC
-    google_tls_ = std::make_unique<GoogleAsyncClientThreadLocal>(*api_);
+    google_tls_ = std::make_unique<GoogleAsyncClientThreadLocal>(
+        std::make_shared<GoogleAsyncClientSharedState>(*api_, 0));
     GoogleGenericStubFactory stub_factory;
     return std::make_unique<GoogleAsyncClientImpl>(*dispatcher_, *google_tls_, stub_factory,
-                                                   stats_scope_, createGoogleGrpcConfig(), *api_,
+                                                   stats_scope_, createGoogleGrpcConfig(),
                                                    google_grpc_stat_names_);
 #else
     NOT_REACHED_GCOVR_EXCL_LINE;
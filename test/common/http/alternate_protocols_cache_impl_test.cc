@@ -1,6 +1,8 @@
 #include "source/common/http/alternate_protocols_cache_impl.h"
 
+#include "test/test_common/environment.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
 
@@ -116,6 +118,81 @@ TEST_F(AlternateProtocolsCacheImplTest, FindAlternativesAfterTruncation) {
   EXPECT_EQ(expected_protocols, protocols.ref());
 }
 
+TEST_F(AlternateProtocolsCacheImplTest, RecordHttp3Attempts) {
+  EXPECT_FALSE(protocols_.findStats(origin1_).has_value());
+  protocols_.recordHttp3Attempt(origin1_, true, std::chrono::milliseconds(80));
+  protocols_.recordHttp3Attempt(origin1_, true, std::chrono::milliseconds(160));
+  protocols_.recordHttp3Attempt(origin1_, false, std::chrono::milliseconds(1000));
+  absl::optional<AlternateProtocolsCacheImpl::OriginStats> stats = protocols_.findStats(origin1_);
+  ASSERT_TRUE(stats.has_value());
+  // The connect time is smoothed, and failed attempts don't count in it.
+  EXPECT_EQ(std::chrono::milliseconds(90), stats->http3_connect_time_);
+  EXPECT_EQ(2, stats->http3_successes_);
+  EXPECT_EQ(1, stats->http3_failures_);
+  EXPECT_FALSE(protocols_.findStats(origin2_).has_value());
+}
+
+TEST_F(AlternateProtocolsCacheImplTest, RecordHttp3AttemptsDecay) {
+  for (size_t i = 0; i < 32; ++i) {
+    protocols_.recordHttp3Attempt(origin1_, false, std::chrono::microseconds::zero());
+  }
+  protocols_.recordHttp3Attempt(origin1_, true, std::chrono::milliseconds(10));
+  absl::optional<AlternateProtocolsCacheImpl::OriginStats> stats = protocols_.findStats(origin1_);
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(1, stats->http3_successes_);
+  EXPECT_EQ(16, stats->http3_failures_);
+}
+
+TEST_F(AlternateProtocolsCacheImplTest, Persistence) {
+  Api::ApiPtr api = Api::createApiForTest();
+  const std::string path = TestEnvironment::temporaryPath("alternate_protocols_cache");
+  TestEnvironment::removePath(path);
+  {
+    auto file = std::make_shared<AlternateProtocolsCacheFile>(api->fileSystem(), path);
+    AlternateProtocolsCacheImpl cache(simTime(), file);
+    cache.setAlternatives(origin1_, protocols1_);
+    cache.recordHttp3Attempt(origin1_, true, std::chrono::milliseconds(80));
+    cache.recordHttp3Attempt(origin2_, false, std::chrono::microseconds::zero());
+    file->flush();
+  }
+
+  // Another cache, as after a restart, is seeded from the file.
+  auto file = std::make_shared<AlternateProtocolsCacheFile>(api->fileSystem(), path);
+  AlternateProtocolsCacheImpl cache(simTime(), file);
+  EXPECT_EQ(1, cache.size());
+  OptRef<const std::vector<AlternateProtocolsCacheImpl::AlternateProtocol>> protocols =
+      cache.findAlternatives(origin1_);
+  ASSERT_TRUE(protocols.has_value());
+  ASSERT_EQ(1, protocols->size());
+  EXPECT_EQ(alpn1_, protocols.ref()[0].alpn_);
+  EXPECT_EQ(hostname1_, protocols.ref()[0].hostname_);
+  EXPECT_EQ(port1_, protocols.ref()[0].port_);
+  EXPECT_EQ(std::chrono::milliseconds(80), cache.findStats(origin1_)->http3_connect_time_);
+  EXPECT_EQ(1, cache.findStats(origin2_)->http3_failures_);
+
+  // The protocols which expired meanwhile are dropped.
+  simTime().setSystemTime(simTime().systemTime() + Seconds(6));
+  AlternateProtocolsCacheImpl expired_cache(simTime(), file);
+  EXPECT_EQ(0, expired_cache.size());
+  EXPECT_TRUE(expired_cache.findStats(origin1_).has_value());
+  TestEnvironment::removePath(path);
+}
+
+TEST_F(AlternateProtocolsCacheImplTest, InvalidPersistedEntries) {
+  Api::ApiPtr api = Api::createApiForTest();
+  const std::string path = TestEnvironment::writeStringToFileForTest(
+      "invalid_alternate_protocols_cache",
+      "https|hostname1|1 0|1|0|alpn1,,1,99999999999\n"
+      "https|hostname2 0|1|0|\n"
+      "https|hostname3|3 invalid\n");
+  auto file = std::make_shared<AlternateProtocolsCacheFile>(api->fileSystem(), path);
+  AlternateProtocolsCacheImpl cache(simTime(), file);
+  EXPECT_EQ(1, cache.size());
+  EXPECT_TRUE(cache.findAlternatives(origin1_).has_value());
+  EXPECT_FALSE(cache.findStats({https_, "hostname2", 2}).has_value());
+  EXPECT_FALSE(cache.findStats({https_, "hostname3", 3}).has_value());
+}
+
 } // namespace
 } // namespace Http
 } // namespace Envoy
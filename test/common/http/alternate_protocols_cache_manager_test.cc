@@ -1,8 +1,11 @@
 #include "source/common/http/alternate_protocols_cache_manager_impl.h"
 #include "source/common/singleton/manager_impl.h"
 
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/environment.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
 
@@ -14,7 +17,8 @@ class AlternateProtocolsCacheManagerTest : public testing::Test,
                                            public Event::TestUsingSimulatedTime {
 public:
   AlternateProtocolsCacheManagerTest()
-      : factory_(singleton_manager_, simTime(), tls_), manager_(factory_.get()) {
+      : factory_(singleton_manager_, simTime(), tls_, api_->fileSystem()),
+        manager_(factory_.get()) {
     options1_.set_name(name1_);
     options1_.mutable_max_entries()->set_value(max_entries1_);
 
@@ -24,6 +28,7 @@ public:
 
   Singleton::ManagerImpl singleton_manager_{Thread::threadFactoryForTest()};
   testing::NiceMock<ThreadLocal::MockInstance> tls_;
+  Api::ApiPtr api_ = Api::createApiForTest();
   Http::AlternateProtocolsCacheManagerFactoryImpl factory_;
   AlternateProtocolsCacheManagerSharedPtr manager_;
   const std::string name1_ = "name1";
@@ -61,6 +66,25 @@ TEST_F(AlternateProtocolsCacheManagerTest, GetCacheForConflictingOptions) {
       "options specified alternate protocols cache 'name1' with different settings.*");
 }
 
+TEST_F(AlternateProtocolsCacheManagerTest, GetCacheWithPersistence) {
+  const std::string path = TestEnvironment::temporaryPath("alternate_protocols_cache_manager");
+  TestEnvironment::removePath(path);
+  options1_.set_persistence_path(path);
+  options1_.mutable_persistence_flush_interval()->set_seconds(1);
+  auto* flush_timer = new Event::MockTimer(&tls_.dispatcher_);
+  EXPECT_CALL(*flush_timer, enableTimer(std::chrono::milliseconds(1000), testing::_));
+  AlternateProtocolsCacheSharedPtr cache = manager_->getCache(options1_);
+  const AlternateProtocolsCache::Origin origin("https", "hostname", 443);
+  cache->recordHttp3Attempt(origin, true, std::chrono::milliseconds(20));
+  EXPECT_FALSE(api_->fileSystem().fileExists(path));
+
+  // The cache is saved when the timer fires, which is then re-armed.
+  EXPECT_CALL(*flush_timer, enableTimer(std::chrono::milliseconds(1000), testing::_));
+  flush_timer->invokeCallback();
+  EXPECT_EQ("https|hostname|443 20000|1|0|\n", api_->fileSystem().fileReadToEnd(path));
+  TestEnvironment::removePath(path);
+}
+
 } // namespace
 } // namespace Http
 } // namespace Envoy
@@ -619,6 +619,51 @@ TEST_F(ConnectivityGridWithAlternateProtocolsCacheImplTest, SuccessWithoutHttp3N
   grid_.callbacks()->onPoolReady(encoder_, host_, info_, absl::nullopt);
 }
 
+// Test that HTTP/3 is given twice the time it took to connect to the origin before TCP is
+// attempted.
+TEST_F(ConnectivityGridWithAlternateProtocolsCacheImplTest, NextAttemptDurationFromConnectTime) {
+  addHttp3AlternateProtocol();
+  Event::MockTimer* failover_timer = new NiceMock<MockTimer>(&dispatcher_);
+  EXPECT_CALL(*failover_timer, enableTimer(std::chrono::milliseconds(300), nullptr));
+  grid_.newStream(decoder_, callbacks_);
+  simTime().advanceTimeWait(std::chrono::milliseconds(40));
+  EXPECT_CALL(callbacks_.pool_ready_, ready());
+  grid_.callbacks()->onPoolReady(encoder_, host_, info_, absl::nullopt);
+
+  AlternateProtocolsCacheImpl::Origin origin("https", "hostname", 9000);
+  absl::optional<AlternateProtocolsCache::OriginStats> stats =
+      alternate_protocols_->findStats(origin);
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(std::chrono::milliseconds(40), stats->http3_connect_time_);
+  EXPECT_EQ(1, stats->http3_successes_);
+  EXPECT_EQ(0, stats->http3_failures_);
+
+  failover_timer = new NiceMock<MockTimer>(&dispatcher_);
+  EXPECT_CALL(*failover_timer, enableTimer(std::chrono::milliseconds(80), nullptr));
+  grid_.newStream(decoder_, callbacks_);
+}
+
+// Test that TCP is attempted right away when HTTP/3 mostly failed to connect to the origin.
+TEST_F(ConnectivityGridWithAlternateProtocolsCacheImplTest, NoNextAttemptDelayAfterHttp3Failures) {
+  addHttp3AlternateProtocol();
+  Event::MockTimer* failover_timer = new NiceMock<MockTimer>(&dispatcher_);
+  grid_.newStream(decoder_, callbacks_);
+  EXPECT_CALL(callbacks_.pool_failure_, ready()).Times(0);
+  grid_.callbacks()->onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                                   "reason", host_);
+  EXPECT_CALL(callbacks_.pool_ready_, ready());
+  grid_.callbacks(1)->onPoolReady(encoder_, host_, info_, absl::nullopt);
+  EXPECT_EQ(1, alternate_protocols_->findStats({"https", "hostname", 9000})->http3_failures_);
+
+  // HTTP/3 is broken after it failed while TCP succeeded, so confirm it to attempt it again.
+  grid_.markHttp3Confirmed();
+  failover_timer = new NiceMock<MockTimer>(&dispatcher_);
+  EXPECT_CALL(*failover_timer, enableTimer(std::chrono::milliseconds(0), nullptr));
+  EXPECT_LOG_CONTAINS("trace",
+                      "HTTP/3 mostly failed to host 'hostname', attempting TCP right away.",
+                      grid_.newStream(decoder_, callbacks_));
+}
+
 #ifdef ENVOY_ENABLE_QUIC
 
 } // namespace
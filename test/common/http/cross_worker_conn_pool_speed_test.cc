@@ -0,0 +1,197 @@
+// Compares streams made on a connection pool owned by the worker making them with streams which
+// CrossWorkerConnPool forwards to a pool owned by another worker. The pools here respond as soon
+// as a stream's request headers are encoded, so the difference is the cost of the handoff.
+//
+// Each benchmark thread stands in for a worker. With per worker pools every worker needs its own
+// connection to a host, while a shared pool needs one no matter how many workers use it, which is
+// reported as the connections_per_host counter.
+
+#include <memory>
+
+#include "envoy/event/deferred_deletable.h"
+
+#include "source/common/http/cross_worker_conn_pool.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/stream_info/stream_info_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+// An upstream stream which responds as soon as its request headers are encoded.
+class ImmediateResponseStream : public RequestEncoder,
+                                public Stream,
+                                public Event::DeferredDeletable {
+public:
+  ImmediateResponseStream(Event::Dispatcher& dispatcher, ResponseDecoder& response_decoder)
+      : dispatcher_(dispatcher), response_decoder_(response_decoder) {}
+
+  // RequestEncoder
+  Status encodeHeaders(const RequestHeaderMap&, bool) override {
+    ResponseHeaderMapPtr headers = ResponseHeaderMapImpl::create();
+    headers->setStatus(200);
+    response_decoder_.decodeHeaders(std::move(headers), true);
+    // Like a codec stream, this outlives the call which completes it.
+    dispatcher_.deferredDelete(std::unique_ptr<ImmediateResponseStream>(this));
+    return okStatus();
+  }
+  void encodeTrailers(const RequestTrailerMap&) override {}
+  void enableTcpTunneling() override {}
+
+  // StreamEncoder
+  void encodeData(Buffer::Instance&, bool) override {}
+  void encodeMetadata(const MetadataMapVector&) override {}
+  Http1StreamEncoderOptionsOptRef http1StreamEncoderOptions() override { return absl::nullopt; }
+  Stream& getStream() override { return *this; }
+
+  // Stream
+  void addCallbacks(StreamCallbacks&) override {}
+  void removeCallbacks(StreamCallbacks&) override {}
+  void resetStream(StreamResetReason) override {}
+  void readDisable(bool) override {}
+  uint32_t bufferLimit() override { return 0; }
+  const Network::Address::InstanceConstSharedPtr& connectionLocalAddress() override {
+    return connection_local_address_;
+  }
+  void setFlushTimeout(std::chrono::milliseconds) override {}
+  void setAccount(Buffer::BufferMemoryAccountSharedPtr) override {}
+
+private:
+  Event::Dispatcher& dispatcher_;
+  ResponseDecoder& response_decoder_;
+  const Network::Address::InstanceConstSharedPtr connection_local_address_;
+};
+
+// A pool whose streams are ready immediately.
+class ImmediatePool : public ConnectionPool::Instance {
+public:
+  ImmediatePool(Event::Dispatcher& dispatcher, TimeSource& time_source)
+      : dispatcher_(dispatcher), stream_info_(time_source, nullptr) {}
+
+  // ConnectionPool::Instance
+  void addIdleCallback(IdleCb) override {}
+  bool isIdle() const override { return true; }
+  void startDrain() override {}
+  void drainConnections() override {}
+  Upstream::HostDescriptionConstSharedPtr host() const override { return nullptr; }
+  bool maybePreconnect(float) override { return false; }
+  bool hasActiveConnections() const override { return false; }
+  ConnectionPool::Cancellable* newStream(ResponseDecoder& response_decoder,
+                                         ConnectionPool::Callbacks& callbacks) override {
+    auto* stream = new ImmediateResponseStream(dispatcher_, response_decoder);
+    callbacks.onPoolReady(*stream, nullptr, stream_info_, Protocol::Http2);
+    return nullptr;
+  }
+  absl::string_view protocolDescription() const override { return "immediate"; }
+
+private:
+  Event::Dispatcher& dispatcher_;
+  StreamInfo::StreamInfoImpl stream_info_;
+};
+
+// A request from a worker, which exits the worker's dispatcher when its response arrives.
+class Request : public ResponseDecoder, public ConnectionPool::Callbacks {
+public:
+  explicit Request(Event::Dispatcher& dispatcher) : dispatcher_(dispatcher) {
+    headers_->setMethod("GET");
+    headers_->setPath("/");
+    headers_->setHost("host");
+  }
+
+  // ConnectionPool::Callbacks
+  void onPoolFailure(ConnectionPool::PoolFailureReason, absl::string_view,
+                     Upstream::HostDescriptionConstSharedPtr) override {
+    dispatcher_.exit();
+  }
+  void onPoolReady(RequestEncoder& encoder, Upstream::HostDescriptionConstSharedPtr,
+                   const StreamInfo::StreamInfo&, absl::optional<Http::Protocol>) override {
+    encoder.encodeHeaders(*headers_, true).IgnoreError();
+  }
+
+  // ResponseDecoder
+  void decode100ContinueHeaders(ResponseHeaderMapPtr&&) override {}
+  void decodeHeaders(ResponseHeaderMapPtr&&, bool end_stream) override {
+    if (end_stream) {
+      dispatcher_.exit();
+    }
+  }
+  void decodeTrailers(ResponseTrailerMapPtr&&) override { dispatcher_.exit(); }
+  void dumpState(std::ostream&, int) const override {}
+
+  // StreamDecoder
+  void decodeData(Buffer::Instance&, bool end_stream) override {
+    if (end_stream) {
+      dispatcher_.exit();
+    }
+  }
+  void decodeMetadata(MetadataMapPtr&&) override {}
+
+private:
+  Event::Dispatcher& dispatcher_;
+  const RequestHeaderMapPtr headers_{RequestHeaderMapImpl::create()};
+};
+
+// The worker which owns the shared pool, running its dispatcher on its own thread.
+class OwnerWorker {
+public:
+  OwnerWorker()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("owner")),
+        pool_(*dispatcher_, api_->timeSource()),
+        thread_(api_->threadFactory().createThread(
+            [this]() { dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit); })) {}
+
+  Event::Dispatcher& dispatcher() { return *dispatcher_; }
+  ConnectionPool::Instance* pool() { return &pool_; }
+
+private:
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  ImmediatePool pool_;
+  Thread::ThreadPtr thread_;
+};
+
+void bmPerWorkerPool(::benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("worker");
+  ImmediatePool pool(*dispatcher, api->timeSource());
+  Request request(*dispatcher);
+
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    pool.newStream(request, request);
+    dispatcher->clearDeferredDeleteList();
+  }
+  state.counters["connections_per_host"] =
+      ::benchmark::Counter(state.threads, ::benchmark::Counter::kAvgThreads);
+}
+BENCHMARK(bmPerWorkerPool)->ThreadRange(1, 8)->UseRealTime();
+
+void bmSharedPool(::benchmark::State& state) {
+  // Shared by all of the benchmark threads, and left running until the process exits.
+  static OwnerWorker* owner = new OwnerWorker();
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("worker");
+  {
+    CrossWorkerConnPool pool(*dispatcher, owner->dispatcher(), nullptr,
+                             []() { return owner->pool(); });
+    Request request(*dispatcher);
+
+    for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+      pool.newStream(request, request);
+      dispatcher->run(Event::Dispatcher::RunType::RunUntilExit);
+    }
+  }
+  // Let the last stream's halves be released.
+  dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+  state.counters["connections_per_host"] =
+      ::benchmark::Counter(1, ::benchmark::Counter::kAvgThreads);
+}
+BENCHMARK(bmSharedPool)->ThreadRange(1, 8)->UseRealTime();
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
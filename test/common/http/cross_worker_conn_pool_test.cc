@@ -0,0 +1,271 @@
+#include <list>
+#include <memory>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/cross_worker_conn_pool.h"
+
+#include "test/mocks/common.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/mocks/upstream/host.h"
+#include "test/test_common/printers.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::NotNull;
+using testing::Return;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+class CrossWorkerConnPoolTest : public testing::Test {
+public:
+  CrossWorkerConnPoolTest() {
+    // Queue posted events so that the test controls when each worker runs.
+    ON_CALL(dispatcher_, post(_)).WillByDefault(Invoke([this](Event::PostCb cb) {
+      origin_posts_.push_back(std::move(cb));
+    }));
+    ON_CALL(owner_dispatcher_, post(_)).WillByDefault(Invoke([this](Event::PostCb cb) {
+      owner_posts_.push_back(std::move(cb));
+    }));
+    pool_ = std::make_unique<CrossWorkerConnPool>(dispatcher_, owner_dispatcher_, host_,
+                                                  [this]() { return owner_pool_; });
+  }
+
+  ~CrossWorkerConnPoolTest() override {
+    pool_.reset();
+    runOwner();
+    runOrigin();
+  }
+
+  // Runs the events posted to a worker, including any posted while running.
+  static void runPosted(std::list<Event::PostCb>& posts) {
+    while (!posts.empty()) {
+      Event::PostCb cb = std::move(posts.front());
+      posts.pop_front();
+      cb();
+    }
+  }
+  void runOwner() { runPosted(owner_posts_); }
+  void runOrigin() { runPosted(origin_posts_); }
+
+  // Starts a stream and has the owning worker's pool queue it.
+  ConnectionPool::Cancellable* startStream() {
+    EXPECT_CALL(owner_pool_mock_, newStream(_, _))
+        .WillOnce(Invoke([this](ResponseDecoder& decoder,
+                                ConnectionPool::Callbacks& callbacks) -> ConnectionPool::Cancellable* {
+          owner_decoder_ = &decoder;
+          owner_callbacks_ = &callbacks;
+          return &owner_cancellable_;
+        }));
+    ConnectionPool::Cancellable* handle = pool_->newStream(decoder_, callbacks_);
+    EXPECT_NE(nullptr, handle);
+    EXPECT_FALSE(pool_->isIdle());
+    runOwner();
+    return handle;
+  }
+
+  // Starts a stream and makes it ready.
+  RequestEncoder* startReadyStream() {
+    startStream();
+    owner_callbacks_->onPoolReady(upstream_encoder_, host_, owner_stream_info_, Protocol::Http2);
+    RequestEncoder* encoder = nullptr;
+    EXPECT_CALL(callbacks_, onPoolReady(_, _, _, absl::make_optional(Protocol::Http2)))
+        .WillOnce(SaveArg<0>(&encoder));
+    runOrigin();
+    EXPECT_NE(nullptr, encoder);
+    EXPECT_NE(&upstream_encoder_, encoder);
+    return encoder;
+  }
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Event::MockDispatcher> owner_dispatcher_{"owner"};
+  std::list<Event::PostCb> origin_posts_;
+  std::list<Event::PostCb> owner_posts_;
+  std::shared_ptr<NiceMock<Upstream::MockHost>> host_{new NiceMock<Upstream::MockHost>()};
+  NiceMock<ConnectionPool::MockInstance> owner_pool_mock_;
+  ConnectionPool::Instance* owner_pool_{&owner_pool_mock_};
+  std::unique_ptr<CrossWorkerConnPool> pool_;
+
+  MockResponseDecoder decoder_;
+  ConnectionPool::MockCallbacks callbacks_;
+  Envoy::ConnectionPool::MockCancellable owner_cancellable_;
+  ResponseDecoder* owner_decoder_{};
+  ConnectionPool::Callbacks* owner_callbacks_{};
+  NiceMock<MockRequestEncoder> upstream_encoder_;
+  NiceMock<StreamInfo::MockStreamInfo> owner_stream_info_;
+};
+
+TEST_F(CrossWorkerConnPoolTest, ForwardsStream) {
+  RequestEncoder* encoder = startReadyStream();
+  testing::MockFunction<void()> idle_callback;
+  pool_->addIdleCallback(idle_callback.AsStdFunction());
+
+  // The request is encoded on the owning worker.
+  TestRequestHeaderMapImpl request_headers{
+      {":method", "GET"}, {":path", "/"}, {":authority", "host"}};
+  EXPECT_TRUE(encoder->encodeHeaders(request_headers, false).ok());
+  Buffer::OwnedImpl request_body("request");
+  encoder->encodeData(request_body, true);
+  EXPECT_EQ(0, request_body.length());
+  EXPECT_CALL(upstream_encoder_, encodeHeaders(HeaderMapEqualRef(&request_headers), false));
+  EXPECT_CALL(upstream_encoder_, encodeData(BufferStringEqual("request"), true));
+  runOwner();
+
+  // The response is decoded on the origin worker.
+  owner_decoder_->decodeHeaders(
+      ResponseHeaderMapPtr{new TestResponseHeaderMapImpl{{":status", "200"}}}, false);
+  Buffer::OwnedImpl response_body("response");
+  owner_decoder_->decodeData(response_body, true);
+  EXPECT_CALL(decoder_, decodeHeaders_(NotNull(), false));
+  EXPECT_CALL(decoder_, decodeData(BufferStringEqual("response"), true));
+  EXPECT_CALL(idle_callback, Call());
+  runOrigin();
+  EXPECT_TRUE(pool_->isIdle());
+}
+
+TEST_F(CrossWorkerConnPoolTest, TrailersAndMetadata) {
+  RequestEncoder* encoder = startReadyStream();
+
+  TestRequestHeaderMapImpl request_headers{
+      {":method", "POST"}, {":path", "/"}, {":authority", "host"}};
+  EXPECT_TRUE(encoder->encodeHeaders(request_headers, false).ok());
+  MetadataMapVector metadata_map_vector;
+  metadata_map_vector.push_back(std::make_unique<MetadataMap>(MetadataMap{{"key", "value"}}));
+  encoder->encodeMetadata(metadata_map_vector);
+  TestRequestTrailerMapImpl request_trailers{{"trailer", "value"}};
+  encoder->encodeTrailers(request_trailers);
+  EXPECT_CALL(upstream_encoder_, encodeHeaders(_, false));
+  EXPECT_CALL(upstream_encoder_, encodeMetadata(_))
+      .WillOnce(Invoke([](const MetadataMapVector& forwarded) {
+        ASSERT_EQ(1, forwarded.size());
+        EXPECT_EQ("value", forwarded[0]->at("key"));
+      }));
+  EXPECT_CALL(upstream_encoder_, encodeTrailers(HeaderMapEqualRef(&request_trailers)));
+  runOwner();
+
+  owner_decoder_->decodeHeaders(
+      ResponseHeaderMapPtr{new TestResponseHeaderMapImpl{{":status", "200"}}}, false);
+  owner_decoder_->decodeTrailers(
+      ResponseTrailerMapPtr{new TestResponseTrailerMapImpl{{"trailer", "value"}}});
+  EXPECT_CALL(decoder_, decodeHeaders_(NotNull(), false));
+  EXPECT_CALL(decoder_, decodeTrailers_(NotNull()));
+  runOrigin();
+  EXPECT_TRUE(pool_->isIdle());
+}
+
+TEST_F(CrossWorkerConnPoolTest, PoolFailure) {
+  EXPECT_CALL(owner_pool_mock_, newStream(_, _))
+      .WillOnce(Invoke([this](ResponseDecoder&, ConnectionPool::Callbacks& callbacks)
+                           -> ConnectionPool::Cancellable* {
+        callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::Timeout, "timeout", host_);
+        return nullptr;
+      }));
+  EXPECT_NE(nullptr, pool_->newStream(decoder_, callbacks_));
+  runOwner();
+
+  EXPECT_CALL(callbacks_,
+              onPoolFailure(ConnectionPool::PoolFailureReason::Timeout, "timeout", _));
+  runOrigin();
+  EXPECT_TRUE(pool_->isIdle());
+}
+
+TEST_F(CrossWorkerConnPoolTest, NoOwnerPool) {
+  owner_pool_ = nullptr;
+  EXPECT_NE(nullptr, pool_->newStream(decoder_, callbacks_));
+  runOwner();
+
+  EXPECT_CALL(callbacks_,
+              onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure, _, _));
+  runOrigin();
+  EXPECT_TRUE(pool_->isIdle());
+}
+
+TEST_F(CrossWorkerConnPoolTest, CancelBeforeReady) {
+  ConnectionPool::Cancellable* handle = startStream();
+  handle->cancel(Envoy::ConnectionPool::CancelPolicy::CloseExcess);
+  EXPECT_TRUE(pool_->isIdle());
+
+  EXPECT_CALL(owner_cancellable_, cancel(Envoy::ConnectionPool::CancelPolicy::CloseExcess));
+  runOwner();
+}
+
+TEST_F(CrossWorkerConnPoolTest, CancelAfterReadyOnOwner) {
+  ConnectionPool::Cancellable* handle = startStream();
+  owner_callbacks_->onPoolReady(upstream_encoder_, host_, owner_stream_info_, Protocol::Http2);
+  handle->cancel(Envoy::ConnectionPool::CancelPolicy::Default);
+
+  // The stream became ready before the cancellation reached the owning worker, so it is reset.
+  EXPECT_CALL(upstream_encoder_.stream_, resetStream(StreamResetReason::LocalReset));
+  runOwner();
+  EXPECT_CALL(callbacks_, onPoolReady(_, _, _, _)).Times(0);
+  runOrigin();
+}
+
+TEST_F(CrossWorkerConnPoolTest, LocalReset) {
+  RequestEncoder* encoder = startReadyStream();
+  MockStreamCallbacks stream_callbacks;
+  encoder->getStream().addCallbacks(stream_callbacks);
+
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::LocalReset, _));
+  encoder->getStream().resetStream(StreamResetReason::LocalReset);
+  EXPECT_TRUE(pool_->isIdle());
+
+  EXPECT_CALL(upstream_encoder_.stream_, resetStream(StreamResetReason::LocalReset));
+  runOwner();
+}
+
+TEST_F(CrossWorkerConnPoolTest, RemoteReset) {
+  RequestEncoder* encoder = startReadyStream();
+  MockStreamCallbacks stream_callbacks;
+  encoder->getStream().addCallbacks(stream_callbacks);
+
+  upstream_encoder_.stream_.resetStream(StreamResetReason::RemoteReset);
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::RemoteReset, _));
+  runOrigin();
+  EXPECT_TRUE(pool_->isIdle());
+}
+
+TEST_F(CrossWorkerConnPoolTest, FlowControl) {
+  RequestEncoder* encoder = startReadyStream();
+  MockStreamCallbacks stream_callbacks;
+  encoder->getStream().addCallbacks(stream_callbacks);
+
+  upstream_encoder_.stream_.runHighWatermarkCallbacks();
+  EXPECT_CALL(stream_callbacks, onAboveWriteBufferHighWatermark());
+  runOrigin();
+  upstream_encoder_.stream_.runLowWatermarkCallbacks();
+  EXPECT_CALL(stream_callbacks, onBelowWriteBufferLowWatermark());
+  runOrigin();
+
+  encoder->getStream().readDisable(true);
+  EXPECT_CALL(upstream_encoder_.stream_, readDisable(true));
+  runOwner();
+}
+
+TEST_F(CrossWorkerConnPoolTest, DestroyedWithOpenStream) {
+  startReadyStream();
+  pool_.reset();
+
+  EXPECT_CALL(upstream_encoder_.stream_, resetStream(StreamResetReason::LocalReset));
+  runOwner();
+}
+
+TEST_F(CrossWorkerConnPoolTest, DrainWhenIdle) {
+  testing::MockFunction<void()> idle_callback;
+  pool_->addIdleCallback(idle_callback.AsStdFunction());
+  EXPECT_CALL(idle_callback, Call());
+  pool_->startDrain();
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
@@ -15,6 +15,7 @@
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/local_reply/mocks.h"
 #include "test/mocks/network/mocks.h"
+#include "test/mocks/stats/mocks.h"
 
 #include "gtest/gtest.h"
 
@@ -272,6 +273,73 @@ TEST_F(FilterManagerTest, MatchTreeSkipActionRequestAndResponseHeaders) {
   filter_manager_->destroyFilters();
 }
 
+// Verify that a filter which skips its remaining callbacks after the request headers sees none of
+// the rest of the stream, while the other filters see all of it.
+TEST_F(FilterManagerTest, SkipRemainingCallbacks) {
+  initialize();
+
+  EXPECT_CALL(dispatcher_, pushTrackedObject(_));
+  EXPECT_CALL(dispatcher_, popTrackedObject(_));
+
+  auto stream_filter = std::make_shared<MockStreamFilter>();
+  EXPECT_CALL(*stream_filter, setDecoderFilterCallbacks(_));
+  EXPECT_CALL(*stream_filter, setEncoderFilterCallbacks(_));
+  EXPECT_CALL(*stream_filter, onDestroy());
+  EXPECT_CALL(*stream_filter, decodeHeaders(_, false))
+      .WillOnce(Invoke([&](RequestHeaderMap&, bool) -> FilterHeadersStatus {
+        stream_filter->decoder_callbacks_->skipRemainingCallbacks();
+        stream_filter->encoder_callbacks_->skipRemainingCallbacks();
+        return FilterHeadersStatus::Continue;
+      }));
+  EXPECT_CALL(*stream_filter, decodeData(_, _)).Times(0);
+  EXPECT_CALL(*stream_filter, decodeTrailers(_)).Times(0);
+  EXPECT_CALL(*stream_filter, decodeComplete()).Times(0);
+  EXPECT_CALL(*stream_filter, encodeHeaders(_, _)).Times(0);
+  EXPECT_CALL(*stream_filter, encodeData(_, _)).Times(0);
+  EXPECT_CALL(*stream_filter, encodeComplete()).Times(0);
+
+  auto decoder_filter = std::make_shared<Envoy::Http::MockStreamDecoderFilter>();
+  EXPECT_CALL(*decoder_filter, setDecoderFilterCallbacks(_));
+  EXPECT_CALL(*decoder_filter, onDestroy());
+  EXPECT_CALL(*decoder_filter, decodeHeaders(_, false))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  EXPECT_CALL(*decoder_filter, decodeData(_, false)).WillOnce(Return(FilterDataStatus::Continue));
+  EXPECT_CALL(*decoder_filter, decodeTrailers(_))
+      .WillOnce(Invoke([&](RequestTrailerMap&) -> FilterTrailersStatus {
+        ResponseHeaderMapPtr headers{new TestResponseHeaderMapImpl{{":status", "200"}}};
+        decoder_filter->callbacks_->encodeHeaders(std::move(headers), false, "details");
+        Buffer::OwnedImpl data("data");
+        decoder_filter->callbacks_->encodeData(data, true);
+        return FilterTrailersStatus::StopIteration;
+      }));
+  EXPECT_CALL(*decoder_filter, decodeComplete());
+
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillRepeatedly(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.addStreamFilter(stream_filter);
+        callbacks.addStreamDecoderFilter(decoder_filter);
+      }));
+
+  RequestHeaderMapPtr headers{
+      new TestRequestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "GET"}}};
+  ON_CALL(filter_manager_callbacks_, requestHeaders())
+      .WillByDefault(Return((makeOptRef(*headers))));
+  filter_manager_->createFilterChain();
+
+  EXPECT_CALL(filter_manager_callbacks_, encodeHeaders(_, false));
+  EXPECT_CALL(filter_manager_callbacks_, encodeData(_, true));
+  EXPECT_CALL(filter_manager_callbacks_, endStream());
+
+  filter_manager_->requestHeadersInitialized();
+  filter_manager_->decodeHeaders(*headers, false);
+  Buffer::OwnedImpl data("data");
+  filter_manager_->decodeData(data, false);
+  RequestTrailerMapPtr trailers{new TestRequestTrailerMapImpl{{"trailer", ""}}};
+  filter_manager_->decodeTrailers(*trailers);
+
+  filter_manager_->destroyFilters();
+}
+
 // Verify that we propagate custom match actions to a decoding filter.
 TEST_F(FilterManagerTest, MatchTreeFilterActionDecodingHeaders) {
   initialize();
@@ -567,6 +635,42 @@ TEST_F(FilterManagerTest, ResetIdleTimer) {
   filter_manager_->destroyFilters();
 }
 
+// Verifies that the cost of each filter of a sampled stream is recorded once the filters are
+// destroyed.
+TEST_F(FilterManagerTest, RecordFilterCosts) {
+  initialize();
+
+  std::shared_ptr<MockStreamDecoderFilter> decoder_filter(new NiceMock<MockStreamDecoderFilter>());
+  std::shared_ptr<MockStreamFilter> stream_filter(new NiceMock<MockStreamFilter>());
+  NiceMock<Stats::MockHistogram> decoder_filter_cpu_time;
+  NiceMock<Stats::MockHistogram> stream_filter_cpu_time;
+
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.recordFilterCost(decoder_filter_cpu_time);
+        callbacks.addStreamDecoderFilter(decoder_filter);
+        callbacks.recordFilterCost(stream_filter_cpu_time);
+        callbacks.addStreamFilter(stream_filter);
+      }));
+  filter_manager_->createFilterChain();
+
+  RequestHeaderMapPtr headers{
+      new TestRequestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "GET"}}};
+  ON_CALL(filter_manager_callbacks_, requestHeaders())
+      .WillByDefault(Return(makeOptRef(*headers)));
+  filter_manager_->requestHeadersInitialized();
+  EXPECT_CALL(*decoder_filter, decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::Continue));
+  EXPECT_CALL(*stream_filter, decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  filter_manager_->decodeHeaders(*headers, true);
+
+  // The cost of the dual filter is recorded once.
+  EXPECT_CALL(decoder_filter_cpu_time, recordValue(_));
+  EXPECT_CALL(stream_filter_cpu_time, recordValue(_));
+  filter_manager_->destroyFilters();
+}
+
 } // namespace
 } // namespace Http
 } // namespace Envoy
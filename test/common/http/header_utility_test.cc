@@ -690,6 +690,24 @@ TEST(HeaderIsValidTest, ValidHeaderValuesAreAccepted) {
   EXPECT_TRUE(HeaderUtility::headerValueIsValid("Some Other Value"));
 }
 
+// Values are validated 16 bytes at a time with a per-byte tail, so place every byte value at
+// every position of values spanning several blocks.
+TEST(HeaderIsValidTest, AllBytesAtAllPositions) {
+  for (size_t length = 1; length <= 40; length++) {
+    for (size_t position = 0; position < length; position++) {
+      for (int c = 0; c < 256; c++) {
+        std::string value(length, 'a');
+        value[position] = static_cast<char>(c);
+        const bool expected = (c >= 0x20 || c == '\t') && c != 0x7f;
+        EXPECT_EQ(expected, HeaderUtility::headerValueIsValid(value))
+            << "byte " << c << " at " << position << " of " << length;
+      }
+    }
+  }
+  EXPECT_TRUE(HeaderUtility::headerValueIsValid(""));
+  EXPECT_TRUE(HeaderUtility::headerValueIsValid(std::string(64, '\x80')));
+}
+
 TEST(HeaderIsValidTest, AuthorityIsValid) {
   EXPECT_TRUE(HeaderUtility::authorityIsValid("strangebutlegal$-%&'"));
   EXPECT_FALSE(HeaderUtility::authorityIsValid("illegal{}"));
@@ -273,6 +273,113 @@ TEST_F(Http1ConnPoolImplTest, DrainConnections) {
   dispatcher_.clearDeferredDeleteList();
 }
 
+/**
+ * Verify that the connection which became idle last is reused first.
+ */
+TEST_F(Http1ConnPoolImplTest, ReuseLastIdleConnection) {
+  cluster_->resetResourceManager(2, 1024, 1024, 1, 1);
+  InSequence s;
+
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::CreateConnection);
+  r1.startRequest();
+  ActiveTestRequest r2(*this, 1, ActiveTestRequest::Type::CreateConnection);
+  r2.startRequest();
+
+  conn_pool_->expectEnableUpstreamReady();
+  r1.completeResponse(false);
+  conn_pool_->expectEnableUpstreamReady();
+  r2.completeResponse(false);
+  conn_pool_->expectAndRunUpstreamReady();
+
+  // The second connection became idle last, so the next request uses it.
+  ActiveTestRequest r3(*this, 1, ActiveTestRequest::Type::Immediate);
+  r3.startRequest();
+  conn_pool_->expectEnableUpstreamReady();
+  r3.completeResponse(false);
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_idle_overflow_.value());
+
+  EXPECT_CALL(*conn_pool_, onClientDestroy()).Times(2);
+  conn_pool_->expectAndRunUpstreamReady();
+  conn_pool_->drainConnections();
+  dispatcher_.clearDeferredDeleteList();
+}
+
+/**
+ * Verify that the connections idle for the longest are closed over the maximum idle connections.
+ */
+TEST_F(Http1ConnPoolImplTest, MaxIdleConnections) {
+  cluster_->resetResourceManager(2, 1024, 1024, 1, 1);
+  cluster_->common_http_protocol_options_.mutable_max_idle_connections()->set_value(1);
+  InSequence s;
+
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::CreateConnection);
+  r1.startRequest();
+  ActiveTestRequest r2(*this, 1, ActiveTestRequest::Type::CreateConnection);
+  r2.startRequest();
+
+  // A single idle connection is kept.
+  conn_pool_->expectEnableUpstreamReady();
+  r1.completeResponse(false);
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_idle_overflow_.value());
+
+  // The first connection is idle for longer, so it is closed.
+  conn_pool_->expectEnableUpstreamReady();
+  r2.completeResponse(false);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_idle_overflow_.value());
+  EXPECT_CALL(*conn_pool_, onClientDestroy());
+  dispatcher_.clearDeferredDeleteList();
+  conn_pool_->expectAndRunUpstreamReady();
+
+  // The second connection is now the first test client, and is reused.
+  ActiveTestRequest r3(*this, 0, ActiveTestRequest::Type::Immediate);
+  r3.startRequest();
+  conn_pool_->expectEnableUpstreamReady();
+  r3.completeResponse(false);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_idle_overflow_.value());
+
+  EXPECT_CALL(*conn_pool_, onClientDestroy());
+  conn_pool_->expectAndRunUpstreamReady();
+  conn_pool_->test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+}
+
+/**
+ * Verify that idle connections are kept while streams are pending.
+ */
+TEST_F(Http1ConnPoolImplTest, MaxIdleConnectionsWithPendingStreams) {
+  cluster_->resetResourceManager(2, 1024, 1024, 1, 1);
+  cluster_->common_http_protocol_options_.mutable_max_idle_connections()->set_value(1);
+  InSequence s;
+
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::CreateConnection);
+  r1.startRequest();
+  ActiveTestRequest r2(*this, 1, ActiveTestRequest::Type::CreateConnection);
+  r2.startRequest();
+  // Both connections are busy and the circuit breaker allows no more, so this request is pending.
+  ActiveTestRequest r3(*this, 0, ActiveTestRequest::Type::Pending);
+
+  conn_pool_->expectEnableUpstreamReady();
+  r1.completeResponse(false);
+  conn_pool_->expectEnableUpstreamReady();
+  r2.completeResponse(false);
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_idle_overflow_.value());
+
+  // The pending request is attached to the connection which became idle last.
+  r3.client_index_ = 1;
+  r3.expectNewStream();
+  conn_pool_->expectAndRunUpstreamReady();
+  r3.startRequest();
+
+  conn_pool_->expectEnableUpstreamReady();
+  r3.completeResponse(false);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_idle_overflow_.value());
+
+  EXPECT_CALL(*conn_pool_, onClientDestroy()).Times(2);
+  conn_pool_->expectAndRunUpstreamReady();
+  conn_pool_->drainConnections();
+  dispatcher_.clearDeferredDeleteList();
+}
+
 /**
  * Test all timing stats are set.
  */
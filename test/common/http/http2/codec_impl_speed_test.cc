@@ -0,0 +1,164 @@
+// Measures sending a request through an HTTP/2 client connection into a server connection and an
+// empty response back, with a number of added headers like a route's request_headers_to_add,
+// either copied into the request or added by reference as HeaderParser does for static values.
+//
+// The frames counter is the rate of HEADERS frames decoded, and bytes_copied is the number of
+// bytes of decoded header names and values per round trip which were copied rather than
+// referenced.
+
+#include <string>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/http/utility.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/common/http/http2/codec_impl_test_util.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+namespace {
+
+// A client and server connection which write into each other's input buffer.
+class CodecPair {
+public:
+  CodecPair()
+      : http2_options_(::Envoy::Http2::Utility::initializeAndValidateOptions(
+            envoy::config::core::v3::Http2ProtocolOptions())),
+        client_(client_connection_, client_callbacks_, client_stats_store_, http2_options_,
+                random_, Http::DEFAULT_MAX_REQUEST_HEADERS_KB, Http::DEFAULT_MAX_HEADERS_COUNT,
+                ProdNghttp2SessionFactory::get()),
+        server_(server_connection_, server_callbacks_, server_stats_store_, http2_options_,
+                random_, Http::DEFAULT_MAX_REQUEST_HEADERS_KB, Http::DEFAULT_MAX_HEADERS_COUNT,
+                envoy::config::core::v3::HttpProtocolOptions::ALLOW) {
+    ON_CALL(client_connection_, write(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) { to_server_.move(data); }));
+    ON_CALL(server_connection_, write(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) { to_client_.move(data); }));
+    ON_CALL(server_callbacks_, newStream(_, _))
+        .WillByDefault(Invoke([this](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+          response_encoder_ = &encoder;
+          return request_decoder_;
+        }));
+    ON_CALL(request_decoder_, decodeHeaders_(_, true))
+        .WillByDefault(Invoke([this](RequestHeaderMapPtr& headers, bool) {
+          countDecoded(*headers);
+          response_encoder_->encodeHeaders(*response_headers_, true);
+        }));
+    ON_CALL(response_decoder_, decodeHeaders_(_, _))
+        .WillByDefault(
+            Invoke([this](ResponseHeaderMapPtr& headers, bool) { countDecoded(*headers); }));
+    response_headers_->setStatus(200);
+  }
+
+  void roundTrip(const RequestHeaderMap& request_headers) {
+    RequestEncoder& encoder = client_.newStream(response_decoder_);
+    encoder.encodeHeaders(request_headers, true).IgnoreError();
+    server_.dispatch(to_server_).IgnoreError();
+    client_.dispatch(to_client_).IgnoreError();
+    // The closed streams.
+    client_connection_.dispatcher_.to_delete_.clear();
+    server_connection_.dispatcher_.to_delete_.clear();
+  }
+
+  void resetCounts() {
+    frames_ = 0;
+    bytes_copied_ = 0;
+  }
+  uint64_t frames() const { return frames_; }
+  uint64_t bytesCopied() const { return bytes_copied_; }
+
+private:
+  void countDecoded(const HeaderMap& headers) {
+    frames_++;
+    headers.iterate([this](const HeaderEntry& header) -> HeaderMap::Iterate {
+      if (!header.key().isReference()) {
+        bytes_copied_ += header.key().size();
+      }
+      if (!header.value().isReference()) {
+        bytes_copied_ += header.value().size();
+      }
+      return HeaderMap::Iterate::Continue;
+    });
+  }
+
+  const envoy::config::core::v3::Http2ProtocolOptions http2_options_;
+  Stats::IsolatedStoreImpl client_stats_store_;
+  Stats::IsolatedStoreImpl server_stats_store_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  NiceMock<Network::MockConnection> client_connection_;
+  NiceMock<Network::MockConnection> server_connection_;
+  NiceMock<MockConnectionCallbacks> client_callbacks_;
+  NiceMock<MockServerConnectionCallbacks> server_callbacks_;
+  NiceMock<MockResponseDecoder> response_decoder_;
+  NiceMock<MockRequestDecoder> request_decoder_;
+  ResponseEncoder* response_encoder_{};
+  const ResponseHeaderMapPtr response_headers_{ResponseHeaderMapImpl::create()};
+  TestClientConnectionImpl client_;
+  TestServerConnectionImpl server_;
+  Buffer::OwnedImpl to_server_;
+  Buffer::OwnedImpl to_client_;
+  uint64_t frames_{};
+  uint64_t bytes_copied_{};
+};
+
+// state.range(0) is the number of added headers, and state.range(1) is non-zero if they are added
+// by reference.
+void bmRequestRoundTrip(::benchmark::State& state) {
+  const int64_t added_headers = state.range(0);
+  const bool by_reference = state.range(1) != 0;
+
+  std::vector<LowerCaseString> keys;
+  std::vector<std::string> values;
+  for (int64_t i = 0; i < added_headers; i++) {
+    keys.emplace_back(absl::StrCat("x-added-header-", i));
+    values.push_back(absl::StrCat("added-header-value-", i));
+  }
+
+  RequestHeaderMapPtr request_headers = RequestHeaderMapImpl::create();
+  request_headers->setMethod("POST");
+  request_headers->setPath("/envoy.service.Service/Method");
+  request_headers->setScheme("https");
+  request_headers->setHost("service.example.com");
+  for (int64_t i = 0; i < added_headers; i++) {
+    if (by_reference) {
+      request_headers->addReference(keys[i], values[i]);
+    } else {
+      request_headers->addCopy(keys[i], values[i]);
+    }
+  }
+
+  CodecPair codecs;
+  // Exchange the connection prefaces and SETTINGS before measuring.
+  codecs.roundTrip(*request_headers);
+  codecs.resetCounts();
+
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    codecs.roundTrip(*request_headers);
+  }
+  state.counters["frames"] = ::benchmark::Counter(codecs.frames(), ::benchmark::Counter::kIsRate);
+  state.counters["bytes_copied"] =
+      ::benchmark::Counter(codecs.bytesCopied(), ::benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(bmRequestRoundTrip)
+    ->Args({0, 0})
+    ->Args({10, 0})
+    ->Args({10, 1})
+    ->Args({30, 0})
+    ->Args({30, 1});
+
+} // namespace
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
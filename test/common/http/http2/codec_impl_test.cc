@@ -362,6 +362,28 @@ TEST_P(Http2CodecImplTest, ShutdownNotice) {
   response_encoder_->encodeHeaders(response_headers, true);
 }
 
+// Names and values decoded from the HPACK static table are referenced rather than copied.
+TEST_P(Http2CodecImplTest, StaticTableHeadersAreReferenced) {
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  request_headers.addCopy("x-custom", "custom-value");
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true))
+      .WillOnce(Invoke([](RequestHeaderMapPtr& headers, bool) {
+        EXPECT_EQ("GET", headers->getMethodValue());
+        EXPECT_TRUE(headers->Method()->value().isReference());
+        EXPECT_EQ("host", headers->getHostValue());
+        EXPECT_FALSE(headers->Host()->value().isReference());
+        const auto custom = headers->get(LowerCaseString("x-custom"));
+        ASSERT_EQ(1, custom.size());
+        EXPECT_FALSE(custom[0]->key().isReference());
+        EXPECT_EQ("custom-value", custom[0]->value().getStringView());
+        EXPECT_FALSE(custom[0]->value().isReference());
+      }));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+}
+
 TEST_P(Http2CodecImplTest, ProtocolErrorForTest) {
   initialize();
   EXPECT_EQ(absl::nullopt, request_encoder_->http1StreamEncoderOptions());
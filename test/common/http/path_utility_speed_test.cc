@@ -0,0 +1,75 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+#include <vector>
+
+#include "source/common/http/header_map_impl.h"
+#include "source/common/http/path_utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+
+// Typical request paths, which are already canonical.
+static const std::vector<std::string>& canonicalPaths() {
+  static const std::vector<std::string>* paths = new std::vector<std::string>{
+      "/",
+      "/index.html",
+      "/api/v1/users/12345/profile",
+      "/static/js/app.3f2a1b.min.js?v=20210801",
+      "/search/results?q=envoy+proxy&page=2&sort=relevance&lang=en-US",
+  };
+  return *paths;
+}
+
+// Paths rewritten by the normalization.
+static const std::vector<std::string>& otherPaths() {
+  static const std::vector<std::string>* paths = new std::vector<std::string>{
+      "/api/v1/../v2/users",
+      "/static/./js/app.js",
+      "/a/b/%2E%2E/c?d=e",
+      "/search//results",
+  };
+  return *paths;
+}
+
+// Runs the normalization of the connection manager, with merge_slashes enabled, on each path.
+static void normalizePaths(benchmark::State& state, const std::vector<std::string>& paths) {
+  RequestHeaderMapPtr headers = RequestHeaderMapImpl::create();
+  for (auto _ : state) { // NOLINT
+    for (const std::string& path : paths) {
+      headers->setPath(path);
+      benchmark::DoNotOptimize(PathUtil::canonicalPath(*headers));
+      PathUtil::mergeSlashes(*headers);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * paths.size());
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_NormalizeCanonicalPaths(benchmark::State& state) {
+  normalizePaths(state, canonicalPaths());
+}
+BENCHMARK(BM_NormalizeCanonicalPaths);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_NormalizeOtherPaths(benchmark::State& state) {
+  normalizePaths(state, otherPaths());
+}
+BENCHMARK(BM_NormalizeOtherPaths);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_IsCanonicalPath(benchmark::State& state) {
+  for (auto _ : state) { // NOLINT
+    for (const std::string& path : canonicalPaths()) {
+      benchmark::DoNotOptimize(PathUtil::isCanonicalPath(PathUtil::removeQueryAndFragment(path)));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * canonicalPaths().size());
+}
+BENCHMARK(BM_IsCanonicalPath);
+
+} // namespace Http
+} // namespace Envoy
@@ -2,10 +2,12 @@
 #include <utility>
 #include <vector>
 
+#include "source/common/http/legacy_path_canonicalizer.h"
 #include "source/common/http/path_utility.h"
 
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -38,6 +40,44 @@ TEST_F(PathUtilityTest, AlreadyNormalPaths) {
   }
 }
 
+// Canonical paths are detected without the canonicalizer.
+TEST_F(PathUtilityTest, IsCanonicalPath) {
+  const std::vector<std::string> canonical_paths{
+      "/", "/xyz", "/x/y/z/", "/index.html", "/.well-known/a", "/a/...", "/a/..b/.c", "/a:b;c=d@e"};
+  for (const auto& path : canonical_paths) {
+    EXPECT_TRUE(PathUtil::isCanonicalPath(path)) << "path: " << path;
+  }
+  const std::vector<std::string> other_paths{"",       "xyz",    "/.",         "/..",
+                                             "/a/./b", "/a/../", "/a/b/%2E%2E", "/a\\b",
+                                             "/a b",   "/a#b",   "/a?b",       "/a\x80"};
+  for (const auto& path : other_paths) {
+    EXPECT_FALSE(PathUtil::isCanonicalPath(path)) << "path: " << path;
+  }
+}
+
+// The paths detected as canonical are left unchanged by the canonicalizer.
+TEST_F(PathUtilityTest, IsCanonicalPathMatchesCanonicalizer) {
+  for (int c = 1; c < 256; c++) {
+    for (const std::string& path :
+         {absl::StrCat("/a", std::string(1, c), "b"), absl::StrCat("/", std::string(1, c)),
+          absl::StrCat("/", std::string(1, c), std::string(1, c), "/")}) {
+      if (PathUtil::isCanonicalPath(path)) {
+        EXPECT_EQ(path, LegacyPathCanonicalizer::canonicalizePath(path).value_or(""));
+      }
+    }
+  }
+}
+
+// Already normalized paths with a query don't change.
+TEST_F(PathUtilityTest, AlreadyNormalPathsWithQuery) {
+  const std::vector<std::string> normal_paths{"/xyz?a=../b", "/x/y/z.html?%2e%2e"};
+  for (const auto& path : normal_paths) {
+    auto& path_header = pathHeaderEntry(path);
+    EXPECT_TRUE(PathUtil::canonicalPath(headers_)) << "original path: " << path;
+    EXPECT_EQ(path_header.value().getStringView(), absl::string_view(path));
+  }
+}
+
 // Invalid paths are rejected.
 TEST_F(PathUtilityTest, InvalidPaths) {
   const std::vector<std::string> invalid_paths{"/xyz/.%00../abc", "/xyz/%00.%00./abc",
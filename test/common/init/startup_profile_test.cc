@@ -0,0 +1,165 @@
+#include "source/common/init/manager_impl.h"
+#include "source/common/init/startup_profile.h"
+
+#include "test/mocks/init/mocks.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Property;
+
+namespace Envoy {
+namespace Init {
+namespace {
+
+class StartupProfileTest : public testing::Test {
+protected:
+  void advance(uint64_t ms) { time_system_.advanceTimeWait(std::chrono::milliseconds(ms)); }
+
+  envoy::admin::v3::StartupProfile expectedDump(const std::string& yaml) {
+    envoy::admin::v3::StartupProfile expected;
+    TestUtility::loadFromYaml(yaml, expected);
+    return expected;
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<Stats::MockIsolatedStatsStore> store_;
+};
+
+TEST_F(StartupProfileTest, Dump) {
+  StartupProfile profile(time_system_);
+  advance(1);
+  const StartupProfile::StepId phase = profile.begin(StartupProfile::Kind::Phase, "phase");
+  advance(2);
+  const StartupProfile::StepId cluster =
+      profile.begin(StartupProfile::Kind::Cluster, "cluster", phase);
+  advance(3);
+  profile.end(cluster);
+  profile.end(phase);
+  profile.begin(StartupProfile::Kind::Xds, "xds");
+  advance(4);
+  // Ending a step twice keeps the first end.
+  profile.end(cluster);
+  profile.end(StartupProfile::NoStep);
+
+  envoy::admin::v3::StartupProfile dump;
+  profile.dump(dump);
+  EXPECT_THAT(dump, ProtoEq(expectedDump(R"EOF(
+startup:
+  name: total
+  start: 0s
+  steps:
+  - name: phase
+    start: 0.001s
+    duration: 0.005s
+    steps:
+    - name: cluster
+      start: 0.003s
+      duration: 0.003s
+  - name: xds
+    start: 0.006s
+)EOF")));
+}
+
+TEST_F(StartupProfileTest, Complete) {
+  StartupProfile profile(time_system_);
+  const StartupProfile::StepId phase = profile.begin(StartupProfile::Kind::Phase, "phase");
+  const StartupProfile::StepId cluster =
+      profile.begin(StartupProfile::Kind::Cluster, "cluster", phase);
+  const StartupProfile::StepId target = profile.begin(StartupProfile::Kind::InitTarget, "target");
+  profile.begin(StartupProfile::Kind::Xds, "xds");
+  advance(5);
+  profile.end(cluster);
+  profile.end(target);
+  advance(5);
+  profile.end(phase);
+
+  EXPECT_CALL(store_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name, "server.startup.total_time_ms"), 10));
+  EXPECT_CALL(store_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name, "server.startup.phase_time_ms"), 10));
+  EXPECT_CALL(store_,
+              deliverHistogramToSinks(
+                  Property(&Stats::Metric::name, "server.startup.cluster_warm_time_ms"), 5));
+  EXPECT_CALL(store_,
+              deliverHistogramToSinks(
+                  Property(&Stats::Metric::name, "server.startup.init_target_time_ms"), 5));
+  // The xDS step had not ended, so it is not recorded.
+  EXPECT_CALL(store_,
+              deliverHistogramToSinks(
+                  Property(&Stats::Metric::name, "server.startup.xds_first_update_time_ms"), _))
+      .Times(0);
+  EXPECT_FALSE(profile.completed());
+  profile.complete(store_);
+  EXPECT_TRUE(profile.completed());
+
+  // Steps are no longer recorded once startup is complete.
+  EXPECT_EQ(StartupProfile::NoStep, profile.begin(StartupProfile::Kind::Phase, "later"));
+  profile.complete(store_);
+  envoy::admin::v3::StartupProfile dump;
+  profile.dump(dump);
+  EXPECT_EQ(3, dump.startup().steps_size());
+  EXPECT_EQ(10, DurationUtil::durationToMilliseconds(dump.startup().duration()));
+}
+
+TEST_F(StartupProfileTest, NoSingleton) {
+  EXPECT_EQ(StartupProfile::NoStep,
+            StartupProfile::beginStep(StartupProfile::Kind::Phase, "phase"));
+  StartupProfile::endStep(StartupProfile::NoStep);
+}
+
+// The init manager records itself and each of its targets as they initialize.
+TEST_F(StartupProfileTest, InitManager) {
+  ScopedStartupProfileSingleton profile(std::make_unique<StartupProfile>(time_system_));
+
+  ManagerImpl m("test");
+  ExpectableTargetImpl t1("t1");
+  m.add(t1);
+  ExpectableTargetImpl t2("t2");
+  m.add(t2);
+  ExpectableWatcherImpl w;
+
+  t1.expectInitialize();
+  t2.expectInitializeWillCallReady();
+  m.initialize(w);
+  advance(2);
+  ExpectableTargetImpl t3("t3");
+  t3.expectInitialize();
+  m.add(t3);
+  advance(1);
+  t3.ready();
+  advance(1);
+  w.expectReady();
+  t1.ready();
+
+  envoy::admin::v3::StartupProfile dump;
+  StartupProfileSingleton::getExisting()->dump(dump);
+  EXPECT_THAT(dump, ProtoEq(expectedDump(R"EOF(
+startup:
+  name: total
+  start: 0s
+  steps:
+  - name: init manager test
+    start: 0s
+    duration: 0.004s
+    steps:
+    - name: target t1
+      start: 0s
+      duration: 0.004s
+    - name: target t2
+      start: 0s
+      duration: 0s
+    - name: target t3
+      start: 0.002s
+      duration: 0.001s
+)EOF")));
+}
+
+} // namespace
+} // namespace Init
+} // namespace Envoy
@@ -0,0 +1,115 @@
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "source/common/io/io_uring_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Io {
+namespace {
+
+class IoUringImplTest : public testing::Test {
+public:
+  void SetUp() override {
+    if (!IoUringImpl::isIoUringSupported()) {
+      GTEST_SKIP() << "io_uring is not supported by the running kernel";
+    }
+    io_uring_ = std::make_unique<IoUringImpl>(2, false);
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds_));
+  }
+
+  void TearDown() override {
+    io_uring_.reset();
+    for (os_fd_t fd : fds_) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+  }
+
+  // Waits for the registered eventfd to become readable and collects all the completions.
+  void waitForCompletions(os_fd_t event_fd, size_t expected) {
+    while (completions_.size() < expected) {
+      struct pollfd pfd {
+        event_fd, POLLIN, 0
+      };
+      ASSERT_EQ(1, ::poll(&pfd, 1, 5000));
+      io_uring_->forEveryCompletion([this](void* user_data, int32_t result) {
+        completions_.emplace_back(user_data, result);
+      });
+    }
+  }
+
+  std::unique_ptr<IoUringImpl> io_uring_;
+  os_fd_t fds_[2]{-1, -1};
+  std::vector<std::pair<void*, int32_t>> completions_;
+};
+
+TEST_F(IoUringImplTest, RegisterEventfd) {
+  EXPECT_FALSE(io_uring_->isEventfdRegistered());
+  const os_fd_t event_fd = io_uring_->registerEventfd();
+  EXPECT_TRUE(SOCKET_VALID(event_fd));
+  EXPECT_TRUE(io_uring_->isEventfdRegistered());
+  io_uring_->unregisterEventfd();
+  EXPECT_FALSE(io_uring_->isEventfdRegistered());
+}
+
+TEST_F(IoUringImplTest, SubmitWithoutEntries) { EXPECT_EQ(IoUringResult::Ok, io_uring_->submit()); }
+
+TEST_F(IoUringImplTest, BatchedWritevAndReadv) {
+  const os_fd_t event_fd = io_uring_->registerEventfd();
+
+  std::string data = "hello world";
+  struct iovec write_iov {
+    data.data(), data.size()
+  };
+  char read_buf[32];
+  struct iovec read_iov {
+    read_buf, sizeof(read_buf)
+  };
+  int write_tag = 1;
+  int read_tag = 2;
+
+  // Both requests are handed to the kernel with a single submit().
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->prepareWritev(fds_[0], &write_iov, 1, 0, &write_tag));
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->prepareReadv(fds_[1], &read_iov, 1, 0, &read_tag));
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->submit());
+  waitForCompletions(event_fd, 2);
+
+  ASSERT_EQ(2, completions_.size());
+  for (const auto& completion : completions_) {
+    EXPECT_EQ(static_cast<int32_t>(data.size()), completion.second);
+  }
+  EXPECT_EQ(data, std::string(read_buf, data.size()));
+}
+
+TEST_F(IoUringImplTest, SubmissionQueueFull) {
+  std::string data = "a";
+  struct iovec iov {
+    data.data(), data.size()
+  };
+
+  // The ring was created with two entries.
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->prepareWritev(fds_[0], &iov, 1, 0, nullptr));
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->prepareWritev(fds_[0], &iov, 1, 0, nullptr));
+  EXPECT_EQ(IoUringResult::Failed, io_uring_->prepareWritev(fds_[0], &iov, 1, 0, nullptr));
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->submit());
+}
+
+TEST_F(IoUringImplTest, PrepareClose) {
+  const os_fd_t event_fd = io_uring_->registerEventfd();
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->prepareClose(fds_[1], nullptr));
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->submit());
+  waitForCompletions(event_fd, 1);
+  EXPECT_EQ(0, completions_[0].second);
+  fds_[1] = -1;
+}
+
+} // namespace
+} // namespace Io
+} // namespace Envoy
@@ -0,0 +1,63 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures loading JSON documents of about state.range(0) KiB, shaped like a bootstrap with many
+// clusters, with the nlohmann and the legacy RapidJSON implementations.
+
+#include <string>
+
+#include "source/common/json/json_internal.h"
+#include "source/common/json/json_internal_legacy.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Json {
+namespace {
+
+constexpr absl::string_view ClusterJson = R"EOF({
+  "name": "cluster_{0}", "connect_timeout": "0.25s", "type": "STRICT_DNS",
+  "lb_policy": "ROUND_ROBIN", "respect_dns_ttl": true,
+  "circuit_breakers": {"thresholds": [{"max_connections": 1024, "max_retries": 3}]},
+  "load_assignment": {"cluster_name": "cluster_{0}", "endpoints": [{"lb_endpoints": [
+    {"endpoint": {"address": {"socket_address": {"address": "10.0.0.1", "port_value": 80}}},
+     "load_balancing_weight": 1.5, "health_status": null},
+    {"endpoint": {"address": {"socket_address": {"address": "10.0.0.2", "port_value": 80}}},
+     "load_balancing_weight": 2.5, "health_status": null}]}]}})EOF";
+
+std::string makeDocument(size_t kib) {
+  std::string json = R"EOF({"static_resources": {"clusters": [)EOF";
+  for (size_t i = 0; json.size() < kib * 1024; i++) {
+    absl::StrAppend(&json, i == 0 ? "" : ",",
+                    absl::StrReplaceAll(ClusterJson, {{"{0}", absl::StrCat(i)}}));
+  }
+  absl::StrAppend(&json, "]}}");
+  return json;
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_NlohmannLoadFromString(benchmark::State& state) {
+  const std::string json = makeDocument(state.range(0));
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(Nlohmann::Factory::loadFromString(json));
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_NlohmannLoadFromString)->Arg(16)->Arg(1024)->Arg(8192)->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_RapidJsonLoadFromString(benchmark::State& state) {
+  const std::string json = makeDocument(state.range(0));
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(RapidJson::Factory::loadFromString(json));
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_RapidJsonLoadFromString)->Arg(16)->Arg(1024)->Arg(8192)->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace Json
+} // namespace Envoy
@@ -7,6 +7,8 @@
 
 #include "test/common/matcher/test_utility.h"
 
+#include "absl/strings/str_cat.h"
+
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -83,6 +85,34 @@ TEST_F(ExactMapMatcherTest, Match) {
   verifyImmediateMatch(result, "match");
 }
 
+TEST_F(ExactMapMatcherTest, MatchManyChildren) {
+  for (const int children : {2, 8, 9, 32}) {
+    for (const int i : {0, children - 1}) {
+      ExactMapMatcher<TestData> matcher(
+          std::make_unique<TestInput>(DataInputGetResult{
+              DataInputGetResult::DataAvailability::AllDataAvailable, absl::StrCat("match", i)}),
+          stringOnMatch<TestData>("no_match"));
+      for (int j = 0; j < children; j++) {
+        matcher.addChild(absl::StrCat("match", j), stringOnMatch<TestData>(absl::StrCat("m", j)));
+      }
+
+      TestData data;
+      verifyImmediateMatch(matcher.match(data), absl::StrCat("m", i));
+    }
+
+    ExactMapMatcher<TestData> matcher(
+        std::make_unique<TestInput>(
+            DataInputGetResult{DataInputGetResult::DataAvailability::AllDataAvailable, "match"}),
+        absl::nullopt);
+    for (int j = 0; j < children; j++) {
+      matcher.addChild(absl::StrCat("match", j), stringOnMatch<TestData>("match"));
+    }
+
+    TestData data;
+    verifyNoMatch(matcher.match(data));
+  }
+}
+
 TEST_F(ExactMapMatcherTest, DataNotAvailable) {
   ExactMapMatcher<TestData> matcher(std::make_unique<TestInput>(DataInputGetResult{
                                         DataInputGetResult::DataAvailability::NotAvailable, {}}),
@@ -0,0 +1,64 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures matching the last of a number of children of exact map matchers, and of entries of
+// list matchers.
+
+#include <memory>
+#include <string>
+
+#include "source/common/matcher/exact_map_matcher.h"
+#include "source/common/matcher/list_matcher.h"
+
+#include "test/common/matcher/test_utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Matcher {
+namespace {
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_ExactMapMatcher(benchmark::State& state) {
+  const int children = state.range(0);
+  ExactMapMatcher<TestData> matcher(
+      std::make_unique<TestInput>(
+          DataInputGetResult{DataInputGetResult::DataAvailability::AllDataAvailable,
+                             absl::StrCat("x-envoy-child-", children - 1)}),
+      absl::nullopt);
+  for (int i = 0; i < children; i++) {
+    matcher.addChild(absl::StrCat("x-envoy-child-", i), stringOnMatch<TestData>("match"));
+  }
+
+  TestData data;
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(matcher.match(data));
+  }
+}
+BENCHMARK(BM_ExactMapMatcher)->Arg(1)->Arg(4)->Arg(8)->Arg(9)->Arg(64)->Arg(1024);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_ListMatcher(benchmark::State& state) {
+  const int entries = state.range(0);
+  const std::string last = absl::StrCat("x-envoy-entry-", entries - 1);
+  ListMatcher<TestData> matcher(absl::nullopt);
+  for (int i = 0; i < entries; i++) {
+    matcher.addMatcher(createSingleMatcher(last,
+                                           [value = absl::StrCat("x-envoy-entry-", i)](
+                                               absl::optional<absl::string_view> input) {
+                                             return input == absl::string_view(value);
+                                           }),
+                       stringOnMatch<TestData>("match"));
+  }
+
+  TestData data;
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(matcher.match(data));
+  }
+}
+BENCHMARK(BM_ListMatcher)->Arg(1)->Arg(4)->Arg(16)->Arg(64);
+
+} // namespace
+} // namespace Matcher
+} // namespace Envoy
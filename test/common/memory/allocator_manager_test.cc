@@ -0,0 +1,69 @@
+#include "source/common/event/dispatcher_impl.h"
+#include "source/common/memory/allocator_manager.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+
+using testing::_;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Memory {
+namespace {
+
+class AllocatorManagerTest : public testing::Test {
+protected:
+  AllocatorManagerTest()
+      : api_(Api::createApiForTest(stats_, time_system_)),
+        dispatcher_("test_thread", *api_, time_system_) {}
+
+  void step(std::chrono::milliseconds duration) {
+    time_system_.advanceTimeAndRun(duration, dispatcher_, Event::Dispatcher::RunType::NonBlock);
+  }
+
+  envoy::config::bootstrap::v3::MemoryAllocatorManager config_;
+  Envoy::Stats::TestUtil::TestStore stats_;
+  Event::SimulatedTimeSystem time_system_;
+  Api::ApiPtr api_;
+  Event::DispatcherImpl dispatcher_;
+};
+
+TEST_F(AllocatorManagerTest, DoNotReleaseWhenNotConfigured) {
+  NiceMock<Event::MockDispatcher> dispatcher;
+  config_.mutable_max_total_thread_cache_bytes()->set_value(16 << 20);
+  EXPECT_CALL(dispatcher, createTimer_(_)).Times(0);
+  AllocatorManager manager(dispatcher, config_, stats_);
+  EXPECT_EQ(0, stats_.counter("memory_allocator_manager.released_by_timer").value());
+}
+
+TEST_F(AllocatorManagerTest, ReleaseOnEachInterval) {
+  config_.set_bytes_to_release(1 << 20);
+  AllocatorManager manager(dispatcher_, config_, stats_);
+
+  // The free memory is released every second by default.
+  step(std::chrono::milliseconds(999));
+  EXPECT_EQ(0, stats_.counter("memory_allocator_manager.released_by_timer").value());
+  step(std::chrono::milliseconds(1));
+  EXPECT_EQ(1, stats_.counter("memory_allocator_manager.released_by_timer").value());
+  step(std::chrono::milliseconds(1000));
+  EXPECT_EQ(2, stats_.counter("memory_allocator_manager.released_by_timer").value());
+}
+
+TEST_F(AllocatorManagerTest, ReleaseOnConfiguredInterval) {
+  config_.set_bytes_to_release(1 << 20);
+  config_.mutable_memory_release_interval()->set_seconds(10);
+  AllocatorManager manager(dispatcher_, config_, stats_);
+
+  step(std::chrono::milliseconds(5000));
+  EXPECT_EQ(0, stats_.counter("memory_allocator_manager.released_by_timer").value());
+  step(std::chrono::milliseconds(5000));
+  EXPECT_EQ(1, stats_.counter("memory_allocator_manager.released_by_timer").value());
+}
+
+} // namespace
+} // namespace Memory
+} // namespace Envoy
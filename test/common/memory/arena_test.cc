@@ -0,0 +1,74 @@
+#include <cstdint>
+
+#include "source/common/memory/arena.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Memory {
+namespace {
+
+bool isAligned(const void* ptr, size_t alignment) {
+  return (reinterpret_cast<uintptr_t>(ptr) & (alignment - 1)) == 0;
+}
+
+TEST(ArenaTest, InlineStorageDoesNotAllocate) {
+  InlineArena<256> arena;
+  for (int i = 0; i < 16; i++) {
+    EXPECT_NE(nullptr, arena.allocate(16));
+  }
+  EXPECT_EQ(0, arena.heapBlocks());
+  EXPECT_EQ(256, arena.bytesAllocated());
+
+  arena.allocate(1);
+  EXPECT_EQ(1, arena.heapBlocks());
+}
+
+TEST(ArenaTest, AllocationsAreAlignedAndDisjoint) {
+  InlineArena<64> arena;
+  uint8_t* a = static_cast<uint8_t*>(arena.allocate(1, 1));
+  uint8_t* b = static_cast<uint8_t*>(arena.allocate(8, 8));
+  uint8_t* c = static_cast<uint8_t*>(arena.allocate(3, 2));
+  uint8_t* d = static_cast<uint8_t*>(arena.allocate(16));
+  EXPECT_TRUE(isAligned(b, 8));
+  EXPECT_TRUE(isAligned(c, 2));
+  EXPECT_TRUE(isAligned(d, alignof(std::max_align_t)));
+  EXPECT_LE(a + 1, b);
+  EXPECT_LE(b + 8, c);
+  EXPECT_LE(c + 3, d);
+}
+
+TEST(ArenaTest, BlocksGrowUpToMax) {
+  Arena arena(128);
+  arena.allocate(100);
+  EXPECT_EQ(1, arena.heapBlocks());
+  // The second block is twice as large, so both of these fit in it.
+  arena.allocate(100);
+  arena.allocate(100);
+  EXPECT_EQ(2, arena.heapBlocks());
+
+  // Requests larger than the next block size get a block of their own.
+  arena.allocate(Arena::MaxBlockSize * 2);
+  EXPECT_EQ(3, arena.heapBlocks());
+  EXPECT_EQ(300 + Arena::MaxBlockSize * 2, arena.bytesAllocated());
+}
+
+TEST(ArenaTest, PlacementNew) {
+  struct Tracked {
+    Tracked(int& destroyed) : destroyed_(destroyed) {}
+    ~Tracked() { destroyed_++; }
+    int& destroyed_;
+  };
+
+  int destroyed = 0;
+  {
+    InlineArena<64> arena;
+    Tracked* tracked = new (arena.allocate(sizeof(Tracked), alignof(Tracked))) Tracked(destroyed);
+    tracked->~Tracked();
+  }
+  EXPECT_EQ(1, destroyed);
+}
+
+} // namespace
+} // namespace Memory
+} // namespace Envoy
@@ -0,0 +1,63 @@
+// Measures the trade-off between the resident memory of the allocator and the latency of the
+// allocations when its free memory is released to the system in the background, as
+// Memory::AllocatorManager does. Only meaningful when built with tcmalloc or gperftools tcmalloc.
+//
+// Each iteration frees a spike of allocations, then makes a batch of request-sized allocations
+// after releasing the given number of bytes of free memory. The "physical_bytes" counter reports
+// the memory used by the allocator after the batch.
+
+#include <memory>
+#include <vector>
+
+#include "source/common/memory/stats.h"
+#include "source/common/memory/utils.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Memory {
+
+constexpr size_t SpikeAllocations = 16384;
+constexpr size_t BatchAllocations = 1024;
+constexpr size_t AllocationSize = 4096;
+
+// The numeric Arg is the number of bytes released before each batch, 0 for no release.
+static void allocateAfterRelease(benchmark::State& state) {
+  const uint64_t bytes_to_release = state.range(0);
+  uint64_t physical_bytes = 0;
+  for (auto _ : state) { // NOLINT
+    state.PauseTiming();
+    {
+      std::vector<std::unique_ptr<char[]>> spike;
+      for (size_t i = 0; i < SpikeAllocations; i++) {
+        spike.push_back(std::make_unique<char[]>(AllocationSize));
+      }
+    }
+    if (bytes_to_release > 0) {
+      Utils::releaseFreeMemory(bytes_to_release);
+    }
+    state.ResumeTiming();
+
+    std::vector<std::unique_ptr<char[]>> batch;
+    batch.reserve(BatchAllocations);
+    for (size_t i = 0; i < BatchAllocations; i++) {
+      batch.push_back(std::make_unique<char[]>(AllocationSize));
+      benchmark::DoNotOptimize(batch.back().get());
+    }
+
+    state.PauseTiming();
+    physical_bytes = Stats::totalPhysicalBytes();
+    batch.clear();
+    state.ResumeTiming();
+  }
+  state.counters["physical_bytes"] = physical_bytes;
+}
+BENCHMARK(allocateAfterRelease)
+    ->Arg(0)
+    ->Arg(1 << 20)
+    ->Arg(16 << 20)
+    ->Arg(64 << 20)
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace Memory
+} // namespace Envoy
@@ -0,0 +1,183 @@
+#include <list>
+#include <string>
+
+#include "source/common/network/caching_dns_resolver_impl.h"
+#include "source/common/network/utility.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::DoAll;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class CachingDnsResolverImplTest : public testing::Test, public Event::TestUsingSimulatedTime {
+public:
+  // Resolves a name and returns the addresses it is resolved to, with their TTL.
+  std::list<std::pair<std::string, std::chrono::seconds>>
+  resolveInline(const std::string& name, DnsLookupFamily family = DnsLookupFamily::V4Only) {
+    std::list<std::pair<std::string, std::chrono::seconds>> addresses;
+    EXPECT_EQ(nullptr, resolver_.resolve(name, family,
+                                         [&](DnsResolver::ResolutionStatus status,
+                                             std::list<DnsResponse>&& response) -> void {
+                                           EXPECT_EQ(DnsResolver::ResolutionStatus::Success,
+                                                     status);
+                                           for (const auto& resp : response) {
+                                             addresses.emplace_back(
+                                                 resp.address_->ip()->addressAsString(),
+                                                 resp.ttl_);
+                                           }
+                                         }));
+    return addresses;
+  }
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  std::shared_ptr<MockDnsResolver> wrapped_{std::make_shared<MockDnsResolver>()};
+  CachingDnsResolverImpl resolver_{dispatcher_, wrapped_};
+};
+
+TEST_F(CachingDnsResolverImplTest, ConcurrentResolutionsShareQuery) {
+  DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*wrapped_, resolve("foo.com", DnsLookupFamily::V4Only, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&wrapped_->active_query_)));
+
+  uint32_t resolutions = 0;
+  auto callback = [&](DnsResolver::ResolutionStatus status,
+                      std::list<DnsResponse>&& response) -> void {
+    EXPECT_EQ(DnsResolver::ResolutionStatus::Success, status);
+    EXPECT_EQ(1, response.size());
+    resolutions++;
+  };
+  EXPECT_NE(nullptr, resolver_.resolve("foo.com", DnsLookupFamily::V4Only, callback));
+  EXPECT_NE(nullptr, resolver_.resolve("foo.com", DnsLookupFamily::V4Only, callback));
+
+  // Other lookup families are resolved on their own.
+  EXPECT_CALL(*wrapped_, resolve("foo.com", DnsLookupFamily::V6Only, _))
+      .WillOnce(Return(&wrapped_->active_query_));
+  EXPECT_NE(nullptr, resolver_.resolve("foo.com", DnsLookupFamily::V6Only, callback));
+
+  resolve_cb(DnsResolver::ResolutionStatus::Success,
+             TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(10)));
+  EXPECT_EQ(2, resolutions);
+  EXPECT_CALL(wrapped_->active_query_, cancel(ActiveDnsQuery::CancelReason::QueryAbandoned));
+}
+
+TEST_F(CachingDnsResolverImplTest, CachesForLowestTtl) {
+  DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*wrapped_, resolve("foo.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&wrapped_->active_query_)));
+  resolver_.resolve("foo.com", DnsLookupFamily::V4Only,
+                    [](DnsResolver::ResolutionStatus, std::list<DnsResponse>&&) -> void {});
+  std::list<DnsResponse> response;
+  response.emplace_back(Utility::parseInternetAddress("10.0.0.1"), std::chrono::seconds(30));
+  response.emplace_back(Utility::parseInternetAddress("10.0.0.2"), std::chrono::seconds(10));
+  resolve_cb(DnsResolver::ResolutionStatus::Success, std::move(response));
+
+  // Cached addresses are answered inline with the TTL left.
+  simTime().advanceTimeWait(std::chrono::seconds(4));
+  const std::list<std::pair<std::string, std::chrono::seconds>> expected{
+      {"10.0.0.1", std::chrono::seconds(26)}, {"10.0.0.2", std::chrono::seconds(6)}};
+  EXPECT_EQ(expected, resolveInline("foo.com"));
+
+  // The resolution is sent again once the lowest TTL has passed.
+  simTime().advanceTimeWait(std::chrono::seconds(6));
+  EXPECT_CALL(*wrapped_, resolve("foo.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&wrapped_->active_query_)));
+  EXPECT_NE(nullptr,
+            resolver_.resolve("foo.com", DnsLookupFamily::V4Only,
+                              [](DnsResolver::ResolutionStatus, std::list<DnsResponse>&&) {}));
+  resolve_cb(DnsResolver::ResolutionStatus::Success,
+             TestUtility::makeDnsResponse({"10.0.0.3"}, std::chrono::seconds(10)));
+  EXPECT_EQ(1, resolveInline("foo.com").size());
+}
+
+TEST_F(CachingDnsResolverImplTest, FailuresAndZeroTtlNotCached) {
+  DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*wrapped_, resolve("foo.com", _, _))
+      .Times(3)
+      .WillRepeatedly(DoAll(SaveArg<2>(&resolve_cb), Return(&wrapped_->active_query_)));
+  auto callback = [](DnsResolver::ResolutionStatus, std::list<DnsResponse>&&) -> void {};
+
+  resolver_.resolve("foo.com", DnsLookupFamily::V4Only, callback);
+  resolve_cb(DnsResolver::ResolutionStatus::Failure, {});
+  resolver_.resolve("foo.com", DnsLookupFamily::V4Only, callback);
+  resolve_cb(DnsResolver::ResolutionStatus::Success, TestUtility::makeDnsResponse({"10.0.0.1"}));
+  resolver_.resolve("foo.com", DnsLookupFamily::V4Only, callback);
+  resolve_cb(DnsResolver::ResolutionStatus::Success, TestUtility::makeDnsResponse({"10.0.0.1"}));
+}
+
+TEST_F(CachingDnsResolverImplTest, CancelQueryWithLastResolution) {
+  DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*wrapped_, resolve("foo.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&wrapped_->active_query_)));
+
+  bool resolved = false;
+  ActiveDnsQuery* first = resolver_.resolve(
+      "foo.com", DnsLookupFamily::V4Only,
+      [](DnsResolver::ResolutionStatus, std::list<DnsResponse>&&) -> void { FAIL(); });
+  resolver_.resolve(
+      "foo.com", DnsLookupFamily::V4Only,
+      [&](DnsResolver::ResolutionStatus, std::list<DnsResponse>&&) -> void { resolved = true; });
+
+  // The query goes on while a resolution still waits for it.
+  EXPECT_CALL(wrapped_->active_query_, cancel(_)).Times(0);
+  first->cancel(ActiveDnsQuery::CancelReason::QueryAbandoned);
+  resolve_cb(DnsResolver::ResolutionStatus::Success,
+             TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(10)));
+  EXPECT_TRUE(resolved);
+
+  // The query is cancelled with its last resolution.
+  EXPECT_CALL(*wrapped_, resolve("bar.com", _, _)).WillOnce(Return(&wrapped_->active_query_));
+  ActiveDnsQuery* third = resolver_.resolve(
+      "bar.com", DnsLookupFamily::V4Only,
+      [](DnsResolver::ResolutionStatus, std::list<DnsResponse>&&) -> void { FAIL(); });
+  EXPECT_CALL(wrapped_->active_query_, cancel(ActiveDnsQuery::CancelReason::Timeout));
+  third->cancel(ActiveDnsQuery::CancelReason::Timeout);
+}
+
+TEST_F(CachingDnsResolverImplTest, InlineResolution) {
+  EXPECT_CALL(*wrapped_, resolve("10.0.0.1", _, _))
+      .WillOnce(Invoke([](const std::string&, DnsLookupFamily,
+                          DnsResolver::ResolveCb callback) -> ActiveDnsQuery* {
+        callback(DnsResolver::ResolutionStatus::Success,
+                 TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(10)));
+        return nullptr;
+      }));
+  EXPECT_EQ(1, resolveInline("10.0.0.1").size());
+  EXPECT_EQ(1, resolveInline("10.0.0.1").size());
+}
+
+TEST_F(CachingDnsResolverImplTest, RuntimeDisabled) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.dns_resolution_cache", "false"}});
+
+  DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*wrapped_, resolve("foo.com", _, _))
+      .Times(2)
+      .WillRepeatedly(DoAll(SaveArg<2>(&resolve_cb), Return(&wrapped_->active_query_)));
+  auto callback = [](DnsResolver::ResolutionStatus, std::list<DnsResponse>&&) -> void {};
+  EXPECT_EQ(&wrapped_->active_query_,
+            resolver_.resolve("foo.com", DnsLookupFamily::V4Only, callback));
+  resolve_cb(DnsResolver::ResolutionStatus::Success,
+             TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(10)));
+  EXPECT_EQ(&wrapped_->active_query_,
+            resolver_.resolve("foo.com", DnsLookupFamily::V4Only, callback));
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
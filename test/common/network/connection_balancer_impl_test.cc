@@ -0,0 +1,114 @@
+#include "source/common/network/connection_balancer_impl.h"
+
+#include "test/mocks/common.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class TestHandler : public BalancedConnectionHandler {
+public:
+  TestHandler(uint64_t num_connections = 0,
+              std::chrono::microseconds loop_duration = std::chrono::microseconds(0))
+      : num_connections_(num_connections), loop_duration_(loop_duration) {}
+
+  // BalancedConnectionHandler
+  uint64_t numConnections() const override { return num_connections_; }
+  void incNumConnections() override { ++num_connections_; }
+  void post(ConnectionSocketPtr&&) override {}
+  void onAcceptWorker(ConnectionSocketPtr&&, bool, bool) override {}
+  SocketOptRef listenSocket() override { return absl::nullopt; }
+  std::chrono::microseconds averageLoopDuration() override { return loop_duration_; }
+
+  uint64_t num_connections_;
+  std::chrono::microseconds loop_duration_;
+};
+
+class PowerOfTwoChoicesConnectionBalancerImplTest : public testing::Test {
+protected:
+  // Makes the next pick sample the handlers of the two slots.
+  void sample(uint32_t first_slot, uint32_t second_slot) {
+    EXPECT_CALL(random_, random())
+        .WillOnce(Return(static_cast<uint64_t>(second_slot) << 32 | first_slot));
+  }
+
+  NiceMock<Random::MockRandomGenerator> random_;
+};
+
+TEST_F(PowerOfTwoChoicesConnectionBalancerImplTest, PicksLessLoadedHandler) {
+  PowerOfTwoChoicesConnectionBalancerImpl balancer(random_, 3, false);
+  TestHandler handler0(5);
+  TestHandler handler1(2);
+  TestHandler handler2(7);
+  balancer.registerHandler(handler0);
+  balancer.registerHandler(handler1);
+  balancer.registerHandler(handler2);
+
+  sample(0, 1);
+  EXPECT_EQ(&handler1, &balancer.pickTargetHandler(handler0));
+  EXPECT_EQ(3, handler1.numConnections());
+  EXPECT_EQ(5, handler0.numConnections());
+
+  sample(2, 0);
+  EXPECT_EQ(&handler0, &balancer.pickTargetHandler(handler2));
+  EXPECT_EQ(6, handler0.numConnections());
+
+  // Ties keep the connection on the current handler.
+  handler2.num_connections_ = 6;
+  sample(0, 2);
+  EXPECT_EQ(&handler2, &balancer.pickTargetHandler(handler2));
+  EXPECT_EQ(7, handler2.numConnections());
+}
+
+TEST_F(PowerOfTwoChoicesConnectionBalancerImplTest, EmptySlotsKeepCurrentHandler) {
+  PowerOfTwoChoicesConnectionBalancerImpl balancer(random_, 4, false);
+  TestHandler handler0(1);
+  TestHandler handler1(3);
+  balancer.registerHandler(handler0);
+  balancer.registerHandler(handler1);
+
+  sample(2, 3);
+  EXPECT_EQ(&handler1, &balancer.pickTargetHandler(handler1));
+  EXPECT_EQ(4, handler1.numConnections());
+
+  sample(0, 3);
+  EXPECT_EQ(&handler0, &balancer.pickTargetHandler(handler1));
+  EXPECT_EQ(2, handler0.numConnections());
+
+  // An unregistered handler leaves an empty slot behind, which the next handler fills.
+  balancer.unregisterHandler(handler0);
+  sample(0, 1);
+  EXPECT_EQ(&handler1, &balancer.pickTargetHandler(handler1));
+  TestHandler handler2;
+  balancer.registerHandler(handler2);
+  sample(0, 1);
+  EXPECT_EQ(&handler2, &balancer.pickTargetHandler(handler1));
+}
+
+TEST_F(PowerOfTwoChoicesConnectionBalancerImplTest, WeightByLoopDuration) {
+  PowerOfTwoChoicesConnectionBalancerImpl balancer(random_, 2, true);
+  TestHandler busy(1, std::chrono::microseconds(1000));
+  TestHandler idle(4, std::chrono::microseconds(100));
+  balancer.registerHandler(busy);
+  balancer.registerHandler(idle);
+
+  // (1 + 1) * (1000 + 1) is higher than (4 + 1) * (100 + 1).
+  sample(0, 1);
+  EXPECT_EQ(&idle, &balancer.pickTargetHandler(busy));
+
+  // Without measured durations only the connection counts are compared.
+  busy.loop_duration_ = std::chrono::microseconds(0);
+  idle.loop_duration_ = std::chrono::microseconds(0);
+  sample(0, 1);
+  EXPECT_EQ(&busy, &balancer.pickTargetHandler(idle));
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,85 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <vector>
+
+#include "source/common/common/random_generator.h"
+#include "source/common/network/connection_balancer_impl.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+constexpr uint32_t Workers = 64;
+
+class TestHandler : public BalancedConnectionHandler {
+public:
+  // BalancedConnectionHandler
+  uint64_t numConnections() const override { return num_connections_; }
+  void incNumConnections() override { ++num_connections_; }
+  void post(ConnectionSocketPtr&&) override {}
+  void onAcceptWorker(ConnectionSocketPtr&&, bool, bool) override {}
+  SocketOptRef listenSocket() override { return absl::nullopt; }
+  std::chrono::microseconds averageLoopDuration() override { return {}; }
+
+  std::atomic<uint64_t> num_connections_{};
+};
+
+// Each benchmark thread accepts connections on the handler of its own worker, out of Workers
+// registered handlers, and closes each connection right away.
+void balanceConnections(benchmark::State& state, ConnectionBalancer& balancer,
+                        std::vector<TestHandler>& handlers) {
+  TestHandler& current_handler = handlers[state.thread_index];
+  for (auto _ : state) { // NOLINT
+    BalancedConnectionHandler& target = balancer.pickTargetHandler(current_handler);
+    --static_cast<TestHandler&>(target).num_connections_;
+    balancer.onConnectionClosed(target);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+std::unique_ptr<std::vector<TestHandler>> registerHandlers(ConnectionBalancer& balancer) {
+  auto handlers = std::make_unique<std::vector<TestHandler>>(Workers);
+  for (TestHandler& handler : *handlers) {
+    balancer.registerHandler(handler);
+  }
+  return handlers;
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_ExactBalance(benchmark::State& state) {
+  // Function local statics, so that they are initialized once before any thread uses them.
+  static ExactConnectionBalancerImpl balancer;
+  static const auto handlers = registerHandlers(balancer);
+  balanceConnections(state, balancer, *handlers);
+}
+BENCHMARK(BM_ExactBalance)->Threads(1)->Threads(8)->Threads(Workers)->UseRealTime();
+
+// state.range(0) is non-zero to weight the connection counts by the loop durations.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_PowerOfTwoChoicesBalance(benchmark::State& state) {
+  static Random::RandomGeneratorImpl random;
+  static PowerOfTwoChoicesConnectionBalancerImpl balancer(random, Workers, false);
+  static PowerOfTwoChoicesConnectionBalancerImpl weighted_balancer(random, Workers, true);
+  static const auto handlers = registerHandlers(balancer);
+  static const auto weighted_handlers = registerHandlers(weighted_balancer);
+  if (state.range(0) == 0) {
+    balanceConnections(state, balancer, *handlers);
+  } else {
+    balanceConnections(state, weighted_balancer, *weighted_handlers);
+  }
+}
+BENCHMARK(BM_PowerOfTwoChoicesBalance)
+    ->Arg(0)
+    ->Arg(1)
+    ->Threads(1)
+    ->Threads(8)
+    ->Threads(Workers)
+    ->UseRealTime();
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -16,6 +16,7 @@
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/ratelimit/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/stats/mocks.h"
 #include "test/mocks/server/factory_context.h"
 #include "test/mocks/server/instance.h"
 #include "test/mocks/tracing/mocks.h"
@@ -114,6 +115,37 @@ TEST_F(NetworkFilterManagerTest, All) {
   manager.onWrite();
 }
 
+// Verifies that the cost of each filter of a sampled connection is recorded once the filter
+// manager is destroyed, and that the filters added before any cost are not charged.
+TEST_F(NetworkFilterManagerTest, RecordFilterCosts) {
+  MockReadFilter* read_filter(new NiceMock<MockReadFilter>());
+  MockFilter* filter(new NiceMock<MockFilter>());
+  NiceMock<Stats::MockHistogram> filter_cpu_time;
+
+  {
+    FilterManagerImpl manager(connection_, socket_);
+    manager.addReadFilter(ReadFilterSharedPtr{read_filter});
+    manager.recordFilterCost(filter_cpu_time);
+    manager.addFilter(FilterSharedPtr{filter});
+
+    EXPECT_CALL(*read_filter, onNewConnection()).WillOnce(Return(FilterStatus::Continue));
+    EXPECT_CALL(*filter, onNewConnection()).WillOnce(Return(FilterStatus::Continue));
+    EXPECT_TRUE(manager.initializeReadFilters());
+
+    read_buffer_.add("hello");
+    EXPECT_CALL(*read_filter, onData(_, false)).WillOnce(Return(FilterStatus::Continue));
+    EXPECT_CALL(*filter, onData(_, false)).WillOnce(Return(FilterStatus::Continue));
+    manager.onRead();
+
+    write_buffer_.add("world");
+    EXPECT_CALL(*filter, onWrite(_, false)).WillOnce(Return(FilterStatus::Continue));
+    manager.onWrite();
+
+    // The cost of the combination filter is recorded once.
+    EXPECT_CALL(filter_cpu_time, recordValue(_));
+  }
+}
+
 TEST_F(NetworkFilterManagerTest, ConnectionClosedBeforeRunningFilter) {
   InSequence s;
 
@@ -1,3 +1,8 @@
+#ifdef __linux__
+#include <linux/errqueue.h>
+#endif
+
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/utility.h"
 #include "source/common/network/address_impl.h"
 #include "source/common/network/io_socket_error_impl.h"
@@ -98,6 +103,101 @@ TEST(IoSocketHandleImpl, LastRoundTripTimeReturnsRttIfSuccessful) {
   EXPECT_THAT(io_handle.lastRoundTripTime(),
               Eq(std::chrono::duration_cast<std::chrono::milliseconds>(rtt)));
 }
+
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+class IoSocketHandleImplZeroCopyTest : public testing::Test {
+public:
+  IoSocketHandleImplZeroCopyTest() : os_calls_(&os_sys_calls_), io_handle_(fd_) {
+    EXPECT_CALL(os_sys_calls_, close(fd_)).WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  }
+
+  void enableZeroCopy() {
+    const int enable = 1;
+    EXPECT_EQ(0, io_handle_.setOption(SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)).rc_);
+  }
+
+  // Queues a zero-copy completion for the sends numbered [first, last] on the error queue.
+  void expectCompletion(uint32_t first, uint32_t last, uint8_t code = 0) {
+    EXPECT_CALL(os_sys_calls_, recvmsg(fd_, _, MSG_ERRQUEUE))
+        .WillOnce(Invoke([first, last, code](os_fd_t, msghdr* msg, int) {
+          cmsghdr* cmsg = CMSG_FIRSTHDR(msg);
+          cmsg->cmsg_level = SOL_IP;
+          cmsg->cmsg_type = IP_RECVERR;
+          cmsg->cmsg_len = CMSG_LEN(sizeof(sock_extended_err));
+          sock_extended_err error{};
+          error.ee_origin = SO_EE_ORIGIN_ZEROCOPY;
+          error.ee_code = code;
+          error.ee_info = first;
+          error.ee_data = last;
+          memcpy(CMSG_DATA(cmsg), &error, sizeof(error));
+          msg->msg_controllen = CMSG_SPACE(sizeof(sock_extended_err));
+          return Api::SysCallSizeResult{0, 0};
+        }))
+        .WillRepeatedly(Return(Api::SysCallSizeResult{-1, SOCKET_ERROR_AGAIN}));
+  }
+
+  const os_fd_t fd_{10};
+  NiceMock<Api::MockOsSysCalls> os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_;
+  IoSocketHandleImpl io_handle_;
+};
+
+TEST_F(IoSocketHandleImplZeroCopyTest, SmallWritesAreCopied) {
+  enableZeroCopy();
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(os_sys_calls_, sendmsg(_, _, _)).Times(0);
+  EXPECT_CALL(os_sys_calls_, writev(fd_, _, 1)).WillOnce(Return(Api::SysCallSizeResult{5, 0}));
+  EXPECT_EQ(5, io_handle_.write(buffer).rc_);
+  EXPECT_EQ(0, buffer.length());
+}
+
+TEST_F(IoSocketHandleImplZeroCopyTest, LargeWritesArePinnedUntilCompletion) {
+  enableZeroCopy();
+  Buffer::OwnedImpl buffer(std::string(65536, 'a'));
+  EXPECT_CALL(os_sys_calls_, writev(_, _, _)).Times(0);
+  EXPECT_CALL(os_sys_calls_, sendmsg(fd_, _, MSG_ZEROCOPY))
+      .Times(2)
+      .WillRepeatedly(Return(Api::SysCallSizeResult{20000, 0}));
+  EXPECT_EQ(20000, io_handle_.write(buffer).rc_);
+  EXPECT_EQ(45536, buffer.length());
+
+  // Only the first send completed.
+  expectCompletion(0, 0);
+  EXPECT_EQ(20000, io_handle_.write(buffer).rc_);
+  EXPECT_EQ(25536, buffer.length());
+
+  // The second send completes before the socket is closed.
+  expectCompletion(1, 1);
+  io_handle_.close();
+}
+
+TEST_F(IoSocketHandleImplZeroCopyTest, FallbackToCopyOnEnobufs) {
+  enableZeroCopy();
+  Buffer::OwnedImpl buffer(std::string(65536, 'a'));
+  EXPECT_CALL(os_sys_calls_, sendmsg(fd_, _, MSG_ZEROCOPY))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, ENOBUFS}));
+  EXPECT_CALL(os_sys_calls_, writev(fd_, _, _))
+      .WillOnce(Return(Api::SysCallSizeResult{65536, 0}));
+  EXPECT_EQ(65536, io_handle_.write(buffer).rc_);
+  EXPECT_EQ(0, buffer.length());
+}
+
+TEST_F(IoSocketHandleImplZeroCopyTest, DisabledWhenKernelCopies) {
+  enableZeroCopy();
+  Buffer::OwnedImpl buffer(std::string(65536, 'a'));
+  EXPECT_CALL(os_sys_calls_, sendmsg(fd_, _, MSG_ZEROCOPY))
+      .WillOnce(Return(Api::SysCallSizeResult{20000, 0}));
+  EXPECT_EQ(20000, io_handle_.write(buffer).rc_);
+
+  // The kernel reports that it copied the data anyway, so the next write is a plain writev.
+  expectCompletion(0, 0, SO_EE_CODE_ZEROCOPY_COPIED);
+  EXPECT_CALL(os_sys_calls_, writev(fd_, _, _))
+      .WillOnce(Return(Api::SysCallSizeResult{45536, 0}));
+  EXPECT_EQ(45536, io_handle_.write(buffer).rc_);
+  EXPECT_EQ(0, buffer.length());
+}
+#endif
+
 } // namespace
 } // namespace Network
 } // namespace Envoy
@@ -146,4 +146,49 @@ static void lcTrieLookupMinimal(benchmark::State& state) {
 
 BENCHMARK(lcTrieLookupMinimal);
 
+// Looks up random addresses in tries of state.range(0) IPv4 /24 or IPv6 /48 prefixes, as large as
+// an IP reputation list, each nested in a /16 or /32 prefix of 256 of them.
+static void lcTrieLookupLarge(benchmark::State& state, bool ipv6) {
+  const int prefixes = state.range(0);
+  std::vector<std::pair<std::string, std::vector<Envoy::Network::Address::CidrRange>>> tag_data;
+  for (int i = 0; i < prefixes; i++) {
+    tag_data.push_back(
+        {fmt::format("tag_{}", i % 16),
+         {Envoy::Network::Address::CidrRange::create(
+             ipv6 ? fmt::format("2001:{:x}:{:x}::/48", i >> 8, i & 0xff)
+                  : fmt::format("{}.{}.{}.0/24", 1 + (i >> 16), (i >> 8) & 0xff, i & 0xff))}});
+    if (i % 256 == 0) {
+      tag_data.push_back(
+          {"tag_16",
+           {Envoy::Network::Address::CidrRange::create(
+               ipv6 ? fmt::format("2001:{:x}::/32", i >> 8)
+                    : fmt::format("{}.{}.0.0/16", 1 + (i >> 16), (i >> 8) & 0xff))}});
+    }
+  }
+  Envoy::Network::LcTrie::LcTrie<std::string> lc_trie(tag_data, false, 0.5, 16);
+
+  std::vector<Envoy::Network::Address::InstanceConstSharedPtr> addresses;
+  uint32_t random = 1;
+  for (int i = 0; i < 1024; i++) {
+    random = random * 1103515245 + 12345;
+    const int prefix = (random >> 8) % prefixes;
+    addresses.push_back(Envoy::Network::Utility::parseInternetAddress(
+        ipv6 ? fmt::format("2001:{:x}:{:x}::{:x}", prefix >> 8, prefix & 0xff, random & 0xff)
+             : fmt::format("{}.{}.{}.{}", 1 + (prefix >> 16), (prefix >> 8) & 0xff, prefix & 0xff,
+                           random & 0xff)));
+  }
+
+  size_t i = 0;
+  size_t output_tags = 0;
+  for (auto _ : state) {
+    i++;
+    i %= addresses.size();
+    output_tags += lc_trie.getData(addresses[i]).size();
+  }
+  benchmark::DoNotOptimize(output_tags);
+}
+
+BENCHMARK_CAPTURE(lcTrieLookupLarge, ipv4, false)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 17);
+BENCHMARK_CAPTURE(lcTrieLookupLarge, ipv6, true)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 17);
+
 } // namespace Envoy
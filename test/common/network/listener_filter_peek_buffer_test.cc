@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "envoy/common/platform.h"
+
+#include "source/common/network/io_socket_error_impl.h"
+#include "source/common/network/listener_filter_peek_buffer.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/io_handle.h"
+#include "test/mocks/network/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class ListenerFilterPeekBufferTest : public testing::Test {
+public:
+  ListenerFilterPeekBufferTest() {
+    ON_CALL(socket_, ioHandle()).WillByDefault(ReturnRef(io_handle_));
+  }
+
+  // Expects a peek at the socket, which receives data_.
+  void expectPeek() {
+    EXPECT_CALL(io_handle_, recv(_, _, MSG_PEEK))
+        .WillOnce(Invoke([this](void* buffer, size_t length, int) -> Api::IoCallUint64Result {
+          const size_t received = std::min(length, data_.size());
+          memcpy(buffer, data_.data(), received);
+          return {received, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError)};
+        }));
+  }
+
+  // Peeks at most length bytes and returns them.
+  std::string peek(ListenerFilterPeekBuffer& peek_buffer, uint64_t length) {
+    std::string peeked(length, '\0');
+    const Api::IoCallUint64Result result = peek_buffer.peek(peeked.data(), length);
+    EXPECT_TRUE(result.ok());
+    peeked.resize(result.rc_);
+    return peeked;
+  }
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<MockConnectionSocket> socket_;
+  NiceMock<MockIoHandle> io_handle_;
+  std::string data_{"0123456789"};
+};
+
+// The data peeked is shared until the end of the event loop iteration.
+TEST_F(ListenerFilterPeekBufferTest, SharedUntilEndOfIteration) {
+  auto* release_cb = new NiceMock<Event::MockSchedulableCallback>(&dispatcher_);
+  ListenerFilterPeekBuffer peek_buffer(socket_, dispatcher_);
+
+  expectPeek();
+  EXPECT_CALL(*release_cb, scheduleCallbackCurrentIteration()).Times(2);
+  EXPECT_EQ("0123456789", peek(peek_buffer, 1024));
+  // The socket had no more data than peeked when asked for more.
+  EXPECT_EQ("0123456789", peek(peek_buffer, 512));
+  EXPECT_EQ("0123", peek(peek_buffer, 4));
+
+  data_ = "0123456789abcdef";
+  release_cb->invokeCallback();
+  expectPeek();
+  EXPECT_EQ("0123456789abcdef", peek(peek_buffer, 1024));
+}
+
+// The socket is peeked again when asked for more data than asked for when peeking.
+TEST_F(ListenerFilterPeekBufferTest, PeekMore) {
+  new NiceMock<Event::MockSchedulableCallback>(&dispatcher_);
+  ListenerFilterPeekBuffer peek_buffer(socket_, dispatcher_);
+
+  expectPeek();
+  EXPECT_EQ("0123", peek(peek_buffer, 4));
+  EXPECT_EQ("01", peek(peek_buffer, 2));
+  expectPeek();
+  EXPECT_EQ("012345", peek(peek_buffer, 6));
+}
+
+// The data peeked isn't shared with the other sockets.
+TEST_F(ListenerFilterPeekBufferTest, NotSharedWithOtherSockets) {
+  new NiceMock<Event::MockSchedulableCallback>(&dispatcher_);
+  new NiceMock<Event::MockSchedulableCallback>(&dispatcher_);
+  ListenerFilterPeekBuffer peek_buffer(socket_, dispatcher_);
+  ListenerFilterPeekBuffer other_peek_buffer(socket_, dispatcher_);
+
+  expectPeek();
+  EXPECT_EQ("0123456789", peek(peek_buffer, 1024));
+  expectPeek();
+  EXPECT_EQ("0123456789", peek(other_peek_buffer, 1024));
+  data_ = "abc";
+  expectPeek();
+  EXPECT_EQ("abc", peek(peek_buffer, 1024));
+}
+
+// Failed peeks are not shared.
+TEST_F(ListenerFilterPeekBufferTest, ErrorNotShared) {
+  ListenerFilterPeekBuffer peek_buffer(socket_, dispatcher_);
+  char buffer[16];
+
+  EXPECT_CALL(io_handle_, recv(_, _, MSG_PEEK))
+      .Times(2)
+      .WillRepeatedly(Invoke([](void*, size_t, int) -> Api::IoCallUint64Result {
+        return {0, Api::IoErrorPtr(IoSocketError::getIoSocketEagainInstance(),
+                                   IoSocketError::deleteIoError)};
+      }));
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again,
+            peek_buffer.peek(buffer, sizeof(buffer)).err_->getErrorCode());
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again,
+            peek_buffer.peek(buffer, sizeof(buffer)).err_->getErrorCode());
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
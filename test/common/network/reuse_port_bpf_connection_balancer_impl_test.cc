@@ -0,0 +1,104 @@
+#include <poll.h>
+
+#include "source/common/network/listen_socket_impl.h"
+#include "source/common/network/reuse_port_bpf_connection_balancer_impl.h"
+#include "source/common/network/socket_impl.h"
+#include "source/common/network/socket_option_factory.h"
+
+#include "test/test_common/network_utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class TestHandler : public BalancedConnectionHandler {
+public:
+  explicit TestHandler(SocketSharedPtr listen_socket = nullptr)
+      : listen_socket_(std::move(listen_socket)) {}
+
+  // BalancedConnectionHandler
+  uint64_t numConnections() const override { return num_connections_; }
+  void incNumConnections() override { ++num_connections_; }
+  void post(ConnectionSocketPtr&&) override {}
+  void onAcceptWorker(ConnectionSocketPtr&&, bool, bool) override {}
+  SocketOptRef listenSocket() override {
+    return listen_socket_ != nullptr ? SocketOptRef(*listen_socket_) : absl::nullopt;
+  }
+  std::chrono::microseconds averageLoopDuration() override { return {}; }
+
+  uint64_t num_connections_{};
+  const SocketSharedPtr listen_socket_;
+};
+
+TEST(ReusePortBpfConnectionBalancerImplTest, KeepsConnectionOnCurrentHandler) {
+  ReusePortBpfConnectionBalancerImpl balancer(2);
+  TestHandler handler1;
+  TestHandler handler2;
+  balancer.registerHandler(handler1);
+  balancer.registerHandler(handler2);
+
+  EXPECT_EQ(&handler1, &balancer.pickTargetHandler(handler1));
+  EXPECT_EQ(&handler2, &balancer.pickTargetHandler(handler2));
+  EXPECT_EQ(&handler2, &balancer.pickTargetHandler(handler2));
+  EXPECT_EQ(1, handler1.numConnections());
+  EXPECT_EQ(2, handler2.numConnections());
+
+  --handler2.num_connections_;
+  balancer.onConnectionClosed(handler2);
+  balancer.unregisterHandler(handler1);
+  balancer.unregisterHandler(handler2);
+  // Closing a connection of an unregistered handler is ignored.
+  balancer.onConnectionClosed(handler1);
+}
+
+// The kernel steers each connection to the listen socket of the handler with fewest connections.
+TEST(ReusePortBpfConnectionBalancerImplTest, SteersToLeastLoadedHandler) {
+  ReusePortBpfConnectionBalancerImpl balancer(2);
+  if (!balancer.enabled()) {
+    // Loading BPF programs is not supported or not permitted in this environment.
+    return;
+  }
+
+  auto socket1 = std::make_shared<TcpListenSocket>(
+      Network::Test::getCanonicalLoopbackAddress(Address::IpVersion::v4),
+      SocketOptionFactory::buildReusePortOptions(), true);
+  auto socket2 = std::make_shared<TcpListenSocket>(socket1->addressProvider().localAddress(),
+                                                   SocketOptionFactory::buildReusePortOptions(),
+                                                   true);
+  ASSERT_EQ(0, socket1->ioHandle().listen(16).rc_);
+  ASSERT_EQ(0, socket2->ioHandle().listen(16).rc_);
+  TestHandler handler1(socket1);
+  TestHandler handler2(socket2);
+  balancer.registerHandler(handler1);
+  balancer.registerHandler(handler2);
+
+  // Connects to the listener and returns the handler whose socket has the connection pending.
+  auto connect = [&]() -> TestHandler* {
+    SocketPtr client = std::make_unique<SocketImpl>(Socket::Type::Stream,
+                                                    socket1->addressProvider().localAddress(),
+                                                    nullptr);
+    EXPECT_EQ(0, client->connect(socket1->addressProvider().localAddress()).rc_);
+    pollfd fds[] = {{socket1->ioHandle().fdDoNotUse(), POLLIN, 0},
+                    {socket2->ioHandle().fdDoNotUse(), POLLIN, 0}};
+    EXPECT_EQ(1, poll(fds, 2, 1000));
+    TestHandler& handler = fds[0].revents != 0 ? handler1 : handler2;
+    EXPECT_NE(nullptr, handler.listen_socket_->ioHandle().accept(nullptr, nullptr));
+    return &balancer.pickTargetHandler(handler) == &handler ? &handler : nullptr;
+  };
+
+  balancer.pickTargetHandler(handler1);
+  EXPECT_EQ(&handler2, connect());
+  EXPECT_EQ(&handler1, connect());
+  --handler1.num_connections_;
+  balancer.onConnectionClosed(handler1);
+  EXPECT_EQ(&handler1, connect());
+
+  balancer.unregisterHandler(handler1);
+  balancer.unregisterHandler(handler2);
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
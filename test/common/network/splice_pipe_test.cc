@@ -0,0 +1,138 @@
+#include <sys/socket.h>
+
+#include <string>
+
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/network/splice_pipe.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class SplicePipeTest : public testing::Test {
+public:
+  void SetUp() override {
+    os_fd_t input[2];
+    os_fd_t output[2];
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, input));
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, output));
+    input_writer_ = std::make_unique<IoSocketHandleImpl>(input[0]);
+    input_ = std::make_unique<IoSocketHandleImpl>(input[1]);
+    output_ = std::make_unique<IoSocketHandleImpl>(output[0]);
+    output_reader_ = std::make_unique<IoSocketHandleImpl>(output[1]);
+    pipe_ = SplicePipe::create();
+    ASSERT_NE(nullptr, pipe_);
+  }
+
+  std::string readOutput() {
+    Buffer::OwnedImpl buffer;
+    while (output_reader_->read(buffer, absl::nullopt).rc_ > 0) {
+    }
+    return buffer.toString();
+  }
+
+  IoHandlePtr input_writer_;
+  IoHandlePtr input_;
+  IoHandlePtr output_;
+  IoHandlePtr output_reader_;
+  SplicePipePtr pipe_;
+};
+
+TEST_F(SplicePipeTest, TransferData) {
+  Buffer::OwnedImpl data("hello world");
+  EXPECT_EQ(11, input_writer_->write(data).rc_);
+
+  SplicePipe::TransferResult result = pipe_->transfer(*input_, *output_);
+  EXPECT_EQ(11, result.bytes_read_);
+  EXPECT_EQ(11, result.bytes_written_);
+  EXPECT_FALSE(result.write_blocked_);
+  EXPECT_FALSE(result.end_stream_);
+  EXPECT_FALSE(result.error_);
+  EXPECT_EQ(0, pipe_->bufferedBytes());
+  EXPECT_EQ("hello world", readOutput());
+
+  // Nothing left to move.
+  result = pipe_->transfer(*input_, *output_);
+  EXPECT_EQ(0, result.bytes_read_);
+  EXPECT_EQ(0, result.bytes_written_);
+}
+
+TEST_F(SplicePipeTest, EndStream) {
+  Buffer::OwnedImpl data("bye");
+  EXPECT_EQ(3, input_writer_->write(data).rc_);
+  input_writer_->close();
+
+  const SplicePipe::TransferResult result = pipe_->transfer(*input_, *output_);
+  EXPECT_EQ(3, result.bytes_written_);
+  EXPECT_TRUE(result.end_stream_);
+  EXPECT_EQ("bye", readOutput());
+}
+
+TEST_F(SplicePipeTest, BackPressure) {
+  // Fill the output socket so that it doesn't accept any more data.
+  Buffer::OwnedImpl filler(std::string(1024 * 1024, 'a'));
+  while (output_->write(filler).rc_ > 0) {
+  }
+
+  Buffer::OwnedImpl data(std::string(1024, 'b'));
+  EXPECT_EQ(1024, input_writer_->write(data).rc_);
+  SplicePipe::TransferResult result = pipe_->transfer(*input_, *output_);
+  EXPECT_EQ(1024, result.bytes_read_);
+  EXPECT_EQ(0, result.bytes_written_);
+  EXPECT_TRUE(result.write_blocked_);
+  EXPECT_EQ(1024, pipe_->bufferedBytes());
+
+  // Once the output is writable again, the buffered data is flushed.
+  EXPECT_FALSE(readOutput().empty());
+  result = pipe_->transfer(*input_, *output_);
+  EXPECT_EQ(1024, result.bytes_written_);
+  EXPECT_FALSE(result.write_blocked_);
+  EXPECT_EQ(0, pipe_->bufferedBytes());
+  EXPECT_EQ(std::string(1024, 'b'), readOutput());
+}
+
+TEST(SplicePipeCreateTest, PipeCreationFailure) {
+  Api::MockLinuxOsSysCalls linux_os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls(&linux_os_sys_calls);
+  EXPECT_CALL(linux_os_sys_calls, pipe2(_, _)).WillOnce(Return(Api::SysCallIntResult{-1, EMFILE}));
+  EXPECT_EQ(nullptr, SplicePipe::create());
+}
+
+TEST(SplicePipeCreateTest, SpliceError) {
+  Api::MockLinuxOsSysCalls linux_os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls(&linux_os_sys_calls);
+  EXPECT_CALL(linux_os_sys_calls, pipe2(_, _))
+      .WillOnce(testing::Invoke([](os_fd_t fds[2], int) -> Api::SysCallIntResult {
+        fds[0] = 100;
+        fds[1] = 101;
+        return {0, 0};
+      }));
+  SplicePipePtr pipe = SplicePipe::create();
+  ASSERT_NE(nullptr, pipe);
+
+  IoSocketHandleImpl input;
+  IoSocketHandleImpl output;
+  EXPECT_CALL(linux_os_sys_calls, splice(_, 101, _, _))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, EBADF}));
+  EXPECT_TRUE(pipe->transfer(input, output).error_);
+
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  EXPECT_CALL(os_sys_calls, close(100));
+  EXPECT_CALL(os_sys_calls, close(101));
+  pipe.reset();
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -42,6 +42,7 @@ public:
   void onDataWorker(Network::UdpRecvData&& data) override;
   void post(Network::UdpRecvData&& data) override;
   void onDatagramsDropped(uint32_t dropped) override;
+  void onDatagramsRead(uint64_t datagrams) override;
   uint32_t workerIndex() const override;
   Network::UdpPacketWriter& udpPacketWriter() override;
   size_t numPacketsExpectedPerEventLoop() const override;
@@ -179,6 +180,10 @@ void FuzzUdpListenerCallbacks::onDatagramsDropped(uint32_t dropped) {
   UNREFERENCED_PARAMETER(dropped);
 }
 
+void FuzzUdpListenerCallbacks::onDatagramsRead(uint64_t datagrams) {
+  UNREFERENCED_PARAMETER(datagrams);
+}
+
 size_t FuzzUdpListenerCallbacks::numPacketsExpectedPerEventLoop() const {
   return Network::MAX_NUM_PACKETS_PER_EVENT_LOOP;
 }
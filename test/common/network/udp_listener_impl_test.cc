@@ -47,6 +47,9 @@ class OverrideOsSysCallsImpl : public Api::OsSysCallsImpl {
 public:
   MOCK_METHOD(bool, supportsUdpGro, (), (const));
   MOCK_METHOD(bool, supportsMmsg, (), (const));
+  MOCK_METHOD(Api::SysCallIntResult, recvmmsg,
+              (os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen, int flags,
+               struct timespec* timeout));
 };
 
 class UdpListenerImplTest : public UdpListenerImplTestBase {
@@ -56,6 +59,11 @@ public:
     // Return the real version by default.
     ON_CALL(override_syscall_, supportsMmsg())
         .WillByDefault(Return(os_calls.latched().supportsMmsg()));
+    ON_CALL(override_syscall_, recvmmsg(_, _, _, _, _))
+        .WillByDefault(Invoke([this](os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                     int flags, struct timespec* timeout) {
+          return os_calls.latched().recvmmsg(sockfd, msgvec, vlen, flags, timeout);
+        }));
     ON_CALL(listener_callbacks_, numPacketsExpectedPerEventLoop())
         .WillByDefault(Return(MAX_NUM_PACKETS_PER_EVENT_LOOP));
 
@@ -140,6 +148,11 @@ TEST_P(UdpListenerImplTest, UseActualDstUdp) {
   client_.write(second, *send_to_addr_);
 
   EXPECT_CALL(listener_callbacks_, onReadReady());
+  if (Api::OsSysCallsSingleton::get().supportsMmsg()) {
+    EXPECT_CALL(listener_callbacks_, onDatagramsRead(2u));
+  } else {
+    EXPECT_CALL(listener_callbacks_, onDatagramsRead(1u)).Times(2);
+  }
   EXPECT_CALL(listener_callbacks_, onData(_))
       .WillOnce(Invoke([&](const UdpRecvData& data) -> void {
         validateRecvCallbackParams(
@@ -162,6 +175,73 @@ TEST_P(UdpListenerImplTest, UseActualDstUdp) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+// Test that a recvmmsg batch which isn't filled ends the reads of the event, as the read after it
+// would just fail with EAGAIN.
+TEST_P(UdpListenerImplTest, PartialRecvmmsgBatchEndsReads) {
+  setup();
+  if (!Api::OsSysCallsSingleton::get().supportsMmsg()) {
+    return;
+  }
+
+  const std::string first("first");
+  client_.write(first, *send_to_addr_);
+  const std::string second("second");
+  client_.write(second, *send_to_addr_);
+
+  EXPECT_CALL(override_syscall_, recvmmsg(_, _, NUM_DATAGRAMS_PER_RECEIVE, _, _))
+      .WillOnce(Invoke([this](os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                              int flags, struct timespec* timeout) {
+        return os_calls.latched().recvmmsg(sockfd, msgvec, vlen, flags, timeout);
+      }));
+  EXPECT_CALL(listener_callbacks_, onReadReady());
+  EXPECT_CALL(listener_callbacks_, onDatagramsRead(2u));
+  EXPECT_CALL(listener_callbacks_, onData(_))
+      .WillOnce(Invoke([&](const UdpRecvData& data) -> void {
+        EXPECT_EQ(data.buffer_->toString(), first);
+      }))
+      .WillOnce(Invoke([&](const UdpRecvData& data) -> void {
+        EXPECT_EQ(data.buffer_->toString(), second);
+        dispatcher_->exit();
+      }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+}
+
+// Test that the recvmmsg batches are sized to the number of packets expected per event loop.
+TEST_P(UdpListenerImplTest, RecvmmsgBatchesSizedToExpectedPackets) {
+  setup();
+  if (!Api::OsSysCallsSingleton::get().supportsMmsg() ||
+      !Runtime::runtimeFeatureEnabled("envoy.reloadable_features.udp_per_event_loop_read_limit")) {
+    return;
+  }
+
+  const std::string payload(10, 'a');
+  for (uint64_t i = 0; i < 3; ++i) {
+    client_.write(payload, *send_to_addr_);
+  }
+
+  EXPECT_CALL(listener_callbacks_, numPacketsExpectedPerEventLoop()).WillRepeatedly(Return(2u));
+  EXPECT_CALL(override_syscall_, recvmmsg(_, _, 2u, _, _))
+      .WillRepeatedly(Invoke([this](os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                    int flags, struct timespec* timeout) {
+        return os_calls.latched().recvmmsg(sockfd, msgvec, vlen, flags, timeout);
+      }));
+  EXPECT_CALL(listener_callbacks_, onReadReady()).Times(2);
+  EXPECT_CALL(listener_callbacks_, onDatagramsRead(2u));
+  EXPECT_CALL(listener_callbacks_, onDatagramsRead(1u));
+  uint64_t num_packets_received = 0;
+  EXPECT_CALL(listener_callbacks_, onData(_))
+      .Times(3)
+      .WillRepeatedly(Invoke([&](const UdpRecvData& data) -> void {
+        EXPECT_EQ(payload, data.buffer_->toString());
+        if (++num_packets_received == 3) {
+          dispatcher_->exit();
+        }
+      }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+}
+
 // Test a large datagram that gets dropped using recvmsg or recvmmsg if supported.
 TEST_P(UdpListenerImplTest, LargeDatagramRecvmmsg) {
   setup();
@@ -636,6 +716,7 @@ TEST_P(UdpListenerImplTest, UdpGroBasic) {
       .WillRepeatedly(Return(Api::SysCallSizeResult{-1, EAGAIN}));
 
   EXPECT_CALL(listener_callbacks_, onReadReady());
+  EXPECT_CALL(listener_callbacks_, onDatagramsRead(client_data.size()));
   EXPECT_CALL(listener_callbacks_, onData(_))
       .WillOnce(Invoke([&](const UdpRecvData& data) -> void {
         validateRecvCallbackParams(data, client_data.size());
@@ -617,7 +617,8 @@ TEST(PacketLoss, LossTest) {
   NiceMock<MockUdpPacketProcessor> processor;
   MonotonicTime time(std::chrono::seconds(0));
   uint32_t packets_dropped = 0;
-  Utility::readFromSocket(handle, *address, processor, time, false, &packets_dropped);
+  Utility::readFromSocket(handle, *address, processor, time, false, NUM_DATAGRAMS_PER_RECEIVE,
+                          &packets_dropped);
   EXPECT_EQ(1, packets_dropped);
 
   // Send another packet.
@@ -625,7 +626,8 @@ TEST(PacketLoss, LossTest) {
                                         reinterpret_cast<sockaddr*>(&storage), sizeof(storage)));
 
   // Make sure the drop count is now 2.
-  Utility::readFromSocket(handle, *address, processor, time, false, &packets_dropped);
+  Utility::readFromSocket(handle, *address, processor, time, false, NUM_DATAGRAMS_PER_RECEIVE,
+                          &packets_dropped);
   EXPECT_EQ(2, packets_dropped);
 }
 #endif
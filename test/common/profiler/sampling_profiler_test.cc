@@ -0,0 +1,76 @@
+#include <chrono>
+#include <string>
+
+#include "source/common/profiler/sampling_profiler.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace FakeSpin {
+
+// Stands for a filter using CPU.
+ABSL_ATTRIBUTE_NOINLINE uint64_t spin(std::chrono::milliseconds duration) {
+  uint64_t iterations = 0;
+  const auto start = std::chrono::steady_clock::now();
+  while (std::chrono::steady_clock::now() - start < duration) {
+    iterations++;
+  }
+  return iterations;
+}
+
+} // namespace FakeSpin
+} // namespace HttpFilters
+} // namespace Extensions
+
+namespace Profiler {
+namespace {
+
+TEST(SamplingProfilerTest, FilterName) {
+  EXPECT_EQ("http.ext_authz",
+            Sampling::filterName(
+                "Envoy::Extensions::HttpFilters::ExtAuthz::Filter::decodeHeaders()"));
+  EXPECT_EQ("network.redis_proxy",
+            Sampling::filterName(
+                "Envoy::Extensions::NetworkFilters::RedisProxy::ProxyFilter::onData()"));
+  EXPECT_EQ("listener.tls_inspector",
+            Sampling::filterName(
+                "Envoy::Extensions::ListenerFilters::TlsInspector::Filter::onAccept()"));
+  EXPECT_EQ(absl::nullopt,
+            Sampling::filterName(
+                "Envoy::Extensions::HttpFilters::Common::StreamRateLimiter::onTokenTimer()"));
+  EXPECT_EQ(absl::nullopt, Sampling::filterName("Envoy::Http::FilterManager::decodeHeaders()"));
+  EXPECT_EQ(absl::nullopt, Sampling::filterName("Envoy::Extensions::HttpFilters::"));
+}
+
+TEST(SamplingProfilerTest, InvalidFrequency) {
+  EXPECT_FALSE(Sampling::startProfiler(0));
+  EXPECT_FALSE(Sampling::startProfiler(Sampling::MaxFrequencyHz + 1));
+  EXPECT_FALSE(Sampling::profilerStarted());
+}
+
+TEST(SamplingProfilerTest, Profile) {
+  if (!Sampling::profilerAvailable()) {
+    EXPECT_FALSE(Sampling::startProfiler(Sampling::DefaultFrequencyHz));
+    return;
+  }
+
+  ASSERT_TRUE(Sampling::startProfiler(Sampling::MaxFrequencyHz));
+  EXPECT_TRUE(Sampling::profilerStarted());
+  EXPECT_FALSE(Sampling::startProfiler(Sampling::MaxFrequencyHz));
+  EXPECT_GT(Extensions::HttpFilters::FakeSpin::spin(std::chrono::milliseconds(500)), 0);
+  Sampling::stopProfiler();
+  EXPECT_FALSE(Sampling::profilerStarted());
+
+  // The samples are kept once stopped, labelled with their thread and filter.
+  const std::string profile = Sampling::profile(std::chrono::seconds(60));
+  EXPECT_NE(std::string::npos, profile.find("FakeSpin::spin"));
+  EXPECT_NE(std::string::npos, profile.find("http.fake_spin"));
+  EXPECT_NE(std::string::npos, profile.find("thread"));
+  EXPECT_NE(std::string::npos, profile.find("nanoseconds"));
+}
+
+} // namespace
+} // namespace Profiler
+} // namespace Envoy
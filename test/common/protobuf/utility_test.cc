@@ -41,7 +41,9 @@ using namespace std::chrono_literals;
 
 namespace Envoy {
 
+using testing::_;
 using testing::HasSubstr;
+using testing::NiceMock;
 
 class RuntimeStatsHelper : public TestScopedRuntime {
 public:
@@ -256,6 +258,35 @@ TEST_F(ProtobufUtilityTest, DowncastAndValidateUnknownFieldsNested) {
                             "unknown field set {1}) has unknown fields");
 }
 
+// Messages found valid without any deprecated or unknown field are remembered, the others are
+// checked again each time.
+TEST_F(ProtobufUtilityTest, ValidateRemembersValidMessages) {
+  envoy::config::bootstrap::v3::Bootstrap bootstrap;
+  bootstrap.mutable_node()->set_id("validate_remembers_valid_messages");
+  EXPECT_FALSE(MessageUtil::isValidatedMessage(MessageUtil::validatedMessageKey(bootstrap)));
+  TestUtility::validate(bootstrap);
+  EXPECT_TRUE(MessageUtil::isValidatedMessage(MessageUtil::validatedMessageKey(bootstrap)));
+
+  bootstrap.GetReflection()->MutableUnknownFields(&bootstrap)->AddVarint(1, 0);
+  NiceMock<ProtobufMessage::MockValidationVisitor> validation_visitor;
+  EXPECT_CALL(validation_visitor, onUnknownField(_)).Times(2);
+  MessageUtil::validate(bootstrap, validation_visitor);
+  MessageUtil::validate(bootstrap, validation_visitor);
+  EXPECT_FALSE(MessageUtil::isValidatedMessage(MessageUtil::validatedMessageKey(bootstrap)));
+
+  // Messages are not remembered when their fields are not checked.
+  envoy::config::bootstrap::v3::Bootstrap skipped;
+  skipped.mutable_node()->set_id("validate_remembers_valid_messages_skipped");
+  validation_visitor.setSkipValidation(true);
+  MessageUtil::validate(skipped, validation_visitor);
+  EXPECT_FALSE(MessageUtil::isValidatedMessage(MessageUtil::validatedMessageKey(skipped)));
+
+  bootstrap.GetReflection()->MutableUnknownFields(&bootstrap)->Clear();
+  bootstrap.mutable_static_resources()->add_clusters();
+  EXPECT_THROW(TestUtility::validate(bootstrap), ProtoValidationException);
+  EXPECT_THROW(TestUtility::validate(bootstrap), ProtoValidationException);
+}
+
 TEST_F(ProtobufUtilityTest, JsonConvertAnyUnknownMessageType) {
   ProtobufWkt::Any source_any;
   source_any.set_type_url("type.googleapis.com/bad.type.url");
@@ -116,16 +116,16 @@ protected:
         .WillByDefault(Return(Network::UdpListenerConfigOptRef(udp_listener_config_)));
     ON_CALL(udp_listener_config_, packetWriterFactory())
         .WillByDefault(ReturnRef(udp_packet_writer_factory_));
-    ON_CALL(udp_packet_writer_factory_, createUdpPacketWriter(_, _))
-        .WillByDefault(Invoke(
-            [&](Network::IoHandle& io_handle, Stats::Scope& scope) -> Network::UdpPacketWriterPtr {
+    ON_CALL(udp_packet_writer_factory_, createUdpPacketWriter(_, _, _))
+        .WillByDefault(Invoke([&](Network::IoHandle& io_handle, Event::Dispatcher&,
+                                  Stats::Scope& scope) -> Network::UdpPacketWriterPtr {
 #if UDP_GSO_BATCH_WRITER_COMPILETIME_SUPPORT
-              return std::make_unique<Quic::UdpGsoBatchWriter>(io_handle, scope);
+          return std::make_unique<Quic::UdpGsoBatchWriter>(io_handle, scope);
 #else
-              UNREFERENCED_PARAMETER(scope);
-              return std::make_unique<Network::UdpDefaultWriter>(io_handle);
+          UNREFERENCED_PARAMETER(scope);
+          return std::make_unique<Network::UdpDefaultWriter>(io_handle);
 #endif
-            }));
+        }));
   }
 
   void initialize() {
@@ -156,8 +156,7 @@ protected:
   Network::ActiveUdpListenerFactoryPtr createQuicListenerFactory(const std::string& yaml) {
     envoy::config::listener::v3::QuicProtocolOptions options;
     TestUtility::loadFromYamlAndValidate(yaml, options);
-    return std::make_unique<ActiveQuicListenerFactory>(options, /*concurrency=*/1,
-                                                       quic_stat_names_);
+    return std::make_unique<ActiveQuicListenerFactory>(options, concurrency_, quic_stat_names_);
   }
 
   void maybeConfigureMocks(int connection_count) {
@@ -326,6 +325,7 @@ protected:
   quic::ParsedQuicVersion quic_version_;
   uint32_t connection_window_size_{1024u};
   uint32_t stream_window_size_{1024u};
+  uint32_t concurrency_{1u};
   QuicStatNames quic_stat_names_;
 };
 
@@ -468,6 +468,34 @@ TEST_P(ActiveQuicListenerTest, QuicProcessingDisabledAndEnabled) {
   EXPECT_TRUE(ActiveQuicListenerPeer::enabled(*quic_listener_));
 }
 
+#if defined(SO_ATTACH_REUSEPORT_CBPF) && defined(__linux__)
+TEST_P(ActiveQuicListenerTest, CountsPacketsRoutedByKernelToOtherWorker) {
+  concurrency_ = 2;
+  initialize();
+
+  // Feeds a short header packet, too short to be answered, whose connection ID is routed to the
+  // worker given.
+  auto on_data = [this](uint8_t worker) {
+    Network::UdpRecvData data;
+    data.addresses_.local_ = listen_socket_->addressProvider().localAddress();
+    data.addresses_.peer_ = local_address_;
+    data.buffer_ = std::make_unique<Buffer::OwnedImpl>();
+    const uint8_t packet[20] = {0x40, 0, 0, 0, worker};
+    data.buffer_->add(packet, sizeof(packet));
+    data.receive_time_ = dispatcher_->timeSource().monotonicTime();
+    quic_listener_->onData(std::move(data));
+  };
+
+  Stats::Counter& misrouted =
+      listener_config_.scope_.counterFromString("udp.downstream_rx_datagram_misrouted");
+  on_data(0);
+  EXPECT_EQ(0u, misrouted.value());
+  // The packet stays on the worker the kernel delivered it to.
+  on_data(1);
+  EXPECT_EQ(1u, misrouted.value());
+}
+#endif
+
 class ActiveQuicListenerEmptyFlagConfigTest : public ActiveQuicListenerTest {
 protected:
   std::string yamlForQuicConfig() override {
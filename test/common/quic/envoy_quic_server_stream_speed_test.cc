@@ -0,0 +1,188 @@
+// Measures receiving the body of an HTTP/3 request on a server stream, from the STREAM frames
+// carrying its DATA frame to the buffers passed to the request decoder.
+//
+// The body is copied once out of the blocks of the stream sequencer, which are reused once
+// consumed. The bytes_copied counter is the number of bytes of body copied per request, and
+// slices is the number of buffer slices the body was delivered in.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+
+#include "quiche/quic/test_tools/quic_connection_peer.h"
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#include "source/common/quic/envoy_quic_alarm_factory.h"
+#include "source/common/quic/envoy_quic_connection_helper.h"
+#include "source/common/quic/envoy_quic_server_connection.h"
+#include "source/common/quic/envoy_quic_server_session.h"
+#include "source/common/quic/envoy_quic_server_stream.h"
+
+#include "test/common/quic/test_utils.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/http/stream_decoder.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Quic {
+namespace {
+
+// A server stream of an HTTP/3 session whose peer is fed STREAM frames directly.
+class ServerStreamHarness {
+public:
+  ServerStreamHarness()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")),
+        connection_helper_(*dispatcher_),
+        alarm_factory_(*dispatcher_, *connection_helper_.GetClock()), quic_version_([]() {
+          SetQuicReloadableFlag(quic_disable_version_draft_29, true);
+          SetQuicReloadableFlag(quic_enable_version_rfcv1, true);
+          return quic::CurrentSupportedVersions()[0];
+        }()),
+        quic_config_([]() {
+          quic::QuicConfig config;
+          // Large enough for the peer not to wait for window updates within a request.
+          config.SetInitialStreamFlowControlWindowToSend(16 * 1024 * 1024);
+          config.SetInitialSessionFlowControlWindowToSend(16 * 1024 * 1024);
+          return config;
+        }()),
+        quic_connection_(connection_helper_, alarm_factory_, writer_,
+                         quic::ParsedQuicVersionVector{quic_version_}, *listener_config_.socket_),
+        quic_session_(quic_config_, {quic_version_}, &quic_connection_, *dispatcher_,
+                      quic_config_.GetInitialStreamFlowControlWindowToSend() * 2),
+        stats_({ALL_HTTP3_CODEC_STATS(
+            POOL_COUNTER_PREFIX(listener_config_.listenerScope(), "http3."),
+            POOL_GAUGE_PREFIX(listener_config_.listenerScope(), "http3."))}),
+        quic_stream_(new EnvoyQuicServerStream(
+            stream_id_, &quic_session_, quic::BIDIRECTIONAL, stats_, http3_options_,
+            envoy::config::core::v3::HttpProtocolOptions::ALLOW)) {
+    quic_stream_->setRequestDecoder(stream_decoder_);
+    quic::test::QuicConnectionPeer::SetAddressValidated(&quic_connection_);
+    quic_session_.ActivateStream(std::unique_ptr<EnvoyQuicServerStream>(quic_stream_));
+    ON_CALL(quic_session_, ShouldYield(_)).WillByDefault(testing::Return(false));
+    ON_CALL(quic_session_, WritevData(_, _, _, _, _, _))
+        .WillByDefault(
+            Invoke([](quic::QuicStreamId, size_t write_length, quic::QuicStreamOffset,
+                      quic::StreamSendingState state, bool, absl::optional<quic::EncryptionLevel>) {
+              return quic::QuicConsumedData{write_length, state != quic::NO_FIN};
+            }));
+    ON_CALL(writer_, WritePacket(_, _, _, _, _))
+        .WillByDefault(Invoke([](const char*, size_t buf_len, const quic::QuicIpAddress&,
+                                 const quic::QuicSocketAddress&, quic::PerPacketOptions*) {
+          return quic::WriteResult{quic::WRITE_STATUS_OK, static_cast<int>(buf_len)};
+        }));
+    ON_CALL(stream_decoder_, decodeData(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& buffer, bool) {
+          slices_ += buffer.getRawSlices().size();
+          bytes_copied_ += buffer.length();
+        }));
+
+    quic_session_.Initialize();
+    setQuicConfigWithDefaultValues(quic_session_.config());
+    quic_session_.OnConfigNegotiated();
+
+    // The request headers, and the body of the requests, all sent on the same stream.
+    spdy::SpdyHeaderBlock request_headers;
+    request_headers[":authority"] = "www.abc.com";
+    request_headers[":method"] = "POST";
+    request_headers[":path"] = "/";
+    const std::string headers_payload = spdyHeaderToHttp3StreamPayload(request_headers);
+    receive(headers_payload, headers_payload.size());
+  }
+
+  ~ServerStreamHarness() {
+    quic_session_.close(Network::ConnectionCloseType::NoFlush);
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+
+  // Feeds payload to the stream in STREAM frames of frame_size bytes. If reversed, the frames are
+  // fed last first, so that the stream reads the whole payload at once when the first one arrives.
+  void receive(const std::string& payload, uint64_t frame_size, bool reversed = false) {
+    std::vector<quic::QuicStreamFrame> frames;
+    for (uint64_t offset = 0; offset < payload.size(); offset += frame_size) {
+      frames.emplace_back(stream_id_, /*fin=*/false, offset_ + offset,
+                          absl::string_view(payload).substr(offset, frame_size));
+    }
+    if (reversed) {
+      std::reverse(frames.begin(), frames.end());
+    }
+    for (const quic::QuicStreamFrame& frame : frames) {
+      quic_stream_->OnStreamFrame(frame);
+    }
+    offset_ += payload.size();
+  }
+
+  void resetCounts() {
+    slices_ = 0;
+    bytes_copied_ = 0;
+  }
+  uint64_t slices() const { return slices_; }
+  uint64_t bytesCopied() const { return bytes_copied_; }
+
+private:
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  EnvoyQuicConnectionHelper connection_helper_;
+  EnvoyQuicAlarmFactory alarm_factory_;
+  NiceMock<quic::test::MockPacketWriter> writer_;
+  quic::ParsedQuicVersion quic_version_;
+  quic::QuicConfig quic_config_;
+  NiceMock<Network::MockListenerConfig> listener_config_;
+  NiceMock<MockEnvoyQuicServerConnection> quic_connection_;
+  NiceMock<MockEnvoyQuicSession> quic_session_;
+  const quic::QuicStreamId stream_id_{4u};
+  Http::Http3::CodecStats stats_;
+  envoy::config::core::v3::Http3ProtocolOptions http3_options_;
+  EnvoyQuicServerStream* quic_stream_;
+  NiceMock<Http::MockRequestDecoder> stream_decoder_;
+  uint64_t offset_{};
+  uint64_t slices_{};
+  uint64_t bytes_copied_{};
+};
+
+// state.range(0) is the size of the request body, state.range(1) the size of the STREAM frames
+// carrying it, and state.range(2) is non-zero if the frames arrive last first.
+void bmReceiveRequestBody(::benchmark::State& state) {
+  const uint64_t body_size = state.range(0);
+  const uint64_t frame_size = state.range(1);
+  const bool reversed = state.range(2) != 0;
+  const std::string payload = bodyToHttp3StreamPayload(std::string(body_size, 'a'));
+
+  ServerStreamHarness harness;
+  harness.resetCounts();
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    harness.receive(payload, frame_size, reversed);
+  }
+
+  state.SetBytesProcessed(state.iterations() * body_size);
+  state.counters["bytes_copied"] =
+      ::benchmark::Counter(harness.bytesCopied(), ::benchmark::Counter::kAvgIterations);
+  state.counters["slices"] =
+      ::benchmark::Counter(harness.slices(), ::benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(bmReceiveRequestBody)
+    ->Args({1024, 1200, 0})
+    ->Args({16 * 1024, 1200, 0})
+    ->Args({16 * 1024, 1200, 1})
+    ->Args({256 * 1024, 1200, 0})
+    ->Args({256 * 1024, 1200, 1})
+    ->Unit(::benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Quic
+} // namespace Envoy
@@ -12,6 +12,8 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include "source/common/buffer/buffer_impl.h"
+
 #include "test/mocks/api/mocks.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 
@@ -110,5 +112,20 @@ TEST(EnvoyQuicUtilsTest, HeadersConversion) {
                                                                            100, details));
 }
 
+TEST(EnvoyQuicUtilsTest, CopyBodyRegionsToBuffer) {
+  std::string first = "Hello";
+  std::string second = " world";
+  iovec regions[2] = {{first.data(), first.size()}, {second.data(), second.size()}};
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(11u, copyBodyRegionsToBuffer(regions, 2, buffer));
+  EXPECT_EQ("Hello world", buffer.toString());
+  // The regions are copied into one slice.
+  EXPECT_EQ(1u, buffer.getRawSlices().size());
+
+  regions[0].iov_len = 0;
+  EXPECT_EQ(0u, copyBodyRegionsToBuffer(regions, 1, buffer));
+  EXPECT_EQ(11u, buffer.length());
+}
+
 } // namespace Quic
 } // namespace Envoy
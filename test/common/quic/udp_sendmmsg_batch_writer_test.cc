@@ -0,0 +1,255 @@
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/quic/udp_sendmmsg_batch_writer.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+#if UDP_SENDMMSG_BATCH_WRITER_COMPILETIME_SUPPORT
+
+namespace Envoy {
+namespace Quic {
+namespace {
+
+class MockSendmmsgOsSysCalls : public Api::MockOsSysCalls {
+public:
+  MOCK_METHOD(bool, supportsUdpGso, (), (const));
+};
+
+// A message passed to sendmmsg.
+struct SentMessage {
+  std::string peer_;
+  std::vector<std::string> packets_;
+  // The GSO segment size, 0 if not set.
+  uint16_t segment_size_{};
+  bool has_self_ip_{};
+};
+
+class UdpSendmmsgBatchWriterTest : public ::testing::Test {
+public:
+  UdpSendmmsgBatchWriterTest()
+      : self_address_("::1", 443), peer_address_("::1", 123), other_peer_address_("::2", 123) {}
+
+  void createWriter(bool gso) {
+    ON_CALL(os_sys_calls_, supportsUdpGso()).WillByDefault(Return(gso));
+    flush_cb_ = new NiceMock<Event::MockSchedulableCallback>(&dispatcher_);
+    writer_ = std::make_unique<UdpSendmmsgBatchWriter>(socket_.ioHandle(), dispatcher_, store_);
+  }
+
+  Api::IoCallUint64Result write(const std::string& packet,
+                                const Network::Address::Instance& peer_address) {
+    Buffer::OwnedImpl buffer(packet);
+    return writer_->writePacket(buffer, self_address_.ip(), peer_address);
+  }
+
+  // Records the messages of the next sendmmsg calls, which all succeed.
+  void expectSendmmsg(std::vector<SentMessage>& sent) {
+    EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, _, _))
+        .WillRepeatedly(Invoke([&sent](os_fd_t, struct mmsghdr* msgvec, unsigned int vlen, int) {
+          for (unsigned int i = 0; i < vlen; ++i) {
+            sent.push_back(toSentMessage(msgvec[i].msg_hdr));
+            msgvec[i].msg_len = 0;
+            for (const std::string& packet : sent.back().packets_) {
+              msgvec[i].msg_len += packet.size();
+            }
+          }
+          return Api::SysCallIntResult{static_cast<int>(vlen), 0};
+        }));
+  }
+
+  static SentMessage toSentMessage(const msghdr& hdr) {
+    SentMessage message;
+    message.peer_ = (*Network::Address::addressFromSockAddr(
+                         *reinterpret_cast<sockaddr_storage*>(hdr.msg_name), hdr.msg_namelen,
+                         /*v6only=*/false))
+                        ->asString();
+    for (size_t i = 0; i < hdr.msg_iovlen; ++i) {
+      message.packets_.emplace_back(reinterpret_cast<char*>(hdr.msg_iov[i].iov_base),
+                                    hdr.msg_iov[i].iov_len);
+    }
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&hdr), cmsg)) {
+      if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_SEGMENT) {
+        message.segment_size_ = *reinterpret_cast<uint16_t*>(CMSG_DATA(cmsg));
+      } else if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO) {
+        message.has_self_ip_ = true;
+      }
+    }
+    return message;
+  }
+
+protected:
+  NiceMock<MockSendmmsgOsSysCalls> os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
+  NiceMock<Network::MockListenSocket> socket_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  Stats::IsolatedStoreImpl store_;
+  Network::Address::Ipv6Instance self_address_;
+  Network::Address::Ipv6Instance peer_address_;
+  Network::Address::Ipv6Instance other_peer_address_;
+  Event::MockSchedulableCallback* flush_cb_;
+  std::unique_ptr<UdpSendmmsgBatchWriter> writer_;
+};
+
+// The packets of all the connections are sent together once the event loop iteration ends, even
+// if they are flushed before.
+TEST_F(UdpSendmmsgBatchWriterTest, SendsPacketsAtEndOfIteration) {
+  createWriter(false);
+  EXPECT_TRUE(writer_->isBatchMode());
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, _, _)).Times(0);
+  EXPECT_EQ(5u, write("hello", peer_address_).return_value_);
+  EXPECT_TRUE(writer_->flush().ok());
+  EXPECT_EQ(5u, write("world", other_peer_address_).return_value_);
+  EXPECT_TRUE(writer_->flush().ok());
+  EXPECT_EQ(2u, writer_->bufferedPackets());
+  EXPECT_TRUE(flush_cb_->enabled_);
+
+  std::vector<SentMessage> sent;
+  expectSendmmsg(sent);
+  flush_cb_->invokeCallback();
+  ASSERT_EQ(2u, sent.size());
+  EXPECT_EQ(peer_address_.asString(), sent[0].peer_);
+  EXPECT_EQ(std::vector<std::string>{"hello"}, sent[0].packets_);
+  EXPECT_TRUE(sent[0].has_self_ip_);
+  EXPECT_EQ(0u, sent[0].segment_size_);
+  EXPECT_EQ(other_peer_address_.asString(), sent[1].peer_);
+  EXPECT_EQ(std::vector<std::string>{"world"}, sent[1].packets_);
+  EXPECT_EQ(0u, writer_->bufferedPackets());
+  EXPECT_EQ(10u, store_.counterFromString("total_bytes_sent").value());
+}
+
+// The consecutive packets to a peer are coalesced with GSO, as long as only the last one is
+// shorter.
+TEST_F(UdpSendmmsgBatchWriterTest, CoalescesPacketsToPeerWithGso) {
+  createWriter(true);
+  const std::string full(1200, 'a');
+  write(full, peer_address_);
+  write(full, peer_address_);
+  write("short", peer_address_);
+  write(full, peer_address_);
+  write(full, other_peer_address_);
+
+  std::vector<SentMessage> sent;
+  expectSendmmsg(sent);
+  flush_cb_->invokeCallback();
+  ASSERT_EQ(3u, sent.size());
+  EXPECT_EQ((std::vector<std::string>{full, full, "short"}), sent[0].packets_);
+  EXPECT_EQ(1200u, sent[0].segment_size_);
+  EXPECT_TRUE(sent[0].has_self_ip_);
+  EXPECT_EQ(std::vector<std::string>{full}, sent[1].packets_);
+  EXPECT_EQ(0u, sent[1].segment_size_);
+  EXPECT_EQ(other_peer_address_.asString(), sent[2].peer_);
+  EXPECT_EQ(2 * 1200u + 5 + 2 * 1200u, store_.counterFromString("total_bytes_sent").value());
+}
+
+// The packets are serialized in place into the slots returned by getNextWriteLocation().
+TEST_F(UdpSendmmsgBatchWriterTest, WritesPacketInPlace) {
+  createWriter(false);
+  Network::UdpPacketWriterBuffer location =
+      writer_->getNextWriteLocation(self_address_.ip(), peer_address_);
+  ASSERT_NE(nullptr, location.buffer_);
+  EXPECT_EQ(Network::UdpMaxOutgoingPacketSize, location.length_);
+  memcpy(location.buffer_, "hello", 5); // NOLINT(safe-memcpy)
+  Buffer::OwnedImpl buffer;
+  buffer.addBufferFragment(*new Buffer::BufferFragmentImpl(
+      location.buffer_, 5, [](const void*, size_t, const Buffer::BufferFragmentImpl* fragment) {
+        delete fragment;
+      }));
+  EXPECT_EQ(5u, writer_->writePacket(buffer, self_address_.ip(), peer_address_).return_value_);
+
+  std::vector<SentMessage> sent;
+  expectSendmmsg(sent);
+  flush_cb_->invokeCallback();
+  ASSERT_EQ(1u, sent.size());
+  EXPECT_EQ(std::vector<std::string>{"hello"}, sent[0].packets_);
+}
+
+// Once the writer is full the packets are sent without waiting for the end of the iteration.
+TEST_F(UdpSendmmsgBatchWriterTest, SendsWhenFull) {
+  createWriter(false);
+  std::vector<SentMessage> sent;
+  expectSendmmsg(sent);
+  for (uint32_t i = 0; i < UdpSendmmsgBatchWriter::MaxBufferedPackets; ++i) {
+    write("hello", peer_address_);
+  }
+  EXPECT_EQ(UdpSendmmsgBatchWriter::MaxBufferedPackets, sent.size());
+  EXPECT_EQ(0u, writer_->bufferedPackets());
+}
+
+// The packets the socket doesn't take are sent once it's writable again, and the writer reports
+// itself blocked meanwhile.
+TEST_F(UdpSendmmsgBatchWriterTest, KeepsPacketsWhileBlocked) {
+  createWriter(false);
+  write("hello", peer_address_);
+  write("world", other_peer_address_);
+
+  std::vector<SentMessage> sent;
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, _, _))
+      .WillOnce(Invoke([&sent](os_fd_t, struct mmsghdr* msgvec, unsigned int, int) {
+        sent.push_back(toSentMessage(msgvec[0].msg_hdr));
+        msgvec[0].msg_len = 5;
+        return Api::SysCallIntResult{1, 0};
+      }))
+      .WillOnce(Return(Api::SysCallIntResult{-1, SOCKET_ERROR_AGAIN}));
+  flush_cb_->invokeCallback();
+  ASSERT_EQ(1u, sent.size());
+  EXPECT_TRUE(writer_->isWriteBlocked());
+  EXPECT_EQ(1u, writer_->bufferedPackets());
+  EXPECT_EQ(nullptr, writer_->getNextWriteLocation(self_address_.ip(), peer_address_).buffer_);
+  Api::IoCallUint64Result result = write("again", peer_address_);
+  EXPECT_TRUE(result.wouldBlock());
+
+  writer_->setWritable();
+  EXPECT_FALSE(writer_->isWriteBlocked());
+  expectSendmmsg(sent);
+  flush_cb_->invokeCallback();
+  ASSERT_EQ(2u, sent.size());
+  EXPECT_EQ(other_peer_address_.asString(), sent[1].peer_);
+  EXPECT_EQ(std::vector<std::string>{"world"}, sent[1].packets_);
+  EXPECT_EQ(0u, writer_->bufferedPackets());
+}
+
+// A message the kernel fails to send is dropped, and the next ones are still sent.
+TEST_F(UdpSendmmsgBatchWriterTest, DropsPacketsOnError) {
+  createWriter(false);
+  write("hello", peer_address_);
+  write("world", other_peer_address_);
+
+  std::vector<SentMessage> sent;
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EPERM}))
+      .WillOnce(Invoke([&sent](os_fd_t, struct mmsghdr* msgvec, unsigned int vlen, int) {
+        EXPECT_EQ(1u, vlen);
+        sent.push_back(toSentMessage(msgvec[0].msg_hdr));
+        msgvec[0].msg_len = 5;
+        return Api::SysCallIntResult{1, 0};
+      }));
+  flush_cb_->invokeCallback();
+  ASSERT_EQ(1u, sent.size());
+  EXPECT_EQ(std::vector<std::string>{"world"}, sent[0].packets_);
+  EXPECT_FALSE(writer_->isWriteBlocked());
+  EXPECT_EQ(0u, writer_->bufferedPackets());
+  EXPECT_EQ(1u, store_.counterFromString("pkts_dropped").value());
+}
+
+} // namespace
+} // namespace Quic
+} // namespace Envoy
+
+#endif // UDP_SENDMMSG_BATCH_WRITER_COMPILETIME_SUPPORT
@@ -1,3 +1,7 @@
+#include <functional>
+#include <map>
+#include <string>
+
 #include "envoy/config/route/v3/route.pb.h"
 #include "envoy/config/route/v3/route.pb.validate.h"
 
@@ -8,6 +12,8 @@
 #include "test/mocks/stream_info/mocks.h"
 #include "test/test_common/utility.h"
 
+#include "absl/container/node_hash_map.h"
+#include "absl/strings/ascii.h"
 #include "benchmark/benchmark.h"
 #include "gmock/gmock.h"
 
@@ -59,7 +65,7 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
       break;
     }
     case RouteMatch::PathSpecifierCase::kPath: {
-      match->set_prefix(absl::StrCat("/shelves/shelf_", i, "/route_", i));
+      match->set_path(absl::StrCat("/shelves/shelf_", i, "/route_", i));
       break;
     }
     case RouteMatch::PathSpecifierCase::kSafeRegex: {
@@ -68,6 +74,23 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
       regex->set_regex(absl::StrCat("^/shelves/[^\\\\/]+/route_", i, "$"));
       break;
     }
+    case RouteMatch::PathSpecifierCase::PATH_SPECIFIER_NOT_SET: {
+      // A mix of the three, as in an API gateway.
+      switch (i % 3) {
+      case 0:
+        match->set_prefix(absl::StrCat("/shelves/shelf_", i, "/"));
+        break;
+      case 1:
+        match->set_path(absl::StrCat("/shelves/shelf_", i, "/route_", i));
+        break;
+      default:
+        envoy::type::matcher::v3::RegexMatcher* regex = match->mutable_safe_regex();
+        regex->mutable_google_re2();
+        regex->set_regex(absl::StrCat("^/shelves/[^\\/]+/route_", i, "$"));
+        break;
+      }
+      break;
+    }
     default:
       NOT_REACHED_GCOVR_EXCL_LINE;
     }
@@ -78,7 +101,8 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
 
 /**
  * Measure the speed of doing a route match against a route table of varying sizes.
- * Why? Currently, route matching is linear in first-to-win ordering.
+ * Why? Route matching is first-to-win, and only the routes whose path specifier may match the
+ * request path are evaluated.
  *
  * We construct the first `n - 1` items in the route table so they are not
  * matched by the incoming request. Only the last route will be matched.
@@ -136,9 +160,114 @@ static void bmRouteTableSizeWithRegexMatch(benchmark::State& state) {
   bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kSafeRegex);
 }
 
-BENCHMARK(bmRouteTableSizeWithPathPrefixMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
-BENCHMARK(bmRouteTableSizeWithExactPathMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
-BENCHMARK(bmRouteTableSizeWithRegexMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
+/**
+ * Benchmark a route table mixing the path prefix, exact path and regex matchers above.
+ */
+static void bmRouteTableSizeWithMixedMatch(benchmark::State& state) {
+  bmRouteTableSize(state, RouteMatch::PathSpecifierCase::PATH_SPECIFIER_NOT_SET);
+}
+
+/**
+ * Generates a route config with `n` suffix wildcard virtual hosts of the form:
+ * - *.shelf_x.example.com
+ * - *-x.example.com
+ */
+static RouteConfiguration genWildcardVirtualHostConfig(int64_t virtual_hosts) {
+  RouteConfiguration route_config;
+  for (int64_t i = 0; i < virtual_hosts; ++i) {
+    VirtualHost* v_host = route_config.add_virtual_hosts();
+    v_host->set_name(absl::StrCat("vhost_", i));
+    v_host->add_domains(absl::StrCat("*.shelf_", i, ".example.com"));
+    v_host->add_domains(absl::StrCat("*-", i, ".example.com"));
+  }
+  return route_config;
+}
+
+/**
+ * The lookup of the wildcard virtual hosts before they were kept in a trie: a map of the wildcards
+ * by length, probed from the longest length down with a substring of the host for each length.
+ */
+class LengthMapWildcardVirtualHosts {
+public:
+  explicit LengthMapWildcardVirtualHosts(const RouteConfiguration& route_config) {
+    for (const VirtualHost& v_host : route_config.virtual_hosts()) {
+      for (const std::string& domain : v_host.domains()) {
+        wildcards_[domain.size() - 1].emplace(domain.substr(1), &v_host);
+      }
+    }
+  }
+
+  const VirtualHost* find(const std::string& host) const {
+    for (const auto& iter : wildcards_) {
+      if (iter.first >= static_cast<int64_t>(host.size())) {
+        continue;
+      }
+      const auto match = iter.second.find(host.substr(host.size() - iter.first));
+      if (match != iter.second.end()) {
+        return match->second;
+      }
+    }
+    return nullptr;
+  }
+
+private:
+  std::map<int64_t, absl::node_hash_map<std::string, const VirtualHost*>, std::greater<>>
+      wildcards_;
+};
+
+/**
+ * Measure the speed of finding the virtual host of a request among `n` wildcard virtual hosts,
+ * with the host matching the wildcard of the last one.
+ */
+static void bmWildcardVirtualHostLookup(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  ConfigImpl config(genWildcardVirtualHostConfig(state.range(0)), OptionalHttpFilters(),
+                    factory_context, ProtobufMessage::getNullValidationVisitor(), true);
+  const auto headers = Http::TestRequestHeaderMapImpl{
+      {":authority", absl::StrCat("api.shelf_", state.range(0) - 1, ".example.com")}};
+
+  for (auto _ : state) { // NOLINT
+    // Without an x-forwarded-proto header, routing stops once the virtual host is found.
+    benchmark::DoNotOptimize(config.route(headers, stream_info, 0));
+  }
+}
+
+/**
+ * The same lookup as bmWildcardVirtualHostLookup() with the length map.
+ */
+static void bmWildcardVirtualHostLengthMapLookup(benchmark::State& state) {
+  const RouteConfiguration route_config = genWildcardVirtualHostConfig(state.range(0));
+  const LengthMapWildcardVirtualHosts wildcards(route_config);
+  const auto headers = Http::TestRequestHeaderMapImpl{
+      {":authority", absl::StrCat("api.shelf_", state.range(0) - 1, ".example.com")}};
+
+  for (auto _ : state) { // NOLINT
+    const std::string host = absl::AsciiStrToLower(headers.getHostValue());
+    benchmark::DoNotOptimize(wildcards.find(host));
+  }
+}
+
+BENCHMARK(bmRouteTableSizeWithPathPrefixMatch)
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 2 << 13}})
+    ->Arg(10000);
+BENCHMARK(bmRouteTableSizeWithExactPathMatch)
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 2 << 13}})
+    ->Arg(10000);
+BENCHMARK(bmRouteTableSizeWithRegexMatch)
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 2 << 13}})
+    ->Arg(10000);
+BENCHMARK(bmRouteTableSizeWithMixedMatch)
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 2 << 13}})
+    ->Arg(10000);
+BENCHMARK(bmWildcardVirtualHostLookup)->RangeMultiplier(4)->Ranges({{1, 4 << 10}});
+BENCHMARK(bmWildcardVirtualHostLengthMapLookup)->RangeMultiplier(4)->Ranges({{1, 4 << 10}});
 
 } // namespace
 } // namespace Router
@@ -61,9 +61,11 @@ public:
   TestConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
                  Server::Configuration::ServerFactoryContext& factory_context,
                  bool validate_clusters_default,
-                 const OptionalHttpFilters& optional_http_filters = OptionalHttpFilters())
+                 const OptionalHttpFilters& optional_http_filters = OptionalHttpFilters(),
+                 const ConfigImpl* previous_config = nullptr)
       : ConfigImpl(config, optional_http_filters, factory_context,
-                   ProtobufMessage::getNullValidationVisitor(), validate_clusters_default),
+                   ProtobufMessage::getNullValidationVisitor(), validate_clusters_default,
+                   previous_config),
         config_(config) {}
 
   void setupRouteConfig(const Http::RequestHeaderMap& headers, uint64_t random_value) const {
@@ -1149,6 +1151,184 @@ virtual_hosts:
             config.route(genHeaders("example.com", "/", "GET"), 0)->routeEntry()->clusterName());
 }
 
+TEST_F(RouteMatcherTest, TestLongestPrefixAndSuffixWildcards) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: short_prefix
+    domains: ["api.*"]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: "short_prefix" }
+  - name: long_prefix
+    domains: ["api.example.*"]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: "long_prefix" }
+  - name: suffix
+    domains: ["*.example.org"]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: "suffix" }
+  - name: default
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: "default" }
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters(
+      {"short_prefix", "long_prefix", "suffix", "default"}, {});
+  const auto proto_config = parseRouteConfigurationFromYaml(yaml);
+  TestConfigImpl config(proto_config, factory_context_, true);
+
+  EXPECT_EQ("long_prefix", config.route(genHeaders("api.example.com", "/", "GET"), 0)
+                               ->routeEntry()
+                               ->clusterName());
+  EXPECT_EQ("short_prefix", config.route(genHeaders("api.examples.com", "/", "GET"), 0)
+                                ->routeEntry()
+                                ->clusterName());
+  // Suffix wildcards take precedence over prefix wildcards.
+  EXPECT_EQ("suffix", config.route(genHeaders("api.example.org", "/", "GET"), 0)
+                          ->routeEntry()
+                          ->clusterName());
+  // A wildcard matches at least one character.
+  EXPECT_EQ("short_prefix",
+            config.route(genHeaders("api.example.", "/", "GET"), 0)->routeEntry()->clusterName());
+  EXPECT_EQ("default",
+            config.route(genHeaders("api.", "/", "GET"), 0)->routeEntry()->clusterName());
+}
+
+TEST_F(RouteMatcherTest, RouteCache) {
+  const std::string yaml = R"EOF(
+name: foo
+route_cache_size: 2
+virtual_hosts:
+  - name: cacheable
+    domains: ["cacheable.com"]
+    routes:
+      - match: { prefix: "/foo" }
+        route: { cluster: "foo" }
+      - match:
+          prefix: "/"
+          headers:
+            - name: ":method"
+              exact_match: "POST"
+        route: { cluster: "post" }
+  - name: uncacheable
+    domains: ["uncacheable.com"]
+    routes:
+      - match:
+          prefix: "/"
+          headers:
+            - name: "x-safe"
+              exact_match: "safe"
+        route: { cluster: "foo" }
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters({"foo", "post"}, {});
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+  auto counter = [this](const std::string& name) {
+    return factory_context_.scope_.counterFromString("route_config.foo.route_cache." + name)
+        .value();
+  };
+
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ("foo", config.route(genHeaders("cacheable.com", "/foo", "GET"), 0)
+                         ->routeEntry()
+                         ->clusterName());
+  }
+  EXPECT_EQ(1, counter("miss"));
+  EXPECT_EQ(2, counter("hit"));
+
+  // The method and x-forwarded-proto header are a part of the key.
+  EXPECT_EQ("post", config.route(genHeaders("cacheable.com", "/bar", "POST"), 0)
+                        ->routeEntry()
+                        ->clusterName());
+  EXPECT_EQ(nullptr, config.route(genHeaders("cacheable.com", "/bar", "GET"), 0));
+  EXPECT_EQ(nullptr, config.route(genHeaders("cacheable.com", "/bar", "GET"), 0));
+  EXPECT_EQ(nullptr, config.route(genHeaders("cacheable.com", "/foo", "GET", ""), 0));
+  EXPECT_EQ(4, counter("miss"));
+  EXPECT_EQ(3, counter("hit"));
+  EXPECT_EQ(2, counter("eviction"));
+
+  // The lookups with a callback are not cached.
+  EXPECT_EQ("foo", config
+                       .route(
+                           [](RouteConstSharedPtr, RouteEvalStatus) -> RouteMatchStatus {
+                             return RouteMatchStatus::Accept;
+                           },
+                           genHeaders("cacheable.com", "/foo", "GET"))
+                       ->routeEntry()
+                       ->clusterName());
+  EXPECT_EQ(3, counter("hit"));
+
+  EXPECT_EQ("foo", config.route(genHeaders("uncacheable.com", "/", "GET"), 0)
+                       ->routeEntry()
+                       ->clusterName());
+  EXPECT_EQ(1, counter("uncacheable"));
+  EXPECT_EQ(4, counter("miss"));
+}
+
+TEST_F(RouteMatcherTest, ReuseUnchangedVirtualHosts) {
+  const std::string yaml = R"EOF(
+name: foo
+virtual_hosts:
+  - name: www
+    domains: ["www.lyft.com"]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: "www" }
+  - name: api
+    domains: ["api.lyft.com"]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: "api" }
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters({"www", "api", "api2"}, {});
+  envoy::config::route::v3::RouteConfiguration route_config =
+      parseRouteConfigurationFromYaml(yaml);
+  TestConfigImpl config(route_config, factory_context_, false);
+  EXPECT_EQ(2, config.virtualHostsBuilt());
+  EXPECT_EQ(0, config.virtualHostsReused());
+  const RouteConstSharedPtr www_route = config.route(genHeaders("www.lyft.com", "/", "GET"), 0);
+
+  // Only the changed virtual host is built again.
+  route_config.mutable_virtual_hosts(1)->mutable_routes(0)->mutable_route()->set_cluster("api2");
+  TestConfigImpl updated_config(route_config, factory_context_, false, OptionalHttpFilters(),
+                                &config);
+  EXPECT_EQ(1, updated_config.virtualHostsBuilt());
+  EXPECT_EQ(1, updated_config.virtualHostsReused());
+  EXPECT_EQ(www_route, updated_config.route(genHeaders("www.lyft.com", "/", "GET"), 0));
+  EXPECT_EQ("api2", updated_config.route(genHeaders("api.lyft.com", "/", "GET"), 0)
+                        ->routeEntry()
+                        ->clusterName());
+
+  // The virtual hosts of the previous version stay valid.
+  EXPECT_EQ("api",
+            config.route(genHeaders("api.lyft.com", "/", "GET"), 0)->routeEntry()->clusterName());
+
+  // A change of the rest of the route configuration builds every virtual host again.
+  route_config.add_internal_only_headers("x-lyft-internal");
+  TestConfigImpl rebuilt_config(route_config, factory_context_, false, OptionalHttpFilters(),
+                                &updated_config);
+  EXPECT_EQ(2, rebuilt_config.virtualHostsBuilt());
+  EXPECT_EQ(0, rebuilt_config.virtualHostsReused());
+  EXPECT_NE(www_route, rebuilt_config.route(genHeaders("www.lyft.com", "/", "GET"), 0));
+  EXPECT_EQ(1, rebuilt_config.route(genHeaders("www.lyft.com", "/", "GET"), 0)
+                   ->routeEntry()
+                   ->virtualHost()
+                   .routeConfig()
+                   .internalOnlyHeaders()
+                   .size());
+
+  // The clusters of the virtual hosts are validated again when requested.
+  TestConfigImpl validated_config(route_config, factory_context_, true, OptionalHttpFilters(),
+                                  &rebuilt_config);
+  EXPECT_EQ(2, validated_config.virtualHostsBuilt());
+  EXPECT_EQ(0, validated_config.virtualHostsReused());
+}
+
 TEST_F(RouteMatcherTest, TestRoutesWithInvalidRegex) {
   std::string invalid_route = R"EOF(
 virtual_hosts:
@@ -1777,6 +1957,38 @@ virtual_hosts:
             config.route(genHeaders("www.lyft.com", "/bar", "GET"), 0)->routeEntry()->priority());
 }
 
+TEST_F(RouteMatcherTest, QueuePriority) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+- name: local_service
+  domains:
+  - "*"
+  routes:
+  - match:
+      prefix: "/foo"
+      headers:
+      - name: x-request-class
+        string_match:
+          exact: interactive
+    route:
+      cluster: local_service_grpc
+      queue_priority: 2
+  - match:
+      prefix: "/foo"
+    route:
+      cluster: local_service_grpc
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters({"local_service_grpc"}, {});
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+
+  Http::TestRequestHeaderMapImpl interactive = genHeaders("www.lyft.com", "/foo", "GET");
+  interactive.addCopy("x-request-class", "interactive");
+  EXPECT_EQ(2, config.route(interactive, 0)->routeEntry()->queuePriority());
+  EXPECT_EQ(
+      0, config.route(genHeaders("www.lyft.com", "/foo", "GET"), 0)->routeEntry()->queuePriority());
+}
+
 TEST_F(RouteMatcherTest, NoHostRewriteAndAutoRewrite) {
   const std::string yaml = R"EOF(
 virtual_hosts:
@@ -3219,6 +3431,34 @@ virtual_hosts:
   EXPECT_EQ("foo", boz_shadow_policies[1]->runtimeKey());
 }
 
+TEST_F(RouteMatcherTest, StreamedShadow) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+- name: www2
+  domains:
+  - www.lyft.com
+  routes:
+  - match:
+      prefix: "/foo"
+    route:
+      request_mirror_policies:
+        - cluster: some_cluster
+        - cluster: some_cluster2
+          stream_body: true
+      cluster: www2
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters({"www2", "some_cluster", "some_cluster2"},
+                                                       {});
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+
+  const auto& shadow_policies =
+      config.route(genHeaders("www.lyft.com", "/foo", "GET"), 0)->routeEntry()->shadowPolicies();
+  EXPECT_EQ(2, shadow_policies.size());
+  EXPECT_FALSE(shadow_policies[0]->streamBody());
+  EXPECT_TRUE(shadow_policies[1]->streamBody());
+}
+
 TEST_F(RouteMatcherTest, DEPRECATED_FEATURE_TEST(ShadowPolicyAndPolicies)) {
   TestDeprecatedV2Api _deprecated_v2_api;
   const std::string yaml = R"EOF(
@@ -3785,6 +4025,57 @@ virtual_hosts:
   EXPECT_EQ(100, ProtobufPercentHelper::fractionalPercentDenominatorToInt(percent.denominator()));
 }
 
+TEST_F(RouteMatcherTest, HedgeOnLatency) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+- domains: [www.lyft.com]
+  name: www
+  routes:
+  - match: {prefix: /foo}
+    route:
+      cluster: www
+      hedge_policy:
+        hedge_on_latency:
+          percentile: {value: 99}
+          budget_percent: {value: 5}
+          min_samples: 1000
+  - match: {prefix: /bar}
+    route:
+      cluster: www
+      hedge_policy:
+        hedge_on_latency: {}
+  - match: {prefix: /}
+    route: {cluster: www}
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters({"www"}, {});
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+
+  const LatencyHedgeSettings* latency_hedge =
+      config.route(genHeaders("www.lyft.com", "/foo", "GET"), 0)
+          ->routeEntry()
+          ->hedgePolicy()
+          .latencyHedge();
+  ASSERT_NE(nullptr, latency_hedge);
+  EXPECT_EQ(99, latency_hedge->percentile_);
+  EXPECT_EQ(5, latency_hedge->budget_percent_);
+  EXPECT_EQ(1000, latency_hedge->min_samples_);
+
+  latency_hedge = config.route(genHeaders("www.lyft.com", "/bar", "GET"), 0)
+                      ->routeEntry()
+                      ->hedgePolicy()
+                      .latencyHedge();
+  ASSERT_NE(nullptr, latency_hedge);
+  EXPECT_EQ(95, latency_hedge->percentile_);
+  EXPECT_EQ(10, latency_hedge->budget_percent_);
+  EXPECT_EQ(100, latency_hedge->min_samples_);
+
+  EXPECT_EQ(nullptr, config.route(genHeaders("www.lyft.com", "/", "GET"), 0)
+                         ->routeEntry()
+                         ->hedgePolicy()
+                         .latencyHedge());
+}
+
 TEST_F(RouteMatcherTest, HedgeVirtualHostLevel) {
   const std::string yaml = R"EOF(
 virtual_hosts:
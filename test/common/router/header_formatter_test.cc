@@ -801,6 +801,31 @@ TEST_F(StreamInfoHeaderFormatterTest, WrongFormatOnUpstreamMetadataVariable) {
       "does not match actual type 'Object'.");
 }
 
+TEST(HeaderFormatterTest, ValueScopes) {
+  EXPECT_NE(nullptr, StreamInfoHeaderFormatter("HOSTNAME", false).staticValue());
+  EXPECT_TRUE(StreamInfoHeaderFormatter("DOWNSTREAM_LOCAL_ADDRESS", false).connectionScoped());
+  EXPECT_TRUE(StreamInfoHeaderFormatter("DOWNSTREAM_PEER_URI_SAN", false).connectionScoped());
+  EXPECT_FALSE(StreamInfoHeaderFormatter("DOWNSTREAM_REMOTE_ADDRESS", false).connectionScoped());
+  EXPECT_FALSE(StreamInfoHeaderFormatter("PROTOCOL", false).connectionScoped());
+
+  std::vector<HeaderFormatterPtr> static_formatters;
+  static_formatters.push_back(std::make_unique<PlainHeaderFormatter>("host-", false));
+  static_formatters.push_back(std::make_unique<StreamInfoHeaderFormatter>("HOSTNAME", false));
+  CompoundHeaderFormatter static_compound(std::move(static_formatters), false);
+  ASSERT_NE(nullptr, static_compound.staticValue());
+  EXPECT_EQ("host-" + *StreamInfoHeaderFormatter("HOSTNAME", false).staticValue(),
+            *static_compound.staticValue());
+  EXPECT_FALSE(static_compound.connectionScoped());
+
+  std::vector<HeaderFormatterPtr> connection_formatters;
+  connection_formatters.push_back(std::make_unique<PlainHeaderFormatter>("local-", false));
+  connection_formatters.push_back(
+      std::make_unique<StreamInfoHeaderFormatter>("DOWNSTREAM_LOCAL_ADDRESS", false));
+  CompoundHeaderFormatter connection_compound(std::move(connection_formatters), false);
+  EXPECT_EQ(nullptr, connection_compound.staticValue());
+  EXPECT_TRUE(connection_compound.connectionScoped());
+}
+
 TEST(HeaderParserTest, TestParseInternal) {
   struct TestCase {
     std::string input_;
@@ -1087,6 +1112,89 @@ TEST(HeaderParserTest, EvaluateHeaderValuesWithNullStreamInfo) {
   EXPECT_FALSE(header_map.has("empty"));
 }
 
+TEST(HeaderParserTest, StaticValuesAreAddedByReference) {
+  const std::string yaml = R"EOF(
+match: { prefix: "/new_endpoint" }
+route:
+  cluster: "www2"
+request_headers_to_add:
+  - header:
+      key: "x-static"
+      value: "static-value"
+    append: true
+  - header:
+      key: "x-escaped"
+      value: "100%%"
+    append: false
+  - header:
+      key: "x-client-ip"
+      value: "%DOWNSTREAM_REMOTE_ADDRESS_WITHOUT_PORT%"
+    append: true
+)EOF";
+
+  HeaderParserPtr req_header_parser =
+      HeaderParser::configure(parseRouteFromV3Yaml(yaml).request_headers_to_add());
+  Http::TestRequestHeaderMapImpl header_map{{":method", "POST"}};
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+  req_header_parser->evaluateHeaders(header_map, stream_info);
+
+  const auto static_value = header_map.get(Http::LowerCaseString("x-static"));
+  ASSERT_EQ(1, static_value.size());
+  EXPECT_EQ("static-value", static_value[0]->value().getStringView());
+  EXPECT_TRUE(static_value[0]->value().isReference());
+
+  const auto escaped_value = header_map.get(Http::LowerCaseString("x-escaped"));
+  ASSERT_EQ(1, escaped_value.size());
+  EXPECT_EQ("100%", escaped_value[0]->value().getStringView());
+  EXPECT_TRUE(escaped_value[0]->value().isReference());
+
+  const auto formatted_value = header_map.get(Http::LowerCaseString("x-client-ip"));
+  ASSERT_EQ(1, formatted_value.size());
+  EXPECT_EQ("127.0.0.1", formatted_value[0]->value().getStringView());
+  EXPECT_FALSE(formatted_value[0]->value().isReference());
+}
+
+TEST(HeaderParserTest, ConnectionScopedValuesAreFormattedOncePerConnection) {
+  const std::string yaml = R"EOF(
+match: { prefix: "/new_endpoint" }
+route:
+  cluster: "www2"
+request_headers_to_add:
+  - header:
+      key: "x-local"
+      value: "local %DOWNSTREAM_LOCAL_ADDRESS%"
+    append: false
+  - header:
+      key: "x-remote"
+      value: "%DOWNSTREAM_REMOTE_ADDRESS%"
+    append: false
+)EOF";
+
+  HeaderParserPtr req_header_parser =
+      HeaderParser::configure(parseRouteFromV3Yaml(yaml).request_headers_to_add());
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+  stream_info.downstream_address_provider_->setConnectionID(1);
+  auto evaluate = [&]() {
+    Http::TestRequestHeaderMapImpl header_map{{":method", "POST"}};
+    req_header_parser->evaluateHeaders(header_map, stream_info);
+    return std::make_pair(header_map.get_("x-local"), header_map.get_("x-remote"));
+  };
+  EXPECT_EQ(std::make_pair(std::string("local 127.0.0.2:0"), std::string("127.0.0.1:0")),
+            evaluate());
+
+  // The values of the connection are kept, while those of the stream are formatted again.
+  stream_info.downstream_address_provider_->setLocalAddress(
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.3"));
+  stream_info.downstream_address_provider_->setRemoteAddress(
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.4"));
+  EXPECT_EQ(std::make_pair(std::string("local 127.0.0.2:0"), std::string("127.0.0.4:0")),
+            evaluate());
+
+  stream_info.downstream_address_provider_->setConnectionID(2);
+  EXPECT_EQ(std::make_pair(std::string("local 127.0.0.3:0"), std::string("127.0.0.4:0")),
+            evaluate());
+}
+
 TEST(HeaderParserTest, EvaluateEmptyHeaders) {
   const std::string yaml = R"EOF(
 match: { prefix: "/new_endpoint" }
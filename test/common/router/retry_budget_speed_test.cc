@@ -0,0 +1,54 @@
+// Compares deciding whether to retry with the retry budget shared by the workers of a cluster,
+// which is computed from the active requests and retries of all the workers, with the budget each
+// worker keeps for itself.
+
+#include <algorithm>
+#include <cstdint>
+
+#include "source/common/common/basic_resource_impl.h"
+#include "source/common/common/utility.h"
+#include "source/common/router/worker_retry_budget.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_SharedRetryBudget(benchmark::State& state) {
+  static BasicResourceLimitImpl requests;
+  static BasicResourceLimitImpl retries;
+
+  for (auto _ : state) { // NOLINT
+    requests.inc();
+    const uint64_t max_retries = std::max<uint64_t>(20.0 / 100 * requests.count(), 3);
+    if (retries.count() < max_retries) {
+      retries.inc();
+      retries.dec();
+    }
+    requests.dec();
+  }
+}
+BENCHMARK(BM_SharedRetryBudget)->Threads(1)->Threads(8)->Threads(64);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_WorkerRetryBudget(benchmark::State& state) {
+  RealTimeSource time_source;
+  const Upstream::WorkerRetryBudgetSettings settings{20.0, 3};
+
+  for (auto _ : state) { // NOLINT
+    const MonotonicTime now = time_source.monotonicTime();
+    WorkerRetryBudgetSharedPtr budget = WorkerRetryBudget::forCluster(
+        "cluster", Upstream::ResourcePriority::Default, settings, now);
+    budget->onRequest(now);
+    if (budget->canRetry()) {
+      budget->onRetry();
+    }
+  }
+}
+BENCHMARK(BM_WorkerRetryBudget)->Threads(1)->Threads(8)->Threads(64);
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -1152,6 +1152,36 @@ TEST_F(RouterRetryStateImplTest, BudgetNoAvailableRetries) {
   EXPECT_EQ(RetryStatus::NoOverflow, state_->shouldRetryHeaders(response_headers, callback_));
 }
 
+TEST_F(RouterRetryStateImplTest, WorkerBudget) {
+  // The buckets are kept per thread across the tests, so the cluster gets a name of its own.
+  cluster_.name_ = "worker_budget_cluster";
+  // The max_retries CB allows no retries, and is overridden by the worker budget.
+  cluster_.resetResourceManagerWithRetryBudget(
+      0 /* cx */, 0 /* rq_pending */, 0 /* rq */, 0 /* rq_retry */, 0 /* conn_pool */,
+      50.0 /* budget_percent */, 1 /* min_retry_concurrency */, true /* per_worker */);
+
+  Http::TestRequestHeaderMapImpl request_headers{{"x-envoy-retry-on", "5xx"},
+                                                 {"x-envoy-max-retries", "42"}};
+  Http::TestResponseHeaderMapImpl response_headers{{":status", "500"}};
+  setup(request_headers);
+  EXPECT_TRUE(state_->enabled());
+
+  // The bucket starts with min_retry_concurrency tokens.
+  expectTimerCreateAndEnable();
+  EXPECT_EQ(RetryStatus::Yes, state_->shouldRetryHeaders(response_headers, callback_));
+  EXPECT_EQ(RetryStatus::NoOverflow, state_->shouldRetryHeaders(response_headers, callback_));
+  EXPECT_EQ(1UL, cluster_.stats().upstream_rq_retry_budget_exhausted_.value());
+  EXPECT_EQ(1UL, cluster_.stats().upstream_rq_retry_overflow_.value());
+  // The shared retry circuit breaker is not used.
+  EXPECT_EQ(0UL, cluster_.resourceManager(Upstream::ResourcePriority::Default).retries().count());
+
+  // The bucket is refilled up to min_retry_concurrency on reconciliation.
+  test_time_.advanceTimeWait(std::chrono::seconds(1));
+  setup(request_headers);
+  expectTimerCreateAndEnable();
+  EXPECT_EQ(RetryStatus::Yes, state_->shouldRetryHeaders(response_headers, callback_));
+}
+
 TEST_F(RouterRetryStateImplTest, BudgetVerifyMinimumConcurrency) {
   // Expect no available retries from resource manager.
   cluster_.resetResourceManagerWithRetryBudget(
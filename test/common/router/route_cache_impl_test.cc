@@ -0,0 +1,86 @@
+#include <memory>
+
+#include "source/common/router/route_cache_impl.h"
+
+#include "test/mocks/router/mocks.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+using testing::NiceMock;
+
+Http::TestRequestHeaderMapImpl genHeaders(const std::string& path) {
+  return Http::TestRequestHeaderMapImpl{{":authority", "host"},
+                                        {":path", path},
+                                        {":method", "GET"},
+                                        {"x-forwarded-proto", "http"}};
+}
+
+TEST(RouteCacheTest, EvictsLeastRecentlyUsed) {
+  RouteCache cache(2);
+  auto route_a = std::make_shared<NiceMock<MockRoute>>();
+  auto route_b = std::make_shared<NiceMock<MockRoute>>();
+  RouteConstSharedPtr route;
+
+  EXPECT_FALSE(cache.find(genHeaders("/a"), route));
+  EXPECT_FALSE(cache.insert(route_a));
+  EXPECT_FALSE(cache.find(genHeaders("/b"), route));
+  EXPECT_FALSE(cache.insert(route_b));
+  EXPECT_FALSE(cache.find(genHeaders("/none"), route));
+  EXPECT_TRUE(cache.insert(nullptr));
+  EXPECT_EQ(2, cache.size());
+
+  // /a was evicted, /b is now the least recently used.
+  EXPECT_FALSE(cache.find(genHeaders("/a"), route));
+  route = route_a;
+  EXPECT_TRUE(cache.find(genHeaders("/none"), route));
+  EXPECT_EQ(nullptr, route);
+  EXPECT_TRUE(cache.find(genHeaders("/b"), route));
+  EXPECT_EQ(route_b, route);
+  EXPECT_FALSE(cache.find(genHeaders("/a"), route));
+  EXPECT_TRUE(cache.insert(route_a));
+  EXPECT_FALSE(cache.find(genHeaders("/none"), route));
+}
+
+TEST(RouteCacheTest, DoesNotKeepRoutesAlive) {
+  RouteCache cache(2);
+  auto route = std::make_shared<NiceMock<MockRoute>>();
+  std::weak_ptr<MockRoute> weak_route = route;
+  RouteConstSharedPtr found;
+
+  EXPECT_FALSE(cache.find(genHeaders("/a"), found));
+  EXPECT_FALSE(cache.insert(route));
+  route.reset();
+  EXPECT_TRUE(weak_route.expired());
+
+  // A destroyed route is a miss, and its entry is replaced.
+  EXPECT_FALSE(cache.find(genHeaders("/a"), found));
+  auto other_route = std::make_shared<NiceMock<MockRoute>>();
+  EXPECT_FALSE(cache.insert(other_route));
+  EXPECT_EQ(1, cache.size());
+  EXPECT_TRUE(cache.find(genHeaders("/a"), found));
+  EXPECT_EQ(other_route, found);
+}
+
+TEST(WorkerRouteCachesTest, EachRouteTableHasItsOwnCache) {
+  NiceMock<Stats::MockStore> store;
+  WorkerRouteCaches caches_a(1, store, "a.");
+  WorkerRouteCaches caches_b(1, store, "b.");
+  RouteConstSharedPtr route;
+
+  EXPECT_EQ(&caches_a.local(), &caches_a.local());
+  caches_a.local().find(genHeaders("/a"), route);
+  caches_a.local().insert(nullptr);
+  EXPECT_EQ(1, caches_a.local().size());
+  EXPECT_EQ(0, caches_b.local().size());
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
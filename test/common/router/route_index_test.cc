@@ -0,0 +1,121 @@
+#include <string>
+#include <vector>
+
+#include "envoy/config/route/v3/route_components.pb.h"
+
+#include "source/common/common/fmt.h"
+#include "source/common/router/route_index.h"
+
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+class RouteIndexTest : public testing::Test {
+public:
+  void addRoute(const std::string& yaml) {
+    envoy::config::route::v3::RouteMatch match;
+    TestUtility::loadFromYaml(yaml, match);
+    index_.addRoute(match);
+  }
+
+  std::vector<uint32_t> candidates(absl::string_view path) {
+    RouteIndex::Candidates candidates;
+    index_.candidates(path, candidates);
+    return {candidates.begin(), candidates.end()};
+  }
+
+  RouteIndex index_;
+};
+
+TEST_F(RouteIndexTest, PrefixesAndPathsInConfigurationOrder) {
+  addRoute("prefix: /foo/bar");
+  addRoute("path: /foo/bar/baz");
+  addRoute("prefix: /foo");
+  addRoute("prefix: /fob");
+  addRoute("path: /foo");
+  addRoute("prefix: /");
+  index_.finalize();
+
+  EXPECT_THAT(candidates("/foo/bar/baz"), ElementsAre(0, 1, 2, 5));
+  EXPECT_THAT(candidates("/foo/bar/baz?a=b"), ElementsAre(0, 1, 2, 5));
+  EXPECT_THAT(candidates("/foo"), ElementsAre(2, 4, 5));
+  EXPECT_THAT(candidates("/fob/foo"), ElementsAre(3, 5));
+  EXPECT_THAT(candidates("/fo"), ElementsAre(5));
+  EXPECT_THAT(candidates("foo"), IsEmpty());
+}
+
+TEST_F(RouteIndexTest, CaseInsensitiveRoutes) {
+  addRoute(R"EOF(
+prefix: /Foo
+case_sensitive: false
+)EOF");
+  addRoute(R"EOF(
+path: /FOO/bar
+case_sensitive: false
+)EOF");
+  addRoute("prefix: /Foo");
+  index_.finalize();
+
+  EXPECT_THAT(candidates("/foo/bar"), ElementsAre(0, 1));
+  EXPECT_THAT(candidates("/Foo/BAR"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(candidates("/bar"), IsEmpty());
+}
+
+TEST_F(RouteIndexTest, RegexRoutesMatchTheWholePath) {
+  addRoute(R"EOF(
+safe_regex:
+  google_re2: {}
+  regex: /shelves/[^/]+/books
+)EOF");
+  addRoute("prefix: /shelves");
+  addRoute(R"EOF(
+safe_regex:
+  google_re2: {}
+  regex: /shelves/.*
+)EOF");
+  index_.finalize();
+
+  EXPECT_THAT(candidates("/shelves/1/books"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(candidates("/shelves/1/books/2?a=b"), ElementsAre(1, 2));
+  EXPECT_THAT(candidates("/x/shelves/1/books"), IsEmpty());
+}
+
+// The regexes of thousands of routes are still evaluated in one pass, yielding only the routes
+// whose regex matches rather than all of them.
+TEST_F(RouteIndexTest, ThousandsOfRegexRoutes) {
+  for (int i = 0; i < 2000; ++i) {
+    addRoute(fmt::format(R"EOF(
+safe_regex:
+  google_re2: {{}}
+  regex: /shelves/[^/]+/route_{}
+)EOF",
+                         i));
+  }
+  addRoute("prefix: /shelves");
+  index_.finalize();
+
+  EXPECT_THAT(candidates("/shelves/1/route_1999"), ElementsAre(1999, 2000));
+  EXPECT_THAT(candidates("/shelves/1/route_12"), ElementsAre(12, 2000));
+  EXPECT_THAT(candidates("/shelves/1/route_2000"), ElementsAre(2000));
+}
+
+TEST_F(RouteIndexTest, UnindexedRoutesAreAlwaysCandidates) {
+  addRoute("prefix: /foo");
+  addRoute("connect_matcher: {}");
+  index_.finalize();
+
+  EXPECT_THAT(candidates("/foo"), ElementsAre(0, 1));
+  EXPECT_THAT(candidates("/bar"), ElementsAre(1));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
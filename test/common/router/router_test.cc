@@ -37,6 +37,7 @@
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/router/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/server/overload_manager.h"
 #include "test/mocks/ssl/mocks.h"
 #include "test/mocks/tracing/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
@@ -2617,6 +2618,74 @@ TEST_F(RouterTest, RetryRequestDuringBody) {
   EXPECT_TRUE(verifyHostUpstreamStats(1, 1));
 }
 
+#ifndef WIN32
+// Test retrying a request whose body buffered for the retry was spilled to disk.
+TEST_F(RouterTest, RetryRequestWithSpilledBody) {
+  envoy::config::core::v3::BufferSpillConfig spill_config;
+  spill_config.set_directory(TestEnvironment::temporaryDirectory());
+  spill_config.mutable_memory_threshold_bytes()->set_value(3);
+  spill_config.mutable_segment_size_bytes()->set_value(4096);
+  config_.request_body_spill_ = Buffer::DiskSpill::create(spill_config, stats_store_, "spill.");
+
+  Buffer::OwnedImpl decoding_buffer;
+  EXPECT_CALL(callbacks_, decodingBuffer()).WillRepeatedly(Return(&decoding_buffer));
+  EXPECT_CALL(callbacks_, addDecodedData(_, true))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data, bool) { decoding_buffer.move(data); }));
+
+  NiceMock<Http::MockRequestEncoder> encoder1;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  EXPECT_CALL(cm_.thread_local_cluster_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::ResponseDecoder& decoder,
+              Http::ConnectionPool::Callbacks& callbacks) -> Http::ConnectionPool::Cancellable* {
+            response_decoder = &decoder;
+            callbacks.onPoolReady(encoder1, cm_.thread_local_cluster_.conn_pool_.host_,
+                                  upstream_stream_info_, Http::Protocol::Http10);
+            return nullptr;
+          }));
+  expectResponseTimerCreate();
+
+  Http::TestRequestHeaderMapImpl headers{{"x-envoy-retry-on", "5xx"}, {"x-envoy-internal", "true"}};
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, false);
+  const std::string body("body1");
+  Buffer::OwnedImpl buf(body);
+  EXPECT_CALL(encoder1, encodeData(BufferStringEqual(body), false));
+  EXPECT_CALL(*router_.retry_state_, enabled()).WillOnce(Return(true));
+  router_.decodeData(buf, false);
+  EXPECT_EQ(body, decoding_buffer.toString());
+  EXPECT_EQ(5, TestUtility::findCounter(stats_store_, "spill.spilled_bytes")->value());
+  EXPECT_EQ(4096, TestUtility::findGauge(stats_store_, "spill.disk_bytes")->value());
+
+  router_.retry_state_->expectResetRetry();
+  encoder1.stream_.resetStream(Http::StreamResetReason::RemoteReset);
+
+  NiceMock<Http::MockRequestEncoder> encoder2;
+  EXPECT_CALL(cm_.thread_local_cluster_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::ResponseDecoder& decoder,
+              Http::ConnectionPool::Callbacks& callbacks) -> Http::ConnectionPool::Cancellable* {
+            response_decoder = &decoder;
+            callbacks.onPoolReady(encoder2, cm_.thread_local_cluster_.conn_pool_.host_,
+                                  upstream_stream_info_, Http::Protocol::Http10);
+            return nullptr;
+          }));
+  EXPECT_CALL(encoder2, encodeData(BufferStringEqual(body), false));
+  router_.retry_state_->callback_();
+
+  // Complete request and send a successful response.
+  EXPECT_CALL(encoder2, encodeData(BufferStringEqual("body2"), true));
+  Buffer::OwnedImpl buf2("body2");
+  EXPECT_CALL(*router_.retry_state_, enabled()).WillOnce(Return(true));
+  router_.decodeData(buf2, true);
+  Http::ResponseHeaderMapPtr response_headers(
+      new Http::TestResponseHeaderMapImpl({{":status", "200"}}));
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, _));
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+  EXPECT_EQ(10, TestUtility::findCounter(stats_store_, "spill.spilled_bytes")->value());
+}
+#endif
+
 // Test retrying a request, when the first attempt fails while the client
 // is sending the body, with more data arriving in between upstream attempts
 // (which would normally happen during the backoff timer interval), but not end_stream.
@@ -4589,6 +4658,100 @@ TEST_F(RouterTest, Shadow) {
   EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
 }
 
+// Shadowing is skipped when shed under overload.
+TEST_F(RouterTest, ShadowShedUnderOverload) {
+  NiceMock<Server::MockOverloadManager> overload_manager;
+  const Server::OverloadActionState saturated = Server::OverloadActionState::saturated();
+  ON_CALL(overload_manager.overload_state_,
+          getState(Server::LoadShedPointNames::get().RouterShadowing))
+      .WillByDefault(ReturnRef(saturated));
+  config_.overload_manager_ = &overload_manager;
+
+  callbacks_.route_->route_entry_.shadow_policies_.push_back(
+      std::make_unique<TestShadowPolicy>("foo", "bar"));
+
+  NiceMock<Http::MockRequestEncoder> encoder;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  EXPECT_CALL(cm_.thread_local_cluster_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::ResponseDecoder& decoder,
+              Http::ConnectionPool::Callbacks& callbacks) -> Http::ConnectionPool::Cancellable* {
+            response_decoder = &decoder;
+            callbacks.onPoolReady(encoder, cm_.thread_local_cluster_.conn_pool_.host_,
+                                  upstream_stream_info_, Http::Protocol::Http10);
+            return nullptr;
+          }));
+  expectResponseTimerCreate();
+
+  EXPECT_CALL(runtime_.snapshot_, featureEnabled("bar", _, _, _)).Times(0);
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, false);
+
+  // The body is not buffered for the shadow.
+  Buffer::OwnedImpl body_data("hello");
+  EXPECT_CALL(callbacks_, addDecodedData(_, _)).Times(0);
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, router_.decodeData(body_data, true));
+  EXPECT_CALL(*shadow_writer_, shadow_(_, _, _)).Times(0);
+
+  Http::ResponseHeaderMapPtr response_headers(
+      new Http::TestResponseHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+  config_.overload_manager_ = nullptr;
+}
+
+TEST_F(RouterTest, StreamedShadow) {
+  auto policy = std::make_unique<TestShadowPolicy>("foo", "bar");
+  policy->stream_body_ = true;
+  callbacks_.route_->route_entry_.shadow_policies_.push_back(std::move(policy));
+  ON_CALL(callbacks_, streamId()).WillByDefault(Return(43));
+
+  NiceMock<Http::MockRequestEncoder> encoder;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  EXPECT_CALL(cm_.thread_local_cluster_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::ResponseDecoder& decoder,
+              Http::ConnectionPool::Callbacks& callbacks) -> Http::ConnectionPool::Cancellable* {
+            response_decoder = &decoder;
+            callbacks.onPoolReady(encoder, cm_.thread_local_cluster_.conn_pool_.host_,
+                                  upstream_stream_info_, Http::Protocol::Http10);
+            return nullptr;
+          }));
+  expectResponseTimerCreate();
+
+  EXPECT_CALL(runtime_.snapshot_, featureEnabled("bar", 0, 43, 10000)).WillOnce(Return(true));
+  auto shadow_stream = std::make_unique<MockShadowStream>();
+  MockShadowStream* shadow_stream_ptr = shadow_stream.get();
+  EXPECT_CALL(*shadow_writer_, streamingShadow_("foo", _, false, _))
+      .WillOnce(Invoke([&](const std::string&, Http::RequestHeaderMapPtr& headers, bool,
+                           const Http::AsyncClient::StreamOptions& options) -> ShadowStreamPtr {
+        EXPECT_NE(nullptr, headers->Host());
+        EXPECT_EQ(absl::optional<std::chrono::milliseconds>(10), options.timeout);
+        return std::move(shadow_stream);
+      }));
+
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, false);
+
+  // The body is teed to the shadow, not buffered.
+  Buffer::OwnedImpl body_data("hello");
+  EXPECT_CALL(*shadow_stream_ptr, sendData(BufferStringEqual("hello"), false));
+  EXPECT_CALL(callbacks_, addDecodedData(_, _)).Times(0);
+  EXPECT_CALL(encoder, encodeData(BufferStringEqual("hello"), false));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, router_.decodeData(body_data, false));
+
+  Http::TestRequestTrailerMapImpl trailers{{"some", "trailer"}};
+  EXPECT_CALL(*shadow_stream_ptr, sendTrailers(_));
+  EXPECT_CALL(*shadow_writer_, shadow_(_, _, _)).Times(0);
+  router_.decodeTrailers(trailers);
+
+  Http::ResponseHeaderMapPtr response_headers(
+      new Http::TestResponseHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+  EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
+}
+
 TEST_F(RouterTest, AltStatName) {
   // Also test no upstream timeout here.
   EXPECT_CALL(callbacks_.route_->route_entry_, timeout())
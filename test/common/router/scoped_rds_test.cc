@@ -116,7 +116,8 @@ protected:
 
 class ScopedRdsTest : public ScopedRoutesTestBase {
 protected:
-  void setup(const OptionalHttpFilters optional_http_filters = OptionalHttpFilters()) {
+  void setup(const OptionalHttpFilters optional_http_filters = OptionalHttpFilters(),
+             uint32_t max_loaded_on_demand_scopes = 0) {
     ON_CALL(server_factory_context_.cluster_manager_, adsMux())
         .WillByDefault(Return(std::make_shared<::Envoy::Config::NullGrpcMuxImpl>()));
 
@@ -180,6 +181,10 @@ scope_key_builder:
     envoy::extensions::filters::network::http_connection_manager::v3::ScopedRoutes
         scoped_routes_config;
     TestUtility::loadFromYaml(config_yaml, scoped_routes_config);
+    if (max_loaded_on_demand_scopes > 0) {
+      scoped_routes_config.mutable_scoped_rds()->mutable_max_loaded_on_demand_scopes()->set_value(
+          max_loaded_on_demand_scopes);
+    }
     provider_ = config_provider_manager_->createXdsConfigProvider(
         scoped_routes_config.scoped_rds(), server_factory_context_, context_init_manager_, "foo.",
         ScopedRoutesConfigProviderManagerOptArg(
@@ -251,6 +256,13 @@ scope_key_builder:
       "foo.scoped_rds.foo_scoped_routes.active_scopes", Stats::Gauge::ImportMode::Accumulate)};
   Envoy::Stats::Gauge& on_demand_scopes_{server_factory_context_.scope_.gauge(
       "foo.scoped_rds.foo_scoped_routes.on_demand_scopes", Stats::Gauge::ImportMode::Accumulate)};
+  Envoy::Stats::Gauge& on_demand_scopes_loaded_{server_factory_context_.scope_.gauge(
+      "foo.scoped_rds.foo_scoped_routes.on_demand_scopes_loaded",
+      Stats::Gauge::ImportMode::Accumulate)};
+  Envoy::Stats::Counter& on_demand_scopes_unloaded_{server_factory_context_.scope_.counter(
+      "foo.scoped_rds.foo_scoped_routes.on_demand_scopes_unloaded")};
+  Envoy::Stats::Counter& on_demand_scopes_reloaded_{server_factory_context_.scope_.counter(
+      "foo.scoped_rds.foo_scoped_routes.on_demand_scopes_reloaded")};
 };
 
 // Test an exception will be throw when unknown factory in the per-virtualhost typed config.
@@ -1230,10 +1242,20 @@ key:
                 ->getRouteConfig(TestRequestHeaderMapImpl{{"Addr", "x-foo-key;x-bar-key"}})
                 ->name(),
             "foo_routes");
+  // Both scopes share the route configuration built by the RDS subscription.
+  EXPECT_EQ(getScopedRdsProvider()
+                ->config<ScopedConfigImpl>()
+                ->getRouteConfig(TestRequestHeaderMapImpl{{"Addr", "x-foo-key;x-foo-key"}})
+                .get(),
+            getScopedRdsProvider()
+                ->config<ScopedConfigImpl>()
+                ->getRouteConfig(TestRequestHeaderMapImpl{{"Addr", "x-foo-key;x-bar-key"}})
+                .get());
   // Now we have 1 active on demand scope and 1 eager loading scope.
   EXPECT_EQ(2UL, all_scopes_.value());
   EXPECT_EQ(2UL, active_scopes_.value());
   EXPECT_EQ(1UL, on_demand_scopes_.value());
+  EXPECT_EQ(1UL, on_demand_scopes_loaded_.value());
 }
 
 TEST_F(ScopedRdsTest, PushRdsBeforeOndemandRequest) {
@@ -1442,6 +1464,78 @@ key:
   EXPECT_EQ(1UL, on_demand_scopes_.value());
 }
 
+// Tests that the on demand scopes used the least recently are unloaded beyond
+// max_loaded_on_demand_scopes, and loaded again on demand.
+TEST_F(ScopedRdsTest, UnloadOnDemandScopes) {
+  setup(OptionalHttpFilters(), 1);
+  init_watcher_.expectReady();
+  context_init_manager_.initialize(init_watcher_);
+  const std::string lazy_resource1 = R"EOF(
+name: foo_scope1
+route_configuration_name: foo_routes1
+on_demand: true
+key:
+  fragments:
+    - string_key: x-foo-key
+)EOF";
+  const std::string lazy_resource2 = R"EOF(
+name: foo_scope2
+route_configuration_name: foo_routes2
+on_demand: true
+key:
+  fragments:
+    - string_key: x-bar-key
+)EOF";
+  srdsUpdateWithYaml({lazy_resource1, lazy_resource2}, "1");
+  EXPECT_EQ(2UL, on_demand_scopes_.value());
+  EXPECT_EQ(0UL, on_demand_scopes_loaded_.value());
+
+  const TestRequestHeaderMapImpl headers1{{"Addr", "x-foo-key;x-foo-key"}};
+  const TestRequestHeaderMapImpl headers2{{"Addr", "x-foo-key;x-bar-key"}};
+  auto load_scope = [this](const TestRequestHeaderMapImpl& headers,
+                           const std::string& route_config_name, const std::string& version) {
+    ScopeKeyPtr scope_key =
+        getScopedRdsProvider()->config<ScopedConfigImpl>()->computeScopeKey(headers);
+    ASSERT_THAT(scope_key, Not(IsNull()));
+    bool scope_found = false;
+    getScopedRdsProvider()->onDemandRdsUpdate(
+        std::move(scope_key), event_dispatcher_,
+        [&scope_found](bool found) { scope_found = found; });
+    pushRdsConfig({route_config_name}, version);
+    EXPECT_TRUE(scope_found);
+  };
+
+  load_scope(headers1, "foo_routes1", "1");
+  EXPECT_EQ(getScopedRdsProvider()->config<ScopedConfigImpl>()->getRouteConfig(headers1)->name(),
+            "foo_routes1");
+  EXPECT_EQ(1UL, on_demand_scopes_loaded_.value());
+  EXPECT_EQ(1UL, active_scopes_.value());
+
+  // Loading the second scope unloads the first one, which the workers get back without a route
+  // configuration.
+  load_scope(headers2, "foo_routes2", "1");
+  EXPECT_EQ(getScopedRdsProvider()->config<ScopedConfigImpl>()->getRouteConfig(headers2)->name(),
+            "foo_routes2");
+  EXPECT_THAT(getScopedRdsProvider()->config<ScopedConfigImpl>()->getRouteConfig(headers1),
+              IsNull());
+  EXPECT_EQ(1UL, on_demand_scopes_loaded_.value());
+  EXPECT_EQ(1UL, active_scopes_.value());
+  EXPECT_EQ(1UL, on_demand_scopes_unloaded_.value());
+  EXPECT_EQ(0UL, on_demand_scopes_reloaded_.value());
+
+  // The first scope is loaded again on demand, unloading the second one.
+  load_scope(headers1, "foo_routes1", "2");
+  EXPECT_EQ(getScopedRdsProvider()->config<ScopedConfigImpl>()->getRouteConfig(headers1)->name(),
+            "foo_routes1");
+  EXPECT_THAT(getScopedRdsProvider()->config<ScopedConfigImpl>()->getRouteConfig(headers2),
+              IsNull());
+  EXPECT_EQ(1UL, on_demand_scopes_loaded_.value());
+  EXPECT_EQ(1UL, active_scopes_.value());
+  EXPECT_EQ(2UL, on_demand_scopes_unloaded_.value());
+  EXPECT_EQ(1UL, on_demand_scopes_reloaded_.value());
+  EXPECT_EQ(2UL, on_demand_scopes_.value());
+}
+
 TEST_F(ScopedRdsTest, DanglingSubscriptionOnDemandUpdate) {
   setup();
   std::function<void(bool)> route_config_updated_cb = [](bool) {};
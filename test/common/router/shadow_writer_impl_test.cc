@@ -1,11 +1,16 @@
 #include <chrono>
 #include <string>
 
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/header_map_impl.h"
 #include "source/common/http/headers.h"
 #include "source/common/http/message_impl.h"
 #include "source/common/router/shadow_writer_impl.h"
 
+#include "test/mocks/buffer/mocks.h"
+#include "test/mocks/http/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
+#include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -14,6 +19,7 @@ using testing::_;
 using testing::Eq;
 using testing::InSequence;
 using testing::Invoke;
+using testing::NiceMock;
 using testing::Return;
 
 namespace Envoy {
@@ -73,6 +79,118 @@ TEST_F(ShadowWriterImplTest, NoCluster) {
   writer_.shadow("foo", std::move(message), options);
 }
 
+class StreamingShadowWriterImplTest : public testing::Test {
+public:
+  StreamingShadowWriterImplTest() { cm_.initializeThreadLocalClusters({"foo"}); }
+
+  // Starts a streamed shadow which is not complete with its headers.
+  ShadowStreamPtr startStreamingShadow() {
+    auto headers = Http::createHeaderMap<Http::RequestHeaderMapImpl>(
+        {{Http::Headers::get().Host, "cluster1"}});
+    auto options = Http::AsyncClient::StreamOptions().setTimeout(std::chrono::milliseconds(5));
+    EXPECT_CALL(cm_.thread_local_cluster_.async_client_, start(_, _))
+        .WillOnce(Invoke(
+            [&](Http::AsyncClient::StreamCallbacks& callbacks,
+                const Http::AsyncClient::StreamOptions&) -> Http::AsyncClient::Stream* {
+              callbacks_ = &callbacks;
+              return &stream_;
+            }));
+    EXPECT_CALL(stream_, sendHeaders(_, false))
+        .WillOnce(Invoke([](Http::RequestHeaderMap& headers, bool) -> void {
+          EXPECT_EQ("cluster1-shadow", headers.getHostValue());
+        }));
+    return writer_.streamingShadow("foo", std::move(headers), false, options);
+  }
+
+  uint64_t droppedShadows() {
+    return cm_.thread_local_cluster_.cluster_.info_->stats().upstream_rq_shadow_dropped_.value();
+  }
+
+  NiceMock<Upstream::MockClusterManager> cm_;
+  ShadowWriterImpl writer_{cm_};
+  NiceMock<Http::MockAsyncClientStream> stream_;
+  Http::AsyncClient::StreamCallbacks* callbacks_{};
+};
+
+TEST_F(StreamingShadowWriterImplTest, StreamsTheRequest) {
+  ShadowStreamPtr shadow_stream = startStreamingShadow();
+  ASSERT_NE(nullptr, shadow_stream);
+
+  Buffer::OwnedImpl data("hello");
+  EXPECT_CALL(stream_, sendData(BufferStringEqual("hello"), false));
+  shadow_stream->sendData(data, false);
+  // The data of the request is left for the primary upstream.
+  EXPECT_EQ("hello", data.toString());
+
+  Http::TestRequestTrailerMapImpl trailers{{"some", "trailer"}};
+  EXPECT_CALL(stream_, sendTrailers(_));
+  shadow_stream->sendTrailers(trailers);
+
+  // The shadow goes on once the request is gone.
+  EXPECT_CALL(stream_, reset()).Times(0);
+  shadow_stream.reset();
+  callbacks_->onComplete();
+  EXPECT_EQ(0, droppedShadows());
+}
+
+TEST_F(StreamingShadowWriterImplTest, DropsShadowWhichFellBehind) {
+  ShadowStreamPtr shadow_stream = startStreamingShadow();
+  ASSERT_NE(nullptr, shadow_stream);
+
+  EXPECT_CALL(stream_, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  EXPECT_CALL(stream_, sendData(_, _)).Times(0);
+  EXPECT_CALL(stream_, reset()).WillOnce(Invoke([&]() -> void { callbacks_->onReset(); }));
+  Buffer::OwnedImpl data("hello");
+  shadow_stream->sendData(data, false);
+  EXPECT_EQ(1, droppedShadows());
+
+  // Nothing more is sent once the shadow is dropped.
+  shadow_stream->sendData(data, true);
+  shadow_stream.reset();
+  EXPECT_EQ(1, droppedShadows());
+}
+
+TEST_F(StreamingShadowWriterImplTest, ResetsShadowOfIncompleteRequest) {
+  ShadowStreamPtr shadow_stream = startStreamingShadow();
+  ASSERT_NE(nullptr, shadow_stream);
+
+  EXPECT_CALL(stream_, reset()).WillOnce(Invoke([&]() -> void { callbacks_->onReset(); }));
+  shadow_stream.reset();
+  EXPECT_EQ(0, droppedShadows());
+}
+
+TEST_F(StreamingShadowWriterImplTest, EndsWithHeaders) {
+  auto headers = Http::createHeaderMap<Http::RequestHeaderMapImpl>(
+      {{Http::Headers::get().Host, "cluster1:8000"}});
+  EXPECT_CALL(cm_.thread_local_cluster_.async_client_, start(_, _))
+      .WillOnce(Invoke([&](Http::AsyncClient::StreamCallbacks& callbacks,
+                           const Http::AsyncClient::StreamOptions&) -> Http::AsyncClient::Stream* {
+        callbacks_ = &callbacks;
+        return &stream_;
+      }));
+  EXPECT_CALL(stream_, sendHeaders(_, true))
+      .WillOnce(Invoke([](Http::RequestHeaderMap& headers, bool) -> void {
+        EXPECT_EQ("cluster1-shadow:8000", headers.getHostValue());
+      }));
+  EXPECT_EQ(nullptr, writer_.streamingShadow("foo", std::move(headers), true,
+                                             Http::AsyncClient::StreamOptions()));
+
+  // The shadow goes on without a handle until its response is complete.
+  EXPECT_CALL(stream_, reset()).Times(0);
+  callbacks_->onHeaders(std::make_unique<Http::TestResponseHeaderMapImpl>(), true);
+  callbacks_->onComplete();
+}
+
+TEST_F(StreamingShadowWriterImplTest, NoCluster) {
+  EXPECT_CALL(cm_, getThreadLocalCluster(Eq("bar"))).WillOnce(Return(nullptr));
+  EXPECT_CALL(cm_.thread_local_cluster_.async_client_, start(_, _)).Times(0);
+  EXPECT_EQ(nullptr,
+            writer_.streamingShadow("bar",
+                                    Http::createHeaderMap<Http::RequestHeaderMapImpl>(
+                                        {{Http::Headers::get().Host, "cluster1"}}),
+                                    false, Http::AsyncClient::StreamOptions()));
+}
+
 } // namespace
 } // namespace Router
 } // namespace Envoy
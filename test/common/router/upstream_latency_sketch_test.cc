@@ -0,0 +1,98 @@
+#include <chrono>
+#include <limits>
+
+#include "source/common/router/upstream_latency_sketch.h"
+
+#include "test/mocks/upstream/cluster_info.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+using testing::NiceMock;
+
+TEST(UpstreamLatencySketchTest, BucketsCoverTheirLowerBounds) {
+  for (uint32_t bucket = 0; bucket < UpstreamLatencySketch::NumBuckets; bucket++) {
+    EXPECT_EQ(bucket,
+              UpstreamLatencySketch::bucket(UpstreamLatencySketch::bucketLowerBound(bucket)));
+  }
+  EXPECT_EQ(15, UpstreamLatencySketch::bucket(15));
+  EXPECT_EQ(16, UpstreamLatencySketch::bucket(16));
+  EXPECT_EQ(31, UpstreamLatencySketch::bucket(31));
+  EXPECT_EQ(32, UpstreamLatencySketch::bucket(32));
+  EXPECT_EQ(32, UpstreamLatencySketch::bucket(33));
+  EXPECT_EQ(UpstreamLatencySketch::NumBuckets - 1,
+            UpstreamLatencySketch::bucket(std::numeric_limits<uint64_t>::max()));
+}
+
+TEST(UpstreamLatencySketchTest, Percentile) {
+  UpstreamLatencySketch sketch;
+  for (uint32_t i = 1; i <= 100; i++) {
+    EXPECT_EQ(absl::nullopt, sketch.percentile(95, 100));
+    sketch.recordLatency(std::chrono::milliseconds(i));
+  }
+
+  // The percentile is rounded up to the upper bound of its bucket.
+  const absl::optional<std::chrono::milliseconds> p95 = sketch.percentile(95, 100);
+  ASSERT_TRUE(p95.has_value());
+  EXPECT_GE(p95.value().count(), 95);
+  EXPECT_LE(p95.value().count(), 101);
+  const absl::optional<std::chrono::milliseconds> p50 = sketch.percentile(50, 100);
+  ASSERT_TRUE(p50.has_value());
+  EXPECT_GE(p50.value().count(), 50);
+  EXPECT_LE(p50.value().count(), 54);
+}
+
+TEST(UpstreamLatencySketchTest, PercentileFollowsRecentLatencies) {
+  UpstreamLatencySketch sketch;
+  for (uint32_t i = 0; i < 10000; i++) {
+    sketch.recordLatency(std::chrono::milliseconds(10));
+  }
+  EXPECT_LE(sketch.percentile(95, 100).value().count(), 11);
+
+  for (uint32_t i = 0; i < 10000; i++) {
+    sketch.recordLatency(std::chrono::milliseconds(100));
+  }
+  EXPECT_GE(sketch.percentile(95, 100).value().count(), 100);
+}
+
+TEST(UpstreamLatencySketchTest, HedgeBudget) {
+  UpstreamLatencySketch sketch;
+  EXPECT_FALSE(sketch.hedgeAllowed(10));
+  for (uint32_t i = 0; i < 20; i++) {
+    sketch.recordRequest();
+  }
+  EXPECT_TRUE(sketch.hedgeAllowed(10));
+  sketch.recordHedge();
+  EXPECT_TRUE(sketch.hedgeAllowed(10));
+  sketch.recordHedge();
+  EXPECT_FALSE(sketch.hedgeAllowed(10));
+
+  for (uint32_t i = 0; i < 10; i++) {
+    sketch.recordRequest();
+  }
+  EXPECT_TRUE(sketch.hedgeAllowed(10));
+}
+
+TEST(UpstreamLatencySketchTest, EachClusterHasItsOwnSketch) {
+  auto cluster_a = std::make_shared<NiceMock<Upstream::MockClusterInfo>>();
+  cluster_a->name_ = "a";
+  auto cluster_b = std::make_shared<NiceMock<Upstream::MockClusterInfo>>();
+  cluster_b->name_ = "b";
+
+  UpstreamLatencySketchSharedPtr sketch_a = UpstreamLatencySketch::forCluster(cluster_a);
+  EXPECT_EQ(sketch_a, UpstreamLatencySketch::forCluster(cluster_a));
+  EXPECT_NE(sketch_a, UpstreamLatencySketch::forCluster(cluster_b));
+
+  // An updated cluster starts with a new sketch.
+  auto updated_cluster_a = std::make_shared<NiceMock<Upstream::MockClusterInfo>>();
+  updated_cluster_a->name_ = "a";
+  EXPECT_NE(sketch_a, UpstreamLatencySketch::forCluster(updated_cluster_a));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
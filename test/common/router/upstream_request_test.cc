@@ -55,6 +55,24 @@ TEST_F(UpstreamRequestTest, Decode200UpgradeHeaders) {
   upstream_request_.decodeHeaders(std::move(response_headers), false);
 }
 
+// The downstream deadline follows the global timeout from the completion of the downstream request.
+TEST_F(UpstreamRequestTest, DownstreamDeadline) {
+  FilterUtility::TimeoutData timeout;
+  EXPECT_CALL(router_filter_interface_, timeout()).WillRepeatedly(Return(timeout));
+  EXPECT_EQ(absl::nullopt, upstream_request_.downstreamDeadline());
+
+  timeout.global_timeout_ = std::chrono::milliseconds(100);
+  EXPECT_CALL(router_filter_interface_, timeout()).WillRepeatedly(Return(timeout));
+  EXPECT_CALL(router_filter_interface_, downstreamEndStream()).WillRepeatedly(Return(false));
+  EXPECT_EQ(absl::nullopt, upstream_request_.downstreamDeadline());
+
+  const MonotonicTime complete_time = MonotonicTime(std::chrono::seconds(1));
+  EXPECT_CALL(router_filter_interface_, downstreamEndStream()).WillRepeatedly(Return(true));
+  EXPECT_CALL(router_filter_interface_, downstreamRequestCompleteTime())
+      .WillRepeatedly(Return(complete_time));
+  EXPECT_EQ(complete_time + std::chrono::milliseconds(100), upstream_request_.downstreamDeadline());
+}
+
 // UpstreamRequest dumpState without allocating memory.
 TEST_F(UpstreamRequestTest, DumpsStateWithoutAllocatingMemory) {
   // Set up router filter
@@ -75,12 +75,14 @@ vhds:
   RouteConfigUpdatePtr
   makeRouteConfigUpdate(const envoy::config::route::v3::RouteConfiguration& rc) {
     RouteConfigUpdatePtr config_update_info =
-        std::make_unique<RouteConfigUpdateReceiverImpl>(factory_context_, OptionalHttpFilters());
+        std::make_unique<RouteConfigUpdateReceiverImpl>(factory_context_, optional_http_filters_,
+                                                        factory_context_.scope_);
     config_update_info->onRdsUpdate(rc, "1");
     return config_update_info;
   }
 
   NiceMock<Server::Configuration::MockServerFactoryContext> factory_context_;
+  const OptionalHttpFilters optional_http_filters_;
   Init::ExpectableWatcherImpl init_watcher_;
   Init::TargetHandlePtr init_target_handle_;
   const std::string context_ = "vhds_test";
@@ -195,6 +197,9 @@ vhds:
   factory_context_.cluster_manager_.subscription_factory_.callbacks_->onConfigUpdate(
       decoded_resources.refvec_, removed_resources, "1");
   EXPECT_EQ(2UL, config_update_info->protobufConfiguration().virtual_hosts_size());
+  // The RDS virtual host is reused by the rebuilt route configuration.
+  EXPECT_EQ(2UL, factory_context_.scope_.counterFromString("virtual_hosts_built").value());
+  EXPECT_EQ(1UL, factory_context_.scope_.counterFromString("virtual_hosts_reused").value());
 
   config_update_info->onRdsUpdate(updated_route_config, "2");
 
@@ -0,0 +1,84 @@
+#include <chrono>
+
+#include "source/common/router/worker_retry_budget.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+class WorkerRetryBudgetTest : public testing::Test {
+public:
+  MonotonicTime now() { return time_system_.monotonicTime(); }
+
+  Event::SimulatedTimeSystem time_system_;
+};
+
+TEST_F(WorkerRetryBudgetTest, RequestsAddTokens) {
+  WorkerRetryBudget budget({20.0, 1}, now());
+  budget.onRequest(now());
+  EXPECT_TRUE(budget.canRetry());
+  budget.onRetry();
+  EXPECT_FALSE(budget.canRetry());
+
+  // Up to the capacity, which is min_retry_concurrency until the first reconciliation.
+  for (uint32_t i = 0; i < 5; i++) {
+    EXPECT_FALSE(budget.canRetry());
+    budget.onRequest(now());
+  }
+  EXPECT_TRUE(budget.canRetry());
+  for (uint32_t i = 0; i < 100; i++) {
+    budget.onRequest(now());
+  }
+  EXPECT_DOUBLE_EQ(1, budget.tokens());
+}
+
+TEST_F(WorkerRetryBudgetTest, ReconcilesWithTheRequestsOfTheLastInterval) {
+  WorkerRetryBudget budget({10.0, 2}, now());
+  for (uint32_t i = 0; i < 100; i++) {
+    budget.onRequest(now());
+  }
+  EXPECT_DOUBLE_EQ(2, budget.tokens());
+
+  // 100 requests in the last second hold up to 10 tokens.
+  time_system_.advanceTimeWait(WorkerRetryBudget::ReconcileInterval);
+  budget.onRequest(now());
+  EXPECT_EQ(now(), budget.lastReconciled());
+  for (uint32_t i = 0; i < 200; i++) {
+    budget.onRequest(now());
+  }
+  EXPECT_DOUBLE_EQ(10, budget.tokens());
+
+  // The bucket is refilled up to min_retry_concurrency.
+  for (uint32_t i = 0; i < 10; i++) {
+    budget.onRetry();
+  }
+  EXPECT_FALSE(budget.canRetry());
+  time_system_.advanceTimeWait(WorkerRetryBudget::ReconcileInterval);
+  budget.onRequest(now());
+  EXPECT_DOUBLE_EQ(2.1, budget.tokens());
+
+  // Without traffic for a while, the capacity falls back to min_retry_concurrency.
+  time_system_.advanceTimeWait(std::chrono::seconds(10));
+  budget.onRequest(now());
+  EXPECT_DOUBLE_EQ(2, budget.tokens());
+}
+
+TEST_F(WorkerRetryBudgetTest, EachClusterAndPriorityHasItsOwnBucket) {
+  const Upstream::WorkerRetryBudgetSettings settings{20.0, 3};
+  WorkerRetryBudgetSharedPtr budget = WorkerRetryBudget::forCluster(
+      "bucket_cluster", Upstream::ResourcePriority::Default, settings, now());
+  EXPECT_EQ(budget, WorkerRetryBudget::forCluster(
+                        "bucket_cluster", Upstream::ResourcePriority::Default, settings, now()));
+  EXPECT_NE(budget, WorkerRetryBudget::forCluster(
+                        "bucket_cluster", Upstream::ResourcePriority::High, settings, now()));
+  EXPECT_NE(budget, WorkerRetryBudget::forCluster(
+                        "other_cluster", Upstream::ResourcePriority::Default, settings, now()));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
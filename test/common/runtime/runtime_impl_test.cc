@@ -10,6 +10,7 @@
 #include "source/common/config/runtime_utility.h"
 #include "source/common/runtime/runtime_features.h"
 #include "source/common/runtime/runtime_impl.h"
+#include "source/common/runtime/runtime_key_registry.h"
 
 #include "test/common/stats/stat_test_utility.h"
 #include "test/mocks/common.h"
@@ -545,6 +546,59 @@ TEST_F(StaticLoaderImplTest, All) {
   testNewOverrides(*loader_, store_);
 }
 
+TEST_F(StaticLoaderImplTest, KeyHandles) {
+  base_ = TestUtility::parseYaml<ProtobufWkt::Struct>(R"EOF(
+    handle_integer: 2
+    handle_double: 2.5
+    handle_boolean: true
+    handle_percent: 0
+    handle_fractional:
+      numerator: 1
+      denominator: TEN_THOUSAND
+  )EOF");
+  setup();
+
+  // The keys may be registered after the snapshot they are looked up in is created.
+  const KeyHandle integer_key = KeyRegistry::registerKey("handle_integer");
+  EXPECT_EQ(integer_key.index(), KeyRegistry::registerKey("handle_integer").index());
+  const KeyHandle double_key = KeyRegistry::registerKey("handle_double");
+  EXPECT_NE(integer_key.index(), double_key.index());
+  const KeyHandle boolean_key = KeyRegistry::registerKey("handle_boolean");
+  const KeyHandle percent_key = KeyRegistry::registerKey("handle_percent");
+  const KeyHandle fractional_key = KeyRegistry::registerKey("handle_fractional");
+  const KeyHandle missing_key = KeyRegistry::registerKey("handle_missing");
+  const KeyHandle empty_key = KeyRegistry::registerKey("");
+  const KeyHandle unregistered_key("handle_integer", KeyHandle::Unregistered);
+
+  const Snapshot& snapshot = loader_->snapshot();
+  for (int i = 0; i < 2; i++) {
+    EXPECT_EQ(2, snapshot.getInteger(integer_key, 1));
+    EXPECT_EQ(2, snapshot.getInteger(unregistered_key, 1));
+    EXPECT_EQ(1, snapshot.getInteger(missing_key, 1));
+    EXPECT_EQ(1, snapshot.getInteger(empty_key, 1));
+    EXPECT_EQ(2.5, snapshot.getDouble(double_key, 1.5));
+    EXPECT_EQ(1.5, snapshot.getDouble(missing_key, 1.5));
+    EXPECT_TRUE(snapshot.getBoolean(boolean_key, false));
+    EXPECT_FALSE(snapshot.getBoolean(missing_key, false));
+    EXPECT_FALSE(snapshot.featureEnabled(percent_key, 100));
+    EXPECT_TRUE(snapshot.featureEnabled(missing_key, 100));
+    EXPECT_TRUE(snapshot.featureEnabled(integer_key, 50, 1));
+    EXPECT_FALSE(snapshot.featureEnabled(integer_key, 50, 2));
+
+    envoy::type::v3::FractionalPercent default_value;
+    default_value.set_numerator(50);
+    EXPECT_TRUE(snapshot.featureEnabled(fractional_key, default_value, 0));
+    EXPECT_FALSE(snapshot.featureEnabled(fractional_key, default_value, 1));
+    EXPECT_TRUE(snapshot.featureEnabled(missing_key, default_value, 49));
+    EXPECT_FALSE(snapshot.featureEnabled(missing_key, default_value, 50));
+  }
+
+  // The handles resolve the keys in each new snapshot.
+  loader_->mergeValues({{"handle_integer", "3"}, {"handle_missing", "4"}});
+  EXPECT_EQ(3, loader_->snapshot().getInteger(integer_key, 1));
+  EXPECT_EQ(4, loader_->snapshot().getInteger(missing_key, 1));
+}
+
 #ifdef ENVOY_ENABLE_QUIC
 TEST_F(StaticLoaderImplTest, QuicheReloadableFlags) {
   // Test that Quiche flags can be overwritten via Envoy runtime config.
@@ -2,6 +2,7 @@
 
 #include "source/common/event/timer_impl.h"
 #include "source/common/shared_pool/shared_pool.h"
+#include "source/common/stats/isolated_store_impl.h"
 
 #include "test/mocks/event/mocks.h"
 #include "test/test_common/thread_factory_for_test.h"
@@ -84,6 +85,33 @@ TEST_F(SharedPoolTest, Basic) {
   ASSERT_EQ(0, pool->poolSize());
 }
 
+TEST_F(SharedPoolTest, Stats) {
+  Event::MockDispatcher dispatcher;
+  Stats::IsolatedStoreImpl store;
+  auto pool = std::make_shared<ObjectSharedPool<int>>(
+      dispatcher, SharedPoolStats{ALL_SHARED_POOL_STATS(POOL_COUNTER_PREFIX(store, "pool."),
+                                                        POOL_GAUGE_PREFIX(store, "pool."))});
+  Stats::Counter& deduplicated = store.counterFromString("pool.deduplicated");
+  Stats::Gauge& objects =
+      store.gaugeFromString("pool.objects", Stats::Gauge::ImportMode::NeverImport);
+  {
+    auto o = pool->getObject(4);
+    EXPECT_EQ(0, deduplicated.value());
+    EXPECT_EQ(1, objects.value());
+
+    auto o1 = pool->getObject(4);
+    auto o2 = pool->getObject(4);
+    EXPECT_EQ(2, deduplicated.value());
+    EXPECT_EQ(1, objects.value());
+
+    auto o3 = pool->getObject(5);
+    EXPECT_EQ(2, deduplicated.value());
+    EXPECT_EQ(2, objects.value());
+  }
+
+  EXPECT_EQ(0, objects.value());
+}
+
 TEST_F(SharedPoolTest, NonThreadSafeForGetObjectDeathTest) {
   std::shared_ptr<ObjectSharedPool<int>> pool;
   createObjectSharedPool(pool);
@@ -52,6 +52,43 @@ TEST_F(AllocatorImplTest, CountersWithSameName) {
   EXPECT_EQ(2, c2->value());
 }
 
+// A sharded counter sums the increments made on every thread.
+TEST_F(AllocatorImplTest, ShardedCounter) {
+  StatName counter_name = makeStat("counter.name");
+  CounterSharedPtr counter = alloc_.makeShardedCounter(counter_name, StatName(), {});
+  EXPECT_FALSE(counter->used());
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+
+  const uint32_t num_threads = 32;
+  const uint32_t iters = 1000;
+  std::vector<Thread::ThreadPtr> threads;
+  absl::Notification go;
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads.push_back(thread_factory.createThread([&]() {
+      go.WaitForNotification();
+      for (uint32_t i = 0; i < iters; ++i) {
+        counter->inc();
+      }
+      counter->add(2);
+    }));
+  }
+  go.Notify();
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads[i]->join();
+  }
+
+  const uint64_t expected = num_threads * (iters + 2);
+  EXPECT_TRUE(counter->used());
+  EXPECT_EQ(expected, counter->value());
+  EXPECT_EQ(expected, counter->latch());
+  EXPECT_EQ(0, counter->latch());
+  counter->reset();
+  EXPECT_EQ(0, counter->value());
+
+  // Counters of the same name are shared, whether or not they were made sharded.
+  EXPECT_EQ(counter.get(), alloc_.makeCounter(counter_name, StatName(), {}).get());
+}
+
 TEST_F(AllocatorImplTest, GaugesWithSameName) {
   StatName gauge_name = makeStat("gauges.name");
   GaugeSharedPtr g1 = alloc_.makeGauge(gauge_name, StatName(), {}, Gauge::ImportMode::Accumulate);
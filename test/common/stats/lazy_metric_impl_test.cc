@@ -0,0 +1,75 @@
+#include <string>
+
+#include "source/common/stats/lazy_metric_impl.h"
+
+#include "test/common/stats/stat_test_utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+class LazyMetricImplTest : public testing::Test {
+protected:
+  LazyMetricImplTest() : pool_(store_.symbolTable()), prefix_(pool_.add("prefix")) {}
+
+  TestUtil::TestStore store_;
+  StatNamePool pool_;
+  const StatName prefix_;
+};
+
+TEST_F(LazyMetricImplTest, Counter) {
+  LazyCounterImpl counter(store_, prefix_, pool_.add("counter"));
+  EXPECT_EQ(0, counter.value());
+  EXPECT_EQ(0, counter.latch());
+  EXPECT_FALSE(counter.used());
+  counter.add(0);
+  counter.reset();
+  EXPECT_FALSE(store_.findCounterByString("prefix.counter").has_value());
+
+  counter.inc();
+  counter.add(2);
+  ASSERT_TRUE(store_.findCounterByString("prefix.counter").has_value());
+  EXPECT_EQ(&store_.findCounterByString("prefix.counter")->get(),
+            &store_.counterFromString("prefix.counter"));
+  EXPECT_EQ(3, counter.value());
+  EXPECT_TRUE(counter.used());
+  EXPECT_EQ(3, counter.latch());
+  EXPECT_EQ("prefix.counter", counter.name());
+}
+
+TEST_F(LazyMetricImplTest, Gauge) {
+  LazyGaugeImpl gauge(store_, prefix_, pool_.add("gauge"), Gauge::ImportMode::Accumulate);
+  EXPECT_EQ(0, gauge.value());
+  EXPECT_EQ(Gauge::ImportMode::Accumulate, gauge.importMode());
+  gauge.set(0);
+  gauge.add(0);
+  gauge.sub(0);
+  EXPECT_FALSE(store_.findGaugeByString("prefix.gauge").has_value());
+
+  gauge.set(5);
+  ASSERT_TRUE(store_.findGaugeByString("prefix.gauge").has_value());
+  EXPECT_EQ(5, store_.findGaugeByString("prefix.gauge")->get().value());
+  gauge.dec();
+  gauge.set(0);
+  EXPECT_EQ(0, store_.findGaugeByString("prefix.gauge")->get().value());
+  EXPECT_EQ(Gauge::ImportMode::Accumulate, gauge.importMode());
+}
+
+TEST_F(LazyMetricImplTest, Histogram) {
+  LazyHistogramImpl histogram(store_, prefix_, pool_.add("histogram"),
+                              Histogram::Unit::Milliseconds);
+  EXPECT_EQ(Histogram::Unit::Milliseconds, histogram.unit());
+  EXPECT_FALSE(histogram.used());
+  EXPECT_FALSE(store_.findHistogramByString("prefix.histogram").has_value());
+
+  histogram.recordValue(1);
+  ASSERT_TRUE(store_.findHistogramByString("prefix.histogram").has_value());
+  EXPECT_EQ(Histogram::Unit::Milliseconds,
+            store_.findHistogramByString("prefix.histogram")->get().unit());
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
@@ -391,6 +391,51 @@ TEST_F(StatMergerThreadLocalTest, RetainNeverImportModeAfterMerge) {
   EXPECT_EQ(42, gauge.value());
 }
 
+// Stats whose names are encoded with the symbols of the parent are merged like the others, and
+// keep the dynamic segments of their names.
+TEST_F(StatMergerThreadLocalTest, EncodedStatsFromParent) {
+  SymbolTableImpl parent_symbol_table;
+  StatNamePool parent_pool(parent_symbol_table);
+  StatNameDynamicPool parent_dynamic_pool(parent_symbol_table);
+  const StatName counter_name = parent_pool.add("parent.counter");
+  SymbolTable::StoragePtr parent_joined = parent_symbol_table.join(
+      {parent_pool.add("parent"), parent_dynamic_pool.add("dynamic.gauge")});
+  const StatName gauge_name(parent_joined.get());
+  const auto encode = [](StatName stat_name) {
+    return std::string(reinterpret_cast<const char*>(stat_name.data()), stat_name.dataSize());
+  };
+
+  StatNamePool pool(symbol_table_);
+  StatNameDynamicPool dynamic_pool(symbol_table_);
+  SymbolTable::StoragePtr joined =
+      symbol_table_.join({pool.add("parent"), dynamic_pool.add("dynamic.gauge")});
+  {
+    StatMerger stat_merger(store_);
+    parent_symbol_table.iterateSymbols([&stat_merger](uint32_t symbol, absl::string_view token) {
+      stat_merger.setParentSymbol(symbol, token);
+    });
+    stat_merger.mergeEncodedCounter(encode(counter_name), 2);
+    stat_merger.mergeEncodedCounter(encode(counter_name), 3);
+    stat_merger.mergeEncodedGauge(encode(gauge_name), 42);
+    EXPECT_EQ(5, store_.counterFromString("parent.counter").value());
+    GaugeOptConstRef gauge = store_.findGauge(StatName(joined.get()));
+    ASSERT_TRUE(gauge);
+    EXPECT_EQ(42, gauge->get().value());
+    stat_merger.mergeEncodedGauge(encode(gauge_name), 7);
+    EXPECT_EQ(7, gauge->get().value());
+
+    // The stats encoded with a symbol the parent reuses for another token are renamed.
+    parent_symbol_table.iterateSymbols([&stat_merger](uint32_t symbol, absl::string_view token) {
+      if (token == "counter") {
+        stat_merger.setParentSymbol(symbol, "renamed");
+      }
+    });
+    stat_merger.mergeEncodedCounter(encode(counter_name), 1);
+    EXPECT_EQ(1, store_.counterFromString("parent.renamed").value());
+    EXPECT_EQ(5, store_.counterFromString("parent.counter").value());
+  }
+}
+
 } // namespace
 } // namespace Stats
 } // namespace Envoy
@@ -9,6 +9,7 @@
 #include "test/test_common/logging.h"
 #include "test/test_common/utility.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/hash/hash_testing.h"
 #include "absl/strings/str_join.h"
 #include "absl/synchronization/blocking_counter.h"
@@ -682,6 +683,143 @@ TEST_F(StatNameTest, RecentLookups) {
   EXPECT_EQ(0, num_calls);
 }
 
+TEST_F(StatNameTest, IterateSymbols) {
+  StatName stat_name = makeStat("a.b");
+  StatNameDynamicPool dynamic(table_);
+  dynamic.add("dynamic");
+
+  absl::flat_hash_map<Symbol, std::string> symbols;
+  table_.iterateSymbols(
+      [&symbols](Symbol symbol, absl::string_view token) { symbols[symbol] = std::string(token); });
+
+  // Dynamic tokens are stored inline, and so are not in the table.
+  ASSERT_EQ(2, symbols.size());
+  std::vector<std::string> tokens;
+  SymbolTableImpl::Encoding::decodeTokens(
+      stat_name.data(), stat_name.dataSize(),
+      [&symbols, &tokens](Symbol symbol) { tokens.push_back(symbols[symbol]); },
+      [](absl::string_view) {});
+  EXPECT_EQ("a.b", absl::StrJoin(tokens, "."));
+}
+
+TEST_F(StatNameTest, ThreadCache) {
+  table_.setThreadCacheCapacity(SymbolTableImpl::DefaultThreadCacheCapacity);
+  StatName first = makeStat("a.b.c");
+  StatName second = makeStat("a.b.c");
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(getSymbols(first), getSymbols(second));
+  EXPECT_EQ("a.b.c", table_.toString(second));
+  EXPECT_EQ(3, table_.numSymbols());
+}
+
+// A symbol freed and reused for another token must not be handed out through
+// the stale cache entry for the token it was freed from.
+TEST_F(StatNameTest, ThreadCacheStaleEntry) {
+  table_.setThreadCacheCapacity(SymbolTableImpl::DefaultThreadCacheCapacity);
+  {
+    StatNameManagedStorage a("a", table_);
+    EXPECT_EQ(1, table_.numSymbols());
+  }
+  EXPECT_EQ(0, table_.numSymbols());
+
+  StatName b = makeStat("b");
+  StatName a = makeStat("a");
+  EXPECT_EQ("b", table_.toString(b));
+  EXPECT_EQ("a", table_.toString(a));
+  EXPECT_NE(getSymbols(a), getSymbols(b));
+  EXPECT_EQ(2, table_.numSymbols());
+}
+
+TEST_F(StatNameTest, ThreadCacheFull) {
+  table_.setThreadCacheCapacity(2);
+  std::vector<StatName> stat_names;
+  for (int i = 0; i < 10; ++i) {
+    stat_names.push_back(makeStat(absl::StrCat("x.y", i)));
+    stat_names.push_back(makeStat(absl::StrCat("x.y", i)));
+  }
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(absl::StrCat("x.y", i), table_.toString(stat_names[2 * i]));
+    EXPECT_EQ(stat_names[2 * i], stat_names[2 * i + 1]);
+  }
+  EXPECT_EQ(11, table_.numSymbols());
+}
+
+TEST_F(StatNameTest, ThreadCacheOtherTable) {
+  table_.setThreadCacheCapacity(SymbolTableImpl::DefaultThreadCacheCapacity);
+  SymbolTableImpl other;
+  other.setThreadCacheCapacity(SymbolTableImpl::DefaultThreadCacheCapacity);
+  StatNamePool other_pool(other);
+
+  // Each encode switches the thread's cache to the other table.
+  StatName a = makeStat("a.b");
+  StatName other_a = other_pool.add("b.a");
+  StatName b = makeStat("a.b");
+  EXPECT_EQ(a, b);
+  EXPECT_EQ("b.a", other.toString(other_a));
+  other_pool.clear();
+  EXPECT_EQ(0, other.numSymbols());
+}
+
+TEST_F(StatNameTest, ThreadCacheRecentLookups) {
+  table_.setThreadCacheCapacity(SymbolTableImpl::DefaultThreadCacheCapacity);
+  encodeDecode("direct.stat");
+  table_.setRecentLookupCapacity(10);
+  encodeDecode("direct.stat");
+
+  // The cache is bypassed so that the second lookup is recorded.
+  std::vector<std::string> accum;
+  EXPECT_EQ(1, table_.getRecentLookups([&accum](absl::string_view name, uint64_t count) {
+    accum.emplace_back(absl::StrCat(count, ": ", name));
+  }));
+  EXPECT_EQ("1: direct.stat", absl::StrJoin(accum, " "));
+}
+
+// With the thread cache, encoding names whose tokens each thread has already
+// encoded takes no lock, so there are no contentions at all.
+TEST_F(StatNameTest, ThreadCacheNoContentionOnExistingSymbols) {
+  table_.setThreadCacheCapacity(SymbolTableImpl::DefaultThreadCacheCapacity);
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+  MutexTracerImpl& mutex_tracer = MutexTracerImpl::getOrCreateTracer();
+
+  constexpr int num_threads = 32;
+  std::vector<Thread::ThreadPtr> threads;
+  threads.reserve(num_threads);
+  ConditionalInitializer creation, access, wait;
+  absl::BlockingCounter creates(num_threads), accesses(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(
+        thread_factory.createThread([this, i, &creation, &access, &wait, &creates, &accesses]() {
+          const std::string stat_name_string = absl::StrCat("cluster.symbol", i % 8, ".upstream");
+          creation.wait();
+          StatNameManagedStorage initial(stat_name_string, table_);
+          creates.DecrementCount();
+
+          // These are freed, which takes the lock, only after the accesses
+          // have all been made.
+          access.wait();
+          std::vector<std::unique_ptr<StatNameManagedStorage>> accessed;
+          for (int count = 0; count < 100; ++count) {
+            accessed.push_back(std::make_unique<StatNameManagedStorage>(stat_name_string, table_));
+          }
+          accesses.DecrementCount();
+
+          wait.wait();
+        }));
+  }
+  creation.setReady();
+  creates.Wait();
+
+  const int64_t create_contentions = mutex_tracer.numContentions();
+  access.setReady();
+  accesses.Wait();
+  EXPECT_EQ(create_contentions, mutex_tracer.numContentions());
+
+  wait.setReady();
+  for (auto& thread : threads) {
+    thread->join();
+  }
+}
+
 TEST_F(StatNameTest, StatNameEmptyEquivalent) {
   StatName empty1;
   StatName empty2 = makeStat("");
@@ -12,6 +12,7 @@
 #include "test/common/stats/make_elements_helper.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "benchmark/benchmark.h"
 
@@ -94,3 +95,51 @@ static void bmJoinElements(benchmark::State& state) {
   }
 }
 BENCHMARK(bmJoinElements);
+
+// Measures encoding names whose tokens are all already interned from many
+// threads at once, as filters building stat names from per-request data do.
+// state.range(0) is the number of threads, and state.range(1) is non-zero to
+// enable the per-thread symbol cache, which takes the lock off the encode path.
+// Freeing each name still takes the lock.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmEncodeContention(benchmark::State& state) {
+  const int num_threads = state.range(0);
+  const bool thread_cache = state.range(1) != 0;
+  Envoy::Thread::ThreadFactory& thread_factory = Envoy::Thread::threadFactoryForTest();
+  Envoy::Stats::SymbolTableImpl table;
+  if (thread_cache) {
+    table.setThreadCacheCapacity(Envoy::Stats::SymbolTableImpl::DefaultThreadCacheCapacity);
+  }
+  std::vector<std::string> names;
+  Envoy::Stats::StatNamePool pool(table);
+  for (int i = 0; i < 16; ++i) {
+    names.push_back(absl::StrCat("cluster.service_", i, ".ext_authz.ok"));
+    pool.add(names.back());
+  }
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    std::vector<Envoy::Thread::ThreadPtr> threads;
+    threads.reserve(num_threads);
+    Envoy::ConditionalInitializer access;
+    for (int i = 0; i < num_threads; ++i) {
+      threads.push_back(thread_factory.createThread([&access, &table, &names, i]() {
+        access.wait();
+        for (int count = 0; count < 1000; ++count) {
+          Envoy::Stats::StatNameManagedStorage storage(names[(i + count) % names.size()], table);
+        }
+      }));
+    }
+    access.setReady();
+    for (auto& thread : threads) {
+      thread->join();
+    }
+  }
+}
+BENCHMARK(bmEncodeContention)
+    ->Args({32, 0})
+    ->Args({32, 1})
+    ->Args({64, 0})
+    ->Args({64, 1})
+    ->Unit(::benchmark::kMillisecond)
+    ->UseRealTime();
@@ -46,6 +46,7 @@
 #include "source/common/config/well_known_names.h"
 #include "source/common/stats/tag_producer_impl.h"
 
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
@@ -88,9 +89,11 @@ const std::vector<Params> params = {
      1},
 };
 
+// state.range(0) indexes params, and state.range(1) is non-zero to compile the extractors
+// into a single matcher, rather than running each one.
 // NOLINTNEXTLINE(readability-identifier-naming)
 void BM_ExtractTags(benchmark::State& state) {
-  TagProducerImpl tag_extractors{envoy::config::metrics::v3::StatsConfig()};
+  TagProducerImpl tag_extractors{envoy::config::metrics::v3::StatsConfig(), state.range(1) != 0};
   const auto idx = state.range(0);
   const auto& p = params[idx];
   absl::string_view str = std::get<0>(p);
@@ -104,7 +107,43 @@ void BM_ExtractTags(benchmark::State& state) {
                    absl::StrCat("tags.size()=", tags.size(), " tags_size==", tags_size));
   }
 }
-BENCHMARK(BM_ExtractTags)->DenseRange(0, 26, 1);
+void extractTagsArgs(benchmark::internal::Benchmark* b) {
+  for (int64_t idx = 0; idx < static_cast<int64_t>(params.size()); ++idx) {
+    b->Args({idx, 0});
+    b->Args({idx, 1});
+  }
+}
+BENCHMARK(BM_ExtractTags)->Apply(extractTagsArgs);
+
+// Extracts the tags of the stats of state.range(0) clusters, as is done at startup, with the
+// extractors compiled if state.range(1) is non-zero.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_ExtractClusterTags(benchmark::State& state) {
+  TagProducerImpl tag_extractors{envoy::config::metrics::v3::StatsConfig(), state.range(1) != 0};
+  const std::vector<std::string> suffixes = {"upstream_cx_total",
+                                             "upstream_rq_200",
+                                             "upstream_rq_2xx",
+                                             "upstream_rq_time",
+                                             "ssl.ciphers.AES256-SHA",
+                                             "grpc.service.method.success",
+                                             "outlier_detection.ejections_active",
+                                             "circuit_breakers.default.rq_open"};
+  std::vector<std::string> names;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    for (const std::string& suffix : suffixes) {
+      names.push_back(absl::StrCat("cluster.cluster_", i, ".", suffix));
+    }
+  }
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (const std::string& name : names) {
+      TagVector tags;
+      tag_extractors.produceTags(name, tags);
+    }
+  }
+}
+BENCHMARK(BM_ExtractClusterTags)->Args({500, 0})->Args({500, 1})->Unit(benchmark::kMillisecond);
 
 } // namespace
 } // namespace Stats
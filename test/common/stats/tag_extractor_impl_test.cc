@@ -9,6 +9,7 @@
 
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_split.h"
 #include "gtest/gtest.h"
 
 using ::testing::ElementsAre;
@@ -86,7 +87,9 @@ TEST(TagExtractorTest, BadRegex) {
 
 class DefaultTagRegexTester {
 public:
-  DefaultTagRegexTester() : tag_extractors_(envoy::config::metrics::v3::StatsConfig()) {}
+  DefaultTagRegexTester()
+      : tag_extractors_(envoy::config::metrics::v3::StatsConfig()),
+        uncompiled_tag_extractors_(envoy::config::metrics::v3::StatsConfig(), false) {}
 
   void testRegex(const std::string& stat_name, const std::string& expected_tag_extracted_name,
                  const TagVector& expected_tags) {
@@ -105,6 +108,15 @@ public:
     EXPECT_TRUE(std::is_permutation(expected_tags.begin(), expected_tags.end(), tags.begin(), cmp))
         << fmt::format("Stat name '{}' did not produce the expected tags", stat_name);
 
+    // Running every extractor rather than the compiled matcher's candidates produces the same
+    // tags in the same order.
+    TagVector uncompiled_tags;
+    EXPECT_EQ(tag_extracted_name,
+              uncompiled_tag_extractors_.produceTags(stat_name, uncompiled_tags));
+    EXPECT_TRUE(std::equal(tags.begin(), tags.end(), uncompiled_tags.begin(),
+                           uncompiled_tags.end(), cmp))
+        << fmt::format("Stat name '{}' produced different tags when not compiled", stat_name);
+
     // Reverse iteration through regexes to ensure ordering invariance
     TagVector rev_tags;
     const std::string rev_tag_extracted_name = produceTagsReverse(stat_name, rev_tags);
@@ -152,6 +164,7 @@ public:
 
   SymbolTableImpl symbol_table_;
   TagProducerImpl tag_extractors_;
+  TagProducerImpl uncompiled_tag_extractors_;
 };
 
 TEST(TagExtractorTest, DefaultTagExtractors) {
@@ -411,6 +424,14 @@ protected:
     tags_.clear();
     TagExtractionContext tag_extraction_context(stat_name);
     bool extracted = tokens.extractTag(tag_extraction_context, tags_, remove_characters);
+
+    // The trie must agree with the extractor on whether the pattern matches.
+    TagExtractorTokensTrie trie;
+    trie.add(pattern, 0);
+    std::vector<bool> matched(1, false);
+    trie.findMatches(tag_extraction_context.tokens(), matched);
+    EXPECT_EQ(extracted, matched[0]) << pattern << " " << stat_name;
+
     if (extracted) {
       tag_extracted_name_ = StringUtil::removeCharacters(stat_name, remove_characters);
     } else {
@@ -513,5 +534,42 @@ TEST_F(TagExtractorTokensTest, TokensMismatchPatternTooLong) {
   EXPECT_FALSE(extract("article", "now.$.the.time.to", "now.is.the.time"));
 }
 
+TEST_F(TagExtractorTokensTest, TokensMismatchTrailingDoubleWild) {
+  // A trailing "**" must match at least one token.
+  EXPECT_FALSE(extract("prefix", "tcp.$.**", "tcp.prefix"));
+  EXPECT_TRUE(extract("prefix", "tcp.$.**", "tcp.prefix.stat"));
+}
+
+TEST(TagExtractorTokensTrieTest, MultiplePatterns) {
+  TagExtractorTokensTrie trie;
+  trie.add("cluster.$.**", 0);
+  trie.add("cluster.*.grpc.$.**", 1);
+  trie.add("cluster.*.grpc.*.$.**", 2);
+  trie.add("http.*.user_agent.$.**", 3);
+  trie.add("mongo.*.collection.$.**.query.*", 4);
+
+  auto matches = [&trie](absl::string_view name) {
+    const std::vector<absl::string_view> tokens = absl::StrSplit(name, '.');
+    std::vector<bool> matched(5, false);
+    trie.findMatches(tokens, matched);
+    std::vector<uint32_t> ids;
+    for (uint32_t id = 0; id < matched.size(); ++id) {
+      if (matched[id]) {
+        ids.push_back(id);
+      }
+    }
+    return ids;
+  };
+
+  EXPECT_THAT(matches("cluster.foo.upstream_rq_total"), ElementsAre(0));
+  EXPECT_THAT(matches("cluster.foo.grpc.service.success"), ElementsAre(0, 1));
+  EXPECT_THAT(matches("cluster.foo.grpc.service.method.success"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(matches("http.prefix.user_agent.ios.downstream_cx_total"), ElementsAre(3));
+  EXPECT_THAT(matches("mongo.prefix.collection.coll.callsite.site.query.total"), ElementsAre(4));
+  EXPECT_THAT(matches("mongo.prefix.collection.coll.query"), ElementsAre());
+  EXPECT_THAT(matches("listener.127.0.0.1_80.downstream_cx_total"), ElementsAre());
+  EXPECT_THAT(matches("cluster"), ElementsAre());
+}
+
 } // namespace Stats
 } // namespace Envoy
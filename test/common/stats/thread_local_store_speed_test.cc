@@ -69,6 +69,18 @@ public:
     store_.setStatsMatcher(std::make_unique<Stats::StatsMatcherImpl>(stats_config_, symbol_table_));
   }
 
+  // Returns a hot counter, sharded if requested.
+  Stats::Counter& hotCounter(bool sharded) {
+    const std::string name = "http.ingress.downstream_rq_total";
+    if (sharded) {
+      envoy::config::metrics::v3::StatsMatcher matcher;
+      matcher.mutable_inclusion_list()->add_patterns()->set_exact(name);
+      store_.setShardedCounterMatcher(
+          std::make_unique<Stats::StatsMatcherImpl>(matcher, symbol_table_));
+    }
+    return store_.counterFromString(name);
+  }
+
 private:
   Stats::SymbolTableImpl symbol_table_;
   Event::SimulatedTimeSystem time_system_;
@@ -135,3 +147,25 @@ BENCHMARK(BM_StatsWithTlsAndRejectionsWithoutDot);
 
 // TODO(jmarantz): add multi-threaded variant of this test, that aggressively
 // looks up stats in multiple threads to try to trigger contention issues.
+
+// Tests incrementing one counter from many threads at once, as workers do with counters like
+// downstream_rq_total. state.range(0) is non-zero to shard the counter.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_CounterIncContention(benchmark::State& state) {
+  static Envoy::ThreadLocalStorePerf* context;
+  static Envoy::Stats::Counter* counter;
+  // Threads are only started on the loop below once this is done.
+  if (state.thread_index == 0) {
+    context = new Envoy::ThreadLocalStorePerf();
+    counter = &context->hotCounter(state.range(0) != 0);
+  }
+
+  for (auto _ : state) { // NOLINT
+    counter->inc();
+  }
+
+  if (state.thread_index == 0) {
+    delete context;
+  }
+}
+BENCHMARK(BM_CounterIncContention)->Arg(0)->Arg(1)->Threads(1)->Threads(8)->Threads(64);
@@ -948,6 +948,26 @@ TEST_F(StatsMatcherTLSTest, TestExclusionRegex) {
   EXPECT_EQ("", invalid_string_2.value());
 }
 
+// Counters accepted by the sharded counter matcher are sharded, and count as usual.
+TEST_F(StatsMatcherTLSTest, ShardedCounters) {
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+  envoy::config::metrics::v3::StatsMatcher sharded_counters;
+  sharded_counters.mutable_inclusion_list()->add_patterns()->set_prefix("hot.");
+  store_->setShardedCounterMatcher(
+      std::make_unique<StatsMatcherImpl>(sharded_counters, symbol_table_));
+
+  Counter& hot = store_->counterFromString("hot.counter");
+  Counter& cold = store_->counterFromString("cold.counter");
+  hot.add(5);
+  hot.inc();
+  cold.inc();
+  EXPECT_EQ(6, hot.value());
+  EXPECT_EQ(1, cold.value());
+  EXPECT_EQ(&hot, &store_->counterFromString("hot.counter"));
+  EXPECT_EQ(6, TestUtility::findCounter(*store_, "hot.counter")->latch());
+  EXPECT_EQ(6, hot.value());
+}
+
 // Rejecting stats of the form "cluster." enables an optimization in the matcher
 // infrastructure that performs the rejection without converting from StatName
 // to string, obviating the need to memoize the rejection in a set. This saves
@@ -1556,10 +1576,11 @@ protected:
     absl::BlockingCounter blocking_counter_;
   };
 
-  ThreadLocalRealThreadsTestBase(uint32_t num_threads)
+  ThreadLocalRealThreadsTestBase(uint32_t num_threads, uint32_t histogram_merge_threads = 0)
       : num_threads_(num_threads), start_time_(time_system_.monotonicTime()),
         api_(Api::createApiForTest()), thread_factory_(api_->threadFactory()),
         pool_(store_->symbolTable()) {
+    store_->setHistogramMergeThreads(thread_factory_, histogram_merge_threads);
     // This is the same order as InstanceImpl::initialize in source/server/server.cc.
     thread_dispatchers_.resize(num_threads_);
     {
@@ -1744,7 +1765,8 @@ class HistogramThreadTest : public ThreadLocalRealThreadsTestBase {
 protected:
   static constexpr uint32_t NumThreads = 10;
 
-  HistogramThreadTest() : ThreadLocalRealThreadsTestBase(NumThreads) {}
+  explicit HistogramThreadTest(uint32_t histogram_merge_threads = 0)
+      : ThreadLocalRealThreadsTestBase(NumThreads, histogram_merge_threads) {}
 
   void mergeHistograms() {
     BlockingBarrier blocking_barrier(1);
@@ -1858,5 +1880,60 @@ TEST_F(HistogramThreadTest, ScopeOverlap) {
   store_->histogramFromString("histogram_after_shutdown", Histogram::Unit::Unspecified);
 }
 
+class HistogramMergeThreadsTest : public HistogramThreadTest {
+protected:
+  static constexpr uint32_t NumMergeThreads = 3;
+
+  HistogramMergeThreadsTest() : HistogramThreadTest(NumMergeThreads) {}
+};
+
+TEST_F(HistogramMergeThreadsTest, MakeHistogramsAndRecordValues) {
+  foreachThread([this]() {
+    for (uint32_t i = 0; i < 10; ++i) {
+      Histogram& histogram = store_->histogramFromString(absl::StrCat("my_hist_", i),
+                                                         Stats::Histogram::Unit::Unspecified);
+      histogram.recordValue(42);
+    }
+  });
+
+  mergeHistograms();
+
+  std::vector<ParentHistogramSharedPtr> histograms = store_->histograms();
+  ASSERT_EQ(10, histograms.size());
+  for (const ParentHistogramSharedPtr& histogram : histograms) {
+    EXPECT_THAT(histogram->bucketSummary(),
+                HasSubstr(absl::StrCat(" B25(0,0) B50(", NumThreads, ",", NumThreads, ") ")));
+  }
+}
+
+// Values recorded while the histograms are being merged are all collected by one of the merges.
+TEST_F(HistogramMergeThreadsTest, RecordWhileMerging) {
+  constexpr uint32_t NumHistograms = 20;
+  constexpr uint32_t NumValues = 10000;
+  {
+    BlockingBarrier blocking_barrier(NumThreads);
+    for (Event::DispatcherPtr& thread_dispatcher : thread_dispatchers_) {
+      thread_dispatcher->post(blocking_barrier.run([this]() {
+        for (uint32_t i = 0; i < NumValues; ++i) {
+          store_
+              ->histogramFromString(absl::StrCat("my_hist_", i % NumHistograms),
+                                    Stats::Histogram::Unit::Unspecified)
+              .recordValue(i);
+        }
+      }));
+    }
+    for (uint32_t i = 0; i < 10; ++i) {
+      mergeHistograms();
+    }
+  }
+  mergeHistograms();
+
+  uint64_t sample_count = 0;
+  for (const ParentHistogramSharedPtr& histogram : store_->histograms()) {
+    sample_count += histogram->cumulativeStatistics().sampleCount();
+  }
+  EXPECT_EQ(NumThreads * NumValues, sample_count);
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -195,6 +195,35 @@ TEST_F(StreamInfoImplTest, MiscSettersAndGetters) {
   }
 }
 
+TEST_F(StreamInfoImplTest, RarelySetFieldsDefaultUntilSet) {
+  StreamInfoImpl stream_info(Http::Protocol::Http2, test_time_.timeSystem(), nullptr);
+  const StreamInfoImpl& const_stream_info = stream_info;
+
+  EXPECT_EQ(0, const_stream_info.dynamicMetadata().filter_metadata_size());
+  EXPECT_FALSE(stream_info.firstUpstreamRxByteReceived());
+  stream_info.setRouteName("");
+  EXPECT_EQ("", stream_info.getRouteName());
+  stream_info.setUpstreamTransportFailureReason("");
+  EXPECT_EQ("", stream_info.upstreamTransportFailureReason());
+  stream_info.setFilterChainName("");
+  EXPECT_EQ("", stream_info.filterChainName());
+
+  stream_info.setRouteName("route");
+  EXPECT_EQ("route", stream_info.getRouteName());
+  EXPECT_EQ("", stream_info.upstreamTransportFailureReason());
+  EXPECT_EQ("", stream_info.filterChainName());
+  EXPECT_FALSE(stream_info.connectionTerminationDetails().has_value());
+  EXPECT_FALSE(stream_info.firstUpstreamRxByteReceived());
+  EXPECT_EQ(0, const_stream_info.dynamicMetadata().filter_metadata_size());
+
+  stream_info.setUpstreamTransportFailureReason("reason");
+  stream_info.setFilterChainName("filter_chain");
+  stream_info.setRouteName("");
+  EXPECT_EQ("", stream_info.getRouteName());
+  EXPECT_EQ("reason", stream_info.upstreamTransportFailureReason());
+  EXPECT_EQ("filter_chain", stream_info.filterChainName());
+}
+
 TEST_F(StreamInfoImplTest, DynamicMetadataTest) {
   StreamInfoImpl stream_info(Http::Protocol::Http2, test_time_.timeSystem(), nullptr);
 
@@ -0,0 +1,193 @@
+#include <chrono>
+#include <memory>
+
+#include "envoy/config/trace/v3/http_tracer.pb.h"
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/common/tracing/common_values.h"
+#include "source/common/tracing/tail_sampler_impl.h"
+
+#include "test/mocks/common.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/mocks/tracing/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Tracing {
+namespace {
+
+class TailSamplerTest : public testing::Test {
+public:
+  void setup(const std::string& yaml) {
+    envoy::config::trace::v3::TailSampling config;
+    TestUtility::loadFromYaml(yaml, config);
+    sampler_ = std::make_unique<TailSampler>(config, tls_, store_, time_system_, random_);
+  }
+
+  // Starts a request, whose downstream span is root_ and whose upstream span is child_.
+  void startRequest() {
+    start_time_ = time_system_.monotonicTime();
+    root_ = new NiceMock<MockSpan>();
+    child_ = new NiceMock<MockSpan>();
+    span_ = sampler_->wrap(SpanPtr{root_}, start_time_);
+    EXPECT_CALL(*root_, spawnChild_(_, "upstream", _)).WillOnce(Return(child_));
+    child_span_ = span_->spawnChild(config_, "upstream", time_system_.systemTime());
+  }
+
+  uint64_t counter(const std::string& name) {
+    return store_.counterFromString("tracing.tail_sampling." + name).value();
+  }
+
+  uint64_t gauge(const std::string& name) {
+    return store_
+        .gaugeFromString("tracing.tail_sampling." + name, Stats::Gauge::ImportMode::Accumulate)
+        .value();
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Stats::IsolatedStoreImpl store_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  NiceMock<MockConfig> config_;
+  std::unique_ptr<TailSampler> sampler_;
+  MonotonicTime start_time_;
+  NiceMock<MockSpan>* root_;
+  NiceMock<MockSpan>* child_;
+  SpanPtr span_;
+  SpanPtr child_span_;
+};
+
+// The spans of a request which failed are exported once it completes, with the time they
+// finished.
+TEST_F(TailSamplerTest, KeepsTraceWithError) {
+  setup("{}");
+  startRequest();
+  Event::MockTimer* timer = new Event::MockTimer(&tls_.dispatcher_);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(10000), _));
+  child_span_->finishSpan();
+  const SystemTime end_time = time_system_.systemTime();
+  const MonotonicTime monotonic_end_time = time_system_.monotonicTime();
+  EXPECT_EQ(1U, gauge("buffered_spans"));
+  EXPECT_LT(0U, gauge("buffered_bytes"));
+
+  time_system_.advanceTimeWait(std::chrono::milliseconds(5));
+  span_->setTag(Tags::get().Error, Tags::get().True);
+  EXPECT_CALL(*timer, disableTimer());
+  EXPECT_CALL(*child_, finishSpanAt(end_time, monotonic_end_time));
+  EXPECT_CALL(*root_, setSampled(_)).Times(0);
+  EXPECT_CALL(*root_, finishSpan());
+  span_->finishSpan();
+  EXPECT_EQ(1U, counter("traces_kept"));
+  EXPECT_EQ(0U, gauge("buffered_spans"));
+  EXPECT_EQ(0U, gauge("buffered_bytes"));
+}
+
+// The spans of a request which none of the criteria keeps are finished unsampled.
+TEST_F(TailSamplerTest, DropsTrace) {
+  setup(R"EOF(
+latency_threshold: 1s
+keep_tags:
+- name: foo
+  value: bar
+)EOF");
+  startRequest();
+  Event::MockTimer* timer = new NiceMock<Event::MockTimer>(&tls_.dispatcher_);
+  child_span_->setTag("foo", "baz");
+  child_span_->finishSpan();
+  EXPECT_TRUE(timer->enabled_);
+
+  EXPECT_CALL(*child_, setSampled(false));
+  EXPECT_CALL(*child_, finishSpanAt(_, _));
+  EXPECT_CALL(*root_, setSampled(false));
+  EXPECT_CALL(*root_, finishSpan());
+  span_->finishSpan();
+  EXPECT_EQ(1U, counter("traces_dropped"));
+  EXPECT_FALSE(timer->enabled_);
+}
+
+// The traces of the requests which took long enough, or which have one of the tags, are kept.
+TEST_F(TailSamplerTest, KeepsTraceByLatencyOrTag) {
+  setup(R"EOF(
+latency_threshold: 1s
+keep_tags:
+- name: foo
+)EOF");
+  startRequest();
+  EXPECT_CALL(*child_, finishSpan());
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  span_->finishSpan();
+  child_span_->finishSpan();
+
+  startRequest();
+  EXPECT_CALL(*child_, finishSpan());
+  child_span_->setTag("foo", "any");
+  span_->finishSpan();
+  child_span_->finishSpan();
+  EXPECT_EQ(2U, counter("traces_kept"));
+}
+
+// The traces which nothing else keeps are kept at random at the configured rate.
+TEST_F(TailSamplerTest, KeepsTraceAtRandom) {
+  setup("random_sampling: {value: 50}");
+  startRequest();
+  EXPECT_CALL(random_, random()).WillOnce(Return(0));
+  EXPECT_CALL(*root_, setSampled(_)).Times(0);
+  span_->finishSpan();
+  EXPECT_EQ(1U, counter("traces_kept"));
+}
+
+// The trace of a request which lasts longer than decision_wait is kept.
+TEST_F(TailSamplerTest, KeepsTraceOnDecisionWait) {
+  setup("decision_wait: 1s");
+  startRequest();
+  Event::MockTimer* timer = new NiceMock<Event::MockTimer>(&tls_.dispatcher_);
+  child_span_->finishSpan();
+
+  EXPECT_CALL(*child_, finishSpanAt(_, _));
+  timer->invokeCallback();
+  EXPECT_EQ(1U, counter("traces_kept"));
+  EXPECT_EQ(0U, gauge("buffered_spans"));
+
+  EXPECT_CALL(*root_, setSampled(_)).Times(0);
+  EXPECT_CALL(*root_, finishSpan());
+  span_->finishSpan();
+  EXPECT_EQ(1U, counter("traces_kept"));
+}
+
+// The spans which finish while their worker buffers max_buffered_bytes already are exported right
+// away.
+TEST_F(TailSamplerTest, ExportsSpansOverMaxBufferedBytes) {
+  setup("max_buffered_bytes: 1");
+  startRequest();
+  EXPECT_CALL(*child_, finishSpan());
+  child_span_->finishSpan();
+  EXPECT_EQ(1U, counter("spans_overflowed"));
+  EXPECT_EQ(0U, gauge("buffered_spans"));
+}
+
+// The spans buffered for a request which ends without completing are exported.
+TEST_F(TailSamplerTest, ExportsBufferedSpansOnDestruction) {
+  setup("{}");
+  startRequest();
+  new NiceMock<Event::MockTimer>(&tls_.dispatcher_);
+  child_span_->finishSpan();
+
+  EXPECT_CALL(*child_, finishSpanAt(_, _));
+  span_.reset();
+  child_span_.reset();
+  EXPECT_EQ(0U, gauge("buffered_spans"));
+  EXPECT_EQ(0U, gauge("buffered_bytes"));
+}
+
+} // namespace
+} // namespace Tracing
+} // namespace Envoy
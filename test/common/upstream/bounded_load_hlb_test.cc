@@ -269,6 +269,34 @@ TEST_F(BoundedLoadHashingLoadBalancerTest, AllHostsOverloaded) {
   EXPECT_EQ(host->address()->asString(), "127.0.0.11:90");
 };
 
+// Works correctly when the only eligible host is found late in the random sequence of a large
+// number of hosts, and the same hash finds it again.
+TEST_F(BoundedLoadHashingLoadBalancerTest, OnlyOneOfManyHostsNotOverloaded) {
+  NormalizedHostWeightVector normalized_host_weights;
+  for (uint32_t i = 0; i < 1000; i++) {
+    normalized_host_weights.push_back(
+        {makeTestHost(info_, fmt::format("tcp://10.0.{}.{}:90", i / 256, i % 256), simTime()),
+         1.0 / 1000});
+  }
+  const std::string eligible = "10.0.3.231:90";
+  host_overload_factor_predicate_ = [&eligible](const Host& h, double) -> double {
+    return h.address()->asString() == eligible ? 0.5 : 2.0;
+  };
+
+  NormalizedHostWeightVector ring(normalized_host_weights);
+  hlb_ = std::make_shared<TestHashingLoadBalancer>(ring);
+
+  lb_ = std::make_unique<TestBoundedLoadHashingLoadBalancer>(hlb_, normalized_host_weights, 1,
+                                                             host_overload_factor_predicate_);
+
+  for (uint32_t i = 0; i < 10; i++) {
+    HostConstSharedPtr host = lb_->chooseHost(i, 1);
+    EXPECT_NE(host, nullptr);
+    EXPECT_EQ(host->address()->asString(), eligible);
+    EXPECT_EQ(host, lb_->chooseHost(i, 1));
+  }
+};
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
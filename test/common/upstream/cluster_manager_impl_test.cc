@@ -21,6 +21,8 @@
 #include "test/mocks/upstream/thread_aware_load_balancer.h"
 #include "test/test_common/test_runtime.h"
 
+#include "absl/synchronization/notification.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -315,6 +317,102 @@ TEST_F(ClusterManagerImplTest, OutlierEventLog) {
   create(parseBootstrapFromV3Json(json));
 }
 
+TEST_F(ClusterManagerImplTest, NoClusterInitThreads) {
+  create(parseBootstrapFromV3Yaml(R"EOF(
+static_resources:
+  clusters: []
+  )EOF"));
+  EXPECT_FALSE(cluster_manager_->runOnClusterInitThread([]() { FAIL(); }, []() { FAIL(); }));
+}
+
+// Work runs on a cluster init thread, and then done is posted to the main thread.
+TEST_F(ClusterManagerImplTest, RunOnClusterInitThread) {
+  create(parseBootstrapFromV3Yaml(R"EOF(
+cluster_manager:
+  cluster_init_threads: 2
+static_resources:
+  clusters: []
+  )EOF"));
+
+  Thread::ThreadFactory& thread_factory = factory_.api_->threadFactory();
+  const Thread::ThreadId main_thread_id = thread_factory.currentThreadId();
+  Thread::ThreadId work_thread_id;
+  absl::Notification done;
+  EXPECT_CALL(factory_.dispatcher_, post(_)).WillOnce(Invoke([&](Event::PostCb cb) { cb(); }));
+  EXPECT_TRUE(cluster_manager_->runOnClusterInitThread(
+      [&]() { work_thread_id = thread_factory.currentThreadId(); }, [&]() { done.Notify(); }));
+  done.WaitForNotification();
+  EXPECT_NE(main_thread_id, work_thread_id);
+}
+
+// A cluster with a TLS context built on a cluster init thread initializes once it is built.
+TEST_F(ClusterManagerImplTest, TlsContextBuiltOnClusterInitThread) {
+  const std::string yaml = R"EOF(
+cluster_manager:
+  cluster_init_threads: 1
+static_resources:
+  clusters:
+  - name: cluster_1
+    connect_timeout: 0.250s
+    type: STATIC
+    lb_policy: ROUND_ROBIN
+    load_assignment:
+      cluster_name: cluster_1
+      endpoints:
+      - lb_endpoints:
+        - endpoint:
+            address:
+              socket_address:
+                address: 127.0.0.1
+                port_value: 11001
+    transport_socket:
+      name: envoy.transport_sockets.tls
+      typed_config:
+        "@type": type.googleapis.com/envoy.extensions.transport_sockets.tls.v3.UpstreamTlsContext
+  )EOF";
+
+  // Hold back the publication of the context on the main thread.
+  Thread::ThreadFactory& thread_factory = factory_.api_->threadFactory();
+  const Thread::ThreadId main_thread_id = thread_factory.currentThreadId();
+  absl::Notification built;
+  Event::PostCb publish;
+  ON_CALL(factory_.dispatcher_, post(_)).WillByDefault(Invoke([&](Event::PostCb cb) {
+    if (thread_factory.currentThreadId() == main_thread_id) {
+      cb();
+    } else {
+      publish = std::move(cb);
+      built.Notify();
+    }
+  }));
+
+  ReadyWatcher initialized;
+  create(parseBootstrapFromV3Yaml(yaml));
+  cluster_manager_->setInitializedCb([&]() -> void { initialized.ready(); });
+  auto create_transport_socket = [this]() {
+    return cluster_manager_->clusters()
+        .active_clusters_.find("cluster_1")
+        ->second.get()
+        .info()
+        ->transportSocketMatcher()
+        .resolve(nullptr)
+        .factory_.createTransportSocket(nullptr);
+  };
+
+  // There is no context until it is published.
+  built.WaitForNotification();
+  create_transport_socket();
+  EXPECT_EQ(1UL, factory_.stats_.counter("cluster.cluster_1.client_ssl_socket_factory."
+                                         "upstream_context_secrets_not_ready")
+                     .value());
+
+  EXPECT_CALL(initialized, ready());
+  publish();
+  create_transport_socket();
+  EXPECT_EQ(1UL, factory_.stats_.counter("cluster.cluster_1.client_ssl_socket_factory."
+                                         "upstream_context_secrets_not_ready")
+                     .value());
+}
+
 TEST_F(ClusterManagerImplTest, NoSdsConfig) {
   const std::string yaml = R"EOF(
 static_resources:
@@ -668,6 +766,24 @@ TEST_F(ClusterManagerImplTest, SubsetLoadBalancerClusterProvidedLbRestriction) {
       "cluster: LB policy CLUSTER_PROVIDED cannot be combined with lb_subset_config");
 }
 
+TEST_F(ClusterManagerImplTest, SubsetLoadBalancerPeakEwmaLbRestriction) {
+  const std::string yaml = R"EOF(
+ static_resources:
+  clusters:
+  - name: cluster_1
+    connect_timeout: 0.250s
+    type: static
+    lb_policy: peak_ewma
+    lb_subset_config:
+      fallback_policy: ANY_ENDPOINT
+      subset_selectors:
+        - keys: [ "x" ]
+  )EOF";
+
+  EXPECT_THROW_WITH_MESSAGE(create(parseBootstrapFromV3Yaml(yaml)), EnvoyException,
+                            "cluster: LB policy PEAK_EWMA cannot be combined with lb_subset_config");
+}
+
 TEST_F(ClusterManagerImplTest, SubsetLoadBalancerLocalityAware) {
   const std::string yaml = R"EOF(
  static_resources:
@@ -4901,6 +5017,115 @@ TEST_F(PreconnectTest, PreconnectCappedByMaybePreconnect) {
   EXPECT_EQ(1, http_preconnect_calls);
 }
 
+class WarmUpTest : public ClusterManagerImplTest {
+public:
+  void initialize() {
+    const std::string yaml = R"EOF(
+  static_resources:
+    clusters:
+    - name: cluster_1
+      connect_timeout: 0.250s
+      lb_policy: ROUND_ROBIN
+      type: STATIC
+      preconnect_policy:
+        warm_up_connections: 2
+        warm_up_timeout: 2s
+  )EOF";
+
+    create(parseBootstrapFromV3Yaml(yaml));
+    cluster_ = &cluster_manager_->activeClusters().begin()->second.get();
+    host1_ = makeTestHost(cluster_->info(), "tcp://127.0.0.1:80", time_system_);
+    host2_ = makeTestHost(cluster_->info(), "tcp://127.0.0.2:80", time_system_);
+    ON_CALL(factory_, allocateConnPool_(_, _, _, _, _))
+        .WillByDefault(Invoke(
+            [this](HostConstSharedPtr host,
+                   const absl::optional<envoy::config::core::v3::AlternateProtocolsCacheOptions>&,
+                   Network::ConnectionSocket::OptionsSharedPtr,
+                   Network::TransportSocketOptionsConstSharedPtr,
+                   ClusterConnectivityState&) -> Http::ConnectionPool::Instance* {
+              auto* pool = new NiceMock<Http::ConnectionPool::MockInstance>();
+              ON_CALL(*pool, warmUp(2, _))
+                  .WillByDefault(
+                      Invoke([this, host](uint32_t, Envoy::ConnectionPool::Instance::WarmUpCb cb) {
+                        warm_up_cbs_[host] = cb;
+                      }));
+              return pool;
+            }));
+  }
+
+  void updateHosts(const HostVector& hosts, const HostVector& hosts_added) {
+    cluster_->prioritySet().updateHosts(
+        0, HostSetImpl::partitionHosts(std::make_shared<HostVector>(hosts),
+                                       HostsPerLocalityImpl::empty()),
+        nullptr, hosts_added, {}, 100);
+  }
+
+  // Returns the hosts picked by the load balancer for the next 4 streams.
+  std::vector<HostConstSharedPtr> pickHosts() {
+    std::vector<HostConstSharedPtr> hosts;
+    for (int i = 0; i < 4; ++i) {
+      hosts.push_back(cluster_manager_->getThreadLocalCluster("cluster_1")
+                          ->loadBalancer()
+                          .chooseHost(nullptr));
+    }
+    return hosts;
+  }
+
+  Cluster* cluster_{};
+  HostSharedPtr host1_;
+  HostSharedPtr host2_;
+  absl::flat_hash_map<HostConstSharedPtr, Envoy::ConnectionPool::Instance::WarmUpCb> warm_up_cbs_;
+};
+
+// The hosts of a new cluster are warmed up without being held back, as there's nothing else to
+// send the traffic to, while the hosts added later wait for their connections.
+TEST_F(WarmUpTest, ExcludesNewHostsUntilWarm) {
+  initialize();
+  updateHosts({host1_}, {host1_});
+  EXPECT_EQ(1, warm_up_cbs_.count(host1_));
+  EXPECT_EQ(0, cluster_->info()->stats().upstream_host_warm_up_.value());
+  EXPECT_EQ(std::vector<HostConstSharedPtr>(4, host1_), pickHosts());
+
+  updateHosts({host1_, host2_}, {host2_});
+  ASSERT_EQ(1, warm_up_cbs_.count(host2_));
+  EXPECT_EQ(1, cluster_->info()->stats().upstream_host_warm_up_.value());
+  EXPECT_EQ(std::vector<HostConstSharedPtr>(4, host1_), pickHosts());
+
+  warm_up_cbs_[host2_]();
+  std::vector<HostConstSharedPtr> hosts = pickHosts();
+  EXPECT_EQ(2, std::count(hosts.begin(), hosts.end(), host2_));
+  EXPECT_EQ(0, cluster_->info()->stats().upstream_host_warm_up_timeout_.value());
+}
+
+TEST_F(WarmUpTest, WarmUpTimeout) {
+  initialize();
+  updateHosts({host1_}, {host1_});
+  auto* timeout_timer = new NiceMock<Event::MockTimer>(&factory_.tls_.dispatcher_);
+  EXPECT_CALL(*timeout_timer, enableTimer(std::chrono::milliseconds(2000), _));
+  updateHosts({host1_, host2_}, {host2_});
+  EXPECT_EQ(std::vector<HostConstSharedPtr>(4, host1_), pickHosts());
+
+  timeout_timer->invokeCallback();
+  EXPECT_EQ(1, cluster_->info()->stats().upstream_host_warm_up_timeout_.value());
+  std::vector<HostConstSharedPtr> hosts = pickHosts();
+  EXPECT_EQ(2, std::count(hosts.begin(), hosts.end(), host2_));
+  // The pool calling back late is ignored.
+  warm_up_cbs_[host2_]();
+}
+
+// A host removed while it is warmed up is forgotten.
+TEST_F(WarmUpTest, RemoveWarmingHost) {
+  initialize();
+  updateHosts({host1_}, {host1_});
+  updateHosts({host1_, host2_}, {host2_});
+  cluster_->prioritySet().updateHosts(
+      0, HostSetImpl::partitionHosts(std::make_shared<HostVector>(HostVector{host1_}),
+                                     HostsPerLocalityImpl::empty()),
+      nullptr, {}, {host2_}, 100);
+  warm_up_cbs_[host2_]();
+  EXPECT_EQ(std::vector<HostConstSharedPtr>(4, host1_), pickHosts());
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
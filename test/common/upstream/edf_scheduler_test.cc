@@ -59,6 +59,25 @@ TEST(EdfSchedulerTest, Weighted) {
 }
 
 // Validate that expired entries are ignored.
+// Validate that a scheduler built in bulk picks in the same order as one built by add().
+TEST(EdfSchedulerTest, CreateFromEntries) {
+  constexpr uint32_t num_entries = 64;
+  std::vector<std::shared_ptr<uint32_t>> entries;
+  EdfScheduler<uint32_t> sched;
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries.push_back(std::make_shared<uint32_t>(i));
+    // Repeat weights so that ties are broken by insertion order.
+    sched.add(i % 5 + 1, entries.back());
+  }
+  auto bulk = EdfScheduler<uint32_t>::createFromEntries(
+      entries, [](const uint32_t& entry) -> double { return entry % 5 + 1; });
+
+  const auto weight = [](const uint32_t& entry) -> double { return entry % 5 + 1; };
+  for (uint32_t i = 0; i < num_entries * 10; ++i) {
+    EXPECT_EQ(*sched.pickAndAdd(weight), *bulk->pickAndAdd(weight));
+  }
+}
+
 TEST(EdfSchedulerTest, Expired) {
   EdfScheduler<uint32_t> sched;
 
@@ -134,6 +153,60 @@ TEST(EdfSchedulerTest, ManyPeekahead) {
   }
 }
 
+// Validate that the indexed scheduler picks in the same order as EdfScheduler, including when
+// weights change between picks and entries are peeked ahead.
+TEST(IndexedEdfSchedulerTest, MatchesEdfScheduler) {
+  constexpr uint32_t num_entries = 97;
+  std::vector<std::shared_ptr<uint32_t>> entries;
+  std::vector<double> weights;
+  EdfScheduler<uint32_t> sched;
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries.push_back(std::make_shared<uint32_t>(i));
+    // Repeat weights so that ties are broken by insertion order.
+    weights.push_back(i % 7 + 1);
+    sched.add(weights.back(), entries.back());
+  }
+  IndexedEdfScheduler indexed(num_entries, [&weights](uint32_t index) { return weights[index]; });
+  EXPECT_EQ(num_entries, indexed.size());
+
+  const auto weight = [&weights](const uint32_t& entry) { return weights[entry]; };
+  const auto indexed_weight = [&weights](uint32_t index) { return weights[index]; };
+  for (uint32_t i = 0; i < num_entries * 20; ++i) {
+    if (i % 13 == 0) {
+      EXPECT_EQ(*sched.peekAgain(weight), indexed.peekAgain(indexed_weight));
+    }
+    if (i % 50 == 0) {
+      weights[i % num_entries] = i % 3 + 0.5;
+    }
+    EXPECT_EQ(*sched.pickAndAdd(weight), indexed.pickAndAdd(indexed_weight));
+  }
+}
+
+// Validate that a batched pick is equivalent to consecutive single picks.
+TEST(IndexedEdfSchedulerTest, BatchedPick) {
+  constexpr uint32_t num_entries = 16;
+  const auto weight = [](uint32_t index) -> double { return index + 1; };
+  IndexedEdfScheduler single(num_entries, weight);
+  IndexedEdfScheduler batched(num_entries, weight);
+
+  // Peeked entries are returned first by the batch, as they would be by single picks.
+  EXPECT_EQ(single.peekAgain(weight), batched.peekAgain(weight));
+
+  std::vector<uint32_t> picks{42};
+  batched.pickAndAdd(100, weight, picks);
+  ASSERT_EQ(101, picks.size());
+  EXPECT_EQ(42, picks[0]);
+  for (uint32_t i = 1; i < picks.size(); ++i) {
+    EXPECT_EQ(single.pickAndAdd(weight), picks[i]);
+  }
+}
+
+TEST(IndexedEdfSchedulerTest, Empty) {
+  IndexedEdfScheduler sched(0, [](uint32_t) { return 1.0; });
+  EXPECT_TRUE(sched.empty());
+  EXPECT_EQ(0, sched.size());
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -91,8 +91,12 @@ public:
 
   // Set up an EDS config with multiple priorities, localities, weights and make sure
   // they are loaded as expected.
+  // If unhealthy_host is set, only that endpoint is reported unhealthy. If timed is false the
+  // whole update runs with timing paused, e.g. to set up state for a later measured update.
   void priorityAndLocalityWeightedHelper(bool ignore_unknown_dynamic_fields, size_t num_hosts,
-                                         bool healthy) {
+                                         bool healthy,
+                                         absl::optional<size_t> unhealthy_host = absl::nullopt,
+                                         bool timed = true) {
     state_.PauseTiming();
 
     envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
@@ -110,7 +114,7 @@ public:
     uint32_t port = 1000;
     for (size_t i = 0; i < num_hosts; ++i) {
       auto* lb_endpoint = endpoints->add_lb_endpoints();
-      if (healthy) {
+      if (healthy && unhealthy_host != i) {
         lb_endpoint->set_health_status(envoy::config::core::v3::HEALTHY);
       } else {
         lb_endpoint->set_health_status(envoy::config::core::v3::UNHEALTHY);
@@ -135,10 +139,15 @@ public:
                      "");
       resource->set_type_url("type.googleapis.com/envoy.api.v2.ClusterLoadAssignment");
     }
-    state_.ResumeTiming();
+    if (timed) {
+      state_.ResumeTiming();
+    }
     grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
     ASSERT(cluster_->prioritySet().hostSetsPerPriority()[1]->hostsPerLocality().get()[0].size() ==
            num_hosts);
+    if (!timed) {
+      state_.ResumeTiming();
+    }
   }
 
   TestDeprecatedV2Api _deprecated_v2_api_;
@@ -222,3 +231,31 @@ static void healthOnlyUpdate(State& state) {
 }
 
 BENCHMARK(healthOnlyUpdate)->Range(1, 100000)->Unit(benchmark::kMillisecond);
+
+// Measures an update that changes the health of a single endpoint in an otherwise unchanged
+// cluster, with reuse of hosts for unchanged endpoints disabled (0) or enabled (1).
+static void singleEndpointUpdate(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  for (auto _ : state) {
+    state.PauseTiming();
+    Envoy::TestScopedRuntime scoped_runtime;
+    Envoy::Runtime::LoaderSingleton::getExisting()->mergeValues(
+        {{"envoy.reloadable_features.eds_reuse_unchanged_hosts",
+          state.range(1) ? "true" : "false"}});
+    Envoy::Upstream::EdsSpeedTest speed_test(state, false);
+    state.ResumeTiming();
+    uint32_t endpoints = skipExpensiveBenchmarks() ? 1 : state.range(0);
+    speed_test.priorityAndLocalityWeightedHelper(true, endpoints, true, absl::nullopt, false);
+    speed_test.priorityAndLocalityWeightedHelper(true, endpoints, true, 0);
+  }
+}
+BENCHMARK(singleEndpointUpdate)
+    ->Args({10000, 0})
+    ->Args({10000, 1})
+    ->Args({50000, 0})
+    ->Args({50000, 1})
+    ->Args({100000, 0})
+    ->Args({100000, 1})
+    ->Unit(benchmark::kMillisecond);
@@ -405,6 +405,60 @@ TEST_F(EdsTest, EndpointWeightChangeCausesRebuildDisabled) {
   endpointWeightChangeCausesRebuildTest(*this, false);
 }
 
+namespace {
+
+void unchangedEndpointsKeepHostsTest(EdsTest& test) {
+  envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
+  cluster_load_assignment.set_cluster_name("fare");
+  auto* endpoints = cluster_load_assignment.add_endpoints();
+  for (uint32_t port = 80; port < 84; ++port) {
+    auto* socket_address = endpoints->add_lb_endpoints()
+                               ->mutable_endpoint()
+                               ->mutable_address()
+                               ->mutable_socket_address();
+    socket_address->set_address("1.2.3.4");
+    socket_address->set_port_value(port);
+  }
+
+  test.initialize();
+  test.doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  const HostVector initial_hosts = test.cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+  ASSERT_EQ(4, initial_hosts.size());
+
+  // An identical update leaves everything in place.
+  test.doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(1UL, test.stats_.counter("cluster.name.update_no_rebuild").value());
+  EXPECT_EQ(initial_hosts, test.cluster_->prioritySet().hostSetsPerPriority()[0]->hosts());
+
+  // Changing one endpoint updates that host in place and keeps all of the others.
+  endpoints->mutable_lb_endpoints(2)->set_health_status(envoy::config::core::v3::UNHEALTHY);
+  test.doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(initial_hosts, test.cluster_->prioritySet().hostSetsPerPriority()[0]->hosts());
+  EXPECT_EQ(Host::Health::Unhealthy, initial_hosts[2]->health());
+  EXPECT_EQ(3, test.cluster_->prioritySet().hostSetsPerPriority()[0]->healthyHosts().size());
+
+  // Reverting it is picked up as well, even though the endpoint matches an earlier update.
+  endpoints->mutable_lb_endpoints(2)->clear_health_status();
+  test.doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(initial_hosts, test.cluster_->prioritySet().hostSetsPerPriority()[0]->hosts());
+  EXPECT_EQ(Host::Health::Healthy, initial_hosts[2]->health());
+  EXPECT_EQ(4, test.cluster_->prioritySet().hostSetsPerPriority()[0]->healthyHosts().size());
+}
+
+} // namespace
+
+// Verify that hosts whose endpoint did not change are kept across updates.
+TEST_F(EdsTest, UnchangedEndpointsKeepHosts) { unchangedEndpointsKeepHostsTest(*this); }
+
+// Same as above, with host reuse disabled so every endpoint is matched via address.
+TEST_F(EdsTest, UnchangedEndpointsKeepHostsReuseDisabled) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.eds_reuse_unchanged_hosts", "false"}});
+
+  unchangedEndpointsKeepHostsTest(*this);
+}
+
 // Validate that onConfigUpdate() updates the endpoint metadata.
 TEST_F(EdsTest, EndpointMetadata) {
   envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
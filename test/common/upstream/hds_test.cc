@@ -699,6 +699,52 @@ TEST_F(HdsTest, TestSendResponseOneEndpointTimeout) {
             1234);
 }
 
+// Tests that the health status of the endpoints is updated in each response, and that the
+// response follows the endpoints of a new specifier.
+TEST_F(HdsTest, TestSendResponseHealthChange) {
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  EXPECT_CALL(async_stream_, sendMessageRaw_(_, _));
+  createHdsDelegate();
+
+  // Create Message
+  message.reset(createSimpleMessage());
+
+  // Create a new active connection on request, setting its status to connected
+  // to mock a found endpoint.
+  expectCreateClientConnection();
+
+  EXPECT_CALL(*server_response_timer_, enableTimer(_, _)).Times(AtLeast(1));
+  EXPECT_CALL(async_stream_, sendMessageRaw_(_, false)).Times(3);
+  EXPECT_CALL(test_factory_, createClusterInfo(_)).WillRepeatedly(Return(cluster_info_));
+  EXPECT_CALL(dispatcher_, deferredDelete_(_)).Times(AtLeast(1));
+  hds_delegate_->onReceiveMessage(std::move(message));
+
+  auto response = hds_delegate_->sendResponse().endpoint_health_response();
+  ASSERT_EQ(response.endpoints_health_size(), 1);
+  EXPECT_EQ(response.endpoints_health(0).health_status(), envoy::config::core::v3::UNHEALTHY);
+
+  // The host passing its health check is reported in both lists of the next response.
+  hds_delegate_->hdsClusters()[0]->hosts()[0]->healthFlagClear(Host::HealthFlag::FAILED_ACTIVE_HC);
+  response = hds_delegate_->sendResponse().endpoint_health_response();
+  ASSERT_EQ(response.endpoints_health_size(), 1);
+  EXPECT_EQ(response.endpoints_health(0).health_status(), envoy::config::core::v3::HEALTHY);
+  EXPECT_EQ(response.cluster_endpoints_health(0)
+                .locality_endpoints_health(0)
+                .endpoints_health(0)
+                .health_status(),
+            envoy::config::core::v3::HEALTHY);
+
+  // The endpoints of a new specifier are all reported.
+  message.reset(createSimpleMessage());
+  message->MergeFrom(*createComplexSpecifier(1, 1, 2));
+  hds_delegate_->onReceiveMessage(std::move(message));
+  response = hds_delegate_->sendResponse().endpoint_health_response();
+  EXPECT_EQ(response.endpoints_health_size(), 3);
+  ASSERT_EQ(response.cluster_endpoints_health_size(), 2);
+  const auto& cluster_health = response.cluster_endpoints_health(1);
+  EXPECT_EQ(cluster_health.locality_endpoints_health(0).endpoints_health_size(), 2);
+}
+
 // Check to see if two of the same specifier does not get parsed twice in a row.
 TEST_F(HdsTest, TestSameSpecifier) {
   EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
@@ -2933,6 +2933,60 @@ TEST_F(HttpHealthCheckerImplTest, GoAwayProbeInProgressStreamResetRuntimeDisable
   EXPECT_EQ(Host::Health::Healthy, cluster_->prioritySet().getMockHostSet(0)->hosts_[0]->health());
 }
 
+// The HTTP/2 health checks of the hosts of the same address in clusters sharing their connections
+// are sent as streams of a single connection.
+TEST_F(HttpHealthCheckerImplTest, SharedConnection) {
+  const std::string yaml = R"EOF(
+    timeout: 1s
+    interval: 1s
+    unhealthy_threshold: 1
+    healthy_threshold: 1
+    http_health_check:
+      path: /healthcheck
+      codec_client_type: Http2
+      share_connection: true
+    )EOF";
+  auto registry = std::make_shared<SharedHttpHealthCheckConnectionRegistry>();
+  allocHealthChecker(yaml);
+  addCompletionCallback();
+  health_checker_->shareConnections(registry, parseHealthCheckFromV3Yaml(yaml));
+  NiceMock<MockClusterMockPrioritySet> other_cluster;
+  auto other_health_checker = std::make_shared<TestHttpHealthCheckerImpl>(
+      other_cluster, parseHealthCheckFromV3Yaml(yaml), dispatcher_, runtime_, random_, nullptr);
+  other_health_checker->shareConnections(registry, parseHealthCheckFromV3Yaml(yaml));
+  EXPECT_CALL(*other_health_checker, createCodecClient_(_)).Times(0);
+
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80", simTime())};
+  other_cluster.prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(other_cluster.info_, "tcp://127.0.0.1:80", simTime())};
+
+  expectSessionCreate();
+  expectStreamCreate(0);
+  EXPECT_CALL(*test_sessions_[0]->timeout_timer_, enableTimer(_, _));
+  health_checker_->start();
+  EXPECT_EQ(1UL, registry->size());
+
+  // The health check of the other cluster is a second stream of the same connection.
+  auto* other_timeout_timer = new Event::MockTimer(&dispatcher_);
+  new Event::MockTimer(&dispatcher_);
+  NiceMock<Http::MockRequestEncoder> other_request_encoder;
+  Http::ResponseDecoder* other_response_decoder{};
+  EXPECT_CALL(*test_sessions_[0]->codec_, newStream(_))
+      .WillOnce(DoAll(SaveArgAddress(&other_response_decoder), ReturnRef(other_request_encoder)));
+  EXPECT_CALL(*other_timeout_timer, enableTimer(_, _));
+  other_health_checker->start();
+  EXPECT_EQ(1UL, registry->size());
+
+  expectUnchanged(0);
+  respond(0, "200", false);
+  EXPECT_CALL(*other_timeout_timer, disableTimer());
+  other_response_decoder->decodeHeaders(
+      Http::ResponseHeaderMapPtr{new Http::TestResponseHeaderMapImpl{{":status", "200"}}}, true);
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.success").value());
+  EXPECT_EQ(1UL, other_cluster.info_->stats_store_.counter("health_check.success").value());
+}
+
 class TestProdHttpHealthChecker : public ProdHttpHealthCheckerImpl {
 public:
   using ProdHttpHealthCheckerImpl::ProdHttpHealthCheckerImpl;
@@ -3916,6 +3970,96 @@ TEST_F(TcpHealthCheckerImplTest, ConnectionLocalFailure) {
   EXPECT_EQ(0UL, cluster_->info_->stats_store_.counter("health_check.passive_failure").value());
 }
 
+// The hosts of the same address in clusters sharing their health checks are health checked once,
+// by the session of the first cluster, and by the next one once it is removed.
+TEST_F(TcpHealthCheckerImplTest, SharedAcrossClusters) {
+  const std::string yaml = R"EOF(
+    timeout: 1s
+    interval: 1s
+    unhealthy_threshold: 2
+    healthy_threshold: 2
+    share_across_clusters: true
+    tcp_health_check:
+      send:
+        text: "01"
+      receive:
+      - text: "02"
+    )EOF";
+  auto registry = std::make_shared<HealthCheckSessionRegistry>();
+  allocHealthChecker(yaml);
+  health_checker_->shareSessions(registry, parseHealthCheckFromV3Yaml(yaml));
+  NiceMock<MockClusterMockPrioritySet> other_cluster;
+  auto other_health_checker = std::make_shared<TcpHealthCheckerImpl>(
+      other_cluster, parseHealthCheckFromV3Yaml(yaml), dispatcher_, runtime_, random_, nullptr);
+  other_health_checker->shareSessions(registry, parseHealthCheckFromV3Yaml(yaml));
+
+  HostSharedPtr host = makeTestHost(cluster_->info_, "tcp://127.0.0.1:80", simTime());
+  host->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {host};
+  HostSharedPtr other_host = makeTestHost(other_cluster.info_, "tcp://127.0.0.1:80", simTime());
+  other_host->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+  other_cluster.prioritySet().getMockHostSet(0)->hosts_ = {other_host};
+
+  expectSessionCreate();
+  expectClientCreate();
+  EXPECT_CALL(*connection_, write(_, _));
+  EXPECT_CALL(*timeout_timer_, enableTimer(_, _));
+  health_checker_->start();
+
+  // The session of the other cluster does not send health checks.
+  auto* other_interval_timer = new Event::MockTimer(&dispatcher_);
+  new Event::MockTimer(&dispatcher_);
+  EXPECT_CALL(*other_interval_timer, enableTimer(_, _)).Times(0);
+  other_health_checker->start();
+  const std::string key =
+      "127.0.0.1:80_" + std::to_string(MessageUtil::hash(parseHealthCheckFromV3Yaml(yaml)));
+  EXPECT_EQ(2UL, registry->size(key));
+
+  // The result is applied to the hosts of both clusters.
+  connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_CALL(event_logger_, logAddHealthy(_, _, true));
+  EXPECT_CALL(*timeout_timer_, disableTimer());
+  EXPECT_CALL(*interval_timer_, enableTimer(_, _));
+  Buffer::OwnedImpl response;
+  addUint8(response, 2);
+  read_filter_->onData(response, false);
+  EXPECT_FALSE(host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC));
+  EXPECT_FALSE(other_host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC));
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+  EXPECT_EQ(0UL, other_cluster.info_->stats_store_.counter("health_check.attempt").value());
+  EXPECT_EQ(1UL, other_cluster.info_->stats_store_.counter("health_check.success").value());
+
+  // Once the host is removed from the first cluster, the other cluster sends the health checks.
+  testing::Mock::VerifyAndClearExpectations(other_interval_timer);
+  EXPECT_CALL(*other_interval_timer, enableTimer(_, _));
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {};
+  cluster_->prioritySet().runUpdateCallbacks(0, {}, {host});
+
+  expectClientCreate();
+  EXPECT_CALL(*connection_, write(_, _));
+  other_interval_timer->invokeCallback();
+  EXPECT_EQ(1UL, other_cluster.info_->stats_store_.counter("health_check.attempt").value());
+}
+
+// The first health check of a host is delayed by a share of the interval.
+TEST_F(TcpHealthCheckerImplTest, InitialJitterPercent) {
+  allocHealthChecker(R"EOF(
+    timeout: 1s
+    interval: 1s
+    initial_jitter_percent: 50
+    unhealthy_threshold: 2
+    healthy_threshold: 2
+    tcp_health_check: {}
+    )EOF");
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80", simTime())};
+  expectSessionCreate();
+  EXPECT_CALL(dispatcher_, createClientConnection_(_, _, _, _)).Times(0);
+  EXPECT_CALL(random_, random()).WillOnce(Return(600));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(100), _));
+  health_checker_->start();
+}
+
 class TestGrpcHealthCheckerImpl : public GrpcHealthCheckerImpl {
 public:
   using GrpcHealthCheckerImpl::GrpcHealthCheckerImpl;
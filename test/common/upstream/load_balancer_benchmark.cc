@@ -16,6 +16,7 @@
 #include "test/mocks/upstream/cluster_info.h"
 #include "test/test_common/simulated_time_system.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
@@ -27,7 +28,9 @@ public:
   static constexpr absl::string_view metadata_key = "key";
   // We weight the first weighted_subset_percent of hosts with weight.
   BaseTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0,
-             bool attach_metadata = false) {
+             bool attach_metadata = false,
+             LoadBalancerType lb_type = LoadBalancerType::RoundRobin) {
+    info_->lb_type_ = lb_type;
     HostVector hosts;
     ASSERT(num_hosts < 65536);
     for (uint64_t i = 0; i < num_hosts; i++) {
@@ -81,7 +84,7 @@ public:
 
   void initialize() {
     lb_ = std::make_unique<RoundRobinLoadBalancer>(priority_set_, &local_priority_set_, stats_,
-                                                   runtime_, random_, common_config_);
+                                                   runtime_, random_, common_config_, simTime());
   }
 
   std::unique_ptr<RoundRobinLoadBalancer> lb_;
@@ -92,14 +95,28 @@ public:
   LeastRequestTester(uint64_t num_hosts, uint32_t choice_count) : BaseTester(num_hosts) {
     envoy::config::cluster::v3::Cluster::LeastRequestLbConfig lr_lb_config;
     lr_lb_config.mutable_choice_count()->set_value(choice_count);
-    lb_ =
-        std::make_unique<LeastRequestLoadBalancer>(priority_set_, &local_priority_set_, stats_,
-                                                   runtime_, random_, common_config_, lr_lb_config);
+    lb_ = std::make_unique<LeastRequestLoadBalancer>(priority_set_, &local_priority_set_, stats_,
+                                                     runtime_, random_, common_config_,
+                                                     lr_lb_config, simTime());
   }
 
   std::unique_ptr<LeastRequestLoadBalancer> lb_;
 };
 
+class PeakEwmaTester : public BaseTester {
+public:
+  PeakEwmaTester(uint64_t num_hosts, uint32_t choice_count)
+      : BaseTester(num_hosts, 0, 0, false, LoadBalancerType::PeakEwma) {
+    envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig peak_ewma_lb_config;
+    peak_ewma_lb_config.mutable_choice_count()->set_value(choice_count);
+    lb_ = std::make_unique<PeakEwmaLoadBalancer>(priority_set_, &local_priority_set_, stats_,
+                                                 runtime_, random_, common_config_,
+                                                 peak_ewma_lb_config, simTime());
+  }
+
+  std::unique_ptr<PeakEwmaLoadBalancer> lb_;
+};
+
 void benchmarkRoundRobinLoadBalancerBuild(::benchmark::State& state) {
   const uint64_t num_hosts = state.range(0);
   const uint64_t weighted_subset_percent = state.range(1);
@@ -147,6 +164,26 @@ BENCHMARK(benchmarkRoundRobinLoadBalancerBuild)
     ->Args({50000, 100, 50})
     ->Unit(::benchmark::kMillisecond);
 
+void benchmarkRoundRobinLoadBalancerChooseHostWeighted(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t weighted_subset_percent = state.range(1);
+  const uint64_t weight = state.range(2);
+  const uint64_t picks = 100000;
+
+  RoundRobinTester tester(num_hosts, weighted_subset_percent, weight);
+  tester.initialize();
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    for (uint64_t i = 0; i < picks; ++i) {
+      ::benchmark::DoNotOptimize(tester.lb_->chooseHost(nullptr));
+    }
+  }
+}
+BENCHMARK(benchmarkRoundRobinLoadBalancerChooseHostWeighted)
+    ->Args({100, 50, 50})
+    ->Args({10000, 50, 50})
+    ->Args({50000, 50, 50})
+    ->Unit(::benchmark::kMillisecond);
+
 class RingHashTester : public BaseTester {
 public:
   RingHashTester(uint64_t num_hosts, uint64_t min_ring_size) : BaseTester(num_hosts) {
@@ -162,8 +199,11 @@ public:
 
 class MaglevTester : public BaseTester {
 public:
-  MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0)
+  MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0,
+               uint64_t table_size = MaglevTable::DefaultTableSize)
       : BaseTester(num_hosts, weighted_subset_percent, weight) {
+    config_ = envoy::config::cluster::v3::Cluster::MaglevLbConfig();
+    config_.value().mutable_table_size()->set_value(table_size);
     maglev_lb_ = std::make_unique<MaglevLoadBalancer>(priority_set_, stats_, stats_store_, runtime_,
                                                       random_, config_, common_config_);
   }
@@ -209,7 +249,8 @@ void benchmarkMaglevLoadBalancerBuildTable(::benchmark::State& state) {
   for (auto _ : state) { // NOLINT: Silences warning about dead store
     state.PauseTiming();
     const uint64_t num_hosts = state.range(0);
-    MaglevTester tester(num_hosts);
+    const uint64_t table_size = state.range(1);
+    MaglevTester tester(num_hosts, 0, 0, table_size);
 
     const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
 
@@ -224,9 +265,13 @@ void benchmarkMaglevLoadBalancerBuildTable(::benchmark::State& state) {
   }
 }
 BENCHMARK(benchmarkMaglevLoadBalancerBuildTable)
-    ->Arg(100)
-    ->Arg(200)
-    ->Arg(500)
+    ->Args({100, MaglevTable::DefaultTableSize})
+    ->Args({200, MaglevTable::DefaultTableSize})
+    ->Args({500, MaglevTable::DefaultTableSize})
+    ->Args({5000, MaglevTable::DefaultTableSize})
+    ->Args({500, 1000003})
+    ->Args({5000, 1000003})
+    ->Args({5000, 5000011})
     ->Unit(::benchmark::kMillisecond);
 
 class TestLoadBalancerContext : public LoadBalancerContextBase {
@@ -299,6 +344,53 @@ BENCHMARK(benchmarkLeastRequestLoadBalancerChooseHost)
     ->Args({100, 100, 1000000})
     ->Unit(::benchmark::kMillisecond);
 
+// Every tenth host is ten times slower than the others. The slow_host_share counter is the
+// fraction of picks which went to a slow host; it is 10% for a latency unaware load balancer.
+void benchmarkPeakEwmaLoadBalancerChooseHost(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t choice_count = state.range(1);
+  const uint64_t keys_to_simulate = state.range(2);
+
+  if (benchmark::skipExpensiveBenchmarks() && keys_to_simulate > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    PeakEwmaTester tester(num_hosts, choice_count);
+    absl::flat_hash_set<const Host*> slow_hosts;
+    const HostVector& hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+    for (uint64_t i = 0; i < hosts.size(); ++i) {
+      const bool slow = i % 10 == 0;
+      hosts[i]->responseTimeTracker()->putResponseTime(
+          std::chrono::microseconds(slow ? 10000 : 1000));
+      if (slow) {
+        slow_hosts.insert(hosts[i].get());
+      }
+    }
+    uint64_t slow_picks = 0;
+    TestLoadBalancerContext context;
+    state.ResumeTiming();
+
+    for (uint64_t i = 0; i < keys_to_simulate; ++i) {
+      slow_picks += slow_hosts.contains(tester.lb_->chooseHost(&context).get());
+    }
+
+    state.PauseTiming();
+    state.counters["slow_host_share"] = static_cast<double>(slow_picks) / keys_to_simulate;
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(benchmarkPeakEwmaLoadBalancerChooseHost)
+    ->Args({100, 2, 1000})
+    ->Args({100, 3, 1000})
+    ->Args({100, 10, 1000})
+    ->Args({100, 2, 1000000})
+    ->Args({100, 3, 1000000})
+    ->Args({100, 10, 1000000})
+    ->Unit(::benchmark::kMillisecond);
+
 void benchmarkRingHashLoadBalancerChooseHost(::benchmark::State& state) {
   for (auto _ : state) { // NOLINT: Silences warning about dead store
     // Do not time the creation of the ring.
@@ -544,7 +636,7 @@ public:
     lb_ = std::make_unique<SubsetLoadBalancer>(LoadBalancerType::Random, priority_set_,
                                                &local_priority_set_, stats_, stats_store_, runtime_,
                                                random_, *subset_info_, absl::nullopt, absl::nullopt,
-                                               absl::nullopt, common_config_);
+                                               absl::nullopt, common_config_, simTime());
 
     const HostVector& hosts = priority_set_.getOrCreateHostSet(0).hosts();
     ASSERT(hosts.size() == num_hosts);
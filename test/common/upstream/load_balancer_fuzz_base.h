@@ -46,6 +46,7 @@ public:
   ClusterStats stats_;
   NiceMock<Runtime::MockLoader> runtime_;
   Random::PsuedoRandomGenerator64 random_;
+  NiceMock<MockTimeSystem> time_source_;
   NiceMock<MockPrioritySet> priority_set_;
   std::unique_ptr<LoadBalancer> lb_;
 
@@ -548,7 +548,7 @@ public:
       local_priority_set_->getOrCreateHostSet(0);
     }
     lb_ = std::make_shared<RoundRobinLoadBalancer>(priority_set_, local_priority_set_.get(), stats_,
-                                                   runtime_, random_, common_config_);
+                                                   runtime_, random_, common_config_, simTime());
   }
 
   // Updates priority 0 with the given hosts and hosts_per_locality.
@@ -1454,13 +1454,78 @@ TEST_P(RoundRobinLoadBalancerTest, NoZoneAwareRoutingNoLocalLocality) {
   EXPECT_EQ(1U, stats_.lb_local_cluster_not_ok_.value());
 }
 
+// A new host gets a share of the traffic which grows over its slow start window, from the minimum
+// weight to its full weight.
+TEST_P(RoundRobinLoadBalancerTest, SlowStartRampsUpNewHost) {
+  common_config_.mutable_slow_start_config()->mutable_slow_start_window()->set_seconds(10);
+  HostSharedPtr old_host = makeTestHost(info_, "tcp://127.0.0.1:80", simTime());
+  simTime().advanceTimeWait(std::chrono::seconds(20));
+  HostSharedPtr new_host = makeTestHost(info_, "tcp://127.0.0.1:81", simTime());
+  hostSet().healthy_hosts_ = {old_host, new_host};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  init(false);
+
+  const auto new_host_picks = [this, &new_host](uint32_t picks) {
+    uint32_t new_host_picks = 0;
+    for (uint32_t i = 0; i < picks; ++i) {
+      if (lb_->chooseHost(nullptr) == new_host) {
+        ++new_host_picks;
+      }
+    }
+    return new_host_picks;
+  };
+
+  // 10% of its weight at first.
+  EXPECT_NEAR(10, new_host_picks(110), 1);
+  // Half of it halfway through the window.
+  simTime().advanceTimeWait(std::chrono::seconds(5));
+  EXPECT_NEAR(30, new_host_picks(90), 1);
+  // All of it once the window elapsed, which is plain round robin again.
+  simTime().advanceTimeWait(std::chrono::seconds(5));
+  EXPECT_EQ(50U, new_host_picks(100));
+}
+
+// The slow start window of a host starts over when it passes a health check after failing them,
+// and the aggression shapes the ramp up.
+TEST_P(RoundRobinLoadBalancerTest, SlowStartAfterPassingHealthCheck) {
+  auto* slow_start_config = common_config_.mutable_slow_start_config();
+  slow_start_config->mutable_slow_start_window()->set_seconds(10);
+  slow_start_config->mutable_aggression()->set_runtime_key("slow_start_aggression");
+  slow_start_config->mutable_aggression()->set_default_value(2.0);
+  slow_start_config->mutable_min_weight_percent()->set_value(20);
+  EXPECT_CALL(runtime_.snapshot_, getDouble("slow_start_aggression", 2.0))
+      .WillRepeatedly(Return(2.0));
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime())};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  simTime().advanceTimeWait(std::chrono::seconds(20));
+  hostSet().healthy_hosts_[1]->setLastHcPassTime(simTime().monotonicTime());
+  init(false);
+
+  const auto second_host_picks = [this](uint32_t picks) {
+    uint32_t second_host_picks = 0;
+    for (uint32_t i = 0; i < picks; ++i) {
+      if (lb_->chooseHost(nullptr) == hostSet().healthy_hosts_[1]) {
+        ++second_host_picks;
+      }
+    }
+    return second_host_picks;
+  };
+
+  // The minimum weight of 20% at first.
+  EXPECT_NEAR(10, second_host_picks(60), 1);
+  // A quarter through the window, the weight is sqrt(0.25) = 50%.
+  simTime().advanceTimeWait(std::chrono::milliseconds(2500));
+  EXPECT_NEAR(30, second_host_picks(90), 1);
+}
+
 INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, RoundRobinLoadBalancerTest,
                          ::testing::Values(true, false));
 
 class LeastRequestLoadBalancerTest : public LoadBalancerTestBase {
 public:
-  LeastRequestLoadBalancer lb_{
-      priority_set_, nullptr, stats_, runtime_, random_, common_config_, least_request_lb_config_};
+  LeastRequestLoadBalancer lb_{priority_set_, nullptr, stats_, runtime_, random_, common_config_,
+                               least_request_lb_config_, simTime()};
 };
 
 TEST_P(LeastRequestLoadBalancerTest, NoHosts) { EXPECT_EQ(nullptr, lb_.chooseHost(nullptr)); }
@@ -1537,11 +1602,11 @@ TEST_P(LeastRequestLoadBalancerTest, PNC) {
   // Creating various load balancer objects with different choice configs.
   envoy::config::cluster::v3::Cluster::LeastRequestLbConfig lr_lb_config;
   lr_lb_config.mutable_choice_count()->set_value(2);
-  LeastRequestLoadBalancer lb_2{priority_set_, nullptr,        stats_,      runtime_,
-                                random_,       common_config_, lr_lb_config};
+  LeastRequestLoadBalancer lb_2{priority_set_, nullptr,        stats_,       runtime_,
+                                random_,       common_config_, lr_lb_config, simTime()};
   lr_lb_config.mutable_choice_count()->set_value(5);
-  LeastRequestLoadBalancer lb_5{priority_set_, nullptr,        stats_,      runtime_,
-                                random_,       common_config_, lr_lb_config};
+  LeastRequestLoadBalancer lb_5{priority_set_, nullptr,        stats_,       runtime_,
+                                random_,       common_config_, lr_lb_config, simTime()};
 
   // Verify correct number of choices.
 
@@ -1617,8 +1682,8 @@ TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceWithInvalidActiveRequestBias
   envoy::config::cluster::v3::Cluster::LeastRequestLbConfig lr_lb_config;
   lr_lb_config.mutable_active_request_bias()->set_runtime_key("ar_bias");
   lr_lb_config.mutable_active_request_bias()->set_default_value(1.0);
-  LeastRequestLoadBalancer lb_2{priority_set_, nullptr,        stats_,      runtime_,
-                                random_,       common_config_, lr_lb_config};
+  LeastRequestLoadBalancer lb_2{priority_set_, nullptr,        stats_,       runtime_,
+                                random_,       common_config_, lr_lb_config, simTime()};
 
   EXPECT_CALL(runtime_.snapshot_, getDouble("ar_bias", 1.0)).WillRepeatedly(Return(-1.0));
 
@@ -1671,8 +1736,8 @@ TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceWithCustomActiveRequestBias)
   envoy::config::cluster::v3::Cluster::LeastRequestLbConfig lr_lb_config;
   lr_lb_config.mutable_active_request_bias()->set_runtime_key("ar_bias");
   lr_lb_config.mutable_active_request_bias()->set_default_value(1.0);
-  LeastRequestLoadBalancer lb_2{priority_set_, nullptr,        stats_,      runtime_,
-                                random_,       common_config_, lr_lb_config};
+  LeastRequestLoadBalancer lb_2{priority_set_, nullptr,        stats_,       runtime_,
+                                random_,       common_config_, lr_lb_config, simTime()};
 
   EXPECT_CALL(runtime_.snapshot_, getDouble("ar_bias", 1.0)).WillRepeatedly(Return(0.0));
 
@@ -1720,6 +1785,106 @@ TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceCallbacks) {
 INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, LeastRequestLoadBalancerTest,
                          ::testing::Values(true, false));
 
+class PeakEwmaLoadBalancerTest : public LoadBalancerTestBase {
+public:
+  PeakEwmaLoadBalancerTest() { info_->lb_type_ = LoadBalancerType::PeakEwma; }
+
+  void initHosts(uint32_t weight_0 = 1, uint32_t weight_1 = 1) {
+    hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), weight_0),
+                                makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), weight_1)};
+    stats_.max_host_weight_.set(std::max(weight_0, weight_1));
+    hostSet().hosts_ = hostSet().healthy_hosts_;
+    hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+  }
+
+  void putResponseTime(uint32_t host, uint64_t us) {
+    hostSet().healthy_hosts_[host]->responseTimeTracker()->putResponseTime(
+        std::chrono::microseconds(us));
+  }
+
+  // Picks with the two choices landing on hosts 0 and 1.
+  HostConstSharedPtr chooseHost() {
+    EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(2)).WillOnce(Return(3));
+    return lb_.chooseHost(nullptr);
+  }
+
+  absl::optional<envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig> peak_ewma_lb_config_;
+  PeakEwmaLoadBalancer lb_{priority_set_, nullptr, stats_, runtime_, random_, common_config_,
+                           peak_ewma_lb_config_, simTime()};
+};
+
+TEST_P(PeakEwmaLoadBalancerTest, NoHosts) { EXPECT_EQ(nullptr, lb_.chooseHost(nullptr)); }
+
+TEST_P(PeakEwmaLoadBalancerTest, PrefersFasterHost) {
+  initHosts();
+  putResponseTime(0, 1000);
+  putResponseTime(1, 100);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], chooseHost());
+
+  // A slow response raises the estimate immediately.
+  putResponseTime(1, 5000);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], chooseHost());
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, ActiveRequestsScaleCost) {
+  initHosts();
+  putResponseTime(0, 100);
+  putResponseTime(1, 1000);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], chooseHost());
+
+  // 100us * (20 + 1) is more expensive than 1000us * (0 + 1).
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(20);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], chooseHost());
+  EXPECT_DOUBLE_EQ(2100, PeakEwmaLoadBalancer::hostCost(*hostSet().healthy_hosts_[0]));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, UnknownResponseTime) {
+  initHosts();
+  putResponseTime(1, 100);
+
+  // An idle host without a response time is probed first.
+  EXPECT_EQ(hostSet().healthy_hosts_[0], chooseHost());
+
+  // Once it has active requests it is ranked below the hosts with a response time.
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(1);
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(100);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], chooseHost());
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, NoTrackerWithOtherLbType) {
+  info_->lb_type_ = LoadBalancerType::LeastRequest;
+  HostSharedPtr host = makeTestHost(info_, "tcp://127.0.0.1:80", simTime());
+  EXPECT_EQ(nullptr, host->responseTimeTracker());
+  host->stats().rq_active_.set(2);
+  EXPECT_DOUBLE_EQ(1e15 + 2, PeakEwmaLoadBalancer::hostCost(*host));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, WeightImbalance) {
+  initHosts(1, 2);
+  putResponseTime(0, 100);
+  putResponseTime(1, 100);
+
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(0));
+
+  // Equal costs give the 2:1 ratio of the host weights.
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+
+  // A host twice as slow cancels out twice the weight, giving a 1:1 ratio.
+  putResponseTime(1, 200);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+}
+
+INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, PeakEwmaLoadBalancerTest,
+                         ::testing::Values(true, false));
+
 class RandomLoadBalancerTest : public LoadBalancerTestBase {
 public:
   void init() {
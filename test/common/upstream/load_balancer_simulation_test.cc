@@ -77,8 +77,8 @@ TEST(DISABLED_LeastRequestLoadBalancerWeightTest, Weight) {
   Random::RandomGeneratorImpl random;
   envoy::config::cluster::v3::Cluster::LeastRequestLbConfig least_request_lb_config;
   envoy::config::cluster::v3::Cluster::CommonLbConfig common_config;
-  LeastRequestLoadBalancer lb_{
-      priority_set, nullptr, stats, runtime, random, common_config, least_request_lb_config};
+  LeastRequestLoadBalancer lb_{priority_set, nullptr, stats, runtime, random, common_config,
+                               least_request_lb_config, time_source_};
 
   absl::node_hash_map<HostConstSharedPtr, uint64_t> host_hits;
   const uint64_t total_requests = 100;
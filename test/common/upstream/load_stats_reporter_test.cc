@@ -3,8 +3,11 @@
 #include "envoy/config/endpoint/v3/load_report.pb.h"
 #include "envoy/service/load_stats/v3/lrs.pb.h"
 
+#include "source/common/network/utility.h"
 #include "source/common/upstream/load_stats_reporter.h"
+#include "source/common/upstream/upstream_impl.h"
 
+#include "test/common/upstream/utility.h"
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/grpc/mocks.h"
 #include "test/mocks/local_info/mocks.h"
@@ -222,6 +225,86 @@ TEST_F(LoadStatsReporterTest, ExistingClusters) {
   response_timer_cb_();
 }
 
+// Validate that the load of the hosts is reported per locality.
+TEST_F(LoadStatsReporterTest, LocalityLoad) {
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage({});
+  createLoadStatsReporter();
+  time_system_.setMonotonicTime(std::chrono::microseconds(3));
+  NiceMock<MockClusterMockPrioritySet> foo_cluster;
+  const auto locality_a = Locality("region", "a", "");
+  const auto locality_b = Locality("region", "b", "");
+  auto make_host = [this, &foo_cluster](const std::string& url,
+                                        const envoy::config::core::v3::Locality& locality,
+                                        uint32_t priority) -> HostSharedPtr {
+    return std::make_shared<HostImpl>(
+        foo_cluster.info_, "", Network::Utility::resolveUrl(url), nullptr, 1, locality,
+        envoy::config::endpoint::v3::Endpoint::HealthCheckConfig::default_instance(), priority,
+        envoy::config::core::v3::UNKNOWN, time_system_);
+  };
+  HostSharedPtr a1 = make_host("tcp://127.0.0.1:80", locality_a, 0);
+  HostSharedPtr a2 = make_host("tcp://127.0.0.2:80", locality_a, 0);
+  HostSharedPtr b1 = make_host("tcp://127.0.0.3:80", locality_b, 0);
+  HostSharedPtr a3 = make_host("tcp://127.0.0.4:80", locality_a, 1);
+  foo_cluster.priority_set_.getMockHostSet(0)->hosts_per_locality_ =
+      makeHostsPerLocality({{a1, a2}, {b1}});
+  foo_cluster.priority_set_.getMockHostSet(1)->hosts_per_locality_ = makeHostsPerLocality({{a3}});
+  MockClusterManager::ClusterInfoMaps cluster_info{{{"foo", foo_cluster}}, {}};
+  ON_CALL(cm_, clusters()).WillByDefault(Return(cluster_info));
+
+  // The load from before the cluster is tracked is not reported.
+  a1->stats().incRqSuccess();
+  deliverLoadStatsResponse({"foo"});
+
+  a1->stats().incRqTotal();
+  a1->stats().incRqSuccess();
+  a2->stats().incRqTotal();
+  a2->stats().incRqError();
+  b1->stats().incRqTotal();
+  b1->stats().incRqActive();
+  // A locality with hosts at several priorities is reported at the first of them.
+  a3->stats().incRqTotal();
+  a3->stats().incRqSuccess();
+  time_system_.setMonotonicTime(std::chrono::microseconds(4));
+  {
+    envoy::config::endpoint::v3::ClusterStats foo_cluster_stats;
+    foo_cluster_stats.set_cluster_name("foo");
+    auto* a_stats = foo_cluster_stats.add_upstream_locality_stats();
+    a_stats->mutable_locality()->MergeFrom(locality_a);
+    a_stats->set_total_successful_requests(2);
+    a_stats->set_total_error_requests(1);
+    a_stats->set_total_issued_requests(3);
+    auto* b_stats = foo_cluster_stats.add_upstream_locality_stats();
+    b_stats->mutable_locality()->MergeFrom(locality_b);
+    b_stats->set_total_requests_in_progress(1);
+    b_stats->set_total_issued_requests(1);
+    foo_cluster_stats.mutable_load_report_interval()->MergeFrom(
+        Protobuf::util::TimeUtil::MicrosecondsToDuration(1));
+    expectSendMessage({foo_cluster_stats});
+  }
+  EXPECT_CALL(*response_timer_, enableTimer(std::chrono::milliseconds(42000), _));
+  response_timer_cb_();
+
+  // The counters are latched by each report, while the requests in progress are still reported.
+  b1->stats().decRqActive();
+  b1->stats().incRqSuccess();
+  time_system_.setMonotonicTime(std::chrono::microseconds(6));
+  {
+    envoy::config::endpoint::v3::ClusterStats foo_cluster_stats;
+    foo_cluster_stats.set_cluster_name("foo");
+    auto* b_stats = foo_cluster_stats.add_upstream_locality_stats();
+    b_stats->mutable_locality()->MergeFrom(locality_b);
+    b_stats->set_total_successful_requests(1);
+    foo_cluster_stats.mutable_load_report_interval()->MergeFrom(
+        Protobuf::util::TimeUtil::MicrosecondsToDuration(2));
+    expectSendMessage({foo_cluster_stats});
+  }
+  EXPECT_CALL(*response_timer_, enableTimer(std::chrono::milliseconds(42000), _));
+  response_timer_cb_();
+  EXPECT_EQ(2, a1->stats().rq_success_.value());
+  EXPECT_EQ(0, b1->stats().rq_active_.value());
+}
+
 // Validate that the client can recover from a remote stream closure via retry.
 TEST_F(LoadStatsReporterTest, RemoteStreamClose) {
   EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
@@ -0,0 +1,161 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/config/core/v3/config_source.pb.h"
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/common/upstream/od_cds_api_impl.h"
+
+#include "test/mocks/protobuf/mocks.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::InSequence;
+using testing::Return;
+using testing::UnorderedElementsAre;
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+MATCHER_P(WithName, expectedName, "") { return arg.name() == expectedName; }
+
+class MockMissingClusterNotifier : public MissingClusterNotifier {
+public:
+  MOCK_METHOD(void, notifyMissingCluster, (absl::string_view name));
+};
+
+class OdCdsApiImplTest : public testing::Test {
+protected:
+  void setup(std::chrono::milliseconds negative_cache_ttl = std::chrono::seconds(30)) {
+    envoy::config::core::v3::ConfigSource odcds_config;
+    odcds_ = OdCdsApiImpl::create(odcds_config, negative_cache_ttl, cm_, notifier_, store_,
+                                  time_system_, validation_visitor_);
+    odcds_callbacks_ = cm_.subscription_factory_.callbacks_;
+  }
+
+  // Tells that the discovery service does not know the clusters.
+  void removeClusters(const std::vector<std::string>& names) {
+    Protobuf::RepeatedPtrField<std::string> removed;
+    for (const auto& name : names) {
+      *removed.Add() = name;
+      EXPECT_CALL(notifier_, notifyMissingCluster(absl::string_view(name)));
+    }
+    odcds_callbacks_->onConfigUpdate({}, removed, "");
+  }
+
+  uint64_t negativeCacheSize() {
+    return TestUtility::findGauge(store_, "cluster_manager.odcds.negative_cache_size")->value();
+  }
+
+  NiceMock<MockClusterManager> cm_;
+  MockMissingClusterNotifier notifier_;
+  Stats::IsolatedStoreImpl store_;
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<ProtobufMessage::MockValidationVisitor> validation_visitor_;
+  OdCdsApiImplPtr odcds_;
+  Config::SubscriptionCallbacks* odcds_callbacks_{};
+};
+
+// The subscription is started with the first cluster requested, and the others are requested on
+// demand.
+TEST_F(OdCdsApiImplTest, StartsSubscriptionWithFirstRequest) {
+  InSequence s;
+  setup();
+
+  EXPECT_CALL(*cm_.subscription_factory_.subscription_, start(UnorderedElementsAre("cluster_1")));
+  odcds_->updateOnDemand("cluster_1");
+  EXPECT_CALL(*cm_.subscription_factory_.subscription_, start(_)).Times(0);
+  EXPECT_CALL(*cm_.subscription_factory_.subscription_,
+              requestOnDemandUpdate(UnorderedElementsAre("cluster_2")));
+  odcds_->updateOnDemand("cluster_2");
+  EXPECT_EQ(2, TestUtility::findCounter(store_, "cluster_manager.odcds.cluster_discovery_requested")
+                   ->value());
+}
+
+// The received clusters are added to the cluster manager.
+TEST_F(OdCdsApiImplTest, AddsReceivedClusters) {
+  setup();
+
+  envoy::config::cluster::v3::Cluster cluster;
+  cluster.set_name("cluster_1");
+  EXPECT_CALL(cm_, addOrUpdateCluster(WithName("cluster_1"), "v1")).WillOnce(Return(true));
+  const auto decoded_resources = TestUtility::decodeResources({cluster});
+  odcds_callbacks_->onConfigUpdate(decoded_resources.refvec_, {}, "v1");
+}
+
+// The clusters the discovery service does not know are missing until the TTL of the negative cache
+// expires.
+TEST_F(OdCdsApiImplTest, RemovedClustersAreMissingUntilTtlExpires) {
+  setup();
+
+  EXPECT_FALSE(odcds_->isMissing("cluster_1"));
+  removeClusters({"cluster_1"});
+  EXPECT_TRUE(odcds_->isMissing("cluster_1"));
+  EXPECT_EQ(1, negativeCacheSize());
+  EXPECT_EQ(1, TestUtility::findCounter(store_, "cluster_manager.odcds.cluster_missing")->value());
+
+  time_system_.setMonotonicTime(time_system_.monotonicTime() + std::chrono::seconds(29));
+  EXPECT_TRUE(odcds_->isMissing("cluster_1"));
+  time_system_.setMonotonicTime(time_system_.monotonicTime() + std::chrono::seconds(1));
+  EXPECT_FALSE(odcds_->isMissing("cluster_1"));
+  EXPECT_EQ(0, negativeCacheSize());
+}
+
+// A cluster received after it was missing is no longer missing.
+TEST_F(OdCdsApiImplTest, ReceivedClusterLeavesNegativeCache) {
+  setup();
+
+  removeClusters({"cluster_1"});
+  EXPECT_TRUE(odcds_->isMissing("cluster_1"));
+
+  envoy::config::cluster::v3::Cluster cluster;
+  cluster.set_name("cluster_1");
+  EXPECT_CALL(cm_, addOrUpdateCluster(WithName("cluster_1"), "v1")).WillOnce(Return(true));
+  const auto decoded_resources = TestUtility::decodeResources({cluster});
+  odcds_callbacks_->onConfigUpdate(decoded_resources.refvec_, {}, "v1");
+  EXPECT_FALSE(odcds_->isMissing("cluster_1"));
+  EXPECT_EQ(0, negativeCacheSize());
+}
+
+// The expired clusters are dropped from the negative cache as others are added to it.
+TEST_F(OdCdsApiImplTest, ExpiredClustersAreDropped) {
+  setup();
+
+  removeClusters({"cluster_1", "cluster_2"});
+  EXPECT_EQ(2, negativeCacheSize());
+  time_system_.setMonotonicTime(time_system_.monotonicTime() + std::chrono::seconds(30));
+  removeClusters({"cluster_3"});
+  EXPECT_EQ(1, negativeCacheSize());
+  EXPECT_TRUE(odcds_->isMissing("cluster_3"));
+}
+
+// A zero TTL disables the negative cache, the missing clusters still being notified.
+TEST_F(OdCdsApiImplTest, ZeroTtlDisablesNegativeCache) {
+  setup(std::chrono::milliseconds(0));
+
+  removeClusters({"cluster_1"});
+  EXPECT_FALSE(odcds_->isMissing("cluster_1"));
+  EXPECT_EQ(0, negativeCacheSize());
+}
+
+// The negative cache statistics are released with the subscription.
+TEST_F(OdCdsApiImplTest, DestructionReleasesNegativeCacheSize) {
+  setup();
+
+  removeClusters({"cluster_1", "cluster_2"});
+  EXPECT_EQ(2, negativeCacheSize());
+  odcds_.reset();
+  EXPECT_EQ(0, negativeCacheSize());
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,152 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures how original destination clusters add the hosts created by the workers, for a number
+// of destinations and of hosts created before each time the main thread gets to add them.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/stats/scope.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/http/headers.h"
+#include "source/common/singleton/manager_impl.h"
+#include "source/common/upstream/original_dst_cluster.h"
+#include "source/server/transport_socket_config_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/protobuf/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/server/admin.h"
+#include "test/mocks/server/instance.h"
+#include "test/mocks/server/options.h"
+#include "test/mocks/ssl/mocks.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class HeaderLoadBalancerContext : public LoadBalancerContextBase {
+public:
+  HeaderLoadBalancerContext(const std::string& destination)
+      : headers_{{Http::Headers::get().EnvoyOriginalDstHost.get(), destination}} {}
+
+  // Upstream::LoadBalancerContext
+  const Http::RequestHeaderMap* downstreamHeaders() const override { return &headers_; }
+
+  Http::TestRequestHeaderMapImpl headers_;
+};
+
+class OriginalDstClusterSpeedTest {
+public:
+  OriginalDstClusterSpeedTest() : api_(Api::createApiForTest(stats_store_)) {
+    ON_CALL(dispatcher_, post(_)).WillByDefault(Invoke([this](Event::PostCb cb) -> void {
+      posts_.push_back(std::move(cb));
+    }));
+
+    const auto cluster_config = parseClusterFromV3Yaml(R"EOF(
+      name: name
+      connect_timeout: 0.25s
+      type: ORIGINAL_DST
+      lb_policy: CLUSTER_PROVIDED
+      original_dst_lb_config:
+        use_http_header: true
+    )EOF");
+    Stats::ScopePtr scope = stats_store_.createScope("cluster.name.");
+    Server::Configuration::TransportSocketFactoryContextImpl factory_context(
+        admin_, ssl_context_manager_, *scope, cm_, local_info_, dispatcher_, stats_store_,
+        singleton_manager_, tls_, validation_visitor_, *api_, options_);
+    cluster_ = std::make_shared<OriginalDstCluster>(cluster_config, runtime_, factory_context,
+                                                    std::move(scope), false);
+  }
+
+  // Creates a host on a worker for each of the contexts, then lets the main thread add them.
+  void addHosts(const std::vector<std::unique_ptr<HeaderLoadBalancerContext>>& contexts,
+                size_t first, size_t count) {
+    OriginalDstCluster::LoadBalancer lb(cluster_);
+    for (size_t i = first; i < first + count; i++) {
+      ::benchmark::DoNotOptimize(lb.chooseHost(contexts[i].get()));
+    }
+    std::vector<Event::PostCb> posts;
+    posts.swap(posts_);
+    for (const auto& post : posts) {
+      post();
+    }
+  }
+
+  size_t hosts() const { return cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size(); }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  Ssl::MockContextManager ssl_context_manager_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<MockClusterManager> cm_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<LocalInfo::MockLocalInfo> local_info_;
+  NiceMock<Server::MockAdmin> admin_;
+  Singleton::ManagerImpl singleton_manager_{Thread::threadFactoryForTest()};
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  NiceMock<ProtobufMessage::MockValidationVisitor> validation_visitor_;
+  Api::ApiPtr api_;
+  Server::MockOptions options_;
+  std::vector<Event::PostCb> posts_;
+  OriginalDstClusterSharedPtr cluster_;
+};
+
+// Adds state.range(0) destinations to a cluster, state.range(1) of them created by the workers
+// each time before the main thread adds them.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_AddDestinations(::benchmark::State& state) {
+  const size_t destinations = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && destinations > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  const size_t batch_size = state.range(1);
+
+  std::vector<std::unique_ptr<HeaderLoadBalancerContext>> contexts;
+  for (size_t i = 0; i < destinations; i++) {
+    contexts.push_back(std::make_unique<HeaderLoadBalancerContext>(
+        absl::StrCat("10.", (i >> 16) & 0xff, ".", (i >> 8) & 0xff, ".", i & 0xff, ":80")));
+  }
+
+  for (auto _ : state) { // NOLINT
+    state.PauseTiming();
+    auto speed_test = std::make_unique<OriginalDstClusterSpeedTest>();
+    state.ResumeTiming();
+
+    for (size_t first = 0; first < destinations; first += batch_size) {
+      speed_test->addHosts(contexts, first, std::min(batch_size, destinations - first));
+    }
+
+    state.PauseTiming();
+    ASSERT(speed_test->hosts() == destinations);
+    speed_test.reset();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_AddDestinations)
+    ->Args({1000, 1})
+    ->Args({1000, 100})
+    ->Args({10000, 1})
+    ->Args({10000, 100})
+    ->Args({100000, 1000})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
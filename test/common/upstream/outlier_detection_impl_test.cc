@@ -1,5 +1,6 @@
 #include <chrono>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -108,6 +109,12 @@ public:
     }
   }
 
+  void loadResponseTimes(HostSharedPtr host, int num_rq, std::chrono::milliseconds response_time) {
+    for (int i = 0; i < num_rq; i++) {
+      host->outlierDetector().putResponseTime(response_time);
+    }
+  }
+
   NiceMock<MockClusterMockPrioritySet> cluster_;
   HostVector& hosts_ = cluster_.prioritySet().getMockHostSet(0)->hosts_;
   HostVector& failover_hosts_ = cluster_.prioritySet().getMockHostSet(1)->hosts_;
@@ -1311,6 +1318,104 @@ TEST_F(OutlierDetectorImplTest, BasicFlowFailurePercentageLocalOrigin) {
                     DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin));
 }
 
+TEST_F(OutlierDetectorImplTest, BasicFlowLatency) {
+  EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
+  addHosts({
+      "tcp://127.0.0.1:80",
+      "tcp://127.0.0.1:81",
+      "tcp://127.0.0.1:82",
+      "tcp://127.0.0.1:83",
+      "tcp://127.0.0.1:84",
+  });
+
+  envoy::config::cluster::v3::OutlierDetection outlier_detection;
+  outlier_detection.mutable_latency_threshold_factor()->set_value(300);
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  std::shared_ptr<DetectorImpl> detector(DetectorImpl::create(
+      cluster_, outlier_detection, dispatcher_, runtime_, time_system_, event_logger_));
+  detector->addChangedStateCb([&](HostSharedPtr host) -> void { checker_.check(host); });
+
+  // The last host is 5 times slower than the others.
+  for (size_t i = 0; i < 4; i++) {
+    loadResponseTimes(hosts_[i], 100, std::chrono::milliseconds(10));
+  }
+  loadResponseTimes(hosts_[4], 100, std::chrono::milliseconds(50));
+
+  time_system_.setMonotonicTime(std::chrono::milliseconds(10000));
+  EXPECT_CALL(checker_, check(hosts_[4]));
+  EXPECT_CALL(*event_logger_, logEject(std::static_pointer_cast<const HostDescription>(hosts_[4]),
+                                       _, envoy::data::cluster::v3::LATENCY, true));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  interval_timer_->invokeCallback();
+  // The percentiles are the upper bounds of the buckets of the response times.
+  EXPECT_EQ(11, hosts_[0]->outlierDetector().latency());
+  EXPECT_EQ(52, hosts_[4]->outlierDetector().latency());
+  EXPECT_EQ(11, detector->latencyMedian());
+  EXPECT_EQ(33, detector->latencyEjectionThreshold());
+  EXPECT_TRUE(hosts_[4]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  EXPECT_EQ(1UL, outlier_detection_ejections_active_.value());
+  EXPECT_EQ(1UL, cluster_.info_->stats_store_
+                     .counter("outlier_detection.ejections_detected_latency")
+                     .value());
+  EXPECT_EQ(1UL, cluster_.info_->stats_store_
+                     .counter("outlier_detection.ejections_enforced_latency")
+                     .value());
+
+  // Interval that does bring the host back in.
+  time_system_.setMonotonicTime(std::chrono::milliseconds(40001));
+  EXPECT_CALL(checker_, check(hosts_[4]));
+  EXPECT_CALL(*event_logger_,
+              logUneject(std::static_pointer_cast<const HostDescription>(hosts_[4])));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  interval_timer_->invokeCallback();
+  EXPECT_FALSE(hosts_[4]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  // There were no requests in the last interval.
+  EXPECT_EQ(-1, hosts_[0]->outlierDetector().latency());
+  EXPECT_EQ(-1, detector->latencyMedian());
+  EXPECT_EQ(-1, detector->latencyEjectionThreshold());
+
+  // Not enough request volume on the slow host, which leaves too few hosts to compare.
+  for (size_t i = 0; i < 4; i++) {
+    loadResponseTimes(hosts_[i], 100, std::chrono::milliseconds(10));
+  }
+  loadResponseTimes(hosts_[4], 99, std::chrono::milliseconds(50));
+
+  time_system_.setMonotonicTime(std::chrono::milliseconds(50001));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  interval_timer_->invokeCallback();
+  EXPECT_FALSE(hosts_[4]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  EXPECT_EQ(-1, hosts_[4]->outlierDetector().latency());
+  EXPECT_EQ(-1, detector->latencyMedian());
+  EXPECT_EQ(0UL, outlier_detection_ejections_active_.value());
+}
+
+// Without latency_threshold_factor the response times are not tracked.
+TEST_F(OutlierDetectorImplTest, LatencyNotConfigured) {
+  EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
+  addHosts({
+      "tcp://127.0.0.1:80",
+      "tcp://127.0.0.1:81",
+      "tcp://127.0.0.1:82",
+      "tcp://127.0.0.1:83",
+      "tcp://127.0.0.1:84",
+  });
+
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  std::shared_ptr<DetectorImpl> detector(DetectorImpl::create(
+      cluster_, empty_outlier_detection_, dispatcher_, runtime_, time_system_, event_logger_));
+  for (size_t i = 0; i < 4; i++) {
+    loadResponseTimes(hosts_[i], 100, std::chrono::milliseconds(10));
+  }
+  loadResponseTimes(hosts_[4], 100, std::chrono::milliseconds(1000));
+
+  time_system_.setMonotonicTime(std::chrono::milliseconds(10000));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  interval_timer_->invokeCallback();
+  EXPECT_FALSE(hosts_[4]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  EXPECT_EQ(-1, hosts_[4]->outlierDetector().latency());
+  EXPECT_EQ(-1, detector->latencyMedian());
+}
+
 TEST_F(OutlierDetectorImplTest, RemoveWhileEjected) {
   EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
   addHosts({"tcp://127.0.0.1:80"});
@@ -1900,6 +2005,7 @@ TEST(DetectorHostMonitorNullImplTest, All) {
   EXPECT_EQ(0UL, null_sink.numEjections());
   EXPECT_FALSE(null_sink.lastEjectionTime());
   EXPECT_FALSE(null_sink.lastUnejectionTime());
+  EXPECT_EQ(-1, null_sink.latency());
 }
 
 TEST(OutlierDetectionEventLoggerImplTest, All) {
@@ -2010,6 +2116,23 @@ TEST(OutlierDetectionEventLoggerImplTest, All) {
       .WillOnce(SaveArg<0>(&log6));
   event_logger.logUneject(host);
   Json::Factory::loadFromString(log6);
+
+  StringViewSaver log7;
+  EXPECT_CALL(host->outlier_detector_, lastUnejectionTime()).WillOnce(ReturnRef(monotonic_time));
+  EXPECT_CALL(host->outlier_detector_, latency()).WillOnce(Return(52));
+  EXPECT_CALL(detector, latencyMedian()).WillOnce(Return(11));
+  EXPECT_CALL(detector, latencyEjectionThreshold()).WillOnce(Return(33));
+  EXPECT_CALL(*file,
+              write(absl::string_view(
+                  "{\"type\":\"LATENCY\",\"cluster_name\":\"fake_cluster\","
+                  "\"upstream_url\":\"10.0.0.1:443\",\"action\":\"EJECT\","
+                  "\"num_ejections\":0,\"enforced\":true,\"eject_latency_event\":{"
+                  "\"host_latency_ms\":\"52\",\"cluster_median_latency_ms\":\"11\","
+                  "\"cluster_latency_ejection_threshold_ms\":\"33\"},"
+                  "\"timestamp\":\"2018-12-18T09:00:00Z\",\"secs_since_last_action\":\"30\"}\n")))
+      .WillOnce(SaveArg<0>(&log7));
+  event_logger.logEject(host, detector, envoy::data::cluster::v3::LATENCY, true);
+  Json::Factory::loadFromString(log7);
 }
 
 TEST(OutlierUtility, SRThreshold) {
@@ -2026,6 +2149,37 @@ TEST(OutlierUtility, SRThreshold) {
   EXPECT_EQ(52.0, success_rate_nums.ejection_threshold_);   // ejection threshold
 }
 
+TEST(OutlierUtility, LatencyPercentile) {
+  // Every bucket covers the response times from the upper bound of the previous one.
+  EXPECT_EQ(0U, LatencyAccumulatorBucket::bucketIndex(0));
+  for (uint32_t i = 1; i < LatencyAccumulatorBucket::NumBuckets; i++) {
+    EXPECT_EQ(i, LatencyAccumulatorBucket::bucketIndex(
+                     LatencyAccumulatorBucket::bucketUpperBound(i - 1)));
+    EXPECT_EQ(i - 1, LatencyAccumulatorBucket::bucketIndex(
+                         LatencyAccumulatorBucket::bucketUpperBound(i - 1) - 1));
+  }
+  EXPECT_EQ(LatencyAccumulatorBucket::NumBuckets - 1,
+            LatencyAccumulatorBucket::bucketIndex(std::numeric_limits<uint64_t>::max()));
+
+  LatencyAccumulator accumulator;
+  LatencyAccumulatorBucket* bucket = accumulator.updateCurrentWriter();
+  for (uint64_t i = 0; i < 98; i++) {
+    bucket->record(5);
+  }
+  bucket->record(1000);
+  bucket->record(1000);
+  EXPECT_FALSE(accumulator.getLatencyAndVolume(0.99).has_value());
+
+  accumulator.updateCurrentWriter();
+  absl::optional<std::pair<double, uint64_t>> latency_and_volume =
+      accumulator.getLatencyAndVolume(0.99);
+  ASSERT_TRUE(latency_and_volume.has_value());
+  // 1000ms falls in the [960, 1024) bucket.
+  EXPECT_EQ(1024, latency_and_volume.value().first);
+  EXPECT_EQ(100U, latency_and_volume.value().second);
+  EXPECT_EQ(6, accumulator.getLatencyAndVolume(0.5).value().first);
+}
+
 } // namespace
 } // namespace Outlier
 } // namespace Upstream
@@ -0,0 +1,53 @@
+#include <chrono>
+#include <cmath>
+
+#include "source/common/upstream/peak_ewma_tracker.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class PeakEwmaTrackerTest : public Event::TestUsingSimulatedTime, public testing::Test {
+protected:
+  PeakEwmaTracker tracker_{simTime(), std::chrono::seconds(10)};
+};
+
+TEST_F(PeakEwmaTrackerTest, NoResponseTime) { EXPECT_EQ(0, tracker_.responseTime()); }
+
+// A response time above the average replaces it immediately.
+TEST_F(PeakEwmaTrackerTest, PeakReplacesAverage) {
+  tracker_.putResponseTime(std::chrono::microseconds(100));
+  EXPECT_DOUBLE_EQ(100, tracker_.responseTime());
+  tracker_.putResponseTime(std::chrono::microseconds(5000));
+  EXPECT_DOUBLE_EQ(5000, tracker_.responseTime());
+}
+
+// A response time below the average is blended in based on the time since the last update.
+TEST_F(PeakEwmaTrackerTest, LowerResponseTimeIsBlended) {
+  tracker_.putResponseTime(std::chrono::microseconds(1000));
+
+  // With no time elapsed the new observation has no weight.
+  tracker_.putResponseTime(std::chrono::microseconds(100));
+  EXPECT_DOUBLE_EQ(1000, tracker_.responseTime());
+
+  simTime().advanceTimeWait(std::chrono::seconds(10));
+  tracker_.putResponseTime(std::chrono::microseconds(100));
+  EXPECT_NEAR(1000 * std::exp(-1) + 100 * (1 - std::exp(-1)), tracker_.responseTime(), 1e-6);
+}
+
+// The average decays towards zero while no responses are recorded.
+TEST_F(PeakEwmaTrackerTest, DecaysWhileIdle) {
+  tracker_.putResponseTime(std::chrono::microseconds(1000));
+  simTime().advanceTimeWait(std::chrono::seconds(10));
+  EXPECT_NEAR(1000 * std::exp(-1), tracker_.responseTime(), 1e-6);
+  simTime().advanceTimeWait(std::chrono::seconds(10));
+  EXPECT_NEAR(1000 * std::exp(-2), tracker_.responseTime(), 1e-6);
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
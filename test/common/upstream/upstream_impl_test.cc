@@ -1,4 +1,5 @@
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <list>
 #include <string>
@@ -40,6 +41,7 @@
 #include "test/mocks/upstream/priority_set.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/registry.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
@@ -1613,6 +1615,11 @@ TEST_F(StaticClusterImplTest, LoadAssignmentLocality) {
     EXPECT_EQ("hello", locality.zone());
     EXPECT_EQ("world", locality.sub_zone());
   }
+  // The hosts share the locality of their endpoints.
+  EXPECT_EQ(&hosts[0]->locality(), &hosts[1]->locality());
+  EXPECT_EQ(1UL, stats_.counter("shared_pool.locality.deduplicated").value());
+  EXPECT_EQ(1UL, stats_.gauge("shared_pool.locality.objects", Stats::Gauge::ImportMode::NeverImport)
+                     .value());
   EXPECT_EQ(nullptr, cluster.prioritySet().hostSetsPerPriority()[0]->localityWeights());
   EXPECT_FALSE(cluster.info()->addedViaApi());
 }
@@ -2360,6 +2367,40 @@ TEST_F(ClusterInfoImplTest, Metadata) {
   EXPECT_EQ(LoadBalancerType::Maglev, cluster->info()->lbType());
 }
 
+// Hosts of a peak EWMA cluster track their response times.
+TEST_F(ClusterInfoImplTest, PeakEwmaResponseTimeTracker) {
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: PEAK_EWMA
+    peak_ewma_lb_config:
+      choice_count: 3
+      decay_time: 5s
+  )EOF";
+
+  auto cluster = makeCluster(yaml);
+  EXPECT_EQ(LoadBalancerType::PeakEwma, cluster->info()->lbType());
+  EXPECT_EQ(3, cluster->info()->lbPeakEwmaConfig()->choice_count().value());
+
+  Event::SimulatedTimeSystem time_system;
+  HostSharedPtr host = makeTestHost(cluster->info(), "tcp://10.0.0.1:1234", time_system);
+  ASSERT_NE(nullptr, host->responseTimeTracker());
+  host->responseTimeTracker()->putResponseTime(std::chrono::microseconds(1000));
+  time_system.advanceTimeWait(std::chrono::seconds(5));
+  EXPECT_NEAR(1000 * std::exp(-1), host->responseTimeTracker()->responseTime(), 1e-6);
+
+  const std::string round_robin_yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+  )EOF";
+  auto round_robin_cluster = makeCluster(round_robin_yaml);
+  EXPECT_EQ(nullptr, makeTestHost(round_robin_cluster->info(), "tcp://10.0.0.1:1234", time_system)
+                         ->responseTimeTracker());
+}
+
 // Verify retry budget default values are honored.
 TEST_F(ClusterInfoImplTest, RetryBudgetDefaultPopulation) {
   std::string yaml = R"EOF(
@@ -2572,6 +2613,29 @@ TEST_F(ClusterInfoImplTest,
                             "extension_protocol_options can be specified");
 }
 
+// With lazy cluster stats, each cluster stat is only created when it is first written.
+TEST_F(ClusterInfoImplTest, LazyClusterStats) {
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+  )EOF";
+
+  cm_.lazy_cluster_stats_ = true;
+  auto cluster = makeCluster(yaml);
+  ClusterStats& stats = cluster->info()->stats();
+  EXPECT_EQ(0UL, stats.upstream_rq_total_.value());
+  EXPECT_FALSE(stats_.findCounterByString("cluster.name.upstream_rq_total").has_value());
+  EXPECT_FALSE(stats_.findCounterByString("cluster.name.upstream_cx_total").has_value());
+
+  stats.upstream_rq_total_.inc();
+  EXPECT_EQ(1UL, stats.upstream_rq_total_.value());
+  ASSERT_TRUE(stats_.findCounterByString("cluster.name.upstream_rq_total").has_value());
+  EXPECT_EQ(1UL, stats_.findCounterByString("cluster.name.upstream_rq_total")->get().value());
+  EXPECT_FALSE(stats_.findCounterByString("cluster.name.upstream_cx_total").has_value());
+}
+
 TEST_F(ClusterInfoImplTest, TestTrackRequestResponseSizesNotSetInConfig) {
   const std::string yaml_disabled = R"EOF(
     name: name
@@ -96,6 +96,15 @@ TEST_P(MainCommonTest, ConstructDestructHotRestartDisabled) {
   VERBOSE_EXPECT_NO_THROW(MainCommon main_common(argc(), argv()));
 }
 
+// Exercise the asynchronous application logs, whose background thread is stopped with the server.
+TEST_P(MainCommonTest, ConstructDestructAsyncLogging) {
+  addArg("--disable-hot-restart");
+  addArg("--enable-async-logging");
+  initOnly();
+  MainCommon main_common(argc(), argv());
+  EXPECT_TRUE(main_common.run());
+}
+
 // Exercise init_only explicitly.
 TEST_P(MainCommonTest, ConstructDestructHotRestartDisabledNoInit) {
   addArg("--disable-hot-restart");
@@ -0,0 +1,100 @@
+#include <string>
+
+#include "source/extensions/access_loggers/binary_file/block_encoder.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+namespace {
+
+TEST(BlockEncoderTest, Varints) {
+  std::string output;
+  BlockEncoder::appendVarint(output, 1);
+  BlockEncoder::appendVarint(output, 300);
+  BlockEncoder::appendSignedVarint(output, -1);
+  BlockEncoder::appendSignedVarint(output, -300);
+  BlockEncoder::appendFixed32(output, 0x01020304);
+  EXPECT_EQ(std::string("\x01\xac\x02\x01\xd7\x04\x04\x03\x02\x01", 10), output);
+}
+
+TEST(BlockEncoderTest, EncodesBlock) {
+  BlockEncoder encoder({{"path", ColumnType::String}, {"code", ColumnType::Integer}});
+  encoder.setString(0, "/a");
+  encoder.setInteger(1, 200);
+  encoder.endRecord();
+  // The string is written once in the dictionary, and the integer is null.
+  encoder.setString(0, "/a");
+  encoder.endRecord();
+  EXPECT_EQ(2U, encoder.records());
+
+  std::string block;
+  encoder.finish(block);
+  // clang-format off
+  const std::string expected(
+      "EALB" "\x1f\x00\x00\x00"
+      // The dictionary.
+      "\x01" "\x02" "/a"
+      // The columns.
+      "\x03" "\x00" "\x00"
+      "\x01" "\x90\x03"
+      // The index.
+      "\x01" "\x02" "\x02"
+      "\x04" "path" "\x00" "\x04"
+      "\x04" "code" "\x01" "\x07"
+      "\x11\x00\x00\x00",
+      39);
+  // clang-format on
+  EXPECT_EQ(expected, block);
+  EXPECT_EQ(0U, encoder.records());
+}
+
+// Each block has its own dictionary, so that it can be decoded on its own.
+TEST(BlockEncoderTest, StartsNewBlock) {
+  BlockEncoder encoder({{"path", ColumnType::String}});
+  encoder.setString(0, "/a");
+  encoder.endRecord();
+  std::string first;
+  encoder.finish(first);
+
+  encoder.setString(0, "/b");
+  encoder.endRecord();
+  encoder.setString(0, "/a");
+  encoder.endRecord();
+  std::string second;
+  encoder.finish(second);
+  // clang-format off
+  const std::string expected(
+      "EALB" "\x18\x00\x00\x00"
+      "\x02" "\x02" "/b" "\x02" "/a"
+      "\x03" "\x00" "\x01"
+      "\x01" "\x02" "\x01"
+      "\x04" "path" "\x00" "\x07"
+      "\x0a\x00\x00\x00",
+      32);
+  // clang-format on
+  EXPECT_EQ(expected, second);
+}
+
+// The bitmaps have a bit per record, including the records after the last value of their column.
+TEST(BlockEncoderTest, NullValues) {
+  BlockEncoder encoder({{"code", ColumnType::Integer}});
+  for (int i = 0; i < 9; ++i) {
+    if (i == 1) {
+      encoder.setInteger(0, 1);
+    }
+    encoder.endRecord();
+  }
+  std::string block;
+  encoder.finish(block);
+  // The dictionary is empty, then come the 2 bytes of the bitmap and the value.
+  EXPECT_EQ(std::string("\x00\x02\x00\x02", 4), block.substr(8, 4));
+}
+
+} // namespace
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,135 @@
+#include <memory>
+#include <string>
+
+#include "envoy/config/accesslog/v3/accesslog.pb.h"
+#include "envoy/extensions/access_loggers/binary_file/v3alpha/binary_file.pb.h"
+
+#include "source/common/access_log/access_log_impl.h"
+#include "source/extensions/access_loggers/binary_file/config.h"
+
+#include "test/mocks/access_log/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+namespace {
+
+TEST(BinaryFileAccessLogNegativeTest, ValidateFail) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+
+  EXPECT_THROW(BinaryFileAccessLogFactory().createAccessLogInstance(
+                   envoy::extensions::access_loggers::binary_file::v3alpha::BinaryFileAccessLog(),
+                   nullptr, context),
+               ProtoValidationException);
+}
+
+class BinaryFileAccessLogTest : public testing::Test {
+public:
+  void createLogger() {
+    const std::string yaml = R"EOF(
+path: /foo
+columns:
+- name: code
+  format: "%RESPONSE_CODE%"
+  type: INTEGER
+- name: path
+  format: "%REQ(:PATH)%"
+- name: user_agent
+  format: "%REQ(USER-AGENT)%"
+records_per_block: 2
+block_flush_interval: 5s
+)EOF";
+    envoy::extensions::access_loggers::binary_file::v3alpha::BinaryFileAccessLog proto_config;
+    TestUtility::loadFromYamlAndValidate(yaml, proto_config);
+    envoy::config::accesslog::v3::AccessLog config;
+    config.mutable_typed_config()->PackFrom(proto_config);
+
+    Filesystem::FilePathAndType file_info{Filesystem::DestinationType::File, "/foo"};
+    EXPECT_CALL(context_.access_log_manager_, createAccessLog(file_info)).WillOnce(Return(file_));
+    flush_timer_ = new NiceMock<Event::MockTimer>(&context_.thread_local_.dispatcher_);
+    EXPECT_CALL(*flush_timer_, enableTimer(std::chrono::milliseconds(5000), _));
+    logger_ = AccessLog::AccessLogFactory::fromProto(config, context_);
+  }
+
+  void log() {
+    logger_->log(&request_headers_, &response_headers_, &response_trailers_, stream_info_);
+  }
+
+  // Returns the record count written in the index of a block.
+  static uint32_t recordCount(const std::string& block) {
+    const uint8_t* end = reinterpret_cast<const uint8_t*>(block.data()) + block.size();
+    const uint32_t index_length = end[-4] | end[-3] << 8 | end[-2] << 16 | end[-1] << 24;
+    // The version, then the record count, both a byte long in the tests.
+    return *(end - 4 - index_length + 1);
+  }
+
+  NiceMock<Server::Configuration::MockServerFactoryContext> context_;
+  std::shared_ptr<AccessLog::MockAccessLogFile> file_{
+      std::make_shared<AccessLog::MockAccessLogFile>()};
+  Event::MockTimer* flush_timer_;
+  AccessLog::InstanceSharedPtr logger_;
+  Http::TestRequestHeaderMapImpl request_headers_{{":method", "GET"}, {":path", "/a"}};
+  Http::TestResponseHeaderMapImpl response_headers_;
+  Http::TestResponseTrailerMapImpl response_trailers_;
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+};
+
+// A block is written once full.
+TEST_F(BinaryFileAccessLogTest, WritesFullBlock) {
+  createLogger();
+  stream_info_.response_code_ = 200;
+
+  std::string block;
+  EXPECT_CALL(*file_, write(_)).WillOnce(SaveArg<0>(&block));
+  log();
+  log();
+  EXPECT_EQ("EALB", block.substr(0, 4));
+  EXPECT_EQ(2U, recordCount(block));
+  // The path is written once in the dictionary of the block.
+  EXPECT_EQ(std::string("\x01\x02/a", 4), block.substr(8, 4));
+  // Both records have a code and a path, but no user agent.
+  EXPECT_EQ(std::string("\x03\x90\x03\x90\x03"
+                        "\x03\x00\x00"
+                        "\x00",
+                        9),
+            block.substr(12, 9));
+}
+
+// The block being filled is written periodically, and once the thread exits.
+TEST_F(BinaryFileAccessLogTest, WritesBlockPeriodically) {
+  createLogger();
+
+  EXPECT_CALL(*file_, write(_)).Times(0);
+  flush_timer_->invokeCallback();
+
+  std::string block;
+  log();
+  EXPECT_CALL(*file_, write(_)).WillOnce(SaveArg<0>(&block));
+  EXPECT_CALL(*flush_timer_, enableTimer(std::chrono::milliseconds(5000), _));
+  flush_timer_->invokeCallback();
+  EXPECT_EQ(1U, recordCount(block));
+
+  log();
+  EXPECT_CALL(*file_, write(_)).WillOnce(SaveArg<0>(&block));
+  context_.thread_local_.shutdownThread();
+  EXPECT_EQ(1U, recordCount(block));
+}
+
+} // namespace
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
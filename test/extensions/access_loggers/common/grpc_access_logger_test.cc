@@ -5,11 +5,13 @@
 #include "envoy/extensions/access_loggers/grpc/v3/als.pb.h"
 #include "envoy/service/accesslog/v3/als.pb.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/buffer/zero_copy_input_stream_impl.h"
 #include "source/common/grpc/typed_async_client.h"
 #include "source/common/network/address_impl.h"
 #include "source/common/protobuf/protobuf.h"
 #include "source/extensions/access_loggers/common/grpc_access_logger.h"
+#include "source/extensions/compression/gzip/decompressor/zlib_decompressor_impl.h"
 
 #include "test/mocks/access_log/mocks.h"
 #include "test/mocks/grpc/mocks.h"
@@ -17,6 +19,7 @@
 #include "test/mocks/stream_info/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
 
 using testing::_;
 using testing::InSequence;
@@ -55,10 +58,11 @@ public:
                            uint64_t max_buffer_size_bytes, Event::Dispatcher& dispatcher,
                            Stats::Scope& scope, std::string access_log_prefix,
                            const Protobuf::MethodDescriptor& service_method,
-                           envoy::config::core::v3::ApiVersion transport_api_version)
+                           envoy::config::core::v3::ApiVersion transport_api_version,
+                           const Common::GrpcAccessLoggerOptions& options = {})
       : GrpcAccessLogger(std::move(client), buffer_flush_interval_msec, max_buffer_size_bytes,
                          dispatcher, scope, access_log_prefix, service_method,
-                         transport_api_version) {}
+                         transport_api_version, options) {}
 
   int numInits() const { return num_inits_; }
 
@@ -116,13 +120,14 @@ public:
     return entry;
   }
 
-  void initLogger(std::chrono::milliseconds buffer_flush_interval_msec, size_t buffer_size_bytes) {
+  void initLogger(std::chrono::milliseconds buffer_flush_interval_msec, size_t buffer_size_bytes,
+                  const Common::GrpcAccessLoggerOptions& options = {}) {
     timer_ = new Event::MockTimer(&dispatcher_);
     EXPECT_CALL(*timer_, enableTimer(buffer_flush_interval_msec, _));
     logger_ = std::make_unique<MockGrpcAccessLoggerImpl>(
         Grpc::RawAsyncClientPtr{async_client_}, buffer_flush_interval_msec, buffer_size_bytes,
         dispatcher_, stats_store_, "mock_access_log_prefix.", mockMethodDescriptor(),
-        TRANSPORT_API_VERSION);
+        TRANSPORT_API_VERSION, options);
   }
 
   void expectStreamStart(MockAccessLogStream& stream, AccessLogCallbacks** callbacks_to_set) {
@@ -312,6 +317,99 @@ TEST_F(GrpcAccessLogTest, Flushing) {
   timer_->invokeCallback();
 }
 
+// Test that the flush interval follows the rate of the logs when it is adaptive.
+TEST_F(GrpcAccessLogTest, AdaptiveFlushInterval) {
+  const std::chrono::milliseconds max_flush_interval = 8 * FlushInterval;
+  const uint64_t entry_size = mockHttpEntry().ByteSizeLong();
+  Common::GrpcAccessLoggerOptions options;
+  options.max_buffer_flush_interval_ = max_flush_interval;
+  initLogger(FlushInterval, 10 * entry_size, options);
+
+  // Without logs, the interval grows to the maximum.
+  EXPECT_CALL(*timer_, enableTimer(max_flush_interval, _));
+  timer_->invokeCallback();
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillRepeatedly(Return(false));
+  EXPECT_CALL(stream, sendMessageRaw_(_, false)).Times(6);
+
+  // Twice the buffer was logged during the interval, which is halved.
+  for (int i = 0; i < 20; ++i) {
+    logger_->log(mockHttpEntry());
+  }
+  EXPECT_CALL(*timer_, enableTimer(max_flush_interval / 2, _));
+  timer_->invokeCallback();
+
+  // The interval doesn't go below the flush interval.
+  for (int i = 0; i < 40; ++i) {
+    logger_->log(mockHttpEntry());
+  }
+  EXPECT_CALL(*timer_, enableTimer(FlushInterval, _));
+  timer_->invokeCallback();
+
+  EXPECT_EQ(60 * entry_size,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.bytes_logged")->value());
+  EXPECT_EQ(
+      6, TestUtility::findCounter(stats_store_, "mock_access_log_prefix.messages_sent")->value());
+  EXPECT_LT(0,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.bytes_sent")->value());
+}
+
+// Test that the messages are compressed with gzip by the logger for the Envoy gRPC client.
+TEST_F(GrpcAccessLogTest, CompressedMessages) {
+  Common::GrpcAccessLoggerOptions options;
+  options.compress_messages_ = true;
+  initLogger(FlushInterval, 0, options);
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
+  EXPECT_CALL(stream, sendMessageRaw_(_, _)).Times(0);
+  uint64_t compressed_size = 0;
+  EXPECT_CALL(stream, sendCompressedMessageRaw_(_, false))
+      .WillOnce(Invoke([&compressed_size](Buffer::InstancePtr& request, bool) {
+        compressed_size = request->length();
+        Stats::IsolatedStoreImpl stats_store;
+        Extensions::Compression::Gzip::Decompressor::ZlibDecompressorImpl decompressor(
+            stats_store, "test.");
+        decompressor.init(15 + 16);
+        Buffer::OwnedImpl decompressed;
+        decompressor.decompress(*request, decompressed);
+        ProtobufWkt::Struct message;
+        EXPECT_TRUE(message.ParseFromString(decompressed.toString()));
+        EXPECT_EQ(1, message.fields().at(MOCK_HTTP_LOG_FIELD_NAME).number_value());
+      }));
+  logger_->log(mockHttpEntry());
+  EXPECT_EQ(compressed_size,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.bytes_sent")->value());
+
+  Http::TestRequestHeaderMapImpl metadata;
+  callbacks->onCreateInitialMetadata(metadata);
+  EXPECT_EQ("gzip", metadata.get_("grpc-encoding"));
+}
+
+// Test that the compression is left to the Google gRPC client.
+TEST_F(GrpcAccessLogTest, CompressedMessagesByGoogleGrpc) {
+  Common::GrpcAccessLoggerOptions options;
+  options.compress_messages_ = true;
+  options.google_grpc_ = true;
+  initLogger(FlushInterval, 0, options);
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  expectFlushedLogEntriesCount(stream, MOCK_HTTP_LOG_FIELD_NAME, 1);
+  logger_->log(mockHttpEntry());
+
+  Http::TestRequestHeaderMapImpl metadata;
+  callbacks->onCreateInitialMetadata(metadata);
+  EXPECT_EQ("gzip", metadata.get_("grpc-internal-encoding-request"));
+  EXPECT_FALSE(metadata.has("grpc-encoding"));
+}
+
 class MockGrpcAccessLoggerCache
     : public Common::GrpcAccessLoggerCache<
           MockGrpcAccessLoggerImpl,
@@ -327,10 +425,11 @@ private:
   createLogger(const envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig& config,
                envoy::config::core::v3::ApiVersion, Grpc::RawAsyncClientPtr&& client,
                std::chrono::milliseconds buffer_flush_interval_msec, uint64_t max_buffer_size_bytes,
-               Event::Dispatcher& dispatcher, Stats::Scope& scope) override {
+               const Common::GrpcAccessLoggerOptions& options, Event::Dispatcher& dispatcher,
+               Stats::Scope& scope) override {
     return std::make_shared<MockGrpcAccessLoggerImpl>(
         std::move(client), buffer_flush_interval_msec, max_buffer_size_bytes, dispatcher, scope,
-        "mock_access_log_prefix.", mockMethodDescriptor(), config.transport_api_version());
+        "mock_access_log_prefix.", mockMethodDescriptor(), config.transport_api_version(), options);
   }
 };
 
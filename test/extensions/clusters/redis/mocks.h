@@ -22,6 +22,7 @@ public:
   ~MockClusterSlotUpdateCallBack() override = default;
 
   MOCK_METHOD(bool, onClusterSlotUpdate, (ClusterSlotsPtr&&, Upstream::HostMap));
+  MOCK_METHOD(bool, onSlotsMoved, (const Common::Redis::MovedSlots&));
   MOCK_METHOD(void, onHostHealthUpdate, ());
 };
 
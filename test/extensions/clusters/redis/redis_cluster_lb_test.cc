@@ -8,6 +8,8 @@
 #include "test/mocks/upstream/cluster_info.h"
 #include "test/test_common/simulated_time_system.h"
 
+#include "absl/container/flat_hash_map.h"
+
 using testing::Return;
 
 namespace Envoy {
@@ -31,10 +33,27 @@ public:
   NetworkFilters::Common::Redis::Client::ReadPolicy readPolicy() const override {
     return read_policy_;
   };
+  const HostLatencyTracker* hostLatencies() const override { return host_latencies_; }
+  absl::string_view preferredZone() const override { return preferred_zone_; }
 
   absl::optional<uint64_t> hash_key_;
   bool is_read_;
   NetworkFilters::Common::Redis::Client::ReadPolicy read_policy_;
+  const HostLatencyTracker* host_latencies_{};
+  std::string preferred_zone_;
+};
+
+class TestHostLatencyTracker : public HostLatencyTracker {
+public:
+  absl::optional<double> latency(const Upstream::Host& host) const override {
+    auto it = latencies_.find(host.address()->asString());
+    if (it == latencies_.end()) {
+      return absl::nullopt;
+    }
+    return it->second;
+  }
+
+  absl::flat_hash_map<std::string, double> latencies_;
 };
 
 class RedisClusterLoadBalancerTest : public Event::TestUsingSimulatedTime, public testing::Test {
@@ -73,6 +92,15 @@ public:
     return map;
   }
 
+  Upstream::HostSharedPtr makeTestHostInZone(const std::string& url, const std::string& zone) {
+    envoy::config::core::v3::Locality locality;
+    locality.set_zone(zone);
+    return std::make_shared<Upstream::HostImpl>(
+        info_, "", Network::Utility::resolveUrl(url), nullptr, 1, locality,
+        envoy::config::endpoint::v3::Endpoint::HealthCheckConfig::default_instance(), 0,
+        envoy::config::core::v3::UNKNOWN, simTime());
+  }
+
   std::shared_ptr<RedisClusterLoadBalancerFactory> factory_;
   std::unique_ptr<RedisClusterThreadAwareLoadBalancer> lb_;
   std::shared_ptr<Upstream::MockClusterInfo> info_{new NiceMock<Upstream::MockClusterInfo>()};
@@ -315,6 +343,52 @@ TEST_F(RedisClusterLoadBalancerTest, ReadStrategiesNoReplica) {
   EXPECT_TRUE(host == nullptr);
 }
 
+TEST_F(RedisClusterLoadBalancerTest, ReplicaSelection) {
+  Upstream::HostVector hosts{
+      makeTestHostInZone("tcp://127.0.0.1:90", "zone_a"),
+      makeTestHostInZone("tcp://127.0.0.2:90", "zone_a"),
+      makeTestHostInZone("tcp://127.0.0.3:90", "zone_b"),
+      makeTestHostInZone("tcp://127.0.0.4:90", "zone_b"),
+  };
+
+  ClusterSlotsPtr slots = std::make_unique<std::vector<ClusterSlot>>(std::vector<ClusterSlot>{
+      ClusterSlot(0, 16383, hosts[0]->address()),
+  });
+  slots->at(0).addReplica(hosts[1]->address());
+  slots->at(0).addReplica(hosts[2]->address());
+  slots->at(0).addReplica(hosts[3]->address());
+  init();
+  factory_->onClusterSlotUpdate(std::move(slots), generateHostMap(hosts));
+  Upstream::LoadBalancerPtr lb = lb_->factory()->create();
+  ON_CALL(random_, random()).WillByDefault(Return(1));
+
+  TestLoadBalancerContext context(0, true,
+                                  NetworkFilters::Common::Redis::Client::ReadPolicy::Replica);
+  EXPECT_EQ(hosts[2], lb->chooseHost(&context));
+
+  // The replicas of the preferred zone are chosen from.
+  context.preferred_zone_ = "zone_b";
+  EXPECT_EQ(hosts[3], lb->chooseHost(&context));
+  context.preferred_zone_ = "zone_a";
+  EXPECT_EQ(hosts[1], lb->chooseHost(&context));
+
+  // All the replicas are chosen from when none is in the preferred zone.
+  context.preferred_zone_ = "zone_c";
+  EXPECT_EQ(hosts[2], lb->chooseHost(&context));
+
+  // The replica with the lowest latency among two random ones is chosen, preferring a replica
+  // whose latency is unknown.
+  TestHostLatencyTracker latencies;
+  context.host_latencies_ = &latencies;
+  context.preferred_zone_ = "zone_b";
+  latencies.latencies_[hosts[2]->address()->asString()] = 100;
+  EXPECT_EQ(hosts[3], lb->chooseHost(&context));
+  latencies.latencies_[hosts[3]->address()->asString()] = 200;
+  EXPECT_EQ(hosts[2], lb->chooseHost(&context));
+  latencies.latencies_[hosts[3]->address()->asString()] = 50;
+  EXPECT_EQ(hosts[3], lb->chooseHost(&context));
+}
+
 TEST_F(RedisClusterLoadBalancerTest, ClusterSlotUpdate) {
   Upstream::HostVector hosts{Upstream::makeTestHost(info_, "tcp://127.0.0.1:90", simTime()),
                              Upstream::makeTestHost(info_, "tcp://127.0.0.1:91", simTime())};
@@ -395,6 +469,39 @@ TEST_F(RedisClusterLoadBalancerTest, ClusterSlotNoUpdate) {
   validateAssignment(hosts, expected_assignments);
 }
 
+TEST_F(RedisClusterLoadBalancerTest, SlotsMoved) {
+  Upstream::HostVector hosts{Upstream::makeTestHost(info_, "tcp://127.0.0.1:90", simTime()),
+                             Upstream::makeTestHost(info_, "tcp://127.0.0.1:91", simTime()),
+                             Upstream::makeTestHost(info_, "tcp://127.0.0.1:92", simTime())};
+  std::vector<ClusterSlot> slots{ClusterSlot(0, 1000, hosts[0]->address()),
+                                 ClusterSlot(1001, 16383, hosts[1]->address())};
+  Upstream::HostMap all_hosts{{hosts[0]->address()->asString(), hosts[0]},
+                              {hosts[1]->address()->asString(), hosts[1]}};
+  init();
+
+  // The slots can't be moved before the topology is known.
+  EXPECT_EQ(false, factory_->onSlotsMoved({{100, hosts[1]->address()->asString()}}));
+  EXPECT_EQ(true, factory_->onClusterSlotUpdate(
+                      std::make_unique<std::vector<ClusterSlot>>(slots), all_hosts));
+
+  // The moves to hosts that aren't the primary of a shard, of invalid slots, and to the current
+  // primary of the slot are ignored.
+  EXPECT_EQ(false, factory_->onSlotsMoved({{100, hosts[2]->address()->asString()},
+                                           {MaxSlot, hosts[1]->address()->asString()},
+                                           {1100, hosts[1]->address()->asString()}}));
+  validateAssignment(hosts, {{100, 0}, {101, 0}, {1100, 1}, {1101, 1}});
+
+  // Only the moved slots are updated.
+  EXPECT_EQ(true, factory_->onSlotsMoved({{100, hosts[1]->address()->asString()},
+                                          {1100, hosts[0]->address()->asString()}}));
+  validateAssignment(hosts, {{100, 1}, {101, 0}, {1100, 0}, {1101, 1}});
+
+  // The next cluster slot update is applied even though it didn't change since the last one.
+  EXPECT_EQ(true, factory_->onClusterSlotUpdate(
+                      std::make_unique<std::vector<ClusterSlot>>(slots), all_hosts));
+  validateAssignment(hosts, {{100, 0}, {101, 0}, {1100, 1}, {1101, 1}});
+}
+
 TEST_F(RedisLoadBalancerContextImplTest, Basic) {
   // Simple read command
   std::vector<NetworkFilters::Common::Redis::RespValue> get_foo(2);
@@ -489,7 +489,7 @@ protected:
     // No change.
     expectRedisResolve();
     resolve_timer_->invokeCallback();
-    EXPECT_CALL(*cluster_callback_, onClusterSlotUpdate(_, _)).WillOnce(Return(false));
+    EXPECT_CALL(*cluster_callback_, onClusterSlotUpdate(_, _)).Times(0);
     expectClusterSlotResponse(twoSlotsPrimaries());
     expectHealthyHosts(std::list<std::string>({"127.0.0.1:22120", "127.0.0.2:22120"}));
 
@@ -505,7 +505,7 @@ protected:
     // No change.
     expectRedisResolve();
     resolve_timer_->invokeCallback();
-    EXPECT_CALL(*cluster_callback_, onClusterSlotUpdate(_, _)).WillOnce(Return(false));
+    EXPECT_CALL(*cluster_callback_, onClusterSlotUpdate(_, _)).Times(0);
     expectClusterSlotResponse(twoSlotsPrimariesWithReplica());
     expectHealthyHosts(std::list<std::string>(
         {"127.0.0.1:22120", "127.0.0.3:22120", "127.0.0.2:22120", "127.0.0.4:22120"}));
@@ -519,6 +519,10 @@ protected:
     expectHealthyHosts(std::list<std::string>({"127.0.0.1:22120", "127.0.0.2:22120"}));
   }
 
+  void onSlotsMoved(const Common::Redis::MovedSlots& moved_slots) {
+    cluster_->onSlotsMoved(moved_slots);
+  }
+
   void exerciseStubs() {
     EXPECT_CALL(dispatcher_, createTimer_(_));
     RedisCluster::RedisDiscoverySession discovery_session(*cluster_, *this);
@@ -852,7 +856,8 @@ TEST_F(RedisClusterTest, RedisErrorResponse) {
     expectRedisResolve();
     resolve_timer_->invokeCallback();
     if (flags.all()) {
-      EXPECT_CALL(*cluster_callback_, onClusterSlotUpdate(_, _)).WillOnce(Return(false));
+      // The topology didn't change.
+      EXPECT_CALL(*cluster_callback_, onClusterSlotUpdate(_, _)).Times(0);
     }
     expectClusterSlotResponse(createResponse(flags, no_replica));
     expectHealthyHosts(std::list<std::string>({"127.0.0.1:22120"}));
@@ -962,6 +967,47 @@ TEST_F(RedisClusterTest, MultipleDnsDiscovery) {
   EXPECT_CALL(pool_request_, cancel());
 }
 
+TEST_F(RedisClusterTest, SlotsMoved) {
+  setupFromV3Yaml(BasicConfig);
+  const std::list<std::string> resolved_addresses{"127.0.0.1", "127.0.0.2"};
+  expectResolveDiscovery(Network::DnsLookupFamily::V4Only, "foo.bar.com", resolved_addresses);
+  expectRedisResolve(true);
+
+  EXPECT_CALL(membership_updated_, ready());
+  EXPECT_CALL(initialized_, ready());
+  cluster_->initialize([&]() -> void { initialized_.ready(); });
+
+  EXPECT_CALL(*cluster_callback_, onClusterSlotUpdate(_, _));
+  expectClusterSlotResponse(twoSlotsPrimaries());
+
+  // The load balancers are only updated if the slot map changed.
+  const Common::Redis::MovedSlots moved_slots{{100, "127.0.0.2:22120"}};
+  EXPECT_CALL(*cluster_callback_, onSlotsMoved(moved_slots)).WillOnce(Return(false));
+  EXPECT_CALL(membership_updated_, ready()).Times(0);
+  onSlotsMoved(moved_slots);
+
+  EXPECT_CALL(*cluster_callback_, onSlotsMoved(moved_slots)).WillOnce(Return(true));
+  EXPECT_CALL(membership_updated_, ready());
+  onSlotsMoved(moved_slots);
+
+  // The next topology is applied even though it didn't change since the last one.
+  expectRedisResolve();
+  resolve_timer_->invokeCallback();
+  EXPECT_CALL(*cluster_callback_, onClusterSlotUpdate(_, _));
+  EXPECT_CALL(membership_updated_, ready());
+  expectClusterSlotResponse(twoSlotsPrimaries());
+  EXPECT_EQ(0U, cluster_->info()->stats().update_no_rebuild_.value());
+
+  // And the one after it is not, as it didn't change.
+  expectRedisResolve();
+  resolve_timer_->invokeCallback();
+  EXPECT_CALL(*cluster_callback_, onClusterSlotUpdate(_, _)).Times(0);
+  EXPECT_CALL(membership_updated_, ready()).Times(0);
+  expectClusterSlotResponse(twoSlotsPrimaries());
+  EXPECT_EQ(1U, cluster_->info()->stats().update_no_rebuild_.value());
+  expectHealthyHosts(std::list<std::string>({"127.0.0.1:22120", "127.0.0.2:22120"}));
+}
+
 TEST_F(RedisClusterTest, HostRemovalAfterHcFail) {
   setupFromV3Yaml(BasicConfig);
   auto health_checker = std::make_shared<Upstream::MockHealthChecker>();
@@ -0,0 +1,87 @@
+// Measures the cache hits of the dynamic forward proxy DNS cache, with many resolved hosts cached.
+
+#include <string>
+#include <vector>
+
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/extensions/common/dynamic_forward_proxy/v3/dns_cache.pb.h"
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/common/dynamic_forward_proxy/dns_cache_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/extensions/common/dynamic_forward_proxy/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace DynamicForwardProxy {
+namespace {
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_LoadCachedDnsCacheEntry(::benchmark::State& state) {
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  const size_t num_hosts = state.range(0);
+
+  NiceMock<Event::MockDispatcher> dispatcher;
+  auto resolver = std::make_shared<NiceMock<Network::MockDnsResolver>>();
+  ON_CALL(dispatcher, createDnsResolver(_, _)).WillByDefault(Return(resolver));
+  ON_CALL(*resolver, resolve(_, _, _))
+      .WillByDefault(Invoke([](const std::string&, Network::DnsLookupFamily,
+                               Network::DnsResolver::ResolveCb callback)
+                               -> Network::ActiveDnsQuery* {
+        callback(Network::DnsResolver::ResolutionStatus::Success,
+                 TestUtility::makeDnsResponse({"10.0.0.1"}));
+        return nullptr;
+      }));
+  NiceMock<ThreadLocal::MockInstance> tls;
+  NiceMock<Random::MockRandomGenerator> random;
+  NiceMock<Runtime::MockLoader> loader;
+  Stats::IsolatedStoreImpl store;
+
+  envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig config;
+  config.set_name("foo");
+  config.set_dns_lookup_family(envoy::config::cluster::v3::Cluster::V4_ONLY);
+  config.mutable_max_hosts()->set_value(num_hosts);
+  DnsCacheImpl dns_cache(dispatcher, tls, random, loader, store, config);
+
+  // The hosts are resolved inline, as the dispatcher runs what is posted to it at once.
+  NiceMock<MockLoadDnsCacheEntryCallbacks> callbacks;
+  std::vector<std::string> hosts;
+  hosts.reserve(num_hosts);
+  for (size_t i = 0; i < num_hosts; i++) {
+    hosts.push_back(absl::StrCat("host", i, ".example.com"));
+    dns_cache.loadDnsCacheEntry(hosts.back(), 443, callbacks);
+  }
+
+  size_t i = 0;
+  for (auto _ : state) { // NOLINT
+    auto result = dns_cache.loadDnsCacheEntry(hosts[i], 443, callbacks);
+    ASSERT(result.status_ == DnsCache::LoadDnsCacheEntryStatus::InCache);
+    ::benchmark::DoNotOptimize(result);
+    i = (i + 1) % num_hosts;
+  }
+}
+BENCHMARK(BM_LoadCachedDnsCacheEntry)->Arg(1000)->Arg(100000)->Unit(::benchmark::kNanosecond);
+
+} // namespace
+} // namespace DynamicForwardProxy
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
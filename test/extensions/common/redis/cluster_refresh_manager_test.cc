@@ -17,6 +17,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::_;
 using testing::Return;
 
 namespace Envoy {
@@ -121,7 +122,7 @@ public:
 // invalid unregistered cluster names.
 TEST_F(ClusterRefreshManagerTest, Basic) {
   handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::milliseconds(1000), 1, 1,
-                                              1, [&]() { callback_count_++; });
+                                              1, [&]() { callback_count_++; }, nullptr);
   ClusterRefreshManagerImpl::ClusterInfoSharedPtr cluster_info = clusterInfo(cluster_name_);
 
   Thread::ThreadPtr thread_1 = platform_.threadFactory().createThread([&]() {
@@ -165,7 +166,7 @@ TEST_F(ClusterRefreshManagerTest, Basic) {
 // invalid unregistered cluster names.
 TEST_F(ClusterRefreshManagerTest, BasicFailureEvents) {
   handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::milliseconds(1000), 1, 1,
-                                              1, [&]() { callback_count_++; });
+                                              1, [&]() { callback_count_++; }, nullptr);
   ClusterRefreshManagerImpl::ClusterInfoSharedPtr cluster_info = clusterInfo(cluster_name_);
 
   Thread::ThreadPtr thread_1 = platform_.threadFactory().createThread([&]() {
@@ -209,7 +210,7 @@ TEST_F(ClusterRefreshManagerTest, BasicFailureEvents) {
 // invalid unregistered cluster names.
 TEST_F(ClusterRefreshManagerTest, BasicDegradedEvents) {
   handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::milliseconds(1000), 1, 1,
-                                              1, [&]() { callback_count_++; });
+                                              1, [&]() { callback_count_++; }, nullptr);
   ClusterRefreshManagerImpl::ClusterInfoSharedPtr cluster_info = clusterInfo(cluster_name_);
 
   Thread::ThreadPtr thread_1 = platform_.threadFactory().createThread([&]() {
@@ -253,7 +254,7 @@ TEST_F(ClusterRefreshManagerTest, BasicDegradedEvents) {
 // to simulate possible thread timing issues.
 TEST_F(ClusterRefreshManagerTest, HighVolume) {
   handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::seconds(2), 1000, 1000,
-                                              1000, [&]() { callback_count_++; });
+                                              1000, [&]() { callback_count_++; }, nullptr);
   ClusterRefreshManagerImpl::ClusterInfoSharedPtr cluster_info = clusterInfo(cluster_name_);
   uint32_t thread1_callback_count = 0;
   uint32_t thread2_callback_count = 0;
@@ -298,7 +299,7 @@ TEST_F(ClusterRefreshManagerTest, HighVolume) {
 // degraded events are disabled by setting the threshold to 0
 TEST_F(ClusterRefreshManagerTest, FeatureDisabled) {
   handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::milliseconds(1000), 0, 0,
-                                              0, [&]() { callback_count_++; });
+                                              0, [&]() { callback_count_++; }, nullptr);
   ClusterRefreshManagerImpl::ClusterInfoSharedPtr cluster_info = clusterInfo(cluster_name_);
 
   EXPECT_FALSE(refresh_manager_->onRedirection(cluster_name_));
@@ -316,6 +317,41 @@ TEST_F(ClusterRefreshManagerTest, FeatureDisabled) {
   EXPECT_EQ(cluster_info->host_degraded_threshold_, 0);
 }
 
+// The slots moved before the callback runs on the main thread are passed to a single call.
+TEST_F(ClusterRefreshManagerTest, SlotsMoved) {
+  std::vector<MovedSlots> moved_slots;
+  handle_ = refresh_manager_->registerCluster(
+      cluster_name_, std::chrono::milliseconds(1000), 1, 1, 1, [&]() { callback_count_++; },
+      [&](const MovedSlots& slots) { moved_slots.push_back(slots); });
+
+  std::function<void()> post_cb;
+  EXPECT_CALL(dispatcher_, post(_))
+      .WillOnce(testing::SaveArg<0>(&post_cb))
+      .WillRepeatedly(testing::Invoke([](std::function<void()> cb) { cb(); }));
+  refresh_manager_->onSlotMoved(cluster_name_, 1, "10.0.0.1:6379");
+  refresh_manager_->onSlotMoved(cluster_name_, 2, "10.0.0.2:6379");
+  refresh_manager_->onSlotMoved(cluster_name_, 1, "10.0.0.3:6379");
+  refresh_manager_->onSlotMoved("unregistered_cluster", 1, "10.0.0.1:6379");
+  EXPECT_TRUE(moved_slots.empty());
+  post_cb();
+  ASSERT_EQ(1UL, moved_slots.size());
+  EXPECT_EQ((MovedSlots{{1, "10.0.0.3:6379"}, {2, "10.0.0.2:6379"}}), moved_slots[0]);
+
+  // The next move posts the callback again.
+  refresh_manager_->onSlotMoved(cluster_name_, 3, "10.0.0.1:6379");
+  ASSERT_EQ(2UL, moved_slots.size());
+  EXPECT_EQ((MovedSlots{{3, "10.0.0.1:6379"}}), moved_slots[1]);
+  EXPECT_EQ(0, callback_count_);
+}
+
+// The moved slots are ignored for the clusters without slots moved callback.
+TEST_F(ClusterRefreshManagerTest, SlotsMovedIgnored) {
+  handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::milliseconds(1000), 1, 1,
+                                              1, [&]() { callback_count_++; }, nullptr);
+  EXPECT_CALL(dispatcher_, post(_)).Times(0);
+  refresh_manager_->onSlotMoved(cluster_name_, 1, "10.0.0.1:6379");
+}
+
 } // namespace Redis
 } // namespace Common
 } // namespace Extensions
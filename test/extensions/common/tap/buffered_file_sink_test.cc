@@ -0,0 +1,127 @@
+#include <memory>
+#include <string>
+
+#include "envoy/config/tap/v3/common.pb.h"
+#include "envoy/data/tap/v3/wrapper.pb.h"
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/common/tap/buffered_file_sink.h"
+#include "source/extensions/common/tap/pcapng_writer.h"
+
+#include "test/extensions/common/tap/common.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Tap {
+namespace {
+
+class BufferedFileSinkTest : public testing::Test {
+public:
+  BufferedFileSinkTest()
+      : api_(Api::createApiForTest(store_)),
+        path_(TestEnvironment::temporaryPath("buffered_file_sink_test")) {}
+
+  void initialize(const std::string& yaml,
+                  envoy::config::tap::v3::OutputSink::Format format =
+                      envoy::config::tap::v3::OutputSink::PROTO_BINARY_LENGTH_DELIMITED) {
+    envoy::config::tap::v3::BufferedFileSink config;
+    TestUtility::loadFromYaml(yaml, config);
+    config.set_path(path_);
+    sink_ = std::make_unique<BufferedFileSink>(config, format, *api_);
+  }
+
+  void submitTrace(uint64_t trace_id, const std::string& yaml) {
+    auto trace = std::make_unique<envoy::data::tap::v3::TraceWrapper>();
+    TestUtility::loadFromYaml(yaml, *trace);
+    sink_->createPerTapSinkHandle(trace_id)->submitTrace(
+        std::move(trace), envoy::config::tap::v3::OutputSink::PROTO_BINARY_LENGTH_DELIMITED);
+  }
+
+  uint64_t counter(const std::string& name) {
+    return store_.counterFromString("tap.buffered_file_sink." + name).value();
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  Api::ApiPtr api_;
+  const std::string path_;
+  std::unique_ptr<BufferedFileSink> sink_;
+};
+
+// The traces are written to the file, length delimited, by the time the sink is destroyed.
+TEST_F(BufferedFileSinkTest, TraceWrapper) {
+  initialize("{}");
+  submitTrace(1, "http_buffered_trace: {request: {body: {as_bytes: aGVsbG8=}}}");
+  submitTrace(2, "http_buffered_trace: {response: {body: {as_bytes: d29ybGQ=}}}");
+  sink_.reset();
+
+  const auto traces = readTracesFromFile(path_);
+  ASSERT_EQ(2, traces.size());
+  EXPECT_THAT(traces[0],
+              TraceEqual("http_buffered_trace: {request: {body: {as_bytes: aGVsbG8=}}}"));
+  EXPECT_THAT(traces[1],
+              TraceEqual("http_buffered_trace: {response: {body: {as_bytes: d29ybGQ=}}}"));
+  EXPECT_EQ(2, counter("traces_written"));
+  EXPECT_EQ(TestEnvironment::readFileToStringForTest(path_).size(), counter("bytes_written"));
+}
+
+// The transport socket traces are written as packets, and the other traces are skipped.
+TEST_F(BufferedFileSinkTest, Pcapng) {
+  initialize("file_format: PCAPNG");
+  submitTrace(1, R"EOF(
+socket_buffered_trace:
+  connection:
+    local_address: {socket_address: {address: 10.0.0.1, port_value: 80}}
+    remote_address: {socket_address: {address: 10.0.0.2, port_value: 1234}}
+  events:
+  - read: {data: {as_bytes: aGVsbG8=}}
+)EOF");
+  submitTrace(2, "http_buffered_trace: {}");
+  sink_.reset();
+
+  const std::string capture = TestEnvironment::readFileToStringForTest(path_);
+  EXPECT_EQ(PcapngWriter::header(), capture.substr(0, PcapngWriter::header().size()));
+  EXPECT_EQ(PcapngWriter::header().size() + 80, capture.size());
+  EXPECT_EQ(1, counter("traces_written"));
+  EXPECT_EQ(1, counter("traces_skipped"));
+}
+
+// The traces of the taps that are not sampled are not buffered.
+TEST_F(BufferedFileSinkTest, Sampling) {
+  initialize("sampling: {numerator: 0}");
+  submitTrace(1, "http_buffered_trace: {}");
+  sink_.reset();
+
+  EXPECT_TRUE(readTracesFromFile(path_).empty());
+  EXPECT_EQ(0, counter("traces_written"));
+  EXPECT_EQ(0, counter("traces_dropped"));
+}
+
+// The traces that don't fit in the ring of their thread are dropped and counted.
+TEST_F(BufferedFileSinkTest, Drops) {
+  initialize("max_buffered_traces: 1");
+  for (uint64_t trace_id = 0; trace_id < 100; trace_id++) {
+    submitTrace(trace_id, "http_buffered_trace: {}");
+  }
+  sink_.reset();
+
+  EXPECT_EQ(100, counter("traces_written") + counter("traces_dropped"));
+  EXPECT_EQ(counter("traces_written"), readTracesFromFile(path_).size());
+}
+
+// The trace wrappers can only be written length delimited.
+TEST_F(BufferedFileSinkTest, InvalidFormat) {
+  EXPECT_THROW_WITH_MESSAGE(
+      initialize("{}", envoy::config::tap::v3::OutputSink::JSON_BODY_AS_STRING), EnvoyException,
+      "buffered file sink only supports the PROTO_BINARY_LENGTH_DELIMITED format");
+}
+
+} // namespace
+} // namespace Tap
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
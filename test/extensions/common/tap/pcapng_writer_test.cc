@@ -0,0 +1,158 @@
+#include <cstdint>
+#include <string>
+
+#include "envoy/data/tap/v3/wrapper.pb.h"
+
+#include "source/extensions/common/tap/pcapng_writer.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Tap {
+namespace {
+
+// The offsets of the fields of the first packet of a capture without its header, which is made of
+// an enhanced packet block, an IPv4 header and a TCP header.
+constexpr size_t PacketStart = 28;
+constexpr size_t TcpStart = PacketStart + 20;
+
+uint32_t littleEndian32(const std::string& data, size_t offset) {
+  uint32_t value = 0;
+  for (int i = 3; i >= 0; i--) {
+    value = (value << 8) | static_cast<uint8_t>(data[offset + i]);
+  }
+  return value;
+}
+
+uint32_t network32(const std::string& data, size_t offset) {
+  uint32_t value = 0;
+  for (int i = 0; i < 4; i++) {
+    value = (value << 8) | static_cast<uint8_t>(data[offset + i]);
+  }
+  return value;
+}
+
+envoy::data::tap::v3::TraceWrapper loadTrace(const std::string& yaml) {
+  envoy::data::tap::v3::TraceWrapper trace;
+  TestUtility::loadFromYaml(yaml, trace);
+  return trace;
+}
+
+// The capture starts with a section header block and the description of a raw IP interface.
+TEST(PcapngWriterTest, Header) {
+  const std::string header = PcapngWriter::header();
+  ASSERT_EQ(48, header.size());
+  EXPECT_EQ(0x0A0D0D0A, littleEndian32(header, 0));
+  EXPECT_EQ(28, littleEndian32(header, 4));
+  EXPECT_EQ(0x1A2B3C4D, littleEndian32(header, 8));
+  EXPECT_EQ(28, littleEndian32(header, 24));
+  EXPECT_EQ(1, littleEndian32(header, 28));
+  EXPECT_EQ(20, littleEndian32(header, 32));
+  // The raw IP link type.
+  EXPECT_EQ(101, littleEndian32(header, 36) & 0xFFFF);
+  EXPECT_EQ(20, littleEndian32(header, 44));
+}
+
+// Each data event of a buffered trace is a packet from the side that sent it, with sequence numbers
+// that follow the data sent so far.
+TEST(PcapngWriterTest, BufferedTrace) {
+  PcapngWriter writer;
+  std::string output;
+  EXPECT_TRUE(writer.write(loadTrace(R"EOF(
+socket_buffered_trace:
+  connection:
+    local_address: {socket_address: {address: 10.0.0.1, port_value: 80}}
+    remote_address: {socket_address: {address: 10.0.0.2, port_value: 1234}}
+  events:
+  - read: {data: {as_bytes: aGVsbG8=}}
+  - write: {data: {as_bytes: d29ybGQh}, end_stream: true}
+)EOF"),
+                           output));
+
+  // Both packets are padded to 48 bytes.
+  ASSERT_EQ(160, output.size());
+  EXPECT_EQ(6, littleEndian32(output, 0));
+  EXPECT_EQ(80, littleEndian32(output, 4));
+  EXPECT_EQ(45, littleEndian32(output, 20));
+  EXPECT_EQ(80, littleEndian32(output, 76));
+
+  // The read data is sent by the remote peer.
+  EXPECT_EQ(0x45, static_cast<uint8_t>(output[PacketStart]));
+  EXPECT_EQ(0x0A000002, network32(output, PacketStart + 12));
+  EXPECT_EQ(0x0A000001, network32(output, PacketStart + 16));
+  EXPECT_EQ((1234 << 16) | 80, network32(output, TcpStart));
+  EXPECT_EQ(0, network32(output, TcpStart + 4));
+  EXPECT_EQ(0, network32(output, TcpStart + 8));
+  EXPECT_EQ("hello", output.substr(TcpStart + 20, 5));
+
+  // The written data acknowledges the read data, and carries the FIN of the end of the stream.
+  const size_t second_packet_start = 80 + PacketStart;
+  const size_t second_tcp_start = 80 + TcpStart;
+  EXPECT_EQ(0x0A000001, network32(output, second_packet_start + 12));
+  EXPECT_EQ((80 << 16) | 1234, network32(output, second_tcp_start));
+  EXPECT_EQ(0, network32(output, second_tcp_start + 4));
+  EXPECT_EQ(5, network32(output, second_tcp_start + 8));
+  EXPECT_EQ(0x19, static_cast<uint8_t>(output[second_tcp_start + 13]));
+  EXPECT_EQ("world!", output.substr(second_tcp_start + 20, 6));
+}
+
+// The connection of a streamed trace is kept by the writer until it is closed.
+TEST(PcapngWriterTest, StreamedTrace) {
+  PcapngWriter writer;
+  std::string output;
+  EXPECT_TRUE(writer.write(loadTrace(R"EOF(
+socket_streamed_trace_segment:
+  trace_id: 1
+  connection:
+    local_address: {socket_address: {address: "::1", port_value: 80}}
+    remote_address: {socket_address: {address: "::2", port_value: 1234}}
+)EOF"),
+                           output));
+  EXPECT_TRUE(output.empty());
+
+  const std::string write_event = R"EOF(
+socket_streamed_trace_segment:
+  trace_id: 1
+  event: {write: {data: {as_bytes: aGVsbG8=}}}
+)EOF";
+  EXPECT_TRUE(writer.write(loadTrace(write_event), output));
+  // An IPv6 header of 40 bytes.
+  ASSERT_EQ(100, output.size());
+  EXPECT_EQ(0x60, static_cast<uint8_t>(output[PacketStart]));
+  EXPECT_EQ(1, static_cast<uint8_t>(output[PacketStart + 23]));
+  EXPECT_EQ(2, static_cast<uint8_t>(output[PacketStart + 39]));
+
+  output.clear();
+  EXPECT_TRUE(writer.write(loadTrace(write_event), output));
+  EXPECT_EQ(5, network32(output, PacketStart + 40 + 4));
+
+  EXPECT_TRUE(writer.write(loadTrace(R"EOF(
+socket_streamed_trace_segment:
+  trace_id: 1
+  event: {closed: {}}
+)EOF"),
+                           output));
+  // Once closed, the next trace with the same ID stands for an unknown connection.
+  output.clear();
+  EXPECT_TRUE(writer.write(loadTrace(write_event), output));
+  ASSERT_EQ(80, output.size());
+  EXPECT_EQ(0, network32(output, TcpStart + 4));
+}
+
+// Only the traces of the transport socket have packets.
+TEST(PcapngWriterTest, HttpTrace) {
+  PcapngWriter writer;
+  std::string output;
+  EXPECT_FALSE(writer.write(loadTrace("http_buffered_trace: {}"), output));
+  EXPECT_TRUE(output.empty());
+}
+
+} // namespace
+} // namespace Tap
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
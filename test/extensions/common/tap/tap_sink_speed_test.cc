@@ -0,0 +1,68 @@
+// Measures the cost of submitting a trace to a sink that writes a file per tap, and to a buffered
+// file sink that hands the trace to a background thread, from one or many threads.
+
+#include <memory>
+
+#include "envoy/config/tap/v3/common.pb.h"
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/common/tap/buffered_file_sink.h"
+#include "source/extensions/common/tap/tap_config_base.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Tap {
+namespace {
+
+TraceWrapperPtr makeTrace() {
+  auto trace = std::make_unique<envoy::data::tap::v3::TraceWrapper>();
+  auto& event = *trace->mutable_socket_streamed_trace_segment()->mutable_event();
+  event.mutable_read()->mutable_data()->set_as_bytes(std::string(1024, 'a'));
+  return trace;
+}
+
+void submitTraces(benchmark::State& state, Sink& sink) {
+  uint64_t trace_id = state.thread_index;
+  for (auto _ : state) { // NOLINT
+    sink.createPerTapSinkHandle(trace_id)->submitTrace(
+        makeTrace(), envoy::config::tap::v3::OutputSink::PROTO_BINARY_LENGTH_DELIMITED);
+    trace_id += state.threads;
+  }
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_FilePerTapSink(benchmark::State& state) {
+  static Sink* sink = []() {
+    envoy::config::tap::v3::FilePerTapSink config;
+    config.set_path_prefix(TestEnvironment::temporaryPath("tap_sink_speed_test_file_per_tap"));
+    return new FilePerTapSink(config);
+  }();
+  submitTraces(state, *sink);
+}
+BENCHMARK(BM_FilePerTapSink)->Threads(1)->Threads(8)->UseRealTime();
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_BufferedFileSink(benchmark::State& state) {
+  static Sink* sink = []() {
+    static Stats::IsolatedStoreImpl* store = new Stats::IsolatedStoreImpl();
+    static Api::ApiPtr api = Api::createApiForTest(*store);
+    envoy::config::tap::v3::BufferedFileSink config;
+    config.set_path(TestEnvironment::temporaryPath("tap_sink_speed_test_buffered"));
+    return new BufferedFileSink(
+        config, envoy::config::tap::v3::OutputSink::PROTO_BINARY_LENGTH_DELIMITED, *api);
+  }();
+  submitTraces(state, *sink);
+}
+BENCHMARK(BM_BufferedFileSink)->Threads(1)->Threads(8)->UseRealTime();
+
+} // namespace
+} // namespace Tap
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
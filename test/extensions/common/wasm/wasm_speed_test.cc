@@ -63,6 +63,59 @@ void bmWasmSpeedTest(benchmark::State& state) {
 
 BENCHMARK(bmWasmSpeedTest);
 
+class HeaderMapContext : public Envoy::Extensions::Common::Wasm::Context {
+public:
+  using Envoy::Extensions::Common::Wasm::Context::Context;
+
+  void setRequestHeaders(Envoy::Http::RequestHeaderMap* headers) { request_headers_ = headers; }
+};
+
+// Measures the per request cost of the header map calls of a plugin: reading the request headers
+// one by one, marshalling them all at once as the VM receives them and replacing them all.
+void bmWasmHeaderMapSpeedTest(benchmark::State& state) {
+  Envoy::Stats::IsolatedStoreImpl stats_store;
+  Envoy::Api::ApiPtr api = Envoy::Api::createApiForTest(stats_store);
+  Envoy::Upstream::MockClusterManager cluster_manager;
+  Envoy::Event::DispatcherPtr dispatcher(api->allocateDispatcher("wasm_test"));
+  auto scope = Envoy::Stats::ScopeSharedPtr(stats_store.createScope("wasm."));
+
+  envoy::extensions::wasm::v3::PluginConfig plugin_config;
+  *plugin_config.mutable_vm_config()->mutable_runtime() = "envoy.wasm.runtime.null";
+  auto config = Envoy::Extensions::Common::Wasm::WasmConfig(plugin_config);
+  auto wasm = std::make_unique<Envoy::Extensions::Common::Wasm::Wasm>(config, "", scope,
+                                                                      cluster_manager, *dispatcher);
+  auto context = std::make_shared<HeaderMapContext>(wasm.get());
+
+  Envoy::Http::TestRequestHeaderMapImpl headers{{":method", "GET"},
+                                                {":path", "/api/users?page=1"},
+                                                {":authority", "example.com"},
+                                                {":scheme", "https"},
+                                                {"user-agent", "curl/7.64.1"},
+                                                {"accept", "*/*"},
+                                                {"x-request-id", "a-request-id"},
+                                                {"x-forwarded-for", "10.0.0.1"}};
+  const std::vector<std::string> keys{"user-agent", "accept", "x-request-id", "x-missing"};
+  context->setRequestHeaders(&headers);
+  std::string_view value;
+  Envoy::Extensions::Common::Wasm::Pairs pairs;
+  std::string marshalled;
+
+  for (__attribute__((unused)) auto _ : state) {
+    for (const auto& key : keys) {
+      context->getHeaderMapValue(proxy_wasm::WasmHeaderMapType::RequestHeaders, key, &value);
+    }
+    context->getHeaderMapPairs(proxy_wasm::WasmHeaderMapType::RequestHeaders, &pairs);
+    marshalled.resize(proxy_wasm::exports::pairsSize(pairs));
+    proxy_wasm::exports::marshalPairs(pairs, marshalled.data());
+    const std::vector<std::pair<std::string, std::string>> copies(pairs.begin(), pairs.end());
+    const Envoy::Extensions::Common::Wasm::Pairs new_pairs(copies.begin(), copies.end());
+    context->setHeaderMapPairs(proxy_wasm::WasmHeaderMapType::RequestHeaders, new_pairs);
+    benchmark::DoNotOptimize(marshalled);
+  }
+}
+
+BENCHMARK(bmWasmHeaderMapSpeedTest);
+
 } // namespace Envoy
 
 int main(int argc, char** argv) {
@@ -0,0 +1,158 @@
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/compression/zstd/compressor/config.h"
+#include "source/extensions/compression/zstd/decompressor/config.h"
+
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Compressor {
+namespace {
+
+class ZstdCompressorImplTest : public testing::Test {
+protected:
+  void drainBuffer(Buffer::OwnedImpl& buffer) { buffer.drain(buffer.length()); }
+
+  static std::string dictionaryPath(uint32_t id) {
+    return TestEnvironment::runfilesPath(
+        absl::StrCat("test/extensions/compression/zstd/test_data/dictionary_", id));
+  }
+
+  void verifyWithDecompressor(Envoy::Compression::Compressor::CompressorPtr compressor,
+                              const std::string& decompressor_json = "{}") {
+    Buffer::OwnedImpl buffer;
+    Buffer::OwnedImpl accumulation_buffer;
+    std::string original_text{};
+    for (uint64_t i = 0; i < 10; i++) {
+      TestUtility::feedBufferWithRandomCharacters(buffer, default_input_size * i, i);
+      original_text.append(buffer.toString());
+      ASSERT_EQ(default_input_size * i, buffer.length());
+      compressor->compress(buffer, Envoy::Compression::Compressor::State::Flush);
+      accumulation_buffer.add(buffer);
+      drainBuffer(buffer);
+      ASSERT_EQ(0, buffer.length());
+    }
+
+    compressor->compress(buffer, Envoy::Compression::Compressor::State::Finish);
+    accumulation_buffer.add(buffer);
+    drainBuffer(buffer);
+
+    envoy::extensions::compression::zstd::decompressor::v3::Zstd zstd;
+    TestUtility::loadFromJson(decompressor_json, zstd);
+    Decompressor::ZstdDecompressorFactory factory(zstd, stats_store_, *api_);
+    Envoy::Compression::Decompressor::DecompressorPtr decompressor =
+        factory.createDecompressor("test.");
+
+    decompressor->decompress(accumulation_buffer, buffer);
+    std::string decompressed_text{buffer.toString()};
+
+    ASSERT_EQ(original_text.length(), decompressed_text.length());
+    EXPECT_EQ(original_text, decompressed_text);
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  Api::ApiPtr api_{Api::createApiForTest()};
+
+  static constexpr uint32_t default_compression_level{6};
+  static constexpr uint32_t default_input_size{796};
+};
+
+TEST_F(ZstdCompressorImplTest, CompressorDeathTest) {
+  EXPECT_DEATH(
+      { ZstdCompressorImpl compressor(100, false, 0, nullptr, 4096); },
+      "assert failure: static_cast<int>\\(compression_level\\) <= ZSTD_maxCLevel\\(\\)");
+  EXPECT_DEATH(
+      { ZstdCompressorImpl compressor(default_compression_level, false, 100, nullptr, 4096); },
+      "assert failure: strategy <= ZSTD_btultra2");
+}
+
+TEST_F(ZstdCompressorImplTest, CallingFinishOnly) {
+  Buffer::OwnedImpl buffer;
+  ZstdCompressorImpl compressor(default_compression_level, false, 0, nullptr, 4096);
+
+  TestUtility::feedBufferWithRandomCharacters(buffer, 4096);
+  compressor.compress(buffer, Envoy::Compression::Compressor::State::Finish);
+}
+
+TEST_F(ZstdCompressorImplTest, CallingFlushOnly) {
+  Buffer::OwnedImpl buffer;
+  ZstdCompressorImpl compressor(default_compression_level, false, 0, nullptr, 4096);
+
+  TestUtility::feedBufferWithRandomCharacters(buffer, 4096);
+  compressor.compress(buffer, Envoy::Compression::Compressor::State::Flush);
+}
+
+TEST_F(ZstdCompressorImplTest, CompressWithSmallChunkSize) {
+  auto compressor =
+      std::make_unique<ZstdCompressorImpl>(default_compression_level, true, 0, nullptr, 8);
+  verifyWithDecompressor(std::move(compressor));
+}
+
+class ConfigTest : public ZstdCompressorImplTest,
+                   public testing::WithParamInterface<std::string> {};
+
+INSTANTIATE_TEST_SUITE_P(ConfigTestSuite, ConfigTest,
+                         testing::Values("DEFAULT", "FAST", "DFAST", "GREEDY", "LAZY", "LAZY2",
+                                         "BTLAZY2", "BTOPT", "BTULTRA", "BTULTRA2"));
+
+TEST_P(ConfigTest, LoadConfig) {
+  absl::string_view strategy = GetParam();
+
+  std::string json{fmt::format(R"EOF({{
+  "compression_level": 7,
+  "enable_checksum": true,
+  "strategy": "{}",
+  "chunk_size": 4096
+}})EOF",
+                               strategy)};
+  envoy::extensions::compression::zstd::compressor::v3::Zstd zstd;
+  TestUtility::loadFromJson(json, zstd);
+
+  ZstdCompressorLibraryFactory lib_factory;
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  Envoy::Compression::Compressor::CompressorFactoryPtr factory =
+      lib_factory.createCompressorFactoryFromProto(zstd, context);
+  EXPECT_EQ("zstd.", factory->statsPrefix());
+  EXPECT_EQ("zstd", factory->contentEncoding());
+
+  verifyWithDecompressor(factory->createCompressor());
+}
+
+// The content compressed with a dictionary is decompressed with the dictionary of the same ID.
+TEST_F(ZstdCompressorImplTest, CompressWithDictionary) {
+  envoy::extensions::compression::zstd::compressor::v3::Zstd zstd;
+  zstd.mutable_dictionary()->set_inline_bytes(
+      TestEnvironment::readFileToStringForTest(dictionaryPath(2)));
+  ZstdCompressorFactory factory(zstd, *api_);
+
+  const std::string decompressor_json{fmt::format(R"EOF({{
+  "dictionaries": [
+    {{ "filename": "{}" }},
+    {{ "filename": "{}" }}
+  ]
+}})EOF",
+                                                  dictionaryPath(1), dictionaryPath(2))};
+  verifyWithDecompressor(factory.createCompressor(), decompressor_json);
+  EXPECT_EQ(0, stats_store_.counterFromString("test.zstd_dictionary_error").value());
+}
+
+TEST_F(ZstdCompressorImplTest, DictionaryWithoutId) {
+  envoy::extensions::compression::zstd::compressor::v3::Zstd zstd;
+  zstd.mutable_dictionary()->set_inline_string("raw content");
+  EXPECT_THROW_WITH_MESSAGE(ZstdCompressorFactory(zstd, *api_), EnvoyException,
+                            "zstd dictionary has no ID, it has to be trained with zstd --train");
+}
+
+} // namespace
+} // namespace Compressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
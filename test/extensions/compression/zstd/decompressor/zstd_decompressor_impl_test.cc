@@ -0,0 +1,248 @@
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/compression/zstd/compressor/config.h"
+#include "source/extensions/compression/zstd/decompressor/config.h"
+
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Decompressor {
+namespace {
+
+class ZstdDecompressorImplTest : public testing::Test {
+protected:
+  void drainBuffer(Buffer::OwnedImpl& buffer) { buffer.drain(buffer.length()); }
+
+  static std::string dictionary(uint32_t id) {
+    return TestEnvironment::readFileToStringForTest(TestEnvironment::runfilesPath(
+        absl::StrCat("test/extensions/compression/zstd/test_data/dictionary_", id)));
+  }
+
+  // Compresses 20 chunks of random characters into accumulation_buffer.
+  // @return the original text.
+  std::string compress(Envoy::Compression::Compressor::Compressor& compressor,
+                       Buffer::OwnedImpl& accumulation_buffer) {
+    Buffer::OwnedImpl buffer;
+    std::string original_text{};
+    for (uint64_t i = 0; i < 20; ++i) {
+      TestUtility::feedBufferWithRandomCharacters(buffer, default_input_size * i, i);
+      original_text.append(buffer.toString());
+      compressor.compress(buffer, Envoy::Compression::Compressor::State::Flush);
+      accumulation_buffer.add(buffer);
+      drainBuffer(buffer);
+    }
+
+    compressor.compress(buffer, Envoy::Compression::Compressor::State::Finish);
+    accumulation_buffer.add(buffer);
+    return original_text;
+  }
+
+  // Compresses with a compressor of the config.
+  std::string compress(const envoy::extensions::compression::zstd::compressor::v3::Zstd& zstd,
+                       Buffer::OwnedImpl& accumulation_buffer) {
+    Zstd::Compressor::ZstdCompressorFactory factory(zstd, *api_);
+    return compress(*factory.createCompressor(), accumulation_buffer);
+  }
+
+  std::unique_ptr<ZstdDecompressorImpl> makeDecompressor(uint32_t chunk_size) {
+    return std::make_unique<ZstdDecompressorImpl>(stats_store_, "test.",
+                                                  std::make_shared<ZstdDDictMap>(), chunk_size);
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  Api::ApiPtr api_{Api::createApiForTest()};
+
+  static constexpr uint32_t default_compression_level{3};
+  static constexpr uint32_t default_input_size{796};
+};
+
+// Exercises compression and decompression by compressing some data, decompressing it and then
+// comparing compressor's input with decompressor's output.
+TEST_F(ZstdDecompressorImplTest, CompressAndDecompress) {
+  Buffer::OwnedImpl buffer;
+  Buffer::OwnedImpl accumulation_buffer;
+
+  Zstd::Compressor::ZstdCompressorImpl compressor{default_compression_level, true, 0, nullptr,
+                                                  4096};
+  const std::string original_text = compress(compressor, accumulation_buffer);
+
+  std::string json{R"EOF({
+  "chunk_size": 4096
+})EOF"};
+  envoy::extensions::compression::zstd::decompressor::v3::Zstd zstd;
+  TestUtility::loadFromJson(json, zstd);
+
+  ZstdDecompressorLibraryFactory lib_factory;
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  Envoy::Compression::Decompressor::DecompressorFactoryPtr factory =
+      lib_factory.createDecompressorFactoryFromProto(zstd, context);
+  EXPECT_EQ("zstd.", factory->statsPrefix());
+  EXPECT_EQ("zstd", factory->contentEncoding());
+
+  Envoy::Compression::Decompressor::DecompressorPtr decompressor =
+      factory->createDecompressor("test.");
+  decompressor->decompress(accumulation_buffer, buffer);
+  std::string decompressed_text{buffer.toString()};
+  ASSERT_EQ(original_text.length(), decompressed_text.length());
+  EXPECT_EQ(original_text, decompressed_text);
+}
+
+// Exercises decompression with a very small output buffer.
+TEST_F(ZstdDecompressorImplTest, DecompressWithSmallOutputBuffer) {
+  Buffer::OwnedImpl buffer;
+  Buffer::OwnedImpl accumulation_buffer;
+
+  Zstd::Compressor::ZstdCompressorImpl compressor{default_compression_level, false, 0, nullptr,
+                                                  4096};
+  const std::string original_text = compress(compressor, accumulation_buffer);
+
+  auto decompressor = makeDecompressor(16);
+  decompressor->decompress(accumulation_buffer, buffer);
+  std::string decompressed_text{buffer.toString()};
+
+  ASSERT_EQ(original_text.length(), decompressed_text.length());
+  EXPECT_EQ(original_text, decompressed_text);
+  EXPECT_EQ(0, stats_store_.counterFromString("test.zstd_generic_error").value());
+}
+
+TEST_F(ZstdDecompressorImplTest, WrongInput) {
+  Buffer::OwnedImpl buffer;
+  Buffer::OwnedImpl output_buffer;
+  const char zeros[20]{};
+
+  Buffer::BufferFragmentImpl* frag = new Buffer::BufferFragmentImpl(
+      zeros, 20, [](const void*, size_t, const Buffer::BufferFragmentImpl* frag) { delete frag; });
+  buffer.addBufferFragment(*frag);
+  auto decompressor = makeDecompressor(16);
+  decompressor->decompress(buffer, output_buffer);
+  EXPECT_EQ(1, stats_store_.counterFromString("test.zstd_generic_error").value());
+}
+
+TEST_F(ZstdDecompressorImplTest, WrongChecksum) {
+  Buffer::OwnedImpl buffer;
+  Buffer::OwnedImpl accumulation_buffer;
+
+  Zstd::Compressor::ZstdCompressorImpl compressor{default_compression_level, true, 0, nullptr,
+                                                  4096};
+  compress(compressor, accumulation_buffer);
+
+  // The checksum is the last 4 bytes of the frame.
+  std::string compressed = accumulation_buffer.toString();
+  compressed.back() ^= 0xff;
+  Buffer::OwnedImpl corrupted(compressed);
+
+  auto decompressor = makeDecompressor(4096);
+  decompressor->decompress(corrupted, buffer);
+  EXPECT_EQ(1, stats_store_.counterFromString("test.zstd_checksum_wrong_error").value());
+}
+
+TEST_F(ZstdDecompressorImplTest, CompressDecompressOfMultipleSlices) {
+  Buffer::OwnedImpl buffer;
+  Buffer::OwnedImpl accumulation_buffer;
+
+  const std::string sample{"slice, slice, slice, slice, slice, "};
+  std::string original_text;
+  for (uint64_t i = 0; i < 20; ++i) {
+    Buffer::BufferFragmentImpl* frag = new Buffer::BufferFragmentImpl(
+        sample.c_str(), sample.size(),
+        [](const void*, size_t, const Buffer::BufferFragmentImpl* frag) { delete frag; });
+
+    buffer.addBufferFragment(*frag);
+    original_text.append(sample);
+  }
+
+  const uint64_t num_slices = buffer.getRawSlices().size();
+  EXPECT_EQ(num_slices, 20);
+
+  Zstd::Compressor::ZstdCompressorImpl compressor{default_compression_level, false, 0, nullptr,
+                                                  4096};
+  compressor.compress(buffer, Envoy::Compression::Compressor::State::Flush);
+  accumulation_buffer.add(buffer);
+
+  auto decompressor = makeDecompressor(16);
+
+  drainBuffer(buffer);
+  ASSERT_EQ(0, buffer.length());
+
+  decompressor->decompress(accumulation_buffer, buffer);
+  std::string decompressed_text{buffer.toString()};
+
+  ASSERT_EQ(original_text.length(), decompressed_text.length());
+  EXPECT_EQ(original_text, decompressed_text);
+  EXPECT_EQ(0, stats_store_.counterFromString("test.zstd_generic_error").value());
+}
+
+// The frames compressed with different dictionaries, or none, are each decompressed with the
+// dictionary of their ID.
+TEST_F(ZstdDecompressorImplTest, DecompressWithDictionaries) {
+  Buffer::OwnedImpl buffer;
+  Buffer::OwnedImpl accumulation_buffer;
+
+  envoy::extensions::compression::zstd::compressor::v3::Zstd compressor_config;
+  compressor_config.mutable_dictionary()->set_inline_bytes(dictionary(1));
+  std::string original_text = compress(compressor_config, accumulation_buffer);
+  compressor_config.mutable_dictionary()->set_inline_bytes(dictionary(2));
+  original_text.append(compress(compressor_config, accumulation_buffer));
+  compressor_config.clear_dictionary();
+  original_text.append(compress(compressor_config, accumulation_buffer));
+
+  envoy::extensions::compression::zstd::decompressor::v3::Zstd zstd;
+  zstd.add_dictionaries()->set_inline_bytes(dictionary(1));
+  zstd.add_dictionaries()->set_inline_bytes(dictionary(2));
+  ZstdDecompressorFactory factory(zstd, stats_store_, *api_);
+  Envoy::Compression::Decompressor::DecompressorPtr decompressor =
+      factory.createDecompressor("test.");
+
+  decompressor->decompress(accumulation_buffer, buffer);
+  std::string decompressed_text{buffer.toString()};
+
+  ASSERT_EQ(original_text.length(), decompressed_text.length());
+  EXPECT_EQ(original_text, decompressed_text);
+  EXPECT_EQ(0, stats_store_.counterFromString("test.zstd_dictionary_error").value());
+}
+
+TEST_F(ZstdDecompressorImplTest, UnknownDictionary) {
+  Buffer::OwnedImpl buffer;
+  Buffer::OwnedImpl accumulation_buffer;
+
+  envoy::extensions::compression::zstd::compressor::v3::Zstd compressor_config;
+  compressor_config.mutable_dictionary()->set_inline_bytes(dictionary(2));
+  compress(compressor_config, accumulation_buffer);
+
+  envoy::extensions::compression::zstd::decompressor::v3::Zstd zstd;
+  zstd.add_dictionaries()->set_inline_bytes(dictionary(1));
+  ZstdDecompressorFactory factory(zstd, stats_store_, *api_);
+  Envoy::Compression::Decompressor::DecompressorPtr decompressor =
+      factory.createDecompressor("test.");
+
+  decompressor->decompress(accumulation_buffer, buffer);
+  EXPECT_EQ(0, buffer.length());
+  EXPECT_EQ(1, stats_store_.counterFromString("test.zstd_dictionary_error").value());
+}
+
+TEST_F(ZstdDecompressorImplTest, InvalidDictionaries) {
+  envoy::extensions::compression::zstd::decompressor::v3::Zstd zstd;
+  zstd.add_dictionaries()->set_inline_string("raw content");
+  EXPECT_THROW_WITH_MESSAGE(ZstdDecompressorFactory(zstd, stats_store_, *api_), EnvoyException,
+                            "zstd dictionary has no ID, it has to be trained with zstd --train");
+
+  zstd.clear_dictionaries();
+  zstd.add_dictionaries()->set_inline_bytes(dictionary(1));
+  zstd.add_dictionaries()->set_inline_bytes(dictionary(1));
+  EXPECT_THROW_WITH_MESSAGE(ZstdDecompressorFactory(zstd, stats_store_, *api_), EnvoyException,
+                            "duplicate zstd dictionary ID 1");
+}
+
+} // namespace
+} // namespace Decompressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,54 @@
+// Measures the evaluation of an expression matching a request header, with an activation providing
+// all the context attributes and with one providing only the attributes the expression references.
+
+#include "source/extensions/filters/common/expr/evaluator.h"
+
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace Expr {
+namespace {
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_MatchRequestHeader(benchmark::State& state) {
+  google::api::expr::v1alpha1::Expr condition;
+  TestUtility::loadFromYaml(R"EOF(
+call_expr:
+  function: _==_
+  args:
+  - call_expr:
+      function: _[_]
+      args:
+      - select_expr:
+          operand: {ident_expr: {name: request}}
+          field: headers
+      - const_expr: {string_value: x-tenant}
+  - const_expr: {string_value: foo}
+)EOF",
+                            condition);
+  Protobuf::Arena constant_arena;
+  BuilderPtr builder = createBuilder(&constant_arena);
+  ExpressionPtr expr = createExpression(*builder, condition);
+  const ContextAttributes attributes =
+      state.range(0) != 0 ? referencedAttributes(condition) : AllContextAttributes;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  Http::TestRequestHeaderMapImpl headers{{":path", "/"}, {"x-tenant", "foo"}};
+
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(matches(*expr, info, headers, attributes));
+  }
+}
+BENCHMARK(BM_MatchRequestHeader)->Arg(0)->Arg(1);
+
+} // namespace
+} // namespace Expr
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
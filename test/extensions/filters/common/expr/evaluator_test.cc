@@ -1,5 +1,6 @@
 #include "source/extensions/filters/common/expr/evaluator.h"
 
+#include "test/mocks/stream_info/mocks.h"
 #include "test/test_common/utility.h"
 
 #include "absl/time/time.h"
@@ -40,6 +41,60 @@ TEST(Evaluator, Print) {
   EXPECT_EQ(print(CelValue::CreateError(&status)), "CelError value");
 }
 
+TEST(Evaluator, ReferencedAttributes) {
+  google::api::expr::v1alpha1::Expr expr;
+  TestUtility::loadFromYaml(R"EOF(
+call_expr:
+  function: _&&_
+  args:
+  - call_expr:
+      function: _==_
+      args:
+      - select_expr:
+          operand: {ident_expr: {name: request}}
+          field: path
+      - const_expr: {string_value: /}
+  - ident_expr: {name: connection.mtls}
+)EOF",
+                            expr);
+  const ContextAttributes attributes = referencedAttributes(expr);
+  EXPECT_EQ(2U, attributes.count());
+
+  Protobuf::Arena arena;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  ActivationPtr activation = createActivation(arena, info, nullptr, nullptr, nullptr, attributes);
+  EXPECT_TRUE(activation->FindValue(Request, &arena).has_value());
+  EXPECT_TRUE(activation->FindValue(Connection, &arena).has_value());
+  EXPECT_FALSE(activation->FindValue(Response, &arena).has_value());
+  EXPECT_FALSE(activation->FindValue(Metadata, &arena).has_value());
+
+  google::api::expr::v1alpha1::Expr constant;
+  TestUtility::loadFromYaml("const_expr: {bool_value: true}", constant);
+  EXPECT_TRUE(referencedAttributes(constant).none());
+}
+
+// An expression evaluates the same with the attributes it references as with all of them.
+TEST(Evaluator, MatchesWithReferencedAttributes) {
+  google::api::expr::v1alpha1::Expr condition;
+  TestUtility::loadFromYaml(R"EOF(
+call_expr:
+  function: _==_
+  args:
+  - select_expr:
+      operand: {ident_expr: {name: request}}
+      field: path
+  - const_expr: {string_value: /foo}
+)EOF",
+                            condition);
+  BuilderPtr builder = createBuilder(nullptr);
+  ExpressionPtr expr = createExpression(*builder, condition);
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  Http::TestRequestHeaderMapImpl headers{{":path", "/foo"}};
+  EXPECT_TRUE(matches(*expr, info, headers));
+  EXPECT_TRUE(matches(*expr, info, headers, referencedAttributes(condition)));
+  EXPECT_FALSE(matches(*expr, info, headers, ContextAttributes()));
+}
+
 } // namespace
 } // namespace Expr
 } // namespace Common
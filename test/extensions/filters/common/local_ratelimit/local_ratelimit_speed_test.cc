@@ -0,0 +1,87 @@
+// Measures the requests allowed by a local rate limiter shared by the threads, taking their tokens
+// from a single bucket, from a bucket split in a shard per thread and from the bucket of the client
+// of each thread.
+
+#include <cstdint>
+#include <limits>
+
+#include "source/extensions/filters/common/local_ratelimit/local_ratelimit_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "fmt/format.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace LocalRateLimit {
+namespace {
+
+// The buckets are large enough not to run out of tokens while measured.
+constexpr uint32_t MaxTokens = std::numeric_limits<uint32_t>::max();
+
+LocalRateLimiterImpl* createRateLimiter(uint32_t shards, uint32_t max_value_buckets) {
+  static Event::MockDispatcher* dispatcher = new NiceMock<Event::MockDispatcher>();
+  Protobuf::RepeatedPtrField<envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>
+      descriptors;
+  if (max_value_buckets > 0) {
+    TestUtility::loadFromYaml(fmt::format(R"EOF(
+entries:
+- key: client
+  value: any
+token_bucket:
+  max_tokens: {}
+  fill_interval: 1s
+max_value_buckets: {}
+)EOF",
+                                          MaxTokens, max_value_buckets),
+                              *descriptors.Add());
+  }
+  return new LocalRateLimiterImpl(std::chrono::seconds(1), MaxTokens, 1, *dispatcher, descriptors,
+                                  shards);
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_SharedBucket(benchmark::State& state) {
+  static LocalRateLimiterImpl* rate_limiter = createRateLimiter(1, 0);
+  const std::vector<RateLimit::LocalDescriptor> descriptors;
+
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(rate_limiter->requestAllowed(descriptors));
+  }
+}
+BENCHMARK(BM_SharedBucket)->Threads(1)->Threads(8)->Threads(64)->UseRealTime();
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ShardedBucket(benchmark::State& state) {
+  static LocalRateLimiterImpl* rate_limiter = createRateLimiter(64, 0);
+  const std::vector<RateLimit::LocalDescriptor> descriptors;
+
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(rate_limiter->requestAllowed(descriptors));
+  }
+}
+BENCHMARK(BM_ShardedBucket)->Threads(1)->Threads(8)->Threads(64)->UseRealTime();
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ValueBuckets(benchmark::State& state) {
+  static LocalRateLimiterImpl* rate_limiter = createRateLimiter(1, 1024);
+  const std::vector<RateLimit::LocalDescriptor> descriptors{
+      {{{"client", absl::StrCat("10.0.0.", state.thread_index)}}}};
+
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(rate_limiter->requestAllowed(descriptors));
+  }
+}
+BENCHMARK(BM_ValueBuckets)->Threads(1)->Threads(8)->Threads(64)->UseRealTime();
+
+} // namespace
+} // namespace LocalRateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
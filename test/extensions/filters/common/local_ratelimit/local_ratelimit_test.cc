@@ -24,12 +24,12 @@ public:
   }
 
   void initialize(const std::chrono::milliseconds fill_interval, const uint32_t max_tokens,
-                  const uint32_t tokens_per_fill) {
+                  const uint32_t tokens_per_fill, const uint32_t shards = 1) {
 
     initializeTimer();
 
     rate_limiter_ = std::make_shared<LocalRateLimiterImpl>(
-        fill_interval, max_tokens, tokens_per_fill, dispatcher_, descriptors_);
+        fill_interval, max_tokens, tokens_per_fill, dispatcher_, descriptors_, shards);
   }
 
   Thread::ThreadSynchronizer& synchronizer() { return rate_limiter_->synchronizer_; }
@@ -172,6 +172,53 @@ TEST_F(LocalRateLimiterImplTest, TokenBucketMaxTokensGreaterThanTokensPerFill) {
   EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_));
 }
 
+// Verify that a thread takes the tokens of all the shards of a sharded token bucket.
+TEST_F(LocalRateLimiterImplTest, ShardedTokenBucket) {
+  initialize(std::chrono::milliseconds(200), 5, 5, 4);
+
+  // 5 -> 0 tokens
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  }
+  EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_));
+
+  // 0 -> 5 tokens
+  EXPECT_CALL(*fill_timer_, enableTimer(std::chrono::milliseconds(200), nullptr));
+  fill_timer_->invokeCallback();
+
+  // 5 -> 5 tokens
+  EXPECT_CALL(*fill_timer_, enableTimer(std::chrono::milliseconds(200), nullptr));
+  fill_timer_->invokeCallback();
+
+  // 5 -> 0 tokens
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  }
+  EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_));
+}
+
+// Verify that the tokens of a fill which a full shard can't take go to the other shards.
+TEST_F(LocalRateLimiterImplTest, ShardedTokenBucketFewerTokensPerFill) {
+  initialize(std::chrono::milliseconds(200), 4, 1, 4);
+
+  // 4 -> 1 tokens
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  }
+
+  // 1 -> 4 tokens
+  for (int i = 0; i < 4; i++) {
+    EXPECT_CALL(*fill_timer_, enableTimer(std::chrono::milliseconds(200), nullptr));
+    fill_timer_->invokeCallback();
+  }
+
+  // 4 -> 0 tokens
+  for (int i = 0; i < 4; i++) {
+    EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  }
+  EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_));
+}
+
 class LocalRateLimiterDescriptorImplTest : public LocalRateLimiterImplTest {
 public:
   void initializeWithDescriptor(const std::chrono::milliseconds fill_interval,
@@ -394,6 +441,67 @@ TEST_F(LocalRateLimiterDescriptorImplTest, TokenBucketDifferentDescriptorDiffere
   EXPECT_FALSE(rate_limiter_->requestAllowed(descriptor_));
 }
 
+const std::string value_buckets_config_yaml = R"(
+  entries:
+  - key: client
+    value: any
+  token_bucket:
+    max_tokens: 1
+    tokens_per_fill: 1
+    fill_interval: 0.1s
+  max_value_buckets: 2
+  )";
+
+// Verify that each set of values of a descriptor with value buckets gets a bucket of its own.
+TEST_F(LocalRateLimiterDescriptorImplTest, ValueBuckets) {
+  TestUtility::loadFromYaml(value_buckets_config_yaml, *descriptors_.Add());
+  initializeWithDescriptor(std::chrono::milliseconds(50), 1, 1);
+  const std::vector<RateLimit::LocalDescriptor> foo{{{{"client", "foo"}}}};
+  const std::vector<RateLimit::LocalDescriptor> bar{{{{"client", "bar"}}}};
+
+  // 1 -> 0 tokens for foo and bar
+  EXPECT_TRUE(rate_limiter_->requestAllowed(foo));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(foo));
+  EXPECT_TRUE(rate_limiter_->requestAllowed(bar));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(bar));
+
+  // The descriptors of other keys use the default token bucket.
+  EXPECT_TRUE(rate_limiter_->requestAllowed(descriptor_));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(descriptor_));
+
+  // 0 -> 1 tokens for foo, as its bucket is used.
+  dispatcher_.time_system_.advanceTimeWait(std::chrono::milliseconds(100));
+  EXPECT_TRUE(rate_limiter_->requestAllowed(foo));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(foo));
+}
+
+// Verify that the least recently used value bucket is dropped for new values.
+TEST_F(LocalRateLimiterDescriptorImplTest, ValueBucketsEvictLeastRecentlyUsed) {
+  TestUtility::loadFromYaml(value_buckets_config_yaml, *descriptors_.Add());
+  initializeWithDescriptor(std::chrono::milliseconds(50), 1, 1);
+  const std::vector<RateLimit::LocalDescriptor> foo{{{{"client", "foo"}}}};
+  const std::vector<RateLimit::LocalDescriptor> bar{{{{"client", "bar"}}}};
+  const std::vector<RateLimit::LocalDescriptor> baz{{{{"client", "baz"}}}};
+
+  EXPECT_TRUE(rate_limiter_->requestAllowed(foo));
+  EXPECT_TRUE(rate_limiter_->requestAllowed(bar));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(foo));
+  // The bucket of bar is dropped for baz, so that bar starts again with a full bucket.
+  EXPECT_TRUE(rate_limiter_->requestAllowed(baz));
+  EXPECT_TRUE(rate_limiter_->requestAllowed(bar));
+  // The bucket of foo was dropped for bar.
+  EXPECT_TRUE(rate_limiter_->requestAllowed(foo));
+}
+
+TEST_F(LocalRateLimiterDescriptorImplTest, DuplicateValueBuckets) {
+  TestUtility::loadFromYaml(value_buckets_config_yaml, *descriptors_.Add());
+  TestUtility::loadFromYaml(value_buckets_config_yaml, *descriptors_.Add());
+
+  EXPECT_THROW_WITH_MESSAGE(
+      LocalRateLimiterImpl(std::chrono::milliseconds(50), 1, 1, dispatcher_, descriptors_),
+      EnvoyException, "duplicate descriptor in the local rate descriptor: client");
+}
+
 } // Namespace LocalRateLimit
 } // namespace Common
 } // namespace Filters
@@ -160,6 +160,71 @@ TEST_F(LuaTest, MarkDead) {
   lua_gc(cr1->luaState(), LUA_GCCOLLECT, 0);
 }
 
+// Only the threads of the coroutines that returned are reused.
+TEST_F(LuaTest, CoroutineReused) {
+  const std::string SCRIPT{R"EOF(
+    function callMe(object)
+      object:testCall()
+      return "done"
+    end
+
+    function yieldMe()
+      coroutine.yield()
+    end
+
+    function failMe()
+      error("failed")
+    end
+  )EOF"};
+
+  setup(SCRIPT);
+  const int call_me = state_->getGlobalRef(state_->registerGlobal("callMe", initializers_));
+  const int yield_me = state_->getGlobalRef(state_->registerGlobal("yieldMe", initializers_));
+  const int fail_me = state_->getGlobalRef(state_->registerGlobal("failMe", initializers_));
+
+  CoroutinePtr cr(state_->createCoroutine());
+  EXPECT_FALSE(cr->reused());
+  lua_State* thread = cr->luaState();
+  LuaRef<TestObject> ref(TestObject::create(cr->luaState()), true);
+  EXPECT_CALL(*ref.get(), doTestCall(_));
+  cr->start(call_me, 1, yield_callback_);
+  EXPECT_EQ(cr->state(), Coroutine::State::Finished);
+  cr.reset();
+
+  // The reused thread starts with an empty stack.
+  cr = state_->createCoroutine();
+  EXPECT_TRUE(cr->reused());
+  EXPECT_EQ(thread, cr->luaState());
+  EXPECT_EQ(0, lua_gettop(cr->luaState()));
+  ref.pushStack();
+  EXPECT_CALL(*ref.get(), doTestCall(_));
+  cr->start(call_me, 1, yield_callback_);
+  EXPECT_EQ(cr->state(), Coroutine::State::Finished);
+  EXPECT_STREQ("done", lua_tostring(cr->luaState(), -1));
+  cr.reset();
+
+  // A yielded coroutine isn't reused.
+  cr = state_->createCoroutine();
+  EXPECT_TRUE(cr->reused());
+  EXPECT_CALL(on_yield_, ready());
+  cr->start(yield_me, 0, yield_callback_);
+  EXPECT_EQ(cr->state(), Coroutine::State::Yielded);
+  cr.reset();
+  cr = state_->createCoroutine();
+  EXPECT_FALSE(cr->reused());
+
+  // Nor is a coroutine that failed.
+  EXPECT_THROW(cr->start(fail_me, 0, yield_callback_), LuaException);
+  cr.reset();
+  cr = state_->createCoroutine();
+  EXPECT_FALSE(cr->reused());
+  cr.reset();
+
+  EXPECT_CALL(*ref.get(), onDestroy());
+  ref.reset();
+  lua_gc(state_->createCoroutine()->luaState(), LUA_GCCOLLECT, 0);
+}
+
 class ThreadSafeTest : public testing::Test {
 public:
   ThreadSafeTest()
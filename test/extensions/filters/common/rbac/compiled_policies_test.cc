@@ -0,0 +1,203 @@
+#include "envoy/config/rbac/v3/rbac.pb.h"
+
+#include "source/common/network/address_impl.h"
+#include "source/common/network/utility.h"
+#include "source/extensions/filters/common/rbac/compiled_policies.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RBAC {
+namespace {
+
+class CompiledPoliciesTest : public testing::Test {
+public:
+  void setup(const std::string& yaml) {
+    envoy::config::rbac::v3::RBAC rules;
+    TestUtility::loadFromYaml(yaml, rules);
+    policies_ = std::make_unique<CompiledPolicies>(rules, nullptr);
+  }
+
+  std::string firstMatch(const Envoy::Http::RequestHeaderMap& headers) {
+    const std::string* policy = policies_->firstMatch(connection_, headers, info_);
+    return policy == nullptr ? "" : *policy;
+  }
+
+  std::string firstMatchFrom(const std::string& address) {
+    connection_.stream_info_.downstream_address_provider_->setRemoteAddress(
+        Network::Utility::parseInternetAddress(address, 1234, false));
+    return firstMatch(Envoy::Http::TestRequestHeaderMapImpl());
+  }
+
+  NiceMock<Envoy::Network::MockConnection> connection_;
+  NiceMock<StreamInfo::MockStreamInfo> info_;
+  std::unique_ptr<CompiledPolicies> policies_;
+};
+
+// The identical rules of the policies are compiled once.
+TEST_F(CompiledPoliciesTest, SharesIdenticalRules) {
+  setup(R"EOF(
+policies:
+  foo:
+    permissions:
+    - header: {name: x-user, exact_match: alice}
+    principals:
+    - any: true
+  bar:
+    permissions:
+    - header: {name: x-user, exact_match: alice}
+    principals:
+    - any: true
+  baz:
+    permissions:
+    - not_rule:
+        header: {name: x-user, exact_match: alice}
+    principals:
+    - any: true
+)EOF");
+  // The header rule, the always matching rule, the not rule and an or node for each set of rules.
+  EXPECT_EQ(6U, policies_->predicateCount());
+
+  EXPECT_EQ("bar", firstMatch(Envoy::Http::TestRequestHeaderMapImpl{{"x-user", "alice"}}));
+  EXPECT_EQ("baz", firstMatch(Envoy::Http::TestRequestHeaderMapImpl{{"x-user", "bob"}}));
+}
+
+// The policy matching first in name order is chosen.
+TEST_F(CompiledPoliciesTest, MatchesInNameOrder) {
+  setup(R"EOF(
+policies:
+  b:
+    permissions:
+    - any: true
+    principals:
+    - any: true
+  a:
+    permissions:
+    - destination_port: 123
+    principals:
+    - any: true
+  c:
+    permissions:
+    - any: true
+    principals:
+    - any: true
+)EOF");
+  EXPECT_EQ("b", firstMatch(Envoy::Http::TestRequestHeaderMapImpl()));
+  info_.downstream_address_provider_->setLocalAddress(
+      Network::Utility::parseInternetAddress("1.2.3.4", 123, false));
+  EXPECT_EQ("a", firstMatch(Envoy::Http::TestRequestHeaderMapImpl()));
+}
+
+// The nested ranges of the policies all match the addresses within them.
+TEST_F(CompiledPoliciesTest, MatchesIpRanges) {
+  setup(R"EOF(
+policies:
+  a:
+    permissions:
+    - any: true
+    principals:
+    - source_ip: {address_prefix: 10.1.2.0, prefix_len: 24}
+  b:
+    permissions:
+    - any: true
+    principals:
+    - source_ip: {address_prefix: 10.0.0.0, prefix_len: 8}
+    - source_ip: {address_prefix: "2001:db8::", prefix_len: 32}
+  c:
+    permissions:
+    - any: true
+    principals:
+    - and_ids:
+        ids:
+        - source_ip: {address_prefix: 10.0.0.0, prefix_len: 8}
+        - not_id:
+            source_ip: {address_prefix: 10.2.0.0, prefix_len: 16}
+  d:
+    permissions:
+    - any: true
+    principals:
+    - direct_remote_ip: {address_prefix: 10.0.0.0, prefix_len: 8}
+)EOF");
+  EXPECT_EQ("a", firstMatchFrom("10.1.2.3"));
+  EXPECT_EQ("b", firstMatchFrom("10.3.0.1"));
+  EXPECT_EQ("b", firstMatchFrom("2001:db8::1"));
+  EXPECT_EQ("", firstMatchFrom("11.0.0.1"));
+  EXPECT_EQ("", firstMatchFrom("2001:db9::1"));
+
+  connection_.stream_info_.downstream_address_provider_->setRemoteAddress(
+      std::make_shared<Envoy::Network::Address::PipeInstance>("/foo"));
+  EXPECT_EQ("", firstMatch(Envoy::Http::TestRequestHeaderMapImpl()));
+}
+
+// The exact header values of the policies are matched against the values of the headers.
+TEST_F(CompiledPoliciesTest, MatchesExactHeaders) {
+  setup(R"EOF(
+policies:
+  a:
+    permissions:
+    - header: {name: x-user, exact_match: alice}
+    principals:
+    - any: true
+  b:
+    permissions:
+    - header: {name: x-user, exact_match: bob}
+    - header: {name: x-group, exact_match: admin}
+    principals:
+    - any: true
+  c:
+    permissions:
+    - header: {name: x-user, exact_match: alice, invert_match: true}
+    principals:
+    - header: {name: x-group, exact_match: admin}
+  d:
+    permissions:
+    - header: {name: x-user, exact_match: "alice,bob"}
+    principals:
+    - any: true
+)EOF");
+  EXPECT_EQ("a", firstMatch(Envoy::Http::TestRequestHeaderMapImpl{{"x-user", "alice"}}));
+  EXPECT_EQ("b", firstMatch(Envoy::Http::TestRequestHeaderMapImpl{{"x-user", "bob"}}));
+  EXPECT_EQ("b", firstMatch(Envoy::Http::TestRequestHeaderMapImpl{{"x-group", "admin"}}));
+  EXPECT_EQ("d", firstMatch(Envoy::Http::TestRequestHeaderMapImpl{{"x-user", "alice"},
+                                                                  {"x-user", "bob"}}));
+  EXPECT_EQ("", firstMatch(Envoy::Http::TestRequestHeaderMapImpl{{"x-user", "carol"}}));
+  EXPECT_EQ("", firstMatch(Envoy::Http::TestRequestHeaderMapImpl()));
+}
+
+// The exact paths of the policies are matched against the path without its query and fragment.
+TEST_F(CompiledPoliciesTest, MatchesExactPaths) {
+  setup(R"EOF(
+policies:
+  a:
+    permissions:
+    - url_path: {path: {exact: /admin}}
+    principals:
+    - any: true
+  b:
+    permissions:
+    - url_path: {path: {exact: /Users, ignore_case: true}}
+    - url_path: {path: {exact: /groups}}
+    principals:
+    - any: true
+)EOF");
+  EXPECT_EQ("a", firstMatch(Envoy::Http::TestRequestHeaderMapImpl{{":path", "/admin?x=1"}}));
+  EXPECT_EQ("b", firstMatch(Envoy::Http::TestRequestHeaderMapImpl{{":path", "/users"}}));
+  EXPECT_EQ("b", firstMatch(Envoy::Http::TestRequestHeaderMapImpl{{":path", "/groups#top"}}));
+  EXPECT_EQ("", firstMatch(Envoy::Http::TestRequestHeaderMapImpl{{":path", "/Admin"}}));
+  EXPECT_EQ("", firstMatch(Envoy::Http::TestRequestHeaderMapImpl()));
+}
+
+} // namespace
+} // namespace RBAC
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
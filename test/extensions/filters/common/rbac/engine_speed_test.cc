@@ -0,0 +1,99 @@
+// Measures the evaluation of RBAC policies, one per tenant, matching the tenant header, a shared
+// path and the address range of the tenant, against a request only the last policy matches, one
+// policy matcher after the other and compiled.
+
+#include <map>
+
+#include "envoy/config/rbac/v3/rbac.pb.h"
+
+#include "source/common/network/utility.h"
+#include "source/extensions/filters/common/rbac/compiled_policies.h"
+#include "source/extensions/filters/common/rbac/matchers.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "fmt/format.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RBAC {
+namespace {
+
+envoy::config::rbac::v3::RBAC tenantPolicies(int64_t tenants) {
+  envoy::config::rbac::v3::RBAC rules;
+  for (int64_t i = 0; i < tenants; i++) {
+    envoy::config::rbac::v3::Policy policy;
+    TestUtility::loadFromYaml(fmt::format(R"EOF(
+permissions:
+- and_rules:
+    rules:
+    - header: {{name: x-tenant, exact_match: tenant-{}}}
+    - url_path: {{path: {{exact: /api}}}}
+principals:
+- source_ip: {{address_prefix: 10.{}.{}.0, prefix_len: 24}}
+)EOF",
+                                          i, i / 256, i % 256),
+                              policy);
+    (*rules.mutable_policies())[absl::StrCat("tenant-", 100000 + i)] = policy;
+  }
+  return rules;
+}
+
+class RequestOfLastTenant {
+public:
+  explicit RequestOfLastTenant(int64_t tenants)
+      : headers_{{":path", "/api?page=1"}, {"x-tenant", absl::StrCat("tenant-", tenants - 1)}} {
+    connection_.stream_info_.downstream_address_provider_->setRemoteAddress(
+        Network::Utility::parseInternetAddress(
+            fmt::format("10.{}.{}.1", (tenants - 1) / 256, (tenants - 1) % 256), 1234, false));
+  }
+
+  NiceMock<Envoy::Network::MockConnection> connection_;
+  NiceMock<StreamInfo::MockStreamInfo> info_;
+  Envoy::Http::TestRequestHeaderMapImpl headers_;
+};
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_PolicyMatchers(benchmark::State& state) {
+  const envoy::config::rbac::v3::RBAC rules = tenantPolicies(state.range(0));
+  std::map<std::string, std::unique_ptr<PolicyMatcher>> policies;
+  for (const auto& policy : rules.policies()) {
+    policies.emplace(policy.first, std::make_unique<PolicyMatcher>(policy.second, nullptr));
+  }
+  RequestOfLastTenant request(state.range(0));
+
+  for (auto _ : state) { // NOLINT
+    for (const auto& policy : policies) {
+      if (policy.second->matches(request.connection_, request.headers_, request.info_)) {
+        benchmark::DoNotOptimize(policy.first);
+        break;
+      }
+    }
+  }
+}
+BENCHMARK(BM_PolicyMatchers)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_CompiledPolicies(benchmark::State& state) {
+  const CompiledPolicies policies(tenantPolicies(state.range(0)), nullptr);
+  RequestOfLastTenant request(state.range(0));
+
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(
+        policies.firstMatch(request.connection_, request.headers_, request.info_));
+  }
+}
+BENCHMARK(BM_CompiledPolicies)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+} // namespace
+} // namespace RBAC
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
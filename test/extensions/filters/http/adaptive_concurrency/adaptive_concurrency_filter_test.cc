@@ -28,6 +28,7 @@ using Controller::RequestForwardingAction;
 class MockConcurrencyController : public Controller::ConcurrencyController {
 public:
   MOCK_METHOD(RequestForwardingAction, forwardingDecision, ());
+  MOCK_METHOD(RequestForwardingAction, forwardingDecision, (double));
   MOCK_METHOD(void, cancelLatencySample, ());
   MOCK_METHOD(void, recordLatencySample, (MonotonicTime));
 
@@ -253,6 +254,72 @@ TEST_F(AdaptiveConcurrencyFilterTest, DecodeHeadersTestBlock) {
             filter_->decodeHeaders(request_headers, true));
 }
 
+TEST_F(AdaptiveConcurrencyFilterTest, PriorityLimits) {
+  std::string yaml_config =
+      R"EOF(
+gradient_controller_config:
+  concurrency_limit_params:
+    concurrency_update_interval: 0.1s
+  min_rtt_calc_params:
+    interval: 30s
+priority_limits:
+  header: x-priority
+  priorities:
+  - priority: low
+    limit:
+      value: 25
+  - priority: high
+    limit:
+      value: 100
+  default_limit:
+    value: 50
+)EOF";
+
+  auto config_ptr = std::make_shared<AdaptiveConcurrencyFilterConfig>(
+      makeConfig(yaml_config), runtime_, "testprefix.", stats_, time_system_);
+  EXPECT_TRUE(config_ptr->hasPriorityLimits());
+  EXPECT_DOUBLE_EQ(0.25, config_ptr->limitFraction(
+                             Http::TestRequestHeaderMapImpl{{"x-priority", "low"}}));
+  EXPECT_DOUBLE_EQ(1.0, config_ptr->limitFraction(
+                            Http::TestRequestHeaderMapImpl{{"x-priority", "high"}}));
+  EXPECT_DOUBLE_EQ(0.5, config_ptr->limitFraction(
+                            Http::TestRequestHeaderMapImpl{{"x-priority", "other"}}));
+  EXPECT_DOUBLE_EQ(0.5, config_ptr->limitFraction(Http::TestRequestHeaderMapImpl{}));
+
+  filter_ = std::make_unique<AdaptiveConcurrencyFilter>(config_ptr, controller_);
+  filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+  filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+
+  // The controller is only given the share of its limit the priority of the request may use.
+  Http::TestRequestHeaderMapImpl request_headers{{"x-priority", "low"}};
+  EXPECT_CALL(*controller_, forwardingDecision(0.25))
+      .WillOnce(Return(RequestForwardingAction::Block));
+  EXPECT_CALL(decoder_callbacks_, sendLocalReply(Http::Code::ServiceUnavailable, _, _, _, _));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers, true));
+}
+
+TEST_F(AdaptiveConcurrencyFilterTest, RouteController) {
+  auto route_controller = std::make_shared<MockConcurrencyController>();
+  AdaptiveConcurrencyRouteConfig route_config(route_controller);
+  ON_CALL(decoder_callbacks_.route_->route_entry_,
+          perFilterConfig("envoy.filters.http.adaptive_concurrency"))
+      .WillByDefault(Return(&route_config));
+
+  // The requests of the route are limited and sampled by the controller of the route only.
+  EXPECT_CALL(*controller_, forwardingDecision()).Times(0);
+  EXPECT_CALL(*route_controller, forwardingDecision())
+      .WillOnce(Return(RequestForwardingAction::Forward));
+  Http::TestRequestHeaderMapImpl request_headers;
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+
+  Http::TestResponseHeaderMapImpl response_headers;
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, true));
+  EXPECT_CALL(*controller_, recordLatencySample(_)).Times(0);
+  EXPECT_CALL(*route_controller, recordLatencySample(_));
+  filter_->encodeComplete();
+}
+
 TEST_F(AdaptiveConcurrencyFilterTest, RecordSampleInDestructor) {
   // Verify that the request latency is always sampled even if encodeComplete() is never called.
   EXPECT_CALL(*controller_, forwardingDecision())
@@ -349,6 +349,40 @@ min_rtt_calc_params:
   verifyMinRTTValue(std::chrono::milliseconds(13));
 }
 
+TEST_F(GradientControllerTest, LimitFraction) {
+  const std::string yaml = R"EOF(
+sample_aggregate_percentile:
+  value: 50
+concurrency_limit_params:
+  concurrency_update_interval: 0.1s
+min_rtt_calc_params:
+  jitter:
+    value: 0.0
+  interval: 30s
+  request_count: 50
+  min_concurrency: 8
+)EOF";
+
+  auto controller = makeController(yaml);
+  EXPECT_EQ(controller->concurrencyLimit(), 8);
+
+  // The requests given half of the limit are blocked once half of it is outstanding, while the
+  // requests given all of it may still be forwarded.
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(RequestForwardingAction::Forward, controller->forwardingDecision(0.5));
+  }
+  EXPECT_EQ(RequestForwardingAction::Block, controller->forwardingDecision(0.5));
+  EXPECT_EQ(RequestForwardingAction::Block, controller->forwardingDecision(0.0));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(RequestForwardingAction::Forward, controller->forwardingDecision(1.0));
+  }
+  EXPECT_EQ(RequestForwardingAction::Block, controller->forwardingDecision(1.0));
+  EXPECT_EQ(RequestForwardingAction::Block, controller->forwardingDecision());
+
+  controller->cancelLatencySample();
+  EXPECT_EQ(RequestForwardingAction::Forward, controller->forwardingDecision());
+}
+
 TEST_F(GradientControllerTest, CancelLatencySample) {
   const std::string yaml = R"EOF(
 sample_aggregate_percentile:
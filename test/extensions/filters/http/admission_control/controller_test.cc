@@ -131,6 +131,43 @@ TEST_F(ThreadLocalControllerTest, AverageRps) {
   EXPECT_EQ(5, tlc_.averageRps());
 }
 
+// Verify that the request counts of the workers are aggregated when they share their summaries.
+TEST_F(ThreadLocalControllerTest, AggregateAcrossWorkers) {
+  auto summaries = std::make_shared<WorkerSummaries>(time_system_, window_);
+  ThreadLocalControllerImpl worker1(time_system_, window_, summaries);
+  auto worker2 = std::make_unique<ThreadLocalControllerImpl>(time_system_, window_, summaries);
+
+  worker1.recordSuccess();
+  worker2->recordSuccess();
+  worker2->recordFailure();
+  EXPECT_EQ(RequestData(3, 2), worker1.requestCounts());
+  EXPECT_EQ(RequestData(3, 2), worker2->requestCounts());
+  EXPECT_EQ(3, worker1.averageRps());
+
+  // The window of a worker that goes idle for a whole window is no longer counted by the others,
+  // even though the worker didn't remove its stale samples.
+  time_system_.advanceTimeWait(window_);
+  worker1.recordSuccess();
+  EXPECT_EQ(RequestData(1, 1), worker1.requestCounts());
+
+  // The requests of a worker that went away are no longer counted, and its summary is reused.
+  worker2->recordFailure();
+  EXPECT_EQ(RequestData(2, 1), worker1.requestCounts());
+  worker2.reset();
+  EXPECT_EQ(RequestData(1, 1), worker1.requestCounts());
+  ThreadLocalControllerImpl worker3(time_system_, window_, summaries);
+  EXPECT_EQ(RequestData(1, 1), worker3.requestCounts());
+}
+
+// Verify that the ring buffer of the historical data wraps around while the window is full.
+TEST_F(ThreadLocalControllerTest, HistoryWrapsAround) {
+  for (int i = 0; i < 4; ++i) {
+    time_system_.advanceTimeWait(std::chrono::seconds(1));
+    fillHistorySlots(i % 2 == 0);
+    EXPECT_EQ(RequestData(window_.count(), i % 2 == 0 ? window_.count() : 0), tlc_.requestCounts());
+  }
+}
+
 } // namespace
 } // namespace AdmissionControl
 } // namespace HttpFilters
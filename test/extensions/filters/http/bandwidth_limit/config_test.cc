@@ -53,7 +53,7 @@ TEST(Factory, RouteSpecificFilterConfig) {
   EXPECT_EQ(config->limit(), 10);
   EXPECT_EQ(config->fillInterval().count(), 100);
   EXPECT_EQ(config->enableMode(), EnableMode::BandwidthLimit_EnableMode_REQUEST_AND_RESPONSE);
-  EXPECT_FALSE(config->tokenBucket() == nullptr);
+  EXPECT_FALSE(config->routePool() == nullptr);
 }
 
 TEST(Factory, RouteSpecificFilterConfigDisabledByDefault) {
@@ -1,5 +1,6 @@
 #include "envoy/extensions/filters/http/bandwidth_limit/v3alpha/bandwidth_limit.pb.h"
 
+#include "source/common/network/utility.h"
 #include "source/extensions/filters/http/bandwidth_limit/bandwidth_limit.h"
 
 #include "test/mocks/http/mocks.h"
@@ -24,7 +25,8 @@ public:
   void setup(const std::string& yaml) {
     envoy::extensions::filters::http::bandwidth_limit::v3alpha::BandwidthLimit config;
     TestUtility::loadFromYaml(yaml, config);
-    config_ = std::make_shared<FilterConfig>(config, stats_, runtime_, time_system_, true);
+    config_ = std::make_shared<FilterConfig>(config, stats_, runtime_, time_system_, true,
+                                             pool_registry_);
     filter_ = std::make_shared<BandwidthLimiter>(config_);
     filter_->setDecoderFilterCallbacks(decoder_filter_callbacks_);
     filter_->setEncoderFilterCallbacks(encoder_filter_callbacks_);
@@ -57,6 +59,8 @@ public:
   Http::TestResponseTrailerMapImpl response_trailers_;
   Buffer::OwnedImpl data_;
   Event::SimulatedTimeSystem time_system_;
+  BandwidthPoolRegistrySharedPtr pool_registry_{
+      std::make_shared<BandwidthPoolRegistry>(time_system_)};
 };
 
 TEST_F(FilterTest, Disabled) {
@@ -552,6 +556,87 @@ TEST_F(FilterTest, WithTrailersNoEndStream) {
   EXPECT_EQ(0, findGauge("test.http_bandwidth_limit.response_pending"));
 }
 
+// The filter configs with a pool of the same name share the pool of each key and direction.
+TEST_F(FilterTest, SharedPoolKeys) {
+  const std::string config_yaml = R"(
+  stat_prefix: test
+  enable_mode: REQUEST_AND_RESPONSE
+  shared_pool:
+    name: tenant
+    key: DOWNSTREAM_IP
+    limit_kbps: 1
+  )";
+  setup(config_yaml);
+  envoy::extensions::filters::http::bandwidth_limit::v3alpha::BandwidthLimit other_proto_config;
+  TestUtility::loadFromYaml(config_yaml, other_proto_config);
+  const FilterConfig other_config(other_proto_config, stats_, runtime_, time_system_, true,
+                                  pool_registry_);
+
+  auto& address_provider = *decoder_filter_callbacks_.stream_info_.downstream_address_provider_;
+  address_provider.setRemoteAddress(Network::Utility::parseInternetAddress("10.0.0.1", 1234));
+  const BandwidthPoolSharedPtr pool = config_->pool(decoder_filter_callbacks_, "request");
+  EXPECT_EQ(1UL, pool->limit());
+  EXPECT_EQ(pool, other_config.pool(decoder_filter_callbacks_, "request"));
+  EXPECT_NE(pool, config_->pool(decoder_filter_callbacks_, "response"));
+  EXPECT_NE(pool, config_->routePool());
+
+  address_provider.setRemoteAddress(Network::Utility::parseInternetAddress("10.0.0.1", 5678));
+  EXPECT_EQ(pool, config_->pool(decoder_filter_callbacks_, "request"));
+  address_provider.setRemoteAddress(Network::Utility::parseInternetAddress("10.0.0.2", 1234));
+  EXPECT_NE(pool, config_->pool(decoder_filter_callbacks_, "request"));
+}
+
+// The streams drawing from a shared pool each take about an equal share of its bandwidth, instead
+// of the first stream scheduled taking all of it.
+TEST_F(FilterTest, SharedPoolFairShare) {
+  const std::string config_yaml = R"(
+  stat_prefix: test
+  enable_mode: REQUEST
+  shared_pool:
+    name: tenant
+    limit_kbps: 1
+  )";
+  setup(config_yaml);
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> other_decoder_filter_callbacks;
+  auto other_filter = std::make_shared<BandwidthLimiter>(config_);
+  other_filter->setDecoderFilterCallbacks(other_decoder_filter_callbacks);
+
+  uint64_t sent = 0;
+  uint64_t other_sent = 0;
+  ON_CALL(decoder_filter_callbacks_, decoderBufferLimit()).WillByDefault(Return(100000));
+  ON_CALL(other_decoder_filter_callbacks, decoderBufferLimit()).WillByDefault(Return(100000));
+  ON_CALL(decoder_filter_callbacks_, injectDecodedDataToFilterChain(_, _))
+      .WillByDefault([&sent](Buffer::Instance& data, bool) { sent += data.length(); });
+  ON_CALL(other_decoder_filter_callbacks, injectDecodedDataToFilterChain(_, _))
+      .WillByDefault([&other_sent](Buffer::Instance& data, bool) { other_sent += data.length(); });
+  Event::MockTimer* token_timer =
+      new NiceMock<Event::MockTimer>(&decoder_filter_callbacks_.dispatcher_);
+  Event::MockTimer* other_token_timer =
+      new NiceMock<Event::MockTimer>(&other_decoder_filter_callbacks.dispatcher_);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            other_filter->decodeHeaders(request_headers_, false));
+
+  Buffer::OwnedImpl data(std::string(10000, 'a'));
+  Buffer::OwnedImpl other_data(std::string(10000, 'b'));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(data, false));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer,
+            other_filter->decodeData(other_data, false));
+  for (int i = 0; i < 20; i++) {
+    token_timer->invokeCallback();
+    other_token_timer->invokeCallback();
+    time_system_.advanceTimeWait(std::chrono::milliseconds(50));
+  }
+
+  // One fill interval of tokens to start with, and 19 refills.
+  EXPECT_GE(51 + 19 * 51.2, sent + other_sent);
+  EXPECT_LT(400, sent);
+  EXPECT_LT(400, other_sent);
+
+  filter_->onDestroy();
+  other_filter->onDestroy();
+}
+
 } // namespace BandwidthLimitFilter
 } // namespace HttpFilters
 } // namespace Extensions
@@ -6,12 +6,15 @@
 
 #include "source/common/http/header_map_impl.h"
 #include "source/common/runtime/runtime_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
 #include "source/extensions/filters/http/buffer/buffer_filter.h"
 
 #include "test/mocks/buffer/mocks.h"
 #include "test/mocks/http/mocks.h"
+#include "test/test_common/environment.h"
 #include "test/test_common/printers.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -178,6 +181,45 @@ TEST_F(BufferFilterTest, RouteDisabledConfigOverride) {
   EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(data1, true));
 }
 
+#ifndef WIN32
+// The chunks buffered past the threshold are spilled to disk, the body reading back whole.
+TEST(BufferFilterSpillTest, SpillsPastThreshold) {
+  envoy::extensions::filters::http::buffer::v3::Buffer proto_config;
+  proto_config.mutable_max_request_bytes()->set_value(1024 * 1024);
+  proto_config.mutable_spill()->set_directory(TestEnvironment::temporaryDirectory());
+  proto_config.mutable_spill()->mutable_memory_threshold_bytes()->set_value(10);
+  proto_config.mutable_spill()->mutable_segment_size_bytes()->set_value(4096);
+  Stats::IsolatedStoreImpl store;
+  auto config = std::make_shared<BufferFilterConfig>(proto_config, "http.test.", store);
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> callbacks;
+  Buffer::OwnedImpl body;
+  {
+    BufferFilter filter(config);
+    filter.setDecoderFilterCallbacks(callbacks);
+
+    Http::TestRequestHeaderMapImpl headers;
+    EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter.decodeHeaders(headers, false));
+    Buffer::OwnedImpl data1("hello");
+    EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter.decodeData(data1, false));
+    body.move(data1);
+    Buffer::OwnedImpl data2(" world");
+    EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter.decodeData(data2, false));
+    body.move(data2);
+    Buffer::OwnedImpl data3("!");
+    EXPECT_EQ(Http::FilterDataStatus::Continue, filter.decodeData(data3, true));
+    body.move(data3);
+    EXPECT_EQ("12", headers.getContentLengthValue());
+    filter.onDestroy();
+  }
+
+  EXPECT_EQ("hello world!", body.toString());
+  EXPECT_EQ(6, TestUtility::findCounter(store, "http.test.buffer.spill.spilled_bytes")->value());
+  EXPECT_EQ(4096, TestUtility::findGauge(store, "http.test.buffer.spill.disk_bytes")->value());
+  body.drain(body.length());
+  EXPECT_EQ(0, TestUtility::findGauge(store, "http.test.buffer.spill.disk_bytes")->value());
+}
+#endif
+
 } // namespace BufferFilter
 } // namespace HttpFilters
 } // namespace Extensions
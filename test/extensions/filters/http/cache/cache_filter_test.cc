@@ -21,9 +21,10 @@ class CacheFilterTest : public ::testing::Test {
 protected:
   // The filter has to be created as a shared_ptr to enable shared_from_this() which is used in the
   // cache callbacks.
-  CacheFilterSharedPtr makeFilter(HttpCache& cache) {
+  CacheFilterSharedPtr makeFilter(HttpCache& cache,
+                                  CacheFillCoalescerSharedPtr fill_coalescer = nullptr) {
     auto filter = std::make_shared<CacheFilter>(config_, /*stats_prefix=*/"", context_.scope(),
-                                                context_.timeSource(), cache);
+                                                context_.timeSource(), cache, fill_coalescer);
     filter->setDecoderFilterCallbacks(decoder_callbacks_);
     filter->setEncoderFilterCallbacks(encoder_callbacks_);
     return filter;
@@ -612,6 +613,130 @@ TEST_F(CacheFilterTest, FilterDeletedBeforePostedCallbackExecuted) {
   }
 }
 
+class CacheFilterCoalescingTest : public CacheFilterTest {
+protected:
+  void SetUp() override {
+    CacheFilterTest::SetUp();
+    config_.mutable_request_coalescing_timeout()->set_seconds(1);
+    ON_CALL(follower_callbacks_, dispatcher()).WillByDefault(::testing::ReturnRef(*dispatcher_));
+  }
+
+  // Starts the request of the leader of the fill, which misses the cache.
+  CacheFilterSharedPtr startLeader() {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_, fill_coalescer_);
+    testDecodeRequestMiss(filter);
+    return filter;
+  }
+
+  // Starts a request which misses the cache while the leader's response is being fetched.
+  CacheFilterSharedPtr startFollower(NiceMock<Http::MockStreamDecoderFilterCallbacks>& callbacks) {
+    auto filter = std::make_shared<CacheFilter>(config_, /*stats_prefix=*/"", context_.scope(),
+                                                context_.timeSource(), simple_cache_,
+                                                fill_coalescer_);
+    filter->setDecoderFilterCallbacks(callbacks);
+    filter->setEncoderFilterCallbacks(encoder_callbacks_);
+    EXPECT_EQ(filter->decodeHeaders(request_headers_, true),
+              Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    return filter;
+  }
+
+  CacheFillCoalescerSharedPtr fill_coalescer_ = std::make_shared<CacheFillCoalescer>();
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> follower_callbacks_;
+};
+
+TEST_F(CacheFilterCoalescingTest, FollowerIsServedTheLeadersResponse) {
+  request_headers_.setHost("FollowerIsServedTheLeadersResponse");
+  CacheFilterSharedPtr leader = startLeader();
+  // The follower waits for the leader's response instead of going to the origin.
+  EXPECT_CALL(follower_callbacks_, continueDecoding).Times(0);
+  CacheFilterSharedPtr follower = startFollower(follower_callbacks_);
+
+  response_headers_.setContentLength(3);
+  EXPECT_CALL(follower_callbacks_,
+              encodeHeaders_(IsSupersetOfHeaders(response_headers_), /*end_stream=*/false));
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, false), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+
+  Buffer::OwnedImpl first_chunk("ab");
+  EXPECT_CALL(follower_callbacks_,
+              encodeData(testing::Property(&Buffer::Instance::toString, testing::Eq("ab")), false));
+  EXPECT_EQ(leader->encodeData(first_chunk, false), Http::FilterDataStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+
+  // A follower joining late is served all of the response received so far.
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> late_follower_callbacks;
+  ON_CALL(late_follower_callbacks, dispatcher()).WillByDefault(::testing::ReturnRef(*dispatcher_));
+  EXPECT_CALL(late_follower_callbacks, continueDecoding).Times(0);
+  EXPECT_CALL(late_follower_callbacks,
+              encodeHeaders_(IsSupersetOfHeaders(response_headers_), /*end_stream=*/false));
+  EXPECT_CALL(late_follower_callbacks,
+              encodeData(testing::Property(&Buffer::Instance::toString, testing::Eq("ab")), false));
+  CacheFilterSharedPtr late_follower = startFollower(late_follower_callbacks);
+
+  Buffer::OwnedImpl last_chunk("c");
+  EXPECT_CALL(follower_callbacks_,
+              encodeData(testing::Property(&Buffer::Instance::toString, testing::Eq("c")), true));
+  EXPECT_CALL(late_follower_callbacks,
+              encodeData(testing::Property(&Buffer::Instance::toString, testing::Eq("c")), true));
+  EXPECT_EQ(leader->encodeData(last_chunk, true), Http::FilterDataStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+
+  leader->onDestroy();
+  follower->onDestroy();
+  late_follower->onDestroy();
+}
+
+TEST_F(CacheFilterCoalescingTest, FollowerGoesToTheOriginOnTimeout) {
+  request_headers_.setHost("FollowerGoesToTheOriginOnTimeout");
+  CacheFilterSharedPtr leader = startLeader();
+  CacheFilterSharedPtr follower = startFollower(follower_callbacks_);
+
+  EXPECT_CALL(follower_callbacks_, continueDecoding);
+  time_source_.advanceTimeAndRun(std::chrono::seconds(1), *dispatcher_,
+                                 Event::Dispatcher::RunType::NonBlock);
+  ::testing::Mock::VerifyAndClearExpectations(&follower_callbacks_);
+
+  // The leader's response isn't served to the follower anymore.
+  EXPECT_CALL(follower_callbacks_, encodeHeaders_).Times(0);
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+
+  leader->onDestroy();
+  follower->onDestroy();
+}
+
+TEST_F(CacheFilterCoalescingTest, FollowerGoesToTheOriginForUncacheableResponse) {
+  request_headers_.setHost("FollowerGoesToTheOriginForUncacheableResponse");
+  CacheFilterSharedPtr leader = startLeader();
+  CacheFilterSharedPtr follower = startFollower(follower_callbacks_);
+
+  EXPECT_CALL(follower_callbacks_, encodeHeaders_).Times(0);
+  EXPECT_CALL(follower_callbacks_, continueDecoding);
+  response_headers_.setCopy(Http::CustomHeaders::get().CacheControl, "no-store");
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+
+  leader->onDestroy();
+  follower->onDestroy();
+}
+
+TEST_F(CacheFilterCoalescingTest, FollowerIsResetIfTheLeaderGoesAwayMidResponse) {
+  request_headers_.setHost("FollowerIsResetIfTheLeaderGoesAwayMidResponse");
+  CacheFilterSharedPtr leader = startLeader();
+  CacheFilterSharedPtr follower = startFollower(follower_callbacks_);
+
+  EXPECT_CALL(follower_callbacks_, encodeHeaders_(testing::_, false));
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, false), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+
+  EXPECT_CALL(follower_callbacks_, resetStream());
+  leader->onDestroy();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+
+  follower->onDestroy();
+}
+
 // A new type alias for a different type of tests that use the exact same class
 using ValidationHeadersTest = CacheFilterTest;
 
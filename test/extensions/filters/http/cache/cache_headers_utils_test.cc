@@ -675,6 +675,33 @@ TEST(CreateVaryKey, MultiValueSameHeader) {
             "bar\n");
 }
 
+TEST(CreateVaryKey, AcceptEncodingIsNormalized) {
+  Http::TestResponseHeaderMapImpl response_headers{{"vary", "Accept-Encoding"}};
+  Http::TestRequestHeaderMapImpl request_headers1{{"accept-encoding", "gzip, br;q=0.8, identity"}};
+  Http::TestRequestHeaderMapImpl request_headers2{{"accept-encoding", "BR"},
+                                                  {"accept-encoding", "gzip"}};
+
+  const std::string vary_key = VaryHeader::createVaryKey(
+      response_headers.get(Http::CustomHeaders::get().Vary), request_headers1);
+  EXPECT_EQ(vary_key, "vary-key\nAccept-Encoding\rbr,gzip\n");
+  EXPECT_EQ(vary_key, VaryHeader::createVaryKey(
+                          response_headers.get(Http::CustomHeaders::get().Vary), request_headers2));
+}
+
+TEST(NormalizeAcceptEncoding, ComprehensiveTest) {
+  EXPECT_EQ(CacheHeadersUtils::normalizeAcceptEncoding(""), "");
+  EXPECT_EQ(CacheHeadersUtils::normalizeAcceptEncoding("identity"), "");
+  EXPECT_EQ(CacheHeadersUtils::normalizeAcceptEncoding("gzip"), "gzip");
+  EXPECT_EQ(CacheHeadersUtils::normalizeAcceptEncoding(" gzip , deflate,gzip"), "deflate,gzip");
+  EXPECT_EQ(CacheHeadersUtils::normalizeAcceptEncoding("br;q=1.0, GZIP;q=0.5"), "br,gzip");
+  EXPECT_EQ(CacheHeadersUtils::normalizeAcceptEncoding("gzip, identity;q=0"), "gzip,identity;q=0");
+  EXPECT_EQ(CacheHeadersUtils::normalizeAcceptEncoding("*;q=0.1, br;Q=0"), "*,br;q=0");
+  // Codings with invalid q-values are ignored.
+  EXPECT_EQ(CacheHeadersUtils::normalizeAcceptEncoding("gzip;q=high, br"), "br");
+  // Multiple accept-encoding headers, as joined into a vary key.
+  EXPECT_EQ(CacheHeadersUtils::normalizeAcceptEncoding("gzip\rbr"), "br,gzip");
+}
+
 envoy::extensions::filters::http::cache::v3alpha::CacheConfig getConfig() {
   // Allows {accept, accept-language, width} to be varied in the tests.
   envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
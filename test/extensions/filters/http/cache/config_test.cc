@@ -33,6 +33,17 @@ TEST_F(CacheFilterFactoryTest, Basic) {
   ASSERT(dynamic_cast<CacheFilter*>(filter.get()));
 }
 
+TEST_F(CacheFilterFactoryTest, RequestCoalescing) {
+  config_.mutable_typed_config()->PackFrom(
+      envoy::extensions::cache::simple_http_cache::v3alpha::SimpleHttpCacheConfig());
+  config_.mutable_request_coalescing_timeout()->set_seconds(1);
+  Http::FilterFactoryCb cb = factory_.createFilterFactoryFromProto(config_, "stats", context_);
+  Http::StreamFilterSharedPtr filter;
+  EXPECT_CALL(filter_callback_, addStreamFilter(_)).WillOnce(::testing::SaveArg<0>(&filter));
+  cb(filter_callback_);
+  ASSERT(dynamic_cast<CacheFilter*>(filter.get()));
+}
+
 TEST_F(CacheFilterFactoryTest, NoTypedConfig) {
   EXPECT_THROW(factory_.createFilterFactoryFromProto(config_, "stats", context_), EnvoyException);
 }
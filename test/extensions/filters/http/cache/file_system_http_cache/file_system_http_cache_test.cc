@@ -0,0 +1,326 @@
+#include "envoy/extensions/cache/file_system_http_cache/v3alpha/config.pb.h"
+#include "envoy/http/header_map.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/http/cache/cache_headers_utils.h"
+#include "source/extensions/filters/http/cache/file_system_http_cache/file_system_http_cache.h"
+
+#include "test/extensions/filters/http/cache/common.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "absl/synchronization/notification.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+using testing::NiceMock;
+using testing::ReturnRef;
+
+envoy::extensions::cache::file_system_http_cache::v3alpha::FileSystemHttpCacheConfig
+cacheConfig(const std::string& path, uint64_t max_cache_size_bytes) {
+  envoy::extensions::cache::file_system_http_cache::v3alpha::FileSystemHttpCacheConfig config;
+  config.set_name("test");
+  config.set_cache_path(path);
+  config.set_max_cache_size_bytes(max_cache_size_bytes);
+  config.mutable_index_buckets()->set_value(64);
+  // A single thread runs the I/O in order, so the tests can wait for the inserts.
+  config.mutable_io_threads()->set_value(1);
+  return config;
+}
+
+envoy::extensions::filters::http::cache::v3alpha::CacheConfig getConfig() {
+  // Allows 'accept' to be varied in the tests.
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
+  const auto& add_accept = config.mutable_allowed_vary_headers()->Add();
+  add_accept->set_exact("accept");
+  return config;
+}
+
+class FileSystemHttpCacheTest : public testing::Test {
+protected:
+  FileSystemHttpCacheTest()
+      : path_(TestEnvironment::temporaryPath("file_system_http_cache_test")),
+        config_(cacheConfig(path_, 1 << 20)), vary_allow_list_(getConfig().allowed_vary_headers()) {
+    TestEnvironment::removePath(path_);
+    TestEnvironment::createPath(path_);
+    request_headers_.setMethod("GET");
+    request_headers_.setHost("example.com");
+    request_headers_.setForwardedProto("https");
+    request_headers_.setCopy(Http::CustomHeaders::get().CacheControl, "max-age=3600");
+    response_headers_.setCopy(Http::LowerCaseString("date"), formatter_.fromTime(current_time_));
+  }
+
+  ~FileSystemHttpCacheTest() override {
+    cache_.reset();
+    TestEnvironment::removePath(path_);
+  }
+
+  void initialize() {
+    cache_.reset();
+    cache_ = std::make_unique<FileSystemHttpCache>(config_, store_, Thread::threadFactoryForTest());
+  }
+
+  // Waits for the I/O queued so far.
+  void drain() {
+    absl::Notification done;
+    cache_->post([&done]() { done.Notify(); });
+    done.WaitForNotification();
+  }
+
+  // Performs a cache lookup.
+  LookupContextPtr lookup(absl::string_view request_path) {
+    request_headers_.setPath(request_path);
+    LookupContextPtr context = cache_->makeLookupContext(
+        LookupRequest(request_headers_, current_time_, vary_allow_list_));
+    absl::Notification done;
+    context->getHeaders([this, &done](LookupResult&& result) {
+      lookup_result_ = std::move(result);
+      done.Notify();
+    });
+    done.WaitForNotification();
+    return context;
+  }
+
+  // Inserts a value into the cache.
+  void insert(absl::string_view request_path, absl::string_view response_body) {
+    InsertContextPtr inserter = cache_->makeInsertContext(lookup(request_path));
+    inserter->insertHeaders(response_headers_, ResponseMetadata{current_time_}, false);
+    inserter->insertBody(Buffer::OwnedImpl(response_body), nullptr, true);
+    drain();
+  }
+
+  std::string getBody(LookupContext& context, uint64_t start, uint64_t end) {
+    std::string body;
+    absl::Notification done;
+    context.getBody(AdjustedByteRange(start, end), [&body, &done](Buffer::InstancePtr&& data) {
+      EXPECT_NE(data, nullptr);
+      if (data != nullptr) {
+        body = data->toString();
+      }
+      done.Notify();
+    });
+    done.WaitForNotification();
+    return body;
+  }
+
+  // Returns the body cached for the path, or nullopt on a miss.
+  absl::optional<std::string> cachedBody(absl::string_view request_path) {
+    LookupContextPtr context = lookup(request_path);
+    if (lookup_result_.cache_entry_status_ != CacheEntryStatus::Ok) {
+      return absl::nullopt;
+    }
+    if (lookup_result_.content_length_ == 0) {
+      return "";
+    }
+    return getBody(*context, 0, lookup_result_.content_length_);
+  }
+
+  const std::string path_;
+  envoy::extensions::cache::file_system_http_cache::v3alpha::FileSystemHttpCacheConfig config_;
+  Stats::IsolatedStoreImpl store_;
+  std::unique_ptr<FileSystemHttpCache> cache_;
+  LookupResult lookup_result_;
+  Http::TestRequestHeaderMapImpl request_headers_;
+  Http::TestResponseHeaderMapImpl response_headers_{{"cache-control", "public,max-age=3600"}};
+  Event::SimulatedTimeSystem time_source_;
+  SystemTime current_time_ = time_source_.systemTime();
+  DateFormatter formatter_{"%a, %d %b %Y %H:%M:%S GMT"};
+  VaryHeader vary_allow_list_;
+};
+
+TEST_F(FileSystemHttpCacheTest, PutGet) {
+  initialize();
+  EXPECT_EQ(absl::nullopt, cachedBody("/a"));
+  insert("/a", "Value");
+  insert("/b", "Other value");
+  EXPECT_EQ("Value", cachedBody("/a"));
+  EXPECT_EQ("Other value", cachedBody("/b"));
+  insert("/a", "New value");
+  EXPECT_EQ("New value", cachedBody("/a"));
+
+  EXPECT_EQ(4, cache_->stats().hit_.value());
+  EXPECT_EQ(3, cache_->stats().miss_.value());
+  EXPECT_EQ(3, cache_->stats().insert_.value());
+  EXPECT_EQ(0, cache_->stats().io_error_.value());
+  EXPECT_EQ("http_cache.file_system.test.hit", cache_->stats().hit_.name());
+}
+
+TEST_F(FileSystemHttpCacheTest, ServesRangesOfTheCachedBody) {
+  initialize();
+  insert("/a", "Hello, World!");
+  LookupContextPtr context = lookup("/a");
+  EXPECT_EQ("Hello", getBody(*context, 0, 5));
+  EXPECT_EQ("World!", getBody(*context, 7, 13));
+}
+
+TEST_F(FileSystemHttpCacheTest, ReadsLargeBodiesInChunks) {
+  config_ = cacheConfig(path_, 4 << 20);
+  initialize();
+  const std::string body(FileSystemHttpCache::MaxReadSizeBytes + 10, 'a');
+  insert("/a", body);
+  LookupContextPtr context = lookup("/a");
+  ASSERT_EQ(body.size(), lookup_result_.content_length_);
+  EXPECT_EQ(FileSystemHttpCache::MaxReadSizeBytes, getBody(*context, 0, body.size()).size());
+}
+
+TEST_F(FileSystemHttpCacheTest, PersistsAcrossRestarts) {
+  initialize();
+  insert("/a", "Value");
+  initialize();
+  EXPECT_EQ("Value", cachedBody("/a"));
+  EXPECT_EQ(response_headers_.getDateValue(), lookup_result_.headers_->getDateValue());
+}
+
+TEST_F(FileSystemHttpCacheTest, DropsTheIndexOfAnotherLayout) {
+  initialize();
+  insert("/a", "Value");
+  config_.mutable_index_buckets()->set_value(128);
+  initialize();
+  EXPECT_EQ(absl::nullopt, cachedBody("/a"));
+}
+
+TEST_F(FileSystemHttpCacheTest, EvictsOldestSegment) {
+  // Room for three segments of a single record each.
+  config_ = cacheConfig(path_, 4000);
+  config_.mutable_segment_size_bytes()->set_value(2000);
+  initialize();
+  const std::string body(1000, 'a');
+  insert("/a", body);
+  insert("/b", body);
+  insert("/c", body);
+  EXPECT_EQ(0, cache_->stats().segment_eviction_.value());
+  insert("/d", body);
+
+  EXPECT_EQ(1, cache_->stats().segment_eviction_.value());
+  EXPECT_LE(cache_->stats().size_bytes_.value(), 4000);
+  EXPECT_EQ(absl::nullopt, cachedBody("/a"));
+  EXPECT_EQ(body, cachedBody("/b"));
+  EXPECT_EQ(body, cachedBody("/c"));
+  EXPECT_EQ(body, cachedBody("/d"));
+}
+
+TEST_F(FileSystemHttpCacheTest, FullBucketReplacesItsOldestRecord) {
+  // A single bucket of four records.
+  config_.mutable_index_buckets()->set_value(1);
+  initialize();
+  insert("/a", "a");
+  insert("/b", "b");
+  insert("/c", "c");
+  insert("/d", "d");
+  insert("/e", "e");
+
+  EXPECT_EQ(absl::nullopt, cachedBody("/a"));
+  EXPECT_EQ("b", cachedBody("/b"));
+  EXPECT_EQ("e", cachedBody("/e"));
+}
+
+TEST_F(FileSystemHttpCacheTest, DoesNotCacheTooLargeResponses) {
+  config_.mutable_max_entry_size_bytes()->set_value(1000);
+  initialize();
+  InsertContextPtr inserter = cache_->makeInsertContext(lookup("/a"));
+  inserter->insertHeaders(response_headers_, ResponseMetadata{current_time_}, false);
+  bool ready_for_more = true;
+  inserter->insertBody(
+      Buffer::OwnedImpl(std::string(1000, 'a')),
+      [&ready_for_more](bool ready) { ready_for_more = ready; }, false);
+  EXPECT_FALSE(ready_for_more);
+  drain();
+
+  EXPECT_EQ(absl::nullopt, cachedBody("/a"));
+  EXPECT_EQ(1, cache_->stats().insert_too_large_.value());
+  EXPECT_EQ(0, cache_->stats().insert_.value());
+}
+
+TEST_F(FileSystemHttpCacheTest, UpdateHeaders) {
+  initialize();
+  insert("/a", "Value");
+  LookupContextPtr context = lookup("/a");
+  Http::TestResponseHeaderMapImpl updated_headers{{"date", formatter_.fromTime(current_time_)},
+                                                  {"cache-control", "public,max-age=7200"}};
+  cache_->updateHeaders(*context, updated_headers, ResponseMetadata{current_time_});
+  drain();
+
+  EXPECT_EQ("Value", cachedBody("/a"));
+  EXPECT_EQ("public,max-age=7200",
+            lookup_result_.headers_->get(Http::CustomHeaders::get().CacheControl)[0]
+                ->value()
+                .getStringView());
+}
+
+TEST_F(FileSystemHttpCacheTest, VaryResponses) {
+  initialize();
+  response_headers_.setCopy(Http::LowerCaseString("vary"), "accept");
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "image/*");
+  insert("/a", "image");
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "text/html");
+  EXPECT_EQ(absl::nullopt, cachedBody("/a"));
+  insert("/a", "html");
+
+  EXPECT_EQ("html", cachedBody("/a"));
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "image/*");
+  EXPECT_EQ("image", cachedBody("/a"));
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "text/plain");
+  EXPECT_EQ(absl::nullopt, cachedBody("/a"));
+}
+
+TEST_F(FileSystemHttpCacheTest, DestroyedContextIsNotCalledBack) {
+  initialize();
+  insert("/a", "Value");
+  // Holds the I/O thread until the context is destroyed.
+  absl::Notification destroyed;
+  cache_->post([&destroyed]() { destroyed.WaitForNotification(); });
+  request_headers_.setPath("/a");
+  LookupContextPtr context = cache_->makeLookupContext(
+      LookupRequest(request_headers_, current_time_, vary_allow_list_));
+  bool called = false;
+  context->getHeaders([&called](LookupResult&&) { called = true; });
+  context->onDestroy();
+  context.reset();
+  destroyed.Notify();
+  drain();
+  EXPECT_FALSE(called);
+}
+
+TEST_F(FileSystemHttpCacheTest, MissingDirectory) {
+  config_.set_cache_path(path_ + "/missing");
+  EXPECT_THROW_WITH_REGEX(initialize(), EnvoyException, "unable to open http cache index");
+}
+
+TEST_F(FileSystemHttpCacheTest, CachesOfTheSameDirectoryAreShared) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.extensions.cache.file_system_http_cache.v3alpha.FileSystemHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  ON_CALL(context.api_, threadFactory()).WillByDefault(ReturnRef(Thread::threadFactoryForTest()));
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
+  config.mutable_typed_config()->PackFrom(config_);
+
+  HttpCacheSharedPtr cache = factory->getCache(config, context);
+  EXPECT_EQ(cache->cacheInfo().name_, "envoy.extensions.http.cache.file_system");
+  EXPECT_EQ(cache, factory->getCache(config, context));
+
+  config.mutable_typed_config()->PackFrom(cacheConfig(path_, 1 << 10));
+  EXPECT_THROW_WITH_MESSAGE(
+      factory->getCache(config, context), EnvoyException,
+      fmt::format("config specified file system http cache '{}' with different settings", path_));
+
+  // Once no filter uses the cache, it can be configured again differently.
+  cache.reset();
+  EXPECT_NE(nullptr, factory->getCache(config, context));
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
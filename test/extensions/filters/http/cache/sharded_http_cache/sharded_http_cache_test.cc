@@ -0,0 +1,237 @@
+#include "envoy/extensions/cache/sharded_http_cache/v3alpha/config.pb.h"
+#include "envoy/http/header_map.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/http/cache/cache_headers_utils.h"
+#include "source/extensions/filters/http/cache/sharded_http_cache/sharded_http_cache.h"
+
+#include "test/extensions/filters/http/cache/common.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+using testing::NiceMock;
+
+envoy::extensions::cache::sharded_http_cache::v3alpha::ShardedHttpCacheConfig
+cacheConfig(uint32_t shards, uint64_t max_size_bytes) {
+  envoy::extensions::cache::sharded_http_cache::v3alpha::ShardedHttpCacheConfig config;
+  config.set_name("test");
+  config.mutable_shards()->set_value(shards);
+  config.set_max_size_bytes(max_size_bytes);
+  config.mutable_max_entry_size_bytes()->set_value(max_size_bytes);
+  return config;
+}
+
+envoy::extensions::filters::http::cache::v3alpha::CacheConfig getConfig() {
+  // Allows 'accept' to be varied in the tests.
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
+  const auto& add_accept = config.mutable_allowed_vary_headers()->Add();
+  add_accept->set_exact("accept");
+  return config;
+}
+
+class ShardedHttpCacheTest : public testing::Test {
+protected:
+  ShardedHttpCacheTest() : vary_allow_list_(getConfig().allowed_vary_headers()) {
+    request_headers_.setMethod("GET");
+    request_headers_.setHost("example.com");
+    request_headers_.setForwardedProto("https");
+    request_headers_.setCopy(Http::CustomHeaders::get().CacheControl, "max-age=3600");
+    response_headers_.setCopy(Http::LowerCaseString("date"), formatter_.fromTime(current_time_));
+  }
+
+  void initialize(uint32_t shards, uint64_t max_size_bytes) {
+    cache_ = std::make_unique<ShardedHttpCache>(cacheConfig(shards, max_size_bytes), store_);
+  }
+
+  // Performs a cache lookup.
+  LookupContextPtr lookup(absl::string_view request_path) {
+    request_headers_.setPath(request_path);
+    LookupContextPtr context = cache_->makeLookupContext(
+        LookupRequest(request_headers_, current_time_, vary_allow_list_));
+    context->getHeaders([this](LookupResult&& result) { lookup_result_ = std::move(result); });
+    return context;
+  }
+
+  // Inserts a value into the cache.
+  void insert(absl::string_view request_path, absl::string_view response_body) {
+    InsertContextPtr inserter = cache_->makeInsertContext(lookup(request_path));
+    inserter->insertHeaders(response_headers_, ResponseMetadata{current_time_}, false);
+    inserter->insertBody(Buffer::OwnedImpl(response_body), nullptr, true);
+  }
+
+  std::string getBody(LookupContext& context, uint64_t start, uint64_t end) {
+    std::string body;
+    context.getBody(AdjustedByteRange(start, end), [&body](Buffer::InstancePtr&& data) {
+      ASSERT_NE(data, nullptr);
+      body = data->toString();
+    });
+    return body;
+  }
+
+  // Returns the body cached for the path, or nullopt on a miss.
+  absl::optional<std::string> cachedBody(absl::string_view request_path) {
+    LookupContextPtr context = lookup(request_path);
+    if (lookup_result_.cache_entry_status_ != CacheEntryStatus::Ok) {
+      return absl::nullopt;
+    }
+    if (lookup_result_.content_length_ == 0) {
+      return "";
+    }
+    return getBody(*context, 0, lookup_result_.content_length_);
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  std::unique_ptr<ShardedHttpCache> cache_;
+  LookupResult lookup_result_;
+  Http::TestRequestHeaderMapImpl request_headers_;
+  Http::TestResponseHeaderMapImpl response_headers_{{"cache-control", "public,max-age=3600"}};
+  Event::SimulatedTimeSystem time_source_;
+  SystemTime current_time_ = time_source_.systemTime();
+  DateFormatter formatter_{"%a, %d %b %Y %H:%M:%S GMT"};
+  VaryHeader vary_allow_list_;
+};
+
+TEST_F(ShardedHttpCacheTest, PutGet) {
+  initialize(4, 1 << 20);
+  EXPECT_EQ(absl::nullopt, cachedBody("/a"));
+  insert("/a", "Value");
+  insert("/b", "Other value");
+  EXPECT_EQ("Value", cachedBody("/a"));
+  EXPECT_EQ("Other value", cachedBody("/b"));
+  insert("/a", "New value");
+  EXPECT_EQ("New value", cachedBody("/a"));
+
+  EXPECT_EQ(4, cache_->stats().hit_.value());
+  EXPECT_EQ(3, cache_->stats().miss_.value());
+  EXPECT_EQ(3, cache_->stats().insert_.value());
+  EXPECT_EQ(2, cache_->stats().entries_.value());
+  EXPECT_EQ(0, cache_->stats().eviction_.value());
+  EXPECT_EQ("http_cache.sharded.test.hit", cache_->stats().hit_.name());
+}
+
+TEST_F(ShardedHttpCacheTest, ServesRangesOfTheCachedBody) {
+  initialize(4, 1 << 20);
+  insert("/a", "Hello, World!");
+  LookupContextPtr context = lookup("/a");
+  EXPECT_EQ("Hello", getBody(*context, 0, 5));
+  EXPECT_EQ("World!", getBody(*context, 7, 13));
+}
+
+TEST_F(ShardedHttpCacheTest, BodyOutlivesItsEntry) {
+  initialize(1, 1 << 20);
+  insert("/a", "Value");
+  LookupContextPtr context = lookup("/a");
+  Buffer::InstancePtr body;
+  context->getBody(AdjustedByteRange(0, 5),
+                   [&body](Buffer::InstancePtr&& data) { body = std::move(data); });
+  insert("/a", "New value");
+  context.reset();
+  EXPECT_EQ("Value", body->toString());
+}
+
+TEST_F(ShardedHttpCacheTest, EvictsLeastRecentlyUsed) {
+  // Measures the size of an entry without a body in a cache with its own stats.
+  Stats::IsolatedStoreImpl probe_store;
+  cache_ = std::make_unique<ShardedHttpCache>(cacheConfig(1, 1 << 20), probe_store);
+  insert("/a", "");
+  const uint64_t entry_size = cache_->stats().size_bytes_.value();
+  // Leaves room for three entries of 1000 bytes in the single shard.
+  initialize(1, 3 * (entry_size + 1000));
+  const std::string body(1000, 'a');
+  insert("/a", body);
+  insert("/b", body);
+  insert("/c", body);
+  EXPECT_EQ(body, cachedBody("/a"));
+  insert("/d", body);
+
+  EXPECT_EQ(1, cache_->stats().eviction_.value());
+  EXPECT_EQ(3, cache_->stats().entries_.value());
+  EXPECT_EQ(absl::nullopt, cachedBody("/b"));
+  EXPECT_EQ(body, cachedBody("/a"));
+  EXPECT_EQ(body, cachedBody("/c"));
+  EXPECT_EQ(body, cachedBody("/d"));
+}
+
+TEST_F(ShardedHttpCacheTest, DoesNotCacheTooLargeResponses) {
+  initialize(1, 1000);
+  InsertContextPtr inserter = cache_->makeInsertContext(lookup("/a"));
+  inserter->insertHeaders(response_headers_, ResponseMetadata{current_time_}, false);
+  bool ready_for_more = true;
+  inserter->insertBody(
+      Buffer::OwnedImpl(std::string(1000, 'a')),
+      [&ready_for_more](bool ready) { ready_for_more = ready; }, false);
+  EXPECT_FALSE(ready_for_more);
+
+  EXPECT_EQ(absl::nullopt, cachedBody("/a"));
+  EXPECT_EQ(1, cache_->stats().insert_too_large_.value());
+  EXPECT_EQ(0, cache_->stats().insert_.value());
+}
+
+TEST_F(ShardedHttpCacheTest, UpdateHeaders) {
+  initialize(4, 1 << 20);
+  insert("/a", "Value");
+  LookupContextPtr context = lookup("/a");
+  Http::TestResponseHeaderMapImpl updated_headers{{"date", formatter_.fromTime(current_time_)},
+                                                  {"cache-control", "public,max-age=7200"}};
+  cache_->updateHeaders(*context, updated_headers, ResponseMetadata{current_time_});
+
+  EXPECT_EQ("Value", cachedBody("/a"));
+  EXPECT_EQ("public,max-age=7200",
+            lookup_result_.headers_->get(Http::CustomHeaders::get().CacheControl)[0]
+                ->value()
+                .getStringView());
+}
+
+TEST_F(ShardedHttpCacheTest, VaryResponses) {
+  initialize(4, 1 << 20);
+  response_headers_.setCopy(Http::LowerCaseString("vary"), "accept");
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "image/*");
+  insert("/a", "image");
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "text/html");
+  EXPECT_EQ(absl::nullopt, cachedBody("/a"));
+  insert("/a", "html");
+
+  EXPECT_EQ("html", cachedBody("/a"));
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "image/*");
+  EXPECT_EQ("image", cachedBody("/a"));
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "text/plain");
+  EXPECT_EQ(absl::nullopt, cachedBody("/a"));
+}
+
+TEST(Registration, CachesOfTheSameNameAreShared) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.extensions.cache.sharded_http_cache.v3alpha.ShardedHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
+  config.mutable_typed_config()->PackFrom(cacheConfig(4, 1 << 20));
+
+  HttpCacheSharedPtr cache = factory->getCache(config, context);
+  EXPECT_EQ(cache->cacheInfo().name_, "envoy.extensions.http.cache.sharded");
+  EXPECT_EQ(cache, factory->getCache(config, context));
+
+  config.mutable_typed_config()->PackFrom(cacheConfig(4, 1 << 10));
+  EXPECT_THROW_WITH_MESSAGE(factory->getCache(config, context), EnvoyException,
+                            "config specified sharded http cache 'test' with different settings");
+
+  // Once no filter uses the cache, it can be configured again differently.
+  cache.reset();
+  EXPECT_NE(nullptr, factory->getCache(config, context));
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
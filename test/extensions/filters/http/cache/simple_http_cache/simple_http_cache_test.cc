@@ -6,6 +6,7 @@
 #include "source/extensions/filters/http/cache/simple_http_cache/simple_http_cache.h"
 
 #include "test/extensions/filters/http/cache/common.h"
+#include "test/mocks/server/factory_context.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
@@ -17,6 +18,8 @@ namespace HttpFilters {
 namespace Cache {
 namespace {
 
+using testing::NiceMock;
+
 const std::string EpochDate = "Thu, 01 Jan 1970 00:00:00 GMT";
 
 envoy::extensions::filters::http::cache::v3alpha::CacheConfig getConfig() {
@@ -223,7 +226,9 @@ TEST(Registration, GetFactory) {
   ASSERT_NE(factory, nullptr);
   envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
   config.mutable_typed_config()->PackFrom(*factory->createEmptyConfigProto());
-  EXPECT_EQ(factory->getCache(config).cacheInfo().name_, "envoy.extensions.http.cache.simple");
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  EXPECT_EQ(factory->getCache(config, context)->cacheInfo().name_,
+            "envoy.extensions.http.cache.simple");
 }
 
 TEST_F(SimpleHttpCacheTest, VaryResponses) {
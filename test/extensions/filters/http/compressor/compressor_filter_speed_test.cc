@@ -1,7 +1,10 @@
+#include <functional>
+
 #include "envoy/compression/compressor/factory.h"
 #include "envoy/extensions/filters/http/compressor/v3/compressor.pb.h"
 
 #include "source/extensions/compression/gzip/compressor/zlib_compressor_impl.h"
+#include "source/extensions/compression/zstd/compressor/config.h"
 #include "source/extensions/filters/http/compressor/compressor_filter.h"
 
 #include "test/mocks/http/mocks.h"
@@ -10,6 +13,7 @@
 
 #include "benchmark/benchmark.h"
 #include "gmock/gmock.h"
+#include "zlib.h"
 
 using testing::Return;
 
@@ -89,20 +93,18 @@ struct Result {
   uint64_t total_compressed_bytes = 0;
 };
 
-static Result compressWith(std::vector<Buffer::OwnedImpl>&& chunks, CompressionParams params,
-                           NiceMock<Http::MockStreamDecoderFilterCallbacks>& decoder_callbacks,
-                           benchmark::State& state) {
+static Result
+compressWith(std::vector<Buffer::OwnedImpl>&& chunks,
+             Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory,
+             NiceMock<Http::MockStreamDecoderFilterCallbacks>& decoder_callbacks,
+             benchmark::State& state) {
   auto start = std::chrono::high_resolution_clock::now();
   Stats::IsolatedStoreImpl stats;
   testing::NiceMock<Runtime::MockLoader> runtime;
   envoy::extensions::filters::http::compressor::v3::Compressor compressor;
 
-  const auto level = std::get<0>(params);
-  const auto strategy = std::get<1>(params);
-  const auto window_bits = std::get<2>(params);
-  const auto memory_level = std::get<3>(params);
-  Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory =
-      std::make_unique<MockCompressorFactory>(level, strategy, window_bits, memory_level);
+  const std::string stats_prefix = "test.compressor.." + compressor_factory->statsPrefix();
+  const std::string content_encoding = compressor_factory->contentEncoding();
   CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
       compressor, "test.", stats, runtime, std::move(compressor_factory));
 
@@ -112,7 +114,8 @@ static Result compressWith(std::vector<Buffer::OwnedImpl>&& chunks, CompressionP
   auto filter = std::make_unique<CompressorFilter>(config);
   filter->setDecoderFilterCallbacks(decoder_callbacks);
 
-  Http::TestRequestHeaderMapImpl headers = {{":method", "get"}, {"accept-encoding", "gzip"}};
+  Http::TestRequestHeaderMapImpl headers = {{":method", "get"},
+                                            {"accept-encoding", content_encoding}};
   filter->decodeHeaders(headers, false);
 
   Http::TestResponseHeaderMapImpl response_headers = {
@@ -137,11 +140,11 @@ static Result compressWith(std::vector<Buffer::OwnedImpl>&& chunks, CompressionP
   }
 
   EXPECT_EQ(res.total_uncompressed_bytes,
-            stats.counterFromString("test.compressor..test.total_uncompressed_bytes").value());
+            stats.counterFromString(stats_prefix + "total_uncompressed_bytes").value());
   EXPECT_EQ(res.total_compressed_bytes,
-            stats.counterFromString("test.compressor..test.total_compressed_bytes").value());
+            stats.counterFromString(stats_prefix + "total_compressed_bytes").value());
 
-  EXPECT_EQ(1U, stats.counterFromString("test.compressor..test.compressed").value());
+  EXPECT_EQ(1U, stats.counterFromString(stats_prefix + "compressed").value());
   auto end = std::chrono::high_resolution_clock::now();
   const auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
   state.SetIterationTime(elapsed.count());
@@ -229,65 +232,96 @@ static std::vector<CompressionParams> compression_params = {
     {Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionLevel::Best,
      Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionStrategy::Standard, 15, 9}};
 
-static void compressFull(benchmark::State& state) {
+// Compresses the test data in chunk_count chunks of chunk_size bytes with the compressors of the
+// factory made by make_factory, and reports the throughput and the compression ratio, labeled
+// with label.
+static void
+compressChunksWith(benchmark::State& state, uint64_t chunk_count, uint64_t chunk_size,
+                   const std::function<Envoy::Compression::Compressor::CompressorFactoryPtr()>&
+                       make_factory,
+                   const std::string& label) {
   NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
-  const auto idx = state.range(0);
-  const auto& params = compression_params[idx];
 
+  Result total;
   for (auto _ : state) {
-    std::vector<Buffer::OwnedImpl> chunks = generateChunks(1, 122880);
-    compressWith(std::move(chunks), params, decoder_callbacks, state);
+    std::vector<Buffer::OwnedImpl> chunks = generateChunks(chunk_count, chunk_size);
+    const Result res = compressWith(std::move(chunks), make_factory(), decoder_callbacks, state);
+    total.total_uncompressed_bytes += res.total_uncompressed_bytes;
+    total.total_compressed_bytes += res.total_compressed_bytes;
   }
-}
-BENCHMARK(compressFull)->DenseRange(0, 8, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
-
-static void compressChunks16384(benchmark::State& state) {
-  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
-  const auto idx = state.range(0);
-  const auto& params = compression_params[idx];
 
-  for (auto _ : state) {
-    std::vector<Buffer::OwnedImpl> chunks = generateChunks(7, 16384);
-    compressWith(std::move(chunks), params, decoder_callbacks, state);
+  state.SetLabel(label);
+  state.SetBytesProcessed(total.total_uncompressed_bytes);
+  if (total.total_uncompressed_bytes > 0) {
+    state.counters["compression_ratio"] = static_cast<double>(total.total_compressed_bytes) /
+                                          static_cast<double>(total.total_uncompressed_bytes);
   }
 }
-BENCHMARK(compressChunks16384)->DenseRange(0, 8, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
 
-static void compressChunks8192(benchmark::State& state) {
-  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
-  const auto idx = state.range(0);
-  const auto& params = compression_params[idx];
+// Compresses with gzip with the params of the range of the benchmark. The benchmark is labeled
+// with the version of the zlib it is built with, e.g. "1.2.11" or "1.2.11.zlib-ng" with
+// --define zlib=ng, so that the backends can be compared across the runs of the builds with each.
+static void compressChunks(benchmark::State& state, uint64_t chunk_count, uint64_t chunk_size) {
+  const auto& params = compression_params[state.range(0)];
+  compressChunksWith(
+      state, chunk_count, chunk_size,
+      [&params]() {
+        return std::make_unique<MockCompressorFactory>(std::get<0>(params), std::get<1>(params),
+                                                       std::get<2>(params), std::get<3>(params));
+      },
+      zlibVersion());
+}
 
-  for (auto _ : state) {
-    std::vector<Buffer::OwnedImpl> chunks = generateChunks(15, 8192);
-    compressWith(std::move(chunks), params, decoder_callbacks, state);
-  }
+// The zstd compression levels compared with gzip.
+static std::vector<uint32_t> zstd_compression_levels = {1, 3, 6, 9, 12, 15, 19};
+
+// Compresses with zstd with the compression level of the range of the benchmark.
+static void compressChunksZstd(benchmark::State& state, uint64_t chunk_count,
+                               uint64_t chunk_size) {
+  envoy::extensions::compression::zstd::compressor::v3::Zstd zstd;
+  zstd.mutable_compression_level()->set_value(zstd_compression_levels[state.range(0)]);
+  Api::ApiPtr api = Api::createApiForTest();
+  compressChunksWith(
+      state, chunk_count, chunk_size,
+      [&zstd, &api]() {
+        return std::make_unique<Compression::Zstd::Compressor::ZstdCompressorFactory>(zstd, *api);
+      },
+      ZSTD_versionString());
 }
-BENCHMARK(compressChunks8192)->DenseRange(0, 8, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
 
-static void compressChunks4096(benchmark::State& state) {
-  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
-  const auto idx = state.range(0);
-  const auto& params = compression_params[idx];
+static void compressFull(benchmark::State& state) { compressChunks(state, 1, 122880); }
+BENCHMARK(compressFull)->DenseRange(0, 8, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
 
-  for (auto _ : state) {
-    std::vector<Buffer::OwnedImpl> chunks = generateChunks(30, 4096);
-    compressWith(std::move(chunks), params, decoder_callbacks, state);
-  }
-}
+static void compressChunks16384(benchmark::State& state) { compressChunks(state, 7, 16384); }
+BENCHMARK(compressChunks16384)->DenseRange(0, 8, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+static void compressChunks8192(benchmark::State& state) { compressChunks(state, 15, 8192); }
+BENCHMARK(compressChunks8192)->DenseRange(0, 8, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+static void compressChunks4096(benchmark::State& state) { compressChunks(state, 30, 4096); }
 BENCHMARK(compressChunks4096)->DenseRange(0, 8, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
 
-static void compressChunks1024(benchmark::State& state) {
-  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
-  const auto idx = state.range(0);
-  const auto& params = compression_params[idx];
+static void compressChunks1024(benchmark::State& state) { compressChunks(state, 120, 1024); }
+BENCHMARK(compressChunks1024)->DenseRange(0, 8, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
 
-  for (auto _ : state) {
-    std::vector<Buffer::OwnedImpl> chunks = generateChunks(120, 1024);
-    compressWith(std::move(chunks), params, decoder_callbacks, state);
-  }
+static void compressFullZstd(benchmark::State& state) { compressChunksZstd(state, 1, 122880); }
+BENCHMARK(compressFullZstd)->DenseRange(0, 6, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+static void compressChunks16384Zstd(benchmark::State& state) {
+  compressChunksZstd(state, 7, 16384);
 }
-BENCHMARK(compressChunks1024)->DenseRange(0, 8, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(compressChunks16384Zstd)
+    ->DenseRange(0, 6, 1)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+static void compressChunks1024Zstd(benchmark::State& state) {
+  compressChunksZstd(state, 120, 1024);
+}
+BENCHMARK(compressChunks1024Zstd)
+    ->DenseRange(0, 6, 1)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
 
 } // namespace Compressor
 } // namespace HttpFilters
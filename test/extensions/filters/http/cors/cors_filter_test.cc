@@ -79,6 +79,8 @@ TEST_F(CorsFilterTest, RequestWithoutOrigin) {
   Http::TestRequestHeaderMapImpl request_headers{{":method", "get"}};
 
   EXPECT_CALL(decoder_callbacks_, encodeHeaders_(_, false)).Times(0);
+  EXPECT_CALL(decoder_callbacks_, skipRemainingCallbacks());
+  EXPECT_CALL(encoder_callbacks_, skipRemainingCallbacks());
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, false));
   EXPECT_EQ(false, IsCorsRequest());
   EXPECT_EQ(0, stats_.counter("test.cors.origin_invalid").value());
@@ -97,6 +99,9 @@ TEST_F(CorsFilterTest, RequestWithOrigin) {
   Http::TestRequestHeaderMapImpl request_headers{{":method", "get"}, {"origin", "localhost"}};
 
   EXPECT_CALL(decoder_callbacks_, encodeHeaders_(_, false)).Times(0);
+  // The response headers of a CORS request are still needed.
+  EXPECT_CALL(decoder_callbacks_, skipRemainingCallbacks());
+  EXPECT_CALL(encoder_callbacks_, skipRemainingCallbacks()).Times(0);
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, false));
   EXPECT_EQ(true, IsCorsRequest());
   EXPECT_EQ(0, stats_.counter("test.cors.origin_invalid").value());
@@ -0,0 +1,213 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/filters/http/ext_authz/v3/ext_authz.pb.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/http/ext_authz/decision_cache.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/ssl/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+namespace {
+
+using Filters::Common::ExtAuthz::CheckStatus;
+using Filters::Common::ExtAuthz::Response;
+
+class DecisionCacheTest : public testing::Test {
+public:
+  void initialize(const std::string& yaml) {
+    envoy::extensions::filters::http::ext_authz::v3::DecisionCache config;
+    TestUtility::loadFromYaml(yaml, config);
+    cache_ = std::make_unique<DecisionCache>(config, tls_, time_system_, store_, "cache.");
+  }
+
+  Response response(CheckStatus status) {
+    Response response{};
+    response.status = status;
+    return response;
+  }
+
+  std::string key(const Http::RequestHeaderMap& headers,
+                  const DecisionCache::ContextExtensionsMap& context_extensions = {}) {
+    return cache_->key(headers, &connection_, context_extensions);
+  }
+
+  uint64_t counter(const std::string& name) {
+    return store_.counterFromString("cache." + name).value();
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<Network::MockConnection> connection_;
+  std::unique_ptr<DecisionCache> cache_;
+};
+
+// The requests only share a key when their configured attributes are the same.
+TEST_F(DecisionCacheTest, KeyOfConfiguredAttributes) {
+  initialize(R"EOF(
+key_headers: [authorization, x-tenant]
+key_path_segments: 2
+)EOF");
+  const std::string alice = key(Http::TestRequestHeaderMapImpl{
+      {":path", "/api/users/1?page=2"}, {"authorization", "alice"}, {"x-tenant", "foo"}});
+
+  EXPECT_EQ(alice, key(Http::TestRequestHeaderMapImpl{{":path", "/api/users/2"},
+                                                      {"authorization", "alice"},
+                                                      {"x-tenant", "foo"},
+                                                      {"x-request-id", "1"}}));
+  EXPECT_NE(alice, key(Http::TestRequestHeaderMapImpl{{":path", "/api/groups/1"},
+                                                      {"authorization", "alice"},
+                                                      {"x-tenant", "foo"}}));
+  EXPECT_NE(alice, key(Http::TestRequestHeaderMapImpl{
+                       {":path", "/api/users/1"}, {"authorization", "bob"}, {"x-tenant", "foo"}}));
+  EXPECT_NE(alice, key(Http::TestRequestHeaderMapImpl{{":path", "/api/users/1"},
+                                                      {"authorization", "alice"}}));
+
+  // A missing header is told apart from an empty one.
+  EXPECT_NE(key(Http::TestRequestHeaderMapImpl{{":path", "/"}, {"authorization", "alice"}}),
+            key(Http::TestRequestHeaderMapImpl{
+                {":path", "/"}, {"authorization", "alice"}, {"x-tenant", ""}}));
+  // The attributes can't run into each other.
+  EXPECT_NE(key(Http::TestRequestHeaderMapImpl{
+                {":path", "/"}, {"authorization", "a"}, {"x-tenant", "bc"}}),
+            key(Http::TestRequestHeaderMapImpl{
+                {":path", "/"}, {"authorization", "ab"}, {"x-tenant", "c"}}));
+}
+
+// The context extensions of the route are part of the key, whatever their order.
+TEST_F(DecisionCacheTest, KeyOfContextExtensions) {
+  initialize("key_headers: [authorization]");
+  const Http::TestRequestHeaderMapImpl headers{{"authorization", "alice"}};
+  DecisionCache::ContextExtensionsMap extensions;
+  extensions["service"] = "users";
+  extensions["zone"] = "eu";
+  DecisionCache::ContextExtensionsMap other_extensions;
+  other_extensions["service"] = "groups";
+  other_extensions["zone"] = "eu";
+
+  EXPECT_EQ(key(headers, extensions), key(headers, extensions));
+  EXPECT_NE(key(headers, extensions), key(headers, other_extensions));
+  EXPECT_NE(key(headers, extensions), key(headers));
+}
+
+// The peer identity is the URI SANs of the peer certificate, else its subject.
+TEST_F(DecisionCacheTest, KeyOfPeerIdentity) {
+  initialize("key_peer_identity: true");
+  const Http::TestRequestHeaderMapImpl headers;
+  const std::string without_certificate = key(headers);
+
+  auto ssl = std::make_shared<NiceMock<Ssl::MockConnectionInfo>>();
+  const std::vector<std::string> uri_sans{"spiffe://foo"};
+  const std::vector<std::string> no_uri_sans;
+  const std::string subject = "CN=foo";
+  ON_CALL(connection_, ssl()).WillByDefault(Return(ssl));
+  ON_CALL(*ssl, peerCertificatePresented()).WillByDefault(Return(true));
+  ON_CALL(*ssl, uriSanPeerCertificate()).WillByDefault(Return(uri_sans));
+  ON_CALL(*ssl, subjectPeerCertificate()).WillByDefault(ReturnRef(subject));
+  const std::string with_uri_sans = key(headers);
+
+  ON_CALL(*ssl, uriSanPeerCertificate()).WillByDefault(Return(no_uri_sans));
+  const std::string with_subject = key(headers);
+
+  EXPECT_NE(without_certificate, with_uri_sans);
+  EXPECT_NE(without_certificate, with_subject);
+  EXPECT_NE(with_uri_sans, with_subject);
+}
+
+// The decisions are cached until their TTL passes.
+TEST_F(DecisionCacheTest, CachesUntilExpiry) {
+  initialize("ttl: 10s");
+  EXPECT_EQ(nullptr, cache_->lookup("foo"));
+  cache_->insert("foo", response(CheckStatus::OK));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(9));
+  Filters::Common::ExtAuthz::ResponsePtr cached = cache_->lookup("foo");
+  ASSERT_NE(nullptr, cached);
+  EXPECT_EQ(CheckStatus::OK, cached->status);
+
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_EQ(nullptr, cache_->lookup("foo"));
+  EXPECT_EQ(nullptr, cache_->lookup("foo"));
+  EXPECT_EQ(1U, counter("hit"));
+  EXPECT_EQ(3U, counter("miss"));
+  EXPECT_EQ(1U, counter("expired"));
+}
+
+// The TTL returned in the dynamic metadata overrides the configured one.
+TEST_F(DecisionCacheTest, TtlFromMetadata) {
+  initialize(R"EOF(
+ttl: 10s
+ttl_metadata_key: cache_ttl
+)EOF");
+  Response short_lived = response(CheckStatus::OK);
+  (*short_lived.dynamic_metadata.mutable_fields())["cache_ttl"] = ValueUtil::numberValue(1.5);
+  cache_->insert("short", short_lived);
+  Response uncached = response(CheckStatus::OK);
+  (*uncached.dynamic_metadata.mutable_fields())["cache_ttl"] = ValueUtil::numberValue(0);
+  cache_->insert("uncached", uncached);
+  Response not_a_number = response(CheckStatus::OK);
+  (*not_a_number.dynamic_metadata.mutable_fields())["cache_ttl"] = ValueUtil::stringValue("1");
+  cache_->insert("configured", not_a_number);
+
+  EXPECT_EQ(nullptr, cache_->lookup("uncached"));
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_NE(nullptr, cache_->lookup("short"));
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_EQ(nullptr, cache_->lookup("short"));
+  EXPECT_NE(nullptr, cache_->lookup("configured"));
+}
+
+// The errors are never cached, and the denials only when configured.
+TEST_F(DecisionCacheTest, CachesDenialsWhenConfigured) {
+  initialize("{}");
+  cache_->insert("denied", response(CheckStatus::Denied));
+  cache_->insert("error", response(CheckStatus::Error));
+  EXPECT_EQ(nullptr, cache_->lookup("denied"));
+  EXPECT_EQ(nullptr, cache_->lookup("error"));
+
+  initialize("cache_denials: true");
+  cache_->insert("denied", response(CheckStatus::Denied));
+  cache_->insert("error", response(CheckStatus::Error));
+  Filters::Common::ExtAuthz::ResponsePtr cached = cache_->lookup("denied");
+  ASSERT_NE(nullptr, cached);
+  EXPECT_EQ(CheckStatus::Denied, cached->status);
+  EXPECT_EQ(nullptr, cache_->lookup("error"));
+}
+
+// The least recently used decision is evicted when the cache is full.
+TEST_F(DecisionCacheTest, EvictsLeastRecentlyUsed) {
+  initialize("max_entries: 2");
+  cache_->insert("a", response(CheckStatus::OK));
+  cache_->insert("b", response(CheckStatus::OK));
+  EXPECT_NE(nullptr, cache_->lookup("a"));
+  cache_->insert("c", response(CheckStatus::OK));
+
+  EXPECT_EQ(1U, counter("evicted"));
+  EXPECT_NE(nullptr, cache_->lookup("a"));
+  EXPECT_EQ(nullptr, cache_->lookup("b"));
+  EXPECT_NE(nullptr, cache_->lookup("c"));
+}
+
+} // namespace
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -23,9 +23,11 @@
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/router/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/tracing/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -54,8 +56,14 @@ public:
     if (!yaml.empty()) {
       TestUtility::loadFromYaml(yaml, proto_config);
     }
+    DecisionCacheSharedPtr decision_cache;
+    if (proto_config.has_decision_cache()) {
+      decision_cache = std::make_shared<DecisionCache>(proto_config.decision_cache(), tls_,
+                                                       time_system_, stats_store_,
+                                                       "ext_authz_prefix.decision_cache.");
+    }
     config_.reset(new FilterConfig(proto_config, stats_store_, runtime_, http_context_,
-                                   "ext_authz_prefix", bootstrap_));
+                                   "ext_authz_prefix", bootstrap_, std::move(decision_cache)));
     client_ = new Filters::Common::ExtAuthz::MockClient();
     filter_ = std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{client_});
     filter_->setDecoderFilterCallbacks(filter_callbacks_);
@@ -70,6 +78,8 @@ public:
   }
 
   NiceMock<Stats::MockIsolatedStatsStore> stats_store_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Event::SimulatedTimeSystem time_system_;
   envoy::config::bootstrap::v3::Bootstrap bootstrap_;
   FilterConfigSharedPtr config_;
   Filters::Common::ExtAuthz::MockClient* client_;
@@ -374,6 +384,64 @@ TEST_F(HttpFilterTest, ImmediateErrorOpen) {
   EXPECT_EQ(1U, config_->stats().failure_mode_allowed_.value());
 }
 
+// Verifies that a cached decision answers the requests sharing its key without calling the
+// authorization service, and that errors aren't cached.
+TEST_F(HttpFilterTest, CachedDecision) {
+  initialize(R"EOF(
+  transport_api_version: V3
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_authz_server"
+  decision_cache:
+    key_headers: [authorization]
+  )EOF");
+  prepareCheck();
+  request_headers_.addCopy(Http::LowerCaseString("authorization"), "alice");
+
+  auto respond = [](Filters::Common::ExtAuthz::CheckStatus status) {
+    return [status](Filters::Common::ExtAuthz::RequestCallbacks& callbacks,
+                    const envoy::service::auth::v3::CheckRequest&, Tracing::Span&,
+                    const StreamInfo::StreamInfo&) -> void {
+      Filters::Common::ExtAuthz::Response response{};
+      response.status = status;
+      callbacks.onComplete(std::make_unique<Filters::Common::ExtAuthz::Response>(response));
+    };
+  };
+  auto resetFilter = [this]() {
+    client_ = new Filters::Common::ExtAuthz::MockClient();
+    filter_ = std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{client_});
+    filter_->setDecoderFilterCallbacks(filter_callbacks_);
+    filter_->setEncoderFilterCallbacks(encoder_filter_callbacks_);
+  };
+
+  EXPECT_CALL(*client_, check(_, _, _, _))
+      .WillOnce(Invoke(respond(Filters::Common::ExtAuthz::CheckStatus::OK)));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
+
+  resetFilter();
+  EXPECT_CALL(*client_, check(_, _, _, _)).Times(0);
+  EXPECT_CALL(filter_callbacks_, continueDecoding()).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(2U, config_->stats().ok_.value());
+  EXPECT_EQ(1U, stats_store_.counterFromString("ext_authz_prefix.decision_cache.hit").value());
+
+  // An error of the authorization service isn't cached.
+  resetFilter();
+  Http::TestRequestHeaderMapImpl bob_headers{request_headers_};
+  bob_headers.setCopy(Http::LowerCaseString("authorization"), "bob");
+  EXPECT_CALL(*client_, check(_, _, _, _))
+      .WillOnce(Invoke(respond(Filters::Common::ExtAuthz::CheckStatus::Error)));
+  EXPECT_CALL(filter_callbacks_, sendLocalReply(Http::Code::Forbidden, _, _, _, _));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            filter_->decodeHeaders(bob_headers, true));
+
+  resetFilter();
+  EXPECT_CALL(*client_, check(_, _, _, _))
+      .WillOnce(Invoke(respond(Filters::Common::ExtAuthz::CheckStatus::OK)));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(bob_headers, true));
+  EXPECT_EQ(3U, stats_store_.counterFromString("ext_authz_prefix.decision_cache.miss").value());
+}
+
 // Check a bad configuration results in validation exception.
 TEST_F(HttpFilterTest, BadConfig) {
   const std::string filter_config = R"EOF(
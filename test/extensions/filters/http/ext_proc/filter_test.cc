@@ -5,6 +5,7 @@
 #include "test/common/http/common.h"
 #include "test/extensions/filters/http/ext_proc/mock_server.h"
 #include "test/extensions/filters/http/ext_proc/utils.h"
+#include "test/mocks/buffer/mocks.h"
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/network/mocks.h"
@@ -78,6 +79,10 @@ protected:
   }
 
   void doSend(ProcessingRequest&& request, Unused) {
+    if (queue_streamed_requests_ && (request.has_request_body() || request.has_response_body())) {
+      streamed_requests_.push_back(std::move(request));
+      return;
+    }
     ASSERT_TRUE(last_request_processed_);
     last_request_ = std::move(request);
     last_request_processed_ = false;
@@ -181,10 +186,27 @@ protected:
     stream_callbacks_->onReceiveMessage(std::move(response));
   }
 
+  // Expect the oldest queued request_body request, and send back a response
+  // that replaces its body if a new body is given
+  void processStreamedRequestBody(absl::optional<std::string> new_body) {
+    ASSERT_FALSE(streamed_requests_.empty());
+    ASSERT_TRUE(streamed_requests_.front().has_request_body());
+    streamed_requests_.pop_front();
+    auto response = std::make_unique<ProcessingResponse>();
+    auto* body_response = response->mutable_request_body();
+    if (new_body) {
+      body_response->mutable_response()->mutable_body_mutation()->set_body(*new_body);
+    }
+    stream_callbacks_->onReceiveMessage(std::move(response));
+  }
+
   std::unique_ptr<MockClient> client_;
   ExternalProcessorCallbacks* stream_callbacks_ = nullptr;
   ProcessingRequest last_request_;
   bool last_request_processed_ = true;
+  // When set, the body requests are queued rather than checked one at a time.
+  bool queue_streamed_requests_ = false;
+  std::deque<ProcessingRequest> streamed_requests_;
   bool server_closed_stream_ = false;
   NiceMock<Stats::MockIsolatedStatsStore> stats_store_;
   FilterConfigSharedPtr config_;
@@ -825,54 +847,136 @@ TEST_F(HttpFilterTest, PostAndChangeBothBodiesBufferedMultiChunk) {
   EXPECT_EQ(1, config_->stats().streams_closed_.value());
 }
 
-// Using a configuration with streaming set for the request and
-// response bodies, we should ignore a "buffered" body mode for now
-// because it is not implemented.
-TEST_F(HttpFilterTest, PostAndIgnoreStreamedBodiesUntilImplemented) {
+// Using a configuration with streaming set for the request body, test that
+// the chunks are sent without waiting for the responses of the previous ones
+// up to the configured limit, and that they continue in order as their
+// responses come back.
+TEST_F(HttpFilterTest, StreamRequestBodyPipelined) {
   initialize(R"EOF(
   grpc_service:
     envoy_grpc:
       cluster_name: "ext_proc_server"
   processing_mode:
-    request_header_mode: "SEND"
-    response_header_mode: "SEND"
     request_body_mode: "STREAMED"
-    response_body_mode: "STREAMED"
-    request_trailer_mode: "SKIP"
-    response_trailer_mode: "SKIP"
+    response_header_mode: "SKIP"
+  max_streamed_chunks_in_flight: 2
   )EOF");
 
-  // Create synthetic HTTP request
   HttpTestUtility::addDefaultHeaders(request_headers_, "POST");
-  request_headers_.addCopy(LowerCaseString("content-type"), "text/plain");
-  request_headers_.addCopy(LowerCaseString("content-length"), 100);
+  request_headers_.addCopy(LowerCaseString("content-length"), 13);
 
   EXPECT_EQ(FilterHeadersStatus::StopIteration, filter_->decodeHeaders(request_headers_, false));
   processRequestHeaders(false, absl::nullopt);
+  // The processor may change the size of the chunks.
+  EXPECT_EQ(nullptr, request_headers_.ContentLength());
 
-  Buffer::OwnedImpl req_data;
-  TestUtility::feedBufferWithRandomCharacters(req_data, 100);
-  EXPECT_EQ(FilterDataStatus::Continue, filter_->decodeData(req_data, true));
-  EXPECT_EQ(FilterTrailersStatus::Continue, filter_->decodeTrailers(request_trailers_));
+  queue_streamed_requests_ = true;
+  Buffer::OwnedImpl req_data_1("Hello");
+  Buffer::OwnedImpl req_data_2(", ");
+  Buffer::OwnedImpl req_data_3("World!");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_1, false));
+  EXPECT_EQ(0, req_data_1.length());
+  // With as many chunks in flight as allowed, the sender is asked to pause.
+  EXPECT_CALL(decoder_callbacks_, onDecoderFilterAboveWriteBufferHighWatermark());
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_2, false));
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data_3, true));
+  ASSERT_EQ(2, streamed_requests_.size());
+  EXPECT_EQ("Hello", streamed_requests_[0].request_body().body());
+  EXPECT_EQ(", ", streamed_requests_[1].request_body().body());
+
+  EXPECT_CALL(decoder_callbacks_,
+              injectDecodedDataToFilterChain(BufferStringEqual("Goodbye"), false));
+  processStreamedRequestBody("Goodbye");
+  // The response made room for the last chunk.
+  ASSERT_EQ(2, streamed_requests_.size());
+  EXPECT_EQ("World!", streamed_requests_[1].request_body().body());
+  EXPECT_TRUE(streamed_requests_[1].request_body().end_of_stream());
 
-  response_headers_.addCopy(LowerCaseString(":status"), "200");
-  response_headers_.addCopy(LowerCaseString("content-type"), "text/plain");
-  response_headers_.addCopy(LowerCaseString("content-length"), "100");
+  EXPECT_CALL(decoder_callbacks_, onDecoderFilterBelowWriteBufferLowWatermark());
+  EXPECT_CALL(decoder_callbacks_, injectDecodedDataToFilterChain(BufferStringEqual(", "), false));
+  processStreamedRequestBody(absl::nullopt);
+  EXPECT_CALL(decoder_callbacks_,
+              injectDecodedDataToFilterChain(BufferStringEqual("World!"), true));
+  processStreamedRequestBody(absl::nullopt);
+  EXPECT_TRUE(streamed_requests_.empty());
 
-  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->encode100ContinueHeaders(response_headers_));
+  filter_->onDestroy();
+
+  EXPECT_EQ(4, config_->stats().stream_msgs_sent_.value());
+  EXPECT_EQ(4, config_->stats().stream_msgs_received_.value());
+}
+
+// Using a configuration with streaming set for the request body and the
+// request trailers sent, test that the trailers wait for the streamed chunks
+// to come back before they are sent.
+TEST_F(HttpFilterTest, StreamRequestBodyThenTrailers) {
+  initialize(R"EOF(
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_proc_server"
+  processing_mode:
+    request_body_mode: "STREAMED"
+    response_header_mode: "SKIP"
+    request_trailer_mode: "SEND"
+  )EOF");
+
+  HttpTestUtility::addDefaultHeaders(request_headers_, "POST");
+  EXPECT_EQ(FilterHeadersStatus::StopIteration, filter_->decodeHeaders(request_headers_, false));
+  processRequestHeaders(false, absl::nullopt);
+
+  queue_streamed_requests_ = true;
+  Buffer::OwnedImpl req_data("foo");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(req_data, false));
+  EXPECT_EQ(FilterTrailersStatus::StopIteration, filter_->decodeTrailers(request_trailers_));
+  queue_streamed_requests_ = false;
+
+  EXPECT_CALL(decoder_callbacks_, injectDecodedDataToFilterChain(BufferStringEqual("foo"), false));
+  processStreamedRequestBody(absl::nullopt);
+  ASSERT_TRUE(last_request_.has_request_trailers());
+
+  auto response = std::make_unique<ProcessingResponse>();
+  response->mutable_request_trailers();
+  last_request_processed_ = true;
+  EXPECT_CALL(decoder_callbacks_, continueDecoding());
+  stream_callbacks_->onReceiveMessage(std::move(response));
+
+  filter_->onDestroy();
+}
+
+// Using a configuration with streaming set for the response body, test that
+// the streamed chunks continue unprocessed and in order when the processor
+// closes the stream before it responds to them.
+TEST_F(HttpFilterTest, StreamResponseBodyFlushedOnClose) {
+  initialize(R"EOF(
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_proc_server"
+  processing_mode:
+    request_header_mode: "SKIP"
+    response_body_mode: "STREAMED"
+  )EOF");
+
+  HttpTestUtility::addDefaultHeaders(request_headers_, "GET");
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
+
+  response_headers_.addCopy(LowerCaseString(":status"), "200");
   EXPECT_EQ(FilterHeadersStatus::StopIteration, filter_->encodeHeaders(response_headers_, false));
   processResponseHeaders(false, absl::nullopt);
 
-  Buffer::OwnedImpl resp_data;
-  TestUtility::feedBufferWithRandomCharacters(resp_data, 100);
-  EXPECT_EQ(FilterDataStatus::Continue, filter_->encodeData(resp_data, true));
+  queue_streamed_requests_ = true;
+  Buffer::OwnedImpl resp_data_1("foo");
+  Buffer::OwnedImpl resp_data_2("bar");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(resp_data_1, false));
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(resp_data_2, true));
+  EXPECT_EQ(2, streamed_requests_.size());
 
-  EXPECT_EQ(FilterTrailersStatus::Continue, filter_->encodeTrailers(response_trailers_));
-  filter_->onDestroy();
+  testing::InSequence s;
+  EXPECT_CALL(encoder_callbacks_, injectEncodedDataToFilterChain(BufferStringEqual("foo"), false));
+  EXPECT_CALL(encoder_callbacks_, injectEncodedDataToFilterChain(BufferStringEqual("bar"), true));
+  server_closed_stream_ = true;
+  stream_callbacks_->onGrpcClose();
 
-  EXPECT_EQ(1, config_->stats().streams_started_.value());
-  EXPECT_EQ(2, config_->stats().stream_msgs_sent_.value());
-  EXPECT_EQ(2, config_->stats().stream_msgs_received_.value());
+  filter_->onDestroy();
   EXPECT_EQ(1, config_->stats().streams_closed_.value());
 }
 
@@ -0,0 +1,120 @@
+// Measures the decoding of HttpBody responses received in chunks of 16KiB, either by buffering
+// each gRPC frame until it is whole, as the transcoder does by default, or incrementally as it
+// does when streaming responses. The bytes_before_first_output counter is the response data
+// received before the first bytes of the body could be forwarded, which is also the data the
+// decoding buffers at most.
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/zero_copy_input_stream_impl.h"
+#include "source/common/grpc/codec.h"
+#include "source/common/grpc/common.h"
+#include "source/extensions/filters/http/grpc_json_transcoder/http_body_stream_decoder.h"
+#include "source/extensions/filters/http/grpc_json_transcoder/http_body_utils.h"
+
+#include "benchmark/benchmark.h"
+#include "google/api/httpbody.pb.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace GrpcJsonTranscoder {
+namespace {
+
+constexpr uint64_t ChunkSize = 16 * 1024;
+
+// @return the response of the given number of messages with the given body size, in chunks.
+std::vector<std::string> makeResponse(uint64_t messages, uint64_t body_size) {
+  google::api::HttpBody http_body;
+  http_body.set_content_type("application/json");
+  http_body.set_data(std::string(body_size, 'a'));
+  Buffer::OwnedImpl response;
+  for (uint64_t i = 0; i < messages; i++) {
+    response.add(*Grpc::Common::serializeToGrpcFrame(http_body));
+  }
+  std::vector<std::string> chunks;
+  while (response.length() > 0) {
+    const uint64_t length = std::min(ChunkSize, response.length());
+    std::string chunk(length, '\0');
+    response.copyOut(0, length, chunk.data());
+    chunks.push_back(std::move(chunk));
+    response.drain(length);
+  }
+  return chunks;
+}
+
+void setCounters(benchmark::State& state, uint64_t bytes_before_first_output, uint64_t bytes) {
+  state.counters["bytes_before_first_output"] = bytes_before_first_output;
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_FrameDecoder(benchmark::State& state) {
+  const std::vector<std::string> chunks = makeResponse(state.range(0), state.range(1));
+  const std::vector<const ProtobufWkt::Field*> field_path;
+  uint64_t bytes_before_first_output = 0;
+  uint64_t bytes = 0;
+  for (auto _ : state) { // NOLINT
+    Grpc::Decoder decoder;
+    bytes = 0;
+    bytes_before_first_output = 0;
+    for (const std::string& chunk : chunks) {
+      Buffer::OwnedImpl data(chunk);
+      bytes += chunk.size();
+      std::vector<Grpc::Frame> frames;
+      decoder.decode(data, frames);
+      for (auto& frame : frames) {
+        google::api::HttpBody http_body;
+        Buffer::ZeroCopyInputStreamImpl stream(std::move(frame.data_));
+        HttpBodyUtils::parseMessageByFieldPath(&stream, field_path, &http_body);
+        if (bytes_before_first_output == 0 && !http_body.data().empty()) {
+          bytes_before_first_output = bytes;
+        }
+        benchmark::DoNotOptimize(http_body.data().size());
+      }
+    }
+  }
+  setCounters(state, bytes_before_first_output, bytes);
+}
+BENCHMARK(BM_FrameDecoder)
+    ->Args({1, 50 << 20})
+    ->Args({1000, 50 << 10})
+    ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_StreamDecoder(benchmark::State& state) {
+  const std::vector<std::string> chunks = makeResponse(state.range(0), state.range(1));
+  const std::vector<const ProtobufWkt::Field*> field_path;
+  uint64_t bytes_before_first_output = 0;
+  uint64_t bytes = 0;
+  for (auto _ : state) { // NOLINT
+    HttpBodyStreamDecoder decoder(field_path);
+    bytes = 0;
+    bytes_before_first_output = 0;
+    for (const std::string& chunk : chunks) {
+      Buffer::OwnedImpl data(chunk);
+      bytes += chunk.size();
+      Buffer::OwnedImpl output;
+      decoder.decode(data, output);
+      if (bytes_before_first_output == 0 && output.length() > 0) {
+        bytes_before_first_output = bytes;
+      }
+      benchmark::DoNotOptimize(output.length());
+    }
+  }
+  setCounters(state, bytes_before_first_output, bytes);
+}
+BENCHMARK(BM_StreamDecoder)
+    ->Args({1, 50 << 20})
+    ->Args({1000, 50 << 10})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace GrpcJsonTranscoder
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
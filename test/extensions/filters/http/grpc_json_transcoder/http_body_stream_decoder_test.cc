@@ -0,0 +1,139 @@
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/grpc/common.h"
+#include "source/extensions/filters/http/grpc_json_transcoder/http_body_stream_decoder.h"
+
+#include "test/proto/bookstore.pb.h"
+
+#include "google/api/httpbody.pb.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace GrpcJsonTranscoder {
+namespace {
+
+class HttpBodyStreamDecoderTest : public testing::Test {
+public:
+  void setBodyFieldPath(const std::vector<int>& body_field_path) {
+    for (int field_number : body_field_path) {
+      ProtobufWkt::Field field;
+      field.set_number(field_number);
+      raw_body_field_path_.emplace_back(std::move(field));
+    }
+    for (auto& field : raw_body_field_path_) {
+      body_field_path_.push_back(&field);
+    }
+  }
+
+  // Decodes the data a byte at a time, checking that the body is forwarded as it is received.
+  std::string decodeBytewise(HttpBodyStreamDecoder& decoder, Buffer::Instance& data) {
+    std::string body;
+    while (data.length() > 0) {
+      Buffer::OwnedImpl byte;
+      byte.move(data, 1);
+      Buffer::OwnedImpl output;
+      EXPECT_TRUE(decoder.decode(byte, output));
+      EXPECT_EQ(0, byte.length());
+      EXPECT_LE(output.length(), 1);
+      body += output.toString();
+    }
+    return body;
+  }
+
+  std::vector<ProtobufWkt::Field> raw_body_field_path_;
+  std::vector<const ProtobufWkt::Field*> body_field_path_;
+};
+
+TEST_F(HttpBodyStreamDecoderTest, Bytewise) {
+  HttpBodyStreamDecoder decoder(body_field_path_);
+  google::api::HttpBody http_body;
+  http_body.set_content_type("text/plain");
+  http_body.set_data(std::string(20000, 'a'));
+  auto data = Grpc::Common::serializeToGrpcFrame(http_body);
+
+  EXPECT_EQ(http_body.data(), decodeBytewise(decoder, *data));
+  EXPECT_TRUE(decoder.contentTypeDecoded());
+  EXPECT_EQ("text/plain", decoder.contentType());
+}
+
+// The content type is the one of the first message of the stream.
+TEST_F(HttpBodyStreamDecoderTest, MultipleMessages) {
+  HttpBodyStreamDecoder decoder(body_field_path_);
+  Buffer::OwnedImpl data;
+  google::api::HttpBody http_body;
+  http_body.set_content_type("text/html");
+  http_body.set_data("msg1");
+  data.add(*Grpc::Common::serializeToGrpcFrame(http_body));
+  http_body.set_content_type("text/plain");
+  http_body.set_data("msg2");
+  data.add(*Grpc::Common::serializeToGrpcFrame(http_body));
+
+  Buffer::OwnedImpl output;
+  EXPECT_TRUE(decoder.decode(data, output));
+  EXPECT_EQ("msg1msg2", output.toString());
+  EXPECT_EQ("text/html", decoder.contentType());
+}
+
+// The content type of a message without data is known once the message ends.
+TEST_F(HttpBodyStreamDecoderTest, NoData) {
+  HttpBodyStreamDecoder decoder(body_field_path_);
+  google::api::HttpBody http_body;
+  http_body.set_content_type("text/plain");
+  auto data = Grpc::Common::serializeToGrpcFrame(http_body);
+  Buffer::OwnedImpl fragment;
+  fragment.move(*data, data->length() - 1);
+
+  Buffer::OwnedImpl output;
+  EXPECT_TRUE(decoder.decode(fragment, output));
+  EXPECT_FALSE(decoder.contentTypeDecoded());
+  EXPECT_TRUE(decoder.decode(*data, output));
+  EXPECT_TRUE(decoder.contentTypeDecoded());
+  EXPECT_EQ("text/plain", decoder.contentType());
+  EXPECT_EQ(0, output.length());
+}
+
+// The body nested in the response message is decoded, skipping the other fields.
+TEST_F(HttpBodyStreamDecoderTest, NestedBodySkippingUnknownFields) {
+  setBodyFieldPath({1, 1000000, 100000000, 500000000});
+  HttpBodyStreamDecoder decoder(body_field_path_);
+  bookstore::DeepNestedBody message;
+  auto* body = message.mutable_nested()->mutable_nested()->mutable_nested()->mutable_body();
+  body->set_content_type("text/nested");
+  body->set_data("abcd");
+  message.mutable_extra()->set_field("test");
+  message.mutable_nested()->mutable_extra()->set_field(123);
+  auto data = Grpc::Common::serializeToGrpcFrame(message);
+
+  EXPECT_EQ("abcd", decodeBytewise(decoder, *data));
+  EXPECT_EQ("text/nested", decoder.contentType());
+}
+
+TEST_F(HttpBodyStreamDecoderTest, FailCompressedFrame) {
+  HttpBodyStreamDecoder decoder(body_field_path_);
+  Buffer::OwnedImpl data("\x01\x00\x00\x00\x01\x0a", 6);
+  Buffer::OwnedImpl output;
+  EXPECT_FALSE(decoder.decode(data, output));
+}
+
+TEST_F(HttpBodyStreamDecoderTest, FailFieldLongerThanMessage) {
+  HttpBodyStreamDecoder decoder(body_field_path_);
+  // A message of 3 bytes, with a data field of 2 bytes longer than it.
+  Buffer::OwnedImpl data("\x00\x00\x00\x00\x03\x12\x04ab", 9);
+  Buffer::OwnedImpl output;
+  EXPECT_FALSE(decoder.decode(data, output));
+}
+
+TEST_F(HttpBodyStreamDecoderTest, FailInvalidTag) {
+  HttpBodyStreamDecoder decoder(body_field_path_);
+  // A message of 2 bytes, with a tag that doesn't fit in it.
+  Buffer::OwnedImpl data("\x00\x00\x00\x00\x02\x80\x80", 7);
+  Buffer::OwnedImpl output;
+  EXPECT_FALSE(decoder.decode(data, output));
+}
+
+} // namespace
+} // namespace GrpcJsonTranscoder
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -137,6 +137,69 @@ TEST_F(GrpcJsonTranscoderConfigTest, ParseBinaryConfig) {
   EXPECT_NO_THROW(JsonTranscoderConfig config(proto_config, *api_));
 }
 
+// The configs of the same descriptor set and method mapping share their descriptor pool, even if
+// they print the messages differently or load the descriptor set differently.
+TEST_F(GrpcJsonTranscoderConfigTest, SharedDescriptorPool) {
+  auto cache = std::make_shared<CompiledDescriptorPoolCache>();
+  const std::string descriptor_path =
+      TestEnvironment::runfilesPath("test/proto/bookstore.descriptor");
+  JsonTranscoderConfig config(getProtoConfig(descriptor_path, "bookstore.Bookstore"), *api_,
+                              cache);
+
+  auto proto_config = getProtoConfig(descriptor_path, "bookstore.Bookstore", true);
+  proto_config.mutable_print_options()->set_add_whitespace(true);
+  JsonTranscoderConfig same_mapping_config(proto_config, *api_, cache);
+  EXPECT_EQ(config.descriptorPool(), same_mapping_config.descriptorPool());
+
+  proto_config.set_proto_descriptor_bin(api_->fileSystem().fileReadToEnd(descriptor_path));
+  JsonTranscoderConfig binary_config(proto_config, *api_, cache);
+  EXPECT_EQ(config.descriptorPool(), binary_config.descriptorPool());
+
+  proto_config.set_auto_mapping(true);
+  JsonTranscoderConfig auto_mapping_config(proto_config, *api_, cache);
+  EXPECT_NE(config.descriptorPool(), auto_mapping_config.descriptorPool());
+
+  JsonTranscoderConfig ignored_parameters_config(
+      getProtoConfig(descriptor_path, "bookstore.Bookstore", false, {"key"}), *api_, cache);
+  EXPECT_NE(config.descriptorPool(), ignored_parameters_config.descriptorPool());
+  EXPECT_EQ(3, cache->size());
+
+  // The configs built without the cache have their own pool.
+  JsonTranscoderConfig uncached_config(getProtoConfig(descriptor_path, "bookstore.Bookstore"),
+                                       *api_);
+  EXPECT_NE(config.descriptorPool(), uncached_config.descriptorPool());
+}
+
+// A pool is built again once the configs which used it are gone.
+TEST_F(GrpcJsonTranscoderConfigTest, SharedDescriptorPoolReleased) {
+  auto cache = std::make_shared<CompiledDescriptorPoolCache>();
+  const auto proto_config = getProtoConfig(
+      TestEnvironment::runfilesPath("test/proto/bookstore.descriptor"), "bookstore.Bookstore");
+  std::weak_ptr<const CompiledDescriptorPool> pool;
+  {
+    JsonTranscoderConfig config(proto_config, *api_, cache);
+    pool = config.descriptorPool();
+  }
+  EXPECT_TRUE(pool.expired());
+
+  JsonTranscoderConfig config(proto_config, *api_, cache);
+  EXPECT_NE(nullptr, config.descriptorPool());
+  EXPECT_EQ(1, cache->size());
+}
+
+// An invalid config doesn't leave a pool in the cache.
+TEST_F(GrpcJsonTranscoderConfigTest, SharedDescriptorPoolUnknownService) {
+  auto cache = std::make_shared<CompiledDescriptorPoolCache>();
+  EXPECT_THROW_WITH_MESSAGE(
+      JsonTranscoderConfig config(
+          getProtoConfig(TestEnvironment::runfilesPath("test/proto/bookstore.descriptor"),
+                         "grpc.service.UnknownService"),
+          *api_, cache),
+      EnvoyException,
+      "transcoding_filter: Could not find 'grpc.service.UnknownService' in the proto descriptor");
+  EXPECT_EQ(0, cache->size());
+}
+
 TEST_F(GrpcJsonTranscoderConfigTest, UnknownService) {
   EXPECT_THROW_WITH_MESSAGE(
       JsonTranscoderConfig config(
@@ -1245,6 +1308,146 @@ TEST_F(GrpcJsonTranscoderFilterTest, TranscodingStreamWithFragmentedHttpBody) {
   EXPECT_EQ(http_body.data(), fragment2->toString());
 }
 
+class GrpcJsonTranscoderFilterStreamResponsesTest : public GrpcJsonTranscoderFilterTest {
+public:
+  GrpcJsonTranscoderFilterStreamResponsesTest()
+      : GrpcJsonTranscoderFilterTest(makeProtoConfig()) {}
+
+private:
+  const envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder
+  makeProtoConfig() {
+    auto proto_config = bookstoreProtoConfig();
+    proto_config.set_stream_responses(true);
+    return proto_config;
+  }
+};
+
+TEST_F(GrpcJsonTranscoderFilterStreamResponsesTest, TranscodingUnaryPost) {
+  Http::TestRequestHeaderMapImpl request_headers{
+      {"content-type", "application/json"}, {":method", "POST"}, {":path", "/shelf"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, false));
+
+  Http::TestResponseHeaderMapImpl response_headers{
+      {"content-type", "application/grpc"}, {":status", "200"}, {"content-length", "100"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.encodeHeaders(response_headers, false));
+
+  bookstore::Shelf response;
+  response.set_id(20);
+  response.set_theme("Children");
+  auto fragment2 = Grpc::Common::serializeToGrpcFrame(response);
+  Buffer::OwnedImpl fragment1;
+  fragment1.move(*fragment2, fragment2->length() / 2);
+
+  // The headers are held until the message is transcoded, and then forwarded with it.
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_.encodeData(fragment1, false));
+  EXPECT_EQ(0, fragment1.length());
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.encodeData(*fragment2, false));
+  EXPECT_EQ("{\"id\":\"20\",\"theme\":\"Children\"}", fragment2->toString());
+  EXPECT_EQ("application/json", response_headers.get_("content-type"));
+  EXPECT_EQ(nullptr, response_headers.ContentLength());
+
+  Http::TestResponseTrailerMapImpl response_trailers{{"grpc-status", "0"}};
+  EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_.encodeTrailers(response_trailers));
+  EXPECT_EQ(nullptr, response_headers.ContentLength());
+}
+
+// A unary response without data keeps the status of its gRPC trailers.
+TEST_F(GrpcJsonTranscoderFilterStreamResponsesTest, TranscodingUnaryErrorFromTrailer) {
+  Http::TestRequestHeaderMapImpl request_headers{
+      {"content-type", "application/json"}, {":method", "POST"}, {":path", "/shelf"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, false));
+
+  Http::TestResponseHeaderMapImpl response_headers{{"content-type", "application/grpc"},
+                                                   {":status", "200"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.encodeHeaders(response_headers, false));
+
+  Http::TestResponseTrailerMapImpl response_trailers{{"grpc-status", "5"},
+                                                     {"grpc-message", "unknown shelf"}};
+  EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_.encodeTrailers(response_trailers));
+  EXPECT_EQ("404", response_headers.get_(":status"));
+  EXPECT_EQ("unknown shelf", response_headers.get_("grpc-message"));
+}
+
+// The body of an HttpBody response is forwarded as it is received, before its message is whole.
+TEST_F(GrpcJsonTranscoderFilterStreamResponsesTest, TranscodingUnaryWithFragmentedHttpBody) {
+  Http::TestRequestHeaderMapImpl request_headers{{":method", "GET"}, {":path", "/index"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, false));
+
+  Http::TestResponseHeaderMapImpl response_headers{{"content-type", "application/grpc"},
+                                                   {":status", "200"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.encodeHeaders(response_headers, false));
+
+  google::api::HttpBody response;
+  response.set_content_type("text/html");
+  response.set_data("<h1>Hello, world!</h1>");
+  auto fragment3 = Grpc::Common::serializeToGrpcFrame(response);
+  // The frame header and the first bytes of the content type.
+  Buffer::OwnedImpl fragment1;
+  fragment1.move(*fragment3, 8);
+  // The rest of the content type and the first bytes of the data.
+  Buffer::OwnedImpl fragment2;
+  fragment2.move(*fragment3, 20);
+
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_.encodeData(fragment1, false));
+  EXPECT_EQ(0, fragment1.length());
+  EXPECT_EQ("application/json", response_headers.get_("content-type"));
+
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.encodeData(fragment2, false));
+  EXPECT_EQ("text/html", response_headers.get_("content-type"));
+  EXPECT_EQ(nullptr, response_headers.ContentLength());
+  EXPECT_EQ("<h1>Hello,", fragment2.toString());
+
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.encodeData(*fragment3, false));
+  EXPECT_EQ(" world!</h1>", fragment3->toString());
+
+  Http::TestResponseTrailerMapImpl response_trailers{{"grpc-status", "0"}};
+  EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_.encodeTrailers(response_trailers));
+  EXPECT_EQ(nullptr, response_headers.ContentLength());
+}
+
+// The messages of a server streaming HttpBody response are forwarded as they are received too.
+TEST_F(GrpcJsonTranscoderFilterStreamResponsesTest, TranscodingStreamWithHttpBodyAsOutput) {
+  Http::TestRequestHeaderMapImpl request_headers{{":method", "GET"}, {":path", "/indexStream"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, false));
+
+  Http::TestResponseHeaderMapImpl response_headers{{"content-type", "application/grpc"},
+                                                   {":status", "200"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.encodeHeaders(response_headers, false));
+
+  Buffer::OwnedImpl response_data;
+  google::api::HttpBody response;
+  response.set_content_type("text/html");
+  response.set_data("msg1");
+  response_data.add(*Grpc::Common::serializeToGrpcFrame(response));
+  response.set_content_type("text/plain");
+  response.set_data("msg2");
+  response_data.add(*Grpc::Common::serializeToGrpcFrame(response));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.encodeData(response_data, false));
+  EXPECT_EQ("text/html", response_headers.get_("content-type"));
+  EXPECT_EQ("msg1msg2", response_data.toString());
+}
+
+// Compressed frames can't be decoded incrementally.
+TEST_F(GrpcJsonTranscoderFilterStreamResponsesTest, TranscodingWithInvalidHttpBody) {
+  Http::TestRequestHeaderMapImpl request_headers{{":method", "GET"}, {":path", "/index"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, false));
+
+  Http::TestResponseHeaderMapImpl response_headers{{"content-type", "application/grpc"},
+                                                   {":status", "200"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.encodeHeaders(response_headers, false));
+
+  Buffer::OwnedImpl response_data;
+  response_data.add("\x01\x00\x00\x00\x01a", 6);
+  EXPECT_CALL(encoder_callbacks_, resetStream());
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer,
+            filter_.encodeData(response_data, false));
+}
+
 class GrpcJsonTranscoderFilterGrpcStatusTest : public GrpcJsonTranscoderFilterTest {
 public:
   GrpcJsonTranscoderFilterGrpcStatusTest(
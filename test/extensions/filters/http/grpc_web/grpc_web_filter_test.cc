@@ -247,6 +247,8 @@ TEST_F(GrpcWebFilterTest, MergeAndLimitNonProtoEncodedResponseDataWithNoEncoding
 TEST_F(GrpcWebFilterTest, UnsupportedContentType) {
   Buffer::OwnedImpl data;
   request_headers_.addCopy(Http::Headers::get().ContentType, "unsupported");
+  EXPECT_CALL(decoder_callbacks_, skipRemainingCallbacks());
+  EXPECT_CALL(encoder_callbacks_, skipRemainingCallbacks());
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers_, false));
   EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(data, false));
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_.decodeTrailers(request_trailers_));
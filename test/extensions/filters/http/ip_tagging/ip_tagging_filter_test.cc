@@ -7,14 +7,19 @@
 #include "source/common/network/utility.h"
 #include "source/extensions/filters/http/ip_tagging/ip_tagging_filter.h"
 
+#include "test/mocks/filesystem/mocks.h"
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/server/factory_context.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/test_common/environment.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::_;
+using testing::Invoke;
 using testing::Return;
 using testing::ReturnRef;
 
@@ -29,6 +34,9 @@ public:
   IpTaggingFilterTest() {
     ON_CALL(runtime_.snapshot_, featureEnabled("ip_tagging.http_filter_enabled", 100))
         .WillByDefault(Return(true));
+    ON_CALL(context_, scope()).WillByDefault(ReturnRef(stats_));
+    ON_CALL(context_, runtime()).WillByDefault(ReturnRef(runtime_));
+    ON_CALL(context_, api()).WillByDefault(ReturnRef(*api_));
   }
 
   const std::string internal_request_yaml = R"EOF(
@@ -43,14 +51,20 @@ ip_tags:
   void initializeFilter(const std::string& yaml) {
     envoy::extensions::filters::http::ip_tagging::v3::IPTagging config;
     TestUtility::loadFromYaml(yaml, config);
-    config_ = std::make_shared<IpTaggingFilterConfig>(config, "prefix.", stats_, runtime_);
+    config_ = std::make_shared<IpTaggingFilterConfig>(config, "prefix.", context_);
     filter_ = std::make_unique<IpTaggingFilter>(config_);
     filter_->setDecoderFilterCallbacks(filter_callbacks_);
   }
 
-  ~IpTaggingFilterTest() override { filter_->onDestroy(); }
+  ~IpTaggingFilterTest() override {
+    if (filter_ != nullptr) {
+      filter_->onDestroy();
+    }
+  }
 
   NiceMock<Stats::MockStore> stats_;
+  Api::ApiPtr api_{Api::createApiForTest()};
+  NiceMock<Server::Configuration::MockFactoryContext> context_;
   IpTaggingFilterConfigSharedPtr config_;
   std::unique_ptr<IpTaggingFilter> filter_;
   NiceMock<Http::MockStreamDecoderFilterCallbacks> filter_callbacks_;
@@ -277,6 +291,83 @@ TEST_F(IpTaggingFilterTest, ClearRouteCache) {
   EXPECT_FALSE(request_headers.has(Http::Headers::get().EnvoyIpTags));
 }
 
+TEST_F(IpTaggingFilterTest, NoIpTags) {
+  EXPECT_THROW_WITH_MESSAGE(
+      initializeFilter("request_type: both"), EnvoyException,
+      "HTTP IP Tagging Filter requires ip_tags or ip_tags_files to be specified.");
+}
+
+TEST_F(IpTaggingFilterTest, IpTagsFiles) {
+  const std::string path = TestEnvironment::writeStringToFileForTest("ip_tags", R"EOF(
+# Reputation list.
+low_reputation 1.2.3.0/24
+low_reputation	2001:abcd::/32
+
+spammer 1.2.3.5/32
+)EOF");
+  auto* watcher = new Filesystem::MockWatcher();
+  Filesystem::Watcher::OnChangedCb watch_cb;
+  EXPECT_CALL(context_.dispatcher_, createFilesystemWatcher_()).WillOnce(Return(watcher));
+  EXPECT_CALL(*watcher, addWatch(absl::string_view(path), Filesystem::Watcher::Events::MovedTo, _))
+      .WillOnce(Invoke([&watch_cb](absl::string_view, uint32_t,
+                                   Filesystem::Watcher::OnChangedCb cb) { watch_cb = cb; }));
+  initializeFilter(fmt::format(R"EOF(
+ip_tags:
+  - ip_tag_name: internal_request
+    ip_list:
+      - {{address_prefix: 1.2.3.5, prefix_len: 32}}
+ip_tags_files: ["{}"]
+)EOF",
+                               path));
+
+  auto tags = [this](const std::string& address) {
+    std::vector<std::string> tags =
+        config_->trie().getData(Network::Utility::parseInternetAddress(address));
+    std::sort(tags.begin(), tags.end());
+    return tags;
+  };
+  EXPECT_EQ((std::vector<std::string>{"internal_request", "low_reputation", "spammer"}),
+            tags("1.2.3.5"));
+  EXPECT_EQ(std::vector<std::string>{"low_reputation"}, tags("2001:abcd::1"));
+  EXPECT_TRUE(tags("1.2.4.1").empty());
+
+  // The IP tags are rebuilt when the file is moved into place, and swapped into the workers.
+  TestEnvironment::writeStringToFileForTest("ip_tags", "low_reputation 1.2.4.0/24\n");
+  EXPECT_CALL(stats_, counter("prefix.ip_tagging.ip_tags_reload_success"));
+  watch_cb(Filesystem::Watcher::Events::MovedTo);
+  EXPECT_EQ(std::vector<std::string>{"internal_request"}, tags("1.2.3.5"));
+  EXPECT_EQ(std::vector<std::string>{"low_reputation"}, tags("1.2.4.1"));
+
+  // The previous IP tags are kept if the file is not valid.
+  TestEnvironment::writeStringToFileForTest("ip_tags", "low_reputation 1.2.5.0/33\n");
+  EXPECT_CALL(stats_, counter("prefix.ip_tagging.ip_tags_reload_failure"));
+  watch_cb(Filesystem::Watcher::Events::MovedTo);
+  EXPECT_EQ(std::vector<std::string>{"low_reputation"}, tags("1.2.4.1"));
+
+  // The IP tags are built on the cluster init threads if there are any.
+  Event::PostCb done;
+  EXPECT_CALL(context_.cluster_manager_, runOnClusterInitThread(_, _))
+      .WillOnce(Invoke([&done](std::function<void()> work, Event::PostCb cb) {
+        work();
+        done = cb;
+        return true;
+      }));
+  TestEnvironment::writeStringToFileForTest("ip_tags", "spammer 1.2.4.1/32\n");
+  watch_cb(Filesystem::Watcher::Events::MovedTo);
+  EXPECT_EQ(std::vector<std::string>{"low_reputation"}, tags("1.2.4.1"));
+  EXPECT_CALL(stats_, counter("prefix.ip_tagging.ip_tags_reload_success"));
+  done();
+  EXPECT_EQ(std::vector<std::string>{"spammer"}, tags("1.2.4.1"));
+}
+
+TEST_F(IpTaggingFilterTest, InvalidIpTagsFile) {
+  const std::string path =
+      TestEnvironment::writeStringToFileForTest("invalid_ip_tags", "low_reputation\n");
+  EXPECT_THROW_WITH_MESSAGE(
+      initializeFilter(fmt::format("ip_tags_files: [\"{}\"]", path)), EnvoyException,
+      "invalid IP tags line 'low_reputation' (format is <tag> <ip>/<# mask bits>)");
+}
+
 // Test that the deprecated extension name still functions.
 TEST(IpTaggingFilterConfigTest, DEPRECATED_FEATURE_TEST(DeprecatedExtensionFilterName)) {
   const std::string deprecated_name = "envoy.ip_tagging";
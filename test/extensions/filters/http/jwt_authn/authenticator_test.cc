@@ -112,6 +112,61 @@ TEST_F(AuthenticatorTest, TestOkJWTandCache) {
   EXPECT_EQ(0U, filter_config_->stats().jwks_fetch_failed_.value());
 }
 
+// This test verifies the JWTs are verified once with the JWT cache, and the cached JWTs still
+// forward their payload.
+TEST_F(AuthenticatorTest, TestJwtCache) {
+  (*proto_config_.mutable_providers())[std::string(ProviderName)]
+      .mutable_jwt_cache_config()
+      ->set_jwt_cache_size(10);
+  createAuthenticator();
+  EXPECT_CALL(*raw_fetcher_, fetch(_, _, _))
+      .WillOnce(Invoke([this](const envoy::config::core::v3::HttpUri&, Tracing::Span&,
+                              JwksFetcher::JwksReceiver& receiver) {
+        receiver.onJwksSuccess(std::move(jwks_));
+      }));
+
+  for (int i = 0; i < 10; i++) {
+    Http::TestRequestHeaderMapImpl headers{{"Authorization", "Bearer " + std::string(GoodToken)}};
+
+    expectVerifyStatus(Status::Ok, headers);
+
+    EXPECT_EQ(headers.get_("sec-istio-auth-userinfo"), ExpectedPayloadValue);
+    EXPECT_FALSE(headers.has(Http::CustomHeaders::get().Authorization));
+  }
+
+  EXPECT_EQ(9U, filter_config_->stats().jwt_cache_hit_.value());
+  EXPECT_EQ(1U, filter_config_->stats().jwt_cache_miss_.value());
+}
+
+// This test verifies a cached JWT is still rejected when the audience of the request isn't
+// allowed.
+TEST_F(AuthenticatorTest, TestJwtCacheChecksAudience) {
+  (*proto_config_.mutable_providers())[std::string(ProviderName)]
+      .mutable_jwt_cache_config()
+      ->set_jwt_cache_size(10);
+  createAuthenticator();
+  EXPECT_CALL(*raw_fetcher_, fetch(_, _, _))
+      .WillOnce(Invoke([this](const envoy::config::core::v3::HttpUri&, Tracing::Span&,
+                              JwksFetcher::JwksReceiver& receiver) {
+        receiver.onJwksSuccess(std::move(jwks_));
+      }));
+
+  Http::TestRequestHeaderMapImpl headers{{"Authorization", "Bearer " + std::string(GoodToken)}};
+  expectVerifyStatus(Status::Ok, headers);
+
+  // Another authenticator of the same provider requires another audience.
+  ::google::jwt_verify::CheckAudience check_audience({"invalid_service"});
+  auth_ = Authenticator::create(
+      &check_audience, absl::make_optional<std::string>(ProviderName), false, false,
+      filter_config_->getJwksCache(), filter_config_->cm(),
+      [](Upstream::ClusterManager&) -> JwksFetcherPtr { return nullptr; },
+      filter_config_->timeSource());
+  Http::TestRequestHeaderMapImpl headers2{{"Authorization", "Bearer " + std::string(GoodToken)}};
+  expectVerifyStatus(Status::JwtAudienceNotAllowed, headers2);
+
+  EXPECT_EQ(1U, filter_config_->stats().jwt_cache_hit_.value());
+}
+
 TEST_F(AuthenticatorTest, TestCompletePaddingInJwtPayload) {
   (*proto_config_.mutable_providers())[std::string(ProviderName)].set_pad_forward_payload_header(
       true);
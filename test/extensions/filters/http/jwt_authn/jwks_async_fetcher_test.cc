@@ -73,7 +73,8 @@ public:
               });
         },
         stats_,
-        [this](google::jwt_verify::JwksPtr&& jwks) { out_jwks_array_.push_back(std::move(jwks)); });
+        [this](google::jwt_verify::JwksPtr&& jwks) { out_jwks_array_.push_back(std::move(jwks)); },
+        [this]() { return jwks_fresh_; });
 
     if (initManagerUsed()) {
       init_target_handle_->initialize(init_watcher_);
@@ -86,6 +87,8 @@ public:
   JwtAuthnFilterStats stats_;
   std::vector<Common::JwksFetcher::JwksReceiver*> fetch_receiver_array_;
   std::vector<google::jwt_verify::JwksPtr> out_jwks_array_;
+  // Whether the Jwks was fetched for another provider.
+  bool jwks_fresh_{};
 
   Init::TargetHandlePtr init_target_handle_;
   NiceMock<Init::ExpectableWatcherImpl> init_watcher_;
@@ -241,6 +244,33 @@ TEST_P(JwksAsyncFetcherTest, TestNetworkFailureFetchAndRefresh) {
   EXPECT_EQ(2U, stats_.jwks_fetch_failed_.value());
 }
 
+TEST_P(JwksAsyncFetcherTest, TestSkipFetchWhenFresh) {
+  const char config[] = R"(
+      http_uri:
+        uri: https://pubkey_server/pubkey_path
+        cluster: pubkey_cluster
+      async_fetch: {}
+)";
+
+  // The Jwks was just fetched for another provider: the listener doesn't wait for a fetch.
+  jwks_fresh_ = true;
+  if (initManagerUsed()) {
+    init_watcher_.expectReady();
+  }
+  setupAsyncFetcher(config);
+  EXPECT_EQ(fetch_receiver_array_.size(), 0);
+
+  // Once the Jwks is stale, it is fetched at the next refresh.
+  jwks_fresh_ = false;
+  timer_->invokeCallback();
+  EXPECT_EQ(fetch_receiver_array_.size(), 1);
+  auto jwks = google::jwt_verify::Jwks::createFrom(PublicKey, google::jwt_verify::Jwks::JWKS);
+  fetch_receiver_array_[0]->onJwksSuccess(std::move(jwks));
+
+  EXPECT_EQ(out_jwks_array_.size(), 1);
+  EXPECT_EQ(1U, stats_.jwks_fetch_success_.value());
+}
+
 } // namespace
 } // namespace JwtAuthn
 } // namespace HttpFilters
@@ -119,6 +119,25 @@ TEST_F(JwksCacheTest, TestSetRemoteJwksWithDefaultCacheDuration) {
   EXPECT_FALSE(jwks->isExpired());
 }
 
+// Test the remote jwks is shared by the filter configs fetching the same URI.
+TEST_F(JwksCacheTest, TestRemoteJwksSharedAcrossConfigs) {
+  JwtAuthentication other_config = config_;
+  auto other_cache =
+      JwksCache::create(other_config, context_, mock_fetcher_.AsStdFunction(), stats_);
+  (*other_config.mutable_providers())[std::string(ProviderName)]
+      .mutable_remote_jwks()
+      ->mutable_http_uri()
+      ->set_cluster("other_cluster");
+  auto other_cluster_cache =
+      JwksCache::create(other_config, context_, mock_fetcher_.AsStdFunction(), stats_);
+
+  auto jwks = cache_->findByProvider(ProviderName);
+  const auto* jwks_obj = jwks->setRemoteJwks(std::move(jwks_));
+  EXPECT_EQ(other_cache->findByProvider(ProviderName)->getJwksObj(), jwks_obj);
+  EXPECT_FALSE(other_cache->findByProvider(ProviderName)->isExpired());
+  EXPECT_TRUE(other_cluster_cache->findByProvider(ProviderName)->getJwksObj() == nullptr);
+}
+
 // Test a good local jwks
 TEST_F(JwksCacheTest, TestGoodInlineJwks) {
   auto& provider0 = (*config_.mutable_providers())[std::string(ProviderName)];
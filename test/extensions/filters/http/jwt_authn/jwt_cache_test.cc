@@ -0,0 +1,90 @@
+#include <chrono>
+
+#include "envoy/extensions/filters/http/jwt_authn/v3/config.pb.h"
+
+#include "source/extensions/filters/http/jwt_authn/jwt_cache.h"
+
+#include "test/extensions/filters/http/jwt_authn/test_common.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+using envoy::extensions::filters::http::jwt_authn::v3::JwtCacheConfig;
+using ::google::jwt_verify::Jwt;
+using ::google::jwt_verify::Status;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+namespace {
+
+class JwtCacheTest : public testing::Test {
+public:
+  void setupCache(uint32_t jwt_cache_size) {
+    JwtCacheConfig config;
+    config.set_jwt_cache_size(jwt_cache_size);
+    cache_ = JwtCache::create(config, time_system_);
+  }
+
+  std::unique_ptr<Jwt> parse(const std::string& token) {
+    auto jwt = std::make_unique<Jwt>();
+    EXPECT_EQ(jwt->parseFromString(token), Status::Ok);
+    return jwt;
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  JwtCachePtr cache_;
+};
+
+// Test a JWT is found by its token once cached.
+TEST_F(JwtCacheTest, TestInsertAndLookup) {
+  setupCache(10);
+  EXPECT_EQ(cache_->lookup(GoodToken), nullptr);
+
+  cache_->insert(GoodToken, parse(GoodToken));
+  Jwt* jwt = cache_->lookup(GoodToken);
+  ASSERT_NE(jwt, nullptr);
+  EXPECT_EQ(jwt->iss_, "https://example.com");
+  EXPECT_EQ(cache_->lookup(OtherGoodToken), nullptr);
+}
+
+// Test a JWT isn't cached past its `exp`, and an expired JWT isn't cached at all.
+TEST_F(JwtCacheTest, TestExpiration) {
+  setupCache(10);
+  cache_->insert(ExpiredToken, parse(ExpiredToken));
+  EXPECT_EQ(cache_->lookup(ExpiredToken), nullptr);
+
+  cache_->insert(GoodToken, parse(GoodToken));
+  cache_->insert(NonExpiringToken, parse(NonExpiringToken));
+  time_system_.setSystemTime(std::chrono::system_clock::from_time_t(2001001002));
+  EXPECT_EQ(cache_->lookup(GoodToken), nullptr);
+  EXPECT_NE(cache_->lookup(NonExpiringToken), nullptr);
+}
+
+// Test the least recently used JWT is evicted when the cache is full.
+TEST_F(JwtCacheTest, TestEvictLeastRecentlyUsed) {
+  setupCache(2);
+  cache_->insert(GoodToken, parse(GoodToken));
+  cache_->insert(NonExpiringToken, parse(NonExpiringToken));
+  EXPECT_NE(cache_->lookup(GoodToken), nullptr);
+  cache_->insert(OtherGoodToken, parse(OtherGoodToken));
+
+  EXPECT_NE(cache_->lookup(GoodToken), nullptr);
+  EXPECT_EQ(cache_->lookup(NonExpiringToken), nullptr);
+  EXPECT_NE(cache_->lookup(OtherGoodToken), nullptr);
+}
+
+// Test the default size of the cache is used when none is configured.
+TEST_F(JwtCacheTest, TestDefaultSize) {
+  setupCache(0);
+  cache_->insert(GoodToken, parse(GoodToken));
+  EXPECT_NE(cache_->lookup(GoodToken), nullptr);
+}
+
+} // namespace
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -5,6 +5,7 @@
 
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/http/message_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
 #include "source/common/stream_info/stream_info_impl.h"
 #include "source/extensions/filters/http/lua/lua_filter.h"
 
@@ -91,7 +92,8 @@ public:
   void setupConfig(envoy::extensions::filters::http::lua::v3::Lua& proto_config,
                    envoy::extensions::filters::http::lua::v3::LuaPerRoute& per_route_proto_config) {
     // Setup filter config for Lua filter.
-    config_ = std::make_shared<FilterConfig>(proto_config, tls_, cluster_manager_, api_);
+    config_ = std::make_shared<FilterConfig>(proto_config, tls_, cluster_manager_, api_,
+                                             stats_store_, "test.");
     // Setup per route config for Lua filter.
     per_route_config_ =
         std::make_shared<FilterConfigPerRoute>(per_route_proto_config, server_factory_context_);
@@ -122,6 +124,7 @@ public:
   NiceMock<ThreadLocal::MockInstance> tls_;
   NiceMock<Api::MockApi> api_;
   Upstream::MockClusterManager cluster_manager_;
+  Stats::IsolatedStoreImpl stats_store_;
   std::shared_ptr<FilterConfig> config_;
   std::shared_ptr<FilterConfigPerRoute> per_route_config_;
   std::unique_ptr<TestFilter> filter_;
@@ -226,11 +229,12 @@ TEST(LuaHttpFilterConfigTest, BadCode) {
   NiceMock<ThreadLocal::MockInstance> tls;
   NiceMock<Upstream::MockClusterManager> cluster_manager;
   NiceMock<Api::MockApi> api;
+  Stats::IsolatedStoreImpl stats_store;
 
   envoy::extensions::filters::http::lua::v3::Lua proto_config;
   proto_config.set_inline_code(SCRIPT);
 
-  EXPECT_THROW_WITH_MESSAGE(FilterConfig(proto_config, tls, cluster_manager, api),
+  EXPECT_THROW_WITH_MESSAGE(FilterConfig(proto_config, tls, cluster_manager, api, stats_store, ""),
                             Filters::Common::Lua::LuaException,
                             "script load error: [string \"...\"]:3: '=' expected near '<eof>'");
 }
@@ -245,6 +249,23 @@ TEST_F(LuaHttpFilterTest, ScriptHeadersOnlyRequestHeadersOnly) {
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
 }
 
+// The coroutine of a finished stream is reused by the next stream.
+TEST_F(LuaHttpFilterTest, CoroutineReused) {
+  setup(HEADER_ONLY_SCRIPT);
+
+  Http::TestRequestHeaderMapImpl request_headers{{":path", "/"}};
+  EXPECT_CALL(*filter_, scriptLog(spdlog::level::trace, StrEq("/")));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+  filter_->onDestroy();
+
+  setupFilter();
+  EXPECT_CALL(*filter_, scriptLog(spdlog::level::trace, StrEq("/")));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+
+  EXPECT_EQ(1U, stats_store_.counterFromString("test.lua.coroutines_created").value());
+  EXPECT_EQ(1U, stats_store_.counterFromString("test.lua.coroutines_reused").value());
+}
+
 // Script touching headers only, request that has body.
 TEST_F(LuaHttpFilterTest, ScriptHeadersOnlyRequestBody) {
   InSequence s;
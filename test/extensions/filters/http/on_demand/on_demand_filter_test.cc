@@ -5,12 +5,16 @@
 
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/mocks/upstream/od_cds_api_handle.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::Invoke;
 using testing::Return;
+using testing::SaveArg;
 
 namespace Envoy {
 namespace Extensions {
@@ -20,10 +24,28 @@ namespace OnDemand {
 class OnDemandFilterTest : public testing::Test {
 public:
   void SetUp() override {
-    filter_ = std::make_unique<OnDemandRouteUpdate>();
+    filter_ = std::make_unique<OnDemandRouteUpdate>(
+        std::make_shared<OnDemandFilterConfig>(cm_, nullptr, std::chrono::milliseconds(5000)));
     filter_->setDecoderFilterCallbacks(decoder_callbacks_);
   }
 
+  NiceMock<Upstream::MockClusterManager> cm_;
+  std::unique_ptr<OnDemandRouteUpdate> filter_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+};
+
+class OnDemandFilterOdCdsTest : public testing::Test {
+public:
+  void SetUp() override {
+    cm_.initializeThreadLocalClusters({"fake_cluster"});
+    filter_ = std::make_unique<OnDemandRouteUpdate>(
+        std::make_shared<OnDemandFilterConfig>(cm_, odcds_, std::chrono::milliseconds(5000)));
+    filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+  }
+
+  NiceMock<Upstream::MockClusterManager> cm_;
+  std::shared_ptr<Upstream::MockOdCdsApiHandle> odcds_{
+      std::make_shared<Upstream::MockOdCdsApiHandle>()};
   std::unique_ptr<OnDemandRouteUpdate> filter_;
   NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
 };
@@ -101,6 +123,67 @@ TEST_F(OnDemandFilterTest, OnRouteConfigUpdateCompletionRestartsActiveStream) {
   filter_->onRouteConfigUpdateCompletion(true);
 }
 
+// tests decodeHeaders() when the cluster of the route is known
+TEST_F(OnDemandFilterOdCdsTest, TestDecodeHeadersWhenClusterAvailable) {
+  Http::TestRequestHeaderMapImpl headers;
+  EXPECT_CALL(*odcds_, requestOnDemandClusterDiscovery(_, _, _)).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, true));
+}
+
+// tests decodeHeaders() when the cluster of the route is unknown, and the discovery completes
+TEST_F(OnDemandFilterOdCdsTest, TestDecodeHeadersDiscoversCluster) {
+  Http::TestRequestHeaderMapImpl headers;
+  Upstream::ClusterDiscoveryCallbackWeakPtr callback;
+  EXPECT_CALL(cm_, getThreadLocalCluster(absl::string_view("fake_cluster")))
+      .WillOnce(Return(nullptr));
+  EXPECT_CALL(*odcds_, requestOnDemandClusterDiscovery(absl::string_view("fake_cluster"), _,
+                                                       std::chrono::milliseconds(5000)))
+      .WillOnce(SaveArg<1>(&callback));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter_->decodeHeaders(headers, true));
+
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndWatermark, filter_->decodeData(buffer, false));
+  EXPECT_CALL(decoder_callbacks_, continueDecoding());
+  (*callback.lock())(Upstream::ClusterDiscoveryStatus::Available);
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(buffer, false));
+}
+
+// tests that the request continues to the router when the cluster is missing
+TEST_F(OnDemandFilterOdCdsTest, TestDecodeHeadersContinuesWhenClusterMissing) {
+  Http::TestRequestHeaderMapImpl headers;
+  Upstream::ClusterDiscoveryCallbackWeakPtr callback;
+  EXPECT_CALL(cm_, getThreadLocalCluster(_)).WillOnce(Return(nullptr));
+  EXPECT_CALL(*odcds_, requestOnDemandClusterDiscovery(_, _, _)).WillOnce(SaveArg<1>(&callback));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter_->decodeHeaders(headers, true));
+
+  EXPECT_CALL(decoder_callbacks_, continueDecoding());
+  (*callback.lock())(Upstream::ClusterDiscoveryStatus::Missing);
+}
+
+// tests decodeHeaders() when the discovery completes before it returns
+TEST_F(OnDemandFilterOdCdsTest, TestDecodeHeadersWhenDiscoveryCompletesAtOnce) {
+  Http::TestRequestHeaderMapImpl headers;
+  EXPECT_CALL(cm_, getThreadLocalCluster(_)).WillOnce(Return(nullptr));
+  EXPECT_CALL(*odcds_, requestOnDemandClusterDiscovery(_, _, _))
+      .WillOnce(Invoke([](absl::string_view, Upstream::ClusterDiscoveryCallbackWeakPtr callback,
+                          std::chrono::milliseconds) {
+        (*callback.lock())(Upstream::ClusterDiscoveryStatus::Available);
+      }));
+  EXPECT_CALL(decoder_callbacks_, continueDecoding()).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, true));
+}
+
+// tests that onDestroy() releases the callback of the discovery
+TEST_F(OnDemandFilterOdCdsTest, TestOnDestroyReleasesDiscoveryCallback) {
+  Http::TestRequestHeaderMapImpl headers;
+  Upstream::ClusterDiscoveryCallbackWeakPtr callback;
+  EXPECT_CALL(cm_, getThreadLocalCluster(_)).WillOnce(Return(nullptr));
+  EXPECT_CALL(*odcds_, requestOnDemandClusterDiscovery(_, _, _)).WillOnce(SaveArg<1>(&callback));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter_->decodeHeaders(headers, true));
+  filter_->onDestroy();
+  EXPECT_TRUE(callback.expired());
+}
+
 } // namespace OnDemand
 } // namespace HttpFilters
 } // namespace Extensions
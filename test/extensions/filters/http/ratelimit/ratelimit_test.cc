@@ -16,8 +16,10 @@
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/ratelimit/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/tracing/mocks.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -54,11 +56,9 @@ public:
     TestUtility::loadFromYaml(yaml, proto_config);
 
     config_ = std::make_shared<FilterConfig>(proto_config, local_info_, stats_store_, runtime_,
-                                             http_context_);
+                                             http_context_, tls_, time_system_);
 
-    client_ = new Filters::Common::RateLimit::MockClient();
-    filter_ = std::make_unique<Filter>(config_, Filters::Common::RateLimit::ClientPtr{client_});
-    filter_->setDecoderFilterCallbacks(filter_callbacks_);
+    newFilter();
     filter_callbacks_.route_->route_entry_.rate_limit_policy_.rate_limit_policy_entry_.clear();
     filter_callbacks_.route_->route_entry_.rate_limit_policy_.rate_limit_policy_entry_.emplace_back(
         route_rate_limit_);
@@ -68,6 +68,12 @@ public:
         .emplace_back(vh_rate_limit_);
   }
 
+  void newFilter() {
+    client_ = new Filters::Common::RateLimit::MockClient();
+    filter_ = std::make_unique<Filter>(config_, Filters::Common::RateLimit::ClientPtr{client_});
+    filter_->setDecoderFilterCallbacks(filter_callbacks_);
+  }
+
   const std::string fail_close_config_ = R"EOF(
   domain: foo
   failure_mode_deny: true
@@ -87,6 +93,13 @@ public:
   domain: foo
   )EOF";
 
+  const std::string quota_lease_config_ = R"EOF(
+  domain: foo
+  quota_lease:
+    hits: 3
+    duration: 1s
+  )EOF";
+
   Filters::Common::RateLimit::MockClient* client_;
   NiceMock<Http::MockStreamDecoderFilterCallbacks> filter_callbacks_;
   Stats::StatNamePool pool_{filter_callbacks_.clusterInfo()->statsScope().symbolTable()};
@@ -104,6 +117,8 @@ public:
   Buffer::OwnedImpl data_;
   Buffer::OwnedImpl response_data_;
   NiceMock<Stats::MockIsolatedStatsStore> stats_store_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Event::SimulatedTimeSystem time_system_;
   FilterConfigSharedPtr config_;
   std::unique_ptr<Filter> filter_;
   NiceMock<Runtime::MockLoader> runtime_;
@@ -238,6 +253,98 @@ TEST_F(HttpRateLimitFilterTest, OkResponse) {
       1U, filter_callbacks_.clusterInfo()->statsScope().counterFromStatName(ratelimit_ok_).value());
 }
 
+// The hits leased from the rate limit service allow the next requests of the same descriptors
+// without calling it, until they run out or the lease expires.
+TEST_F(HttpRateLimitFilterTest, QuotaLease) {
+  SetUpTest(quota_lease_config_);
+  ON_CALL(route_rate_limit_, populateDescriptors(_, _, _, _))
+      .WillByDefault(SetArgReferee<0>(descriptor_));
+  auto lease_from_service = [this]() {
+    EXPECT_CALL(*client_, limit(_, "foo", _, _, _))
+        .WillOnce(WithArgs<0>(
+            Invoke([this](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
+              request_callbacks_ = &callbacks;
+            })));
+    EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+              filter_->decodeHeaders(request_headers_, false));
+    EXPECT_CALL(filter_callbacks_, continueDecoding());
+    request_callbacks_->complete(Filters::Common::RateLimit::LimitStatus::OK, nullptr, nullptr,
+                                 nullptr, "", nullptr);
+  };
+
+  lease_from_service();
+  for (int i = 0; i < 2; i++) {
+    newFilter();
+    EXPECT_CALL(*client_, limit(_, _, _, _, _)).Times(0);
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  }
+
+  // The lease is used up.
+  newFilter();
+  lease_from_service();
+
+  // The lease expires.
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  newFilter();
+  lease_from_service();
+
+  EXPECT_EQ(2U, stats_store_.counterFromString("ratelimit.quota_lease.local_ok").value());
+  EXPECT_EQ(3U, stats_store_.counterFromString("ratelimit.quota_lease.remote").value());
+  EXPECT_EQ(2U, stats_store_.counterFromString("ratelimit.quota_lease.hits_wasted").value());
+}
+
+// The requests of other descriptors don't use the lease.
+TEST_F(HttpRateLimitFilterTest, QuotaLeaseOfDescriptors) {
+  SetUpTest(quota_lease_config_);
+  EXPECT_CALL(route_rate_limit_, populateDescriptors(_, _, _, _))
+      .WillOnce(SetArgReferee<0>(descriptor_))
+      .WillOnce(SetArgReferee<0>(descriptor_two_));
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _))
+      .WillOnce(
+          WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
+            request_callbacks_ = &callbacks;
+          })));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+  EXPECT_CALL(filter_callbacks_, continueDecoding());
+  request_callbacks_->complete(Filters::Common::RateLimit::LimitStatus::OK, nullptr, nullptr,
+                               nullptr, "", nullptr);
+
+  newFilter();
+  EXPECT_CALL(*client_, limit(_, "foo",
+                              testing::ContainerEq(std::vector<RateLimit::Descriptor>{
+                                  {{{"key", "value"}}}}),
+                              _, _));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+  EXPECT_CALL(*client_, cancel());
+  filter_->onDestroy();
+}
+
+// The requests which are over the limit get no lease.
+TEST_F(HttpRateLimitFilterTest, QuotaLeaseOverLimit) {
+  SetUpTest(quota_lease_config_);
+  ON_CALL(route_rate_limit_, populateDescriptors(_, _, _, _))
+      .WillByDefault(SetArgReferee<0>(descriptor_));
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _))
+      .WillOnce(
+          WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
+            request_callbacks_ = &callbacks;
+          })));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+  EXPECT_CALL(filter_callbacks_, sendLocalReply(Http::Code::TooManyRequests, _, _, _, _));
+  request_callbacks_->complete(Filters::Common::RateLimit::LimitStatus::OverLimit, nullptr,
+                               nullptr, nullptr, "", nullptr);
+
+  newFilter();
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+  EXPECT_CALL(*client_, cancel());
+  filter_->onDestroy();
+}
+
 TEST_F(HttpRateLimitFilterTest, OkResponseWithHeaders) {
   SetUpTest(filter_config_);
   InSequence s;
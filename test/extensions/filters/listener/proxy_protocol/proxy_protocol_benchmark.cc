@@ -0,0 +1,166 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures how the proxy protocol filter accepts PROXY protocol v2 headers carrying the TLVs of
+// cloud load balancers, for a number of TLV types configured to be saved to the dynamic metadata.
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "envoy/config/core/v3/base.pb.h"
+#include "envoy/extensions/filters/listener/proxy_protocol/v3/proxy_protocol.pb.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/network/listen_socket_impl.h"
+#include "source/common/network/utility.h"
+#include "source/extensions/filters/listener/proxy_protocol/proxy_protocol.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+namespace ProxyProtocol {
+namespace {
+
+class FastMockListenerFilterCallbacks : public Network::MockListenerFilterCallbacks {
+public:
+  FastMockListenerFilterCallbacks(Network::ConnectionSocket& socket, Event::Dispatcher& dispatcher)
+      : socket_(socket), dispatcher_(dispatcher) {}
+  Network::ConnectionSocket& socket() override { return socket_; }
+  Event::Dispatcher& dispatcher() override { return dispatcher_; }
+  void continueFilterChain(bool success) override {
+    RELEASE_ASSERT(success, "");
+    continued_ = true;
+  }
+  void setDynamicMetadata(const std::string& name, const ProtobufWkt::Struct& value) override {
+    (*metadata_.mutable_filter_metadata())[name].MergeFrom(value);
+  }
+  envoy::config::core::v3::Metadata& dynamicMetadata() override { return metadata_; }
+  const envoy::config::core::v3::Metadata& dynamicMetadata() const override { return metadata_; }
+
+  Network::ConnectionSocket& socket_;
+  Event::Dispatcher& dispatcher_;
+  envoy::config::core::v3::Metadata metadata_;
+  bool continued_{false};
+};
+
+// Don't inherit from the mock implementation at all, because this is instantiated
+// in the hot loop.
+class FastMockFileEvent : public Event::FileEvent {
+  void activate(uint32_t) override {}
+  void setEnabled(uint32_t) override {}
+  void unregisterEventIfEmulatedEdge(uint32_t) override {}
+  void registerEventIfEmulatedEdge(uint32_t) override {}
+};
+
+class FastMockDispatcher : public Event::MockDispatcher {
+public:
+  Event::FileEventPtr createFileEvent(os_fd_t, Event::FileReadyCb cb, Event::FileTriggerType,
+                                      uint32_t) override {
+    file_event_callback_ = cb;
+    return std::make_unique<FastMockFileEvent>();
+  }
+
+  Event::FileReadyCb file_event_callback_;
+};
+
+// Receives the data of a stream, which is consumed unless peeked.
+class FastMockStreamOsSysCalls : public Api::MockOsSysCalls {
+public:
+  FastMockStreamOsSysCalls(std::string data) : data_(std::move(data)) {}
+
+  Api::SysCallSizeResult recv(os_fd_t, void* buffer, size_t length, int flags) override {
+    const size_t received = std::min(length, data_.size() - offset_);
+    memcpy(buffer, data_.data() + offset_, received);
+    if (!(flags & MSG_PEEK)) {
+      offset_ += received;
+    }
+    return Api::SysCallSizeResult{ssize_t(received), 0};
+  }
+
+  const std::string data_;
+  size_t offset_{0};
+};
+
+void addTlv(std::string& tlvs, uint8_t type, size_t length) {
+  tlvs.push_back(type);
+  tlvs.push_back(length >> 8);
+  tlvs.push_back(length & 0xff);
+  tlvs.append(length, 'x');
+}
+
+// A PROXY protocol v2 TCP4 header followed by the TLVs of a cloud load balancer and a TLS client
+// certificate.
+std::string proxyHeader() {
+  std::string tlvs;
+  // PP2_TYPE_ALPN, PP2_TYPE_AUTHORITY and PP2_TYPE_SSL.
+  addTlv(tlvs, 0x01, 2);
+  addTlv(tlvs, 0x02, 32);
+  addTlv(tlvs, 0x20, 1024);
+  // The AWS VPC endpoint ID and the GCP PSC connection ID.
+  addTlv(tlvs, 0xea, 23);
+  addTlv(tlvs, 0xe0, 9);
+  // PP2_TYPE_NOOP padding.
+  addTlv(tlvs, 0x04, 256);
+
+  const size_t length = 12 + tlvs.size();
+  std::string header("\r\n\r\n\0\r\nQUIT\n\x21\x11", 14);
+  header.push_back(length >> 8);
+  header.push_back(length & 0xff);
+  // 1.2.3.4:65535 to 253.253.253.253:1234.
+  header.append("\x01\x02\x03\x04\xfd\xfd\xfd\xfd\xff\xff\x04\xd2", 12);
+  return header + tlvs + "GET / HTTP/1.1\r\n\r\n";
+}
+
+// Accepts a connection with a PROXY protocol v2 header, with state.range(0) of its TLVs configured
+// to be saved to the dynamic metadata.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_ProxyProtocolV2(benchmark::State& state) {
+  NiceMock<FastMockStreamOsSysCalls> os_sys_calls(proxyHeader());
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls{&os_sys_calls};
+  NiceMock<Stats::MockStore> store;
+  envoy::extensions::filters::listener::proxy_protocol::v3::ProxyProtocol proto_config;
+  const std::vector<uint8_t> tlv_types{0xea, 0xe0, 0x02};
+  for (int64_t i = 0; i < state.range(0); i++) {
+    auto* rule = proto_config.add_rules();
+    rule->set_tlv_type(tlv_types[i]);
+    rule->mutable_on_tlv_present()->set_key(absl::StrCat("tlv_", static_cast<int>(tlv_types[i])));
+  }
+  auto cfg = std::make_shared<Config>(store, proto_config);
+  Network::IoHandlePtr io_handle = std::make_unique<Network::IoSocketHandleImpl>();
+  Network::ConnectionSocketImpl socket(std::move(io_handle),
+                                       Network::Utility::parseInternetAddress("127.0.0.1", 80),
+                                       Network::Utility::parseInternetAddress("127.0.0.2", 4321));
+  NiceMock<FastMockDispatcher> dispatcher;
+  FastMockListenerFilterCallbacks cb(socket, dispatcher);
+
+  for (auto _ : state) { // NOLINT
+    os_sys_calls.offset_ = 0;
+    cb.continued_ = false;
+    cb.metadata_.Clear();
+    Filter filter(cfg);
+    filter.onAccept(cb);
+    dispatcher.file_event_callback_(Event::FileReadyType::Read);
+    RELEASE_ASSERT(cb.continued_, "");
+    RELEASE_ASSERT(socket.addressProvider().remoteAddress()->asString() == "1.2.3.4:65535", "");
+  }
+}
+BENCHMARK(BM_ProxyProtocolV2)->DenseRange(0, 3)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace ProxyProtocol
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -1,9 +1,15 @@
 #include <vector>
 
+#include "envoy/extensions/filters/listener/proxy_protocol/v3/proxy_protocol.pb.h"
+
 #include "source/common/api/os_sys_calls_impl.h"
 #include "source/common/http/utility.h"
 #include "source/common/network/io_socket_handle_impl.h"
 #include "source/common/network/listen_socket_impl.h"
+#include "source/common/network/listener_filter_peek_buffer.h"
+#include "source/common/network/utility.h"
+#include "source/extensions/filters/listener/http_inspector/http_inspector.h"
+#include "source/extensions/filters/listener/proxy_protocol/proxy_protocol.h"
 #include "source/extensions/filters/listener/tls_inspector/tls_inspector.h"
 
 #include "test/extensions/filters/listener/tls_inspector/tls_utility.h"
@@ -26,13 +32,39 @@ namespace TlsInspector {
 class FastMockListenerFilterCallbacks : public Network::MockListenerFilterCallbacks {
 public:
   FastMockListenerFilterCallbacks(Network::ConnectionSocket& socket, Event::Dispatcher& dispatcher)
-      : socket_(socket), dispatcher_(dispatcher) {}
+      : socket_(socket), dispatcher_(dispatcher) {
+    newSocket();
+  }
   Network::ConnectionSocket& socket() override { return socket_; }
   Event::Dispatcher& dispatcher() override { return dispatcher_; }
-  void continueFilterChain(bool success) override { RELEASE_ASSERT(success, ""); }
+  void continueFilterChain(bool success) override {
+    RELEASE_ASSERT(success, "");
+    runFilters();
+  }
+  Api::IoCallUint64Result peek(void* buffer, uint64_t length) override {
+    return peek_buffer_->peek(buffer, length);
+  }
+
+  // Starts over with the data peeked and the filters, as for a newly accepted socket.
+  void newSocket() {
+    peek_buffer_.emplace(socket_, dispatcher_);
+    next_filter_ = 0;
+  }
+
+  // Runs the filters which are left, until one of them stops the iteration.
+  void runFilters() {
+    while (next_filter_ < filters_.size()) {
+      if (filters_[next_filter_++]->onAccept(*this) == Network::FilterStatus::StopIteration) {
+        return;
+      }
+    }
+  }
 
   Network::ConnectionSocket& socket_;
   Event::Dispatcher& dispatcher_;
+  absl::optional<Network::ListenerFilterPeekBuffer> peek_buffer_;
+  std::vector<Network::ListenerFilter*> filters_;
+  size_t next_filter_{0};
 };
 
 // Don't inherit from the mock implementation at all, because this is instantiated
@@ -44,6 +76,16 @@ class FastMockFileEvent : public Event::FileEvent {
   void registerEventIfEmulatedEdge(uint32_t) override {}
 };
 
+// The event loop iterations aren't run, each socket starts over with the data peeked instead.
+class FastMockSchedulableCallback : public Event::SchedulableCallback {
+  void scheduleCallbackCurrentIteration() override { enabled_ = true; }
+  void scheduleCallbackNextIteration() override { enabled_ = true; }
+  void cancel() override { enabled_ = false; }
+  bool enabled() override { return enabled_; }
+
+  bool enabled_{false};
+};
+
 class FastMockDispatcher : public Event::MockDispatcher {
 public:
   Event::FileEventPtr createFileEvent(os_fd_t, Event::FileReadyCb cb, Event::FileTriggerType,
@@ -51,6 +93,9 @@ public:
     file_event_callback_ = cb;
     return std::make_unique<FastMockFileEvent>();
   }
+  Event::SchedulableCallbackPtr createSchedulableCallback(std::function<void()>) override {
+    return std::make_unique<FastMockSchedulableCallback>();
+  }
 
   Event::FileReadyCb file_event_callback_;
 };
@@ -68,6 +113,26 @@ public:
   const std::vector<uint8_t> client_hello_;
 };
 
+// Receives the data of a stream, which is consumed unless peeked.
+class FastMockStreamOsSysCalls : public Api::MockOsSysCalls {
+public:
+  FastMockStreamOsSysCalls(absl::string_view data) : data_(data) {}
+
+  Api::SysCallSizeResult recv(os_fd_t, void* buffer, size_t length, int flags) override {
+    recvs_++;
+    const size_t received = std::min(length, data_.size() - offset_);
+    memcpy(buffer, data_.data() + offset_, received);
+    if (!(flags & MSG_PEEK)) {
+      offset_ += received;
+    }
+    return Api::SysCallSizeResult{ssize_t(received), 0};
+  }
+
+  const std::string data_;
+  size_t offset_{0};
+  uint64_t recvs_{0};
+};
+
 static void BM_TlsInspector(benchmark::State& state) {
   NiceMock<FastMockOsSysCalls> os_sys_calls(Tls::Test::generateClientHello(
       Config::TLS_MIN_SUPPORTED_VERSION, Config::TLS_MAX_SUPPORTED_VERSION, "example.com",
@@ -81,6 +146,7 @@ static void BM_TlsInspector(benchmark::State& state) {
   FastMockListenerFilterCallbacks cb(socket, dispatcher);
 
   for (auto _ : state) {
+    cb.newSocket();
     Filter filter(cfg);
     filter.onAccept(cb);
     RELEASE_ASSERT(dispatcher.file_event_callback_ == nullptr, "");
@@ -98,6 +164,50 @@ static void BM_TlsInspector(benchmark::State& state) {
 
 BENCHMARK(BM_TlsInspector)->Unit(benchmark::kMicrosecond);
 
+// Accepts plaintext HTTP/1.1 connections with a PROXY protocol header through the proxy protocol,
+// TLS inspector and HTTP inspector filters, and reports the recv() calls per connection.
+static void BM_ListenerFilters(benchmark::State& state) {
+  NiceMock<FastMockStreamOsSysCalls> os_sys_calls(
+      "PROXY TCP4 1.2.3.4 253.253.253.253 65535 1234\r\n"
+      "GET /anything HTTP/1.1\r\nhost: example.com\r\n\r\n");
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls{&os_sys_calls};
+  NiceMock<Stats::MockStore> store;
+  auto proxy_protocol_cfg = std::make_shared<ProxyProtocol::Config>(
+      store, envoy::extensions::filters::listener::proxy_protocol::v3::ProxyProtocol());
+  ConfigSharedPtr tls_inspector_cfg(std::make_shared<Config>(store));
+  auto http_inspector_cfg = std::make_shared<HttpInspector::Config>(store);
+  Network::IoHandlePtr io_handle = std::make_unique<Network::IoSocketHandleImpl>();
+  Network::ConnectionSocketImpl socket(std::move(io_handle),
+                                       Network::Utility::parseInternetAddress("127.0.0.1", 80),
+                                       Network::Utility::parseInternetAddress("127.0.0.2", 4321));
+  NiceMock<FastMockDispatcher> dispatcher;
+  FastMockListenerFilterCallbacks cb(socket, dispatcher);
+
+  for (auto _ : state) {
+    os_sys_calls.offset_ = 0;
+    cb.newSocket();
+    ProxyProtocol::Filter proxy_protocol(proxy_protocol_cfg);
+    Filter tls_inspector(tls_inspector_cfg);
+    HttpInspector::Filter http_inspector(http_inspector_cfg);
+    cb.filters_ = {&proxy_protocol, &tls_inspector, &http_inspector};
+    cb.runFilters();
+    // The proxy protocol filter waits for the socket to be readable.
+    dispatcher.file_event_callback_(Event::FileReadyType::Read);
+    RELEASE_ASSERT(cb.next_filter_ == cb.filters_.size(), "");
+    RELEASE_ASSERT(socket.addressProvider().remoteAddress()->asString() == "1.2.3.4:65535", "");
+    RELEASE_ASSERT(socket.detectedTransportProtocol().empty(), "");
+    RELEASE_ASSERT(socket.requestedApplicationProtocols().size() == 1 &&
+                       socket.requestedApplicationProtocols().front() ==
+                           Http::Utility::AlpnNames::get().Http11,
+                   "");
+    socket.setRequestedApplicationProtocols({});
+  }
+  state.counters["recvs_per_connection"] =
+      benchmark::Counter(os_sys_calls.recvs_, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_ListenerFilters)->Unit(benchmark::kMicrosecond);
+
 } // namespace TlsInspector
 } // namespace ListenerFilters
 } // namespace Extensions
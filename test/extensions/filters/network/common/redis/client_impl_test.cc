@@ -10,6 +10,7 @@
 
 #include "test/extensions/filters/network/common/redis/mocks.h"
 #include "test/extensions/filters/network/common/redis/test_utils.h"
+#include "test/mocks/buffer/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/upstream/host.h"
 #include "test/test_common/simulated_time_system.h"
@@ -68,6 +69,9 @@ public:
     // Create timers in order they are created in client_impl.cc
     connect_or_op_timer_ = new Event::MockTimer(&dispatcher_);
     flush_timer_ = new Event::MockTimer(&dispatcher_);
+    if (config_->flushOnEventLoopIteration()) {
+      flush_cb_ = new Event::MockSchedulableCallback(&dispatcher_);
+    }
 
     EXPECT_CALL(*connect_or_op_timer_, enableTimer(_, _));
     EXPECT_CALL(*host_, createConnection_(_, _)).WillOnce(Return(conn_info));
@@ -131,6 +135,7 @@ public:
   std::shared_ptr<Upstream::MockHost> host_{new NiceMock<Upstream::MockHost>()};
   Event::MockDispatcher dispatcher_;
   Event::MockTimer* flush_timer_{};
+  Event::MockSchedulableCallback* flush_cb_{};
   Event::MockTimer* connect_or_op_timer_{};
   MockEncoder* encoder_{new MockEncoder()};
   MockDecoder* decoder_{new MockDecoder()};
@@ -187,6 +192,7 @@ class ConfigBufferSizeGTSingleRequest : public Config {
   std::chrono::milliseconds bufferFlushTimeoutInMs() const override {
     return std::chrono::milliseconds(1);
   }
+  bool flushOnEventLoopIteration() const override { return false; }
   uint32_t maxUpstreamUnknownConnections() const override { return 0; }
   bool enableCommandStats() const override { return false; }
   ReadPolicy readPolicy() const override { return ReadPolicy::Primary; }
@@ -285,6 +291,82 @@ TEST_F(RedisClientImplTest, BatchWithTimerCancelledByBufferFlush) {
   client_->close();
 }
 
+TEST_F(RedisClientImplTest, BatchWithEventLoopIterationFlush) {
+  // The requests made within an event loop iteration are written together once it processed
+  // its events, whatever their size when no buffer size is set.
+  InSequence s;
+
+  auto settings = createConnPoolSettings();
+  settings.set_flush_on_event_loop_iteration(true);
+  setup(std::make_unique<ConfigImpl>(settings));
+
+  // The first request schedules the flush.
+  Common::Redis::RespValue request1;
+  MockClientCallbacks callbacks1;
+  EXPECT_CALL(*encoder_, encode(Ref(request1), _))
+      .WillOnce(Invoke([](const Common::Redis::RespValue&, Buffer::Instance& out) -> void {
+        out.add("request1");
+      }));
+  EXPECT_CALL(*flush_cb_, scheduleCallbackCurrentIteration());
+  EXPECT_NE(nullptr, client_->makeRequest(request1, callbacks1));
+
+  Common::Redis::RespValue request2;
+  MockClientCallbacks callbacks2;
+  EXPECT_CALL(*encoder_, encode(Ref(request2), _))
+      .WillOnce(Invoke([](const Common::Redis::RespValue&, Buffer::Instance& out) -> void {
+        out.add("request2");
+      }));
+  EXPECT_NE(nullptr, client_->makeRequest(request2, callbacks2));
+
+  EXPECT_CALL(*flush_timer_, enabled()).WillOnce(Return(false));
+  EXPECT_CALL(*flush_cb_, cancel());
+  EXPECT_CALL(*upstream_connection_, write(BufferStringEqual("request1request2"), false));
+  flush_cb_->invokeCallback();
+
+  EXPECT_CALL(*upstream_connection_, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(callbacks1, onFailure());
+  EXPECT_CALL(callbacks2, onFailure());
+  EXPECT_CALL(*connect_or_op_timer_, disableTimer());
+  client_->close();
+}
+
+TEST_F(RedisClientImplTest, BatchWithEventLoopIterationFlushCancelledByBufferFlush) {
+  // With a buffer size, a full buffer is written right away and cancels the scheduled flush.
+  InSequence s;
+
+  auto settings = createConnPoolSettings();
+  settings.set_flush_on_event_loop_iteration(true);
+  settings.set_max_buffer_size_before_flush(16);
+  setup(std::make_unique<ConfigImpl>(settings));
+
+  Common::Redis::RespValue request1;
+  MockClientCallbacks callbacks1;
+  EXPECT_CALL(*encoder_, encode(Ref(request1), _))
+      .WillOnce(Invoke([](const Common::Redis::RespValue&, Buffer::Instance& out) -> void {
+        out.add("request1");
+      }));
+  EXPECT_CALL(*flush_cb_, scheduleCallbackCurrentIteration());
+  EXPECT_NE(nullptr, client_->makeRequest(request1, callbacks1));
+
+  Common::Redis::RespValue request2;
+  MockClientCallbacks callbacks2;
+  EXPECT_CALL(*encoder_, encode(Ref(request2), _))
+      .WillOnce(Invoke([](const Common::Redis::RespValue&, Buffer::Instance& out) -> void {
+        out.add("request2");
+      }));
+  EXPECT_CALL(*flush_timer_, enabled()).WillOnce(Return(false));
+  EXPECT_CALL(*flush_cb_, cancel());
+  EXPECT_CALL(*upstream_connection_, write(BufferStringEqual("request1request2"), false));
+  EXPECT_NE(nullptr, client_->makeRequest(request2, callbacks2));
+  EXPECT_FALSE(flush_cb_->enabled_);
+
+  EXPECT_CALL(*upstream_connection_, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(callbacks1, onFailure());
+  EXPECT_CALL(callbacks2, onFailure());
+  EXPECT_CALL(*connect_or_op_timer_, disableTimer());
+  client_->close();
+}
+
 TEST_F(RedisClientImplTest, Basic) {
   InSequence s;
 
@@ -346,6 +428,7 @@ class ConfigEnableCommandStats : public Config {
   std::chrono::milliseconds bufferFlushTimeoutInMs() const override {
     return std::chrono::milliseconds(0);
   }
+  bool flushOnEventLoopIteration() const override { return false; }
   ReadPolicy readPolicy() const override { return ReadPolicy::Primary; }
   uint32_t maxUpstreamUnknownConnections() const override { return 0; }
   bool enableCommandStats() const override { return true; }
@@ -731,6 +814,7 @@ class ConfigOutlierDisabled : public Config {
   std::chrono::milliseconds bufferFlushTimeoutInMs() const override {
     return std::chrono::milliseconds(0);
   }
+  bool flushOnEventLoopIteration() const override { return false; }
   ReadPolicy readPolicy() const override { return ReadPolicy::Primary; }
   uint32_t maxUpstreamUnknownConnections() const override { return 0; }
   bool enableCommandStats() const override { return false; }
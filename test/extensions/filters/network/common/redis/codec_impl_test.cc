@@ -427,6 +427,68 @@ TEST_F(RedisEncoderDecoderImplTest, InvalidBulkStringExpectLF) {
   EXPECT_THROW(decoder_.decode(buffer_), ProtocolError);
 }
 
+// The bulk strings from the threshold are buffered, except the command of a request.
+TEST_F(RedisEncoderDecoderImplTest, BufferedBulkString) {
+  DecoderImpl decoder(*this, 4);
+  buffer_.add("*3\r\n$5\r\nlarge\r\n$3\r\nkey\r\n$11\r\nbulk ");
+  decoder.decode(buffer_);
+  EXPECT_EQ(0UL, buffer_.length());
+  buffer_.add("string\r\n");
+  decoder.decode(buffer_);
+  EXPECT_EQ(0UL, buffer_.length());
+  ASSERT_EQ(1UL, decoded_values_.size());
+
+  const std::vector<RespValue>& array = decoded_values_[0]->asArray();
+  EXPECT_EQ(nullptr, array[0].bufferedString());
+  EXPECT_EQ(nullptr, array[1].bufferedString());
+  ASSERT_NE(nullptr, array[2].bufferedString());
+  EXPECT_EQ("bulk string", array[2].bufferedString()->toString());
+
+  encoder_.encode(*decoded_values_[0], buffer_);
+  EXPECT_EQ("*3\r\n$5\r\nlarge\r\n$3\r\nkey\r\n$11\r\nbulk string\r\n", buffer_.toString());
+}
+
+TEST_F(RedisEncoderDecoderImplTest, BufferedBulkStringBytewise) {
+  DecoderImpl decoder(*this, 4);
+  const std::string data = "$11\r\nbulk string\r\n$4\r\nnext\r\n";
+  for (char c : data) {
+    buffer_.add(&c, 1);
+    decoder.decode(buffer_);
+    EXPECT_EQ(0UL, buffer_.length());
+  }
+  ASSERT_EQ(2UL, decoded_values_.size());
+  ASSERT_NE(nullptr, decoded_values_[0]->bufferedString());
+  EXPECT_EQ(11UL, decoded_values_[0]->bufferedString()->length());
+  ASSERT_NE(nullptr, decoded_values_[1]->bufferedString());
+
+  encoder_.encode(*decoded_values_[0], buffer_);
+  encoder_.encode(*decoded_values_[1], buffer_);
+  EXPECT_EQ(data, buffer_.toString());
+}
+
+// The copies of a buffered string share its buffer until their content is accessed.
+TEST_F(RedisEncoderDecoderImplTest, BufferedBulkStringCopy) {
+  DecoderImpl decoder(*this, 4);
+  buffer_.add("$11\r\nbulk string\r\n");
+  decoder.decode(buffer_);
+  ASSERT_EQ(1UL, decoded_values_.size());
+  const RespValue& value = *decoded_values_[0];
+  ASSERT_NE(nullptr, value.bufferedString());
+
+  RespValue copy(value);
+  EXPECT_EQ(value.bufferedString(), copy.bufferedString());
+  RespValue assigned;
+  assigned = value;
+  EXPECT_EQ(value.bufferedString(), assigned.bufferedString());
+
+  copy.asString() += "!";
+  EXPECT_EQ(nullptr, copy.bufferedString());
+  EXPECT_EQ("bulk string!", copy.asString());
+  EXPECT_EQ("bulk string", value.bufferedString()->toString());
+  EXPECT_EQ("bulk string", assigned.asString());
+  EXPECT_EQ(nullptr, assigned.bufferedString());
+}
+
 } // namespace Redis
 } // namespace Common
 } // namespace NetworkFilters
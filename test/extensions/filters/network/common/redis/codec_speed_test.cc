@@ -0,0 +1,95 @@
+// Measures the decoding and the re-encoding of SET requests with values of 1KB to 1MB received in
+// chunks of 16KiB, as the proxy forwards them, with the bulk strings copied into their string or
+// kept in the slices of the decoded data.
+// Note: this should be run with --compilation_mode=opt.
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/network/common/redis/codec_impl.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Common {
+namespace Redis {
+namespace {
+
+constexpr uint64_t ChunkSize = 16 * 1024;
+
+class CollectingCallbacks : public DecoderCallbacks {
+public:
+  // Common::Redis::DecoderCallbacks
+  void onRespValue(RespValuePtr&& value) override { values_.push_back(std::move(value)); }
+
+  std::vector<RespValuePtr> values_;
+};
+
+// @return a SET request with a value of the given size, in chunks.
+std::vector<std::string> makeRequest(uint64_t value_size) {
+  RespValue request;
+  request.type(RespType::Array);
+  std::vector<RespValue> values(3);
+  for (RespValue& value : values) {
+    value.type(RespType::BulkString);
+  }
+  values[0].asString() = "set";
+  values[1].asString() = "key";
+  values[2].asString() = std::string(value_size, 'a');
+  request.asArray().swap(values);
+
+  Buffer::OwnedImpl data;
+  EncoderImpl().encode(request, data);
+  std::vector<std::string> chunks;
+  while (data.length() > 0) {
+    const uint64_t length = std::min(ChunkSize, data.length());
+    std::string chunk(length, '\0');
+    data.copyOut(0, length, chunk.data());
+    chunks.push_back(std::move(chunk));
+    data.drain(length);
+  }
+  return chunks;
+}
+
+void decodeAndEncode(benchmark::State& state, uint64_t buffered_bulk_string_size) {
+  const std::vector<std::string> chunks = makeRequest(state.range(0));
+  EncoderImpl encoder;
+  uint64_t bytes = 0;
+  for (auto _ : state) { // NOLINT
+    CollectingCallbacks callbacks;
+    DecoderImpl decoder(callbacks, buffered_bulk_string_size);
+    for (const std::string& chunk : chunks) {
+      Buffer::OwnedImpl data(chunk);
+      decoder.decode(data);
+    }
+    Buffer::OwnedImpl out;
+    for (const RespValuePtr& value : callbacks.values_) {
+      encoder.encode(*value, out);
+    }
+    bytes += out.length();
+    benchmark::DoNotOptimize(out.length());
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_CopiedBulkString(benchmark::State& state) { decodeAndEncode(state, 0); }
+BENCHMARK(BM_CopiedBulkString)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_BufferedBulkString(benchmark::State& state) {
+  decodeAndEncode(state, DecoderImpl::DefaultBufferedBulkStringSize);
+}
+BENCHMARK(BM_BufferedBulkString)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+
+} // namespace
+} // namespace Redis
+} // namespace Common
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
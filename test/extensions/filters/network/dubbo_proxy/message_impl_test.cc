@@ -78,6 +78,26 @@ TEST(RpcInvocationImplAttachmentTest, RpcInvocationImplAttachmentTest) {
   EXPECT_EQ(23333, attachment.attachmentOffset());
 }
 
+TEST(RpcInvocationImplAttachmentTest, HeadersBuiltOnFirstUse) {
+  auto map = std::make_unique<RpcInvocationImpl::Attachment::Map>();
+  map->toMutableUntypedMap()->emplace(std::make_unique<Hessian2::StringObject>("fake_key"),
+                                      std::make_unique<Hessian2::StringObject>("fake_value"));
+
+  RpcInvocationImpl::Attachment attachment(std::move(map), 0);
+
+  // The header of an existing key takes the inserted value, as if the headers had been built first.
+  attachment.insert("fake_key", "new_value");
+  attachment.insert("test", "test_value");
+  EXPECT_EQ(2, attachment.headers().size());
+  EXPECT_EQ("new_value", attachment.headers()
+                             .get(Http::LowerCaseString("fake_key"))[0]
+                             ->value()
+                             .getStringView());
+
+  attachment.remove("test");
+  EXPECT_EQ(1, attachment.headers().size());
+}
+
 TEST(RpcInvocationImplTest, RpcInvocationImplTest) {
   RpcInvocationImpl invo;
 
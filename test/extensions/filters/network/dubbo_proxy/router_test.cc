@@ -101,7 +101,7 @@ public:
     route_ = new NiceMock<MockRoute>();
     route_ptr_.reset(route_);
 
-    router_ = std::make_unique<Router>(context_.clusterManager());
+    router_ = std::make_unique<Router>(context_.clusterManager(), nullptr);
 
     EXPECT_EQ(nullptr, router_->downstreamConnection());
 
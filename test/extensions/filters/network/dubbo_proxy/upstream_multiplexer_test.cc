@@ -0,0 +1,236 @@
+#include <memory>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/network/dubbo_proxy/router/upstream_multiplexer.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/tcp/mocks.h"
+#include "test/test_common/printers.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Ref;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace DubboProxy {
+namespace Router {
+namespace {
+
+class TestPoolCallbacks : public Tcp::ConnectionPool::Callbacks {
+public:
+  // Tcp::ConnectionPool::Callbacks
+  void onPoolFailure(ConnectionPool::PoolFailureReason reason, absl::string_view,
+                     Upstream::HostDescriptionConstSharedPtr) override {
+    failure_ = reason;
+  }
+  void onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn_data,
+                   Upstream::HostDescriptionConstSharedPtr) override {
+    conn_data_ = std::move(conn_data);
+    conn_data_->addUpstreamCallbacks(upstream_callbacks_);
+  }
+
+  MultiplexedStream& stream() { return *static_cast<MultiplexedStream*>(conn_data_.get()); }
+
+  absl::optional<ConnectionPool::PoolFailureReason> failure_;
+  Tcp::ConnectionPool::ConnectionDataPtr conn_data_;
+  NiceMock<Tcp::ConnectionPool::MockUpstreamCallbacks> upstream_callbacks_;
+};
+
+class DubboUpstreamMultiplexerTest : public testing::Test {
+public:
+  DubboUpstreamMultiplexerTest() : pool_data_([]() {}, &pool_) {
+    EXPECT_CALL(*pool_.connection_data_, addUpstreamCallbacks(_))
+        .WillRepeatedly(Invoke([&](Tcp::ConnectionPool::UpstreamCallbacks& callbacks) -> void {
+          upstream_callbacks_ = &callbacks;
+        }));
+  }
+
+  Tcp::ConnectionPool::Cancellable* newStream(TestPoolCallbacks& callbacks) {
+    return multiplexer_.newConnection(pool_data_, callbacks);
+  }
+
+  static std::string message(uint8_t flag, int64_t request_id, const std::string& body) {
+    Buffer::OwnedImpl buffer;
+    buffer.writeBEInt<uint16_t>(0xdabb);
+    buffer.writeByte(flag);
+    buffer.writeByte(0x14);
+    buffer.writeBEInt<int64_t>(request_id);
+    buffer.writeBEInt<uint32_t>(body.size());
+    buffer.add(body);
+    return buffer.toString();
+  }
+
+  // Two way request and its response.
+  static std::string request(int64_t request_id) { return message(0xc2, request_id, "request"); }
+  static std::string response(int64_t request_id) { return message(0x02, request_id, "response"); }
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Tcp::ConnectionPool::MockInstance> pool_;
+  Upstream::TcpPoolData pool_data_;
+  NiceMock<Network::MockClientConnection> connection_;
+  ConnectionMultiplexer multiplexer_{dispatcher_};
+  Tcp::ConnectionPool::UpstreamCallbacks* upstream_callbacks_{};
+};
+
+TEST_F(DubboUpstreamMultiplexerTest, RequestsShareConnection) {
+  TestPoolCallbacks first;
+  TestPoolCallbacks second;
+
+  EXPECT_CALL(pool_, newConnection(_));
+  EXPECT_NE(nullptr, newStream(first));
+  EXPECT_NE(nullptr, newStream(second));
+  pool_.poolReady(connection_);
+
+  ASSERT_NE(nullptr, first.conn_data_);
+  ASSERT_NE(nullptr, second.conn_data_);
+  EXPECT_EQ(&connection_, &first.conn_data_->connection());
+  EXPECT_EQ(&connection_, &second.conn_data_->connection());
+
+  // Requests are written with the request id of their stream.
+  EXPECT_CALL(connection_, write(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> void {
+        EXPECT_EQ(request(0), data.toString());
+        data.drain(data.length());
+      }))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> void {
+        EXPECT_EQ(request(1), data.toString());
+        data.drain(data.length());
+      }));
+  Buffer::OwnedImpl first_request(request(7));
+  first.stream().writeRequest(first_request);
+  Buffer::OwnedImpl second_request(request(7));
+  second.stream().writeRequest(second_request);
+
+  // A request started once connected gets the connection at once.
+  TestPoolCallbacks third;
+  EXPECT_EQ(nullptr, newStream(third));
+  ASSERT_NE(nullptr, third.conn_data_);
+  third.conn_data_.reset();
+
+  // Responses go to their requests whatever their order, with the original request id.
+  EXPECT_CALL(second.upstream_callbacks_, onUpstreamData(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> void {
+        EXPECT_EQ(response(7), data.toString());
+      }));
+  EXPECT_CALL(first.upstream_callbacks_, onUpstreamData(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> void {
+        EXPECT_EQ(response(7), data.toString());
+      }));
+  const std::string first_response = response(0);
+  Buffer::OwnedImpl data(response(1) + first_response.substr(0, 10));
+  upstream_callbacks_->onUpstreamData(data, false);
+  Buffer::OwnedImpl rest(first_response.substr(10));
+  upstream_callbacks_->onUpstreamData(rest, false);
+
+  // The connection goes back to the pool with its last request.
+  first.conn_data_.reset();
+  EXPECT_CALL(pool_, released(Ref(connection_)));
+  second.conn_data_.reset();
+}
+
+TEST_F(DubboUpstreamMultiplexerTest, DropsResponsesOfReleasedRequests) {
+  TestPoolCallbacks callbacks;
+  newStream(callbacks);
+  pool_.poolReady(connection_);
+
+  Buffer::OwnedImpl request_data(request(3));
+  callbacks.stream().writeRequest(request_data);
+  EXPECT_CALL(pool_, released(_)).Times(0);
+  callbacks.conn_data_.reset();
+
+  // The connection is released once the response of the request is read.
+  EXPECT_CALL(callbacks.upstream_callbacks_, onUpstreamData(_, _)).Times(0);
+  EXPECT_CALL(pool_, released(Ref(connection_)));
+  Buffer::OwnedImpl data(response(0));
+  upstream_callbacks_->onUpstreamData(data, false);
+}
+
+TEST_F(DubboUpstreamMultiplexerTest, OnewayRequestReleasedAtOnce) {
+  TestPoolCallbacks callbacks;
+  newStream(callbacks);
+  pool_.poolReady(connection_);
+
+  Buffer::OwnedImpl request_data(message(0x82, 3, "request"));
+  callbacks.stream().writeRequest(request_data);
+  EXPECT_CALL(pool_, released(Ref(connection_)));
+  callbacks.conn_data_.reset();
+}
+
+TEST_F(DubboUpstreamMultiplexerTest, DropsUnknownResponsesAndRequests) {
+  TestPoolCallbacks callbacks;
+  newStream(callbacks);
+  pool_.poolReady(connection_);
+
+  // Neither a response with an unknown request id nor a heartbeat from the upstream is delivered.
+  EXPECT_CALL(callbacks.upstream_callbacks_, onUpstreamData(_, _)).Times(0);
+  Buffer::OwnedImpl data(response(5) + message(0xe2, 0, ""));
+  upstream_callbacks_->onUpstreamData(data, false);
+}
+
+TEST_F(DubboUpstreamMultiplexerTest, PoolFailure) {
+  TestPoolCallbacks first;
+  TestPoolCallbacks second;
+  newStream(first);
+  newStream(second);
+
+  pool_.poolFailure(ConnectionPool::PoolFailureReason::RemoteConnectionFailure);
+  EXPECT_EQ(ConnectionPool::PoolFailureReason::RemoteConnectionFailure, first.failure_);
+  EXPECT_EQ(ConnectionPool::PoolFailureReason::RemoteConnectionFailure, second.failure_);
+
+  // The next request gets a new connection.
+  TestPoolCallbacks third;
+  EXPECT_CALL(pool_, newConnection(_));
+  EXPECT_NE(nullptr, newStream(third));
+}
+
+TEST_F(DubboUpstreamMultiplexerTest, CancelPendingRequest) {
+  TestPoolCallbacks first;
+  TestPoolCallbacks second;
+  newStream(first)->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+  newStream(second);
+
+  pool_.poolReady(connection_);
+  EXPECT_EQ(nullptr, first.conn_data_);
+  ASSERT_NE(nullptr, second.conn_data_);
+}
+
+TEST_F(DubboUpstreamMultiplexerTest, ConnectionClose) {
+  TestPoolCallbacks first;
+  TestPoolCallbacks second;
+  newStream(first);
+  newStream(second);
+  pool_.poolReady(connection_);
+
+  EXPECT_CALL(first.upstream_callbacks_, onEvent(Network::ConnectionEvent::RemoteClose));
+  EXPECT_CALL(second.upstream_callbacks_, onEvent(Network::ConnectionEvent::RemoteClose));
+  EXPECT_CALL(pool_, released(Ref(connection_)));
+  upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
+
+  // Streams can be released after the connection.
+  first.conn_data_.reset();
+  second.conn_data_.reset();
+}
+
+TEST_F(DubboUpstreamMultiplexerTest, InvalidResponseClosesConnection) {
+  TestPoolCallbacks callbacks;
+  newStream(callbacks);
+  pool_.poolReady(connection_);
+
+  EXPECT_CALL(connection_, close(Network::ConnectionCloseType::NoFlush));
+  Buffer::OwnedImpl data(std::string(16, 'x'));
+  upstream_callbacks_->onUpstreamData(data, false);
+}
+
+} // namespace
+} // namespace Router
+} // namespace DubboProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -11,6 +11,7 @@
 
 using testing::_;
 using testing::Eq;
+using testing::Invoke;
 using testing::Return;
 
 namespace Envoy {
@@ -54,6 +55,44 @@ TEST_F(FilterChainTest, CreateFilterChain) {
   config.createFilterChain(callbacks);
 }
 
+TEST_F(FilterChainTest, CreateFilterChainWithFilterCosts) {
+  auto hcm_config = parseHttpConnectionManagerFromYaml(basic_config_);
+  hcm_config.mutable_filter_cost_sampling()->set_value(100);
+  HttpConnectionManagerConfig config(hcm_config, context_, date_provider_,
+                                     route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_, http_tracer_manager_,
+                                     filter_config_provider_manager_);
+
+  Http::MockFilterChainFactoryCallbacks callbacks;
+  std::vector<std::string> histograms;
+  EXPECT_CALL(callbacks, recordFilterCost(_))
+      .Times(2)
+      .WillRepeatedly(Invoke([&histograms](Stats::Histogram& cpu_time_us) {
+        histograms.push_back(cpu_time_us.name());
+      }));
+  EXPECT_CALL(callbacks, addStreamFilter(_));        // Buffer
+  EXPECT_CALL(callbacks, addStreamDecoderFilter(_)); // Router
+  config.createFilterChain(callbacks);
+  EXPECT_THAT(histograms,
+              testing::ElementsAre("http.router.filter_cost.encoder-decoder-buffer-filter.cpu_us",
+                                   "http.router.filter_cost.envoy.filters.http.router.cpu_us"));
+}
+
+TEST_F(FilterChainTest, CreateFilterChainWithoutSampledFilterCosts) {
+  auto hcm_config = parseHttpConnectionManagerFromYaml(basic_config_);
+  hcm_config.mutable_filter_cost_sampling()->set_value(0);
+  HttpConnectionManagerConfig config(hcm_config, context_, date_provider_,
+                                     route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_, http_tracer_manager_,
+                                     filter_config_provider_manager_);
+
+  Http::MockFilterChainFactoryCallbacks callbacks;
+  EXPECT_CALL(callbacks, recordFilterCost(_)).Times(0);
+  EXPECT_CALL(callbacks, addStreamFilter(_));        // Buffer
+  EXPECT_CALL(callbacks, addStreamDecoderFilter(_)); // Router
+  config.createFilterChain(callbacks);
+}
+
 TEST_F(FilterChainTest, CreateDynamicFilterChain) {
   const std::string yaml_string = R"EOF(
 codec_type: http1
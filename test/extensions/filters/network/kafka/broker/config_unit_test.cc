@@ -35,6 +35,32 @@ stat_prefix: test_prefix
   // then - connection had `addFilter` invoked
 }
 
+TEST(KafkaConfigFactoryUnitTest, shouldCreateFilterWithProduceAggregation) {
+  // given
+  const std::string yaml = R"EOF(
+stat_prefix: test_prefix
+produce_aggregation:
+  cluster: kafka
+  linger: 0.01s
+  batch_size: 65536
+  )EOF";
+
+  KafkaBrokerProtoConfig proto_config;
+  TestUtility::loadFromYamlAndValidate(yaml, proto_config);
+
+  testing::NiceMock<Server::Configuration::MockFactoryContext> context;
+  KafkaConfigFactory factory;
+
+  Network::FilterFactoryCb cb = factory.createFilterFactoryFromProto(proto_config, context);
+  Network::MockConnection connection;
+  EXPECT_CALL(connection, addFilter(_));
+
+  // when
+  cb(connection);
+
+  // then - connection had `addFilter` invoked
+}
+
 TEST(KafkaConfigFactoryUnitTest, shouldThrowOnInvalidStatPrefix) {
   // given
   const std::string yaml = R"EOF(
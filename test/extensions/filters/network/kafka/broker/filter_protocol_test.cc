@@ -34,7 +34,7 @@ class KafkaBrokerFilterProtocolTest : public testing::Test,
 protected:
   Stats::TestUtil::TestStore scope_;
   Event::TestRealTimeSystem time_source_;
-  KafkaBrokerFilter testee_{scope_, time_source_, "prefix"};
+  KafkaBrokerFilter testee_{scope_, time_source_, "prefix", false, nullptr};
 
   Network::FilterStatus consumeRequestFromBuffer() {
     return testee_.onData(RequestB::buffer_, false);
@@ -153,6 +153,39 @@ TEST_F(KafkaBrokerFilterProtocolTest, ShouldProcessMessages) {
   }
 }
 
+TEST_F(KafkaBrokerFilterProtocolTest, ShouldProcessMessagesWithoutParsingPayloads) {
+  // given
+  KafkaBrokerFilter testee{scope_, time_source_, "prefix", true, nullptr};
+  for (const AbstractRequestSharedPtr& message : MessageUtilities::makeAllRequests()) {
+    RequestB::putMessageIntoBuffer(*message);
+  }
+  for (const AbstractResponseSharedPtr& message : MessageUtilities::makeAllResponses()) {
+    ResponseB::putMessageIntoBuffer(*message);
+  }
+  const std::string request_bytes = RequestB::buffer_.toString();
+  const std::string response_bytes = ResponseB::buffer_.toString();
+
+  // when
+  const Network::FilterStatus result1 = testee.onData(RequestB::buffer_, false);
+  const Network::FilterStatus result2 = testee.onWrite(ResponseB::buffer_, false);
+
+  // then
+  ASSERT_EQ(result1, Network::FilterStatus::Continue);
+  ASSERT_EQ(result2, Network::FilterStatus::Continue);
+
+  // The data is forwarded untouched.
+  ASSERT_EQ(RequestB::buffer_.toString(), request_bytes);
+  ASSERT_EQ(ResponseB::buffer_.toString(), response_bytes);
+
+  // The metrics are the same as when payloads are parsed.
+  for (int16_t i = 0; i < MessageUtilities::apiKeys(); ++i) {
+    const Stats::Counter& request_counter = scope_.counter(MessageUtilities::requestMetric(i));
+    ASSERT_EQ(request_counter.value(), MessageUtilities::requestApiVersions(i));
+    const Stats::Counter& response_counter = scope_.counter(MessageUtilities::responseMetric(i));
+    ASSERT_EQ(response_counter.value(), MessageUtilities::responseApiVersions(i));
+  }
+}
+
 } // namespace Broker
 } // namespace Kafka
 } // namespace NetworkFilters
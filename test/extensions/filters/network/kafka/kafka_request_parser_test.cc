@@ -192,6 +192,51 @@ TEST_F(KafkaRequestParserTest, SentinelParserShouldConsumeDataUntilEndOfRequest)
   assertStringViewIncrement(data, orig_data, request_len);
 }
 
+TEST_F(KafkaRequestParserTest, HeaderOnlyResolverShouldSkipOnlySupportedRequests) {
+  // given
+  const RequestParserResolver& testee = HeaderOnlyRequestParserResolver::getInstance();
+  RequestContextSharedPtr context{new RequestContext()};
+
+  // when
+  const RequestParserSharedPtr supported = testee.createParser(0, 0, context);
+  const RequestParserSharedPtr unsupported =
+      testee.createParser(std::numeric_limits<int16_t>::max(), 0, context);
+
+  // then
+  ASSERT_NE(std::dynamic_pointer_cast<UnparsedRequestParser>(supported), nullptr);
+  ASSERT_NE(std::dynamic_pointer_cast<SentinelParser>(unsupported), nullptr);
+}
+
+TEST_F(KafkaRequestParserTest, UnparsedRequestParserShouldConsumeDataUntilEndOfRequest) {
+  // given
+  const int32_t request_len = 1000;
+  RequestContextSharedPtr context{new RequestContext()};
+  context->remaining_request_size_ = request_len;
+  context->request_header_ = {1, 2, 3, absl::nullopt};
+  UnparsedRequestParser testee{context};
+
+  const absl::string_view orig_data = putGarbageIntoBuffer(request_len * 2);
+  absl::string_view data = orig_data;
+  absl::string_view first_part = {data.data(), request_len / 2};
+  data = {data.data() + request_len / 2, data.size() - request_len / 2};
+
+  // when
+  const RequestParseResponse result1 = testee.parse(first_part);
+  const RequestParseResponse result2 = testee.parse(data);
+
+  // then
+  ASSERT_EQ(result1.hasData(), false);
+  ASSERT_EQ(result2.hasData(), true);
+  ASSERT_EQ(result2.next_parser_, nullptr);
+  ASSERT_NE(std::dynamic_pointer_cast<UnparsedRequest>(result2.message_), nullptr);
+  ASSERT_EQ(result2.failure_data_, nullptr);
+  ASSERT_EQ(result2.message_->request_header_, context->request_header_);
+
+  ASSERT_EQ(testee.contextForTest()->remaining_request_size_, 0);
+
+  assertStringViewIncrement(data, orig_data, request_len);
+}
+
 } // namespace KafkaRequestParserTest
 } // namespace Kafka
 } // namespace NetworkFilters
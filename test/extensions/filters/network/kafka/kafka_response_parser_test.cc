@@ -193,6 +193,54 @@ TEST_F(KafkaResponseParserTest, SentinelResponseParserShouldConsumeDataUntilEndO
   assertStringViewIncrement(data, orig_data, response_len);
 }
 
+TEST_F(KafkaResponseParserTest, HeaderOnlyResolverShouldSkipOnlySupportedResponses) {
+  // given
+  const ResponseParserResolver& testee = HeaderOnlyResponseParserResolver::getInstance();
+  ResponseContextSharedPtr supported_context = std::make_shared<ResponseContext>();
+  supported_context->api_key_ = 0;
+  supported_context->api_version_ = 0;
+  ResponseContextSharedPtr unsupported_context = std::make_shared<ResponseContext>();
+  unsupported_context->api_key_ = std::numeric_limits<int16_t>::max();
+  unsupported_context->api_version_ = 0;
+
+  // when
+  const ResponseParserSharedPtr supported = testee.createParser(supported_context);
+  const ResponseParserSharedPtr unsupported = testee.createParser(unsupported_context);
+
+  // then
+  ASSERT_NE(std::dynamic_pointer_cast<UnparsedResponseParser>(supported), nullptr);
+  ASSERT_NE(std::dynamic_pointer_cast<SentinelResponseParser>(unsupported), nullptr);
+}
+
+TEST_F(KafkaResponseParserTest, UnparsedResponseParserShouldConsumeDataUntilEndOfMessage) {
+  // given
+  const int32_t response_len = 1000;
+  ResponseContextSharedPtr context = std::make_shared<ResponseContext>();
+  context->remaining_response_size_ = response_len;
+  context->api_key_ = 1;
+  context->api_version_ = 2;
+  context->correlation_id_ = 3;
+  UnparsedResponseParser testee{context};
+
+  const absl::string_view orig_data = putGarbageIntoBuffer(response_len * 2);
+  absl::string_view data = orig_data;
+
+  // when
+  const ResponseParseResponse result = testee.parse(data);
+
+  // then
+  ASSERT_EQ(result.hasData(), true);
+  ASSERT_EQ(result.next_parser_, nullptr);
+  ASSERT_NE(std::dynamic_pointer_cast<UnparsedResponse>(result.message_), nullptr);
+  ASSERT_EQ(result.failure_data_, nullptr);
+  const ResponseMetadata expected_metadata = {1, 2, 3};
+  ASSERT_EQ(result.message_->metadata_, expected_metadata);
+
+  ASSERT_EQ(testee.contextForTest()->remaining_response_size_, 0);
+
+  assertStringViewIncrement(data, orig_data, response_len);
+}
+
 } // namespace KafkaResponseParserTest
 } // namespace Kafka
 } // namespace NetworkFilters
@@ -0,0 +1,151 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "source/common/common/byte_order.h"
+#include "source/extensions/filters/network/kafka/record_batch.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace {
+
+void putVarlong(std::string& dst, const int64_t value) {
+  uint64_t raw = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+  while (raw >= 0x80) {
+    dst.push_back(static_cast<char>(raw | 0x80));
+    raw >>= 7;
+  }
+  dst.push_back(static_cast<char>(raw));
+}
+
+template <typename T> void putBigEndian(std::string& dst, const T value) {
+  const T converted = toEndianness<ByteOrder::BigEndian>(value);
+  dst.append(reinterpret_cast<const char*>(&converted), sizeof(T));
+}
+
+template <typename T> T getBigEndian(const Bytes& data, const uint32_t offset) {
+  T value;
+  memcpy(&value, data.data() + offset, sizeof(T));
+  return fromEndianness<ByteOrder::BigEndian>(value);
+}
+
+/**
+ * Builds a record batch with records of given values, that have timestamps relative to the
+ * first timestamp given.
+ */
+std::string makeBatch(const int64_t first_timestamp,
+                      const std::vector<std::pair<int64_t, std::string>>& records,
+                      const int16_t attributes = 0, const int64_t producer_id = -1) {
+  std::string encoded_records;
+  int64_t max_timestamp = first_timestamp;
+  for (size_t i = 0; i < records.size(); ++i) {
+    std::string record;
+    record.push_back(0);
+    putVarlong(record, records[i].first);
+    putVarlong(record, i);
+    putVarlong(record, -1);
+    putVarlong(record, records[i].second.size());
+    record += records[i].second;
+    putVarlong(record, 0);
+    putVarlong(encoded_records, record.size());
+    encoded_records += record;
+    max_timestamp = std::max(max_timestamp, first_timestamp + records[i].first);
+  }
+
+  // Everything after the checksum.
+  std::string checksummed;
+  putBigEndian<int16_t>(checksummed, attributes);
+  putBigEndian<int32_t>(checksummed, records.size() - 1);
+  putBigEndian<int64_t>(checksummed, first_timestamp);
+  putBigEndian<int64_t>(checksummed, max_timestamp);
+  putBigEndian<int64_t>(checksummed, producer_id);
+  putBigEndian<int16_t>(checksummed, -1);
+  putBigEndian<int32_t>(checksummed, -1);
+  putBigEndian<int32_t>(checksummed, records.size());
+  checksummed += encoded_records;
+
+  std::string batch;
+  putBigEndian<int64_t>(batch, 0);
+  putBigEndian<int32_t>(batch, checksummed.size() + 9);
+  putBigEndian<int32_t>(batch, -1);
+  batch.push_back(2);
+  putBigEndian<uint32_t>(batch, crc32c(checksummed));
+  return batch + checksummed;
+}
+
+absl::string_view toView(const Bytes& bytes) {
+  return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+}
+
+TEST(Crc32c, ShouldComputeChecksum) {
+  ASSERT_EQ(crc32c(""), 0U);
+  ASSERT_EQ(crc32c("123456789"), 0xe3069283);
+  ASSERT_EQ(crc32c("56789", crc32c("1234")), 0xe3069283);
+}
+
+TEST(RecordBatchMerger, ShouldMergeBatches) {
+  // given
+  RecordBatchMerger testee;
+
+  // when
+  const absl::optional<int32_t> first = testee.add(makeBatch(1000, {{0, "a"}, {5, "bb"}}));
+  const absl::optional<int32_t> second = testee.add(makeBatch(990, {{20, "ccc"}}));
+
+  // then
+  ASSERT_EQ(first, 0);
+  ASSERT_EQ(second, 2);
+  ASSERT_EQ(testee.recordCount(), 3);
+
+  const Bytes merged = testee.build();
+  ASSERT_EQ(merged.size(), testee.size());
+  ASSERT_EQ(getBigEndian<int32_t>(merged, 23), 2);    // Last offset delta.
+  ASSERT_EQ(getBigEndian<int64_t>(merged, 27), 1000); // First timestamp.
+  ASSERT_EQ(getBigEndian<int64_t>(merged, 35), 1010); // Max timestamp.
+  ASSERT_EQ(getBigEndian<int32_t>(merged, 57), 3);    // Record count.
+
+  // The merged batch is valid, with the same records as a batch built directly.
+  RecordBatchMerger validator;
+  ASSERT_EQ(validator.add(toView(merged)), 0);
+  const std::string expected = makeBatch(1000, {{0, "a"}, {5, "bb"}, {10, "ccc"}});
+  ASSERT_EQ(toView(merged), expected);
+}
+
+TEST(RecordBatchMerger, ShouldNotMergeCompressedBatches) {
+  // given
+  RecordBatchMerger testee;
+  ASSERT_EQ(testee.add(makeBatch(1000, {{0, "a"}})), 0);
+  const uint64_t size = testee.size();
+
+  // when
+  const absl::optional<int32_t> result = testee.add(makeBatch(1000, {{0, "b"}}, 1));
+
+  // then
+  ASSERT_EQ(result, absl::nullopt);
+  ASSERT_EQ(testee.recordCount(), 1);
+  ASSERT_EQ(testee.size(), size);
+}
+
+TEST(RecordBatchMerger, ShouldNotMergeBatchesOfIdempotentProducers) {
+  RecordBatchMerger testee;
+  ASSERT_EQ(testee.add(makeBatch(1000, {{0, "a"}}, 0, 42)), absl::nullopt);
+  ASSERT_EQ(testee.recordCount(), 0);
+}
+
+TEST(RecordBatchMerger, ShouldNotMergeCorruptedBatches) {
+  RecordBatchMerger testee;
+  std::string batch = makeBatch(1000, {{0, "a"}});
+  batch.back() ^= 1;
+  ASSERT_EQ(testee.add(batch), absl::nullopt);
+  ASSERT_EQ(testee.add(batch.substr(0, batch.size() - 1)), absl::nullopt);
+  ASSERT_EQ(testee.recordCount(), 0);
+}
+
+} // namespace
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
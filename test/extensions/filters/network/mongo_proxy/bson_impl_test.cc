@@ -51,6 +51,62 @@ TEST(BsonImplTest, InvalodDocumentTermination) {
   EXPECT_THROW(DocumentImpl::create(buffer), EnvoyException);
 }
 
+TEST(BsonImplTest, LazyDocument) {
+  DocumentSharedPtr doc = DocumentImpl::create()->addString("hello", "world")->addInt32("n", 1);
+  Buffer::OwnedImpl buffer;
+  doc->encode(buffer);
+  const std::string encoded = buffer.toString();
+
+  DocumentSharedPtr lazy_doc = LazyDocumentImpl::create(buffer);
+  const auto& lazy = dynamic_cast<const LazyDocumentImpl&>(*lazy_doc);
+  EXPECT_EQ(0, buffer.length());
+
+  // The size and encoding do not need the document to be decoded.
+  EXPECT_EQ(doc->byteSize(), lazy.byteSize());
+  Buffer::OwnedImpl output;
+  lazy.encode(output);
+  EXPECT_EQ(encoded, output.toString());
+  EXPECT_FALSE(lazy.isDecoded());
+
+  // Fields are decoded when first accessed.
+  EXPECT_EQ("world", lazy.find("hello")->asString());
+  EXPECT_TRUE(lazy.isDecoded());
+  EXPECT_TRUE(lazy == *doc);
+  EXPECT_EQ(doc->toString(), lazy.toString());
+
+  // Documents can still be modified.
+  lazy_doc->addInt32("m", 2);
+  EXPECT_EQ(2, lazy.find("m", Field::Type::Int32)->asInt32());
+  EXPECT_EQ(doc->byteSize() + 7, lazy.byteSize());
+}
+
+TEST(BsonImplTest, LazyDocumentInvalidMessageLength) {
+  {
+    Buffer::OwnedImpl buffer;
+    BufferHelper::writeInt32(buffer, 100);
+    EXPECT_THROW(LazyDocumentImpl::create(buffer), EnvoyException);
+  }
+
+  {
+    Buffer::OwnedImpl buffer;
+    BufferHelper::writeInt32(buffer, 4);
+    EXPECT_THROW(LazyDocumentImpl::create(buffer), EnvoyException);
+  }
+}
+
+TEST(BsonImplTest, LazyDocumentInvalidDocumentTermination) {
+  Buffer::OwnedImpl buffer;
+  BufferHelper::writeInt32(buffer, 5);
+  uint8_t invalid_document_end = 0x1;
+  buffer.add(&invalid_document_end, sizeof(invalid_document_end));
+
+  // Malformed documents are only detected when decoded, and can be decoded again.
+  DocumentSharedPtr doc = LazyDocumentImpl::create(buffer);
+  EXPECT_EQ(5, doc->byteSize());
+  EXPECT_THROW(doc->values(), EnvoyException);
+  EXPECT_THROW(doc->values(), EnvoyException);
+}
+
 TEST(BufferHelperTest, InvalidSize) {
   {
     Buffer::OwnedImpl buffer;
@@ -0,0 +1,65 @@
+// Measures the decoding of the documents of large insert batches, either decoding each
+// document whole or only keeping its encoded bytes until its fields are accessed.
+
+#include <string>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/network/mongo_proxy/bson_impl.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace MongoProxy {
+namespace Bson {
+namespace {
+
+// @return the given number of encoded documents, each with the given number of fields.
+std::string makeDocuments(int64_t documents, int64_t fields) {
+  Buffer::OwnedImpl buffer;
+  for (int64_t i = 0; i < documents; i++) {
+    DocumentSharedPtr document = DocumentImpl::create();
+    for (int64_t j = 0; j < fields; j++) {
+      const std::string key = "field" + std::to_string(j);
+      document->addString(key, std::string(32, 'a'));
+      document->addInt64(key + "_count", j);
+      document->addDocument(key + "_nested", DocumentImpl::create()->addBoolean("flag", true));
+    }
+    document->encode(buffer);
+  }
+  return buffer.toString();
+}
+
+template <class DocumentType> void decodeDocuments(benchmark::State& state) {
+  const std::string documents = makeDocuments(state.range(0), state.range(1));
+  for (auto _ : state) { // NOLINT
+    Buffer::OwnedImpl buffer(documents);
+    uint64_t byte_size = 0;
+    while (buffer.length() > 0) {
+      byte_size += DocumentType::create(buffer)->byteSize();
+    }
+    benchmark::DoNotOptimize(byte_size);
+  }
+  state.SetBytesProcessed(state.iterations() * documents.size());
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_DecodeDocuments(benchmark::State& state) { decodeDocuments<DocumentImpl>(state); }
+BENCHMARK(BM_DecodeDocuments)->Args({1000, 1})->Args({1000, 20})->Unit(benchmark::kMicrosecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_DecodeLazyDocuments(benchmark::State& state) {
+  decodeDocuments<LazyDocumentImpl>(state);
+}
+BENCHMARK(BM_DecodeLazyDocuments)
+    ->Args({1000, 1})
+    ->Args({1000, 20})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Bson
+} // namespace MongoProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,82 @@
+// Measures the decoding of result sets by the decoder, with the data arriving in reads of a given
+// size as it does through the filter.
+
+#include <algorithm>
+#include <string>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/network/mysql_proxy/mysql_codec.h"
+#include "source/extensions/filters/network/mysql_proxy/mysql_decoder_impl.h"
+#include "source/extensions/filters/network/mysql_proxy/mysql_utils.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace MySQLProxy {
+namespace {
+
+class BenchmarkDecoderCallbacks : public DecoderCallbacks {
+public:
+  // DecoderCallbacks
+  void onProtocolError() override {}
+  void onNewMessage(MySQLSession::State) override {}
+  void onServerGreeting(ServerGreeting&) override {}
+  void onClientLogin(ClientLogin&) override {}
+  void onClientLoginResponse(ClientLoginResponse&) override {}
+  void onClientSwitchResponse(ClientSwitchResponse&) override {}
+  void onMoreClientLoginResponse(ClientLoginResponse&) override {}
+  void onCommand(Command&) override {}
+  void onCommandResponse(CommandResponse&) override {}
+};
+
+// @return a result set of the given number of rows, each with a column of the given size.
+std::string makeResultSet(int64_t rows, int64_t column_size) {
+  Buffer::OwnedImpl buffer;
+  uint8_t seq = 1;
+
+  // Column count, then the rows, each with the length encoded value of its column.
+  Buffer::OwnedImpl packet;
+  BufferHelper::addUint8(packet, 1);
+  BufferHelper::encodeHdr(packet, seq++);
+  buffer.move(packet);
+  const std::string column(column_size, 'a');
+  for (int64_t i = 0; i < rows; i++) {
+    BufferHelper::addLengthEncodedInteger(packet, column_size);
+    BufferHelper::addString(packet, column);
+    BufferHelper::encodeHdr(packet, seq++);
+    buffer.move(packet);
+  }
+  return buffer.toString();
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_DecodeResultSet(benchmark::State& state) {
+  const std::string result_set = makeResultSet(state.range(0), state.range(1));
+  const uint64_t read_size = state.range(2);
+  BenchmarkDecoderCallbacks callbacks;
+  for (auto _ : state) { // NOLINT
+    DecoderImpl decoder(callbacks);
+    decoder.getSession().setState(MySQLSession::State::ReqResp);
+    decoder.getSession().setExpectedSeq(1);
+    Buffer::OwnedImpl buffer;
+    for (uint64_t offset = 0; offset < result_set.size(); offset += read_size) {
+      buffer.add(result_set.data() + offset, std::min(read_size, result_set.size() - offset));
+      decoder.onData(buffer, true);
+    }
+    benchmark::DoNotOptimize(buffer.length());
+  }
+  state.SetBytesProcessed(state.iterations() * result_set.size());
+}
+BENCHMARK(BM_DecodeResultSet)
+    ->Args({10000, 16, 16384})
+    ->Args({100, 16384, 16384})
+    ->Args({10, 1 << 20, 16384})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace MySQLProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -1067,6 +1067,67 @@ TEST_F(MySQLFilterTest, MySqlLoginAndQueryTest) {
   EXPECT_EQ(MySQLSession::State::Req, filter_->getSession().getState());
 }
 
+/*
+ * Test that the rows of a result set are dropped as they arrive
+ * SM: greeting(p=10) -> challenge-req(v41) -> serv-resp-ok ->
+ * -> Query-request -> Query-response -> partial row -> Query-request -> rest of row
+ * validate that the partial row does not hold the decoding of either direction
+ */
+TEST_F(MySQLFilterTest, MySqlSkipResultSetRowsTest) {
+  initialize();
+
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onNewConnection());
+
+  std::string greeting_data = encodeServerGreeting(MYSQL_PROTOCOL_10);
+  Buffer::OwnedImpl greet_data(greeting_data);
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onWrite(greet_data, false));
+
+  std::string clogin_data = encodeClientLogin(CLIENT_PROTOCOL_41, "user1", CHALLENGE_SEQ_NUM);
+  Buffer::OwnedImpl client_login_data(clogin_data);
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(client_login_data, false));
+
+  std::string srv_resp_data = encodeClientLoginResp(MYSQL_RESP_OK);
+  Buffer::OwnedImpl server_resp_data(srv_resp_data);
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onWrite(server_resp_data, false));
+  EXPECT_EQ(MySQLSession::State::Req, filter_->getSession().getState());
+
+  Command mysql_cmd_encode{};
+  mysql_cmd_encode.setCmd(Command::Cmd::Query);
+  mysql_cmd_encode.setData("CREATE DATABASE mysqldb");
+  Buffer::OwnedImpl client_query_data;
+  mysql_cmd_encode.encode(client_query_data);
+  BufferHelper::encodeHdr(client_query_data, 0);
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(client_query_data, false));
+  EXPECT_EQ(MySQLSession::State::ReqResp, filter_->getSession().getState());
+
+  srv_resp_data = encodeClientLoginResp(MYSQL_RESP_OK, 0, 1);
+  Buffer::OwnedImpl query_resp_data(srv_resp_data);
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onWrite(query_resp_data, false));
+  EXPECT_EQ(MySQLSession::State::Req, filter_->getSession().getState());
+
+  // Only the header and the start of a row are received.
+  const std::string row = encodeMessage(100, 0, 2);
+  Buffer::OwnedImpl row_start(row.substr(0, 14));
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onWrite(row_start, false));
+  EXPECT_EQ(1UL, config_->stats().protocol_errors_.value());
+
+  // The client side is still decoded.
+  mysql_cmd_encode.setData("show databases");
+  Buffer::OwnedImpl query_show;
+  mysql_cmd_encode.encode(query_show);
+  BufferHelper::encodeHdr(query_show, 0);
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(query_show, false));
+  EXPECT_EQ(MySQLSession::State::ReqResp, filter_->getSession().getState());
+  EXPECT_EQ(2UL, config_->stats().queries_parsed_.value());
+
+  // The rest of the row is dropped, and the next response is decoded.
+  Buffer::OwnedImpl row_end(row.substr(14) + encodeClientLoginResp(MYSQL_RESP_OK, 0, 1));
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onWrite(row_end, false));
+  EXPECT_EQ(MySQLSession::State::Req, filter_->getSession().getState());
+  EXPECT_EQ(1UL, config_->stats().protocol_errors_.value());
+  EXPECT_EQ(0UL, config_->stats().decoder_errors_.value());
+}
+
 } // namespace MySQLProxy
 } // namespace NetworkFilters
 } // namespace Extensions
@@ -0,0 +1,86 @@
+// Measures the decoding of result sets by the backend decoder, with the data arriving in reads of
+// a given size as it does through the filter.
+
+#include <algorithm>
+#include <string>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/network/postgres_proxy/postgres_decoder.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace PostgresProxy {
+namespace {
+
+class BenchmarkDecoderCallbacks : public DecoderCallbacks {
+public:
+  // DecoderCallbacks
+  void incMessagesBackend() override {}
+  void incMessagesFrontend() override {}
+  void incMessagesUnknown() override {}
+  void incSessionsEncrypted() override {}
+  void incSessionsUnencrypted() override {}
+  void incStatements(StatementType) override {}
+  void incTransactions() override {}
+  void incTransactionsCommit() override {}
+  void incTransactionsRollback() override {}
+  void incNotices(NoticeType) override {}
+  void incErrors(ErrorType) override {}
+  void processQuery(const std::string&) override {}
+  bool onSSLRequest() override { return true; }
+};
+
+// @return a result set of the given number of rows, each with a column of the given size.
+std::string makeResultSet(int64_t rows, int64_t column_size) {
+  Buffer::OwnedImpl buffer;
+  const std::string column(column_size, 'a');
+  for (int64_t i = 0; i < rows; i++) {
+    // DataRow: number of columns, then the length and value of each of them.
+    buffer.add("D");
+    buffer.writeBEInt<uint32_t>(4 + 2 + 4 + column_size);
+    buffer.writeBEInt<uint16_t>(1);
+    buffer.writeBEInt<uint32_t>(column_size);
+    buffer.add(column);
+  }
+  const std::string tag = absl::StrCat("SELECT ", rows);
+  buffer.add("C");
+  buffer.writeBEInt<uint32_t>(4 + tag.size() + 1);
+  buffer.add(tag);
+  buffer.writeByte(0);
+  return buffer.toString();
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_DecodeResultSet(benchmark::State& state) {
+  const std::string result_set = makeResultSet(state.range(0), state.range(1));
+  const uint64_t read_size = state.range(2);
+  BenchmarkDecoderCallbacks callbacks;
+  for (auto _ : state) { // NOLINT
+    DecoderImpl decoder(&callbacks);
+    decoder.state(DecoderImpl::State::InSyncState);
+    Buffer::OwnedImpl buffer;
+    for (uint64_t offset = 0; offset < result_set.size(); offset += read_size) {
+      buffer.add(result_set.data() + offset, std::min(read_size, result_set.size() - offset));
+      while (buffer.length() > 0 &&
+             decoder.onData(buffer, false) == Decoder::Result::ReadyForNext) {
+      }
+    }
+    benchmark::DoNotOptimize(buffer.length());
+  }
+  state.SetBytesProcessed(state.iterations() * result_set.size());
+}
+BENCHMARK(BM_DecodeResultSet)
+    ->Args({10000, 16, 16384})
+    ->Args({100, 16384, 16384})
+    ->Args({10, 1 << 20, 16384})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace PostgresProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
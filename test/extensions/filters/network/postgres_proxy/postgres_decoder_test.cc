@@ -242,7 +242,7 @@ TEST_F(PostgresProxyDecoderTest, ReadingBufferLargeMessages) {
   // Fill the buffer with message of 100 bytes long
   // but the buffer contains only 98 bytes.
   // It should not be processed.
-  data_.add("d");
+  data_.add("p");
   // Add length.
   data_.writeBEInt<uint32_t>(100); // This also includes length field
   data_.add(buf_, 94);
@@ -258,6 +258,39 @@ TEST_F(PostgresProxyDecoderTest, ReadingBufferLargeMessages) {
   ASSERT_THAT(data_.length(), 0);
 }
 
+// Test verifies that the body of bulk data messages is dropped as it
+// arrives, without waiting for the entire message.
+TEST_F(PostgresProxyDecoderTest, SkippingBulkDataMessages) {
+  decoder_->state(DecoderImpl::State::InSyncState);
+  // DataRow message of 100 bytes long, of which only the header
+  // and 10 bytes of body are in the buffer.
+  EXPECT_CALL(callbacks_, incMessagesBackend()).Times(2);
+  data_.add("D");
+  data_.writeBEInt<uint32_t>(100);
+  data_.add(buf_, 10);
+  ASSERT_THAT(decoder_->onData(data_, false), Decoder::Result::ReadyForNext);
+  ASSERT_THAT(data_.length(), 0);
+
+  // Frontend messages are decoded while the backend message is skipped.
+  Buffer::OwnedImpl frontend_data;
+  EXPECT_CALL(callbacks_, processQuery);
+  createPostgresMsg(frontend_data, "Q", "test");
+  ASSERT_THAT(decoder_->onData(frontend_data, true), Decoder::Result::ReadyForNext);
+  ASSERT_THAT(frontend_data.length(), 0);
+
+  // The rest of the body is dropped, and the next message is decoded.
+  Buffer::OwnedImpl next_message;
+  createPostgresMsg(next_message, "C", "SELECT blah");
+  data_.add(buf_, 86);
+  data_.add(next_message);
+  ASSERT_THAT(decoder_->onData(data_, false), Decoder::Result::ReadyForNext);
+  ASSERT_THAT(data_.length(), 17);
+  EXPECT_CALL(callbacks_, incStatements(DecoderCallbacks::StatementType::Select));
+  ASSERT_THAT(decoder_->onData(data_, false), Decoder::Result::ReadyForNext);
+  ASSERT_THAT(data_.length(), 0);
+  ASSERT_THAT(decoder_->state(), DecoderImpl::State::InSyncState);
+}
+
 // Test simulates situation when a buffer contains more than one
 // message. Call to the decoder should consume only one message
 // at a time and only when the buffer contains the entire message.
@@ -655,6 +688,7 @@ public:
   MOCK_METHOD(void*, linearize, (uint32_t), (override));
   MOCK_METHOD(void, move, (Instance&), (override));
   MOCK_METHOD(void, move, (Instance&, uint64_t), (override));
+  MOCK_METHOD(void, movePinned, (Instance&, uint64_t), (override));
   MOCK_METHOD(Buffer::Reservation, reserveForRead, (), (override));
   MOCK_METHOD(Buffer::ReservationSingleSlice, reserveSingleSlice, (uint64_t, bool), (override));
   MOCK_METHOD(void, commit,
@@ -5,13 +5,20 @@
 #include <string>
 #include <vector>
 
+#include "envoy/extensions/filters/network/redis_proxy/v3/redis_proxy.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/fmt.h"
 #include "source/common/stats/isolated_store_impl.h"
 #include "source/extensions/filters/network/common/redis/client_impl.h"
+#include "source/extensions/filters/network/common/redis/codec_impl.h"
 #include "source/extensions/filters/network/common/redis/supported_commands.h"
 #include "source/extensions/filters/network/redis_proxy/command_splitter_impl.h"
 #include "source/extensions/filters/network/redis_proxy/router_impl.h"
 
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/upstream/host.h"
 #include "test/test_common/simulated_time_system.h"
 
 #include "absl/types/variant.h"
@@ -83,6 +90,91 @@ public:
     }
   }
 };
+
+// Proxies the requests a number of downstream clients send in each event loop iteration to an
+// upstream client, counting the writes to its connection.
+class ClientBatchSpeedTest : public Common::Redis::Client::ClientCallbacks {
+public:
+  ClientBatchSpeedTest(bool flush_on_event_loop_iteration) {
+    envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ConnPoolSettings settings;
+    settings.mutable_op_timeout()->set_seconds(1);
+    settings.set_flush_on_event_loop_iteration(flush_on_event_loop_iteration);
+    config_ = std::make_unique<Common::Redis::Client::ConfigImpl>(settings);
+
+    // The connect or operation timer and the flush timer.
+    new testing::NiceMock<Event::MockTimer>(&dispatcher_);
+    new testing::NiceMock<Event::MockTimer>(&dispatcher_);
+    if (flush_on_event_loop_iteration) {
+      flush_cb_ = new testing::NiceMock<Event::MockSchedulableCallback>(&dispatcher_);
+    }
+
+    auto* connection = new testing::NiceMock<Network::MockClientConnection>();
+    Upstream::MockHost::MockCreateConnectionData conn_info;
+    conn_info.connection_ = connection;
+    ON_CALL(*host_, createConnection_(testing::_, testing::_))
+        .WillByDefault(testing::Return(conn_info));
+    ON_CALL(*connection, addReadFilter(testing::_))
+        .WillByDefault(testing::SaveArg<0>(&read_filter_));
+    ON_CALL(*connection, write(testing::_, testing::_))
+        .WillByDefault(testing::Invoke([this](Buffer::Instance& data, bool) -> void {
+          writes_++;
+          data.drain(data.length());
+        }));
+
+    request_.type(Common::Redis::RespType::Array);
+    std::vector<Common::Redis::RespValue> values(2);
+    values[0].type(Common::Redis::RespType::BulkString);
+    values[0].asString() = "get";
+    values[1].type(Common::Redis::RespType::BulkString);
+    values[1].asString() = std::string(36, 'k');
+    request_.asArray().swap(values);
+
+    client_ = Common::Redis::Client::ClientImpl::create(
+        host_, dispatcher_, std::make_unique<Common::Redis::EncoderImpl>(), decoder_factory_,
+        *config_,
+        Common::Redis::RedisCommandStats::createRedisCommandStats(store_.symbolTable()), store_);
+  }
+
+  ~ClientBatchSpeedTest() override { client_->close(); }
+
+  // Makes the requests of an event loop iteration and receives their responses.
+  void iterate(uint64_t requests) {
+    for (uint64_t i = 0; i < requests; i++) {
+      client_->makeRequest(request_, *this);
+    }
+    if (flush_cb_ != nullptr) {
+      flush_cb_->invokeCallback();
+    }
+
+    Buffer::OwnedImpl responses;
+    for (uint64_t i = 0; i < requests; i++) {
+      responses.add("+OK\r\n");
+    }
+    read_filter_->onData(responses, false);
+  }
+
+  uint64_t writes() const { return writes_; }
+
+  // Common::Redis::Client::ClientCallbacks
+  void onResponse(Common::Redis::RespValuePtr&&) override {}
+  void onFailure() override {}
+  bool onRedirection(Common::Redis::RespValuePtr&&, const std::string&, bool) override {
+    return false;
+  }
+
+private:
+  Stats::IsolatedStoreImpl store_;
+  testing::NiceMock<Event::MockDispatcher> dispatcher_;
+  std::shared_ptr<testing::NiceMock<Upstream::MockHost>> host_{
+      new testing::NiceMock<Upstream::MockHost>()};
+  Event::MockSchedulableCallback* flush_cb_{};
+  Network::ReadFilterSharedPtr read_filter_;
+  Common::Redis::DecoderFactoryImpl decoder_factory_;
+  std::unique_ptr<Common::Redis::Client::Config> config_;
+  Common::Redis::RespValue request_;
+  Common::Redis::Client::ClientPtr client_;
+  uint64_t writes_{};
+};
 } // namespace RedisProxy
 } // namespace NetworkFilters
 } // namespace Extensions
@@ -129,3 +221,16 @@ static void BM_Split_CreateVariant(benchmark::State& state) {
   state.counters["use_count"] = request.use_count();
 }
 BENCHMARK(BM_Split_CreateVariant)->Ranges({{1, 100}, {64, 8 << 14}});
+
+// The writes to the upstream connection for each request, depending on the number of requests
+// made in an event loop iteration and whether they are flushed at its end.
+static void BM_Client_Batch(benchmark::State& state) {
+  Envoy::Extensions::NetworkFilters::RedisProxy::ClientBatchSpeedTest context(state.range(1));
+  uint64_t requests = 0;
+  for (auto _ : state) {
+    context.iterate(state.range(0));
+    requests += state.range(0);
+  }
+  state.counters["writes_per_request"] = static_cast<double>(context.writes()) / requests;
+}
+BENCHMARK(BM_Client_Batch)->Ranges({{1, 256}, {0, 1}});
@@ -17,6 +17,7 @@
 #include "test/extensions/filters/network/common/redis/test_utils.h"
 #include "test/extensions/filters/network/redis_proxy/mocks.h"
 #include "test/mocks/api/mocks.h"
+#include "test/mocks/local_info/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/upstream/cluster.h"
 #include "test/mocks/upstream/cluster_manager.h"
@@ -88,7 +89,7 @@ public:
         cluster_name_, cm_, *this, tls_,
         Common::Redis::Client::createConnPoolSettings(20, hashtagging, true, max_unknown_conns,
                                                       read_policy_),
-        api_, std::move(store), redis_command_stats, cluster_refresh_manager_);
+        api_, std::move(store), redis_command_stats, cluster_refresh_manager_, local_info_);
     conn_pool_impl->init();
     // Set the authentication password for this connection pool.
     conn_pool_impl->tls_->getTyped<InstanceImpl::ThreadLocalPool>().auth_username_ = auth_username_;
@@ -301,6 +302,7 @@ public:
   std::string auth_username_;
   std::string auth_password_;
   NiceMock<Api::MockApi> api_;
+  NiceMock<LocalInfo::MockLocalInfo> local_info_;
   envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ConnPoolSettings::ReadPolicy
       read_policy_ = envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::
           ConnPoolSettings::MASTER;
@@ -1083,6 +1085,7 @@ TEST_F(RedisConnPoolImplTest, MovedRedirectionSuccess) {
 
   EXPECT_CALL(*this, create_(_)).WillOnce(DoAll(SaveArg<0>(&host1), Return(client2)));
   EXPECT_CALL(*client2, makeRequest_(Ref(*request_value), _)).WillOnce(Return(&active_request2));
+  EXPECT_CALL(*cluster_refresh_manager_, onSlotMoved("fake_cluster", 1111, "10.1.2.3:4000"));
   EXPECT_TRUE(client->client_callbacks_.back()->onRedirection(std::move(moved_response),
                                                               "10.1.2.3:4000", false));
   EXPECT_EQ(host1->address()->asString(), "10.1.2.3:4000");
@@ -1165,6 +1168,7 @@ TEST_F(RedisConnPoolImplTest, AskRedirectionSuccess) {
   EXPECT_CALL(*client2, makeRequest_(Ref(Common::Redis::Utility::AskingRequest::instance()), _))
       .WillOnce(Return(&ask_request));
   EXPECT_CALL(*client2, makeRequest_(Ref(*request_value), _)).WillOnce(Return(&active_request2));
+  EXPECT_CALL(*cluster_refresh_manager_, onSlotMoved(_, _, _)).Times(0);
   EXPECT_TRUE(client->client_callbacks_.back()->onRedirection(std::move(ask_response),
                                                               "10.1.2.3:4000", true));
   EXPECT_EQ(host1->address()->asString(), "10.1.2.3:4000");
@@ -1231,7 +1235,7 @@ TEST_F(RedisConnPoolImplTest, MakeRequestAndRedirectFollowedByDelete) {
   conn_pool_ = std::make_shared<InstanceImpl>(
       cluster_name_, cm_, *this, tls_,
       Common::Redis::Client::createConnPoolSettings(20, true, true, 100, read_policy_), api_,
-      std::move(store), redis_command_stats, cluster_refresh_manager_);
+      std::move(store), redis_command_stats, cluster_refresh_manager_, local_info_);
   conn_pool_->init();
 
   auto& local_pool = threadLocalPool();
@@ -1275,6 +1279,26 @@ TEST_F(RedisConnPoolImplTest, MakeRequestAndRedirectFollowedByDelete) {
   tls_.shutdownThread();
 }
 
+TEST(HostLatencyTrackerImplTest, MovingAverage) {
+  HostLatencyTrackerImpl tracker;
+  NiceMock<Upstream::MockHost> host1;
+  NiceMock<Upstream::MockHost> host2;
+
+  EXPECT_FALSE(tracker.latency(host1).has_value());
+  tracker.onResponseTime(host1, std::chrono::microseconds(100));
+  EXPECT_DOUBLE_EQ(100, tracker.latency(host1).value());
+  tracker.onResponseTime(host1, std::chrono::microseconds(200));
+  EXPECT_DOUBLE_EQ(120, tracker.latency(host1).value());
+  tracker.onResponseTime(host2, std::chrono::microseconds(50));
+  EXPECT_DOUBLE_EQ(50, tracker.latency(host2).value());
+
+  tracker.removeHost(host1);
+  EXPECT_FALSE(tracker.latency(host1).has_value());
+  EXPECT_DOUBLE_EQ(50, tracker.latency(host2).value());
+  tracker.clear();
+  EXPECT_FALSE(tracker.latency(host2).has_value());
+}
+
 } // namespace ConnPool
 } // namespace RedisProxy
 } // namespace NetworkFilters
@@ -0,0 +1,102 @@
+// Measures the decoding of framed binary requests, either decoding each request whole or only
+// its message header, with payload passthrough.
+
+#include <string>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/network/thrift_proxy/binary_protocol_impl.h"
+#include "source/extensions/filters/network/thrift_proxy/decoder.h"
+#include "source/extensions/filters/network/thrift_proxy/filters/pass_through_filter.h"
+#include "source/extensions/filters/network/thrift_proxy/framed_transport_impl.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace ThriftProxy {
+namespace {
+
+class BenchmarkDecoderCallbacks : public DecoderCallbacks {
+public:
+  BenchmarkDecoderCallbacks(bool passthrough) : passthrough_(passthrough) {}
+
+  // DecoderCallbacks
+  DecoderEventHandler& newDecoderEventHandler() override { return handler_; }
+  bool passthroughEnabled() const override { return passthrough_; }
+
+private:
+  const bool passthrough_;
+  ThriftFilters::PassThroughDecoderFilter handler_;
+};
+
+// @return the given number of framed requests, each with a list of the given number of structs.
+std::string makeRequests(int64_t requests, int64_t elements) {
+  BinaryProtocolImpl protocol;
+  FramedTransportImpl transport;
+  Buffer::OwnedImpl buffer;
+  for (int64_t i = 0; i < requests; i++) {
+    MessageMetadata metadata;
+    metadata.setMethodName("method");
+    metadata.setMessageType(MessageType::Call);
+    metadata.setSequenceId(i);
+
+    Buffer::OwnedImpl message;
+    protocol.writeMessageBegin(message, metadata);
+    protocol.writeStructBegin(message, "");
+    protocol.writeFieldBegin(message, "", FieldType::List, 1);
+    protocol.writeListBegin(message, FieldType::Struct, elements);
+    for (int64_t j = 0; j < elements; j++) {
+      protocol.writeStructBegin(message, "");
+      protocol.writeFieldBegin(message, "", FieldType::String, 1);
+      protocol.writeString(message, std::string(32, 'a'));
+      protocol.writeFieldEnd(message);
+      protocol.writeFieldBegin(message, "", FieldType::I64, 2);
+      protocol.writeInt64(message, j);
+      protocol.writeFieldEnd(message);
+      protocol.writeFieldBegin(message, "", FieldType::Stop, 0);
+      protocol.writeStructEnd(message);
+    }
+    protocol.writeListEnd(message);
+    protocol.writeFieldEnd(message);
+    protocol.writeFieldBegin(message, "", FieldType::Stop, 0);
+    protocol.writeStructEnd(message);
+    protocol.writeMessageEnd(message);
+    transport.encodeFrame(buffer, metadata, message);
+  }
+  return buffer.toString();
+}
+
+void decodeRequests(benchmark::State& state, bool passthrough) {
+  const std::string requests = makeRequests(state.range(0), state.range(1));
+  BinaryProtocolImpl protocol;
+  FramedTransportImpl transport;
+  BenchmarkDecoderCallbacks callbacks(passthrough);
+  for (auto _ : state) { // NOLINT
+    Decoder decoder(transport, protocol, callbacks);
+    Buffer::OwnedImpl buffer(requests);
+    bool underflow = false;
+    while (!underflow) {
+      decoder.onData(buffer, underflow);
+    }
+    benchmark::DoNotOptimize(buffer.length());
+  }
+  state.SetBytesProcessed(state.iterations() * requests.size());
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_DecodeRequests(benchmark::State& state) { decodeRequests(state, false); }
+BENCHMARK(BM_DecodeRequests)->Args({100, 1})->Args({100, 100})->Unit(benchmark::kMicrosecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_DecodeRequestsPassthrough(benchmark::State& state) { decodeRequests(state, true); }
+BENCHMARK(BM_DecodeRequestsPassthrough)
+    ->Args({100, 1})
+    ->Args({100, 100})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace ThriftProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
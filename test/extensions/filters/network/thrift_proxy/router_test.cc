@@ -90,7 +90,8 @@ public:
     route_ = new NiceMock<MockRoute>();
     route_ptr_.reset(route_);
 
-    router_ = std::make_unique<Router>(context_.clusterManager(), "test", context_.scope());
+    router_ =
+        std::make_unique<Router>(context_.clusterManager(), "test", context_.scope(), nullptr);
 
     EXPECT_EQ(nullptr, router_->downstreamConnection());
 
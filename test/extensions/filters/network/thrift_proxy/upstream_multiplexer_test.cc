@@ -0,0 +1,228 @@
+#include <memory>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/network/thrift_proxy/binary_protocol_impl.h"
+#include "source/extensions/filters/network/thrift_proxy/framed_transport_impl.h"
+#include "source/extensions/filters/network/thrift_proxy/router/upstream_multiplexer.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/tcp/mocks.h"
+#include "test/test_common/printers.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Ref;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace ThriftProxy {
+namespace Router {
+namespace {
+
+class TestPoolCallbacks : public Tcp::ConnectionPool::Callbacks {
+public:
+  // Tcp::ConnectionPool::Callbacks
+  void onPoolFailure(ConnectionPool::PoolFailureReason reason, absl::string_view,
+                     Upstream::HostDescriptionConstSharedPtr) override {
+    failure_ = reason;
+  }
+  void onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn_data,
+                   Upstream::HostDescriptionConstSharedPtr) override {
+    conn_data_ = std::move(conn_data);
+    conn_data_->addUpstreamCallbacks(upstream_callbacks_);
+  }
+
+  int32_t sequenceId() {
+    return conn_data_->connectionStateTyped<ThriftConnectionState>()->nextSequenceId();
+  }
+
+  absl::optional<ConnectionPool::PoolFailureReason> failure_;
+  Tcp::ConnectionPool::ConnectionDataPtr conn_data_;
+  NiceMock<Tcp::ConnectionPool::MockUpstreamCallbacks> upstream_callbacks_;
+};
+
+class ThriftUpstreamMultiplexerTest : public testing::Test {
+public:
+  ThriftUpstreamMultiplexerTest() : pool_data_([]() {}, &pool_) {
+    EXPECT_CALL(*pool_.connection_data_, addUpstreamCallbacks(_))
+        .WillRepeatedly(Invoke([&](Tcp::ConnectionPool::UpstreamCallbacks& callbacks) -> void {
+          upstream_callbacks_ = &callbacks;
+        }));
+  }
+
+  Tcp::ConnectionPool::Cancellable* newStream(TestPoolCallbacks& callbacks) {
+    return multiplexer_.newConnection(pool_data_, TransportType::Framed, ProtocolType::Binary,
+                                      callbacks);
+  }
+
+  std::string response(int32_t sequence_id) {
+    MessageMetadata metadata;
+    metadata.setMethodName("method");
+    metadata.setMessageType(MessageType::Reply);
+    metadata.setSequenceId(sequence_id);
+
+    BinaryProtocolImpl protocol;
+    Buffer::OwnedImpl message;
+    protocol.writeMessageBegin(message, metadata);
+    protocol.writeStructBegin(message, "");
+    protocol.writeFieldBegin(message, "", FieldType::Stop, 0);
+    protocol.writeStructEnd(message);
+    protocol.writeMessageEnd(message);
+
+    Buffer::OwnedImpl frame;
+    FramedTransportImpl().encodeFrame(frame, metadata, message);
+    return frame.toString();
+  }
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Tcp::ConnectionPool::MockInstance> pool_;
+  Upstream::TcpPoolData pool_data_;
+  NiceMock<Network::MockClientConnection> connection_;
+  ConnectionMultiplexer multiplexer_{dispatcher_};
+  Tcp::ConnectionPool::UpstreamCallbacks* upstream_callbacks_{};
+};
+
+TEST_F(ThriftUpstreamMultiplexerTest, RequestsShareConnection) {
+  TestPoolCallbacks first;
+  TestPoolCallbacks second;
+
+  EXPECT_CALL(pool_, newConnection(_));
+  EXPECT_NE(nullptr, newStream(first));
+  EXPECT_NE(nullptr, newStream(second));
+  pool_.poolReady(connection_);
+
+  ASSERT_NE(nullptr, first.conn_data_);
+  ASSERT_NE(nullptr, second.conn_data_);
+  EXPECT_EQ(&connection_, &first.conn_data_->connection());
+  EXPECT_EQ(&connection_, &second.conn_data_->connection());
+  EXPECT_EQ(0, first.sequenceId());
+  EXPECT_EQ(1, second.sequenceId());
+
+  // A request started once connected gets the connection at once.
+  TestPoolCallbacks third;
+  EXPECT_EQ(nullptr, newStream(third));
+  ASSERT_NE(nullptr, third.conn_data_);
+  EXPECT_EQ(2, third.sequenceId());
+  third.conn_data_.reset();
+
+  // Responses go to their requests, whatever their order.
+  const std::string first_response = response(0);
+  const std::string second_response = response(1);
+  EXPECT_CALL(second.upstream_callbacks_, onUpstreamData(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> void {
+        EXPECT_EQ(second_response, data.toString());
+      }));
+  EXPECT_CALL(first.upstream_callbacks_, onUpstreamData(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> void {
+        EXPECT_EQ(first_response, data.toString());
+      }));
+  Buffer::OwnedImpl data(second_response + first_response.substr(0, 10));
+  upstream_callbacks_->onUpstreamData(data, false);
+  Buffer::OwnedImpl rest(first_response.substr(10));
+  upstream_callbacks_->onUpstreamData(rest, false);
+
+  // The connection goes back to the pool with its last request.
+  first.conn_data_.reset();
+  EXPECT_CALL(pool_, released(Ref(connection_)));
+  second.conn_data_.reset();
+}
+
+TEST_F(ThriftUpstreamMultiplexerTest, DropsResponsesOfReleasedRequests) {
+  TestPoolCallbacks callbacks;
+  newStream(callbacks);
+  pool_.poolReady(connection_);
+
+  auto* stream = static_cast<MultiplexedStream*>(callbacks.conn_data_.get());
+  stream->onRequestSent();
+  EXPECT_CALL(pool_, released(_)).Times(0);
+  callbacks.conn_data_.reset();
+
+  // The connection is released once the response of the request is read.
+  EXPECT_CALL(callbacks.upstream_callbacks_, onUpstreamData(_, _)).Times(0);
+  EXPECT_CALL(pool_, released(Ref(connection_)));
+  Buffer::OwnedImpl data(response(0));
+  upstream_callbacks_->onUpstreamData(data, false);
+}
+
+TEST_F(ThriftUpstreamMultiplexerTest, DropsResponsesWithUnknownSequenceId) {
+  TestPoolCallbacks callbacks;
+  newStream(callbacks);
+  pool_.poolReady(connection_);
+
+  EXPECT_CALL(callbacks.upstream_callbacks_, onUpstreamData(_, _)).Times(0);
+  Buffer::OwnedImpl data(response(5));
+  upstream_callbacks_->onUpstreamData(data, false);
+}
+
+TEST_F(ThriftUpstreamMultiplexerTest, PoolFailure) {
+  TestPoolCallbacks first;
+  TestPoolCallbacks second;
+  newStream(first);
+  newStream(second);
+
+  pool_.poolFailure(ConnectionPool::PoolFailureReason::RemoteConnectionFailure);
+  EXPECT_EQ(ConnectionPool::PoolFailureReason::RemoteConnectionFailure, first.failure_);
+  EXPECT_EQ(ConnectionPool::PoolFailureReason::RemoteConnectionFailure, second.failure_);
+
+  // The next request gets a new connection.
+  TestPoolCallbacks third;
+  EXPECT_CALL(pool_, newConnection(_));
+  EXPECT_NE(nullptr, newStream(third));
+}
+
+TEST_F(ThriftUpstreamMultiplexerTest, CancelPendingRequest) {
+  TestPoolCallbacks first;
+  TestPoolCallbacks second;
+  newStream(first)->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+  newStream(second);
+
+  pool_.poolReady(connection_);
+  EXPECT_EQ(nullptr, first.conn_data_);
+  ASSERT_NE(nullptr, second.conn_data_);
+  EXPECT_EQ(0, second.sequenceId());
+}
+
+TEST_F(ThriftUpstreamMultiplexerTest, ConnectionClose) {
+  TestPoolCallbacks first;
+  TestPoolCallbacks second;
+  newStream(first);
+  newStream(second);
+  pool_.poolReady(connection_);
+
+  EXPECT_CALL(first.upstream_callbacks_, onEvent(Network::ConnectionEvent::RemoteClose))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { first.conn_data_.reset(); }));
+  EXPECT_CALL(second.upstream_callbacks_, onEvent(Network::ConnectionEvent::RemoteClose))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { second.conn_data_.reset(); }));
+  EXPECT_CALL(pool_, released(Ref(connection_)));
+  upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
+}
+
+TEST_F(ThriftUpstreamMultiplexerTest, InvalidResponseClosesConnection) {
+  TestPoolCallbacks callbacks;
+  newStream(callbacks);
+  pool_.poolReady(connection_);
+
+  EXPECT_CALL(connection_, close(Network::ConnectionCloseType::NoFlush));
+  Buffer::OwnedImpl data(std::string("\x00\x00\x00\x02\x00\x00", 6));
+  upstream_callbacks_->onUpstreamData(data, false);
+}
+
+TEST_F(ThriftUpstreamMultiplexerTest, Supports) {
+  BinaryProtocolImpl protocol;
+  EXPECT_TRUE(ConnectionMultiplexer::supports(TransportType::Framed, protocol));
+  EXPECT_TRUE(ConnectionMultiplexer::supports(TransportType::Header, protocol));
+  EXPECT_FALSE(ConnectionMultiplexer::supports(TransportType::Unframed, protocol));
+}
+
+} // namespace
+} // namespace Router
+} // namespace ThriftProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,143 @@
+// Measures the queries answered by the DNS filter, for the A records of a configured domain and for
+// a name answered from the cache of the external resolutions.
+
+#include <string>
+
+#include "envoy/extensions/filters/udp/dns_filter/v3alpha/dns_filter.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/utility.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/udp/dns_filter/dns_filter.h"
+#include "source/extensions/filters/udp/dns_filter/dns_filter_constants.h"
+
+#include "test/mocks/common.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/server/listener_factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "dns_filter_test_utils.h"
+
+using testing::_;
+using testing::DoAll;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Extensions {
+namespace UdpFilters {
+namespace DnsFilter {
+namespace {
+
+const std::string config_yaml = R"EOF(
+stat_prefix: "my_prefix"
+client_config:
+  resolver_timeout: 1s
+  dns_resolution_config:
+    resolvers:
+    - socket_address:
+        address: "1.1.1.1"
+        port_value: 53
+  max_pending_lookups: 256
+  max_cached_lookups: 1024
+server_config:
+  inline_dns_table:
+    virtual_domains:
+    - name: "www.foo1.com"
+      endpoint:
+        address_list:
+          address:
+          - "10.0.0.1"
+          - "10.0.0.2"
+          - "10.0.0.3"
+          - "10.0.0.4"
+)EOF";
+
+class DnsFilterBenchmark {
+public:
+  DnsFilterBenchmark() : api_(Api::createApiForTest()) {
+    ON_CALL(listener_factory_, scope()).WillByDefault(ReturnRef(stats_store_));
+    ON_CALL(listener_factory_, api()).WillByDefault(ReturnRef(*api_));
+    ON_CALL(listener_factory_, random()).WillByDefault(ReturnRef(random_));
+    ON_CALL(dispatcher_, createDnsResolver(_, _)).WillByDefault(Return(resolver_));
+    ON_CALL(callbacks_.udp_listener_, dispatcher()).WillByDefault(ReturnRef(dispatcher_));
+    ON_CALL(callbacks_.udp_listener_, send(_))
+        .WillByDefault(Invoke([](const Network::UdpSendData& send_data) {
+          Api::IoCallUint64Result result = Api::ioCallUint64ResultNoError();
+          result.rc_ = send_data.buffer_.length();
+          send_data.buffer_.drain(send_data.buffer_.length());
+          return result;
+        }));
+
+    envoy::extensions::filters::udp::dns_filter::v3alpha::DnsFilterConfig config;
+    TestUtility::loadFromYamlAndValidate(config_yaml, config);
+    filter_ = std::make_unique<DnsFilter>(
+        callbacks_, std::make_shared<DnsFilterEnvoyConfig>(listener_factory_, config));
+  }
+
+  void sendQuery(const std::string& query) {
+    Network::UdpRecvData data{};
+    data.addresses_.peer_ = peer_address_;
+    data.addresses_.local_ = listener_address_;
+    data.buffer_ = std::make_unique<Buffer::OwnedImpl>(query);
+    filter_->onData(data);
+  }
+
+  Api::ApiPtr api_;
+  Stats::IsolatedStoreImpl stats_store_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  std::shared_ptr<NiceMock<Network::MockDnsResolver>> resolver_{
+      std::make_shared<NiceMock<Network::MockDnsResolver>>()};
+  NiceMock<Server::Configuration::MockListenerFactoryContext> listener_factory_;
+  NiceMock<Network::MockUdpReadFilterCallbacks> callbacks_;
+  const Network::Address::InstanceConstSharedPtr listener_address_{
+      Network::Utility::parseInternetAddressAndPort("127.0.2.1:5353")};
+  const Network::Address::InstanceConstSharedPtr peer_address_{
+      Network::Utility::parseInternetAddressAndPort("10.0.0.1:1000")};
+  std::unique_ptr<DnsFilter> filter_;
+};
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ConfiguredDomainQuery(::benchmark::State& state) {
+  DnsFilterBenchmark benchmark;
+  const std::string query =
+      Utils::buildQueryForDomain("www.foo1.com", DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN, 1);
+
+  for (auto _ : state) { // NOLINT
+    benchmark.sendQuery(query);
+  }
+}
+BENCHMARK(BM_ConfiguredDomainQuery);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_CachedExternalQuery(::benchmark::State& state) {
+  DnsFilterBenchmark benchmark;
+  const std::string query =
+      Utils::buildQueryForDomain("www.foobaz.com", DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN, 1);
+
+  // The first query is resolved externally, and its answers are cached for the next ones.
+  Network::DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*benchmark.resolver_, resolve("www.foobaz.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&benchmark.resolver_->active_query_)));
+  benchmark.sendQuery(query);
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Success,
+             TestUtility::makeDnsResponse({"130.207.244.251", "130.207.244.252"},
+                                          std::chrono::seconds(3600)));
+
+  for (auto _ : state) { // NOLINT
+    benchmark.sendQuery(query);
+  }
+}
+BENCHMARK(BM_CachedExternalQuery);
+
+} // namespace
+} // namespace DnsFilter
+} // namespace UdpFilters
+} // namespace Extensions
+} // namespace Envoy
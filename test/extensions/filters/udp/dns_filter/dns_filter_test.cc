@@ -199,6 +199,28 @@ server_config:
             - "10.0.0.1"
 )EOF";
 
+  const std::string forward_query_cached_config = R"EOF(
+stat_prefix: "my_prefix"
+client_config:
+  resolver_timeout: 1s
+  dns_resolution_config:
+    resolvers:
+    - socket_address:
+        address: "1.1.1.1"
+        port_value: 53
+  max_pending_lookups: 1
+  max_cached_lookups: 1
+server_config:
+  inline_dns_table:
+    external_retry_count: 0
+    virtual_domains:
+      - name: "www.foo1.com"
+        endpoint:
+          address_list:
+            address:
+            - "10.0.0.1"
+)EOF";
+
   const std::string external_dns_table_config = R"EOF(
 stat_prefix: "my_prefix"
 client_config:
@@ -860,6 +882,61 @@ TEST_F(DnsFilterTest, ExternalResolutionReturnMultipleAddresses) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
 }
 
+TEST_F(DnsFilterTest, ExternalResolutionCachedAnswers) {
+  InSequence s;
+
+  auto timeout_timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*timeout_timer, enableTimer(_, _));
+
+  const std::list<std::string> expected_address{"130.207.244.251", "130.207.244.252"};
+  const std::string domain("www.foobaz.com");
+  setup(forward_query_cached_config);
+
+  Network::DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*resolver_, resolve(domain, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+
+  const std::string query =
+      Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN);
+  ASSERT_FALSE(query.empty());
+  sendQueryFromClient("10.0.0.1:1000", query);
+
+  EXPECT_CALL(*timeout_timer, disableTimer());
+
+  // The answers are cached for the lowest TTL of the resolved addresses.
+  auto response = TestUtility::makeDnsResponse({"130.207.244.251"}, std::chrono::seconds(60));
+  response.splice(response.end(), TestUtility::makeDnsResponse({"130.207.244.252"},
+                                                                std::chrono::seconds(30)));
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Success, std::move(response));
+  EXPECT_EQ(0, config_->stats().externally_resolved_cached_queries_.value());
+
+  // The next queries are answered without the resolver until the answers expire.
+  simTime().advanceTimeWait(std::chrono::seconds(29));
+  sendQueryFromClient("10.0.0.1:1000", query);
+
+  query_ctx_ = response_parser_->createQueryContext(udp_response_, counters_);
+  EXPECT_TRUE(query_ctx_->parse_status_);
+  EXPECT_EQ(DNS_RESPONSE_CODE_NO_ERROR, query_ctx_->getQueryResponseCode());
+  EXPECT_EQ(expected_address.size(), query_ctx_->answers_.size());
+  for (const auto& answer : query_ctx_->answers_) {
+    EXPECT_EQ(answer.first, domain);
+    Utils::verifyAddress(expected_address, answer.second);
+  }
+  EXPECT_EQ(1, config_->stats().externally_resolved_cached_queries_.value());
+  EXPECT_EQ(2, config_->stats().external_a_record_queries_.value());
+  EXPECT_EQ(2 * expected_address.size(), config_->stats().external_a_record_answers_.value());
+
+  // Once expired, the name is resolved again.
+  simTime().advanceTimeWait(std::chrono::seconds(1));
+  auto second_timeout_timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*second_timeout_timer, enableTimer(_, _));
+  EXPECT_CALL(*resolver_, resolve(domain, _, _)).WillOnce(Return(&resolver_->active_query_));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  EXPECT_EQ(1, config_->stats().externally_resolved_cached_queries_.value());
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+}
+
 TEST_F(DnsFilterTest, ExternalResolutionReturnNoAddresses) {
   InSequence s;
 
@@ -0,0 +1,120 @@
+// Measures the forwarding of downstream datagrams to the upstream by the UDP proxy, for a number of
+// downstream peers each having a session. The upstream sockets are mocks, so that the lookup and
+// accounting of the sessions are measured rather than the kernel.
+
+#include <vector>
+
+#include "envoy/extensions/filters/udp/udp_proxy/v3/udp_proxy.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/utility.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/udp/udp_proxy/udp_proxy_filter.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/network/socket.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/mocks/upstream/host.h"
+#include "test/mocks/upstream/thread_local_cluster.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "fmt/format.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace UdpFilters {
+namespace UdpProxy {
+namespace {
+
+class BenchmarkUdpProxyFilter : public UdpProxyFilter {
+public:
+  using UdpProxyFilter::UdpProxyFilter;
+
+  // UdpProxyFilter
+  Network::SocketPtr createSocket(const Upstream::HostConstSharedPtr&) override {
+    auto socket = std::make_unique<NiceMock<Network::MockSocket>>();
+    EXPECT_CALL(*socket->io_handle_, createFileEvent_(_, _, _, _));
+    EXPECT_CALL(*socket->io_handle_, sendmsg(_, _, _, _, _))
+        .WillRepeatedly(Invoke([](const Buffer::RawSlice* slices, uint64_t num_slice, int,
+                                  const Network::Address::Ip*, const Network::Address::Instance&) {
+          Api::IoCallUint64Result result = Api::ioCallUint64ResultNoError();
+          for (uint64_t i = 0; i < num_slice; i++) {
+            result.rc_ += slices[i].len_;
+          }
+          return result;
+        }));
+    return socket;
+  }
+};
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ForwardDownstreamDatagrams(benchmark::State& state) {
+  const uint32_t sessions = state.range(0);
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+
+  NiceMock<Upstream::MockClusterManager> cluster_manager;
+  cluster_manager.initializeThreadLocalClusters({"fake_cluster"});
+  cluster_manager.thread_local_cluster_.cluster_.info_->resetResourceManager(sessions, 0, 0, 0, 0);
+  const Network::Address::InstanceConstSharedPtr upstream_address =
+      Network::Utility::parseInternetAddressAndPort("20.0.0.1:443");
+  EXPECT_CALL(*cluster_manager.thread_local_cluster_.lb_.host_, address())
+      .WillRepeatedly(Return(upstream_address));
+  EXPECT_CALL(*cluster_manager.thread_local_cluster_.lb_.host_, health())
+      .WillRepeatedly(Return(Upstream::Host::Health::Healthy));
+
+  NiceMock<Network::MockUdpReadFilterCallbacks> callbacks;
+  ON_CALL(callbacks.udp_listener_, dispatcher()).WillByDefault(ReturnRef(*dispatcher));
+
+  envoy::extensions::filters::udp::udp_proxy::v3::UdpProxyConfig proto_config;
+  TestUtility::loadFromYaml(R"EOF(
+stat_prefix: foo
+cluster: fake_cluster
+)EOF",
+                            proto_config);
+  Stats::IsolatedStoreImpl stats_store;
+  auto config = std::make_shared<UdpProxyFilterConfig>(cluster_manager, api->timeSource(),
+                                                       stats_store, proto_config);
+  BenchmarkUdpProxyFilter filter(callbacks, config);
+
+  const Network::Address::InstanceConstSharedPtr local_address =
+      Network::Utility::parseInternetAddressAndPort("10.255.0.1:53");
+  std::vector<Network::Address::InstanceConstSharedPtr> peer_addresses;
+  for (uint32_t i = 0; i < sessions; i++) {
+    peer_addresses.push_back(Network::Utility::parseInternetAddressAndPort(
+        fmt::format("10.0.{}.{}:1000", i / 256, i % 256)));
+  }
+
+  Network::UdpRecvData data;
+  data.buffer_ = std::make_unique<Buffer::OwnedImpl>(std::string(64, 'a'));
+  auto forward = [&](const Network::Address::InstanceConstSharedPtr& peer_address) {
+    // The addresses are moved into the session when one is created.
+    data.addresses_.local_ = local_address;
+    data.addresses_.peer_ = peer_address;
+    filter.onData(data);
+  };
+  // The sessions are created before measuring.
+  for (const auto& peer_address : peer_addresses) {
+    forward(peer_address);
+  }
+
+  size_t next = 0;
+  for (auto _ : state) { // NOLINT
+    forward(peer_addresses[next]);
+    next = next + 1 == sessions ? 0 : next + 1;
+  }
+}
+BENCHMARK(BM_ForwardDownstreamDatagrams)->Arg(1)->Arg(1 << 10)->Arg(1 << 16);
+
+} // namespace
+} // namespace UdpProxy
+} // namespace UdpFilters
+} // namespace Extensions
+} // namespace Envoy
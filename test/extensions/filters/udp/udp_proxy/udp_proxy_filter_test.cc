@@ -25,6 +25,7 @@ using testing::InSequence;
 using testing::InvokeWithoutArgs;
 using testing::Return;
 using testing::ReturnNew;
+using testing::ReturnPointee;
 using testing::SaveArg;
 
 namespace Envoy {
@@ -72,7 +73,6 @@ public:
 
     void expectWriteToUpstream(const std::string& data, int sys_errno = 0,
                                const Network::Address::Ip* local_ip = nullptr) {
-      EXPECT_CALL(*idle_timer_, enableTimer(parent_.config_->sessionTimeout(), nullptr));
       EXPECT_CALL(*socket_->io_handle_, sendmsg(_, 1, 0, _, _))
           .WillOnce(Invoke(
               [this, data, local_ip, sys_errno](
@@ -99,8 +99,6 @@ public:
 
     void recvDataFromUpstream(const std::string& data, int recv_sys_errno = 0,
                               int send_sys_errno = 0) {
-      EXPECT_CALL(*idle_timer_, enableTimer(parent_.config_->sessionTimeout(), nullptr));
-
       if (parent_.expect_gro_) {
         EXPECT_CALL(*socket_->io_handle_, supportsUdpGro());
       }
@@ -169,6 +167,9 @@ public:
     ON_CALL(os_sys_calls_, supportsIpTransparent()).WillByDefault(Return(true));
     EXPECT_CALL(os_sys_calls_, supportsUdpGro()).Times(AtLeast(0)).WillRepeatedly(Return(true));
     EXPECT_CALL(callbacks_, udpListener()).Times(AtLeast(0));
+    EXPECT_CALL(callbacks_.udp_listener_.dispatcher_, approximateMonotonicTime())
+        .Times(AtLeast(0))
+        .WillRepeatedly(ReturnPointee(&monotonic_time_));
     EXPECT_CALL(*cluster_manager_.thread_local_cluster_.lb_.host_, address())
         .WillRepeatedly(Return(upstream_address_));
     EXPECT_CALL(*cluster_manager_.thread_local_cluster_.lb_.host_, health())
@@ -213,12 +214,15 @@ public:
         *new_session.socket_->io_handle_,
         createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
         .WillOnce(SaveArg<1>(&new_session.file_event_cb_));
+    EXPECT_CALL(*new_session.idle_timer_, enableTimer(config_->sessionTimeout(), nullptr));
     // Internal Buffer is Empty, flush will be a no-op
     ON_CALL(callbacks_.udp_listener_, flush())
         .WillByDefault(
             InvokeWithoutArgs([]() -> Api::IoCallUint64Result { return makeNoError(0); }));
   }
 
+  void advanceTime(std::chrono::milliseconds duration) { monotonic_time_ += duration; }
+
   std::shared_ptr<NiceMock<Upstream::MockHost>>
   createHost(const Network::Address::InstanceConstSharedPtr& host_address) {
     auto host = std::make_shared<NiceMock<Upstream::MockHost>>();
@@ -288,6 +292,7 @@ use_original_src_ip: true
   std::unique_ptr<TestUdpProxyFilter> filter_;
   std::vector<TestSession> test_sessions_;
   bool expect_gro_{};
+  MonotonicTime monotonic_time_;
   const Network::Address::InstanceConstSharedPtr upstream_address_;
   const Network::Address::InstanceConstSharedPtr peer_address_;
   const std::vector<Network::SocketOptionName> transparent_options_{ENVOY_SOCKET_IP_TRANSPARENT,
@@ -386,6 +391,7 @@ cluster: fake_cluster
   EXPECT_EQ(1, config_->stats().downstream_sess_total_.value());
   EXPECT_EQ(1, config_->stats().downstream_sess_active_.value());
 
+  advanceTime(config_->sessionTimeout());
   test_sessions_[0].idle_timer_->invokeCallback();
   EXPECT_EQ(1, config_->stats().downstream_sess_total_.value());
   EXPECT_EQ(0, config_->stats().downstream_sess_active_.value());
@@ -397,6 +403,40 @@ cluster: fake_cluster
   EXPECT_EQ(1, config_->stats().downstream_sess_active_.value());
 }
 
+// Activity during the idle timeout delays the timeout without touching the idle timer until it
+// fires.
+TEST_F(UdpProxyFilterTest, IdleTimeoutAfterActivity) {
+  InSequence s;
+
+  setup(R"EOF(
+stat_prefix: foo
+cluster: fake_cluster
+idle_timeout: 10s
+  )EOF");
+
+  expectSessionCreate(upstream_address_);
+  test_sessions_[0].expectWriteToUpstream("hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+
+  advanceTime(std::chrono::seconds(4));
+  test_sessions_[0].expectWriteToUpstream("hello2");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello2");
+  advanceTime(std::chrono::seconds(3));
+  test_sessions_[0].recvDataFromUpstream("world");
+
+  // The timer is rearmed for the rest of the timeout since the last datagram.
+  advanceTime(std::chrono::seconds(3));
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(std::chrono::milliseconds(7000), _));
+  test_sessions_[0].idle_timer_->invokeCallback();
+  EXPECT_EQ(0, config_->stats().idle_timeout_.value());
+  EXPECT_EQ(1, config_->stats().downstream_sess_active_.value());
+
+  advanceTime(std::chrono::seconds(7));
+  test_sessions_[0].idle_timer_->invokeCallback();
+  EXPECT_EQ(1, config_->stats().idle_timeout_.value());
+  EXPECT_EQ(0, config_->stats().downstream_sess_active_.value());
+}
+
 // Verify downstream send and receive error handling.
 TEST_F(UdpProxyFilterTest, SendReceiveErrorHandling) {
   InSequence s;
@@ -539,6 +579,7 @@ cluster: fake_cluster
   EXPECT_EQ(1, config_->stats().downstream_sess_active_.value());
 
   // Timing out the 1st session should allow us to create another.
+  advanceTime(config_->sessionTimeout());
   test_sessions_[0].idle_timer_->invokeCallback();
   EXPECT_EQ(1, config_->stats().downstream_sess_total_.value());
   EXPECT_EQ(0, config_->stats().downstream_sess_active_.value());
@@ -180,6 +180,32 @@ TEST_F(IoHandleImplTest, ReadContent) {
   ASSERT_EQ(0, io_handle_->getWriteBuffer()->length());
 }
 
+// Test that read moves whole slices rather than copying the part of a slice.
+TEST_F(IoHandleImplTest, ReadStopsAtSliceEnd) {
+  Buffer::OwnedImpl buf_to_write;
+  buf_to_write.appendSliceForTest(std::string(4 * FRAGMENT_SIZE, 'a'));
+  buf_to_write.appendSliceForTest(std::string(4 * FRAGMENT_SIZE, 'b'));
+  io_handle_peer_->write(buf_to_write);
+  ASSERT_EQ(0, buf_to_write.length());
+
+  Buffer::OwnedImpl buf;
+  auto result = io_handle_->read(buf, 6 * FRAGMENT_SIZE);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(4 * FRAGMENT_SIZE, result.rc_);
+  EXPECT_EQ(std::string(4 * FRAGMENT_SIZE, 'a'), buf.toString());
+  result = io_handle_->read(buf, 6 * FRAGMENT_SIZE);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(4 * FRAGMENT_SIZE, result.rc_);
+  EXPECT_EQ(2, buf.getRawSlices().size());
+
+  // A slice larger than the limit is still split.
+  buf_to_write.add(std::string(4 * FRAGMENT_SIZE, 'c'));
+  io_handle_peer_->write(buf_to_write);
+  result = io_handle_->read(buf, FRAGMENT_SIZE);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(FRAGMENT_SIZE, result.rc_);
+}
+
 // Test read throttling on watermark buffer.
 TEST_F(IoHandleImplTest, ReadThrottling) {
   {
@@ -29,6 +29,23 @@ TEST(UUIDRequestIDExtensionTest, SetRequestID) {
   EXPECT_EQ("second-request-id", request_headers.get_(Http::Headers::get().RequestId));
 }
 
+TEST(UUIDRequestIDExtensionTest, SetNonCryptographicRequestID) {
+  testing::StrictMock<Random::MockRandomGenerator> random;
+  envoy::extensions::request_id::uuid::v3::UuidRequestIdConfig config;
+  config.set_use_non_cryptographic_random(true);
+  UUIDRequestIDExtension uuid_utils(config, random);
+  Http::TestRequestHeaderMapImpl request_headers;
+
+  EXPECT_CALL(random, uuid()).Times(0);
+  uuid_utils.set(request_headers, true);
+  const std::string first_request_id(request_headers.getRequestIdValue());
+  EXPECT_EQ(Random::RandomGeneratorImpl::UUID_LENGTH, first_request_id.length());
+  EXPECT_EQ(Tracing::Reason::NotTraceable, uuid_utils.getTraceReason(request_headers));
+
+  uuid_utils.set(request_headers, true);
+  EXPECT_NE(first_request_id, request_headers.getRequestIdValue());
+}
+
 TEST(UUIDRequestIDExtensionTest, EnsureRequestID) {
   testing::StrictMock<Random::MockRandomGenerator> random;
   UUIDRequestIDExtension uuid_utils(envoy::extensions::request_id::uuid::v3::UuidRequestIdConfig(),
@@ -0,0 +1,192 @@
+#include <string>
+
+#include "envoy/extensions/resource_monitors/cgroup/v3/cgroup.pb.h"
+
+#include "source/extensions/resource_monitors/cgroup/cgroup_monitor.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMonitor {
+namespace {
+
+using envoy::extensions::resource_monitors::cgroup::v3::CgroupConfig;
+
+class ResourcePressure : public Server::ResourceMonitor::Callbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+    error_.reset();
+  }
+
+  void onFailure(const EnvoyException& error) override {
+    pressure_.reset();
+    error_ = error;
+  }
+
+  bool hasPressure() const { return pressure_.has_value(); }
+  bool hasError() const { return error_.has_value(); }
+  double pressure() const { return *pressure_; }
+
+private:
+  absl::optional<double> pressure_;
+  absl::optional<EnvoyException> error_;
+};
+
+class CgroupMonitorTest : public testing::Test {
+protected:
+  CgroupMonitorTest()
+      : api_(Api::createApiForTest()), cgroup_path_(TestEnvironment::temporaryPath("cgroup")) {
+    TestEnvironment::removePath(cgroup_path_);
+    TestEnvironment::createPath(cgroup_path_);
+  }
+
+  ~CgroupMonitorTest() override { TestEnvironment::removePath(cgroup_path_); }
+
+  void writeFile(const std::string& name, const std::string& contents) {
+    TestEnvironment::writeStringToFileForTest(absl::StrCat(cgroup_path_, "/", name), contents,
+                                              true);
+  }
+
+  void useCgroupV2() { writeFile("cgroup.controllers", "cpu io memory pids\n"); }
+
+  std::unique_ptr<CgroupMonitor> createMonitor(CgroupConfig::Resource resource) {
+    config_.set_cgroup_path(cgroup_path_);
+    config_.set_resource(resource);
+    return std::make_unique<CgroupMonitor>(config_, api_->fileSystem());
+  }
+
+  ResourcePressure update(CgroupMonitor& monitor) {
+    ResourcePressure pressure;
+    monitor.updateResourceUsage(pressure);
+    return pressure;
+  }
+
+  Api::ApiPtr api_;
+  const std::string cgroup_path_;
+  CgroupConfig config_;
+};
+
+TEST_F(CgroupMonitorTest, MemoryV2) {
+  useCgroupV2();
+  writeFile("memory.current", "500\n");
+  writeFile("memory.max", "1000\n");
+  writeFile("memory.stat", "anon 200\nfile 300\nactive_file 100\ninactive_file 200\n");
+  auto monitor = createMonitor(CgroupConfig::MEMORY);
+  EXPECT_DOUBLE_EQ(0.5, update(*monitor).pressure());
+
+  // Usage changes are seen on the next update.
+  writeFile("memory.current", "900\n");
+  EXPECT_DOUBLE_EQ(0.9, update(*monitor).pressure());
+
+  // The configured maximum applies when it is lower than the limit of the cgroup.
+  config_.set_max_memory_bytes(1800);
+  EXPECT_DOUBLE_EQ(0.9, update(*createMonitor(CgroupConfig::MEMORY)).pressure());
+  config_.set_max_memory_bytes(900);
+  EXPECT_DOUBLE_EQ(1.0, update(*createMonitor(CgroupConfig::MEMORY)).pressure());
+}
+
+TEST_F(CgroupMonitorTest, MemoryV2NoLimit) {
+  useCgroupV2();
+  writeFile("memory.current", "500\n");
+  writeFile("memory.max", "max\n");
+  EXPECT_TRUE(update(*createMonitor(CgroupConfig::MEMORY)).hasError());
+
+  config_.set_max_memory_bytes(2000);
+  EXPECT_DOUBLE_EQ(0.25, update(*createMonitor(CgroupConfig::MEMORY)).pressure());
+}
+
+TEST_F(CgroupMonitorTest, MemoryV2ExcludeInactiveFile) {
+  useCgroupV2();
+  writeFile("memory.current", "500\n");
+  writeFile("memory.max", "1000\n");
+  writeFile("memory.stat", "anon 200\nfile 300\nactive_file 100\ninactive_file 200\n");
+  config_.set_exclude_inactive_file(true);
+  EXPECT_DOUBLE_EQ(0.3, update(*createMonitor(CgroupConfig::MEMORY)).pressure());
+
+  writeFile("memory.stat", "anon 200\n");
+  EXPECT_TRUE(update(*createMonitor(CgroupConfig::MEMORY)).hasError());
+}
+
+TEST_F(CgroupMonitorTest, MemoryV1) {
+  TestEnvironment::createPath(absl::StrCat(cgroup_path_, "/memory"));
+  writeFile("memory/memory.usage_in_bytes", "600\n");
+  writeFile("memory/memory.limit_in_bytes", "1000\n");
+  writeFile("memory/memory.stat", "inactive_file 0\ntotal_inactive_file 100\n");
+  EXPECT_DOUBLE_EQ(0.6, update(*createMonitor(CgroupConfig::MEMORY)).pressure());
+
+  config_.set_exclude_inactive_file(true);
+  EXPECT_DOUBLE_EQ(0.5, update(*createMonitor(CgroupConfig::MEMORY)).pressure());
+
+  // cgroup v1 has no limit when it reports the largest page aligned value.
+  writeFile("memory/memory.limit_in_bytes", "9223372036854771712\n");
+  EXPECT_TRUE(update(*createMonitor(CgroupConfig::MEMORY)).hasError());
+  config_.set_max_memory_bytes(1000);
+  EXPECT_DOUBLE_EQ(0.5, update(*createMonitor(CgroupConfig::MEMORY)).pressure());
+}
+
+TEST_F(CgroupMonitorTest, MemoryMissingFiles) {
+  useCgroupV2();
+  auto monitor = createMonitor(CgroupConfig::MEMORY);
+  EXPECT_TRUE(update(*monitor).hasError());
+
+  writeFile("memory.current", "garbage\n");
+  writeFile("memory.max", "1000\n");
+  EXPECT_TRUE(update(*monitor).hasError());
+}
+
+TEST_F(CgroupMonitorTest, CpuThrottling) {
+  useCgroupV2();
+  writeFile("cpu.stat", "usage_usec 100\nnr_periods 100\nnr_throttled 50\nthrottled_usec 10\n");
+  auto monitor = createMonitor(CgroupConfig::CPU_THROTTLING);
+
+  // The first update has no previous periods to compare with.
+  EXPECT_DOUBLE_EQ(0, update(*monitor).pressure());
+
+  writeFile("cpu.stat", "usage_usec 200\nnr_periods 110\nnr_throttled 54\nthrottled_usec 20\n");
+  EXPECT_DOUBLE_EQ(0.4, update(*monitor).pressure());
+
+  // No periods, as when the cgroup is idle.
+  EXPECT_DOUBLE_EQ(0, update(*monitor).pressure());
+
+  writeFile("cpu.stat", "usage_usec 200\n");
+  EXPECT_TRUE(update(*monitor).hasError());
+}
+
+TEST_F(CgroupMonitorTest, CpuThrottlingV1) {
+  TestEnvironment::createPath(absl::StrCat(cgroup_path_, "/cpu"));
+  writeFile("cpu/cpu.stat", "nr_periods 10\nnr_throttled 0\nthrottled_time 0\n");
+  auto monitor = createMonitor(CgroupConfig::CPU_THROTTLING);
+  EXPECT_DOUBLE_EQ(0, update(*monitor).pressure());
+  writeFile("cpu/cpu.stat", "nr_periods 20\nnr_throttled 10\nthrottled_time 1000\n");
+  EXPECT_DOUBLE_EQ(1.0, update(*monitor).pressure());
+}
+
+TEST_F(CgroupMonitorTest, StallPressure) {
+  useCgroupV2();
+  writeFile("memory.pressure", "some avg10=12.50 avg60=1.00 avg300=0.00 total=100\n"
+                               "full avg10=2.00 avg60=0.00 avg300=0.00 total=10\n");
+  writeFile("cpu.pressure", "some avg10=75.00 avg60=10.00 avg300=1.00 total=1000\n");
+  writeFile("io.pressure", "full avg10=50.00 avg60=10.00 avg300=1.00 total=1000\n");
+  EXPECT_DOUBLE_EQ(0.125, update(*createMonitor(CgroupConfig::MEMORY_PRESSURE)).pressure());
+  EXPECT_DOUBLE_EQ(0.75, update(*createMonitor(CgroupConfig::CPU_PRESSURE)).pressure());
+  EXPECT_TRUE(update(*createMonitor(CgroupConfig::IO_PRESSURE)).hasError());
+}
+
+TEST_F(CgroupMonitorTest, StallPressureRequiresV2) {
+  EXPECT_THROW_WITH_REGEX(createMonitor(CgroupConfig::MEMORY_PRESSURE), EnvoyException,
+                          "requires cgroup v2");
+}
+
+} // namespace
+} // namespace CgroupMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
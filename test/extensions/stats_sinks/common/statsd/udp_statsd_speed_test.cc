@@ -0,0 +1,123 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures how the UDP statsd sink renders and packs the counters of a flush, the datagrams being
+// dropped by the writer.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/metrics/v3/stats.pb.h"
+
+#include "source/common/stats/allocator_impl.h"
+#include "source/common/stats/symbol_table_impl.h"
+#include "source/common/stats/tag_producer_impl.h"
+#include "source/common/stats/thread_local_store.h"
+#include "source/extensions/stat_sinks/common/statsd/statsd.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/thread_local/mocks.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace Common {
+namespace Statsd {
+namespace {
+
+class NullWriter : public UdpStatsdSink::Writer {
+public:
+  void write(const std::string&) override { datagrams_++; }
+  void writeDatagrams(const std::vector<std::string>& messages) override {
+    datagrams_ += messages.size();
+  }
+
+  uint64_t datagrams_{};
+};
+
+class TestSnapshot : public Stats::MetricSnapshot {
+public:
+  explicit TestSnapshot(Stats::Store& store) : counter_ptrs_(store.counters()) {
+    for (const auto& counter : counter_ptrs_) {
+      // Only the used stats are flushed.
+      counter->inc();
+      counters_.push_back({1, *counter});
+    }
+  }
+
+  // Stats::MetricSnapshot
+  const std::vector<Stats::MetricSnapshot::CounterSnapshot>& counters() override {
+    return counters_;
+  }
+  const std::vector<std::reference_wrapper<const Stats::Gauge>>& gauges() override {
+    return gauges_;
+  }
+  const std::vector<std::reference_wrapper<const Stats::ParentHistogram>>& histograms() override {
+    return histograms_;
+  }
+  const std::vector<std::reference_wrapper<const Stats::TextReadout>>& textReadouts() override {
+    return text_readouts_;
+  }
+  SystemTime snapshotTime() const override { return {}; }
+
+private:
+  const std::vector<Stats::CounterSharedPtr> counter_ptrs_;
+  std::vector<Stats::MetricSnapshot::CounterSnapshot> counters_;
+  std::vector<std::reference_wrapper<const Stats::Gauge>> gauges_;
+  std::vector<std::reference_wrapper<const Stats::ParentHistogram>> histograms_;
+  std::vector<std::reference_wrapper<const Stats::TextReadout>> text_readouts_;
+};
+
+// Flushes about state.range(0) counters of clusters, with their tags if state.range(1) is set,
+// packed into datagrams of at most state.range(2) bytes.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_FlushCounters(::benchmark::State& state) {
+  const int num_stats = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && num_stats > 10000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  Stats::SymbolTableImpl symbol_table;
+  Stats::AllocatorImpl allocator(symbol_table);
+  Stats::ThreadLocalStoreImpl store(allocator);
+  envoy::config::metrics::v3::StatsConfig stats_config;
+  store.setTagProducer(std::make_unique<Stats::TagProducerImpl>(stats_config));
+  // There are about 70 stats per cluster.
+  Stats::TestUtil::forEachSampleStat(num_stats / 70, false, [&store](absl::string_view name) {
+    store.counterFromString(std::string(name));
+  });
+  TestSnapshot snapshot(store);
+
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
+  auto writer = std::make_shared<NullWriter>();
+  UdpStatsdSink sink(tls, writer, state.range(1) != 0, getDefaultPrefix(), state.range(2));
+
+  for (auto _ : state) { // NOLINT
+    sink.flush(snapshot);
+  }
+  state.counters["datagrams_per_flush"] =
+      ::benchmark::Counter(writer->datagrams_ / state.iterations());
+
+  tls.shutdownThread();
+  store.shutdownThreading();
+}
+BENCHMARK(BM_FlushCounters)
+    ->Args({10000, 0, 0})
+    ->Args({10000, 1, 0})
+    ->Args({10000, 1, 1432})
+    ->Args({500000, 0, 0})
+    ->Args({500000, 1, 0})
+    ->Args({500000, 1, 1432})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace Statsd
+} // namespace Common
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -16,6 +16,7 @@
 #include "test/test_common/network_utility.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "spdlog/spdlog.h"
@@ -32,17 +33,29 @@ namespace {
 class MockWriter : public UdpStatsdSink::Writer {
 public:
   MOCK_METHOD(void, write, (const std::string& message));
-  MOCK_METHOD(void, writeBuffer, (Buffer::Instance & buffer));
 
   void delegateBufferFake() {
-    ON_CALL(*this, writeBuffer).WillByDefault([this](Buffer::Instance& buffer) {
-      this->buffer_writes.push_back(buffer.toString());
+    ON_CALL(*this, write).WillByDefault([this](const std::string& message) {
+      this->buffer_writes.push_back(message);
     });
   }
 
   std::vector<std::string> buffer_writes;
 };
 
+// Records the datagrams written, and the batches they are written in.
+class RecordingWriter : public UdpStatsdSink::Writer {
+public:
+  void write(const std::string& message) override { messages_.push_back(message); }
+  void writeDatagrams(const std::vector<std::string>& messages) override {
+    batches_.push_back(messages.size());
+    UdpStatsdSink::Writer::writeDatagrams(messages);
+  }
+
+  std::vector<std::string> messages_;
+  std::vector<size_t> batches_;
+};
+
 // Skipping this test as Datagram sockets are not currently supported by UDS on Windows
 #ifndef WIN32
 // Regression test for https://github.com/envoyproxy/envoy/issues/8911
@@ -174,7 +187,7 @@ TEST(UdpStatsdSinkTest, CheckActualStats) {
   counter.latch_ = 1;
   snapshot.counters_.push_back({1, counter});
 
-  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), writeBuffer(_));
+  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), write(_));
   sink.flush(snapshot);
   EXPECT_EQ(writer_ptr->buffer_writes.size(), 1);
   EXPECT_EQ(writer_ptr->buffer_writes.at(0), "envoy.test_counter:1|c");
@@ -186,7 +199,7 @@ TEST(UdpStatsdSinkTest, CheckActualStats) {
   gauge.used_ = true;
   snapshot.gauges_.push_back(gauge);
 
-  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), writeBuffer(_));
+  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), write(_));
   sink.flush(snapshot);
   EXPECT_EQ(writer_ptr->buffer_writes.size(), 2);
   EXPECT_EQ(writer_ptr->buffer_writes.at(1), "envoy.test_gauge:1|g");
@@ -255,7 +268,7 @@ TEST(UdpStatsdSinkTest, CheckBufferedWritesWithinBufferSize) {
   snapshot.gauges_.push_back(gauge);
 
   // Expect both metrics to be present in single write
-  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), writeBuffer(_));
+  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), write(_));
   sink.flush(snapshot);
   EXPECT_EQ(writer_ptr->buffer_writes.size(), 1);
   EXPECT_EQ(writer_ptr->buffer_writes.at(0), "envoy.test_counter:1|c\nenvoy.test_gauge:1|g");
@@ -290,7 +303,7 @@ TEST(UdpStatsdSinkTest, CheckBufferedWritesExceedingBufferSize) {
   snapshot.gauges_.push_back(gauge);
 
   // Expect both metrics to be present in single write
-  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), writeBuffer(_))
+  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), write(_))
       .Times(2);
   sink.flush(snapshot);
   EXPECT_EQ(writer_ptr->buffer_writes.size(), 2);
@@ -313,7 +326,7 @@ TEST(UdpStatsdSinkTest, CheckActualStatsWithCustomPrefix) {
   counter.latch_ = 1;
   snapshot.counters_.push_back({1, counter});
 
-  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), writeBuffer(_));
+  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), write(_));
   sink.flush(snapshot);
   EXPECT_EQ(writer_ptr->buffer_writes.size(), 1);
   EXPECT_EQ(writer_ptr->buffer_writes.at(0), "test_prefix.test_counter:1|c");
@@ -378,7 +391,7 @@ TEST(UdpStatsdSinkWithTagsTest, CheckActualStats) {
   counter.setTags(tags);
   snapshot.counters_.push_back({1, counter});
 
-  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), writeBuffer(_));
+  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), write(_));
   sink.flush(snapshot);
   EXPECT_EQ(writer_ptr->buffer_writes.size(), 1);
   EXPECT_EQ(writer_ptr->buffer_writes.at(0), "envoy.test_counter:1|c|#key1:value1,key2:value2");
@@ -391,7 +404,7 @@ TEST(UdpStatsdSinkWithTagsTest, CheckActualStats) {
   gauge.setTags(tags);
   snapshot.gauges_.push_back(gauge);
 
-  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), writeBuffer(_));
+  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), write(_));
   sink.flush(snapshot);
   EXPECT_EQ(writer_ptr->buffer_writes.size(), 2);
   EXPECT_EQ(writer_ptr->buffer_writes.at(1), "envoy.test_gauge:1|g|#key1:value1,key2:value2");
@@ -468,7 +481,7 @@ TEST(UdpStatsdSinkWithTagsTest, GraphiteTagSyntax) {
   counter.setTags(tags);
   snapshot.counters_.push_back({1, counter});
 
-  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), writeBuffer(_));
+  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), write(_));
   sink.flush(snapshot);
   EXPECT_EQ(writer_ptr->buffer_writes.size(), 1);
   EXPECT_EQ(writer_ptr->buffer_writes.at(0), "envoy.test_counter;key1=value1;key2=value2:1|c");
@@ -481,7 +494,7 @@ TEST(UdpStatsdSinkWithTagsTest, GraphiteTagSyntax) {
   gauge.setTags(tags);
   snapshot.gauges_.push_back(gauge);
 
-  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), writeBuffer(_));
+  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), write(_));
   sink.flush(snapshot);
   EXPECT_EQ(writer_ptr->buffer_writes.size(), 2);
   EXPECT_EQ(writer_ptr->buffer_writes.at(1), "envoy.test_gauge;key1=value1;key2=value2:1|g");
@@ -496,6 +509,57 @@ TEST(UdpStatsdSinkWithTagsTest, GraphiteTagSyntax) {
   tls_.shutdownThread();
 }
 
+TEST(UdpStatsdSinkTest, WritesDatagramsInBatches) {
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  auto writer_ptr = std::make_shared<RecordingWriter>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  UdpStatsdSink sink(tls_, writer_ptr, false);
+
+  std::vector<std::unique_ptr<NiceMock<Stats::MockCounter>>> counters;
+  for (int i = 0; i < 100; i++) {
+    counters.push_back(std::make_unique<NiceMock<Stats::MockCounter>>());
+    counters.back()->name_ = absl::StrCat("test_counter_", i);
+    counters.back()->used_ = true;
+    snapshot.counters_.push_back({1, *counters.back()});
+  }
+
+  sink.flush(snapshot);
+  EXPECT_EQ(std::vector<size_t>({64, 36}), writer_ptr->batches_);
+  ASSERT_EQ(100, writer_ptr->messages_.size());
+  EXPECT_EQ("envoy.test_counter_0:1|c", writer_ptr->messages_.front());
+  EXPECT_EQ("envoy.test_counter_99:1|c", writer_ptr->messages_.back());
+
+  tls_.shutdownThread();
+}
+
+TEST(UdpStatsdSinkWithTagsTest, RenderingFollowsStatName) {
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  auto writer_ptr = std::make_shared<RecordingWriter>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  UdpStatsdSink sink(tls_, writer_ptr, true);
+
+  NiceMock<Stats::MockCounter> counter;
+  counter.name_ = "test_counter.value1";
+  counter.setTagExtractedName("test_counter");
+  counter.setTags({Stats::Tag{"key1", "value1"}});
+  counter.used_ = true;
+  snapshot.counters_.push_back({1, counter});
+
+  sink.flush(snapshot);
+  sink.flush(snapshot);
+  EXPECT_EQ(std::vector<std::string>({"envoy.test_counter:1|c|#key1:value1",
+                                      "envoy.test_counter:1|c|#key1:value1"}),
+            writer_ptr->messages_);
+
+  // A stat of another name, such as one taking the place of a removed stat, is rendered again.
+  counter.name_ = "test_counter.value2";
+  counter.setTags({Stats::Tag{"key1", "value2"}});
+  sink.flush(snapshot);
+  EXPECT_EQ("envoy.test_counter:1|c|#key1:value2", writer_ptr->messages_.back());
+
+  tls_.shutdownThread();
+}
+
 } // namespace
 } // namespace Statsd
 } // namespace Common
@@ -457,6 +457,29 @@ TEST_F(HystrixSinkTest, AddAndRemoveClusters) {
   validateResults(cluster_message_map[cluster2_name_], 0, 0, 0, 0, 0, window_size_);
 }
 
+TEST_F(HystrixSinkTest, ReplacedClusterWindowsRemoved) {
+  InSequence s;
+  createClusterAndCallbacks();
+  // Register callback to sink.
+  sink_->registerConnection(&callbacks_);
+
+  sink_->flush(snapshot_);
+  EXPECT_NE(std::string::npos, sink_->printRollingWindows().find(cluster1_name_ + ".total"));
+
+  // Replace the cluster by another one, so that the number of clusters is unchanged.
+  removeClusterFromMap(cluster1_name_);
+  addSecondClusterHelper(cluster_stats_buffer_);
+  sink_->flush(snapshot_);
+
+  const std::string rolling_map = sink_->printRollingWindows();
+  EXPECT_EQ(std::string::npos, rolling_map.find(cluster1_name_ + ".total"));
+  EXPECT_NE(std::string::npos, rolling_map.find(cluster2_name_ + ".total"));
+  absl::node_hash_map<std::string, std::string> cluster_message_map =
+      buildClusterMap(cluster_stats_buffer_.toString());
+  EXPECT_EQ(cluster_message_map.find(cluster1_name_), cluster_message_map.end());
+  validateResults(cluster_message_map[cluster2_name_], 0, 0, 0, 0, 0, window_size_);
+}
+
 TEST_F(HystrixSinkTest, HistogramTest) {
   InSequence s;
 
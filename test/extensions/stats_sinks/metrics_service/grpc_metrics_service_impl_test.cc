@@ -1,5 +1,6 @@
 #include "envoy/service/metrics/v3/metrics_service.pb.h"
 
+#include "source/common/buffer/zero_copy_input_stream_impl.h"
 #include "source/extensions/stat_sinks/metrics_service/grpc_metrics_service_impl.h"
 
 #include "test/mocks/common.h"
@@ -9,6 +10,7 @@
 #include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/simulated_time_system.h"
 
+#include "absl/strings/str_cat.h"
 #include "io/prometheus/client/metrics.pb.h"
 
 using namespace std::chrono_literals;
@@ -35,7 +37,7 @@ public:
     }));
     streamer_ = std::make_unique<GrpcMetricsStreamerImpl>(
         Grpc::AsyncClientFactoryPtr{factory_}, local_info_,
-        envoy::config::core::v3::ApiVersion::AUTO);
+        envoy::config::core::v3::ApiVersion::AUTO, 2);
   }
 
   void expectStreamStart(MockMetricsStream& stream, MetricsServiceCallbacks** callbacks_to_set) {
@@ -89,6 +91,41 @@ TEST_F(GrpcMetricsStreamerImplTest, StreamFailure) {
   streamer_->send(std::move(metrics));
 }
 
+// Test that the metrics are split across messages of at most max_metrics_per_message families,
+// the identifier being only sent in the first message of the stream.
+TEST_F(GrpcMetricsStreamerImplTest, SplitMetrics) {
+  InSequence s;
+
+  MockMetricsStream stream;
+  MetricsServiceCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  EXPECT_CALL(local_info_, node());
+  std::vector<envoy::service::metrics::v3::StreamMetricsMessage> messages;
+  EXPECT_CALL(stream, sendMessageRaw_(_, false))
+      .Times(3)
+      .WillRepeatedly(Invoke([&messages](Buffer::InstancePtr& request, bool) {
+        envoy::service::metrics::v3::StreamMetricsMessage message;
+        Buffer::ZeroCopyInputStreamImpl request_stream(std::move(request));
+        EXPECT_TRUE(message.ParseFromZeroCopyStream(&request_stream));
+        messages.push_back(message);
+      }));
+  auto metrics =
+      std::make_unique<Envoy::Protobuf::RepeatedPtrField<io::prometheus::client::MetricFamily>>();
+  for (int i = 0; i < 5; i++) {
+    metrics->Add()->set_name(absl::StrCat("metric_", i));
+  }
+  streamer_->send(std::move(metrics));
+
+  ASSERT_EQ(3, messages.size());
+  EXPECT_TRUE(messages[0].has_identifier());
+  EXPECT_FALSE(messages[1].has_identifier());
+  EXPECT_EQ(2, messages[0].envoy_metrics_size());
+  EXPECT_EQ(2, messages[1].envoy_metrics_size());
+  ASSERT_EQ(1, messages[2].envoy_metrics_size());
+  EXPECT_EQ("metric_2", messages[1].envoy_metrics(0).name());
+  EXPECT_EQ("metric_4", messages[2].envoy_metrics(0).name());
+}
+
 class MockGrpcMetricsStreamer
     : public GrpcMetricsStreamer<envoy::service::metrics::v3::StreamMetricsMessage,
                                  envoy::service::metrics::v3::StreamMetricsResponse> {
@@ -296,6 +333,50 @@ TEST_F(MetricsServiceSinkTest, ReportMetricsWithTags) {
   sink.flush(snapshot_);
 }
 
+// Test that only the changed counters and gauges are reported when configured to do so.
+TEST_F(MetricsServiceSinkTest, ReportOnlyChangedMetrics) {
+  MetricsServiceSink<envoy::service::metrics::v3::StreamMetricsMessage,
+                     envoy::service::metrics::v3::StreamMetricsResponse>
+      sink(streamer_, true, false, true);
+
+  addCounterToSnapshot("test_counter", 1, 1);
+  addGaugeToSnapshot("test_gauge", 1);
+  addHistogramToSnapshot("test_histogram");
+
+  EXPECT_CALL(*streamer_, send(_)).WillOnce(Invoke([](MetricsPtr&& metrics) {
+    EXPECT_EQ(4, metrics->size());
+  }));
+  sink.flush(snapshot_);
+
+  // Only the histograms are reported while the counters and gauges don't change.
+  snapshot_.counters_.back().delta_ = 0;
+  EXPECT_CALL(*streamer_, send(_)).WillOnce(Invoke([](MetricsPtr&& metrics) {
+    EXPECT_EQ(2, metrics->size());
+  }));
+  sink.flush(snapshot_);
+
+  snapshot_.counters_.back().delta_ = 2;
+  gauge_storage_.back()->value_ = 2;
+  EXPECT_CALL(*streamer_, send(_)).WillOnce(Invoke([](MetricsPtr&& metrics) {
+    ASSERT_EQ(4, metrics->size());
+    EXPECT_EQ(2, (*metrics)[0].metric(0).counter().value());
+    EXPECT_EQ(2, (*metrics)[1].metric(0).gauge().value());
+  }));
+  sink.flush(snapshot_);
+
+  // A gauge which was not in a flush is reported again once it is back.
+  snapshot_.gauges_.clear();
+  EXPECT_CALL(*streamer_, send(_)).WillOnce(Invoke([](MetricsPtr&& metrics) {
+    EXPECT_EQ(3, metrics->size());
+  }));
+  sink.flush(snapshot_);
+  snapshot_.gauges_.push_back(*gauge_storage_.back());
+  EXPECT_CALL(*streamer_, send(_)).WillOnce(Invoke([](MetricsPtr&& metrics) {
+    EXPECT_EQ(4, metrics->size());
+  }));
+  sink.flush(snapshot_);
+}
+
 TEST_F(MetricsServiceSinkTest, FlushPredicate) {
   addCounterToSnapshot("used_counter", 100, 1);
   addCounterToSnapshot("unused_counter", 100, 1, false);
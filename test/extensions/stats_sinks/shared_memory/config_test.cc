@@ -0,0 +1,55 @@
+#include "envoy/extensions/stat_sinks/shared_memory/v3/shared_memory.pb.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/stat_sinks/shared_memory/config.h"
+#include "source/extensions/stat_sinks/shared_memory/shared_memory_sink.h"
+
+#include "test/mocks/server/instance.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace SharedMemory {
+namespace {
+
+TEST(SharedMemoryConfigTest, ValidPath) {
+  envoy::extensions::stat_sinks::shared_memory::v3::SharedMemorySink sink_config;
+  sink_config.set_path(TestEnvironment::temporaryPath("shared_memory_config_test"));
+
+  Server::Configuration::StatsSinkFactory* factory =
+      Registry::FactoryRegistry<Server::Configuration::StatsSinkFactory>::getFactory(
+          "envoy.stat_sinks.shared_memory");
+  ASSERT_NE(factory, nullptr);
+
+  ProtobufTypes::MessagePtr message = factory->createEmptyConfigProto();
+  TestUtility::jsonConvert(sink_config, *message);
+
+  NiceMock<Server::Configuration::MockServerFactoryContext> server;
+  Stats::SinkPtr sink = factory->createStatsSink(*message, server);
+  EXPECT_NE(dynamic_cast<SharedMemorySink*>(sink.get()), nullptr);
+}
+
+TEST(SharedMemoryConfigTest, EmptyPath) {
+  Server::Configuration::StatsSinkFactory* factory =
+      Registry::FactoryRegistry<Server::Configuration::StatsSinkFactory>::getFactory(
+          "envoy.stat_sinks.shared_memory");
+  ASSERT_NE(factory, nullptr);
+
+  envoy::extensions::stat_sinks::shared_memory::v3::SharedMemorySink sink_config;
+  NiceMock<Server::Configuration::MockServerFactoryContext> server;
+  EXPECT_THROW(factory->createStatsSink(sink_config, server), ProtoValidationException);
+}
+
+} // namespace
+} // namespace SharedMemory
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
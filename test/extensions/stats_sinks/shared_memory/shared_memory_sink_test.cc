@@ -0,0 +1,221 @@
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/stats/symbol_table_impl.h"
+#include "source/extensions/stat_sinks/shared_memory/shared_memory_sink.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace SharedMemory {
+namespace {
+
+// Decodes a snapshot file the way an external reader would.
+class SnapshotReader {
+public:
+  explicit SnapshotReader(const std::string& path)
+      : contents_(TestEnvironment::readFileToStringForTest(path)) {
+    uint64_t offset = header().symbols_.offset_;
+    for (uint64_t i = 0; i < header().symbols_.count_; ++i) {
+      const SymbolRecord& record = at<SymbolRecord>(offset);
+      symbols_[record.symbol_] = std::string(contents_.data() + offset + sizeof(record),
+                                             record.size_);
+      offset = align(offset + sizeof(record) + record.size_);
+    }
+  }
+
+  const FileHeader& header() const { return at<FileHeader>(0); }
+  uint64_t fileSize() const { return contents_.size(); }
+
+  absl::flat_hash_map<std::string, std::pair<uint64_t, uint64_t>> counters() const {
+    absl::flat_hash_map<std::string, std::pair<uint64_t, uint64_t>> counters;
+    uint64_t offset = header().counters_.offset_;
+    for (uint64_t i = 0; i < header().counters_.count_; ++i) {
+      const CounterRecord& record = at<CounterRecord>(offset);
+      offset += sizeof(record);
+      counters[name(offset, record.name_size_)] = {record.value_, record.delta_};
+      offset = align(offset + record.name_size_);
+    }
+    EXPECT_EQ(header().counters_.offset_ + header().counters_.size_, offset);
+    return counters;
+  }
+
+  absl::flat_hash_map<std::string, uint64_t> gauges() const {
+    absl::flat_hash_map<std::string, uint64_t> gauges;
+    uint64_t offset = header().gauges_.offset_;
+    for (uint64_t i = 0; i < header().gauges_.count_; ++i) {
+      const GaugeRecord& record = at<GaugeRecord>(offset);
+      offset += sizeof(record);
+      gauges[name(offset, record.name_size_)] = record.value_;
+      offset = align(offset + record.name_size_);
+    }
+    EXPECT_EQ(header().gauges_.offset_ + header().gauges_.size_, offset);
+    return gauges;
+  }
+
+  struct Histogram {
+    uint64_t sample_count_;
+    double sample_sum_;
+    std::vector<QuantileRecord> quantiles_;
+  };
+
+  absl::flat_hash_map<std::string, Histogram> histograms() const {
+    absl::flat_hash_map<std::string, Histogram> histograms;
+    uint64_t offset = header().histograms_.offset_;
+    for (uint64_t i = 0; i < header().histograms_.count_; ++i) {
+      const HistogramRecord& record = at<HistogramRecord>(offset);
+      offset += sizeof(record);
+      Histogram histogram{record.sample_count_, record.sample_sum_, {}};
+      for (uint32_t j = 0; j < record.quantile_count_; ++j) {
+        histogram.quantiles_.push_back(at<QuantileRecord>(offset));
+        offset += sizeof(QuantileRecord);
+      }
+      histograms[name(offset, record.name_size_)] = histogram;
+      offset = align(offset + record.name_size_);
+    }
+    EXPECT_EQ(header().histograms_.offset_ + header().histograms_.size_, offset);
+    return histograms;
+  }
+
+private:
+  template <class T> const T& at(uint64_t offset) const {
+    EXPECT_EQ(0, offset % RecordAlignment);
+    EXPECT_LE(offset + sizeof(T), contents_.size());
+    return *reinterpret_cast<const T*>(contents_.data() + offset);
+  }
+
+  static uint64_t align(uint64_t offset) {
+    return (offset + RecordAlignment - 1) / RecordAlignment * RecordAlignment;
+  }
+
+  std::string name(uint64_t offset, uint32_t size) const {
+    std::vector<std::string> tokens;
+    Stats::SymbolTableImpl::Encoding::decodeTokens(
+        reinterpret_cast<const uint8_t*>(contents_.data() + offset), size,
+        [this, &tokens](Stats::Symbol symbol) { tokens.push_back(symbols_.at(symbol)); },
+        [&tokens](absl::string_view token) { tokens.emplace_back(token); });
+    return absl::StrJoin(tokens, ".");
+  }
+
+  const std::string contents_;
+  absl::flat_hash_map<uint32_t, std::string> symbols_;
+};
+
+class SharedMemorySinkTest : public testing::Test {
+protected:
+  SharedMemorySinkTest()
+      : path_(TestEnvironment::temporaryPath("shared_memory_sink_test")),
+        sink_(*symbol_table_, path_) {}
+
+  void addCounter(const std::string& name, uint64_t value, uint64_t delta) {
+    auto counter = std::make_unique<NiceMock<Stats::MockCounter>>();
+    counter->name_ = name;
+    counter->value_ = value;
+    snapshot_.counters_.push_back({delta, *counter});
+    counters_.push_back(std::move(counter));
+  }
+
+  Stats::TestUtil::TestSymbolTable symbol_table_;
+  const std::string path_;
+  SharedMemorySink sink_;
+  std::vector<std::unique_ptr<NiceMock<Stats::MockCounter>>> counters_;
+  NiceMock<Stats::MockMetricSnapshot> snapshot_;
+};
+
+TEST_F(SharedMemorySinkTest, EmptyFile) {
+  SnapshotReader reader(path_);
+  EXPECT_EQ(0, memcmp(reader.header().magic_, Magic, sizeof(Magic)));
+  EXPECT_EQ(Version, reader.header().version_);
+  EXPECT_EQ(sizeof(FileHeader), reader.header().header_size_);
+  EXPECT_EQ(0, reader.header().sequence_.load());
+  EXPECT_EQ(sizeof(FileHeader), reader.header().size_);
+}
+
+TEST_F(SharedMemorySinkTest, Flush) {
+  addCounter("cluster.foo.upstream_rq_total", 5, 2);
+
+  NiceMock<Stats::MockGauge> gauge;
+  gauge.name_ = "cluster.foo.upstream_cx_active";
+  gauge.value_ = 3;
+  snapshot_.gauges_.push_back(gauge);
+
+  NiceMock<Stats::MockParentHistogram> histogram;
+  histogram.name_ = "cluster.foo.upstream_rq_time";
+  snapshot_.histograms_.push_back(histogram);
+
+  snapshot_.snapshot_time_ = SystemTime(std::chrono::milliseconds(1234));
+  sink_.flush(snapshot_);
+
+  SnapshotReader reader(path_);
+  EXPECT_EQ(2, reader.header().sequence_.load());
+  EXPECT_EQ(1234, reader.header().snapshot_time_ms_);
+  EXPECT_LE(reader.header().size_, reader.fileSize());
+  EXPECT_EQ(reader.header().histograms_.offset_ + reader.header().histograms_.size_,
+            reader.header().size_);
+
+  const auto counters = reader.counters();
+  ASSERT_EQ(1, counters.size());
+  EXPECT_EQ(std::make_pair(uint64_t(5), uint64_t(2)), counters.at("cluster.foo.upstream_rq_total"));
+
+  const auto gauges = reader.gauges();
+  ASSERT_EQ(1, gauges.size());
+  EXPECT_EQ(3, gauges.at("cluster.foo.upstream_cx_active"));
+
+  const auto histograms = reader.histograms();
+  ASSERT_EQ(1, histograms.size());
+  const SnapshotReader::Histogram& read_histogram = histograms.at("cluster.foo.upstream_rq_time");
+  const Stats::HistogramStatistics& statistics = histogram.cumulativeStatistics();
+  EXPECT_EQ(statistics.sampleCount(), read_histogram.sample_count_);
+  ASSERT_EQ(statistics.supportedQuantiles().size(), read_histogram.quantiles_.size());
+  for (size_t i = 0; i < read_histogram.quantiles_.size(); ++i) {
+    EXPECT_EQ(statistics.supportedQuantiles()[i], read_histogram.quantiles_[i].quantile_);
+    EXPECT_EQ(statistics.computedQuantiles()[i], read_histogram.quantiles_[i].value_);
+  }
+}
+
+// A snapshot larger than the file is written after growing it.
+TEST_F(SharedMemorySinkTest, Grow) {
+  addCounter("counter", 1, 1);
+  sink_.flush(snapshot_);
+  const uint64_t initial_file_size = SnapshotReader(path_).fileSize();
+
+  for (uint64_t i = 0; i < 2000; ++i) {
+    addCounter(absl::StrCat("cluster.cluster_", i, ".upstream_rq_total"), i, 0);
+  }
+  sink_.flush(snapshot_);
+
+  SnapshotReader reader(path_);
+  EXPECT_EQ(4, reader.header().sequence_.load());
+  EXPECT_GT(reader.fileSize(), initial_file_size);
+  EXPECT_LE(reader.header().size_, reader.fileSize());
+  const auto counters = reader.counters();
+  EXPECT_EQ(2001, counters.size());
+  EXPECT_EQ(1999, counters.at("cluster.cluster_1999.upstream_rq_total").first);
+}
+
+TEST(SharedMemorySinkErrorTest, InvalidPath) {
+  Stats::TestUtil::TestSymbolTable symbol_table;
+  EXPECT_THROW_WITH_REGEX(SharedMemorySink(*symbol_table, "/nonexistent/dir/stats"),
+                          EnvoyException, "unable to open stats snapshot file");
+}
+
+} // namespace
+} // namespace SharedMemory
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
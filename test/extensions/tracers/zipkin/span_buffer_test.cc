@@ -1,5 +1,7 @@
 #include "envoy/config/trace/v3/zipkin.pb.h"
 
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/json/json_loader.h"
 #include "source/common/network/utility.h"
 #include "source/common/protobuf/utility.h"
 #include "source/extensions/tracers/zipkin/span_buffer.h"
@@ -467,6 +469,45 @@ TEST(ZipkinSpanBufferTest, TestSerializeTimestampInTheFuture) {
   EXPECT_THAT(bufferJsonV2.serialize(), Not(HasSubstr(R"("duration":"2584324295476870")")));
 }
 
+// The spans encoded one by one as they are added parse as a single list of spans.
+TEST(ZipkinSpanBufferTest, EncodeSpansAsTheyAreAdded) {
+  SpanBuffer buffer(envoy::config::trace::v3::ZipkinConfig::HTTP_PROTO, true, 2);
+  EXPECT_EQ(0U, buffer.pendingBytes());
+  buffer.addSpan(createSpan({"cs"}, IpType::V4));
+  const uint64_t first_span_bytes = buffer.pendingBytes();
+  EXPECT_GT(first_span_bytes, 0U);
+  buffer.addSpan(createSpan({"cs", "sr"}, IpType::V4));
+  EXPECT_GT(buffer.pendingBytes(), first_span_bytes);
+
+  zipkin::proto3::ListOfSpans spans;
+  ASSERT_TRUE(spans.ParseFromString(buffer.serialize()));
+  EXPECT_EQ(3, spans.spans_size());
+  EXPECT_EQ(zipkin::proto3::Span::CLIENT, spans.spans(0).kind());
+  EXPECT_EQ(zipkin::proto3::Span::CLIENT, spans.spans(1).kind());
+  EXPECT_EQ(zipkin::proto3::Span::SERVER, spans.spans(2).kind());
+}
+
+// Moving the serialized spans to a report gives the same payload as serializing them, and empties
+// the buffer.
+TEST(ZipkinSpanBufferTest, MoveSerialized) {
+  SpanBuffer buffer(envoy::config::trace::v3::ZipkinConfig::HTTP_JSON, true, 2);
+  buffer.addSpan(createSpan({"cs"}, IpType::V4));
+  buffer.addSpan(createSpan({"cs", "sr"}, IpType::V4));
+  const std::string serialized = buffer.serialize();
+
+  Buffer::OwnedImpl report;
+  buffer.moveSerialized(report);
+  EXPECT_EQ(serialized, report.toString());
+  EXPECT_EQ(0U, buffer.pendingSpans());
+  EXPECT_EQ(0U, buffer.pendingBytes());
+  EXPECT_EQ("[]", buffer.serialize());
+
+  EXPECT_TRUE(buffer.addSpan(createSpan({"cs"}, IpType::V4)));
+  Buffer::OwnedImpl next_report;
+  buffer.moveSerialized(next_report);
+  EXPECT_EQ(1U, Json::Factory::loadFromString(next_report.toString())->asObjectArray().size());
+}
+
 } // namespace
 } // namespace Zipkin
 } // namespace Tracers
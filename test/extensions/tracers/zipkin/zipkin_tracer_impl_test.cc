@@ -5,11 +5,14 @@
 
 #include "envoy/config/trace/v3/zipkin.pb.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/headers.h"
 #include "source/common/http/message_impl.h"
 #include "source/common/runtime/runtime_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
 #include "source/common/tracing/http_tracer_impl.h"
+#include "source/extensions/compression/gzip/decompressor/zlib_decompressor_impl.h"
 #include "source/extensions/tracers/zipkin/zipkin_core_constants.h"
 #include "source/extensions/tracers/zipkin/zipkin_tracer_impl.h"
 
@@ -21,6 +24,7 @@
 #include "test/mocks/tracing/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/mocks/upstream/thread_local_cluster.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -481,6 +485,98 @@ TEST_F(ZipkinDriverTest, FlushSpansTimer) {
   EXPECT_EQ(1U, stats_.counter("tracing.zipkin.spans_sent").value());
 }
 
+TEST_F(ZipkinDriverTest, CompressReports) {
+  cm_.initializeClusters({"fake_cluster"}, {});
+  const std::string yaml_string = R"EOF(
+  collector_cluster: fake_cluster
+  collector_endpoint: /api/v2/spans
+  collector_endpoint_version: HTTP_PROTO
+  compress_reports: true
+  )EOF";
+  envoy::config::trace::v3::ZipkinConfig zipkin_config;
+  TestUtility::loadFromYaml(yaml_string, zipkin_config);
+  setup(zipkin_config, true);
+
+  Http::MockAsyncClientRequest request(&cm_.thread_local_cluster_.async_client_);
+  Http::AsyncClient::Callbacks* callback;
+  EXPECT_CALL(cm_.thread_local_cluster_.async_client_, send_(_, _, _))
+      .WillOnce(
+          Invoke([&](Http::RequestMessagePtr& message, Http::AsyncClient::Callbacks& callbacks,
+                     const Http::AsyncClient::RequestOptions&) -> Http::AsyncClient::Request* {
+            callback = &callbacks;
+
+            EXPECT_EQ("application/x-protobuf", message->headers().getContentTypeValue());
+            EXPECT_EQ("gzip", message->headers()
+                                  .get(Http::CustomHeaders::get().ContentEncoding)[0]
+                                  ->value()
+                                  .getStringView());
+            Stats::IsolatedStoreImpl stats_store;
+            Extensions::Compression::Gzip::Decompressor::ZlibDecompressorImpl decompressor(
+                stats_store, "test.");
+            decompressor.init(15 + 16);
+            Buffer::OwnedImpl decompressed;
+            decompressor.decompress(message->body(), decompressed);
+            zipkin::proto3::ListOfSpans spans;
+            EXPECT_TRUE(spans.ParseFromString(decompressed.toString()));
+            EXPECT_EQ(1, spans.spans_size());
+
+            return &request;
+          }));
+  EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.min_flush_spans", 5))
+      .WillOnce(Return(1));
+
+  driver_
+      ->startSpan(config_, request_headers_, operation_name_, start_time_,
+                  {Tracing::Reason::Sampling, true})
+      ->finishSpan();
+  callback->onFailure(request, Http::AsyncClient::FailureReason::Reset);
+}
+
+TEST_F(ZipkinDriverTest, DropSpansOverMaxBufferedBytes) {
+  cm_.initializeClusters({"fake_cluster"}, {});
+  const std::string yaml_string = R"EOF(
+  collector_cluster: fake_cluster
+  collector_endpoint: /api/v2/spans
+  collector_endpoint_version: HTTP_JSON
+  max_buffered_bytes: 1
+  )EOF";
+  envoy::config::trace::v3::ZipkinConfig zipkin_config;
+  TestUtility::loadFromYaml(yaml_string, zipkin_config);
+  setup(zipkin_config, true);
+
+  Http::MockAsyncClientRequest request(&cm_.thread_local_cluster_.async_client_);
+  Http::AsyncClient::Callbacks* callback;
+  EXPECT_CALL(cm_.thread_local_cluster_.async_client_, send_(_, _, _))
+      .Times(2)
+      .WillRepeatedly(DoAll(WithArg<1>(SaveArgAddress(&callback)), Return(&request)));
+  ON_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.min_flush_spans", 5))
+      .WillByDefault(Return(1));
+
+  // The first span is sent, and the next one is dropped until the collector answers its report.
+  driver_
+      ->startSpan(config_, request_headers_, operation_name_, start_time_,
+                  {Tracing::Reason::Sampling, true})
+      ->finishSpan();
+  driver_
+      ->startSpan(config_, request_headers_, operation_name_, start_time_,
+                  {Tracing::Reason::Sampling, true})
+      ->finishSpan();
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.spans_sent").value());
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.spans_dropped").value());
+
+  Http::ResponseMessagePtr msg(new Http::ResponseMessageImpl(
+      Http::ResponseHeaderMapPtr{new Http::TestResponseHeaderMapImpl{{":status", "202"}}}));
+  callback->onSuccess(request, std::move(msg));
+
+  driver_
+      ->startSpan(config_, request_headers_, operation_name_, start_time_,
+                  {Tracing::Reason::Sampling, true})
+      ->finishSpan();
+  EXPECT_EQ(2U, stats_.counter("tracing.zipkin.spans_sent").value());
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.spans_dropped").value());
+  callback->onFailure(request, Http::AsyncClient::FailureReason::Reset);
+}
+
 TEST_F(ZipkinDriverTest, NoB3ContextSampledTrue) {
   setupValidDriver("HTTP_JSON");
 
@@ -502,6 +598,24 @@ TEST_F(ZipkinDriverTest, NoB3ContextSampledFalse) {
   EXPECT_TRUE(request_headers_.get(ZipkinCoreConstants::get().X_B3_TRACE_ID).empty());
   EXPECT_TRUE(request_headers_.get(ZipkinCoreConstants::get().X_B3_SAMPLED).empty());
 
+  Tracing::SpanPtr span = driver_->startSpan(config_, request_headers_, operation_name_,
+                                             start_time_, {Tracing::Reason::Sampling, false});
+  EXPECT_NE(nullptr, dynamic_cast<UnsampledSpan*>(span.get()));
+
+  // Only the decision not to sample the request is propagated, by the span and its children.
+  Tracing::SpanPtr child = span->spawnChild(config_, "child", start_time_);
+  child->injectContext(request_headers_);
+  EXPECT_TRUE(request_headers_.get(ZipkinCoreConstants::get().X_B3_SPAN_ID).empty());
+  EXPECT_TRUE(request_headers_.get(ZipkinCoreConstants::get().X_B3_TRACE_ID).empty());
+  EXPECT_EQ(NOT_SAMPLED, request_headers_.get_(ZipkinCoreConstants::get().X_B3_SAMPLED));
+}
+
+TEST_F(ZipkinDriverTest, NoB3ContextSampledFalseWithoutSkippingUnsampledSpans) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.zipkin_skip_unsampled_spans", "false"}});
+  setupValidDriver("HTTP_JSON");
+
   Tracing::SpanPtr span = driver_->startSpan(config_, request_headers_, operation_name_,
                                              start_time_, {Tracing::Reason::Sampling, false});
 
@@ -533,12 +647,15 @@ TEST_F(ZipkinDriverTest, PropagateB3NoSampleDecisionSampleFalse) {
   request_headers_.addReferenceKey(ZipkinCoreConstants::get().X_B3_SPAN_ID,
                                    Hex::uint64ToHex(generateRandom64()));
   EXPECT_TRUE(request_headers_.get(ZipkinCoreConstants::get().X_B3_SAMPLED).empty());
+  const Http::TestRequestHeaderMapImpl original_headers(request_headers_);
 
   Tracing::SpanPtr span = driver_->startSpan(config_, request_headers_, operation_name_,
                                              start_time_, {Tracing::Reason::Sampling, false});
+  EXPECT_NE(nullptr, dynamic_cast<Tracing::NullSpan*>(span.get()));
 
-  ZipkinSpanPtr zipkin_span(dynamic_cast<ZipkinSpan*>(span.release()));
-  EXPECT_FALSE(zipkin_span->span().sampled());
+  // The trace context of the request is propagated untouched.
+  span->spawnChild(config_, "child", start_time_)->injectContext(request_headers_);
+  EXPECT_EQ(original_headers, request_headers_);
 }
 
 TEST_F(ZipkinDriverTest, PropagateB3NotSampled) {
@@ -849,6 +966,9 @@ TEST_F(ZipkinDriverTest, ExplicitlySetSampledFalse) {
 }
 
 TEST_F(ZipkinDriverTest, ExplicitlySetSampledTrue) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.zipkin_skip_unsampled_spans", "false"}});
   setupValidDriver("HTTP_JSON");
 
   Tracing::SpanPtr span = driver_->startSpan(config_, request_headers_, operation_name_,
@@ -0,0 +1,91 @@
+// Measures the tracing overhead of a request proxied upstream with the Zipkin driver, sampling one
+// request in a thousand, with and without Zipkin spans for the requests which aren't sampled.
+
+#include "envoy/config/trace/v3/zipkin.pb.h"
+
+#include "source/common/http/header_map_impl.h"
+#include "source/common/runtime/runtime_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/common/tracing/http_tracer_impl.h"
+#include "source/extensions/tracers/zipkin/zipkin_tracer_impl.h"
+
+#include "test/mocks/common.h"
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/mocks/tracing/mocks.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/mocks/upstream/thread_local_cluster.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace Zipkin {
+namespace {
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_StartSpanAtLowSampling(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.zipkin_skip_unsampled_spans",
+        state.range(0) != 0 ? "true" : "false"}});
+
+  NiceMock<Upstream::MockClusterManager> cm;
+  cm.thread_local_cluster_.cluster_.info_->name_ = "fake_cluster";
+  cm.initializeThreadLocalClusters({"fake_cluster"});
+  ON_CALL(cm.thread_local_cluster_, httpAsyncClient())
+      .WillByDefault(ReturnRef(cm.thread_local_cluster_.async_client_));
+  cm.initializeClusters({"fake_cluster"}, {});
+  Stats::IsolatedStoreImpl stats;
+  NiceMock<ThreadLocal::MockInstance> tls;
+  NiceMock<Runtime::MockLoader> runtime;
+  NiceMock<LocalInfo::MockLocalInfo> local_info;
+  NiceMock<Random::MockRandomGenerator> random;
+  Event::SimulatedTimeSystem time_system;
+
+  envoy::config::trace::v3::ZipkinConfig zipkin_config;
+  TestUtility::loadFromYaml(R"EOF(
+collector_cluster: fake_cluster
+collector_endpoint: /api/v2/spans
+collector_endpoint_version: HTTP_JSON
+)EOF",
+                            zipkin_config);
+  Tracing::HttpTracerImpl tracer(std::make_shared<Driver>(zipkin_config, cm, stats, tls, runtime,
+                                                          local_info, random, time_system),
+                                 local_info);
+  NiceMock<Tracing::MockConfig> config;
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+
+  uint64_t request = 0;
+  for (auto _ : state) { // NOLINT
+    Http::TestRequestHeaderMapImpl request_headers{
+        {":authority", "example.com"}, {":path", "/"}, {":method", "GET"}};
+    Tracing::SpanPtr span =
+        tracer.startSpan(config, request_headers, stream_info,
+                         {Tracing::Reason::Sampling, request++ % 1000 == 0});
+    Tracing::SpanPtr child =
+        span->spawnChild(config, "router upstream egress", time_system.systemTime());
+    child->setTag(Tracing::Tags::get().UpstreamCluster, "fake_cluster");
+    Http::TestRequestHeaderMapImpl upstream_headers(request_headers);
+    child->injectContext(upstream_headers);
+    child->finishSpan();
+    span->setTag(Tracing::Tags::get().HttpStatusCode, "200");
+    span->finishSpan();
+  }
+}
+BENCHMARK(BM_StartSpanAtLowSampling)->Arg(0)->Arg(1);
+
+} // namespace
+} // namespace Zipkin
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
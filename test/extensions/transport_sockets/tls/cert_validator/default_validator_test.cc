@@ -2,15 +2,24 @@
 #include <vector>
 
 #include "source/extensions/transport_sockets/tls/cert_validator/default_validator.h"
+#include "source/extensions/transport_sockets/tls/utility.h"
 
+#include "test/extensions/transport_sockets/tls/cert_validator/test_common.h"
 #include "test/extensions/transport_sockets/tls/ssl_test_utility.h"
+#include "test/mocks/ssl/mocks.h"
 #include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "openssl/x509v3.h"
 
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
 namespace Envoy {
 namespace Extensions {
 namespace TransportSockets {
@@ -146,6 +155,161 @@ TEST(DefaultCertValidatorTest, TestCertificateVerificationWithSANMatcher) {
   EXPECT_EQ(stats.fail_verify_san_.value(), 1);
 }
 
+TEST(VerifiedCertChainCacheTest, KeyCoversChainAndSans) {
+  bssl::UniquePtr<X509> cert = readCertFromFile(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem"));
+  bssl::UniquePtr<X509> other_cert = readCertFromFile(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_uri_cert.pem"));
+  bssl::UniquePtr<STACK_OF(X509)> intermediates(sk_X509_new_null());
+  X509_up_ref(other_cert.get());
+  sk_X509_push(intermediates.get(), other_cert.get());
+
+  const std::string key = VerifiedCertChainCache::key(*cert, nullptr, {});
+  EXPECT_EQ(key, VerifiedCertChainCache::key(*cert, nullptr, {}));
+  EXPECT_NE(key, VerifiedCertChainCache::key(*other_cert, nullptr, {}));
+  EXPECT_NE(key, VerifiedCertChainCache::key(*cert, intermediates.get(), {}));
+  EXPECT_NE(key, VerifiedCertChainCache::key(*cert, nullptr, {"server1.example.com"}));
+  EXPECT_NE(VerifiedCertChainCache::key(*cert, nullptr, {"a", "bc"}),
+            VerifiedCertChainCache::key(*cert, nullptr, {"ab", "c"}));
+}
+
+TEST(VerifiedCertChainCacheTest, EvictsLeastRecentlyUsed) {
+  Event::SimulatedTimeSystem time_system;
+  VerifiedCertChainCache cache(2, time_system);
+  const MonotonicTime expiry = time_system.monotonicTime() + std::chrono::hours(1);
+
+  cache.insert("a", Envoy::Ssl::ClientValidationStatus::Validated, expiry);
+  cache.insert("b", Envoy::Ssl::ClientValidationStatus::NotValidated, expiry);
+  EXPECT_EQ(Envoy::Ssl::ClientValidationStatus::Validated, cache.lookup("a"));
+  cache.insert("c", Envoy::Ssl::ClientValidationStatus::Validated, expiry);
+
+  EXPECT_EQ(2, cache.size());
+  EXPECT_EQ(Envoy::Ssl::ClientValidationStatus::Validated, cache.lookup("a"));
+  EXPECT_EQ(absl::nullopt, cache.lookup("b"));
+  EXPECT_EQ(Envoy::Ssl::ClientValidationStatus::Validated, cache.lookup("c"));
+}
+
+TEST(VerifiedCertChainCacheTest, Expiry) {
+  Event::SimulatedTimeSystem time_system;
+  VerifiedCertChainCache cache(2, time_system);
+
+  cache.insert("a", Envoy::Ssl::ClientValidationStatus::Validated,
+               time_system.monotonicTime() + std::chrono::seconds(10));
+  time_system.advanceTimeWait(std::chrono::seconds(5));
+  EXPECT_EQ(Envoy::Ssl::ClientValidationStatus::Validated, cache.lookup("a"));
+  time_system.advanceTimeWait(std::chrono::seconds(5));
+  EXPECT_EQ(absl::nullopt, cache.lookup("a"));
+  EXPECT_EQ(0, cache.size());
+}
+
+class DefaultCertValidatorCacheTest : public testing::Test {
+protected:
+  DefaultCertValidatorCacheTest()
+      : stats_(generateSslStats(store_)),
+        ca_cert_(TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+            "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.pem"))),
+        ssl_ctx_(SSL_CTX_new(TLS_method())) {
+    ON_CALL(config_, caCert()).WillByDefault(ReturnRef(ca_cert_));
+    ON_CALL(config_, caCertPath()).WillByDefault(ReturnRef(ca_cert_path_));
+    ON_CALL(config_, certificateRevocationList()).WillByDefault(ReturnRef(empty_string_));
+    ON_CALL(config_, certificateRevocationListPath()).WillByDefault(ReturnRef(empty_string_));
+    ON_CALL(config_, subjectAltNameMatchers()).WillByDefault(ReturnRef(san_matchers_));
+    ON_CALL(config_, verifyCertificateHashList()).WillByDefault(ReturnRef(empty_list_));
+    ON_CALL(config_, verifyCertificateSpkiList()).WillByDefault(ReturnRef(empty_list_));
+    ON_CALL(config_, verifiedCertChainCacheMaxEntries()).WillByDefault(Return(10));
+    ON_CALL(config_, verifiedCertChainCacheTtl())
+        .WillByDefault(Return(std::chrono::milliseconds(60 * 1000)));
+  }
+
+  void initialize() {
+    validator_ = std::make_unique<DefaultCertValidator>(&config_, stats_, time_system_);
+    validator_->initializeSslContexts({ssl_ctx_.get()}, false);
+  }
+
+  // Verifies a certificate as of an hour after it became valid.
+  int verify(const std::string& cert_file) {
+    bssl::UniquePtr<X509> cert = readCertFromFile(TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + cert_file));
+    const SystemTime now = Utility::getValidFrom(*cert) + std::chrono::hours(1);
+    time_system_.setSystemTime(now);
+    bssl::UniquePtr<X509_STORE_CTX> store_ctx(X509_STORE_CTX_new());
+    X509_STORE_CTX_init(store_ctx.get(), SSL_CTX_get_cert_store(ssl_ctx_.get()), cert.get(),
+                        nullptr);
+    X509_STORE_CTX_set_time(store_ctx.get(), 0,
+                            std::chrono::system_clock::to_time_t(
+                                std::chrono::time_point_cast<std::chrono::seconds>(now)));
+    TestSslExtendedSocketInfo info;
+    const int ret = validator_->doVerifyCertChain(store_ctx.get(), &info, *cert, nullptr);
+    last_status_ = info.certificateValidationStatus();
+    return ret;
+  }
+
+  Stats::TestUtil::TestStore store_;
+  SslStats stats_;
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<Envoy::Ssl::MockCertificateValidationContextConfig> config_;
+  const std::string ca_cert_;
+  const std::string ca_cert_path_{"ca_cert.pem"};
+  const std::string empty_string_;
+  const std::vector<std::string> empty_list_;
+  std::vector<envoy::type::matcher::v3::StringMatcher> san_matchers_;
+  bssl::UniquePtr<SSL_CTX> ssl_ctx_;
+  std::unique_ptr<DefaultCertValidator> validator_;
+  Envoy::Ssl::ClientValidationStatus last_status_{};
+};
+
+TEST_F(DefaultCertValidatorCacheTest, CachesVerifiedChains) {
+  initialize();
+
+  EXPECT_EQ(1, verify("san_dns_cert.pem"));
+  EXPECT_EQ(Envoy::Ssl::ClientValidationStatus::Validated, last_status_);
+  EXPECT_EQ(0, stats_.verified_cert_chain_cache_hit_.value());
+  EXPECT_EQ(1, stats_.verified_cert_chain_cache_miss_.value());
+
+  EXPECT_EQ(1, verify("san_dns_cert.pem"));
+  EXPECT_EQ(Envoy::Ssl::ClientValidationStatus::Validated, last_status_);
+  EXPECT_EQ(1, stats_.verified_cert_chain_cache_hit_.value());
+  EXPECT_EQ(1, stats_.verified_cert_chain_cache_miss_.value());
+
+  // The cached chain is verified again once its TTL has passed.
+  time_system_.advanceTimeWait(std::chrono::minutes(2));
+  EXPECT_EQ(1, verify("san_dns_cert.pem"));
+  EXPECT_EQ(1, stats_.verified_cert_chain_cache_hit_.value());
+  EXPECT_EQ(2, stats_.verified_cert_chain_cache_miss_.value());
+}
+
+TEST_F(DefaultCertValidatorCacheTest, DoesNotCacheFailedChains) {
+  initialize();
+
+  EXPECT_EQ(0, verify("selfsigned_cert.pem"));
+  EXPECT_EQ(0, verify("selfsigned_cert.pem"));
+  EXPECT_EQ(0, stats_.verified_cert_chain_cache_hit_.value());
+  EXPECT_EQ(2, stats_.verified_cert_chain_cache_miss_.value());
+  EXPECT_EQ(2, stats_.fail_verify_error_.value());
+}
+
+TEST_F(DefaultCertValidatorCacheTest, DoesNotCacheSanMismatches) {
+  envoy::type::matcher::v3::StringMatcher matcher;
+  matcher.set_exact("hello.example.com");
+  san_matchers_.push_back(matcher);
+  initialize();
+
+  EXPECT_EQ(0, verify("san_dns_cert.pem"));
+  EXPECT_EQ(0, verify("san_dns_cert.pem"));
+  EXPECT_EQ(0, stats_.verified_cert_chain_cache_hit_.value());
+  EXPECT_EQ(2, stats_.fail_verify_san_.value());
+}
+
+TEST_F(DefaultCertValidatorCacheTest, Disabled) {
+  ON_CALL(config_, verifiedCertChainCacheMaxEntries()).WillByDefault(Return(0));
+  initialize();
+
+  EXPECT_EQ(1, verify("san_dns_cert.pem"));
+  EXPECT_EQ(1, verify("san_dns_cert.pem"));
+  EXPECT_EQ(0, stats_.verified_cert_chain_cache_hit_.value());
+  EXPECT_EQ(0, stats_.verified_cert_chain_cache_miss_.value());
+}
+
 } // namespace Tls
 } // namespace TransportSockets
 } // namespace Extensions
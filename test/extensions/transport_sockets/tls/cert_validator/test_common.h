@@ -71,6 +71,11 @@ public:
     return custom_validator_config_;
   }
 
+  uint32_t verifiedCertChainCacheMaxEntries() const override { return 0; }
+  std::chrono::milliseconds verifiedCertChainCacheTtl() const override {
+    return std::chrono::milliseconds(0);
+  }
+
   Api::Api& api() const override { return *api_; }
 
 private:
@@ -0,0 +1,238 @@
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/transport_sockets/tls/private_key/thread_pool/config.h"
+
+#include "test/mocks/server/options.h"
+#include "test/mocks/server/transport_socket_factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/evp.h"
+#include "openssl/pem.h"
+#include "openssl/ssl.h"
+
+using testing::Invoke;
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+namespace {
+
+class MockPrivateKeyConnectionCallbacks : public Ssl::PrivateKeyConnectionCallbacks {
+public:
+  MOCK_METHOD(void, onPrivateKeyMethodComplete, ());
+};
+
+class ThreadPoolPrivateKeyProviderTest : public testing::Test {
+protected:
+  ThreadPoolPrivateKeyProviderTest()
+      : api_(Api::createApiForTest(store_)), dispatcher_(api_->allocateDispatcher("test_thread")),
+        ssl_ctx_(SSL_CTX_new(TLS_method())), ssl_(SSL_new(ssl_ctx_.get())) {
+    ON_CALL(factory_context_, api()).WillByDefault(ReturnRef(*api_));
+    ON_CALL(factory_context_, scope()).WillByDefault(ReturnRef(store_));
+    ON_CALL(factory_context_, options()).WillByDefault(ReturnRef(options_));
+    ON_CALL(factory_context_, messageValidationVisitor())
+        .WillByDefault(ReturnRef(ProtobufMessage::getStrictValidationVisitor()));
+  }
+
+  void createProvider(const std::string& key_file, const std::string& extra_config = "") {
+    envoy::extensions::transport_sockets::tls::v3::PrivateKeyProvider config;
+    TestUtility::loadFromYaml(TestEnvironment::substitute(fmt::format(R"EOF(
+provider_name: thread_pool
+typed_config:
+  "@type": type.googleapis.com/envoy.extensions.private_key_providers.thread_pool.v3alpha.ThreadPoolPrivateKeyMethodConfig
+  private_key:
+    filename: "{{{{ test_rundir }}}}/test/extensions/transport_sockets/tls/test_data/{}"
+{}
+)EOF",
+                                                                      key_file, extra_config)),
+                              config);
+    provider_ = factory_.createPrivateKeyMethodProviderInstance(config, factory_context_);
+    method_ = provider_->getBoringSslPrivateKeyMethod();
+
+    const std::string key = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + key_file));
+    bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(key.data(), key.size()));
+    pkey_.reset(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+    ASSERT_NE(nullptr, pkey_);
+  }
+
+  // Runs the dispatcher until the operation in progress completes.
+  void waitForCompletion() {
+    EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).WillOnce(Invoke([this]() {
+      dispatcher_->exit();
+    }));
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+  }
+
+  void verify(uint16_t signature_algorithm, const std::vector<uint8_t>& signature) {
+    bssl::ScopedEVP_MD_CTX ctx;
+    EVP_PKEY_CTX* pctx;
+    ASSERT_EQ(1, EVP_DigestVerifyInit(ctx.get(), &pctx,
+                                      SSL_get_signature_algorithm_digest(signature_algorithm),
+                                      nullptr, pkey_.get()));
+    if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm)) {
+      ASSERT_EQ(1, EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_PKCS1_PSS_PADDING));
+      ASSERT_EQ(1, EVP_PKEY_CTX_set_rsa_pss_saltlen(pctx, -1));
+    }
+    EXPECT_EQ(1, EVP_DigestVerify(ctx.get(), signature.data(), signature.size(), input_.data(),
+                                  input_.size()));
+  }
+
+  uint64_t counter(const std::string& name) {
+    return store_.counterFromString("thread_pool_private_key_provider." + name).value();
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  NiceMock<Server::MockOptions> options_;
+  NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context_;
+  NiceMock<MockPrivateKeyConnectionCallbacks> callbacks_;
+  ThreadPoolPrivateKeyMethodFactory factory_;
+  bssl::UniquePtr<SSL_CTX> ssl_ctx_;
+  bssl::UniquePtr<SSL> ssl_;
+  bssl::UniquePtr<EVP_PKEY> pkey_;
+  Ssl::PrivateKeyMethodProviderSharedPtr provider_;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr method_;
+  const std::vector<uint8_t> input_{'h', 'a', 'n', 'd', 's', 'h', 'a', 'k', 'e'};
+  std::vector<uint8_t> output_ = std::vector<uint8_t>(1024);
+  size_t output_len_{};
+};
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, RsaSignOffloaded) {
+  createProvider("unittest_key.pem");
+  provider_->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+
+  for (const uint16_t signature_algorithm : {SSL_SIGN_RSA_PKCS1_SHA256, SSL_SIGN_RSA_PSS_SHA256}) {
+    EXPECT_EQ(ssl_private_key_retry,
+              method_->sign(ssl_.get(), output_.data(), &output_len_, output_.size(),
+                            signature_algorithm, input_.data(), input_.size()));
+    waitForCompletion();
+    ASSERT_EQ(ssl_private_key_success, method_->complete(ssl_.get(), output_.data(), &output_len_,
+                                                         output_.size()));
+    verify(signature_algorithm,
+           std::vector<uint8_t>(output_.begin(), output_.begin() + output_len_));
+  }
+
+  EXPECT_EQ(2, counter("offloaded"));
+  EXPECT_EQ(0, counter("inline_fallback"));
+  EXPECT_EQ(0, store_.gaugeFromString("thread_pool_private_key_provider.queue_depth",
+                                      Stats::Gauge::ImportMode::NeverImport)
+                   .value());
+  provider_->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, EcdsaSignOffloaded) {
+  createProvider("selfsigned_ecdsa_p256_key.pem", "  thread_count: 2");
+  provider_->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+
+  EXPECT_EQ(ssl_private_key_retry,
+            method_->sign(ssl_.get(), output_.data(), &output_len_, output_.size(),
+                          SSL_SIGN_ECDSA_SECP256R1_SHA256, input_.data(), input_.size()));
+  // The completion is retried until the operation is done.
+  EXPECT_EQ(ssl_private_key_retry,
+            method_->complete(ssl_.get(), output_.data(), &output_len_, output_.size()));
+  waitForCompletion();
+  ASSERT_EQ(ssl_private_key_success,
+            method_->complete(ssl_.get(), output_.data(), &output_len_, output_.size()));
+  verify(SSL_SIGN_ECDSA_SECP256R1_SHA256,
+         std::vector<uint8_t>(output_.begin(), output_.begin() + output_len_));
+
+  // ECDSA keys don't decrypt.
+  EXPECT_EQ(ssl_private_key_failure,
+            method_->decrypt(ssl_.get(), output_.data(), &output_len_, output_.size(),
+                             input_.data(), input_.size()));
+  provider_->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, InlineFallbackWhenQueueFull) {
+  createProvider("unittest_key.pem", "  max_queue_depth: 0");
+  provider_->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+
+  EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).Times(0);
+  ASSERT_EQ(ssl_private_key_success,
+            method_->sign(ssl_.get(), output_.data(), &output_len_, output_.size(),
+                          SSL_SIGN_RSA_PKCS1_SHA256, input_.data(), input_.size()));
+  verify(SSL_SIGN_RSA_PKCS1_SHA256,
+         std::vector<uint8_t>(output_.begin(), output_.begin() + output_len_));
+
+  EXPECT_EQ(0, counter("offloaded"));
+  EXPECT_EQ(1, counter("inline_fallback"));
+  provider_->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, SignatureAlgorithmMismatch) {
+  createProvider("unittest_key.pem");
+  provider_->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+
+  EXPECT_EQ(ssl_private_key_retry,
+            method_->sign(ssl_.get(), output_.data(), &output_len_, output_.size(),
+                          SSL_SIGN_ECDSA_SECP256R1_SHA256, input_.data(), input_.size()));
+  waitForCompletion();
+  EXPECT_EQ(ssl_private_key_failure,
+            method_->complete(ssl_.get(), output_.data(), &output_len_, output_.size()));
+  EXPECT_EQ(1, counter("failures"));
+  provider_->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, OutputTooLarge) {
+  createProvider("unittest_key.pem", "  max_queue_depth: 0");
+  provider_->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+
+  EXPECT_EQ(ssl_private_key_failure,
+            method_->sign(ssl_.get(), output_.data(), &output_len_, 16, SSL_SIGN_RSA_PKCS1_SHA256,
+                          input_.data(), input_.size()));
+  EXPECT_EQ(1, counter("failures"));
+  provider_->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+// A connection closed during an operation isn't called back.
+TEST_F(ThreadPoolPrivateKeyProviderTest, UnregisterDuringOperation) {
+  createProvider("unittest_key.pem");
+  provider_->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+
+  EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).Times(0);
+  EXPECT_EQ(ssl_private_key_retry,
+            method_->sign(ssl_.get(), output_.data(), &output_len_, output_.size(),
+                          SSL_SIGN_RSA_PKCS1_SHA256, input_.data(), input_.size()));
+  provider_->unregisterPrivateKeyMethod(ssl_.get());
+  // Waits for the pool to be done with the operation.
+  provider_.reset();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, RegisterTwice) {
+  createProvider("unittest_key.pem");
+  provider_->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+  EXPECT_THROW_WITH_MESSAGE(
+      provider_->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_), EnvoyException,
+      "Can't distinguish between two registered providers for the same SSL object.");
+  provider_->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, InvalidPrivateKey) {
+  EXPECT_THROW_WITH_MESSAGE(
+      createProvider("unittest_cert.pem"), EnvoyException,
+      "Failed to load the private key of the thread pool private key provider.");
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, InvalidThreadCount) {
+  EXPECT_THROW_WITH_REGEX(createProvider("unittest_key.pem", "  thread_count: 0"),
+                          EnvoyException, "ThreadCount");
+}
+
+} // namespace
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
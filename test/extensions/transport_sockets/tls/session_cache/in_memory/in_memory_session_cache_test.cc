@@ -0,0 +1,125 @@
+#include "envoy/extensions/tls_session_caches/in_memory/v3alpha/in_memory.pb.h"
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/transport_sockets/tls/session_cache/in_memory/in_memory_session_cache.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace SessionCache {
+namespace {
+
+class InMemorySessionCacheTest : public testing::Test {
+protected:
+  InMemorySessionCacheTest() {
+    config_.set_name("test");
+    config_.mutable_max_sessions()->set_value(2);
+  }
+
+  std::unique_ptr<InMemorySessionCache> makeCache() {
+    return std::make_unique<InMemorySessionCache>(config_, store_, time_system_);
+  }
+
+  absl::optional<std::string> lookup(InMemorySessionCache& cache, absl::string_view session_id) {
+    absl::optional<std::string> session;
+    bool called = false;
+    EXPECT_EQ(nullptr, cache.lookup(session_id, dispatcher_,
+                                    [&](absl::optional<std::string>&& result) {
+                                      called = true;
+                                      session = std::move(result);
+                                    }));
+    EXPECT_TRUE(called);
+    return session;
+  }
+
+  uint64_t sessions() {
+    return TestUtility::findGauge(store_, "tls_session_cache.in_memory.test.sessions")->value();
+  }
+  uint64_t evictions() {
+    return TestUtility::findCounter(store_, "tls_session_cache.in_memory.test.evictions")->value();
+  }
+
+  envoy::extensions::tls_session_caches::in_memory::v3alpha::InMemorySessionCacheConfig config_;
+  Stats::IsolatedStoreImpl store_;
+  Event::SimulatedTimeSystem time_system_;
+  testing::NiceMock<Event::MockDispatcher> dispatcher_;
+};
+
+TEST_F(InMemorySessionCacheTest, InsertAndLookup) {
+  auto cache = makeCache();
+  EXPECT_EQ(absl::nullopt, lookup(*cache, "a"));
+  cache->insert("a", "session a", std::chrono::seconds(300));
+  EXPECT_EQ("session a", lookup(*cache, "a"));
+  EXPECT_EQ(1, sessions());
+
+  // The session of an ID is replaced.
+  cache->insert("a", "session a2", std::chrono::seconds(300));
+  EXPECT_EQ("session a2", lookup(*cache, "a"));
+  EXPECT_EQ(1, sessions());
+  EXPECT_EQ(0, evictions());
+}
+
+TEST_F(InMemorySessionCacheTest, Remove) {
+  auto cache = makeCache();
+  cache->insert("a", "session a", std::chrono::seconds(300));
+  cache->remove("a");
+  cache->remove("b");
+  EXPECT_EQ(absl::nullopt, lookup(*cache, "a"));
+  EXPECT_EQ(0, sessions());
+}
+
+TEST_F(InMemorySessionCacheTest, EvictsLeastRecentlyUsed) {
+  auto cache = makeCache();
+  cache->insert("a", "session a", std::chrono::seconds(300));
+  cache->insert("b", "session b", std::chrono::seconds(300));
+  // Looking up a makes b the least recently used.
+  EXPECT_EQ("session a", lookup(*cache, "a"));
+  cache->insert("c", "session c", std::chrono::seconds(300));
+  EXPECT_EQ(2, sessions());
+  EXPECT_EQ(1, evictions());
+  EXPECT_EQ("session a", lookup(*cache, "a"));
+  EXPECT_EQ(absl::nullopt, lookup(*cache, "b"));
+  EXPECT_EQ("session c", lookup(*cache, "c"));
+}
+
+TEST_F(InMemorySessionCacheTest, Expiry) {
+  auto cache = makeCache();
+  cache->insert("a", "session a", std::chrono::seconds(10));
+  time_system_.advanceTimeWait(std::chrono::seconds(9));
+  EXPECT_EQ("session a", lookup(*cache, "a"));
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_EQ(absl::nullopt, lookup(*cache, "a"));
+  EXPECT_EQ(0, sessions());
+}
+
+TEST_F(InMemorySessionCacheTest, ManagerSharesCachesByName) {
+  InMemorySessionCacheManager manager(store_, time_system_);
+  InMemorySessionCacheSharedPtr cache1 = manager.getCache(config_);
+  InMemorySessionCacheSharedPtr cache2 = manager.getCache(config_);
+  EXPECT_EQ(cache1, cache2);
+
+  auto other_config = config_;
+  other_config.mutable_max_sessions()->set_value(3);
+  EXPECT_THROW_WITH_MESSAGE(
+      manager.getCache(other_config), EnvoyException,
+      "config specified in-memory TLS session cache 'test' with different settings");
+
+  // Once no context uses the cache anymore, it can be configured differently.
+  cache1.reset();
+  cache2.reset();
+  EXPECT_NE(nullptr, manager.getCache(other_config));
+}
+
+} // namespace
+} // namespace SessionCache
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
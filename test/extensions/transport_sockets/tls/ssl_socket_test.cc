@@ -6,6 +6,7 @@
 #include "envoy/config/listener/v3/listener_components.pb.h"
 #include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
 #include "envoy/network/transport_socket.h"
+#include "envoy/ssl/session_cache.h"
 
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/empty_string.h"
@@ -30,6 +31,7 @@
 #include "test/extensions/transport_sockets/tls/test_data/san_dns3_cert_info.h"
 #include "test/extensions/transport_sockets/tls/test_data/san_dns4_cert_info.h"
 #include "test/extensions/transport_sockets/tls/test_data/san_dns_cert_info.h"
+#include "test/extensions/transport_sockets/tls/test_data/san_multiple_dns_cert_info.h"
 #include "test/extensions/transport_sockets/tls/test_data/san_uri_cert_info.h"
 #include "test/extensions/transport_sockets/tls/test_data/selfsigned_ecdsa_p256_cert_info.h"
 #include "test/extensions/transport_sockets/tls/test_private_key_method_provider.h"
@@ -1181,6 +1183,47 @@ TEST_P(SslSocketTest, MultiCertPreferEcdsa) {
   testUtil(test_options);
 }
 
+// With several certificates of a type, the certificate for the SNI is selected, by exact name
+// first and then by wildcard name, and the first certificate for an unknown SNI.
+TEST_P(SslSocketTest, MultiCertSelectBySni) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+    - certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_key.pem"
+    - certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_multiple_dns_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_multiple_dns_key.pem"
+)EOF";
+
+  const auto client_ctx_yaml = [](absl::string_view sni, absl::string_view cert_hash) {
+    return absl::StrCat(R"EOF(
+    sni: )EOF",
+                        sni, R"EOF(
+    common_tls_context:
+      validation_context:
+        verify_certificate_hash: )EOF",
+                        cert_hash);
+  };
+
+  testUtil(TestUtilOptions(client_ctx_yaml("server1.example.com", TEST_SAN_DNS_CERT_256_HASH),
+                           server_ctx_yaml, true, GetParam()));
+  testUtil(TestUtilOptions(
+      client_ctx_yaml("server2.example.com", TEST_SAN_MULTIPLE_DNS_CERT_256_HASH),
+      server_ctx_yaml, true, GetParam()));
+  testUtil(TestUtilOptions(
+      client_ctx_yaml("Other.Example.com", TEST_SAN_MULTIPLE_DNS_CERT_256_HASH),
+      server_ctx_yaml, true, GetParam()));
+  // A wildcard doesn't match several labels.
+  testUtil(TestUtilOptions(client_ctx_yaml("a.b.example.com", TEST_SAN_DNS_CERT_256_HASH),
+                           server_ctx_yaml, true, GetParam()));
+  testUtil(TestUtilOptions(client_ctx_yaml("example.org", TEST_SAN_DNS_CERT_256_HASH),
+                           server_ctx_yaml, true, GetParam()));
+}
+
 TEST_P(SslSocketTest, GetUriWithLocalUriSan) {
   const std::string client_ctx_yaml = R"EOF(
   common_tls_context:
@@ -2536,6 +2579,98 @@ TEST_P(SslSocketTest, HalfClose) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+// Data flows both ways with kernel TLS enabled, whether the kernel of the test supports it or not.
+TEST_P(SslSocketTest, KernelTls) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    enable_kernel_tls: true
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_key.pem"
+)EOF";
+
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext server_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml), server_tls_context);
+  auto server_cfg = std::make_unique<ServerContextConfigImpl>(server_tls_context, factory_context_);
+  ContextManagerImpl manager(time_system_);
+  Stats::TestUtil::TestStore server_stats_store;
+  ServerSslSocketFactory server_ssl_socket_factory(std::move(server_cfg), manager,
+                                                   server_stats_store, std::vector<std::string>{});
+
+  auto socket = std::make_shared<Network::TcpListenSocket>(
+      Network::Test::getCanonicalLoopbackAddress(GetParam()), nullptr, true);
+  Network::MockTcpListenerCallbacks listener_callbacks;
+  Network::ListenerPtr listener =
+      dispatcher_->createListener(socket, listener_callbacks, true, ENVOY_TCP_BACKLOG_SIZE);
+  std::shared_ptr<Network::MockReadFilter> server_read_filter(new Network::MockReadFilter());
+  std::shared_ptr<Network::MockReadFilter> client_read_filter(new Network::MockReadFilter());
+
+  const std::string client_ctx_yaml = R"EOF(
+    common_tls_context:
+      enable_kernel_tls: true
+  )EOF";
+
+  envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(client_ctx_yaml), tls_context);
+  auto client_cfg = std::make_unique<ClientContextConfigImpl>(tls_context, factory_context_);
+  Stats::TestUtil::TestStore client_stats_store;
+  ClientSslSocketFactory client_ssl_socket_factory(std::move(client_cfg), manager,
+                                                   client_stats_store);
+  Network::ClientConnectionPtr client_connection = dispatcher_->createClientConnection(
+      socket->addressProvider().localAddress(), Network::Address::InstanceConstSharedPtr(),
+      client_ssl_socket_factory.createTransportSocket(nullptr), nullptr);
+  client_connection->addReadFilter(client_read_filter);
+  client_connection->connect();
+  Network::MockConnectionCallbacks client_connection_callbacks;
+  client_connection->addConnectionCallbacks(client_connection_callbacks);
+
+  Network::ConnectionPtr server_connection;
+  Network::MockConnectionCallbacks server_connection_callbacks;
+  EXPECT_CALL(listener_callbacks, onAccept_(_))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket) -> void {
+        server_connection = dispatcher_->createServerConnection(
+            std::move(socket), server_ssl_socket_factory.createTransportSocket(nullptr),
+            stream_info_);
+        server_connection->addReadFilter(server_read_filter);
+        server_connection->addConnectionCallbacks(server_connection_callbacks);
+        Buffer::OwnedImpl data("hello");
+        server_connection->write(data, false);
+      }));
+
+  EXPECT_CALL(*server_read_filter, onNewConnection())
+      .WillOnce(Return(Network::FilterStatus::Continue));
+  EXPECT_CALL(*client_read_filter, onNewConnection())
+      .WillOnce(Return(Network::FilterStatus::Continue));
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::Connected));
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::Connected));
+  EXPECT_CALL(*client_read_filter, onData(BufferStringEqual("hello"), false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> Network::FilterStatus {
+        data.drain(data.length());
+        Buffer::OwnedImpl buffer("world");
+        client_connection->write(buffer, false);
+        return Network::FilterStatus::StopIteration;
+      }));
+  EXPECT_CALL(*server_read_filter, onData(BufferStringEqual("world"), false))
+      .WillOnce(Invoke([&](Buffer::Instance&, bool) -> Network::FilterStatus {
+        dispatcher_->exit();
+        return Network::FilterStatus::StopIteration;
+      }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  EXPECT_EQ(1UL, server_stats_store.counter("ssl.kernel_tls_offloaded").value() +
+                     server_stats_store.counter("ssl.kernel_tls_not_offloaded").value());
+  EXPECT_EQ(1UL, client_stats_store.counter("ssl.kernel_tls_offloaded").value() +
+                     client_stats_store.counter("ssl.kernel_tls_not_offloaded").value());
+
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::LocalClose));
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::LocalClose));
+  client_connection->close(Network::ConnectionCloseType::NoFlush);
+  server_connection->close(Network::ConnectionCloseType::NoFlush);
+}
+
 TEST_P(SslSocketTest, ShutdownWithCloseNotify) {
   const std::string server_ctx_yaml = R"EOF(
   common_tls_context:
@@ -3381,6 +3516,134 @@ TEST_P(SslSocketTest, StatelessSessionResumptionEnabledByDefault) {
   testSupportForStatelessSessionResumption(server_ctx_yaml, client_ctx_yaml, true, GetParam());
 }
 
+// A session cache shared by all the contexts configured with it. With "async", the lookups complete
+// on the dispatcher.
+class TestSessionCache : public Ssl::SessionCache {
+public:
+  // Ssl::SessionCache
+  void insert(absl::string_view session_id, std::string&& session, std::chrono::seconds) override {
+    absl::MutexLock lock(&mutex_);
+    sessions_[session_id] = std::move(session);
+  }
+  Ssl::SessionCacheLookupHandlePtr lookup(absl::string_view session_id,
+                                          Event::Dispatcher& dispatcher,
+                                          LookupCallback cb) override {
+    absl::optional<std::string> session;
+    {
+      absl::MutexLock lock(&mutex_);
+      auto it = sessions_.find(session_id);
+      if (it != sessions_.end()) {
+        session = it->second;
+      }
+    }
+    if (!async_) {
+      cb(std::move(session));
+      return nullptr;
+    }
+    auto handle = std::make_unique<Handle>();
+    dispatcher.post([cancelled = handle->cancelled_, cb, session]() mutable {
+      if (!*cancelled) {
+        cb(std::move(session));
+      }
+    });
+    return handle;
+  }
+  void remove(absl::string_view session_id) override {
+    absl::MutexLock lock(&mutex_);
+    sessions_.erase(session_id);
+  }
+
+  bool async_{};
+
+private:
+  struct Handle : public Ssl::SessionCacheLookupHandle {
+    ~Handle() override { *cancelled_ = true; }
+    std::shared_ptr<bool> cancelled_ = std::make_shared<bool>(false);
+  };
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::string> sessions_ ABSL_GUARDED_BY(mutex_);
+};
+
+class TestSessionCacheFactory : public Ssl::SessionCacheFactory {
+public:
+  Ssl::SessionCacheSharedPtr
+  createSessionCache(const Protobuf::Message& config,
+                     Server::Configuration::TransportSocketFactoryContext&) override {
+    const auto& fields = dynamic_cast<const ProtobufWkt::Struct&>(config).fields();
+    auto async = fields.find("async");
+    cache_->async_ = async != fields.end() && async->second.bool_value();
+    return cache_;
+  }
+  std::string name() const override { return "envoy.tls.session_cache.test"; }
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<ProtobufWkt::Struct>();
+  }
+
+  const std::shared_ptr<TestSessionCache> cache_ = std::make_shared<TestSessionCache>();
+};
+
+void testSessionCacheResumption(bool async, const Network::Address::IpVersion ip_version) {
+  TestSessionCacheFactory factory;
+  Registry::InjectFactory<Ssl::SessionCacheFactory> registered_factory(factory);
+
+  const std::string server_ctx_yaml = fmt::format(R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{{{ test_rundir }}}}/test/extensions/transport_sockets/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{{{ test_rundir }}}}/test/extensions/transport_sockets/tls/test_data/unittest_key.pem"
+  disable_stateless_session_resumption: true
+  session_cache:
+    name: envoy.tls.session_cache.test
+    typed_config:
+      "@type": type.googleapis.com/google.protobuf.Struct
+      value:
+        async: {}
+)EOF",
+                                                  async);
+
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+)EOF";
+
+  // The sessions are resumed by ID with the context of another listener.
+  testTicketSessionResumption(server_ctx_yaml, {}, server_ctx_yaml, {}, client_ctx_yaml, true,
+                              ip_version);
+}
+
+TEST_P(SslSocketTest, SessionCacheResumption) { testSessionCacheResumption(false, GetParam()); }
+
+TEST_P(SslSocketTest, SessionCacheResumptionAsyncLookup) {
+  testSessionCacheResumption(true, GetParam());
+}
+
+// Without a session cache, the sessions are only resumed by ID with the context which established
+// them.
+TEST_P(SslSocketTest, SessionIdResumptionWithoutSessionCache) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_key.pem"
+  disable_stateless_session_resumption: true
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+)EOF";
+
+  testTicketSessionResumption(server_ctx_yaml, {}, server_ctx_yaml, {}, client_ctx_yaml, false,
+                              GetParam());
+}
+
 // Test that if two listeners use the same cert and session ticket key, but
 // different client CA, that sessions cannot be resumed.
 TEST_P(SslSocketTest, ClientAuthCrossListenerSessionResumption) {
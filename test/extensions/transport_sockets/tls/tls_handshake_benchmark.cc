@@ -0,0 +1,189 @@
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/fmt.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/transport_sockets/tls/context_config_impl.h"
+#include "source/extensions/transport_sockets/tls/context_impl.h"
+#include "source/extensions/transport_sockets/tls/context_manager_impl.h"
+
+#include "test/mocks/server/transport_socket_factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "openssl/err.h"
+#include "openssl/ssl.h"
+#include "tools/cpp/runfiles/runfiles.h"
+
+namespace Envoy {
+namespace Extensions::TransportSockets::Tls {
+
+enum class KeyType { Rsa2048, EcdsaP256 };
+
+static void drainErrorQueue() {
+  while (uint64_t err = ERR_get_error()) {
+    ENVOY_LOG_MISC(error, "{}:{}:{}:{}", err, ERR_lib_error_string(err),
+                   ERR_func_error_string(err), ERR_reason_error_string(err));
+  }
+}
+
+static void handleSslError(SSL* ssl, int err, bool is_server) {
+  int error = SSL_get_error(ssl, err);
+  switch (error) {
+  case SSL_ERROR_NONE:
+  case SSL_ERROR_WANT_READ:
+  case SSL_ERROR_WANT_WRITE:
+    return;
+  default:
+    drainErrorQueue();
+    ENVOY_LOG_MISC(error, "is_server {} handshake err {} SSL_get_error {}", is_server, err, error);
+    PANIC("Unexpected error during handshake");
+  }
+}
+
+// The certificate of a key type, with the certificate of the other key type following it if
+// dual_certs is set, so that the server selects the certificate for each handshake.
+static std::string serverCtxYaml(KeyType key_type, bool dual_certs) {
+  static constexpr absl::string_view RsaCert = R"EOF(
+    - certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_key.pem"
+)EOF";
+  static constexpr absl::string_view EcdsaCert = R"EOF(
+    - certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_ecdsa_p256_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_ecdsa_p256_key.pem"
+)EOF";
+  const absl::string_view cert = key_type == KeyType::Rsa2048 ? RsaCert : EcdsaCert;
+  const absl::string_view other_cert = key_type == KeyType::Rsa2048 ? EcdsaCert : RsaCert;
+  return absl::StrCat(R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_3
+    tls_certificates:)EOF",
+                      dual_certs ? other_cert : "", cert);
+}
+
+static std::string clientCtxYaml(KeyType key_type, bool tls13) {
+  return fmt::format(R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: {0}
+      tls_maximum_protocol_version: {0}
+      cipher_suites: [{1}]
+)EOF",
+                     tls13 ? "TLSv1_3" : "TLSv1_2",
+                     key_type == KeyType::Rsa2048 ? "ECDHE-RSA-AES128-GCM-SHA256"
+                                                  : "ECDHE-ECDSA-AES128-GCM-SHA256");
+}
+
+// Runs a handshake over a pair of memory BIOs.
+static void handshake(SSL* client_ssl, SSL* server_ssl) {
+  BIO* client_bio;
+  BIO* server_bio;
+  RELEASE_ASSERT(BIO_new_bio_pair(&client_bio, 0, &server_bio, 0) == 1, "BIO_new_bio_pair");
+  SSL_set_bio(client_ssl, client_bio, client_bio);
+  SSL_set_bio(server_ssl, server_bio, server_bio);
+  SSL_set_connect_state(client_ssl);
+  SSL_set_accept_state(server_ssl);
+
+  for (int i = 0; i < 50; i++) {
+    int client_err = SSL_do_handshake(client_ssl);
+    int server_err = SSL_do_handshake(server_ssl);
+    if (client_err == 1 && server_err == 1) {
+      // TLS 1.3 servers send their session tickets after the handshake.
+      uint8_t byte;
+      RELEASE_ASSERT(SSL_read(client_ssl, &byte, 1) <= 0, "unexpected application data");
+      return;
+    }
+    handleSslError(client_ssl, client_err, false);
+    handleSslError(server_ssl, server_err, true);
+  }
+  PANIC("handshake did not complete");
+}
+
+// Full handshakes, or resumptions with a session ticket, of a client and a server context.
+static void testHandshake(benchmark::State& state) {
+  std::string error;
+  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+      bazel::tools::cpp::runfiles::Runfiles::Create("tls_handshake_benchmark", &error));
+  Envoy::TestEnvironment::setRunfiles(runfiles.get());
+
+  const auto key_type = static_cast<KeyType>(state.range(0));
+  const bool tls13 = state.range(1);
+  const bool resume = state.range(2);
+  const bool dual_certs = state.range(3);
+
+  Event::SimulatedTimeSystem time_system;
+  Stats::IsolatedStoreImpl store;
+  Api::ApiPtr api = Api::createApiForTest(store, time_system);
+  testing::NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(testing::ReturnRef(*api));
+  ContextManagerImpl manager(time_system);
+
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext server_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(serverCtxYaml(key_type, dual_certs)),
+                            server_tls_context);
+  ServerContextConfigImpl server_cfg(server_tls_context, factory_context);
+  auto server_ctx = std::dynamic_pointer_cast<ContextImpl>(
+      manager.createSslServerContext(store, server_cfg, std::vector<std::string>{}, nullptr));
+
+  envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext client_tls_context;
+  TestUtility::loadFromYaml(clientCtxYaml(key_type, tls13), client_tls_context);
+  // The signature algorithms make TLS 1.3 servers with both certificates select the one of the
+  // key type.
+  ClientContextConfigImpl client_cfg(
+      client_tls_context,
+      key_type == KeyType::Rsa2048 ? "rsa_pss_rsae_sha256" : "ecdsa_secp256r1_sha256",
+      factory_context);
+  auto client_ctx = std::dynamic_pointer_cast<ContextImpl>(
+      manager.createSslClientContext(store, client_cfg, nullptr));
+
+  bssl::UniquePtr<SSL_SESSION> session;
+  if (resume) {
+    bssl::UniquePtr<SSL> client_ssl = client_ctx->newSsl(nullptr);
+    bssl::UniquePtr<SSL> server_ssl = server_ctx->newSsl(nullptr);
+    handshake(client_ssl.get(), server_ssl.get());
+    session.reset(SSL_get1_session(client_ssl.get()));
+  }
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    bssl::UniquePtr<SSL> client_ssl = client_ctx->newSsl(nullptr);
+    bssl::UniquePtr<SSL> server_ssl = server_ctx->newSsl(nullptr);
+    if (session != nullptr) {
+      SSL_set_session(client_ssl.get(), session.get());
+    }
+    handshake(client_ssl.get(), server_ssl.get());
+    RELEASE_ASSERT(SSL_session_reused(client_ssl.get()) == resume, "unexpected resumption");
+  }
+  state.counters["handshakes"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+static void testParams(benchmark::internal::Benchmark* b) {
+  for (auto key_type : {KeyType::Rsa2048, KeyType::EcdsaP256}) {
+    for (auto tls13 : {false, true}) {
+      for (auto resume : {false, true}) {
+        for (auto dual_certs : {false, true}) {
+          b->Args({static_cast<int>(key_type), tls13, resume, dual_certs});
+        }
+      }
+    }
+  }
+}
+
+BENCHMARK(testHandshake)
+    ->ArgNames({"key_type", "tls13", "resume", "dual_certs"})
+    ->Unit(::benchmark::kMicrosecond)
+    ->Apply(testParams);
+
+} // namespace Extensions::TransportSockets::Tls
+} // namespace Envoy
@@ -0,0 +1,57 @@
+#include "envoy/extensions/watchdog/stall_report_action/v3alpha/stall_report_action.pb.h"
+#include "envoy/registry/registry.h"
+#include "envoy/server/guarddog_config.h"
+
+#include "source/extensions/watchdog/stall_report_action/config.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Watchdog {
+namespace StallReportAction {
+namespace {
+
+TEST(StallReportActionFactoryTest, CanCreateAction) {
+  auto factory =
+      Registry::FactoryRegistry<Server::Configuration::GuardDogActionFactory>::getFactory(
+          "envoy.watchdog.stall_report_action");
+  ASSERT_NE(factory, nullptr);
+
+  // Create config and mock context
+  envoy::config::bootstrap::v3::Watchdog::WatchdogAction config;
+  TestUtility::loadFromJson(
+      R"EOF(
+        {
+          "config": {
+            "name": "envoy.watchdog.stall_report_action",
+            "typed_config": {
+              "@type": "type.googleapis.com/udpa.type.v1.TypedStruct",
+              "type_url": "type.googleapis.com/envoy.extensions.watchdog.stall_report_action.v3alpha.StallReportActionConfig",
+              "value": {
+                "min_report_interval": "60s",
+                "capture_timeout": "0.2s"
+              }
+            }
+          },
+        }
+      )EOF",
+      config);
+
+  Stats::TestUtil::TestStore stats;
+  Event::MockDispatcher dispatcher;
+  Api::ApiPtr api = Api::createApiForTest(stats);
+  Server::Configuration::GuardDogActionFactoryContext context{*api, dispatcher, stats, "test"};
+
+  EXPECT_NE(factory->createGuardDogActionFromProto(config, context), nullptr);
+}
+
+} // namespace
+} // namespace StallReportAction
+} // namespace Watchdog
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,116 @@
+#include <atomic>
+#include <memory>
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/extensions/watchdog/stall_report_action/v3alpha/stall_report_action.pb.h"
+#include "envoy/server/guarddog_config.h"
+#include "envoy/thread/thread.h"
+
+#include "source/extensions/watchdog/stall_report_action/stall_report_action.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/logging.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace FakeStall {
+
+// Stands for a filter blocking its worker.
+ABSL_ATTRIBUTE_NOINLINE void stall(const std::atomic<bool>& stalled) {
+  while (stalled.load()) {
+  }
+}
+
+} // namespace FakeStall
+} // namespace HttpFilters
+
+namespace Watchdog {
+namespace StallReportAction {
+namespace {
+
+class StallReportActionTest : public testing::Test {
+protected:
+  StallReportActionTest()
+      : api_(Api::createApiForTest(stats_, time_system_)), context_({*api_, dispatcher_, stats_,
+                                                                      "test"}) {}
+
+  uint64_t counter(const std::string& name) {
+    return stats_.counter(absl::StrCat("test.stall_report_action.", name)).value();
+  }
+
+  void run(const Thread::ThreadId& thread_id) {
+    const MonotonicTime now = time_system_.monotonicTime();
+    action_->run(envoy::config::bootstrap::v3::Watchdog::WatchdogAction::MISS,
+                 {{thread_id, now - std::chrono::seconds(1)}}, now);
+  }
+
+  envoy::extensions::watchdog::stall_report_action::v3alpha::StallReportActionConfig config_;
+  Stats::TestUtil::TestStore stats_;
+  Event::SimulatedTimeSystem time_system_;
+  Api::ApiPtr api_;
+  testing::NiceMock<Event::MockDispatcher> dispatcher_;
+  Server::Configuration::GuardDogActionFactoryContext context_;
+  std::unique_ptr<Server::Configuration::GuardDogAction> action_;
+};
+
+TEST_F(StallReportActionTest, RateLimitsReportsOfEachThread) {
+  config_.mutable_min_report_interval()->set_seconds(10);
+  action_ = std::make_unique<StallReportAction>(config_, context_);
+
+  // The thread doesn't exist, so its stack can't be captured.
+  run(Thread::ThreadId(-10));
+  EXPECT_EQ(1, counter("stalls"));
+  EXPECT_EQ(1, counter("reports"));
+  EXPECT_EQ(1, counter("captures_failed"));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(5));
+  run(Thread::ThreadId(-10));
+  EXPECT_EQ(2, counter("stalls"));
+  EXPECT_EQ(1, counter("reports"));
+
+  // Other threads are reported on their own.
+  run(Thread::ThreadId(-11));
+  EXPECT_EQ(3, counter("stalls"));
+  EXPECT_EQ(2, counter("reports"));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(5));
+  run(Thread::ThreadId(-10));
+  EXPECT_EQ(4, counter("stalls"));
+  EXPECT_EQ(3, counter("reports"));
+}
+
+#ifdef __linux__
+TEST_F(StallReportActionTest, CapturesStalledThread) {
+  config_.mutable_capture_timeout()->set_seconds(1);
+  action_ = std::make_unique<StallReportAction>(config_, context_);
+
+  std::atomic<bool> stalled{true};
+  std::atomic<int64_t> stalled_thread_id{-1};
+  Thread::ThreadPtr thread = api_->threadFactory().createThread([&]() -> void {
+    stalled_thread_id = api_->threadFactory().currentThreadId().getId();
+    HttpFilters::FakeStall::stall(stalled);
+  });
+  while (stalled_thread_id.load() == -1) {
+  }
+
+  EXPECT_LOG_CONTAINS("warn", "Stack trace:", run(Thread::ThreadId(stalled_thread_id.load())));
+  stalled = false;
+  thread->join();
+
+  EXPECT_EQ(1, counter("reports"));
+  EXPECT_EQ(0, counter("captures_failed"));
+  EXPECT_EQ(1, counter("filter.http.fake_stall.stalls"));
+}
+#endif
+
+} // namespace
+} // namespace StallReportAction
+} // namespace Watchdog
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,229 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the requests proxied end to end by a server, from a client to an autonomous upstream
+// over loopback, with the protocols, transport and route tables of typical deployments. Unlike the
+// microbenchmarks of the codecs and header maps, this covers the whole request path: the listener,
+// the transport socket, the codec, the HTTP connection manager with its filters, the router, the
+// connection pools and the upstream codec.
+//
+// Each benchmark reports the requests per second as items_per_second, the latency percentiles in
+// microseconds, and the growth of the memory allocated by the process per request.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/config/route/v3/route_components.pb.h"
+
+#include "source/common/memory/stats.h"
+
+#include "test/benchmark/main.h"
+#include "test/integration/http_integration.h"
+#include "test/integration/ssl_utility.h"
+#include "test/test_common/environment.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace {
+
+// The configuration of the proxy under test.
+struct ProxyConfig {
+  Http::CodecType protocol_;
+  bool tls_;
+  // The routes of the virtual host matched before the route of the requests.
+  uint32_t routes_;
+  bool filters_;
+  // The requests in flight, on as many connections for HTTP/1 or on one connection for HTTP/2.
+  uint32_t concurrency_;
+};
+
+ProxyConfig proxyConfig(const ::benchmark::State& state) {
+  return {state.range(0) == 2 ? Http::CodecType::HTTP2 : Http::CodecType::HTTP1,
+          state.range(1) != 0, static_cast<uint32_t>(state.range(2)), state.range(3) != 0,
+          static_cast<uint32_t>(state.range(4))};
+}
+
+class ProxyBenchmark : public HttpIntegrationTest {
+public:
+  explicit ProxyBenchmark(const ProxyConfig& config)
+      : HttpIntegrationTest(config.protocol_, TestEnvironment::getIpVersionsForTest().front()),
+        config_(config) {
+    autonomous_upstream_ = true;
+    setUpstreamProtocol(config.protocol_);
+    if (config.tls_) {
+      config_helper_.addSslConfig();
+    }
+    if (config.routes_ > 0) {
+      config_helper_.addConfigModifier(
+          [routes = config.routes_](ConfigHelper::HttpConnectionManager& hcm) {
+            auto* virtual_host = hcm.mutable_route_config()->mutable_virtual_hosts(0);
+            const envoy::config::route::v3::Route route = virtual_host->routes(0);
+            virtual_host->clear_routes();
+            // The route of the requests is the last one, as with the catch all route of a table.
+            for (uint32_t i = 0; i < routes; i++) {
+              auto* other_route = virtual_host->add_routes();
+              *other_route = route;
+              other_route->mutable_match()->set_prefix(absl::StrCat("/route_", i, "/"));
+            }
+            *virtual_host->add_routes() = route;
+          });
+    }
+    if (config.filters_) {
+      // Filters typically found in front of the router, which let the requests through.
+      config_helper_.addFilter(R"EOF(
+name: envoy.filters.http.fault
+typed_config:
+  "@type": type.googleapis.com/envoy.extensions.filters.http.fault.v3.HTTPFault
+)EOF");
+      config_helper_.addFilter(R"EOF(
+name: envoy.filters.http.cors
+typed_config:
+  "@type": type.googleapis.com/envoy.extensions.filters.http.cors.v3.Cors
+)EOF");
+      config_helper_.addFilter(R"EOF(
+name: envoy.filters.http.health_check
+typed_config:
+  "@type": type.googleapis.com/envoy.extensions.filters.http.health_check.v3.HealthCheck
+  pass_through_mode: false
+  headers:
+  - name: ":path"
+    exact_match: "/healthcheck"
+)EOF");
+    }
+    initialize();
+
+    const uint32_t connections =
+        config.protocol_ == Http::CodecType::HTTP2 ? 1 : config.concurrency_;
+    for (uint32_t i = 0; i < connections; i++) {
+      clients_.push_back(makeHttpConnection(makeConnection()));
+    }
+  }
+
+  ~ProxyBenchmark() override {
+    for (IntegrationCodecClientPtr& client : clients_) {
+      client->close();
+    }
+  }
+
+  // Proxies state.iterations() requests, keeping config_.concurrency_ of them in flight.
+  void run(::benchmark::State& state) {
+    const uint64_t memory_before = Memory::Stats::totalCurrentlyAllocated();
+    std::vector<InFlightRequest> in_flight(config_.concurrency_);
+    for (uint32_t i = 0; i < config_.concurrency_; i++) {
+      startRequest(in_flight[i], i);
+    }
+
+    // Each iteration waits for the oldest request, and replaces each of the completed requests.
+    // With several requests in flight their latencies are upper bounds, the requests completed
+    // while waiting for the oldest one being seen complete with it.
+    uint32_t oldest = 0;
+    for (auto _ : state) { // NOLINT
+      if (!in_flight[oldest].response_->waitForEndStream()) {
+        state.SkipWithError("Request timed out");
+        break;
+      }
+      completeRequest(in_flight[oldest], oldest);
+      oldest = (oldest + 1) % config_.concurrency_;
+    }
+    for (InFlightRequest& request : in_flight) {
+      if (!request.response_->waitForEndStream()) {
+        state.SkipWithError("Request timed out");
+        return;
+      }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["errors"] = errors_;
+    if (latencies_.empty()) {
+      return;
+    }
+    std::sort(latencies_.begin(), latencies_.end());
+    const std::vector<std::pair<std::string, double>> quantiles = {
+        {"p50_us", 0.5}, {"p90_us", 0.9}, {"p99_us", 0.99}, {"p999_us", 0.999}};
+    for (const auto& [name, quantile] : quantiles) {
+      state.counters[name] = latencies_[static_cast<size_t>(quantile * (latencies_.size() - 1))];
+    }
+    const uint64_t memory_after = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["bytes_retained_per_request"] =
+        memory_after > memory_before
+            ? static_cast<double>(memory_after - memory_before) / state.iterations()
+            : 0;
+  }
+
+private:
+  struct InFlightRequest {
+    MonotonicTime start_;
+    IntegrationStreamDecoderPtr response_;
+  };
+
+  Network::ClientConnectionPtr makeConnection() {
+    if (!config_.tls_) {
+      return makeClientConnection(lookupPort("http"));
+    }
+    if (client_tls_factory_ == nullptr) {
+      client_tls_factory_ = Ssl::createClientSslTransportSocketFactory({}, context_manager_, *api_);
+    }
+    return dispatcher_->createClientConnection(Ssl::getSslAddress(version_, lookupPort("http")),
+                                               Network::Address::InstanceConstSharedPtr(),
+                                               client_tls_factory_->createTransportSocket({}),
+                                               nullptr);
+  }
+
+  void startRequest(InFlightRequest& request, uint32_t slot) {
+    request.start_ = timeSystem().monotonicTime();
+    request.response_ =
+        clients_[slot % clients_.size()]->makeHeaderOnlyRequest(default_request_headers_);
+  }
+
+  void completeRequest(InFlightRequest& request, uint32_t slot) {
+    const MonotonicTime now = timeSystem().monotonicTime();
+    if (request.response_->headers().getStatusValue() != "200") {
+      errors_++;
+    }
+    latencies_.push_back(
+        std::chrono::duration_cast<std::chrono::microseconds>(now - request.start_).count());
+    startRequest(request, slot);
+  }
+
+  const ProxyConfig config_;
+  Network::TransportSocketFactoryPtr client_tls_factory_;
+  std::vector<IntegrationCodecClientPtr> clients_;
+  std::vector<double> latencies_;
+  uint64_t errors_{};
+};
+
+// Proxies requests with the protocol state.range(0) (1 for HTTP/1, 2 for HTTP/2), over TLS if
+// state.range(1) is set, matching a route after state.range(2) others, through the common filters
+// if state.range(3) is set, with state.range(4) requests in flight.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_ProxyRequests(::benchmark::State& state) {
+  const ProxyConfig config = proxyConfig(state);
+  if (benchmark::skipExpensiveBenchmarks() && (config.routes_ > 0 || config.concurrency_ > 1)) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  ProxyBenchmark proxy(config);
+  proxy.run(state);
+}
+BENCHMARK(BM_ProxyRequests)
+    ->Args({1, 0, 0, 0, 1})
+    ->Args({1, 0, 0, 0, 16})
+    ->Args({1, 1, 0, 0, 1})
+    ->Args({1, 0, 1000, 1, 1})
+    ->Args({2, 0, 0, 0, 1})
+    ->Args({2, 0, 0, 0, 16})
+    ->Args({2, 1, 0, 0, 16})
+    ->Args({2, 1, 1000, 1, 16})
+    ->UseRealTime()
+    ->Unit(::benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Envoy
@@ -67,6 +67,11 @@ public:
   Buffer::InstancePtr createBuffer(std::function<void()> below_low_watermark,
                                    std::function<void()> above_high_watermark,
                                    std::function<void()> above_overflow_watermark) override;
+  // The factory is shared by all the dispatchers, so the accounts are not tracked by size class.
+  BufferMemoryAccountSharedPtr createAccount(Http::StreamResetHandler&) override {
+    return std::make_shared<BufferMemoryAccountImpl>();
+  }
+  uint64_t resetAccountsGivenPressure(float) override { return 0; }
 
   // Number of buffers created.
   uint64_t numBuffersCreated() const;
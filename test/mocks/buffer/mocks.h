@@ -87,6 +87,9 @@ public:
   MOCK_METHOD(Buffer::Instance*, createBuffer_,
               (std::function<void()> below_low, std::function<void()> above_high,
                std::function<void()> above_overflow));
+  MOCK_METHOD(Buffer::BufferMemoryAccountSharedPtr, createAccount,
+              (Http::StreamResetHandler & reset_handler));
+  MOCK_METHOD(uint64_t, resetAccountsGivenPressure, (float pressure));
 };
 
 MATCHER_P(BufferEqual, rhs, testing::PrintToString(*rhs)) {
@@ -28,6 +28,12 @@ MockDispatcher::MockDispatcher(const std::string& name) : name_(name) {
   ON_CALL(*this, createScaledTypedTimer_(_, _))
       .WillByDefault(ReturnNew<NiceMock<Event::MockTimer>>());
   ON_CALL(*this, post(_)).WillByDefault(Invoke([](PostCb cb) -> void { cb(); }));
+  ON_CALL(*this, postBatch(_))
+      .WillByDefault(Invoke([this](std::vector<PostCb>&& callbacks) -> void {
+        for (auto& cb : callbacks) {
+          post(std::move(cb));
+        }
+      }));
 
   ON_CALL(buffer_factory_, createBuffer_(_, _, _))
       .WillByDefault(Invoke([](std::function<void()> below_low, std::function<void()> above_high,
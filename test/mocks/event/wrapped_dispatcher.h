@@ -31,6 +31,10 @@ public:
     impl_.initializeStats(scope, prefix);
   }
 
+  std::chrono::microseconds averageLoopDuration() const override {
+    return impl_.averageLoopDuration();
+  }
+
   void clearDeferredDeleteList() override { impl_.clearDeferredDeleteList(); }
 
   Network::ServerConnectionPtr
@@ -102,6 +106,10 @@ public:
 
   void post(std::function<void()> callback) override { impl_.post(std::move(callback)); }
 
+  void postBatch(std::vector<std::function<void()>>&& callbacks) override {
+    impl_.postBatch(std::move(callbacks));
+  }
+
   void deleteInDispatcherThread(DispatcherThreadDeletableConstPtr deletable) override {
     impl_.deleteInDispatcherThread(std::move(deletable));
   }
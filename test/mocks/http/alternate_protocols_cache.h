@@ -14,6 +14,9 @@ public:
               (const Origin& origin, const std::vector<AlternateProtocol>& protocols));
   MOCK_METHOD(OptRef<const std::vector<AlternateProtocol>>, findAlternatives,
               (const Origin& origin));
+  MOCK_METHOD(void, recordHttp3Attempt,
+              (const Origin& origin, bool succeeded, std::chrono::microseconds connect_time));
+  MOCK_METHOD(absl::optional<OriginStats>, findStats, (const Origin& origin));
   MOCK_METHOD(size_t, size, (), (const));
 };
 
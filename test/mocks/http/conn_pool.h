@@ -14,6 +14,7 @@ namespace Http {
 namespace ConnectionPool {
 
 class MockCallbacks : public Callbacks {
+public:
   MOCK_METHOD(void, onPoolFailure,
               (PoolFailureReason reason, absl::string_view transport_failure_reason,
                Upstream::HostDescriptionConstSharedPtr host));
@@ -36,6 +37,7 @@ public:
   MOCK_METHOD(bool, hasActiveConnections, (), (const));
   MOCK_METHOD(Cancellable*, newStream, (ResponseDecoder & response_decoder, Callbacks& callbacks));
   MOCK_METHOD(bool, maybePreconnect, (float));
+  MOCK_METHOD(void, warmUp, (uint32_t, WarmUpCb));
   MOCK_METHOD(Upstream::HostDescriptionConstSharedPtr, host, (), (const));
   MOCK_METHOD(absl::string_view, protocolDescription, (), (const));
 
@@ -203,6 +203,7 @@ public:
   MOCK_METHOD(Event::Dispatcher&, dispatcher, ());
   MOCK_METHOD(void, resetStream, ());
   MOCK_METHOD(void, resetIdleTimer, ());
+  MOCK_METHOD(void, skipRemainingCallbacks, ());
   MOCK_METHOD(Upstream::ClusterInfoConstSharedPtr, clusterInfo, ());
   MOCK_METHOD(Router::RouteConstSharedPtr, route, ());
   MOCK_METHOD(Router::RouteConstSharedPtr, route, (const Router::RouteCallback&));
@@ -294,6 +295,7 @@ public:
   MOCK_METHOD(Event::Dispatcher&, dispatcher, ());
   MOCK_METHOD(void, resetStream, ());
   MOCK_METHOD(void, resetIdleTimer, ());
+  MOCK_METHOD(void, skipRemainingCallbacks, ());
   MOCK_METHOD(Upstream::ClusterInfoConstSharedPtr, clusterInfo, ());
   MOCK_METHOD(void, requestRouteConfigUpdate, (std::function<void()>));
   MOCK_METHOD(bool, canRequestRouteConfigUpdate, ());
@@ -516,6 +518,7 @@ public:
               (Http::StreamFilterSharedPtr filter,
                Matcher::MatchTreeSharedPtr<HttpMatchingData> match_tree));
   MOCK_METHOD(void, addAccessLogHandler, (AccessLog::InstanceSharedPtr handler));
+  MOCK_METHOD(void, recordFilterCost, (Stats::Histogram & cpu_time_us));
 };
 
 class MockDownstreamWatermarkCallbacks : public DownstreamWatermarkCallbacks {
@@ -60,6 +60,7 @@ public:
   MOCK_METHOD(uint64_t, id, (), (const));                                                          \
   MOCK_METHOD(void, hashKey, (std::vector<uint8_t>&), (const));                                    \
   MOCK_METHOD(bool, initializeReadFilters, ());                                                    \
+  MOCK_METHOD(void, recordFilterCost, (Stats::Histogram & cpu_time_us));                           \
   MOCK_METHOD(std::string, nextProtocol, (), (const));                                             \
   MOCK_METHOD(void, noDelay, (bool enable));                                                       \
   MOCK_METHOD(void, readDisable, (bool disable));                                                  \
@@ -116,6 +116,9 @@ MockListenerFilter::~MockListenerFilter() { destroy_(); }
 
 MockListenerFilterCallbacks::MockListenerFilterCallbacks() {
   ON_CALL(*this, socket()).WillByDefault(ReturnRef(socket_));
+  ON_CALL(*this, peek(_, _)).WillByDefault(Invoke([this](void* buffer, uint64_t length) {
+    return socket().ioHandle().recv(buffer, length, MSG_PEEK);
+  }));
 }
 MockListenerFilterCallbacks::~MockListenerFilterCallbacks() = default;
 
@@ -148,6 +148,7 @@ public:
 
   MOCK_METHOD(void, onData, (UdpRecvData && data));
   MOCK_METHOD(void, onDatagramsDropped, (uint32_t dropped));
+  MOCK_METHOD(void, onDatagramsRead, (uint64_t datagrams));
   MOCK_METHOD(void, onReadReady, ());
   MOCK_METHOD(void, onWriteReady, (const Socket& socket));
   MOCK_METHOD(void, onReceiveError, (Api::IoError::IoErrorCode err));
@@ -336,6 +337,7 @@ public:
   MOCK_METHOD(ConnectionSocket&, socket, ());
   MOCK_METHOD(Event::Dispatcher&, dispatcher, ());
   MOCK_METHOD(void, continueFilterChain, (bool));
+  MOCK_METHOD(Api::IoCallUint64Result, peek, (void*, uint64_t));
   MOCK_METHOD(void, setDynamicMetadata, (const std::string&, const ProtobufWkt::Struct&));
   MOCK_METHOD(envoy::config::core::v3::Metadata&, dynamicMetadata, ());
   MOCK_METHOD(const envoy::config::core::v3::Metadata&, dynamicMetadata, (), (const));
@@ -359,7 +361,7 @@ public:
   MockUdpPacketWriterFactory() = default;
 
   MOCK_METHOD(Network::UdpPacketWriterPtr, createUdpPacketWriter,
-              (Network::IoHandle&, Stats::Scope&), ());
+              (Network::IoHandle&, Event::Dispatcher&, Stats::Scope&), ());
 };
 
 class MockUdpListenerConfig : public UdpListenerConfig {
@@ -445,6 +447,9 @@ public:
   MOCK_METHOD(void, enableListeners, ());
   MOCK_METHOD(void, setListenerRejectFraction, (UnitFloat), (override));
   MOCK_METHOD(const std::string&, statPrefix, (), (const));
+  MOCK_METHOD(std::vector<IoHandlePtr>, releaseIdleConnections,
+              (std::chrono::milliseconds min_idle_time));
+  MOCK_METHOD(bool, adoptConnection, (ConnectionSocketPtr && socket));
 
   uint64_t num_handler_connections_{};
 };
@@ -582,6 +587,7 @@ public:
   MOCK_METHOD(void, unregisterHandler, (BalancedConnectionHandler & handler));
   MOCK_METHOD(BalancedConnectionHandler&, pickTargetHandler,
               (BalancedConnectionHandler & current_handler));
+  MOCK_METHOD(void, onConnectionClosed, (BalancedConnectionHandler & handler));
 };
 
 class MockListenerFilterMatcher : public ListenerFilterMatcher {
@@ -598,6 +604,7 @@ public:
                Address::InstanceConstSharedPtr peer_address, Buffer::InstancePtr buffer,
                MonotonicTime receive_time));
   MOCK_METHOD(void, onDatagramsDropped, (uint32_t dropped));
+  MOCK_METHOD(void, onDatagramsRead, (uint64_t datagrams));
   MOCK_METHOD(uint64_t, maxDatagramSize, (), (const));
   MOCK_METHOD(size_t, numPacketsExpectedPerEventLoop, (), (const));
 };
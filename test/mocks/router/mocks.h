@@ -91,10 +91,14 @@ public:
     return additional_request_chance_;
   }
   bool hedgeOnPerTryTimeout() const override { return hedge_on_per_try_timeout_; }
+  const LatencyHedgeSettings* latencyHedge() const override {
+    return latency_hedge_.has_value() ? &latency_hedge_.value() : nullptr;
+  }
 
   uint32_t initial_requests_{};
   envoy::type::v3::FractionalPercent additional_request_chance_{};
   bool hedge_on_per_try_timeout_{};
+  absl::optional<LatencyHedgeSettings> latency_hedge_;
 };
 
 class TestRetryPolicy : public RetryPolicy {
@@ -230,11 +234,13 @@ public:
   const std::string& runtimeKey() const override { return runtime_key_; }
   const envoy::type::v3::FractionalPercent& defaultValue() const override { return default_value_; }
   bool traceSampled() const override { return trace_sampled_; }
+  bool streamBody() const override { return stream_body_; }
 
   std::string cluster_;
   std::string runtime_key_;
   envoy::type::v3::FractionalPercent default_value_;
   bool trace_sampled_;
+  bool stream_body_{};
 };
 
 class MockShadowWriter : public ShadowWriter {
@@ -248,9 +254,28 @@ public:
     shadow_(cluster, request, options);
   }
 
+  ShadowStreamPtr streamingShadow(const std::string& cluster, Http::RequestHeaderMapPtr&& headers,
+                                  bool end_stream,
+                                  const Http::AsyncClient::StreamOptions& options) override {
+    return streamingShadow_(cluster, headers, end_stream, options);
+  }
+
   MOCK_METHOD(void, shadow_,
               (const std::string& cluster, Http::RequestMessagePtr& request,
                const Http::AsyncClient::RequestOptions& options));
+  MOCK_METHOD(ShadowStreamPtr, streamingShadow_,
+              (const std::string& cluster, Http::RequestHeaderMapPtr& headers, bool end_stream,
+               const Http::AsyncClient::StreamOptions& options));
+};
+
+class MockShadowStream : public ShadowStream {
+public:
+  MockShadowStream();
+  ~MockShadowStream() override;
+
+  // Router::ShadowStream
+  MOCK_METHOD(void, sendData, (const Buffer::Instance& data, bool end_stream));
+  MOCK_METHOD(void, sendTrailers, (const Http::RequestTrailerMap& trailers));
 };
 
 class TestVirtualCluster : public VirtualCluster {
@@ -275,7 +300,7 @@ public:
   MOCK_METHOD(const std::string&, name, (), (const));
   MOCK_METHOD(const RateLimitPolicy&, rateLimitPolicy, (), (const));
   MOCK_METHOD(const CorsPolicy*, corsPolicy, (), (const));
-  MOCK_METHOD(const Config&, routeConfig, (), (const));
+  MOCK_METHOD(const CommonConfig&, routeConfig, (), (const));
   MOCK_METHOD(const RouteSpecificFilterConfig*, perFilterConfig, (const std::string&), (const));
   MOCK_METHOD(bool, includeAttemptCountInRequest, (), (const));
   MOCK_METHOD(bool, includeAttemptCountInResponse, (), (const));
@@ -367,6 +392,7 @@ public:
   MOCK_METHOD(const Router::MetadataMatchCriteria*, metadataMatchCriteria, (), (const));
   MOCK_METHOD(const Router::TlsContextMatchCriteria*, tlsContextMatchCriteria, (), (const));
   MOCK_METHOD(Upstream::ResourcePriority, priority, (), (const));
+  MOCK_METHOD(uint32_t, queuePriority, (), (const));
   MOCK_METHOD(const RateLimitPolicy&, rateLimitPolicy, (), (const));
   MOCK_METHOD(const RetryPolicy&, retryPolicy, (), (const));
   MOCK_METHOD(const InternalRedirectPolicy&, internalRedirectPolicy, (), (const));
@@ -559,6 +585,7 @@ class MockUpstreamToDownstream : public UpstreamToDownstream {
 public:
   MOCK_METHOD(const RouteEntry&, routeEntry, (), (const));
   MOCK_METHOD(const Network::Connection&, connection, (), (const));
+  MOCK_METHOD(absl::optional<MonotonicTime>, downstreamDeadline, (), (const));
 
   MOCK_METHOD(void, decodeData, (Buffer::Instance&, bool));
   MOCK_METHOD(void, decodeMetadata, (Http::MetadataMapPtr &&));
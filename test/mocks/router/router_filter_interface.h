@@ -31,6 +31,7 @@ public:
                UpstreamRequest& upstream_request));
   MOCK_METHOD(void, onUpstreamHostSelected, (Upstream::HostDescriptionConstSharedPtr host));
   MOCK_METHOD(void, onPerTryTimeout, (UpstreamRequest & upstream_request));
+  MOCK_METHOD(void, onLatencyHedgeTimeout, (UpstreamRequest & upstream_request));
   MOCK_METHOD(void, onStreamMaxDurationReached, (UpstreamRequest & upstream_request));
 
   MOCK_METHOD(Envoy::Http::StreamDecoderFilterCallbacks*, callbacks, ());
@@ -41,12 +42,14 @@ public:
   MOCK_METHOD(Envoy::Http::RequestTrailerMap*, downstreamTrailers, ());
   MOCK_METHOD(bool, downstreamResponseStarted, (), (const));
   MOCK_METHOD(bool, downstreamEndStream, (), (const));
+  MOCK_METHOD(MonotonicTime, downstreamRequestCompleteTime, (), (const));
   MOCK_METHOD(uint32_t, attemptCount, (), (const));
   MOCK_METHOD(const VirtualCluster*, requestVcluster, (), (const));
   MOCK_METHOD(const RouteEntry*, routeEntry, (), (const));
   MOCK_METHOD(const std::list<UpstreamRequestPtr>&, upstreamRequests, (), (const));
   MOCK_METHOD(const UpstreamRequest*, finalUpstreamRequest, (), (const));
   MOCK_METHOD(TimeSource&, timeSource, ());
+  MOCK_METHOD(absl::optional<std::chrono::milliseconds>, latencyHedgeDelay, ());
 
   NiceMock<Envoy::Http::MockStreamDecoderFilterCallbacks> callbacks_;
   NiceMock<MockRouteEntry> route_entry_;
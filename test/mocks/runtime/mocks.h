@@ -32,6 +32,12 @@ public:
     }
   }
 
+  // The lookups by handle default to the mocked lookups by key.
+  using Snapshot::featureEnabled;
+  using Snapshot::getBoolean;
+  using Snapshot::getDouble;
+  using Snapshot::getInteger;
+
   MOCK_METHOD(bool, deprecatedFeatureEnabled, (absl::string_view key, bool default_enabled),
               (const));
   MOCK_METHOD(bool, runtimeFeatureEnabled, (absl::string_view key), (const));
@@ -16,6 +16,7 @@ public:
   // Server::HotRestart
   MOCK_METHOD(void, drainParentListeners, ());
   MOCK_METHOD(int, duplicateParentListenSocket, (const std::string& address));
+  MOCK_METHOD(int, duplicateParentIdleConnection, ());
   MOCK_METHOD(std::unique_ptr<envoy::HotRestartMessage>, getParentStats, ());
   MOCK_METHOD(void, initialize, (Event::Dispatcher & dispatcher, Server::Instance& server));
   MOCK_METHOD(void, sendParentAdminShutdownRequest, (time_t & original_start_time));
@@ -28,6 +28,10 @@ public:
   MOCK_METHOD(void, endListenerUpdate, (ListenerManager::FailureStates &&));
   MOCK_METHOD(ApiListenerOptRef, apiListener, ());
   MOCK_METHOD(bool, isWorkerStarted, ());
+  MOCK_METHOD(void, releaseIdleConnections,
+              (std::chrono::milliseconds min_idle_time,
+               Worker::ReleaseIdleConnectionsCompletion completion));
+  MOCK_METHOD(void, adoptConnection, (Network::ConnectionSocketPtr && socket));
 };
 } // namespace Server
 } // namespace Envoy
@@ -45,6 +45,10 @@ public:
   MOCK_METHOD(void, removeFilterChains,
               (uint64_t listener_tag, const std::list<const Network::FilterChain*>& filter_chains,
                std::function<void()> completion));
+  MOCK_METHOD(void, releaseIdleConnections,
+              (std::chrono::milliseconds min_idle_time,
+               ReleaseIdleConnectionsCompletion completion));
+  MOCK_METHOD(void, adoptConnection, (Network::ConnectionSocketPtr && socket));
 
   AddListenerCompletion add_listener_completion_;
   std::function<void()> remove_listener_completion_;
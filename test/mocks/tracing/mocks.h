@@ -36,6 +36,7 @@ public:
   MOCK_METHOD(void, setTag, (absl::string_view name, absl::string_view value));
   MOCK_METHOD(void, log, (SystemTime timestamp, const std::string& event));
   MOCK_METHOD(void, finishSpan, ());
+  MOCK_METHOD(void, finishSpanAt, (SystemTime end_time, MonotonicTime monotonic_end_time));
   MOCK_METHOD(void, injectContext, (Tracing::TraceContext & request_headers));
   MOCK_METHOD(void, setSampled, (const bool sampled));
   MOCK_METHOD(void, setBaggage, (absl::string_view key, absl::string_view value));
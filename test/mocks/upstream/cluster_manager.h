@@ -55,6 +55,11 @@ public:
   MOCK_METHOD(ClusterUpdateCallbacksHandle*, addThreadLocalClusterUpdateCallbacks_,
               (ClusterUpdateCallbacks & callbacks));
   MOCK_METHOD(Config::SubscriptionFactory&, subscriptionFactory, ());
+  MOCK_METHOD(bool, runOnClusterInitThread, (std::function<void()> work, Event::PostCb done));
+  MOCK_METHOD(OdCdsApiHandleSharedPtr, allocateOdCdsApi,
+              (const envoy::config::core::v3::ConfigSource& odcds_config,
+               std::chrono::milliseconds negative_cache_ttl,
+               ProtobufMessage::ValidationVisitor& validation_visitor));
   const ClusterStatNames& clusterStatNames() const override { return cluster_stat_names_; }
   const ClusterLoadReportStatNames& clusterLoadReportStatNames() const override {
     return cluster_load_report_stat_names_;
@@ -68,6 +73,7 @@ public:
   const ClusterTimeoutBudgetStatNames& clusterTimeoutBudgetStatNames() const override {
     return cluster_timeout_budget_stat_names_;
   }
+  bool lazyClusterStats() const override { return lazy_cluster_stats_; }
 
   NiceMock<MockThreadLocalCluster> thread_local_cluster_;
   envoy::config::core::v3::BindConfig bind_config_;
@@ -84,6 +90,7 @@ public:
   ClusterCircuitBreakersStatNames cluster_circuit_breakers_stat_names_;
   ClusterRequestResponseSizeStatNames cluster_request_response_size_stat_names_;
   ClusterTimeoutBudgetStatNames cluster_timeout_budget_stat_names_;
+  bool lazy_cluster_stats_{};
 };
 } // namespace Upstream
 
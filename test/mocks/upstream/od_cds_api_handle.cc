@@ -0,0 +1,10 @@
+#include "od_cds_api_handle.h"
+
+namespace Envoy {
+namespace Upstream {
+MockOdCdsApiHandle::MockOdCdsApiHandle() = default;
+
+MockOdCdsApiHandle::~MockOdCdsApiHandle() = default;
+
+} // namespace Upstream
+} // namespace Envoy
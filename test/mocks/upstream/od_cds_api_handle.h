@@ -0,0 +1,22 @@
+#pragma once
+
+#include <chrono>
+
+#include "envoy/upstream/cluster_manager.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+class MockOdCdsApiHandle : public OdCdsApiHandle {
+public:
+  MockOdCdsApiHandle();
+  ~MockOdCdsApiHandle() override;
+
+  MOCK_METHOD(void, requestOnDemandClusterDiscovery,
+              (absl::string_view name, ClusterDiscoveryCallbackWeakPtr callback,
+               std::chrono::milliseconds timeout));
+};
+} // namespace Upstream
+} // namespace Envoy
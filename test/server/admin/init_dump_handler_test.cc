@@ -1,5 +1,10 @@
+#include "source/common/init/startup_profile.h"
+
 #include "test/server/admin/admin_instance.h"
+#include "test/test_common/simulated_time_system.h"
 
+using testing::HasSubstr;
+using testing::Not;
 using testing::Return;
 using testing::ReturnRef;
 
@@ -107,5 +112,32 @@ TEST_P(AdminInstanceTest, ListenerUnreadyTargetsDump) {
 )EOF";
   EXPECT_EQ(output, expected_json);
 }
+
+// Test Using /init_dump?mask=startup to dump the startup profile.
+TEST_P(AdminInstanceTest, StartupProfileDump) {
+  Buffer::OwnedImpl response;
+  Http::TestResponseHeaderMapImpl header_map;
+
+  // Without a startup profile, there is nothing to dump.
+  EXPECT_EQ(Http::Code::OK, getCallback("/init_dump?mask=startup", header_map, response));
+  EXPECT_THAT(response.toString(), Not(HasSubstr("startup_profile")));
+  response.drain(response.length());
+
+  Event::SimulatedTimeSystem time_system;
+  Init::ScopedStartupProfileSingleton startup_profile(
+      std::make_unique<Init::StartupProfile>(time_system));
+  EXPECT_EQ(Http::Code::OK, getCallback("/init_dump?mask=startup", header_map, response));
+  const std::string expected_json = R"EOF({
+ "startup_profile": {
+  "startup": {
+   "name": "total",
+   "start": "0s"
+  }
+ }
+}
+)EOF";
+  EXPECT_EQ(response.toString(), expected_json);
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -1,4 +1,5 @@
 #include "source/common/profiler/profiler.h"
+#include "source/common/profiler/sampling_profiler.h"
 
 #include "test/server/admin/admin_instance.h"
 #include "test/test_common/logging.h"
@@ -64,6 +65,40 @@ TEST_P(AdminInstanceTest, AdminHeapProfiler) {
   EXPECT_FALSE(Profiler::Heap::isProfilerStarted());
 }
 
+TEST_P(AdminInstanceTest, AdminContinuousCpuProfiler) {
+  Buffer::OwnedImpl data;
+  Http::TestResponseHeaderMapImpl header_map;
+
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/cpuprofiler/continuous?enable=y&hz=0", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/cpuprofiler/continuous?hz=100", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest,
+            getCallback("/cpuprofiler/continuous/pprof?seconds=x", header_map, data));
+
+  if (!Profiler::Sampling::profilerAvailable()) {
+    EXPECT_EQ(Http::Code::NotImplemented,
+              postCallback("/cpuprofiler/continuous?enable=y", header_map, data));
+    return;
+  }
+
+  EXPECT_EQ(Http::Code::OK,
+            postCallback("/cpuprofiler/continuous?enable=y&hz=200", header_map, data));
+  EXPECT_TRUE(Profiler::Sampling::profilerStarted());
+  // The profilers use the same signal.
+  EXPECT_EQ(Http::Code::BadRequest, postCallback("/cpuprofiler?enable=y", header_map, data));
+  EXPECT_FALSE(Profiler::Cpu::profilerEnabled());
+
+  data.drain(data.length());
+  EXPECT_EQ(Http::Code::OK,
+            getCallback("/cpuprofiler/continuous/pprof?seconds=10", header_map, data));
+  EXPECT_EQ(Http::Headers::get().ContentTypeValues.Protobuf, header_map.getContentTypeValue());
+  EXPECT_NE(std::string::npos, data.toString().find("nanoseconds"));
+
+  EXPECT_EQ(Http::Code::OK, postCallback("/cpuprofiler/continuous?enable=n", header_map, data));
+  EXPECT_FALSE(Profiler::Sampling::profilerStarted());
+}
+
 TEST_P(AdminInstanceTest, AdminBadProfiler) {
   Buffer::OwnedImpl data;
   AdminImpl admin_bad_profile_path(TestEnvironment::temporaryPath("some/unlikely/bad/path.prof"),
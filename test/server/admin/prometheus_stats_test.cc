@@ -701,5 +701,41 @@ envoy_cluster_test_1_upstream_cx_total{a_tag_name="a.tag-value"} 0
   EXPECT_EQ(expected_output, response.toString());
 }
 
+// Rendering a chunk at a time produces the same output, with each chunk ending after the
+// metric name which took it past the chunk size.
+TEST_F(PrometheusStatsFormatterTest, RenderInChunks) {
+  for (const char* cluster : {"ccc", "aaa", "bbb"}) {
+    const Stats::StatNameTagVector tags{{makeStat("cluster"), makeStat(cluster)}};
+    addCounter("cluster.upstream_cx_total", tags);
+    addCounter("cluster.upstream_cx_connect_fail", tags);
+    addGauge("cluster.upstream_cx_active", tags);
+  }
+
+  Buffer::OwnedImpl expected;
+  EXPECT_EQ(3UL, PrometheusStatsFormatter::statsAsPrometheus(counters_, gauges_, histograms_,
+                                                             expected, false, absl::nullopt));
+
+  PrometheusStatsRenderer renderer(counters_, gauges_, histograms_, false, absl::nullopt);
+  EXPECT_EQ(3UL, renderer.metricNameCount());
+  Buffer::OwnedImpl response;
+  uint32_t chunks = 1;
+  while (renderer.nextChunk(response, 1)) {
+    ++chunks;
+  }
+  EXPECT_EQ(3, chunks);
+  EXPECT_EQ(expected.toString(), response.toString());
+
+  Buffer::OwnedImpl first_chunk;
+  PrometheusStatsRenderer chunked_renderer(counters_, gauges_, histograms_, false, absl::nullopt);
+  EXPECT_TRUE(chunked_renderer.nextChunk(first_chunk, 1));
+  EXPECT_EQ(R"EOF(# TYPE envoy_cluster_upstream_cx_connect_fail counter
+envoy_cluster_upstream_cx_connect_fail{cluster="aaa"} 0
+envoy_cluster_upstream_cx_connect_fail{cluster="bbb"} 0
+envoy_cluster_upstream_cx_connect_fail{cluster="ccc"} 0
+
+)EOF",
+            first_chunk.toString());
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -1,5 +1,6 @@
 #include "envoy/admin/v3/memory.pb.h"
 
+#include "source/common/memory/stats.h"
 #include "source/extensions/transport_sockets/tls/context_config_impl.h"
 
 #include "test/server/admin/admin_instance.h"
@@ -61,6 +62,14 @@ TEST_P(AdminInstanceTest, Memory) {
                                   Property(&envoy::admin::v3::Memory::total_thread_cache, Ge(0))));
 }
 
+TEST_P(AdminInstanceTest, MemoryTcmalloc) {
+  Http::TestResponseHeaderMapImpl header_map;
+  Buffer::OwnedImpl response;
+  EXPECT_EQ(Http::Code::OK, getCallback("/memory/tcmalloc", header_map, response));
+  EXPECT_EQ(Memory::Stats::detailedStats().empty(), response.length() == 0);
+  EXPECT_THAT(std::string(header_map.getContentTypeValue()), HasSubstr("text/plain"));
+}
+
 TEST_P(AdminInstanceTest, GetReadyRequest) {
   NiceMock<Init::MockManager> initManager;
   ON_CALL(server_, initManager()).WillByDefault(ReturnRef(initManager));
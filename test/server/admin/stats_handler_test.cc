@@ -1,6 +1,7 @@
 #include <regex>
 
 #include "source/common/stats/thread_local_store.h"
+#include "source/server/admin/prometheus_stats.h"
 #include "source/server/admin/stats_handler.h"
 
 #include "test/mocks/server/admin_stream.h"
@@ -9,6 +10,7 @@
 #include "test/test_common/logging.h"
 #include "test/test_common/utility.h"
 
+using testing::_;
 using testing::EndsWith;
 using testing::HasSubstr;
 using testing::InSequence;
@@ -68,6 +70,61 @@ TEST_P(AdminStatsTest, HandlerStatsInvalidFormat) {
   EXPECT_EQ("usage: /stats?format=json  or /stats?format=prometheus \n\n", data.toString());
 }
 
+// A Prometheus response larger than a chunk is streamed a chunk at a time, pausing while the
+// downstream is above its high watermark.
+TEST_P(AdminStatsTest, HandlerPrometheusStatsStreamed) {
+  const std::string url = "/stats/prometheus";
+  Http::TestResponseHeaderMapImpl response_headers;
+  Buffer::OwnedImpl data;
+  MockAdminStream admin_stream;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  MockInstance instance;
+  EXPECT_CALL(instance, stats()).WillRepeatedly(testing::ReturnRef(*store_));
+  StatsHandler handler(instance);
+
+  for (uint32_t i = 0; i < 2000; ++i) {
+    store_->counterFromString(absl::StrCat("cluster.streamed_counter_with_a_long_name_", i)).inc();
+  }
+  Buffer::OwnedImpl expected;
+  PrometheusStatsFormatter::statsAsPrometheus(store_->counters(), store_->gauges(),
+                                              store_->histograms(), expected, false,
+                                              absl::nullopt);
+
+  auto* next_chunk = new NiceMock<Event::MockSchedulableCallback>(&decoder_callbacks.dispatcher_);
+  std::function<void()> on_destroy;
+  EXPECT_CALL(admin_stream, setEndStreamOnComplete(false));
+  EXPECT_CALL(admin_stream, getDecoderFilterCallbacks())
+      .WillRepeatedly(testing::ReturnRef(decoder_callbacks));
+  EXPECT_CALL(admin_stream, addOnDestroyCallback(_)).WillOnce(testing::SaveArg<0>(&on_destroy));
+  EXPECT_EQ(Http::Code::OK, handler.handlerPrometheusStats(url, response_headers, data,
+                                                           admin_stream));
+  EXPECT_LT(data.length(), expected.length());
+  ASSERT_EQ(1, decoder_callbacks.callbacks_.size());
+  Http::DownstreamWatermarkCallbacks& watermark_callbacks = *decoder_callbacks.callbacks_.front();
+
+  // Nothing is sent while the downstream is backed up.
+  watermark_callbacks.onAboveWriteBufferHighWatermark();
+  EXPECT_CALL(decoder_callbacks, encodeData(_, _)).Times(0);
+  next_chunk->invokeCallback();
+  EXPECT_FALSE(next_chunk->enabled_);
+  testing::Mock::VerifyAndClearExpectations(&decoder_callbacks);
+  watermark_callbacks.onBelowWriteBufferLowWatermark();
+
+  bool end_stream = false;
+  EXPECT_CALL(decoder_callbacks, encodeData(_, _))
+      .WillRepeatedly(testing::Invoke([&](Buffer::Instance& chunk, bool end) {
+        data.move(chunk);
+        end_stream = end;
+      }));
+  while (!end_stream) {
+    next_chunk->invokeCallback();
+  }
+  EXPECT_FALSE(next_chunk->enabled_);
+  EXPECT_TRUE(decoder_callbacks.callbacks_.empty());
+  EXPECT_EQ(expected.toString(), data.toString());
+  on_destroy();
+}
+
 TEST_P(AdminStatsTest, HandlerStatsPlainText) {
   const std::string url = "/stats";
   Http::TestResponseHeaderMapImpl response_headers;
@@ -630,6 +630,40 @@ TEST_F(ConnectionHandlerTest, CloseConnectionOnEmptyFilterChain) {
   EXPECT_CALL(*listener, onDestroy());
 }
 
+TEST_F(ConnectionHandlerTest, AdoptConnection) {
+  Network::TcpListenerCallbacks* listener_callbacks;
+  auto listener = new NiceMock<Network::MockListener>();
+  TestListener* test_listener =
+      addListener(1, true, false, "test_listener", listener, &listener_callbacks);
+  Network::Address::InstanceConstSharedPtr normal_address(
+      new Network::Address::Ipv4Instance("127.0.0.1", 10001));
+  EXPECT_CALL(*socket_factory_, localAddress()).WillRepeatedly(ReturnRef(normal_address));
+  handler_->addListener(absl::nullopt, *test_listener);
+
+  // Connections to addresses without a listener are not adopted.
+  auto unknown_socket = std::make_unique<NiceMock<Network::MockConnectionSocket>>();
+  unknown_socket->addressProvider().setLocalAddress(
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.2", 20002));
+  EXPECT_FALSE(handler_->adoptConnection(std::move(unknown_socket)));
+  EXPECT_EQ(0UL, handler_->numConnections());
+
+  auto adopted_socket = std::make_unique<NiceMock<Network::MockConnectionSocket>>();
+  adopted_socket->addressProvider().setLocalAddress(normal_address);
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(filter_chain_.get()));
+  auto* connection = new NiceMock<Network::MockServerConnection>();
+  EXPECT_CALL(dispatcher_, createServerConnection_()).WillOnce(Return(connection));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillOnce(Return(true));
+  EXPECT_TRUE(handler_->adoptConnection(std::move(adopted_socket)));
+  EXPECT_EQ(1UL, handler_->numConnections());
+
+  EXPECT_CALL(*access_log_, log(_, _, _, _));
+  connection->close(Network::ConnectionCloseType::NoFlush);
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(0UL, handler_->numConnections());
+
+  EXPECT_CALL(*listener, onDestroy());
+}
+
 TEST_F(ConnectionHandlerTest, NormalRedirect) {
   Network::TcpListenerCallbacks* listener_callbacks1;
   auto listener1 = new NiceMock<Network::MockListener>();
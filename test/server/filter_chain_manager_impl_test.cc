@@ -36,6 +36,7 @@
 #include "absl/strings/match.h"
 #include "gtest/gtest.h"
 
+using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
@@ -180,6 +181,56 @@ TEST_F(FilterChainManagerImplTest, FilterChainUseFallbackIfNoFilterChainMatches)
   EXPECT_EQ(fallback_filter_chain, build_out_fallback_filter_chain_.get());
 }
 
+// The filter chains of a destination port that only match on server names and transport protocols
+// are found through the compiled decisions, with the precedence of the match tree.
+TEST_F(FilterChainManagerImplTest, ServerNameDecisions) {
+  absl::flat_hash_map<std::string, const Network::FilterChain*> built;
+  EXPECT_CALL(filter_chain_factory_builder_, buildFilterChain(_, _))
+      .WillRepeatedly(Invoke([&built](const envoy::config::listener::v3::FilterChain& filter_chain,
+                                      FilterChainFactoryContextCreator&) {
+        auto built_filter_chain = std::make_shared<Network::MockFilterChain>();
+        built[filter_chain.name()] = built_filter_chain.get();
+        return built_filter_chain;
+      }));
+
+  std::vector<envoy::config::listener::v3::FilterChain> filter_chains(4, filter_chain_template_);
+  filter_chains[0].set_name("exact");
+  filter_chains[0].mutable_filter_chain_match()->add_server_names("foo.example.com");
+  filter_chains[0].mutable_filter_chain_match()->set_transport_protocol("tls");
+  filter_chains[1].set_name("wildcard");
+  filter_chains[1].mutable_filter_chain_match()->add_server_names("*.example.com");
+  filter_chains[2].set_name("any_server_name");
+  filter_chains[2].mutable_filter_chain_match()->set_transport_protocol("tls");
+  // The source type keeps port 10001 on the match tree.
+  filter_chains[3].set_name("local");
+  filter_chains[3].mutable_filter_chain_match()->mutable_destination_port()->set_value(10001);
+  filter_chains[3].mutable_filter_chain_match()->add_server_names("foo.example.com");
+  filter_chains[3].mutable_filter_chain_match()->set_source_type(
+      envoy::config::listener::v3::FilterChainMatch::SAME_IP_OR_LOOPBACK);
+  std::vector<const envoy::config::listener::v3::FilterChain*> filter_chain_ptrs;
+  for (const auto& filter_chain : filter_chains) {
+    filter_chain_ptrs.push_back(&filter_chain);
+  }
+  filter_chain_manager_.addFilterChains(filter_chain_ptrs, nullptr, filter_chain_factory_builder_,
+                                        filter_chain_manager_);
+
+  EXPECT_EQ(built["exact"], findFilterChainHelper(10000, "127.0.0.1", "foo.example.com", "tls", {},
+                                                  "8.8.8.8", 111));
+  // The exact server name matched, so a mismatched transport protocol matches nothing.
+  EXPECT_EQ(nullptr, findFilterChainHelper(10000, "127.0.0.1", "foo.example.com", "raw_buffer",
+                                           {}, "8.8.8.8", 111));
+  EXPECT_EQ(built["wildcard"], findFilterChainHelper(10000, "127.0.0.1", "bar.example.com",
+                                                     "raw_buffer", {}, "8.8.8.8", 111));
+  EXPECT_EQ(built["any_server_name"],
+            findFilterChainHelper(10000, "127.0.0.1", "other.test", "tls", {}, "8.8.8.8", 111));
+  EXPECT_EQ(nullptr, findFilterChainHelper(10000, "127.0.0.1", "other.test", "raw_buffer", {},
+                                           "8.8.8.8", 111));
+  EXPECT_EQ(built["local"], findFilterChainHelper(10001, "127.0.0.1", "foo.example.com", "tls", {},
+                                                  "127.0.0.1", 111));
+  EXPECT_EQ(nullptr, findFilterChainHelper(10001, "127.0.0.1", "foo.example.com", "tls", {},
+                                           "8.8.8.8", 111));
+}
+
 TEST_F(FilterChainManagerImplTest, LookupFilterChainContextByFilterChainMessage) {
   std::vector<envoy::config::listener::v3::FilterChain> filter_chain_messages;
 
@@ -223,6 +274,15 @@ TEST_F(FilterChainManagerImplTest, DuplicateContextsAreNotBuilt) {
       std::vector<const envoy::config::listener::v3::FilterChain*>{
           &filter_chain_messages[0], &filter_chain_messages[1], &filter_chain_messages[2]},
       nullptr, filter_chain_factory_builder_, new_filter_chain_manager);
+
+  // The reused filter chain shares its message with the previous filter chain manager.
+  const auto& previous = *filter_chain_manager_.filterChainsByMessage().begin();
+  const auto reused =
+      new_filter_chain_manager.filterChainsByMessage().find(FcContextKey(filter_chain_messages[0]));
+  ASSERT_NE(reused, new_filter_chain_manager.filterChainsByMessage().end());
+  EXPECT_EQ(&previous.first.message(), &reused->first.message());
+  EXPECT_EQ(previous.second, reused->second);
+  EXPECT_EQ(3, new_filter_chain_manager.filterChainsByMessage().size());
 }
 
 TEST_F(FilterChainManagerImplTest, CreatedFilterChainFactoryContextHasIndependentDrainClose) {
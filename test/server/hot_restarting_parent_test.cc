@@ -3,15 +3,19 @@
 #include "source/server/hot_restarting_child.h"
 #include "source/server/hot_restarting_parent.h"
 
+#include "test/mocks/network/io_handle.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/instance.h"
 #include "test/mocks/server/listener_manager.h"
 
+#include "absl/strings/str_cat.h"
 #include "gtest/gtest.h"
 
+using testing::_;
 using testing::InSequence;
 using testing::Return;
 using testing::ReturnRef;
+using testing::SaveArg;
 
 namespace Envoy {
 namespace Server {
@@ -114,6 +118,95 @@ TEST_F(HotRestartingParentTest, ExportStatsToChild) {
   }
 }
 
+TEST_F(HotRestartingParentTest, ExportEncodedStatsToChild) {
+  Stats::TestUtil::TestStore store;
+  MockListenerManager listener_manager;
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+  EXPECT_CALL(listener_manager, numConnections()).WillRepeatedly(Return(3));
+  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(store));
+  const auto encode = [](Stats::StatName stat_name) {
+    return std::string(reinterpret_cast<const char*>(stat_name.data()), stat_name.dataSize());
+  };
+  const auto export_stats = [this](bool all_symbols) {
+    HotRestartMessage::Request::Stats request;
+    request.set_encoded(true);
+    request.set_all_symbols(all_symbols);
+    std::vector<HotRestartMessage> replies;
+    hot_restarting_parent_.exportEncodedStatsToChild(
+        request, [&replies](const HotRestartMessage& reply) { replies.push_back(reply); });
+    return replies;
+  };
+  const auto has_token = [](const HotRestartMessage::Reply::Stats& stats,
+                            const std::string& token) {
+    for (const auto& symbol : stats.symbols()) {
+      if (symbol.second == token) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  Stats::Counter& c1 = store.counter("c1");
+  c1.add(2);
+  store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(123);
+  {
+    std::vector<HotRestartMessage> replies = export_stats(true);
+    ASSERT_EQ(1, replies.size());
+    const HotRestartMessage::Reply::Stats& stats = replies[0].reply().stats();
+    EXPECT_FALSE(stats.more());
+    EXPECT_TRUE(has_token(stats, "c1"));
+    EXPECT_TRUE(has_token(stats, "g1"));
+    ASSERT_EQ(1, stats.encoded_counter_deltas_size());
+    EXPECT_EQ(encode(c1.statName()), stats.encoded_counter_deltas(0).name());
+    EXPECT_EQ(2, stats.encoded_counter_deltas(0).value());
+    ASSERT_EQ(1, stats.encoded_gauges_size());
+    EXPECT_EQ(123, stats.encoded_gauges(0).value());
+    EXPECT_EQ(3, stats.num_connections());
+  }
+
+  // Only the new symbols are sent again.
+  c1.inc();
+  store.counter("c2").inc();
+  {
+    std::vector<HotRestartMessage> replies = export_stats(false);
+    ASSERT_EQ(1, replies.size());
+    const HotRestartMessage::Reply::Stats& stats = replies[0].reply().stats();
+    EXPECT_EQ(1, stats.symbols_size());
+    EXPECT_TRUE(has_token(stats, "c2"));
+    EXPECT_EQ(2, stats.encoded_counter_deltas_size());
+  }
+  {
+    std::vector<HotRestartMessage> replies = export_stats(true);
+    ASSERT_EQ(1, replies.size());
+    EXPECT_TRUE(has_token(replies[0].reply().stats(), "c1"));
+  }
+}
+
+TEST_F(HotRestartingParentTest, ExportEncodedStatsToChildInSeveralReplies) {
+  Stats::TestUtil::TestStore store;
+  MockListenerManager listener_manager;
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+  EXPECT_CALL(listener_manager, numConnections()).WillRepeatedly(Return(0));
+  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(store));
+  for (int i = 0; i < 15000; i++) {
+    store.counter(absl::StrCat("c", i)).inc();
+  }
+
+  HotRestartMessage::Request::Stats request;
+  request.set_encoded(true);
+  std::vector<HotRestartMessage> replies;
+  hot_restarting_parent_.exportEncodedStatsToChild(
+      request, [&replies](const HotRestartMessage& reply) { replies.push_back(reply); });
+  ASSERT_EQ(2, replies.size());
+  EXPECT_TRUE(replies[0].reply().stats().more());
+  EXPECT_EQ(10000, replies[0].reply().stats().encoded_counter_deltas_size());
+  // All the symbols are sent before the stats using them.
+  EXPECT_GE(replies[0].reply().stats().symbols_size(), 15000);
+  EXPECT_FALSE(replies[1].reply().stats().more());
+  EXPECT_EQ(5000, replies[1].reply().stats().encoded_counter_deltas_size());
+  EXPECT_EQ(0, replies[1].reply().stats().symbols_size());
+}
+
 TEST_F(HotRestartingParentTest, RetainDynamicStats) {
   MockListenerManager listener_manager;
   Stats::SymbolTableImpl parent_symbol_table;
@@ -157,6 +250,29 @@ TEST_F(HotRestartingParentTest, DrainListeners) {
   hot_restarting_parent_.drainListeners();
 }
 
+TEST_F(HotRestartingParentTest, TakeIdleConnection) {
+  MockListenerManager listener_manager;
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+
+  // Connections are only handed off once the workers have released them.
+  Worker::ReleaseIdleConnectionsCompletion completion;
+  EXPECT_CALL(listener_manager, releaseIdleConnections(std::chrono::milliseconds(1000), _))
+      .WillOnce(SaveArg<1>(&completion));
+  EXPECT_EQ(nullptr, hot_restarting_parent_.takeIdleConnection());
+
+  std::vector<Network::IoHandlePtr> released;
+  released.push_back(std::make_unique<Network::MockIoHandle>());
+  released.push_back(std::make_unique<Network::MockIoHandle>());
+  Network::IoHandle* first = released[0].get();
+  Network::IoHandle* second = released[1].get();
+  completion(std::move(released));
+
+  EXPECT_EQ(first, hot_restarting_parent_.takeIdleConnection().get());
+  EXPECT_EQ(second, hot_restarting_parent_.takeIdleConnection().get());
+  EXPECT_CALL(listener_manager, releaseIdleConnections(_, _));
+  EXPECT_EQ(nullptr, hot_restarting_parent_.takeIdleConnection());
+}
+
 } // namespace
 } // namespace Server
 } // namespace Envoy
@@ -113,7 +113,7 @@ udp_listener_config:
           .get()
           .udpListenerConfig()
           ->packetWriterFactory()
-          .createUdpPacketWriter(listen_socket->ioHandle(),
+          .createUdpPacketWriter(listen_socket->ioHandle(), server_.dispatcher(),
                                  manager_->listeners()[0].get().listenerScope());
   EXPECT_EQ(udp_packet_writer->isBatchMode(), Api::OsSysCallsSingleton::get().supportsUdpGso());
 
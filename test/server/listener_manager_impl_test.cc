@@ -4525,6 +4525,17 @@ TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortListenerDisabled) {
   EXPECT_EQ(0, manager_->listeners().size());
 }
 
+TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortBpfBalanceRequiresReusePort) {
+  auto listener = createIPv4Listener("BpfBalanceListener");
+  listener.mutable_connection_balance_config()->mutable_reuse_port_bpf_balance();
+  listener.set_reuse_port(false);
+
+  EXPECT_THROW_WITH_MESSAGE(manager_->addOrUpdateListener(listener, "", true), EnvoyException,
+                            "error adding listener '127.0.0.1:1111': reuse_port_bpf_balance "
+                            "requires reuse_port");
+  EXPECT_EQ(0, manager_->listeners().size());
+}
+
 TEST_F(ListenerManagerImplWithRealFiltersTest, LiteralSockoptListenerEnabled) {
   const envoy::config::listener::v3::Listener listener = parseListenerFromV3Yaml(R"EOF(
     name: SockoptsListener
@@ -5445,7 +5456,7 @@ filter_chains:
           .get()
           .udpListenerConfig()
           ->packetWriterFactory()
-          .createUdpPacketWriter(listen_socket->ioHandle(),
+          .createUdpPacketWriter(listen_socket->ioHandle(), server_.dispatcher(),
                                  manager_->listeners()[0].get().listenerScope());
   EXPECT_FALSE(udp_packet_writer->isBatchMode());
 }
@@ -211,6 +211,7 @@ struct SyncPacketProcessor : public Network::UdpPacketProcessor {
   }
   uint64_t maxDatagramSize() const override { return max_rx_datagram_size_; }
   void onDatagramsDropped(uint32_t) override {}
+  void onDatagramsRead(uint64_t) override {}
   size_t numPacketsExpectedPerEventLoop() const override {
     return Network::MAX_NUM_PACKETS_PER_EVENT_LOOP;
   }
@@ -225,7 +226,8 @@ Api::IoCallUint64Result readFromSocket(IoHandle& handle, const Address::Instance
                                        uint64_t max_rx_datagram_size) {
   SyncPacketProcessor processor(data, max_rx_datagram_size);
   return Network::Utility::readFromSocket(handle, local_address, processor,
-                                          MonotonicTime(std::chrono::seconds(0)), false, nullptr);
+                                          MonotonicTime(std::chrono::seconds(0)), false,
+                                          Network::NUM_DATAGRAMS_PER_RECEIVE, nullptr);
 }
 
 UdpSyncPeer::UdpSyncPeer(Network::Address::IpVersion version, uint64_t max_rx_datagram_size)
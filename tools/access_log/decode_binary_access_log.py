@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+
+# Decode the files written by the binary file access log
+# (envoy.access_loggers.binary_file) into JSON lines, a JSON object per log
+# entry keyed by the names of the columns. Null values are left out.
+#
+# Usage: decode_binary_access_log.py [file ...]
+#
+# The files are read from stdin if none is given. See the BinaryFileAccessLog
+# proto for the format of the blocks.
+
+import json
+import struct
+import sys
+
+MAGIC = b'EALB'
+VERSION = 1
+STRING = 0
+INTEGER = 1
+
+
+class DecodeError(Exception):
+    pass
+
+
+def read_varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        if pos >= len(data):
+            raise DecodeError('truncated varint')
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        if byte < 0x80:
+            return value, pos
+        shift += 7
+
+
+def read_signed_varint(data, pos):
+    value, pos = read_varint(data, pos)
+    return (value >> 1) ^ -(value & 1), pos
+
+
+def decode_block(body):
+    (index_length,) = struct.unpack_from('<I', body, len(body) - 4)
+    pos = len(body) - 4 - index_length
+    version, pos = read_varint(body, pos)
+    if version != VERSION:
+        raise DecodeError('unsupported version %d' % version)
+    records, pos = read_varint(body, pos)
+    column_count, pos = read_varint(body, pos)
+    columns = []
+    for _ in range(column_count):
+        name_length, pos = read_varint(body, pos)
+        name = body[pos:pos + name_length].decode('utf-8')
+        pos += name_length
+        column_type = body[pos]
+        offset, pos = read_varint(body, pos + 1)
+        columns.append((name, column_type, offset))
+
+    symbol_count, pos = read_varint(body, 0)
+    symbols = []
+    for _ in range(symbol_count):
+        length, pos = read_varint(body, pos)
+        symbols.append(body[pos:pos + length].decode('utf-8', errors='replace'))
+        pos += length
+
+    entries = [{} for _ in range(records)]
+    for name, column_type, offset in columns:
+        bitmap = body[offset:offset + (records + 7) // 8]
+        pos = offset + len(bitmap)
+        for i in range(records):
+            if not bitmap[i // 8] & (1 << (i % 8)):
+                continue
+            if column_type == STRING:
+                symbol, pos = read_varint(body, pos)
+                entries[i][name] = symbols[symbol]
+            elif column_type == INTEGER:
+                entries[i][name], pos = read_signed_varint(body, pos)
+            else:
+                raise DecodeError('unknown type %d of column %s' % (column_type, name))
+    return entries
+
+
+def decode(data):
+    pos = 0
+    while pos < len(data):
+        if data[pos:pos + 4] != MAGIC:
+            raise DecodeError('no block at offset %d' % pos)
+        (length,) = struct.unpack_from('<I', data, pos + 4)
+        pos += 8
+        if pos + length > len(data):
+            raise DecodeError('truncated block at offset %d' % (pos - 8))
+        yield from decode_block(data[pos:pos + length])
+        pos += length
+
+
+def main(paths):
+    inputs = [open(path, 'rb') for path in paths] if paths else [sys.stdin.buffer]
+    for f in inputs:
+        with f:
+            for entry in decode(f.read()):
+                print(json.dumps(entry))
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])